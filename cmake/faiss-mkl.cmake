@@ -38,6 +38,12 @@ endif()
 
 message(STATUS "faiss use ${FAISS_OPT_LEVEL} instruction set")
 
+if(WITH_FAISS_GPU)
+  set(FAISS_ENABLE_GPU ON)
+else()
+  set(FAISS_ENABLE_GPU OFF)
+endif()
+
 if(DEFINED ENV{MKLROOT})
   message(STATUS "MKLROOT is: $ENV{MKLROOT}")
 else()
@@ -61,7 +67,7 @@ ExternalProject_Add(
              -DCMAKE_POSITION_INDEPENDENT_CODE=ON
              -DCMAKE_BUILD_TYPE=${THIRD_PARTY_BUILD_TYPE}
              -DCMAKE_PREFIX_PATH=${prefix_path}
-             -DFAISS_ENABLE_GPU=OFF
+             -DFAISS_ENABLE_GPU=${FAISS_ENABLE_GPU}
              -DFAISS_ENABLE_PYTHON=OFF
              -DFAISS_OPT_LEVEL=${FAISS_OPT_LEVEL}
              -DBLA_STATIC=ON
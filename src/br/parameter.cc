@@ -111,6 +111,9 @@ DEFINE_string(br_diff_file1, "", "br diff file1. default empty");
 // br diff file2
 DEFINE_string(br_diff_file2, "", "br diff file2. default empty");
 
+// br diff region data file in this many key ranges in parallel
+DEFINE_uint32(br_diff_concurrency, 4, "br diff region data file in this many key ranges in parallel. default 4");
+
 // br client method
 DEFINE_string(br_client_method, "", "br client method. default empty");
 
@@ -149,4 +152,14 @@ DEFINE_int32(br_backup_restore_wait_for_region_leader_select_timeout_s, 600,
 DEFINE_int32(br_backup_restore_wait_for_region_leader_select_tick_timeout_s, 1,
              "backup & restore waiting for the region to select a new leader tick timeout. default 1s.");
 
+// restore region data start concurrency of each store. default 2.
+DEFINE_uint32(restore_store_init_concurrency, 2, "restore region data start concurrency of each store. default 2");
+
+// restore region data max concurrency of each store. default 8.
+DEFINE_uint32(restore_store_max_concurrency, 8, "restore region data max concurrency of each store. default 8");
+
+// restore region data is slow when cost per mb above average cost multiply this ratio. default 2.0.
+DEFINE_double(restore_store_slow_ratio, 2.0,
+              "restore region data is slow when cost per mb above average cost multiply this ratio. default 2.0");
+
 }  // namespace br
\ No newline at end of file
@@ -157,6 +157,9 @@ DECLARE_string(br_diff_file1);
 // br diff file2
 DECLARE_string(br_diff_file2);
 
+// br diff region data file in this many key ranges in parallel
+DECLARE_uint32(br_diff_concurrency);
+
 // br client method
 DECLARE_string(br_client_method);
 
@@ -189,6 +192,15 @@ DECLARE_int32(br_backup_restore_wait_for_region_leader_select_timeout_s);
 // backup & restore waiting for the region to select a new leader tick timeout. default 1s.
 DECLARE_int32(br_backup_restore_wait_for_region_leader_select_tick_timeout_s);
 
+// restore region data start concurrency of each store. default 2.
+DECLARE_uint32(restore_store_init_concurrency);
+
+// restore region data max concurrency of each store. default 8.
+DECLARE_uint32(restore_store_max_concurrency);
+
+// restore region data is slow when cost per mb above average cost multiply this ratio. default 2.0.
+DECLARE_double(restore_store_slow_ratio);
+
 }  // namespace br
 
 #endif  // DINGODB_BR_PARAMETER_H_
\ No newline at end of file
@@ -21,13 +21,18 @@
 #include <string>
 #include <thread>
 
+#include "br/parameter.h"
 #include "br/restore_region_data.h"
 #include "br/utils.h"
+#include "bthread/bthread.h"
+#include "bvar/reducer.h"
+#include "bvar/status.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "fmt/core.h"
 #include "fmt/format.h"
 #include "proto/common.pb.h"
+#include "proto/coordinator.pb.h"
 #include "proto/error.pb.h"
 
 namespace br {
@@ -38,6 +43,12 @@ namespace br {
 
 // #undef ENABLE_RESTORE_REGION_DATA_PTHREAD
 
+// wait time of thread when all stores with pending regions are busy
+static const int64_t kWaitStoreSlotUs = 10 * 1000;
+
+static bvar::Adder<int64_t> g_restore_region_data_count("dingo_br_restore_region_data_count");
+static bvar::Status<int64_t> g_restore_region_data_eta_s("dingo_br_restore_region_data_eta_s", 0);
+
 RestoreRegionDataManager::RestoreRegionDataManager(
     ServerInteractionPtr coordinator_interaction, ServerInteractionPtr interaction, uint32_t concurrency,
     int64_t replica_num, const std::string& restorets, int64_t restoretso_internal, const std::string& storage,
@@ -60,6 +71,9 @@ RestoreRegionDataManager::RestoreRegionDataManager(
       restore_region_timeout_s_(restore_region_timeout_s),
       id_and_region_kvs_(id_and_region_kvs),
       id_and_sst_meta_group_kvs_(id_and_sst_meta_group_kvs),
+      resolving_sst_meta_groups_(0),
+      store_limiter_(std::make_shared<RestoreStoreLimiter>(
+          FLAGS_restore_store_init_concurrency, FLAGS_restore_store_max_concurrency, FLAGS_restore_store_slow_ratio)),
       is_need_exit_(false),
       already_restore_region_datas_(0) {
   bthread_mutex_init(&mutex_, nullptr);
@@ -120,7 +134,10 @@ butil::Status RestoreRegionDataManager::Init() {
 butil::Status RestoreRegionDataManager::Run() {
   butil::Status status;
 
-  uint32_t concurrency = std::min(concurrency_, static_cast<uint32_t>(sst_meta_groups_.size()));
+  // each store may run up to restore_store_max_concurrency regions, the limiter decide how many it really runs.
+  uint32_t store_num = std::max(static_cast<uint32_t>(interaction_->GetAddrs().size()), static_cast<uint32_t>(1));
+  uint32_t concurrency = std::max(concurrency_, store_num * FLAGS_restore_store_max_concurrency);
+  concurrency = std::min(concurrency, static_cast<uint32_t>(sst_meta_groups_.size()));
   int64_t sst_meta_groups_size = sst_meta_groups_.size();
 
   // init thread_exit_flags_ set already exit
@@ -176,8 +193,12 @@ butil::Status RestoreRegionDataManager::Run() {
 
       std::string elapsed_time_per_region_str = Utils::FormatDurationFromMs(elapsed_time_per_region_ms);
 
+      int64_t eta_ms = elapsed_time_per_region_ms * (sst_meta_groups_size - already_restore_region_datas_.load());
+      g_restore_region_data_eta_s.set_value(eta_ms / 1000);
+
       std::cout << "\r" << progress_head << " <" << already_restore_region_datas_ << "/" << sst_meta_groups_size << " "
-                << elapsed_time_str << " " << elapsed_time_per_region_str << "/r" << "> " << std::fixed
+                << elapsed_time_str << " " << elapsed_time_per_region_str << "/r" << " eta "
+                << Utils::FormatDurationFromMs(eta_ms) << "> " << std::fixed
                 << std::setprecision(2)
                 << static_cast<double>(already_restore_region_datas_.load()) / sst_meta_groups_size * 100 << "%" << " ["
                 << backup_meta_region_cf_names[0][0] << ":" << already_restore_region_datas_ << "]" << std::flush;
@@ -252,6 +273,8 @@ butil::Status RestoreRegionDataManager::Run() {
   lambda_output_progress_function();
   std::cout << std::endl;
 
+  DINGO_LOG(INFO) << "restore store limiter : " << store_limiter_->ToString();
+
   int64_t elapsed_time_ms = calc_end_time_ms - calc_start_time_ms;
   std::string elapsed_time_str = Utils::FormatDurationFromMs(elapsed_time_ms);
   int64_t elapsed_time_per_region_ms =
@@ -337,22 +360,63 @@ butil::Status RestoreRegionDataManager::DoRestoreRegionDataInternal(ServerIntera
     }
 
     std::shared_ptr<dingodb::pb::common::BackupDataFileValueSstMetaGroup> sst_meta_group;
+    int64_t store_id = 0;
+    bool is_resolve = false;
     {
       BAIDU_SCOPED_LOCK(mutex_);
-      if (!sst_meta_groups_.empty()) {
-        // sst_meta_group = sst_meta_groups_.front();
-        // sst_meta_groups_.erase(sst_meta_groups_.begin());
+      // most idle store which has pending groups and a free slot
+      double min_load = 1.0;
+      for (const auto& [id, groups] : store_sst_meta_groups_) {
+        double load = groups.empty() ? 1.0 : store_limiter_->Load(id);
+        if (load < min_load) {
+          min_load = load;
+          store_id = id;
+        }
+      }
+
+      if (min_load < 1.0 && store_limiter_->Acquire(store_id)) {
+        auto& groups = store_sst_meta_groups_[store_id];
+        sst_meta_group = groups.back();
+        groups.pop_back();
+      } else if (!sst_meta_groups_.empty()) {
         sst_meta_group = sst_meta_groups_.back();
         sst_meta_groups_.pop_back();
+        resolving_sst_meta_groups_++;
+        is_resolve = true;
       } else {
-        // empty regions. thread exit
-        break;
+        bool is_pending = (resolving_sst_meta_groups_ > 0);
+        for (const auto& [id, groups] : store_sst_meta_groups_) {
+          is_pending = is_pending || !groups.empty();
+        }
+        if (!is_pending) {
+          // empty regions. thread exit
+          break;
+        }
       }
     }
 
-    // check sst_meta_group empty. ignore
-    if (0 == sst_meta_group->backup_data_file_value_sst_metas_size()) {
-      already_restore_region_datas_++;
+    // all stores with pending groups are busy
+    if (sst_meta_group == nullptr) {
+      bthread_usleep(kWaitStoreSlotUs);
+      continue;
+    }
+
+    if (is_resolve) {
+      // check sst_meta_group empty. ignore
+      if (0 == sst_meta_group->backup_data_file_value_sst_metas_size()) {
+        BAIDU_SCOPED_LOCK(mutex_);
+        resolving_sst_meta_groups_--;
+        already_restore_region_datas_++;
+        continue;
+      }
+
+      int64_t leader_store_id =
+          GetLeaderStoreId(coordinator_interaction, sst_meta_group->backup_data_file_value_sst_metas(0).region_id());
+      {
+        BAIDU_SCOPED_LOCK(mutex_);
+        resolving_sst_meta_groups_--;
+        store_sst_meta_groups_[leader_store_id].push_front(sst_meta_group);
+      }
       continue;
     }
 
@@ -365,11 +429,12 @@ butil::Status RestoreRegionDataManager::DoRestoreRegionDataInternal(ServerIntera
         std::string s = fmt::format("region id : {} not found", region_id);
         DINGO_LOG(ERROR) << s;
         is_need_exit_ = true;
-        DINGO_LOG(ERROR) << Utils::FormatStatusError(status);
+        status = butil::Status(dingodb::pb::error::ERESTORE_REGION_META_NOT_FOUND, s);
         {
           BAIDU_SCOPED_LOCK(mutex_);
           last_error_ = status;
         }
+        break;
       }
 
       region = iter->second;
@@ -379,51 +444,36 @@ butil::Status RestoreRegionDataManager::DoRestoreRegionDataInternal(ServerIntera
         coordinator_interaction, interaction, region, restorets_, restoretso_internal_, storage_, storage_internal_,
         sst_meta_group, backup_meta_region_cf_name_, group_belongs_to_whom_, restore_region_timeout_s_);
 
-    if (!is_need_exit_) {
-      status = restore_region_data->Init();
-      if (!status.ok()) {
-        is_need_exit_ = true;
-        DINGO_LOG(ERROR) << Utils::FormatStatusError(status);
-        {
-          BAIDU_SCOPED_LOCK(mutex_);
-          last_error_ = status;
-        }
-        break;
-      }
-    } else {
+    if (is_need_exit_) {
       break;
     }
 
-    if (!is_need_exit_) {
-      status = restore_region_data->Run();
-      if (!status.ok()) {
-        is_need_exit_ = true;
-        DINGO_LOG(ERROR) << Utils::FormatStatusError(status);
-        {
-          BAIDU_SCOPED_LOCK(mutex_);
-          last_error_ = status;
-        }
-        break;
-      }
-    } else {
-      break;
+    int64_t data_size = 0;
+    for (const auto& sst_meta : sst_meta_group->backup_data_file_value_sst_metas()) {
+      data_size += sst_meta.file_size();
     }
 
-    if (!is_need_exit_) {
+    int64_t start_time_ms = dingodb::Helper::TimestampMs();
+    status = restore_region_data->Init();
+    if (status.ok()) {
+      status = restore_region_data->Run();
+    }
+    if (status.ok()) {
       status = restore_region_data->Finish();
-      if (!status.ok()) {
-        is_need_exit_ = true;
-        DINGO_LOG(ERROR) << Utils::FormatStatusError(status);
-        {
-          BAIDU_SCOPED_LOCK(mutex_);
-          last_error_ = status;
-        }
-        break;
+    }
+    store_limiter_->Release(store_id, dingodb::Helper::TimestampMs() - start_time_ms, data_size, status.ok());
+
+    if (!status.ok()) {
+      is_need_exit_ = true;
+      DINGO_LOG(ERROR) << Utils::FormatStatusError(status);
+      {
+        BAIDU_SCOPED_LOCK(mutex_);
+        last_error_ = status;
       }
-    } else {
       break;
     }
 
+    g_restore_region_data_count << 1;
     already_restore_region_datas_++;
   }
 
@@ -436,6 +486,23 @@ butil::Status RestoreRegionDataManager::DoRestoreRegionDataInternal(ServerIntera
   return butil::Status::OK();
 }
 
+int64_t RestoreRegionDataManager::GetLeaderStoreId(ServerInteractionPtr coordinator_interaction, int64_t region_id) {
+  dingodb::pb::coordinator::QueryRegionRequest request;
+  dingodb::pb::coordinator::QueryRegionResponse response;
+
+  request.set_region_id(region_id);
+
+  auto status = coordinator_interaction->SendRequest("CoordinatorService", "QueryRegion", request, response);
+  if (status.ok() && response.error().errcode() == dingodb::pb::error::OK) {
+    return response.region().leader_store_id();
+  }
+
+  // not know leader, regions of unknown store share store 0 slots.
+  DINGO_LOG(WARNING) << fmt::format("query leader store of region({}) failed, {} {}", region_id,
+                                    Utils::FormatStatusError(status), Utils::FormatResponseError(response));
+  return 0;
+}
+
 butil::Status RestoreRegionDataManager::FormatBackupMetaRegionCfName(
     std::vector<std::string>& backup_meta_region_cf_names) {
   if (backup_meta_region_cf_name_ != dingodb::Constant::kStoreCfSstMetaSqlMetaSstName &&
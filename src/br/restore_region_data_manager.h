@@ -16,10 +16,13 @@
 #define DINGODB_BR_RESTORE_REGION_DATA_MANAGER_H_
 
 #include <cstdint>
+#include <deque>
+#include <map>
 #include <memory>
 #include <string>
 
 #include "br/interation.h"
+#include "br/restore_store_limiter.h"
 #include "bthread/butex.h"
 #include "butil/status.h"
 #include "fmt/core.h"
@@ -59,6 +62,8 @@ class RestoreRegionDataManager : public std::enable_shared_from_this<RestoreRegi
   butil::Status DoAsyncRestoreRegionData(uint32_t thread_no);
   butil::Status DoRestoreRegionDataInternal(ServerInteractionPtr coordinator_interaction,
                                             ServerInteractionPtr interaction, uint32_t thread_no);
+  // store of region leader, restore request is sent to it.
+  int64_t GetLeaderStoreId(ServerInteractionPtr coordinator_interaction, int64_t region_id);
   butil::Status FormatBackupMetaRegionCfName(std::vector<std::string>& backup_meta_region_cf_names);
   static butil::Status PaddingBackupMetaRegionCfName(std::vector<std::string>& backup_meta_region_cf_names);
   ServerInteractionPtr coordinator_interaction_;
@@ -77,8 +82,18 @@ class RestoreRegionDataManager : public std::enable_shared_from_this<RestoreRegi
   std::shared_ptr<std::map<int64_t, std::shared_ptr<dingodb::pb::common::BackupDataFileValueSstMetaGroup>>>
       id_and_sst_meta_group_kvs_;
 
+  // groups whose leader store is not known yet
   std::vector<std::shared_ptr<dingodb::pb::common::BackupDataFileValueSstMetaGroup>> sst_meta_groups_;
 
+  // store id -> groups wait for a slot of the store
+  std::map<int64_t, std::deque<std::shared_ptr<dingodb::pb::common::BackupDataFileValueSstMetaGroup>>>
+      store_sst_meta_groups_;
+
+  // groups being resolved leader store
+  int64_t resolving_sst_meta_groups_;
+
+  std::shared_ptr<RestoreStoreLimiter> store_limiter_;
+
   // notify other threads to exit
   std::atomic<bool> is_need_exit_;
 
@@ -256,24 +256,25 @@ butil::Status RestoreSqlMeta::ExtractFromStoreRegionSqlMetaSst() {
   if (store_region_sql_meta_sst_) {
     std::string file_path = storage_internal_ + "/" + store_region_sql_meta_sst_->file_name();
 
-    SstFileReader sst_file_reader;
-    std::map<std::string, std::string> internal_id_and_region_kvs;
-    status = sst_file_reader.ReadFile(file_path, internal_id_and_region_kvs);
-    if (!status.ok()) {
-      DINGO_LOG(ERROR) << Utils::FormatStatusError(status);
-      return status;
-    }
-
     id_and_region_kvs_ = std::make_shared<std::map<int64_t, std::shared_ptr<dingodb::pb::common::Region>>>();
-    for (const auto& [internal_id, region_str] : internal_id_and_region_kvs) {
+
+    // parse kv while reading file, raw kvs of the whole file are not held.
+    SstFileReader sst_file_reader;
+    status = sst_file_reader.ReadFile(file_path, [&](const rocksdb::Slice& key, const rocksdb::Slice& value) {
+      std::string internal_id = key.ToString();
       dingodb::pb::common::Region region;
-      if (!region.ParseFromString(region_str)) {
+      if (!region.ParseFromArray(value.data(), value.size())) {
         std::string s = fmt::format("parse dingodb::pb::common::Region failed : {}", internal_id);
         return butil::Status(dingodb::pb::error::Errno::EINTERNAL, s);
       }
 
       id_and_region_kvs_->emplace(std::stoll(internal_id),
                                   std::make_shared<dingodb::pb::common::Region>(std::move(region)));
+      return butil::Status::OK();
+    });
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << Utils::FormatStatusError(status);
+      return status;
     }
   }  // if (store_region_sql_meta_sst_)
 
@@ -286,19 +287,15 @@ butil::Status RestoreSqlMeta::ExtractFromStoreCfSstMetaSqlMetaSst() {
   if (store_cf_sst_meta_sql_meta_sst_) {
     std::string file_path = storage_internal_ + "/" + store_cf_sst_meta_sql_meta_sst_->file_name();
 
-    SstFileReader sst_file_reader;
-    std::map<std::string, std::string> internal_id_and_sst_meta_group_kvs;
-    status = sst_file_reader.ReadFile(file_path, internal_id_and_sst_meta_group_kvs);
-    if (!status.ok()) {
-      DINGO_LOG(ERROR) << Utils::FormatStatusError(status);
-      return status;
-    }
-
     id_and_sst_meta_group_kvs_ =
         std::make_shared<std::map<int64_t, std::shared_ptr<dingodb::pb::common::BackupDataFileValueSstMetaGroup>>>();
-    for (const auto& [internal_id, group_str] : internal_id_and_sst_meta_group_kvs) {
+
+    // parse kv while reading file, raw kvs of the whole file are not held.
+    SstFileReader sst_file_reader;
+    status = sst_file_reader.ReadFile(file_path, [&](const rocksdb::Slice& key, const rocksdb::Slice& value) {
+      std::string internal_id = key.ToString();
       dingodb::pb::common::BackupDataFileValueSstMetaGroup group;
-      if (!group.ParseFromString(group_str)) {
+      if (!group.ParseFromArray(value.data(), value.size())) {
         std::string s =
             fmt::format("parse dingodb::pb::common::BackupDataFileValueSstMetaGroup failed : {}", internal_id);
         return butil::Status(dingodb::pb::error::Errno::EINTERNAL, s);
@@ -307,6 +304,11 @@ butil::Status RestoreSqlMeta::ExtractFromStoreCfSstMetaSqlMetaSst() {
       id_and_sst_meta_group_kvs_->emplace(
           std::stoll(internal_id),
           std::make_shared<dingodb::pb::common::BackupDataFileValueSstMetaGroup>(std::move(group)));
+      return butil::Status::OK();
+    });
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << Utils::FormatStatusError(status);
+      return status;
     }
   }  // if (store_cf_sst_meta_sql_meta_sst_)
 
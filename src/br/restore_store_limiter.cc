@@ -0,0 +1,111 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "br/restore_store_limiter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#include "fmt/core.h"
+
+namespace br {
+
+// weight of latest restore in moving average cost.
+static const double kCostAlpha = 0.2;
+// cost is measure per mb, small region counted as 1mb, so it not make a too small average.
+static const int64_t kCostUnitSize = 1024 * 1024;
+
+RestoreStoreLimiter::RestoreStoreLimiter(uint32_t init_concurrency, uint32_t max_concurrency, double slow_ratio)
+    : init_concurrency_(std::max(init_concurrency, static_cast<uint32_t>(1))),
+      max_concurrency_(std::max(max_concurrency, init_concurrency_)),
+      slow_ratio_(slow_ratio) {
+  bthread_mutex_init(&mutex_, nullptr);
+}
+
+RestoreStoreLimiter::~RestoreStoreLimiter() { bthread_mutex_destroy(&mutex_); }
+
+RestoreStoreLimiter::StoreState& RestoreStoreLimiter::GetState(int64_t store_id) {
+  auto iter = stores_.find(store_id);
+  if (iter == stores_.end()) {
+    iter = stores_.emplace(store_id, StoreState()).first;
+    iter->second.limit = init_concurrency_;
+  }
+  return iter->second;
+}
+
+bool RestoreStoreLimiter::Acquire(int64_t store_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto& state = GetState(store_id);
+  if (state.inflight >= state.limit) {
+    return false;
+  }
+  state.inflight++;
+  return true;
+}
+
+void RestoreStoreLimiter::Release(int64_t store_id, int64_t cost_ms, int64_t data_size, bool is_ok) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto& state = GetState(store_id);
+  if (state.inflight > 0) {
+    state.inflight--;
+  }
+
+  // multiplicative decrease
+  if (!is_ok) {
+    state.limit = std::max(state.limit / 2, static_cast<uint32_t>(1));
+    state.fast_count = 0;
+    return;
+  }
+
+  double cost = static_cast<double>(cost_ms) / std::max(data_size / kCostUnitSize, static_cast<int64_t>(1));
+  bool is_slow = state.avg_cost > 0.0 && cost > state.avg_cost * slow_ratio_;
+  state.avg_cost = state.avg_cost > 0.0 ? state.avg_cost * (1 - kCostAlpha) + cost * kCostAlpha : cost;
+
+  if (is_slow) {
+    state.limit = std::max(state.limit / 2, static_cast<uint32_t>(1));
+    state.fast_count = 0;
+    return;
+  }
+
+  // additive increase, one slot per window of limit restores.
+  if (++state.fast_count >= state.limit) {
+    state.limit = std::min(state.limit + 1, max_concurrency_);
+    state.fast_count = 0;
+  }
+}
+
+double RestoreStoreLimiter::Load(int64_t store_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto& state = GetState(store_id);
+  return static_cast<double>(state.inflight) / state.limit;
+}
+
+uint32_t RestoreStoreLimiter::GetLimit(int64_t store_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return GetState(store_id).limit;
+}
+
+std::string RestoreStoreLimiter::ToString() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  std::string s;
+  for (const auto& [store_id, state] : stores_) {
+    s += fmt::format("[store({}) limit({}) inflight({}) avg_cost({:.2f}ms/mb)] ", store_id, state.limit,
+                     state.inflight, state.avg_cost);
+  }
+  return s;
+}
+
+}  // namespace br
@@ -0,0 +1,76 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_BR_RESTORE_STORE_LIMITER_H_
+#define DINGODB_BR_RESTORE_STORE_LIMITER_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "bthread/mutex.h"
+
+namespace br {
+
+// Per store concurrency of restore region data, adjusted by AIMD.
+// A store gets one more slot after a window of fast restores, and half of its slots when a restore fails or is slow.
+// Slow means cost per mb of the restore is above slow_ratio times the moving average of the store.
+class RestoreStoreLimiter {
+ public:
+  RestoreStoreLimiter(uint32_t init_concurrency, uint32_t max_concurrency, double slow_ratio);
+  ~RestoreStoreLimiter();
+
+  RestoreStoreLimiter(const RestoreStoreLimiter&) = delete;
+  const RestoreStoreLimiter& operator=(const RestoreStoreLimiter&) = delete;
+  RestoreStoreLimiter(RestoreStoreLimiter&&) = delete;
+  RestoreStoreLimiter& operator=(RestoreStoreLimiter&&) = delete;
+
+  // take a slot of store, return false if all slots of store are in use.
+  bool Acquire(int64_t store_id);
+
+  // give back the slot taken by Acquire, and adjust limit of store.
+  void Release(int64_t store_id, int64_t cost_ms, int64_t data_size, bool is_ok);
+
+  // used slots / limit, smaller is more idle.
+  double Load(int64_t store_id);
+
+  uint32_t GetLimit(int64_t store_id);
+
+  std::string ToString();
+
+ private:
+  struct StoreState {
+    uint32_t limit{0};
+    uint32_t inflight{0};
+    // fast restores since last adjust
+    uint32_t fast_count{0};
+    // moving average of cost ms per mb
+    double avg_cost{0.0};
+  };
+
+  // caller hold mutex_
+  StoreState& GetState(int64_t store_id);
+
+  uint32_t init_concurrency_;
+  uint32_t max_concurrency_;
+  double slow_ratio_;
+
+  bthread_mutex_t mutex_;
+  std::map<int64_t, StoreState> stores_;
+};
+
+}  // namespace br
+
+#endif  // DINGODB_BR_RESTORE_STORE_LIMITER_H_
@@ -27,7 +27,7 @@ SstFileReader::SstFileReader() {
   }
 }
 
-butil::Status SstFileReader::ReadFile(const std::string& filename, std::map<std::string, std::string>& kvs) {
+butil::Status SstFileReader::Open(const std::string& filename) {
   if (options_.env == nullptr || sst_reader_ == nullptr) {
     return butil::Status(dingodb::pb::error::EINTERNAL, "init sst options env error.");
   }
@@ -39,16 +39,46 @@ butil::Status SstFileReader::ReadFile(const std::string& filename, std::map<std:
     return butil::Status(dingodb::pb::error::EINTERNAL, s);
   }
 
-  kvs.clear();
+  return butil::Status();
+}
+
+std::unique_ptr<rocksdb::Iterator> SstFileReader::NewIterator() {
+  rocksdb::ReadOptions read_options;
+  // file is read once in order.
+  read_options.fill_cache = false;
+  read_options.readahead_size = kReadaheadSize;
+  return std::unique_ptr<rocksdb::Iterator>(sst_reader_->NewIterator(read_options));
+}
+
+butil::Status SstFileReader::ReadFile(const std::string& filename, const KvHandler& handler) {
+  auto status = Open(filename);
+  if (!status.ok()) {
+    return status;
+  }
 
-  std::unique_ptr<rocksdb::Iterator> iter(sst_reader_->NewIterator(rocksdb::ReadOptions()));
+  auto iter = NewIterator();
   for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
-    std::string key(iter->key().data(), iter->key().size());
-    std::string value(iter->value().data(), iter->value().size());
-    kvs.emplace(std::move(key), std::move(value));
+    status = handler(iter->key(), iter->value());
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  if (BAIDU_UNLIKELY(!iter->status().ok())) {
+    std::string s = fmt::format("read {} failed, error: {}.", filename, iter->status().ToString());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(dingodb::pb::error::EINTERNAL, s);
   }
 
   return butil::Status();
 }
 
+butil::Status SstFileReader::ReadFile(const std::string& filename, std::map<std::string, std::string>& kvs) {
+  kvs.clear();
+  return ReadFile(filename, [&kvs](const rocksdb::Slice& key, const rocksdb::Slice& value) {
+    kvs.emplace(key.ToString(), value.ToString());
+    return butil::Status();
+  });
+}
+
 }  // namespace br
\ No newline at end of file
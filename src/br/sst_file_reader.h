@@ -15,6 +15,8 @@
 #ifndef DINGODB_BR_SST_FILE_READER_H_
 #define DINGODB_BR_SST_FILE_READER_H_
 
+#include <functional>
+#include <map>
 #include <memory>
 #include <string>
 
@@ -33,9 +35,21 @@ class SstFileReader {
   SstFileReader(SstFileReader&& rhs) = delete;
   SstFileReader& operator=(SstFileReader&& rhs) = delete;
 
+  using KvHandler = std::function<butil::Status(const rocksdb::Slice& key, const rocksdb::Slice& value)>;
+
+  // load whole file, only for small meta file.
   butil::Status ReadFile(const std::string& filename, std::map<std::string, std::string>& kvs);
 
+  // iterate kvs in key order without loading whole file, stop at the first error of handler.
+  butil::Status ReadFile(const std::string& filename, const KvHandler& handler);
+
+  // open file for NewIterator, iterator must be released before the reader is reopened or destroyed.
+  butil::Status Open(const std::string& filename);
+  std::unique_ptr<rocksdb::Iterator> NewIterator();
+
  private:
+  static constexpr size_t kReadaheadSize = 2 * 1024 * 1024;
+
   rocksdb::Options options_;
   std::unique_ptr<rocksdb::SstFileReader> sst_reader_;
 };
@@ -24,20 +24,26 @@
 
 namespace br {
 
-butil::Status SstFileWriter::SaveFile(const std::map<std::string, std::string>& kvs, const std::string& filename) {
+butil::Status SstFileWriter::Open(const std::string& filename) {
   auto status = sst_writer_->Open(filename);
   if (!status.ok()) {
     return butil::Status(status.code(), status.ToString());
   }
 
-  for (const auto& [key, value] : kvs) {
-    status = sst_writer_->Put(key, value);
-    if (!status.ok()) {
-      return butil::Status(status.code(), status.ToString());
-    }
+  return butil::Status();
+}
+
+butil::Status SstFileWriter::Put(const rocksdb::Slice& key, const rocksdb::Slice& value) {
+  auto status = sst_writer_->Put(key, value);
+  if (!status.ok()) {
+    return butil::Status(status.code(), status.ToString());
   }
 
-  status = sst_writer_->Finish();
+  return butil::Status();
+}
+
+butil::Status SstFileWriter::Finish() {
+  auto status = sst_writer_->Finish();
   if (!status.ok()) {
     return butil::Status(status.code(), status.ToString());
   }
@@ -45,4 +51,20 @@ butil::Status SstFileWriter::SaveFile(const std::map<std::string, std::string>&
   return butil::Status();
 }
 
+butil::Status SstFileWriter::SaveFile(const std::map<std::string, std::string>& kvs, const std::string& filename) {
+  auto status = Open(filename);
+  if (!status.ok()) {
+    return status;
+  }
+
+  for (const auto& [key, value] : kvs) {
+    status = Put(key, value);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  return Finish();
+}
+
 }  // namespace br
\ No newline at end of file
@@ -16,6 +16,8 @@
 #define DINGODB_BR_SST_FILE_WRITER_H_
 
 #include <cstdint>
+#include <map>
+#include <memory>
 #include <string>
 
 #include "butil/status.h"
@@ -23,6 +25,7 @@
 #include "rocksdb/convenience.h"
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
+#include "rocksdb/sst_file_writer.h"
 
 namespace br {
 class SstFileWriter {
@@ -37,6 +40,11 @@ class SstFileWriter {
 
   butil::Status SaveFile(const std::map<std::string, std::string>& kvs, const std::string& filename);
 
+  // write kvs one by one in strictly increasing key order, memory not depend on file size.
+  butil::Status Open(const std::string& filename);
+  butil::Status Put(const rocksdb::Slice& key, const rocksdb::Slice& value);
+  butil::Status Finish();
+
   int64_t GetSize() { return sst_writer_->FileSize(); }
 
  private:
@@ -19,6 +19,9 @@
 #include <cstddef>
 #include <memory>
 #include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 #include "br/sst_file_reader.h"
 #include "br/tool_utils.h"
@@ -3573,109 +3576,145 @@ butil::Status ToolDiff::CompareRegionDataFunction(const std::string& path1, cons
                                                   std::string& diff_content) {
   butil::Status status;
 
-  std::map<std::string, std::string> kvs1;
+  // key range of both files, used to cut files into parts compared in parallel.
+  std::string start_key;
+  std::string end_key;
+  bool is_empty = true;
+  for (const auto& path : {path1, path2}) {
+    SstFileReader sst_reader;
+    status = sst_reader.Open(path);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << Utils::FormatStatusError(status);
+      return status;
+    }
+
+    auto iter = sst_reader.NewIterator();
+    iter->SeekToFirst();
+    if (!iter->Valid()) {
+      continue;
+    }
+    std::string first_key = iter->key().ToString();
+    iter->SeekToLast();
+    std::string last_key = iter->key().ToString();
+
+    start_key = (is_empty || first_key < start_key) ? first_key : start_key;
+    end_key = (is_empty || last_key > end_key) ? last_key : end_key;
+    is_empty = false;
+  }
+
+  std::vector<std::string> split_keys = ToolUtils::SplitKeyRange(start_key, end_key, FLAGS_br_diff_concurrency);
+
+  // part i is [lower_keys[i], lower_keys[i + 1]), first part from begin of file and last part to end of file.
+  std::vector<std::string> lower_keys = {""};
+  lower_keys.insert(lower_keys.end(), split_keys.begin(), split_keys.end());
+  size_t part_num = lower_keys.size();
 
-  status = ToolDiff::ReadSstForRegionData(path1, kvs1);
+  std::vector<butil::Status> part_status(part_num);
+  std::vector<uint8_t> part_is_same(part_num, 1);
+  std::vector<KvBrief> part_kv_briefs1(part_num);
+  std::vector<KvBrief> part_kv_briefs2(part_num);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < part_num; ++i) {
+    threads.emplace_back([&, i]() {
+      bool is_part_same = true;
+      part_status[i] = CompareRegionDataRange(path1, path2, lower_keys[i], (i + 1 < part_num ? lower_keys[i + 1] : ""),
+                                              is_part_same, part_kv_briefs1[i], part_kv_briefs2[i]);
+      part_is_same[i] = is_part_same ? 1 : 0;
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  is_same = true;
+  KvBrief kv_brief1;
+  KvBrief kv_brief2;
+  for (size_t i = 0; i < part_num; ++i) {
+    if (!part_status[i].ok()) {
+      DINGO_LOG(ERROR) << Utils::FormatStatusError(part_status[i]);
+      return part_status[i];
+    }
+    is_same = is_same && part_is_same[i] != 0;
+    kv_brief1.Merge(part_kv_briefs1[i]);
+    kv_brief2.Merge(part_kv_briefs2[i]);
+  }
+
+  content1 += kv_brief1.ToString();
+  content2 += kv_brief2.ToString();
+
+  compare_content += fmt::format("\n {} total number of key values  L:{} | R:{}", is_same ? "=" : "≠",
+                                 kv_brief1.Count(), kv_brief2.Count());
+  compare_content += "\n";
+
+  return butil::Status::OK();
+}
+
+butil::Status ToolDiff::CompareRegionDataRange(const std::string& path1, const std::string& path2,
+                                               const std::string& lower_key, const std::string& upper_key,
+                                               bool& is_same, KvBrief& kv_brief1, KvBrief& kv_brief2) {
+  butil::Status status;
+
+  // region data file may be large, compare two sorted kv streams instead of loading whole files.
+  SstFileReader sst_reader1;
+  status = sst_reader1.Open(path1);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << Utils::FormatStatusError(status);
     return status;
   }
 
-  std::map<std::string, std::string> kvs2;
-  status = ToolDiff::ReadSstForRegionData(path2, kvs2);
+  SstFileReader sst_reader2;
+  status = sst_reader2.Open(path2);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << Utils::FormatStatusError(status);
     return status;
   }
 
-  int32_t i = 0;
-  int32_t size = kvs1.size();
-  int32_t j = 0;
-  for (const auto& [key, value] : kvs1) {
-    std::string key_hex;
-    std::string value_hex;
-    std::string key_hex_brief;
-    std::string value_hex_brief;
-
-    if (i < 3 || i >= (size - 3)) {
-      key_hex = dingodb::Helper::StringToHex(key);
-      value_hex = dingodb::Helper::StringToHex(value);
-
-      key_hex_brief = key_hex.size() > 64 ? key_hex.substr(0, 64) + "..." : key_hex;
-      value_hex_brief = value_hex.size() > 64 ? value_hex.substr(0, 64) + "..." : value_hex;
-
-      content1 += fmt::format("\n[{}] [{}] : {}", i, key_hex_brief, value_hex_brief);
-    } else {
-      if (j++ == 0) content1 += fmt::format("\n............");
-    }
-    i++;
-  }
+  auto iter1 = sst_reader1.NewIterator();
+  auto iter2 = sst_reader2.NewIterator();
 
-  i = 0;
-  size = kvs2.size();
-  j = 0;
-  for (const auto& [key, value] : kvs2) {
-    std::string key_hex;
-    std::string value_hex;
-    std::string key_hex_brief;
-    std::string value_hex_brief;
-
-    if (i < 3 || i >= (size - 3)) {
-      key_hex = dingodb::Helper::StringToHex(key);
-      value_hex = dingodb::Helper::StringToHex(value);
-
-      key_hex_brief = key_hex.size() > 64 ? key_hex.substr(0, 64) + "..." : key_hex;
-      value_hex_brief = value_hex.size() > 64 ? value_hex.substr(0, 64) + "..." : value_hex;
-
-      content2 += fmt::format("\n[{}] [{}] : {}", i, key_hex_brief, value_hex_brief);
-    } else {
-      if (j++ == 0) content1 += fmt::format("\n............");
-    }
-    i++;
-  }
+  auto lambda_valid_function = [&upper_key](rocksdb::Iterator* iter) {
+    return iter->Valid() && (upper_key.empty() || iter->key().compare(upper_key) < 0);
+  };
 
-  // compare
   is_same = true;
-  if (kvs1.size() != kvs2.size()) {
-    is_same = false;
-    compare_content += fmt::format("\n {} total number of key values  L:{} | R:{}", "≠", kvs1.size(), kvs2.size());
-    compare_content += "\n";
-
-    return butil::Status::OK();
-  }
+  iter1->Seek(lower_key);
+  iter2->Seek(lower_key);
+  bool is_valid1 = lambda_valid_function(iter1.get());
+  bool is_valid2 = lambda_valid_function(iter2.get());
+  while (is_valid1 || is_valid2) {
+    int cmp = 0;
+    if (is_valid1 && is_valid2) {
+      cmp = iter1->key().compare(iter2->key());
+    } else {
+      cmp = is_valid1 ? -1 : 1;
+    }
 
-  for (const auto& [key, value] : kvs1) {
-    auto iter = kvs2.find(key);
-    if (iter == kvs2.end()) {
+    if (cmp != 0 || iter1->value() != iter2->value()) {
       is_same = false;
-    } else {
-      if (value != iter->second) {
-        is_same = false;
-      }
     }
-  }
 
-  if (is_same) {
-    for (const auto& [key, value] : kvs2) {
-      auto iter = kvs1.find(key);
-      if (iter == kvs1.end()) {
-        is_same = false;
-      } else {
-        if (value != iter->second) {
-          is_same = false;
-        }
-      }
+    if (cmp <= 0) {
+      kv_brief1.Add(std::string_view(iter1->key().data(), iter1->key().size()),
+                    std::string_view(iter1->value().data(), iter1->value().size()));
+      iter1->Next();
+      is_valid1 = lambda_valid_function(iter1.get());
+    }
+    if (cmp >= 0) {
+      kv_brief2.Add(std::string_view(iter2->key().data(), iter2->key().size()),
+                    std::string_view(iter2->value().data(), iter2->value().size()));
+      iter2->Next();
+      is_valid2 = lambda_valid_function(iter2.get());
     }
   }
 
-  if (is_same) {
-    compare_content += fmt::format("\n {} total number of key values  L:{} | R:{}", "=", kvs1.size(), kvs2.size());
-  } else {
-    compare_content += fmt::format("\n {} total number of key values  L:{} | R:{}", "≠", kvs1.size(), kvs2.size());
+  for (const auto* iter : {iter1.get(), iter2.get()}) {
+    if (!iter->status().ok()) {
+      std::string s = fmt::format("read sst file failed. {}", iter->status().ToString());
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(dingodb::pb::error::Errno::EINTERNAL, s);
+    }
   }
 
-  compare_content += "\n";
-
   return butil::Status::OK();
 }
 
@@ -3717,19 +3756,4 @@ butil::Status ToolDiff::ParseFileName(const std::string& file_name, std::string&
   return butil::Status::OK();
 }
 
-butil::Status ToolDiff::ReadSstForRegionData(const std::string& path, std::map<std::string, std::string>& kvs) {
-  butil::Status status;
-
-  std::shared_ptr<SstFileReader> sst_reader = std::make_shared<SstFileReader>();
-
-  status = sst_reader->ReadFile(path, kvs);
-  if (!status.ok()) {
-    std::string s = fmt::format("read sst file failed. {}", status.error_str());
-    DINGO_LOG(ERROR) << s;
-    return butil::Status(dingodb::pb::error::Errno::EINTERNAL, s);
-  }
-
-  return butil::Status::OK();
-}
-
 }  // namespace br
\ No newline at end of file
@@ -19,6 +19,7 @@
 #include <memory>
 
 #include "br/parameter.h"
+#include "br/tool_utils.h"
 #include "butil/status.h"
 #include "fmt/core.h"
 #include "proto/common.pb.h"
@@ -225,11 +226,14 @@ class ToolDiff : public std::enable_shared_from_this<ToolDiff> {
                                                  std::string& content2, std::string& same_content,
                                                  std::string& diff_content);
 
+  // merge compare kvs in [lower_key, upper_key) of two files, empty upper_key means to end of file.
+  static butil::Status CompareRegionDataRange(const std::string& path1, const std::string& path2,
+                                              const std::string& lower_key, const std::string& upper_key,
+                                              bool& is_same, KvBrief& kv_brief1, KvBrief& kv_brief2);
+
   static butil::Status ParseFileName(const std::string& file_name, std::string& region_id, std::string& region_cf,
                                      std::string& file_name_summary);
 
-  static butil::Status ReadSstForRegionData(const std::string& path, std::map<std::string, std::string>& kvs);
-
   ToolDiffParams tool_diff_params_;
   std::string path_internal_1_;
   std::string file_name_1_;
@@ -18,6 +18,7 @@
 #include <filesystem>
 #include <memory>
 #include <string>
+#include <string_view>
 
 #include "br/sst_file_reader.h"
 #include "br/tool_utils.h"
@@ -1019,21 +1020,13 @@ butil::Status ToolDump::DumpRegionCfFunction(const std::string& path, std::strin
                                              std::string& content_brief, std::string& content_detail) {
   butil::Status status;
 
-  std::map<std::string, std::string> kvs;
-
   std::shared_ptr<SstFileReader> sst_reader = std::make_shared<SstFileReader>();
 
-  status = sst_reader->ReadFile(path, kvs);
-  if (!status.ok()) {
-    std::string s = fmt::format("read sst file failed. {}", status.error_str());
-    DINGO_LOG(ERROR) << s;
-    return butil::Status(dingodb::pb::error::Errno::EINTERNAL, s);
-  }
-
   int32_t i = 0;
-  for (const auto& [region_string, backup_data_file_value_sst_meta_group_string] : kvs) {
+  status = sst_reader->ReadFile(path, [&](const rocksdb::Slice& key, const rocksdb::Slice& value) {
+    std::string region_string = key.ToString();
     dingodb::pb::common::BackupDataFileValueSstMetaGroup backup_data_file_value_sst_meta_group;
-    auto ret = backup_data_file_value_sst_meta_group.ParseFromString(backup_data_file_value_sst_meta_group_string);
+    auto ret = backup_data_file_value_sst_meta_group.ParseFromArray(value.data(), value.size());
     if (!ret) {
       std::string s =
           fmt::format("parse dingodb::pb::common::BackupDataFileValueSstMetaGroup failed : {}", region_string);
@@ -1057,6 +1050,12 @@ butil::Status ToolDump::DumpRegionCfFunction(const std::string& path, std::strin
     content_detail +=
         fmt::format("\n[{}] [{}] :\n{}", i, region_string, backup_data_file_value_sst_meta_group.DebugString());
     i++;
+    return butil::Status::OK();
+  });
+  if (!status.ok()) {
+    std::string s = fmt::format("read sst file failed. {}", status.error_str());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(dingodb::pb::error::Errno::EINTERNAL, s);
   }
 
   content_summary += fmt::format("region cf nums = {}", std::to_string(i));
@@ -1068,21 +1067,13 @@ butil::Status ToolDump::DumpRegionDefinitionFunction(const std::string& path, st
                                                      std::string& content_brief, std::string& content_detail) {
   butil::Status status;
 
-  std::map<std::string, std::string> kvs;
-
   std::shared_ptr<SstFileReader> sst_reader = std::make_shared<SstFileReader>();
 
-  status = sst_reader->ReadFile(path, kvs);
-  if (!status.ok()) {
-    std::string s = fmt::format("read sst file failed. {}", status.error_str());
-    DINGO_LOG(ERROR) << s;
-    return butil::Status(dingodb::pb::error::Errno::EINTERNAL, s);
-  }
-
   int32_t i = 0;
-  for (const auto& [region_key_string, region_value_string] : kvs) {
+  status = sst_reader->ReadFile(path, [&](const rocksdb::Slice& key, const rocksdb::Slice& value) {
+    std::string region_key_string = key.ToString();
     dingodb::pb::common::Region region;
-    auto ret = region.ParseFromString(region_value_string);
+    auto ret = region.ParseFromArray(value.data(), value.size());
     if (!ret) {
       std::string s = fmt::format("parse dingodb::pb::common::Region failed : {}", region_key_string);
       DINGO_LOG(ERROR) << s;
@@ -1107,6 +1098,12 @@ butil::Status ToolDump::DumpRegionDefinitionFunction(const std::string& path, st
 
     content_detail += fmt::format("\n[{}] [{}] :\n{}", i, region_key_string, region.DebugString());
     i++;
+    return butil::Status::OK();
+  });
+  if (!status.ok()) {
+    std::string s = fmt::format("read sst file failed. {}", status.error_str());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(dingodb::pb::error::Errno::EINTERNAL, s);
   }
 
   content_summary += fmt::format("region definition nums = {}", std::to_string(i));
@@ -1118,43 +1115,24 @@ butil::Status ToolDump::DumpRegionDataFunction(const std::string& path, std::str
                                                std::string& content_brief, std::string& /*content_detail*/) {
   butil::Status status;
 
-  std::map<std::string, std::string> kvs;
+  // region data file may be large, stream it instead of loading whole file.
+  KvBrief kv_brief;
 
   std::shared_ptr<SstFileReader> sst_reader = std::make_shared<SstFileReader>();
 
-  status = sst_reader->ReadFile(path, kvs);
+  status = sst_reader->ReadFile(path, [&kv_brief](const rocksdb::Slice& key, const rocksdb::Slice& value) {
+    kv_brief.Add(std::string_view(key.data(), key.size()), std::string_view(value.data(), value.size()));
+    return butil::Status::OK();
+  });
   if (!status.ok()) {
     std::string s = fmt::format("read sst file failed. {}", status.error_str());
     DINGO_LOG(ERROR) << s;
     return butil::Status(dingodb::pb::error::Errno::EINTERNAL, s);
   }
 
-  int32_t i = 0;
-  int32_t size = kvs.size();
-  int32_t j = 0;
-  for (const auto& [key, value] : kvs) {
-    std::string key_hex;
-    std::string value_hex;
-    std::string key_hex_brief;
-    std::string value_hex_brief;
-
-    if (i < 3 || i >= (size - 3)) {
-      key_hex = dingodb::Helper::StringToHex(key);
-      value_hex = dingodb::Helper::StringToHex(value);
-
-      key_hex_brief = key_hex.size() > 64 ? key_hex.substr(0, 64) + "..." : key_hex;
-      value_hex_brief = value_hex.size() > 64 ? value_hex.substr(0, 64) + "..." : value_hex;
-
-      content_brief += fmt::format("\n[{}] [{}] : {}", i, key_hex_brief, value_hex_brief);
-    } else {
-      if (j++ == 0) content_brief += fmt::format("\n............");
-    }
-
-    // content_detail += fmt::format("\n[{}] [{}] : {}", i, key_hex, value_hex);
-    i++;
-  }
+  content_brief += kv_brief.ToString();
 
-  content_summary += fmt::format("region data key_value pairs = {}", std::to_string(i));
+  content_summary += fmt::format("region data key_value pairs = {}", std::to_string(kv_brief.Count()));
 
   return butil::Status::OK();
 }
@@ -18,6 +18,7 @@
 #include <iostream>
 
 #include "br/utils.h"
+#include "common/helper.h"
 #include "common/logging.h"
 #include "fmt/format.h"
 #include "proto/error.pb.h"
@@ -111,4 +112,96 @@ std::vector<std::string_view> ToolUtils::Split(std::string_view str, char delimi
   return result;
 }
 
-}  // namespace br
\ No newline at end of file
+std::vector<std::string> ToolUtils::SplitKeyRange(const std::string& start_key, const std::string& end_key, int num) {
+  std::vector<std::string> split_keys;
+  if (num <= 1 || start_key >= end_key) {
+    return split_keys;
+  }
+
+  size_t prefix_size = 0;
+  while (prefix_size < start_key.size() && prefix_size < end_key.size() &&
+         start_key[prefix_size] == end_key[prefix_size]) {
+    ++prefix_size;
+  }
+
+  // next 8 bytes after common prefix as big endian number, missing bytes as 0.
+  auto lambda_to_number_function = [prefix_size](const std::string& key) {
+    uint64_t number = 0;
+    for (size_t i = prefix_size; i < prefix_size + sizeof(uint64_t); ++i) {
+      number = (number << 8) | (i < key.size() ? static_cast<uint8_t>(key[i]) : 0);
+    }
+    return number;
+  };
+
+  uint64_t start_number = lambda_to_number_function(start_key);
+  uint64_t end_number = lambda_to_number_function(end_key);
+  uint64_t step = (end_number - start_number) / num;
+  if (end_number <= start_number || step == 0) {
+    return split_keys;
+  }
+
+  for (int i = 1; i < num; ++i) {
+    uint64_t number = start_number + step * i;
+    std::string split_key = start_key.substr(0, prefix_size);
+    for (int j = sizeof(uint64_t) - 1; j >= 0; --j) {
+      split_key.push_back(static_cast<char>((number >> (j * 8)) & 0xFF));
+    }
+    split_keys.push_back(std::move(split_key));
+  }
+
+  return split_keys;
+}
+
+std::string KvBrief::FormatKv(int64_t index, std::string_view key, std::string_view value) {
+  std::string key_hex = dingodb::Helper::StringToHex(key);
+  std::string value_hex = dingodb::Helper::StringToHex(value);
+
+  std::string key_hex_brief = key_hex.size() > 64 ? key_hex.substr(0, 64) + "..." : key_hex;
+  std::string value_hex_brief = value_hex.size() > 64 ? value_hex.substr(0, 64) + "..." : value_hex;
+
+  return fmt::format("\n[{}] [{}] : {}", index, key_hex_brief, value_hex_brief);
+}
+
+void KvBrief::Add(std::string_view key, std::string_view value) {
+  if (count_ < kBriefNum) {
+    head_.emplace_back(key, value);
+  } else {
+    tail_.emplace_back(key, value);
+    if (static_cast<int64_t>(tail_.size()) > kBriefNum) {
+      tail_.pop_front();
+    }
+  }
+  ++count_;
+}
+
+void KvBrief::Merge(const KvBrief& other) {
+  for (const auto& [key, value] : other.head_) {
+    Add(key, value);
+  }
+  // kvs between head and tail of other are not kept, only count them.
+  count_ += other.count_ - static_cast<int64_t>(other.head_.size() + other.tail_.size());
+  for (const auto& [key, value] : other.tail_) {
+    Add(key, value);
+  }
+}
+
+std::string KvBrief::ToString() const {
+  std::string content;
+  int64_t index = 0;
+  for (const auto& [key, value] : head_) {
+    content += FormatKv(index++, key, value);
+  }
+
+  if (count_ > kBriefNum * 2) {
+    content += fmt::format("\n............");
+  }
+
+  index = count_ - static_cast<int64_t>(tail_.size());
+  for (const auto& [key, value] : tail_) {
+    content += FormatKv(index++, key, value);
+  }
+
+  return content;
+}
+
+}  // namespace br
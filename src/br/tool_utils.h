@@ -15,8 +15,12 @@
 #ifndef DINGODB_BR_TOOL_UTILS_H_
 #define DINGODB_BR_TOOL_UTILS_H_
 
+#include <cstdint>
+#include <deque>
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "butil/status.h"
@@ -32,6 +36,8 @@ class ToolUtils {
   static butil::Status CheckParameterAndHandle(const std::string& br_diff_file, const std::string& br_diff_file_name,
                                                std::string& path_internal, std::string& file_name);
   static std::vector<std::string_view> Split(std::string_view str, char delimiter);
+  // split keys which cut [start_key, end_key] into about num even parts, interpolate bytes after common prefix.
+  static std::vector<std::string> SplitKeyRange(const std::string& start_key, const std::string& end_key, int num);
 
   template <typename Request>
   static void PrintRequest(const std::string& name, const Request& request) {
@@ -50,6 +56,25 @@ class ToolUtils {
   ToolUtils() = default;
   ~ToolUtils() = default;
 };
+
+// Brief of a sorted kv stream, keep the first and last kBriefNum kvs, memory not depend on kv count.
+class KvBrief {
+ public:
+  void Add(std::string_view key, std::string_view value);
+  // append brief of kvs which are all after kvs of this brief.
+  void Merge(const KvBrief& other);
+  std::string ToString() const;
+  int64_t Count() const { return count_; }
+
+ private:
+  static constexpr int64_t kBriefNum = 3;
+  static std::string FormatKv(int64_t index, std::string_view key, std::string_view value);
+
+  int64_t count_{0};
+  std::vector<std::pair<std::string, std::string>> head_;
+  std::deque<std::pair<std::string, std::string>> tail_;
+};
+
 }  // namespace br
 
 #endif  // DINGODB_BR_TOOL_UTILS_H_
\ No newline at end of file
@@ -0,0 +1,235 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "client_v2/batcher.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "proto/error.pb.h"
+#include "proto/store.pb.h"
+
+namespace client_v2 {
+
+KvBatcher::KvBatcher(int64_t window_us, int32_t max_batch_size, int32_t max_inflight_per_store)
+    : window_us_(window_us),
+      max_batch_size_(std::max(max_batch_size, 1)),
+      max_inflight_per_store_(std::max(max_inflight_per_store, 1)) {
+  bthread_mutex_init(&mutex_, nullptr);
+}
+
+KvBatcher::~KvBatcher() { bthread_mutex_destroy(&mutex_); }
+
+butil::Status KvBatcher::Get(const std::string& key, std::string& value) { return Submit(kGet, key, "", &value); }
+
+butil::Status KvBatcher::Put(const std::string& key, const std::string& value) {
+  return Submit(kPut, key, value, nullptr);
+}
+
+butil::Status KvBatcher::Submit(OpType type, const std::string& key, const std::string& value,
+                                std::string* get_value) {
+  auto region_entry = RegionRouter::GetInstance().QueryRegionEntry(key);
+  if (region_entry == nullptr) {
+    return butil::Status(dingodb::pb::error::EREGION_NOT_FOUND, "Not found region of key");
+  }
+  int64_t batch_key = region_entry->RegionId() * 2 + type;
+
+  BatchPtr batch;
+  bool is_leader = false;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = pending_batches_.find(batch_key);
+    if (it != pending_batches_.end()) {
+      // join collecting batch as follower, a full batch is taken away so next op start a new one
+      batch = it->second;
+      if (static_cast<int32_t>(batch->kvs.size()) + 1 >= max_batch_size_) {
+        pending_batches_.erase(it);
+      }
+    } else {
+      is_leader = true;
+      batch = std::make_shared<Batch>();
+      batch->type = type;
+      pending_batches_[batch_key] = batch;
+    }
+
+    auto* kv = &batch->kvs.emplace_back();
+    kv->set_key(key);
+    kv->set_value(value);
+  }
+
+  if (is_leader) {
+    // wait other ops join
+    bthread_usleep(window_us_);
+    {
+      BAIDU_SCOPED_LOCK(mutex_);
+      auto it = pending_batches_.find(batch_key);
+      if (it != pending_batches_.end() && it->second == batch) {
+        pending_batches_.erase(it);
+      }
+    }
+
+    // batch is not changed by others after it is taken away from pending_batches_
+    batch->status = SendKvs(type, batch->kvs, batch->values, 0);
+    batch->done_event.signal();
+  } else {
+    batch->done_event.wait();
+  }
+
+  if (batch->status.ok() && get_value != nullptr) {
+    auto it = batch->values.find(key);
+    *get_value = (it != batch->values.end()) ? it->second : "";
+  }
+  return batch->status;
+}
+
+butil::Status KvBatcher::SendKvs(OpType type, const std::vector<dingodb::pb::common::KeyValue>& kvs,
+                                 std::map<std::string, std::string>& values, int retry_count) {
+  // key: region_id
+  std::map<int64_t, std::pair<RegionEntryPtr, std::vector<dingodb::pb::common::KeyValue>>> region_kvs;
+  for (const auto& kv : kvs) {
+    auto region_entry = RegionRouter::GetInstance().QueryRegionEntry(kv.key());
+    if (region_entry == nullptr) {
+      return butil::Status(dingodb::pb::error::EREGION_NOT_FOUND, "Not found region of key");
+    }
+    auto& item = region_kvs[region_entry->RegionId()];
+    item.first = region_entry;
+    item.second.push_back(kv);
+  }
+
+  for (auto& [region_id, item] : region_kvs) {
+    dingodb::pb::error::Error error;
+    auto status = SendRegionKvs(type, item.first, item.second, values, error);
+    if (status.ok()) {
+      continue;
+    }
+
+    if ((error.errcode() != dingodb::pb::error::EREGION_VERSION &&
+         error.errcode() != dingodb::pb::error::EKEY_OUT_OF_RANGE) ||
+        retry_count >= kMaxRetry) {
+      return status;
+    }
+
+    // region split or merged, route these keys again
+    DINGO_LOG(INFO) << fmt::format("[batcher] region({}) epoch changed, retry({}) route {} keys", region_id,
+                                   retry_count, item.second.size());
+    if (error.has_store_region_info()) {
+      RegionRouter::GetInstance().UpdateRegionEntry(error.store_region_info());
+    } else {
+      item.first->SetDirty(true);
+    }
+    status = SendKvs(type, item.second, values, retry_count + 1);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status KvBatcher::SendRegionKvs(OpType type, RegionEntryPtr region_entry,
+                                       const std::vector<dingodb::pb::common::KeyValue>& kvs,
+                                       std::map<std::string, std::string>& values, dingodb::pb::error::Error& error) {
+  auto interaction = GetInteraction(region_entry);
+  if (interaction == nullptr) {
+    return butil::Status(dingodb::pb::error::EINTERNAL, "Init store interaction failed");
+  }
+
+  auto addrs = region_entry->GetAddrs();
+  std::string store_addr = addrs[interaction->GetLeader() % addrs.size()];
+  AcquireStore(store_addr);
+
+  butil::Status status;
+  if (type == kGet) {
+    dingodb::pb::store::KvBatchGetRequest request;
+    dingodb::pb::store::KvBatchGetResponse response;
+    *request.mutable_context() = region_entry->GenConext();
+    for (const auto& kv : kvs) {
+      request.add_keys(kv.key());
+    }
+    status = interaction->SendRequest("StoreService", "KvBatchGet", request, response);
+    for (const auto& kv : response.kvs()) {
+      values[kv.key()] = kv.value();
+    }
+    error = response.error();
+  } else {
+    dingodb::pb::store::KvBatchPutRequest request;
+    dingodb::pb::store::KvBatchPutResponse response;
+    *request.mutable_context() = region_entry->GenConext();
+    for (const auto& kv : kvs) {
+      *request.add_kvs() = kv;
+    }
+    status = interaction->SendRequest("StoreService", "KvBatchPut", request, response);
+    error = response.error();
+  }
+
+  ReleaseStore(store_addr);
+  return status;
+}
+
+ServerInteractionPtr KvBatcher::GetInteraction(RegionEntryPtr region_entry) {
+  auto addrs = region_entry->GetAddrs();
+  if (addrs.empty()) {
+    return nullptr;
+  }
+  std::string addrs_key;
+  for (const auto& addr : addrs) {
+    addrs_key += addr + ",";
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = interactions_.find(addrs_key);
+  if (it != interactions_.end()) {
+    return it->second;
+  }
+
+  auto interaction = std::make_shared<ServerInteraction>();
+  if (!interaction->Init(addrs)) {
+    return nullptr;
+  }
+  interactions_[addrs_key] = interaction;
+  return interaction;
+}
+
+void KvBatcher::AcquireStore(const std::string& store_addr) {
+  std::unique_lock<bthread_mutex_t> lock(mutex_);
+  auto& slot = store_slots_[store_addr];
+  if (slot == nullptr) {
+    slot = std::make_shared<StoreSlot>();
+  }
+  auto store_slot = slot;
+  while (store_slot->inflight_count >= max_inflight_per_store_) {
+    store_slot->cond.wait(lock);
+  }
+  ++store_slot->inflight_count;
+}
+
+void KvBatcher::ReleaseStore(const std::string& store_addr) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto& slot = store_slots_[store_addr];
+  --slot->inflight_count;
+  slot->cond.notify_one();
+}
+
+}  // namespace client_v2
@@ -0,0 +1,98 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_CLIENT_BATCHER_H_
+#define DINGODB_CLIENT_BATCHER_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bthread/condition_variable.h"
+#include "bthread/countdown_event.h"
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "client_v2/interation.h"
+#include "client_v2/router.h"
+#include "proto/common.pb.h"
+
+namespace client_v2 {
+
+// Group kv get/put of concurrent callers by region into KvBatchGet/KvBatchPut.
+// The first op of a region is leader, it wait a short window for other ops to join, then send the batch to the
+// region leader store. New ops start another batch while one is sending, so batches of a store are pipelined,
+// bounded by max_inflight_per_store. Batch is routed again by key after epoch change, e.g. region split.
+class KvBatcher {
+ public:
+  KvBatcher(int64_t window_us, int32_t max_batch_size, int32_t max_inflight_per_store);
+  ~KvBatcher();
+
+  KvBatcher(const KvBatcher&) = delete;
+  KvBatcher& operator=(const KvBatcher&) = delete;
+
+  // value is empty if key not exist.
+  butil::Status Get(const std::string& key, std::string& value);
+  butil::Status Put(const std::string& key, const std::string& value);
+
+ private:
+  enum OpType { kGet = 0, kPut };
+
+  struct Batch {
+    OpType type;
+    std::vector<dingodb::pb::common::KeyValue> kvs;
+    // key: value, result of get
+    std::map<std::string, std::string> values;
+    butil::Status status;
+    // leader signal when batch finish
+    bthread::CountdownEvent done_event{1};
+  };
+  using BatchPtr = std::shared_ptr<Batch>;
+
+  struct StoreSlot {
+    int32_t inflight_count{0};
+    bthread::ConditionVariable cond;
+  };
+
+  butil::Status Submit(OpType type, const std::string& key, const std::string& value, std::string* get_value);
+
+  // group kvs by region and send, retry with refreshed route when region epoch changed.
+  butil::Status SendKvs(OpType type, const std::vector<dingodb::pb::common::KeyValue>& kvs,
+                        std::map<std::string, std::string>& values, int retry_count);
+  butil::Status SendRegionKvs(OpType type, RegionEntryPtr region_entry,
+                              const std::vector<dingodb::pb::common::KeyValue>& kvs,
+                              std::map<std::string, std::string>& values, dingodb::pb::error::Error& error);
+
+  ServerInteractionPtr GetInteraction(RegionEntryPtr region_entry);
+  void AcquireStore(const std::string& store_addr);
+  void ReleaseStore(const std::string& store_addr);
+
+  int64_t window_us_;
+  int32_t max_batch_size_;
+  int32_t max_inflight_per_store_;
+
+  bthread_mutex_t mutex_;
+  // key: region_id * 2 + op type, collecting batch
+  std::map<int64_t, BatchPtr> pending_batches_;
+  // key: joined peer addrs of region
+  std::map<std::string, ServerInteractionPtr> interactions_;
+  // key: leader store addr
+  std::map<std::string, std::shared_ptr<StoreSlot>> store_slots_;
+};
+
+}  // namespace client_v2
+
+#endif  // DINGODB_CLIENT_BATCHER_H_
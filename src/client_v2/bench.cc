@@ -0,0 +1,532 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "client_v2/bench.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "client_v2/batcher.h"
+#include "client_v2/coordinator.h"
+#include "client_v2/helper.h"
+#include "client_v2/interation.h"
+#include "client_v2/router.h"
+#include "client_v2/store.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "coordinator/tso_control.h"
+#include "fmt/core.h"
+#include "nlohmann/json.hpp"
+#include "proto/common.pb.h"
+#include "proto/meta.pb.h"
+#include "proto/store.pb.h"
+
+namespace client_v2 {
+
+// ts fetched from coordinator in one request.
+static const int64_t kTsoBatchSize = 1000;
+// lock ttl of bench txn, ms.
+static const int64_t kTxnLockTtlMs = 10000;
+// theta of ycsb zipfian distribution.
+static const double kZipfianTheta = 0.99;
+
+enum BenchOp { kBenchRead = 0, kBenchUpdate, kBenchInsert, kBenchScan, kBenchReadModifyWrite, kBenchOpNum };
+static const char* kBenchOpNames[kBenchOpNum] = {"read", "update", "insert", "scan", "read_modify_write"};
+
+struct BenchWorkload {
+  // ratio of each BenchOp
+  double ratios[kBenchOpNum];
+  std::string distribution;
+};
+
+// ycsb core workloads.
+static bool GetBenchWorkload(const std::string& name, BenchWorkload& workload) {
+  if (name == "a") {
+    workload = {{0.5, 0.5, 0, 0, 0}, "zipfian"};
+  } else if (name == "b") {
+    workload = {{0.95, 0.05, 0, 0, 0}, "zipfian"};
+  } else if (name == "c") {
+    workload = {{1.0, 0, 0, 0, 0}, "zipfian"};
+  } else if (name == "d") {
+    workload = {{0.95, 0, 0.05, 0, 0}, "latest"};
+  } else if (name == "e") {
+    workload = {{0, 0, 0.05, 0.95, 0}, "zipfian"};
+  } else if (name == "f") {
+    workload = {{0.5, 0, 0, 0, 0.5}, "zipfian"};
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Zipfian rank generator of ycsb, rank 0 is the hottest.
+class ZipfianGenerator {
+ public:
+  ZipfianGenerator(int64_t items, double theta) : items_(std::max(items, static_cast<int64_t>(1))), theta_(theta) {
+    double zeta2 = Zeta(2, theta_);
+    zetan_ = Zeta(items_, theta_);
+    alpha_ = 1.0 / (1.0 - theta_);
+    eta_ = (1 - std::pow(2.0 / items_, 1 - theta_)) / (1 - zeta2 / zetan_);
+    half_pow_theta_ = 1.0 + std::pow(0.5, theta_);
+  }
+
+  // u is uniform in [0, 1)
+  int64_t Next(double u) const {
+    double uz = u * zetan_;
+    if (uz < 1.0) {
+      return 0;
+    }
+    if (uz < half_pow_theta_) {
+      return 1;
+    }
+    int64_t rank = static_cast<int64_t>(items_ * std::pow(eta_ * u - eta_ + 1, alpha_));
+    return std::min(rank, items_ - 1);
+  }
+
+ private:
+  static double Zeta(int64_t n, double theta) {
+    double sum = 0;
+    for (int64_t i = 1; i <= n; ++i) {
+      sum += 1 / std::pow(i, theta);
+    }
+    return sum;
+  }
+
+  int64_t items_;
+  double theta_;
+  double zetan_;
+  double alpha_;
+  double eta_;
+  double half_pow_theta_;
+};
+
+static uint64_t FnvHash64(uint64_t value) {
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  for (int i = 0; i < 8; ++i) {
+    hash ^= (value & 0xFF);
+    hash *= 1099511628211ULL;
+    value >>= 8;
+  }
+  return hash;
+}
+
+struct BenchContext {
+  BenchOptions opt;
+  BenchWorkload workload;
+  dingodb::pb::common::Region region;
+  std::string service_name;
+  std::unique_ptr<ZipfianGenerator> zipfian;
+  // group single key get/put of all threads, nullptr means one rpc per op
+  std::unique_ptr<KvBatcher> batcher;
+
+  // next id of insert, start from record_count
+  std::atomic<int64_t> next_insert_id{0};
+  std::atomic<int64_t> next_scan_id{0};
+  std::atomic<int64_t> issued_count{0};
+  std::atomic<int64_t> error_count{0};
+  int64_t deadline_ms{0};
+
+  std::mutex tso_mutex;
+  int64_t next_ts{0};
+  int64_t end_ts{0};
+};
+
+static std::string BenchKey(const BenchContext& ctx, int64_t id) {
+  return ctx.region.definition().range().start_key() + fmt::format("user{:012}", id);
+}
+
+static int64_t ChooseKeyId(BenchContext& ctx, std::mt19937_64& rng) {
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  int64_t key_count = std::max(ctx.next_insert_id.load(std::memory_order_relaxed), static_cast<int64_t>(1));
+  if (ctx.workload.distribution == "uniform") {
+    return rng() % key_count;
+  } else if (ctx.workload.distribution == "latest") {
+    return std::max(key_count - 1 - ctx.zipfian->Next(uniform(rng)), static_cast<int64_t>(0));
+  }
+
+  // scrambled zipfian, hot keys spread over key space.
+  int64_t hot_count = std::max(std::min(key_count, ctx.opt.record_count), static_cast<int64_t>(1));
+  return FnvHash64(ctx.zipfian->Next(uniform(rng))) % hot_count;
+}
+
+static bool GenTso(BenchContext& ctx, int64_t& ts) {
+  std::lock_guard<std::mutex> lock(ctx.tso_mutex);
+  if (ctx.next_ts >= ctx.end_ts) {
+    dingodb::pb::meta::TsoRequest request;
+    dingodb::pb::meta::TsoResponse response;
+    request.set_op_type(::dingodb::pb::meta::TsoOpType::OP_GEN_TSO);
+    request.set_count(kTsoBatchSize);
+
+    auto status = CoordinatorInteraction::GetInstance().GetCoorinatorInteractionMeta()->SendRequest(
+        "TsoService", request, response);
+    if (!status.ok() || response.error().errcode() != dingodb::pb::error::OK) {
+      DINGO_LOG(ERROR) << fmt::format("[bench] gen tso failed, {} {}", status.error_str(), response.error().errmsg());
+      return false;
+    }
+
+    ctx.next_ts =
+        (response.start_timestamp().physical() << ::dingodb::kLogicalBits) + response.start_timestamp().logical();
+    ctx.end_ts = ctx.next_ts + response.count();
+  }
+
+  ts = ctx.next_ts++;
+  return true;
+}
+
+template <typename Request, typename Response>
+static bool SendBenchRequest(BenchContext& ctx, const std::string& api_name, Request& request, Response& response) {
+  auto status = InteractionManager::GetInstance().SendRequestWithContext(ctx.service_name, api_name, request, response);
+  if (!status.ok() || response.error().errcode() != dingodb::pb::error::OK) {
+    DINGO_LOG(ERROR) << fmt::format("[bench] {} failed, {} {}", api_name, status.error_str(),
+                                    response.error().ShortDebugString());
+    return false;
+  }
+  return true;
+}
+
+static dingodb::pb::store::Context GenTxnContext(BenchContext& ctx) {
+  auto context = RegionRouter::GetInstance().GenConext(ctx.opt.region_id);
+  context.set_isolation_level(dingodb::pb::store::IsolationLevel::SnapshotIsolation);
+  return context;
+}
+
+static bool RawGet(BenchContext& ctx, const std::string& key) {
+  if (ctx.batcher != nullptr) {
+    std::string value;
+    return ctx.batcher->Get(key, value).ok();
+  }
+
+  dingodb::pb::store::KvGetRequest request;
+  dingodb::pb::store::KvGetResponse response;
+  *request.mutable_context() = RegionRouter::GetInstance().GenConext(ctx.opt.region_id);
+  request.set_key(key);
+  return SendBenchRequest(ctx, "KvGet", request, response);
+}
+
+static bool RawPut(BenchContext& ctx, const std::vector<std::string>& keys) {
+  if (ctx.batcher != nullptr && keys.size() == 1) {
+    return ctx.batcher->Put(keys.front(), Helper::GenRandomString(ctx.opt.value_size)).ok();
+  }
+
+  dingodb::pb::store::KvBatchPutRequest request;
+  dingodb::pb::store::KvBatchPutResponse response;
+  *request.mutable_context() = RegionRouter::GetInstance().GenConext(ctx.opt.region_id);
+  for (const auto& key : keys) {
+    auto* kv = request.add_kvs();
+    kv->set_key(key);
+    kv->set_value(Helper::GenRandomString(ctx.opt.value_size));
+  }
+  return SendBenchRequest(ctx, "KvBatchPut", request, response);
+}
+
+static bool RawScan(BenchContext& ctx, const std::string& key) {
+  int64_t scan_id = ctx.next_scan_id.fetch_add(1, std::memory_order_relaxed);
+
+  dingodb::pb::store::KvScanBeginRequestV2 request;
+  dingodb::pb::store::KvScanBeginResponseV2 response;
+  *request.mutable_context() = RegionRouter::GetInstance().GenConext(ctx.opt.region_id);
+  request.set_scan_id(scan_id);
+  request.mutable_range()->mutable_range()->set_start_key(key);
+  request.mutable_range()->mutable_range()->set_end_key(ctx.region.definition().range().end_key());
+  request.mutable_range()->set_with_start(true);
+  request.mutable_range()->set_with_end(false);
+  request.set_max_fetch_cnt(ctx.opt.scan_length);
+  bool is_ok = SendBenchRequest(ctx, "KvScanBeginV2", request, response);
+
+  dingodb::pb::store::KvScanReleaseRequestV2 release_request;
+  dingodb::pb::store::KvScanReleaseResponseV2 release_response;
+  *release_request.mutable_context() = RegionRouter::GetInstance().GenConext(ctx.opt.region_id);
+  release_request.set_scan_id(scan_id);
+  InteractionManager::GetInstance().SendRequestWithContext(ctx.service_name, "KvScanReleaseV2", release_request,
+                                                           release_response);
+  return is_ok;
+}
+
+static bool TxnGet(BenchContext& ctx, const std::string& key, int64_t start_ts) {
+  dingodb::pb::store::TxnGetRequest request;
+  dingodb::pb::store::TxnGetResponse response;
+  *request.mutable_context() = GenTxnContext(ctx);
+  request.set_key(key);
+  request.set_start_ts(start_ts);
+  return SendBenchRequest(ctx, "TxnGet", request, response);
+}
+
+// all keys are in one region, so try one pc, commit only when store not do one pc.
+static bool TxnPut(BenchContext& ctx, const std::vector<std::string>& keys, int64_t start_ts) {
+  dingodb::pb::store::TxnPrewriteRequest request;
+  dingodb::pb::store::TxnPrewriteResponse response;
+  *request.mutable_context() = GenTxnContext(ctx);
+  request.set_primary_lock(keys.front());
+  request.set_start_ts(start_ts);
+  request.set_lock_ttl(dingodb::Helper::TimestampMs() + kTxnLockTtlMs);
+  request.set_txn_size(keys.size());
+  request.set_try_one_pc(true);
+  for (const auto& key : keys) {
+    auto* mutation = request.add_mutations();
+    mutation->set_op(::dingodb::pb::store::Op::Put);
+    mutation->set_key(key);
+    mutation->set_value(Helper::GenRandomString(ctx.opt.value_size));
+  }
+  if (!SendBenchRequest(ctx, "TxnPrewrite", request, response)) {
+    return false;
+  }
+  if (response.one_pc_commit_ts() > 0) {
+    return true;
+  }
+
+  int64_t commit_ts = 0;
+  if (!GenTso(ctx, commit_ts)) {
+    return false;
+  }
+
+  dingodb::pb::store::TxnCommitRequest commit_request;
+  dingodb::pb::store::TxnCommitResponse commit_response;
+  *commit_request.mutable_context() = GenTxnContext(ctx);
+  commit_request.set_start_ts(start_ts);
+  commit_request.set_commit_ts(commit_ts);
+  for (const auto& key : keys) {
+    commit_request.add_keys(key);
+  }
+  return SendBenchRequest(ctx, "TxnCommit", commit_request, commit_response);
+}
+
+static bool TxnScan(BenchContext& ctx, const std::string& key, int64_t start_ts) {
+  dingodb::pb::store::TxnScanRequest request;
+  dingodb::pb::store::TxnScanResponse response;
+  *request.mutable_context() = GenTxnContext(ctx);
+  request.mutable_range()->mutable_range()->set_start_key(key);
+  request.mutable_range()->mutable_range()->set_end_key(ctx.region.definition().range().end_key());
+  request.mutable_range()->set_with_start(true);
+  request.mutable_range()->set_with_end(false);
+  request.set_limit(ctx.opt.scan_length);
+  request.set_start_ts(start_ts);
+  return SendBenchRequest(ctx, "TxnScan", request, response);
+}
+
+static bool DoBenchOp(BenchContext& ctx, BenchOp op, const std::string& key) {
+  bool is_txn = (ctx.opt.mode == "txn");
+  int64_t start_ts = 0;
+  if (is_txn && !GenTso(ctx, start_ts)) {
+    return false;
+  }
+
+  switch (op) {
+    case kBenchRead:
+      return is_txn ? TxnGet(ctx, key, start_ts) : RawGet(ctx, key);
+    case kBenchUpdate:
+    case kBenchInsert:
+      return is_txn ? TxnPut(ctx, {key}, start_ts) : RawPut(ctx, {key});
+    case kBenchScan:
+      return is_txn ? TxnScan(ctx, key, start_ts) : RawScan(ctx, key);
+    case kBenchReadModifyWrite:
+      if (is_txn) {
+        return TxnGet(ctx, key, start_ts) && TxnPut(ctx, {key}, start_ts);
+      }
+      return RawGet(ctx, key) && RawPut(ctx, {key});
+    default:
+      return false;
+  }
+}
+
+static void BenchLoadThread(BenchContext& ctx, int64_t start_id, int64_t end_id,
+                            std::vector<LatencyHistogram>& histograms) {
+  BenchPacer pacer(ctx.opt.rate, ctx.opt.concurrency);
+  for (int64_t id = start_id; id < end_id; id += ctx.opt.batch_size) {
+    std::vector<std::string> keys;
+    for (int64_t i = id; i < std::min(id + ctx.opt.batch_size, end_id); ++i) {
+      keys.push_back(BenchKey(ctx, i));
+    }
+
+    int64_t start_us = pacer.Wait();
+    bool is_ok = false;
+    if (ctx.opt.mode == "txn") {
+      int64_t start_ts = 0;
+      is_ok = GenTso(ctx, start_ts) && TxnPut(ctx, keys, start_ts);
+    } else {
+      is_ok = RawPut(ctx, keys);
+    }
+    histograms[kBenchInsert].Record(dingodb::Helper::TimestampUs() - start_us);
+    if (!is_ok) {
+      ctx.error_count.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+static void BenchRunThread(BenchContext& ctx, int32_t thread_no, std::vector<LatencyHistogram>& histograms) {
+  std::mt19937_64 rng(dingodb::Helper::TimestampNs() + thread_no);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  BenchPacer pacer(ctx.opt.rate, ctx.opt.concurrency);
+
+  while (true) {
+    if (ctx.opt.operation_count > 0 &&
+        ctx.issued_count.fetch_add(1, std::memory_order_relaxed) >= ctx.opt.operation_count) {
+      break;
+    }
+    if (ctx.deadline_ms > 0 && dingodb::Helper::TimestampMs() >= ctx.deadline_ms) {
+      break;
+    }
+
+    BenchOp op = kBenchRead;
+    double choice = uniform(rng);
+    for (int i = 0; i < kBenchOpNum; ++i) {
+      if (choice < ctx.workload.ratios[i]) {
+        op = static_cast<BenchOp>(i);
+        break;
+      }
+      choice -= ctx.workload.ratios[i];
+    }
+
+    int64_t key_id = (op == kBenchInsert) ? ctx.next_insert_id.fetch_add(1, std::memory_order_relaxed)
+                                          : ChooseKeyId(ctx, rng);
+
+    int64_t start_us = pacer.Wait();
+    bool is_ok = DoBenchOp(ctx, op, BenchKey(ctx, key_id));
+    histograms[op].Record(dingodb::Helper::TimestampUs() - start_us);
+    if (!is_ok) {
+      ctx.error_count.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+void SetUpBenchSubCommands(CLI::App& app) { SetUpBench(app); }
+
+void SetUpBench(CLI::App& app) {
+  auto opt = std::make_shared<BenchOptions>();
+  auto* cmd = app.add_subcommand("Bench", "Ycsb like benchmark of raw kv or txn on one region")->group("Bench Command");
+  cmd->add_option("--coor_url", opt->coor_url, "Coordinator url, default:file://./coor_list");
+  cmd->add_option("--region_id", opt->region_id, "Request parameter region id")->required();
+  cmd->add_option("--mode", opt->mode, "raw or txn")->default_val("raw")->check(CLI::IsMember({"raw", "txn"}));
+  cmd->add_option("--phase", opt->phase, "load or run")->default_val("run")->check(CLI::IsMember({"load", "run"}));
+  cmd->add_option("--workload", opt->workload, "ycsb workload a/b/c/d/e/f")
+      ->default_val("a")
+      ->check(CLI::IsMember({"a", "b", "c", "d", "e", "f"}));
+  cmd->add_option("--distribution", opt->distribution, "zipfian/uniform/latest, default is by workload")
+      ->check(CLI::IsMember({"", "zipfian", "uniform", "latest"}));
+  cmd->add_option("--record_count", opt->record_count, "Key count of load phase")->default_val(100000);
+  cmd->add_option("--operation_count", opt->operation_count, "Op count of run phase, 0 means no limit")
+      ->default_val(100000);
+  cmd->add_option("--duration_s", opt->duration_s, "Max seconds of run phase, 0 means no limit")->default_val(0);
+  cmd->add_option("--concurrency", opt->concurrency, "Thread count")->default_val(8)->check(CLI::PositiveNumber);
+  cmd->add_option("--rate", opt->rate, "Total ops per second, 0 means no limit")->default_val(0);
+  cmd->add_option("--value_size", opt->value_size, "Value size")->default_val(256);
+  cmd->add_option("--scan_length", opt->scan_length, "Kv count of one scan")->default_val(10);
+  cmd->add_option("--batch_size", opt->batch_size, "Kv count of one put in load phase, or max op of one batch")
+      ->default_val(100)
+      ->check(CLI::PositiveNumber);
+  cmd->add_option("--batch_window_us", opt->batch_window_us, "Group raw get/put of threads in window, 0 means not")
+      ->default_val(0);
+  cmd->add_option("--max_inflight_per_store", opt->max_inflight_per_store, "Max in flight batch rpc of one store")
+      ->default_val(4)
+      ->check(CLI::PositiveNumber);
+  cmd->add_option("--output", opt->output, "Json result file, default print to stdout");
+  cmd->callback([opt]() { RunBench(*opt); });
+}
+
+void RunBench(BenchOptions const& opt) {
+  if (Helper::SetUp(opt.coor_url) < 0) {
+    exit(-1);
+  }
+  auto status = InteractionManager::GetInstance().CreateStoreInteraction(opt.region_id);
+  if (!status.ok()) {
+    std::cout << "Create store interaction failed, error: " << status.error_cstr() << std::endl;
+    return;
+  }
+
+  auto ctx = std::make_shared<BenchContext>();
+  ctx->opt = opt;
+  GetBenchWorkload(opt.workload, ctx->workload);
+  if (!opt.distribution.empty()) {
+    ctx->workload.distribution = opt.distribution;
+  }
+  ctx->region = SendQueryRegion(opt.region_id);
+  if (ctx->region.id() == 0) {
+    std::cout << "GetRegion failed." << std::endl;
+    return;
+  }
+  ctx->service_name = GetServiceName(ctx->region);
+  ctx->zipfian = std::make_unique<ZipfianGenerator>(opt.record_count, kZipfianTheta);
+  ctx->next_insert_id = opt.record_count;
+  ctx->next_scan_id = dingodb::Helper::TimestampNs();
+  if (opt.batch_window_us > 0) {
+    ctx->batcher = std::make_unique<KvBatcher>(opt.batch_window_us, opt.batch_size, opt.max_inflight_per_store);
+  }
+  ctx->deadline_ms = opt.duration_s > 0 ? dingodb::Helper::TimestampMs() + opt.duration_s * 1000 : 0;
+
+  std::vector<std::vector<LatencyHistogram>> thread_histograms(opt.concurrency,
+                                                               std::vector<LatencyHistogram>(kBenchOpNum));
+  std::vector<std::thread> threads;
+  int64_t start_ms = dingodb::Helper::TimestampMs();
+  for (int32_t i = 0; i < opt.concurrency; ++i) {
+    if (opt.phase == "load") {
+      int64_t part_size = (opt.record_count + opt.concurrency - 1) / opt.concurrency;
+      int64_t start_id = std::min(part_size * i, opt.record_count);
+      int64_t end_id = std::min(start_id + part_size, opt.record_count);
+      threads.emplace_back(BenchLoadThread, std::ref(*ctx), start_id, end_id, std::ref(thread_histograms[i]));
+    } else {
+      threads.emplace_back(BenchRunThread, std::ref(*ctx), i, std::ref(thread_histograms[i]));
+    }
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  int64_t duration_ms = std::max(dingodb::Helper::TimestampMs() - start_ms, static_cast<int64_t>(1));
+
+  nlohmann::json result;
+  result["mode"] = opt.mode;
+  result["phase"] = opt.phase;
+  result["workload"] = opt.workload;
+  result["distribution"] = ctx->workload.distribution;
+  result["region_id"] = opt.region_id;
+  result["concurrency"] = opt.concurrency;
+  result["rate"] = opt.rate;
+  result["record_count"] = opt.record_count;
+  result["duration_ms"] = duration_ms;
+
+  int64_t total_count = 0;
+  for (int op = 0; op < kBenchOpNum; ++op) {
+    LatencyHistogram histogram;
+    for (const auto& histograms : thread_histograms) {
+      histogram.Merge(histograms[op]);
+    }
+    if (histogram.Count() > 0) {
+      result["latency"][kBenchOpNames[op]] = histogram.ToJson();
+      total_count += histogram.Count();
+    }
+  }
+  result["operation_count"] = total_count;
+  result["error_count"] = ctx->error_count.load();
+  result["throughput_ops"] = total_count * 1000.0 / duration_ms;
+
+  if (opt.output.empty()) {
+    std::cout << result.dump(2) << std::endl;
+    return;
+  }
+  std::ofstream output(opt.output);
+  output << result.dump(2) << std::endl;
+  std::cout << "bench result is written to " << opt.output << std::endl;
+}
+
+}  // namespace client_v2
@@ -0,0 +1,179 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_CLIENT_BENCH_H_
+#define DINGODB_CLIENT_BENCH_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CLI/CLI.hpp"
+#include "bthread/bthread.h"
+#include "common/helper.h"
+#include "nlohmann/json.hpp"
+
+namespace client_v2 {
+
+void SetUpBenchSubCommands(CLI::App &app);
+
+// Log linear latency histogram like hdr histogram, values below 2 * kSubBucketCount are exact, others are kept
+// with relative error below 1 / kSubBucketCount. Memory is fixed, each thread has own histograms and merge at end.
+class LatencyHistogram {
+ public:
+  LatencyHistogram() : counts_(kBucketCount, 0) {}
+
+  void Record(int64_t value) {
+    value = std::max(value, static_cast<int64_t>(0));
+    counts_[BucketIndex(value)]++;
+    count_++;
+    sum_ += value;
+    min_ = (count_ == 1) ? value : std::min(min_, value);
+    max_ = std::max(max_, value);
+  }
+
+  void Merge(const LatencyHistogram& other) {
+    if (other.count_ == 0) {
+      return;
+    }
+    for (int i = 0; i < kBucketCount; ++i) {
+      counts_[i] += other.counts_[i];
+    }
+    min_ = (count_ == 0) ? other.min_ : std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    count_ += other.count_;
+    sum_ += other.sum_;
+  }
+
+  int64_t Percentile(double percentile) const {
+    int64_t target = std::max(static_cast<int64_t>(std::ceil(percentile / 100 * count_)), static_cast<int64_t>(1));
+    int64_t accumulate = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+      accumulate += counts_[i];
+      if (accumulate >= target) {
+        return std::min(BucketHighestValue(i), max_);
+      }
+    }
+    return max_;
+  }
+
+  int64_t Count() const { return count_; }
+
+  nlohmann::json ToJson() const {
+    nlohmann::json json;
+    json["count"] = count_;
+    json["mean_us"] = count_ > 0 ? sum_ / count_ : 0;
+    json["min_us"] = min_;
+    json["max_us"] = max_;
+    json["p50_us"] = Percentile(50);
+    json["p90_us"] = Percentile(90);
+    json["p95_us"] = Percentile(95);
+    json["p99_us"] = Percentile(99);
+    json["p999_us"] = Percentile(99.9);
+    return json;
+  }
+
+ private:
+  static constexpr int kSubBucketBits = 5;
+  static constexpr int64_t kSubBucketCount = 1 << kSubBucketBits;
+  static constexpr int kBucketCount = 2 * kSubBucketCount + (63 - kSubBucketBits - 1) * kSubBucketCount;
+
+  static int BucketIndex(int64_t value) {
+    if (value < 2 * kSubBucketCount) {
+      return value;
+    }
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - kSubBucketBits;
+    return 2 * kSubBucketCount + (msb - kSubBucketBits - 1) * kSubBucketCount + ((value >> shift) - kSubBucketCount);
+  }
+
+  static int64_t BucketHighestValue(int index) {
+    if (index < 2 * kSubBucketCount) {
+      return index;
+    }
+    int msb = (index - 2 * kSubBucketCount) / kSubBucketCount + kSubBucketBits + 1;
+    int64_t sub_bucket = (index - 2 * kSubBucketCount) % kSubBucketCount + kSubBucketCount;
+    int shift = msb - kSubBucketBits;
+    return (sub_bucket << shift) + (static_cast<int64_t>(1) << shift) - 1;
+  }
+
+  std::vector<int64_t> counts_;
+  int64_t count_{0};
+  int64_t sum_{0};
+  int64_t min_{0};
+  int64_t max_{0};
+};
+
+// pace ops of one thread to rate / concurrency, latency is measured from scheduled time when rate is limited,
+// so a stall of server is not hidden by fewer requests.
+class BenchPacer {
+ public:
+  BenchPacer(int64_t rate, int32_t concurrency)
+      : interval_us_(rate > 0 ? static_cast<int64_t>(1000000.0 * concurrency / rate) : 0),
+        next_us_(dingodb::Helper::TimestampUs()) {}
+
+  int64_t Wait() {
+    int64_t now_us = dingodb::Helper::TimestampUs();
+    if (interval_us_ == 0) {
+      return now_us;
+    }
+    int64_t scheduled_us = next_us_;
+    next_us_ += interval_us_;
+    if (scheduled_us > now_us) {
+      bthread_usleep(scheduled_us - now_us);
+    }
+    return scheduled_us;
+  }
+
+ private:
+  int64_t interval_us_;
+  int64_t next_us_;
+};
+
+// ycsb like workload on one region, requests are sent to the region leader by RegionRouter.
+struct BenchOptions {
+  std::string coor_url;
+  int64_t region_id;
+  // raw or txn
+  std::string mode;
+  // load or run
+  std::string phase;
+  // a/b/c/d/e/f
+  std::string workload;
+  // zipfian, uniform or latest, empty means default of workload
+  std::string distribution;
+  int64_t record_count;
+  int64_t operation_count;
+  int64_t duration_s;
+  int32_t concurrency;
+  // total ops per second, 0 means no limit
+  int64_t rate;
+  int32_t value_size;
+  int32_t scan_length;
+  int32_t batch_size;
+  // group raw get/put of threads by KvBatcher, 0 means one rpc per op
+  int64_t batch_window_us;
+  int32_t max_inflight_per_store;
+  // json result file, empty means print to stdout
+  std::string output;
+};
+void SetUpBench(CLI::App &app);
+void RunBench(BenchOptions const &opt);
+
+}  // namespace client_v2
+
+#endif  // DINGODB_CLIENT_BENCH_H_
@@ -14,8 +14,11 @@
 
 #include "client_v2/interation.h"
 
+#include <algorithm>
 #include <memory>
+#include <numeric>
 #include <string>
+#include <vector>
 
 #include "bthread/bthread.h"
 #include "client_v2/helper.h"
@@ -24,6 +27,69 @@
 
 namespace client_v2 {
 
+ServerInteraction::ServerInteraction() : leader_index_(0), latency_(0) { bthread_mutex_init(&latency_mutex_, nullptr); }
+
+ServerInteraction::~ServerInteraction() { bthread_mutex_destroy(&latency_mutex_); }
+
+const google::protobuf::MethodDescriptor* ServerInteraction::FindMethod(const std::string& service_name,
+                                                                        const std::string& api_name) {
+  const google::protobuf::MethodDescriptor* method = nullptr;
+
+  if (service_name == "CoordinatorService") {
+    method = dingodb::pb::coordinator::CoordinatorService::descriptor()->FindMethodByName(api_name);
+  } else if (service_name == "MetaService") {
+    method = dingodb::pb::meta::MetaService::descriptor()->FindMethodByName(api_name);
+  } else if (service_name == "StoreService") {
+    method = dingodb::pb::store::StoreService::descriptor()->FindMethodByName(api_name);
+  } else if (service_name == "IndexService") {
+    method = dingodb::pb::index::IndexService::descriptor()->FindMethodByName(api_name);
+  } else if (service_name == "DocumentService") {
+    method = dingodb::pb::document::DocumentService::descriptor()->FindMethodByName(api_name);
+  } else if (service_name == "UtilService") {
+    method = dingodb::pb::util::UtilService::descriptor()->FindMethodByName(api_name);
+  } else if (service_name == "DebugService") {
+    method = dingodb::pb::debug::DebugService::descriptor()->FindMethodByName(api_name);
+  } else {
+    DINGO_LOG(FATAL) << "Unknown service name: " << service_name;
+  }
+
+  if (method == nullptr) {
+    DINGO_LOG(FATAL) << "Unknown api name: " << api_name;
+  }
+
+  return method;
+}
+
+void ServerInteraction::UpdateLatency(int index, int64_t latency_us) {
+  BAIDU_SCOPED_LOCK(latency_mutex_);
+  if (index >= ewma_latency_us_.size()) {
+    ewma_latency_us_.resize(index + 1, 0);
+  }
+
+  auto& ewma_latency_us = ewma_latency_us_[index];
+  if (ewma_latency_us == 0) {
+    ewma_latency_us = latency_us;
+  } else {
+    ewma_latency_us = static_cast<int64_t>(kLatencyEwmaAlpha * latency_us + (1 - kLatencyEwmaAlpha) * ewma_latency_us);
+  }
+}
+
+std::vector<int> ServerInteraction::SortByLatency() {
+  std::vector<int> replicas(channels_.size());
+  std::iota(replicas.begin(), replicas.end(), 0);
+
+  BAIDU_SCOPED_LOCK(latency_mutex_);
+  auto get_latency = [&](int index) { return index < ewma_latency_us_.size() ? ewma_latency_us_[index] : 0; };
+  std::stable_sort(replicas.begin(), replicas.end(),
+                   [&](int left, int right) { return get_latency(left) < get_latency(right); });
+
+  return replicas;
+}
+
+int64_t ServerInteraction::HedgeDelayUs() {
+  return std::max(latency_recorder_.latency_percentile(0.95), kHedgeMinDelayUs);
+}
+
 bool ServerInteraction::Init(const std::string& addrs) {
   std::vector<std::string> vec_addrs;
   butil::SplitString(addrs, ',', &vec_addrs);
@@ -20,6 +20,7 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <random>
 #include <string>
@@ -28,7 +29,11 @@
 #include "brpc/channel.h"
 #include "brpc/controller.h"
 #include "bthread/bthread.h"
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
 #include "bthread/types.h"
+#include "butil/time.h"
+#include "bvar/latency_recorder.h"
 #include "client_v2/router.h"
 #include "common/logging.h"
 #include "fmt/core.h"
@@ -46,11 +51,51 @@ namespace client_v2 {
 const int kMaxRetry = 5;
 const int64_t kTimeoutMs = 60000;
 const bool kLogEachRequest = true;
+// hedged request is sent not earlier than this, even p95 latency is lower.
+const int64_t kHedgeMinDelayUs = 2000;
+// weight of new sample in ewma latency of replica
+const double kLatencyEwmaAlpha = 0.2;
+
+template <typename Response>
+struct HedgeCall {
+  brpc::Controller cntl;
+  Response response;
+  bool done{false};
+  int64_t start_time_us{0};
+};
+
+// shared by hedged calls, the slower call may finish after request return.
+template <typename Response>
+struct HedgeState {
+  bthread::Mutex mutex;
+  bthread::ConditionVariable cond;
+  HedgeCall<Response> calls[2];
+};
+
+template <typename Response>
+class HedgeDone : public google::protobuf::Closure {
+ public:
+  HedgeDone(std::shared_ptr<HedgeState<Response>> state, int index) : state_(state), index_(index) {}
+  ~HedgeDone() override = default;
+
+  void Run() override {
+    {
+      std::unique_lock<bthread::Mutex> lock(state_->mutex);
+      state_->calls[index_].done = true;
+      state_->cond.notify_all();
+    }
+    delete this;
+  }
+
+ private:
+  std::shared_ptr<HedgeState<Response>> state_;
+  int index_;
+};
 
 class ServerInteraction {
  public:
-  ServerInteraction() : leader_index_(0){};
-  ~ServerInteraction() = default;
+  ServerInteraction();
+  ~ServerInteraction();
 
   ServerInteraction(const ServerInteraction&) = delete;
   const ServerInteraction& operator=(const ServerInteraction&) = delete;
@@ -72,13 +117,33 @@ class ServerInteraction {
   butil::Status AllSendRequest(const std::string& service_name, const std::string& api_name, const Request& request,
                                Response& response);
 
+  // Read which any replica can serve, e.g. stale read at ts. Send to replica with the lowest ewma latency, and
+  // send a hedged copy to the next fastest replica when no response within p95 latency, the slower is cancelled.
+  // Fallback to SendRequest when replicas refuse, e.g. follower read is disabled on store.
+  template <typename Request, typename Response>
+  butil::Status SendHedgedRequest(const std::string& service_name, const std::string& api_name,
+                                  const Request& request, Response& response);
+
   int64_t GetLatency() const { return latency_; }
 
  private:
+  static const google::protobuf::MethodDescriptor* FindMethod(const std::string& service_name,
+                                                              const std::string& api_name);
+
+  void UpdateLatency(int index, int64_t latency_us);
+  // replica index order by ewma latency, replica without latency is first, so every replica is measured.
+  std::vector<int> SortByLatency();
+  int64_t HedgeDelayUs();
+
   std::atomic<int> leader_index_;
   std::vector<butil::EndPoint> endpoints_;
   std::vector<std::unique_ptr<brpc::Channel> > channels_;
   int64_t latency_;
+
+  bthread_mutex_t latency_mutex_;
+  // ewma latency of each replica, index same as channels_.
+  std::vector<int64_t> ewma_latency_us_;
+  bvar::LatencyRecorder latency_recorder_;
 };
 
 using ServerInteractionPtr = std::shared_ptr<ServerInteraction>;
@@ -86,29 +151,7 @@ using ServerInteractionPtr = std::shared_ptr<ServerInteraction>;
 template <typename Request, typename Response>
 butil::Status ServerInteraction::SendRequest(const std::string& service_name, const std::string& api_name,
                                              const Request& request, Response& response) {
-  const google::protobuf::MethodDescriptor* method = nullptr;
-
-  if (service_name == "CoordinatorService") {
-    method = dingodb::pb::coordinator::CoordinatorService::descriptor()->FindMethodByName(api_name);
-  } else if (service_name == "MetaService") {
-    method = dingodb::pb::meta::MetaService::descriptor()->FindMethodByName(api_name);
-  } else if (service_name == "StoreService") {
-    method = dingodb::pb::store::StoreService::descriptor()->FindMethodByName(api_name);
-  } else if (service_name == "IndexService") {
-    method = dingodb::pb::index::IndexService::descriptor()->FindMethodByName(api_name);
-  } else if (service_name == "DocumentService") {
-    method = dingodb::pb::document::DocumentService::descriptor()->FindMethodByName(api_name);
-  } else if (service_name == "UtilService") {
-    method = dingodb::pb::util::UtilService::descriptor()->FindMethodByName(api_name);
-  } else if (service_name == "DebugService") {
-    method = dingodb::pb::debug::DebugService::descriptor()->FindMethodByName(api_name);
-  } else {
-    DINGO_LOG(FATAL) << "Unknown service name: " << service_name;
-  }
-
-  if (method == nullptr) {
-    DINGO_LOG(FATAL) << "Unknown api name: " << api_name;
-  }
+  const auto* method = FindMethod(service_name, api_name);
 
   int retry_count = 0;
   do {
@@ -134,6 +177,9 @@ butil::Status ServerInteraction::SendRequest(const std::string& service_name, co
       return butil::Status(cntl.ErrorCode(), cntl.ErrorText());
     }
 
+    UpdateLatency(leader_index, cntl.latency_us());
+    latency_recorder_ << cntl.latency_us();
+
     if (response.error().errcode() != dingodb::pb::error::OK) {
       if (response.error().errcode() == dingodb::pb::error::ERAFT_NOTLEADER ||
           response.error().errcode() == dingodb::pb::error::EREGION_NOT_FOUND) {
@@ -177,6 +223,94 @@ butil::Status ServerInteraction::AllSendRequest(const std::string& service_name,
   return butil::Status();
 }
 
+template <typename Request, typename Response>
+butil::Status ServerInteraction::SendHedgedRequest(const std::string& service_name, const std::string& api_name,
+                                                   const Request& request, Response& response) {
+  if (channels_.size() < 2) {
+    return SendRequest(service_name, api_name, request, response);
+  }
+
+  const auto* method = FindMethod(service_name, api_name);
+  auto replicas = SortByLatency();
+  int64_t hedge_delay_us = HedgeDelayUs();
+  auto state = std::make_shared<HedgeState<Response>>();
+
+  auto start_call = [&](int call_index) {
+    auto& call = state->calls[call_index];
+    call.cntl.set_timeout_ms(kTimeoutMs);
+    call.cntl.set_log_id(butil::fast_rand());
+    call.start_time_us = butil::gettimeofday_us();
+    channels_[replicas[call_index]]->CallMethod(method, &call.cntl, &request, &call.response,
+                                                new HedgeDone<Response>(state, call_index));
+  };
+  auto is_ok = [](HedgeCall<Response>& call) {
+    return !call.cntl.Failed() && call.response.error().errcode() == dingodb::pb::error::OK;
+  };
+
+  start_call(0);
+  int call_count = 1;
+  int winner = -1;
+  {
+    std::unique_lock<bthread::Mutex> lock(state->mutex);
+    if (!state->calls[0].done) {
+      state->cond.wait_for(lock, hedge_delay_us);
+    }
+    // slow or refused by first replica
+    if (!state->calls[0].done || !is_ok(state->calls[0])) {
+      lock.unlock();
+      start_call(1);
+      call_count = 2;
+      lock.lock();
+    }
+
+    for (;;) {
+      bool all_done = true;
+      for (int i = 0; i < call_count; ++i) {
+        if (!state->calls[i].done) {
+          all_done = false;
+        } else if (is_ok(state->calls[i])) {
+          winner = i;
+          break;
+        }
+      }
+      if (winner >= 0 || all_done) {
+        break;
+      }
+      state->cond.wait(lock);
+    }
+  }
+
+  int64_t now_us = butil::gettimeofday_us();
+  for (int i = 0; i < call_count; ++i) {
+    std::unique_lock<bthread::Mutex> lock(state->mutex);
+    auto& call = state->calls[i];
+    if (!call.done) {
+      // elapsed time is lower bound of latency of the slower replica.
+      brpc::StartCancel(call.cntl.call_id());
+      UpdateLatency(replicas[i], now_us - call.start_time_us);
+    } else {
+      UpdateLatency(replicas[i], call.cntl.Failed() ? now_us - call.start_time_us : call.cntl.latency_us());
+    }
+  }
+
+  if (winner < 0) {
+    return SendRequest(service_name, api_name, request, response);
+  }
+
+  auto& call = state->calls[winner];
+  if (kLogEachRequest) {
+    DINGO_LOG(INFO) << fmt::format("send hedged request api [{}] {} call_count: {} response: {} request: {}",
+                                   replicas[winner], api_name, call_count,
+                                   call.response.ShortDebugString().substr(0, 256),
+                                   request.ShortDebugString().substr(0, 256));
+  }
+  response.Swap(&call.response);
+  latency_ = call.cntl.latency_us();
+  latency_recorder_ << latency_;
+
+  return butil::Status();
+}
+
 class InteractionManager {
  public:
   static InteractionManager& GetInstance();
@@ -195,9 +329,10 @@ class InteractionManager {
   butil::Status SendRequestWithoutContext(const std::string& service_name, const std::string& api_name,
                                           const Request& request, Response& response);
 
+  // is_hedged is only for read which any replica can serve, see ServerInteraction::SendHedgedRequest.
   template <typename Request, typename Response>
   butil::Status SendRequestWithContext(const std::string& service_name, const std::string& api_name, Request& request,
-                                       Response& response);
+                                       Response& response, bool is_hedged = false);
 
   template <typename Request, typename Response>
   butil::Status AllSendRequestWithoutContext(const std::string& service_name, const std::string& api_name,
@@ -233,7 +368,7 @@ butil::Status InteractionManager::SendRequestWithoutContext(const std::string& s
 
 template <typename Request, typename Response>
 butil::Status InteractionManager::SendRequestWithContext(const std::string& service_name, const std::string& api_name,
-                                                         Request& request, Response& response) {
+                                                         Request& request, Response& response, bool is_hedged) {
   if (store_interaction_ == nullptr) {
     auto status = CreateStoreInteraction(request.context().region_id());
     if (!status.ok()) {
@@ -242,7 +377,8 @@ butil::Status InteractionManager::SendRequestWithContext(const std::string& serv
   }
 
   for (;;) {
-    auto status = store_interaction_->SendRequest(service_name, api_name, request, response);
+    auto status = is_hedged ? store_interaction_->SendHedgedRequest(service_name, api_name, request, response)
+                            : store_interaction_->SendRequest(service_name, api_name, request, response);
     if (status.ok()) {
       return status;
     }
@@ -29,6 +29,7 @@
 #include "brpc/channel.h"
 #include "brpc/controller.h"
 #include "bthread/bthread.h"
+#include "client_v2/bench.h"
 #include "client_v2/coordinator.h"
 #include "client_v2/document_index.h"
 #include "client_v2/dump.h"
@@ -232,6 +233,7 @@ int main(int argc, char* argv[]) {
   client_v2::SetUpToolSubCommands(app);
   client_v2::SetUpVectorIndexSubCommands(app);
   client_v2::SetUpRestoreSubCommands(app);
+  client_v2::SetUpBenchSubCommands(app);
 
   if (argc > 1) {
     CLI11_PARSE(app, argc, argv);
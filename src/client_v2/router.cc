@@ -14,7 +14,9 @@
 
 #include "client_v2/router.h"
 
+#include <iterator>
 #include <memory>
+#include <string>
 #include <utility>
 
 #include "client_v2/interation.h"
@@ -33,6 +35,18 @@ static dingodb::pb::common::Region SendQueryRegion(int64_t region_id) {
   return response.region();
 }
 
+// Query id of the region which contain key
+static int64_t SendQueryRegionIdByKey(const std::string& key) {
+  dingodb::pb::coordinator::ScanRegionsRequest request;
+  dingodb::pb::coordinator::ScanRegionsResponse response;
+
+  request.set_key(key);
+
+  InteractionManager::GetInstance().SendRequestWithoutContext("CoordinatorService", "ScanRegions", request, response);
+
+  return response.regions().empty() ? 0 : response.regions(0).region_id();
+}
+
 RegionEntry::RegionEntry(const dingodb::pb::common::Region& region) : region_(region), is_dirty_(false) {}
 
 std::shared_ptr<RegionEntry> RegionEntry::New(dingodb::pb::common::Region region) {
@@ -124,22 +138,36 @@ void RegionRouter::UpdateRegionEntry(const dingodb::pb::error::StoreRegionInfo&
 }
 
 RegionEntryPtr RegionRouter::QueryRegionEntry(const std::string& key) {
-  BAIDU_SCOPED_LOCK(mutex_);
+  RegionEntryPtr region_entry;
 
-  auto it = route_map_.lower_bound(key);
-  if (it == route_map_.end()) {
-    return nullptr;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+
+    // region with the greatest start_key not greater than key
+    auto it = route_map_.upper_bound(key);
+    if (it != route_map_.begin()) {
+      region_entry = std::prev(it)->second;
+    }
   }
-  auto region_entry = it->second;
-  if (region_entry->IsDirty()) {
+
+  if (region_entry != nullptr && region_entry->IsDirty()) {
+    UpdateRegion(region_entry);
   }
 
-  const auto& range = region_entry->Range();
-  if (key.compare(range.start_key()) >= 0 && key.compare(range.end_key()) < 0) {
-    return region_entry;
+  if (region_entry != nullptr) {
+    const auto& range = region_entry->Range();
+    if (key.compare(range.start_key()) >= 0 && key.compare(range.end_key()) < 0) {
+      return region_entry;
+    }
+  }
+
+  // not in cache or range changed by split/merge, get from coordinator
+  int64_t region_id = SendQueryRegionIdByKey(key);
+  if (region_id == 0) {
+    return nullptr;
   }
 
-  return nullptr;
+  return AddRegionEntry(region_id);
 }
 
 RegionEntryPtr RegionRouter::QueryRegionEntry(int64_t region_id) {
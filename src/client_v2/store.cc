@@ -415,6 +415,8 @@ void SetUpKvGet(CLI::App& app) {
   cmd->add_option("--coor_url", opt->coor_url, "Coordinator url, default:file://./coor_list");
   cmd->add_option("--region_id", opt->region_id, "Request parameter region id")->required();
   cmd->add_option("--key", opt->key, "Request parameter key")->required();
+  cmd->add_option("--ts", opt->ts, "Request parameter ts, read at ts is hedged to the fastest replicas")
+      ->default_val(0);
   cmd->callback([opt]() { RunKvGet(*opt); });
 }
 
@@ -2295,8 +2297,11 @@ void SendKvGet(KvGetOptions const& opt, std::string& value) {
   dingodb::pb::store::KvGetResponse response;
   *(request.mutable_context()) = RegionRouter::GetInstance().GenConext(opt.region_id);
   request.set_key(dingodb::Helper::HexToString(opt.key));
+  request.set_ts(opt.ts);
 
-  auto status = InteractionManager::GetInstance().SendRequestWithContext("StoreService", "KvGet", request, response);
+  // stale read at ts can be served by follower.
+  auto status =
+      InteractionManager::GetInstance().SendRequestWithContext("StoreService", "KvGet", request, response, opt.ts > 0);
   if (response.has_error() && response.error().errcode() != dingodb::pb::error::Errno::OK) {
     std::cout << "kv get failed, error: "
               << dingodb::pb::error::Errno_descriptor()->FindValueByNumber(response.error().errcode())->name() << " "
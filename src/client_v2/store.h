@@ -120,6 +120,7 @@ struct KvGetOptions {
   std::string coor_url;
   int64_t region_id;
   std::string key;
+  int64_t ts{0};
 };
 void SetUpKvGet(CLI::App &app);
 void RunKvGet(KvGetOptions const &opt);
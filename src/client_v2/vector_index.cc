@@ -14,11 +14,18 @@
 
 #include "client_v2/vector_index.h"
 
+#include <algorithm>
+#include <atomic>
 #include <climits>
 #include <cstdint>
+#include <fstream>
 #include <iostream>
+#include <random>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "client_v2/bench.h"
 #include "client_v2/helper.h"
 #include "client_v2/meta.h"
 #include "client_v2/pretty.h"
@@ -56,6 +63,8 @@ void SetUpVectorIndexSubCommands(CLI::App& app) {
   SetUpVectorCountMemory(app);
 
   SetUpIndexEnableOrDisableSplitAndMerge(app);
+
+  SetUpVectorBench(app);
 }
 
 static bool SetUpStore(const std::string& url, const std::vector<std::string>& addrs, int64_t region_id) {
@@ -2453,8 +2462,11 @@ void SendVectorBatchQuery(VectorBatchQueryOptions const& opt) {
     auto* keys = request.mutable_selected_keys()->Add();
     keys->assign(opt.key);
   }
+  request.set_ts(opt.ts);
 
-  InteractionManager::GetInstance().SendRequestWithContext("IndexService", "VectorBatchQuery", request, response);
+  // stale read at ts can be served by follower.
+  InteractionManager::GetInstance().SendRequestWithContext("IndexService", "VectorBatchQuery", request, response,
+                                                           opt.ts > 0);
 
   std::cout << "VectorBatchQuery response: " << response.DebugString() << std::endl;
 }
@@ -3399,6 +3411,8 @@ void SetUpVectorBatchQuery(CLI::App& app) {
   cmd->add_option("--without_table", opt->without_table, "Search vector without table data")
       ->default_val(false)
       ->default_str("false");
+  cmd->add_option("--ts", opt->ts, "Request parameter ts, read at ts is hedged to the fastest replicas")
+      ->default_val(0);
   cmd->callback([opt]() { RunVectorBatchQuery(*opt); });
 }
 
@@ -3944,4 +3958,334 @@ void RunIndexEnableOrDisableSplitAndMerge(IndexEnableOrDisableSplitAndMergeOptio
   }
 }
 
+
+// fvecs: for each vector, int32 dimension then dimension floats.
+static bool ReadFvecs(const std::string& path, int64_t max_count, std::vector<std::vector<float>>& vectors) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    std::cout << "open file failed, path: " << path << std::endl;
+    return false;
+  }
+
+  int32_t dimension = 0;
+  while ((max_count <= 0 || static_cast<int64_t>(vectors.size()) < max_count) &&
+         file.read(reinterpret_cast<char*>(&dimension), sizeof(dimension))) {
+    if (dimension <= 0 || (!vectors.empty() && dimension != static_cast<int32_t>(vectors.front().size()))) {
+      std::cout << fmt::format("invalid fvecs file {}, dimension {} at vector {}", path, dimension, vectors.size())
+                << std::endl;
+      return false;
+    }
+    std::vector<float> vector(dimension);
+    if (!file.read(reinterpret_cast<char*>(vector.data()), dimension * sizeof(float))) {
+      std::cout << fmt::format("truncated fvecs file {} at vector {}", path, vectors.size()) << std::endl;
+      return false;
+    }
+    vectors.push_back(std::move(vector));
+  }
+
+  return !vectors.empty();
+}
+
+// sample base vectors with id from region.
+static bool ScanVectorWithIds(int64_t region_id, int64_t max_count, std::vector<int64_t>& vector_ids,
+                              std::vector<std::vector<float>>& vectors) {
+  int64_t start_id = 0;
+  while (max_count <= 0 || static_cast<int64_t>(vectors.size()) < max_count) {
+    dingodb::pb::index::VectorScanQueryRequest request;
+    dingodb::pb::index::VectorScanQueryResponse response;
+    *(request.mutable_context()) = RegionRouter::GetInstance().GenConext(region_id);
+    request.set_vector_id_start(start_id);
+    request.set_vector_id_end(INT64_MAX);
+    request.set_max_scan_count(1000);
+    request.set_without_vector_data(false);
+    request.set_without_scalar_data(true);
+    request.set_without_table_data(true);
+
+    auto status =
+        InteractionManager::GetInstance().SendRequestWithContext("IndexService", "VectorScanQuery", request, response);
+    if (!status.ok() || response.error().errcode() != dingodb::pb::error::OK) {
+      std::cout << "VectorScanQuery failed: " << status.error_str() << " " << response.error().errmsg() << std::endl;
+      return false;
+    }
+    if (response.vectors_size() == 0) {
+      break;
+    }
+
+    for (const auto& vector : response.vectors()) {
+      if (max_count > 0 && static_cast<int64_t>(vectors.size()) >= max_count) {
+        break;
+      }
+      vector_ids.push_back(vector.id());
+      vectors.push_back(dingodb::Helper::PbRepeatedToVector(vector.vector().float_values()));
+      start_id = std::max(start_id, vector.id() + 1);
+    }
+  }
+
+  return !vectors.empty();
+}
+
+static bool AddBenchVectors(int64_t region_id, const std::vector<int64_t>& vector_ids,
+                            const std::vector<std::vector<float>>& vectors) {
+  const size_t kBatchSize = 1000;
+  for (size_t offset = 0; offset < vectors.size(); offset += kBatchSize) {
+    dingodb::pb::index::VectorAddRequest request;
+    dingodb::pb::index::VectorAddResponse response;
+    *(request.mutable_context()) = RegionRouter::GetInstance().GenConext(region_id);
+    for (size_t i = offset; i < std::min(offset + kBatchSize, vectors.size()); ++i) {
+      auto* vector_with_id = request.add_vectors();
+      vector_with_id->set_id(vector_ids[i]);
+      vector_with_id->mutable_vector()->set_dimension(vectors[i].size());
+      vector_with_id->mutable_vector()->set_value_type(dingodb::pb::common::ValueType::FLOAT);
+      for (auto value : vectors[i]) {
+        vector_with_id->mutable_vector()->add_float_values(value);
+      }
+    }
+
+    auto status =
+        InteractionManager::GetInstance().SendRequestWithContext("IndexService", "VectorAdd", request, response);
+    if (!status.ok() || response.error().errcode() != dingodb::pb::error::OK) {
+      std::cout << "VectorAdd failed: " << status.error_str() << " " << response.error().errmsg() << std::endl;
+      return false;
+    }
+    std::cout << fmt::format("\rload vectors {}/{}", std::min(offset + kBatchSize, vectors.size()), vectors.size())
+              << std::flush;
+  }
+  std::cout << std::endl;
+
+  return true;
+}
+
+// smaller is closer
+static float BenchDistance(const std::string& metric_type, const std::vector<float>& x, const std::vector<float>& y) {
+  if (metric_type == "ip") {
+    return -dingodb::Helper::DingoFaissInnerProduct(x.data(), y.data(), x.size());
+  } else if (metric_type == "cosine") {
+    float norm = std::sqrt(dingodb::Helper::DingoFaissInnerProduct(x.data(), x.data(), x.size()) *
+                           dingodb::Helper::DingoFaissInnerProduct(y.data(), y.data(), y.size()));
+    return norm > 0 ? -dingodb::Helper::DingoFaissInnerProduct(x.data(), y.data(), x.size()) / norm : 0;
+  }
+  return dingodb::Helper::DingoFaissL2sqr(x.data(), y.data(), x.size());
+}
+
+// brute force topn of each query, split queries by threads.
+static std::vector<std::vector<int64_t>> GenGroundTruth(const VectorBenchOptions& opt,
+                                                        const std::vector<int64_t>& base_ids,
+                                                        const std::vector<std::vector<float>>& base_vectors,
+                                                        const std::vector<std::vector<float>>& queries) {
+  std::vector<std::vector<int64_t>> ground_truth(queries.size());
+  std::atomic<size_t> next_query{0};
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < std::max(std::thread::hardware_concurrency(), 1U); ++t) {
+    threads.emplace_back([&]() {
+      std::vector<std::pair<float, int64_t>> distances(base_vectors.size());
+      size_t topn = std::min(static_cast<size_t>(opt.topn), base_vectors.size());
+      for (size_t i = next_query.fetch_add(1); i < queries.size(); i = next_query.fetch_add(1)) {
+        for (size_t j = 0; j < base_vectors.size(); ++j) {
+          distances[j] = {BenchDistance(opt.metric_type, queries[i], base_vectors[j]), base_ids[j]};
+        }
+        std::partial_sort(distances.begin(), distances.begin() + topn, distances.end());
+        for (size_t j = 0; j < topn; ++j) {
+          ground_truth[i].push_back(distances[j].second);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return ground_truth;
+}
+
+struct VectorBenchSetting {
+  int64_t ef_search{0};
+  int64_t nprobe{0};
+  int64_t qps{0};
+};
+
+// search all queries once with the setting, return json of recall and latency.
+static nlohmann::json RunVectorBenchSetting(const VectorBenchOptions& opt, const VectorBenchSetting& setting,
+                                            const std::vector<std::vector<float>>& queries,
+                                            const std::vector<std::vector<int64_t>>& ground_truth) {
+  std::atomic<size_t> next_query{0};
+  std::atomic<int64_t> hit_count{0};
+  std::atomic<int64_t> expect_count{0};
+  std::atomic<int64_t> error_count{0};
+  std::vector<LatencyHistogram> histograms(opt.concurrency);
+
+  auto search_function = [&](int32_t thread_no) {
+    BenchPacer pacer(setting.qps, opt.concurrency);
+    for (size_t i = next_query.fetch_add(1); i < queries.size(); i = next_query.fetch_add(1)) {
+      dingodb::pb::index::VectorSearchRequest request;
+      dingodb::pb::index::VectorSearchResponse response;
+      *(request.mutable_context()) = RegionRouter::GetInstance().GenConext(opt.region_id);
+      auto* vector = request.add_vector_with_ids()->mutable_vector();
+      vector->set_dimension(queries[i].size());
+      vector->set_value_type(dingodb::pb::common::ValueType::FLOAT);
+      for (auto value : queries[i]) {
+        vector->add_float_values(value);
+      }
+      request.mutable_parameter()->set_top_n(opt.topn);
+      request.mutable_parameter()->set_without_vector_data(true);
+      request.mutable_parameter()->set_without_scalar_data(true);
+      request.mutable_parameter()->set_without_table_data(true);
+      if (setting.ef_search > 0) {
+        request.mutable_parameter()->mutable_hnsw()->set_efsearch(setting.ef_search);
+      }
+      if (setting.nprobe > 0) {
+        request.mutable_parameter()->mutable_ivf_flat()->set_nprobe(setting.nprobe);
+        request.mutable_parameter()->mutable_ivf_pq()->set_nprobe(setting.nprobe);
+      }
+
+      int64_t start_us = pacer.Wait();
+      auto status =
+          InteractionManager::GetInstance().SendRequestWithContext("IndexService", "VectorSearch", request, response);
+      histograms[thread_no].Record(dingodb::Helper::TimestampUs() - start_us);
+      if (!status.ok() || response.error().errcode() != dingodb::pb::error::OK ||
+          response.batch_results_size() != 1) {
+        error_count.fetch_add(1);
+        continue;
+      }
+
+      int64_t hit = 0;
+      for (const auto& vector_with_distance : response.batch_results(0).vector_with_distances()) {
+        int64_t id = vector_with_distance.vector_with_id().id();
+        hit += std::count(ground_truth[i].begin(), ground_truth[i].end(), id);
+      }
+      hit_count.fetch_add(hit);
+      expect_count.fetch_add(ground_truth[i].size());
+    }
+  };
+
+  int64_t start_ms = dingodb::Helper::TimestampMs();
+  std::vector<std::thread> threads;
+  for (int32_t i = 0; i < opt.concurrency; ++i) {
+    threads.emplace_back(search_function, i);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  int64_t duration_ms = std::max(dingodb::Helper::TimestampMs() - start_ms, static_cast<int64_t>(1));
+
+  LatencyHistogram histogram;
+  for (const auto& thread_histogram : histograms) {
+    histogram.Merge(thread_histogram);
+  }
+
+  nlohmann::json result;
+  result["ef_search"] = setting.ef_search;
+  result["nprobe"] = setting.nprobe;
+  result["target_qps"] = setting.qps;
+  result["qps"] = histogram.Count() * 1000.0 / duration_ms;
+  result["recall"] = expect_count.load() > 0 ? static_cast<double>(hit_count.load()) / expect_count.load() : 0;
+  result["error_count"] = error_count.load();
+  result["latency"] = histogram.ToJson();
+  return result;
+}
+
+void SetUpVectorBench(CLI::App& app) {
+  auto opt = std::make_shared<VectorBenchOptions>();
+  auto* cmd = app.add_subcommand("VectorBench", "Vector search recall and latency per search parameter")
+                  ->group("Vector Command");
+  cmd->add_option("--coor_url", opt->coor_url, "Coordinator url, default:file://./coor_list");
+  cmd->add_option("--region_id", opt->region_id, "Request parameter region id")->required();
+  cmd->add_option("--dataset_path", opt->dataset_path, "Base vectors fvecs file, empty means sample from region");
+  cmd->add_option("--query_path", opt->query_path, "Query vectors fvecs file, empty means sample from base vectors");
+  cmd->add_option("--base_count", opt->base_count, "Max base vector count, 0 means all")->default_val(0);
+  cmd->add_option("--query_count", opt->query_count, "Query vector count")->default_val(1000);
+  cmd->add_option("--load", opt->load, "Add base vectors to region before bench")
+      ->default_val(false)
+      ->default_str("false");
+  cmd->add_option("--topn", opt->topn, "Request parameter topn")->default_val(10)->check(CLI::PositiveNumber);
+  cmd->add_option("--metric_type", opt->metric_type, "Metric type of index, l2|ip|cosine")
+      ->default_val("l2")
+      ->check(CLI::IsMember({"l2", "ip", "cosine"}));
+  cmd->add_option("--ef_searchs", opt->ef_searchs, "hnsw search ef list, e.g. 16,32,64")->default_val("0");
+  cmd->add_option("--nprobes", opt->nprobes, "ivf search nprobe list, e.g. 8,16,32")->default_val("0");
+  cmd->add_option("--qpses", opt->qpses, "Target qps list, 0 means no limit")->default_val("0");
+  cmd->add_option("--concurrency", opt->concurrency, "Search thread count")->default_val(8)->check(CLI::PositiveNumber);
+  cmd->add_option("--output", opt->output, "Json result file, default print to stdout");
+  cmd->callback([opt]() { RunVectorBench(*opt); });
+}
+
+void RunVectorBench(VectorBenchOptions const& opt) {
+  if (!SetUpStore(opt.coor_url, {}, opt.region_id)) {
+    exit(-1);
+  }
+
+  std::vector<int64_t> base_ids;
+  std::vector<std::vector<float>> base_vectors;
+  if (!opt.dataset_path.empty()) {
+    if (!ReadFvecs(opt.dataset_path, opt.base_count, base_vectors)) {
+      return;
+    }
+    for (size_t i = 0; i < base_vectors.size(); ++i) {
+      base_ids.push_back(i + 1);
+    }
+    if (opt.load && !AddBenchVectors(opt.region_id, base_ids, base_vectors)) {
+      return;
+    }
+  } else if (!ScanVectorWithIds(opt.region_id, opt.base_count, base_ids, base_vectors)) {
+    std::cout << "no base vector in region " << opt.region_id << std::endl;
+    return;
+  }
+
+  std::vector<std::vector<float>> queries;
+  if (!opt.query_path.empty()) {
+    if (!ReadFvecs(opt.query_path, opt.query_count, queries)) {
+      return;
+    }
+  } else {
+    std::mt19937_64 rng(opt.region_id);
+    std::uniform_int_distribution<size_t> distrib(0, base_vectors.size() - 1);
+    for (int64_t i = 0; i < opt.query_count; ++i) {
+      queries.push_back(base_vectors[distrib(rng)]);
+    }
+  }
+  if (queries.empty() || queries.front().size() != base_vectors.front().size()) {
+    std::cout << "query dimension not match base vector" << std::endl;
+    return;
+  }
+
+  std::cout << fmt::format("base vectors {}, queries {}, dimension {}, computing ground truth...", base_vectors.size(),
+                           queries.size(), base_vectors.front().size())
+            << std::endl;
+  auto ground_truth = GenGroundTruth(opt, base_ids, base_vectors, queries);
+
+  std::vector<int64_t> ef_searchs, nprobes, qpses;
+  dingodb::Helper::SplitString(opt.ef_searchs, ',', ef_searchs);
+  dingodb::Helper::SplitString(opt.nprobes, ',', nprobes);
+  dingodb::Helper::SplitString(opt.qpses, ',', qpses);
+
+  nlohmann::json result;
+  result["region_id"] = opt.region_id;
+  result["base_count"] = base_vectors.size();
+  result["query_count"] = queries.size();
+  result["topn"] = opt.topn;
+  result["concurrency"] = opt.concurrency;
+  result["results"] = nlohmann::json::array();
+  for (auto ef_search : ef_searchs) {
+    for (auto nprobe : nprobes) {
+      for (auto qps : qpses) {
+        auto setting_result = RunVectorBenchSetting(opt, {ef_search, nprobe, qps}, queries, ground_truth);
+        const auto& latency = setting_result["latency"];
+        std::cout << fmt::format("ef_search {} nprobe {} target_qps {}: recall {:.4f} qps {:.1f} p50 {}us p99 {}us",
+                                 ef_search, nprobe, qps, setting_result["recall"].get<double>(),
+                                 setting_result["qps"].get<double>(), latency["p50_us"].get<int64_t>(),
+                                 latency["p99_us"].get<int64_t>())
+                  << std::endl;
+        result["results"].push_back(setting_result);
+      }
+    }
+  }
+
+  if (opt.output.empty()) {
+    std::cout << result.dump(2) << std::endl;
+    return;
+  }
+  std::ofstream output(opt.output);
+  output << result.dump(2) << std::endl;
+  std::cout << "bench result is written to " << opt.output << std::endl;
+}
+
 }  // namespace client_v2
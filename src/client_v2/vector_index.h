@@ -177,6 +177,7 @@ struct VectorBatchQueryOptions {
   bool without_vector;
   bool without_scalar;
   bool without_table;
+  int64_t ts{0};
 };
 void SetUpVectorBatchQuery(CLI::App &app);
 void RunVectorBatchQuery(VectorBatchQueryOptions const &opt);
@@ -408,6 +409,33 @@ struct IndexEnableOrDisableSplitAndMergeOptions {
 void SetUpIndexEnableOrDisableSplitAndMerge(CLI::App &app);
 void RunIndexEnableOrDisableSplitAndMerge(IndexEnableOrDisableSplitAndMergeOptions const &opt);
 
+// recall and latency of vector search for each search parameter, ground truth is brute force on client.
+struct VectorBenchOptions {
+  std::string coor_url;
+  int64_t region_id;
+  // base vectors in fvecs, e.g. sift_base.fvecs, empty means sample from region
+  std::string dataset_path;
+  // query vectors in fvecs, empty means sample from base vectors
+  std::string query_path;
+  int64_t base_count;
+  int64_t query_count;
+  // add base vectors of dataset to region before bench, vector id start from 1
+  bool load;
+  int32_t topn;
+  // l2, ip or cosine, same as index
+  std::string metric_type;
+  // comma separated, e.g. 16,32,64
+  std::string ef_searchs;
+  std::string nprobes;
+  // comma separated total qps, 0 means no limit
+  std::string qpses;
+  int32_t concurrency;
+  // json result file, empty means print to stdout
+  std::string output;
+};
+void SetUpVectorBench(CLI::App &app);
+void RunVectorBench(VectorBenchOptions const &opt);
+
 // vector
 int64_t SendVectorCountMemory(VectorCountMemoryOptions const &opt);
 void SendVectorDump(VectorDumpOptions const &opt);
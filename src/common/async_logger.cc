@@ -0,0 +1,180 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/async_logger.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "brpc/reloadable_flags.h"
+#include "butil/compiler_specific.h"
+#include "bvar/reducer.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_async_log, true, "write INFO/WARNING/ERROR log file in background thread, take effect at startup");
+DEFINE_int64(async_log_buffer_max_bytes, 64 * 1024 * 1024, "max pending bytes of one async logger, drop when full");
+BRPC_VALIDATE_GFLAG(async_log_buffer_max_bytes, brpc::PositiveInteger);
+DEFINE_int64(async_log_flush_interval_ms, 100, "interval of async logger write pending log to file");
+BRPC_VALIDATE_GFLAG(async_log_flush_interval_ms, brpc::PositiveInteger);
+
+bvar::Adder<int64_t> g_async_log_dropped_count("dingo_async_log_dropped_count");
+
+static std::vector<AsyncLogger*> g_async_loggers;
+
+[[noreturn]] static void FailureFunction() {
+  AsyncLogger::FlushAll();
+  abort();
+}
+
+AsyncLogger::AsyncLogger(google::base::Logger* wrapped) : wrapped_(wrapped) {}
+
+AsyncLogger::~AsyncLogger() { Stop(); }
+
+void AsyncLogger::Start() { thread_ = std::thread([this]() { RunThread(); }); }
+
+void AsyncLogger::Stop() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (is_stop_) {
+      return;
+    }
+    is_stop_ = true;
+  }
+  cond_.notify_one();
+
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  wrapped_->Flush();
+}
+
+void AsyncLogger::Write(bool force_flush, time_t timestamp, const char* message, size_t message_len) {
+  bool is_notify = false;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (BAIDU_UNLIKELY(is_stop_)) {
+      lock.unlock();
+      wrapped_->Write(force_flush, timestamp, message, message_len);
+      return;
+    }
+
+    if (BAIDU_UNLIKELY(active_buffer_.data.size() + message_len > FLAGS_async_log_buffer_max_bytes)) {
+      ++dropped_count_;
+      g_async_log_dropped_count << 1;
+      return;
+    }
+
+    active_buffer_.entries.push_back(Entry{timestamp, active_buffer_.data.size(), message_len});
+    active_buffer_.data.append(message, message_len);
+    ++write_seq_;
+    // glog force flush message above logbuflevel, only wake up writer instead of wait.
+    if (force_flush) {
+      active_buffer_.force_flush = true;
+      is_notify = true;
+    }
+  }
+
+  if (is_notify) {
+    cond_.notify_one();
+  }
+}
+
+void AsyncLogger::Flush() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t target_seq = write_seq_;
+    active_buffer_.force_flush = true;
+    cond_.notify_one();
+    flush_cond_.wait(lock, [this, target_seq]() { return is_stop_ || flushed_seq_ >= target_seq; });
+  }
+
+  wrapped_->Flush();
+}
+
+uint32_t AsyncLogger::LogSize() { return wrapped_->LogSize(); }
+
+void AsyncLogger::RunThread() {
+  for (;;) {
+    int64_t dropped_count = 0;
+    uint64_t seq = 0;
+    bool is_stop = false;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait_for(lock, std::chrono::milliseconds(FLAGS_async_log_flush_interval_ms),
+                     [this]() { return is_stop_ || active_buffer_.force_flush; });
+
+      std::swap(active_buffer_, flushing_buffer_);
+      dropped_count = dropped_count_;
+      dropped_count_ = 0;
+      seq = write_seq_;
+      is_stop = is_stop_;
+    }
+
+    for (const auto& entry : flushing_buffer_.entries) {
+      wrapped_->Write(false, entry.timestamp, flushing_buffer_.data.data() + entry.offset, entry.len);
+    }
+    if (dropped_count > 0) {
+      std::string message = fmt::format("[async_log] buffer is full, dropped {} log message.\n", dropped_count);
+      wrapped_->Write(false, time(nullptr), message.data(), message.size());
+    }
+    if (flushing_buffer_.force_flush) {
+      wrapped_->Flush();
+    }
+    flushing_buffer_.Clear();
+
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      flushed_seq_ = seq;
+    }
+    flush_cond_.notify_all();
+
+    if (is_stop) {
+      break;
+    }
+  }
+}
+
+void AsyncLogger::Install() {
+  if (!FLAGS_enable_async_log) {
+    return;
+  }
+
+  for (auto severity : {google::GLOG_INFO, google::GLOG_WARNING, google::GLOG_ERROR}) {
+    auto* logger = new AsyncLogger(google::base::GetLogger(severity));
+    logger->Start();
+    google::base::SetLogger(severity, logger);
+    g_async_loggers.push_back(logger);
+  }
+
+  // write pending log before abort on FATAL.
+  google::InstallFailureFunction(&FailureFunction);
+}
+
+void AsyncLogger::FlushAll() {
+  for (auto* logger : g_async_loggers) {
+    logger->Flush();
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,96 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COMMON_ASYNC_LOGGER_H_
+#define DINGODB_COMMON_ASYNC_LOGGER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "glog/logging.h"
+
+namespace dingodb {
+
+// Async glog file logger, wrap the logger of one severity.
+// Glog format message in caller thread and call Write() under its log lock, Write() only append message to buffer,
+// a background thread write buffer to wrapped logger, so file write and flush is out of the lock.
+// Message is dropped and counted when buffer is full.
+class AsyncLogger : public google::base::Logger {
+ public:
+  explicit AsyncLogger(google::base::Logger* wrapped);
+  ~AsyncLogger() override;
+
+  AsyncLogger(const AsyncLogger&) = delete;
+  AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+  void Write(bool force_flush, time_t timestamp, const char* message, size_t message_len) override;
+  // wait buffer is written and flush wrapped logger.
+  void Flush() override;
+  uint32_t LogSize() override;
+
+  void Start();
+  void Stop();
+
+  // replace logger of INFO/WARNING/ERROR, FATAL is still sync.
+  static void Install();
+  // write all pending message, e.g. before abort.
+  static void FlushAll();
+
+ private:
+  struct Entry {
+    time_t timestamp;
+    size_t offset;
+    size_t len;
+  };
+
+  struct Buffer {
+    std::string data;
+    std::vector<Entry> entries;
+    bool force_flush{false};
+
+    void Clear() {
+      data.clear();
+      entries.clear();
+      force_flush = false;
+    }
+  };
+
+  void RunThread();
+
+  google::base::Logger* wrapped_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::condition_variable flush_cond_;
+  Buffer active_buffer_;
+  Buffer flushing_buffer_;
+  // times of buffer is written, for Flush() wait.
+  uint64_t write_seq_{0};
+  uint64_t flushed_seq_{0};
+  int64_t dropped_count_{0};
+  bool is_stop_{false};
+
+  std::thread thread_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_ASYNC_LOGGER_H_
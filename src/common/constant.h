@@ -108,6 +108,9 @@ class Constant {
   inline static const std::string kStorePathConfigName = "store.path";
   inline static const std::string kColumnFamilies = "store.column_families";
   inline static const std::string kBaseColumnFamily = "store.base";
+  // tiered storage, bottom levels sst files of tiered column families place at cold path
+  inline static const std::string kStoreColdPathConfigName = "store.cold_path";
+  inline static const std::string kStoreHotPathTargetSizeConfigName = "store.hot_path_target_size";
 
   inline static const std::string kBlockSize = "block_size";
   inline static const std::string kBlockSizeDefaultValue = "131072";  // 128KB
@@ -125,15 +128,45 @@ class Constant {
   inline static const std::string kWriteBufferSizeDefaultValue = "67108864";  // 64MB
   inline static const std::string kPrefixExtractor = "prefix_extractor";
   inline static const std::string kPrefixExtractorDefaultValue = "24";
+  // region prefix(1 byte) + partition id(8 bytes) is 10 bytes after mem-comparable encode
+  static constexpr size_t kPrefixExtractorMinLength = 10;
   inline static const std::string kMaxBytesForLevelBase = "max_bytes_for_level_base";
   inline static const std::string kMaxBytesForLevelBaseDefaultValue = "134217728";  // 128MB
   inline static const std::string kTargetFileSizeBase = "target_file_size_base";
   inline static const std::string kTargetFileSizeBaseDefaultValue = "67108864";  // 64MB
   inline static const std::string kMaxBytesForLevelMultiplier = "max_bytes_for_level_multiplier";
   inline static const std::string kMaxBytesForLevelMultiplierDefaultValue = "10";
+  // bloom/ribbon/none
+  inline static const std::string kFilterPolicy = "filter_policy";
+  inline static const std::string kFilterPolicyDefaultValue = "bloom";
+  inline static const std::string kFilterBitsPerKey = "filter_bits_per_key";
+  inline static const std::string kFilterBitsPerKeyDefaultValue = "10";
+  // partitioned index and filters
+  inline static const std::string kPartitionFilters = "partition_filters";
+  inline static const std::string kPartitionFiltersDefaultValue = "false";
+  // level/universal
+  inline static const std::string kCompactionStyle = "compaction_style";
+  inline static const std::string kCompactionStyleDefaultValue = "level";
+  // integrated blob db, value not less than min_blob_size is separated to blob file, e.g. vector and document.
+  inline static const std::string kEnableBlobFiles = "enable_blob_files";
+  inline static const std::string kEnableBlobFilesDefaultValue = "false";
+  inline static const std::string kMinBlobSize = "min_blob_size";
+  inline static const std::string kMinBlobSizeDefaultValue = "4096";  // 4KB
+  inline static const std::string kBlobFileSize = "blob_file_size";
+  inline static const std::string kBlobFileSizeDefaultValue = "268435456";  // 256MB
+  // live blobs in the oldest part of blob files are relocated by compaction
+  inline static const std::string kBlobGarbageCollectionAgeCutoff = "blob_garbage_collection_age_cutoff";
+  inline static const std::string kBlobGarbageCollectionAgeCutoffDefaultValue = "0.25";
+  // force compaction of sst files which reference the oldest blob files when garbage ratio exceed it
+  inline static const std::string kBlobGarbageCollectionForceThreshold = "blob_garbage_collection_force_threshold";
+  inline static const std::string kBlobGarbageCollectionForceThresholdDefaultValue = "0.5";
+  // column family tuning profile, see rocks_raw_engine.cc
+  inline static const std::string kColumnFamilyProfile = "profile";
+  inline static const std::string kColumnFamilyProfileDefaultValue = "default";
 
   static const int kRocksdbBackgroundThreadNumDefault = 16;
   static const int kStatsDumpPeriodSecDefault = 600;
+  static const int64_t kHotPathTargetSizeDefault = 256L * 1024 * 1024 * 1024;  // 256GB
 
   // scan config
   inline static const std::string kStoreScan = "store.scan";
@@ -211,6 +244,10 @@ class Constant {
   static const int32_t kRaftLogFallBehindThreshold = 1000;
   static const int32_t kTransferLeaderRaftLogFallBehindThreshold = 16;
 
+  // bthread tag, raft server run on dedicated tag when raft_bthread_tag_worker_num is set.
+  static constexpr int kDefaultBthreadTag = 0;
+  static constexpr int kRaftBthreadTag = 1;
+
   static constexpr int64_t kLockVer = INT64_MAX;
   static constexpr int64_t kMaxVer = INT64_MAX;
 
@@ -0,0 +1,85 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/cycle_clock.h"
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_cycle_clock, true, "use cpu cycle counter for latency instrumentation if it is invariant");
+DEFINE_int32(cycle_clock_calibrate_ms, 20, "calibrate time of cycle counter frequency");
+
+// cycle counter is usable only when its rate not change with frequency scaling and not stop in idle.
+static bool IsCycleCounterInvariant() {
+#if defined(__x86_64__)
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line)) {
+    if (line.rfind("flags", 0) == 0) {
+      return line.find(" constant_tsc") != std::string::npos && line.find(" nonstop_tsc") != std::string::npos;
+    }
+  }
+  return false;
+#elif defined(__aarch64__)
+  // generic timer of armv8 is fixed frequency.
+  return true;
+#else
+  return false;
+#endif
+}
+
+static int64_t WallNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+CycleClock::State CycleClock::Calibrate() {
+  State state;
+  state.use_cycle_counter = FLAGS_enable_cycle_clock && IsCycleCounterInvariant();
+
+  if (state.use_cycle_counter) {
+    uint64_t start_steady_ns = SteadyNs();
+    uint64_t start_cycles = ReadCounter();
+    std::this_thread::sleep_for(std::chrono::milliseconds(FLAGS_cycle_clock_calibrate_ms));
+    uint64_t end_steady_ns = SteadyNs();
+    uint64_t end_cycles = ReadCounter();
+
+    if (end_cycles > start_cycles && end_steady_ns > start_steady_ns) {
+      state.ns_per_cycle =
+          static_cast<double>(end_steady_ns - start_steady_ns) / static_cast<double>(end_cycles - start_cycles);
+    } else {
+      state.use_cycle_counter = false;
+    }
+  }
+
+  state.base_cycles = state.use_cycle_counter ? ReadCounter() : SteadyNs();
+  state.base_wall_ns = WallNs();
+
+  DINGO_LOG(INFO) << fmt::format("[cycle_clock] use_cycle_counter({}) ns_per_cycle({:.6f})", state.use_cycle_counter,
+                                 state.ns_per_cycle);
+
+  return state;
+}
+
+}  // namespace dingodb
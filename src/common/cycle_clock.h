@@ -0,0 +1,96 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COMMON_CYCLE_CLOCK_H_
+#define DINGODB_COMMON_CYCLE_CLOCK_H_
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+namespace dingodb {
+
+// Cheap clock for hot path instrumentation, read cpu cycle counter instead of clock_gettime.
+// Counter frequency is calibrated against system clock at first use, fallback to steady clock when the
+// counter is not invariant across cores and power states or disabled by flag.
+// Use it for latency and stage timestamps, not for persistent or cross machine time.
+class CycleClock {
+ public:
+  // raw counter value, only the difference of two values is meaningful.
+  static inline uint64_t Now() {
+    if (__builtin_expect(!GetState().use_cycle_counter, 0)) {
+      return SteadyNs();
+    }
+    return ReadCounter();
+  }
+
+  // difference of two values is wrapped as signed, counter of cores may be slightly skewed.
+  static inline int64_t CyclesToNs(uint64_t cycles) {
+    return static_cast<int64_t>(static_cast<int64_t>(cycles) * GetState().ns_per_cycle);
+  }
+  static inline int64_t CyclesToUs(uint64_t cycles) { return CyclesToNs(cycles) / 1000; }
+
+  // wall clock ns anchored at calibration, same unit as Helper::TimestampNs().
+  static inline int64_t NowNs() {
+    const auto& state = GetState();
+    return state.base_wall_ns + CyclesToNs(Now() - state.base_cycles);
+  }
+  static inline int64_t NowUs() { return NowNs() / 1000; }
+
+  // calibrate ahead at startup, so first probe of hot path not pay for it.
+  static void Init() { (void)GetState(); }
+
+  static bool IsCycleCounter() { return GetState().use_cycle_counter; }
+  static double NsPerCycle() { return GetState().ns_per_cycle; }
+
+ private:
+  struct State {
+    bool use_cycle_counter{false};
+    double ns_per_cycle{1.0};
+    uint64_t base_cycles{0};
+    int64_t base_wall_ns{0};
+  };
+
+  static const State& GetState() {
+    static const State state = Calibrate();
+    return state;
+  }
+
+  static State Calibrate();
+
+  static inline uint64_t SteadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  static inline uint64_t ReadCounter() {
+#if defined(__x86_64__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return SteadyNs();
+#endif
+  }
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_CYCLE_CLOCK_H_
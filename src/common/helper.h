@@ -149,6 +149,14 @@ class Helper {
     }
   }
 
+  template <typename T>
+  static void VectorToPbRepeated(std::vector<T>&& vec, google::protobuf::RepeatedPtrField<T>* out) {
+    out->Reserve(out->size() + vec.size());
+    for (auto& item : vec) {
+      out->Add(std::move(item));
+    }
+  }
+
   template <typename T>
   static void VectorToPbRepeated(const std::vector<T>& vec, google::protobuf::RepeatedField<T>* out) {
     for (auto& item : vec) {
@@ -0,0 +1,71 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/hyper_log_log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "butil/third_party/murmurhash3/murmurhash3.h"
+
+namespace dingodb {
+
+HyperLogLog::HyperLogLog(uint32_t precision) : precision_(std::clamp(precision, 4U, 16U)) {}
+
+void HyperLogLog::Add(std::string_view key) {
+  if (registers_.empty()) {
+    registers_.resize(1U << precision_, 0);
+  }
+
+  uint64_t hash[2];
+  butil::MurmurHash3_x64_128(key.data(), static_cast<int>(key.size()), 0, hash);
+
+  uint64_t index = hash[0] >> (64 - precision_);
+  // rank is position of first 1 bit in the remaining bits, a sentinel bit bound it.
+  uint64_t remain = (hash[0] << precision_) | (1ULL << (precision_ - 1));
+  uint8_t rank = static_cast<uint8_t>(__builtin_clzll(remain) + 1);
+  registers_[index] = std::max(registers_[index], rank);
+}
+
+int64_t HyperLogLog::Estimate() const {
+  if (registers_.empty()) {
+    return 0;
+  }
+
+  double m = static_cast<double>(registers_.size());
+  double sum = 0.0;
+  int64_t zero_count = 0;
+  for (auto reg : registers_) {
+    sum += std::ldexp(1.0, -static_cast<int>(reg));
+    if (reg == 0) {
+      ++zero_count;
+    }
+  }
+
+  double alpha = 0.7213 / (1.0 + 1.079 / m);
+  double estimate = alpha * m * m / sum;
+  // small range correction by linear counting
+  if (estimate <= 2.5 * m && zero_count > 0) {
+    estimate = m * std::log(m / static_cast<double>(zero_count));
+  }
+
+  return static_cast<int64_t>(std::llround(estimate));
+}
+
+void HyperLogLog::Clear() { std::vector<uint8_t>().swap(registers_); }
+
+}  // namespace dingodb
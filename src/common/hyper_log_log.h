@@ -0,0 +1,45 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COMMON_HYPER_LOG_LOG_H_
+#define DINGODB_COMMON_HYPER_LOG_LOG_H_
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace dingodb {
+
+// HyperLogLog estimate of distinct key count, standard error is about 1.04 / sqrt(2^precision).
+// Not thread safe, caller protect it.
+class HyperLogLog {
+ public:
+  explicit HyperLogLog(uint32_t precision = kDefaultPrecision);
+  ~HyperLogLog() = default;
+
+  void Add(std::string_view key);
+  int64_t Estimate() const;
+  void Clear();
+
+  static constexpr uint32_t kDefaultPrecision = 10;
+
+ private:
+  uint32_t precision_;
+  // lazily allocated at first add, most region has no write between two full count.
+  std::vector<uint8_t> registers_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_HYPER_LOG_LOG_H_
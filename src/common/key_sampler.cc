@@ -0,0 +1,65 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/key_sampler.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "butil/fast_rand.h"
+#include "common/helper.h"
+
+namespace dingodb {
+
+KeySampler::KeySampler() : start_time_ms_(Helper::TimestampMs()) { bthread_mutex_init(&mutex_, nullptr); }
+
+KeySampler::~KeySampler() { bthread_mutex_destroy(&mutex_); }
+
+void KeySampler::Sample(const std::vector<std::string_view>& keys, size_t capacity) {
+  if (keys.empty() || capacity == 0) {
+    return;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  for (const auto& key : keys) {
+    ++count_;
+    if (keys_.size() < capacity) {
+      keys_.emplace_back(key);
+      continue;
+    }
+
+    uint64_t pos = butil::fast_rand_less_than(count_);
+    if (pos < keys_.size()) {
+      keys_[pos] = key;
+    }
+  }
+}
+
+int64_t KeySampler::Take(std::vector<std::string>& keys, int64_t& elapsed_ms) {
+  int64_t now_ms = Helper::TimestampMs();
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  keys.swap(keys_);
+  keys_.clear();
+  int64_t count = count_;
+  count_ = 0;
+  elapsed_ms = now_ms - start_time_ms_;
+  start_time_ms_ = now_ms;
+
+  return count;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,53 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COMMON_KEY_SAMPLER_H_
+#define DINGODB_COMMON_KEY_SAMPLER_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bthread/mutex.h"
+
+namespace dingodb {
+
+// Reservoir sample of request keys, every key has same probability to be kept.
+// Used by load based split to find a split key which balance request of both side.
+class KeySampler {
+ public:
+  KeySampler();
+  ~KeySampler();
+
+  KeySampler(const KeySampler&) = delete;
+  KeySampler& operator=(const KeySampler&) = delete;
+
+  // keep at most capacity keys.
+  void Sample(const std::vector<std::string_view>& keys, size_t capacity);
+
+  // take sampled keys and reset sampler.
+  // return request key count since last take, elapsed_ms is time since last take.
+  int64_t Take(std::vector<std::string>& keys, int64_t& elapsed_ms);
+
+ private:
+  bthread_mutex_t mutex_;
+  std::vector<std::string> keys_;
+  int64_t count_{0};
+  int64_t start_time_ms_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_KEY_SAMPLER_H_
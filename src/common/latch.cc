@@ -14,15 +14,24 @@
 
 #include "common/latch.h"
 
+#include <algorithm>
 #include <cassert>
 #include <utility>
 
 #include "butil/scoped_lock.h"
+#include "butil/time.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
 #include "gflags/gflags.h"
 
 namespace dingodb {
 
 DEFINE_uint32(latch_slot_num, 2048, "latch slot num");
+DEFINE_uint32(latch_hot_slot_waiting_num, 8, "slot is hot when waiting list size exceed it");
+
+bvar::LatencyRecorder g_latch_wait_recorder("dingo_latch_wait");
+bvar::LatencyRecorder g_latch_hot_slot_wait_recorder("dingo_latch_hot_slot_wait");
+bvar::Adder<uint64_t> g_latch_hot_slot_count("dingo_latch_hot_slot_count");
 
 const size_t kWaitingListShrinkSize = 8;
 const size_t kWaitingListMaxCapacity = 16;
@@ -116,7 +125,19 @@ bool Latches::Acquire(Lock* lock, uint64_t who) const {
     if (first_req.has_value()) {
       if (first_req == who) {
         ++acquired_count;
+        if (lock->waitStartUs > 0 && lock->waitingHash == key_hash) {
+          RecordWait(GetSlot(key_hash), lock);
+        }
       } else {
+        if (lock->waitStartUs == 0 || lock->waitingHash != key_hash) {
+          lock->waitingHash = key_hash;
+          lock->waitStartUs = butil::gettimeofday_us();
+          lock->waitingHot = latch.waiting.size() >= FLAGS_latch_hot_slot_waiting_num;
+          if (lock->waitingHot) {
+            ++GetSlot(key_hash)->hot_count;
+            g_latch_hot_slot_count << 1;
+          }
+        }
         latch.WaitForWake(key_hash, who);
         break;
       }
@@ -181,6 +202,41 @@ std::vector<uint64_t> Latches::Release(Lock* lock, uint64_t who,
   return wakeup_list;
 }
 
+void Latches::RecordWait(Slot* slot, Lock* lock) {
+  int64_t wait_time_us = butil::gettimeofday_us() - lock->waitStartUs;
+  ++slot->wait_count;
+  slot->wait_time_us += wait_time_us;
+
+  g_latch_wait_recorder << wait_time_us;
+  if (lock->waitingHot) {
+    g_latch_hot_slot_wait_recorder << wait_time_us;
+  }
+
+  lock->waitingHash = 0;
+  lock->waitStartUs = 0;
+  lock->waitingHot = false;
+}
+
+std::vector<SlotWaitStat> Latches::GetHotSlots(size_t top_n) const {
+  std::vector<SlotWaitStat> stats;
+  for (size_t i = 0; i < slots_size; ++i) {
+    auto& slot = (*slots_ptr)[i];
+    BAIDU_SCOPED_LOCK(slot.mutex);
+    if (slot.wait_count == 0) {
+      continue;
+    }
+    stats.push_back(SlotWaitStat{i, slot.wait_count, slot.wait_time_us, slot.hot_count});
+  }
+
+  std::sort(stats.begin(), stats.end(),
+            [](const SlotWaitStat& a, const SlotWaitStat& b) { return a.wait_time_us > b.wait_time_us; });
+  if (stats.size() > top_n) {
+    stats.resize(top_n);
+  }
+
+  return stats;
+}
+
 size_t Latches::NextPowerOfTwo(size_t n) {
   if (n == 0) {
     return 1;
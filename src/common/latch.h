@@ -15,8 +15,10 @@
 #ifndef DINGODB_COMMON_LATCH_H_
 #define DINGODB_COMMON_LATCH_H_
 
+#include <cstdint>
 #include <deque>
 #include <optional>
+#include <utility>
 #include <vector>
 
 #include "bthread/mutex.h"
@@ -47,6 +49,11 @@ class Lock {
   std::vector<uint64_t> requiredHashes;
   size_t ownedCount = 0;
 
+  // the latch which is waiting for, used by latch wait statistics
+  uint64_t waitingHash = 0;
+  int64_t waitStartUs = 0;
+  bool waitingHot = false;
+
   Lock(const std::vector<std::string>& keys);
 
   bool Acquired() const;
@@ -78,6 +85,18 @@ struct Slot {
 
   bthread_mutex_t mutex;
   Latch latch;
+
+  // wait statistics, protected by mutex
+  uint64_t wait_count{0};
+  uint64_t wait_time_us{0};
+  uint64_t hot_count{0};
+};
+
+struct SlotWaitStat {
+  size_t slot_index{0};
+  uint64_t wait_count{0};
+  uint64_t wait_time_us{0};
+  uint64_t hot_count{0};
 };
 
 class Latches {
@@ -98,10 +117,17 @@ class Latches {
   size_t GetSlotIndex(uint64_t hash) const;
   Slot* GetSlot(uint64_t hash) const;
 
+  // Slots which have most waiting, order by wait time desc.
+  std::vector<SlotWaitStat> GetHotSlots(size_t top_n) const;
+
   std::vector<Slot>* slots_ptr;
   size_t slots_size;
 
   static size_t NextPowerOfTwo(size_t n);
+
+ private:
+  // Called when lock get the latch it waiting for, hold slot mutex.
+  static void RecordWait(Slot* slot, Lock* lock);
 };
 
 }  // namespace dingodb
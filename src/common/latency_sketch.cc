@@ -0,0 +1,103 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/latency_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace dingodb {
+
+uint32_t LatencySketch::BucketIndex(int64_t latency_us) {
+  if (latency_us < static_cast<int64_t>(kSubBucketNum)) {
+    return latency_us < 0 ? 0 : static_cast<uint32_t>(latency_us);
+  }
+
+  uint64_t value = static_cast<uint64_t>(latency_us);
+  uint32_t exponent = 63 - __builtin_clzll(value);
+  if (exponent >= kMaxExponent) {
+    return kBucketNum - 1;
+  }
+
+  uint32_t shift = exponent - kSubBucketBits;
+  uint32_t sub_bucket = (value >> shift) & (kSubBucketNum - 1);
+  return kSubBucketNum * (shift + 1) + sub_bucket;
+}
+
+int64_t LatencySketch::BucketValue(uint32_t index) {
+  if (index < kSubBucketNum) {
+    return index;
+  }
+
+  uint32_t shift = index / kSubBucketNum - 1;
+  uint32_t sub_bucket = index % kSubBucketNum;
+  int64_t lower = static_cast<int64_t>(kSubBucketNum + sub_bucket) << shift;
+  return lower + ((static_cast<int64_t>(1) << shift) >> 1);
+}
+
+void LatencySketch::Add(int64_t latency_us) {
+  buckets_[BucketIndex(latency_us)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void LatencySketch::Merge(const LatencySketch& other) {
+  for (uint32_t i = 0; i < kBucketNum; ++i) {
+    uint32_t count = other.buckets_[i].load(std::memory_order_relaxed);
+    if (count > 0) {
+      buckets_[i].fetch_add(count, std::memory_order_relaxed);
+    }
+  }
+}
+
+void LatencySketch::Clear() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+int64_t LatencySketch::Count() const {
+  int64_t count = 0;
+  for (const auto& bucket : buckets_) {
+    count += bucket.load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+int64_t LatencySketch::Quantile(double quantile) const {
+  // snapshot counts, concurrent add may change them.
+  std::array<uint32_t, kBucketNum> counts;
+  int64_t total = 0;
+  for (uint32_t i = 0; i < kBucketNum; ++i) {
+    counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (total == 0) {
+    return 0;
+  }
+
+  quantile = std::clamp(quantile, 0.0, 1.0);
+  int64_t rank = std::max(static_cast<int64_t>(std::ceil(quantile * total)), static_cast<int64_t>(1));
+  int64_t accumulated = 0;
+  for (uint32_t i = 0; i < kBucketNum; ++i) {
+    accumulated += counts[i];
+    if (accumulated >= rank) {
+      return BucketValue(i);
+    }
+  }
+
+  return BucketValue(kBucketNum - 1);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,61 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COMMON_LATENCY_SKETCH_H_
+#define DINGODB_COMMON_LATENCY_SKETCH_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace dingodb {
+
+// Mergeable log-linear histogram of latency in us, relative error of quantile is less than 1/16.
+// Every power of two range is split to kSubBucketNum linear buckets, Add() is one relaxed atomic increment,
+// so it is cheap enough for per region hot path. Quantile and merge are computed on demand.
+class LatencySketch {
+ public:
+  LatencySketch() = default;
+  ~LatencySketch() = default;
+
+  LatencySketch(const LatencySketch&) = delete;
+  LatencySketch& operator=(const LatencySketch&) = delete;
+
+  void Add(int64_t latency_us);
+  // add counts of other sketch to this one.
+  void Merge(const LatencySketch& other);
+  void Clear();
+
+  int64_t Count() const;
+  // latency in us at quantile, e.g. 0.99, return 0 if empty.
+  int64_t Quantile(double quantile) const;
+
+  static constexpr uint32_t kSubBucketBits = 3;
+  static constexpr uint32_t kSubBucketNum = 1 << kSubBucketBits;
+  // max latency is 2^32 us, about 71 minutes, larger latency is put to last bucket.
+  static constexpr uint32_t kMaxExponent = 32;
+  static constexpr uint32_t kBucketNum = kSubBucketNum * (kMaxExponent - kSubBucketBits + 1);
+
+  static uint32_t BucketIndex(int64_t latency_us);
+  // middle value of bucket.
+  static int64_t BucketValue(uint32_t index);
+
+ private:
+  std::array<std::atomic<uint32_t>, kBucketNum> buckets_{};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_LATENCY_SKETCH_H_
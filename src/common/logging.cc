@@ -17,10 +17,46 @@
 #include <cstdint>
 #include <iomanip>
 
+#include "brpc/reloadable_flags.h"
+#include "butil/time.h"
+#include "bvar/reducer.h"
+#include "common/async_logger.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 
 namespace dingodb {
 
+DEFINE_int64(log_site_max_per_second, 100, "max WARNING/ERROR log per second of one call site, 0 is unlimited");
+BRPC_VALIDATE_GFLAG(log_site_max_per_second, brpc::NonNegativeInteger);
+
+bvar::Adder<int64_t> g_log_suppressed_count("dingo_log_suppressed_count");
+
+bool LogSite::Allow() {
+  int64_t max_count = FLAGS_log_site_max_per_second;
+  if (max_count <= 0) {
+    return true;
+  }
+
+  int64_t now_ms = butil::monotonic_time_ms();
+  int64_t window_start_ms = window_start_ms_.load(std::memory_order_relaxed);
+  if (now_ms - window_start_ms >= 1000 &&
+      window_start_ms_.compare_exchange_strong(window_start_ms, now_ms, std::memory_order_relaxed)) {
+    count_.store(0, std::memory_order_relaxed);
+    int64_t suppressed_count = suppressed_count_.exchange(0, std::memory_order_relaxed);
+    if (suppressed_count > 0) {
+      LOG(WARNING) << fmt::format("[log] suppressed {} log at {}:{}", suppressed_count, file_, line_);
+    }
+  }
+
+  if (count_.fetch_add(1, std::memory_order_relaxed) < max_count) {
+    return true;
+  }
+
+  suppressed_count_.fetch_add(1, std::memory_order_relaxed);
+  g_log_suppressed_count << 1;
+  return false;
+}
+
 void DingoLogger::InitLogger(const std::string& log_dir, const std::string& role, const LogLevel& level) {
   FLAGS_logbufsecs = 10;
   FLAGS_max_log_size = 80;
@@ -35,6 +71,8 @@ void DingoLogger::InitLogger(const std::string& log_dir, const std::string& role
   google::SetLogDestination(google::GLOG_WARNING, fmt::format("{}/{}.warn.log.", log_dir, role).c_str());
   google::SetLogDestination(google::GLOG_ERROR, fmt::format("{}/{}.error.log.", log_dir, role).c_str());
   google::SetLogDestination(google::GLOG_FATAL, fmt::format("{}/{}.fatal.log.", log_dir, role).c_str());
+
+  AsyncLogger::Install();
 }
 
 void DingoLogger::SetMinLogLevel(int level) { FLAGS_minloglevel = level; }
@@ -15,6 +15,8 @@
 #ifndef DINGODB_COMMON_LOGGING_H_
 #define DINGODB_COMMON_LOGGING_H_
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include "glog/logging.h"
 
@@ -48,24 +50,48 @@ static constexpr int kGlobalValueOfDebug = DINGO_DEBUG;
 
 #define CURRENT_FUNC_NAME "[" << __func__ << "] "
 
+// Rate limit of one log call site, every expansion has its own static site.
+#define DINGO_LOG_SITE_ALLOW()                                               \
+  ([]() {                                                                    \
+    static ::dingodb::LogSite dingo_log_site(__FILE__, __LINE__);            \
+    return dingo_log_site.Allow();                                           \
+  }())
+
 #define DINGO_LOG(level) DINGO_LOG_##level
 
 #define DINGO_LOG_IF(level, condition) DINGO_LOG_IF_##level(condition)
 
 #define DINGO_LOG_DEBUG VLOG(DINGO_DEBUG) << CURRENT_FUNC_NAME
 #define DINGO_LOG_INFO LOG(INFO) << CURRENT_FUNC_NAME
-#define DINGO_LOG_WARNING LOG(WARNING) << CURRENT_FUNC_NAME
-#define DINGO_LOG_ERROR LOG(ERROR) << CURRENT_FUNC_NAME
+#define DINGO_LOG_WARNING LOG_IF(WARNING, DINGO_LOG_SITE_ALLOW()) << CURRENT_FUNC_NAME
+#define DINGO_LOG_ERROR LOG_IF(ERROR, DINGO_LOG_SITE_ALLOW()) << CURRENT_FUNC_NAME
 #define DINGO_LOG_FATAL LOG(FATAL) << CURRENT_FUNC_NAME
 
 #define DINGO_LOG_IF(level, condition) DINGO_LOG_IF_##level(condition)
 
 #define DINGO_LOG_IF_DEBUG(condition) VLOG_IF(DINGO_DEBUG, condition) << CURRENT_FUNC_NAME
 #define DINGO_LOG_IF_INFO(condition) LOG_IF(INFO, condition) << CURRENT_FUNC_NAME
-#define DINGO_LOG_IF_WARNING(condition) LOG_IF(WARNING, condition) << CURRENT_FUNC_NAME
-#define DINGO_LOG_IF_ERROR(condition) LOG_IF(ERROR, condition) << CURRENT_FUNC_NAME
+#define DINGO_LOG_IF_WARNING(condition) LOG_IF(WARNING, (condition) && DINGO_LOG_SITE_ALLOW()) << CURRENT_FUNC_NAME
+#define DINGO_LOG_IF_ERROR(condition) LOG_IF(ERROR, (condition) && DINGO_LOG_SITE_ALLOW()) << CURRENT_FUNC_NAME
 #define DINGO_LOG_IF_FATAL(condition) LOG_IF(FATAL, condition) << CURRENT_FUNC_NAME
 
+// At most log_site_max_per_second WARNING/ERROR logs per second of one call site, others are suppressed and counted,
+// suppressed count is logged when next second begin, so a flood of same warning can not slow down request.
+class LogSite {
+ public:
+  LogSite(const char* file, int line) : file_(file), line_(line) {}
+
+  bool Allow();
+
+ private:
+  const char* file_;
+  int line_;
+
+  std::atomic<int64_t> window_start_ms_{0};
+  std::atomic<int64_t> count_{0};
+  std::atomic<int64_t> suppressed_count_{0};
+};
+
 class DingoLogger {
  public:
   static void InitLogger(const std::string& log_dir, const std::string& role, const LogLevel& level);
@@ -0,0 +1,241 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/memory_tracker.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "brpc/reloadable_flags.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+static bool ValidateMemoryLimitRatio(const char*, double value) { return value >= 0 && value <= 1; }
+
+DEFINE_double(memory_soft_limit_ratio, 0.8, "store memory soft limit ratio of system memory, evict cache when over");
+DEFINE_validator(memory_soft_limit_ratio, &ValidateMemoryLimitRatio);
+DEFINE_double(memory_hard_limit_ratio, 0.9, "store memory hard limit ratio of system memory, read only when over");
+DEFINE_validator(memory_hard_limit_ratio, &ValidateMemoryLimitRatio);
+
+MemoryTracker::MemoryTracker(std::string name, MemoryTracker* parent) : name_(std::move(name)), parent_(parent) {
+  bthread_mutex_init(&mutex_, nullptr);
+}
+
+MemoryTracker::~MemoryTracker() { bthread_mutex_destroy(&mutex_); }
+
+MemoryTrackerPtr MemoryTracker::Root() {
+  static MemoryTrackerPtr root = []() {
+    auto root = std::make_shared<MemoryTracker>("store", nullptr);
+    root->consumption_bvar_ = std::make_unique<bvar::PassiveStatus<int64_t>>(
+        "dingo_memory_tracker_store", [](void* arg) { return static_cast<MemoryTracker*>(arg)->Consumption(); },
+        root.get());
+    return root;
+  }();
+  return root;
+}
+
+MemoryTrackerPtr MemoryTracker::Subsystem(const std::string& name) {
+  auto root = Root();
+
+  BAIDU_SCOPED_LOCK(root->mutex_);
+  auto it = root->children_.find(name);
+  if (it != root->children_.end()) {
+    return it->second;
+  }
+
+  auto tracker = std::make_shared<MemoryTracker>(name, root.get());
+  tracker->consumption_bvar_ = std::make_unique<bvar::PassiveStatus<int64_t>>(
+      fmt::format("dingo_memory_tracker_{}", name),
+      [](void* arg) { return static_cast<MemoryTracker*>(arg)->Consumption(); }, tracker.get());
+  root->children_.emplace(name, tracker);
+  return tracker;
+}
+
+void MemoryTracker::UpdateRoot(int64_t system_total_memory, int64_t process_used_memory) {
+  auto root = Root();
+  if (system_total_memory > 0) {
+    root->SetLimit(static_cast<int64_t>(system_total_memory * FLAGS_memory_soft_limit_ratio),
+                   static_cast<int64_t>(system_total_memory * FLAGS_memory_hard_limit_ratio));
+  }
+
+  auto untracked = Subsystem(kUntracked);
+  int64_t tracked_memory = root->Consumption() - untracked->Consumption();
+  untracked->SetConsumption(std::max(process_used_memory - tracked_memory, static_cast<int64_t>(0)));
+}
+
+MemoryTrackerPtr MemoryTracker::GetOrNewChild(const std::string& name) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = children_.find(name);
+  if (it != children_.end()) {
+    return it->second;
+  }
+
+  auto tracker = std::make_shared<MemoryTracker>(name, this);
+  children_.emplace(name, tracker);
+  return tracker;
+}
+
+void MemoryTracker::RemoveChild(const std::string& name) {
+  MemoryTrackerPtr child;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = children_.find(name);
+    if (it == children_.end()) {
+      return;
+    }
+    child = it->second;
+    children_.erase(it);
+  }
+
+  child->SetConsumption(0);
+}
+
+std::vector<MemoryTrackerPtr> MemoryTracker::GetChildren() {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  std::vector<MemoryTrackerPtr> children;
+  children.reserve(children_.size());
+  for (auto& [_, child] : children_) {
+    children.push_back(child);
+  }
+  return children;
+}
+
+void MemoryTracker::Consume(int64_t bytes) {
+  if (bytes == 0) {
+    return;
+  }
+
+  for (auto* tracker = this; tracker != nullptr; tracker = tracker->parent_) {
+    tracker->UpdatePeak(tracker->consumption_.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+  }
+}
+
+void MemoryTracker::UpdatePeak(int64_t consumption) {
+  int64_t peak_consumption = peak_consumption_.load(std::memory_order_relaxed);
+  while (consumption > peak_consumption && !peak_consumption_.compare_exchange_weak(peak_consumption, consumption)) {
+  }
+}
+
+bool MemoryTracker::TryConsume(int64_t bytes) {
+  for (auto* tracker = this; tracker != nullptr; tracker = tracker->parent_) {
+    int64_t hard_limit = tracker->HardLimit();
+    if (hard_limit > 0 && tracker->Consumption() + bytes > hard_limit) {
+      return false;
+    }
+  }
+
+  Consume(bytes);
+  return true;
+}
+
+void MemoryTracker::SetConsumption(int64_t bytes) {
+  int64_t old_bytes = consumption_.exchange(bytes, std::memory_order_relaxed);
+  UpdatePeak(bytes);
+  if (parent_ != nullptr) {
+    parent_->Consume(bytes - old_bytes);
+  }
+}
+
+void MemoryTracker::SetLimit(int64_t soft_limit, int64_t hard_limit) {
+  soft_limit_.store(soft_limit, std::memory_order_relaxed);
+  hard_limit_.store(hard_limit, std::memory_order_relaxed);
+}
+
+bool MemoryTracker::IsOverSoftLimit() const {
+  for (const auto* tracker = this; tracker != nullptr; tracker = tracker->parent_) {
+    int64_t soft_limit = tracker->SoftLimit();
+    if (soft_limit > 0 && tracker->Consumption() > soft_limit) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool MemoryTracker::IsOverHardLimit() const {
+  for (const auto* tracker = this; tracker != nullptr; tracker = tracker->parent_) {
+    int64_t hard_limit = tracker->HardLimit();
+    if (hard_limit > 0 && tracker->Consumption() > hard_limit) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void MemoryTracker::SetEvictor(Evictor evictor) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  evictor_ = std::move(evictor);
+}
+
+int64_t MemoryTracker::Evict(int64_t bytes) {
+  if (bytes <= 0) {
+    return 0;
+  }
+
+  Evictor evictor;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    evictor = evictor_;
+  }
+
+  int64_t freed_bytes = 0;
+  if (evictor != nullptr) {
+    freed_bytes += evictor(bytes);
+    if (freed_bytes >= bytes) {
+      return freed_bytes;
+    }
+  }
+
+  auto children = GetChildren();
+  std::sort(children.begin(), children.end(),
+            [](const MemoryTrackerPtr& lhs, const MemoryTrackerPtr& rhs) {
+              return lhs->Consumption() > rhs->Consumption();
+            });
+  for (auto& child : children) {
+    if (freed_bytes >= bytes) {
+      break;
+    }
+    freed_bytes += child->Evict(bytes - freed_bytes);
+  }
+
+  return freed_bytes;
+}
+
+void MemoryTracker::Dump(int max_depth, std::vector<std::string>& lines) { DoDump("", max_depth, lines); }
+
+void MemoryTracker::DoDump(const std::string& prefix, int max_depth, std::vector<std::string>& lines) {
+  std::string path = prefix.empty() ? name_ : prefix + "/" + name_;
+  lines.push_back(fmt::format("{} consumption({}) peak({}) soft_limit({}) hard_limit({})", path, Consumption(),
+                              PeakConsumption(), SoftLimit(), HardLimit()));
+  if (max_depth <= 1) {
+    return;
+  }
+
+  for (auto& child : GetChildren()) {
+    child->DoDump(path, max_depth - 1, lines);
+  }
+}
+
+}  // namespace dingodb
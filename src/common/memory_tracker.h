@@ -0,0 +1,122 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COMMON_MEMORY_TRACKER_H_
+#define DINGODB_COMMON_MEMORY_TRACKER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "bvar/passive_status.h"
+
+namespace dingodb {
+
+class MemoryTracker;
+using MemoryTrackerPtr = std::shared_ptr<MemoryTracker>;
+
+// Hierarchical memory accounting of store, e.g. store -> subsystem -> region.
+// Consumption of tracker include all its children, charge of child is propagated to all ancestors.
+// Subsystem either charge and release when allocate and free, or set sampled consumption periodically.
+// When store is over soft limit, evictor of subsystems are called to free memory, most consumption first.
+// When store is over hard limit, cache stop growing and store turn to read only, instead of killed by OOM.
+// Child is owned by parent, holder of child must not outlive parent.
+class MemoryTracker {
+ public:
+  // free at least bytes, return freed bytes.
+  using Evictor = std::function<int64_t(int64_t bytes)>;
+
+  MemoryTracker(std::string name, MemoryTracker* parent);
+  ~MemoryTracker();
+
+  MemoryTracker(const MemoryTracker&) = delete;
+  MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+  // subsystem names
+  static constexpr const char* kRocksBlockCache = "rocks_block_cache";
+  static constexpr const char* kRocksMemtable = "rocks_memtable";
+  static constexpr const char* kVectorIndex = "vector_index";
+  static constexpr const char* kRaftLogCache = "raft_log_cache";
+  static constexpr const char* kStream = "stream";
+  // process memory not tracked by any subsystem.
+  static constexpr const char* kUntracked = "untracked";
+
+  static MemoryTrackerPtr Root();
+  // child of root, consumption is exposed as bvar dingo_memory_tracker_{name}.
+  static MemoryTrackerPtr Subsystem(const std::string& name);
+
+  // update limit of root by system memory, and account process memory not tracked.
+  static void UpdateRoot(int64_t system_total_memory, int64_t process_used_memory);
+
+  const std::string& Name() const { return name_; }
+
+  MemoryTrackerPtr GetOrNewChild(const std::string& name);
+  // consumption of child is released.
+  void RemoveChild(const std::string& name);
+  std::vector<MemoryTrackerPtr> GetChildren();
+
+  void Consume(int64_t bytes);
+  void Release(int64_t bytes) { Consume(-bytes); }
+  // consume if self and ancestors not exceed hard limit.
+  bool TryConsume(int64_t bytes);
+  // set sampled consumption of leaf tracker.
+  void SetConsumption(int64_t bytes);
+
+  int64_t Consumption() const { return consumption_.load(std::memory_order_relaxed); }
+  int64_t PeakConsumption() const { return peak_consumption_.load(std::memory_order_relaxed); }
+
+  // 0 is unlimit.
+  void SetLimit(int64_t soft_limit, int64_t hard_limit);
+  int64_t SoftLimit() const { return soft_limit_.load(std::memory_order_relaxed); }
+  int64_t HardLimit() const { return hard_limit_.load(std::memory_order_relaxed); }
+
+  // self or any ancestor is over limit.
+  bool IsOverSoftLimit() const;
+  bool IsOverHardLimit() const;
+
+  void SetEvictor(Evictor evictor);
+  // free by evictor of self, then children which has most consumption, return freed bytes.
+  int64_t Evict(int64_t bytes);
+
+  // one line per tracker, e.g. store/vector_index consumption(1024) peak(2048) soft_limit(0) hard_limit(0).
+  void Dump(int max_depth, std::vector<std::string>& lines);
+
+ private:
+  void DoDump(const std::string& prefix, int max_depth, std::vector<std::string>& lines);
+  void UpdatePeak(int64_t consumption);
+
+  std::string name_;
+  MemoryTracker* parent_;
+
+  std::atomic<int64_t> consumption_{0};
+  std::atomic<int64_t> peak_consumption_{0};
+  std::atomic<int64_t> soft_limit_{0};
+  std::atomic<int64_t> hard_limit_{0};
+
+  bthread_mutex_t mutex_;
+  std::map<std::string, MemoryTrackerPtr> children_;
+  Evictor evictor_;
+
+  std::unique_ptr<bvar::PassiveStatus<int64_t>> consumption_bvar_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_MEMORY_TRACKER_H_
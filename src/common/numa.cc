@@ -0,0 +1,153 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/numa.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <cctype>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_numa_affinity, false,
+            "partition regions across numa nodes, bind apply worker and vector index thread pool to node cpus, "
+            "take effect after restart");
+
+// cpulist format: 0-15,32-47
+static std::vector<int32_t> ParseCpuList(const std::string& cpu_list) {
+  std::vector<int32_t> cpus;
+  std::vector<std::string> parts;
+  Helper::SplitString(cpu_list, ',', parts);
+  for (const auto& part : parts) {
+    if (part.empty()) {
+      continue;
+    }
+
+    auto pos = part.find('-');
+    int32_t start = std::stoi(part.substr(0, pos));
+    int32_t end = (pos == std::string::npos) ? start : std::stoi(part.substr(pos + 1));
+    for (int32_t cpu = start; cpu <= end; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+
+  return cpus;
+}
+
+const NumaTopology::Topology& NumaTopology::GetTopology() {
+  static const Topology kTopology = []() {
+    Topology topology;
+    int32_t cores = Helper::GetCores();
+
+    // node id may be sparse, sort it and use index as node.
+    std::map<int32_t, std::vector<int32_t>> node_cpus;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", ec)) {
+      std::string name = entry.path().filename().string();
+      if (name.size() <= 4 || name.compare(0, 4, "node") != 0 || !std::isdigit(name[4])) {
+        continue;
+      }
+
+      std::ifstream file(entry.path() / "cpulist");
+      std::string cpu_list;
+      if (file >> cpu_list) {
+        try {
+          node_cpus[std::stoi(name.substr(4))] = ParseCpuList(cpu_list);
+        } catch (const std::exception& e) {
+          DINGO_LOG(ERROR) << fmt::format("[numa] parse cpulist({}) of {} failed, error: {}", cpu_list, name,
+                                          e.what());
+        }
+      }
+    }
+
+    topology.cpu_nodes.resize(cores, 0);
+    for (auto& [_, cpus] : node_cpus) {
+      if (cpus.empty()) {
+        continue;
+      }
+      for (int32_t cpu : cpus) {
+        if (cpu >= 0 && cpu < cores) {
+          topology.cpu_nodes[cpu] = topology.node_cpus.size();
+        }
+      }
+      topology.node_cpus.push_back(std::move(cpus));
+    }
+
+    if (topology.node_cpus.empty()) {
+      std::vector<int32_t> cpus;
+      for (int32_t cpu = 0; cpu < cores; ++cpu) {
+        cpus.push_back(cpu);
+      }
+      topology.node_cpus.push_back(std::move(cpus));
+    }
+
+    DINGO_LOG(INFO) << fmt::format("[numa] node num({}) cpu num({})", topology.node_cpus.size(), cores);
+    return topology;
+  }();
+
+  return kTopology;
+}
+
+int32_t NumaTopology::NodeNum() { return GetTopology().node_cpus.size(); }
+
+const std::vector<int32_t>& NumaTopology::NodeCpus(int32_t node) {
+  const auto& node_cpus = GetTopology().node_cpus;
+  return node_cpus[(node >= 0 && node < node_cpus.size()) ? node : 0];
+}
+
+int32_t NumaTopology::NodeOfCpu(int32_t cpu) {
+  const auto& cpu_nodes = GetTopology().cpu_nodes;
+  return (cpu >= 0 && cpu < cpu_nodes.size()) ? cpu_nodes[cpu] : 0;
+}
+
+int32_t NumaTopology::CurrentNode() { return NodeOfCpu(sched_getcpu()); }
+
+bool NumaTopology::IsEnabled() { return FLAGS_enable_numa_affinity && NodeNum() > 1; }
+
+int32_t NumaTopology::NodeOfRegion(int64_t region_id) {
+  return IsEnabled() ? static_cast<int32_t>(region_id % NodeNum()) : 0;
+}
+
+bool NumaTopology::BindCurrentThread(int32_t node) {
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  for (int32_t cpu : NodeCpus(node)) {
+    CPU_SET(cpu, &cpuset);
+  }
+
+  int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+  if (ret != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[numa] bind thread to node({}) failed, error: {}", node, ret);
+    return false;
+  }
+
+  return true;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,53 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COMMON_NUMA_H_
+#define DINGODB_COMMON_NUMA_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace dingodb {
+
+// Numa topology of machine, read from sysfs, machine without numa is one node holding all cpus.
+// In numa mode regions are partitioned across nodes by region id, the apply worker and vector index thread pool
+// of a node are bound to its cpus, so memory of region and vector index is allocated on the node by first touch.
+class NumaTopology {
+ public:
+  static int32_t NodeNum();
+  static const std::vector<int32_t>& NodeCpus(int32_t node);
+  static int32_t NodeOfCpu(int32_t cpu);
+  // node of the cpu which current thread run on.
+  static int32_t CurrentNode();
+
+  // numa mode is enabled and machine has more than one node.
+  static bool IsEnabled();
+  // node which region and its vector index placed on, 0 if not numa mode.
+  static int32_t NodeOfRegion(int64_t region_id);
+
+  // bind current thread to all cpus of node.
+  static bool BindCurrentThread(int32_t node);
+
+ private:
+  struct Topology {
+    std::vector<std::vector<int32_t>> node_cpus;
+    std::vector<int32_t> cpu_nodes;
+  };
+  static const Topology& GetTopology();
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_NUMA_H_
@@ -0,0 +1,51 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COMMON_PROBE_H_
+#define DINGODB_COMMON_PROBE_H_
+
+#include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
+#include "common/cycle_clock.h"
+#include "common/synchronization.h"
+
+// Instrumentation probes of hot path, timed by CycleClock and aggregated by bvar per-thread agents,
+// so a probe not contend on shared cache line.
+// DINGO_PROBE_* are always on, DINGO_DEBUG_PROBE_* are only compiled with ENABLE_DEBUG_PROBE,
+// otherwise they are removed at compile time and their arguments are not evaluated.
+
+#define DINGO_PROBE_CONCAT_INNER(a, b) a##b
+#define DINGO_PROBE_CONCAT(a, b) DINGO_PROBE_CONCAT_INNER(a, b)
+
+// record latency(us) of current scope to bvar::LatencyRecorder* recorder.
+#define DINGO_PROBE_LATENCY(recorder) \
+  ::dingodb::BvarLatencyGuard DINGO_PROBE_CONCAT(dingo_probe_guard_, __LINE__)(recorder)
+
+#ifdef ENABLE_DEBUG_PROBE
+// record latency(us) of current scope to bvar dingo_probe_<name>, name must be string literal.
+#define DINGO_DEBUG_PROBE_LATENCY(name)                                                                    \
+  static bvar::LatencyRecorder DINGO_PROBE_CONCAT(dingo_probe_recorder_, __LINE__)("dingo_probe_" name); \
+  DINGO_PROBE_LATENCY(&DINGO_PROBE_CONCAT(dingo_probe_recorder_, __LINE__))
+
+// add value to bvar dingo_probe_<name>, name must be string literal.
+#define DINGO_DEBUG_PROBE_ADD(name, value)                                                             \
+  static bvar::Adder<int64_t> DINGO_PROBE_CONCAT(dingo_probe_adder_, __LINE__)("dingo_probe_" name); \
+  DINGO_PROBE_CONCAT(dingo_probe_adder_, __LINE__) << static_cast<int64_t>(value)
+#else
+#define DINGO_DEBUG_PROBE_LATENCY(name) static_cast<void>(0)
+#define DINGO_DEBUG_PROBE_ADD(name, value) static_cast<void>(0)
+#endif
+
+#endif  // DINGODB_COMMON_PROBE_H_
@@ -0,0 +1,176 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/profiler.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "brpc/reloadable_flags.h"
+#include "bthread/bthread.h"
+#include "butil/status.h"
+#include "common/gflag_validator.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/synchronization.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+#ifdef BRPC_ENABLE_CPU_PROFILER
+#include "gperftools/profiler.h"
+#endif
+
+#ifdef LINK_TCMALLOC
+#include "gperftools/malloc_extension.h"
+#endif
+
+DECLARE_string(log_dir);
+
+namespace dingodb {
+
+DEFINE_string(cpu_profile_worker_set, "", "worker set name of cpu profile, empty is whole process");
+
+static bool ValidateTriggerCpuProfile(const char*, int32_t value) {
+  if (value <= 0) {
+    return value == 0;
+  }
+  std::string file_path;
+  auto status = Profiler::StartCpuProfile(value, FLAGS_cpu_profile_worker_set, file_path);
+  DINGO_LOG_IF(ERROR, !status.ok()) << fmt::format("[profiler] start cpu profile failed, error: {}",
+                                                   status.error_str());
+  return true;
+}
+
+DEFINE_int32(trigger_cpu_profile_seconds, 0, "set positive value to start cpu profile of these seconds");
+DEFINE_validator(trigger_cpu_profile_seconds, &ValidateTriggerCpuProfile);
+
+static bool ValidateTriggerHeapProfile(const char*, bool value) {
+  if (value) {
+    std::string file_path;
+    auto status = Profiler::DumpHeapProfile(file_path);
+    DINGO_LOG_IF(ERROR, !status.ok()) << fmt::format("[profiler] dump heap profile failed, error: {}",
+                                                     status.error_str());
+  }
+  return true;
+}
+
+DEFINE_bool(trigger_heap_profile, false, "set true to dump heap profile");
+DEFINE_validator(trigger_heap_profile, &ValidateTriggerHeapProfile);
+
+static std::atomic<bool> g_cpu_profiling{false};
+
+// read in signal handler, so it is plain buffer, not changed while profiling.
+static char g_profile_worker_set[256] = {0};
+
+struct ThreadMark {
+  const char* worker_set_name{nullptr};
+};
+
+static ThreadMark& GetThreadMark() {
+  thread_local ThreadMark mark;
+  return mark;
+}
+
+Profiler::ScopedWorkerSet::ScopedWorkerSet(const char* name) {
+  auto& mark = GetThreadMark();
+  prev_name_ = mark.worker_set_name;
+  thread_mark_ = &mark;
+  mark.worker_set_name = name;
+}
+
+Profiler::ScopedWorkerSet::~ScopedWorkerSet() {
+  auto& mark = GetThreadMark();
+  // bthread is moved to other worker, the mark on origin worker is overwritten by next task.
+  if (thread_mark_ == &mark) {
+    mark.worker_set_name = prev_name_;
+  }
+}
+
+#ifdef BRPC_ENABLE_CPU_PROFILER
+static int FilterInThread(void*) {
+  const char* name = GetThreadMark().worker_set_name;
+  return name != nullptr && strcmp(name, g_profile_worker_set) == 0 ? 1 : 0;
+}
+#endif
+
+butil::Status Profiler::StartCpuProfile(int64_t seconds, const std::string& worker_set_name, std::string& file_path) {
+#ifdef BRPC_ENABLE_CPU_PROFILER
+  if (worker_set_name.size() >= sizeof(g_profile_worker_set)) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "worker set name is too long");
+  }
+
+  bool expected = false;
+  if (!g_cpu_profiling.compare_exchange_strong(expected, true)) {
+    return butil::Status(pb::error::EINTERNAL, "cpu profile is running");
+  }
+
+  strncpy(g_profile_worker_set, worker_set_name.c_str(), sizeof(g_profile_worker_set) - 1);
+  file_path = fmt::format("{}/cpu_{}_{}.prof", FLAGS_log_dir, worker_set_name.empty() ? "all" : worker_set_name,
+                          Helper::TimestampMs());
+
+  ProfilerOptions options;
+  memset(&options, 0, sizeof(options));
+  if (!worker_set_name.empty()) {
+    options.filter_in_thread = FilterInThread;
+  }
+  if (ProfilerStartWithOptions(file_path.c_str(), &options) == 0) {
+    g_cpu_profiling.store(false);
+    return butil::Status(pb::error::EINTERNAL, "start cpu profiler failed");
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[profiler] start cpu profile, worker_set({}) seconds({}) file({})", worker_set_name,
+                                 seconds, file_path);
+
+  Bthread bth([seconds, file_path]() {
+    bthread_usleep(seconds * 1000 * 1000);
+    ProfilerStop();
+    g_cpu_profiling.store(false);
+    DINGO_LOG(INFO) << fmt::format("[profiler] finish cpu profile, file({})", file_path);
+  });
+
+  return butil::Status::OK();
+#else
+  (void)seconds, (void)worker_set_name, (void)file_path;
+  return butil::Status(pb::error::ENOT_SUPPORT, "not build with BRPC_ENABLE_CPU_PROFILER");
+#endif
+}
+
+bool Profiler::IsCpuProfiling() { return g_cpu_profiling.load(); }
+
+butil::Status Profiler::DumpHeapProfile(std::string& file_path) {
+#ifdef LINK_TCMALLOC
+  std::string profile;
+  MallocExtension::instance()->GetHeapSample(&profile);
+
+  file_path = fmt::format("{}/heap_{}.prof", FLAGS_log_dir, Helper::TimestampMs());
+  std::ofstream file(file_path, std::ios::binary);
+  if (!file.is_open()) {
+    return butil::Status(pb::error::EINTERNAL, "open heap profile file failed");
+  }
+  file << profile;
+
+  DINGO_LOG(INFO) << fmt::format("[profiler] dump heap profile, file({}) size({})", file_path, profile.size());
+  return butil::Status::OK();
+#else
+  (void)file_path;
+  return butil::Status(pb::error::ENOT_SUPPORT, "not use tcmalloc");
+#endif
+}
+
+}  // namespace dingodb
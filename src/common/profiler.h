@@ -0,0 +1,59 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COMMON_PROFILER_H_
+#define DINGODB_COMMON_PROFILER_H_
+
+#include <cstdint>
+#include <string>
+
+#include "butil/status.h"
+
+namespace dingodb {
+
+// On-demand profile of running process, output is pprof format file under log dir.
+// Cpu profile can be limited to tasks of one worker set, e.g. raft apply or vector search, worker set mark the
+// running thread by ScopedWorkerSet. Triggered by reloadable flag so no restart is need:
+//   curl http://host:port/flags/cpu_profile_worker_set?setvalue=<worker set name>
+//   curl http://host:port/flags/trigger_cpu_profile_seconds?setvalue=30
+//   curl http://host:port/flags/trigger_heap_profile?setvalue=true
+class Profiler {
+ public:
+  // mark current thread running task of worker set during the scope, name must live longer than the scope.
+  class ScopedWorkerSet {
+   public:
+    explicit ScopedWorkerSet(const char* name);
+    ~ScopedWorkerSet();
+
+    ScopedWorkerSet(const ScopedWorkerSet&) = delete;
+    ScopedWorkerSet& operator=(const ScopedWorkerSet&) = delete;
+
+   private:
+    const char* prev_name_;
+    void* thread_mark_;
+  };
+
+  // start cpu profile in background and stop after seconds, only sample tasks of worker_set_name if not empty.
+  // need build with BRPC_ENABLE_CPU_PROFILER.
+  static butil::Status StartCpuProfile(int64_t seconds, const std::string& worker_set_name, std::string& file_path);
+  static bool IsCpuProfiling();
+
+  // dump sampled heap of tcmalloc, need set env TCMALLOC_SAMPLE_PARAMETER.
+  static butil::Status DumpHeapProfile(std::string& file_path);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_PROFILER_H_
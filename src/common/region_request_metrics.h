@@ -0,0 +1,67 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COMMON_REGION_REQUEST_METRICS_H_
+#define DINGODB_COMMON_REGION_REQUEST_METRICS_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "common/latency_sketch.h"
+
+namespace dingodb {
+
+// Compact request metrics block of one region, lock free updated by every request, instead of per region bvar.
+// Counters are accumulated since region is loaded, caller compute rate by delta.
+class RegionRequestMetrics {
+ public:
+  RegionRequestMetrics() = default;
+  ~RegionRequestMetrics() = default;
+
+  RegionRequestMetrics(const RegionRequestMetrics&) = delete;
+  RegionRequestMetrics& operator=(const RegionRequestMetrics&) = delete;
+
+  void Record(bool is_write, int64_t latency_us, bool is_error) {
+    if (is_write) {
+      write_count_.fetch_add(1, std::memory_order_relaxed);
+      write_latency_.Add(latency_us);
+    } else {
+      read_count_.fetch_add(1, std::memory_order_relaxed);
+      read_latency_.Add(latency_us);
+    }
+    if (is_error) {
+      error_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  int64_t ReadCount() const { return read_count_.load(std::memory_order_relaxed); }
+  int64_t WriteCount() const { return write_count_.load(std::memory_order_relaxed); }
+  int64_t ErrorCount() const { return error_count_.load(std::memory_order_relaxed); }
+
+  const LatencySketch& ReadLatency() const { return read_latency_; }
+  const LatencySketch& WriteLatency() const { return write_latency_; }
+
+ private:
+  std::atomic<int64_t> read_count_{0};
+  std::atomic<int64_t> write_count_{0};
+  std::atomic<int64_t> error_count_{0};
+
+  LatencySketch read_latency_;
+  LatencySketch write_latency_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_REGION_REQUEST_METRICS_H_
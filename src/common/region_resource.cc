@@ -0,0 +1,158 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/region_resource.h"
+
+#include <time.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+
+#include "brpc/reloadable_flags.h"
+#include "bthread/bthread.h"
+#include "bthread/mutex.h"
+#include "butil/time.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_int64(region_resource_flush_interval_ms, 1000, "flush interval of thread local region resource usage");
+BRPC_VALIDATE_GFLAG(region_resource_flush_interval_ms, brpc::NonNegativeInteger);
+
+namespace {
+
+struct ThreadState {
+  int64_t region_id{0};
+  bthread_t bthread_id{0};
+  int64_t last_flush_time_ms{0};
+  std::unordered_map<int64_t, RegionResourceUsage> usages;
+};
+
+struct GlobalState {
+  GlobalState() { bthread_mutex_init(&mutex, nullptr); }
+  ~GlobalState() { bthread_mutex_destroy(&mutex); }
+
+  bthread_mutex_t mutex;
+  std::unordered_map<int64_t, RegionResourceUsage> usages;
+};
+
+ThreadState& GetThreadState() {
+  thread_local ThreadState state;
+  return state;
+}
+
+GlobalState& GetGlobalState() {
+  static GlobalState state;
+  return state;
+}
+
+// usage of current scope, nullptr if current bthread is not in scope.
+RegionResourceUsage* CurrentUsage() {
+  auto& state = GetThreadState();
+  if (state.region_id == 0 || state.bthread_id != bthread_self()) {
+    return nullptr;
+  }
+  return &state.usages[state.region_id];
+}
+
+int64_t ThreadCpuTimeUs() {
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void Flush(ThreadState& state) {
+  auto& global = GetGlobalState();
+  BAIDU_SCOPED_LOCK(global.mutex);
+  for (const auto& [region_id, usage] : state.usages) {
+    global.usages[region_id].Add(usage);
+  }
+  state.usages.clear();
+}
+
+}  // namespace
+
+void RegionResourceAccounting::AddReadBytes(int64_t bytes) {
+  auto* usage = CurrentUsage();
+  if (usage != nullptr) {
+    usage->read_bytes += bytes;
+  }
+}
+
+void RegionResourceAccounting::AddWriteBytes(int64_t bytes) {
+  auto* usage = CurrentUsage();
+  if (usage != nullptr) {
+    usage->write_bytes += bytes;
+  }
+}
+
+void RegionResourceAccounting::AddSeekCount(int64_t count) {
+  auto* usage = CurrentUsage();
+  if (usage != nullptr) {
+    usage->seek_count += count;
+  }
+}
+
+void RegionResourceAccounting::AddScanKeyCount(int64_t count) {
+  auto* usage = CurrentUsage();
+  if (usage != nullptr) {
+    usage->scan_key_count += count;
+  }
+}
+
+std::unordered_map<int64_t, RegionResourceUsage> RegionResourceAccounting::TakeAll() {
+  std::unordered_map<int64_t, RegionResourceUsage> usages;
+
+  auto& global = GetGlobalState();
+  BAIDU_SCOPED_LOCK(global.mutex);
+  usages.swap(global.usages);
+  return usages;
+}
+
+RegionResourceScope::RegionResourceScope(int64_t region_id) : region_id_(region_id) {
+  auto& state = GetThreadState();
+  prev_region_id_ = state.region_id;
+  prev_bthread_id_ = state.bthread_id;
+  thread_state_ = &state;
+  state.region_id = region_id;
+  state.bthread_id = bthread_self();
+  start_cpu_time_us_ = ThreadCpuTimeUs();
+}
+
+RegionResourceScope::~RegionResourceScope() {
+  auto& state = GetThreadState();
+  // bthread is moved to other worker, the scope on origin worker is overwritten by next scope.
+  if (thread_state_ != &state) {
+    return;
+  }
+
+  state.usages[region_id_].cpu_time_us += ThreadCpuTimeUs() - start_cpu_time_us_;
+  state.region_id = prev_region_id_;
+  state.bthread_id = prev_bthread_id_;
+
+  // not flush in nested scope.
+  if (state.region_id != 0 && state.bthread_id == bthread_self()) {
+    return;
+  }
+
+  int64_t now_ms = butil::gettimeofday_ms();
+  if (now_ms - state.last_flush_time_ms >= FLAGS_region_resource_flush_interval_ms) {
+    state.last_flush_time_ms = now_ms;
+    Flush(state);
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,78 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COMMON_REGION_RESOURCE_H_
+#define DINGODB_COMMON_REGION_RESOURCE_H_
+
+#include <cstdint>
+#include <unordered_map>
+
+#include "bthread/types.h"
+
+namespace dingodb {
+
+// Resource used by one region.
+struct RegionResourceUsage {
+  int64_t cpu_time_us{0};
+  int64_t read_bytes{0};
+  int64_t write_bytes{0};
+  int64_t seek_count{0};
+  int64_t scan_key_count{0};
+
+  void Add(const RegionResourceUsage& other) {
+    cpu_time_us += other.cpu_time_us;
+    read_bytes += other.read_bytes;
+    write_bytes += other.write_bytes;
+    seek_count += other.seek_count;
+    scan_key_count += other.scan_key_count;
+  }
+};
+
+// Accounting resource usage by region.
+// Usages are accumulated in thread local and flushed to global at the end of scope periodically, so the hot path
+// never take lock. Engine read and write are charged to the region of current RegionResourceScope, and ignored
+// when there is no scope.
+class RegionResourceAccounting {
+ public:
+  static void AddReadBytes(int64_t bytes);
+  static void AddWriteBytes(int64_t bytes);
+  static void AddSeekCount(int64_t count);
+  static void AddScanKeyCount(int64_t count);
+
+  // take flushed usage of all regions since last take.
+  static std::unordered_map<int64_t, RegionResourceUsage> TakeAll();
+};
+
+// Charge cpu time and engine io of current bthread to region during the scope, e.g. service request or raft apply.
+// Cpu time is thread cpu time, it is dropped if bthread is moved to other worker within the scope.
+class RegionResourceScope {
+ public:
+  explicit RegionResourceScope(int64_t region_id);
+  ~RegionResourceScope();
+
+  RegionResourceScope(const RegionResourceScope&) = delete;
+  RegionResourceScope& operator=(const RegionResourceScope&) = delete;
+
+ private:
+  int64_t region_id_;
+  int64_t prev_region_id_;
+  bthread_t prev_bthread_id_;
+  void* thread_state_;
+  int64_t start_cpu_time_us_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_REGION_RESOURCE_H_
@@ -14,20 +14,49 @@
 
 #include "common/runnable.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "bthread/bthread.h"
 #include "butil/compiler_specific.h"
+#include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/numa.h"
+#include "common/profiler.h"
 #include "common/synchronization.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
 
 namespace dingodb {
 
+DEFINE_string(fair_worker_set_class_weight, "8,4,2,1",
+              "schedule weight of oltp,scan,analytics,background class in fair worker set");
+DEFINE_string(fair_worker_set_class_max_running_percent, "100,100,50,25",
+              "max running task of each class in percent of worker num, 100 is unlimited");
+DEFINE_string(fair_worker_set_class_admit_percent, "100,100,80,50",
+              "reject task of each class when pending task exceed this percent of max pending task count");
+DEFINE_string(fair_worker_set_class_queue_wait_slo_ms, "50,200,1000,0",
+              "queue wait slo of each class, 0 is no slo");
+
+const char* WorkloadClassName(WorkloadClass workload_class) {
+  switch (workload_class) {
+    case WorkloadClass::kOltp:
+      return "oltp";
+    case WorkloadClass::kScan:
+      return "scan";
+    case WorkloadClass::kAnalytics:
+      return "analytics";
+    case WorkloadClass::kBackground:
+      return "background";
+    default:
+      return "unknown";
+  }
+}
+
 TaskRunnable::TaskRunnable() : id_(GenId()) { create_time_us_ = Helper::TimestampUs(); }
 TaskRunnable::~TaskRunnable() = default;
 
@@ -49,6 +78,7 @@ int ExecuteRoutine(void* meta, bthread::TaskIterator<TaskRunnablePtr>& iter) {
 
     if (BAIDU_LIKELY(!iter.is_queue_stopped())) {
       int64_t start_time = Helper::TimestampMs();
+      Profiler::ScopedWorkerSet profile_scope(worker != nullptr ? worker->Name().c_str() : nullptr);
       (*iter)->Run();
       DINGO_LOG(DEBUG) << fmt::format("[execqueue][type({})] run task elapsed time {}(ms).", (*iter)->Type(),
                                       Helper::TimestampMs() - start_time);
@@ -75,6 +105,8 @@ Worker::~Worker() { bthread_mutex_destroy(&trace_mutex_); }
 bool Worker::Init() {
   bthread::ExecutionQueueOptions options;
   options.bthread_attr = BTHREAD_ATTR_NORMAL;
+  // Not inherit tag of caller, heavy task never run on raft bthread tag.
+  options.bthread_attr.tag = Constant::kDefaultBthreadTag;
 
   if (bthread::execution_queue_start(&queue_id_, &options, ExecuteRoutine, this) != 0) {
     DINGO_LOG(ERROR) << "[execqueue] start worker execution queue failed";
@@ -178,9 +210,17 @@ WorkerSet::WorkerSet(std::string name, uint32_t worker_num, int64_t max_pending_
       queue_wait_metrics_(fmt::format("dingo_worker_set_{}_queue_wait_latency", name)),
       queue_run_metrics_(fmt::format("dingo_worker_set_{}_queue_run_latency", name)){};
 
+void WorkerSet::InitPthreadWorker() {
+  pthread_setname_np(pthread_self(), GenWorkerName().c_str());
+  if (numa_node_ >= 0) {
+    NumaTopology::BindCurrentThread(numa_node_);
+  }
+}
+
 bool ExecqWorkerSet::Init() {
   for (int i = 0; i < WorkerNum(); ++i) {
     auto worker = Worker::New([this](WorkerEventType type) { WatchWorker(type); });
+    worker->SetName(Name());
     if (!worker->Init()) {
       return false;
     }
@@ -299,7 +339,7 @@ SimpleWorkerSet::~SimpleWorkerSet() {
 bool SimpleWorkerSet::Init() {
   auto worker_function = [this]() {
     if (IsUsePthread()) {
-      pthread_setname_np(pthread_self(), GenWorkerName().c_str());
+      InitPthreadWorker();
     }
 
     while (true) {
@@ -326,6 +366,7 @@ bool SimpleWorkerSet::Init() {
         int64_t now_time_us = Helper::TimestampUs();
         QueueWaitMetrics(now_time_us - task->CreateTimeUs());
 
+        Profiler::ScopedWorkerSet profile_scope(Name().c_str());
         task->Run();
 
         QueueRunMetrics(Helper::TimestampUs() - now_time_us);
@@ -398,6 +439,7 @@ bool SimpleWorkerSet::Execute(TaskRunnablePtr task) {
   if (is_inplace_run && pending_task_count < WorkerNum()) {
     int64_t now_time_us = Helper::TimestampUs();
 
+    Profiler::ScopedWorkerSet profile_scope(Name().c_str());
     task->Run();
 
     QueueRunMetrics(Helper::TimestampUs() - now_time_us);
@@ -438,7 +480,7 @@ PriorWorkerSet::~PriorWorkerSet() {
 bool PriorWorkerSet::Init() {
   auto worker_function = [this]() {
     if (IsUsePthread()) {
-      pthread_setname_np(pthread_self(), GenWorkerName().c_str());
+      InitPthreadWorker();
     }
 
     while (true) {
@@ -464,6 +506,7 @@ bool PriorWorkerSet::Init() {
         int64_t now_time_us = Helper::TimestampUs();
         QueueWaitMetrics(now_time_us - task->CreateTimeUs());
 
+        Profiler::ScopedWorkerSet profile_scope(Name().c_str());
         task->Run();
 
         QueueRunMetrics(Helper::TimestampUs() - now_time_us);
@@ -536,6 +579,7 @@ bool PriorWorkerSet::Execute(TaskRunnablePtr task) {
   if (is_inplace_run && pending_task_count < WorkerNum()) {
     int64_t now_time_us = Helper::TimestampUs();
 
+    Profiler::ScopedWorkerSet profile_scope(Name().c_str());
     task->Run();
 
     QueueRunMetrics(Helper::TimestampUs() - now_time_us);
@@ -559,4 +603,256 @@ bool PriorWorkerSet::ExecuteLeastQueue(TaskRunnablePtr task) { return Execute(ta
 
 bool PriorWorkerSet::ExecuteHashByRegionId(int64_t /*region_id*/, TaskRunnablePtr task) { return Execute(task); }
 
-}  // namespace dingodb
\ No newline at end of file
+// parse per class value, missing value use default_value.
+static std::vector<int64_t> ParseClassValues(const std::string& str, int64_t default_value) {
+  std::vector<int64_t> values;
+  Helper::SplitString(str, ',', values);
+  values.resize(kWorkloadClassNum, default_value);
+  return values;
+}
+
+FairWorkerSet::FairWorkerSet(std::string name, uint32_t worker_num, int64_t max_pending_task_count, bool use_pthread)
+    : WorkerSet(name, worker_num, max_pending_task_count, use_pthread, false) {
+  bthread_mutex_init(&mutex_, nullptr);
+  bthread_cond_init(&cond_, nullptr);
+
+  auto weights = ParseClassValues(FLAGS_fair_worker_set_class_weight, 1);
+  auto max_running_percents = ParseClassValues(FLAGS_fair_worker_set_class_max_running_percent, 100);
+  auto admit_percents = ParseClassValues(FLAGS_fair_worker_set_class_admit_percent, 100);
+  auto queue_wait_slos = ParseClassValues(FLAGS_fair_worker_set_class_queue_wait_slo_ms, 0);
+
+  for (int i = 0; i < kWorkloadClassNum; ++i) {
+    auto& class_queue = class_queues_[i];
+    class_queue.weight = std::max(weights[i], static_cast<int64_t>(1));
+    if (max_running_percents[i] > 0 && max_running_percents[i] < 100) {
+      class_queue.max_running_count = std::max(worker_num * max_running_percents[i] / 100, static_cast<int64_t>(1));
+    }
+    class_queue.admit_percent = admit_percents[i];
+    class_queue.queue_wait_slo_us = queue_wait_slos[i] * 1000;
+
+    std::string class_name = WorkloadClassName(static_cast<WorkloadClass>(i));
+    class_queue.queue_wait_metrics.expose(fmt::format("dingo_worker_set_{}_{}_queue_wait_latency", name, class_name));
+    class_queue.slo_violation_metrics.expose(fmt::format("dingo_worker_set_{}_{}_slo_violation", name, class_name));
+    class_queue.reject_metrics.expose(fmt::format("dingo_worker_set_{}_{}_reject_count", name, class_name));
+  }
+}
+
+FairWorkerSet::~FairWorkerSet() {
+  Destroy();
+
+  bthread_cond_destroy(&cond_);
+  bthread_mutex_destroy(&mutex_);
+}
+
+bool FairWorkerSet::Init() {
+  auto worker_function = [this]() {
+    if (IsUsePthread()) {
+      InitPthreadWorker();
+    }
+
+    while (true) {
+      bthread_mutex_lock(&mutex_);
+      TaskRunnablePtr task = PopTask();
+      // class may has queued task but reach its running limit, wait running task finish.
+      while (task == nullptr && !(is_stop && queued_task_count_ == 0)) {
+        bthread_cond_wait(&cond_, &mutex_);
+        task = PopTask();
+      }
+      bthread_mutex_unlock(&mutex_);
+
+      if (task == nullptr) {
+        break;
+      }
+
+      RunTask(task);
+    }
+
+    stoped_count.fetch_add(1);
+  };
+
+  if (IsUsePthread()) {
+    for (int i = 0; i < WorkerNum(); ++i) {
+      pthread_workers_.push_back(std::thread(worker_function));
+    }
+  } else {
+    for (int i = 0; i < WorkerNum(); ++i) {
+      bthread_workers_.push_back(Bthread(worker_function));
+    }
+  }
+
+  return true;
+}
+
+void FairWorkerSet::Destroy() {
+  // guarantee idempotent
+  if (IsDestroied()) {
+    return;
+  }
+
+  // stop worker thread/bthread
+  bthread_mutex_lock(&mutex_);
+  is_stop = true;
+  bthread_mutex_unlock(&mutex_);
+
+  while (stoped_count.load() < WorkerNum()) {
+    bthread_cond_broadcast(&cond_);
+    bthread_usleep(100000);
+  }
+
+  // join thread/bthread
+  if (IsUsePthread()) {
+    for (auto& std_thread : pthread_workers_) {
+      std_thread.join();
+    }
+  } else {
+    for (auto& bthread : bthread_workers_) {
+      bthread.Join();
+    }
+  }
+}
+
+TaskRunnablePtr FairWorkerSet::PopTask() {
+  // stride of weight 1, class with weight w run w times of class with weight 1.
+  constexpr uint64_t kStride = 1 << 20;
+
+  ClassQueue* selected = nullptr;
+  for (auto& class_queue : class_queues_) {
+    if (class_queue.tasks.empty() ||
+        (class_queue.max_running_count > 0 && class_queue.running_count >= class_queue.max_running_count)) {
+      continue;
+    }
+    if (selected == nullptr || class_queue.pass < selected->pass) {
+      selected = &class_queue;
+    }
+  }
+  if (selected == nullptr) {
+    return nullptr;
+  }
+
+  auto task = selected->tasks.front();
+  selected->tasks.pop();
+  --queued_task_count_;
+  ++selected->running_count;
+
+  virtual_time_ = selected->pass;
+  selected->pass += kStride / selected->weight;
+
+  return task;
+}
+
+void FairWorkerSet::RunTask(TaskRunnablePtr task) {
+  auto& class_queue = class_queues_[static_cast<int>(task->GetWorkloadClass())];
+
+  int64_t now_time_us = Helper::TimestampUs();
+  int64_t queue_wait_us = now_time_us - task->CreateTimeUs();
+  QueueWaitMetrics(queue_wait_us);
+  class_queue.queue_wait_metrics << queue_wait_us;
+  if (class_queue.queue_wait_slo_us > 0 && queue_wait_us > class_queue.queue_wait_slo_us) {
+    class_queue.slo_violation_metrics << 1;
+  }
+
+  Profiler::ScopedWorkerSet profile_scope(Name().c_str());
+  task->Run();
+
+  QueueRunMetrics(Helper::TimestampUs() - now_time_us);
+
+  bthread_mutex_lock(&mutex_);
+  --class_queue.running_count;
+  bool has_queued_task = queued_task_count_ > 0;
+  bthread_mutex_unlock(&mutex_);
+  // task of this class may wait for running limit
+  if (has_queued_task) {
+    bthread_cond_signal(&cond_);
+  }
+
+  DecPendingTaskCount();
+  Notify(WorkerEventType::kFinishTask);
+}
+
+bool FairWorkerSet::Execute(TaskRunnablePtr task) {
+  int class_index = static_cast<int>(task->GetWorkloadClass());
+  if (class_index < 0 || class_index >= kWorkloadClassNum) {
+    class_index = static_cast<int>(WorkloadClass::kOltp);
+    task->SetWorkloadClass(WorkloadClass::kOltp);
+  }
+  auto& class_queue = class_queues_[class_index];
+
+  // lower class is rejected earlier when overload.
+  int64_t max_pending_task_count = MaxPendingTaskCount() * class_queue.admit_percent / 100;
+  uint64_t pending_task_count = PendingTaskCount();
+  if (BAIDU_UNLIKELY(max_pending_task_count > 0 && pending_task_count > max_pending_task_count)) {
+    class_queue.reject_metrics << 1;
+    DINGO_LOG(WARNING) << fmt::format("[execqueue] {} class exceed max pending task limit, {}/{}",
+                                      WorkloadClassName(task->GetWorkloadClass()), pending_task_count,
+                                      max_pending_task_count);
+    return false;
+  }
+
+  IncPendingTaskCount();
+  IncTotalTaskCount();
+
+  bthread_mutex_lock(&mutex_);
+  // idle class start from current virtual time, it can not save credit when idle.
+  if (class_queue.tasks.empty()) {
+    class_queue.pass = std::max(class_queue.pass, virtual_time_);
+  }
+  class_queue.tasks.push(task);
+  ++queued_task_count_;
+  bthread_mutex_unlock(&mutex_);
+  bthread_cond_signal(&cond_);
+
+  return true;
+}
+
+bool FairWorkerSet::ExecuteRR(TaskRunnablePtr task) { return Execute(task); }
+
+bool FairWorkerSet::ExecuteLeastQueue(TaskRunnablePtr task) { return Execute(task); }
+
+bool FairWorkerSet::ExecuteHashByRegionId(int64_t /*region_id*/, TaskRunnablePtr task) { return Execute(task); }
+
+NumaWorkerSet::NumaWorkerSet(std::string name, uint32_t worker_num, int64_t max_pending_task_count,
+                             bool is_inplace_run)
+    : WorkerSet(name, worker_num, max_pending_task_count, true, is_inplace_run) {}
+
+NumaWorkerSet::~NumaWorkerSet() { Destroy(); }
+
+bool NumaWorkerSet::Init() {
+  int32_t node_num = NumaTopology::NodeNum();
+  for (int32_t node = 0; node < node_num; ++node) {
+    auto worker_set = SimpleWorkerSet::New(fmt::format("{}_node{}", Name(), node),
+                                           std::max(WorkerNum() / node_num, static_cast<uint32_t>(1)),
+                                           MaxPendingTaskCount() / node_num, true, is_inplace_run);
+    worker_set->SetNumaNode(node);
+    if (!worker_set->Init()) {
+      DINGO_LOG(ERROR) << fmt::format("[execqueue] init worker set {} of node({}) failed.", Name(), node);
+      return false;
+    }
+    node_worker_sets_.push_back(worker_set);
+  }
+
+  return true;
+}
+
+void NumaWorkerSet::Destroy() {
+  if (IsDestroied()) {
+    return;
+  }
+
+  for (auto& worker_set : node_worker_sets_) {
+    worker_set->Destroy();
+  }
+}
+
+bool NumaWorkerSet::Execute(TaskRunnablePtr task) {
+  return node_worker_sets_[NumaTopology::CurrentNode() % node_worker_sets_.size()]->Execute(task);
+}
+
+bool NumaWorkerSet::ExecuteRR(TaskRunnablePtr task) { return Execute(task); }
+
+bool NumaWorkerSet::ExecuteLeastQueue(TaskRunnablePtr task) { return Execute(task); }
+
+bool NumaWorkerSet::ExecuteHashByRegionId(int64_t region_id, TaskRunnablePtr task) {
+  return node_worker_sets_[NumaTopology::NodeOfRegion(region_id) % node_worker_sets_.size()]->Execute(task);
+}
+
+}  // namespace dingodb
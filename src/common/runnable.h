@@ -29,9 +29,25 @@
 #include "bthread/types.h"
 #include "bvar/latency_recorder.h"
 #include "common/synchronization.h"
+#include "common/task_pool.h"
 
 namespace dingodb {
 
+// Workload class of task, FairWorkerSet schedule and admit task by it.
+enum class WorkloadClass : int32_t {
+  // point read/write and txn
+  kOltp = 0,
+  // range scan
+  kScan = 1,
+  // scan with coprocessor
+  kAnalytics = 2,
+  // backup, restore and gc
+  kBackground = 3,
+};
+constexpr int kWorkloadClassNum = 4;
+
+const char* WorkloadClassName(WorkloadClass workload_class);
+
 class TaskRunnable {
  public:
   TaskRunnable();
@@ -49,6 +65,9 @@ class TaskRunnable {
   int32_t Priority() const { return priority_; }
   void SetPriority(int32_t priority) { priority_ = priority; }
 
+  WorkloadClass GetWorkloadClass() const { return workload_class_; }
+  void SetWorkloadClass(WorkloadClass workload_class) { workload_class_ = workload_class; }
+
   // Operator overloading to compare tasks.
   bool operator<(const TaskRunnable& other) const {
     // Note: Higher priority tasks should come first.
@@ -60,11 +79,22 @@ class TaskRunnable {
  private:
   uint64_t id_{0};
   int32_t priority_{0};
+  WorkloadClass workload_class_{WorkloadClass::kOltp};
   int64_t create_time_us_{0};
 };
 
 using TaskRunnablePtr = std::shared_ptr<TaskRunnable>;
 
+// Create task in one pooled block with its control block, instead of std::make_shared.
+template <typename T, typename... Args>
+std::shared_ptr<T> NewTask(Args&&... args) {
+  return std::allocate_shared<T>(TaskPoolAllocator<T>(), std::forward<Args>(args)...);
+}
+
+// Handler of function task, lambda capture several pointers is stored inline without allocation.
+constexpr size_t kTaskHandlerInlineSize = 64;
+using TaskHandler = InlineFunction<kTaskHandlerInlineSize>;
+
 // Custom Comparator for priority_queue
 struct CompareTaskRunnable {
   bool operator()(const TaskRunnablePtr& lhs, TaskRunnablePtr& rhs) const { return lhs.get() < rhs.get(); }
@@ -105,7 +135,13 @@ class Worker {
   void PopPendingTaskTrace(uint64_t task_id);
   std::vector<std::string> GetPendingTaskTrace();
 
+  // name of owner worker set, used by profiler to filter task, set before Init().
+  const std::string& Name() const { return name_; }
+  void SetName(const std::string& name) { name_ = name; }
+
  private:
+  std::string name_;
+
   // Execution queue is available.
   std::atomic<bool> is_available_;
   bthread::ExecutionQueueId<TaskRunnablePtr> queue_id_;
@@ -139,13 +175,17 @@ class WorkerSet {
   virtual bool ExecuteLeastQueue(TaskRunnablePtr task) = 0;
   virtual bool ExecuteHashByRegionId(int64_t region_id, TaskRunnablePtr task) = 0;
 
-  std::string Name() const { return name_; }
+  const std::string& Name() const { return name_; }
   std::string GenWorkerName() { return name_ + "_" + std::to_string(GenWorkerNo()); }
   uint32_t GenWorkerNo() { return worker_no_generator_.fetch_add(1); }
   bool IsUsePthread() const { return use_pthread_; }
   uint32_t WorkerNum() const { return worker_num_; }
   int64_t MaxPendingTaskCount() const { return max_pending_task_count_; }
 
+  // pthread worker is bound to cpus of numa node, -1 is not bound, set before Init().
+  int32_t NumaNode() const { return numa_node_; }
+  void SetNumaNode(int32_t numa_node) { numa_node_ = numa_node; }
+
   uint64_t TotalTaskCount() { return total_task_count_metrics_.get_value(); }
   void IncTotalTaskCount() { total_task_count_metrics_ << 1; }
 
@@ -184,6 +224,7 @@ class WorkerSet {
 
   uint32_t worker_num_{0};
   int64_t max_pending_task_count_{0};
+  int32_t numa_node_{-1};
   std::atomic<int64_t> pending_task_count_{0};
 
   // Notify
@@ -196,6 +237,9 @@ class WorkerSet {
   bvar::LatencyRecorder queue_run_metrics_;
 
  protected:
+  // set name of current pthread worker and bind it to numa node.
+  void InitPthreadWorker();
+
   bool IsDestroied() {
     bool expect = false;
     return !is_destroied.compare_exchange_strong(expect, true);
@@ -299,6 +343,84 @@ class PriorWorkerSet : public WorkerSet {
   std::vector<std::thread> pthread_workers_;
 };
 
+// MPMC multiple producer, multiple consumer
+// Weighted fair queue by workload class, class queues are scheduled by stride of weight, and each class
+// has its own running limit and admit limit, so background task can not starve oltp task.
+class FairWorkerSet : public WorkerSet {
+ public:
+  FairWorkerSet(std::string name, uint32_t worker_num, int64_t max_pending_task_count, bool use_pthread);
+  ~FairWorkerSet() override;
+
+  static WorkerSetPtr New(std::string name, uint32_t worker_num, uint32_t max_pending_task_count, bool use_pthread) {
+    return std::make_shared<FairWorkerSet>(name, worker_num, max_pending_task_count, use_pthread);
+  }
+
+  bool Init() override;
+  void Destroy() override;
+
+  bool Execute(TaskRunnablePtr task) override;
+  bool ExecuteRR(TaskRunnablePtr task) override;
+  bool ExecuteLeastQueue(TaskRunnablePtr task) override;
+  bool ExecuteHashByRegionId(int64_t region_id, TaskRunnablePtr task) override;
+
+ private:
+  struct ClassQueue {
+    std::queue<TaskRunnablePtr> tasks;
+    int64_t weight{1};
+    // 0 is unlimited
+    int64_t max_running_count{0};
+    int64_t admit_percent{100};
+    // 0 is no slo
+    int64_t queue_wait_slo_us{0};
+
+    int64_t running_count{0};
+    // virtual finish time of class, smallest one run first
+    uint64_t pass{0};
+
+    bvar::LatencyRecorder queue_wait_metrics;
+    bvar::Adder<int64_t> slo_violation_metrics;
+    bvar::Adder<int64_t> reject_metrics;
+  };
+
+  // caller hold mutex_, return nullptr if no class can run task now.
+  TaskRunnablePtr PopTask();
+
+  void RunTask(TaskRunnablePtr task);
+
+  bthread_mutex_t mutex_;
+  bthread_cond_t cond_;
+  ClassQueue class_queues_[kWorkloadClassNum];
+  int64_t queued_task_count_{0};
+  uint64_t virtual_time_{0};
+
+  std::vector<Bthread> bthread_workers_;
+  std::vector<std::thread> pthread_workers_;
+};
+
+// Partition task by numa node, every node has a pthread SimpleWorkerSet bound to its cpus.
+// Task of a region run on node of the region, other task run on node of the submitter.
+class NumaWorkerSet : public WorkerSet {
+ public:
+  NumaWorkerSet(std::string name, uint32_t worker_num, int64_t max_pending_task_count, bool is_inplace_run);
+  ~NumaWorkerSet() override;
+
+  static WorkerSetPtr New(std::string name, uint32_t worker_num, uint32_t max_pending_task_count,
+                          bool is_inplace_run) {
+    return std::make_shared<NumaWorkerSet>(name, worker_num, max_pending_task_count, is_inplace_run);
+  }
+
+  bool Init() override;
+  void Destroy() override;
+
+  bool Execute(TaskRunnablePtr task) override;
+  bool ExecuteRR(TaskRunnablePtr task) override;
+  bool ExecuteLeastQueue(TaskRunnablePtr task) override;
+  bool ExecuteHashByRegionId(int64_t region_id, TaskRunnablePtr task) override;
+
+ private:
+  std::vector<WorkerSetPtr> node_worker_sets_;
+};
+
 }  // namespace dingodb
 
 #endif  // DINGODB_COMMON_RUNNABLE_H_
\ No newline at end of file
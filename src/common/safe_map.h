@@ -15,13 +15,17 @@
 #ifndef DINGODB_COMMON_SAFE_MAP_H_
 #define DINGODB_COMMON_SAFE_MAP_H_
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <set>
 #include <utility>
 #include <vector>
 
+#include "bthread/mutex.h"
 #include "butil/containers/doubly_buffered_data.h"
 #include "butil/containers/flat_map.h"
 
@@ -1116,6 +1120,270 @@ class DingoSafeStdMap {
   TypeSafeMap safe_map;
 };
 
+// Implement a ThreadSafeMap for write heavy map, e.g. map updated by every heartbeat
+// Keys are spread to shards by hash, every shard is a FlatMap protected by its own mutex, so a write only
+// lock one shard and not copy the whole map twice as DingoSafeMap, but a read also lock the shard.
+// Same interface and return value as DingoSafeMap, except GetRawMapCopy/CopyFromRawMap which lock shard one by one.
+// Notice: Must call Init(capacity) before use
+template <typename T_KEY, typename T_VALUE, size_t kShardNum = 32>
+class DingoShardedSafeMap {
+ public:
+  using TypeRawMap = butil::FlatMap<T_KEY, T_VALUE>;
+
+  DingoShardedSafeMap() {
+    for (auto &shard : shards_) {
+      bthread_mutex_init(&shard.mutex, nullptr);
+    }
+  }
+  DingoShardedSafeMap(const DingoShardedSafeMap &) = delete;
+  ~DingoShardedSafeMap() {
+    for (auto &shard : shards_) {
+      bthread_mutex_destroy(&shard.mutex);
+    }
+  }
+
+  void Init(int64_t capacity) {
+    for (auto &shard : shards_) {
+      BAIDU_SCOPED_LOCK(shard.mutex);
+      CHECK_EQ(0, shard.map.init(ShardCapacity(capacity)));
+    }
+  }
+  void Resize(int64_t capacity) {
+    for (auto &shard : shards_) {
+      BAIDU_SCOPED_LOCK(shard.mutex);
+      CHECK_EQ(0, shard.map.resize(ShardCapacity(capacity)));
+    }
+  }
+
+  int Get(const T_KEY &key, T_VALUE &value) {
+    auto &shard = GetShard(key);
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    auto *value_ptr = shard.map.seek(key);
+    if (!value_ptr) {
+      return -1;
+    }
+
+    value = *value_ptr;
+    return 1;
+  }
+
+  int MultiGet(const std::vector<T_KEY> &keys, std::vector<T_VALUE> &values, std::vector<bool> &exists) {
+    for (const auto &key : keys) {
+      T_VALUE value;
+      bool exist = Get(key, value) > 0;
+      values.push_back(exist ? value : T_VALUE());
+      exists.push_back(exist);
+    }
+
+    return 1;
+  }
+
+  T_VALUE Get(const T_KEY &key) {
+    T_VALUE value;
+    Get(key, value);
+    return value;
+  }
+
+  int GetAllKeys(std::vector<T_KEY> &keys) {
+    ForEach([&](const T_KEY &key, const T_VALUE &) { keys.push_back(key); });
+    return keys.size();
+  }
+
+  int GetAllKeys(std::set<T_KEY> &keys, std::function<bool(T_VALUE)> filter = nullptr) {
+    ForEach([&](const T_KEY &key, const T_VALUE &value) {
+      if (filter == nullptr || filter(value)) {
+        keys.insert(key);
+      }
+    });
+    return keys.size();
+  }
+
+  int GetAllValues(std::vector<T_VALUE> &values, std::function<bool(T_VALUE)> filter = nullptr) {
+    ForEach([&](const T_KEY &, const T_VALUE &value) {
+      if (filter == nullptr || filter(value)) {
+        values.push_back(value);
+      }
+    });
+    return values.size();
+  }
+
+  int GetAllKeyValues(std::vector<T_KEY> &keys, std::vector<T_VALUE> &values,
+                      std::function<bool(T_VALUE)> filter = nullptr) {
+    ForEach([&](const T_KEY &key, const T_VALUE &value) {
+      if (filter == nullptr || filter(value)) {
+        keys.push_back(key);
+        values.push_back(value);
+      }
+    });
+    return keys.size();
+  }
+
+  int GetAllKeyValues(std::map<T_KEY, T_VALUE> &key_value_map, std::function<bool(T_VALUE)> filter = nullptr) {
+    ForEach([&](const T_KEY &key, const T_VALUE &value) {
+      if (filter == nullptr || filter(value)) {
+        key_value_map.insert_or_assign(key, value);
+      }
+    });
+    return key_value_map.size();
+  }
+
+  bool Exists(const T_KEY &key) {
+    auto &shard = GetShard(key);
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    return shard.map.seek(key) != nullptr;
+  }
+
+  int SafeExists(const T_KEY &key, bool &exists) {
+    exists = Exists(key);
+    return 1;
+  }
+
+  int64_t Size() {
+    int64_t size = 0;
+    for (auto &shard : shards_) {
+      BAIDU_SCOPED_LOCK(shard.mutex);
+      size += shard.map.size();
+    }
+    return size;
+  }
+
+  int64_t MemorySize() {
+    int64_t size = 0;
+    ForEach([&](const T_KEY &, const T_VALUE &value) { size += value.ByteSizeLong(); });
+    return size;
+  }
+
+  int CopyFromRawMap(const TypeRawMap &input_map) {
+    Clear();
+    for (const auto &it : input_map) {
+      Put(it.first, it.second);
+    }
+    return 1;
+  }
+
+  // the out_map must be initialized before call this function
+  int GetRawMapCopy(TypeRawMap &out_map) {
+    out_map.clear();
+    ForEach([&](const T_KEY &key, const T_VALUE &value) { out_map.insert(key, value); });
+    return 1;
+  }
+
+  int Put(const T_KEY &key, const T_VALUE &value) {
+    auto &shard = GetShard(key);
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    shard.map.insert(key, value);
+    return 1;
+  }
+
+  int MultiPut(const std::vector<T_KEY> &key_list, const std::vector<T_VALUE> &value_list) {
+    if (key_list.size() != value_list.size() || key_list.empty()) {
+      return -1;
+    }
+
+    for (size_t i = 0; i < key_list.size(); ++i) {
+      Put(key_list[i], value_list[i]);
+    }
+    return 1;
+  }
+
+  int MultiErase(const std::vector<T_KEY> &key_list) {
+    if (key_list.empty()) {
+      return -1;
+    }
+
+    for (const auto &key : key_list) {
+      Erase(key);
+    }
+    return 1;
+  }
+
+  int PutIfExists(const T_KEY &key, const T_VALUE &value) {
+    auto &shard = GetShard(key);
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    auto *value_ptr = shard.map.seek(key);
+    if (value_ptr == nullptr) {
+      return -1;
+    }
+
+    *value_ptr = value;
+    return 1;
+  }
+
+  int PutIfAbsent(const T_KEY &key, const T_VALUE &value) {
+    auto &shard = GetShard(key);
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    if (shard.map.seek(key) != nullptr) {
+      return -1;
+    }
+
+    shard.map.insert(key, value);
+    return 1;
+  }
+
+  int PutIfEqual(const T_KEY &key, const T_VALUE &value) {
+    auto &shard = GetShard(key);
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    auto *value_ptr = shard.map.seek(key);
+    if (value_ptr == nullptr || *value_ptr != value) {
+      return -1;
+    }
+
+    return 1;
+  }
+
+  int PutIfNotEqual(const T_KEY &key, const T_VALUE &value) {
+    auto &shard = GetShard(key);
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    auto *value_ptr = shard.map.seek(key);
+    if (value_ptr == nullptr || *value_ptr == value) {
+      return -1;
+    }
+
+    *value_ptr = value;
+    return 1;
+  }
+
+  int Erase(const T_KEY &key) {
+    auto &shard = GetShard(key);
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    shard.map.erase(key);
+    return 1;
+  }
+
+  int Clear() {
+    for (auto &shard : shards_) {
+      BAIDU_SCOPED_LOCK(shard.mutex);
+      shard.map.clear();
+    }
+    return 1;
+  }
+
+ private:
+  struct Shard {
+    bthread_mutex_t mutex;
+    TypeRawMap map;
+  };
+
+  static size_t ShardCapacity(int64_t capacity) {
+    return std::max(static_cast<size_t>(capacity) / kShardNum, static_cast<size_t>(16));
+  }
+
+  Shard &GetShard(const T_KEY &key) { return shards_[std::hash<T_KEY>()(key) % kShardNum]; }
+
+  // visit all records with shard locked one by one, so it is not a snapshot of whole map.
+  template <typename Func>
+  void ForEach(Func func) {
+    for (auto &shard : shards_) {
+      BAIDU_SCOPED_LOCK(shard.mutex);
+      for (const auto &it : shard.map) {
+        func(it.first, it.second);
+      }
+    }
+  }
+
+  std::array<Shard, kShardNum> shards_;
+};
+
 }  // namespace dingodb
 
 #endif  // DINGODB_COMMON_SAFE_MAP_H_
\ No newline at end of file
@@ -52,6 +52,30 @@ void SerialHelper::WriteLong(int64_t value, std::string& output) {
   }
 }
 
+void SerialHelper::WriteLong(int64_t value, char* buf) {
+  if (BAIDU_LIKELY(IsLE())) {
+    // value is little endian
+    buf[0] = static_cast<char>(value >> 56);
+    buf[1] = static_cast<char>(value >> 48);
+    buf[2] = static_cast<char>(value >> 40);
+    buf[3] = static_cast<char>(value >> 32);
+    buf[4] = static_cast<char>(value >> 24);
+    buf[5] = static_cast<char>(value >> 16);
+    buf[6] = static_cast<char>(value >> 8);
+    buf[7] = static_cast<char>(value);
+  } else {
+    // value is big endian
+    buf[0] = static_cast<char>(value);
+    buf[1] = static_cast<char>(value >> 8);
+    buf[2] = static_cast<char>(value >> 16);
+    buf[3] = static_cast<char>(value >> 24);
+    buf[4] = static_cast<char>(value >> 32);
+    buf[5] = static_cast<char>(value >> 40);
+    buf[6] = static_cast<char>(value >> 48);
+    buf[7] = static_cast<char>(value >> 56);
+  }
+}
+
 int64_t SerialHelper::ReadLong(const std::string_view& value) {
   CHECK(value.size() >= 8) << "value size must is gt 8.";
 
@@ -102,6 +126,12 @@ void SerialHelper::WriteLongWithNegation(int64_t value, std::string& output) {
   }
 }
 
+void SerialHelper::WriteLongWithNegation(int64_t value, char* buf) {
+  CHECK(value >= 0) << "value must be positive.";
+
+  WriteLong(~value, buf);
+}
+
 int64_t SerialHelper::ReadLongWithNegation(const std::string_view& value) { return ~ReadLong(value); }
 
 void SerialHelper::WriteLongComparable(int64_t data, std::string& output) {
@@ -130,6 +160,32 @@ void SerialHelper::WriteLongComparable(int64_t data, std::string& output) {
   }
 }
 
+void SerialHelper::WriteLongComparable(int64_t data, char* buf) {
+  uint64_t* l = (uint64_t*)&data;
+  if (BAIDU_LIKELY(IsLE())) {
+    // value is little endian
+    buf[0] = static_cast<char>(*l >> 56 ^ 0x80);
+    buf[1] = static_cast<char>(*l >> 48);
+    buf[2] = static_cast<char>(*l >> 40);
+    buf[3] = static_cast<char>(*l >> 32);
+    buf[4] = static_cast<char>(*l >> 24);
+    buf[5] = static_cast<char>(*l >> 16);
+    buf[6] = static_cast<char>(*l >> 8);
+    buf[7] = static_cast<char>(*l);
+
+  } else {
+    // value is big endian
+    buf[0] = static_cast<char>(*l ^ 0x80);
+    buf[1] = static_cast<char>(*l >> 8);
+    buf[2] = static_cast<char>(*l >> 16);
+    buf[3] = static_cast<char>(*l >> 24);
+    buf[4] = static_cast<char>(*l >> 32);
+    buf[5] = static_cast<char>(*l >> 40);
+    buf[6] = static_cast<char>(*l >> 48);
+    buf[7] = static_cast<char>(*l >> 56);
+  }
+}
+
 int64_t SerialHelper::ReadLongComparable(const std::string& value) {
   CHECK(value.size() >= 8) << "value size must is gt 8.";
 
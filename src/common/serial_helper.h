@@ -32,14 +32,18 @@ class SerialHelper {
 
   // write value
   static void WriteLong(int64_t value, std::string& output);
+  // write value to buf, buf size must not less than 8 bytes
+  static void WriteLong(int64_t value, char* buf);
   static int64_t ReadLong(const std::string_view& value);
 
   // write ~value
   static void WriteLongWithNegation(int64_t value, std::string& output);
+  static void WriteLongWithNegation(int64_t value, char* buf);
   static int64_t ReadLongWithNegation(const std::string_view& value);
 
   // highest bit ~
   static void WriteLongComparable(int64_t data, std::string& output);
+  static void WriteLongComparable(int64_t data, char* buf);
   static int64_t ReadLongComparable(const std::string& value);
   static int64_t ReadLongComparable(const std::string_view& value);
 };
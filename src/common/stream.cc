@@ -15,9 +15,13 @@
 #include "common/stream.h"
 
 #include <cstddef>
+#include <algorithm>
 #include <cstdint>
+#include <string>
 #include <utility>
+#include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "butil/guid.h"
 #include "common/helper.h"
 #include "fmt/core.h"
@@ -28,14 +32,22 @@ namespace dingodb {
 DEFINE_uint32(stream_expire_interval_ms, 60000, "stream expire interval");
 DEFINE_int64(stream_message_max_bytes, 60 * 1024 * 1024, "stream message max bytes");
 DEFINE_int64(stream_message_max_limit_size, 40960, "stream message max line size");
+DEFINE_int64(stream_state_max_memory_bytes, 512 * 1024 * 1024,
+             "max memory of all stream state, evict least recently used one when over, 0 is unlimit");
+BRPC_VALIDATE_GFLAG(stream_state_max_memory_bytes, brpc::NonNegativeInteger);
+DEFINE_int64(stream_iterator_memory_bytes, 1024 * 1024, "estimate memory of one live iterator of stream state");
+BRPC_VALIDATE_GFLAG(stream_iterator_memory_bytes, brpc::NonNegativeInteger);
 
 // generate stream id, use uuid
 static std::string GenStreamId() { return butil::GenerateGUID(); }
 
 Stream::Stream(std::string stream_id, uint32_t limit) : stream_id_(stream_id), limit_(limit) {
   last_time_ms_ = Helper::TimestampMs();
+  bthread_mutex_init(&mutex_, nullptr);
 }
 
+Stream::~Stream() { bthread_mutex_destroy(&mutex_); }
+
 StreamPtr Stream::New(uint32_t limit) { return std::make_shared<Stream>(GenStreamId(), limit); }
 
 bool Stream::Check(size_t size, size_t bytes) const {
@@ -44,6 +56,65 @@ bool Stream::Check(size_t size, size_t bytes) const {
 
 void Stream::RenewLastTime() { last_time_ms_ = Helper::TimestampMs(); }
 
+StreamStatePtr Stream::GetOrNewStreamState(StreamStateAllocator allocator) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  if (stream_state_ == nullptr) {
+    stream_state_ = allocator();
+  }
+  return stream_state_;
+}
+
+void Stream::SetStreamState(StreamStatePtr stream_state) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  stream_state_ = stream_state;
+}
+
+StreamStatePtr Stream::StreamState() {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  return stream_state_;
+}
+
+void Stream::SetResumeKey(std::string resume_key) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  resume_key_ = std::move(resume_key);
+}
+
+std::string Stream::ResumeKey() {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  return resume_key_;
+}
+
+int64_t Stream::EvictStreamState() {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  if (stream_state_ == nullptr || resume_key_.empty()) {
+    return 0;
+  }
+
+  // in-flight request still hold the state until it is done, and it update resume key at end.
+  int64_t memory_size = stream_state_->MemorySize();
+  is_evicted_ = true;
+  stream_state_.reset();
+  return memory_size;
+}
+
+bool Stream::IsEvicted() {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  return is_evicted_;
+}
+
+int64_t Stream::MemorySize() {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  return stream_state_ != nullptr ? stream_state_->MemorySize() : 0;
+}
+
 StreamSet::StreamSet() { bthread_mutex_init(&mutex_, nullptr); }
 StreamSet::~StreamSet() { bthread_mutex_destroy(&mutex_); }
 
@@ -114,6 +185,8 @@ StreamPtr StreamManager::GetOrNew(const pb::stream::StreamRequestMeta& stream_me
   stream = Stream::New(stream_meta.limit());
   AddStream(stream);
 
+  EvictStreamState(stream);
+
   return stream;
 }
 
@@ -128,6 +201,47 @@ void StreamManager::RecycleExpireStream() {
       RemoveStream(stream);
     }
   }
+
+  EvictStreamState(nullptr);
+}
+
+void StreamManager::EvictStreamState(StreamPtr exclude_stream) {
+  int64_t total_memory_size = 0;
+  for (auto& stream : stream_set_->GetAllStreams()) {
+    total_memory_size += stream->MemorySize();
+  }
+  memory_tracker_->SetConsumption(total_memory_size);
+
+  if (FLAGS_stream_state_max_memory_bytes > 0 && total_memory_size > FLAGS_stream_state_max_memory_bytes) {
+    EvictStreamState(exclude_stream, total_memory_size - FLAGS_stream_state_max_memory_bytes);
+  }
+}
+
+int64_t StreamManager::EvictStreamState(StreamPtr exclude_stream, int64_t bytes) {
+  auto streams = stream_set_->GetAllStreams();
+  std::sort(streams.begin(), streams.end(),
+            [](const StreamPtr& lhs, const StreamPtr& rhs) { return lhs->LastTimeMs() < rhs->LastTimeMs(); });
+
+  int64_t freed_bytes = 0;
+  for (auto& stream : streams) {
+    if (freed_bytes >= bytes) {
+      break;
+    }
+    if (stream == exclude_stream) {
+      continue;
+    }
+
+    int64_t memory_size = stream->EvictStreamState();
+    if (memory_size > 0) {
+      freed_bytes += memory_size;
+      evict_stream_state_count_ << 1;
+      DINGO_LOG(INFO) << fmt::format("evict stream({}) state, memory_size({}) freed_bytes({})", stream->StreamId(),
+                                     memory_size, freed_bytes);
+    }
+  }
+
+  memory_tracker_->Release(freed_bytes);
+  return freed_bytes;
 }
 
 }  // namespace dingodb
\ No newline at end of file
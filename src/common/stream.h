@@ -19,11 +19,15 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "bthread/mutex.h"
 #include "bthread/types.h"
+#include "bvar/reducer.h"
 #include "common/failpoint.h"
+#include "common/memory_tracker.h"
 #include "proto/stream.pb.h"
 
 namespace dingodb {
@@ -41,13 +45,16 @@ class StreamState {
  public:
   StreamState() = default;
   virtual ~StreamState() = default;
+
+  // memory held by state, e.g. blocks pinned by live iterator.
+  virtual int64_t MemorySize() const { return 0; }
 };
 using StreamStatePtr = std::shared_ptr<StreamState>;
 
 class Stream {
  public:
   Stream(std::string stream_id, uint32_t limit);
-  ~Stream() = default;
+  ~Stream();
 
   static StreamPtr New(uint32_t limit);
 
@@ -56,17 +63,20 @@ class Stream {
 
   using StreamStateAllocator = std::function<StreamStatePtr()>;
 
-  StreamStatePtr GetOrNewStreamState(StreamStateAllocator allocator) {
-    if (stream_state_ != nullptr) {
-      return stream_state_;
-    }
+  StreamStatePtr GetOrNewStreamState(StreamStateAllocator allocator);
 
-    stream_state_ = allocator();
-    return stream_state_;
-  }
+  void SetStreamState(StreamStatePtr stream_state);
+  StreamStatePtr StreamState();
 
-  void SetStreamState(StreamStatePtr stream_state) { stream_state_ = stream_state; }
-  StreamStatePtr StreamState() const { return stream_state_; }
+  // position of live iterator after one continuation, state with resume key can be evicted when memory is over
+  // limit, then next continuation seek from it instead of keep iterator. empty resume key is not evictable.
+  void SetResumeKey(std::string resume_key);
+  std::string ResumeKey();
+  // release state, return released memory size.
+  int64_t EvictStreamState();
+  bool IsEvicted();
+
+  int64_t MemorySize();
 
   int64_t LastTimeMs() const { return last_time_ms_; }
   void RenewLastTime();
@@ -77,7 +87,11 @@ class Stream {
   std::string stream_id_;
   uint32_t limit_;
 
+  // protect stream_state_ and resume_key_, state may be evicted by other stream.
+  bthread_mutex_t mutex_;
   StreamStatePtr stream_state_;
+  bool is_evicted_{false};
+  std::string resume_key_;
 
   // last request time, for check stream timeout, clean stream.
   int64_t last_time_ms_;
@@ -107,9 +121,13 @@ class StreamManager {
   StreamManager()
       : stream_set_(StreamSet::New()),
         total_stream_count_("dingo_stream_total_count"),
-        release_stream_count_("dingo_stream_release_count") {}
+        release_stream_count_("dingo_stream_release_count"),
+        evict_stream_state_count_("dingo_stream_evict_state_count"),
+        memory_tracker_(MemoryTracker::Subsystem(MemoryTracker::kStream)) {
+    memory_tracker_->SetEvictor([this](int64_t bytes) -> int64_t { return EvictStreamState(nullptr, bytes); });
+  }
 
-  ~StreamManager() = default;
+  ~StreamManager() { memory_tracker_->SetEvictor(nullptr); }
 
   static StreamManagerPtr New() { return std::make_shared<StreamManager>(); }
 
@@ -123,12 +141,21 @@ class StreamManager {
 
   void RecycleExpireStream();
 
+  // evict least recently used stream state when total memory is over limit, exclude stream.
+  void EvictStreamState(StreamPtr exclude_stream);
+
  private:
+  // evict least recently used stream state until freed bytes, return freed bytes.
+  int64_t EvictStreamState(StreamPtr exclude_stream, int64_t bytes);
+
   StreamSetPtr stream_set_;
 
   // statistic
   bvar::Adder<uint64_t> total_stream_count_;
   bvar::Adder<int64_t> release_stream_count_;
+  bvar::Adder<int64_t> evict_stream_state_count_;
+
+  MemoryTrackerPtr memory_tracker_;
 };
 
 }  // namespace dingodb
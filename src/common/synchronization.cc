@@ -15,6 +15,7 @@
 #include "common/synchronization.h"
 
 #include "bvar/latency_recorder.h"
+#include "common/cycle_clock.h"
 #include "common/logging.h"
 
 namespace dingodb {
@@ -183,12 +184,12 @@ void ScopeGuard::Release() { is_release_ = true; }
 
 // BvarLatencyGuard
 BvarLatencyGuard::BvarLatencyGuard(bvar::LatencyRecorder* latency_recoder) : latency_recorder_(latency_recoder) {
-  start_time_us_ = butil::gettimeofday_us();
+  start_cycles_ = CycleClock::Now();
 }
 
 BvarLatencyGuard::~BvarLatencyGuard() {
   if (!is_release_) {
-    (*latency_recorder_) << butil::gettimeofday_us() - start_time_us_;
+    (*latency_recorder_) << CycleClock::CyclesToUs(CycleClock::Now() - start_cycles_);
   }
 }
 
@@ -255,7 +255,7 @@ class BvarLatencyGuard {
 
  private:
   bvar::LatencyRecorder* latency_recorder_;
-  int64_t start_time_us_;
+  uint64_t start_cycles_;
   bool is_release_ = false;
 };
 
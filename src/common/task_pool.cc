@@ -0,0 +1,110 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/task_pool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace dingodb {
+
+// block size of class i is kMinBlockSize << i, larger block is not cached.
+static constexpr size_t kMinBlockSize = 64;
+static constexpr int kBlockClassNum = 4;
+// max cached bytes of every class per thread.
+static constexpr size_t kMaxCachedBytesPerClass = 64 * 1024;
+
+namespace {
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+struct ThreadCache {
+  FreeBlock* free_lists[kBlockClassNum]{nullptr};
+  size_t free_counts[kBlockClassNum]{0};
+
+  uint64_t hit_count{0};
+  uint64_t miss_count{0};
+
+  ~ThreadCache() {
+    for (auto& free_list : free_lists) {
+      while (free_list != nullptr) {
+        FreeBlock* block = free_list;
+        free_list = block->next;
+        ::operator delete(block);
+      }
+    }
+  }
+};
+
+}  // namespace
+
+static thread_local ThreadCache tls_cache;
+
+static int BlockClass(size_t size) {
+  size_t block_size = kMinBlockSize;
+  for (int i = 0; i < kBlockClassNum; ++i) {
+    if (size <= block_size) {
+      return i;
+    }
+    block_size <<= 1;
+  }
+  return -1;
+}
+
+void* TaskPool::Allocate(size_t size) {
+  int block_class = BlockClass(size);
+  if (block_class < 0) {
+    ++tls_cache.miss_count;
+    return ::operator new(size);
+  }
+
+  FreeBlock* block = tls_cache.free_lists[block_class];
+  if (block != nullptr) {
+    tls_cache.free_lists[block_class] = block->next;
+    --tls_cache.free_counts[block_class];
+    ++tls_cache.hit_count;
+    return block;
+  }
+
+  ++tls_cache.miss_count;
+  return ::operator new(kMinBlockSize << block_class);
+}
+
+void TaskPool::Deallocate(void* ptr, size_t size) {
+  if (ptr == nullptr) {
+    return;
+  }
+
+  int block_class = BlockClass(size);
+  if (block_class < 0 ||
+      (tls_cache.free_counts[block_class] + 1) * (kMinBlockSize << block_class) > kMaxCachedBytesPerClass) {
+    ::operator delete(ptr);
+    return;
+  }
+
+  FreeBlock* block = static_cast<FreeBlock*>(ptr);
+  block->next = tls_cache.free_lists[block_class];
+  tls_cache.free_lists[block_class] = block;
+  ++tls_cache.free_counts[block_class];
+}
+
+uint64_t TaskPool::HitCount() { return tls_cache.hit_count; }
+
+uint64_t TaskPool::MissCount() { return tls_cache.miss_count; }
+
+}  // namespace dingodb
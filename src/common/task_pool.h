@@ -0,0 +1,150 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COMMON_TASK_POOL_H_
+#define DINGODB_COMMON_TASK_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace dingodb {
+
+// Thread local cache of small memory block for task object.
+// Task is created and destroyed on every raft apply and service request, so block is reused instead of malloc.
+// Block freed on worker thread is cached by worker thread, the cache size of every thread is bounded.
+class TaskPool {
+ public:
+  static void* Allocate(size_t size);
+  static void Deallocate(void* ptr, size_t size);
+
+  // block count of current thread, for test and benchmark.
+  static uint64_t HitCount();
+  static uint64_t MissCount();
+};
+
+// Allocator of std::allocate_shared, object and control block take one pooled block.
+template <typename T>
+class TaskPoolAllocator {
+ public:
+  using value_type = T;
+
+  TaskPoolAllocator() noexcept = default;
+  template <typename U>
+  TaskPoolAllocator(const TaskPoolAllocator<U>&) noexcept {}  // NOLINT
+
+  T* allocate(size_t n) {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "over aligned type is not supported");
+    return static_cast<T*>(TaskPool::Allocate(n * sizeof(T)));
+  }
+  void deallocate(T* ptr, size_t n) noexcept { TaskPool::Deallocate(ptr, n * sizeof(T)); }
+
+  template <typename U>
+  bool operator==(const TaskPoolAllocator<U>&) const noexcept {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const TaskPoolAllocator<U>&) const noexcept {
+    return false;
+  }
+};
+
+// Move only void() callable, callable not larger than kInlineSize is stored inline instead of heap like std::function.
+template <size_t kInlineSize>
+class InlineFunction {
+ public:
+  InlineFunction() = default;
+
+  template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InlineFunction>>>
+  InlineFunction(F&& func) {  // NOLINT
+    using Fn = std::decay_t<F>;
+    if constexpr (IsInline<Fn>()) {
+      new (buffer_) Fn(std::forward<F>(func));
+      invoke_ = [](void* buffer) { (*static_cast<Fn*>(buffer))(); };
+      manage_ = [](void* dst, void* src) {
+        if (dst != nullptr) {
+          new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+        }
+        static_cast<Fn*>(src)->~Fn();
+      };
+    } else {
+      *reinterpret_cast<Fn**>(buffer_) = new Fn(std::forward<F>(func));
+      invoke_ = [](void* buffer) { (**static_cast<Fn**>(buffer))(); };
+      manage_ = [](void* dst, void* src) {
+        if (dst != nullptr) {
+          *static_cast<Fn**>(dst) = *static_cast<Fn**>(src);
+        } else {
+          delete *static_cast<Fn**>(src);
+        }
+      };
+    }
+  }
+
+  InlineFunction(InlineFunction&& other) noexcept { MoveFrom(other); }
+  InlineFunction& operator=(InlineFunction&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  InlineFunction(const InlineFunction&) = delete;
+  InlineFunction& operator=(const InlineFunction&) = delete;
+
+  ~InlineFunction() { Reset(); }
+
+  void operator()() { invoke_(buffer_); }
+  explicit operator bool() const { return invoke_ != nullptr; }
+
+ private:
+  template <typename Fn>
+  static constexpr bool IsInline() {
+    return sizeof(Fn) <= kInlineSize && alignof(Fn) <= alignof(std::max_align_t) &&
+           std::is_nothrow_move_constructible_v<Fn>;
+  }
+
+  void MoveFrom(InlineFunction& other) {
+    if (other.invoke_ != nullptr) {
+      other.manage_(buffer_, other.buffer_);
+      invoke_ = other.invoke_;
+      manage_ = other.manage_;
+      other.invoke_ = nullptr;
+      other.manage_ = nullptr;
+    }
+  }
+
+  void Reset() {
+    if (invoke_ != nullptr) {
+      manage_(nullptr, buffer_);
+      invoke_ = nullptr;
+      manage_ = nullptr;
+    }
+  }
+
+  // move callable from src to dst and destroy src, only destroy src when dst is nullptr.
+  using Manager = void (*)(void* dst, void* src);
+  using Invoker = void (*)(void* buffer);
+
+  alignas(std::max_align_t) unsigned char buffer_[kInlineSize];
+  Invoker invoke_{nullptr};
+  Manager manage_{nullptr};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_TASK_POOL_H_
@@ -0,0 +1,135 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/tenant_quota.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+#include "brpc/reloadable_flags.h"
+#include "bthread/mutex.h"
+#include "butil/time.h"
+#include "common/gflag_validator.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_tenant_quota, false, "enable per tenant read/write quota of store");
+DEFINE_validator(enable_tenant_quota, &PassBool);
+DEFINE_int64(tenant_quota_read_qps, 0, "max read request per second of one tenant, 0 is unlimited");
+BRPC_VALIDATE_GFLAG(tenant_quota_read_qps, brpc::NonNegativeInteger);
+DEFINE_int64(tenant_quota_write_qps, 0, "max write request per second of one tenant, 0 is unlimited");
+BRPC_VALIDATE_GFLAG(tenant_quota_write_qps, brpc::NonNegativeInteger);
+DEFINE_int64(tenant_quota_read_bytes_per_second, 0, "max read bytes per second of one tenant, 0 is unlimited");
+BRPC_VALIDATE_GFLAG(tenant_quota_read_bytes_per_second, brpc::NonNegativeInteger);
+DEFINE_int64(tenant_quota_write_bytes_per_second, 0, "max write bytes per second of one tenant, 0 is unlimited");
+BRPC_VALIDATE_GFLAG(tenant_quota_write_bytes_per_second, brpc::NonNegativeInteger);
+
+void TenantQuota::TokenBucket::Refill(int64_t rate, int64_t now_us) {
+  if (rate <= 0 || last_refill_time_us == 0) {
+    tokens = rate;
+    last_refill_time_us = now_us;
+    return;
+  }
+
+  int64_t elapsed_us = std::max(now_us - last_refill_time_us, static_cast<int64_t>(0));
+  auto refill_tokens = static_cast<int64_t>(static_cast<double>(rate) * elapsed_us / 1000000);
+  // keep refill time when less than one token, otherwise frequent request never refill low rate bucket.
+  if (refill_tokens > 0) {
+    tokens = std::min(rate, tokens + refill_tokens);
+    last_refill_time_us = now_us;
+  }
+}
+
+TenantQuota::Tenant::Tenant(int64_t tenant_id)
+    : read_count(fmt::format("dingo_tenant_{}_read_count", tenant_id)),
+      read_bytes(fmt::format("dingo_tenant_{}_read_bytes", tenant_id)),
+      write_count(fmt::format("dingo_tenant_{}_write_count", tenant_id)),
+      write_bytes(fmt::format("dingo_tenant_{}_write_bytes", tenant_id)),
+      reject_count(fmt::format("dingo_tenant_{}_quota_reject_count", tenant_id)) {}
+
+TenantQuota::TenantQuota() { bthread_mutex_init(&mutex_, nullptr); }
+
+TenantQuota::~TenantQuota() { bthread_mutex_destroy(&mutex_); }
+
+TenantQuota& TenantQuota::GetInstance() {
+  static TenantQuota instance;
+  return instance;
+}
+
+bool TenantQuota::IsEnabled() { return FLAGS_enable_tenant_quota; }
+
+TenantQuota::Tenant& TenantQuota::GetTenant(int64_t tenant_id) {
+  auto it = tenants_.find(tenant_id);
+  if (it == tenants_.end()) {
+    it = tenants_.emplace(tenant_id, std::make_unique<Tenant>(tenant_id)).first;
+  }
+
+  return *it->second;
+}
+
+butil::Status TenantQuota::Acquire(int64_t tenant_id, bool is_write) {
+  int64_t now_us = butil::gettimeofday_us();
+  int64_t count_rate = is_write ? FLAGS_tenant_quota_write_qps : FLAGS_tenant_quota_read_qps;
+  int64_t bytes_rate = is_write ? FLAGS_tenant_quota_write_bytes_per_second : FLAGS_tenant_quota_read_bytes_per_second;
+
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto& tenant = GetTenant(tenant_id);
+  auto& count_bucket = is_write ? tenant.write_count_bucket : tenant.read_count_bucket;
+  auto& bytes_bucket = is_write ? tenant.write_bytes_bucket : tenant.read_bytes_bucket;
+  count_bucket.Refill(count_rate, now_us);
+  bytes_bucket.Refill(bytes_rate, now_us);
+
+  if (count_bucket.IsExhausted(count_rate) || bytes_bucket.IsExhausted(bytes_rate)) {
+    tenant.reject_count << 1;
+    return butil::Status(pb::error::EREQUEST_FULL,
+                         fmt::format("tenant({}) exceed {} quota, please wait and retry", tenant_id,
+                                     is_write ? "write" : "read"));
+  }
+
+  if (count_rate > 0) {
+    --count_bucket.tokens;
+  }
+  if (is_write) {
+    tenant.write_count << 1;
+  } else {
+    tenant.read_count << 1;
+  }
+
+  return butil::Status();
+}
+
+void TenantQuota::Charge(int64_t tenant_id, bool is_write, int64_t bytes) {
+  int64_t bytes_rate = is_write ? FLAGS_tenant_quota_write_bytes_per_second : FLAGS_tenant_quota_read_bytes_per_second;
+
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto& tenant = GetTenant(tenant_id);
+  auto& bytes_bucket = is_write ? tenant.write_bytes_bucket : tenant.read_bytes_bucket;
+  if (bytes_rate > 0) {
+    bytes_bucket.tokens -= bytes;
+  }
+  if (is_write) {
+    tenant.write_bytes << bytes;
+  } else {
+    tenant.read_bytes << bytes;
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,85 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COMMON_TENANT_QUOTA_H_
+#define DINGODB_COMMON_TENANT_QUOTA_H_
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+#include "bthread/types.h"
+#include "butil/status.h"
+#include "bvar/reducer.h"
+
+namespace dingodb {
+
+// Per tenant quota of store, token bucket of read/write request count and bytes per second.
+// Request count is taken at request entry, bytes is known only when request finish, so it is charged then and
+// bucket may go negative. Tenant which exhaust any bucket is rejected at entry until bucket is refilled, so one
+// heavy tenant can not saturate store shared by many tenants.
+class TenantQuota {
+ public:
+  TenantQuota();
+  ~TenantQuota();
+
+  TenantQuota(const TenantQuota&) = delete;
+  TenantQuota& operator=(const TenantQuota&) = delete;
+
+  static TenantQuota& GetInstance();
+
+  static bool IsEnabled();
+
+  // call before request is queued, return EREQUEST_FULL when tenant exceed quota, client should backoff and retry.
+  butil::Status Acquire(int64_t tenant_id, bool is_write);
+
+  // charge bytes of finished request.
+  void Charge(int64_t tenant_id, bool is_write, int64_t bytes);
+
+ private:
+  struct TokenBucket {
+    int64_t tokens{0};
+    int64_t last_refill_time_us{0};
+
+    // burst is one second of rate, rate 0 means unlimited.
+    void Refill(int64_t rate, int64_t now_us);
+    bool IsExhausted(int64_t rate) const { return rate > 0 && tokens <= 0; }
+  };
+
+  struct Tenant {
+    explicit Tenant(int64_t tenant_id);
+
+    TokenBucket read_count_bucket;
+    TokenBucket read_bytes_bucket;
+    TokenBucket write_count_bucket;
+    TokenBucket write_bytes_bucket;
+
+    bvar::Adder<int64_t> read_count;
+    bvar::Adder<int64_t> read_bytes;
+    bvar::Adder<int64_t> write_count;
+    bvar::Adder<int64_t> write_bytes;
+    bvar::Adder<int64_t> reject_count;
+  };
+
+  // caller hold mutex_
+  Tenant& GetTenant(int64_t tenant_id);
+
+  bthread_mutex_t mutex_;
+  std::unordered_map<int64_t, std::unique_ptr<Tenant>> tenants_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_TENANT_QUOTA_H_
@@ -14,6 +14,7 @@
 
 #include "common/threadpool.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
@@ -24,13 +25,27 @@
 #include <utility>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
+#include "common/gflag_validator.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/numa.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "glog/logging.h"
 
 namespace dingodb {
 
+DEFINE_bool(threadpool_numa_local_submit, false,
+            "submit task to worker bound on the same numa node as submitter, take effect after bind core");
+DEFINE_validator(threadpool_numa_local_submit, &PassBool);
+
+// worker of which pool the current thread is, for push task to own queue
+static thread_local const ThreadPool *tls_thread_pool = nullptr;
+static thread_local uint32_t tls_thread_no = 0;
+// round robin seed of submitter, thread local to avoid sharing cache line
+static thread_local uint32_t tls_submit_seed = 0;
+
 ThreadPool::ThreadPool(const std::string &thread_name, uint32_t pool_size)
     : ThreadPool(thread_name, pool_size, nullptr) {}
 
@@ -38,12 +53,21 @@ ThreadPool::ThreadPool(const std::string &thread_name, uint32_t pool_size, std::
     : thread_name_(thread_name),
       init_thread_func_(init_thread),
       total_task_count_metrics_(fmt::format("dingo_threadpool_{}_total_task_count", thread_name)),
-      pending_task_count_metrics_(fmt::format("dingo_threadpool_{}_pending_task_count", thread_name)) {
+      pending_task_count_metrics_(fmt::format("dingo_threadpool_{}_pending_task_count", thread_name)),
+      queues_(new WorkerQueue[kMaxPoolSize]) {
+  if (pool_size > kMaxPoolSize) {
+    DINGO_LOG(WARNING) << fmt::format("threadpool({}) pool_size({}) exceed max({})", thread_name, pool_size,
+                                      kMaxPoolSize);
+    pool_size = kMaxPoolSize;
+  }
+
   {
     std::unique_lock<std::mutex> lock(mutex_);
     for (int i = 0; i < pool_size; ++i) {
       workers_.push_back(BootstrapThread(i));
     }
+    worker_num_.store(pool_size);
+    queue_num_.store(pool_size);
   }
 }
 
@@ -52,6 +76,7 @@ ThreadPool::~ThreadPool() { Destroy(); }
 void ThreadPool::AdjustPoolSize(uint32_t pool_size) {
   std::unique_lock<std::mutex> lock(mutex_);
 
+  pool_size = std::min(pool_size, kMaxPoolSize);
   uint32_t curr_pool_size = workers_.size();
   if (pool_size < curr_pool_size) {
     ShrinkThreadPool(pool_size);
@@ -79,6 +104,7 @@ bool ThreadPool::BindCore(std::vector<uint32_t> threads, std::vector<uint32_t> c
       DINGO_LOG(ERROR) << fmt::format("bind cpu core failed, error: {}", ret);
       return false;
     }
+    queues_[offset].numa_node.store(NumaTopology::NodeOfCpu(cores[i]), std::memory_order_relaxed);
   }
 
   return true;
@@ -93,12 +119,13 @@ bool ThreadPool::UnbindCore() {
     CPU_SET(i, &cpuset);
   }
 
-  for (auto &thread_entry : workers_) {
-    int ret = pthread_setaffinity_np(thread_entry->thread.native_handle(), sizeof(cpu_set_t), &cpuset);
+  for (int i = 0; i < workers_.size(); ++i) {
+    int ret = pthread_setaffinity_np(workers_[i]->thread.native_handle(), sizeof(cpu_set_t), &cpuset);
     if (ret != 0) {
       DINGO_LOG(ERROR) << fmt::format("unbind cpu core failed, error: {}", ret);
       return false;
     }
+    queues_[i].numa_node.store(-1, std::memory_order_relaxed);
   }
 
   return true;
@@ -133,28 +160,27 @@ ThreadPool::ThreadEntryPtr ThreadPool::BootstrapThread(int thread_no) {
   std::thread th([this, thread_no, thread_entry] {
     thread_entry->name = fmt::format("{}:{}", thread_name_, thread_no);
     pthread_setname_np(pthread_self(), thread_entry->name.c_str());
+    tls_thread_pool = this;
+    tls_thread_no = thread_no;
 
     if (init_thread_func_ != nullptr) {
       init_thread_func_();
     }
 
     for (;;) {
-      TaskPtr task;
-
-      {
-        std::unique_lock<std::mutex> lock(this->task_mutex_);
-
-        this->task_condition_.wait(lock,
-                                   [this, thread_entry] { return thread_entry->is_stop || !this->tasks_.empty(); });
-
-        if (thread_entry->is_stop && this->tasks_.empty()) {
+      TaskPtr task = PopTask(thread_no);
+      if (task == nullptr) {
+        if (thread_entry->is_stop.load()) {
           return;
-        } else if (this->tasks_.empty()) {
-          continue;
         }
 
-        task = this->tasks_.top();
-        this->tasks_.pop();
+        std::unique_lock<std::mutex> lock(this->sleep_mutex_);
+        this->idle_worker_num_.fetch_add(1);
+        this->sleep_condition_.wait(lock, [this, thread_entry] {
+          return thread_entry->is_stop.load() || this->queued_task_count_.load() > 0;
+        });
+        this->idle_worker_num_.fetch_sub(1);
+        continue;
       }
 
       try {
@@ -191,12 +217,14 @@ void ThreadPool::ShrinkThreadPool(uint32_t pool_size) {
   }
 
   workers_.resize(pool_size);
+  // stop submit to shrunk worker, the left task in their queue is stolen by other worker
+  worker_num_.store(pool_size);
 
   for (auto &worker : shrink_workers) {
     worker->is_stop = true;
   }
 
-  task_condition_.notify_all();
+  WakeUpAllWorker();
 
   for (auto &worker : shrink_workers) {
     if (worker->thread.joinable()) {
@@ -212,6 +240,8 @@ void ThreadPool::ExpandTheadPool(uint32_t pool_size) {
   for (int i = workers_.size(); i < pool_size; ++i) {
     workers_.push_back(BootstrapThread(i));
   }
+  queue_num_.store(std::max(queue_num_.load(), pool_size));
+  worker_num_.store(pool_size);
 }
 
 ThreadPool::TaskPtr ThreadPool::ExecuteTask(Funcer func, void *arg, int priority) {
@@ -225,18 +255,136 @@ ThreadPool::TaskPtr ThreadPool::ExecuteTask(Funcer func, void *arg, int priority
   task->arg = arg;
   task->cond = std::make_shared<BthreadCond>();
 
-  {
-    std::unique_lock<std::mutex> lock(task_mutex_);
+  PushTask(task);
+
+  return task;
+}
+
+void ThreadPool::ParallelFor(size_t start, size_t end, size_t batch_size, int priority,
+                             const std::function<void(size_t, size_t)> &fn) {
+  if (start >= end) {
+    return;
+  }
+  batch_size = std::max(batch_size, static_cast<size_t>(1));
+
+  // shared with helper task, a helper may run after all batches are done and caller has returned
+  struct Context {
+    std::atomic<size_t> next_pos;
+    size_t end_pos;
+    size_t batch_size;
+    std::atomic<size_t> remain_batch_num;
+    const std::function<void(size_t, size_t)> *fn;
+    BthreadCond cond{1};
+    std::string thread_name;
+  };
+
+  size_t batch_num = (end - start + batch_size - 1) / batch_size;
+  auto ctx = std::make_shared<Context>();
+  ctx->next_pos.store(start);
+  ctx->end_pos = end;
+  ctx->batch_size = batch_size;
+  ctx->remain_batch_num.store(batch_num);
+  ctx->fn = &fn;
+  ctx->thread_name = thread_name_;
+
+  // fn is only accessed after claim a batch, which must be before caller return.
+  auto run_batches = [ctx](void *) {
+    for (;;) {
+      size_t begin = ctx->next_pos.fetch_add(ctx->batch_size);
+      if (begin >= ctx->end_pos) {
+        return;
+      }
+
+      try {
+        (*ctx->fn)(begin, std::min(begin + ctx->batch_size, ctx->end_pos));
+      } catch (const std::exception &e) {
+        LOG(ERROR) << fmt::format("{} parallel for exception: {}", ctx->thread_name, e.what());
+      }
+
+      if (ctx->remain_batch_num.fetch_sub(1) == 1) {
+        ctx->cond.DecreaseSignal();
+      }
+    }
+  };
+
+  size_t helper_num = std::min(batch_num, static_cast<size_t>(worker_num_.load(std::memory_order_relaxed)));
+  if (helper_num == 0 || is_destroied_.load(std::memory_order_relaxed)) {
+    // in-place run
+    run_batches(nullptr);
+    return;
+  }
 
-    tasks_.push(task);
+  for (size_t i = 0; i < helper_num; ++i) {
+    auto task = std::make_shared<Task>();
+    task->priority = priority;
+    task->func = run_batches;
+    PushTask(task);
+  }
+
+  ctx->cond.Wait();
+}
+
+uint32_t ThreadPool::SelectQueue() {
+  uint32_t worker_num = worker_num_.load(std::memory_order_relaxed);
+  if (tls_thread_pool == this && tls_thread_no < worker_num) {
+    return tls_thread_no;
+  }
+
+  uint32_t seed = tls_submit_seed++;
+  if (FLAGS_threadpool_numa_local_submit) {
+    int32_t numa_node = NumaTopology::CurrentNode();
+    for (uint32_t i = 0; i < worker_num; ++i) {
+      uint32_t pos = (seed + i) % worker_num;
+      if (queues_[pos].numa_node.load(std::memory_order_relaxed) == numa_node) {
+        return pos;
+      }
+    }
+  }
+
+  return seed % worker_num;
+}
+
+void ThreadPool::PushTask(TaskPtr task) {
+  auto &queue = queues_[SelectQueue()];
+  {
+    std::unique_lock<std::mutex> lock(queue.mutex);
+    queue.tasks.push(task);
   }
 
   IncTotalTaskCount();
   IncPendingTaskCount();
 
-  task_condition_.notify_one();
+  queued_task_count_.fetch_add(1);
+  WakeUpWorker();
+}
 
-  return task;
+ThreadPool::TaskPtr ThreadPool::PopTask(uint32_t thread_no) {
+  uint32_t queue_num = queue_num_.load(std::memory_order_relaxed);
+  for (uint32_t i = 0; i < queue_num; ++i) {
+    auto &queue = queues_[(thread_no + i) % queue_num];
+    std::unique_lock<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      TaskPtr task = queue.tasks.top();
+      queue.tasks.pop();
+      queued_task_count_.fetch_sub(1);
+      return task;
+    }
+  }
+
+  return nullptr;
+}
+
+void ThreadPool::WakeUpWorker() {
+  // worker increase idle num before check queued task count, so no lost wakeup.
+  if (idle_worker_num_.load() > 0) {
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    sleep_condition_.notify_one();
+  }
+}
+
+void ThreadPool::WakeUpAllWorker() {
+  std::unique_lock<std::mutex> lock(sleep_mutex_);
+  sleep_condition_.notify_all();
 }
 
 uint64_t ThreadPool::TotalTaskCount() { return total_task_count_metrics_.get_value(); }
@@ -266,7 +414,7 @@ void ThreadPool::Destroy() {
       worker->is_stop = true;
     }
 
-    task_condition_.notify_all();
+    WakeUpAllWorker();
     for (auto &worker : workers_) {
       if (worker->thread.joinable()) {
         worker->thread.join();
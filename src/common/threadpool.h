@@ -15,7 +15,9 @@
 #ifndef DINGODB_COMMON_THREADPOOL_H_
 #define DINGODB_COMMON_THREADPOOL_H_
 
+#include <atomic>
 #include <condition_variable>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -29,6 +31,9 @@
 
 namespace dingodb {
 
+// Work-stealing thread pool, every worker own a priority queue, task submitted by worker is pushed to its own queue,
+// otherwise pushed to a worker queue by round robin(or worker on the same numa node if enable numa local submit).
+// Idle worker steal task from other queues, so priority is only kept within one queue.
 class ThreadPool {
  public:
   ThreadPool(const std::string &thread_name, uint32_t pool_size);
@@ -38,7 +43,7 @@ class ThreadPool {
   struct ThreadEntry {
     std::string name;
     std::thread thread;
-    bool is_stop;
+    std::atomic<bool> is_stop{false};
   };
   using ThreadEntryPtr = std::shared_ptr<ThreadEntry>;
 
@@ -62,8 +67,13 @@ class ThreadPool {
 
   TaskPtr ExecuteTask(Funcer func, void *arg, int priority = 0);
 
+  // run fn(begin, end) for every batch of [start, end) and wait all done.
+  // At most pool size tasks is submitted and they claim batch by atomic index, no task or cond is allocated per batch.
+  void ParallelFor(size_t start, size_t end, size_t batch_size, int priority,
+                   const std::function<void(size_t, size_t)> &fn);
+
   void AdjustPoolSize(uint32_t pool_size);
-  // bind core, thread[0] bind core[0]
+  // bind core, thread[0] bind core[0], also record numa node of worker for numa local submit
   bool BindCore(std::vector<uint32_t> threads, std::vector<uint32_t> cores);
   bool UnbindCore();
 
@@ -79,6 +89,16 @@ class ThreadPool {
   void Destroy();
 
  private:
+  // max worker num, the queues is allocated once, so submitter never lock for worker queues
+  static constexpr uint32_t kMaxPoolSize = 256;
+
+  struct alignas(64) WorkerQueue {
+    std::mutex mutex;
+    std::priority_queue<TaskPtr, std::vector<TaskPtr>, Task> tasks;
+    // numa node of bound core, -1 is not bound
+    std::atomic<int32_t> numa_node{-1};
+  };
+
   // create a new thread
   ThreadEntryPtr BootstrapThread(int thread_no);
 
@@ -87,6 +107,13 @@ class ThreadPool {
 
   bool IsDestroied();
 
+  void PushTask(TaskPtr task);
+  // pop from own queue first, then steal from other queues
+  TaskPtr PopTask(uint32_t thread_no);
+  uint32_t SelectQueue();
+  void WakeUpWorker();
+  void WakeUpAllWorker();
+
   // thread name prefix, format: xxx:{thread_no}
   std::string thread_name_;
   // init thread after create thread
@@ -98,10 +125,16 @@ class ThreadPool {
   std::mutex mutex_;
   std::vector<ThreadEntryPtr> workers_;
 
-  // protect tasks
-  std::mutex task_mutex_;
-  std::condition_variable task_condition_;
-  std::priority_queue<TaskPtr, std::vector<TaskPtr>, Task> tasks_;
+  // running worker num, and num of queues ever used which may still have task of shrunk worker
+  std::atomic<uint32_t> worker_num_{0};
+  std::atomic<uint32_t> queue_num_{0};
+  std::unique_ptr<WorkerQueue[]> queues_;
+  std::atomic<int64_t> queued_task_count_{0};
+
+  // idle worker sleep on it, submitter only notify when there is idle worker
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_condition_;
+  std::atomic<uint32_t> idle_worker_num_{0};
 
   // metrics
   bvar::Adder<uint64_t> total_task_count_metrics_;
@@ -0,0 +1,292 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/trace.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "brpc/reloadable_flags.h"
+#include "butil/compiler_specific.h"
+#include "butil/endpoint.h"
+#include "butil/fast_rand.h"
+#include "bvar/reducer.h"
+#include "common/cycle_clock.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/unknown_field_set.h"
+#include "google/protobuf/wire_format_lite.h"
+
+namespace dingodb {
+
+static bool ValidateTraceSampleRate(const char*, double value) { return value >= 0 && value <= 1; }
+
+DEFINE_double(trace_sample_rate, 0, "sample rate of write request trace, 0 is disable");
+DEFINE_validator(trace_sample_rate, &ValidateTraceSampleRate);
+DEFINE_string(trace_export_file, "./log/trace.json", "file of exported trace span, one OTLP json per line");
+DEFINE_string(trace_service_name, "dingo-store", "service name of exported trace span");
+DEFINE_int64(trace_export_queue_max_size, 100000, "max pending span of trace exporter, drop when full");
+BRPC_VALIDATE_GFLAG(trace_export_queue_max_size, brpc::PositiveInteger);
+DEFINE_int64(trace_export_interval_ms, 500, "interval of trace exporter write pending span to file");
+BRPC_VALIDATE_GFLAG(trace_export_interval_ms, brpc::PositiveInteger);
+
+bvar::Adder<int64_t> g_trace_span_count("dingo_trace_span_count");
+bvar::Adder<int64_t> g_trace_span_dropped_count("dingo_trace_span_dropped_count");
+
+// context in header unknown field: trace_id_high, trace_id_low, span_id.
+static constexpr size_t kTraceContextSize = sizeof(uint64_t) * 3;
+
+// Background writer of span, span is batched and written every interval.
+class TraceExporter {
+ public:
+  static TraceExporter& Instance() {
+    static TraceExporter* exporter = []() {
+      auto* exporter = new TraceExporter();
+      std::thread([exporter]() { exporter->Run(); }).detach();
+      return exporter;
+    }();
+    return *exporter;
+  }
+
+  void Push(Span&& span) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (BAIDU_UNLIKELY(pending_spans_.size() >= FLAGS_trace_export_queue_max_size)) {
+      g_trace_span_dropped_count << 1;
+      return;
+    }
+    pending_spans_.push_back(std::move(span));
+  }
+
+  void Flush() {
+    std::unique_lock<std::mutex> write_lock(write_mutex_);
+    std::vector<Span> spans;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      spans.swap(pending_spans_);
+    }
+    if (spans.empty()) {
+      return;
+    }
+
+    if (file_ == nullptr) {
+      file_ = fopen(FLAGS_trace_export_file.c_str(), "a");
+      if (file_ == nullptr) {
+        DINGO_LOG(ERROR) << fmt::format("[trace] open export file {} failed, error: {}", FLAGS_trace_export_file,
+                                        strerror(errno));
+        g_trace_span_dropped_count << spans.size();
+        return;
+      }
+    }
+
+    std::string line = Tracer::ToOtlpJson(spans);
+    line.push_back('\n');
+    fwrite(line.data(), 1, line.size(), file_);
+    fflush(file_);
+    g_trace_span_count << spans.size();
+  }
+
+ private:
+  TraceExporter() = default;
+
+  void Run() {
+    for (;;) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(FLAGS_trace_export_interval_ms));
+      Flush();
+    }
+  }
+
+  std::mutex mutex_;
+  std::vector<Span> pending_spans_;
+
+  // serialize file write of background thread and Flush().
+  std::mutex write_mutex_;
+  FILE* file_{nullptr};
+};
+
+bool Tracer::IsEnabled() { return BAIDU_UNLIKELY(FLAGS_trace_sample_rate > 0); }
+
+TraceContext Tracer::StartTrace() {
+  TraceContext context;
+  if (!IsEnabled() || butil::fast_rand_double() >= FLAGS_trace_sample_rate) {
+    return context;
+  }
+
+  context.trace_id_high = butil::fast_rand();
+  context.trace_id_low = GenSpanId();
+  context.span_id = GenSpanId();
+  return context;
+}
+
+uint64_t Tracer::GenSpanId() {
+  uint64_t id = butil::fast_rand();
+  return id != 0 ? id : 1;
+}
+
+void Tracer::Emit(Span&& span) { TraceExporter::Instance().Push(std::move(span)); }
+
+void Tracer::Flush() { TraceExporter::Instance().Flush(); }
+
+void Tracer::Inject(const TraceContext& context, pb::raft::RequestHeader* header) {
+  if (!context.IsValid()) {
+    return;
+  }
+
+  char buf[kTraceContextSize];
+  memcpy(buf, &context.trace_id_high, sizeof(uint64_t));
+  memcpy(buf + sizeof(uint64_t), &context.trace_id_low, sizeof(uint64_t));
+  memcpy(buf + sizeof(uint64_t) * 2, &context.span_id, sizeof(uint64_t));
+  header->mutable_unknown_fields()->AddLengthDelimited(kTraceContextFieldNumber, std::string(buf, sizeof(buf)));
+}
+
+bool Tracer::Extract(const pb::raft::RequestHeader& header, TraceContext& context) {
+  const auto& unknown_fields = header.unknown_fields();
+  for (int i = 0; i < unknown_fields.field_count(); ++i) {
+    const auto& field = unknown_fields.field(i);
+    if (field.number() != kTraceContextFieldNumber ||
+        field.type() != google::protobuf::UnknownField::TYPE_LENGTH_DELIMITED ||
+        field.length_delimited().size() != kTraceContextSize) {
+      continue;
+    }
+
+    const char* buf = field.length_delimited().data();
+    memcpy(&context.trace_id_high, buf, sizeof(uint64_t));
+    memcpy(&context.trace_id_low, buf + sizeof(uint64_t), sizeof(uint64_t));
+    memcpy(&context.span_id, buf + sizeof(uint64_t) * 2, sizeof(uint64_t));
+    return context.IsValid();
+  }
+
+  return false;
+}
+
+bool Tracer::Extract(const butil::IOBuf& data, TraceContext& context) {
+  using google::protobuf::internal::WireFormatLite;
+
+  butil::IOBufAsZeroCopyInputStream wrapper(data);
+  google::protobuf::io::CodedInputStream input(&wrapper);
+
+  // header is the first field of serialized raft cmd.
+  uint32_t tag = input.ReadTag();
+  if (WireFormatLite::GetTagFieldNumber(tag) != pb::raft::RaftCmdRequest::kHeaderFieldNumber ||
+      WireFormatLite::GetTagWireType(tag) != WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+    return false;
+  }
+
+  uint32_t length = 0;
+  if (!input.ReadVarint32(&length)) {
+    return false;
+  }
+  auto limit = input.PushLimit(static_cast<int>(length));
+  pb::raft::RequestHeader header;
+  if (!header.MergePartialFromCodedStream(&input) || !input.ConsumedEntireMessage()) {
+    return false;
+  }
+  input.PopLimit(limit);
+
+  return Extract(header, context);
+}
+
+static void AppendStringAttribute(std::string& out, const std::string& key, const std::string& value) {
+  // key and value is set by ourself, only quote and backslash need escape.
+  auto escape = [](const std::string& str) {
+    std::string result;
+    result.reserve(str.size());
+    for (char c : str) {
+      if (c == '"' || c == '\\') {
+        result.push_back('\\');
+      }
+      result.push_back(c);
+    }
+    return result;
+  };
+
+  out += fmt::format(R"({{"key":"{}","value":{{"stringValue":"{}"}}}})", escape(key), escape(value));
+}
+
+std::string Tracer::ToOtlpJson(const std::vector<Span>& spans) {
+  static const std::string kHostName = butil::my_hostname();
+
+  std::string out;
+  out.reserve(256 + spans.size() * 256);
+  out += R"({"resourceSpans":[{"resource":{"attributes":[)";
+  AppendStringAttribute(out, "service.name", FLAGS_trace_service_name);
+  out.push_back(',');
+  AppendStringAttribute(out, "host.name", kHostName);
+  out += R"(]},"scopeSpans":[{"scope":{"name":"dingodb"},"spans":[)";
+
+  for (size_t i = 0; i < spans.size(); ++i) {
+    const auto& span = spans[i];
+    if (i > 0) {
+      out.push_back(',');
+    }
+    out += fmt::format(R"({{"traceId":"{:016x}{:016x}","spanId":"{:016x}",)", span.context.trace_id_high,
+                       span.context.trace_id_low, span.context.span_id);
+    if (span.parent_span_id != 0) {
+      out += fmt::format(R"("parentSpanId":"{:016x}",)", span.parent_span_id);
+    }
+    // kind 1 is SPAN_KIND_INTERNAL
+    out += fmt::format(R"("name":"{}","kind":1,"startTimeUnixNano":"{}","endTimeUnixNano":"{}","attributes":[)",
+                       span.name, span.start_time_ns, span.end_time_ns);
+    for (size_t j = 0; j < span.attributes.size(); ++j) {
+      if (j > 0) {
+        out.push_back(',');
+      }
+      AppendStringAttribute(out, span.attributes[j].first, span.attributes[j].second);
+    }
+    out += "]}";
+  }
+
+  out += "]}]}]}";
+  return out;
+}
+
+ScopedSpan::ScopedSpan(const TraceContext& parent, const char* name) {
+  if (BAIDU_LIKELY(!parent.IsValid())) {
+    return;
+  }
+
+  is_recording_ = true;
+  span_.name = name;
+  span_.context = parent;
+  span_.context.span_id = Tracer::GenSpanId();
+  span_.parent_span_id = parent.span_id;
+  span_.start_time_ns = CycleClock::NowNs();
+}
+
+ScopedSpan::~ScopedSpan() {
+  if (BAIDU_LIKELY(!is_recording_)) {
+    return;
+  }
+
+  span_.end_time_ns = CycleClock::NowNs();
+  Tracer::Emit(std::move(span_));
+}
+
+void ScopedSpan::AddAttribute(std::string key, std::string value) {
+  if (is_recording_) {
+    span_.attributes.emplace_back(std::move(key), std::move(value));
+  }
+}
+
+}  // namespace dingodb
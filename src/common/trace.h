@@ -0,0 +1,99 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COMMON_TRACE_H_
+#define DINGODB_COMMON_TRACE_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "butil/iobuf.h"
+#include "proto/raft.pb.h"
+
+namespace dingodb {
+
+// Sampled trace of write request across service, raft and apply stages of all peers.
+// Trace is sampled at service when tracker is created, trace context is carried in raft cmd header,
+// so follower append and apply are in the same trace as leader propose. Span is exported as OTLP json lines,
+// which can be collected by opentelemetry collector otlpjsonfile receiver.
+// When sample rate is 0, every check is one flag load.
+
+struct TraceContext {
+  uint64_t trace_id_high{0};
+  uint64_t trace_id_low{0};
+  // span id of parent of new span.
+  uint64_t span_id{0};
+
+  bool IsValid() const { return trace_id_high != 0 || trace_id_low != 0; }
+};
+
+struct Span {
+  std::string name;
+  // trace id of trace and span id of this span.
+  TraceContext context;
+  uint64_t parent_span_id{0};
+  int64_t start_time_ns{0};
+  int64_t end_time_ns{0};
+  std::vector<std::pair<std::string, std::string>> attributes;
+};
+
+class Tracer {
+ public:
+  // sample rate is not 0.
+  static bool IsEnabled();
+
+  // sample a new trace, return invalid context if not sampled.
+  static TraceContext StartTrace();
+  static uint64_t GenSpanId();
+
+  // export finished span, span is dropped when export queue is full.
+  static void Emit(Span&& span);
+  // wait all emitted span is written.
+  static void Flush();
+
+  // trace context is put in unknown field of raft cmd header, older peer just ignore it.
+  static void Inject(const TraceContext& context, pb::raft::RequestHeader* header);
+  static bool Extract(const pb::raft::RequestHeader& header, TraceContext& context);
+  // extract from serialized raft cmd, only header is parsed.
+  static bool Extract(const butil::IOBuf& data, TraceContext& context);
+
+  // span as one OTLP json line, for test.
+  static std::string ToOtlpJson(const std::vector<Span>& spans);
+
+  static constexpr int kTraceContextFieldNumber = 1000;
+};
+
+// Span of a scope, child of parent context, nothing is done if parent is invalid.
+class ScopedSpan {
+ public:
+  ScopedSpan(const TraceContext& parent, const char* name);
+  ~ScopedSpan();
+
+  ScopedSpan(const ScopedSpan&) = delete;
+  ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+  bool IsRecording() const { return is_recording_; }
+  void AddAttribute(std::string key, std::string value);
+
+ private:
+  bool is_recording_{false};
+  Span span_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_TRACE_H_
@@ -15,6 +15,8 @@
 #include "common/tracker.h"
 
 #include <memory>
+#include <string>
+#include <utility>
 
 namespace dingodb {
 
@@ -29,4 +31,25 @@ bvar::LatencyRecorder Tracker::store_write_latency("dingo_tracker_store_write");
 bvar::LatencyRecorder Tracker::vector_index_write_latency("dingo_tracker_vector_index_write");
 bvar::LatencyRecorder Tracker::document_index_write_latency("dingo_tracker_document_index_write");
 
+void Tracker::EmitStageSpan(const char* name, uint64_t start_time, uint64_t end_time) {
+  Span span;
+  span.name = name;
+  span.context = trace_context_;
+  span.context.span_id = Tracer::GenSpanId();
+  span.parent_span_id = trace_context_.span_id;
+  span.start_time_ns = start_time;
+  span.end_time_ns = end_time;
+  Tracer::Emit(std::move(span));
+}
+
+void Tracker::EmitRootSpan() {
+  Span span;
+  span.name = "rpc";
+  span.context = trace_context_;
+  span.start_time_ns = start_time_;
+  span.end_time_ns = start_time_ + metrics_.total_rpc_time_ns;
+  span.attributes.emplace_back("request_id", std::to_string(request_info_.request_id()));
+  Tracer::Emit(std::move(span));
+}
+
 }  // namespace dingodb
\ No newline at end of file
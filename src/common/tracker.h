@@ -18,8 +18,10 @@
 #include <cstdint>
 #include <memory>
 
+#include "butil/compiler_specific.h"
 #include "bvar/latency_recorder.h"
-#include "common/helper.h"
+#include "common/cycle_clock.h"
+#include "common/trace.h"
 #include "proto/common.pb.h"
 
 namespace dingodb {
@@ -27,8 +29,11 @@ namespace dingodb {
 class Tracker {
  public:
   Tracker(const pb::common::RequestInfo& request_info) : request_info_(request_info) {
-    start_time_ = Helper::TimestampNs();
+    start_time_ = CycleClock::NowNs();
     last_time_ = start_time_;
+    if (BAIDU_UNLIKELY(Tracer::IsEnabled())) {
+      trace_context_ = Tracer::StartTrace();
+    }
   }
   ~Tracker() = default;
 
@@ -50,12 +55,20 @@ class Tracker {
     uint64_t read_store_time_ns{0};
   };
 
-  void SetTotalRpcTime() { metrics_.total_rpc_time_ns = Helper::TimestampNs() - start_time_; }
+  void SetTotalRpcTime() {
+    metrics_.total_rpc_time_ns = CycleClock::NowNs() - start_time_;
+    if (BAIDU_UNLIKELY(trace_context_.IsValid())) {
+      EmitRootSpan();
+    }
+  }
   uint64_t TotalRpcTime() const { return metrics_.total_rpc_time_ns; }
 
   void SetServiceQueueWaitTime() {
-    uint64_t now_time = Helper::TimestampNs();
+    uint64_t now_time = CycleClock::NowNs();
     metrics_.service_queue_wait_time_ns = now_time - last_time_;
+    if (BAIDU_UNLIKELY(trace_context_.IsValid())) {
+      EmitStageSpan("service_queue_wait", last_time_, now_time);
+    }
     last_time_ = now_time;
 
     service_queue_latency << metrics_.service_queue_wait_time_ns / 1000;
@@ -63,8 +76,11 @@ class Tracker {
   uint64_t ServiceQueueWaitTime() const { return metrics_.service_queue_wait_time_ns; }
 
   void SetPrepairCommitTime() {
-    uint64_t now_time = Helper::TimestampNs();
+    uint64_t now_time = CycleClock::NowNs();
     metrics_.prepair_commit_time_ns = now_time - last_time_;
+    if (BAIDU_UNLIKELY(trace_context_.IsValid())) {
+      EmitStageSpan("prepair_commit", last_time_, now_time);
+    }
     last_time_ = now_time;
 
     prepair_commit_latency << metrics_.prepair_commit_time_ns / 1000;
@@ -72,8 +88,11 @@ class Tracker {
   uint64_t PrepairCommitTime() const { return metrics_.prepair_commit_time_ns; }
 
   void SetRaftCommitTime() {
-    uint64_t now_time = Helper::TimestampNs();
+    uint64_t now_time = CycleClock::NowNs();
     metrics_.raft_commit_time_ns = now_time - last_time_;
+    if (BAIDU_UNLIKELY(trace_context_.IsValid())) {
+      EmitStageSpan("raft_commit", last_time_, now_time);
+    }
     last_time_ = now_time;
 
     raft_commit_latency << metrics_.raft_commit_time_ns / 1000;
@@ -81,8 +100,11 @@ class Tracker {
   uint64_t RaftCommitTime() const { return metrics_.raft_commit_time_ns; }
 
   void SetRaftQueueWaitTime() {
-    uint64_t now_time = Helper::TimestampNs();
+    uint64_t now_time = CycleClock::NowNs();
     metrics_.raft_queue_wait_time_ns = now_time - last_time_;
+    if (BAIDU_UNLIKELY(trace_context_.IsValid())) {
+      EmitStageSpan("raft_queue_wait", last_time_, now_time);
+    }
     last_time_ = now_time;
 
     raft_queue_wait_latency << metrics_.raft_queue_wait_time_ns / 1000;
@@ -90,8 +112,11 @@ class Tracker {
   uint64_t RaftQueueWaitTime() const { return metrics_.raft_queue_wait_time_ns; }
 
   void SetRaftApplyTime() {
-    uint64_t now_time = Helper::TimestampNs();
+    uint64_t now_time = CycleClock::NowNs();
     metrics_.raft_apply_time_ns = now_time - last_time_;
+    if (BAIDU_UNLIKELY(trace_context_.IsValid())) {
+      EmitStageSpan("raft_apply", last_time_, now_time);
+    }
     last_time_ = now_time;
 
     raft_apply_latency << metrics_.raft_apply_time_ns / 1000;
@@ -100,31 +125,50 @@ class Tracker {
 
   void SetStoreWriteTime(uint64_t elapsed_time) {
     metrics_.store_write_time_ns = elapsed_time;
+    if (BAIDU_UNLIKELY(trace_context_.IsValid())) {
+      uint64_t now_time = CycleClock::NowNs();
+      EmitStageSpan("store_write", now_time - elapsed_time, now_time);
+    }
     store_write_latency << metrics_.store_write_time_ns / 1000;
   }
   uint64_t StoreWriteTime() const { return metrics_.store_write_time_ns; }
 
   void SetVectorIndexWriteTime(uint64_t elapsed_time) {
     metrics_.vector_index_write_time_ns = elapsed_time;
+    if (BAIDU_UNLIKELY(trace_context_.IsValid())) {
+      uint64_t now_time = CycleClock::NowNs();
+      EmitStageSpan("vector_index_write", now_time - elapsed_time, now_time);
+    }
     vector_index_write_latency << metrics_.vector_index_write_time_ns / 1000;
   }
   uint64_t VectorIndexwriteTime() const { return metrics_.vector_index_write_time_ns; }
 
   void SetDocumentIndexWriteTime(uint64_t elapsed_time) {
     metrics_.document_index_write_time_ns = elapsed_time;
+    if (BAIDU_UNLIKELY(trace_context_.IsValid())) {
+      uint64_t now_time = CycleClock::NowNs();
+      EmitStageSpan("document_index_write", now_time - elapsed_time, now_time);
+    }
     document_index_write_latency << metrics_.document_index_write_time_ns / 1000;
   }
   uint64_t DocumentIndexwriteTime() const { return metrics_.document_index_write_time_ns; }
 
   void SetReadStoreTime() {
-    uint64_t now_time = Helper::TimestampNs();
+    uint64_t now_time = CycleClock::NowNs();
     metrics_.read_store_time_ns = now_time - last_time_;
+    if (BAIDU_UNLIKELY(trace_context_.IsValid())) {
+      EmitStageSpan("read_store", last_time_, now_time);
+    }
     last_time_ = now_time;
 
     read_store_latency << metrics_.read_store_time_ns / 1000;
   }
   inline uint64_t ReadStoreTime() const { return metrics_.read_store_time_ns; }
 
+  // request is sampled by tracer, context of root span.
+  bool IsSampled() const { return trace_context_.IsValid(); }
+  const TraceContext& GetTraceContext() const { return trace_context_; }
+
   // latency statistics
   static bvar::LatencyRecorder service_queue_latency;
   static bvar::LatencyRecorder prepair_commit_latency;
@@ -141,8 +185,12 @@ class Tracker {
   uint64_t start_time_;
   uint64_t last_time_;
 
+  void EmitStageSpan(const char* name, uint64_t start_time, uint64_t end_time);
+  void EmitRootSpan();
+
   pb::common::RequestInfo request_info_;
   Metrics metrics_;
+  TraceContext trace_context_;
 };
 using TrackerPtr = std::shared_ptr<Tracker>;
 
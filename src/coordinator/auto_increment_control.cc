@@ -14,26 +14,41 @@
 
 #include "coordinator/auto_increment_control.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <fstream>
 #include <memory>
 #include <string>
 
+#include "brpc/reloadable_flags.h"
 #include "butil/containers/flat_map.h"
 #include "butil/status.h"
+#include "common/gflag_validator.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
 #include "engine/snapshot.h"
 #include "fmt/format.h"
+#include "gflags/gflags.h"
 #include "proto/error.pb.h"
 #include "server/server.h"
 
 namespace dingodb {
 
+DEFINE_bool(enable_auto_increment_lease, false, "generate auto increment from larger range granted ahead on leader");
+DEFINE_validator(enable_auto_increment_lease, &PassBool);
+DEFINE_int64(auto_increment_lease_duration_s, 10, "grant auto increment range enough for this seconds of request rate");
+BRPC_VALIDATE_GFLAG(auto_increment_lease_duration_s, brpc::PositiveInteger);
+DEFINE_int64(auto_increment_lease_min_size, 1000, "min size of granted auto increment range");
+BRPC_VALIDATE_GFLAG(auto_increment_lease_min_size, brpc::PositiveInteger);
+DEFINE_int32(auto_increment_lease_refill_percent, 30,
+             "refill auto increment lease in background when remain ids is less than this percent of grant size");
+BRPC_VALIDATE_GFLAG(auto_increment_lease_refill_percent, brpc::NonNegativeInteger);
+
 AutoIncrementControl::AutoIncrementControl() {
   // init bthread mutex
   bthread_mutex_init(&auto_increment_map_mutex_, nullptr);
+  bthread_mutex_init(&lease_mutex_, nullptr);
 
   CHECK_EQ(0, auto_increment_map_.init(256, 70));
 
@@ -222,6 +237,187 @@ butil::Status AutoIncrementControl::GenerateAutoIncrement(int64_t table_id, uint
   return butil::Status::OK();
 }
 
+bool AutoIncrementControl::TakeFromRange(int64_t& lease_start_id, int64_t lease_end_id, uint32_t count,
+                                         uint32_t increment, uint32_t offset, int64_t& start_id, int64_t& end_id) {
+  if (lease_start_id >= lease_end_id) {
+    return false;
+  }
+
+  int64_t generate_end_id = GetGenerateEndId(lease_start_id, count, increment, offset);
+  if (generate_end_id > lease_end_id) {
+    return false;
+  }
+
+  start_id = lease_start_id;
+  end_id = generate_end_id;
+  lease_start_id = generate_end_id;
+  return true;
+}
+
+butil::Status AutoIncrementControl::SyncGenerateAutoIncrement(int64_t table_id, uint32_t count, uint32_t increment,
+                                                              uint32_t offset, int64_t& start_id, int64_t& end_id) {
+  pb::coordinator_internal::MetaIncrement meta_increment;
+  auto status = GenerateAutoIncrement(table_id, count, increment, offset, meta_increment);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // response is filled when applied on leader
+  pb::meta::GenerateAutoIncrementResponse response;
+  std::shared_ptr<Context> const ctx = std::make_shared<Context>(nullptr, nullptr, &response);
+  ctx->SetRegionId(Constant::kAutoIncrementRegionId);
+
+  status = engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), meta_increment));
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << "SubmitMetaIncrement failed, errno=" << status.error_code() << " errmsg=" << status.error_str();
+    return status;
+  }
+  if (response.end_id() <= response.start_id()) {
+    return butil::Status(pb::error::Errno::ERAFT_NOTLEADER, "not leader when apply generate auto increment");
+  }
+
+  start_id = response.start_id();
+  end_id = response.end_id();
+  return butil::Status::OK();
+}
+
+void AutoIncrementControl::UpdateLeaseRate(AutoIncrementLease& lease, int64_t count) {
+  int64_t now_ms = Helper::TimestampMs();
+  if (lease.window_start_ms == 0) {
+    lease.window_start_ms = now_ms;
+  }
+  lease.window_count += count;
+
+  int64_t elapsed_ms = now_ms - lease.window_start_ms;
+  if (elapsed_ms >= 1000) {
+    int64_t rate = lease.window_count * 1000 / elapsed_ms;
+    lease.rate = lease.rate == 0 ? rate : (lease.rate + rate) / 2;
+    lease.window_start_ms = now_ms;
+    lease.window_count = 0;
+  }
+
+  lease.grant_size = std::min(std::max(lease.rate * FLAGS_auto_increment_lease_duration_s,
+                                       FLAGS_auto_increment_lease_min_size),
+                              static_cast<int64_t>(kAutoIncrementGenerateCountMax));
+}
+
+butil::Status AutoIncrementControl::GenerateAutoIncrementFromLease(int64_t table_id, uint32_t count,
+                                                                   uint32_t auto_increment_increment,
+                                                                   uint32_t auto_increment_offset, int64_t& start_id,
+                                                                   int64_t& end_id) {
+  if (count == 0 || auto_increment_increment == 0 || auto_increment_increment > kAutoIncrementOffsetMax ||
+      auto_increment_offset == 0 || auto_increment_offset > kAutoIncrementOffsetMax) {
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "illegal parameters");
+  }
+
+  bool is_taken = false;
+  bool need_refill = false;
+  int64_t epoch = 0;
+  int64_t grant_size = 0;
+  {
+    BAIDU_SCOPED_LOCK(lease_mutex_);
+    auto& lease = lease_map_[table_id];
+    UpdateLeaseRate(lease, static_cast<int64_t>(count) * auto_increment_increment);
+
+    is_taken = TakeFromRange(lease.start_id, lease.end_id, count, auto_increment_increment, auto_increment_offset,
+                             start_id, end_id);
+    if (!is_taken && lease.next_end_id > lease.next_start_id) {
+      lease.start_id = lease.next_start_id;
+      lease.end_id = lease.next_end_id;
+      lease.next_start_id = 0;
+      lease.next_end_id = 0;
+      is_taken = TakeFromRange(lease.start_id, lease.end_id, count, auto_increment_increment, auto_increment_offset,
+                               start_id, end_id);
+    }
+
+    epoch = lease_epoch_;
+    grant_size = lease.grant_size;
+    if (is_taken && !lease.is_refilling && lease.next_end_id <= lease.next_start_id &&
+        (lease.end_id - lease.start_id) * 100 < grant_size * FLAGS_auto_increment_lease_refill_percent) {
+      lease.is_refilling = true;
+      need_refill = true;
+    }
+  }
+
+  if (need_refill) {
+    Bthread bth([this, table_id, epoch, grant_size]() { RefillLease(table_id, epoch, grant_size); });
+  }
+  if (is_taken) {
+    return butil::Status::OK();
+  }
+
+  // lease is exhausted, grant for this request and later ones, the extra increment is for align of offset.
+  grant_size = std::max(grant_size, static_cast<int64_t>(count) * auto_increment_increment + auto_increment_increment);
+  if (grant_size > kAutoIncrementGenerateCountMax) {
+    return SyncGenerateAutoIncrement(table_id, count, auto_increment_increment, auto_increment_offset, start_id,
+                                     end_id);
+  }
+
+  int64_t lease_start_id = 0;
+  int64_t lease_end_id = 0;
+  auto status = SyncGenerateAutoIncrement(table_id, grant_size, 1, 1, lease_start_id, lease_end_id);
+  if (!status.ok()) {
+    return status;
+  }
+  if (!TakeFromRange(lease_start_id, lease_end_id, count, auto_increment_increment, auto_increment_offset, start_id,
+                     end_id)) {
+    return butil::Status(pb::error::Errno::EINTERNAL, "granted auto increment range is not enough");
+  }
+
+  BAIDU_SCOPED_LOCK(lease_mutex_);
+  if (epoch == lease_epoch_) {
+    auto& lease = lease_map_[table_id];
+    // concurrent grants may finish at same time, keep the larger remain.
+    if (lease.end_id - lease.start_id < lease_end_id - lease_start_id) {
+      lease.start_id = lease_start_id;
+      lease.end_id = lease_end_id;
+    }
+    ++lease.grant_count;
+    auto_increment_metrics_.UpdateAutoIncrementBvar(table_id, lease.grant_count, grant_size, lease.rate);
+  }
+
+  return butil::Status::OK();
+}
+
+void AutoIncrementControl::RefillLease(int64_t table_id, int64_t epoch, int64_t grant_size) {
+  int64_t start_id = 0;
+  int64_t end_id = 0;
+  auto status = SyncGenerateAutoIncrement(table_id, grant_size, 1, 1, start_id, end_id);
+
+  BAIDU_SCOPED_LOCK(lease_mutex_);
+  auto it = lease_map_.find(table_id);
+  if (epoch != lease_epoch_ || it == lease_map_.end()) {
+    return;
+  }
+
+  auto& lease = it->second;
+  lease.is_refilling = false;
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("refill auto increment lease failed, table id: {}, error: {}", table_id,
+                                      status.error_str());
+    return;
+  }
+
+  lease.next_start_id = start_id;
+  lease.next_end_id = end_id;
+  ++lease.grant_count;
+  auto_increment_metrics_.UpdateAutoIncrementBvar(table_id, lease.grant_count, grant_size, lease.rate);
+}
+
+void AutoIncrementControl::DropLease(int64_t table_id) {
+  BAIDU_SCOPED_LOCK(lease_mutex_);
+  if (lease_map_.erase(table_id) > 0) {
+    ++lease_epoch_;
+  }
+}
+
+void AutoIncrementControl::ClearLeases() {
+  BAIDU_SCOPED_LOCK(lease_mutex_);
+  lease_map_.clear();
+  ++lease_epoch_;
+  auto_increment_metrics_.Clear();
+}
+
 butil::Status AutoIncrementControl::DeleteAutoIncrement(int64_t table_id,
                                                         pb::coordinator_internal::MetaIncrement& meta_increment) {
   DINGO_LOG(INFO) << "table id" << table_id;
@@ -327,9 +523,15 @@ bool AutoIncrementControl::IsLeader() { return leader_term_.load(butil::memory_o
 
 void AutoIncrementControl::SetLeaderTerm(int64_t term) { leader_term_.store(term, butil::memory_order_release); }
 
-void AutoIncrementControl::OnLeaderStart(int64_t term) { DINGO_LOG(INFO) << "OnLeaderStart, term=" << term; }
+void AutoIncrementControl::OnLeaderStart(int64_t term) {
+  DINGO_LOG(INFO) << "OnLeaderStart, term=" << term;
+  ClearLeases();
+}
 
-void AutoIncrementControl::OnLeaderStop() { DINGO_LOG(INFO) << "OnLeaderStop"; }
+void AutoIncrementControl::OnLeaderStop() {
+  DINGO_LOG(INFO) << "OnLeaderStop";
+  ClearLeases();
+}
 
 // set raft_node to coordinator_control
 void AutoIncrementControl::SetRaftNode(std::shared_ptr<RaftNode> raft_node) { raft_node_ = raft_node; }
@@ -346,6 +548,7 @@ void AutoIncrementControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncr
       DINGO_LOG(INFO) << "create auto increment, table id: " << table_id
                       << ", start id: " << auto_increment.increment().start_id();
       auto_increment_map_[table_id] = auto_increment.increment().start_id();
+      DropLease(table_id);
     } else if (auto_increment.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
       int64_t* start_id_ptr = auto_increment_map_.seek(table_id);
       if (start_id_ptr == nullptr) {
@@ -376,6 +579,7 @@ void AutoIncrementControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncr
                              << auto_increment.increment().source_start_id();
         }
         auto_increment_map_[table_id] = auto_increment.increment().start_id();
+        DropLease(table_id);
         DINGO_LOG(INFO) << "update auto increment, table id: " << table_id
                         << ", old start id: " << auto_increment.increment().source_start_id()
                         << ", start id: " << auto_increment.increment().start_id();
@@ -383,6 +587,7 @@ void AutoIncrementControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncr
     } else if (auto_increment.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
       DINGO_LOG(INFO) << "delete auto increment " << auto_increment.ShortDebugString();
       auto_increment_map_.erase(table_id);
+      DropLease(table_id);
     }
   }
 }
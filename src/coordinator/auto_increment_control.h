@@ -24,6 +24,7 @@
 #include "butil/status.h"
 #include "common/meta_control.h"
 #include "engine/engine.h"
+#include "metrics/coordinator_bvar_metrics.h"
 #include "proto/coordinator_internal.pb.h"
 
 namespace dingodb {
@@ -39,6 +40,25 @@ class AutoIncrementSnapshot : public dingodb::Snapshot {
   const butil::FlatMap<int64_t, int64_t> *snapshot_;
 };
 
+// Ids already granted by raft but not handed out yet, only kept on leader.
+// Handing out ids from lease need no raft write, ids of lease lost at leader change are just skipped.
+struct AutoIncrementLease {
+  int64_t start_id{0};
+  int64_t end_id{0};
+  // prefetched by background refill, used when [start_id, end_id) is exhausted.
+  int64_t next_start_id{0};
+  int64_t next_end_id{0};
+  bool is_refilling{false};
+
+  // requested ids per second, decide grant size.
+  int64_t rate{0};
+  int64_t window_start_ms{0};
+  int64_t window_count{0};
+
+  int64_t grant_size{0};
+  int64_t grant_count{0};
+};
+
 class AutoIncrementControl : public MetaControl {
  public:
   AutoIncrementControl();
@@ -74,6 +94,11 @@ class AutoIncrementControl : public MetaControl {
                                       pb::coordinator_internal::MetaIncrement &meta_increment);
   butil::Status DeleteAutoIncrement(int64_t table_id, pb::coordinator_internal::MetaIncrement &meta_increment);
 
+  // generate auto increment from lease of leader, grant a larger range by raft when lease is exhausted.
+  // start_id and end_id have same meaning as GenerateAutoIncrementResponse.
+  butil::Status GenerateAutoIncrementFromLease(int64_t table_id, uint32_t count, uint32_t auto_increment_increment,
+                                               uint32_t auto_increment_offset, int64_t &start_id, int64_t &end_id);
+
   // restore auto_increment_map_
   butil::Status CreateOrUpdateAutoIncrement(int64_t table_id, int64_t start_id,
                                             pb::coordinator_internal::MetaIncrement &meta_increment);
@@ -124,6 +149,18 @@ class AutoIncrementControl : public MetaControl {
   static int64_t GetGenerateEndId(int64_t start_id, uint32_t count, uint32_t increment, uint32_t offset);
   static int64_t GetRealStartId(int64_t start_id, uint32_t auto_increment_increment, uint32_t auto_increment_offset);
 
+  // take ids from [lease_start_id, lease_end_id), return false if not enough.
+  static bool TakeFromRange(int64_t &lease_start_id, int64_t lease_end_id, uint32_t count, uint32_t increment,
+                            uint32_t offset, int64_t &start_id, int64_t &end_id);
+  // raft write a generate auto increment and wait it applied.
+  butil::Status SyncGenerateAutoIncrement(int64_t table_id, uint32_t count, uint32_t increment, uint32_t offset,
+                                          int64_t &start_id, int64_t &end_id);
+  static void UpdateLeaseRate(AutoIncrementLease &lease, int64_t count);
+  void RefillLease(int64_t table_id, int64_t epoch, int64_t grant_size);
+  // drop leases, ids of them will not be handed out any more.
+  void DropLease(int64_t table_id);
+  void ClearLeases();
+
   butil::FlatMap<int64_t, int64_t> auto_increment_map_;
   bthread_mutex_t auto_increment_map_mutex_;
 
@@ -139,6 +176,14 @@ class AutoIncrementControl : public MetaControl {
   // coordinator raft_location to server_location cache
   std::map<std::string, pb::common::Location> auto_increment_location_cache_;
 
+  // table_id -> lease
+  std::map<int64_t, AutoIncrementLease> lease_map_;
+  bthread_mutex_t lease_mutex_;
+  // changed when leases are dropped, so grant started before is not used.
+  int64_t lease_epoch_{0};
+
+  CoordinatorBvarMetricsAutoIncrement auto_increment_metrics_;
+
   inline static const uint32_t kAutoIncrementGenerateCountMax = 100000;
   inline static const uint32_t kAutoIncrementOffsetMax = 65535;
 };
@@ -17,7 +17,10 @@
 #include <algorithm>
 #include <atomic>
 #include <cstdint>
+#include <functional>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -26,6 +29,7 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "config/config_helper.h"
+#include "coordinator/region_load_stat.h"
 #include "fmt/core.h"
 #include "glog/logging.h"
 #include "proto/common.pb.h"
@@ -37,6 +41,14 @@ DEFINE_uint32(balacne_leader_task_batch_size, 4, "balance leader task batch size
 
 DEFINE_uint32(balacne_leader_random_select_region_num, 10, "balance leader random select region num");
 
+DEFINE_bool(enable_balance_hot_leader, false, "balance leader by region write load before balance by leader count");
+
+DEFINE_uint32(balance_hot_leader_tolerance_percent, 25, "hot leader balance run when store load exceed average");
+
+DEFINE_int64(balance_hot_region_min_write_bytes_rate, 1048576, "region write bytes per second to be hot region");
+
+DEFINE_int64(balance_hot_leader_target_max_cpu_usage, 80, "store cpu usage percent above this not take hot leader");
+
 namespace dingodb {
 
 namespace balance {
@@ -177,6 +189,17 @@ bool TaskFilter::Check(int64_t region_id) {
   return true;
 }
 
+bool HotRegionCooldownFilter::Check(int64_t region_id) {
+  if (RegionLoadStat::GetInstance().IsCoolingDown(region_id)) {
+    if (tracker_) {
+      tracker_->filter_records.push_back(fmt::format("[filter.region({})] hot leader moved recently", region_id));
+    }
+    return false;
+  }
+
+  return true;
+}
+
 void Tracker::Print() {
   std::string store_type_name = pb::common::StoreType_Name(store_type);
   DINGO_LOG(INFO) << fmt::format("[balance.leader.{}] ==========================================================",
@@ -405,6 +428,9 @@ butil::Status BalanceLeaderScheduler::LaunchBalanceLeader(std::shared_ptr<Coordi
 
   std::vector<FilterPtr> region_filters;
   region_filters.push_back(std::make_shared<RegionHealthFilter>(coordinator_controller, tracker));
+  if (FLAGS_enable_balance_hot_leader) {
+    region_filters.push_back(std::make_shared<HotRegionCooldownFilter>(tracker));
+  }
 
   std::vector<FilterPtr> task_filters;
   task_filters.push_back(std::make_shared<TaskFilter>(coordinator_controller, tracker));
@@ -428,13 +454,26 @@ butil::Status BalanceLeaderScheduler::LaunchBalanceLeader(std::shared_ptr<Coordi
     return butil::Status(pb::error::EINTERNAL, "store map is empty");
   }
 
-  auto transfer_leader_tasks = balance_leader_scheduler->Schedule(region_map, store_map);
+  // spread write load first, balance leader count when load is balanced.
+  std::vector<TransferLeaderTaskPtr> transfer_leader_tasks;
+  if (FLAGS_enable_balance_hot_leader) {
+    transfer_leader_tasks = balance_leader_scheduler->ScheduleHotLeader(region_map, store_map);
+  }
+  bool is_hot_leader = !transfer_leader_tasks.empty();
+  if (!is_hot_leader) {
+    transfer_leader_tasks = balance_leader_scheduler->Schedule(region_map, store_map);
+  }
   if (transfer_leader_tasks.empty()) {
     return butil::Status(0, "transfer leader task is empty, maybe leader is balance");
   }
 
   if (!dryrun) {
     balance_leader_scheduler->CommitTransferLeaderJob(transfer_leader_tasks);
+    if (is_hot_leader) {
+      for (const auto& task : transfer_leader_tasks) {
+        RegionLoadStat::GetInstance().MarkMoved(task->region_id);
+      }
+    }
   }
 
   if (tracker) {
@@ -544,6 +583,80 @@ std::vector<TransferLeaderTaskPtr> BalanceLeaderScheduler::Schedule(const pb::co
   return transfer_leader_tasks;
 }
 
+std::vector<TransferLeaderTaskPtr> BalanceLeaderScheduler::ScheduleHotLeader(const pb::common::RegionMap& region_map,
+                                                                             const pb::common::StoreMap& store_map) {
+  CHECK(coordinator_controller_ != nullptr) << "coordinator_controller is nullptr.";
+
+  RegionLoadStat::GetInstance().CleanStale();
+
+  auto store_region_id_map = GenerateStoreRegionMap(region_map);
+  auto store_entries = GenerateStoreEntries(store_region_id_map, store_map);
+  if (store_entries.size() < 2) {
+    return {};
+  }
+
+  // store_id: write bytes rate of leader regions
+  std::map<int64_t, int64_t> store_loads;
+  int64_t total_load = 0;
+  for (auto& store_entry : store_entries) {
+    int64_t load = 0;
+    for (auto region_id : store_entry->LeaderRegionIds()) {
+      load += RegionLoadStat::GetInstance().GetWriteBytesRate(region_id);
+    }
+    store_loads[store_entry->Id()] = load;
+    total_load += load;
+  }
+  int64_t average_load = total_load / static_cast<int64_t>(store_entries.size());
+
+  if (tracker_) {
+    std::string load_str;
+    for (const auto& [store_id, load] : store_loads) {
+      load_str += fmt::format("{}:{},", store_id, load);
+    }
+    tracker_->leader_score = fmt::format("hot leader load({}) average({})", load_str, average_load);
+  }
+
+  auto candidate_stores = CandidateStores::New(store_entries, false);
+
+  int32_t round = 0;
+  std::set<int64_t> used_regions;
+  std::vector<TransferLeaderTaskPtr> transfer_leader_tasks;
+  while (transfer_leader_tasks.size() < FLAGS_balacne_leader_task_batch_size) {
+    auto source_store_entry = *std::max_element(
+        store_entries.begin(), store_entries.end(), [&store_loads](const StoreEntryPtr& lhs, const StoreEntryPtr& rhs) {
+          return store_loads[lhs->Id()] < store_loads[rhs->Id()];
+        });
+
+    // tolerance is the hysteresis, store load around average is not scheduled
+    int64_t source_load = store_loads[source_store_entry->Id()];
+    if (source_load < FLAGS_balance_hot_region_min_write_bytes_rate ||
+        source_load * 100 <= average_load * (100 + FLAGS_balance_hot_leader_tolerance_percent)) {
+      break;
+    }
+
+    auto record = tracker_ != nullptr ? tracker_->AddRecord() : nullptr;
+    if (record) {
+      record->round = ++round;
+    }
+
+    auto transfer_leader_task = GenerateHotLeaderTask(candidate_stores, source_store_entry, store_loads, used_regions);
+    if (transfer_leader_task == nullptr) {
+      break;
+    }
+
+    if (record) {
+      record->region_id = transfer_leader_task->region_id;
+      record->source_store_id = transfer_leader_task->source_store_id;
+      record->target_store_id = transfer_leader_task->target_store_id;
+    }
+
+    used_regions.insert(transfer_leader_task->region_id);
+    transfer_leader_tasks.push_back(transfer_leader_task);
+  }
+
+  return FilterTask(transfer_leader_tasks);
+}
+
 // commit transfer leader task to raft
 void BalanceLeaderScheduler::CommitTransferLeaderJob(const std::vector<TransferLeaderTaskPtr>& tasks) {
   dingodb::pb::coordinator_internal::MetaIncrement meta_increment;
@@ -809,6 +922,74 @@ TransferLeaderTaskPtr BalanceLeaderScheduler::GenerateTransferInLeaderTask(Candi
   return nullptr;
 }
 
+TransferLeaderTaskPtr BalanceLeaderScheduler::GenerateHotLeaderTask(CandidateStoresPtr candidate_stores,
+                                                                    StoreEntryPtr source_store_entry,
+                                                                    std::map<int64_t, int64_t>& store_loads,
+                                                                    const std::set<int64_t>& used_regions) {
+  // hot region first
+  std::vector<std::pair<int64_t, int64_t>> hot_regions;
+  for (auto region_id : FilterRegion(FilterUsedRegion(source_store_entry->LeaderRegionIds(), used_regions))) {
+    int64_t rate = RegionLoadStat::GetInstance().GetWriteBytesRate(region_id);
+    if (rate >= FLAGS_balance_hot_region_min_write_bytes_rate) {
+      hot_regions.emplace_back(rate, region_id);
+    }
+  }
+  std::sort(hot_regions.begin(), hot_regions.end(), std::greater<>());
+
+  int64_t source_load = store_loads[source_store_entry->Id()];
+  for (const auto& [rate, region_id] : hot_regions) {
+    auto region = coordinator_controller_->GetRegion(region_id);
+    if (region.id() == 0) {
+      continue;
+    }
+
+    auto follower_store_entries = FilterResource(GetFollowerStores(candidate_stores, region, source_store_entry->Id()),
+                                                 region.id());
+
+    StoreEntryPtr target_store_entry = nullptr;
+    for (auto& follower_store_entry : follower_store_entries) {
+      // moving must not make target hotter than source, else the leader is moved back next round
+      int64_t target_load = store_loads[follower_store_entry->Id()];
+      if (target_load + rate >= source_load - rate || IsStoreCpuBusy(follower_store_entry->Id())) {
+        continue;
+      }
+      if (target_store_entry == nullptr || target_load < store_loads[target_store_entry->Id()]) {
+        target_store_entry = follower_store_entry;
+      }
+    }
+
+    if (target_store_entry != nullptr) {
+      store_loads[source_store_entry->Id()] -= rate;
+      store_loads[target_store_entry->Id()] += rate;
+      source_store_entry->DecDeltaLeaderNum();
+      target_store_entry->IncDeltaLeaderNum();
+      return GenerateTransferLeaderTask(region.id(), source_store_entry->Id(), target_store_entry);
+    }
+  }
+
+  return nullptr;
+}
+
+bool BalanceLeaderScheduler::IsStoreCpuBusy(int64_t store_id) {
+  std::vector<pb::common::StoreMetrics> store_metrics;
+  coordinator_controller_->GetStoreRegionMetrics(store_id, store_metrics);
+  if (store_metrics.empty()) {
+    return false;
+  }
+
+  // system_cpu_usage is percent
+  int64_t cpu_usage = store_metrics[0].store_own_metrics().system_cpu_usage();
+  if (cpu_usage > FLAGS_balance_hot_leader_target_max_cpu_usage) {
+    if (tracker_) {
+      tracker_->GetLastRecord()->filter_records.push_back(
+          fmt::format("[filter.store({})] cpu usage({}) is too high", store_id, cpu_usage));
+    }
+    return true;
+  }
+
+  return false;
+}
+
 bool BalanceLeaderScheduler::FilterStore(dingodb::pb::common::Store& store) {
   for (auto& filter : store_filters_) {
     if (!filter->Check(store)) {
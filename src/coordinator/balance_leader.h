@@ -18,7 +18,9 @@
 #include <algorithm>
 #include <complex>
 #include <cstdint>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -145,6 +147,18 @@ class TaskFilter : public Filter {
   TrackerPtr tracker_;
 };
 
+// filter region whose leader is moved by hot leader balance recently, avoid flapping
+class HotRegionCooldownFilter : public Filter {
+ public:
+  HotRegionCooldownFilter(TrackerPtr tracker) : tracker_(tracker){};
+  ~HotRegionCooldownFilter() override = default;
+
+  bool Check(int64_t region_id) override;
+
+ private:
+  TrackerPtr tracker_;
+};
+
 // abstract store node, support calulate leader score
 class StoreEntry {
  public:
@@ -269,6 +283,12 @@ class BalanceLeaderScheduler {
   std::vector<TransferLeaderTaskPtr> Schedule(const pb::common::RegionMap& region_map,
                                               const pb::common::StoreMap& store_map);
 
+  // schedule hot leader balance generate transfer leader tasks
+  // move leader of hot region from the store with highest write load to its follower store with lower load,
+  // only when the store load exceed average by tolerance and the move not make target hotter than source.
+  std::vector<TransferLeaderTaskPtr> ScheduleHotLeader(const pb::common::RegionMap& region_map,
+                                                       const pb::common::StoreMap& store_map);
+
   // Just for unit test
   static std::vector<std::pair<int, int>> TestParseTimePeriod(const std::string& time_period) {
     return ParseTimePeriod(time_period);
@@ -313,6 +333,14 @@ class BalanceLeaderScheduler {
   TransferLeaderTaskPtr GenerateTransferInLeaderTask(CandidateStoresPtr candidate_stores,
                                                      const std::set<int64_t>& used_regions);
 
+  // pick hot leader region of source store and follower store with lowest load for transfer leader
+  TransferLeaderTaskPtr GenerateHotLeaderTask(CandidateStoresPtr candidate_stores, StoreEntryPtr source_store_entry,
+                                              std::map<int64_t, int64_t>& store_loads,
+                                              const std::set<int64_t>& used_regions);
+
+  // true: store cpu usage is too high to take more leader
+  bool IsStoreCpuBusy(int64_t store_id);
+
   // filter true: eliminate false: reserve
   bool FilterStore(dingodb::pb::common::Store& store);
 
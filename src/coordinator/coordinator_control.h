@@ -275,6 +275,14 @@ class CoordinatorControl : public MetaControl {
                                         const pb::common::IndexParameter &index_parameter,
                                         std::vector<int64_t> &store_ids);
 
+  // candidate stores ordered by load for scattering pre split regions, empty if not enough stores.
+  void GetPreSplitScatterStoreIds(pb::common::RegionType region_type, pb::common::RawEngine raw_engine,
+                                  int32_t replica_num, int64_t region_count,
+                                  const pb::common::IndexParameter &index_parameter, std::vector<int64_t> &store_ids);
+  // stores of the region_index-th pre split region, a window of replica_num rotating over candidate stores.
+  static std::vector<int64_t> RotatePreSplitStoreIds(const std::vector<int64_t> &scatter_store_ids, int32_t replica_num,
+                                                     int64_t region_index);
+
   butil::Status CreateRegionForSplit(const std::string &region_name, pb::common::RegionType region_type,
                                      const std::string &resource_tag, pb::common::Range region_range,
                                      int64_t split_from_region_id, int64_t &new_region_id,
@@ -790,6 +798,8 @@ class CoordinatorControl : public MetaControl {
 
   // functions below are for raft fsm
   bool IsLeader() override;                                            // for raft fsm
+  // leader, or follower allowed to serve bounded stale meta read.
+  bool CanServeRead();
   void SetLeaderTerm(int64_t term) override;                           // for raft fsm
   void OnLeaderStart(int64_t term) override;                           // for raft fsm
   void OnLeaderStop() override;                                        // for raft fsm
@@ -883,6 +893,8 @@ class CoordinatorControl : public MetaControl {
   // check if task in job can advance
   // if task advance, this function will contruct meta_increment and apply to state_machine
   butil::Status ProcessJobList();
+  // one round of ProcessJobList, has_progress is true when some job is advanced or region cmd is done
+  butil::Status ProcessJobListOnce(bool &has_progress);
 
   // process job
   butil::Status ProcessJob(const pb::coordinator::Job &job, pb::coordinator_internal::MetaIncrement &meta_increment,
@@ -894,6 +906,15 @@ class CoordinatorControl : public MetaControl {
 
   butil::Status SendStoreOperation(int64_t store_id, const pb::coordinator::StoreOperation &store_operation,
                                    pb::coordinator_internal::MetaIncrement &meta_increment);
+  // send store_operations to stores in parallel, then handle result in order
+  void SendStoreOperations(const std::vector<pb::coordinator::StoreOperation> &store_operations,
+                           pb::coordinator_internal::MetaIncrement &meta_increment);
+  butil::Status CheckStoreForSendStoreOperation(int64_t store_id, pb::common::Store &store);
+  butil::Status HandleSendStoreOperationResult(const pb::common::Store &store,
+                                               const pb::coordinator::StoreOperation &store_operation,
+                                               const butil::Status &rpc_status,
+                                               const pb::push::PushStoreOperationResponse &response,
+                                               pb::coordinator_internal::MetaIncrement &meta_increment);
 
   butil::Status GetStoreOperationOfCreateForSend(
       std::map<int64_t, pb::coordinator::StoreOperation> &store_operation_map,
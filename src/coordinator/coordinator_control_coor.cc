@@ -32,8 +32,10 @@
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/synchronization.h"
 #include "config/config_helper.h"
 #include "coordinator/coordinator_control.h"
+#include "coordinator/region_load_stat.h"
 #include "fmt/core.h"
 #include "fmt/format.h"
 #include "gflags/gflags.h"
@@ -79,6 +81,10 @@ DECLARE_int64(max_hnsw_memory_size_of_region);
 DECLARE_int32(max_hnsw_nlinks_of_region);
 
 DEFINE_int32(max_send_region_cmd_per_store, 100, "max send region cmd per store");
+DEFINE_int32(send_store_operation_concurrency, 16, "max concurrent rpc of sending store operation to stores");
+BRPC_VALIDATE_GFLAG(send_store_operation_concurrency, brpc::PositiveInteger);
+DEFINE_int32(job_process_max_round_per_tick, 3, "max round of advancing job list in one tick when job makes progress");
+BRPC_VALIDATE_GFLAG(job_process_max_round_per_tick, brpc::PositiveInteger);
 
 DEFINE_int64(max_region_count, 40000, "max region of dingo");
 BRPC_VALIDATE_GFLAG(max_region_count, brpc::PositiveInteger);
@@ -4521,6 +4527,12 @@ void CoordinatorControl::UpdateRegionMapAndStoreOperation(const pb::common::Stor
                     << store_metrics.region_metrics_map_size();
   }
 
+  // region_metrics_map_ is updated in one batch, every put of DingoSafeMap wait for all readers.
+  std::vector<int64_t> region_metrics_ids;
+  std::vector<pb::common::RegionMetrics> region_metrics_list;
+  region_metrics_ids.reserve(store_metrics.region_metrics_map_size());
+  region_metrics_list.reserve(store_metrics.region_metrics_map_size());
+
   // update region_map
   for (const auto& it : store_metrics.region_metrics_map()) {
     const auto& region_metrics = it.second;
@@ -4546,7 +4558,8 @@ void CoordinatorControl::UpdateRegionMapAndStoreOperation(const pb::common::Stor
     if (ret1 < 0) {
       region_metrics_to_update = region_metrics;
       *(region_metrics_to_update.mutable_region_status()) = GenRegionStatus(region_metrics);
-      region_metrics_map_.Put(region_metrics.id(), region_metrics_to_update);
+      region_metrics_ids.push_back(region_metrics.id());
+      region_metrics_list.push_back(region_metrics_to_update);
 
       DINGO_LOG(INFO) << "region_metrics_to_update is first time put into region_metrics_map_, region_id = "
                       << region_metrics.id() << ", from store_id: " << store_metrics.id();
@@ -4737,7 +4750,8 @@ void CoordinatorControl::UpdateRegionMapAndStoreOperation(const pb::common::Stor
 
       *(region_metrics_to_update.mutable_region_status()) = region_status_to_update;
 
-      region_metrics_map_.Put(region_metrics.id(), region_metrics_to_update);
+      region_metrics_ids.push_back(region_metrics.id());
+      region_metrics_list.push_back(region_metrics_to_update);
 
       DINGO_LOG(DEBUG) << "UpdateRegionMapAndStoreOperation region_metrics_map_ update region_id = "
                        << region_metrics.id() << " last_update_timestamp = "
@@ -4750,6 +4764,15 @@ void CoordinatorControl::UpdateRegionMapAndStoreOperation(const pb::common::Stor
       coordinator_bvar_metrics_region_.UpdateRegionBvar(region_metrics.id(), region_metrics.row_count(),
                                                         region_metrics.region_size());
     }
+
+    // write load for hot leader balance
+    if (!region_metrics_is_not_leader) {
+      RegionLoadStat::GetInstance().Update(region_metrics.id(), region_metrics.region_size());
+    }
+  }
+
+  if (!region_metrics_ids.empty()) {
+    region_metrics_map_.MultiPut(region_metrics_ids, region_metrics_list);
   }
 }
 
@@ -5740,6 +5763,19 @@ butil::Status CoordinatorControl::ProcessJobList() {
 
   AtomicGuard atomic_guard(is_processing_job_);
 
+  // job advance to next task in same tick when store operation is done, not wait next tick.
+  for (int round = 0; round < FLAGS_job_process_max_round_per_tick; ++round) {
+    bool has_progress = false;
+    auto status = ProcessJobListOnce(has_progress);
+    if (!status.ok() || !has_progress) {
+      return status;
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status CoordinatorControl::ProcessJobListOnce(bool& has_progress) {
   butil::FlatMap<int64_t, pb::coordinator::Job> job;
   job.init(100);
   GetJobAll(job);
@@ -5782,6 +5818,20 @@ butil::Status CoordinatorControl::ProcessJobList() {
     return butil::Status::OK();
   }
 
+  // job is deleted or advanced, or region cmd is done
+  for (const auto& job_increment : meta_increment.jobs()) {
+    if (job_increment.op_type() != pb::coordinator_internal::MetaIncrementOpType::MODIFY) {
+      has_progress = true;
+      break;
+    }
+    for (const auto& region_cmd_status : job_increment.region_cmds_status()) {
+      if (region_cmd_status.status() == pb::coordinator::RegionCmdStatus::STATUS_DONE) {
+        has_progress = true;
+        break;
+      }
+    }
+  }
+
   SubmitMetaIncrementSync(meta_increment);
 
   return butil::Status::OK();
@@ -6523,6 +6573,8 @@ butil::Status CoordinatorControl::UpdateJobProcess(const pb::coordinator_interna
 butil::Status CoordinatorControl::GetStoreOperationOfCreateForSend(
     std::map<int64_t, pb::coordinator::StoreOperation>& store_operation_map,
     pb::coordinator_internal::MetaIncrement& meta_increment) {
+  std::vector<pb::coordinator::StoreOperation> create_store_operations;
+  create_store_operations.reserve(store_operation_map.size());
   for (const auto& [store_id, store_operation] : store_operation_map) {
     pb::coordinator::StoreOperation create_store_operation;
     create_store_operation.set_store_id(store_id);
@@ -6533,20 +6585,19 @@ butil::Status CoordinatorControl::GetStoreOperationOfCreateForSend(
       *(create_store_operation.add_region_cmds()) = region_cmd;
     }
 
-    auto status = SendStoreOperation(store_id, create_store_operation, meta_increment);
-    if (!status.ok()) {
-      DINGO_LOG(ERROR) << fmt::format(
-          "[joblist] SendStoreOperation failed, error:{}, store_id:{}, create_store_operation:{}",
-          Helper::PrintStatus(status), store_id, create_store_operation.ShortDebugString());
-    }
+    create_store_operations.push_back(std::move(create_store_operation));
   }
 
+  SendStoreOperations(create_store_operations, meta_increment);
+
   return butil::Status::OK();
 }
 
 butil::Status CoordinatorControl::GetStoreOperationOfNotCreateForSend(
     std::map<int64_t, pb::coordinator::StoreOperation>& store_operation_map,
     pb::coordinator_internal::MetaIncrement& meta_increment) {
+  std::vector<pb::coordinator::StoreOperation> not_create_store_operations;
+  not_create_store_operations.reserve(store_operation_map.size());
   for (const auto& [store_id, store_operation] : store_operation_map) {
     pb::coordinator::StoreOperation not_create_store_operation;
     not_create_store_operation.set_store_id(store_id);
@@ -6571,32 +6622,92 @@ butil::Status CoordinatorControl::GetStoreOperationOfNotCreateForSend(
       *(not_create_store_operation.add_region_cmds()) = region_cmd;
     }
 
-    auto status = SendStoreOperation(store_id, not_create_store_operation, meta_increment);
-    if (!status.ok()) {
-      DINGO_LOG(ERROR) << fmt::format(
-          "[joblist] SendStoreOperation failed, error:{}, store_id:{}, not_create_store_operation:{}",
-          Helper::PrintStatus(status), store_id, not_create_store_operation.ShortDebugString());
-    }
+    not_create_store_operations.push_back(std::move(not_create_store_operation));
   }
 
+  SendStoreOperations(not_create_store_operations, meta_increment);
+
   return butil::Status::OK();
 }
 
-butil::Status CoordinatorControl::SendStoreOperation(int64_t store_id,
-                                                     const pb::coordinator::StoreOperation& store_operation,
-                                                     pb::coordinator_internal::MetaIncrement& meta_increment) {
-  auto store = GetStore(store_id);
+void CoordinatorControl::SendStoreOperations(const std::vector<pb::coordinator::StoreOperation>& store_operations,
+                                             pb::coordinator_internal::MetaIncrement& meta_increment) {
+  struct SendContext {
+    const pb::coordinator::StoreOperation* store_operation{nullptr};
+    pb::common::Store store;
+    pb::push::PushStoreOperationResponse response;
+    butil::Status status;
+  };
 
-  if (store.state() == pb::common::StoreState::STORE_NORMAL) {
-    if (store.last_seen_timestamp() + (FLAGS_store_heartbeat_timeout * 1000) < butil::gettimeofday_ms()) {
-      DINGO_LOG(WARNING) << fmt::format("[joblist] update store:{} state to offline", store.id());
+  // check store sequentially, it may update store state
+  std::vector<SendContext> send_contexts;
+  send_contexts.reserve(store_operations.size());
+  for (const auto& store_operation : store_operations) {
+    pb::common::Store store;
+    auto status = CheckStoreForSendStoreOperation(store_operation.store_id(), store);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[joblist] SendStoreOperation failed, error:{}, store_id:{}, store_operation:{}",
+                                      Helper::PrintStatus(status), store_operation.store_id(),
+                                      store_operation.ShortDebugString());
+      continue;
+    }
+    if (store_operation.region_cmds_size() <= 0) {
+      continue;
+    }
 
-      TrySetStoreToOffline(store.id());
+    SendContext send_context;
+    send_context.store_operation = &store_operation;
+    send_context.store = std::move(store);
+    send_contexts.push_back(std::move(send_context));
+  }
 
-      return butil::Status(pb::error::EINTERNAL, fmt::format("update store:{} state is offline", store.id()));
+  // send rpc to stores in parallel, a slow store not block others
+  std::atomic<size_t> next_index{0};
+  auto send_func = [&send_contexts, &next_index]() {
+    for (size_t i = next_index.fetch_add(1); i < send_contexts.size(); i = next_index.fetch_add(1)) {
+      auto& send_context = send_contexts[i];
+      DINGO_LOG(DEBUG) << "[joblist] send store_operation to store: " << send_context.store.id();
+
+      pb::push::PushStoreOperationRequest request;
+      *(request.mutable_store_operation()) = *send_context.store_operation;
+      send_context.status =
+          RpcSendPushStoreOperation(send_context.store.server_location(), request, send_context.response);
     }
+  };
+
+  size_t concurrency = std::min(send_contexts.size(), static_cast<size_t>(FLAGS_send_store_operation_concurrency));
+  if (concurrency <= 1) {
+    send_func();
   } else {
-    return butil::Status(pb::error::EINTERNAL, fmt::format("store:{} state is not STORE_NORMAL, ", store.id()));
+    std::vector<Bthread> bthreads;
+    bthreads.reserve(concurrency);
+    for (size_t i = 0; i < concurrency; ++i) {
+      bthreads.emplace_back(send_func);
+    }
+    for (auto& bthread : bthreads) {
+      bthread.Join();
+    }
+  }
+
+  // handle result sequentially, it update job and meta_increment
+  for (const auto& send_context : send_contexts) {
+    auto status = HandleSendStoreOperationResult(send_context.store, *send_context.store_operation,
+                                                 send_context.status, send_context.response, meta_increment);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[joblist] SendStoreOperation failed, error:{}, store_id:{}, store_operation:{}",
+                                      Helper::PrintStatus(status), send_context.store.id(),
+                                      send_context.store_operation->ShortDebugString());
+    }
+  }
+}
+
+butil::Status CoordinatorControl::SendStoreOperation(int64_t store_id,
+                                                     const pb::coordinator::StoreOperation& store_operation,
+                                                     pb::coordinator_internal::MetaIncrement& meta_increment) {
+  pb::common::Store store;
+  auto status = CheckStoreForSendStoreOperation(store_id, store);
+  if (!status.ok()) {
+    return status;
   }
 
   // send store_operation
@@ -6614,6 +6725,25 @@ butil::Status CoordinatorControl::SendStoreOperation(int64_t store_id,
 
   *(request.mutable_store_operation()) = store_operation;
 
+  status = RpcSendPushStoreOperation(store.server_location(), request, response);
+  return HandleSendStoreOperationResult(store, store_operation, status, response, meta_increment);
+}
+
+butil::Status CoordinatorControl::CheckStoreForSendStoreOperation(int64_t store_id, pb::common::Store& store) {
+  store = GetStore(store_id);
+
+  if (store.state() == pb::common::StoreState::STORE_NORMAL) {
+    if (store.last_seen_timestamp() + (FLAGS_store_heartbeat_timeout * 1000) < butil::gettimeofday_ms()) {
+      DINGO_LOG(WARNING) << fmt::format("[joblist] update store:{} state to offline", store.id());
+
+      TrySetStoreToOffline(store.id());
+
+      return butil::Status(pb::error::EINTERNAL, fmt::format("update store:{} state is offline", store.id()));
+    }
+  } else {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("store:{} state is not STORE_NORMAL, ", store.id()));
+  }
+
   // send rpcs
   if (!store.has_server_location()) {
     return butil::Status(pb::error::EINTERNAL, fmt::format("store:{} has no server_location", store.id()));
@@ -6624,14 +6754,20 @@ butil::Status CoordinatorControl::SendStoreOperation(int64_t store_id,
                                                            store.server_location().port()));
   }
 
-  auto status = RpcSendPushStoreOperation(store.server_location(), request, response);
-  if (status.error_code() == pb::error::Errno::ESEND_STORE_OPERATION_FAIL) {
+  return butil::Status::OK();
+}
+
+butil::Status CoordinatorControl::HandleSendStoreOperationResult(
+    const pb::common::Store& store, const pb::coordinator::StoreOperation& store_operation,
+    const butil::Status& rpc_status, const pb::push::PushStoreOperationResponse& response,
+    pb::coordinator_internal::MetaIncrement& meta_increment) {
+  if (rpc_status.error_code() == pb::error::Errno::ESEND_STORE_OPERATION_FAIL) {
     return butil::Status(pb::error::ESEND_STORE_OPERATION_FAIL,
                          fmt::format("send store_operation to store:{} failed", store.id()));
   }
 
   // check response
-  if (status.ok()) {
+  if (rpc_status.ok()) {
     pb::error::Error error;
     for (const auto& region_cmd : store_operation.region_cmds()) {
       auto status = UpdateTaskStatus(region_cmd.job_id(), region_cmd.id(),
@@ -22,8 +22,11 @@
 #include <utility>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "butil/status.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
+#include "common/gflag_validator.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "coordinator/coordinator_control.h"
@@ -43,8 +46,42 @@ namespace dingodb {
 DEFINE_int64(meta_revision_base, 0,
              "meta_revision base value, the real revision is meta_revision_base + applied_index");
 
+DEFINE_bool(enable_coordinator_follower_read, false,
+            "enable coordinator follower serve meta read, e.g. get tables and scan regions, when it catch up leader");
+DEFINE_validator(enable_coordinator_follower_read, &PassBool);
+DEFINE_int64(coordinator_follower_read_max_log_gap, 16,
+             "max gap of committed and applied log of coordinator follower serve meta read");
+BRPC_VALIDATE_GFLAG(coordinator_follower_read_max_log_gap, brpc::NonNegativeInteger);
+
+bvar::Adder<uint64_t> g_coordinator_follower_read_count("dingo_coordinator_follower_read_count");
+
 bool CoordinatorControl::IsLeader() { return leader_term_.load(butil::memory_order_acquire) > 0; }
 
+// Follower apply the same meta increment as leader, so its meta maps lag behind leader by the log not applied.
+bool CoordinatorControl::CanServeRead() {
+  if (IsLeader()) {
+    return true;
+  }
+
+  if (!FLAGS_enable_coordinator_follower_read || raft_node_ == nullptr) {
+    return false;
+  }
+
+  // follower without leader may be partitioned, its committed log is not trusted.
+  if (raft_node_->GetLeaderId().is_empty()) {
+    return false;
+  }
+
+  auto raft_status = raft_node_->GetStatus();
+  if (raft_status == nullptr || raft_status->committed_index() - raft_status->known_applied_index() >
+                                    FLAGS_coordinator_follower_read_max_log_gap) {
+    return false;
+  }
+
+  g_coordinator_follower_read_count << 1;
+  return true;
+}
+
 void CoordinatorControl::SetLeaderTerm(int64_t term) {
   DINGO_LOG(INFO) << "SetLeaderTerm, term=" << term;
   leader_term_.store(term, butil::memory_order_release);
@@ -184,9 +221,8 @@ bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapsh
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_id_epoch_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_id_epoch_map_kvs()->Swap(&kv);
   }
 
   DINGO_LOG(INFO) << "Snapshot id_epoch_meta, count=" << kvs.size();
@@ -197,9 +233,8 @@ bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapsh
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_coordinator_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_coordinator_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot coordinator_meta, count=" << kvs.size();
   kvs.clear();
@@ -209,9 +244,8 @@ bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapsh
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_store_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_store_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot store_meta, count=" << kvs.size();
   kvs.clear();
@@ -221,9 +255,8 @@ bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapsh
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_executor_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_executor_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot executor_meta, count=" << kvs.size();
   kvs.clear();
@@ -233,9 +266,8 @@ bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapsh
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_schema_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_schema_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot schema_meta, count=" << kvs.size();
   kvs.clear();
@@ -245,9 +277,8 @@ bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapsh
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_region_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_region_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot region_meta, count=" << kvs.size();
   kvs.clear();
@@ -257,9 +288,8 @@ bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapsh
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_deleted_region_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_deleted_region_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot deleted_region_meta, count=" << kvs.size();
   kvs.clear();
@@ -269,9 +299,8 @@ bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapsh
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_table_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_table_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot table_meta, count=" << kvs.size();
   kvs.clear();
@@ -281,9 +310,8 @@ bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapsh
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_deleted_table_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_deleted_table_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot deleted_table_meta, count=" << kvs.size();
   kvs.clear();
@@ -295,9 +323,8 @@ bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapsh
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_store_operation_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_store_operation_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot store_operation_meta_, count=" << kvs.size();
   kvs.clear();
@@ -306,9 +333,8 @@ bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapsh
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_region_cmd_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_region_cmd_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot region_cmd_meta_, count=" << kvs.size();
   kvs.clear();
@@ -318,9 +344,8 @@ bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapsh
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_executor_user_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_executor_user_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot executor_user_meta_, count=" << kvs.size();
   kvs.clear();
@@ -330,9 +355,8 @@ bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapsh
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_job_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_job_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot job_meta_, count=" << kvs.size();
   kvs.clear();
@@ -342,9 +366,8 @@ bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapsh
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_index_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_index_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot index_meta, count=" << kvs.size();
   kvs.clear();
@@ -354,9 +377,8 @@ bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapsh
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_deleted_index_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_deleted_index_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot deleted_index_meta, count=" << kvs.size();
   kvs.clear();
@@ -368,9 +390,8 @@ bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapsh
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_table_index_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_table_index_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot table_index_meta, count=" << kvs.size();
   kvs.clear();
@@ -380,9 +401,8 @@ bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapsh
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_common_disk_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_common_disk_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot common_disk_meta, count=" << kvs.size();
   kvs.clear();
@@ -392,9 +412,8 @@ bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapsh
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_common_mem_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_common_mem_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot common_mem_meta, count=" << kvs.size();
   kvs.clear();
@@ -404,9 +423,8 @@ bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapsh
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_tenant_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_tenant_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot tenant_mem_meta, count=" << kvs.size();
   kvs.clear();
@@ -422,8 +440,9 @@ bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Meta
   // 0.id_epoch map
   kvs.reserve(meta_snapshot_file.id_epoch_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.id_epoch_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.id_epoch_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_id_epoch_map_kvs(i)));
   }
+  meta_snapshot_file.clear_id_epoch_map_kvs();
   {
     // BAIDU_SCOPED_LOCK(id_epoch_map_mutex_);
     if (!id_epoch_meta_->Recover(kvs)) {
@@ -450,8 +469,9 @@ bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Meta
   // 1.coordinator map
   kvs.reserve(meta_snapshot_file.coordinator_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.coordinator_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.coordinator_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_coordinator_map_kvs(i)));
   }
+  meta_snapshot_file.clear_coordinator_map_kvs();
   {
     // BAIDU_SCOPED_LOCK(coordinator_map_mutex_);
     if (!coordinator_meta_->Recover(kvs)) {
@@ -478,8 +498,9 @@ bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Meta
   // 2.store map
   kvs.reserve(meta_snapshot_file.store_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.store_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.store_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_store_map_kvs(i)));
   }
+  meta_snapshot_file.clear_store_map_kvs();
   {
     // BAIDU_SCOPED_LOCK(store_map_mutex_);
     if (!store_meta_->Recover(kvs)) {
@@ -506,8 +527,9 @@ bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Meta
   // 3.executor map
   kvs.reserve(meta_snapshot_file.executor_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.executor_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.executor_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_executor_map_kvs(i)));
   }
+  meta_snapshot_file.clear_executor_map_kvs();
   {
     // BAIDU_SCOPED_LOCK(executor_map_mutex_);
     if (!executor_meta_->Recover(kvs)) {
@@ -534,8 +556,9 @@ bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Meta
   // 4.schema map
   kvs.reserve(meta_snapshot_file.schema_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.schema_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.schema_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_schema_map_kvs(i)));
   }
+  meta_snapshot_file.clear_schema_map_kvs();
   {
     // BAIDU_SCOPED_LOCK(schema_map_mutex_);
     if (!schema_meta_->Recover(kvs)) {
@@ -562,8 +585,9 @@ bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Meta
   // 5.region map
   kvs.reserve(meta_snapshot_file.region_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.region_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.region_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_region_map_kvs(i)));
   }
+  meta_snapshot_file.clear_region_map_kvs();
   {
     // BAIDU_SCOPED_LOCK(region_map_mutex_);
     if (!region_meta_->Recover(kvs)) {
@@ -590,8 +614,9 @@ bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Meta
   // 5.1 deleted region map
   kvs.reserve(meta_snapshot_file.deleted_region_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.deleted_region_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.deleted_region_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_deleted_region_map_kvs(i)));
   }
+  meta_snapshot_file.clear_deleted_region_map_kvs();
   {
     // BAIDU_SCOPED_LOCK(region_map_mutex_);
     // if (!deleted_region_meta_->Recover(kvs)) {
@@ -618,8 +643,9 @@ bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Meta
   // 6.table map
   kvs.reserve(meta_snapshot_file.table_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.table_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.table_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_table_map_kvs(i)));
   }
+  meta_snapshot_file.clear_table_map_kvs();
   {
     // BAIDU_SCOPED_LOCK(table_map_mutex_);
     if (!table_meta_->Recover(kvs)) {
@@ -646,8 +672,9 @@ bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Meta
   // 6.1 deleted table map
   kvs.reserve(meta_snapshot_file.deleted_table_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.deleted_table_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.deleted_table_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_deleted_table_map_kvs(i)));
   }
+  meta_snapshot_file.clear_deleted_table_map_kvs();
   {
     // BAIDU_SCOPED_LOCK(deleted_table_map_mutex_);
     // if (!deleted_table_meta_->Recover(kvs)) {
@@ -676,8 +703,9 @@ bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Meta
   // 9.store_operation map
   kvs.reserve(meta_snapshot_file.store_operation_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.store_operation_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.store_operation_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_store_operation_map_kvs(i)));
   }
+  meta_snapshot_file.clear_store_operation_map_kvs();
   {
     if (!store_operation_meta_->Recover(kvs)) {
       return false;
@@ -704,8 +732,9 @@ bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Meta
   // 9.1.region_cmd map
   kvs.reserve(meta_snapshot_file.region_cmd_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.region_cmd_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.region_cmd_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_region_cmd_map_kvs(i)));
   }
+  meta_snapshot_file.clear_region_cmd_map_kvs();
   {
     if (!region_cmd_meta_->Recover(kvs)) {
       return false;
@@ -732,8 +761,9 @@ bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Meta
   // 10.executor_user map
   kvs.reserve(meta_snapshot_file.executor_user_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.executor_user_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.executor_user_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_executor_user_map_kvs(i)));
   }
+  meta_snapshot_file.clear_executor_user_map_kvs();
   {
     if (!executor_user_meta_->Recover(kvs)) {
       return false;
@@ -759,8 +789,9 @@ bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Meta
   // 11.job map
   kvs.reserve(meta_snapshot_file.job_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.job_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.job_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_job_map_kvs(i)));
   }
+  meta_snapshot_file.clear_job_map_kvs();
   {
     if (!job_meta_->Recover(kvs)) {
       return false;
@@ -786,8 +817,9 @@ bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Meta
   // 12.index map
   kvs.reserve(meta_snapshot_file.index_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.index_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.index_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_index_map_kvs(i)));
   }
+  meta_snapshot_file.clear_index_map_kvs();
   {
     // BAIDU_SCOPED_LOCK(index_map_mutex_);
     if (!index_meta_->Recover(kvs)) {
@@ -814,8 +846,9 @@ bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Meta
   // 12.1 deleted_index map
   kvs.reserve(meta_snapshot_file.deleted_index_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.deleted_index_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.deleted_index_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_deleted_index_map_kvs(i)));
   }
+  meta_snapshot_file.clear_deleted_index_map_kvs();
   {
     // if (!deleted_index_meta_->Recover(kvs)) {
     //   return false;
@@ -843,8 +876,9 @@ bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Meta
   // 50.table_index map
   kvs.reserve(meta_snapshot_file.table_index_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.table_index_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.table_index_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_table_index_map_kvs(i)));
   }
+  meta_snapshot_file.clear_table_index_map_kvs();
   if (!table_index_meta_->Recover(kvs)) {
     return false;
   }
@@ -868,8 +902,9 @@ bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Meta
   // 51.1 common_disk_map
   kvs.reserve(meta_snapshot_file.common_disk_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.common_disk_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.common_disk_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_common_disk_map_kvs(i)));
   }
+  meta_snapshot_file.clear_common_disk_map_kvs();
   {
     // if (!common_disk_meta_->Recover(kvs)) {
     //   return false;
@@ -895,8 +930,9 @@ bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Meta
   // 51.2 common_mem_map
   kvs.reserve(meta_snapshot_file.common_mem_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.common_mem_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.common_mem_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_common_mem_map_kvs(i)));
   }
+  meta_snapshot_file.clear_common_mem_map_kvs();
   {
     // BAIDU_SCOPED_LOCK(common_mem_map_mutex_);
     if (!common_mem_meta_->Recover(kvs)) {
@@ -923,8 +959,9 @@ bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Meta
   // 52 tenant_mem_map
   kvs.reserve(meta_snapshot_file.tenant_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.tenant_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.tenant_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_tenant_map_kvs(i)));
   }
+  meta_snapshot_file.clear_tenant_map_kvs();
   {
     // BAIDU_SCOPED_LOCK(tenant_mem_map_mutex_);
     if (!tenant_meta_->Recover(kvs)) {
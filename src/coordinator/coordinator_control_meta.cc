@@ -17,6 +17,7 @@
 #include <cctype>
 #include <cstddef>
 #include <cstdint>
+#include <algorithm>
 #include <cstdlib>
 #include <nlohmann/json.hpp>
 #include <set>
@@ -69,6 +70,88 @@ BRPC_VALIDATE_GFLAG(enable_lite, brpc::PassValidate);
 
 DEFINE_bool(use_same_store_for_a_table, true, "use same store for a table");
 
+DEFINE_int64(max_pre_split_region_num_of_partition, 256, "max pre split region num of a partition when create");
+BRPC_VALIDATE_GFLAG(max_pre_split_region_num_of_partition, brpc::PositiveInteger);
+
+DEFINE_int32(max_pre_split_scatter_store_num, 16, "max store num to scatter pre split regions when create");
+BRPC_VALIDATE_GFLAG(max_pre_split_scatter_store_num, brpc::PositiveInteger);
+
+// key distribution hint in table properties, keys are hex encoded and comma separated.
+// explicit split keys is used first, otherwise split keys are quantiles of sampled keys.
+static const std::string kPreSplitKeysProperty = "pre_split_keys";
+static const std::string kPreSplitSampleKeysProperty = "pre_split_sample_keys";
+static const std::string kPreSplitRegionNumProperty = "pre_split_region_num";
+
+static std::vector<std::string> ParseHexKeys(const std::string& hex_keys) {
+  std::vector<std::string> hex_key_strs;
+  Helper::SplitString(hex_keys, ',', hex_key_strs);
+
+  std::vector<std::string> keys;
+  for (const auto& hex_key : hex_key_strs) {
+    if (!hex_key.empty()) {
+      keys.push_back(Helper::HexToString(hex_key));
+    }
+  }
+  return keys;
+}
+
+// Split range of one partition by distribution hint, only keys strictly inside the range are used.
+// Return the range itself when there is no hint.
+static std::vector<pb::common::Range> GenPreSplitRanges(
+    const google::protobuf::Map<std::string, std::string>& properties, const pb::common::Range& part_range) {
+  auto in_range = [&part_range](const std::string& key) {
+    return key > part_range.start_key() && key < part_range.end_key();
+  };
+
+  std::vector<std::string> split_keys;
+  auto it = properties.find(kPreSplitKeysProperty);
+  if (it != properties.end()) {
+    for (auto& key : ParseHexKeys(it->second)) {
+      if (in_range(key)) {
+        split_keys.push_back(std::move(key));
+      }
+    }
+  } else {
+    auto sample_it = properties.find(kPreSplitSampleKeysProperty);
+    auto num_it = properties.find(kPreSplitRegionNumProperty);
+    int64_t region_num = num_it != properties.end() ? std::strtoll(num_it->second.c_str(), nullptr, 10) : 0;
+    if (sample_it != properties.end() && region_num > 1) {
+      std::vector<std::string> samples;
+      for (auto& key : ParseHexKeys(sample_it->second)) {
+        if (in_range(key)) {
+          samples.push_back(std::move(key));
+        }
+      }
+      std::sort(samples.begin(), samples.end());
+
+      region_num = std::min(region_num, static_cast<int64_t>(samples.size()) + 1);
+      for (int64_t i = 1; i < region_num; ++i) {
+        split_keys.push_back(samples[i * samples.size() / region_num]);
+      }
+    }
+  }
+
+  std::sort(split_keys.begin(), split_keys.end());
+  split_keys.erase(std::unique(split_keys.begin(), split_keys.end()), split_keys.end());
+  if (split_keys.size() >= FLAGS_max_pre_split_region_num_of_partition) {
+    split_keys.resize(FLAGS_max_pre_split_region_num_of_partition - 1);
+  }
+
+  std::vector<pb::common::Range> ranges;
+  std::string start_key = part_range.start_key();
+  for (const auto& split_key : split_keys) {
+    auto& range = ranges.emplace_back();
+    range.set_start_key(start_key);
+    range.set_end_key(split_key);
+    start_key = split_key;
+  }
+  auto& range = ranges.emplace_back();
+  range.set_start_key(start_key);
+  range.set_end_key(part_range.end_key());
+
+  return ranges;
+}
+
 butil::Status CoordinatorControl::GenerateTableIdAndPartIds(int64_t schema_id, int64_t part_count,
                                                             pb::meta::EntityType entity_type,
                                                             pb::coordinator_internal::MetaIncrement& meta_increment,
@@ -545,6 +628,35 @@ butil::Status CoordinatorControl::ValidateMaxIndexCount() {
 // in: schema_id, table_definition
 // out: new_table_id, new_regin_ids meta_increment
 // return: 0 success, -1 failed
+void CoordinatorControl::GetPreSplitScatterStoreIds(pb::common::RegionType region_type,
+                                                    pb::common::RawEngine raw_engine, int32_t replica_num,
+                                                    int64_t region_count,
+                                                    const pb::common::IndexParameter& index_parameter,
+                                                    std::vector<int64_t>& store_ids) {
+  // try as many stores as possible, fallback to fewer stores when there is not enough stores.
+  int64_t store_num =
+      std::min(static_cast<int64_t>(FLAGS_max_pre_split_scatter_store_num), region_count + replica_num - 1);
+  for (; store_num > replica_num; --store_num) {
+    store_ids.clear();
+    auto ret = GetCreateRegionStoreIds(region_type, raw_engine, "", store_num, index_parameter, store_ids);
+    if (ret.ok()) {
+      DINGO_LOG(INFO) << fmt::format("[pre_split] scatter {} regions to {} stores", region_count, store_ids.size());
+      return;
+    }
+  }
+
+  store_ids.clear();
+}
+
+std::vector<int64_t> CoordinatorControl::RotatePreSplitStoreIds(const std::vector<int64_t>& scatter_store_ids,
+                                                                int32_t replica_num, int64_t region_index) {
+  std::vector<int64_t> store_ids;
+  for (int32_t i = 0; i < replica_num; ++i) {
+    store_ids.push_back(scatter_store_ids[(region_index + i) % scatter_store_ids.size()]);
+  }
+  return store_ids;
+}
+
 butil::Status CoordinatorControl::CreateTable(int64_t schema_id, const pb::meta::TableDefinition& table_definition,
                                               int64_t& new_table_id, std::vector<int64_t>& region_ids,
                                               pb::coordinator_internal::MetaIncrement& meta_increment) {
@@ -748,33 +860,54 @@ butil::Status CoordinatorControl::CreateTable(int64_t schema_id, const pb::meta:
     return ret4;
   }
 
+  // pre split partitions by key distribution hint
+  std::vector<std::vector<pb::common::Range>> new_region_ranges;
+  size_t new_region_count = 0;
+  for (const auto& new_part_range : new_part_ranges) {
+    new_region_ranges.push_back(GenPreSplitRanges(table_definition.properties(), new_part_range));
+    new_region_count += new_region_ranges.back().size();
+  }
+
+  // scatter pre split regions to more stores
+  std::vector<int64_t> scatter_store_ids;
+  if (new_region_count > new_part_ranges.size()) {
+    GetPreSplitScatterStoreIds(pb::common::RegionType::STORE_REGION, region_raw_engine_type, replica, new_region_count,
+                               index_parameter, scatter_store_ids);
+  }
+
   // for partitions
   for (int i = 0; i < new_part_ranges.size(); i++) {
-    int64_t new_region_id = 0;
     int64_t new_part_id = new_part_ids[i];
-    auto new_part_range = new_part_ranges[i];
 
     std::string const region_name = std::string("T_") + std::to_string(schema_id) + std::string("_") +
                                     table_definition.name() + std::string("_part_") + std::to_string(new_part_id);
 
-    std::vector<pb::coordinator::StoreOperation> store_operations;
-    auto ret = CreateRegionFinal(region_name, pb::common::RegionType::STORE_REGION, region_raw_engine_type,
-                                 region_store_engine_type, "", replica, new_part_range, schema_id, new_table_id, 0,
-                                 new_part_id, tenant_id, false, index_parameter, false, store_ids, 0, new_region_id,
-                                 store_operations, meta_increment);
-    if (!ret.ok()) {
-      DINGO_LOG(ERROR) << "CreateRegion failed in CreateTable table_name=" << table_definition.name()
-                       << ", table_definition:" << table_definition.ShortDebugString() << " ret: " << ret.error_str();
-      return ret;
-    }
-    CreateRegionWithJob(store_operations, meta_increment);
-    DINGO_LOG(INFO) << "CreateTable create region success, region_id=" << new_region_id;
+    for (const auto& new_region_range : new_region_ranges[i]) {
+      int64_t new_region_id = 0;
+      std::vector<int64_t> region_store_ids =
+          scatter_store_ids.empty() ? store_ids
+                                    : RotatePreSplitStoreIds(scatter_store_ids, replica, new_region_ids.size());
+
+      std::vector<pb::coordinator::StoreOperation> store_operations;
+      auto ret = CreateRegionFinal(region_name, pb::common::RegionType::STORE_REGION, region_raw_engine_type,
+                                   region_store_engine_type, "", replica, new_region_range, schema_id, new_table_id, 0,
+                                   new_part_id, tenant_id, false, index_parameter, false, region_store_ids, 0,
+                                   new_region_id, store_operations, meta_increment);
+      if (!ret.ok()) {
+        DINGO_LOG(ERROR) << "CreateRegion failed in CreateTable table_name=" << table_definition.name()
+                         << ", table_definition:" << table_definition.ShortDebugString()
+                         << " ret: " << ret.error_str();
+        return ret;
+      }
+      CreateRegionWithJob(store_operations, meta_increment);
+      DINGO_LOG(INFO) << "CreateTable create region success, region_id=" << new_region_id;
 
-    new_region_ids.push_back(new_region_id);
+      new_region_ids.push_back(new_region_id);
+    }
   }
 
-  if (new_region_ids.size() < new_part_ranges.size()) {
-    DINGO_LOG(ERROR) << "Not enough regions is created, drop residual regions need=" << new_part_ranges.size()
+  if (new_region_ids.size() < new_region_count) {
+    DINGO_LOG(ERROR) << "Not enough regions is created, drop residual regions need=" << new_region_count
                      << " created=" << new_region_ids.size();
     for (auto region_id_to_delete : new_region_ids) {
       auto ret = DropRegion(region_id_to_delete, meta_increment);
@@ -1418,31 +1551,51 @@ butil::Status CoordinatorControl::CreateIndex(int64_t schema_id, const pb::meta:
     }
   }
 
+  // pre split partitions by key distribution hint
+  std::vector<std::vector<pb::common::Range>> new_region_ranges;
+  size_t new_region_count = 0;
+  for (const auto& new_part_range : new_part_ranges) {
+    new_region_ranges.push_back(GenPreSplitRanges(table_definition.properties(), new_part_range));
+    new_region_count += new_region_ranges.back().size();
+  }
+
+  // scatter pre split regions to more stores
+  std::vector<int64_t> scatter_store_ids;
+  if (new_region_count > new_part_ranges.size()) {
+    GetPreSplitScatterStoreIds(region_type, region_raw_engine_type, replica, new_region_count,
+                               table_definition.index_parameter(), scatter_store_ids);
+  }
+
   for (int i = 0; i < new_part_ranges.size(); i++) {
-    int64_t new_region_id = 0;
     int64_t new_part_id = new_part_ids[i];
-    auto new_part_range = new_part_ranges[i];
 
     std::string const region_name = std::string("I_") + std::to_string(schema_id) + std::string("_") +
                                     table_definition.name() + std::string("_part_") + std::to_string(new_part_id);
 
-    std::vector<pb::coordinator::StoreOperation> store_operations;
-    auto ret = CreateRegionFinal(region_name, region_type, region_raw_engine_type, region_store_engine_type, "",
-                                 replica, new_part_range, schema_id, 0, new_index_id, new_part_id, tenant_id,
-                                 table_definition.has_index_parameter(), table_definition.index_parameter(), false,
-                                 store_ids, 0, new_region_id, store_operations, meta_increment);
-    if (!ret.ok()) {
-      DINGO_LOG(ERROR) << "CreateRegion failed in CreateIndex index_name=" << table_definition.name();
-      return ret;
-    }
-    CreateRegionWithJob(store_operations, meta_increment);
-    DINGO_LOG(INFO) << "CreateIndex create region success, region_id=" << new_region_id;
+    for (const auto& new_region_range : new_region_ranges[i]) {
+      int64_t new_region_id = 0;
+      std::vector<int64_t> region_store_ids =
+          scatter_store_ids.empty() ? store_ids
+                                    : RotatePreSplitStoreIds(scatter_store_ids, replica, new_region_ids.size());
 
-    new_region_ids.push_back(new_region_id);
+      std::vector<pb::coordinator::StoreOperation> store_operations;
+      auto ret = CreateRegionFinal(region_name, region_type, region_raw_engine_type, region_store_engine_type, "",
+                                   replica, new_region_range, schema_id, 0, new_index_id, new_part_id, tenant_id,
+                                   table_definition.has_index_parameter(), table_definition.index_parameter(), false,
+                                   region_store_ids, 0, new_region_id, store_operations, meta_increment);
+      if (!ret.ok()) {
+        DINGO_LOG(ERROR) << "CreateRegion failed in CreateIndex index_name=" << table_definition.name();
+        return ret;
+      }
+      CreateRegionWithJob(store_operations, meta_increment);
+      DINGO_LOG(INFO) << "CreateIndex create region success, region_id=" << new_region_id;
+
+      new_region_ids.push_back(new_region_id);
+    }
   }
 
-  if (new_region_ids.size() < new_part_ranges.size()) {
-    DINGO_LOG(ERROR) << "Not enough regions is created, drop residual regions need=" << new_part_ranges.size()
+  if (new_region_ids.size() < new_region_count) {
+    DINGO_LOG(ERROR) << "Not enough regions is created, drop residual regions need=" << new_region_count
                      << " created=" << new_region_ids.size();
     for (auto region_id_to_delete : new_region_ids) {
       auto ret = DropRegion(region_id_to_delete, meta_increment);
@@ -61,7 +61,8 @@ class CoordinatorInteraction {
   template <typename Request, typename Response>
   butil::Status SendRequest(const std::string& api_name, const Request& request, Response& response,
                             int64_t time_out_ms = 60000,
-                            pb::common::CoordinatorServiceType service_type = pb::common::ServiceTypeCoordinator);
+                            pb::common::CoordinatorServiceType service_type = pb::common::ServiceTypeCoordinator,
+                            brpc::CompressType compress_type = brpc::COMPRESS_TYPE_NONE);
 
   template <typename Request, typename Response>
   butil::Status SendRequest(pb::common::CoordinatorServiceType service_type, const std::string& api_name,
@@ -87,10 +88,12 @@ class CoordinatorInteraction {
 
   template <typename Request, typename Response>
   butil::Status SendRequestByList(const std::string& api_name, const Request& request, Response& response,
-                                  int64_t time_out_ms, pb::common::CoordinatorServiceType service_type);
+                                  int64_t time_out_ms, pb::common::CoordinatorServiceType service_type,
+                                  brpc::CompressType compress_type);
   template <typename Request, typename Response>
   butil::Status SendRequestByService(const std::string& api_name, const Request& request, Response& response,
-                                     int64_t time_out_ms, pb::common::CoordinatorServiceType service_type);
+                                     int64_t time_out_ms, pb::common::CoordinatorServiceType service_type,
+                                     brpc::CompressType compress_type);
 };
 
 using CoordinatorInteractionPtr = std::shared_ptr<CoordinatorInteraction>;
@@ -98,18 +101,20 @@ using CoordinatorInteractionPtr = std::shared_ptr<CoordinatorInteraction>;
 template <typename Request, typename Response>
 butil::Status CoordinatorInteraction::SendRequest(const std::string& api_name, const Request& request,
                                                   Response& response, int64_t time_out_ms,
-                                                  pb::common::CoordinatorServiceType service_type) {
+                                                  pb::common::CoordinatorServiceType service_type,
+                                                  brpc::CompressType compress_type) {
   if (use_service_name_) {
-    return SendRequestByService(api_name, request, response, time_out_ms, service_type);
+    return SendRequestByService(api_name, request, response, time_out_ms, service_type, compress_type);
   } else {
-    return SendRequestByList(api_name, request, response, time_out_ms, service_type);
+    return SendRequestByList(api_name, request, response, time_out_ms, service_type, compress_type);
   }
 }
 
 template <typename Request, typename Response>
 butil::Status CoordinatorInteraction::SendRequestByService(const std::string& api_name, const Request& request,
                                                            Response& response, int64_t time_out_ms,
-                                                           pb::common::CoordinatorServiceType service_type) {
+                                                           pb::common::CoordinatorServiceType service_type,
+                                                           brpc::CompressType compress_type) {
   const ::google::protobuf::ServiceDescriptor* service_desc = GetServiceDescriptor(service_type);
   if (service_desc == nullptr) {
     return butil::Status(pb::error::ENOT_SUPPORT, "Service type not found");
@@ -126,6 +131,7 @@ butil::Status CoordinatorInteraction::SendRequestByService(const std::string& ap
     brpc::Controller cntl;
     cntl.set_log_id(butil::fast_rand());
     cntl.set_timeout_ms(time_out_ms);
+    cntl.set_request_compress_type(compress_type);
 
     butil::EndPoint leader_addr;
     {
@@ -238,7 +244,8 @@ butil::Status CoordinatorInteraction::SendRequestByService(const std::string& ap
 template <typename Request, typename Response>
 butil::Status CoordinatorInteraction::SendRequestByList(const std::string& api_name, const Request& request,
                                                         Response& response, int64_t time_out_ms,
-                                                        pb::common::CoordinatorServiceType service_type) {
+                                                        pb::common::CoordinatorServiceType service_type,
+                                                        brpc::CompressType compress_type) {
   const ::google::protobuf::ServiceDescriptor* service_desc = GetServiceDescriptor(service_type);
   if (service_desc == nullptr) {
     return butil::Status(pb::error::ENOT_SUPPORT, "Service type not found");
@@ -255,6 +262,7 @@ butil::Status CoordinatorInteraction::SendRequestByList(const std::string& api_n
     brpc::Controller cntl;
     cntl.set_log_id(butil::fast_rand());
     cntl.set_timeout_ms(time_out_ms);
+    cntl.set_request_compress_type(compress_type);
 
     const int leader_index = GetLeader();
     channels_[leader_index]->CallMethod(method, &cntl, &request, &response, nullptr);
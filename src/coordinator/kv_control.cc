@@ -41,7 +41,6 @@ KvControl::KvControl(std::shared_ptr<MetaReader> meta_reader, std::shared_ptr<Me
     : meta_reader_(meta_reader), meta_writer_(meta_writer), leader_term_(-1), raw_engine_of_meta_(raw_engine_of_meta) {
   // init bthread mutex
   bthread_mutex_init(&lease_to_key_map_mutex_, nullptr);
-  bthread_mutex_init(&one_time_watch_map_mutex_, nullptr);
   leader_term_.store(-1, butil::memory_order_release);
 
   // the data structure below will write to raft
@@ -114,6 +114,17 @@ class DeferDone {
   int64_t create_time_;
 };
 
+// one shard of one time watch, shard is chosen by watch key, and closure id is encoded with shard index,
+// so watch and trigger of different keys not contend on one mutex.
+struct KvWatchShard {
+  KvWatchShard() { bthread_mutex_init(&mutex, nullptr); }
+  ~KvWatchShard() { bthread_mutex_destroy(&mutex); }
+
+  bthread_mutex_t mutex;
+  std::map<std::string, std::map<uint64_t, KvWatchNode>> watch_map;
+  std::map<uint64_t, DeferDone> closure_map;
+};
+
 struct KvLeaseWithKeys {
   pb::coordinator_internal::LeaseInternal lease;
   std::set<std::string> keys;
@@ -320,6 +331,7 @@ class KvControl : public MetaControl {
   // remove watch from map
   butil::Status RemoveOneTimeWatch();
   butil::Status RemoveOneTimeWatch(uint64_t closure_id);
+  // caller must hold mutex of the shard of closure_id
   butil::Status RemoveOneTimeWatchWithLock(uint64_t closure_id);
   butil::Status CancelOneTimeWatchClosure(uint64_t closure_id);
 
@@ -352,11 +364,17 @@ class KvControl : public MetaControl {
   // 16.version kv multi revision
   MetaDiskMap<pb::coordinator_internal::KvRevInternal> *kv_rev_meta_;
 
+  KvWatchShard &GetWatchShardByKey(const std::string &watch_key);
+  KvWatchShard &GetWatchShardByClosureId(uint64_t closure_id);
+  // clear all watches, run done if need_done
+  void ClearOneTimeWatch(bool need_done);
+
   // one time watch map
   // this map on work on leader, is out of state machine
-  std::map<std::string, std::map<uint64_t, KvWatchNode>> one_time_watch_map_;
-  bthread_mutex_t one_time_watch_map_mutex_;
-  std::map<uint64_t, DeferDone> one_time_watch_closure_map_;
+  static constexpr uint32_t kWatchShardNum = 16;
+  KvWatchShard one_time_watch_shards_[kWatchShardNum];
+  // count of watched keys of all shards
+  std::atomic<int64_t> one_time_watch_key_count_{0};
   std::atomic<uint64_t> one_time_watch_closure_seq_{1000};  // used to generate unique closure id
   DingoSafeStdMap<uint64_t, bool> one_time_watch_closure_status_map_;
 
@@ -80,12 +80,7 @@ void KvControl::OnLeaderStart(int64_t term) {
   // this above operation may cause dead lock, so we do this build process in LeaseTask
 
   // clear one time watch map
-  one_time_watch_closure_status_map_.Clear();
-  {
-    BAIDU_SCOPED_LOCK(one_time_watch_map_mutex_);
-    one_time_watch_map_.clear();
-    one_time_watch_closure_map_.clear();
-  }
+  ClearOneTimeWatch(false);
   DINGO_LOG(INFO) << "OnLeaderStart clear one_time_watch_map_, term=" << term;
 
   DINGO_LOG(INFO) << "OnLeaderStart finished, term=" << term;
@@ -94,17 +89,7 @@ void KvControl::OnLeaderStart(int64_t term) {
 void KvControl::OnLeaderStop() {
   DINGO_LOG(INFO) << "OnLeaderStop start";
   // clear one time watch map
-  one_time_watch_closure_status_map_.Clear();
-  {
-    BAIDU_SCOPED_LOCK(one_time_watch_map_mutex_);
-
-    for (auto& it : one_time_watch_closure_map_) {
-      it.second.Done();
-    }
-
-    one_time_watch_map_.clear();
-    one_time_watch_closure_map_.clear();
-  }
+  ClearOneTimeWatch(true);
   DINGO_LOG(INFO) << "OnLeaderStop clear one_time_watch_map_";
 
   DINGO_LOG(INFO) << "OnLeaderStop finished";
@@ -126,9 +111,8 @@ bool KvControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapshot,
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_id_epoch_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_id_epoch_map_kvs()->Swap(&kv);
   }
 
   DINGO_LOG(INFO) << "Snapshot id_epoch_meta, count=" << kvs.size();
@@ -139,9 +123,8 @@ bool KvControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapshot,
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_lease_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_lease_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot lease_map_, count=" << kvs.size();
   kvs.clear();
@@ -151,9 +134,8 @@ bool KvControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapshot,
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_kv_index_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_kv_index_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot kv_index_map_, count=" << kvs.size();
   kvs.clear();
@@ -163,9 +145,8 @@ bool KvControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapshot,
     return false;
   }
 
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_kv_rev_map_kvs();
-    *snapshot_file_kv = kv;
+  for (auto& kv : kvs) {
+    meta_snapshot_file.add_kv_rev_map_kvs()->Swap(&kv);
   }
   DINGO_LOG(INFO) << "Snapshot version_kv_rev_map_, count=" << kvs.size();
   kvs.clear();
@@ -181,8 +162,9 @@ bool KvControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::MetaSnapshotF
   // 0.id_epoch map
   kvs.reserve(meta_snapshot_file.id_epoch_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.id_epoch_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.id_epoch_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_id_epoch_map_kvs(i)));
   }
+  meta_snapshot_file.clear_id_epoch_map_kvs();
   {
     // BAIDU_SCOPED_LOCK(id_epoch_map_mutex_);
     if (!id_epoch_meta_->Recover(kvs)) {
@@ -209,8 +191,9 @@ bool KvControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::MetaSnapshotF
   // 14.lease_map_
   kvs.reserve(meta_snapshot_file.lease_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.lease_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.lease_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_lease_map_kvs(i)));
   }
+  meta_snapshot_file.clear_lease_map_kvs();
   {
     // BAIDU_SCOPED_LOCK(lease_map_mutex_);
     if (!kv_lease_meta_->Recover(kvs)) {
@@ -237,8 +220,9 @@ bool KvControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::MetaSnapshotF
   // 15.kv_index_map_
   kvs.reserve(meta_snapshot_file.kv_index_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.kv_index_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.kv_index_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_kv_index_map_kvs(i)));
   }
+  meta_snapshot_file.clear_kv_index_map_kvs();
   {
     if (!kv_index_meta_->Recover(kvs)) {
       return false;
@@ -264,8 +248,9 @@ bool KvControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::MetaSnapshotF
   // 16.kv_rev_map_
   kvs.reserve(meta_snapshot_file.kv_rev_map_kvs_size());
   for (int i = 0; i < meta_snapshot_file.kv_rev_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.kv_rev_map_kvs(i));
+    kvs.push_back(std::move(*meta_snapshot_file.mutable_kv_rev_map_kvs(i)));
   }
+  meta_snapshot_file.clear_kv_rev_map_kvs();
   {
     // if (!kv_rev_meta_->Recover(kvs)) {
     //   return false;
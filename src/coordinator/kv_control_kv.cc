@@ -717,9 +717,10 @@ butil::Status KvControl::KvPutApply(const std::string &key,
       << "), kv_index: " << kv_index.ShortDebugString();
 
   // trigger watch
-  if (!one_time_watch_map_.empty()) {
-    DINGO_LOG(INFO) << "KvPutApply one_time_watch_map_ is not empty, will trigger watch, key: " << key << "("
-                    << Helper::StringToHex(key) << "), watch size: " << one_time_watch_map_.size();
+  if (one_time_watch_key_count_.load(std::memory_order_relaxed) > 0) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_kv)
+        << "KvPutApply one_time_watch_map_ is not empty, will trigger watch, key: " << key << "("
+        << Helper::StringToHex(key) << "), watch key count: " << one_time_watch_key_count_.load();
 
     if (prev_kv.create_revision() > 0) {
       prev_kv.set_lease(kv_rev_last.kv().lease());
@@ -859,9 +860,10 @@ butil::Status KvControl::KvDeleteApply(const std::string &key,
       << "), revision: " << op_revision.ShortDebugString();
 
   // trigger watch
-  if (!one_time_watch_map_.empty()) {
-    DINGO_LOG(INFO) << "KvDeleteApply one_time_watch_map_ is not empty, will trigger watch, key: " << key << "("
-                    << Helper::StringToHex(key) << "), watch size: " << one_time_watch_map_.size();
+  if (one_time_watch_key_count_.load(std::memory_order_relaxed) > 0) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_kv)
+        << "KvDeleteApply one_time_watch_map_ is not empty, will trigger watch, key: " << key << "("
+        << Helper::StringToHex(key) << "), watch key count: " << one_time_watch_key_count_.load();
 
     if (prev_kv.create_revision() > 0) {
       prev_kv.set_lease(kv_rev_last.kv().lease());
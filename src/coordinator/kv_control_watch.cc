@@ -15,6 +15,7 @@
 #include <sys/types.h>
 
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -25,6 +26,7 @@
 #include "butil/status.h"
 #include "butil/time.h"
 #include "common/logging.h"
+#include "common/synchronization.h"
 #include "coordinator/kv_control.h"
 #include "gflags/gflags.h"
 #include "proto/coordinator_internal.pb.h"
@@ -38,6 +40,30 @@ BRPC_VALIDATE_GFLAG(version_watch_max_count, brpc::NonNegativeInteger);
 DEFINE_bool(dingo_log_switch_coor_watch, false, "switch for dingo log of kv control lease");
 BRPC_VALIDATE_GFLAG(dingo_log_switch_coor_watch, brpc::PassValidate);
 
+KvWatchShard& KvControl::GetWatchShardByKey(const std::string& watch_key) {
+  return one_time_watch_shards_[std::hash<std::string>{}(watch_key) % kWatchShardNum];
+}
+
+KvWatchShard& KvControl::GetWatchShardByClosureId(uint64_t closure_id) {
+  return one_time_watch_shards_[closure_id % kWatchShardNum];
+}
+
+void KvControl::ClearOneTimeWatch(bool need_done) {
+  one_time_watch_closure_status_map_.Clear();
+  for (auto& shard : one_time_watch_shards_) {
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    if (need_done) {
+      for (auto& it : shard.closure_map) {
+        it.second.Done();
+      }
+    }
+
+    one_time_watch_key_count_.fetch_sub(shard.watch_map.size(), std::memory_order_relaxed);
+    shard.watch_map.clear();
+    shard.closure_map.clear();
+  }
+}
+
 void WatchCancelCallback(KvControl* kv_control, uint64_t closure_id) {
   kv_control->CancelOneTimeWatchClosure(closure_id);
   // kv_control->RemoveOneTimeWatch(closure_id);
@@ -54,14 +80,15 @@ butil::Status KvControl::OneTimeWatch(const std::string& watch_key, int64_t star
                   << ", no_delete_event:" << no_delete_event << ", need_prev_kv:" << need_prev_kv
                   << ", wait_on_not_exist_key:" << wait_on_not_exist_key << ", done:" << done;
 
-  BAIDU_SCOPED_LOCK(one_time_watch_map_mutex_);
+  auto& shard = GetWatchShardByKey(watch_key);
+  BAIDU_SCOPED_LOCK(shard.mutex);
 
-  if (one_time_watch_map_.size() > FLAGS_version_watch_max_count) {
+  if (one_time_watch_key_count_.load(std::memory_order_relaxed) > FLAGS_version_watch_max_count) {
     DINGO_LOG(ERROR) << "OneTimeWatch, one_time_watch_map_.size() > FLAGS_version_watch_max_count, watch_key:"
                      << watch_key << ", start_revision:" << start_revision << ", no_put_event:" << no_put_event
                      << ", no_delete_event:" << no_delete_event << ", need_prev_kv:" << need_prev_kv
                      << ", wait_on_not_exist_key:" << wait_on_not_exist_key << ", done:" << done
-                     << ", one_time_watch_map_.size:" << one_time_watch_map_.size();
+                     << ", one_time_watch_map_.size:" << one_time_watch_key_count_.load();
     return butil::Status(pb::error::Errno::EWATCH_COUNT_EXCEEDS_LIMIT,
                          "OneTimeWatch, one_time_watch_map_.size() > FLAGS_version_watch_max_count");
   }
@@ -101,12 +128,14 @@ butil::Status KvControl::OneTimeWatch(const std::string& watch_key, int64_t star
   }
 
   // add to watch
-  auto closure_id = one_time_watch_closure_seq_.fetch_add(1, std::memory_order_relaxed);
+  // closure id is encoded with shard index
+  auto closure_id = one_time_watch_closure_seq_.fetch_add(1, std::memory_order_relaxed) * kWatchShardNum +
+                    (&shard - one_time_watch_shards_);
   DeferDone defer_done(closure_id, watch_key, done_guard.release(), response);
 
   // add defer_done to done_map
   one_time_watch_closure_status_map_.Put(closure_id, false);
-  one_time_watch_closure_map_.insert_or_assign(closure_id, defer_done);
+  shard.closure_map.insert_or_assign(closure_id, defer_done);
 
   AddOneTimeWatch(watch_key, start_revision, no_put_event, no_delete_event, need_prev_kv, closure_id);
 
@@ -116,7 +145,7 @@ butil::Status KvControl::OneTimeWatch(const std::string& watch_key, int64_t star
   return butil::Status::OK();
 }
 
-// caller must hold one_time_watch_map_mutex_
+// caller must hold mutex of the shard of watch_key
 butil::Status KvControl::AddOneTimeWatch(const std::string& watch_key, int64_t start_revision, bool no_put_event,
                                          bool no_delete_event, bool need_prev_kv, uint64_t closure_id) {
   // add to watch
@@ -127,11 +156,13 @@ butil::Status KvControl::AddOneTimeWatch(const std::string& watch_key, int64_t s
                   << ", no_delete_event:" << no_delete_event << ", need_prev_kv:" << need_prev_kv
                   << ", closure_id:" << closure_id;
 
-  auto it = one_time_watch_map_.find(watch_key);
-  if (it == one_time_watch_map_.end()) {
+  auto& watch_map = GetWatchShardByKey(watch_key).watch_map;
+  auto it = watch_map.find(watch_key);
+  if (it == watch_map.end()) {
     std::map<uint64_t, KvWatchNode> watch_node_map;
     watch_node_map.insert_or_assign(closure_id, watch_node);
-    one_time_watch_map_.insert_or_assign(watch_key, watch_node_map);
+    watch_map.insert_or_assign(watch_key, watch_node_map);
+    one_time_watch_key_count_.fetch_add(1, std::memory_order_relaxed);
     DINGO_LOG(INFO) << "AddOneTimeWatch, watch_key not found, insert, watch_key:" << watch_key
                     << ", hex_key: " << Helper::StringToHex(watch_key)
                     << ", watch_node_map.size:" << watch_node_map.size();
@@ -149,8 +180,9 @@ butil::Status KvControl::AddOneTimeWatch(const std::string& watch_key, int64_t s
 butil::Status KvControl::RemoveOneTimeWatchWithLock(uint64_t closure_id) {
   one_time_watch_closure_status_map_.Erase(closure_id);
 
-  auto it_defer_done = one_time_watch_closure_map_.find(closure_id);
-  if (it_defer_done == one_time_watch_closure_map_.end()) {
+  auto& shard = GetWatchShardByClosureId(closure_id);
+  auto it_defer_done = shard.closure_map.find(closure_id);
+  if (it_defer_done == shard.closure_map.end()) {
     DINGO_LOG(INFO) << "RemoveOneTimeWatch not found, closure_id:" << closure_id;
     return butil::Status(EINVAL, "RemoveOneTimeWatch not found");
   }
@@ -169,8 +201,8 @@ butil::Status KvControl::RemoveOneTimeWatchWithLock(uint64_t closure_id) {
     return butil::Status(EINVAL, "RemoveOneTimeWatch watch_key is empty");
   }
 
-  auto it_watch_key = one_time_watch_map_.find(watch_key);
-  if (it_watch_key == one_time_watch_map_.end()) {
+  auto it_watch_key = shard.watch_map.find(watch_key);
+  if (it_watch_key == shard.watch_map.end()) {
     DINGO_LOG(ERROR) << "RemoveOneTimeWatch watch_key not found, closure_id:" << closure_id
                      << ", watch_key:" << watch_key << ", remove from one_time_watch_closure_map_";
     return butil::Status(EINVAL, "RemoveOneTimeWatch watch_key not found");
@@ -190,7 +222,8 @@ butil::Status KvControl::RemoveOneTimeWatchWithLock(uint64_t closure_id) {
 
   if (watch_node_map.empty()) {
     DINGO_LOG(INFO) << "RemoveOneTimeWatch, watch_node_map is empty, watch_key:" << watch_key;
-    one_time_watch_map_.erase(it_watch_key);
+    shard.watch_map.erase(it_watch_key);
+    one_time_watch_key_count_.fetch_sub(1, std::memory_order_relaxed);
   }
 
   return butil::Status::OK();
@@ -218,8 +251,6 @@ butil::Status KvControl::RemoveOneTimeWatch() {
 
   DINGO_LOG(INFO) << "CRONTAB RemoveOneTimeWatch, closure_status_map.size:" << closure_status_map.size();
 
-  BAIDU_SCOPED_LOCK(one_time_watch_map_mutex_);
-
   int64_t start_ts = butil::gettimeofday_ms();
   int64_t count = 0;
   for (auto& it : closure_status_map) {
@@ -231,6 +262,8 @@ butil::Status KvControl::RemoveOneTimeWatch() {
 
     DINGO_LOG(INFO) << "CRONTAB RemoveOneTimeWatch, closure_id:" << closure_id;
 
+    auto& shard = GetWatchShardByClosureId(closure_id);
+    BAIDU_SCOPED_LOCK(shard.mutex);
     auto ret = RemoveOneTimeWatchWithLock(closure_id);
     if (ret.ok()) {
       DINGO_LOG(INFO) << "CRONTAB RemoveOneTimeWatchWithLock success, closure_id:" << closure_id;
@@ -248,7 +281,8 @@ butil::Status KvControl::RemoveOneTimeWatch(uint64_t closure_id) {
   DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch) << "RemoveOneTimeWatch closure_id:" << closure_id;
 
   int64_t start_ts = butil::gettimeofday_ms();
-  auto ret1 = bthread_mutex_trylock(&one_time_watch_map_mutex_);
+  auto& shard = GetWatchShardByClosureId(closure_id);
+  auto ret1 = bthread_mutex_trylock(&shard.mutex);
   if (ret1 != 0) {
     DINGO_LOG(WARNING) << "RemoveOneTimeWatch, bthread_mutex_trylock failed, closure_id:" << closure_id
                        << ", ret1:" << ret1 << ", cost: " << butil::gettimeofday_ms() - start_ts << " ms";
@@ -263,107 +297,85 @@ butil::Status KvControl::RemoveOneTimeWatch(uint64_t closure_id) {
                      << ", errcode: " << ret.error_code() << ", errmsg: " << ret.error_str();
   }
 
-  bthread_mutex_unlock(&one_time_watch_map_mutex_);
+  bthread_mutex_unlock(&shard.mutex);
 
   return butil::Status::OK();
 }
 
 butil::Status KvControl::TriggerOneWatch(const std::string& key, pb::version::Event::EventType event_type,
                                          pb::version::Kv& new_kv, pb::version::Kv& prev_kv) {
-  DINGO_LOG(INFO) << "TriggerOneWatch, key:" << key << ", event_type:" << event_type
-                  << ", new_kv:" << new_kv.ShortDebugString() << ", prev_kv:" << prev_kv.ShortDebugString();
-
-  BAIDU_SCOPED_LOCK(one_time_watch_map_mutex_);
-
-  auto it = one_time_watch_map_.find(key);
-  if (it == one_time_watch_map_.end()) {
-    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch) << "TriggerOneWatch not found, key:" << key;
-    return butil::Status::OK();
-  }
-
-  auto& watch_node_map = it->second;
-
   DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
-      << "TriggerOneWatch, key:" << key << ", watch_node_map.size:" << watch_node_map.size();
-
-  std::vector<uint64_t> done_list;
-  for (auto& watch_node : watch_node_map) {
-    if (watch_node.second.no_put_event && event_type == pb::version::Event::EventType::Event_EventType_PUT) {
-      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch) << "TriggerOneWatch skip, no_put_event, key:" << key;
-      continue;
+      << "TriggerOneWatch, key:" << key << ", event_type:" << event_type << ", new_kv:" << new_kv.ShortDebugString()
+      << ", prev_kv:" << prev_kv.ShortDebugString();
+
+  // take out triggered watches under lock, fill response and run done in background,
+  // so apply is not blocked by many watchers of one key.
+  std::vector<std::pair<DeferDone, bool>> defer_dones;
+  {
+    auto& shard = GetWatchShardByKey(key);
+    BAIDU_SCOPED_LOCK(shard.mutex);
+
+    auto it = shard.watch_map.find(key);
+    if (it == shard.watch_map.end()) {
+      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch) << "TriggerOneWatch not found, key:" << key;
+      return butil::Status::OK();
     }
 
-    if (watch_node.second.no_delete_event && event_type == pb::version::Event::EventType::Event_EventType_DELETE) {
-      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch) << "TriggerOneWatch skip, no_delete_event, key:" << key;
-      continue;
-    }
+    auto& watch_node_map = it->second;
 
-    if (watch_node.second.start_revision > new_kv.mod_revision()) {
-      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
-          << "TriggerOneWatch skip, start_revision > new_kv.mod_revision(), key:" << key
-          << ", start_revision:" << watch_node.second.start_revision
-          << ", new_kv.mod_revision:" << new_kv.mod_revision();
-      continue;
-    }
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
+        << "TriggerOneWatch, key:" << key << ", watch_node_map.size:" << watch_node_map.size();
+
+    for (auto it_node = watch_node_map.begin(); it_node != watch_node_map.end();) {
+      const auto& watch_node = it_node->second;
+      if ((watch_node.no_put_event && event_type == pb::version::Event::EventType::Event_EventType_PUT) ||
+          (watch_node.no_delete_event && event_type == pb::version::Event::EventType::Event_EventType_DELETE) ||
+          watch_node.start_revision > new_kv.mod_revision()) {
+        ++it_node;
+        continue;
+      }
 
-    DINGO_LOG(INFO) << "TriggerOneWatch will GetResponse, key:" << key << ", event_type:" << event_type
-                    << ", watch_node.first:" << watch_node.first
-                    << ", watch_detail: start_revision=" << watch_node.second.start_revision
-                    << ", no_put_event=" << watch_node.second.no_put_event
-                    << ", no_delete_event=" << watch_node.second.no_delete_event
-                    << ", need_prev_kv=" << watch_node.second.need_prev_kv;
-
-    pb::version::WatchResponse* response = nullptr;
-    auto closure_id = watch_node.first;
-    {
-      // BAIDU_SCOPED_LOCK(one_time_watch_closure_map_mutex_);
-      const auto& it_closure = one_time_watch_closure_map_.find(closure_id);
-      if (it_closure == one_time_watch_closure_map_.end()) {
+      auto closure_id = it_node->first;
+      auto it_closure = shard.closure_map.find(closure_id);
+      if (it_closure == shard.closure_map.end()) {
         DINGO_LOG(FATAL) << "TriggerOneWatch, one_time_watch_closure_map_ not found, key:" << key
                          << ", closure_id:" << closure_id;
       }
 
-      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch) << "TriggerOneWatch will GetResponse ptr, key:" << key;
+      defer_dones.emplace_back(it_closure->second, watch_node.need_prev_kv);
+      shard.closure_map.erase(it_closure);
+      one_time_watch_closure_status_map_.Erase(closure_id);
+      it_node = watch_node_map.erase(it_node);
+    }
 
-      response = it_closure->second.GetResponse();
-      if (response == nullptr) {
-        DINGO_LOG(ERROR) << "TriggerOneWatch, response is nullptr, key:" << key << ", closure_id:" << closure_id;
-      } else {
-        auto* event = response->add_events();
-        event->set_type(event_type);
-        auto* kv = event->mutable_kv();
-        *kv = new_kv;
-        if (watch_node.second.need_prev_kv) {
-          auto* old_kv = event->mutable_prev_kv();
-          *old_kv = prev_kv;
-        }
-      }
+    if (watch_node_map.empty()) {
+      shard.watch_map.erase(it);
+      one_time_watch_key_count_.fetch_sub(1, std::memory_order_relaxed);
     }
+  }
 
-    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
-        << "TriggerOneWatch will RemoveOneTimeWatch, key:" << key << ", event_type:" << event_type
-        << ", watch_node.first:" << watch_node.first
-        << ", watch_detail: start_revision=" << watch_node.second.start_revision
-        << ", no_put_event=" << watch_node.second.no_put_event
-        << ", no_delete_event=" << watch_node.second.no_delete_event
-        << ", need_prev_kv=" << watch_node.second.need_prev_kv;
+  if (defer_dones.empty()) {
+    return butil::Status::OK();
+  }
 
-    done_list.push_back(closure_id);
+  DINGO_LOG(INFO) << "TriggerOneWatch, key:" << key << ", event_type:" << event_type
+                  << ", triggered watch count:" << defer_dones.size();
 
-    DINGO_LOG(INFO) << "TriggerOneWatch success, key:" << key << ", event_type:" << event_type
-                    << ", closure_id:" << closure_id;
-  }
+  Bthread bth([defer_dones, event_type, new_kv, prev_kv]() mutable {
+    for (auto& [defer_done, need_prev_kv] : defer_dones) {
+      auto* response = defer_done.GetResponse();
+      if (response != nullptr) {
+        auto* event = response->add_events();
+        event->set_type(event_type);
+        *(event->mutable_kv()) = new_kv;
+        if (need_prev_kv) {
+          *(event->mutable_prev_kv()) = prev_kv;
+        }
+      }
 
-  for (auto& closure_id : done_list) {
-    auto ret = RemoveOneTimeWatchWithLock(closure_id);
-    if (ret.ok()) {
-      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
-          << "RemoveOneTimeWatchWithLock success, do done->Run(), closure_id:" << closure_id;
-    } else {
-      DINGO_LOG(ERROR) << "RemoveOneTimeWatchWithLock failed, do done->Run(), closure_id:" << closure_id
-                       << ", errcode: " << ret.error_code() << ", errmsg: " << ret.error_str();
+      defer_done.Done();
     }
-  }
+  });
 
   return butil::Status::OK();
 }
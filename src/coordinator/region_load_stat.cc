@@ -0,0 +1,126 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "coordinator/region_load_stat.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+#include "brpc/reloadable_flags.h"
+#include "common/helper.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_int64(region_load_stat_expire_s, 300, "region load without heartbeat in this time is treated as cold");
+BRPC_VALIDATE_GFLAG(region_load_stat_expire_s, brpc::PositiveInteger);
+DEFINE_int64(balance_hot_leader_cooldown_s, 600, "hot leader balance not move leader of same region within this time");
+BRPC_VALIDATE_GFLAG(balance_hot_leader_cooldown_s, brpc::NonNegativeInteger);
+
+// heartbeat closer than this is merged to next one, avoid noise of short interval.
+static const int64_t kMinUpdateIntervalMs = 1000;
+
+RegionLoadStat& RegionLoadStat::GetInstance() {
+  static RegionLoadStat instance;
+  return instance;
+}
+
+RegionLoadStat::RegionLoadStat() { bthread_mutex_init(&mutex_, nullptr); }
+
+RegionLoadStat::~RegionLoadStat() { bthread_mutex_destroy(&mutex_); }
+
+void RegionLoadStat::Update(int64_t region_id, int64_t region_size) {
+  Update(region_id, region_size, Helper::TimestampMs());
+}
+
+void RegionLoadStat::Update(int64_t region_id, int64_t region_size, int64_t now_ms) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = entries_.find(region_id);
+  if (it == entries_.end()) {
+    Entry entry;
+    entry.region_size = region_size;
+    entry.update_time_ms = now_ms;
+    entries_.emplace(region_id, entry);
+    return;
+  }
+
+  auto& entry = it->second;
+  int64_t interval_ms = now_ms - entry.update_time_ms;
+  if (interval_ms < kMinUpdateIntervalMs) {
+    return;
+  }
+
+  // size shrink on delete and compaction is also counted as write.
+  int64_t rate = std::abs(region_size - entry.region_size) * 1000 / interval_ms;
+  bool is_expired = interval_ms > FLAGS_region_load_stat_expire_s * 1000;
+  entry.write_bytes_rate = is_expired ? rate : (entry.write_bytes_rate + rate) / 2;
+  entry.region_size = region_size;
+  entry.update_time_ms = now_ms;
+}
+
+int64_t RegionLoadStat::GetWriteBytesRate(int64_t region_id) {
+  return GetWriteBytesRate(region_id, Helper::TimestampMs());
+}
+
+int64_t RegionLoadStat::GetWriteBytesRate(int64_t region_id, int64_t now_ms) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = entries_.find(region_id);
+  if (it == entries_.end() || now_ms - it->second.update_time_ms > FLAGS_region_load_stat_expire_s * 1000) {
+    return 0;
+  }
+
+  return it->second.write_bytes_rate;
+}
+
+void RegionLoadStat::MarkMoved(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  entries_[region_id].moved_time_ms = Helper::TimestampMs();
+}
+
+bool RegionLoadStat::IsCoolingDown(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = entries_.find(region_id);
+  if (it == entries_.end() || it->second.moved_time_ms == 0) {
+    return false;
+  }
+
+  return Helper::TimestampMs() - it->second.moved_time_ms < FLAGS_balance_hot_leader_cooldown_s * 1000;
+}
+
+void RegionLoadStat::CleanStale() {
+  int64_t now_ms = Helper::TimestampMs();
+  int64_t expire_ms = std::max(FLAGS_region_load_stat_expire_s, FLAGS_balance_hot_leader_cooldown_s) * 1000;
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    int64_t last_time_ms = std::max(it->second.update_time_ms, it->second.moved_time_ms);
+    if (now_ms - last_time_ms > expire_ms) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+int64_t RegionLoadStat::Size() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return entries_.size();
+}
+
+}  // namespace dingodb
@@ -0,0 +1,69 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_REGION_LOAD_STAT_H_
+#define DINGODB_REGION_LOAD_STAT_H_
+
+#include <cstdint>
+#include <unordered_map>
+
+#include "bthread/mutex.h"
+
+namespace dingodb {
+
+// Write load of region on coordinator, used by hot leader balance.
+// Store heartbeat does not carry region qps, so write rate is estimated from region size change between
+// leader heartbeats and smoothed, region without heartbeat for a long time is treated as cold.
+class RegionLoadStat {
+ public:
+  static RegionLoadStat& GetInstance();
+
+  RegionLoadStat();
+  ~RegionLoadStat();
+
+  RegionLoadStat(const RegionLoadStat&) = delete;
+  RegionLoadStat& operator=(const RegionLoadStat&) = delete;
+
+  // called with leader region metrics of heartbeat.
+  void Update(int64_t region_id, int64_t region_size);
+  void Update(int64_t region_id, int64_t region_size, int64_t now_ms);
+
+  // estimated write bytes per second.
+  int64_t GetWriteBytesRate(int64_t region_id);
+  int64_t GetWriteBytesRate(int64_t region_id, int64_t now_ms);
+
+  // leader of region is moved by hot balance, it is not moved again within cooldown time.
+  void MarkMoved(int64_t region_id);
+  bool IsCoolingDown(int64_t region_id);
+
+  // remove region without heartbeat for a long time, e.g. deleted or merged region.
+  void CleanStale();
+
+  int64_t Size();
+
+ private:
+  struct Entry {
+    int64_t region_size{0};
+    int64_t update_time_ms{0};
+    int64_t write_bytes_rate{0};
+    int64_t moved_time_ms{0};
+  };
+
+  bthread_mutex_t mutex_;
+  std::unordered_map<int64_t, Entry> entries_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_REGION_LOAD_STAT_H_
@@ -18,20 +18,43 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "brpc/closure_guard.h"
+#include "brpc/controller.h"
+#include "brpc/reloadable_flags.h"
 #include "butil/status.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
+#include "common/gflag_validator.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
 #include "engine/snapshot.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/coordinator_internal.pb.h"
 #include "proto/error.pb.h"
 #include "proto/meta.pb.h"
 
 namespace dingodb {
 
+DEFINE_bool(enable_tso_batch, false, "coalesce concurrent gen tso requests on leader into one allocation");
+DEFINE_validator(enable_tso_batch, &PassBool);
+DEFINE_int64(tso_batch_window_us, 0, "batch leader wait this time for more gen tso requests to join the batch");
+BRPC_VALIDATE_GFLAG(tso_batch_window_us, brpc::NonNegativeInteger);
+DEFINE_bool(enable_tso_follower_proxy, false, "coordinator follower forward batched gen tso requests to leader");
+DEFINE_validator(enable_tso_follower_proxy, &PassBool);
+DEFINE_int64(tso_follower_proxy_timeout_ms, 1000, "timeout of gen tso rpc from follower to leader");
+BRPC_VALIDATE_GFLAG(tso_follower_proxy_timeout_ms, brpc::PositiveInteger);
+
+static const std::string kTsoProxyAttachment = "tso_proxy";
+
+bvar::Adder<int64_t> g_tso_batch_count("dingo_tso_batch_count");
+bvar::Adder<int64_t> g_tso_batch_request_count("dingo_tso_batch_request_count");
+bvar::Adder<int64_t> g_tso_proxy_request_count("dingo_tso_proxy_request_count");
+bvar::Adder<int64_t> g_tso_proxy_rpc_count("dingo_tso_proxy_rpc_count");
+
 void TsoClosure::Run() {
   // DINGO_LOG(INFO) << "TsoClosure run";
   if (!status().ok()) {
@@ -134,14 +157,31 @@ int TsoControl::SyncTimestamp(const pb::meta::TsoTimestamp& current_timestamp, i
   return 0;
 }
 
-void TsoControl::GenTso(const pb::meta::TsoRequest* request, pb::meta::TsoResponse* response) {
-  int64_t count = request->count();
+bool TsoControl::CheckGenTsoCount(const pb::meta::TsoRequest* request, pb::meta::TsoResponse* response) {
   response->set_op_type(request->op_type());
-  if (count == 0) {
+  if (request->count() <= 0) {
     response->mutable_error()->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
     response->mutable_error()->set_errmsg("tso count should be positive");
+    return false;
+  }
+  return true;
+}
+
+void TsoControl::GenTso(const pb::meta::TsoRequest* request, pb::meta::TsoResponse* response) {
+  if (!CheckGenTsoCount(request, response)) {
+    return;
+  }
+
+  if (!FLAGS_enable_tso_batch) {
+    GenTsoCore(request->count(), response);
     return;
   }
+
+  leader_batcher_.GenTso(request, response,
+                         [this](int64_t count, pb::meta::TsoResponse* response) { GenTsoCore(count, response); });
+}
+
+void TsoControl::GenTsoCore(int64_t count, pb::meta::TsoResponse* response) {
   if (!is_healty_) {
     DINGO_LOG(ERROR) << "TSO has wrong status, retry later";
     response->mutable_error()->set_errcode(pb::error::Errno::ERETRY_LATER);
@@ -181,12 +221,163 @@ void TsoControl::GenTso(const pb::meta::TsoRequest* request, pb::meta::TsoRespon
     DINGO_LOG(ERROR) << "gen tso failed";
     return;
   }
-  DINGO_LOG(INFO) << "gen tso current: (" << current.physical() << ", " << current.logical() << ")";
+  DINGO_LOG(DEBUG) << "gen tso current: (" << current.physical() << ", " << current.logical() << ")";
   auto* timestamp = response->mutable_start_timestamp();
   *timestamp = current;
   response->set_count(count);
 }
 
+bool TsoControl::CanProxyGenTso(google::protobuf::RpcController* controller, const pb::meta::TsoRequest* request) {
+  if (!FLAGS_enable_tso_follower_proxy || request->op_type() != pb::meta::OP_GEN_TSO) {
+    return false;
+  }
+
+  // request proxied by other follower is not proxied again, avoid loop when leader is changing.
+  auto* cntl = static_cast<brpc::Controller*>(controller);
+  return cntl->request_attachment().to_string() != kTsoProxyAttachment;
+}
+
+void TsoControl::ProxyGenTso(const pb::meta::TsoRequest* request, pb::meta::TsoResponse* response) {
+  if (!CheckGenTsoCount(request, response)) {
+    return;
+  }
+
+  g_tso_proxy_request_count << 1;
+  proxy_batcher_.GenTso(request, response,
+                        [this](int64_t count, pb::meta::TsoResponse* response) { ProxyGenTsoCore(count, response); });
+}
+
+void TsoControl::ProxyGenTsoCore(int64_t count, pb::meta::TsoResponse* response) {
+  pb::common::Location leader_location;
+  GetLeaderLocation(leader_location);
+  if (leader_location.host().empty()) {
+    RedirectResponse(response);
+    return;
+  }
+
+  std::string leader_address = fmt::format("{}:{}", leader_location.host(), leader_location.port());
+  if (proxy_channel_ == nullptr || proxy_leader_address_ != leader_address) {
+    auto channel = std::make_shared<brpc::Channel>();
+    if (channel->Init(leader_address.c_str(), nullptr) != 0) {
+      DINGO_LOG(ERROR) << fmt::format("[tso.proxy] init channel to leader {} failed", leader_address);
+      RedirectResponse(response);
+      return;
+    }
+    proxy_channel_ = channel;
+    proxy_leader_address_ = leader_address;
+  }
+
+  pb::meta::TsoRequest request;
+  request.set_op_type(pb::meta::OP_GEN_TSO);
+  request.set_count(count);
+
+  brpc::Controller cntl;
+  cntl.set_timeout_ms(FLAGS_tso_follower_proxy_timeout_ms);
+  cntl.request_attachment().append(kTsoProxyAttachment);
+  pb::meta::MetaService_Stub(proxy_channel_.get()).TsoService(&cntl, &request, response, nullptr);
+  if (cntl.Failed()) {
+    DINGO_LOG(WARNING) << fmt::format("[tso.proxy] gen tso from leader {} failed, error: {} {}", leader_address,
+                                      cntl.ErrorCode(), cntl.ErrorText());
+    // client retry on leader directly.
+    response->Clear();
+    RedirectResponse(response);
+    return;
+  }
+
+  g_tso_proxy_rpc_count << 1;
+}
+
+TsoBatcher::TsoBatcher() {
+  bthread_mutex_init(&mutex_, nullptr);
+  bthread_cond_init(&cond_, nullptr);
+}
+
+TsoBatcher::~TsoBatcher() {
+  bthread_cond_destroy(&cond_);
+  bthread_mutex_destroy(&mutex_);
+}
+
+void TsoBatcher::GenTso(const pb::meta::TsoRequest* request, pb::meta::TsoResponse* response,
+                        const AllocFunc& alloc_func) {
+  Waiter waiter;
+  waiter.count = request->count();
+  waiter.response = response;
+
+  bthread_mutex_lock(&mutex_);
+  pending_waiters_.push_back(&waiter);
+  if (is_running_) {
+    while (!waiter.is_done && !waiter.is_leader) {
+      bthread_cond_wait(&cond_, &mutex_);
+    }
+  } else {
+    is_running_ = true;
+    waiter.is_leader = true;
+  }
+  bthread_mutex_unlock(&mutex_);
+
+  if (waiter.is_done) {
+    return;
+  }
+
+  // wait a short window for more requests to join the batch.
+  if (FLAGS_tso_batch_window_us > 0) {
+    bthread_usleep(FLAGS_tso_batch_window_us);
+  }
+
+  // keep batch far below max logical, else the allocation can not be served in one physical time.
+  std::vector<Waiter*> waiters;
+  int64_t total_count = 0;
+  bthread_mutex_lock(&mutex_);
+  while (!pending_waiters_.empty()) {
+    auto* pending_waiter = pending_waiters_.front();
+    if (!waiters.empty() && total_count + pending_waiter->count > kMaxLogical / 4) {
+      break;
+    }
+    total_count += pending_waiter->count;
+    waiters.push_back(pending_waiter);
+    pending_waiters_.pop_front();
+  }
+  bthread_mutex_unlock(&mutex_);
+
+  pb::meta::TsoResponse batch_response;
+  alloc_func(total_count, &batch_response);
+  Dispatch(batch_response, waiters);
+
+  g_tso_batch_count << 1;
+  g_tso_batch_request_count << waiters.size();
+
+  bthread_mutex_lock(&mutex_);
+  for (auto* done_waiter : waiters) {
+    done_waiter->is_done = true;
+  }
+  if (!pending_waiters_.empty()) {
+    pending_waiters_.front()->is_leader = true;
+  } else {
+    is_running_ = false;
+  }
+  bthread_cond_broadcast(&cond_);
+  bthread_mutex_unlock(&mutex_);
+}
+
+void TsoBatcher::Dispatch(const pb::meta::TsoResponse& batch_response, const std::vector<Waiter*>& waiters) {
+  bool is_ok = batch_response.error().errcode() == pb::error::Errno::OK;
+  int64_t logical = batch_response.start_timestamp().logical();
+  for (auto* waiter : waiters) {
+    auto* response = waiter->response;
+    response->set_op_type(pb::meta::OP_GEN_TSO);
+    if (!is_ok) {
+      *response->mutable_error() = batch_response.error();
+      continue;
+    }
+
+    auto* timestamp = response->mutable_start_timestamp();
+    timestamp->set_physical(batch_response.start_timestamp().physical());
+    timestamp->set_logical(logical);
+    response->set_count(waiter->count);
+    logical += waiter->count;
+  }
+}
+
 // This method is called by the gRPC server.
 // This method is used to process the request from the client.
 // The response is filled by the state machine and sent back to the client.
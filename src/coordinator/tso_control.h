@@ -18,10 +18,15 @@
 #include <braft/repeated_timer_task.h>
 
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "brpc/channel.h"
+#include "bthread/bthread.h"
 #include "common/meta_control.h"
 #include "engine/engine.h"
 #include "proto/coordinator_internal.pb.h"
@@ -92,6 +97,39 @@ struct TsoObj {
   int64_t last_save_physical;
 };
 
+// Coalesce concurrent gen tso requests into one allocation.
+// The first caller becomes batch leader, it takes all pending requests, allocates the sum of their count once,
+// then splits the returned logical range to each request, next pending caller becomes batch leader.
+class TsoBatcher {
+ public:
+  // allocate count tso, fill start_timestamp or error of response.
+  using AllocFunc = std::function<void(int64_t count, pb::meta::TsoResponse *response)>;
+
+  TsoBatcher();
+  ~TsoBatcher();
+
+  TsoBatcher(const TsoBatcher &) = delete;
+  TsoBatcher &operator=(const TsoBatcher &) = delete;
+
+  // request count must be positive, alloc_func is called by batch leader only.
+  void GenTso(const pb::meta::TsoRequest *request, pb::meta::TsoResponse *response, const AllocFunc &alloc_func);
+
+ private:
+  struct Waiter {
+    int64_t count{0};
+    pb::meta::TsoResponse *response{nullptr};
+    bool is_done{false};
+    bool is_leader{false};
+  };
+
+  static void Dispatch(const pb::meta::TsoResponse &batch_response, const std::vector<Waiter *> &waiters);
+
+  bthread_mutex_t mutex_;
+  bthread_cond_t cond_;
+  std::deque<Waiter *> pending_waiters_;
+  bool is_running_{false};
+};
+
 class TsoSnapshot : public dingodb::Snapshot {
  public:
   explicit TsoSnapshot(const int64_t *snapshot) : snapshot_(snapshot) {}
@@ -167,6 +205,9 @@ class TsoControl : public MetaControl {
                pb::meta::TsoResponse *response, google::protobuf::Closure *done);
 
   void GenTso(const pb::meta::TsoRequest *request, pb::meta::TsoResponse *response);
+  // follower forward gen tso to leader, concurrent requests are batched into one rpc.
+  static bool CanProxyGenTso(google::protobuf::RpcController *controller, const pb::meta::TsoRequest *request);
+  void ProxyGenTso(const pb::meta::TsoRequest *request, pb::meta::TsoResponse *response);
   void ResetTso(const pb::meta::TsoRequest &request, pb::meta::TsoResponse *response);
   void UpdateTso(const pb::meta::TsoRequest &request, pb::meta::TsoResponse *response);
 
@@ -175,6 +216,10 @@ class TsoControl : public MetaControl {
   void OnApply(braft::Iterator &iter);
 
  private:
+  static bool CheckGenTsoCount(const pb::meta::TsoRequest *request, pb::meta::TsoResponse *response);
+  void GenTsoCore(int64_t count, pb::meta::TsoResponse *response);
+  void ProxyGenTsoCore(int64_t count, pb::meta::TsoResponse *response);
+
   TsoTimer tso_update_timer_;
   TsoObj tso_obj_;
   bthread_mutex_t tso_mutex_;  // for tso_obj_
@@ -191,6 +236,12 @@ class TsoControl : public MetaControl {
 
   // raft kv engine
   std::shared_ptr<Engine> engine_;
+
+  TsoBatcher leader_batcher_;
+  TsoBatcher proxy_batcher_;
+  // channel to leader, only used by batch leader of proxy_batcher_.
+  std::string proxy_leader_address_;
+  std::shared_ptr<brpc::Channel> proxy_channel_;
 };
 
 }  // namespace dingodb
@@ -32,11 +32,17 @@ butil::Status Aggregation::Open(
     size_t start_aggregation_operators_index,
     const std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>>& result_serial_schemas,
     const ::google::protobuf::RepeatedPtrField<pb::store::AggregationOperator>& aggregation_operators) {
-  butil::Status status;
-
   result_record_ = std::make_shared<std::vector<std::any>>();
-
   result_record_->reserve((*result_serial_schemas).size() - start_aggregation_operators_index);
+
+  return InitResult(start_aggregation_operators_index, result_serial_schemas, aggregation_operators, *result_record_);
+}
+
+butil::Status Aggregation::InitResult(
+    size_t start_aggregation_operators_index,
+    const std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>>& result_serial_schemas,
+    const ::google::protobuf::RepeatedPtrField<pb::store::AggregationOperator>& aggregation_operators,
+    std::vector<std::any>& result_record) {
   size_t j = 0;
   for (size_t i = start_aggregation_operators_index;
        i < result_serial_schemas->size() && j < aggregation_operators.size(); i++, j++) {
@@ -46,49 +52,49 @@ butil::Status Aggregation::Open(
     switch (type) {
       case BaseSchema::Type::kBool: {
         if (pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper || pb::store::SUM0 == oper) {
-          result_record_->emplace_back(std::optional<bool>(false));
+          result_record.emplace_back(std::optional<bool>(false));
         } else {
-          result_record_->emplace_back(std::optional<bool>(std::nullopt));
+          result_record.emplace_back(std::optional<bool>(std::nullopt));
         }
         break;
       }
       case BaseSchema::Type::kInteger: {
         if (pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper || pb::store::SUM0 == oper) {
-          result_record_->emplace_back(std::optional<int32_t>(0));
+          result_record.emplace_back(std::optional<int32_t>(0));
         } else {
-          result_record_->emplace_back(std::optional<int32_t>(std::nullopt));
+          result_record.emplace_back(std::optional<int32_t>(std::nullopt));
         }
         break;
       }
       case BaseSchema::Type::kFloat: {
         if (pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper || pb::store::SUM0 == oper) {
-          result_record_->emplace_back(std::optional<float>(0.0f));
+          result_record.emplace_back(std::optional<float>(0.0f));
         } else {
-          result_record_->emplace_back(std::optional<float>(std::nullopt));
+          result_record.emplace_back(std::optional<float>(std::nullopt));
         }
         break;
       }
       case BaseSchema::Type::kLong: {
         if (pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper || pb::store::SUM0 == oper) {
-          result_record_->emplace_back(std::optional<int64_t>(0));
+          result_record.emplace_back(std::optional<int64_t>(0));
         } else {
-          result_record_->emplace_back(std::optional<int64_t>(std::nullopt));
+          result_record.emplace_back(std::optional<int64_t>(std::nullopt));
         }
         break;
       }
       case BaseSchema::Type::kDouble: {
         if (pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper || pb::store::SUM0 == oper) {
-          result_record_->emplace_back(std::optional<double>(0.0));
+          result_record.emplace_back(std::optional<double>(0.0));
         } else {
-          result_record_->emplace_back(std::optional<double>(std::nullopt));
+          result_record.emplace_back(std::optional<double>(std::nullopt));
         }
         break;
       }
       case BaseSchema::Type::kString: {
         if (pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper || pb::store::SUM0 == oper) {
-          result_record_->emplace_back(std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>()));
+          result_record.emplace_back(std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>()));
         } else {
-          result_record_->emplace_back(std::optional<std::shared_ptr<std::string>>(std::nullopt));
+          result_record.emplace_back(std::optional<std::shared_ptr<std::string>>(std::nullopt));
         }
         break;
       }
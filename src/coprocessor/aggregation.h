@@ -46,6 +46,13 @@ class Aggregation {
 
   const std::shared_ptr<std::vector<std::any>>& GetResult() const { return result_record_; }
 
+  // append initial value of every aggregation operator to result_record.
+  static butil::Status InitResult(
+      size_t start_aggregation_operators_index,
+      const std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>>& result_serial_schemas,
+      const ::google::protobuf::RepeatedPtrField<pb::store::AggregationOperator>& aggregation_operators,
+      std::vector<std::any>& result_record);  // NOLINT
+
   void Close();
 
  private:
@@ -14,20 +14,89 @@
 
 #include "coprocessor/aggregation_manager.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <exception>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
 #include <type_traits>
 #include <utility>
 
+#include "brpc/reloadable_flags.h"
 #include "common/logging.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/store.pb.h"
 
 namespace dingodb {
 
+DEFINE_int64(coprocessor_aggregation_init_capacity, 1024, "initial slot capacity of group by aggregation table");
+BRPC_VALIDATE_GFLAG(coprocessor_aggregation_init_capacity, brpc::PositiveInteger);
+DEFINE_int64(coprocessor_aggregation_max_memory_bytes, 1024L * 1024 * 1024,
+             "max memory of group by aggregation table of one request, 0 means no limit");
+BRPC_VALIDATE_GFLAG(coprocessor_aggregation_max_memory_bytes, brpc::NonNegativeInteger);
+
+// check memory limit every this many new groups
+static const size_t kCheckMemoryGroupInterval = 1024;
+
+AggregationHashTable::AggregationHashTable(size_t value_count, size_t init_capacity) : value_count_(value_count) {
+  size_t capacity = 16;
+  while (capacity < init_capacity) {
+    capacity <<= 1;
+  }
+  slots_.resize(capacity);
+}
+
+size_t AggregationHashTable::FindOrInsert(std::string_view key, bool& is_new) {
+  uint64_t hash = std::hash<std::string_view>()(key);
+  size_t mask = slots_.size() - 1;
+  for (size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+    auto& slot = slots_[pos];
+    if (slot.group < 0) {
+      is_new = true;
+      slot.hash = hash;
+      slot.group = key_offsets_.size();
+      key_offsets_.emplace_back(key_arena_.size(), key.size());
+      key_arena_.append(key);
+
+      // keep load factor under 0.5, probe sequence is short.
+      if (key_offsets_.size() * 2 > slots_.size()) {
+        Grow();
+      }
+      return key_offsets_.size() - 1;
+    }
+
+    if (slot.hash == hash && GetKey(slot.group) == key) {
+      is_new = false;
+      return slot.group;
+    }
+  }
+}
+
+void AggregationHashTable::Grow() {
+  std::vector<Slot> old_slots(slots_.size() * 2);
+  old_slots.swap(slots_);
+
+  size_t mask = slots_.size() - 1;
+  for (const auto& old_slot : old_slots) {
+    if (old_slot.group < 0) {
+      continue;
+    }
+    size_t pos = old_slot.hash & mask;
+    while (slots_[pos].group >= 0) {
+      pos = (pos + 1) & mask;
+    }
+    slots_[pos] = old_slot;
+  }
+}
+
+int64_t AggregationHashTable::MemorySize() const {
+  return slots_.capacity() * sizeof(Slot) + key_arena_.capacity() +
+         key_offsets_.capacity() * sizeof(std::pair<size_t, size_t>) + values_.capacity() * sizeof(std::any);
+}
+
 template <typename PARAM, typename RESULT>
 struct SUM {
   bool operator()(const std::any& param, std::any* result) {
@@ -320,32 +389,46 @@ butil::Status AggregationManager::Open(
 butil::Status AggregationManager::Execute(const std::string& group_by_key,
                                           const std::vector<std::any>& group_by_operator_record) {
   butil::Status status;
-  std::shared_ptr<Aggregation> aggregation;
 
   if (!aggregations_) {
-    using MapType = std::map<std::string, std::shared_ptr<Aggregation>>;
-    aggregations_ = std::make_shared<MapType>();
+    aggregations_ = std::make_shared<AggregationHashTable>(aggregation_operators_.size(),
+                                                           FLAGS_coprocessor_aggregation_init_capacity);
   }
 
-  const auto& iter = aggregations_->find(group_by_key);
-  if (iter == aggregations_->end()) {
-    const auto& [iter_new, _] = aggregations_->emplace(group_by_key, std::make_shared<Aggregation>());
-    aggregation = iter_new->second;
-
-    status = aggregation->Open(result_serial_schemas_->size() - group_by_operator_serial_schemas_->size(),
-                               result_serial_schemas_, aggregation_operators_);
+  bool is_new = false;
+  size_t group = aggregations_->FindOrInsert(group_by_key, is_new);
+  if (is_new) {
+    status = Aggregation::InitResult(result_serial_schemas_->size() - group_by_operator_serial_schemas_->size(),
+                                     result_serial_schemas_, aggregation_operators_, aggregations_->MutableValues());
     if (!status.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("Aggregation::Open failed");
+      DINGO_LOG(ERROR) << fmt::format("Aggregation::InitResult failed");
       return status;
     }
-  } else {
-    aggregation = iter->second;
+    if (aggregations_->MutableValues().size() != aggregations_->Size() * aggregations_->ValueCount()) {
+      std::string error_message = fmt::format("Aggregation::InitResult value count not match, expect: {}",
+                                              aggregations_->ValueCount());
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
+
+    if (FLAGS_coprocessor_aggregation_max_memory_bytes > 0 && group % kCheckMemoryGroupInterval == 0 &&
+        aggregations_->MemorySize() > FLAGS_coprocessor_aggregation_max_memory_bytes) {
+      std::string error_message = fmt::format(
+          "aggregation memory exceed limit, group count: {} memory size: {} limit: {}", aggregations_->Size(),
+          aggregations_->MemorySize(), FLAGS_coprocessor_aggregation_max_memory_bytes);
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EREQUEST_FULL, error_message);
+    }
   }
 
-  status = aggregation->Execute(aggregation_functions_, group_by_operator_record);
-  if (!status.ok()) {
-    DINGO_LOG(ERROR) << fmt::format("Aggregation::Execute failed");
-    return status;
+  std::any* values = aggregations_->GetValues(group);
+  size_t value_count = std::min(group_by_operator_record.size(), aggregations_->ValueCount());
+  for (size_t i = 0; i < value_count; i++) {
+    if (!aggregation_functions_[i](group_by_operator_record[i], &values[i])) {
+      std::string error_message = fmt::format("Execute failed index :  {}", i);
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
   }
 
   return butil::Status();
@@ -371,8 +454,8 @@ void AggregationManager::Close() {
 
 std::shared_ptr<AggregationIterator> AggregationManager::CreateIterator() {
   if (!aggregations_) {
-    using MapType = std::map<std::string, std::shared_ptr<Aggregation>>;
-    aggregations_ = std::make_shared<MapType>();
+    aggregations_ = std::make_shared<AggregationHashTable>(aggregation_operators_.size(),
+                                                           FLAGS_coprocessor_aggregation_init_capacity);
   }
   DINGO_LOG(DEBUG) << "aggregations  size : " << aggregations_->size();
   return std::make_shared<AggregationIterator>(aggregations_);
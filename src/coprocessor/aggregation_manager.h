@@ -18,10 +18,12 @@
 #include <serial/schema/base_schema.h>
 
 #include <any>
+#include <cstdint>
 #include <functional>
-#include <map>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "butil/status.h"
@@ -30,23 +32,73 @@
 
 namespace dingodb {
 
-class AggregationIterator {
+// Flat open addressing table of group by aggregation.
+// Group keys are appended to one arena string, and aggregation values of all groups are in one vector with
+// value_count values per group, so there is no allocation per group except the buffer growing.
+// Groups are iterated by insertion order, which is stable when the table grows.
+class AggregationHashTable {
  public:
-  explicit AggregationIterator(const std::shared_ptr<std::map<std::string, std::shared_ptr<Aggregation>>>& aggregations)
-      : aggregations_(aggregations) {
-    iter_ = aggregations_->begin();
+  AggregationHashTable(size_t value_count, size_t init_capacity);
+  ~AggregationHashTable() = default;
+
+  AggregationHashTable(const AggregationHashTable& rhs) = delete;
+  AggregationHashTable& operator=(const AggregationHashTable& rhs) = delete;
+
+  // return index of group, is_new is true if the group is inserted, caller must append its values.
+  size_t FindOrInsert(std::string_view key, bool& is_new);  // NOLINT
+
+  size_t Size() const { return key_offsets_.size(); }
+  size_t ValueCount() const { return value_count_; }
+
+  std::string_view GetKey(size_t group) const {
+    return std::string_view(key_arena_).substr(key_offsets_[group].first, key_offsets_[group].second);
   }
+  std::any* GetValues(size_t group) { return values_.data() + group * value_count_; }
+  std::vector<std::any>& MutableValues() { return values_; }
+
+  int64_t MemorySize() const;
+
+ private:
+  struct Slot {
+    uint64_t hash{0};
+    int64_t group{-1};
+  };
+
+  void Grow();
+
+  size_t value_count_;
+  // capacity is power of 2
+  std::vector<Slot> slots_;
+  std::string key_arena_;
+  // offset and size in key_arena_
+  std::vector<std::pair<size_t, size_t>> key_offsets_;
+  std::vector<std::any> values_;
+};
+
+class AggregationIterator {
+ public:
+  explicit AggregationIterator(const std::shared_ptr<AggregationHashTable>& aggregations)
+      : aggregations_(aggregations), value_(std::make_shared<std::vector<std::any>>()) {}
 
   ~AggregationIterator() { aggregations_.reset(); }
 
-  bool HasNext() { return (iter_ != aggregations_->end()); }
-  void Next() { ++iter_; }
-  const std::string& GetKey() const { return iter_->first; }
-  const std::shared_ptr<std::vector<std::any>>& GetValue() const { return iter_->second->GetResult(); }
+  bool HasNext() { return (index_ < aggregations_->Size()); }
+  void Next() { ++index_; }
+  const std::string& GetKey() {
+    key_.assign(aggregations_->GetKey(index_));
+    return key_;
+  }
+  const std::shared_ptr<std::vector<std::any>>& GetValue() {
+    const std::any* values = aggregations_->GetValues(index_);
+    value_->assign(values, values + aggregations_->ValueCount());
+    return value_;
+  }
 
  private:
-  std::shared_ptr<std::map<std::string, std::shared_ptr<Aggregation>>> aggregations_;
-  std::map<std::string, std::shared_ptr<Aggregation>>::iterator iter_;
+  std::shared_ptr<AggregationHashTable> aggregations_;
+  size_t index_{0};
+  std::string key_;
+  std::shared_ptr<std::vector<std::any>> value_;
 };
 
 class AggregationManager {
@@ -80,7 +132,7 @@ class AggregationManager {
   ::google::protobuf::RepeatedPtrField<pb::store::AggregationOperator> aggregation_operators_;
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas_;
   std::vector<std::function<bool(const std::any&, std::any*)>> aggregation_functions_;
-  std::shared_ptr<std::map<std::string, std::shared_ptr<Aggregation>>> aggregations_;
+  std::shared_ptr<AggregationHashTable> aggregations_;
 };
 
 }  // namespace dingodb
@@ -209,6 +209,21 @@ butil::Status Coprocessor::Open(const std::any& coprocessor) {
 
   DINGO_LOG(DEBUG) << fmt::format("Coprocessor::Open enable_expression_ : {}", enable_expression_);
 
+  // decoder and filter expression are same for all rows, so prepare once here.
+  original_record_decoder_ = std::make_shared<RecordDecoder>(coprocessor_.schema_version(), original_serial_schemas_,
+                                                             coprocessor_.original_schema().common_id());
+  if (enable_expression_) {
+    expr_runner_ = std::make_shared<expr::Runner>();
+    try {
+      expr_runner_->Decode(reinterpret_cast<const expr::Byte*>(coprocessor_.expression().c_str()),
+                           coprocessor_.expression().length());
+    } catch (const std::exception& my_exception) {
+      std::string error_message = fmt::format("expr::Runner Decode failed. exception : {}", my_exception.what());
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
+  }
+
   DINGO_LOG(DEBUG) << fmt::format("Coprocessor::Open Leave");
 
   // Utils::DebugSerialSchema(original_serial_schemas_, "original_serial_schemas");
@@ -258,9 +273,9 @@ butil::Status Coprocessor::Execute(IteratorPtr iter, bool key_only, size_t max_f
       result_key_value.set_value("");
     }
 
-    kvs->emplace_back(result_key_value);
+    kvs->emplace_back(std::move(result_key_value));
 
-    if (scan_filter.UptoLimit(result_key_value)) {
+    if (scan_filter.UptoLimit(kvs->back())) {
       iter->Next();
       return butil::Status();
     }
@@ -292,10 +307,9 @@ butil::Status Coprocessor::DoExecute(const pb::common::KeyValue& kv, bool* has_r
                                      pb::common::KeyValue* result_kv) {
   butil::Status status;
 
-  RecordDecoder original_record_decoder(coprocessor_.schema_version(), original_serial_schemas_,
-                                        coprocessor_.original_schema().common_id());
-
-  std::vector<std::any> original_record;
+  // reuse record buffer of rows
+  auto& original_record = original_record_;
+  original_record.clear();
 
   // if (original_column_indexes_.empty()) {
   //   GetOriginalColumnIndexes();
@@ -312,8 +326,8 @@ butil::Status Coprocessor::DoExecute(const pb::common::KeyValue& kv, bool* has_r
   int ret = 0;
   try {
     // decode some column. not decode all
-    ret = original_record_decoder.Decode(kv.key(), kv.value(), selection_column_indexes_,
-                                         selection_column_indexes_serial_, original_record);
+    ret = original_record_decoder_->Decode(kv.key(), kv.value(), selection_column_indexes_,
+                                           selection_column_indexes_serial_, original_record);
   } catch (const std::exception& my_exception) {
     std::string error_message = fmt::format("serial::Decode failed exception : {}", my_exception.what());
     DINGO_LOG(ERROR) << error_message;
@@ -346,19 +360,15 @@ butil::Status Coprocessor::DoExecute(const pb::common::KeyValue& kv, bool* has_r
 
   bool is_key_value_reserve = true;
   if (enable_expression_) {
-    expr::Runner runner;
-
     try {
-      runner.Decode(reinterpret_cast<const expr::Byte*>(coprocessor_.expression().c_str()),
-                    coprocessor_.expression().length());
       auto tuple = std::make_unique<expr::Tuple>();
       RelExprHelper::TransToOperandWrapper(0x02, original_serial_schemas_, selection_column_indexes_, original_record, tuple);
-      runner.BindTuple(tuple.get());
-      runner.Run();
-      std::optional<bool> ok = runner.GetOptional<bool>();
+      expr_runner_->BindTuple(tuple.get());
+      expr_runner_->Run();
+      std::optional<bool> ok = expr_runner_->GetOptional<bool>();
       is_key_value_reserve = ok.has_value() && ok.value();
     } catch (const std::exception& my_exception) {
-      std::string error_message = fmt::format("expr::Runner Decode or Run failed. exception : {}", my_exception.what());
+      std::string error_message = fmt::format("expr::Runner Run failed. exception : {}", my_exception.what());
       DINGO_LOG(ERROR) << error_message;
       return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
     }
@@ -605,9 +615,9 @@ butil::Status Coprocessor::GetKeyValueFromAggregation(bool key_only, size_t max_
         result_key_value.set_value("");
       }
 
-      kvs->emplace_back(result_key_value);
+      kvs->emplace_back(std::move(result_key_value));
 
-      if (scan_filter.UptoLimit(result_key_value)) {
+      if (scan_filter.UptoLimit(kvs->back())) {
         aggregation_iterator_->Next();
         return butil::Status();
       }
@@ -647,6 +657,8 @@ void Coprocessor::Close() {
 
   enable_expression_ = false;
   end_of_group_by_ = false;
+  expr_runner_.reset();
+  original_record_decoder_.reset();
 
   if (aggregation_manager_) {
     aggregation_manager_.reset();
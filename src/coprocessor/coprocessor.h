@@ -26,7 +26,9 @@
 #include "coprocessor/aggregation_manager.h"
 #include "coprocessor/raw_coprocessor.h"
 #include "engine/iterator.h"
+#include "expr/runner.h"
 #include "proto/store.pb.h"
+#include "serial/record_decoder.h"
 
 namespace dingodb {
 
@@ -96,6 +98,11 @@ class Coprocessor : public RawCoprocessor {
   std::vector<int> original_column_indexes_;
   std::vector<int> selection_column_indexes_;
   std::unordered_map<int, int> selection_column_indexes_serial_;
+  // prepared in Open, shared by all rows
+  std::shared_ptr<RecordDecoder> original_record_decoder_;
+  std::shared_ptr<expr::Runner> expr_runner_;
+  // per row record buffer, reused to keep capacity across rows
+  std::vector<std::any> original_record_;
 
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> original_serial_schemas_sorted_;
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> selection_serial_schemas_sorted_;
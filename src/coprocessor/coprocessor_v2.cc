@@ -26,6 +26,7 @@
 #include <vector>
 
 #include "common/logging.h"
+#include "coprocessor/coprocessor_v2_plan_cache.h"
 #include "coprocessor/utils.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
@@ -145,51 +146,27 @@ butil::Status CoprocessorV2::Open(const std::any& coprocessor) {
   }
 
   forAggCount_ = coprocessor_.for_agg_count();
-  original_serial_schemas_ = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
-
-  // init original_serial_schemas
-  /**
-   *   0    int      2
-   *   1    string   1
-   *   2    long     4
-   *   3    double   5
-   *   4    bool     6
-   *   5    string   7
-   *   6    long     0
-   *   7    double   3
-   */
-  status = Utils::TransToSerialSchema(coprocessor_.original_schema().schema(), &original_serial_schemas_);
-  if (!status.ok()) {
-    DINGO_LOG(ERROR) << fmt::format("TransToSerialSchema for original_serial_schemas  failed");
-    return status;
-  }
-  Utils::DebugSerialSchema(original_serial_schemas_, "original_serial_schemas");
-
-  GetOriginalColumnIndexes();
-  ShowOriginalColumnIndexes();
-
-  GetSelectionColumnIndexes();
-  ShowSelectionColumnIndexes();
 
-  status = Utils::CheckPbSchema(coprocessor_.result_schema().schema());
-  if (!status.ok()) {
-    std::string error_message = fmt::format("result_schema check failed");
-    DINGO_LOG(ERROR) << error_message;
-    return status;
-  }
-  result_serial_schemas_ = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
-
-  status = Utils::TransToSerialSchema(coprocessor_.result_schema().schema(), &result_serial_schemas_);
-  if (!status.ok()) {
-    DINGO_LOG(ERROR) << fmt::format("TransToSerialSchema for result_serial_schemas failed");
-    return status;
+  // same schema is prepared only once, e.g. high qps short scan of one table.
+  if (CoprocessorV2PlanCache::IsEnabled()) {
+    std::string plan_key = CoprocessorV2PlanCache::GenKey(coprocessor_);
+    auto plan = CoprocessorV2PlanCache::GetInstance().Get(plan_key);
+    if (plan != nullptr) {
+      SetPlan(*plan);
+    } else {
+      status = PreparePlan();
+      if (!status.ok()) {
+        return status;
+      }
+      CoprocessorV2PlanCache::GetInstance().Put(plan_key, GetPlan());
+    }
+  } else {
+    status = PreparePlan();
+    if (!status.ok()) {
+      return status;
+    }
   }
 
-  Utils::DebugSerialSchema(result_serial_schemas_, "result_serial_schemas");
-
-  GetResultColumnIndexes();
-  ShowResultColumnIndexes();
-
   if (coprocessor_.rel_expr().empty()) {
     std::string error_message = fmt::format("CoprocessorV2::Open rel_expr empty. not support");
     DINGO_LOG(ERROR) << error_message;
@@ -248,18 +225,11 @@ butil::Status CoprocessorV2::Execute(IteratorPtr iter, bool key_only, size_t max
       iter->Next();
     }
 
-    std::vector<std::any> result_record;
-    bool has_result_kv;
-    pb::common::KeyValue result_kv;
-
-    result_record.push_back(std::make_any<long>(count));
-    status = GetKvFromExpr(result_record, &has_result_kv, &result_kv);
-    if (has_result_kv) {
-      kvs->emplace_back(std::move(result_kv));
-    }
+    status = ExecuteAggCount(count, *kvs);
   } else {
+    // reuse key and value buffer of input kv, most rows are filtered out.
+    pb::common::KeyValue kv;
     while (iter->Valid()) {
-      pb::common::KeyValue kv;
       if (FLAGS_enable_coprocessor_v2_statistics_time_consumption) {
         auto kv_start = lambda_time_now_function();
         ON_SCOPE_EXIT([&]() {
@@ -267,11 +237,8 @@ butil::Status CoprocessorV2::Execute(IteratorPtr iter, bool key_only, size_t max
           get_kv_spend_time_ms += lambda_time_diff_microseconds_function(kv_start, kv_end);
         });
       }
-      std::string plain_key;
-      mvcc::Codec::DecodeKey(iter->Key(), plain_key);
-      kv.mutable_key()->swap(plain_key);
-      std::string value(mvcc::Codec::UnPackageValue(iter->Value()));
-      kv.mutable_value()->swap(value);
+      mvcc::Codec::DecodeKey(iter->Key(), *kv.mutable_key());
+      kv.mutable_value()->assign(mvcc::Codec::UnPackageValue(iter->Value()));
 
       bool has_result_kv = false;
       pb::common::KeyValue result_key_value;
@@ -375,18 +342,11 @@ butil::Status CoprocessorV2::Execute(TxnIteratorPtr iter, bool key_only, bool /*
       }
     }
 
-    std::vector<std::any> result_record;
-    bool has_result_kv;
-    pb::common::KeyValue result_kv;
-
-    result_record.push_back(std::make_any<long>(count));
-    status = GetKvFromExpr(result_record, &has_result_kv, &result_kv);
-    if (has_result_kv) {
-      kvs.emplace_back(std::move(result_kv));
-    }
+    status = ExecuteAggCount(count, kvs);
   } else {
+    // reuse key and value buffer of input kv, most rows are filtered out.
+    pb::common::KeyValue kv;
     while (iter->Valid(txn_result_info)) {
-      pb::common::KeyValue kv;
       if (FLAGS_enable_coprocessor_v2_statistics_time_consumption) {
         auto kv_start = lambda_time_now_function();
         ON_SCOPE_EXIT([&]() {
@@ -394,8 +354,8 @@ butil::Status CoprocessorV2::Execute(TxnIteratorPtr iter, bool key_only, bool /*
           get_kv_spend_time_ms += lambda_time_diff_microseconds_function(kv_start, kv_end);
         });
       }
-      *kv.mutable_key() = iter->Key();
-      *kv.mutable_value() = iter->Value();
+      kv.mutable_key()->assign(iter->Key());
+      kv.mutable_value()->assign(iter->Value());
 
       bool has_result_kv = false;
       pb::common::KeyValue result_kv;
@@ -457,6 +417,20 @@ butil::Status CoprocessorV2::Execute(TxnIteratorPtr iter, bool key_only, bool /*
   return status;
 }
 
+butil::Status CoprocessorV2::ExecuteAggCount(int64_t count, std::vector<pb::common::KeyValue>& kvs) {
+  std::vector<std::any> result_record;
+  bool has_result_kv = false;
+  pb::common::KeyValue result_kv;
+
+  result_record.push_back(std::make_any<long>(count));
+  auto status = GetKvFromExpr(result_record, &has_result_kv, &result_kv);
+  if (has_result_kv) {
+    kvs.emplace_back(std::move(result_kv));
+  }
+
+  return status;
+}
+
 butil::Status CoprocessorV2::Filter(const std::string& key, const std::string& value, bool& is_reserved) {
   if (FLAGS_enable_coprocessor_v2_statistics_time_consumption) {
     ON_SCOPE_EXIT([&]() { coprocessor_v2_end_time_point = std::chrono::steady_clock::now(); });
@@ -478,6 +452,8 @@ void CoprocessorV2::Close() {
   original_column_indexes_.clear();
   selection_column_indexes_.clear();
   selection_column_indexes_serial_.clear();
+  original_operand_columns_.clear();
+  result_operand_columns_.clear();
   result_serial_schemas_.reset();
   result_record_encoder_.reset();
   original_record_decoder_.reset();
@@ -502,7 +478,9 @@ butil::Status CoprocessorV2::DoExecute(const std::string& key, const std::string
     return butil::Status();
   }
 
-  std::vector<std::any> result_record;
+  // reuse record buffer of rows
+  auto& result_record = result_record_;
+  result_record.clear();
   auto lambda_time_now_function = []() { return std::chrono::steady_clock::now(); };
   auto lambda_time_diff_microseconds_function = [](auto start, auto end) {
     return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
@@ -516,8 +494,8 @@ butil::Status CoprocessorV2::DoExecute(const std::string& key, const std::string
     });
   }
   int codec_version = GetCodecVersion(key);
-  status = RelExprHelper::TransFromOperandWrapper(codec_version, result_operand_ptr, result_serial_schemas_,
-                                                  result_column_indexes_, result_record);
+  status = RelExprHelper::TransFromOperandWrapper(codec_version, result_operand_ptr, result_operand_columns_,
+                                                  result_record);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
@@ -581,8 +559,7 @@ butil::Status CoprocessorV2::DoRelExprCore(int codec_version, const std::vector<
     });
   };
 
-  status = RelExprHelper::TransToOperandWrapper(codec_version, original_serial_schemas_, selection_column_indexes_,
-                                                original_record, operand_ptr);
+  status = RelExprHelper::TransToOperandWrapper(codec_version, original_operand_columns_, original_record, operand_ptr);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
@@ -614,7 +591,9 @@ butil::Status CoprocessorV2::DoRelExprCoreWrapper(const std::string& key, const
                                                   std::unique_ptr<std::vector<expr::Operand>>& result_operand_ptr) {
   butil::Status status;
 
-  std::vector<std::any> original_record;
+  // reuse record buffer of rows
+  auto& original_record = original_record_;
+  original_record.clear();
   int codec_version = GetCodecVersion(key);
 
   if (FLAGS_enable_coprocessor_v2_statistics_time_consumption) {
@@ -688,7 +667,7 @@ butil::Status CoprocessorV2::GetKvFromExprEndOfFinish(std::vector<pb::common::Ke
     }
     // int codec_version = GetCodecVersion(kv.key());
     status = RelExprHelper::TransFromOperandWrapper(coprocessor_.codec_version(), result_operand_ptr,
-                                                    result_serial_schemas_, result_column_indexes_, result_record);
+                                                    result_operand_columns_, result_record);
     if (!status.ok()) {
       DINGO_LOG(ERROR) << status.error_cstr();
       return status;
@@ -725,7 +704,8 @@ butil::Status CoprocessorV2::GetKvFromExpr(const std::vector<std::any>& record,
   Utils::DebugPrintAnyArray(record, "From Expr");
 #endif
 
-  pb::common::KeyValue result_key_value;
+  // encode into output directly, no temporary kv.
+  auto& result_key_value = *result_kv;
   int ret = 0;
   try {
     ret = result_record_encoder_->Encode(prefix_, record, *result_key_value.mutable_key(),
@@ -741,11 +721,90 @@ butil::Status CoprocessorV2::GetKvFromExpr(const std::vector<std::any>& record,
   }
 
   *has_result_kv = true;
-  *result_kv = std::move(result_key_value);
 
   return butil::Status();
 }
 
+butil::Status CoprocessorV2::PreparePlan() {
+  butil::Status status;
+
+  original_serial_schemas_ = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+
+  // init original_serial_schemas
+  /**
+   *   0    int      2
+   *   1    string   1
+   *   2    long     4
+   *   3    double   5
+   *   4    bool     6
+   *   5    string   7
+   *   6    long     0
+   *   7    double   3
+   */
+  status = Utils::TransToSerialSchema(coprocessor_.original_schema().schema(), &original_serial_schemas_);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("TransToSerialSchema for original_serial_schemas  failed");
+    return status;
+  }
+  Utils::DebugSerialSchema(original_serial_schemas_, "original_serial_schemas");
+
+  GetOriginalColumnIndexes();
+  ShowOriginalColumnIndexes();
+
+  GetSelectionColumnIndexes();
+  ShowSelectionColumnIndexes();
+
+  status = Utils::CheckPbSchema(coprocessor_.result_schema().schema());
+  if (!status.ok()) {
+    std::string error_message = fmt::format("result_schema check failed");
+    DINGO_LOG(ERROR) << error_message;
+    return status;
+  }
+  result_serial_schemas_ = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+
+  status = Utils::TransToSerialSchema(coprocessor_.result_schema().schema(), &result_serial_schemas_);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("TransToSerialSchema for result_serial_schemas failed");
+    return status;
+  }
+
+  Utils::DebugSerialSchema(result_serial_schemas_, "result_serial_schemas");
+
+  GetResultColumnIndexes();
+  ShowResultColumnIndexes();
+
+  original_operand_columns_ = RelExprHelper::GetOperandColumns(original_serial_schemas_, selection_column_indexes_);
+  result_operand_columns_ = RelExprHelper::GetOperandColumns(result_serial_schemas_, result_column_indexes_);
+
+  return status;
+}
+
+// schema list is copied, it is not shared with decoder/encoder of other request.
+CoprocessorV2PlanPtr CoprocessorV2::GetPlan() const {
+  auto plan = std::make_shared<CoprocessorV2Plan>();
+  plan->original_serial_schemas = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>(*original_serial_schemas_);
+  plan->original_column_indexes = original_column_indexes_;
+  plan->selection_column_indexes = selection_column_indexes_;
+  plan->selection_column_indexes_serial = selection_column_indexes_serial_;
+  plan->result_serial_schemas = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>(*result_serial_schemas_);
+  plan->result_column_indexes = result_column_indexes_;
+  plan->original_operand_columns = original_operand_columns_;
+  plan->result_operand_columns = result_operand_columns_;
+  return plan;
+}
+
+void CoprocessorV2::SetPlan(const CoprocessorV2Plan& plan) {
+  original_serial_schemas_ =
+      std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>(*plan.original_serial_schemas);
+  original_column_indexes_ = plan.original_column_indexes;
+  selection_column_indexes_ = plan.selection_column_indexes;
+  selection_column_indexes_serial_ = plan.selection_column_indexes_serial;
+  result_serial_schemas_ = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>(*plan.result_serial_schemas);
+  result_column_indexes_ = plan.result_column_indexes;
+  original_operand_columns_ = plan.original_operand_columns;
+  result_operand_columns_ = plan.result_operand_columns;
+}
+
 void CoprocessorV2::GetOriginalColumnIndexes() {
   original_column_indexes_.resize(original_serial_schemas_->size(), -1);
   int i = 0;
@@ -25,6 +25,7 @@
 #include <unordered_map>
 
 #include "butil/status.h"
+#include "coprocessor/coprocessor_v2_plan_cache.h"
 #include "coprocessor/raw_coprocessor.h"
 #include "coprocessor/rel_expr_helper.h"  // IWYU pragma: keep
 #include "engine/iterator.h"
@@ -63,6 +64,10 @@ class CoprocessorV2 : public RawCoprocessor {
                         pb::store::TxnResultInfo& txn_result_info, std::vector<pb::common::KeyValue>& kvs,
                         bool& has_more) override;
 
+  // for_agg_count coprocessor, encode count of rows which is counted by caller, e.g. count of parallel scan.
+  bool IsAggCount() const { return forAggCount_; }
+  butil::Status ExecuteAggCount(int64_t count, std::vector<pb::common::KeyValue>& kvs);  // NOLINT
+
   butil::Status Filter(const std::string& key, const std::string& value, bool& is_reserved) override;  // NOLINT
 
   butil::Status Filter(const pb::common::VectorScalardata& scalar_data, bool& is_reserved) override;  // NOLINT
@@ -81,6 +86,11 @@ class CoprocessorV2 : public RawCoprocessor {
   butil::Status GetKvFromExpr(const std::vector<std::any>& record, bool* has_result_kv,
                               pb::common::KeyValue* result_kv);
 
+  // prepare schemas and column indexes from coprocessor_.
+  butil::Status PreparePlan();
+  CoprocessorV2PlanPtr GetPlan() const;
+  void SetPlan(const CoprocessorV2Plan& plan);
+
   void GetOriginalColumnIndexes();
   void GetSelectionColumnIndexes();
   void GetResultColumnIndexes();
@@ -111,6 +121,12 @@ class CoprocessorV2 : public RawCoprocessor {
   // array index =  result schema member index field ; value = result schema array index
   std::vector<int> result_column_indexes_;  // NOLINT
   bool forAggCount_; // NOLINT
+  // column type of operand tuple of rel expr input and output
+  std::vector<RelExprHelper::OperandColumn> original_operand_columns_;  // NOLINT
+  std::vector<RelExprHelper::OperandColumn> result_operand_columns_;    // NOLINT
+  // per row record buffer, reused to keep capacity across rows
+  std::vector<std::any> original_record_;  // NOLINT
+  std::vector<std::any> result_record_;    // NOLINT
 
 #if defined(TEST_COPROCESSOR_V2_MOCK)
   std::shared_ptr<rel::mock::RelRunner> rel_runner_;  // NOLINT
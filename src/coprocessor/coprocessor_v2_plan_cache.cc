@@ -0,0 +1,115 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "coprocessor/coprocessor_v2_plan_cache.h"
+
+#include <cstdint>
+#include <iterator>
+#include <string>
+
+#include "brpc/reloadable_flags.h"
+#include "bthread/mutex.h"
+#include "bvar/reducer.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_int64(coprocessor_v2_plan_cache_max_count, 1024, "max count of prepared coprocessor v2 plan, 0 is disable");
+BRPC_VALIDATE_GFLAG(coprocessor_v2_plan_cache_max_count, brpc::NonNegativeInteger);
+
+bvar::Adder<int64_t> g_coprocessor_v2_plan_cache_hit_count("dingo_coprocessor_v2_plan_cache_hit_count");
+bvar::Adder<int64_t> g_coprocessor_v2_plan_cache_miss_count("dingo_coprocessor_v2_plan_cache_miss_count");
+
+CoprocessorV2PlanCache::CoprocessorV2PlanCache() { bthread_mutex_init(&mutex_, nullptr); }
+
+CoprocessorV2PlanCache::~CoprocessorV2PlanCache() { bthread_mutex_destroy(&mutex_); }
+
+CoprocessorV2PlanCache& CoprocessorV2PlanCache::GetInstance() {
+  static CoprocessorV2PlanCache instance;
+  return instance;
+}
+
+bool CoprocessorV2PlanCache::IsEnabled() { return FLAGS_coprocessor_v2_plan_cache_max_count > 0; }
+
+static void AppendWithSize(const std::string& data, std::string& key) {
+  key.append(std::to_string(data.size()));
+  key.push_back(':');
+  key.append(data);
+}
+
+std::string CoprocessorV2PlanCache::GenKey(const pb::common::CoprocessorV2& coprocessor) {
+  std::string key;
+  key.append(std::to_string(coprocessor.schema_version()));
+  key.push_back(':');
+  AppendWithSize(coprocessor.original_schema().SerializeAsString(), key);
+  AppendWithSize(coprocessor.result_schema().SerializeAsString(), key);
+  for (int selection_column : coprocessor.selection_columns()) {
+    key.append(std::to_string(selection_column));
+    key.push_back(',');
+  }
+
+  return key;
+}
+
+CoprocessorV2PlanPtr CoprocessorV2PlanCache::Get(const std::string& key) {
+  if (!IsEnabled()) {
+    return nullptr;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = entry_map_.find(key);
+  if (it == entry_map_.end()) {
+    g_coprocessor_v2_plan_cache_miss_count << 1;
+    return nullptr;
+  }
+
+  entries_.splice(entries_.begin(), entries_, it->second);
+  g_coprocessor_v2_plan_cache_hit_count << 1;
+  return it->second->plan;
+}
+
+void CoprocessorV2PlanCache::Put(const std::string& key, CoprocessorV2PlanPtr plan) {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = entry_map_.find(key);
+  if (it != entry_map_.end()) {
+    entries_.erase(it->second);
+    entry_map_.erase(it);
+  }
+
+  entries_.push_front(Entry{key, plan});
+  entry_map_[key] = entries_.begin();
+
+  while (static_cast<int64_t>(entries_.size()) > FLAGS_coprocessor_v2_plan_cache_max_count) {
+    auto last = std::prev(entries_.end());
+    entry_map_.erase(last->key);
+    entries_.erase(last);
+  }
+}
+
+void CoprocessorV2PlanCache::Clear() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  entry_map_.clear();
+  entries_.clear();
+}
+
+int64_t CoprocessorV2PlanCache::Size() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return entries_.size();
+}
+
+}  // namespace dingodb
@@ -0,0 +1,85 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COPROCESSOR_V2_PLAN_CACHE_H_  // NOLINT
+#define DINGODB_COPROCESSOR_V2_PLAN_CACHE_H_
+
+#include <serial/schema/base_schema.h>
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "coprocessor/rel_expr_helper.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Schema part of CoprocessorV2 prepared from request, it is immutable after prepared.
+// Decoder/encoder and rel runner keep state of one scan, so they are still created by every request.
+struct CoprocessorV2Plan {
+  std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> original_serial_schemas;
+  std::vector<int> original_column_indexes;
+  std::vector<int> selection_column_indexes;
+  std::unordered_map<int, int> selection_column_indexes_serial;
+  std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas;
+  std::vector<int> result_column_indexes;
+  std::vector<RelExprHelper::OperandColumn> original_operand_columns;
+  std::vector<RelExprHelper::OperandColumn> result_operand_columns;
+};
+
+using CoprocessorV2PlanPtr = std::shared_ptr<const CoprocessorV2Plan>;
+
+// LRU cache of CoprocessorV2Plan shared by all regions, bounded by count.
+class CoprocessorV2PlanCache {
+ public:
+  CoprocessorV2PlanCache();
+  ~CoprocessorV2PlanCache();
+
+  CoprocessorV2PlanCache(const CoprocessorV2PlanCache&) = delete;
+  CoprocessorV2PlanCache& operator=(const CoprocessorV2PlanCache&) = delete;
+
+  static CoprocessorV2PlanCache& GetInstance();
+
+  static bool IsEnabled();
+
+  // key of schema version, original/result schema and selection columns, which the plan is prepared from.
+  static std::string GenKey(const pb::common::CoprocessorV2& coprocessor);
+
+  CoprocessorV2PlanPtr Get(const std::string& key);
+  void Put(const std::string& key, CoprocessorV2PlanPtr plan);
+
+  void Clear();
+  int64_t Size();
+
+ private:
+  struct Entry {
+    std::string key;
+    CoprocessorV2PlanPtr plan;
+  };
+  using EntryList = std::list<Entry>;
+
+  bthread_mutex_t mutex_;
+  // front is most recently used
+  EntryList entries_;
+  std::unordered_map<std::string, EntryList::iterator> entry_map_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COPROCESSOR_V2_PLAN_CACHE_H_  // NOLINT
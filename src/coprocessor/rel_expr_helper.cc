@@ -843,6 +843,83 @@ butil::Status RelExprHelper::TransFromOperandV2(
   return butil::Status();
 }
 
+std::vector<RelExprHelper::OperandColumn> RelExprHelper::GetOperandColumns(
+    const std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>>& serial_schemas,
+    const std::vector<int>& column_indexes) {
+  std::vector<OperandColumn> operand_columns;
+  operand_columns.reserve(column_indexes.size());
+  for (int column_index : column_indexes) {
+    const auto& schema = (*serial_schemas)[column_index];
+    operand_columns.push_back({schema->GetType(), schema->GetPrecision(), schema->GetScale()});
+  }
+
+  return operand_columns;
+}
+
+butil::Status RelExprHelper::TransToOperandWrapper(const int codec_version,
+                                                   const std::vector<OperandColumn>& operand_columns,
+                                                   const std::vector<std::any>& original_record,
+                                                   std::unique_ptr<std::vector<expr::Operand>>& operand_ptr) {
+  if (original_record.size() > operand_columns.size()) {
+    std::string s = fmt::format("record size({}) more than operand column size({})", original_record.size(),
+                                operand_columns.size());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, s);
+  }
+
+  if (operand_ptr) {
+    operand_ptr->reserve(operand_ptr->size() + original_record.size());
+  }
+
+  butil::Status status;
+  for (size_t i = 0; i < original_record.size(); ++i) {
+    const auto& operand_column = operand_columns[i];
+    if (codec_version <= dingodb::serialV2::CODEC_VERSION_V1) {
+      status = RelExprHelper::TransToOperand(operand_column.type, original_record[i], operand_ptr);
+    } else {
+      status = RelExprHelper::TransToOperandV2(operand_column.type, original_record[i], operand_ptr,
+                                               operand_column.precision, operand_column.scale);
+    }
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+  }
+
+  return butil::Status();
+}
+
+butil::Status RelExprHelper::TransFromOperandWrapper(const int codec_version,
+                                                     const std::unique_ptr<std::vector<expr::Operand>>& operand_ptr,
+                                                     const std::vector<OperandColumn>& operand_columns,
+                                                     std::vector<std::any>& result_record) {
+  if (operand_ptr->size() > operand_columns.size()) {
+    std::string s = fmt::format("operand size({}) more than operand column size({})", operand_ptr->size(),
+                                operand_columns.size());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, s);
+  }
+
+  result_record.reserve(result_record.size() + operand_ptr->size());
+
+  butil::Status status;
+  for (size_t i = 0; i < operand_ptr->size(); ++i) {
+    const auto& operand_column = operand_columns[i];
+    if (codec_version <= dingodb::serialV2::CODEC_VERSION_V1) {
+      status = RelExprHelper::TransFromOperand(operand_column.type, operand_ptr, i, result_record);
+    } else {
+      status = RelExprHelper::TransFromOperandV2(operand_column.type, operand_ptr, i, result_record,
+                                                 operand_column.precision, operand_column.scale);
+    }
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+  }
+
+  return butil::Status();
+}
+
 butil::Status RelExprHelper::TransToOperandWrapper(
     const int codec_version,
     const std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>>&
@@ -86,6 +86,17 @@ class RelExprHelper {
   RelExprHelper(RelExprHelper&& rhs) = delete;
   RelExprHelper& operator=(RelExprHelper&& rhs) = delete;
 
+  // type of one column of operand tuple, prepared once per coprocessor, not looked up from schema for every row.
+  struct OperandColumn {
+    BaseSchema::Type type;
+    long precision{0};
+    long scale{0};
+  };
+
+  static std::vector<OperandColumn> GetOperandColumns(
+      const std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>>& serial_schemas,
+      const std::vector<int>& column_indexes);
+
   static butil::Status TransToOperand(BaseSchema::Type type, const std::any& column,
                                       std::unique_ptr<std::vector<expr::Operand>>& operand_ptr);  // NOLINT
 
@@ -111,6 +122,16 @@ class RelExprHelper {
       const std::unique_ptr<std::vector<expr::Operand>>& operand_ptr,
       const std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>>& result_serial_schemas,
       const std::vector<int>& result_column_indexes, std::vector<std::any>& result_record);
+
+  // same as above, with operand columns from GetOperandColumns.
+  static butil::Status TransToOperandWrapper(const int codec_version, const std::vector<OperandColumn>& operand_columns,
+                                             const std::vector<std::any>& original_record,
+                                             std::unique_ptr<std::vector<expr::Operand>>& operand_ptr);  // NOLINT
+
+  static butil::Status TransFromOperandWrapper(const int codec_version,
+                                               const std::unique_ptr<std::vector<expr::Operand>>& operand_ptr,
+                                               const std::vector<OperandColumn>& operand_columns,
+                                               std::vector<std::any>& result_record);
 };
 
 }  // namespace dingodb
@@ -14,20 +14,43 @@
 
 #include "crontab/crontab.h"
 
+#include "brpc/reloadable_flags.h"
 #include "bthread/bthread.h"
-#include "bthread/unstable.h"
 #include "common/logging.h"
 #include "common/role.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 
 namespace dingodb {
 
-CrontabManager::CrontabManager() { bthread_mutex_init(&mutex_, nullptr); }
+DEFINE_int64(timer_wheel_tick_ms, 10, "tick of crontab timer wheel");
+BRPC_VALIDATE_GFLAG(timer_wheel_tick_ms, brpc::PositiveInteger);
+DEFINE_double(crontab_jitter_ratio, 0.05, "random jitter ratio of crontab interval");
+static bool ValidateCrontabJitterRatio(const char*, double value) { return value >= 0.0 && value < 1.0; }
+DEFINE_validator(crontab_jitter_ratio, &ValidateCrontabJitterRatio);
+DEFINE_int32(crontab_region_spread_num, 4,
+             "per-region periodic job is run this times per interval and each run handle part of regions");
+static bool ValidateCrontabRegionSpreadNum(const char*, int32_t value) { return value > 0; }
+DEFINE_validator(crontab_region_spread_num, &ValidateCrontabRegionSpreadNum);
+
+CrontabManager::CrontabManager() : timer_wheel_(FLAGS_timer_wheel_tick_ms) { bthread_mutex_init(&mutex_, nullptr); }
+
+CrontabManager::~CrontabManager() {
+  timer_wheel_.Stop();
+  bthread_mutex_destroy(&mutex_);
+}
 
-CrontabManager::~CrontabManager() { bthread_mutex_destroy(&mutex_); }
+void CrontabManager::ScheduleCrontab(std::shared_ptr<Crontab> crontab, int64_t delay_ms) {
+  std::weak_ptr<Crontab> weak_crontab = crontab;
+  crontab->timer_id = timer_wheel_.Schedule(delay_ms, [this, weak_crontab]() {
+    auto alive_crontab = weak_crontab.lock();
+    if (alive_crontab != nullptr) {
+      Run(alive_crontab);
+    }
+  });
+}
 
-void CrontabManager::Run(void* arg) {
-  Crontab* crontab = static_cast<Crontab*>(arg);
+void CrontabManager::Run(std::shared_ptr<Crontab> crontab) {
   if (crontab->pause) {
     return;
   }
@@ -41,10 +64,13 @@ void CrontabManager::Run(void* arg) {
     ++crontab->run_count;
   } else {
     crontab->immediately = true;
+    // spread first run in [interval/2, interval*3/2) by name, avoid all crontabs of same interval start together.
+    ScheduleCrontab(crontab, crontab->interval / 2 + TimerWheel::SpreadOffset(crontab->name, crontab->interval));
+    return;
   }
 
   if (crontab->max_times == 0 || crontab->run_count < crontab->max_times) {
-    bthread_timer_add(&crontab->timer_id, butil::milliseconds_from_now(crontab->interval), &Run, crontab);
+    ScheduleCrontab(crontab, TimerWheel::Jitter(crontab->interval, FLAGS_crontab_jitter_ratio));
   }
 }
 
@@ -120,15 +146,13 @@ void CrontabManager::StartCrontab(uint32_t crontab_id) {
   auto crontab = it->second;
   crontab->pause = false;
 
-  bthread_t tid;
-  const bthread_attr_t attr = BTHREAD_ATTR_NORMAL;
-  bthread_start_background(
-      &tid, &attr,
-      [](void* arg) -> void* {
-        CrontabManager::Run(arg);
-        return nullptr;
-      },
-      crontab.get());
+  if (!timer_wheel_.Start()) {
+    DINGO_LOG(ERROR) << fmt::format("[crontab.start][id({}).name({})] start timer wheel failed.", crontab_id,
+                                    crontab->name);
+    return;
+  }
+
+  ScheduleCrontab(crontab, 0);
 }
 
 void CrontabManager::InnerPauseCrontab(uint32_t crontab_id) {
@@ -141,7 +165,7 @@ void CrontabManager::InnerPauseCrontab(uint32_t crontab_id) {
 
   crontab->pause = true;
   if (crontab->timer_id != 0) {
-    bthread_timer_del(crontab->timer_id);
+    timer_wheel_.Cancel(crontab->timer_id);
   }
 }
 
@@ -162,10 +186,13 @@ void CrontabManager::Destroy() {
   BAIDU_SCOPED_LOCK(mutex_);
 
   for (auto it = crontabs_.begin(); it != crontabs_.end();) {
-    bthread_timer_del(it->second->timer_id);
+    it->second->pause = true;
+    timer_wheel_.Cancel(it->second->timer_id);
 
     it = crontabs_.erase(it);
   }
+
+  timer_wheel_.Stop();
 }
 
 }  // namespace dingodb
\ No newline at end of file
@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "bthread/types.h"
+#include "crontab/timer_wheel.h"
 #include "proto/common.pb.h"
 
 namespace dingodb {
@@ -50,15 +51,17 @@ class Crontab {
   int run_count{0};
   // Is pause crontab
   bool pause{false};
-  // bthread_timer_t handler
-  bthread_timer_t timer_id{0};
+  // timer wheel timer id
+  uint64_t timer_id{0};
   // For run target function
   std::function<void(void*)> func;
   // Delivery to func_'s argument
   void* arg{nullptr};
 };
 
-// Manage crontab use brpc::bthread_timer_add
+// Manage crontab use one timer wheel.
+// First run of crontab is spread by name within interval and every run is jittered,
+// so crontabs of same interval not fire at the same tick.
 class CrontabManager {
  public:
   CrontabManager();
@@ -67,8 +70,6 @@ class CrontabManager {
   CrontabManager(const CrontabManager&) = delete;
   const CrontabManager& operator=(const CrontabManager&) = delete;
 
-  static void Run(void* arg);
-
   void AddCrontab(std::vector<CrontabConfig>& crontab_configs);
 
   uint32_t AddCrontab(std::shared_ptr<Crontab> crontab);
@@ -85,6 +86,11 @@ class CrontabManager {
 
   void InnerPauseCrontab(uint32_t crontab_id);
 
+  void Run(std::shared_ptr<Crontab> crontab);
+  void ScheduleCrontab(std::shared_ptr<Crontab> crontab, int64_t delay_ms);
+
+  TimerWheel timer_wheel_;
+
   // Atomic auto incremental variable
   std::atomic<uint32_t> auinc_crontab_id_;
   // Protect crontabs_ concurrence access.
@@ -0,0 +1,210 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "crontab/timer_wheel.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "bvar/reducer.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+
+namespace dingodb {
+
+bvar::Adder<int64_t> g_timer_wheel_expire_count("dingo_timer_wheel_expire_count");
+
+static void* RunTimerFunc(void* arg) {
+  std::unique_ptr<TimerWheel::Func> func(static_cast<TimerWheel::Func*>(arg));
+  (*func)();
+  return nullptr;
+}
+
+TimerWheel::TimerWheel(int64_t tick_ms) : tick_ms_(std::max(tick_ms, static_cast<int64_t>(1))) {
+  bthread_mutex_init(&mutex_, nullptr);
+}
+
+TimerWheel::~TimerWheel() {
+  Stop();
+  bthread_mutex_destroy(&mutex_);
+}
+
+bool TimerWheel::Start() {
+  bool expected = true;
+  if (!is_stop_.compare_exchange_strong(expected, false)) {
+    return true;
+  }
+
+  const bthread_attr_t attr = BTHREAD_ATTR_NORMAL;
+  if (bthread_start_background(&ticker_tid_, &attr, &TimerWheel::TickerRun, this) != 0) {
+    DINGO_LOG(ERROR) << "[timer_wheel] start ticker bthread failed.";
+    is_stop_.store(true);
+    return false;
+  }
+
+  return true;
+}
+
+void TimerWheel::Stop() {
+  bool expected = false;
+  if (is_stop_.compare_exchange_strong(expected, true)) {
+    bthread_join(ticker_tid_, nullptr);
+  }
+}
+
+void* TimerWheel::TickerRun(void* arg) {
+  auto* self = static_cast<TimerWheel*>(arg);
+
+  int64_t start_ms = Helper::TimestampMs();
+  int64_t tick_count = 0;
+  while (!self->is_stop_.load(std::memory_order_relaxed)) {
+    // catch up with wall clock when ticker is delayed, ticks are never skipped.
+    int64_t now_ms = Helper::TimestampMs();
+    while (start_ms + (tick_count + 1) * self->tick_ms_ <= now_ms) {
+      self->Tick();
+      ++tick_count;
+    }
+
+    int64_t wait_ms = start_ms + (tick_count + 1) * self->tick_ms_ - Helper::TimestampMs();
+    if (wait_ms > 0) {
+      bthread_usleep(wait_ms * 1000);
+    }
+  }
+
+  return nullptr;
+}
+
+uint64_t TimerWheel::Schedule(int64_t delay_ms, Func func) {
+  // at least one tick, timer of current tick is already expired.
+  int64_t delay_tick = std::max((delay_ms + tick_ms_ - 1) / tick_ms_, static_cast<int64_t>(1));
+
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  uint64_t timer_id = next_timer_id_++;
+  auto& timer = timers_[timer_id];
+  timer.expire_tick = current_tick_ + delay_tick;
+  timer.func = std::move(func);
+  PutTimer(timer_id, timer.expire_tick);
+
+  return timer_id;
+}
+
+bool TimerWheel::Cancel(uint64_t timer_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return timers_.erase(timer_id) > 0;
+}
+
+int64_t TimerWheel::Size() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return timers_.size();
+}
+
+void TimerWheel::PutTimer(uint64_t timer_id, int64_t expire_tick) {
+  expire_tick = std::max(expire_tick, current_tick_);
+  int64_t diff = expire_tick - current_tick_;
+
+  for (int level = 0; level < kLevelNum; ++level) {
+    if (diff < LevelSpan(level + 1)) {
+      slots_[level][(expire_tick >> (kSlotBits * level)) & kSlotMask].push_back(timer_id);
+      return;
+    }
+  }
+
+  // beyond the span of wheel, put into the last come around slot of top level, it is put again then.
+  int top_shift = kSlotBits * (kLevelNum - 1);
+  slots_[kLevelNum - 1][((current_tick_ >> top_shift) + kSlotMask) & kSlotMask].push_back(timer_id);
+}
+
+void TimerWheel::Cascade(int level) {
+  std::vector<uint64_t> timer_ids;
+  timer_ids.swap(slots_[level][(current_tick_ >> (kSlotBits * level)) & kSlotMask]);
+
+  for (auto timer_id : timer_ids) {
+    auto it = timers_.find(timer_id);
+    if (it != timers_.end()) {
+      PutTimer(timer_id, it->second.expire_tick);
+    }
+  }
+}
+
+void TimerWheel::Tick() {
+  std::vector<Func> expired_funcs;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+
+    ++current_tick_;
+
+    // when lower levels wrap around, move down timers of upper level, from top to bottom.
+    int max_level = 0;
+    while (max_level + 1 < kLevelNum && current_tick_ % LevelSpan(max_level + 1) == 0) {
+      ++max_level;
+    }
+    for (int level = max_level; level > 0; --level) {
+      Cascade(level);
+    }
+
+    std::vector<uint64_t> timer_ids;
+    timer_ids.swap(slots_[0][current_tick_ & kSlotMask]);
+    for (auto timer_id : timer_ids) {
+      auto it = timers_.find(timer_id);
+      if (it == timers_.end()) {
+        continue;
+      }
+      if (it->second.expire_tick > current_tick_) {
+        PutTimer(timer_id, it->second.expire_tick);
+        continue;
+      }
+
+      expired_funcs.push_back(std::move(it->second.func));
+      timers_.erase(it);
+    }
+  }
+
+  g_timer_wheel_expire_count << expired_funcs.size();
+
+  for (auto& func : expired_funcs) {
+    auto* arg = new Func(std::move(func));
+    bthread_t tid;
+    const bthread_attr_t attr = BTHREAD_ATTR_NORMAL;
+    if (bthread_start_background(&tid, &attr, &RunTimerFunc, arg) != 0) {
+      DINGO_LOG(ERROR) << "[timer_wheel] start timer bthread failed, run in ticker.";
+      RunTimerFunc(arg);
+    }
+  }
+}
+
+int64_t TimerWheel::SpreadOffset(const std::string& key, int64_t interval_ms) {
+  if (interval_ms <= 0) {
+    return 0;
+  }
+  return static_cast<int64_t>(std::hash<std::string>{}(key) % static_cast<uint64_t>(interval_ms));
+}
+
+int64_t TimerWheel::Jitter(int64_t interval_ms, double ratio) {
+  int64_t range = static_cast<int64_t>(interval_ms * ratio);
+  if (range <= 0) {
+    return interval_ms;
+  }
+  return std::max(interval_ms + Helper::GenerateRandomInteger(-range, range), static_cast<int64_t>(0));
+}
+
+}  // namespace dingodb
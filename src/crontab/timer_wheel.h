@@ -0,0 +1,124 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_CRONTAB_TIMER_WHEEL_H_
+#define DINGODB_CRONTAB_TIMER_WHEEL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "bthread/types.h"
+
+namespace dingodb {
+
+// Hierarchical timing wheel, all timers are driven by one ticker bthread instead of one bthread timer each.
+// There are kLevelNum levels of kSlotNum slots, a slot of level n span kSlotNum^n ticks, timer is put into
+// the lowest level which can hold it and is moved down when the upper slot come around.
+// Expired timer func is run in a new background bthread, so a slow func not delay other timers.
+class TimerWheel {
+ public:
+  using Func = std::function<void()>;
+
+  explicit TimerWheel(int64_t tick_ms);
+  ~TimerWheel();
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  // start ticker bthread.
+  bool Start();
+  void Stop();
+
+  // run func after delay_ms, return timer id, 0 is invalid id.
+  uint64_t Schedule(int64_t delay_ms, Func func);
+  // return false if the timer is already run or not exist.
+  bool Cancel(uint64_t timer_id);
+
+  // advance one tick and run expired timers, it is called by ticker bthread.
+  void Tick();
+
+  int64_t TickMs() const { return tick_ms_; }
+  // pending timer count.
+  int64_t Size();
+
+  // stable offset in [0, interval_ms) of the key, used to spread the first run of periodic jobs.
+  static int64_t SpreadOffset(const std::string& key, int64_t interval_ms);
+  // interval_ms with random jitter in [-interval_ms * ratio, interval_ms * ratio].
+  static int64_t Jitter(int64_t interval_ms, double ratio);
+
+ private:
+  static constexpr int kSlotBits = 6;
+  static constexpr int64_t kSlotNum = 1 << kSlotBits;
+  static constexpr int64_t kSlotMask = kSlotNum - 1;
+  static constexpr int kLevelNum = 4;
+
+  struct Timer {
+    int64_t expire_tick{0};
+    Func func;
+  };
+
+  // ticks span by one slot of the level.
+  static constexpr int64_t LevelSpan(int level) { return static_cast<int64_t>(1) << (kSlotBits * level); }
+
+  static void* TickerRun(void* arg);
+
+  // caller hold mutex_
+  void PutTimer(uint64_t timer_id, int64_t expire_tick);
+  // caller hold mutex_, move timers of the slot to lower level.
+  void Cascade(int level);
+
+  const int64_t tick_ms_;
+
+  std::atomic<bool> is_stop_{true};
+  bthread_t ticker_tid_{0};
+
+  bthread_mutex_t mutex_;
+  int64_t current_tick_{0};
+  uint64_t next_timer_id_{1};
+  std::unordered_map<uint64_t, Timer> timers_;
+  // timer ids of every slot, cancelled timer id is skipped when the slot expire.
+  std::vector<uint64_t> slots_[kLevelNum][kSlotNum];
+};
+
+// Spread per-region work of a periodic job across its interval.
+// The job is triggered round_num times per interval and each round only handle regions fall in its turn,
+// so every region is still handled once per interval but the work is not bursting at the same tick.
+class RoundSpreader {
+ public:
+  explicit RoundSpreader(int32_t round_num) : round_num_(round_num > 0 ? round_num : 1) {}
+
+  // called at the beginning of every round.
+  void NextRound() { current_round_.fetch_add(1, std::memory_order_relaxed); }
+
+  bool IsTurn(int64_t region_id) const {
+    int64_t round = current_round_.load(std::memory_order_relaxed);
+    return static_cast<uint64_t>(region_id) % round_num_ == static_cast<uint64_t>(round) % round_num_;
+  }
+
+  int32_t RoundNum() const { return round_num_; }
+
+ private:
+  const int32_t round_num_;
+  std::atomic<int64_t> current_round_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_CRONTAB_TIMER_WHEEL_H_
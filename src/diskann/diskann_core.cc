@@ -30,15 +30,49 @@
 #include "common/logging.h"
 #include "common/synchronization.h"
 #include "disk_utils.h"
+#include "diskann/diskann_item_manager.h"
+#include "diskann/diskann_uring_reader.h"
 #include "diskann/diskann_utils.h"
 #include "distance.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "linux_aligned_file_reader.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 
 namespace dingodb {
 
+DEFINE_string(diskann_reader_backend, "aio", "diskann search disk reader at load, aio or io_uring");
+DEFINE_uint32(diskann_io_uring_queue_depth, 128, "diskann io_uring reader queue depth of every search thread");
+DEFINE_bool(diskann_io_uring_sqpoll, false, "diskann io_uring reader use kernel sq polling thread");
+
+DEFINE_bool(enable_diskann_hot_node_cache, true, "diskann load cache nodes visited by sampled search queries");
+DEFINE_int64(diskann_query_sample_interval, 100, "diskann sample one of this many search queries, 0 is disable");
+DEFINE_int64(diskann_query_sample_max_count, 10000, "diskann max count of sampled search queries");
+DEFINE_int64(diskann_query_sample_save_count, 1000, "diskann save sampled queries after this many new samples");
+
+DEFINE_string(diskann_universal_label, "", "diskann vector with this label match every filter label");
+
+static const std::string kSampleQueryFileName = "_hot_query_sample.bin";
+static const std::string kLabelFileSuffix = "_labels.txt";
+// diskann/apps/search_disk_index.cpp generate_cache_list_from_sample_queries default
+static const uint64_t kSampleQueryLSearch = 15;
+static const uint64_t kSampleQueryBeamWidth = 6;
+
+// io_uring is used only when it is built in and supported by kernel, otherwise fallback to libaio.
+static bool UseUringReader() {
+  if (FLAGS_diskann_reader_backend != "io_uring") {
+    return false;
+  }
+#ifdef ENABLE_LIBURING
+  if (DiskANNUringReader::IsSupported()) {
+    return true;
+  }
+#endif
+  DINGO_LOG(WARNING) << "[diskann] io_uring reader is not available, fallback to aio reader.";
+  return false;
+}
+
 DiskANNCore::DiskANNCore(int64_t vector_index_id, const pb::common::VectorIndexParameter& vector_index_parameter,
                          u_int32_t num_threads, float search_dram_budget_gb, float build_dram_budget_gb,
                          const std::string& data_path, const std::string& index_path_prefix)
@@ -61,11 +95,13 @@ DiskANNCore::DiskANNCore(int64_t vector_index_id, const pb::common::VectorIndexP
       warmup_(true),
       state_(DiskANNCoreState::kUninitialized) {
   state_ = DiskANNCoreState::kInitialized;
+  bthread_mutex_init(&sample_mutex_, nullptr);
 }
 
 DiskANNCore::~DiskANNCore() {
   DiskANNCoreState state;
   Reset(false, state, true);
+  bthread_mutex_destroy(&sample_mutex_);
 }
 
 butil::Status DiskANNCore::Build(bool force_to_build, DiskANNCoreState& state) {
@@ -246,7 +282,8 @@ butil::Status DiskANNCore::Load(const pb::common::LoadDiskAnnParam& load_param,
 
 butil::Status DiskANNCore::Search(uint32_t top_n, const pb::common::SearchDiskAnnParam& search_param,
                                   const std::vector<pb::common::Vector>& vectors, ExistFunction exist_func,
-                                  std::vector<pb::index::VectorWithDistanceResult>& results, DiskANNCoreState& state) {
+                                  std::vector<pb::index::VectorWithDistanceResult>& results, DiskANNCoreState& state,
+                                  const std::string& filter_label) {
   RWLockReadGuard guard(&rw_lock_);
   auto lambda_set_state_function = [&state, this]() { state = state_.load(); };
   ON_SCOPE_EXIT(lambda_set_state_function);
@@ -288,20 +325,43 @@ butil::Status DiskANNCore::Search(uint32_t top_n, const pb::common::SearchDiskAn
   const bool use_reorder_data = false;
   diskann::QueryStats query_stats;
 
+  const bool use_filter = !filter_label.empty();
+  uint32_t converted_label = 0;
+  if (use_filter) {
+    try {
+      converted_label = flash_index_->get_converted_label(filter_label);
+    } catch (const std::exception& e) {
+      std::string s = fmt::format("diskann filter label : {} not found, {} {}", filter_label, e.what(),
+                                  FormatParameter());
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, s);
+    }
+  }
+
   std::vector<std::vector<uint64_t>> result_labels;
   std::vector<std::vector<float>> result_distances;
 
   for (const auto& vector_float : vector_floats) {
     res_ids.resize(k_search, std::numeric_limits<uint64_t>::max());
     res_dists.resize(k_search, std::numeric_limits<float>::max());
+    query_stats = diskann::QueryStats();
     try {
-      flash_index_->cached_beam_search(vector_float.data(), k_search, l_search, res_ids.data(), res_dists.data(),
-                                       beam_width, use_reorder_data, &query_stats);
+      if (use_filter) {
+        flash_index_->cached_beam_search(vector_float.data(), k_search, l_search, res_ids.data(), res_dists.data(),
+                                         beam_width, use_filter, converted_label, use_reorder_data, &query_stats);
+      } else {
+        flash_index_->cached_beam_search(vector_float.data(), k_search, l_search, res_ids.data(), res_dists.data(),
+                                         beam_width, use_reorder_data, &query_stats);
+      }
     } catch (const std::exception& e) {
       std::string s = fmt::format("cached_beam_search exception : {} {}", e.what(), FormatParameter());
       DINGO_LOG(ERROR) << s;
       return butil::Status(pb::error::Errno::EINTERNAL, s);
     }
+    search_io_count_.fetch_add(query_stats.n_ios, std::memory_order_relaxed);
+    search_cache_hit_count_.fetch_add(query_stats.n_cache_hits, std::memory_order_relaxed);
+    SampleQuery(vector_float.data());
+
     result_labels.emplace_back(res_ids);
     result_distances.emplace_back(res_dists);
   }
@@ -348,6 +408,15 @@ butil::Status DiskANNCore::Reset(bool is_delete_files, DiskANNCoreState& state,
   metric_ = diskann::Metric::L2;
   num_nodes_to_cache_ = 0;
   warmup_ = true;
+  {
+    BAIDU_SCOPED_LOCK(sample_mutex_);
+    sample_queries_.clear();
+    sample_next_ = 0;
+    sample_unsaved_count_ = 0;
+  }
+  search_count_.store(0);
+  search_io_count_.store(0);
+  search_cache_hit_count_.store(0);
 
   if (is_delete_files) {
     DiskANNUtils::RemoveFile(data_path_);
@@ -451,7 +520,72 @@ bool DiskANNCore::IsLoad() {
 
 std::string DiskANNCore::Dump() {
   RWLockReadGuard guard(&rw_lock_);
-  return FormatParameter();
+  int64_t io_count = search_io_count_.load(std::memory_order_relaxed);
+  int64_t cache_hit_count = search_cache_hit_count_.load(std::memory_order_relaxed);
+  double cache_hit_ratio =
+      (io_count + cache_hit_count) > 0 ? static_cast<double>(cache_hit_count) / (io_count + cache_hit_count) : 0.0;
+
+  int64_t sample_count = 0;
+  {
+    BAIDU_SCOPED_LOCK(sample_mutex_);
+    sample_count = dimension_ > 0 ? sample_queries_.size() / dimension_ : 0;
+  }
+
+  return FormatParameter() +
+         fmt::format(" search_count:{} search_io_count:{} cache_hit_count:{} cache_hit_ratio:{:.4f} "
+                     "sample_query_count:{}",
+                     search_count_.load(), io_count, cache_hit_count, cache_hit_ratio, sample_count);
+}
+
+std::string DiskANNCore::SampleQueryFile() {
+  std::string index_path_prefix = index_path_prefix_;
+  if (!index_path_prefix.empty() && index_path_prefix.back() != '/') {
+    index_path_prefix += "/";
+  }
+  return index_path_prefix + kSampleQueryFileName;
+}
+
+void DiskANNCore::SampleQuery(const float* query) {
+  int64_t search_count = search_count_.fetch_add(1, std::memory_order_relaxed);
+  if (FLAGS_diskann_query_sample_interval <= 0 || search_count % FLAGS_diskann_query_sample_interval != 0 ||
+      FLAGS_diskann_query_sample_max_count <= 0 || dimension_ == 0) {
+    return;
+  }
+
+  BAIDU_SCOPED_LOCK(sample_mutex_);
+  // replace oldest sample when full, so samples follow the recent query distribution.
+  int64_t capacity = FLAGS_diskann_query_sample_max_count;
+  int64_t pos = sample_next_ % capacity;
+  if (static_cast<int64_t>(sample_queries_.size()) < (pos + 1) * dimension_) {
+    sample_queries_.resize((pos + 1) * dimension_);
+  }
+  memcpy(sample_queries_.data() + pos * dimension_, query, dimension_ * sizeof(float));
+  sample_next_ = pos + 1;
+
+  if (++sample_unsaved_count_ >= FLAGS_diskann_query_sample_save_count) {
+    SaveSampleQueries();
+  }
+}
+
+void DiskANNCore::SaveSampleQueries() {
+  sample_unsaved_count_ = 0;
+  if (index_path_prefix_.empty() || sample_queries_.empty()) {
+    return;
+  }
+
+  std::string file = SampleQueryFile();
+  std::string tmp_file = file + ".tmp";
+  try {
+    diskann::save_bin<float>(tmp_file, sample_queries_.data(), sample_queries_.size() / dimension_, dimension_);
+  } catch (const std::exception& e) {
+    DINGO_LOG(WARNING) << fmt::format("save sample queries exception : {} {}", e.what(), FormatParameter());
+    return;
+  }
+
+  auto status = DiskANNUtils::RenameFile(tmp_file, file);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << status.error_cstr();
+  }
 }
 
 butil::Status DiskANNCore::Count(int64_t& count, DiskANNCoreState& state) {
@@ -542,7 +676,19 @@ butil::Status DiskANNCore::DoBuild(DiskANNCoreState& state, DiskANNCoreState old
     uint32_t max_degree = diskann_parameter.max_degree();
     uint32_t search_list_size = diskann_parameter.search_list_size();
     float search_dram_budget_gb = search_dram_budget_gb_;
+
+    // wait until the build fit build memory budget, shared with other running builds.
+    auto& item_manager = DiskANNItemManager::GetInstance();
+    int64_t estimate_memory = DiskANNItemManager::EstimateBuildMemory(count, dim, max_degree);
+    int64_t build_memory = item_manager.AcquireBuildMemory(vector_index_id_, estimate_memory);
+    ON_SCOPE_EXIT([&item_manager, build_memory, this]() {
+      item_manager.ReleaseBuildMemory(vector_index_id_, build_memory);
+    });
+    // region larger than the budget, diskann build it partitioned when its estimate exceed build_dram_budget_gb.
     float build_dram_budget_gb = build_dram_budget_gb_;
+    if (build_memory < estimate_memory) {
+      build_dram_budget_gb = std::min(build_dram_budget_gb, static_cast<float>(build_memory) / (1024.0f * 1024 * 1024));
+    }
 
     uint32_t disk_pq = diskann_parameter.pq_disk_bytes();
     disk_pq = 0;
@@ -582,10 +728,15 @@ butil::Status DiskANNCore::DoBuild(DiskANNCoreState& state, DiskANNCoreState old
     std::string codebook_prefix = diskann_parameter.codebook_prefix();
     codebook_prefix = "";
 
-    std::string label_file;
-    bool use_filters = (label_file != "");
+    // labels of vectors beside data file, one line of comma separated labels per vector.
+    // build filtered vamana when it exists, search with label only walk the vectors with the label.
+    std::string label_file = data_path_ + kLabelFileSuffix;
+    bool use_filters = DiskANNUtils::FileExistsAndRegular(label_file).ok();
+    if (!use_filters) {
+      label_file = "";
+    }
 
-    std::string universal_label;
+    std::string universal_label = use_filters ? FLAGS_diskann_universal_label : "";
 
     uint32_t filter_threshold = 0;
 
@@ -676,7 +827,16 @@ butil::Status DiskANNCore::DoLoad(const pb::common::LoadDiskAnnParam& load_param
     }
 
     // garbage diskann interface. I modify diskann interface.
+    bool use_uring_reader = UseUringReader();
+#ifdef ENABLE_LIBURING
+    if (use_uring_reader) {
+      reader = std::make_shared<DiskANNUringReader>(FLAGS_diskann_io_uring_queue_depth, FLAGS_diskann_io_uring_sqpoll);
+    } else {
+      reader = std::make_shared<LinuxAlignedFileReader>();
+    }
+#else
     reader = std::make_shared<LinuxAlignedFileReader>();
+#endif
     flash_index = std::make_unique<diskann::PQFlashIndex<float>>(reader, metric);
 
     try {
@@ -688,8 +848,11 @@ butil::Status DiskANNCore::DoLoad(const pb::common::LoadDiskAnnParam& load_param
       }
 
       // diskann/src/linux_aligned_file_reader.cpp #define MAX_EVENTS 1024
+      // io_uring reader not use aio context, no need to check aio-max-nr.
       std::atomic<int64_t> this_aio_wait_count = ++aio_wait_count;
-      butil::Status status = DiskANNUtils::CheckAioRelatedInformation(num_threads_, 1024, this_aio_wait_count);
+      butil::Status status = use_uring_reader ? butil::Status::OK()
+                                              : DiskANNUtils::CheckAioRelatedInformation(num_threads_, 1024,
+                                                                                         this_aio_wait_count);
       if (!status.ok()) {
         aio_wait_count--;
         DINGO_LOG(ERROR) << status.error_cstr();
@@ -734,8 +897,17 @@ butil::Status DiskANNCore::DoLoad(const pb::common::LoadDiskAnnParam& load_param
     warmup = load_param.warmup();
 
     std::vector<uint32_t> node_list;
-    DINGO_LOG(INFO) << "Caching " << num_nodes_to_cache << " nodes around medoid(s)" << std::endl;
-    flash_index->cache_bfs_levels(num_nodes_to_cache, node_list);
+    // nodes visited by sampled queries of last load, bfs from medoid if there is no sample.
+    std::string sample_query_file = index_path_prefix + kSampleQueryFileName;
+    if (FLAGS_enable_diskann_hot_node_cache && num_nodes_to_cache > 0 && file_exists(sample_query_file)) {
+      DINGO_LOG(INFO) << "Caching " << num_nodes_to_cache << " nodes visited by sampled queries" << std::endl;
+      flash_index->generate_cache_list_from_sample_queries(sample_query_file, kSampleQueryLSearch,
+                                                           kSampleQueryBeamWidth, num_nodes_to_cache, num_threads_,
+                                                           node_list);
+    } else {
+      DINGO_LOG(INFO) << "Caching " << num_nodes_to_cache << " nodes around medoid(s)" << std::endl;
+      flash_index->cache_bfs_levels(num_nodes_to_cache, node_list);
+    }
 
     flash_index->load_cache_list(node_list);
     node_list.clear();
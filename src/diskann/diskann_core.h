@@ -18,9 +18,12 @@
 #include <sys/types.h>
 #include <xmmintrin.h>
 
+#include <atomic>
 #include <cstdint>
 #include <string>
+#include <vector>
 
+#include "bthread/mutex.h"
 #include "butil/status.h"
 #include "common/synchronization.h"
 #include "diskann/diskann_utils.h"
@@ -48,9 +51,11 @@ class DiskANNCore {
   butil::Status Build(bool force_to_build, DiskANNCoreState& state);
   butil::Status UpdateIndexPathPrefix(const std::string& index_path_prefix, DiskANNCoreState& state);
   butil::Status Load(const pb::common::LoadDiskAnnParam& load_param, DiskANNCoreState& state);
+  // filter_label is not empty, only search vectors with the label, index must be built with label file.
   butil::Status Search(uint32_t top_n, const pb::common::SearchDiskAnnParam& search_param,
                        const std::vector<pb::common::Vector>& vectors, ExistFunction exist_func,
-                       std::vector<pb::index::VectorWithDistanceResult>& results, DiskANNCoreState& state);
+                       std::vector<pb::index::VectorWithDistanceResult>& results, DiskANNCoreState& state,
+                       const std::string& filter_label = "");
   butil::Status Reset(bool is_delete_files, DiskANNCoreState& state, bool is_force = false);
   butil::Status Init(int64_t vector_index_id, const pb::common::VectorIndexParameter& vector_index_parameter,
                      u_int32_t num_threads, float search_dram_budget_gb, float build_dram_budget_gb,
@@ -75,6 +80,11 @@ class DiskANNCore {
                                  const std::vector<std::vector<uint64_t>>& labels,
                                  std::vector<pb::index::VectorWithDistanceResult>& results);
   std::string FormatParameter();
+  // sample search query, sampled queries are saved to index dir, hot nodes visited by them are cached at load.
+  void SampleQuery(const float* query);
+  // caller hold sample_mutex_
+  void SaveSampleQueries();
+  std::string SampleQueryFile();
 
   int64_t vector_index_id_;
   pb::common::VectorIndexParameter vector_index_parameter_;
@@ -97,6 +107,18 @@ class DiskANNCore {
   bool warmup_;
   std::atomic<DiskANNCoreState> state_;
   RWLock rw_lock_;
+
+  // protect sample_queries_ / sample_next_ / sample_unsaved_count_
+  bthread_mutex_t sample_mutex_;
+  // row major, dimension_ floats of every query
+  std::vector<float> sample_queries_;
+  int64_t sample_next_{0};
+  int64_t sample_unsaved_count_{0};
+  std::atomic<int64_t> search_count_{0};
+  // node reads of search, for cache hit ratio
+  std::atomic<int64_t> search_io_count_{0};
+  std::atomic<int64_t> search_cache_hit_count_{0};
+
   static inline std::atomic<int64_t> aio_wait_count = 0;
 };
 
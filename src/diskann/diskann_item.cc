@@ -82,7 +82,7 @@ DiskANNItem::DiskANNItem(std::shared_ptr<Context> ctx, int64_t vector_index_id,
 }
 
 DiskANNItem::~DiskANNItem() {
-  if (writer_.is_open()) writer_.close();
+  if (writer_.IsOpen()) writer_.Abort();
   if (diskann_core_) diskann_core_.reset();
 #if defined(ENABLE_DISKANN_ID_MAPPING)
   if (id_writer_.is_open()) id_writer_.close();
@@ -149,7 +149,7 @@ butil::Status DiskANNItem::Import(std::shared_ptr<Context> ctx, const std::vecto
     return status;
   }
 
-  if (writer_.is_open()) {
+  if (writer_.IsOpen()) {
     if (ts != ts_) {
       std::string s = fmt::format("diskann import ts is : {}  not equal to last ts : {}", ts, ts_);
       DINGO_LOG(ERROR) << s;
@@ -782,7 +782,7 @@ butil::Status DiskANNItem::DoImport(const std::vector<pb::common::Vector>& vecto
     return butil::Status(pb::error::Errno::EDISKANN_FILE_TRANSFER_QUANTITY_MISMATCH, s);
   }
 
-  if (!writer_.is_open()) {
+  if (!writer_.IsOpen()) {
     last_import_time_ms_ = Helper::TimestampMs();
   }
 
@@ -797,7 +797,7 @@ butil::Status DiskANNItem::DoImport(const std::vector<pb::common::Vector>& vecto
 
   last_import_time_ms_ = current_time_ms;
 
-  if (!writer_.is_open()) {
+  if (!writer_.IsOpen()) {
     state_.store(DiskANNCoreState::kImporting);
     old_state = state_;
     std::string data_path = fmt::format("{}/{}/{}/{}", base_dir, tmp_name, vector_index_id_, input_name);
@@ -805,12 +805,12 @@ butil::Status DiskANNItem::DoImport(const std::vector<pb::common::Vector>& vecto
     DiskANNUtils::CreateDir(base_dir + "/" + tmp_name);
     DiskANNUtils::CreateDir(base_dir + "/" + tmp_name + "/" + std::to_string(vector_index_id_));
     DiskANNUtils::RemoveFile(data_path);
-    diskann::open_file_to_write(writer_, data_path);
+    butil::Status status = writer_.Open(data_path, dimension);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
     data_path_ = data_path;
-    uint32_t count = 0;
-    uint32_t dim = dimension;
-    writer_.write(reinterpret_cast<char*>(&count), sizeof(uint32_t));
-    writer_.write(reinterpret_cast<char*>(&dim), sizeof(uint32_t));
   }
 
 #if defined(ENABLE_DISKANN_ID_MAPPING)
@@ -833,15 +833,16 @@ butil::Status DiskANNItem::DoImport(const std::vector<pb::common::Vector>& vecto
 #endif
 
   for (const auto& vector : vectors) {
-    const auto& vector_value = vector.float_values();
-    uint32_t total = dimension * sizeof(float);
-    uint32_t remain = total;
-    uint32_t already = 0;
-    while (remain > 0) {
-      uint32_t write_size = std::min(remain, (uint32_t)4 * 1024);
-      writer_.write(reinterpret_cast<const char*>(vector_value.data()) + already, write_size);
-      already += write_size;
-      remain -= write_size;
+    if (vector.float_values_size() != static_cast<int>(dimension)) {
+      std::string s = fmt::format("diskann import vector dimension is : {}  not equal to : {}",
+                                  vector.float_values_size(), dimension);
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, s);
+    }
+    butil::Status status = writer_.Append(vector.float_values().data(), 1);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
     }
   }
 
@@ -878,7 +879,6 @@ butil::Status DiskANNItem::DoImport(const std::vector<pb::common::Vector>& vecto
   }
 
   if (!has_more) {
-    writer_.seekp(0, std::ios::beg);
     if (already_recv_vector_count < Constant::kDiskannMinCount) {
       std::string s = fmt::format("diskann import total vector count is : {}  less than : {}, not support build. {}",
                                   already_recv_vector_count, Constant::kDiskannMinCount, FormatParameter());
@@ -887,13 +887,16 @@ butil::Status DiskANNItem::DoImport(const std::vector<pb::common::Vector>& vecto
     }
 
     uint32_t count = already_recv_vector_count;
-    writer_.write(reinterpret_cast<char*>(&count), sizeof(uint32_t));
-    writer_.close();
+    butil::Status status = writer_.Close(count);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
     std::string new_path = fmt::format("{}/{}/{}/{}", base_dir, normal_name, vector_index_id_, input_name);
     DiskANNUtils::CreateDir(base_dir);
     DiskANNUtils::CreateDir(base_dir + "/" + normal_name);
     DiskANNUtils::CreateDir(base_dir + "/" + normal_name + "/" + std::to_string(vector_index_id_));
-    butil::Status status = DiskANNUtils::Rename(data_path_, new_path);
+    status = DiskANNUtils::Rename(data_path_, new_path);
     if (!status.ok()) {
       DINGO_LOG(ERROR) << status.error_cstr();
       return status;
@@ -1228,7 +1231,7 @@ butil::Status DiskANNItem::DoClose(std::shared_ptr<Context> ctx, bool is_destroy
   index_path_prefix_ = "";
   is_import_ = false;
   state_ = DiskANNCoreState::kUnknown;
-  if (writer_.is_open()) writer_.close();
+  if (writer_.IsOpen()) writer_.Abort();
   already_recv_vector_count_ = 0;
   if (diskann_core_) diskann_core_.reset();
 #if defined(ENABLE_DISKANN_ID_MAPPING)
@@ -1309,7 +1312,7 @@ std::string DiskANNItem::FormatParameter() {
       "vector_index_parameter: {} ",
       vector_index_id_, num_threads_, search_dram_budget_gb_, build_dram_budget_gb_, data_path_, index_path_prefix_,
       (is_import_ ? "true" : "false"), DiskANNUtils::DiskANNCoreStateToString(state_),
-      (writer_.is_open() ? "open" : "close"), already_recv_vector_count_, (diskann_core_ ? "exist" : "null"),
+      (writer_.IsOpen() ? "open" : "close"), already_recv_vector_count_, (diskann_core_ ? "exist" : "null"),
       diskann_to_vector_ids_.size(), vector_to_diskann_ids_.size(), (id_writer_.is_open() ? "open" : "close"), id_path_,
       ts_, tso_, last_error_.error_code(), last_error_.error_cstr(), remote_side_, local_side_, error_remote_side_,
       error_local_side_, vector_index_parameter_.ShortDebugString());
@@ -1322,7 +1325,7 @@ std::string DiskANNItem::FormatParameter() {
       "vector_index_parameter: {} ",
       vector_index_id_, num_threads_, search_dram_budget_gb_, build_dram_budget_gb_, data_path_, index_path_prefix_,
       (is_import_ ? "true" : "false"), DiskANNUtils::DiskANNCoreStateToString(state_),
-      (writer_.is_open() ? "open" : "close"), already_recv_vector_count_, (diskann_core_ ? "exist" : "null"), ts, tso,
+      (writer_.IsOpen() ? "open" : "close"), already_recv_vector_count_, (diskann_core_ ? "exist" : "null"), ts, tso,
       last_error.error_code(), last_error_.error_cstr(), remote_side_, local_side_, error_remote_side_,
       error_local_side_, vector_index_parameter_.ShortDebugString());
 #endif
@@ -1338,7 +1341,7 @@ std::string DiskANNItem::MiniFormatParameter() {
       "vector_to_diskann_ids.size():{} id_writer:{} id_path:\"{}\" ts:{} tso:{} last_error : {} {} remote_side:{} "
       "local_side:{} error_remote_side:{} error_local_side:{} ",
       (is_import_ ? "true" : "false"), DiskANNUtils::DiskANNCoreStateToString(state_),
-      (writer_.is_open() ? "open" : "close"), already_recv_vector_count_, (diskann_core_ ? "exist" : "null"),
+      (writer_.IsOpen() ? "open" : "close"), already_recv_vector_count_, (diskann_core_ ? "exist" : "null"),
       diskann_to_vector_ids_.size(), vector_to_diskann_ids_.size(), (id_writer_.is_open() ? "open" : "close"), id_path_,
       ts_, tso_, last_error_.error_code(), last_error_.error_cstr(), remote_side_, local_side_, error_remote_side_,
       error_local_side_);
@@ -1348,7 +1351,7 @@ std::string DiskANNItem::MiniFormatParameter() {
       "already_recv_vector_count:{} diskann_core:\"{}\" ts:{} tso:{} last_error_ : {} {} remote_side:{} "
       "local_side:{} error_remote_side:{} error_local_side:{} ",
       (is_import_ ? "true" : "false"), DiskANNUtils::DiskANNCoreStateToString(state_),
-      (writer_.is_open() ? "open" : "close"), already_recv_vector_count_, (diskann_core_ ? "exist" : "null"), ts, tso,
+      (writer_.IsOpen() ? "open" : "close"), already_recv_vector_count_, (diskann_core_ ? "exist" : "null"), ts, tso,
       last_error.error_code(), last_error_.error_cstr(), remote_side_, local_side_, error_remote_side_,
       error_local_side_);
 #endif
@@ -1372,7 +1375,7 @@ void DiskANNItem::NoDataSymbolCreate() {
   DiskANNUtils::CreateDir(base_dir + "/" + nodata_name);
   std::string nodata_path = fmt::format("{}/{}/{}", base_dir, nodata_name, std::to_string(vector_index_id_));
   std::ofstream writer_nodata;
-  diskann::open_file_to_write(writer_, nodata_path);
+  diskann::open_file_to_write(writer_nodata, nodata_path);
   writer_nodata.close();
 }
 
@@ -28,6 +28,7 @@
 #include "common/context.h"
 #include "common/synchronization.h"
 #include "diskann/diskann_core.h"
+#include "diskann/diskann_staging_writer.h"
 #include "diskann/diskann_utils.h"
 #include "proto/common.pb.h"
 #include "proto/index.pb.h"
@@ -114,7 +115,7 @@ class DiskANNItem : public std::enable_shared_from_this<DiskANNItem> {
   std::string index_path_prefix_;
   bool is_import_;
   std::atomic<DiskANNCoreState> state_;
-  std::ofstream writer_;
+  DiskANNStagingWriter writer_;
   int64_t already_recv_vector_count_;
   std::shared_ptr<DiskANNCore> diskann_core_;
 #if defined(ENABLE_DISKANN_ID_MAPPING)
@@ -20,15 +20,18 @@
 #include <algorithm>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include "bthread/mutex.h"
 #include "butil/status.h"
 #include "common/constant.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
 #include "diskann/diskann_utils.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 
@@ -44,15 +47,23 @@
 #endif
 namespace dingodb {
 
+DEFINE_double(diskann_build_total_dram_budget_gb, 0.0,
+              "total dram of all running diskann builds, 0 is build_dram_budget_gb of config");
+
 DiskANNItemManager::DiskANNItemManager()
     : num_threads_(Constant::kDiskannNumThreadsDefaultValue),
       search_dram_budget_gb_(Constant::kDiskannSearchDramBudgetGbDefaultValue),
       build_dram_budget_gb_(Constant::kDiskannBuildDramBudgetGbDefaultValue),
-      import_timeout_s_(Constant::kDiskannImportTimeoutSecondDefaultValue) {}
+      import_timeout_s_(Constant::kDiskannImportTimeoutSecondDefaultValue) {
+  bthread_mutex_init(&build_mutex_, nullptr);
+  bthread_cond_init(&build_cond_, nullptr);
+}
 
 DiskANNItemManager::~DiskANNItemManager() {
   RWLockWriteGuard guard(&rw_lock_);
   items_.clear();
+  bthread_cond_destroy(&build_cond_);
+  bthread_mutex_destroy(&build_mutex_);
 }
 
 bool DiskANNItemManager::Init(std::shared_ptr<Config> config) {
@@ -191,4 +202,52 @@ void DiskANNItemManager::SetSimdHookForDiskANN() {
 #endif
 }
 
+int64_t DiskANNItemManager::EstimateBuildMemory(int64_t count, int64_t dimension, uint32_t max_degree) {
+  // diskann/include/defaults.h GRAPH_SLACK_FACTOR and OVERHEAD_FACTOR
+  const double kGraphSlackFactor = 1.3;
+  const double kOverheadFactor = 1.1;
+
+  double data_size = static_cast<double>(count) * ((dimension + 7) / 8 * 8) * sizeof(float);
+  double graph_size = static_cast<double>(count) * max_degree * sizeof(uint32_t) * kGraphSlackFactor;
+  double locks_size = static_cast<double>(count) * sizeof(std::mutex);
+  return static_cast<int64_t>(kOverheadFactor * (data_size + graph_size + locks_size));
+}
+
+int64_t DiskANNItemManager::BuildMemoryBudget() const {
+  double budget_gb = FLAGS_diskann_build_total_dram_budget_gb > 1e-6 ? FLAGS_diskann_build_total_dram_budget_gb
+                                                                       : build_dram_budget_gb_;
+  return static_cast<int64_t>(budget_gb * 1024 * 1024 * 1024);
+}
+
+int64_t DiskANNItemManager::AcquireBuildMemory(int64_t vector_index_id, int64_t estimate_memory) {
+  int64_t budget = BuildMemoryBudget();
+  int64_t memory = std::max(std::min(estimate_memory, budget), static_cast<int64_t>(1));
+
+  BAIDU_SCOPED_LOCK(build_mutex_);
+  build_waiters_.push_back(vector_index_id);
+  while (build_waiters_.front() != vector_index_id ||
+         (build_memory_in_use_ > 0 && build_memory_in_use_ + memory > budget)) {
+    bthread_cond_wait(&build_cond_, &build_mutex_);
+  }
+  build_waiters_.pop_front();
+  build_memory_in_use_ += memory;
+  // next waiter may fit too
+  bthread_cond_broadcast(&build_cond_);
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[diskann.build][id({})] acquire build memory, estimate({}) granted({}) in_use({}) budget({}) waiting({})",
+      vector_index_id, estimate_memory, memory, build_memory_in_use_, budget, build_waiters_.size());
+
+  return memory;
+}
+
+void DiskANNItemManager::ReleaseBuildMemory(int64_t vector_index_id, int64_t memory) {
+  BAIDU_SCOPED_LOCK(build_mutex_);
+  build_memory_in_use_ -= memory;
+  bthread_cond_broadcast(&build_cond_);
+
+  DINGO_LOG(INFO) << fmt::format("[diskann.build][id({})] release build memory({}) in_use({})", vector_index_id,
+                                 memory, build_memory_in_use_);
+}
+
 }  // namespace dingodb
@@ -19,8 +19,10 @@
 #include <xmmintrin.h>
 
 #include <cstdint>
+#include <deque>
 #include <string>
 
+#include "bthread/bthread.h"
 #include "butil/status.h"
 #include "common/synchronization.h"
 #include "config/config.h"
@@ -66,8 +68,19 @@ class DiskANNItemManager : public DiskANNItemManagerSingleton<DiskANNItemManager
 
   static void SetSimdHookForDiskANN();
 
+  // memory of building diskann graph in memory, same formula as diskann estimate_ram_usage.
+  static int64_t EstimateBuildMemory(int64_t count, int64_t dimension, uint32_t max_degree);
+
+  // Builds run in parallel as long as sum of their memory fit the build budget, others wait in fifo order.
+  // Return memory granted to the build, it is the budget when estimate is larger than the budget,
+  // then diskann build it partitioned and merge shards within granted memory.
+  int64_t AcquireBuildMemory(int64_t vector_index_id, int64_t estimate_memory);
+  void ReleaseBuildMemory(int64_t vector_index_id, int64_t memory);
+
  protected:
  private:
+  int64_t BuildMemoryBudget() const;
+
   std::string path_;
   uint32_t num_threads_;
   float search_dram_budget_gb_;
@@ -75,6 +88,12 @@ class DiskANNItemManager : public DiskANNItemManagerSingleton<DiskANNItemManager
   int64_t import_timeout_s_;
   std::map<int64_t, std::shared_ptr<DiskANNItem>> items_;
   RWLock rw_lock_;
+
+  // protect build_waiters_ and build_memory_in_use_
+  bthread_mutex_t build_mutex_;
+  bthread_cond_t build_cond_;
+  std::deque<int64_t> build_waiters_;
+  int64_t build_memory_in_use_{0};
 };
 
 }  // namespace dingodb
@@ -27,7 +27,8 @@ DEFINE_bool(use_pthread_diskann_misc_worker_set, true, "use pthread diskann misc
 
 DEFINE_int32(diskann_import_worker_num, 32, "the number of import worker used by diskann_service");
 DEFINE_int32(diskann_import_worker_max_pending_num, 1024, "diskann_import_worker_max_pending_num");
-DEFINE_int32(diskann_build_worker_num, 1, "the number of build worker used by diskann_service");
+DEFINE_int32(diskann_build_worker_num, 4,
+             "the number of build worker used by diskann_service, running builds are limited by build memory budget");
 DEFINE_int32(diskann_build_worker_max_pending_num, 128, " 0 is unlimited");
 DEFINE_int32(diskann_load_worker_num, 10, "the number of load worker used by diskann_service");
 DEFINE_int32(diskann_load_worker_max_pending_num, 512, "0 is unlimited");
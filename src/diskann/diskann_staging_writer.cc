@@ -0,0 +1,211 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "diskann/diskann_staging_writer.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+DEFINE_int64(diskann_import_staging_buffer_size, 4 * 1024 * 1024,
+             "diskann import staging buffer size, two buffers are used for double buffering");
+
+// direct io alignment of offset, size and buffer address
+static const size_t kDirectIoAlignment = 4096;
+
+static size_t AlignUp(size_t size) { return (size + kDirectIoAlignment - 1) / kDirectIoAlignment * kDirectIoAlignment; }
+
+static butil::Status WriteFull(int fd, const char* data, size_t size, int64_t offset) {
+  size_t written = 0;
+  while (written < size) {
+    ssize_t ret = pwrite(fd, data + written, size - written, offset + written);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return butil::Status(pb::error::Errno::EINTERNAL,
+                           fmt::format("pwrite failed, offset: {} size: {} error: {}", offset, size, strerror(errno)));
+    }
+    written += ret;
+  }
+  return butil::Status::OK();
+}
+
+DiskANNStagingWriter::DiskANNStagingWriter() = default;
+
+DiskANNStagingWriter::~DiskANNStagingWriter() { Abort(); }
+
+butil::Status DiskANNStagingWriter::Open(const std::string& path, uint32_t dimension) {
+  if (IsOpen()) {
+    return butil::Status(pb::error::Errno::EINTERNAL, fmt::format("staging file {} already open", path_));
+  }
+
+  buffer_size_ = AlignUp(std::max(FLAGS_diskann_import_staging_buffer_size, static_cast<int64_t>(kDirectIoAlignment)));
+  for (auto& buffer : buffers_) {
+    buffer = static_cast<char*>(std::aligned_alloc(kDirectIoAlignment, buffer_size_));
+    if (buffer == nullptr) {
+      FreeBuffers();
+      return butil::Status(pb::error::Errno::EINTERNAL, "alloc staging buffer failed");
+    }
+  }
+
+  direct_io_ = true;
+  fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+  if (fd_ < 0 && errno == EINVAL) {
+    // e.g. tmpfs not support direct io
+    DINGO_LOG(WARNING) << fmt::format("staging file {} not support direct io, use buffered io", path);
+    direct_io_ = false;
+    fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  }
+  if (fd_ < 0) {
+    FreeBuffers();
+    return butil::Status(pb::error::Errno::EINTERNAL,
+                         fmt::format("open staging file {} failed, error: {}", path, strerror(errno)));
+  }
+
+  path_ = path;
+  dimension_ = dimension;
+  current_ = 0;
+  offset_ = 0;
+  flush_status_ = butil::Status::OK();
+
+  // header, count is written at close.
+  uint32_t header[2] = {0, dimension};
+  memcpy(buffers_[current_], header, sizeof(header));
+  current_size_ = sizeof(header);
+
+  return butil::Status::OK();
+}
+
+butil::Status DiskANNStagingWriter::Append(const float* data, uint32_t count) {
+  const char* src = reinterpret_cast<const char*>(data);
+  size_t remain = static_cast<size_t>(count) * dimension_ * sizeof(float);
+  while (remain > 0) {
+    size_t copy_size = std::min(remain, buffer_size_ - current_size_);
+    memcpy(buffers_[current_] + current_size_, src, copy_size);
+    current_size_ += copy_size;
+    src += copy_size;
+    remain -= copy_size;
+
+    if (current_size_ == buffer_size_) {
+      auto status = SwitchBuffer();
+      if (!status.ok()) {
+        return status;
+      }
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status DiskANNStagingWriter::SwitchBuffer() {
+  // the other buffer must be written before it is reused.
+  auto status = WaitFlush();
+  if (!status.ok()) {
+    return status;
+  }
+
+  const char* buffer = buffers_[current_];
+  int64_t offset = offset_;
+  size_t size = buffer_size_;
+  flush_thread_ = std::thread([this, buffer, offset, size]() { flush_status_ = WriteFull(fd_, buffer, size, offset); });
+
+  offset_ += buffer_size_;
+  current_ = 1 - current_;
+  current_size_ = 0;
+  return butil::Status::OK();
+}
+
+butil::Status DiskANNStagingWriter::WaitFlush() {
+  if (flush_thread_.joinable()) {
+    flush_thread_.join();
+  }
+  return flush_status_;
+}
+
+butil::Status DiskANNStagingWriter::Close(uint32_t count) {
+  if (!IsOpen()) {
+    return butil::Status(pb::error::Errno::EINTERNAL, "staging file not open");
+  }
+
+  auto status = WaitFlush();
+  if (status.ok() && current_size_ > 0) {
+    // direct io write whole aligned blocks, tail padding is truncated later.
+    size_t size = direct_io_ ? AlignUp(current_size_) : current_size_;
+    memset(buffers_[current_] + current_size_, 0, size - current_size_);
+    status = WriteFull(fd_, buffers_[current_], size, offset_);
+  }
+
+  int64_t file_size = offset_ + current_size_;
+  if (status.ok() && ftruncate(fd_, file_size) != 0) {
+    status = butil::Status(pb::error::Errno::EINTERNAL,
+                           fmt::format("truncate staging file {} failed, error: {}", path_, strerror(errno)));
+  }
+  close(fd_);
+  fd_ = -1;
+  FreeBuffers();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  // header is not aligned, write it by buffered io.
+  int fd = open(path_.c_str(), O_WRONLY);
+  if (fd < 0) {
+    return butil::Status(pb::error::Errno::EINTERNAL,
+                         fmt::format("open staging file {} failed, error: {}", path_, strerror(errno)));
+  }
+  status = WriteFull(fd, reinterpret_cast<const char*>(&count), sizeof(count), 0);
+  if (status.ok() && fsync(fd) != 0) {
+    status = butil::Status(pb::error::Errno::EINTERNAL,
+                           fmt::format("fsync staging file {} failed, error: {}", path_, strerror(errno)));
+  }
+  close(fd);
+
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+  }
+  return status;
+}
+
+void DiskANNStagingWriter::Abort() {
+  WaitFlush();
+  if (fd_ >= 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+  FreeBuffers();
+}
+
+void DiskANNStagingWriter::FreeBuffers() {
+  for (auto& buffer : buffers_) {
+    free(buffer);
+    buffer = nullptr;
+  }
+}
+
+}  // namespace dingodb
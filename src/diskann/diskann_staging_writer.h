@@ -0,0 +1,73 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_DISKANN_DISKANN_STAGING_WRITER_H_  // NOLINT
+#define DINGODB_DISKANN_DISKANN_STAGING_WRITER_H_
+
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "butil/status.h"
+
+namespace dingodb {
+
+// Writer of imported vectors to diskann .bin file(uint32 count, uint32 dim, count * dim floats).
+// Vectors are copied to one of two aligned buffers, a full buffer is written by direct io in background
+// while the other one is filled, so import memory is two buffers regardless of vector count, and the
+// imported data not pollute page cache which build need. Fallback to buffered io if direct io is not supported.
+class DiskANNStagingWriter {
+ public:
+  DiskANNStagingWriter();
+  ~DiskANNStagingWriter();
+
+  DiskANNStagingWriter(const DiskANNStagingWriter&) = delete;
+  DiskANNStagingWriter& operator=(const DiskANNStagingWriter&) = delete;
+
+  butil::Status Open(const std::string& path, uint32_t dimension);
+  // append count vectors, every vector is dimension floats.
+  butil::Status Append(const float* data, uint32_t count);
+  // flush all data and write vector count to header.
+  butil::Status Close(uint32_t count);
+  // close without flush, e.g. import is aborted.
+  void Abort();
+
+  bool IsOpen() const { return fd_ >= 0; }
+
+ private:
+  // write the filling buffer in background and switch to the other one.
+  butil::Status SwitchBuffer();
+  // wait background write
+  butil::Status WaitFlush();
+  void FreeBuffers();
+
+  std::string path_;
+  uint32_t dimension_{0};
+  int fd_{-1};
+  bool direct_io_{false};
+
+  size_t buffer_size_{0};
+  char* buffers_[2]{nullptr, nullptr};
+  int current_{0};
+  size_t current_size_{0};
+  // file offset of current buffer
+  int64_t offset_{0};
+
+  std::thread flush_thread_;
+  butil::Status flush_status_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_DISKANN_DISKANN_STAGING_WRITER_H_  // NOLINT
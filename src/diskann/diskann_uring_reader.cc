@@ -0,0 +1,193 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef ENABLE_LIBURING
+
+#include "diskann/diskann_uring_reader.h"
+
+#include <fcntl.h>
+#include <liburing.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/logging.h"
+#include "fmt/core.h"
+
+namespace dingodb {
+
+// idle time of sqpoll kernel thread before it sleep.
+static const uint32_t kSqThreadIdleMs = 10;
+
+static io_uring* ToRing(IOContext ctx) { return reinterpret_cast<io_uring*>(ctx); }
+
+static void DestroyRing(IOContext ctx) {
+  auto* ring = ToRing(ctx);
+  if (ring != nullptr) {
+    io_uring_queue_exit(ring);
+    delete ring;
+  }
+}
+
+DiskANNUringReader::DiskANNUringReader(uint32_t queue_depth, bool sqpoll)
+    : queue_depth_(std::max(queue_depth, 1u)), sqpoll_(sqpoll) {}
+
+DiskANNUringReader::~DiskANNUringReader() {
+  deregister_all_threads();
+  close();
+}
+
+bool DiskANNUringReader::IsSupported() {
+  static const bool kSupported = []() {
+    io_uring ring;
+    int ret = io_uring_queue_init(1, &ring, 0);
+    if (ret < 0) {
+      DINGO_LOG(WARNING) << fmt::format("[diskann.uring] io_uring not supported, error: {}", strerror(-ret));
+      return false;
+    }
+    io_uring_queue_exit(&ring);
+    return true;
+  }();
+
+  return kSupported;
+}
+
+IOContext& DiskANNUringReader::get_ctx() {
+  std::unique_lock<std::mutex> lk(ctx_mut);
+  auto it = ctx_map.find(std::this_thread::get_id());
+  if (it == ctx_map.end()) {
+    throw std::runtime_error("[diskann.uring] thread is not registered");
+  }
+  return it.value();
+}
+
+void DiskANNUringReader::register_thread() {
+  auto thread_id = std::this_thread::get_id();
+  std::unique_lock<std::mutex> lk(ctx_mut);
+  if (ctx_map.find(thread_id) != ctx_map.end()) {
+    DINGO_LOG(WARNING) << "[diskann.uring] multiple calls to register_thread from the same thread";
+    return;
+  }
+
+  auto* ring = new io_uring;
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  if (sqpoll_) {
+    params.flags |= IORING_SETUP_SQPOLL;
+    params.sq_thread_idle = kSqThreadIdleMs;
+  }
+
+  int ret = io_uring_queue_init_params(queue_depth_, ring, &params);
+  if (ret < 0) {
+    delete ring;
+    throw std::runtime_error(fmt::format("[diskann.uring] io_uring_queue_init failed, error: {}", strerror(-ret)));
+  }
+
+  // fixed file save fget/fput of every read, and it is required by sqpoll on old kernel.
+  ret = io_uring_register_files(ring, &file_desc_, 1);
+  if (ret < 0) {
+    DestroyRing(reinterpret_cast<IOContext>(ring));
+    throw std::runtime_error(fmt::format("[diskann.uring] io_uring_register_files failed, error: {}", strerror(-ret)));
+  }
+
+  ctx_map[thread_id] = reinterpret_cast<IOContext>(ring);
+}
+
+void DiskANNUringReader::deregister_thread() {
+  std::unique_lock<std::mutex> lk(ctx_mut);
+  auto it = ctx_map.find(std::this_thread::get_id());
+  if (it == ctx_map.end()) {
+    return;
+  }
+  DestroyRing(it->second);
+  ctx_map.erase(it);
+}
+
+void DiskANNUringReader::deregister_all_threads() {
+  std::unique_lock<std::mutex> lk(ctx_mut);
+  for (auto& [thread_id, ctx] : ctx_map) {
+    DestroyRing(ctx);
+  }
+  ctx_map.clear();
+}
+
+void DiskANNUringReader::open(const std::string& fname) {
+  file_desc_ = ::open(fname.c_str(), O_RDONLY | O_DIRECT | O_LARGEFILE);
+  if (file_desc_ < 0) {
+    throw std::runtime_error(fmt::format("[diskann.uring] open {} failed, error: {}", fname, strerror(errno)));
+  }
+}
+
+void DiskANNUringReader::close() {
+  if (file_desc_ >= 0) {
+    ::close(file_desc_);
+    file_desc_ = -1;
+  }
+}
+
+void DiskANNUringReader::read(std::vector<AlignedRead>& read_reqs, IOContext& ctx, bool /*async*/) {
+  auto* ring = ToRing(ctx);
+  if (ring == nullptr) {
+    throw std::runtime_error("[diskann.uring] read with invalid ctx");
+  }
+
+  for (size_t start = 0; start < read_reqs.size(); start += queue_depth_) {
+    size_t batch_size = std::min(static_cast<size_t>(queue_depth_), read_reqs.size() - start);
+    for (size_t i = 0; i < batch_size; ++i) {
+      auto& req = read_reqs[start + i];
+      io_uring_sqe* sqe = io_uring_get_sqe(ring);
+      // fixed file index 0 is the index file
+      io_uring_prep_read(sqe, 0, req.buf, req.len, req.offset);
+      sqe->flags |= IOSQE_FIXED_FILE;
+      io_uring_sqe_set_data(sqe, &req);
+    }
+
+    int ret = io_uring_submit_and_wait(ring, batch_size);
+    if (ret < 0) {
+      throw std::runtime_error(fmt::format("[diskann.uring] submit failed, error: {}", strerror(-ret)));
+    }
+
+    // reap all cqes of the batch before throw, ring is reused by next read.
+    std::string error;
+    for (size_t i = 0; i < batch_size; ++i) {
+      io_uring_cqe* cqe = nullptr;
+      ret = io_uring_wait_cqe(ring, &cqe);
+      if (ret < 0) {
+        throw std::runtime_error(fmt::format("[diskann.uring] wait cqe failed, error: {}", strerror(-ret)));
+      }
+      auto* req = static_cast<AlignedRead*>(io_uring_cqe_get_data(cqe));
+      if (cqe->res < 0 || static_cast<uint64_t>(cqe->res) != req->len) {
+        error = fmt::format("[diskann.uring] read failed, offset: {} len: {} res: {}", req->offset, req->len,
+                            cqe->res < 0 ? strerror(-cqe->res) : std::to_string(cqe->res));
+      }
+      io_uring_cqe_seen(ring, cqe);
+    }
+
+    if (!error.empty()) {
+      throw std::runtime_error(error);
+    }
+  }
+}
+
+}  // namespace dingodb
+
+#endif  // ENABLE_LIBURING
@@ -0,0 +1,65 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_DISKANN_DISKANN_URING_READER_H_  // NOLINT
+#define DINGODB_DISKANN_DISKANN_URING_READER_H_
+
+#ifdef ENABLE_LIBURING
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "aligned_file_reader.h"
+
+namespace dingodb {
+
+// io_uring backend of diskann beam search reader, replace LinuxAlignedFileReader(libaio).
+// Every registered thread own a ring with the index file registered as fixed file, the ring pointer is
+// stored as IOContext, so the scratch of PQFlashIndex carry its ring to whatever thread it is used.
+// Optional SQPOLL let kernel thread poll submission queue, no syscall for submit when it is busy.
+class DiskANNUringReader : public AlignedFileReader {
+ public:
+  DiskANNUringReader(uint32_t queue_depth, bool sqpoll);
+  ~DiskANNUringReader() override;
+
+  DiskANNUringReader(const DiskANNUringReader&) = delete;
+  DiskANNUringReader& operator=(const DiskANNUringReader&) = delete;
+
+  // kernel support io_uring, probe once.
+  static bool IsSupported();
+
+  IOContext& get_ctx() override;
+
+  void register_thread() override;
+  void deregister_thread() override;
+  void deregister_all_threads() override;
+
+  void open(const std::string& fname) override;
+  void close() override;
+
+  // read all reqs, async is ignored same as LinuxAlignedFileReader.
+  void read(std::vector<AlignedRead>& read_reqs, IOContext& ctx, bool async = false) override;
+
+ private:
+  uint32_t queue_depth_;
+  bool sqpoll_;
+  int file_desc_{-1};
+};
+
+}  // namespace dingodb
+
+#endif  // ENABLE_LIBURING
+
+#endif  // DINGODB_DISKANN_DISKANN_URING_READER_H_  // NOLINT
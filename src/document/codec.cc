@@ -17,6 +17,7 @@
 #include <cstdint>
 #include <nlohmann/json.hpp>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include "common/constant.h"
@@ -32,6 +33,17 @@
 
 namespace dingodb {
 
+// package fixed length key prefix|partition_id|document_id into buf, avoid allocate memory
+static void PackageFixedDocumentKey(char prefix, int64_t partition_id, int64_t document_id, char* buf) {
+  CHECK(prefix != 0) << fmt::format("Invalid prefix {}.", prefix);
+  CHECK(partition_id > 0) << fmt::format("Invalid partition_id {}.", partition_id);
+  CHECK(document_id >= 0) << fmt::format("Invalid document_id {}.", document_id);
+
+  buf[0] = prefix;
+  SerialHelper::WriteLong(partition_id, buf + 1);
+  SerialHelper::WriteLongComparable(document_id, buf + 9);
+}
+
 std::string DocumentCodec::PackageDocumentKey(char prefix, int64_t partition_id) {
   CHECK(prefix != 0) << fmt::format("Invalid prefix {}.", prefix);
   CHECK(partition_id > 0) << fmt::format("Invalid partition_id {}.", partition_id);
@@ -113,15 +125,21 @@ std::string DocumentCodec::EncodeDocumentKey(char prefix, int64_t partition_id)
 }
 
 std::string DocumentCodec::EncodeDocumentKey(char prefix, int64_t partition_id, int64_t document_id) {
-  std::string plain_key = PackageDocumentKey(prefix, partition_id, document_id);
+  char plain_key[Constant::kDocumentKeyMaxLenWithPrefix];
+  PackageFixedDocumentKey(prefix, partition_id, document_id, plain_key);
 
-  return mvcc::Codec::EncodeBytes(plain_key);
+  std::string encode_key;
+  mvcc::Codec::EncodeBytes(std::string_view(plain_key, sizeof(plain_key)), encode_key);
+  return std::move(encode_key);
 }
 
 std::string DocumentCodec::EncodeDocumentKey(char prefix, int64_t partition_id, int64_t document_id, int64_t ts) {
-  std::string plain_key = PackageDocumentKey(prefix, partition_id, document_id);
+  char plain_key[Constant::kDocumentKeyMaxLenWithPrefix];
+  PackageFixedDocumentKey(prefix, partition_id, document_id, plain_key);
 
-  return mvcc::Codec::EncodeKey(plain_key, ts);
+  std::string encode_key;
+  mvcc::Codec::EncodeKey(std::string_view(plain_key, sizeof(plain_key)), ts, encode_key);
+  return std::move(encode_key);
 }
 
 std::string DocumentCodec::EncodeDocumentKey(char prefix, int64_t partition_id, int64_t document_id,
@@ -138,46 +156,72 @@ std::string DocumentCodec::EncodeDocumentKey(char prefix, int64_t partition_id,
   return mvcc::Codec::EncodeKey(plain_key, ts);
 }
 
+// decode partition_id and document_id from encode key, key without scalar key is decoded in stack buffer
+static void DecodeFixedDocumentKey(const std::string_view& encode_key, int64_t& partition_id, int64_t& document_id) {
+  // long scalar key, decode in heap
+  if (encode_key.size() != 18 && encode_key.size() != 27) {
+    std::string plain_key;
+    bool ret = mvcc::Codec::DecodeBytes(encode_key, plain_key);
+    CHECK(ret) << fmt::format("Decode document key({}) fail.", Helper::StringToHex(encode_key));
+
+    partition_id = DocumentCodec::UnPackagePartitionId(plain_key);
+    document_id = DocumentCodec::UnPackageDocumentId(plain_key);
+    return;
+  }
+
+  char plain_key[mvcc::Codec::DecodeBytesMaxLength(27)];
+  size_t length = 0;
+  bool ret = mvcc::Codec::DecodeBytes(encode_key, plain_key, length);
+  CHECK(ret) << fmt::format("Decode document key({}) fail.", Helper::StringToHex(encode_key));
+  CHECK(length == Constant::kDocumentKeyMinLenWithPrefix || length >= Constant::kDocumentKeyMaxLenWithPrefix)
+      << fmt::format("Decode document key({}) fail, invalid length.", Helper::StringToHex(encode_key));
+
+  partition_id = SerialHelper::ReadLong(std::string_view(plain_key + 1, 8));
+  document_id = length >= Constant::kDocumentKeyMaxLenWithPrefix
+                ? SerialHelper::ReadLongComparable(std::string_view(plain_key + 9, 8))
+                : 0;
+}
+
 int64_t DocumentCodec::DecodePartitionIdFromEncodeKey(const std::string& encode_key) {
   CHECK((encode_key.size() == 18 || encode_key.size() >= 27)) << "encode_key length is invalid.";
 
-  std::string plain_key;
-  bool ret = mvcc::Codec::DecodeBytes(encode_key, plain_key);
-  CHECK(ret) << fmt::format("Decode document key{} fail.", Helper::StringToHex(encode_key));
+  int64_t partition_id = 0;
+  int64_t document_id = 0;
+  DecodeFixedDocumentKey(encode_key, partition_id, document_id);
 
-  return UnPackagePartitionId(plain_key);
+  return partition_id;
 }
 
 int64_t DocumentCodec::DecodePartitionIdFromEncodeKeyWithTs(const std::string& encode_key_with_ts) {
   CHECK((encode_key_with_ts.size() == 26 || encode_key_with_ts.size() >= 35))
       << "encode_key_with_ts length is invalid.";
 
-  std::string plain_key;
-  bool ret = mvcc::Codec::DecodeBytes(TruncateTsForKey(encode_key_with_ts), plain_key);
-  CHECK(ret) << fmt::format("Decode document key{} fail.", Helper::StringToHex(encode_key_with_ts));
+  int64_t partition_id = 0;
+  int64_t document_id = 0;
+  DecodeFixedDocumentKey(TruncateTsForKey(encode_key_with_ts), partition_id, document_id);
 
-  return UnPackagePartitionId(plain_key);
+  return partition_id;
 }
 
 int64_t DocumentCodec::DecodeDocumentIdFromEncodeKey(const std::string& encode_key) {
   CHECK((encode_key.size() == 18 || encode_key.size() >= 27)) << "encode_key length is invalid.";
 
-  std::string plain_key;
-  bool ret = mvcc::Codec::DecodeBytes(encode_key, plain_key);
-  CHECK(ret) << fmt::format("Decode document key{} fail.", Helper::StringToHex(encode_key));
+  int64_t partition_id = 0;
+  int64_t document_id = 0;
+  DecodeFixedDocumentKey(encode_key, partition_id, document_id);
 
-  return UnPackageDocumentId(plain_key);
+  return document_id;
 }
 
 int64_t DocumentCodec::DecodeDocumentIdFromEncodeKeyWithTs(const std::string& encode_key_with_ts) {
   CHECK((encode_key_with_ts.size() == 26 || encode_key_with_ts.size() >= 35))
       << "encode_key_with_ts length is invalid.";
 
-  std::string plain_key;
-  bool ret = mvcc::Codec::DecodeBytes(TruncateTsForKey(encode_key_with_ts), plain_key);
-  CHECK(ret) << fmt::format("Decode document key{} fail.", Helper::StringToHex(encode_key_with_ts));
+  int64_t partition_id = 0;
+  int64_t document_id = 0;
+  DecodeFixedDocumentKey(TruncateTsForKey(encode_key_with_ts), partition_id, document_id);
 
-  return UnPackageDocumentId(plain_key);
+  return document_id;
 }
 
 std::string DocumentCodec::DecodeScalarKeyFromEncodeKey(const std::string& encode_key) {
@@ -204,12 +248,7 @@ std::string DocumentCodec::DecodeScalarKeyFromEncodeKeyWithTs(const std::string&
 void DocumentCodec::DecodeFromEncodeKey(const std::string& encode_key, int64_t& partition_id, int64_t& document_id) {
   CHECK((encode_key.size() == 18 || encode_key.size() >= 27)) << "encode_key length is invalid.";
 
-  std::string plain_key;
-  bool ret = mvcc::Codec::DecodeBytes(encode_key, plain_key);
-  CHECK(ret) << fmt::format("Decode document key({}) fail.", Helper::StringToHex(encode_key));
-
-  partition_id = UnPackagePartitionId(plain_key);
-  document_id = UnPackageDocumentId(plain_key);
+  DecodeFixedDocumentKey(encode_key, partition_id, document_id);
 }
 
 void DocumentCodec::DecodeFromEncodeKey(const std::string& encode_key, int64_t& partition_id, int64_t& document_id,
@@ -229,12 +268,7 @@ void DocumentCodec::DecodeFromEncodeKeyWithTs(const std::string& encode_key_with
                                               int64_t& document_id) {
   CHECK((encode_key_with_ts.size() == 26 || encode_key_with_ts.size() >= 35))
       << "encode_key_with_ts length is invalid.";
-  std::string plain_key;
-  bool ret = mvcc::Codec::DecodeBytes(TruncateTsForKey(encode_key_with_ts), plain_key);
-  CHECK(ret) << fmt::format("Decode document key({}) fail.", Helper::StringToHex(encode_key_with_ts));
-
-  partition_id = UnPackagePartitionId(plain_key);
-  document_id = UnPackageDocumentId(plain_key);
+  DecodeFixedDocumentKey(TruncateTsForKey(encode_key_with_ts), partition_id, document_id);
 }
 
 void DocumentCodec::DecodeFromEncodeKeyWithTs(const std::string& encode_key_with_ts, int64_t& partition_id,
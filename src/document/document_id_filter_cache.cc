@@ -0,0 +1,120 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "document/document_id_filter_cache.h"
+
+#include <cstdint>
+#include <iterator>
+#include <string>
+
+#include "brpc/reloadable_flags.h"
+#include "bthread/mutex.h"
+#include "bvar/reducer.h"
+#include "common/gflag_validator.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_document_id_filter_cache, true, "enable cache document ids of repeated query string filter");
+DEFINE_validator(enable_document_id_filter_cache, &PassBool);
+DEFINE_int64(document_id_filter_cache_max_memory_bytes, 32 * 1024 * 1024,
+             "document id filter cache max memory of one region");
+BRPC_VALIDATE_GFLAG(document_id_filter_cache_max_memory_bytes, brpc::NonNegativeInteger);
+
+bvar::Adder<int64_t> g_document_id_filter_cache_hit_count("dingo_document_id_filter_cache_hit_count");
+bvar::Adder<int64_t> g_document_id_filter_cache_miss_count("dingo_document_id_filter_cache_miss_count");
+bvar::Adder<int64_t> g_document_id_filter_cache_memory_size("dingo_document_id_filter_cache_memory_size");
+
+DocumentIdFilterCache::DocumentIdFilterCache() { bthread_mutex_init(&mutex_, nullptr); }
+
+DocumentIdFilterCache::~DocumentIdFilterCache() {
+  g_document_id_filter_cache_memory_size << -memory_size_;
+  bthread_mutex_destroy(&mutex_);
+}
+
+bool DocumentIdFilterCache::IsEnabled() { return FLAGS_enable_document_id_filter_cache; }
+
+std::string DocumentIdFilterCache::GenKey(const pb::common::Range& region_range, const std::string& query_string) {
+  std::string key;
+  key.reserve(region_range.start_key().size() + region_range.end_key().size() + query_string.size() + 8);
+  key.append(std::to_string(region_range.start_key().size()));
+  key.push_back(':');
+  key.append(region_range.start_key());
+  key.append(region_range.end_key());
+  key.push_back(':');
+  key.append(query_string);
+  return key;
+}
+
+VectorIdBitmapPtr DocumentIdFilterCache::Get(const std::string& key, const Version& version) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = entry_map_.find(key);
+  if (it == entry_map_.end()) {
+    g_document_id_filter_cache_miss_count << 1;
+    return nullptr;
+  }
+
+  auto entry_it = it->second;
+  if (!(entry_it->version == version)) {
+    // reader is reloaded, stale entry will not be valid again
+    Erase(entry_it);
+    g_document_id_filter_cache_miss_count << 1;
+    return nullptr;
+  }
+
+  entries_.splice(entries_.begin(), entries_, entry_it);
+  g_document_id_filter_cache_hit_count << 1;
+  return entry_it->ids;
+}
+
+void DocumentIdFilterCache::Put(const std::string& key, const Version& version, VectorIdBitmapPtr ids) {
+  int64_t memory_size = key.size() * 2 + ids->MemorySize() + sizeof(Entry);
+  if (memory_size > FLAGS_document_id_filter_cache_max_memory_bytes) {
+    return;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = entry_map_.find(key);
+  if (it != entry_map_.end()) {
+    Erase(it->second);
+  }
+
+  entries_.push_front(Entry{key, version, std::move(ids), memory_size});
+  entry_map_[key] = entries_.begin();
+  memory_size_ += memory_size;
+  g_document_id_filter_cache_memory_size << memory_size;
+
+  while (memory_size_ > FLAGS_document_id_filter_cache_max_memory_bytes && !entries_.empty()) {
+    Erase(std::prev(entries_.end()));
+  }
+}
+
+int64_t DocumentIdFilterCache::MemorySize() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return memory_size_;
+}
+
+int64_t DocumentIdFilterCache::Size() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return entries_.size();
+}
+
+void DocumentIdFilterCache::Erase(EntryList::iterator it) {
+  memory_size_ -= it->memory_size;
+  g_document_id_filter_cache_memory_size << -it->memory_size;
+  entry_map_.erase(it->key);
+  entries_.erase(it);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,81 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_DOCUMENT_ID_FILTER_CACHE_H_
+#define DINGODB_DOCUMENT_ID_FILTER_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "bthread/mutex.h"
+#include "proto/common.pb.h"
+#include "vector/vector_id_bitmap.h"
+
+namespace dingodb {
+
+// LRU cache of document ids hit by repeated query string, bounded by memory, ids are kept as compressed
+// bitmap and shared with caller without copy, caller must not modify it.
+// Entry is valid only when reader version of own and sibling document index are same as when it is put,
+// reader version change at every reader reload, so write is visible after it is refreshed.
+class DocumentIdFilterCache {
+ public:
+  struct Version {
+    int64_t reader_version{0};
+    int64_t sibling_reader_version{0};
+
+    bool operator==(const Version& other) const {
+      return reader_version == other.reader_version && sibling_reader_version == other.sibling_reader_version;
+    }
+  };
+
+  DocumentIdFilterCache();
+  ~DocumentIdFilterCache();
+
+  DocumentIdFilterCache(const DocumentIdFilterCache&) = delete;
+  DocumentIdFilterCache& operator=(const DocumentIdFilterCache&) = delete;
+
+  static bool IsEnabled();
+
+  static std::string GenKey(const pb::common::Range& region_range, const std::string& query_string);
+
+  VectorIdBitmapPtr Get(const std::string& key, const Version& version);
+  void Put(const std::string& key, const Version& version, VectorIdBitmapPtr ids);
+
+  int64_t MemorySize();
+  int64_t Size();
+
+ private:
+  struct Entry {
+    std::string key;
+    Version version;
+    VectorIdBitmapPtr ids;
+    int64_t memory_size{0};
+  };
+  using EntryList = std::list<Entry>;
+
+  // caller hold mutex_
+  void Erase(EntryList::iterator it);
+
+  bthread_mutex_t mutex_;
+  // front is most recently used
+  EntryList entries_;
+  std::unordered_map<std::string, EntryList::iterator> entry_map_;
+  int64_t memory_size_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_DOCUMENT_ID_FILTER_CACHE_H_
@@ -14,23 +14,36 @@
 
 #include "document/document_index.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <atomic>
+#include <cerrno>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "braft/protobuf_file.h"
+#include "brpc/reloadable_flags.h"
 #include "bthread/bthread.h"
 #include "butil/status.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "document/codec.h"
 #include "document/document_index_factory.h"
+#include "document/document_index_manager.h"
 #include "fmt/core.h"
 #include "mvcc/codec.h"
+#include "nlohmann/json.hpp"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "server/server.h"
@@ -41,6 +54,44 @@ namespace dingodb {
 DEFINE_int32(document_index_save_log_gap, 10, "document index save log gap");
 BRPC_VALIDATE_GFLAG(document_index_save_log_gap, brpc::PositiveInteger);
 
+DEFINE_bool(enable_document_index_nrt_refresh, true,
+            "document write is committed and reader reloaded by refresh policy instead of every write");
+BRPC_VALIDATE_GFLAG(enable_document_index_nrt_refresh, brpc::PassValidate);
+DEFINE_int64(document_index_refresh_interval_ms, 1000, "max interval from document write to refresh");
+BRPC_VALIDATE_GFLAG(document_index_refresh_interval_ms, brpc::PositiveInteger);
+DEFINE_int64(document_index_refresh_max_docs, 10000, "refresh at once when pending document writes reach this");
+BRPC_VALIDATE_GFLAG(document_index_refresh_max_docs, brpc::PositiveInteger);
+
+DEFINE_bool(enable_document_index_warmup, true, "pre-touch hot document index files into page cache after load");
+BRPC_VALIDATE_GFLAG(enable_document_index_warmup, brpc::PassValidate);
+DEFINE_string(document_index_warmup_file_exts, "term,fast",
+              "tantivy file extensions to warmup, default term dictionary and fast field");
+DEFINE_int64(document_index_warmup_max_bytes, 1024L * 1024 * 1024, "max warmup bytes of one document index");
+BRPC_VALIDATE_GFLAG(document_index_warmup_max_bytes, brpc::NonNegativeInteger);
+
+DEFINE_int64(document_index_ingest_buffer_max_bytes, 4 * 1024 * 1024,
+             "max retained bytes of per thread document ingest buffer");
+BRPC_VALIDATE_GFLAG(document_index_ingest_buffer_max_bytes, brpc::NonNegativeInteger);
+
+DEFINE_int64(document_index_search_parallel_num, 1, "split search of big document index to parts searched in parallel");
+BRPC_VALIDATE_GFLAG(document_index_search_parallel_num, brpc::PositiveInteger);
+DEFINE_int64(document_index_search_parallel_min_doc_count, 1000000, "split search only when doc count reach this");
+BRPC_VALIDATE_GFLAG(document_index_search_parallel_min_doc_count, brpc::NonNegativeInteger);
+
+bvar::Adder<int64_t> g_document_index_commit_count("dingo_document_index_commit_count");
+bvar::Adder<int64_t> g_document_index_reload_count("dingo_document_index_reload_count");
+bvar::Adder<int64_t> g_document_index_split_search_count("dingo_document_index_split_search_count");
+bvar::Adder<int64_t> g_document_index_search_at_caller_count("dingo_document_index_search_at_caller_count");
+bvar::Adder<int64_t> g_document_index_ingest_buffer_release_count("dingo_document_index_ingest_buffer_release_count");
+bvar::Adder<int64_t> g_document_index_warm_num("dingo_document_index_warm_num");
+bvar::Adder<int64_t> g_document_index_warmup_bytes("dingo_document_index_warmup_bytes");
+bvar::Adder<int64_t> g_document_index_warmup_truncated_count("dingo_document_index_warmup_truncated_count");
+bvar::LatencyRecorder g_document_index_warmup_latency("dingo_document_index_warmup_latency");
+
+// reader version is unique among all document index, so replaced index never has same version.
+static std::atomic<int64_t> g_document_index_reader_version{0};
+static int64_t NextReaderVersion() { return g_document_index_reader_version.fetch_add(1) + 1; }
+
 butil::Status DocumentIndex::RemoveIndexFiles(int64_t id, const std::string& index_path) {
 #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
   // index_path: /home/dingo-store/dist/document1/data/document_index/80040/epoch_1
@@ -73,9 +124,13 @@ DocumentIndex::DocumentIndex(int64_t id, const std::string& index_path,
       apply_log_id_(0),
       document_index_parameter_(document_index_parameter),
       epoch_(epoch),
-      range_(range) {}
+      range_(range),
+      reader_version_(NextReaderVersion()) {}
 
 DocumentIndex::~DocumentIndex() {
+  if (is_warm_.load()) {
+    g_document_index_warm_num << -1;
+  }
 #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
   {
     RWLockWriteGuard guard(&rw_lock_);
@@ -244,19 +299,156 @@ butil::Status DocumentIndex::Add(const std::vector<pb::common::DocumentWithId>&
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, err_msg);
   }
 
+  auto status = AddDocuments(document_with_ids);
+  if (!status.ok()) {
+    return status;
+  }
+
+  status = Commit();
+  if (!status.ok()) {
+    return status;
+  }
+
+  return reload_reader ? ReloadReader() : butil::Status::OK();
+}
+
+butil::Status DocumentIndex::UpsertDeferred(const std::vector<pb::common::DocumentWithId>& document_with_ids) {
+  if (document_with_ids.empty()) {
+    return butil::Status::OK();
+  }
+
+  std::vector<int64_t> delete_ids;
+  delete_ids.reserve(document_with_ids.size());
+  for (const auto& document_with_id : document_with_ids) {
+    delete_ids.push_back(document_with_id.id());
+  }
+
+  auto status = Delete(delete_ids);
+  if (!status.ok()) {
+    return status;
+  }
+
+  return AddDeferred(document_with_ids);
+}
+
+butil::Status DocumentIndex::AddDeferred(const std::vector<pb::common::DocumentWithId>& document_with_ids) {
+  DINGO_LOG(DEBUG) << fmt::format("[document_index.raw][id({})] deferred add document count({})", id_,
+                                  document_with_ids.size());
+
+  if (document_with_ids.empty()) {
+    return butil::Status::OK();
+  }
+
+  RWLockWriteGuard guard(&rw_lock_);
+
+  if (is_destroyed_) {
+    std::string err_msg = fmt::format("[document_index.raw][id({})] document index is destroyed", id_);
+    DINGO_LOG(ERROR) << err_msg;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, err_msg);
+  }
+
+  return AddDocuments(document_with_ids);
+}
+
+// Columns of one type of a document, reused across documents to keep vector and string capacity.
+// Documents of one index usually have same fields, so after first document no allocation is needed.
+template <typename T>
+struct IngestColumns {
+  std::vector<std::string> names;
+  std::vector<T> docs;
+  size_t size{0};
+
+  void Clear() { size = 0; }
+
+  template <typename V>
+  void Add(const std::string& name, const V& value) {
+    if (size < names.size()) {
+      names[size].assign(name);
+      docs[size] = value;
+    } else {
+      names.push_back(name);
+      docs.push_back(value);
+    }
+    ++size;
+  }
+
+  // drop the tail left by previous document, retained strings keep their capacity.
+  void Finish() {
+    names.resize(size);
+    docs.resize(size);
+  }
+
+  int64_t CapacityBytes() const {
+    int64_t bytes = 0;
+    for (const auto& name : names) {
+      bytes += name.capacity();
+    }
+    if constexpr (std::is_same_v<T, std::string>) {
+      for (const auto& doc : docs) {
+        bytes += doc.capacity();
+      }
+    }
+    return bytes;
+  }
+};
+
+// FFI marshaling buffer of ingest, one per thread, add is serialized by write lock of index.
+struct IngestBuffer {
+  IngestColumns<std::string> text_columns;
+  IngestColumns<int64_t> i64_columns;
+  IngestColumns<double> f64_columns;
+  IngestColumns<std::string> bytes_columns;
+  IngestColumns<std::string> date_columns;
+  IngestColumns<std::string> bool_columns;
+
+  void Clear() {
+    text_columns.Clear();
+    i64_columns.Clear();
+    f64_columns.Clear();
+    bytes_columns.Clear();
+    date_columns.Clear();
+    bool_columns.Clear();
+  }
+
+  void Finish() {
+    text_columns.Finish();
+    i64_columns.Finish();
+    f64_columns.Finish();
+    bytes_columns.Finish();
+    date_columns.Finish();
+    bool_columns.Finish();
+  }
+
+  bool Empty() const {
+    return text_columns.size == 0 && i64_columns.size == 0 && f64_columns.size == 0 && bytes_columns.size == 0 &&
+           date_columns.size == 0 && bool_columns.size == 0;
+  }
+
+  int64_t CapacityBytes() const {
+    return text_columns.CapacityBytes() + i64_columns.CapacityBytes() + f64_columns.CapacityBytes() +
+           bytes_columns.CapacityBytes() + date_columns.CapacityBytes() + bool_columns.CapacityBytes();
+  }
+};
+
+static IngestBuffer& GetIngestBuffer() {
+  thread_local IngestBuffer buffer;
+  return buffer;
+}
+
+// not keep buffer of a huge document at every thread.
+static void ReleaseIngestBufferIfLarge(IngestBuffer& buffer) {
+  if (buffer.CapacityBytes() > FLAGS_document_index_ingest_buffer_max_bytes) {
+    buffer = IngestBuffer();
+    g_document_index_ingest_buffer_release_count << 1;
+  }
+}
+
+butil::Status DocumentIndex::AddDocuments(const std::vector<pb::common::DocumentWithId>& document_with_ids) {
+  auto& buffer = GetIngestBuffer();
+  ON_SCOPE_EXIT([&]() { ReleaseIngestBufferIfLarge(buffer); });
+
   for (const auto& document_with_id : document_with_ids) {
-    std::vector<std::string> text_column_names;
-    std::vector<std::string> text_column_docs;
-    std::vector<std::string> i64_column_names;
-    std::vector<std::int64_t> i64_column_docs;
-    std::vector<std::string> f64_column_names;
-    std::vector<double> f64_column_docs;
-    std::vector<std::string> bytes_column_names;
-    std::vector<std::string> bytes_column_docs;
-    std::vector<std::string> date_column_names;
-    std::vector<std::string> date_column_docs;
-    std::vector<std::string> bool_column_names;
-    std::vector<std::string> bool_column_docs;
+    buffer.Clear();
 
     uint64_t document_id = document_with_id.id();
 
@@ -269,32 +461,22 @@ butil::Status DocumentIndex::Add(const std::vector<pb::common::DocumentWithId>&
       }
       switch (document_value.field_type()) {
         case pb::common::ScalarFieldType::STRING:
-          text_column_names.push_back(field_name);
-          text_column_docs.push_back(document_value.field_value().string_data());
+          buffer.text_columns.Add(field_name, document_value.field_value().string_data());
           break;
         case pb::common::ScalarFieldType::INT64:
-          i64_column_names.push_back(field_name);
-          i64_column_docs.push_back(document_value.field_value().long_data());
+          buffer.i64_columns.Add(field_name, document_value.field_value().long_data());
           break;
         case pb::common::ScalarFieldType::DOUBLE:
-          f64_column_names.push_back(field_name);
-          f64_column_docs.push_back(document_value.field_value().double_data());
+          buffer.f64_columns.Add(field_name, document_value.field_value().double_data());
           break;
         case pb::common::ScalarFieldType::BYTES:
-          bytes_column_names.push_back(field_name);
-          bytes_column_docs.push_back(document_value.field_value().bytes_data());
+          buffer.bytes_columns.Add(field_name, document_value.field_value().bytes_data());
           break;
         case pb::common::ScalarFieldType::DATETIME:
-          date_column_names.push_back(field_name);
-          date_column_docs.push_back(document_value.field_value().datetime_data());
+          buffer.date_columns.Add(field_name, document_value.field_value().datetime_data());
           break;
         case pb::common::ScalarFieldType::BOOL:
-          bool_column_names.push_back(field_name);
-          if (document_value.field_value().bool_data()) {
-            bool_column_docs.push_back("true");
-          } else {
-            bool_column_docs.push_back("false");
-          }
+          buffer.bool_columns.Add(field_name, document_value.field_value().bool_data() ? "true" : "false");
           break;
         default:
           std::string err_msg =
@@ -305,17 +487,19 @@ butil::Status DocumentIndex::Add(const std::vector<pb::common::DocumentWithId>&
           break;
       }
     }
-    if (text_column_names.empty() && i64_column_names.empty() && f64_column_names.empty() &&
-        bytes_column_names.empty() && date_column_names.empty() && bool_column_names.empty()) {
+    if (buffer.Empty()) {
       DINGO_LOG(INFO) << fmt::format(
           "[document_index.raw][id({})] document_id: ({}) document_value not set so not create document index", id_,
           document_id);
       continue;
     }
+
+    buffer.Finish();
     auto bool_result = ffi_index_multi_type_column_docs(
-        index_path_, document_id, text_column_names, text_column_docs, i64_column_names, i64_column_docs,
-        f64_column_names, f64_column_docs, bytes_column_names, bytes_column_docs, date_column_names, date_column_docs,
-        bool_column_names, bool_column_docs);
+        index_path_, document_id, buffer.text_columns.names, buffer.text_columns.docs, buffer.i64_columns.names,
+        buffer.i64_columns.docs, buffer.f64_columns.names, buffer.f64_columns.docs, buffer.bytes_columns.names,
+        buffer.bytes_columns.docs, buffer.date_columns.names, buffer.date_columns.docs, buffer.bool_columns.names,
+        buffer.bool_columns.docs);
     if (!bool_result.result) {
       std::string err_msg =
           fmt::format("[document_index.raw][id({})] document_id: ({}) add failed, error: {}, error_msg: {}", id_,
@@ -325,6 +509,14 @@ butil::Status DocumentIndex::Add(const std::vector<pb::common::DocumentWithId>&
     }
   }
 
+  if (pending_write_count_.fetch_add(document_with_ids.size()) == 0) {
+    first_pending_time_ms_.store(Helper::TimestampMs());
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status DocumentIndex::Commit() {
   auto bool_result = ffi_index_writer_commit(index_path_);
   if (!bool_result.result) {
     std::string err_msg = fmt::format("[document_index.raw][id({})] commit failed, error: {}, error_msg: {}", id_,
@@ -333,19 +525,64 @@ butil::Status DocumentIndex::Add(const std::vector<pb::common::DocumentWithId>&
     return butil::Status(pb::error::EINTERNAL, err_msg);
   }
 
-  if (reload_reader) {
-    bool_result = ffi_index_reader_reload(index_path_);
-    if (!bool_result.result) {
-      std::string err_msg = fmt::format("[document_index.raw][id({})] reload failed, error: {}, error_msg: {}", id_,
-                                        bool_result.error_code, bool_result.error_msg.c_str());
-      DINGO_LOG(ERROR) << err_msg;
-      return butil::Status(pb::error::EINTERNAL, err_msg);
-    }
+  pending_write_count_.store(0);
+  first_pending_time_ms_.store(0);
+  need_reload_.store(true);
+  reader_version_.store(NextReaderVersion());
+  g_document_index_commit_count << 1;
+
+  return butil::Status::OK();
+}
+
+butil::Status DocumentIndex::ReloadReader() {
+  if (!need_reload_.exchange(false)) {
+    return butil::Status::OK();
+  }
+
+  auto bool_result = ffi_index_reader_reload(index_path_);
+  if (!bool_result.result) {
+    need_reload_.store(true);
+    std::string err_msg = fmt::format("[document_index.raw][id({})] reload failed, error: {}, error_msg: {}", id_,
+                                      bool_result.error_code, bool_result.error_msg.c_str());
+    DINGO_LOG(ERROR) << err_msg;
+    return butil::Status(pb::error::EINTERNAL, err_msg);
   }
 
+  reader_version_.store(NextReaderVersion());
+  g_document_index_reload_count << 1;
   return butil::Status::OK();
 }
 
+butil::Status DocumentIndex::Refresh(bool force) {
+  {
+    RWLockWriteGuard guard(&rw_lock_);
+
+    if (is_destroyed_) {
+      std::string err_msg = fmt::format("[document_index.raw][id({})] document index is destroyed", id_);
+      DINGO_LOG(WARNING) << err_msg;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, err_msg);
+    }
+
+    int64_t pending_write_count = pending_write_count_.load();
+    if (pending_write_count > 0) {
+      bool is_due = pending_write_count >= FLAGS_document_index_refresh_max_docs ||
+                    Helper::TimestampMs() - first_pending_time_ms_.load() >= FLAGS_document_index_refresh_interval_ms;
+      if (!force && !is_due) {
+        return butil::Status::OK();
+      }
+
+      auto status = Commit();
+      if (!status.ok()) {
+        return status;
+      }
+    }
+  }
+
+  // search can go on while reader is reloading, only write is blocked.
+  RWLockReadGuard guard(&rw_lock_);
+  return ReloadReader();
+}
+
 butil::Status DocumentIndex::Delete(const std::vector<int64_t>& delete_ids) {
   DINGO_LOG(INFO) << fmt::format("[document_index.raw][id({})] delete document count({})", id_, delete_ids.size());
 
@@ -387,6 +624,11 @@ butil::Status DocumentIndex::Delete(const std::vector<int64_t>& delete_ids) {
     return butil::Status(pb::error::EINTERNAL, err_msg);
   }
 
+  // delete is visible after next commit
+  if (pending_write_count_.fetch_add(delete_ids_uint64.size()) == 0) {
+    first_pending_time_ms_.store(Helper::TimestampMs());
+  }
+
   return butil::Status::OK();
 }
 
@@ -447,20 +689,13 @@ butil::Status DocumentIndex::Search(uint32_t topk, const std::string& query_stri
 
 butil::Status DocumentIndex::Save(const std::string& /*path*/) {
   // Save need the caller to do LockWrite() and UnlockWrite()
-  auto result = ffi_index_writer_commit(index_path_);
-  if (result.result) {
-    return butil::Status::OK();
-  } else {
-    std::string err_msg = fmt::format("[document_index.raw][id({})] save failed, error: {}, error_msg: {}", id_,
-                                      result.error_code, result.error_msg.c_str());
-    DINGO_LOG(ERROR) << err_msg;
-    return butil::Status(pb::error::EINTERNAL, err_msg);
-  }
+  return Commit();
 }
 
 butil::Status DocumentIndex::Load(const std::string& /*path*/) {
   auto result = ffi_index_reader_reload(index_path_);
   if (result.result) {
+    reader_version_.store(NextReaderVersion());
     return butil::Status::OK();
   } else {
     std::string err_msg = fmt::format("[document_index.raw][id({})] load failed, error: {}, error_msg: {}", id_,
@@ -470,6 +705,91 @@ butil::Status DocumentIndex::Load(const std::string& /*path*/) {
   }
 }
 
+// map file and touch every page, pages stay in page cache after unmap. return warmed bytes.
+static int64_t WarmupFile(const std::string& path, int64_t max_bytes) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    DINGO_LOG(WARNING) << fmt::format("[document_index.warmup] open file {} failed, error: {}", path, strerror(errno));
+    return 0;
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+    close(fd);
+    return 0;
+  }
+
+  size_t size = std::min(static_cast<int64_t>(file_stat.st_size), max_bytes);
+  void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    DINGO_LOG(WARNING) << fmt::format("[document_index.warmup] mmap file {} failed, error: {}", path, strerror(errno));
+    return 0;
+  }
+
+  madvise(data, size, MADV_WILLNEED);
+
+  static const size_t kPageSize = sysconf(_SC_PAGESIZE);
+  const volatile char* bytes = static_cast<const char*>(data);
+  char sum = 0;
+  for (size_t offset = 0; offset < size; offset += kPageSize) {
+    sum += bytes[offset];
+  }
+  (void)sum;
+
+  munmap(data, size);
+  return size;
+}
+
+static bool IsWarmupFile(const std::string& filename, const std::vector<std::string>& exts) {
+  auto pos = filename.rfind('.');
+  if (pos == std::string::npos) {
+    return false;
+  }
+
+  return std::find(exts.begin(), exts.end(), filename.substr(pos + 1)) != exts.end();
+}
+
+butil::Status DocumentIndex::Warmup() {
+  if (!FLAGS_enable_document_index_warmup) {
+    return butil::Status::OK();
+  }
+  if (IsDestroyed()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "document index is destroyed");
+  }
+
+  int64_t start_time = Helper::TimestampMs();
+  std::vector<std::string> exts;
+  Helper::SplitString(FLAGS_document_index_warmup_file_exts, ',', exts);
+
+  // newly written segment is already in page cache, warmup after every open is cheap.
+  int64_t warm_bytes = 0;
+  int64_t file_count = 0;
+  for (const auto& filename : Helper::TraverseDirectory(index_path_, true)) {
+    if (!IsWarmupFile(filename, exts)) {
+      continue;
+    }
+    if (warm_bytes >= FLAGS_document_index_warmup_max_bytes) {
+      g_document_index_warmup_truncated_count << 1;
+      break;
+    }
+
+    warm_bytes +=
+        WarmupFile(Helper::ConcatPath(index_path_, filename), FLAGS_document_index_warmup_max_bytes - warm_bytes);
+    ++file_count;
+  }
+
+  if (!is_warm_.exchange(true)) {
+    g_document_index_warm_num << 1;
+  }
+  g_document_index_warmup_bytes << warm_bytes;
+  g_document_index_warmup_latency << (Helper::TimestampMs() - start_time);
+
+  DINGO_LOG(INFO) << fmt::format("[document_index.warmup][id({})] warmup file({}) bytes({}) elapsed time({}ms)", id_,
+                                 file_count, warm_bytes, Helper::TimestampMs() - start_time);
+  return butil::Status::OK();
+}
+
 butil::Status DocumentIndex::GetDocCount(int64_t& count) {
   RWLockReadGuard guard(&rw_lock_);
   if (is_destroyed_) {
@@ -515,6 +835,24 @@ butil::Status DocumentIndex::GetMetaJson(std::string& json) {
   return butil::Status::OK();
 }
 
+butil::Status DocumentIndex::GetSegmentCount(int64_t& count) {
+  std::string meta_json;
+  auto status = GetMetaJson(meta_json);
+  if (!status.ok()) {
+    return status;
+  }
+
+  auto meta = nlohmann::json::parse(meta_json, nullptr, false);
+  if (meta.is_discarded() || !meta.contains("segments") || !meta["segments"].is_array()) {
+    std::string err_msg = fmt::format("[document_index.raw][id({})] parse segments from meta json failed", id_);
+    DINGO_LOG(ERROR) << err_msg;
+    return butil::Status(pb::error::EINTERNAL, err_msg);
+  }
+
+  count = meta["segments"].size();
+  return butil::Status::OK();
+}
+
 butil::Status DocumentIndex::GetJsonParameter(std::string& json) {
   RWLockReadGuard guard(&rw_lock_);
   if (is_destroyed_) {
@@ -917,6 +1255,15 @@ butil::Status DocumentIndexWrapper::GetMetaJson(std::string& json) {
   return document_index->GetMetaJson(json);
 }
 
+butil::Status DocumentIndexWrapper::GetSegmentCount(int64_t& count) {
+  auto document_index = GetOwnDocumentIndex();
+  if (document_index == nullptr) {
+    return butil::Status(pb::error::EDOCUMENT_INDEX_NOT_FOUND, "document index %lu is not ready.", Id());
+  }
+
+  return document_index->GetSegmentCount(count);
+}
+
 butil::Status DocumentIndexWrapper::GetJsonParameter(std::string& json) {
   auto document_index = GetOwnDocumentIndex();
   if (document_index == nullptr) {
@@ -980,6 +1327,27 @@ static std::vector<pb::common::DocumentWithId> FilterDocumentWithId(
   return result;
 }
 
+// write is committed and reader reloaded by refresh policy, or at once when near real time refresh is disabled.
+static void ScheduleRefresh(DocumentIndexPtr document_index) {
+  if (FLAGS_enable_document_index_nrt_refresh) {
+    DocumentIndexManager::ScheduleRefreshDocumentIndex(document_index);
+  }
+}
+
+static butil::Status WriteDocuments(DocumentIndexPtr document_index,
+                                    const std::vector<pb::common::DocumentWithId>& document_with_ids, bool is_upsert) {
+  if (!FLAGS_enable_document_index_nrt_refresh) {
+    return is_upsert ? document_index->Upsert(document_with_ids, true) : document_index->Add(document_with_ids, true);
+  }
+
+  auto status =
+      is_upsert ? document_index->UpsertDeferred(document_with_ids) : document_index->AddDeferred(document_with_ids);
+  if (status.ok()) {
+    ScheduleRefresh(document_index);
+  }
+  return status;
+}
+
 butil::Status DocumentIndexWrapper::Upsert(const std::vector<pb::common::DocumentWithId>& document_with_ids) {
   if (!IsReady()) {
     DINGO_LOG(WARNING) << fmt::format("[document_index.wrapper][id({})] document index is not ready.", Id());
@@ -1003,13 +1371,14 @@ butil::Status DocumentIndexWrapper::Upsert(const std::vector<pb::common::Documen
   // Exist sibling document index, so need to separate add document.
   auto sibling_document_index = SiblingDocumentIndex();
   if (sibling_document_index != nullptr) {
-    auto status = sibling_document_index->Upsert(
-        FilterDocumentWithId(document_with_ids, sibling_document_index->Range(false)), true);
+    auto status = WriteDocuments(sibling_document_index,
+                                 FilterDocumentWithId(document_with_ids, sibling_document_index->Range(false)), true);
     if (!status.ok()) {
       return status;
     }
 
-    status = document_index->Upsert(FilterDocumentWithId(document_with_ids, document_index->Range(false)), true);
+    status =
+        WriteDocuments(document_index, FilterDocumentWithId(document_with_ids, document_index->Range(false)), true);
     if (!status.ok()) {
       sibling_document_index->Delete(FilterDocumentId(document_with_ids, sibling_document_index->Range(false)));
       return status;
@@ -1018,7 +1387,7 @@ butil::Status DocumentIndexWrapper::Upsert(const std::vector<pb::common::Documen
     return status;
   }
 
-  return document_index->Upsert(document_with_ids, true);
+  return WriteDocuments(document_index, document_with_ids, true);
 }
 
 butil::Status DocumentIndexWrapper::Add(const std::vector<pb::common::DocumentWithId>& document_with_ids) {
@@ -1044,13 +1413,14 @@ butil::Status DocumentIndexWrapper::Add(const std::vector<pb::common::DocumentWi
   // Exist sibling document index, so need to separate add document.
   auto sibling_document_index = SiblingDocumentIndex();
   if (sibling_document_index != nullptr) {
-    auto status = sibling_document_index->Add(
-        FilterDocumentWithId(document_with_ids, sibling_document_index->Range(false)), true);
+    auto status = WriteDocuments(sibling_document_index,
+                                 FilterDocumentWithId(document_with_ids, sibling_document_index->Range(false)), false);
     if (!status.ok()) {
       return status;
     }
 
-    status = document_index->Add(FilterDocumentWithId(document_with_ids, document_index->Range(false)), true);
+    status =
+        WriteDocuments(document_index, FilterDocumentWithId(document_with_ids, document_index->Range(false)), false);
     if (!status.ok()) {
       sibling_document_index->Delete(FilterDocumentId(document_with_ids, sibling_document_index->Range(false)));
       return status;
@@ -1059,7 +1429,7 @@ butil::Status DocumentIndexWrapper::Add(const std::vector<pb::common::DocumentWi
     return status;
   }
 
-  return document_index->Add(document_with_ids, true);
+  return WriteDocuments(document_index, document_with_ids, false);
 }
 
 butil::Status DocumentIndexWrapper::Delete(const std::vector<int64_t>& delete_ids) {
@@ -1089,11 +1459,36 @@ butil::Status DocumentIndexWrapper::Delete(const std::vector<int64_t>& delete_id
     if (!status.ok()) {
       return status;
     }
+    ScheduleRefresh(sibling_document_index);
 
-    return document_index->Delete(FilterDocumentId(delete_ids, document_index->Range(false)));
+    status = document_index->Delete(FilterDocumentId(delete_ids, document_index->Range(false)));
+    if (status.ok()) {
+      ScheduleRefresh(document_index);
+    }
+    return status;
   }
 
-  return document_index->Delete(delete_ids);
+  auto status = document_index->Delete(delete_ids);
+  if (status.ok()) {
+    ScheduleRefresh(document_index);
+  }
+  return status;
+}
+
+butil::Status DocumentIndexWrapper::Refresh() {
+  auto sibling_document_index = SiblingDocumentIndex();
+  if (sibling_document_index != nullptr) {
+    auto status = sibling_document_index->Refresh(true);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  auto document_index = GetDocumentIndex();
+  if (document_index == nullptr) {
+    return butil::Status(pb::error::EDOCUMENT_INDEX_NOT_FOUND, "document index %lu is not ready.", Id());
+  }
+  return document_index->Refresh(true);
 }
 
 static void MergeSearchResult(uint32_t topk, std::vector<pb::common::DocumentWithScore>& input_1,
@@ -1156,6 +1551,133 @@ static void MergeSearchResult(uint32_t topk, std::vector<pb::common::DocumentWit
   }
 }
 
+// One search of a document index, parts of a search are run concurrently and merged.
+struct DocumentSearchPart {
+  DocumentIndexPtr document_index;
+  bool use_range_filter{false};
+  int64_t start_id{0};
+  int64_t end_id{INT64_MAX};
+
+  std::vector<pb::common::DocumentWithScore> results;
+  butil::Status status;
+};
+
+// tantivy search is blocking, run it at pthread worker to not occupy bthread worker.
+// caller wait all part tasks done, so reference to caller data is safe.
+class DocumentSearchPartTask : public TaskRunnable {
+ public:
+  DocumentSearchPartTask(BthreadCondPtr cond, const pb::common::DocumentSearchParameter& parameter,
+                         bool use_id_filter, const std::vector<uint64_t>& alive_ids,
+                         const std::vector<std::string>& column_names, DocumentSearchPart& part)
+      : cond_(cond),
+        parameter_(parameter),
+        use_id_filter_(use_id_filter),
+        alive_ids_(alive_ids),
+        column_names_(column_names),
+        part_(part) {}
+  ~DocumentSearchPartTask() override = default;
+
+  std::string Type() override { return "DOCUMENT_SEARCH_PART"; }
+
+  void Run() override {
+    part_.status = part_.document_index->Search(parameter_.top_n(), parameter_.query_string(), part_.use_range_filter,
+                                                part_.start_id, part_.end_id, use_id_filter_,
+                                                parameter_.query_unlimited(), alive_ids_, column_names_, part_.results);
+    cond_->DecreaseSignal();
+  }
+
+ private:
+  BthreadCondPtr cond_;
+  const pb::common::DocumentSearchParameter& parameter_;
+  bool use_id_filter_;
+  const std::vector<uint64_t>& alive_ids_;
+  const std::vector<std::string>& column_names_;
+  DocumentSearchPart& part_;
+};
+
+// Split search of big document index to id ranges, each part is searched by tantivy in parallel.
+// bm25 statistics is of whole index, so merged score of parts is same as search whole range.
+static std::vector<DocumentSearchPart> SplitSearchPart(int64_t id, const pb::common::Range& region_range,
+                                                       const DocumentSearchPart& part) {
+  int64_t parallel_num = FLAGS_document_index_search_parallel_num;
+  if (parallel_num <= 1) {
+    return {part};
+  }
+
+  int64_t doc_count = 0;
+  auto status = part.document_index->GetDocCount(doc_count);
+  if (!status.ok() || doc_count < FLAGS_document_index_search_parallel_min_doc_count) {
+    return {part};
+  }
+
+  int64_t min_document_id = part.start_id, max_document_id = part.end_id;
+  if (!part.use_range_filter) {
+    if (!DocumentCodec::IsValidKey(region_range.start_key()) || !DocumentCodec::IsValidKey(region_range.end_key())) {
+      return {part};
+    }
+    DocumentCodec::DecodeRangeToDocumentId(false, region_range, min_document_id, max_document_id);
+  }
+  uint64_t step = (static_cast<uint64_t>(max_document_id) - static_cast<uint64_t>(min_document_id)) / parallel_num;
+  if (max_document_id <= min_document_id || step == 0) {
+    return {part};
+  }
+
+  std::vector<DocumentSearchPart> parts(parallel_num, part);
+  for (int64_t i = 0; i < parallel_num; ++i) {
+    parts[i].use_range_filter = true;
+    parts[i].start_id = min_document_id + static_cast<int64_t>(step * i);
+    parts[i].end_id =
+        (i == parallel_num - 1) ? max_document_id : min_document_id + static_cast<int64_t>(step * (i + 1));
+  }
+
+  DINGO_LOG(DEBUG) << fmt::format(
+      "[document_index.wrapper][id({})] split search, doc_count({}) parallel_num({}) min_document_id({}) "
+      "max_document_id({})",
+      id, doc_count, parallel_num, min_document_id, max_document_id);
+
+  g_document_index_split_search_count << 1;
+  return parts;
+}
+
+// Search all parts at search worker, search at caller if search worker is disabled or busy.
+static butil::Status SearchParts(const pb::common::DocumentSearchParameter& parameter, bool use_id_filter,
+                                 const std::vector<uint64_t>& alive_ids, const std::vector<std::string>& column_names,
+                                 std::vector<DocumentSearchPart>& parts,
+                                 std::vector<pb::common::DocumentWithScore>& results) {
+  auto cond = std::make_shared<BthreadCond>();
+
+  std::vector<TaskRunnablePtr> caller_tasks;
+  for (auto& part : parts) {
+    auto task =
+        std::make_shared<DocumentSearchPartTask>(cond, parameter, use_id_filter, alive_ids, column_names, part);
+    cond->Increase();
+    if (!Server::GetInstance().ExecuteDocumentIndexSearchTask(task)) {
+      caller_tasks.push_back(task);
+    }
+  }
+
+  g_document_index_search_at_caller_count << caller_tasks.size();
+  for (auto& task : caller_tasks) {
+    task->Run();
+  }
+  cond->Wait(0);
+
+  for (auto& part : parts) {
+    if (!part.status.ok()) {
+      return part.status;
+    }
+  }
+
+  results.swap(parts[0].results);
+  for (size_t i = 1; i < parts.size(); ++i) {
+    std::vector<pb::common::DocumentWithScore> merged_results;
+    MergeSearchResult(parameter.top_n(), results, parts[i].results, merged_results);
+    results.swap(merged_results);
+  }
+
+  return butil::Status::OK();
+}
+
 butil::Status DocumentIndexWrapper::Search(const pb::common::Range& region_range,
                                            const pb::common::DocumentSearchParameter& parameter,
                                            std::vector<pb::common::DocumentWithScore>& results) {
@@ -1175,6 +1697,7 @@ butil::Status DocumentIndexWrapper::Search(const pb::common::Range& region_range
   }
 
   std::vector<uint64_t> alive_ids;
+  alive_ids.reserve(parameter.document_ids_size());
   for (int64_t doc_id : parameter.document_ids()) {
     alive_ids.push_back(doc_id);
   }
@@ -1188,25 +1711,16 @@ butil::Status DocumentIndexWrapper::Search(const pb::common::Range& region_range
   auto sibling_document_index = SiblingDocumentIndex();
   if (sibling_document_index != nullptr) {
     DINGO_LOG(INFO) << fmt::format("[document_index.wrapper][id({})] search document in sibling document index.", Id());
-    std::vector<pb::common::DocumentWithScore> results_1;
-    auto status =
-        sibling_document_index->Search(parameter.top_n(), parameter.query_string(), false, 0, INT64_MAX, use_id_filter,
-                                       parameter.query_unlimited(), alive_ids, column_names, results_1);
-    if (!status.ok()) {
-      return status;
-    }
-
-    std::vector<pb::common::DocumentWithScore> results_2;
-    status = document_index->Search(parameter.top_n(), parameter.query_string(), false, 0, INT64_MAX, use_id_filter,
-                                    parameter.query_unlimited(), alive_ids, column_names, results_2);
-    if (!status.ok()) {
-      return status;
-    }
+    std::vector<DocumentSearchPart> parts(2);
+    parts[0].document_index = sibling_document_index;
+    parts[1].document_index = document_index;
 
-    MergeSearchResult(parameter.top_n(), results_1, results_2, results);
-    return status;
+    return SearchParts(parameter, use_id_filter, alive_ids, column_names, parts, results);
   }
 
+  DocumentSearchPart part;
+  part.document_index = document_index;
+
   const auto& index_range = document_index->Range(false);
   if (region_range.start_key() != index_range.start_key() || region_range.end_key() != index_range.end_key()) {
     int64_t min_document_id = 0, max_document_id = 0;
@@ -1219,18 +1733,74 @@ butil::Status DocumentIndexWrapper::Search(const pb::common::Range& region_range
         parameter.query_unlimited(), min_document_id, max_document_id);
 
     // use range filter
-    return document_index->Search(parameter.top_n(), parameter.query_string(), true, min_document_id, max_document_id,
-                                  use_id_filter, parameter.query_unlimited(), alive_ids, column_names, results);
+    part.use_range_filter = true;
+    part.start_id = min_document_id;
+    part.end_id = max_document_id;
+  } else {
+    DINGO_LOG(INFO) << fmt::format(
+        "[document_index.wrapper][id({})] search document in document index, range({}) query_string({}) top_n({}), "
+        "query_unlimited({})",
+        Id(), DocumentCodec::DebugRange(false, region_range), parameter.query_string(), parameter.top_n(),
+        parameter.query_unlimited());
   }
 
-  DINGO_LOG(INFO) << fmt::format(
-      "[document_index.wrapper][id({})] search document in document index, range({}) query_string({}) top_n({}), "
-      "query_unlimited({})",
-      Id(), DocumentCodec::DebugRange(false, region_range), parameter.query_string(), parameter.top_n(),
-      parameter.query_unlimited());
+  std::vector<DocumentSearchPart> parts = SplitSearchPart(Id(), region_range, part);
+  return SearchParts(parameter, use_id_filter, alive_ids, column_names, parts, results);
+}
+
+butil::Status DocumentIndexWrapper::SearchAllIds(const pb::common::Range& region_range,
+                                                 const std::string& query_string, VectorIdBitmapPtr& ids) {
+  auto document_index = GetDocumentIndex();
+  if (document_index == nullptr) {
+    return butil::Status(pb::error::EDOCUMENT_INDEX_NOT_FOUND, "document index %lu is not ready.", Id());
+  }
+  auto sibling_document_index = SiblingDocumentIndex();
 
-  return document_index->Search(parameter.top_n(), parameter.query_string(), false, 0, INT64_MAX, use_id_filter,
-                                parameter.query_unlimited(), alive_ids, column_names, results);
+  // get version before search, result may be stale if reader is reloaded during search.
+  DocumentIdFilterCache::Version version;
+  version.reader_version = document_index->ReaderVersion();
+  version.sibling_reader_version = sibling_document_index != nullptr ? sibling_document_index->ReaderVersion() : 0;
+
+  bool use_cache = DocumentIdFilterCache::IsEnabled();
+  std::string key = use_cache ? DocumentIdFilterCache::GenKey(region_range, query_string) : "";
+  if (use_cache) {
+    ids = id_filter_cache_.Get(key, version);
+    if (ids != nullptr) {
+      return butil::Status::OK();
+    }
+  }
+
+  pb::common::DocumentSearchParameter parameter;
+  parameter.set_top_n(0);  // for all
+  parameter.set_query_string(query_string);
+  parameter.set_without_scalar_data(true);
+  parameter.set_without_table_data(true);  // must be true. else crash.
+  parameter.set_query_unlimited(true);     // for all
+
+  std::vector<pb::common::DocumentWithScore> results;
+  auto status = Search(region_range, parameter, results);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // add in ascending order is fast path of bitmap.
+  std::vector<int64_t> document_ids;
+  document_ids.reserve(results.size());
+  for (const auto& result : results) {
+    document_ids.push_back(result.document_with_id().id());
+  }
+  std::sort(document_ids.begin(), document_ids.end());
+
+  ids = std::make_shared<VectorIdBitmap>();
+  for (int64_t document_id : document_ids) {
+    ids->Add(document_id);
+  }
+
+  if (use_cache) {
+    id_filter_cache_.Put(key, version, ids);
+  }
+
+  return butil::Status::OK();
 }
 
 // For document index, all node need to hold the index, so this function always return true.
@@ -25,7 +25,9 @@
 #include "butil/status.h"
 #include "common/runnable.h"
 #include "common/synchronization.h"
+#include "document/document_id_filter_cache.h"
 #include "proto/common.pb.h"
+#include "vector/vector_id_bitmap.h"
 
 namespace dingodb {
 
@@ -63,6 +65,8 @@ class DocumentIndex {
   butil::Status GetTokenCount(int64_t& count);
 
   butil::Status GetMetaJson(std::string& json);
+  // segment count of committed index, more segments make search slower.
+  butil::Status GetSegmentCount(int64_t& count);
 
   butil::Status GetJsonParameter(std::string& json);
 
@@ -70,12 +74,37 @@ class DocumentIndex {
 
   butil::Status Add(const std::vector<pb::common::DocumentWithId>& document_with_ids, bool reload_reader);
 
+  // Near real time write, documents are not committed at once, they become searchable after Refresh().
+  butil::Status UpsertDeferred(const std::vector<pb::common::DocumentWithId>& document_with_ids);
+
+  butil::Status AddDeferred(const std::vector<pb::common::DocumentWithId>& document_with_ids);
+
   butil::Status Delete(const std::vector<int64_t>& delete_ids);
 
+  // Commit pending writes and reload reader.
+  // If force is false, only refresh when pending writes reach document_index_refresh_max_docs or the first
+  // pending write is older than document_index_refresh_interval_ms.
+  butil::Status Refresh(bool force);
+
+  // Uncommitted add/delete count.
+  int64_t PendingWriteCount() const { return pending_write_count_.load(std::memory_order_relaxed); }
+
+  // At most one delayed refresh is scheduled for one index, return false if already scheduled.
+  bool TrySetRefreshScheduled() { return !is_refresh_scheduled_.exchange(true); }
+  void ClearRefreshScheduled() { is_refresh_scheduled_.store(false); }
+
+  // Change at every commit and reader reload, used to invalidate cached search result.
+  int64_t ReaderVersion() const { return reader_version_.load(); }
+
   butil::Status Save(const std::string& path);
 
   butil::Status Load(const std::string& path);
 
+  // tantivy read on-disk index through mmap, pre-touch term dictionary and fast field files
+  // (document_index_warmup_file_exts) into page cache, so first search after load not read disk.
+  butil::Status Warmup();
+  bool IsWarm() const { return is_warm_.load(); }
+
   butil::Status Search(uint32_t topk, const std::string& query_string, bool use_range_filter, int64_t start_id,
                        int64_t end_id, bool use_id_filter, bool query_unlimited, const std::vector<uint64_t>& alive_ids,
                        const std::vector<std::string>& column_names,
@@ -126,6 +155,12 @@ class DocumentIndex {
 #endif
 
  private:
+  // caller hold write lock
+  butil::Status AddDocuments(const std::vector<pb::common::DocumentWithId>& document_with_ids);
+  butil::Status Commit();
+  // caller hold read or write lock
+  butil::Status ReloadReader();
+
   // document index id
   int64_t id_;
 
@@ -142,6 +177,15 @@ class DocumentIndex {
 
   RWLock rw_lock_;
   bool is_destroyed_{false};
+
+  // uncommitted writes, modified with write lock
+  std::atomic<int64_t> pending_write_count_{0};
+  std::atomic<int64_t> first_pending_time_ms_{0};
+  // committed but reader is not reloaded
+  std::atomic<bool> need_reload_{false};
+  std::atomic<bool> is_refresh_scheduled_{false};
+  std::atomic<int64_t> reader_version_{0};
+  std::atomic<bool> is_warm_{false};
 #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
   bool is_defer_destroyed_{false};  // defer destroy for vector index use document speedup and document index
 #endif
@@ -252,13 +296,20 @@ class DocumentIndexWrapper : public std::enable_shared_from_this<DocumentIndexWr
   butil::Status GetDocCount(int64_t& count);
   butil::Status GetTokenCount(int64_t& count);
   butil::Status GetMetaJson(std::string& json);
+  butil::Status GetSegmentCount(int64_t& count);
   butil::Status GetJsonParameter(std::string& json);
 
   butil::Status Add(const std::vector<pb::common::DocumentWithId>& document_with_ids);
   butil::Status Upsert(const std::vector<pb::common::DocumentWithId>& document_with_ids);
   butil::Status Delete(const std::vector<int64_t>& delete_ids);
+  // Commit and reload own and sibling document index at once, for caller need read its own writes.
+  butil::Status Refresh();
   butil::Status Search(const pb::common::Range& region_range, const pb::common::DocumentSearchParameter& parameter,
                        std::vector<pb::common::DocumentWithScore>& results);
+  // Ids of all documents hit by query string in region range, e.g. for filter of vector search.
+  // Ids of repeated query string is cached until document index is refreshed, caller must not modify it.
+  butil::Status SearchAllIds(const pb::common::Range& region_range, const std::string& query_string,
+                             VectorIdBitmapPtr& ids);
 
 #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
   UseDocumentPurposeType GetUseDocumentPurposeType() const { return use_document_purpose_type_; }
@@ -304,6 +355,9 @@ class DocumentIndexWrapper : public std::enable_shared_from_this<DocumentIndexWr
   // document index rebuilding num
   std::atomic<int32_t> rebuilding_num_;
 
+  // document ids of repeated query string
+  DocumentIdFilterCache id_filter_cache_;
+
 #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
   UseDocumentPurposeType use_document_purpose_type_;
 #endif
@@ -19,15 +19,18 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "bthread/bthread.h"
 #include "butil/status.h"
 #include "bvar/latency_recorder.h"
 #include "bvar/reducer.h"
+#include "bvar/status.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
+#include "common/threadpool.h"
 #include "document/codec.h"
 #include "document/document_index.h"
 #include "document/document_index_factory.h"
@@ -40,6 +43,7 @@
 #include "proto/file_service.pb.h"
 #include "proto/node.pb.h"
 #include "proto/raft.pb.h"
+#include "raft/raft_cmd_codec.h"
 #include "server/server.h"
 #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
 #include "vector/vector_index_utils.h"
@@ -59,6 +63,11 @@ BRPC_VALIDATE_GFLAG(document_fast_background_worker_num, brpc::PositiveInteger);
 DEFINE_int64(document_max_background_task_count, 32, "document index max background task count");
 BRPC_VALIDATE_GFLAG(document_max_background_task_count, brpc::PositiveInteger);
 
+DEFINE_int32(document_search_worker_num, 16, "document index search pthread worker num, 0 is search at caller");
+BRPC_VALIDATE_GFLAG(document_search_worker_num, brpc::NonNegativeInteger);
+DEFINE_int32(document_search_worker_pending_num, 256, "document index search worker max pending task num");
+BRPC_VALIDATE_GFLAG(document_search_worker_pending_num, brpc::PositiveInteger);
+
 #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
 DEFINE_int32(document_vector_scalar_search_background_worker_num, 10,
              "document index vector scalar search background worker num");
@@ -73,6 +82,34 @@ DEFINE_bool(use_pthread_document_vector_scalar_search_background_worker_set, tru
 BRPC_VALIDATE_GFLAG(use_pthread_document_vector_scalar_search_background_worker_set, brpc::PassValidate);
 #endif
 
+DECLARE_int64(document_index_refresh_interval_ms);
+DECLARE_int64(document_index_refresh_max_docs);
+
+DEFINE_int32(document_index_build_parallel_num, 4, "split region to sub ranges scanned in parallel when build");
+BRPC_VALIDATE_GFLAG(document_index_build_parallel_num, brpc::PositiveInteger);
+DEFINE_int64(document_index_build_readahead_bytes, 2 * 1024 * 1024, "readahead of scan region when build");
+BRPC_VALIDATE_GFLAG(document_index_build_readahead_bytes, brpc::NonNegativeInteger);
+
+DEFINE_bool(enable_document_index_force_merge, true, "enable force merge document index with too many segments");
+BRPC_VALIDATE_GFLAG(enable_document_index_force_merge, brpc::PassValidate);
+DEFINE_int64(document_index_force_merge_min_segment_count, 64, "force merge document index when segment count reach");
+BRPC_VALIDATE_GFLAG(document_index_force_merge_min_segment_count, brpc::PositiveInteger);
+DEFINE_int32(document_index_force_merge_start_hour, 2, "off-peak start hour of force merge document index, [0, 23]");
+BRPC_VALIDATE_GFLAG(document_index_force_merge_start_hour, brpc::NonNegativeInteger);
+DEFINE_int32(document_index_force_merge_end_hour, 6, "off-peak end hour of force merge document index, [0, 23]");
+BRPC_VALIDATE_GFLAG(document_index_force_merge_end_hour, brpc::NonNegativeInteger);
+DEFINE_int32(document_index_force_merge_max_running_num, 1, "max running force merge document index task num");
+BRPC_VALIDATE_GFLAG(document_index_force_merge_max_running_num, brpc::PositiveInteger);
+
+bvar::Adder<int64_t> g_document_index_parallel_build_count("dingo_document_index_parallel_build_count");
+
+bvar::Adder<int64_t> g_document_index_force_merge_running_num("dingo_document_index_force_merge_running_num");
+bvar::Adder<int64_t> g_document_index_force_merge_count("dingo_document_index_force_merge_count");
+bvar::Adder<int64_t> g_document_index_force_merge_fail_count("dingo_document_index_force_merge_fail_count");
+bvar::Adder<int64_t> g_document_index_force_merge_reduced_segment_count(
+    "dingo_document_index_force_merge_reduced_segment_count");
+bvar::Status<int64_t> g_document_index_force_merge_candidate_num("dingo_document_index_force_merge_candidate_num", 0);
+
 std::string RebuildDocumentIndexTask::Trace() {
   return fmt::format("[document_index.rebuild][id({}).start_time({}).job_id({})] {}", document_index_wrapper_->Id(),
                      Helper::FormatMsTime(start_time_), job_id_, trace_);
@@ -236,6 +273,12 @@ void LoadOrBuildDocumentIndexTask::Run() {
     return;
   }
 
+  // serve warm once loaded, leader may change to this peer at any time.
+  auto document_index = document_index_wrapper_->GetOwnDocumentIndex();
+  if (document_index != nullptr) {
+    document_index->Warmup();
+  }
+
   ADD_REGION_CHANGE_RECORD_TIMEPOINT(job_id_, fmt::format("Loadorbuilded document index {}", region->Id()));
 }
 
@@ -392,6 +435,96 @@ void DocumentIndexManager::DecDocumentIndexSlowBuildTaskRunningNum() {
   bvar_document_index_slow_build_task_running_num << -1;
 }
 
+std::string RefreshDocumentIndexTask::Trace() {
+  return fmt::format("[document_index.refresh][id({})] pending write count({})", document_index_->Id(),
+                     document_index_->PendingWriteCount());
+}
+
+void RefreshDocumentIndexTask::Run() {
+  // write after this point need schedule a new refresh
+  document_index_->ClearRefreshScheduled();
+
+  auto status = document_index_->Refresh(true);
+  if (!status.ok()) {
+    // pending writes are refreshed again at next write
+    DINGO_LOG(ERROR) << fmt::format("[document_index.refresh][id({})] refresh fail, error: {}",
+                                    document_index_->Id(), Helper::PrintStatus(status));
+    return;
+  }
+
+  // write come in while reloading
+  if (document_index_->PendingWriteCount() > 0) {
+    DocumentIndexManager::ScheduleRefreshDocumentIndex(document_index_);
+  }
+}
+
+std::string WarmupDocumentIndexTask::Trace() {
+  return fmt::format("[document_index.warmup][id({})] {}", document_index_wrapper_->Id(), trace_);
+}
+
+void WarmupDocumentIndexTask::Run() {
+  auto document_index = document_index_wrapper_->GetOwnDocumentIndex();
+  if (document_index == nullptr) {
+    return;
+  }
+
+  auto status = document_index->Warmup();
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[document_index.warmup][id({})][trace({})] warmup fail, error: {}",
+                                      document_index_wrapper_->Id(), trace_, Helper::PrintStatus(status));
+  }
+}
+
+std::string DocumentForceMergeTask::Trace() {
+  return fmt::format("[document_index.force_merge][id({}).start_time({}).segment_count({})] {}",
+                     document_index_wrapper_->Id(), Helper::FormatMsTime(start_time_), segment_count_, trace_);
+}
+
+void DocumentForceMergeTask::Run() {
+  int64_t start_time = Helper::TimestampMs();
+  g_document_index_force_merge_running_num << 1;
+  ON_SCOPE_EXIT([&]() {
+    g_document_index_force_merge_running_num << -1;
+    document_index_wrapper_->DecPendingTaskNum();
+    document_index_wrapper_->DecRebuildingNum();
+  });
+
+  auto region = Server::GetInstance().GetRegion(document_index_wrapper_->Id());
+  if (region == nullptr || region->State() != pb::common::NORMAL) {
+    DINGO_LOG(WARNING) << fmt::format("[document_index.force_merge][id({})][trace({})] region is not normal, gave up.",
+                                      document_index_wrapper_->Id(), trace_);
+    return;
+  }
+
+  if (document_index_wrapper_->IsDestoryed() || !document_index_wrapper_->IsOwnReady()) {
+    DINGO_LOG(INFO) << fmt::format(
+        "[document_index.force_merge][id({})][trace({})] document index is not ready, gave up.",
+        document_index_wrapper_->Id(), trace_);
+    return;
+  }
+
+  // build a new document index from region data, it has much less segments, then switch to it.
+  auto status =
+      DocumentIndexManager::RebuildDocumentIndex(document_index_wrapper_, fmt::format("FORCE_MERGE-{}", trace_));
+  if (!status.ok()) {
+    g_document_index_force_merge_fail_count << 1;
+    DINGO_LOG(ERROR) << fmt::format("[document_index.force_merge][id({})][trace({})] force merge fail, error: {}.",
+                                    document_index_wrapper_->Id(), trace_, Helper::PrintStatus(status));
+    return;
+  }
+
+  int64_t segment_count = 0;
+  status = document_index_wrapper_->GetSegmentCount(segment_count);
+  if (status.ok() && segment_count < segment_count_) {
+    g_document_index_force_merge_reduced_segment_count << segment_count_ - segment_count;
+  }
+  g_document_index_force_merge_count << 1;
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[document_index.force_merge][id({})][trace({})] force merge finish, segment count({}->{}) run_time({}ms).",
+      document_index_wrapper_->Id(), trace_, segment_count_, segment_count, Helper::TimestampMs() - start_time);
+}
+
 bool DocumentIndexManager::Init() {
   workers_ = ExecqWorkerSet::New("document_mgr_background", FLAGS_document_background_worker_num, 0);
   if (!workers_->Init()) {
@@ -405,6 +538,15 @@ bool DocumentIndexManager::Init() {
     return false;
   }
 
+  if (FLAGS_document_search_worker_num > 0) {
+    search_workers_ = SimpleWorkerSet::New("document_mgr_search", FLAGS_document_search_worker_num,
+                                           FLAGS_document_search_worker_pending_num, true, false);
+    if (!search_workers_->Init()) {
+      DINGO_LOG(ERROR) << "Init document index manager search worker set fail!";
+      return false;
+    }
+  }
+
 #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
   // only for vector index scalar search with document
   if (use_document_purpose_type_ == UseDocumentPurposeType::kVectorIndexModule) {
@@ -429,6 +571,9 @@ void DocumentIndexManager::Destroy() {
   if (fast_workers_ != nullptr) {
     fast_workers_->Destroy();
   }
+  if (search_workers_ != nullptr) {
+    search_workers_->Destroy();
+  }
 }
 
 // Load document index for already exist document index at bootstrap.
@@ -554,7 +699,7 @@ butil::Status DocumentIndexManager::ReplayWalToDocumentIndex(DocumentIndexPtr do
   auto log_entrys = log_storage->GetDataEntries(document_index->Id(), start_log_id, end_log_id);
   for (const auto& log_entry : log_entrys) {
     auto raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
-    CHECK(raft_cmd->ParseFromString(log_entry->out_data));
+    CHECK(RaftCmdCodec::Decode(log_entry->out_data, raft_cmd.get()));
     for (auto& request : *raft_cmd->mutable_requests()) {
       switch (request.cmd_type()) {
         case pb::raft::DOCUMENT_ADD: {
@@ -723,6 +868,119 @@ butil::Status DocumentIndexManager::ReplayWalToDocumentIndex(DocumentIndexPtr do
 }
 
 // Build document index with original all data.
+// Scan document data of [start_key, end_key) and add to document index by batch.
+static void ScanDocumentToIndex(DocumentIndexPtr document_index, RawEnginePtr raw_engine, const std::string& cf_name,
+                                const std::string& start_key, const std::string& end_key, const std::string& trace,
+                                std::atomic<int64_t>& count, std::atomic<int64_t>& upsert_use_time) {
+  int64_t document_index_id = document_index->Id();
+  int64_t start_time = Helper::TimestampMs();
+
+  IteratorOptions options;
+  options.upper_bound = end_key;
+  options.readahead_size = FLAGS_document_index_build_readahead_bytes;
+  options.fill_cache = false;
+  auto iter = raw_engine->Reader()->NewIterator(cf_name, options);
+  CHECK(iter != nullptr) << fmt::format("[document_index.build][id({})] NewIterator fail.", document_index_id);
+
+  std::vector<pb::common::DocumentWithId> documents;
+  documents.reserve(Constant::kBuildDocumentIndexBatchSize);
+  for (iter->Seek(start_key); iter->Valid(); iter->Next()) {
+    pb::common::DocumentWithId document;
+
+    std::string key(iter->Key());
+    document.set_id(DocumentCodec::DecodeDocumentIdFromEncodeKeyWithTs(key));
+    auto value = mvcc::Codec::UnPackageValue(iter->Value());
+    if (!document.mutable_document()->ParseFromArray(value.data(), value.size())) {
+      DINGO_LOG(ERROR) << fmt::format(
+          "[document_index.build][id({})][trace({})] document with id ParseFromString fail.", document_index_id, trace);
+      continue;
+    }
+
+    if (document.document().document_data_size() <= 0) {
+      DINGO_LOG(WARNING) << fmt::format("[document_index.build][id({})][trace({})] document values_size error.",
+                                        document_index_id, trace);
+      continue;
+    }
+
+    documents.push_back(std::move(document));
+    if (documents.size() >= Constant::kBuildDocumentIndexBatchSize) {
+      int64_t upsert_start_time = Helper::TimestampMs();
+
+      document_index->Add(documents, false);
+
+      int32_t this_upsert_time = Helper::TimestampMs() - upsert_start_time;
+      upsert_use_time.fetch_add(this_upsert_time);
+      int64_t total_count = count.fetch_add(documents.size()) + documents.size();
+
+      DINGO_LOG(INFO) << fmt::format(
+          "[document_index.build][id({})][trace({})] Build document index progress, speed({:.3}) count({}) "
+          "elapsed time({}/{}ms)",
+          document_index_id, trace, static_cast<double>(this_upsert_time) / documents.size(), total_count,
+          upsert_use_time.load(), Helper::TimestampMs() - start_time);
+
+      documents.clear();
+      // yield, for other bthread run.
+      bthread_yield();
+    }
+  }
+
+  if (!documents.empty()) {
+    int64_t upsert_start_time = Helper::TimestampMs();
+    document_index->Add(documents, false);
+    upsert_use_time.fetch_add(Helper::TimestampMs() - upsert_start_time);
+    count.fetch_add(documents.size());
+  }
+}
+
+// Split build range to document_index_build_parallel_num sub ranges by document id, return whole range if region is
+// small. Bound of sub range is encode key without ts, so all versions of one document is in same sub range.
+static std::vector<std::pair<std::string, std::string>> SplitBuildRange(RawEnginePtr raw_engine,
+                                                                        const std::string& cf_name,
+                                                                        const pb::common::Range& plain_range,
+                                                                        const std::string& start_key,
+                                                                        const std::string& end_key) {
+  int64_t parallel_num = FLAGS_document_index_build_parallel_num;
+  if (parallel_num <= 1) {
+    return {{start_key, end_key}};
+  }
+
+  // first and last document id of region
+  IteratorOptions options;
+  auto iter = raw_engine->Reader()->NewIterator(cf_name, options);
+  if (iter == nullptr) {
+    return {{start_key, end_key}};
+  }
+  iter->Seek(start_key);
+  if (!iter->Valid() || iter->Key() >= end_key) {
+    return {{start_key, end_key}};
+  }
+  int64_t min_document_id = DocumentCodec::DecodeDocumentIdFromEncodeKeyWithTs(std::string(iter->Key()));
+  iter->SeekForPrev(end_key);
+  if (!iter->Valid() || iter->Key() < start_key) {
+    return {{start_key, end_key}};
+  }
+  int64_t max_document_id = DocumentCodec::DecodeDocumentIdFromEncodeKeyWithTs(std::string(iter->Key()));
+
+  int64_t step = (max_document_id - min_document_id + 1) / parallel_num;
+  if (step < static_cast<int64_t>(Constant::kBuildDocumentIndexBatchSize)) {
+    return {{start_key, end_key}};
+  }
+
+  char prefix = Helper::GetKeyPrefix(plain_range);
+  int64_t partition_id = DocumentCodec::UnPackagePartitionId(plain_range.start_key());
+
+  std::vector<std::pair<std::string, std::string>> sub_ranges;
+  std::string sub_start_key = start_key;
+  for (int64_t i = 1; i < parallel_num; ++i) {
+    std::string sub_end_key = DocumentCodec::EncodeDocumentKey(prefix, partition_id, min_document_id + step * i);
+    sub_ranges.emplace_back(sub_start_key, sub_end_key);
+    sub_start_key = sub_end_key;
+  }
+  sub_ranges.emplace_back(sub_start_key, end_key);
+
+  return sub_ranges;
+}
+
 DocumentIndexPtr DocumentIndexManager::BuildDocumentIndex(DocumentIndexWrapperPtr document_index_wrapper,
                                                           const std::string& trace) {
   assert(document_index_wrapper != nullptr);
@@ -775,9 +1033,6 @@ DocumentIndexPtr DocumentIndexManager::BuildDocumentIndex(DocumentIndexWrapperPt
 
   int64_t start_time = Helper::TimestampMs();
   // load document data to document index
-  IteratorOptions options;
-  options.upper_bound = end_key;
-
   auto raw_engine = Server::GetInstance().GetRawEngine(region->GetRawEngineType());
 #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
   std::string which_cf;
@@ -800,68 +1055,44 @@ DocumentIndexPtr DocumentIndexManager::BuildDocumentIndex(DocumentIndexWrapperPt
       return nullptr;
     }
   }
-  auto iter = raw_engine->Reader()->NewIterator(which_cf, options);
 #else
-  auto iter = raw_engine->Reader()->NewIterator(Constant::kStoreDataCF, options);
+  std::string which_cf = Constant::kStoreDataCF;
 #endif
 
-  CHECK(iter != nullptr) << fmt::format("[document_index.build][id({})] NewIterator fail.", document_index_id);
+  auto sub_ranges = SplitBuildRange(raw_engine, which_cf, range, start_key, end_key);
 
-  int64_t count = 0;
-  int64_t upsert_use_time = 0;
-  std::vector<pb::common::DocumentWithId> documents;
-  documents.reserve(Constant::kBuildDocumentIndexBatchSize);
-  for (iter->Seek(start_key); iter->Valid(); iter->Next()) {
-    pb::common::DocumentWithId document;
-
-    std::string key(iter->Key());
-    document.set_id(DocumentCodec::DecodeDocumentIdFromEncodeKeyWithTs(key));
-    std::string value(mvcc::Codec::UnPackageValue(iter->Value()));
-    if (!document.mutable_document()->ParseFromString(value)) {
-      DINGO_LOG(ERROR) << fmt::format(
-          "[document_index.build][id({})][trace({})] document with id ParseFromString fail.", document_index_id, trace);
-      continue;
-    }
-
-    if (document.document().document_data_size() <= 0) {
-      DINGO_LOG(WARNING) << fmt::format("[document_index.build][id({})][trace({})] document values_size error.",
-                                        document_index_id, trace);
-      continue;
+  std::atomic<int64_t> count = 0;
+  std::atomic<int64_t> upsert_use_time = 0;
+  if (sub_ranges.size() == 1) {
+    ScanDocumentToIndex(document_index, raw_engine, which_cf, start_key, end_key, trace, count, upsert_use_time);
+  } else {
+    // sub ranges are scanned and decoded in parallel, tantivy writer index documents by its own threads.
+    auto thread_pool = Server::GetInstance().GetDocumentIndexThreadPool();
+    std::vector<ThreadPool::TaskPtr> tasks;
+    for (const auto& sub_range : sub_ranges) {
+      auto task = thread_pool->ExecuteTask(
+          [&](void*) {
+            ScanDocumentToIndex(document_index, raw_engine, which_cf, sub_range.first, sub_range.second, trace, count,
+                                upsert_use_time);
+          },
+          nullptr);
+      if (task != nullptr) {
+        tasks.push_back(task);
+      }
     }
 
-    documents.push_back(document);
-    if (++count % Constant::kBuildDocumentIndexBatchSize == 0) {
-      int64_t upsert_start_time = Helper::TimestampMs();
-
-      document_index->Add(documents, false);
-
-      int32_t this_upsert_time = Helper::TimestampMs() - upsert_start_time;
-      upsert_use_time += this_upsert_time;
-
-      DINGO_LOG(INFO) << fmt::format(
-          "[document_index.build][id({})][trace({})] Build document index progress, speed({:.3}) count({}) "
-          "elapsed time({}/{}ms)",
-          document_index_id, trace, static_cast<double>(this_upsert_time) / documents.size(), count, upsert_use_time,
-          Helper::TimestampMs() - start_time);
-
-      documents.clear();
-      // yield, for other bthread run.
-      bthread_yield();
+    for (auto& task : tasks) {
+      task->Join();
     }
-  }
-
-  if (!documents.empty()) {
-    int64_t upsert_start_time = Helper::TimestampMs();
-    document_index->Add(documents, false);
-    upsert_use_time += (Helper::TimestampMs() - upsert_start_time);
+    g_document_index_parallel_build_count << 1;
   }
 
   DINGO_LOG(INFO) << fmt::format(
       "[document_index.build][id({})][trace({})] Build document index finish, parallel({}) count({}) epoch({}) "
       "range({}) elapsed time({}/{}ms)",
-      document_index_id, trace, document_index->WriteOpParallelNum(), count,
+      document_index_id, trace, sub_ranges.size(), count.load(),
       Helper::RegionEpochToString(document_index->Epoch()),
-      DocumentCodec::DebugRange(false, document_index->Range(false)), upsert_use_time,
+      DocumentCodec::DebugRange(false, document_index->Range(false)), upsert_use_time.load(),
       Helper::TimestampMs() - start_time);
 
   return document_index;
@@ -1094,6 +1325,14 @@ bool DocumentIndexManager::ExecuteTaskFast(int64_t region_id, TaskRunnablePtr ta
   return fast_workers_->ExecuteHashByRegionId(region_id, task);
 }
 
+bool DocumentIndexManager::ExecuteTaskSearch(TaskRunnablePtr task) {
+  if (search_workers_ == nullptr) {
+    return false;
+  }
+
+  return search_workers_->Execute(task);
+}
+
 #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
 bool DocumentIndexManager::ExecuteTaskVectorScalarSearch(int64_t /*region_id*/, TaskRunnablePtr task) {
   return vector_scalar_search_workers_->Execute(task);
@@ -1112,6 +1351,126 @@ bool DocumentIndexManager::ExecuteTask(int64_t region_id, TaskRunnablePtr task,
   return Server::GetInstance().GetDocumentIndexManager()->ExecuteTask(region_id, task);
 }
 
+static void OnRefreshDocumentIndexTimer(void* arg) {
+  std::unique_ptr<std::weak_ptr<DocumentIndex>> weak_document_index(static_cast<std::weak_ptr<DocumentIndex>*>(arg));
+  auto document_index = weak_document_index->lock();
+  if (document_index != nullptr) {
+    DocumentIndexManager::LaunchRefreshDocumentIndex(document_index);
+  }
+}
+
+void DocumentIndexManager::ScheduleRefreshDocumentIndex(DocumentIndexPtr document_index) {
+  if (document_index->PendingWriteCount() >= FLAGS_document_index_refresh_max_docs) {
+    LaunchRefreshDocumentIndex(document_index);
+    return;
+  }
+
+  if (!document_index->TrySetRefreshScheduled()) {
+    return;
+  }
+
+  // timer only hold weak pointer, so it not delay free of the document index.
+  auto* weak_document_index = new std::weak_ptr<DocumentIndex>(document_index);
+  bthread_timer_t timer_id;
+  int ret = bthread_timer_add(&timer_id, butil::milliseconds_from_now(FLAGS_document_index_refresh_interval_ms),
+                              OnRefreshDocumentIndexTimer, weak_document_index);
+  if (ret != 0) {
+    DINGO_LOG(WARNING) << fmt::format("[document_index.refresh][id({})] add refresh timer fail, ret: {}",
+                                      document_index->Id(), ret);
+    delete weak_document_index;
+    LaunchRefreshDocumentIndex(document_index);
+  }
+}
+
+void DocumentIndexManager::LaunchRefreshDocumentIndex(DocumentIndexPtr document_index) {
+  auto task = std::make_shared<RefreshDocumentIndexTask>(document_index);
+
+  // no manager, e.g. in unit test, refresh at once.
+  auto document_index_manager = Server::GetInstance().GetDocumentIndexManager();
+  if (document_index_manager == nullptr || !document_index_manager->ExecuteTaskFast(document_index->Id(), task)) {
+    task->Run();
+  }
+}
+
+// off-peak hours is [start_hour, end_hour), may cross midnight, all day when start_hour equal end_hour.
+static bool IsForceMergeHour() {
+  int start_hour = FLAGS_document_index_force_merge_start_hour;
+  int end_hour = FLAGS_document_index_force_merge_end_hour;
+  if (start_hour == end_hour) {
+    return true;
+  }
+
+  int hour = Helper::NowHour();
+  return start_hour < end_hour ? (hour >= start_hour && hour < end_hour) : (hour >= start_hour || hour < end_hour);
+}
+
+void DocumentIndexManager::ForceMergeDocumentIndex() {
+  if (!FLAGS_enable_document_index_force_merge || !IsForceMergeHour()) {
+    return;
+  }
+
+  int64_t launch_num = FLAGS_document_index_force_merge_max_running_num -
+                       g_document_index_force_merge_running_num.get_value();
+  int64_t candidate_num = 0;
+  auto regions = Server::GetInstance().GetAllAliveRegion();
+  for (const auto& region : regions) {
+    auto document_index_wrapper = region->DocumentIndexWrapper();
+    if (document_index_wrapper == nullptr || region->State() != pb::common::NORMAL) {
+      continue;
+    }
+    if (!document_index_wrapper->IsReady() || document_index_wrapper->IsDestoryed()) {
+      continue;
+    }
+
+    int64_t segment_count = 0;
+    auto status = document_index_wrapper->GetSegmentCount(segment_count);
+    if (!status.ok() || segment_count < FLAGS_document_index_force_merge_min_segment_count) {
+      continue;
+    }
+    ++candidate_num;
+
+    // not conflict with rebuild and load.
+    if (launch_num <= 0 || document_index_wrapper->RebuildingNum() > 0 ||
+        document_index_wrapper->LoadorbuildingNum() > 0) {
+      continue;
+    }
+
+    LaunchForceMergeDocumentIndex(document_index_wrapper, segment_count, "from crontab");
+    --launch_num;
+  }
+
+  g_document_index_force_merge_candidate_num.set_value(candidate_num);
+}
+
+void DocumentIndexManager::LaunchForceMergeDocumentIndex(DocumentIndexWrapperPtr document_index_wrapper,
+                                                         int64_t segment_count, const std::string& trace) {
+  assert(document_index_wrapper != nullptr);
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[document_index.launch][id({})][trace({})] Launch force merge document index, segment_count({}).",
+      document_index_wrapper->Id(), trace, segment_count);
+
+  auto task = std::make_shared<DocumentForceMergeTask>(document_index_wrapper, segment_count, trace);
+  if (!DocumentIndexManager::ExecuteTask(document_index_wrapper->Id(), task, false)) {
+    DINGO_LOG(ERROR) << fmt::format("[document_index.launch][id({})][trace({})] Launch force merge document index fail",
+                                    document_index_wrapper->Id(), trace);
+  } else {
+    document_index_wrapper->IncRebuildingNum();
+    document_index_wrapper->IncPendingTaskNum();
+  }
+}
+
+void DocumentIndexManager::LaunchWarmupDocumentIndex(DocumentIndexWrapperPtr document_index_wrapper,
+                                                     const std::string& trace) {
+  assert(document_index_wrapper != nullptr);
+
+  auto task = std::make_shared<WarmupDocumentIndexTask>(document_index_wrapper, trace);
+  if (!DocumentIndexManager::ExecuteTask(document_index_wrapper->Id(), task, true)) {
+    DINGO_LOG(ERROR) << fmt::format("[document_index.launch][id({})][trace({})] Launch warmup document index fail",
+                                    document_index_wrapper->Id(), trace);
+  }
+}
+
 std::vector<std::vector<std::string>> DocumentIndexManager::GetPendingTaskTrace() {
   if (workers_ == nullptr || fast_workers_ == nullptr) {
     return {};
@@ -87,6 +87,64 @@ class LoadOrBuildDocumentIndexTask : public TaskRunnable {
   int64_t start_time_;
 };
 
+// Commit pending writes and reload reader of document index
+class RefreshDocumentIndexTask : public TaskRunnable {
+ public:
+  explicit RefreshDocumentIndexTask(DocumentIndexPtr document_index) : document_index_(document_index) {}
+  ~RefreshDocumentIndexTask() override = default;
+
+  std::string Type() override { return "REFRESH_DOCUMENT_INDEX"; }
+
+  void Run() override;
+
+  std::string Trace() override;
+
+ private:
+  DocumentIndexPtr document_index_;
+};
+
+// Force merge segments of document index by rebuild it from region data, at off-peak hours.
+class DocumentForceMergeTask : public TaskRunnable {
+ public:
+  DocumentForceMergeTask(DocumentIndexWrapperPtr document_index_wrapper, int64_t segment_count,
+                         const std::string& trace)
+      : document_index_wrapper_(document_index_wrapper), segment_count_(segment_count), trace_(trace) {
+    start_time_ = Helper::TimestampMs();
+  }
+  ~DocumentForceMergeTask() override = default;
+
+  std::string Type() override { return "FORCE_MERGE_DOCUMENT_INDEX"; }
+
+  void Run() override;
+
+  std::string Trace() override;
+
+ private:
+  DocumentIndexWrapperPtr document_index_wrapper_;
+  // segment count when launch
+  int64_t segment_count_;
+  std::string trace_;
+  int64_t start_time_;
+};
+
+// Warmup document index files into page cache, e.g. when region become leader.
+class WarmupDocumentIndexTask : public TaskRunnable {
+ public:
+  WarmupDocumentIndexTask(DocumentIndexWrapperPtr document_index_wrapper, const std::string& trace)
+      : document_index_wrapper_(document_index_wrapper), trace_(trace) {}
+  ~WarmupDocumentIndexTask() override = default;
+
+  std::string Type() override { return "WARMUP_DOCUMENT_INDEX"; }
+
+  void Run() override;
+
+  std::string Trace() override;
+
+ private:
+  DocumentIndexWrapperPtr document_index_wrapper_;
+  std::string trace_;
+};
+
 // Manage document index, e.g. build/rebuild/save/load document index.
 class DocumentIndexManager {
  public:
@@ -125,6 +183,22 @@ class DocumentIndexManager {
   static void LaunchRebuildDocumentIndex(DocumentIndexWrapperPtr document_index_wrapper, int64_t job_id, bool is_clear,
                                          const std::string& trace);
 
+  // Near real time refresh after deferred write, refresh at once when pending writes reach
+  // document_index_refresh_max_docs, else refresh document_index_refresh_interval_ms later by timer.
+  static void ScheduleRefreshDocumentIndex(DocumentIndexPtr document_index);
+  // Launch refresh document index at fast execute queue.
+  static void LaunchRefreshDocumentIndex(DocumentIndexPtr document_index);
+
+  // Launch warmup own document index at fast execute queue.
+  static void LaunchWarmupDocumentIndex(DocumentIndexWrapperPtr document_index_wrapper, const std::string& trace);
+
+  // Scan alive region, force merge document index which segment count reach
+  // document_index_force_merge_min_segment_count, only at off-peak hours.
+  static void ForceMergeDocumentIndex();
+  // Launch force merge document index at execute queue.
+  static void LaunchForceMergeDocumentIndex(DocumentIndexWrapperPtr document_index_wrapper, int64_t segment_count,
+                                            const std::string& trace);
+
   static bvar::Adder<uint64_t> bvar_document_index_task_running_num;
   static bvar::Adder<uint64_t> bvar_document_index_rebuild_task_running_num;
   static bvar::Adder<uint64_t> bvar_document_index_loadorbuild_task_running_num;
@@ -185,6 +259,8 @@ class DocumentIndexManager {
 
   bool ExecuteTask(int64_t region_id, TaskRunnablePtr task);
   bool ExecuteTaskFast(int64_t region_id, TaskRunnablePtr task);
+  // Execute document search at pthread worker, return false if search worker is disabled or queue is full.
+  bool ExecuteTaskSearch(TaskRunnablePtr task);
 #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
   bool ExecuteTaskVectorScalarSearch(int64_t region_id, TaskRunnablePtr task);
   static bool ExecuteTaskForVector(int64_t region_id, TaskRunnablePtr task);
@@ -222,6 +298,8 @@ class DocumentIndexManager {
   // Execute all document index load/build/rebuild/save task.
   WorkerSetPtr workers_;
   WorkerSetPtr fast_workers_;
+  // Execute document search, blocking tantivy search not block bthread worker.
+  WorkerSetPtr search_workers_;
 
 #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
   // only for vector index scalar search with document
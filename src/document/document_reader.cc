@@ -14,9 +14,12 @@
 
 #include "document/document_reader.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #include "butil/status.h"
@@ -34,19 +37,10 @@ namespace dingodb {
 
 DECLARE_int64(stream_message_max_limit_size);
 
-butil::Status DocumentReader::QueryDocumentWithId(int64_t ts, const pb::common::Range& region_range,
-                                                  int64_t partition_id, int64_t document_id, bool with_scalar_data,
-                                                  bool with_table_data, std::vector<std::string>& selected_scalar_keys,
-                                                  pb::common::DocumentWithId& document_with_id) {
-  std::string plain_key =
-      DocumentCodec::PackageDocumentKey(Helper::GetKeyPrefix(region_range), partition_id, document_id);
-
-  std::string value;
-  auto status = reader_->KvGet(Constant::kStoreDataCF, ts, plain_key, value);
-  if (!status.ok()) {
-    return status;
-  }
-
+// build document_with_id from document value, only keep selected columns.
+static butil::Status ParseDocumentWithId(int64_t document_id, const std::string& value, bool with_scalar_data,
+                                         bool with_table_data, const std::vector<std::string>& selected_scalar_keys,
+                                         pb::common::DocumentWithId& document_with_id) {
   pb::common::Document document;
   if (!document.ParseFromString(value)) {
     return butil::Status(pb::error::EINTERNAL, "Parse proto from string error");
@@ -58,7 +52,7 @@ butil::Status DocumentReader::QueryDocumentWithId(int64_t ts, const pb::common::
       document_with_id.mutable_document()->Swap(&document);
       return butil::Status();
     } else {
-      for (auto& key : selected_scalar_keys) {
+      for (const auto& key : selected_scalar_keys) {
         auto scalar = document.document_data().find(key);
         if (scalar == document.document_data().end()) {
           continue;
@@ -82,6 +76,69 @@ butil::Status DocumentReader::QueryDocumentWithId(int64_t ts, const pb::common::
   return butil::Status();
 }
 
+butil::Status DocumentReader::QueryDocumentWithId(int64_t ts, const pb::common::Range& region_range,
+                                                  int64_t partition_id, int64_t document_id, bool with_scalar_data,
+                                                  bool with_table_data, std::vector<std::string>& selected_scalar_keys,
+                                                  pb::common::DocumentWithId& document_with_id) {
+  std::string plain_key =
+      DocumentCodec::PackageDocumentKey(Helper::GetKeyPrefix(region_range), partition_id, document_id);
+
+  std::string value;
+  auto status = reader_->KvGet(Constant::kStoreDataCF, ts, plain_key, value);
+  if (!status.ok()) {
+    return status;
+  }
+
+  return ParseDocumentWithId(document_id, value, with_scalar_data, with_table_data, selected_scalar_keys,
+                             document_with_id);
+}
+
+butil::Status DocumentReader::BatchQueryDocumentWithId(int64_t ts, const pb::common::Range& region_range,
+                                                       int64_t partition_id, const std::vector<int64_t>& document_ids,
+                                                       bool with_scalar_data, bool with_table_data,
+                                                       const std::vector<std::string>& selected_scalar_keys,
+                                                       std::vector<pb::common::DocumentWithId>& document_with_ids,
+                                                       std::vector<bool>& founds) {
+  char prefix = Helper::GetKeyPrefix(region_range);
+  std::vector<std::string> plain_keys;
+  plain_keys.reserve(document_ids.size());
+  for (auto document_id : document_ids) {
+    plain_keys.push_back(DocumentCodec::PackageDocumentKey(prefix, partition_id, document_id));
+  }
+
+  // one iterator seek sorted keys, instead of a point get per id.
+  std::vector<pb::common::KeyValue> plain_kvs;
+  auto status = reader_->KvBatchGet(Constant::kStoreDataCF, ts, plain_keys, plain_kvs);
+  if (!status.ok()) {
+    return status;
+  }
+
+  std::unordered_map<std::string_view, const std::string*> plain_values;
+  plain_values.reserve(plain_kvs.size());
+  for (const auto& kv : plain_kvs) {
+    plain_values[kv.key()] = &kv.value();
+  }
+
+  // keep order of document_ids, if the id is not exist, the document_with_id will be empty.
+  document_with_ids.resize(document_ids.size());
+  founds.resize(document_ids.size(), false);
+  for (size_t i = 0; i < document_ids.size(); ++i) {
+    auto it = plain_values.find(plain_keys[i]);
+    if (it == plain_values.end()) {
+      continue;
+    }
+
+    status = ParseDocumentWithId(document_ids[i], *it->second, with_scalar_data, with_table_data,
+                                 selected_scalar_keys, document_with_ids[i]);
+    if (!status.ok()) {
+      return status;
+    }
+    founds[i] = true;
+  }
+
+  return butil::Status::OK();
+}
+
 butil::Status DocumentReader::SearchDocument(int64_t ts, int64_t partition_id, DocumentIndexWrapperPtr document_index,
                                              pb::common::Range region_range,
                                              const pb::common::DocumentSearchParameter& parameter,
@@ -103,16 +160,26 @@ butil::Status DocumentReader::SearchDocument(int64_t ts, int64_t partition_id, D
   }
 
   // document index does not support restruct document, we restruct it using kv store
-  if (with_scalar_data || with_table_data) {
-    for (auto& document_with_score : document_with_score_results) {
-      pb::common::DocumentWithId document_with_id;
-      auto status = QueryDocumentWithId(ts, region_range, partition_id, document_with_score.document_with_id().id(),
-                                        with_scalar_data, with_table_data, selected_scalar_keys, document_with_id);
-      if (!status.ok()) {
-        return status;
-      }
+  if ((with_scalar_data || with_table_data) && !document_with_score_results.empty()) {
+    std::vector<int64_t> document_ids;
+    document_ids.reserve(document_with_score_results.size());
+    for (const auto& document_with_score : document_with_score_results) {
+      document_ids.push_back(document_with_score.document_with_id().id());
+    }
 
-      document_with_score.mutable_document_with_id()->Swap(&document_with_id);
+    std::vector<pb::common::DocumentWithId> document_with_ids;
+    std::vector<bool> founds;
+    auto status = BatchQueryDocumentWithId(ts, region_range, partition_id, document_ids, with_scalar_data,
+                                           with_table_data, selected_scalar_keys, document_with_ids, founds);
+    if (!status.ok()) {
+      return status;
+    }
+
+    for (size_t i = 0; i < document_with_score_results.size(); ++i) {
+      if (!founds[i]) {
+        return butil::Status(pb::error::EKEY_NOT_FOUND, "Not found document %ld", document_ids[i]);
+      }
+      document_with_score_results[i].mutable_document_with_id()->Swap(&document_with_ids[i]);
     }
   }
 
@@ -137,38 +204,60 @@ butil::Status DocumentReader::DocumentSearchAll(std::shared_ptr<Engine::Document
   auto stream = ctx->stream;
   auto stream_state =
       std::dynamic_pointer_cast<DocumentSearchAllStreamState>(stream->GetOrNewStreamState([&]() -> StreamStatePtr {
+        // only search id and score, document data is read by page.
         std::vector<pb::common::DocumentWithScore> all_results;
-        status = SearchDocument(ctx->ts, ctx->partition_id, ctx->document_index, ctx->region_range, ctx->parameter,
-                                all_results);
+        status = ctx->document_index->Search(ctx->region_range, ctx->parameter, all_results);
         if (!status.ok()) {
           return nullptr;
         }
-        return DocumentSearchAllStreamState::New(std::move(all_results));
+        return DocumentSearchAllStreamState::New(std::move(all_results), ctx->ts, ctx->parameter);
       }));
   if (!status.ok()) {
     DINGO_LOG(ERROR) << "Document search all failed: " << Helper::PrintStatus(status);
     return status;
   }
-  has_more = stream_state->Batch(stream->Limit(), results);
-  return status;
-}
 
-butil::Status DocumentReader::DocumentBatchQuery(std::shared_ptr<Engine::DocumentReader::Context> ctx,
-                                                 std::vector<pb::common::DocumentWithId>& document_with_ids) {
-  for (auto document_id : ctx->document_ids) {
+  const auto& parameter = stream_state->Parameter();
+  bool with_scalar_data = !(parameter.without_scalar_data());
+  bool with_table_data = !(parameter.without_table_data());
+  std::vector<std::string> selected_scalar_keys;
+  if (with_scalar_data) {
+    for (const auto& scalar_key : parameter.selected_keys()) {
+      selected_scalar_keys.push_back(scalar_key);
+    }
+  }
+
+  auto filler = [&](int64_t ts, pb::common::DocumentWithScore& document_with_score) -> butil::Status {
+    if (!with_scalar_data && !with_table_data) {
+      return butil::Status::OK();
+    }
+
     pb::common::DocumentWithId document_with_id;
-    auto status = QueryDocumentWithId(ctx->ts, ctx->region_range, ctx->partition_id, document_id, ctx->with_scalar_data,
-                                      ctx->with_table_data, ctx->selected_scalar_keys, document_with_id);
-    if ((!status.ok()) && status.error_code() != pb::error::EKEY_NOT_FOUND) {
-      DINGO_LOG(WARNING) << fmt::format("Query document_with_id failed, document_id: {} error: {}", document_id,
-                                        status.error_str());
+    auto query_status = QueryDocumentWithId(ts, ctx->region_range, ctx->partition_id,
+                                            document_with_score.document_with_id().id(), with_scalar_data,
+                                            with_table_data, selected_scalar_keys, document_with_id);
+    if (!query_status.ok()) {
+      return query_status;
     }
 
-    // if the id is not exist, the document_with_id will be empty, sdk client will handle this
-    document_with_ids.push_back(document_with_id);
+    document_with_score.mutable_document_with_id()->Swap(&document_with_id);
+    return butil::Status::OK();
+  };
+
+  has_more = stream_state->Batch(stream->Limit(), filler, results, status);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << "Document search all read document failed: " << Helper::PrintStatus(status);
   }
+  return status;
+}
 
-  return butil::Status::OK();
+butil::Status DocumentReader::DocumentBatchQuery(std::shared_ptr<Engine::DocumentReader::Context> ctx,
+                                                 std::vector<pb::common::DocumentWithId>& document_with_ids) {
+  std::vector<bool> founds;
+  // if the id is not exist, the document_with_id will be empty, sdk client will handle this
+  return BatchQueryDocumentWithId(ctx->ts, ctx->region_range, ctx->partition_id, ctx->document_ids,
+                                  ctx->with_scalar_data, ctx->with_table_data, ctx->selected_scalar_keys,
+                                  document_with_ids, founds);
 }
 
 butil::Status DocumentReader::DocumentGetBorderId(int64_t ts, const pb::common::Range& region_range, bool get_min,
@@ -379,19 +468,25 @@ butil::Status DocumentReader::ScanDocumentId(std::shared_ptr<Engine::DocumentRea
   return butil::Status::OK();
 }
 
-bool DocumentSearchAllStreamState::Batch(int32_t limit, std::vector<pb::common::DocumentWithScore>& results) {
-  results.reserve(limit);
+bool DocumentSearchAllStreamState::Batch(int32_t limit, const Filler& filler,
+                                         std::vector<pb::common::DocumentWithScore>& results, butil::Status& status) {
+  results.reserve(std::min(static_cast<size_t>(limit), results_.size() - offset_));
   size_t count = 0;
   size_t total_bytes = 0;
-  bool has_more;
-  while (current_ != end_ && count < limit && total_bytes < FLAGS_stream_message_max_limit_size) {
-    results.push_back(*current_);
-    total_bytes += current_->ByteSizeLong();
-    ++current_;
+  while (offset_ < results_.size() && count < limit && total_bytes < FLAGS_stream_message_max_limit_size) {
+    auto& document_with_score = results_[offset_];
+    status = filler(ts_, document_with_score);
+    if (!status.ok()) {
+      break;
+    }
+
+    total_bytes += document_with_score.ByteSizeLong();
+    results.push_back(std::move(document_with_score));
+    ++offset_;
     ++count;
   }
-  has_more = (current_ != end_);
-  return has_more;
+
+  return offset_ < results_.size();
 }
 
 }  // namespace dingodb
@@ -18,6 +18,7 @@
 #include <sys/types.h>
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -65,6 +66,12 @@ class DocumentReader {
                                     int64_t document_id, bool with_scalar_data, bool with_table_data,
                                     std::vector<std::string>& selected_scalar_keys,
                                     pb::common::DocumentWithId& document_with_id);
+  // read many documents by one batch get, output is same order as document_ids, founds mark the existing documents.
+  butil::Status BatchQueryDocumentWithId(int64_t ts, const pb::common::Range& region_range, int64_t partition_id,
+                                         const std::vector<int64_t>& document_ids, bool with_scalar_data,
+                                         bool with_table_data, const std::vector<std::string>& selected_scalar_keys,
+                                         std::vector<pb::common::DocumentWithId>& document_with_ids,
+                                         std::vector<bool>& founds);
   butil::Status SearchDocument(int64_t ts, int64_t partition_id, DocumentIndexWrapperPtr document_index,
                                pb::common::Range region_range, const pb::common::DocumentSearchParameter& parameter,
                                std::vector<pb::common::DocumentWithScore>& document_with_score_results);
@@ -78,23 +85,37 @@ class DocumentReader {
 class DocumentSearchAllStreamState;
 using DocumentSearchAllStreamStatePtr = std::shared_ptr<DocumentSearchAllStreamState>;
 
+// Cursor of document search all, hold id and score of all matched documents at first request,
+// document data is read page by page at the snapshot ts, so each continuation cost O(page).
 class DocumentSearchAllStreamState : public StreamState {
  public:
-  DocumentSearchAllStreamState(std::vector<pb::common::DocumentWithScore>& vec) {
-    results_ = vec;
-    current_ = results_.begin();
-    end_ = results_.end();
-  }
+  // read document data of one result
+  using Filler = std::function<butil::Status(int64_t ts, pb::common::DocumentWithScore& document_with_score)>;
+
+  DocumentSearchAllStreamState(std::vector<pb::common::DocumentWithScore>&& results, int64_t ts,
+                               const pb::common::DocumentSearchParameter& parameter)
+      : results_(std::move(results)), ts_(ts), parameter_(parameter) {}
   ~DocumentSearchAllStreamState() override = default;
-  bool Batch(int32_t limit, std::vector<pb::common::DocumentWithScore>& results);
-  static DocumentSearchAllStreamStatePtr New(std::vector<pb::common::DocumentWithScore> vec) {
-    return std::make_shared<DocumentSearchAllStreamState>(vec);
+
+  static DocumentSearchAllStreamStatePtr New(std::vector<pb::common::DocumentWithScore>&& results, int64_t ts,
+                                             const pb::common::DocumentSearchParameter& parameter) {
+    return std::make_shared<DocumentSearchAllStreamState>(std::move(results), ts, parameter);
   }
 
+  // parameter of first request, decide which document data is read.
+  const pb::common::DocumentSearchParameter& Parameter() const { return parameter_; }
+
+  // return has more, the returned results are moved out of the cursor.
+  // if fill fail, cursor stay at the failed result, so the next request retry it.
+  bool Batch(int32_t limit, const Filler& filler, std::vector<pb::common::DocumentWithScore>& results,
+             butil::Status& status);
+
  private:
-  std::vector<pb::common::DocumentWithScore>::iterator current_;
-  std::vector<pb::common::DocumentWithScore>::iterator end_;
   std::vector<pb::common::DocumentWithScore> results_;
+  size_t offset_{0};
+  // read ts of first request
+  int64_t ts_;
+  pb::common::DocumentSearchParameter parameter_;
 };
 
 }  // namespace dingodb
@@ -17,6 +17,7 @@
 #include <gflags/gflags.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <cstdlib>
@@ -80,6 +81,10 @@ DEFINE_int32(bdb_dead_lock_detect_time_s, 1, "bdb dead_lock_detect interval(s)")
 DEFINE_int32(bdb_stat_time_s, 60, "bdb stat time interval(s)");
 
 DEFINE_bool(bdb_use_db_pool, false, "bdb use db pool");
+DEFINE_int32(bdb_env_cache_count, 1, "bdb env cache region count, cache size is split into these regions");
+DEFINE_bool(bdb_kv_get_without_snapshot, false,
+            "bdb kv get without snapshot read latest committed value, save txn and cursor setup per get");
+DEFINE_int32(bdb_scan_bulk_buffer_size, 1024 * 1024, "bdb scan read records in bulk buffer, 0 means not use bulk");
 DEFINE_int32(bdb_db_pool_size, 4096, "bdb db pool size, must bigger than bthread_connecurrency");
 
 namespace bdb {
@@ -686,6 +691,11 @@ BdbSnapshot::~BdbSnapshot() {
 
 // Reader
 butil::Status Reader::KvGet(const std::string& cf_name, const std::string& key, std::string& value) {
+  // a single key get is consistent by itself, snapshot txn is only needed by read of multiple keys.
+  if (FLAGS_bdb_kv_get_without_snapshot) {
+    return KvGet(cf_name, nullptr, key, value);
+  }
+
   return KvGet(cf_name, GetSnapshot(), key, value);
 }
 
@@ -743,6 +753,61 @@ butil::Status Reader::KvGet(const std::string& cf_name, dingodb::SnapshotPtr sna
   return butil::Status(pb::error::EBDB_UNKNOW, "unknow error.");
 }
 
+butil::Status Reader::KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                 std::vector<std::string>& values, std::vector<bool>& key_states) {
+  return KvMultiGet(cf_name, GetSnapshot(), keys, values, key_states);
+}
+
+butil::Status Reader::KvMultiGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                 std::vector<bool>& key_states) {
+  values.clear();
+  key_states.clear();
+  if (keys.empty()) {
+    return butil::Status();
+  }
+
+  for (const auto& key : keys) {
+    if (BAIDU_UNLIKELY(key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[bdb] not support empty key.");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+  }
+
+  // visit keys in ascending order, so the cursor moves forward through the btree pages.
+  std::vector<size_t> sorted_indexes(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    sorted_indexes[i] = i;
+  }
+  std::sort(sorted_indexes.begin(), sorted_indexes.end(),
+            [&keys](size_t lhs, size_t rhs) { return keys[lhs] < keys[rhs]; });
+
+  IteratorOptions options;
+  options.lower_bound = keys[sorted_indexes.front()];
+  auto iter = NewIterator(cf_name, snapshot, options);
+  if (iter == nullptr) {
+    DINGO_LOG(ERROR) << fmt::format("[bdb] create iterator failed.");
+    return butil::Status(pb::error::EINTERNAL, "Internal create iterator error.");
+  }
+
+  values.resize(keys.size());
+  key_states.resize(keys.size(), false);
+  for (auto index : sorted_indexes) {
+    const auto& key = keys[index];
+    iter->Seek(key);
+    if (!iter->Status().ok()) {
+      return iter->Status();
+    }
+
+    if (iter->Valid() && iter->Key() == key) {
+      values[index].assign(iter->Value().data(), iter->Value().size());
+      key_states[index] = true;
+    }
+  }
+
+  return butil::Status::OK();
+}
+
 butil::Status Reader::KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                              std::vector<pb::common::KeyValue>& kvs) {
   return KvScan(cf_name, GetSnapshot(), start_key, end_key, kvs);
@@ -764,6 +829,13 @@ butil::Status Reader::KvScan(const std::string& cf_name, dingodb::SnapshotPtr sn
     return butil::Status();
   }
 
+  if (FLAGS_bdb_scan_bulk_buffer_size > 0) {
+    auto ss = std::dynamic_pointer_cast<bdb::BdbSnapshot>(snapshot);
+    if (ss != nullptr) {
+      return ScanByBulkCursor(cf_name, ss, start_key, end_key, kvs);
+    }
+  }
+
   IteratorOptions options;
   options.lower_bound = start_key;
   options.upper_bound = end_key;
@@ -1026,6 +1098,99 @@ butil::Status Reader::RetrieveByCursor(const std::string& cf_name, DbTxn* txn, c
   return butil::Status(pb::error::EBDB_UNKNOW, "unknown error.");
 }
 
+// bulk buffer must be multiple of 1024 and not less than page size.
+static uint32_t BulkBufferSize(uint32_t size) {
+  size = std::max(size, static_cast<uint32_t>(FLAGS_bdb_page_size));
+  return (size + 1023) / 1024 * 1024;
+}
+
+butil::Status Reader::ScanByBulkCursor(const std::string& cf_name, std::shared_ptr<bdb::BdbSnapshot> snapshot,
+                                       const std::string& start_key, const std::string& end_key,
+                                       std::vector<pb::common::KeyValue>& kvs) {
+  std::string store_start_key = BdbHelper::EncodeKey(cf_name, start_key);
+  std::string store_end_key = BdbHelper::EncodeKey(cf_name, end_key);
+
+  Dbc* cursorp = nullptr;
+  // close cursorp
+  DEFER(  // FOR_CLANG_FORMAT
+      if (cursorp != nullptr) {
+        try {
+          cursorp->close();
+          cursorp = nullptr;
+        } catch (DbException& db_exception) {
+          BdbHelper::PrintEnvStat(GetRawEngine()->GetEnv());
+          LOG(WARNING) << fmt::format("[bdb] cursor close failed, exception: {} {}.", db_exception.get_errno(),
+                                      db_exception.what());
+        }
+      });
+
+  try {
+    int ret = snapshot->GetDb()->cursor(snapshot->GetDbTxn(), &cursorp, DB_CURSOR_BULK | DB_TXN_SNAPSHOT);
+    if (ret != 0) {
+      DINGO_LOG(ERROR) << fmt::format("[bdb] cursor create failed, ret: {}.", ret);
+      return butil::Status(pb::error::EINTERNAL, "Internal cursor create error.");
+    }
+
+    std::vector<char> buffer(BulkBufferSize(FLAGS_bdb_scan_bulk_buffer_size));
+    Dbt bdb_key;
+    BdbHelper::StringToDbt(store_start_key, bdb_key);
+    uint32_t flags = DB_SET_RANGE;
+    for (;;) {
+      Dbt bdb_data;
+      bdb_data.set_data(buffer.data());
+      bdb_data.set_ulen(buffer.size());
+      bdb_data.set_flags(DB_DBT_USERMEM);
+
+      try {
+        ret = cursorp->get(&bdb_key, &bdb_data, flags | DB_MULTIPLE_KEY);
+      } catch (DbMemoryException&) {
+        ret = DB_BUFFER_SMALL;
+      }
+
+      if (ret == DB_BUFFER_SMALL) {
+        // a record is larger than buffer, cursor is not moved, get again with bigger buffer.
+        buffer.resize(BulkBufferSize(bdb_data.get_size()));
+        continue;
+      } else if (ret == DB_NOTFOUND) {
+        break;
+      } else if (ret != 0) {
+        DINGO_LOG(ERROR) << fmt::format("[bdb] bulk cursor get failed, ret: {}.", ret);
+        return butil::Status(pb::error::EINTERNAL, "Internal bulk cursor get error.");
+      }
+
+      DbMultipleKeyDataIterator bulk_iter(bdb_data);
+      Dbt record_key, record_value;
+      while (bulk_iter.next(record_key, record_value)) {
+        std::string_view sv((const char*)record_key.get_data(), record_key.get_size());
+        if (store_end_key.compare(sv) <= 0) {
+          return butil::Status::OK();
+        }
+
+        pb::common::KeyValue kv;
+        BdbHelper::DbtToUserKey(record_key, *kv.mutable_key());
+        kv.set_value(record_value.get_data(), record_value.get_size());
+        kvs.push_back(std::move(kv));
+      }
+
+      flags = DB_NEXT;
+    }
+  } catch (DbDeadlockException&) {
+    DINGO_LOG(ERROR) << fmt::format("[bdb] scan by bulk cursor, got deadlock.");
+    return butil::Status(pb::error::EBDB_DEADLOCK, "scan by bulk cursor, got deadlock.");
+  } catch (DbException& db_exception) {
+    BdbHelper::PrintEnvStat(GetRawEngine()->GetEnv());
+    DINGO_LOG(ERROR) << fmt::format("[bdb] scan by bulk cursor, got db exception: {} {}.", db_exception.get_errno(),
+                                    db_exception.what());
+    return butil::Status(pb::error::EBDB_EXCEPTION,
+                         fmt::format("scan by bulk cursor failed, {}.", db_exception.what()));
+  } catch (std::exception& std_exception) {
+    DINGO_LOG(ERROR) << fmt::format("[bdb] std exception, {}.", std_exception.what());
+    return butil::Status(pb::error::ESTD_EXCEPTION, fmt::format("std exception, {}.", std_exception.what()));
+  }
+
+  return butil::Status::OK();
+}
+
 // Writer
 butil::Status Writer::KvPut(const std::string& cf_name, const pb::common::KeyValue& kv) {
   if (BAIDU_UNLIKELY(kv.key().empty())) {
@@ -2072,7 +2237,8 @@ bool BdbRawEngine::Init(std::shared_ptr<Config> config, const std::vector<std::s
 
     // envp_->set_cachesize(FLAGS_bdb_env_cache_size_gb, 0, 1);
     if (FLAGS_bdb_env_cache_size_gb > 0 || FLAGS_bdb_env_cache_size_bytes > 0) {
-      envp_->set_cachesize(FLAGS_bdb_env_cache_size_gb, FLAGS_bdb_env_cache_size_bytes, 1);
+      envp_->set_cachesize(FLAGS_bdb_env_cache_size_gb, FLAGS_bdb_env_cache_size_bytes,
+                           std::max(FLAGS_bdb_env_cache_count, 1));
     }
 
     // set error call back
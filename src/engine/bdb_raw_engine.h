@@ -168,6 +168,13 @@ class Reader : public RawEngine::Reader {
   butil::Status KvGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
                       std::string& value) override;
 
+  butil::Status KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                           std::vector<std::string>& values, std::vector<bool>& key_states) override;
+  // bdb has no native multi get, keys are looked up in sorted order by one cursor.
+  butil::Status KvMultiGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                           const std::vector<std::string>& keys, std::vector<std::string>& values,
+                           std::vector<bool>& key_states) override;
+
   butil::Status KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                        std::vector<pb::common::KeyValue>& kvs) override;
   butil::Status KvScan(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
@@ -195,6 +202,10 @@ class Reader : public RawEngine::Reader {
   void PutDb(Db* db);
   dingodb::SnapshotPtr GetSnapshot();
   butil::Status RetrieveByCursor(const std::string& cf_name, DbTxn* txn, const std::string& key, std::string& value);
+  // read many records per cursor get with DB_MULTIPLE_KEY buffer.
+  butil::Status ScanByBulkCursor(const std::string& cf_name, std::shared_ptr<bdb::BdbSnapshot> snapshot,
+                                 const std::string& start_key, const std::string& end_key,
+                                 std::vector<pb::common::KeyValue>& kvs);
 
   std::weak_ptr<BdbRawEngine> raw_engine_;
 };
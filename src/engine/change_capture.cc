@@ -0,0 +1,253 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "engine/change_capture.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "brpc/reloadable_flags.h"
+#include "bthread/mutex.h"
+#include "bvar/passive_status.h"
+#include "bvar/reducer.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "engine/txn_engine_helper.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "mvcc/codec.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+DEFINE_int64(change_capture_region_max_memory_size, 64 * 1024 * 1024,
+             "max memory of captured changes of one region, oldest is dropped when exceed");
+BRPC_VALIDATE_GFLAG(change_capture_region_max_memory_size, brpc::PositiveInteger);
+
+bvar::Adder<int64_t> g_change_capture_event_count("dingo_change_capture_event_count");
+bvar::Adder<int64_t> g_change_capture_truncate_count("dingo_change_capture_truncate_count");
+
+static int64_t GetChangeCaptureMemorySize(void*) { return ChangeCapture::GetInstance().MemorySize(); }
+bvar::PassiveStatus<int64_t> g_change_capture_memory_size("dingo_change_capture_memory_size",
+                                                          GetChangeCaptureMemorySize, nullptr);
+
+static int64_t EventMemorySize(const ChangeEvent& event) {
+  return sizeof(ChangeEvent) + event.key.size() + event.value.size() + event.old_value.size();
+}
+
+ChangeCapture::ChangeCapture() { bthread_mutex_init(&mutex_, nullptr); }
+
+ChangeCapture::~ChangeCapture() { bthread_mutex_destroy(&mutex_); }
+
+ChangeCapture& ChangeCapture::GetInstance() {
+  static ChangeCapture change_capture;
+  return change_capture;
+}
+
+void ChangeCapture::Subscribe(int64_t region_id, int64_t log_id, bool with_old_value) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = region_logs_.find(region_id);
+  if (it != region_logs_.end()) {
+    it->second->with_old_value = it->second->with_old_value || with_old_value;
+    return;
+  }
+
+  auto region_log = std::make_shared<RegionLog>();
+  region_log->with_old_value = with_old_value;
+  region_log->truncated_log_id = log_id;
+  region_logs_.insert(std::make_pair(region_id, region_log));
+  region_count_.store(region_logs_.size(), std::memory_order_release);
+
+  DINGO_LOG(INFO) << fmt::format("[change_capture][region({})] subscribe, log_id: {} with_old_value: {}", region_id,
+                                 log_id, with_old_value);
+}
+
+void ChangeCapture::Unsubscribe(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = region_logs_.find(region_id);
+  if (it == region_logs_.end()) {
+    return;
+  }
+
+  memory_size_ -= it->second->memory_size;
+  region_logs_.erase(it);
+  region_count_.store(region_logs_.size(), std::memory_order_release);
+
+  DINGO_LOG(INFO) << fmt::format("[change_capture][region({})] unsubscribe.", region_id);
+}
+
+bool ChangeCapture::IsSubscribed(int64_t region_id) {
+  if (region_count_.load(std::memory_order_acquire) == 0) {
+    return false;
+  }
+  BAIDU_SCOPED_LOCK(mutex_);
+  return region_logs_.find(region_id) != region_logs_.end();
+}
+
+void ChangeCapture::Truncate(RegionLogPtr region_log, int64_t log_id) {
+  auto& events = region_log->events;
+  while (!events.empty() && events.front().log_id <= log_id) {
+    int64_t memory_size = EventMemorySize(events.front());
+    region_log->memory_size -= memory_size;
+    memory_size_ -= memory_size;
+    events.pop_front();
+  }
+  region_log->truncated_log_id = std::max(region_log->truncated_log_id, log_id);
+  g_change_capture_truncate_count << 1;
+}
+
+void ChangeCapture::CaptureCommit(store::RegionPtr region, RawEnginePtr engine, int64_t log_id,
+                                  const std::vector<pb::common::KeyValue>& write_kvs) {
+  if (region_count_.load(std::memory_order_acquire) == 0) {
+    return;
+  }
+
+  bool with_old_value = false;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = region_logs_.find(region->Id());
+    if (it == region_logs_.end()) {
+      return;
+    }
+    with_old_value = it->second->with_old_value;
+  }
+
+  // read value out of lock, data cf is written at prewrite, and not gc before commit.
+  auto reader = engine->Reader();
+  TxnReader txn_reader(engine);
+  if (with_old_value && !txn_reader.Init().ok()) {
+    with_old_value = false;
+  }
+
+  std::vector<ChangeEvent> events;
+  for (const auto& kv : write_kvs) {
+    ChangeEvent event;
+    event.log_id = log_id;
+    if (!mvcc::Codec::DecodeKey(kv.key(), event.key, event.commit_ts)) {
+      continue;
+    }
+
+    pb::store::WriteInfo write_info;
+    if (!write_info.ParseFromString(kv.value())) {
+      DINGO_LOG(ERROR) << fmt::format("[change_capture][region({})] parse write info failed, key: {}", region->Id(),
+                                      Helper::StringToHex(kv.key()));
+      continue;
+    }
+    // rollback and lock record not change data.
+    if (write_info.op() != pb::store::Op::Put && write_info.op() != pb::store::Op::Delete) {
+      continue;
+    }
+    event.op = write_info.op();
+    event.start_ts = write_info.start_ts();
+
+    if (event.op == pb::store::Op::Put) {
+      if (!write_info.short_value().empty()) {
+        event.value = write_info.short_value();
+      } else {
+        auto status =
+            reader->KvGet(Constant::kTxnDataCF, mvcc::Codec::EncodeKey(event.key, event.start_ts), event.value);
+        if (!status.ok()) {
+          DINGO_LOG(WARNING) << fmt::format("[change_capture][region({})] read data failed, key: {} error: {}",
+                                            region->Id(), Helper::StringToHex(event.key), status.error_str());
+        }
+      }
+    }
+
+    if (with_old_value) {
+      pb::store::WriteInfo prev_write_info;
+      std::vector<pb::common::KeyValue> old_kvs;
+      auto status = txn_reader.GetOldValue(event.key, event.start_ts, false, prev_write_info, old_kvs);
+      if (status.ok() && !old_kvs.empty()) {
+        event.old_value = old_kvs[0].value();
+      }
+    }
+
+    events.push_back(std::move(event));
+  }
+
+  if (events.empty()) {
+    return;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = region_logs_.find(region->Id());
+  if (it == region_logs_.end()) {
+    return;
+  }
+  auto region_log = it->second;
+  for (auto& event : events) {
+    int64_t memory_size = EventMemorySize(event);
+    region_log->memory_size += memory_size;
+    memory_size_ += memory_size;
+    region_log->events.push_back(std::move(event));
+  }
+  g_change_capture_event_count << events.size();
+
+  // drop whole log of oldest events, consumer behind it need rescan.
+  while (region_log->memory_size > FLAGS_change_capture_region_max_memory_size && !region_log->events.empty()) {
+    Truncate(region_log, region_log->events.front().log_id);
+  }
+}
+
+void ChangeCapture::CaptureDeleteRange(int64_t region_id, int64_t log_id) {
+  if (region_count_.load(std::memory_order_acquire) == 0) {
+    return;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = region_logs_.find(region_id);
+  if (it != region_logs_.end()) {
+    Truncate(it->second, log_id);
+  }
+}
+
+butil::Status ChangeCapture::Fetch(int64_t region_id, int64_t log_id, int64_t max_count,
+                                   std::vector<ChangeEvent>& events) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = region_logs_.find(region_id);
+  if (it == region_logs_.end()) {
+    return butil::Status(pb::error::EREGION_NOT_FOUND, fmt::format("region({}) is not subscribed.", region_id));
+  }
+
+  auto region_log = it->second;
+  if (log_id < region_log->truncated_log_id) {
+    return butil::Status(pb::error::ESTREAM_EXPIRED,
+                         fmt::format("region({}) changes before log({}) are dropped, need rescan.", region_id,
+                                     region_log->truncated_log_id));
+  }
+
+  // not stop in middle of one log, so consumer can continue from log id of last event.
+  for (const auto& event : region_log->events) {
+    if (event.log_id <= log_id) {
+      continue;
+    }
+    if (!events.empty() && static_cast<int64_t>(events.size()) >= max_count && event.log_id != events.back().log_id) {
+      break;
+    }
+    events.push_back(event);
+  }
+
+  return butil::Status::OK();
+}
+
+int64_t ChangeCapture::MemorySize() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return memory_size_;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,100 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_ENGINE_CHANGE_CAPTURE_H_
+#define DINGODB_ENGINE_CHANGE_CAPTURE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bthread/types.h"
+#include "butil/status.h"
+#include "engine/raw_engine.h"
+#include "meta/store_meta_manager.h"
+#include "proto/common.pb.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+// Committed row change of txn region.
+struct ChangeEvent {
+  int64_t log_id{0};
+  int64_t commit_ts{0};
+  int64_t start_ts{0};
+  pb::store::Op op{pb::store::Op::None};
+  std::string key;
+  std::string value;
+  std::string old_value;
+};
+
+// Per region change log captured from raft apply of txn commit, so consumer fetch changes after the
+// last log id it has seen, instead of polling scan with increasing ts range.
+// Region is captured only after it is subscribed. Log is bounded by memory, events of slow consumer
+// are dropped and it get ESTREAM_EXPIRED, then it must rescan and fetch from current log id again.
+class ChangeCapture {
+ public:
+  ChangeCapture();
+  ~ChangeCapture();
+
+  ChangeCapture(const ChangeCapture&) = delete;
+  const ChangeCapture& operator=(const ChangeCapture&) = delete;
+
+  static ChangeCapture& GetInstance();
+
+  // start capture region, changes applied after log_id is fetchable.
+  void Subscribe(int64_t region_id, int64_t log_id, bool with_old_value);
+  void Unsubscribe(int64_t region_id);
+  bool IsSubscribed(int64_t region_id);
+
+  // called at apply, write_kvs is put of write cf.
+  void CaptureCommit(store::RegionPtr region, RawEnginePtr engine, int64_t log_id,
+                     const std::vector<pb::common::KeyValue>& write_kvs);
+  // data is deleted by range, e.g. drop table or merge, consumer must rescan.
+  void CaptureDeleteRange(int64_t region_id, int64_t log_id);
+
+  // fetch at most max_count events after log_id, in apply order.
+  butil::Status Fetch(int64_t region_id, int64_t log_id, int64_t max_count, std::vector<ChangeEvent>& events);
+
+  int64_t MemorySize();
+
+ private:
+  struct RegionLog {
+    bool with_old_value{false};
+    // events at or before it are dropped.
+    int64_t truncated_log_id{0};
+    std::deque<ChangeEvent> events;
+    int64_t memory_size{0};
+  };
+  using RegionLogPtr = std::shared_ptr<RegionLog>;
+
+  // caller hold mutex_
+  void Truncate(RegionLogPtr region_log, int64_t log_id);
+
+  // no lock at apply when no region is subscribed.
+  std::atomic<int64_t> region_count_{0};
+
+  bthread_mutex_t mutex_;
+  std::map<int64_t, RegionLogPtr> region_logs_;
+  int64_t memory_size_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_CHANGE_CAPTURE_H_
@@ -14,6 +14,12 @@
 
 #include "engine/concurrency_manager.h"
 
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
 #include "engine/txn_engine_helper.h"
 #include "proto/store.pb.h"
 
@@ -21,39 +27,30 @@ namespace dingodb {
 
 // lock_entry.rw_lock has already write locked
 void ConcurrencyManager::LockKey(const std::string& key, LockEntryPtr lock_entry) {
-  RWLockWriteGuard guard(&rw_lock_);
+  auto& shard = shards_[ShardIndex(key)];
+  RWLockWriteGuard guard(&shard.rw_lock);
 
-  lock_table_[key] = lock_entry;
+  shard.lock_table[key] = lock_entry;
 }
 
 void ConcurrencyManager::UnlockKeys(const std::vector<std::string>& keys) {
-  RWLockWriteGuard guard(&rw_lock_);
-
   for (auto const& key : keys) {
-    auto it = lock_table_.find(key);
-    if (it != lock_table_.end()) {
+    auto& shard = shards_[ShardIndex(key)];
+    RWLockWriteGuard guard(&shard.rw_lock);
+
+    auto it = shard.lock_table.find(key);
+    if (it != shard.lock_table.end()) {
       it->second->is_deleted.store(true, std::memory_order_release);
-      lock_table_.erase(it);
+      shard.lock_table.erase(it);
     }
   }
 }
 
-bool ConcurrencyManager::CheckKeys(const std::vector<std::string>& keys, pb::store::IsolationLevel isolation_level,
-                                   int64_t start_ts, const std::set<int64_t>& resolved_locks,
-                                   pb::store::TxnResultInfo& txn_result_info) {
-  std::vector<LockEntryPtr> lock_entrys;
-  {
-    RWLockReadGuard guard(&rw_lock_);
-
-    for (auto const& key : keys) {
-      auto it = lock_table_.find(key);
-      if (it != lock_table_.end()) {
-        lock_entrys.push_back(it->second);
-      }
-    }
-  }
-
-  for (auto& lock_entry : lock_entrys) {
+bool ConcurrencyManager::CheckLockEntrys(const std::vector<LockEntryPtr>& lock_entrys,
+                                         pb::store::IsolationLevel isolation_level, int64_t start_ts,
+                                         const std::set<int64_t>& resolved_locks,
+                                         pb::store::TxnResultInfo& txn_result_info) {
+  for (const auto& lock_entry : lock_entrys) {
     if (lock_entry->is_deleted.load(std::memory_order_acquire)) {
       continue;
     }
@@ -68,41 +65,123 @@ bool ConcurrencyManager::CheckKeys(const std::vector<std::string>& keys, pb::sto
   return false;
 }
 
+bool ConcurrencyManager::CheckKeys(const std::vector<std::string>& keys, pb::store::IsolationLevel isolation_level,
+                                   int64_t start_ts, const std::set<int64_t>& resolved_locks,
+                                   pb::store::TxnResultInfo& txn_result_info) {
+  std::vector<LockEntryPtr> lock_entrys;
+  for (auto const& key : keys) {
+    auto& shard = shards_[ShardIndex(key)];
+    RWLockReadGuard guard(&shard.rw_lock);
+
+    auto it = shard.lock_table.find(key);
+    if (it != shard.lock_table.end()) {
+      lock_entrys.push_back(it->second);
+    }
+  }
+
+  return CheckLockEntrys(lock_entrys, isolation_level, start_ts, resolved_locks, txn_result_info);
+}
+
 bool ConcurrencyManager::CheckRange(const std::string& start_key, const std::string& end_key,
                                     pb::store::IsolationLevel isolation_level, int64_t start_ts,
                                     const std::set<int64_t>& resolved_locks,
                                     pb::store::TxnResultInfo& txn_result_info) {
   std::vector<LockEntryPtr> lock_entrys;
-  {
-    RWLockReadGuard guard(&rw_lock_);
+  for (auto& shard : shards_) {
+    RWLockReadGuard guard(&shard.rw_lock);
 
-    auto it = lock_table_.lower_bound(start_key);
-    while (it != lock_table_.end() && it->first < end_key) {
+    auto it = shard.lock_table.lower_bound(start_key);
+    while (it != shard.lock_table.end() && it->first < end_key) {
       lock_entrys.push_back(it->second);
       ++it;
     }
   }
 
-  for (auto& lock_entry : lock_entrys) {
-    if (lock_entry->is_deleted.load(std::memory_order_acquire)) {
-      continue;
+  return CheckLockEntrys(lock_entrys, isolation_level, start_ts, resolved_locks, txn_result_info);
+}
+
+void ConcurrencyManager::GetKeys(std::map<std::string, pb::store::LockInfo>& lock_table) {
+  for (auto& shard : shards_) {
+    RWLockReadGuard guard(&shard.rw_lock);
+
+    for (auto const& kv : shard.lock_table) {
+      RWLockReadGuard guard(&kv.second->rw_lock);
+      lock_table[kv.first] = kv.second->lock_info;
     }
-    RWLockReadGuard guard(&lock_entry->rw_lock);
-    if (TxnEngineHelper::CheckLockConflict(lock_entry->lock_info, isolation_level, start_ts, resolved_locks,
-                                           txn_result_info)) {
-      return true;
+  }
+}
+
+bool ConcurrencyManager::LockPessimisticKey(const std::string& key, const pb::store::LockInfo& lock_info,
+                                            int64_t max_count) {
+  auto& shard = pessimistic_shards_[ShardIndex(key)];
+  RWLockWriteGuard guard(&shard.rw_lock);
+
+  auto it = shard.lock_table.find(key);
+  if (it == shard.lock_table.end()) {
+    if (pessimistic_lock_count_.load(std::memory_order_relaxed) >= max_count) {
+      return false;
     }
+    pessimistic_lock_count_.fetch_add(1, std::memory_order_relaxed);
+  } else if (it->second->lock_info.lock_ts() != lock_info.lock_ts()) {
+    return false;
+  } else {
+    it->second->is_deleted.store(true, std::memory_order_release);
   }
 
-  return false;
+  // entry is not changed after insert, update replace it with a new one.
+  auto lock_entry = std::make_shared<LockEntry>();
+  lock_entry->lock_info = lock_info;
+  shard.lock_table[key] = lock_entry;
+
+  return true;
 }
 
-void ConcurrencyManager::GetKeys(std::map<std::string, pb::store::LockInfo>& lock_table) {
-  RWLockReadGuard guard(&rw_lock_);
+bool ConcurrencyManager::GetPessimisticLock(const std::string& key, pb::store::LockInfo& lock_info) {
+  auto& shard = pessimistic_shards_[ShardIndex(key)];
+  RWLockReadGuard guard(&shard.rw_lock);
+
+  auto it = shard.lock_table.find(key);
+  if (it == shard.lock_table.end()) {
+    return false;
+  }
+
+  lock_info = it->second->lock_info;
+  return true;
+}
 
-  for (auto const& kv : lock_table_) {
-    RWLockReadGuard guard(&kv.second->rw_lock);
-    lock_table[kv.first] = kv.second->lock_info;
+void ConcurrencyManager::UnlockPessimisticKeys(const std::vector<std::string>& keys) {
+  for (auto const& key : keys) {
+    auto& shard = pessimistic_shards_[ShardIndex(key)];
+    RWLockWriteGuard guard(&shard.rw_lock);
+
+    auto it = shard.lock_table.find(key);
+    if (it != shard.lock_table.end()) {
+      it->second->is_deleted.store(true, std::memory_order_release);
+      shard.lock_table.erase(it);
+      pessimistic_lock_count_.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+void ConcurrencyManager::GetPessimisticLocks(std::vector<pb::store::LockInfo>& lock_infos) {
+  for (auto& shard : pessimistic_shards_) {
+    RWLockReadGuard guard(&shard.rw_lock);
+
+    for (auto const& kv : shard.lock_table) {
+      lock_infos.push_back(kv.second->lock_info);
+    }
+  }
+}
+
+void ConcurrencyManager::ClearPessimisticLocks() {
+  for (auto& shard : pessimistic_shards_) {
+    RWLockWriteGuard guard(&shard.rw_lock);
+
+    for (auto const& kv : shard.lock_table) {
+      kv.second->is_deleted.store(true, std::memory_order_release);
+    }
+    pessimistic_lock_count_.fetch_sub(shard.lock_table.size(), std::memory_order_relaxed);
+    shard.lock_table.clear();
   }
 }
 
@@ -15,8 +15,12 @@
 #ifndef DINGODB_COMMON_CONCURRENCY_MANAGER_H_
 #define DINGODB_COMMON_CONCURRENCY_MANAGER_H_
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -58,12 +62,42 @@ class ConcurrencyManager {
   bool CheckRange(const std::string& start_key, const std::string& end_key, pb::store::IsolationLevel isolation_level,
                   int64_t start_ts, const std::set<int64_t>& resolved_locks, pb::store::TxnResultInfo& txn_result_info);
   
-  void GetKeys(std::map<std::string, pb::store::LockInfo>& lock_table);                
+  void GetKeys(std::map<std::string, pb::store::LockInfo>& lock_table);
+
+  // In memory pessimistic lock of leader, it is not replicated, and is dropped when lock cf of the key is
+  // written or deleted by raft, e.g. prewrite convert it, rollback or persist it.
+  // return false if key already has a memory pessimistic lock of other txn, or lock count reach max_count.
+  bool LockPessimisticKey(const std::string& key, const pb::store::LockInfo& lock_info, int64_t max_count);
+  bool GetPessimisticLock(const std::string& key, pb::store::LockInfo& lock_info);
+  void UnlockPessimisticKeys(const std::vector<std::string>& keys);
+  void GetPessimisticLocks(std::vector<pb::store::LockInfo>& lock_infos);
+  void ClearPessimisticLocks();
+  int64_t PessimisticLockCount() const { return pessimistic_lock_count_.load(std::memory_order_relaxed); }
 
  private:
-  // key->lock_info  Ordered storage of locked keys (supporting range queries)
-  std::map<std::string, LockEntryPtr> lock_table_;
-  RWLock rw_lock_;
+  // Lock table is partitioned by key hash, so prewrite and point check only contend on one shard,
+  // range check walk every shard under the shard read lock, no global lock.
+  static constexpr uint32_t kShardNum = 16;
+
+  struct Shard {
+    // key->lock_info  Ordered storage of locked keys (supporting range queries)
+    std::map<std::string, LockEntryPtr> lock_table;
+    RWLock rw_lock;
+  };
+
+  static uint32_t ShardIndex(const std::string& key) {
+    return static_cast<uint32_t>(std::hash<std::string>{}(key) % kShardNum);
+  }
+
+  static bool CheckLockEntrys(const std::vector<LockEntryPtr>& lock_entrys, pb::store::IsolationLevel isolation_level,
+                              int64_t start_ts, const std::set<int64_t>& resolved_locks,
+                              pb::store::TxnResultInfo& txn_result_info);
+
+  std::array<Shard, kShardNum> shards_;
+
+  // pessimistic lock is not checked by read, so it is kept apart from prewrite memory lock.
+  std::array<Shard, kShardNum> pessimistic_shards_;
+  std::atomic<int64_t> pessimistic_lock_count_{0};
 };
 
 }  // namespace dingodb
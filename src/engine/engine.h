@@ -121,6 +121,15 @@ class Engine : public std::enable_shared_from_this<Engine> {
     VectorReader() = default;
     virtual ~VectorReader() = default;
 
+    // aggregate results of all query vectors of one multi-vector document to one list by vector id.
+    enum class MultiVectorAggregation {
+      kNone = 0,
+      // best distance among query vectors
+      kMax = 1,
+      // sum of distance of every query vector, missing one count as its farthest result
+      kSum = 2,
+    };
+
     struct Context {
       int64_t partition_id{};
       int64_t region_id{};
@@ -148,6 +157,8 @@ class Engine : public std::enable_shared_from_this<Engine> {
       bool is_reverse{};
       bool use_scalar_filter{};
 
+      MultiVectorAggregation multi_vector_aggregation{MultiVectorAggregation::kNone};
+
       VectorIndexWrapperPtr vector_index;
       pb::common::ScalarSchema scalar_schema;
 #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
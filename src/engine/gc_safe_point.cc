@@ -14,6 +14,7 @@
 
 #include "engine/gc_safe_point.h"
 
+#include <algorithm>
 #include <cstdint>
 
 #include "bthread/mutex.h"
@@ -134,6 +135,24 @@ std::pair<bool, int64_t> GCSafePointManager::GetGcFlagAndSafePointTs(int64_t ten
   return iter->second->GetGcFlagAndSafePointTs();
 }
 
+int64_t GCSafePointManager::GetMinSafePointTs() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (!all_safe_points_.empty() || active_safe_points_.empty()) {
+    return 0;
+  }
+
+  int64_t min_safe_point_ts = INT64_MAX;
+  for (auto& [_, safe_point] : active_safe_points_) {
+    auto [gc_stop, safe_point_ts] = safe_point->GetGcFlagAndSafePointTs();
+    if (gc_stop || safe_point_ts <= 0) {
+      return 0;
+    }
+    min_safe_point_ts = std::min(min_safe_point_ts, safe_point_ts);
+  }
+
+  return min_safe_point_ts;
+}
+
 std::shared_ptr<GCSafePoint> GCSafePointManager::FindSafePoint(int64_t tenant_id) {
   BAIDU_SCOPED_LOCK(mutex_);
   auto iter = active_safe_points_.find(tenant_id);
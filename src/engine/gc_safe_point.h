@@ -72,6 +72,9 @@ class GCSafePointManager final {
 
   std::pair<bool, int64_t> GetGcFlagAndSafePointTs(int64_t tenant_id);
 
+  // Min safe point ts of all tenants, return 0 if exist stopped tenant or no tenant.
+  int64_t GetMinSafePointTs();
+
   std::shared_ptr<GCSafePoint> FindSafePoint(int64_t tenant_id);
   void RemoveSafePoint(int64_t tenant_id);
 
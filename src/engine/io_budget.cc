@@ -0,0 +1,157 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/io_budget.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "brpc/reloadable_flags.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
+#include "bvar/status.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "rocksdb/env.h"
+
+namespace dingodb {
+
+DEFINE_int64(io_budget_bytes_per_second, 0, "store background write io budget bytes per second, 0 is unlimited");
+BRPC_VALIDATE_GFLAG(io_budget_bytes_per_second, brpc::NonNegativeInteger);
+DEFINE_int64(io_budget_min_bytes_per_second, 32 * 1024 * 1024,
+             "io budget is not lowered below this when disk utilization is high");
+BRPC_VALIDATE_GFLAG(io_budget_min_bytes_per_second, brpc::PositiveInteger);
+DEFINE_string(io_budget_disk_device, "", "disk device name in /proc/diskstats for io budget, empty is no feedback");
+DEFINE_int32(io_budget_disk_util_high_percent, 80, "lower io budget when disk utilization exceed this");
+BRPC_VALIDATE_GFLAG(io_budget_disk_util_high_percent, brpc::PositiveInteger);
+DEFINE_int32(io_budget_disk_util_low_percent, 50, "raise io budget when disk utilization below this");
+BRPC_VALIDATE_GFLAG(io_budget_disk_util_low_percent, brpc::NonNegativeInteger);
+
+// rate of rate limiter when budget is unlimited, rocksdb rate limiter can not be disabled after set.
+static const int64_t kUnlimitedBytesPerSecond = 1LL << 40;
+
+bvar::Status<int64_t> g_io_budget_bytes_per_second("dingo_io_budget_bytes_per_second", 0);
+bvar::Status<int64_t> g_io_budget_disk_util("dingo_io_budget_disk_util", 0);
+bvar::Adder<int64_t> g_io_budget_acquire_bytes("dingo_io_budget_acquire_bytes");
+bvar::LatencyRecorder g_io_budget_acquire_latency("dingo_io_budget_acquire");
+
+IoBudget::IoBudget() : bytes_per_second_(FLAGS_io_budget_bytes_per_second) {
+  bthread_mutex_init(&mutex_, nullptr);
+  rate_limiter_.reset(
+      rocksdb::NewGenericRateLimiter(bytes_per_second_ > 0 ? bytes_per_second_ : kUnlimitedBytesPerSecond));
+  g_io_budget_bytes_per_second.set_value(bytes_per_second_);
+}
+
+IoBudget::~IoBudget() { bthread_mutex_destroy(&mutex_); }
+
+IoBudget& IoBudget::GetInstance() {
+  static IoBudget io_budget;
+  return io_budget;
+}
+
+int64_t IoBudget::BytesPerSecond() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return bytes_per_second_;
+}
+
+void IoBudget::Acquire(int64_t bytes) {
+  if (bytes <= 0 || BytesPerSecond() <= 0) {
+    return;
+  }
+
+  int64_t start_time_us = Helper::TimestampUs();
+
+  // one request can not exceed burst bytes of rate limiter.
+  int64_t burst_bytes = std::max(rate_limiter_->GetSingleBurstBytes(), static_cast<int64_t>(1));
+  for (int64_t remain_bytes = bytes; remain_bytes > 0;) {
+    int64_t request_bytes = std::min(remain_bytes, burst_bytes);
+    rate_limiter_->Request(request_bytes, rocksdb::Env::IO_LOW, nullptr, rocksdb::RateLimiter::OpType::kWrite);
+    remain_bytes -= request_bytes;
+  }
+
+  g_io_budget_acquire_bytes << bytes;
+  g_io_budget_acquire_latency << (Helper::TimestampUs() - start_time_us);
+}
+
+void IoBudget::Adjust() {
+  int64_t max_bytes_per_second = FLAGS_io_budget_bytes_per_second;
+  int64_t now_ms = Helper::TimestampMs();
+  int64_t io_time_ms = FLAGS_io_budget_disk_device.empty() ? -1 : GetDiskIoTimeMs(FLAGS_io_budget_disk_device);
+
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  int64_t bytes_per_second = 0;
+  if (max_bytes_per_second > 0) {
+    bytes_per_second = bytes_per_second_ > 0 ? std::min(bytes_per_second_, max_bytes_per_second) : max_bytes_per_second;
+
+    if (io_time_ms >= 0 && last_io_time_ms_ >= 0 && now_ms > last_adjust_time_ms_) {
+      // io time is the time disk is busy, so its increment rate is disk utilization.
+      int64_t disk_util = (io_time_ms - last_io_time_ms_) * 100 / (now_ms - last_adjust_time_ms_);
+      g_io_budget_disk_util.set_value(disk_util);
+
+      if (disk_util >= FLAGS_io_budget_disk_util_high_percent) {
+        int64_t min_bytes_per_second = std::min(FLAGS_io_budget_min_bytes_per_second, max_bytes_per_second);
+        bytes_per_second = std::max(bytes_per_second * 7 / 10, min_bytes_per_second);
+      } else if (disk_util < FLAGS_io_budget_disk_util_low_percent) {
+        bytes_per_second = std::min(bytes_per_second * 12 / 10 + 1, max_bytes_per_second);
+      }
+    }
+  }
+  last_io_time_ms_ = io_time_ms;
+  last_adjust_time_ms_ = now_ms;
+
+  if (bytes_per_second != bytes_per_second_) {
+    DINGO_LOG(INFO) << fmt::format("[io_budget] change bytes per second {} -> {}, disk util {}%", bytes_per_second_,
+                                   bytes_per_second, g_io_budget_disk_util.get_value());
+    bytes_per_second_ = bytes_per_second;
+    rate_limiter_->SetBytesPerSecond(bytes_per_second > 0 ? bytes_per_second : kUnlimitedBytesPerSecond);
+    g_io_budget_bytes_per_second.set_value(bytes_per_second);
+  }
+}
+
+int64_t IoBudget::GetDiskIoTimeMs(const std::string& device) {
+  std::ifstream file("/proc/diskstats");
+  if (!file.is_open()) {
+    return -1;
+  }
+
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream iss(line);
+    std::string major, minor, name;
+    iss >> major >> minor >> name;
+    if (name != device) {
+      continue;
+    }
+
+    // fields after device name, io time is the 10th.
+    int64_t value = 0;
+    for (int i = 0; i < 10; ++i) {
+      if (!(iss >> value)) {
+        return -1;
+      }
+    }
+    return value;
+  }
+
+  return -1;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,65 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_IO_BUDGET_H_
+#define DINGODB_ENGINE_IO_BUDGET_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "bthread/types.h"
+#include "rocksdb/rate_limiter.h"
+
+namespace dingodb {
+
+// Store wide background write IO budget, one token bucket shared by rocksdb flush/compaction, region
+// snapshot sst and vector index snapshot, so they can not saturate disk together when failover.
+// Rate is set by flag online, and lower when disk utilization is high.
+class IoBudget {
+ public:
+  IoBudget();
+  ~IoBudget();
+
+  IoBudget(const IoBudget&) = delete;
+  const IoBudget& operator=(const IoBudget&) = delete;
+
+  static IoBudget& GetInstance();
+
+  // set to rocksdb DBOptions::rate_limiter.
+  std::shared_ptr<rocksdb::RateLimiter> GetRateLimiter() { return rate_limiter_; }
+
+  // block until bytes is granted, return at once when budget is disabled.
+  void Acquire(int64_t bytes);
+
+  // adjust rate by flag and disk utilization, called periodically.
+  void Adjust();
+
+  int64_t BytesPerSecond();
+
+ private:
+  // io time(ms) of disk device from /proc/diskstats, return -1 when not found.
+  static int64_t GetDiskIoTimeMs(const std::string& device);
+
+  std::shared_ptr<rocksdb::RateLimiter> rate_limiter_;
+
+  bthread_mutex_t mutex_;
+  int64_t bytes_per_second_{0};
+  int64_t last_io_time_ms_{-1};
+  int64_t last_adjust_time_ms_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_IO_BUDGET_H_
@@ -34,10 +34,28 @@ enum class IteratorType {
   kMVCC = 7,
 };
 
+// Class of bulk scan, blocks of bulk scan are seldom read again soon, so by default they not fill block cache
+// and evict hot blocks of point read, and are read ahead.
+enum class ScanClass {
+  kNone = 0,
+  kScan = 1,
+  kCoprocessor = 2,
+  kBackup = 3,
+  kSplitCheck = 4,
+  kGc = 5,
+};
+
 struct IteratorOptions {
   std::string lower_bound;
   std::string upper_bound;
 
+  // for bulk sequential scan, e.g. build index, 0 is adaptive readahead.
+  size_t readahead_size{0};
+  // bulk scan not fill block cache, avoid evict hot blocks.
+  bool fill_cache{true};
+  // bulk scan class, not kNone override fill_cache and default readahead_size.
+  ScanClass scan_class{ScanClass::kNone};
+
   // for rocksdb::Slice
   void* extension{nullptr};
 
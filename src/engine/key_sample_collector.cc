@@ -0,0 +1,119 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "engine/key_sample_collector.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "brpc/reloadable_flags.h"
+#include "butil/sys_byteorder.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_int64(rocks_key_sample_interval_size, 1 * 1024 * 1024,
+             "record one key of sst every this bytes in table properties for estimate split key, 0 is disable");
+BRPC_VALIDATE_GFLAG(rocks_key_sample_interval_size, brpc::NonNegativeInteger);
+
+rocksdb::Status KeySampleCollector::AddUserKey(const rocksdb::Slice& key, const rocksdb::Slice& value,
+                                               rocksdb::EntryType /*type*/, rocksdb::SequenceNumber /*seq*/,
+                                               uint64_t /*file_size*/) {
+  if (interval_size_ <= 0) {
+    return rocksdb::Status::OK();
+  }
+
+  size_ += key.size() + value.size();
+  if (size_ >= interval_size_) {
+    samples_.emplace_back(key.ToString(), size_);
+    size_ = 0;
+    last_key_.clear();
+  } else {
+    last_key_.assign(key.data(), key.size());
+  }
+
+  return rocksdb::Status::OK();
+}
+
+rocksdb::Status KeySampleCollector::Finish(rocksdb::UserCollectedProperties* properties) {
+  // sst without samples property is not used for estimate.
+  if (interval_size_ <= 0) {
+    return rocksdb::Status::OK();
+  }
+
+  // tail data after last sample
+  if (size_ > 0 && !last_key_.empty()) {
+    samples_.emplace_back(last_key_, size_);
+  }
+
+  properties->emplace(kPropertyName, EncodeSamples(samples_));
+  return rocksdb::Status::OK();
+}
+
+// format: | key size(4 bytes) | key | size(8 bytes) | ..., integer in network order.
+std::string KeySampleCollector::EncodeSamples(const std::vector<Sample>& samples) {
+  size_t total_size = 0;
+  for (const auto& sample : samples) {
+    total_size += sizeof(uint32_t) + sample.first.size() + sizeof(uint64_t);
+  }
+
+  std::string data;
+  data.reserve(total_size);
+  for (const auto& [key, size] : samples) {
+    uint32_t key_size = butil::HostToNet32(static_cast<uint32_t>(key.size()));
+    data.append(reinterpret_cast<const char*>(&key_size), sizeof(key_size));
+    data.append(key);
+    uint64_t net_size = butil::HostToNet64(static_cast<uint64_t>(size));
+    data.append(reinterpret_cast<const char*>(&net_size), sizeof(net_size));
+  }
+
+  return data;
+}
+
+bool KeySampleCollector::DecodeSamples(const std::string& data, std::vector<Sample>& samples) {
+  size_t pos = 0;
+  while (pos < data.size()) {
+    uint32_t key_size = 0;
+    if (pos + sizeof(key_size) > data.size()) {
+      return false;
+    }
+    memcpy(&key_size, data.data() + pos, sizeof(key_size));
+    key_size = butil::NetToHost32(key_size);
+    pos += sizeof(key_size);
+
+    uint64_t size = 0;
+    if (pos + key_size + sizeof(size) > data.size()) {
+      return false;
+    }
+    std::string key = data.substr(pos, key_size);
+    pos += key_size;
+    memcpy(&size, data.data() + pos, sizeof(size));
+    pos += sizeof(size);
+
+    samples.emplace_back(std::move(key), static_cast<int64_t>(butil::NetToHost64(size)));
+  }
+
+  return true;
+}
+
+rocksdb::TablePropertiesCollector* KeySampleCollectorFactory::CreateTablePropertiesCollector(
+    rocksdb::TablePropertiesCollectorFactory::Context /*context*/) {
+  return new KeySampleCollector(FLAGS_rocks_key_sample_interval_size);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,73 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_ENGINE_KEY_SAMPLE_COLLECTOR_H_
+#define DINGODB_ENGINE_KEY_SAMPLE_COLLECTOR_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "rocksdb/table_properties.h"
+
+namespace dingodb {
+
+// Record one key about every interval_size bytes of sst in user collected table properties,
+// so size distribution of a range can be got from table properties without scan data, e.g. find split key.
+// Sample is pair of key and size of data from previous sample to this key.
+class KeySampleCollector : public rocksdb::TablePropertiesCollector {
+ public:
+  using Sample = std::pair<std::string, int64_t>;
+
+  explicit KeySampleCollector(int64_t interval_size) : interval_size_(interval_size) {}
+  ~KeySampleCollector() override = default;
+
+  rocksdb::Status AddUserKey(const rocksdb::Slice& key, const rocksdb::Slice& value, rocksdb::EntryType type,
+                             rocksdb::SequenceNumber seq, uint64_t file_size) override;
+  rocksdb::Status Finish(rocksdb::UserCollectedProperties* properties) override;
+  rocksdb::UserCollectedProperties GetReadableProperties() const override { return {}; }
+
+  const char* Name() const override { return "KeySampleCollector"; }
+
+  static std::string EncodeSamples(const std::vector<Sample>& samples);
+  static bool DecodeSamples(const std::string& data, std::vector<Sample>& samples);
+
+  inline static const std::string kPropertyName = "dingo.key_samples";
+
+ private:
+  int64_t interval_size_;
+  // size from previous sample
+  int64_t size_{0};
+  std::string last_key_;
+  std::vector<Sample> samples_;
+};
+
+class KeySampleCollectorFactory : public rocksdb::TablePropertiesCollectorFactory {
+ public:
+  KeySampleCollectorFactory() = default;
+  ~KeySampleCollectorFactory() override = default;
+
+  rocksdb::TablePropertiesCollector* CreateTablePropertiesCollector(
+      rocksdb::TablePropertiesCollectorFactory::Context context) override;
+
+  const char* Name() const override { return "KeySampleCollectorFactory"; }
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_KEY_SAMPLE_COLLECTOR_H_
@@ -0,0 +1,201 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/lock_wait_manager.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "butil/time.h"
+#include "bvar/reducer.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+
+namespace dingodb {
+
+bvar::Adder<int64_t> g_lock_wait_count("dingo_txn_lock_wait_count");
+bvar::Adder<int64_t> g_lock_wait_timeout_count("dingo_txn_lock_wait_timeout_count");
+bvar::Adder<int64_t> g_lock_wait_deadlock_count("dingo_txn_lock_wait_deadlock_count");
+
+LockWaitManager::LockWaitManager() { bthread_mutex_init(&mutex_, nullptr); }
+
+LockWaitManager::~LockWaitManager() { bthread_mutex_destroy(&mutex_); }
+
+LockWaitManager& LockWaitManager::GetInstance() {
+  static LockWaitManager lock_wait_manager;
+  return lock_wait_manager;
+}
+
+bool LockWaitManager::Wait(int64_t start_ts, int64_t lock_ts, int64_t timeout_ms, WakeUpFunc func) {
+  auto waiter = std::make_shared<Waiter>();
+  waiter->manager = this;
+  waiter->start_ts = start_ts;
+  waiter->lock_ts = lock_ts;
+  waiter->func = std::move(func);
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    if (IsDeadlock(start_ts, lock_ts)) {
+      g_lock_wait_deadlock_count << 1;
+      DINGO_LOG(WARNING) << fmt::format("[txn.lock_wait] txn({}) wait txn({}) happen deadlock.", start_ts, lock_ts);
+      return false;
+    }
+
+    waiters_[lock_ts].push_back(waiter);
+    ++wait_for_[start_ts][lock_ts];
+
+    // add timer under mutex, so WakeUp always see timer_id
+    waiter->timer_arg = new WaiterPtr(waiter);
+    if (bthread_timer_add(&waiter->timer_id, butil::milliseconds_from_now(timeout_ms), &OnTimeout,
+                          waiter->timer_arg) != 0) {
+      delete static_cast<WaiterPtr*>(waiter->timer_arg);
+      waiter->timer_arg = nullptr;
+      RemoveWaiter(waiter);
+      DINGO_LOG(ERROR) << fmt::format("[txn.lock_wait] txn({}) add wait timer failed.", start_ts);
+      return false;
+    }
+  }
+
+  g_lock_wait_count << 1;
+  return true;
+}
+
+void LockWaitManager::WakeUp(int64_t lock_ts) {
+  std::vector<WaiterPtr> waiters;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = waiters_.find(lock_ts);
+    if (it == waiters_.end()) {
+      return;
+    }
+
+    waiters.swap(it->second);
+    waiters_.erase(it);
+    for (auto& waiter : waiters) {
+      auto wait_for_it = wait_for_.find(waiter->start_ts);
+      if (wait_for_it != wait_for_.end()) {
+        auto& lock_tss = wait_for_it->second;
+        if (--lock_tss[lock_ts] <= 0) {
+          lock_tss.erase(lock_ts);
+        }
+        if (lock_tss.empty()) {
+          wait_for_.erase(wait_for_it);
+        }
+      }
+    }
+  }
+
+  for (auto& waiter : waiters) {
+    if (waiter->is_done.exchange(true)) {
+      continue;
+    }
+
+    // 0 means timer is not run, need release its arg
+    if (bthread_timer_del(waiter->timer_id) == 0) {
+      delete static_cast<WaiterPtr*>(waiter->timer_arg);
+    }
+
+    waiter->func(false);
+  }
+}
+
+size_t LockWaitManager::WaiterCount() {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  size_t count = 0;
+  for (const auto& [_, waiters] : waiters_) {
+    count += waiters.size();
+  }
+  return count;
+}
+
+void LockWaitManager::OnTimeout(void* arg) {
+  auto* waiter_ptr = static_cast<WaiterPtr*>(arg);
+  WaiterPtr waiter = *waiter_ptr;
+  delete waiter_ptr;
+
+  if (waiter->is_done.exchange(true)) {
+    return;
+  }
+
+  auto* lock_wait_manager = waiter->manager;
+  {
+    BAIDU_SCOPED_LOCK(lock_wait_manager->mutex_);
+    lock_wait_manager->RemoveWaiter(waiter);
+  }
+
+  g_lock_wait_timeout_count << 1;
+  waiter->func(true);
+}
+
+bool LockWaitManager::IsDeadlock(int64_t start_ts, int64_t lock_ts) {
+  std::set<int64_t> visited;
+  std::vector<int64_t> stack = {lock_ts};
+  while (!stack.empty()) {
+    int64_t ts = stack.back();
+    stack.pop_back();
+    if (ts == start_ts) {
+      return true;
+    }
+    if (!visited.insert(ts).second) {
+      continue;
+    }
+
+    auto it = wait_for_.find(ts);
+    if (it == wait_for_.end()) {
+      continue;
+    }
+    for (const auto& [next_ts, _] : it->second) {
+      stack.push_back(next_ts);
+    }
+  }
+
+  return false;
+}
+
+void LockWaitManager::RemoveWaiter(WaiterPtr waiter) {
+  auto it = waiters_.find(waiter->lock_ts);
+  if (it == waiters_.end()) {
+    // already removed by WakeUp
+    return;
+  }
+
+  auto& waiters = it->second;
+  auto waiter_it = std::find(waiters.begin(), waiters.end(), waiter);
+  if (waiter_it == waiters.end()) {
+    return;
+  }
+  waiters.erase(waiter_it);
+  if (waiters.empty()) {
+    waiters_.erase(it);
+  }
+
+  auto wait_for_it = wait_for_.find(waiter->start_ts);
+  if (wait_for_it != wait_for_.end()) {
+    auto& lock_tss = wait_for_it->second;
+    if (--lock_tss[waiter->lock_ts] <= 0) {
+      lock_tss.erase(waiter->lock_ts);
+    }
+    if (lock_tss.empty()) {
+      wait_for_.erase(wait_for_it);
+    }
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,85 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_LOCK_WAIT_MANAGER_H_
+#define DINGODB_ENGINE_LOCK_WAIT_MANAGER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "bthread/types.h"
+#include "bthread/unstable.h"
+
+namespace dingodb {
+
+// Park pessimistic lock request which meet lock conflict, and wake up it when the lock owner txn
+// is finished(commit/rollback/resolve), so client need not backoff and retry.
+// Wait for graph of parked txns is used to detect deadlock of this store.
+class LockWaitManager {
+ public:
+  // is_timeout is true when wait timeout, else lock owner txn is finished.
+  using WakeUpFunc = std::function<void(bool is_timeout)>;
+
+  LockWaitManager();
+  ~LockWaitManager();
+
+  LockWaitManager(const LockWaitManager&) = delete;
+  const LockWaitManager& operator=(const LockWaitManager&) = delete;
+
+  static LockWaitManager& GetInstance();
+
+  // Txn start_ts wait lock owned by txn lock_ts at most timeout_ms, func is called once when wake up.
+  // Return false and not call func when deadlock happen.
+  bool Wait(int64_t start_ts, int64_t lock_ts, int64_t timeout_ms, WakeUpFunc func);
+
+  // Txn lock_ts release its locks, wake up all waiters.
+  void WakeUp(int64_t lock_ts);
+
+  size_t WaiterCount();
+
+ private:
+  struct Waiter {
+    LockWaitManager* manager{nullptr};
+    int64_t start_ts{0};
+    int64_t lock_ts{0};
+    WakeUpFunc func;
+
+    std::atomic<bool> is_done{false};
+    bthread_timer_t timer_id{0};
+    // timer arg, own a reference of waiter
+    void* timer_arg{nullptr};
+  };
+  using WaiterPtr = std::shared_ptr<Waiter>;
+
+  static void OnTimeout(void* arg);
+
+  // Whether lock_ts wait start_ts directly or indirectly, need hold mutex_.
+  bool IsDeadlock(int64_t start_ts, int64_t lock_ts);
+  // Remove waiter from waiters_ and wait_for_, need hold mutex_.
+  void RemoveWaiter(WaiterPtr waiter);
+
+  bthread_mutex_t mutex_;
+  // lock_ts: waiters
+  std::map<int64_t, std::vector<WaiterPtr>> waiters_;
+  // wait for graph, start_ts: the lock_ts which start_ts waiting for
+  std::map<int64_t, std::map<int64_t, int32_t>> wait_for_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_LOCK_WAIT_MANAGER_H_
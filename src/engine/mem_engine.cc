@@ -14,33 +14,116 @@
 
 #include "engine/mem_engine.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/compiler_specific.h"
+#include "common/constant.h"
 #include "common/logging.h"
+#include "engine/write_data.h"
+#include "fmt/core.h"
+#include "mvcc/reader.h"
+#include "proto/error.pb.h"
 
 namespace dingodb {
 
-bool MemEngine::Init(std::shared_ptr<Config> /*config*/) {
+bool MemEngine::Init(std::shared_ptr<Config> config) {
   DINGO_LOG(INFO) << "Init MemEngine...";
-  return true;
+
+  raw_engine_ = std::make_shared<MemRawEngine>();
+  return raw_engine_->Init(config, {Constant::kStoreDataCF, Constant::kStoreMetaCF, Constant::kTxnDataCF,
+                                    Constant::kTxnLockCF, Constant::kTxnWriteCF});
 }
 
 std::string MemEngine::GetName() { return pb::common::StorageEngine_Name(GetID()); }
 
 pb::common::StorageEngine MemEngine::GetID() { return pb::common::StorageEngine::STORE_ENG_MEMORY; }
 
-butil::Status MemEngine::Write(std::shared_ptr<Context> /*ctx*/, std::shared_ptr<WriteData> /*write_data*/) {
+RawEnginePtr MemEngine::GetRawEngine(pb::common::RawEngine /*type*/) { return raw_engine_; }
+
+// Apply directly, only support kv put/delete.
+butil::Status MemEngine::Write(std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data) {
+  auto writer = raw_engine_->Writer();
+  for (const auto& datum : write_data->Datums()) {
+    butil::Status status;
+    switch (datum->GetType()) {
+      case DatumType::kPut: {
+        auto put_datum = std::dynamic_pointer_cast<PutDatum>(datum);
+        if (BAIDU_UNLIKELY(put_datum == nullptr)) {
+          status = butil::Status(pb::error::ENOT_SUPPORT, "Not support write datum");
+          break;
+        }
+        status = writer->KvBatchPut(put_datum->cf_name, put_datum->kvs);
+        break;
+      }
+      case DatumType::kDeleteBatch: {
+        auto delete_batch_datum = std::dynamic_pointer_cast<DeleteBatchDatum>(datum);
+        if (BAIDU_UNLIKELY(delete_batch_datum == nullptr)) {
+          status = butil::Status(pb::error::ENOT_SUPPORT, "Not support write datum");
+          break;
+        }
+        status = writer->KvBatchPutAndDelete(delete_batch_datum->cf_name, {}, delete_batch_datum->keys);
+        break;
+      }
+      case DatumType::kDeleteRange: {
+        auto delete_range_datum = std::dynamic_pointer_cast<DeleteRangeDatum>(datum);
+        if (BAIDU_UNLIKELY(delete_range_datum == nullptr)) {
+          status = butil::Status(pb::error::ENOT_SUPPORT, "Not support write datum");
+          break;
+        }
+        status = writer->KvBatchDeleteRange({{delete_range_datum->cf_name, delete_range_datum->ranges}});
+        break;
+      }
+      default:
+        status = butil::Status(pb::error::ENOT_SUPPORT, "Not support write type");
+    }
+
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[mem.engine][region({})] write failed, error: {}", ctx->RegionId(),
+                                      status.error_str());
+      return status;
+    }
+  }
+
   return butil::Status();
 }
 
-butil::Status MemEngine::AsyncWrite(std::shared_ptr<Context> /*ctx*/, std::shared_ptr<WriteData> /*write_data*/) {
-  return butil::Status();
+butil::Status MemEngine::AsyncWrite(std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data) {
+  return Write(ctx, write_data);
 }
 
-butil::Status MemEngine::AsyncWrite(std::shared_ptr<Context> /*ctx*/, std::shared_ptr<WriteData> /*write_data*/,
-                                    WriteCbFunc /*cb*/) {
-  return butil::Status();
+butil::Status MemEngine::AsyncWrite(std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data,
+                                    WriteCbFunc cb) {
+  auto status = Write(ctx, write_data);
+  if (cb) {
+    cb(ctx, status);
+  }
+
+  return status;
+}
+
+butil::Status MemEngine::Reader::KvGet(std::shared_ptr<Context> ctx, const std::string& key, std::string& value) {
+  return reader_->KvGet(ctx->CfName(), key, value);
 }
 
-std::shared_ptr<Engine::Reader> MemEngine::NewReader(pb::common::RawEngine) { return nullptr; }
+butil::Status MemEngine::Reader::KvScan(std::shared_ptr<Context> ctx, const std::string& start_key,
+                                        const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) {
+  return reader_->KvScan(ctx->CfName(), start_key, end_key, kvs);
+}
+
+butil::Status MemEngine::Reader::KvCount(std::shared_ptr<Context> ctx, const std::string& start_key,
+                                         const std::string& end_key, int64_t& count) {
+  return reader_->KvCount(ctx->CfName(), start_key, end_key, count);
+}
+
+mvcc::ReaderPtr MemEngine::NewMVCCReader(pb::common::RawEngine /*type*/) {
+  return std::make_shared<mvcc::KvReader>(raw_engine_->Reader());
+}
+
+std::shared_ptr<Engine::Reader> MemEngine::NewReader(pb::common::RawEngine /*type*/) {
+  return std::make_shared<MemEngine::Reader>(raw_engine_->Reader());
+}
 
 std::shared_ptr<Engine::Writer> MemEngine::NewWriter(pb::common::RawEngine) { return nullptr; }
 
@@ -16,14 +16,18 @@
 #define DINGODB_ENGINE_MEM_ENGINE_H_
 
 #include <cstdint>
-#include <map>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "common/context.h"
 #include "engine/engine.h"
+#include "engine/mem_raw_engine.h"
 #include "engine/snapshot.h"
 
 namespace dingodb {
 
+// Store engine without replication and persistence, all data held by MemRawEngine.
 class MemEngine : public Engine {
  public:
   MemEngine() = default;
@@ -32,6 +36,7 @@ class MemEngine : public Engine {
   bool Init(std::shared_ptr<Config> config) override;
   std::string GetName() override;
   pb::common::StorageEngine GetID() override;
+  RawEnginePtr GetRawEngine(pb::common::RawEngine type) override;
 
   std::shared_ptr<Snapshot> GetSnapshot() override { return nullptr; }
   butil::Status SaveSnapshot(std::shared_ptr<Context>, int64_t, bool) override { return butil::Status(); }
@@ -42,6 +47,22 @@ class MemEngine : public Engine {
   butil::Status AsyncWrite(std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data,
                            WriteCbFunc cb) override;
 
+  class Reader : public Engine::Reader {
+   public:
+    Reader(RawEngine::ReaderPtr reader) : reader_(reader) {}
+    butil::Status KvGet(std::shared_ptr<Context> ctx, const std::string& key, std::string& value) override;
+
+    butil::Status KvScan(std::shared_ptr<Context> ctx, const std::string& start_key, const std::string& end_key,
+                         std::vector<pb::common::KeyValue>& kvs) override;
+
+    butil::Status KvCount(std::shared_ptr<Context> ctx, const std::string& start_key, const std::string& end_key,
+                          int64_t& count) override;
+
+   private:
+    RawEngine::ReaderPtr reader_;
+  };
+
+  mvcc::ReaderPtr NewMVCCReader(pb::common::RawEngine type) override;
   std::shared_ptr<Engine::Reader> NewReader(pb::common::RawEngine type) override;
   std::shared_ptr<Engine::Writer> NewWriter(pb::common::RawEngine type) override;
   std::shared_ptr<Engine::VectorReader> NewVectorReader(pb::common::RawEngine type) override;
@@ -50,7 +71,7 @@ class MemEngine : public Engine {
   std::shared_ptr<Engine::TxnWriter> NewTxnWriter(pb::common::RawEngine type) override;
 
  private:
-  std::map<std::string, std::string> store_;
+  std::shared_ptr<MemRawEngine> raw_engine_;
 };
 
 }  // namespace dingodb
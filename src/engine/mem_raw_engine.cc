@@ -0,0 +1,735 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/mem_raw_engine.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "butil/compiler_specific.h"
+#include "butil/status.h"
+#include "common/logging.h"
+#include "engine/rocks_raw_engine.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+#include "rocksdb/options.h"
+#include "rocksdb/sst_file_reader.h"
+
+namespace dingodb {
+
+DEFINE_int32(mem_raw_engine_ingest_batch_size, 4096, "mem raw engine ingest sst file batch put kv num");
+
+namespace mem {
+
+const Version* ColumnFamily::GetVisibleVersion(const VersionChain& versions, uint64_t seq) {
+  for (auto it = versions.rbegin(); it != versions.rend(); ++it) {
+    if (it->seq <= seq) {
+      return &(*it);
+    }
+  }
+
+  return nullptr;
+}
+
+bool ColumnFamily::Get(const std::string& key, uint64_t seq, std::string& value) const {
+  auto it = data_.find(key);
+  if (it == data_.end()) {
+    return false;
+  }
+
+  const auto* version = GetVisibleVersion(it->second, seq);
+  if (version == nullptr || version->is_delete) {
+    return false;
+  }
+
+  value = version->value;
+  return true;
+}
+
+bool ColumnFamily::Seek(const std::string& target, bool exclusive, const std::string& end_key, uint64_t seq,
+                        std::string& key, std::string& value) const {
+  auto it = exclusive ? data_.upper_bound(target) : data_.lower_bound(target);
+  for (; it != data_.end(); ++it) {
+    if (!end_key.empty() && it->first >= end_key) {
+      return false;
+    }
+
+    const auto* version = GetVisibleVersion(it->second, seq);
+    if (version != nullptr && !version->is_delete) {
+      key = it->first;
+      value = version->value;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool ColumnFamily::SeekForPrev(const std::string& target, bool exclusive, const std::string& start_key, uint64_t seq,
+                               std::string& key, std::string& value) const {
+  auto it = target.empty() ? data_.end() : (exclusive ? data_.lower_bound(target) : data_.upper_bound(target));
+  while (it != data_.begin()) {
+    --it;
+    if (!start_key.empty() && it->first < start_key) {
+      return false;
+    }
+
+    const auto* version = GetVisibleVersion(it->second, seq);
+    if (version != nullptr && !version->is_delete) {
+      key = it->first;
+      value = version->value;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void ColumnFamily::Scan(const std::string& start_key, const std::string& end_key, uint64_t seq,
+                        const std::function<bool(const std::string&, const std::string&)>& func) const {
+  for (auto it = data_.lower_bound(start_key); it != data_.end() && (end_key.empty() || it->first < end_key); ++it) {
+    const auto* version = GetVisibleVersion(it->second, seq);
+    if (version != nullptr && !version->is_delete) {
+      if (!func(it->first, version->value)) {
+        return;
+      }
+    }
+  }
+}
+
+bool ColumnFamily::Prune(VersionChain& versions, uint64_t min_seq) {
+  // Keep the newest version which min_seq can read, and all versions newer than it.
+  size_t drop_count = 0;
+  for (size_t i = versions.size(); i > 0; --i) {
+    if (versions[i - 1].seq <= min_seq) {
+      drop_count = i - 1;
+      // Tombstone which every snapshot can read is same as not exist.
+      if (versions[i - 1].is_delete) {
+        drop_count = i;
+      }
+      break;
+    }
+  }
+
+  for (size_t i = 0; i < drop_count; ++i) {
+    memory_usage_ -= versions[i].value.size() + sizeof(Version);
+  }
+  versions.erase(versions.begin(), versions.begin() + drop_count);
+
+  return !versions.empty();
+}
+
+void ColumnFamily::AddVersion(const std::string& key, Version version, uint64_t min_seq) {
+  auto it = data_.find(key);
+  if (it == data_.end()) {
+    if (version.is_delete) {
+      return;
+    }
+
+    memory_usage_ += key.size() + version.value.size() + sizeof(Version);
+    data_[key].push_back(std::move(version));
+    return;
+  }
+
+  memory_usage_ += version.value.size() + sizeof(Version);
+  it->second.push_back(std::move(version));
+  if (!Prune(it->second, min_seq)) {
+    memory_usage_ -= it->first.size();
+    data_.erase(it);
+  }
+}
+
+void ColumnFamily::Put(const std::string& key, const std::string& value, uint64_t seq, uint64_t min_seq) {
+  AddVersion(key, Version{seq, false, value}, min_seq);
+}
+
+void ColumnFamily::Delete(const std::string& key, uint64_t seq, uint64_t min_seq) {
+  AddVersion(key, Version{seq, true, ""}, min_seq);
+}
+
+void ColumnFamily::DeleteRange(const std::string& start_key, const std::string& end_key, uint64_t seq,
+                               uint64_t min_seq) {
+  auto it = data_.lower_bound(start_key);
+  while (it != data_.end() && it->first < end_key) {
+    if (!it->second.back().is_delete) {
+      memory_usage_ += sizeof(Version);
+      it->second.push_back(Version{seq, true, ""});
+    }
+
+    if (!Prune(it->second, min_seq)) {
+      memory_usage_ -= it->first.size();
+      it = data_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void ColumnFamily::Compact(uint64_t min_seq) {
+  auto it = data_.begin();
+  while (it != data_.end()) {
+    if (!Prune(it->second, min_seq)) {
+      memory_usage_ -= it->first.size();
+      it = data_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void ColumnFamily::Clear() {
+  data_.clear();
+  memory_usage_ = 0;
+}
+
+Snapshot::~Snapshot() {
+  auto raw_engine = raw_engine_.lock();
+  if (raw_engine != nullptr) {
+    raw_engine->ReleaseSnapshot(seq_);
+  }
+}
+
+void Iterator::DoSeek(const std::string& target, bool exclusive) {
+  RWLockReadGuard guard(&raw_engine_->rw_lock_);
+
+  valid_ = column_family_->Seek(target, exclusive, options_.upper_bound, snapshot_->Seq(), key_, value_);
+}
+
+void Iterator::DoSeekForPrev(const std::string& target, bool exclusive) {
+  RWLockReadGuard guard(&raw_engine_->rw_lock_);
+
+  valid_ = column_family_->SeekForPrev(target, exclusive, options_.lower_bound, snapshot_->Seq(), key_, value_);
+}
+
+void Iterator::SeekToFirst() { DoSeek(options_.lower_bound, false); }
+
+void Iterator::SeekToLast() { DoSeekForPrev(options_.upper_bound, true); }
+
+void Iterator::Seek(const std::string& target) {
+  DoSeek(!options_.lower_bound.empty() && target < options_.lower_bound ? options_.lower_bound : target, false);
+}
+
+void Iterator::SeekForPrev(const std::string& target) {
+  if (!options_.upper_bound.empty() && (target.empty() || target >= options_.upper_bound)) {
+    DoSeekForPrev(options_.upper_bound, true);
+  } else {
+    DoSeekForPrev(target, false);
+  }
+}
+
+void Iterator::Next() {
+  if (BAIDU_LIKELY(valid_)) {
+    DoSeek(key_, true);
+  }
+}
+
+void Iterator::Prev() {
+  if (BAIDU_LIKELY(valid_)) {
+    DoSeekForPrev(key_, true);
+  }
+}
+
+std::shared_ptr<MemRawEngine> Reader::GetRawEngine() {
+  auto raw_engine = raw_engine_.lock();
+  if (raw_engine == nullptr) {
+    DINGO_LOG(FATAL) << "[mem] get raw engine failed.";
+  }
+
+  return raw_engine;
+}
+
+SnapshotPtr Reader::GetSnapshot(dingodb::SnapshotPtr snapshot) {
+  if (snapshot == nullptr) {
+    return GetRawEngine()->NewSnapshot();
+  }
+
+  auto mem_snapshot = std::dynamic_pointer_cast<Snapshot>(snapshot);
+  CHECK(mem_snapshot != nullptr) << "[mem] snapshot is not mem snapshot.";
+  return mem_snapshot;
+}
+
+butil::Status Reader::KvGet(const std::string& cf_name, const std::string& key, std::string& value) {
+  return KvGet(cf_name, nullptr, key, value);
+}
+
+butil::Status Reader::KvGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
+                            std::string& value) {
+  if (BAIDU_UNLIKELY(key.empty())) {
+    DINGO_LOG(ERROR) << fmt::format("[mem] not support empty key.");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  auto raw_engine = GetRawEngine();
+  auto column_family = raw_engine->GetColumnFamily(cf_name);
+  auto mem_snapshot = GetSnapshot(snapshot);
+
+  RWLockReadGuard guard(&raw_engine->rw_lock_);
+  if (!column_family->Get(key, mem_snapshot->Seq(), value)) {
+    return butil::Status(pb::error::EKEY_NOT_FOUND, "Not found key");
+  }
+
+  return butil::Status();
+}
+
+butil::Status Reader::KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                 std::vector<std::string>& values, std::vector<bool>& key_states) {
+  return KvMultiGet(cf_name, nullptr, keys, values, key_states);
+}
+
+butil::Status Reader::KvMultiGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                 std::vector<bool>& key_states) {
+  values.clear();
+  key_states.clear();
+  if (keys.empty()) {
+    return butil::Status();
+  }
+
+  for (const auto& key : keys) {
+    if (BAIDU_UNLIKELY(key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[mem] not support empty key.");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+  }
+
+  auto raw_engine = GetRawEngine();
+  auto column_family = raw_engine->GetColumnFamily(cf_name);
+  auto mem_snapshot = GetSnapshot(snapshot);
+
+  values.resize(keys.size());
+  key_states.resize(keys.size(), false);
+
+  RWLockReadGuard guard(&raw_engine->rw_lock_);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    key_states[i] = column_family->Get(keys[i], mem_snapshot->Seq(), values[i]);
+  }
+
+  return butil::Status();
+}
+
+butil::Status Reader::KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
+                             std::vector<pb::common::KeyValue>& kvs) {
+  return KvScan(cf_name, nullptr, start_key, end_key, kvs);
+}
+
+butil::Status Reader::KvScan(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
+                             const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) {
+  if (BAIDU_UNLIKELY(start_key.empty())) {
+    DINGO_LOG(ERROR) << fmt::format("[mem] not support empty start_key.");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  if (BAIDU_UNLIKELY(end_key.empty())) {
+    DINGO_LOG(ERROR) << fmt::format("[mem] not support empty end_key.");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  auto raw_engine = GetRawEngine();
+  auto column_family = raw_engine->GetColumnFamily(cf_name);
+  auto mem_snapshot = GetSnapshot(snapshot);
+
+  RWLockReadGuard guard(&raw_engine->rw_lock_);
+  column_family->Scan(start_key, end_key, mem_snapshot->Seq(), [&](const std::string& key, const std::string& value) {
+    pb::common::KeyValue kv;
+    kv.set_key(key);
+    kv.set_value(value);
+    kvs.emplace_back(std::move(kv));
+    return true;
+  });
+
+  return butil::Status();
+}
+
+butil::Status Reader::KvCount(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
+                              int64_t& count) {
+  return KvCount(cf_name, nullptr, start_key, end_key, count);
+}
+
+butil::Status Reader::KvCount(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
+                              const std::string& end_key, int64_t& count) {
+  if (BAIDU_UNLIKELY(start_key.empty())) {
+    DINGO_LOG(ERROR) << fmt::format("[mem] not support empty start_key.");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  if (BAIDU_UNLIKELY(end_key.empty())) {
+    DINGO_LOG(ERROR) << fmt::format("[mem] not support empty end_key.");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  auto raw_engine = GetRawEngine();
+  auto column_family = raw_engine->GetColumnFamily(cf_name);
+  auto mem_snapshot = GetSnapshot(snapshot);
+
+  count = 0;
+  RWLockReadGuard guard(&raw_engine->rw_lock_);
+  column_family->Scan(start_key, end_key, mem_snapshot->Seq(), [&](const std::string&, const std::string&) {
+    ++count;
+    return true;
+  });
+
+  return butil::Status();
+}
+
+dingodb::IteratorPtr Reader::NewIterator(const std::string& cf_name, IteratorOptions options) {
+  return NewIterator(cf_name, nullptr, options);
+}
+
+dingodb::IteratorPtr Reader::NewIterator(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                         IteratorOptions options) {
+  auto raw_engine = GetRawEngine();
+  return std::make_shared<Iterator>(options, raw_engine, raw_engine->GetColumnFamily(cf_name), GetSnapshot(snapshot));
+}
+
+std::shared_ptr<MemRawEngine> Writer::GetRawEngine() {
+  auto raw_engine = raw_engine_.lock();
+  if (raw_engine == nullptr) {
+    DINGO_LOG(FATAL) << "[mem] get raw engine failed.";
+  }
+
+  return raw_engine;
+}
+
+butil::Status Writer::KvPut(const std::string& cf_name, const pb::common::KeyValue& kv) {
+  if (BAIDU_UNLIKELY(kv.key().empty())) {
+    DINGO_LOG(ERROR) << fmt::format("[mem] not support empty key.");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  auto raw_engine = GetRawEngine();
+  return raw_engine->Write(
+      {MemRawEngine::WriteOp{MemRawEngine::WriteOp::kPut, raw_engine->GetColumnFamily(cf_name), &kv.key(), &kv.value()}});
+}
+
+butil::Status Writer::KvBatchPut(const std::string& cf_name, const std::vector<pb::common::KeyValue>& kvs) {
+  if (BAIDU_UNLIKELY(kvs.empty())) {
+    DINGO_LOG(ERROR) << fmt::format("[mem] not support empty keys.");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  return KvBatchPutAndDelete(cf_name, kvs, {});
+}
+
+butil::Status Writer::KvDelete(const std::string& cf_name, const std::string& key) {
+  if (BAIDU_UNLIKELY(key.empty())) {
+    DINGO_LOG(ERROR) << fmt::format("[mem] not support empty key.");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  auto raw_engine = GetRawEngine();
+  return raw_engine->Write(
+      {MemRawEngine::WriteOp{MemRawEngine::WriteOp::kDelete, raw_engine->GetColumnFamily(cf_name), &key}});
+}
+
+butil::Status Writer::KvBatchPutAndDelete(const std::string& cf_name,
+                                          const std::vector<pb::common::KeyValue>& kvs_to_put,
+                                          const std::vector<std::string>& keys_to_delete) {
+  if (BAIDU_UNLIKELY(kvs_to_put.empty() && keys_to_delete.empty())) {
+    DINGO_LOG(ERROR) << fmt::format("[mem] not support empty keys.");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  auto raw_engine = GetRawEngine();
+  auto column_family = raw_engine->GetColumnFamily(cf_name);
+
+  std::vector<MemRawEngine::WriteOp> ops;
+  ops.reserve(kvs_to_put.size() + keys_to_delete.size());
+  for (const auto& kv : kvs_to_put) {
+    if (BAIDU_UNLIKELY(kv.key().empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[mem] not support empty key.");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+    ops.push_back(MemRawEngine::WriteOp{MemRawEngine::WriteOp::kPut, column_family, &kv.key(), &kv.value()});
+  }
+
+  for (const auto& key : keys_to_delete) {
+    if (BAIDU_UNLIKELY(key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[mem] not support empty key.");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+    ops.push_back(MemRawEngine::WriteOp{MemRawEngine::WriteOp::kDelete, column_family, &key});
+  }
+
+  return raw_engine->Write(ops);
+}
+
+butil::Status Writer::KvBatchPutAndDelete(
+    const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_puts_with_cf,
+    const std::map<std::string, std::vector<std::string>>& kv_deletes_with_cf) {
+  auto raw_engine = GetRawEngine();
+
+  std::vector<MemRawEngine::WriteOp> ops;
+  for (const auto& [cf_name, kv_puts] : kv_puts_with_cf) {
+    if (BAIDU_UNLIKELY(kv_puts.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[mem] keys empty not support");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+
+    auto column_family = raw_engine->GetColumnFamily(cf_name);
+    for (const auto& kv : kv_puts) {
+      if (BAIDU_UNLIKELY(kv.key().empty())) {
+        DINGO_LOG(ERROR) << fmt::format("[mem] key empty not support");
+        return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+      }
+      ops.push_back(MemRawEngine::WriteOp{MemRawEngine::WriteOp::kPut, column_family, &kv.key(), &kv.value()});
+    }
+  }
+
+  for (const auto& [cf_name, kv_deletes] : kv_deletes_with_cf) {
+    if (BAIDU_UNLIKELY(kv_deletes.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[mem] keys empty not support");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+
+    auto column_family = raw_engine->GetColumnFamily(cf_name);
+    for (const auto& key : kv_deletes) {
+      if (BAIDU_UNLIKELY(key.empty())) {
+        DINGO_LOG(ERROR) << fmt::format("[mem] key empty not support");
+        return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+      }
+      ops.push_back(MemRawEngine::WriteOp{MemRawEngine::WriteOp::kDelete, column_family, &key});
+    }
+  }
+
+  return raw_engine->Write(ops);
+}
+
+butil::Status Writer::KvDeleteRange(const std::string& cf_name, const pb::common::Range& range) {
+  return KvBatchDeleteRange({{cf_name, {range}}});
+}
+
+butil::Status Writer::KvBatchDeleteRange(const std::map<std::string, std::vector<pb::common::Range>>& range_with_cfs) {
+  auto raw_engine = GetRawEngine();
+
+  std::vector<MemRawEngine::WriteOp> ops;
+  for (const auto& [cf_name, ranges] : range_with_cfs) {
+    auto column_family = raw_engine->GetColumnFamily(cf_name);
+    for (const auto& range : ranges) {
+      if (range.start_key().empty() || range.end_key().empty()) {
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "range is empty");
+      }
+      if (range.start_key() >= range.end_key()) {
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "range is wrong");
+      }
+
+      ops.push_back(
+          MemRawEngine::WriteOp{MemRawEngine::WriteOp::kDeleteRange, column_family, nullptr, nullptr, &range});
+    }
+  }
+
+  return raw_engine->Write(ops);
+}
+
+}  // namespace mem
+
+MemRawEngine::MemRawEngine() { bthread_mutex_init(&snapshot_mutex_, nullptr); }
+
+MemRawEngine::~MemRawEngine() { bthread_mutex_destroy(&snapshot_mutex_); }
+
+std::shared_ptr<MemRawEngine> MemRawEngine::GetSelfPtr() {
+  return std::dynamic_pointer_cast<MemRawEngine>(shared_from_this());
+}
+
+std::string MemRawEngine::GetName() { return "RAW_ENG_MEMORY"; }
+
+pb::common::RawEngine MemRawEngine::GetRawEngineType() { return pb::common::RawEngine::RAW_ENG_ROCKSDB; }
+
+bool MemRawEngine::Init(std::shared_ptr<Config> /*config*/, const std::vector<std::string>& cf_names) {
+  DINGO_LOG(INFO) << "Init mem raw engine...";
+
+  for (const auto& cf_name : cf_names) {
+    column_families_.emplace(cf_name, std::make_shared<mem::ColumnFamily>(cf_name));
+  }
+
+  reader_ = std::make_shared<mem::Reader>(GetSelfPtr());
+  writer_ = std::make_shared<mem::Writer>(GetSelfPtr());
+
+  DINGO_LOG(INFO) << fmt::format("[mem] init success, column family num: {}", column_families_.size());
+
+  return true;
+}
+
+void MemRawEngine::Close() {
+  RWLockWriteGuard guard(&rw_lock_);
+
+  for (auto& [_, column_family] : column_families_) {
+    column_family->Clear();
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[mem] close engine.");
+}
+
+void MemRawEngine::Destroy() { Close(); }
+
+mem::ColumnFamilyPtr MemRawEngine::GetColumnFamily(const std::string& cf_name) {
+  auto it = column_families_.find(cf_name);
+  if (it == column_families_.end()) {
+    DINGO_LOG(FATAL) << fmt::format("[mem] Not found column family {}", cf_name);
+  }
+
+  return it->second;
+}
+
+mem::SnapshotPtr MemRawEngine::NewSnapshot() {
+  RWLockReadGuard guard(&rw_lock_);
+
+  BAIDU_SCOPED_LOCK(snapshot_mutex_);
+  snapshot_seqs_.insert(seq_);
+  return std::make_shared<mem::Snapshot>(seq_, GetSelfPtr());
+}
+
+void MemRawEngine::ReleaseSnapshot(uint64_t seq) {
+  BAIDU_SCOPED_LOCK(snapshot_mutex_);
+
+  auto it = snapshot_seqs_.find(seq);
+  if (it != snapshot_seqs_.end()) {
+    snapshot_seqs_.erase(it);
+  }
+}
+
+uint64_t MemRawEngine::MinSnapshotSeq(uint64_t seq) {
+  // Snapshot is taken under read lock, so no new snapshot while hold write lock.
+  BAIDU_SCOPED_LOCK(snapshot_mutex_);
+  return snapshot_seqs_.empty() ? seq : *snapshot_seqs_.begin();
+}
+
+dingodb::SnapshotPtr MemRawEngine::GetSnapshot() { return NewSnapshot(); }
+
+RawEngine::ReaderPtr MemRawEngine::Reader() { return reader_; }
+
+RawEngine::WriterPtr MemRawEngine::Writer() { return writer_; }
+
+RawEngine::CheckpointPtr MemRawEngine::NewCheckpoint() { return std::make_shared<RawEngine::Checkpoint>(); }
+
+butil::Status MemRawEngine::Write(const std::vector<WriteOp>& ops) {
+  RWLockWriteGuard guard(&rw_lock_);
+
+  uint64_t seq = seq_ + 1;
+  uint64_t min_seq = MinSnapshotSeq(seq);
+  for (const auto& op : ops) {
+    switch (op.type) {
+      case WriteOp::kPut:
+        op.column_family->Put(*op.key, *op.value, seq, min_seq);
+        break;
+      case WriteOp::kDelete:
+        op.column_family->Delete(*op.key, seq, min_seq);
+        break;
+      case WriteOp::kDeleteRange:
+        op.column_family->DeleteRange(op.range->start_key(), op.range->end_key(), seq, min_seq);
+        break;
+      default:
+        DINGO_LOG(FATAL) << fmt::format("[mem] unknown write op type {}.", static_cast<int>(op.type));
+    }
+  }
+  seq_ = seq;
+
+  return butil::Status();
+}
+
+butil::Status MemRawEngine::MergeCheckpointFiles(const std::string& /*path*/, const pb::common::Range& /*range*/,
+                                                 const std::vector<std::string>& /*cf_names*/,
+                                                 std::vector<std::string>& /*merge_sst_paths*/) {
+  return butil::Status(pb::error::ENOT_SUPPORT, "Not support merge checkpoint files.");
+}
+
+butil::Status MemRawEngine::IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files) {
+  for (const auto& file : files) {
+    rocksdb::SstFileReader sst_reader(rocksdb::Options{});
+    auto status = sst_reader.Open(file);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[mem] open sst file {} failed, error: {}", file, status.ToString());
+      return butil::Status(pb::error::EINTERNAL, "Internal open sst file error");
+    }
+
+    std::unique_ptr<rocksdb::Iterator> iter(sst_reader.NewIterator(rocksdb::ReadOptions{}));
+    std::vector<pb::common::KeyValue> kvs;
+    kvs.reserve(FLAGS_mem_raw_engine_ingest_batch_size);
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      pb::common::KeyValue kv;
+      kv.set_key(iter->key().data(), iter->key().size());
+      kv.set_value(iter->value().data(), iter->value().size());
+      kvs.push_back(std::move(kv));
+
+      if (kvs.size() >= static_cast<size_t>(FLAGS_mem_raw_engine_ingest_batch_size)) {
+        auto ret = writer_->KvBatchPut(cf_name, kvs);
+        if (!ret.ok()) {
+          return ret;
+        }
+        kvs.clear();
+      }
+    }
+
+    if (!iter->status().ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[mem] read sst file {} failed, error: {}", file, iter->status().ToString());
+      return butil::Status(pb::error::EINTERNAL, "Internal read sst file error");
+    }
+
+    if (!kvs.empty()) {
+      auto ret = writer_->KvBatchPut(cf_name, kvs);
+      if (!ret.ok()) {
+        return ret;
+      }
+    }
+  }
+
+  return butil::Status();
+}
+
+butil::Status MemRawEngine::SaveFile(const std::string& cf_name, const pb::common::Range& range,
+                                     const std::string& filename) {
+  auto iter = reader_->NewIterator(cf_name, IteratorOptions(range.start_key(), range.end_key()));
+  iter->Seek(range.start_key());
+
+  return RocksRawEngine::NewSstFileWriter()->SaveFile(iter, filename);
+}
+
+void MemRawEngine::Flush(const std::string& /*cf_name*/) {}
+
+butil::Status MemRawEngine::Compact(const std::string& cf_name) {
+  auto column_family = GetColumnFamily(cf_name);
+
+  RWLockWriteGuard guard(&rw_lock_);
+  column_family->Compact(MinSnapshotSeq(seq_));
+
+  return butil::Status();
+}
+
+std::vector<int64_t> MemRawEngine::GetApproximateSizes(const std::string& cf_name,
+                                                       std::vector<pb::common::Range>& ranges) {
+  auto column_family = GetColumnFamily(cf_name);
+
+  std::vector<int64_t> sizes;
+  sizes.reserve(ranges.size());
+
+  RWLockReadGuard guard(&rw_lock_);
+  for (const auto& range : ranges) {
+    int64_t size = 0;
+    column_family->Scan(range.start_key(), range.end_key(), seq_,
+                        [&size](const std::string& key, const std::string& value) {
+                          size += key.size() + value.size();
+                          return true;
+                        });
+    sizes.push_back(size);
+  }
+
+  return sizes;
+}
+
+}  // namespace dingodb
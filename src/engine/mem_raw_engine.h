@@ -0,0 +1,306 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_MEM_RAW_ENGINE_H_  // NOLINT
+#define DINGODB_ENGINE_MEM_RAW_ENGINE_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "bthread/types.h"
+#include "butil/status.h"
+#include "common/synchronization.h"
+#include "config/config.h"
+#include "engine/iterator.h"
+#include "engine/raw_engine.h"
+#include "engine/snapshot.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+class MemRawEngine;
+
+namespace mem {
+
+// One version of a key, seq is the engine write sequence.
+struct Version {
+  uint64_t seq;
+  bool is_delete;
+  std::string value;
+};
+// Ascending by seq, the back is the newest version.
+using VersionChain = std::vector<Version>;
+
+class ColumnFamily {
+ public:
+  explicit ColumnFamily(const std::string& name) : name_(name) {}
+  ~ColumnFamily() = default;
+
+  ColumnFamily(const ColumnFamily& rhs) = delete;
+  ColumnFamily& operator=(const ColumnFamily& rhs) = delete;
+
+  const std::string& Name() const { return name_; }
+
+  // All method must hold the engine lock.
+  bool Get(const std::string& key, uint64_t seq, std::string& value) const;
+  // Find the first visible key >= target(> target when exclusive) and < end_key, empty end_key is unlimited.
+  bool Seek(const std::string& target, bool exclusive, const std::string& end_key, uint64_t seq, std::string& key,
+            std::string& value) const;
+  // Find the last visible key <= target(< target when exclusive) and >= start_key, empty target is unlimited.
+  bool SeekForPrev(const std::string& target, bool exclusive, const std::string& start_key, uint64_t seq,
+                   std::string& key, std::string& value) const;
+  // Traverse visible kvs of [start_key, end_key), stop when func return false.
+  void Scan(const std::string& start_key, const std::string& end_key, uint64_t seq,
+            const std::function<bool(const std::string&, const std::string&)>& func) const;
+
+  // min_seq is the oldest sequence still readable, older versions are dropped.
+  void Put(const std::string& key, const std::string& value, uint64_t seq, uint64_t min_seq);
+  void Delete(const std::string& key, uint64_t seq, uint64_t min_seq);
+  void DeleteRange(const std::string& start_key, const std::string& end_key, uint64_t seq, uint64_t min_seq);
+  void Compact(uint64_t min_seq);
+  void Clear();
+
+  int64_t KeyCount() const { return data_.size(); }
+  int64_t MemoryUsage() const { return memory_usage_; }
+
+ private:
+  using DataMap = std::map<std::string, VersionChain, std::less<>>;
+
+  static const Version* GetVisibleVersion(const VersionChain& versions, uint64_t seq);
+  void AddVersion(const std::string& key, Version version, uint64_t min_seq);
+  // Return false when all versions was dropped.
+  bool Prune(VersionChain& versions, uint64_t min_seq);
+
+  std::string name_;
+  DataMap data_;
+  int64_t memory_usage_{0};
+};
+using ColumnFamilyPtr = std::shared_ptr<ColumnFamily>;
+using ColumnFamilyMap = std::map<std::string, ColumnFamilyPtr>;
+
+class Snapshot : public dingodb::Snapshot {
+ public:
+  explicit Snapshot(uint64_t seq, std::shared_ptr<MemRawEngine> raw_engine) : seq_(seq), raw_engine_(raw_engine) {}
+  ~Snapshot() override;
+
+  const void* Inner() override { return &seq_; }
+
+  uint64_t Seq() const { return seq_; }
+
+ private:
+  uint64_t seq_;
+  std::weak_ptr<MemRawEngine> raw_engine_;
+};
+using SnapshotPtr = std::shared_ptr<Snapshot>;
+
+// Every positioning re-seek in the column family under read lock, and copy out the current kv,
+// so concurrent write never invalidate the iterator, the snapshot keep the view stable.
+class Iterator : public dingodb::Iterator {
+ public:
+  explicit Iterator(IteratorOptions options, std::shared_ptr<MemRawEngine> raw_engine, ColumnFamilyPtr column_family,
+                    SnapshotPtr snapshot)
+      : options_(options), raw_engine_(raw_engine), column_family_(column_family), snapshot_(snapshot) {}
+  ~Iterator() override = default;
+
+  std::string GetName() override { return "RawMem"; }
+  IteratorType GetID() override { return IteratorType::kMemEngine; }
+
+  bool Valid() const override { return valid_; }
+
+  void SeekToFirst() override;
+  void SeekToLast() override;
+
+  void Seek(const std::string& target) override;
+  void SeekForPrev(const std::string& target) override;
+
+  void Next() override;
+  void Prev() override;
+
+  std::string_view Key() const override { return key_; }
+  std::string_view Value() const override { return value_; }
+
+  butil::Status Status() const override { return butil::Status(); }
+
+ private:
+  void DoSeek(const std::string& target, bool exclusive);
+  void DoSeekForPrev(const std::string& target, bool exclusive);
+
+  IteratorOptions options_;
+  std::shared_ptr<MemRawEngine> raw_engine_;
+  ColumnFamilyPtr column_family_;
+  SnapshotPtr snapshot_;
+
+  bool valid_{false};
+  std::string key_;
+  std::string value_;
+};
+
+class Reader : public RawEngine::Reader {
+ public:
+  Reader(std::shared_ptr<MemRawEngine> raw_engine) : raw_engine_(raw_engine) {}
+  ~Reader() override = default;
+
+  butil::Status KvGet(const std::string& cf_name, const std::string& key, std::string& value) override;
+  butil::Status KvGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
+                      std::string& value) override;
+
+  butil::Status KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                           std::vector<std::string>& values, std::vector<bool>& key_states) override;
+  butil::Status KvMultiGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                           const std::vector<std::string>& keys, std::vector<std::string>& values,
+                           std::vector<bool>& key_states) override;
+
+  butil::Status KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
+                       std::vector<pb::common::KeyValue>& kvs) override;
+  butil::Status KvScan(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
+                       const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) override;
+
+  butil::Status KvCount(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
+                        int64_t& count) override;
+  butil::Status KvCount(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
+                        const std::string& end_key, int64_t& count) override;
+
+  dingodb::IteratorPtr NewIterator(const std::string& cf_name, IteratorOptions options) override;
+  dingodb::IteratorPtr NewIterator(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                   IteratorOptions options) override;
+
+ private:
+  std::shared_ptr<MemRawEngine> GetRawEngine();
+  // Convert to mem snapshot, nullptr snapshot take a new one.
+  SnapshotPtr GetSnapshot(dingodb::SnapshotPtr snapshot);
+
+  std::weak_ptr<MemRawEngine> raw_engine_;
+};
+
+class Writer : public RawEngine::Writer {
+ public:
+  Writer(std::shared_ptr<MemRawEngine> raw_engine) : raw_engine_(raw_engine) {}
+  ~Writer() override = default;
+
+  butil::Status KvPut(const std::string& cf_name, const pb::common::KeyValue& kv) override;
+  butil::Status KvBatchPut(const std::string& cf_name, const std::vector<pb::common::KeyValue>& kvs) override;
+
+  butil::Status KvDelete(const std::string& cf_name, const std::string& key) override;
+
+  butil::Status KvBatchPutAndDelete(const std::string& cf_name, const std::vector<pb::common::KeyValue>& kvs_to_put,
+                                    const std::vector<std::string>& keys_to_delete) override;
+  butil::Status KvBatchPutAndDelete(const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_puts_with_cf,
+                                    const std::map<std::string, std::vector<std::string>>& kv_deletes_with_cf) override;
+
+  butil::Status KvDeleteRange(const std::string& cf_name, const pb::common::Range& range) override;
+  butil::Status KvBatchDeleteRange(
+      const std::map<std::string, std::vector<pb::common::Range>>& range_with_cfs) override;
+
+ private:
+  std::shared_ptr<MemRawEngine> GetRawEngine();
+
+  std::weak_ptr<MemRawEngine> raw_engine_;
+};
+
+}  // namespace mem
+
+// In-memory raw engine for ephemeral data, e.g. session and rate limit counter.
+// Column family is an ordered map of multi version values, all writes are serialized and get an increasing
+// sequence, snapshot is a registered sequence, versions which no snapshot can read are dropped on write.
+// Nothing is persisted, raft snapshot serialize region data to sst file by SaveFile and load by IngestExternalFile.
+class MemRawEngine : public RawEngine {
+ public:
+  MemRawEngine();
+  ~MemRawEngine() override;
+
+  MemRawEngine(const MemRawEngine& rhs) = delete;
+  MemRawEngine& operator=(const MemRawEngine& rhs) = delete;
+  MemRawEngine(MemRawEngine&& rhs) = delete;
+  MemRawEngine& operator=(MemRawEngine&& rhs) = delete;
+
+  std::shared_ptr<MemRawEngine> GetSelfPtr();
+
+  std::string GetName() override;
+  // Memory engine has no dedicated type, region of memory store engine keep the default raw engine type.
+  pb::common::RawEngine GetRawEngineType() override;
+
+  bool Init(std::shared_ptr<Config> config, const std::vector<std::string>& cf_names) override;
+  void Close() override;
+  void Destroy() override;
+
+  dingodb::SnapshotPtr GetSnapshot() override;
+
+  RawEngine::ReaderPtr Reader() override;
+  RawEngine::WriterPtr Writer() override;
+
+  RawEngine::CheckpointPtr NewCheckpoint() override;
+
+  butil::Status MergeCheckpointFiles(const std::string& path, const pb::common::Range& range,
+                                     const std::vector<std::string>& cf_names,
+                                     std::vector<std::string>& merge_sst_paths) override;
+
+  // Load sst files which generated by SaveFile.
+  butil::Status IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files) override;
+
+  // Serialize visible kvs of range to sst file, return ENO_ENTRIES when range is empty.
+  butil::Status SaveFile(const std::string& cf_name, const pb::common::Range& range, const std::string& filename);
+
+  void Flush(const std::string& cf_name) override;
+  // Drop all versions which no snapshot can read.
+  butil::Status Compact(const std::string& cf_name) override;
+
+  std::vector<int64_t> GetApproximateSizes(const std::string& cf_name, std::vector<pb::common::Range>& ranges) override;
+
+ private:
+  friend mem::Snapshot;
+  friend mem::Iterator;
+  friend mem::Reader;
+  friend mem::Writer;
+
+  struct WriteOp {
+    enum Type { kPut, kDelete, kDeleteRange };
+
+    Type type;
+    mem::ColumnFamilyPtr column_family;
+    const std::string* key{nullptr};
+    const std::string* value{nullptr};
+    const pb::common::Range* range{nullptr};
+  };
+
+  mem::ColumnFamilyPtr GetColumnFamily(const std::string& cf_name);
+
+  mem::SnapshotPtr NewSnapshot();
+  void ReleaseSnapshot(uint64_t seq);
+  // Oldest sequence still readable, must hold write lock.
+  uint64_t MinSnapshotSeq(uint64_t seq);
+
+  // Apply ops atomically with one sequence.
+  butil::Status Write(const std::vector<WriteOp>& ops);
+
+  mem::ColumnFamilyMap column_families_;
+
+  // Protect column families data and seq_.
+  RWLock rw_lock_;
+  uint64_t seq_{0};
+
+  bthread_mutex_t snapshot_mutex_;
+  std::multiset<uint64_t> snapshot_seqs_;
+
+  RawEngine::ReaderPtr reader_;
+  RawEngine::WriterPtr writer_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_MEM_RAW_ENGINE_H_  // NOLINT
@@ -0,0 +1,146 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "engine/mvcc_ttl_compaction_filter.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "brpc/reloadable_flags.h"
+#include "bvar/reducer.h"
+#include "common/gflag_validator.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/role.h"
+#include "engine/txn_gc_compaction_filter.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "metrics/store_bvar_metrics.h"
+#include "mvcc/codec.h"
+#include "server/server.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_mvcc_ttl_compaction_filter, false, "enable reclaim expired ttl versions of raw data in compaction");
+DEFINE_validator(enable_mvcc_ttl_compaction_filter, &PassBool);
+DEFINE_int64(mvcc_ttl_compaction_filter_delay_ms, 60 * 1000,
+             "only reclaim ttl version expired longer than this, tolerate clock drift of replicas");
+BRPC_VALIDATE_GFLAG(mvcc_ttl_compaction_filter_delay_ms, brpc::NonNegativeInteger);
+
+bvar::Adder<int64_t> g_mvcc_ttl_compaction_filter_expire_count("dingo_mvcc_ttl_compaction_filter_expire_count");
+bvar::Adder<int64_t> g_mvcc_ttl_compaction_filter_remove_count("dingo_mvcc_ttl_compaction_filter_remove_count");
+
+MvccTtlCompactionFilter::~MvccTtlCompactionFilter() { FlushExpiredBytes(); }
+
+void MvccTtlCompactionFilter::FlushExpiredBytes() const {
+  for (const auto& [region_id, bytes] : expired_bytes_) {
+    StoreBvarMetrics::GetInstance().IncExpiredTtlBytes(std::to_string(region_id), bytes);
+  }
+  expired_bytes_.clear();
+}
+
+void MvccTtlCompactionFilter::RecordExpiredBytes(const rocksdb::Slice& key, int64_t bytes) const {
+  std::string plain_key;
+  if (!mvcc::Codec::DecodeKey(std::string_view(key.data(), key.size()), plain_key)) {
+    return;
+  }
+
+  // keys come in order, region is searched only when key is out of last region.
+  if (region_id_ == 0 || plain_key < region_start_key_ || plain_key >= region_end_key_) {
+    region_id_ = 0;
+    auto store_meta_manager = Server::GetInstance().GetStoreMetaManager();
+    if (store_meta_manager == nullptr) {
+      return;
+    }
+    for (const auto& region : store_meta_manager->GetStoreRegionMeta()->GetAllAliveRegion()) {
+      auto range = region->Range(false);
+      if (plain_key >= range.start_key() && plain_key < range.end_key()) {
+        region_id_ = region->Id();
+        region_start_key_ = range.start_key();
+        region_end_key_ = range.end_key();
+        break;
+      }
+    }
+    if (region_id_ == 0) {
+      return;
+    }
+  }
+
+  expired_bytes_[region_id_] += bytes;
+}
+
+bool MvccTtlCompactionFilter::Filter(int /*level*/, const rocksdb::Slice& key, const rocksdb::Slice& existing_value,
+                                     std::string* new_value, bool* value_changed) const {
+  // not mvcc key or value
+  if (key.size() <= 8 || existing_value.empty()) {
+    return false;
+  }
+  std::string_view key_view(key.data(), key.size());
+  std::string_view value_view(existing_value.data(), existing_value.size());
+  uint8_t flag = static_cast<uint8_t>(value_view.back());
+  if (flag > static_cast<uint8_t>(mvcc::ValueFlag::kDelete)) {
+    return false;
+  }
+
+  auto encode_key = mvcc::Codec::TruncateTsForKey(key_view);
+  if (encode_key != last_encode_key_) {
+    last_encode_key_.assign(encode_key.data(), encode_key.size());
+    has_invisible_version_ = false;
+  }
+
+  if (has_invisible_version_) {
+    RecordExpiredBytes(key, key.size() + existing_value.size());
+    g_mvcc_ttl_compaction_filter_remove_count << 1;
+    return true;
+  }
+
+  bool is_expired = flag == static_cast<uint8_t>(mvcc::ValueFlag::kPutTTL) && value_view.size() > 9 &&
+                    mvcc::Codec::GetValueTTL(value_view) < expire_before_ms_;
+  if (is_expired) {
+    new_value->assign(1, static_cast<char>(mvcc::ValueFlag::kDelete));
+    *value_changed = true;
+    RecordExpiredBytes(key, existing_value.size() - 1);
+    g_mvcc_ttl_compaction_filter_expire_count << 1;
+  }
+
+  int64_t ts = mvcc::Codec::TruncateKeyForTs(key_view);
+  if (safe_point_ts_ > 0 && ts <= safe_point_ts_ &&
+      (is_expired || flag == static_cast<uint8_t>(mvcc::ValueFlag::kDelete))) {
+    has_invisible_version_ = true;
+  }
+
+  return false;
+}
+
+std::unique_ptr<rocksdb::CompactionFilter> MvccTtlCompactionFilterFactory::CreateCompactionFilter(
+    const rocksdb::CompactionFilter::Context& /*context*/) {
+  // data of index region is synced to vector/document index by gc, not reclaim here.
+  if (!FLAGS_enable_mvcc_ttl_compaction_filter || GetRole() != pb::common::ClusterRole::STORE) {
+    return nullptr;
+  }
+
+  // share safe point with txn gc compaction filter, 0 means not gc and only expired value is reclaimed.
+  int64_t safe_point_ts = TxnGcCompactionFilterFactory::GetSafePointTs();
+  int64_t expire_before_ms = Helper::TimestampMs() - FLAGS_mvcc_ttl_compaction_filter_delay_ms;
+
+  DINGO_LOG(DEBUG) << fmt::format("[mvcc_ttl] create compaction filter, safe_point_ts({}) expire_before_ms({})",
+                                  safe_point_ts, expire_before_ms);
+
+  return std::make_unique<MvccTtlCompactionFilter>(safe_point_ts, expire_before_ms);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,78 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_ENGINE_MVCC_TTL_COMPACTION_FILTER_H_
+#define DINGODB_ENGINE_MVCC_TTL_COMPACTION_FILTER_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "rocksdb/compaction_filter.h"
+#include "rocksdb/slice.h"
+
+namespace dingodb {
+
+// Reclaim expired ttl versions of raw mvcc data cf during compaction.
+// Expired ttl version is invisible and hide older versions like delete, so its value is replaced by delete flag
+// at any ts. Versions older than a delete/expired version(ts <= safe_point_ts) are dropped, same as gc, the newest
+// one seen in the same compaction is always kept.
+// Ttl is wall time, only version expired longer than delay is changed, so replicas change the same versions.
+class MvccTtlCompactionFilter : public rocksdb::CompactionFilter {
+ public:
+  MvccTtlCompactionFilter(int64_t safe_point_ts, int64_t expire_before_ms)
+      : safe_point_ts_(safe_point_ts), expire_before_ms_(expire_before_ms) {}
+  ~MvccTtlCompactionFilter() override;
+
+  bool Filter(int level, const rocksdb::Slice& key, const rocksdb::Slice& existing_value, std::string* new_value,
+              bool* value_changed) const override;
+
+  const char* Name() const override { return "MvccTtlCompactionFilter"; }
+
+ private:
+  // reclaimed bytes of key is counted to region contain it.
+  void RecordExpiredBytes(const rocksdb::Slice& key, int64_t bytes) const;
+  void FlushExpiredBytes() const;
+
+  int64_t safe_point_ts_;
+  int64_t expire_before_ms_;
+
+  // Compaction filter instance is used by one compaction thread, keys come in order.
+  mutable std::string last_encode_key_;
+  // Whether has seen delete/expired version(ts <= safe_point_ts) of last_encode_key_.
+  mutable bool has_invisible_version_{false};
+
+  // region range of last recorded key, region_id_ 0 means not found.
+  mutable int64_t region_id_{0};
+  mutable std::string region_start_key_;
+  mutable std::string region_end_key_;
+  mutable std::map<int64_t, int64_t> expired_bytes_;
+};
+
+class MvccTtlCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
+ public:
+  MvccTtlCompactionFilterFactory() = default;
+  ~MvccTtlCompactionFilterFactory() override = default;
+
+  std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
+      const rocksdb::CompactionFilter::Context& context) override;
+
+  const char* Name() const override { return "MvccTtlCompactionFilterFactory"; }
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_MVCC_TTL_COMPACTION_FILTER_H_
@@ -16,19 +16,25 @@
 
 #include <netinet/in.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "butil/compiler_specific.h"
 #include "butil/endpoint.h"
 #include "butil/status.h"
 #include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
+#include "bvar/status.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/role.h"
+#include "common/trace.h"
 #include "config/config_manager.h"
 #include "document/document_reader.h"
 #include "engine/engine.h"
@@ -56,12 +62,20 @@ DECLARE_int32(init_election_timeout_ms);
 
 namespace dingodb {
 
+DEFINE_int32(raft_recover_concurrency, 8, "concurrency of recover raft node on server starting");
+BRPC_VALIDATE_GFLAG(raft_recover_concurrency, brpc::PositiveInteger);
+
+bvar::Status<int64_t> g_raft_recover_total_region_count("dingo_raft_recover_total_region_count", 0);
+bvar::Adder<int64_t> g_raft_recover_finished_region_count("dingo_raft_recover_finished_region_count");
+
 RaftStoreEngine::RaftStoreEngine(RawEnginePtr rocks_raw_engine, RawEnginePtr bdb_raw_engine,
                                  mvcc::TsProviderPtr ts_provider)
     : rocks_raw_engine_(rocks_raw_engine),
       bdb_raw_engine_(bdb_raw_engine),
       raft_node_manager_(std::move(std::make_unique<RaftNodeManager>())),
-      ts_provider_(ts_provider) {}
+      ts_provider_(ts_provider) {
+  write_batcher_ = std::make_unique<RaftWriteBatcher>(raft_node_manager_.get());
+}
 
 RaftStoreEngine::~RaftStoreEngine() = default;
 
@@ -77,20 +91,136 @@ static bool CleanRaftDirectory(int64_t region_id, const std::string& raft_log_pa
   return Helper::RemoveAllFileOrDirectory(region_raft_log_path);
 }
 
+// Recover one raft node from region meta data.
+bool RaftStoreEngine::RecoverNode(store::RegionPtr region) {
+  auto store_raft_meta = Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta();
+  auto store_region_metrics = Server::GetInstance().GetStoreMetricsManager()->GetStoreRegionMetrics();
+
+  auto raft_meta = store_raft_meta->GetRaftMeta(region->Id());
+  if (raft_meta == nullptr) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.engine][region({})] recover raft meta not found.", region->Id());
+    return false;
+  }
+  auto region_metrics = store_region_metrics->GetMetrics(region->Id());
+  if (region_metrics == nullptr) {
+    DINGO_LOG(WARNING) << fmt::format("[raft.engine][region({})] recover raft metrics not found.", region->Id());
+  }
+
+  RaftControlAble::AddNodeParameter parameter;
+  parameter.role = GetRole();
+  parameter.is_restart = true;
+  parameter.raft_endpoint = Server::GetInstance().RaftEndpoint();
+
+  parameter.raft_path = Server::GetInstance().GetRaftPath();
+  // random election timeout for balance leader on restart
+  parameter.election_timeout_ms = FLAGS_init_election_timeout_ms +
+                                  Helper::GenerateRealRandomInteger(Constant::kRandomElectionTimeoutMinDeltaMs,
+                                                                    Constant::kRandomElectionTimeoutMaxDeltaMs);
+
+  parameter.raft_meta = raft_meta;
+  parameter.region_metrics = region_metrics;
+  parameter.listeners = StoreSmEventListenerFactory().Build();
+  parameter.apply_worker_set = Server::GetInstance().GetApplyWorkerSet();
+
+  AddNode(region, parameter);
+  if (region->NeedBootstrapDoSnapshot()) {
+    DINGO_LOG(INFO) << fmt::format("[raft.engine][region({})] need do snapshot.", region->Id());
+    auto node = GetNode(region->Id());
+    if (node != nullptr) {
+      auto ctx = std::make_shared<Context>();
+      ctx->SetRegionId(region->Id());
+      node->Snapshot(ctx, true);
+    }
+  }
+
+#if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
+  if (GetRole() == pb::common::INDEX) {
+    const auto& definition = region->Definition();
+    if (definition.index_parameter().vector_index_parameter().enable_scalar_speed_up_with_document()) {
+      auto document_index_wrapper = region->DocumentIndexWrapper();
+      if (document_index_wrapper != nullptr) {
+        DocumentIndexManager::LaunchLoadOrBuildDocumentIndex(document_index_wrapper, false, false, 0, "recover");
+      }
+    }
+  }
+#endif
+
+  if (GetRole() == pb::common::DOCUMENT) {
+    auto document_index_wrapper = region->DocumentIndexWrapper();
+    DocumentIndexManager::LaunchLoadOrBuildDocumentIndex(document_index_wrapper, false, false, 0, "recover");
+  }
+
+  return true;
+}
+
+// Sort regions by recover priority, region which was leader on this store before restart first,
+// then region which was written recently.
+static void SortRegionByRecoverPriority(std::vector<store::RegionPtr>& regions) {
+  auto store_region_metrics = Server::GetInstance().GetStoreMetricsManager()->GetStoreRegionMetrics();
+  int64_t store_id = Server::GetInstance().Id();
+
+  struct RecoverItem {
+    store::RegionPtr region;
+    bool is_leader;
+    int64_t last_update_time;
+  };
+
+  std::vector<RecoverItem> items;
+  items.reserve(regions.size());
+  for (auto& region : regions) {
+    auto region_metrics = store_region_metrics->GetMetrics(region->Id());
+    items.push_back({region, region->LeaderId() == store_id,
+                     region_metrics != nullptr ? region_metrics->LastUpdateMetricsTimestamp() : 0});
+  }
+
+  // stable sort keep shuffle order for same priority.
+  std::stable_sort(items.begin(), items.end(), [](const RecoverItem& lhs, const RecoverItem& rhs) {
+    if (lhs.is_leader != rhs.is_leader) {
+      return lhs.is_leader;
+    }
+    return lhs.last_update_time > rhs.last_update_time;
+  });
+
+  for (size_t i = 0; i < items.size(); ++i) {
+    regions[i] = items[i].region;
+  }
+}
+
+struct RecoverNodeArg {
+  RaftStoreEngine* engine;
+  std::vector<store::RegionPtr> regions;
+  std::atomic<int64_t> offset{0};
+  std::atomic<int64_t> count{0};
+};
+
+static void* RecoverNodeRoutine(void* arg) {
+  auto* recover_arg = static_cast<RecoverNodeArg*>(arg);
+  for (;;) {
+    int64_t offset = recover_arg->offset.fetch_add(1);
+    if (offset >= static_cast<int64_t>(recover_arg->regions.size())) {
+      break;
+    }
+
+    if (recover_arg->engine->RecoverNode(recover_arg->regions[offset])) {
+      recover_arg->count.fetch_add(1);
+      g_raft_recover_finished_region_count << 1;
+    }
+  }
+
+  return nullptr;
+}
+
 // Recover raft node from region meta data.
 // Invoke when server starting.
 bool RaftStoreEngine::Recover() {
   auto store_region_meta = GET_STORE_REGION_META;
-  auto store_raft_meta = Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta();
-  auto store_region_metrics = Server::GetInstance().GetStoreMetricsManager()->GetStoreRegionMetrics();
   auto regions = store_region_meta->GetAllRegion();
 
   // shuffle regions for balance leader on restart
   Helper::ShuffleVector(regions);
 
-  int count = 0;
-  auto ctx = std::make_shared<Context>();
-  auto listener_factory = std::make_shared<StoreSmEventListenerFactory>();
+  auto recover_arg = std::make_shared<RecoverNodeArg>();
+  recover_arg->engine = this;
   for (auto& region : regions) {
     if ((region->State() == pb::common::StoreRegionState::NORMAL ||
          region->State() == pb::common::StoreRegionState::STANDBY ||
@@ -98,65 +228,22 @@ bool RaftStoreEngine::Recover() {
          region->State() == pb::common::StoreRegionState::MERGING ||
          region->State() == pb::common::StoreRegionState::TOMBSTONE) &&
         region->GetStoreEngineType() == pb::common::StorageEngine::STORE_ENG_RAFT_STORE) {
-      auto raft_meta = store_raft_meta->GetRaftMeta(region->Id());
-      if (raft_meta == nullptr) {
-        DINGO_LOG(ERROR) << fmt::format("[raft.engine][region({})] recover raft meta not found.", region->Id());
-        continue;
-      }
-      auto region_metrics = store_region_metrics->GetMetrics(region->Id());
-      if (region_metrics == nullptr) {
-        DINGO_LOG(WARNING) << fmt::format("[raft.engine][region({})] recover raft metrics not found.", region->Id());
-      }
-
-      RaftControlAble::AddNodeParameter parameter;
-      parameter.role = GetRole();
-      parameter.is_restart = true;
-      parameter.raft_endpoint = Server::GetInstance().RaftEndpoint();
-
-      parameter.raft_path = Server::GetInstance().GetRaftPath();
-      // random election timeout for balance leader on restart
-      parameter.election_timeout_ms = FLAGS_init_election_timeout_ms +
-                                      Helper::GenerateRealRandomInteger(Constant::kRandomElectionTimeoutMinDeltaMs,
-                                                                        Constant::kRandomElectionTimeoutMaxDeltaMs);
-
-      parameter.raft_meta = raft_meta;
-      parameter.region_metrics = region_metrics;
-      parameter.listeners = listener_factory->Build();
-      parameter.apply_worker_set = Server::GetInstance().GetApplyWorkerSet();
-
-      AddNode(region, parameter);
-      if (region->NeedBootstrapDoSnapshot()) {
-        DINGO_LOG(INFO) << fmt::format("[raft.engine][region({})] need do snapshot.", region->Id());
-        auto node = GetNode(region->Id());
-        if (node != nullptr) {
-          auto ctx = std::make_shared<Context>();
-          ctx->SetRegionId(region->Id());
-          node->Snapshot(ctx, true);
-        }
-      }
-
-#if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
-      if (GetRole() == pb::common::INDEX) {
-        const auto& definition = region->Definition();
-        if (definition.index_parameter().vector_index_parameter().enable_scalar_speed_up_with_document()) {
-          auto document_index_wrapper = region->DocumentIndexWrapper();
-          if (document_index_wrapper != nullptr) {
-            DocumentIndexManager::LaunchLoadOrBuildDocumentIndex(document_index_wrapper, false, false, 0, "recover");
-          }
-        }
-      }
-#endif
+      recover_arg->regions.push_back(region);
+    }
+  }
 
-      if (GetRole() == pb::common::DOCUMENT) {
-        auto document_index_wrapper = region->DocumentIndexWrapper();
-        DocumentIndexManager::LaunchLoadOrBuildDocumentIndex(document_index_wrapper, false, false, 0, "recover");
-      }
+  SortRegionByRecoverPriority(recover_arg->regions);
+  g_raft_recover_total_region_count.set_value(recover_arg->regions.size());
 
-      ++count;
-    }
+  int64_t start_time = Helper::TimestampMs();
+  int concurrency = std::min(FLAGS_raft_recover_concurrency, static_cast<int>(recover_arg->regions.size()));
+  if (concurrency <= 1 || !Helper::ParallelRunTask(&RecoverNodeRoutine, recover_arg.get(), concurrency)) {
+    // Serial recover the rest regions.
+    RecoverNodeRoutine(recover_arg.get());
   }
 
-  DINGO_LOG(INFO) << fmt::format("[raft.engine][region(*)] recover Raft node num({}).", count);
+  DINGO_LOG(INFO) << fmt::format("[raft.engine][region(*)] recover Raft node num({}) concurrency({}) elapsed({}ms).",
+                                 recover_arg->count.load(), concurrency, Helper::TimestampMs() - start_time);
 
   return true;
 }
@@ -346,6 +433,14 @@ void RaftStoreEngine::DoSnapshotPeriodicity() {
   }
 }
 
+void RaftStoreEngine::DoHibernatePeriodicity() {
+  auto nodes = raft_node_manager_->GetAllNode();
+
+  for (auto& node : nodes) {
+    node->CheckHibernate();
+  }
+}
+
 butil::Status RaftStoreEngine::TransferLeader(int64_t region_id, const pb::common::Peer& peer) {
   auto node = raft_node_manager_->GetNode(region_id);
   if (node == nullptr) {
@@ -371,6 +466,11 @@ std::shared_ptr<pb::raft::RaftCmdRequest> GenRaftCmdRequest(const std::shared_pt
   pb::raft::RequestHeader* header = raft_cmd->mutable_header();
   header->set_region_id(ctx->RegionId());
   *header->mutable_epoch() = ctx->RegionEpoch();
+  // carry trace to follower, so its append and apply is in the same trace.
+  auto tracker = ctx->Tracker();
+  if (BAIDU_UNLIKELY(tracker != nullptr && tracker->IsSampled())) {
+    Tracer::Inject(tracker->GetTraceContext(), header);
+  }
 
   auto* requests = raft_cmd->mutable_requests();
   for (auto& datum : write_data->Datums()) {
@@ -391,6 +491,11 @@ butil::Status RaftStoreEngine::Write(std::shared_ptr<Context> ctx, std::shared_p
     return butil::Status(pb::error::ERAFT_NOT_FOUND, "Not found raft node");
   }
 
+  // Merge with concurrent write of the same region.
+  if (RaftWriteBatcher::IsBatchable(write_data)) {
+    return write_batcher_->Write(ctx, write_data);
+  }
+
   // CAUTION: sync mode cannot pass Done here
   CHECK(ctx->Done() == nullptr) << fmt::format("[raft.engine][region({})] sync mode cannot pass Done here.",
                                                ctx->RegionId());
@@ -23,6 +23,7 @@
 #include "common/meta_control.h"
 #include "common/runnable.h"
 #include "engine/engine.h"
+#include "engine/raft_write_batcher.h"
 #include "engine/raw_engine.h"
 #include "engine/snapshot.h"
 #include "event/event.h"
@@ -90,6 +91,8 @@ class RaftStoreEngine : public Engine, public RaftControlAble {
 
   bool Init(std::shared_ptr<Config> config) override;
   bool Recover() override;
+  // Recover one raft node on server starting, may be called concurrently.
+  bool RecoverNode(store::RegionPtr region);
 
   std::string GetName() override;
   pb::common::StorageEngine GetID() override;
@@ -112,6 +115,7 @@ class RaftStoreEngine : public Engine, public RaftControlAble {
   butil::Status SaveSnapshot(std::shared_ptr<Context> ctx, int64_t region_id, bool force) override;
   butil::Status AyncSaveSnapshot(std::shared_ptr<Context> ctx, int64_t region_id, bool force) override;
   void DoSnapshotPeriodicity();
+  void DoHibernatePeriodicity();
 
   butil::Status Write(std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data) override;
   butil::Status AsyncWrite(std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data) override;
@@ -300,6 +304,8 @@ class RaftStoreEngine : public Engine, public RaftControlAble {
   RawEnginePtr rocks_raw_engine_;  // RocksDB, the system engine, for meta and data
   RawEnginePtr bdb_raw_engine_;    // BDB, the engine for data
   std::unique_ptr<RaftNodeManager> raft_node_manager_;
+  // group commit for sync write
+  std::unique_ptr<RaftWriteBatcher> write_batcher_;
 
   mvcc::TsProviderPtr ts_provider_;
 };
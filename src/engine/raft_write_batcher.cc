@@ -0,0 +1,236 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/raft_write_batcher.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "brpc/reloadable_flags.h"
+#include "bthread/bthread.h"
+#include "bthread/mutex.h"
+#include "butil/compiler_specific.h"
+#include "bvar/recorder.h"
+#include "common/gflag_validator.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "engine/raft_store_engine.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+#include "proto/raft.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_raft_write_batch, false, "enable merge concurrent sync write of the same region into one raft log");
+DEFINE_validator(enable_raft_write_batch, &PassBool);
+DEFINE_int64(raft_write_batch_window_us, 50, "raft write batch leader wait window(us)");
+BRPC_VALIDATE_GFLAG(raft_write_batch_window_us, brpc::NonNegativeInteger);
+DEFINE_int32(raft_write_batch_max_count, 128, "raft write batch max merge write count");
+BRPC_VALIDATE_GFLAG(raft_write_batch_max_count, brpc::PositiveInteger);
+DEFINE_int64(raft_write_batch_max_bytes, 4 * 1024 * 1024, "raft write batch max merge bytes");
+BRPC_VALIDATE_GFLAG(raft_write_batch_max_bytes, brpc::PositiveInteger);
+DEFINE_int32(raft_write_batch_queue_num, 64, "raft write batch queue num");
+
+bvar::IntRecorder g_raft_write_batch_size("dingo_raft_store_engine_write_batch_size");
+
+RaftWriteBatcher::RaftWriteBatcher(RaftNodeManager* raft_node_manager) : raft_node_manager_(raft_node_manager) {
+  int32_t queue_num = std::max(FLAGS_raft_write_batch_queue_num, 1);
+  queues_.reserve(queue_num);
+  for (int32_t i = 0; i < queue_num; ++i) {
+    auto queue = std::make_unique<Queue>();
+    bthread_mutex_init(&queue->mutex, nullptr);
+    queues_.push_back(std::move(queue));
+  }
+}
+
+RaftWriteBatcher::~RaftWriteBatcher() {
+  for (auto& queue : queues_) {
+    bthread_mutex_destroy(&queue->mutex);
+  }
+}
+
+bool RaftWriteBatcher::IsBatchable(std::shared_ptr<WriteData> write_data) {
+  if (!FLAGS_enable_raft_write_batch) {
+    return false;
+  }
+
+  for (const auto& datum : write_data->Datums()) {
+    if (std::dynamic_pointer_cast<PutDatum>(datum) == nullptr &&
+        std::dynamic_pointer_cast<DeleteBatchDatum>(datum) == nullptr) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+int64_t RaftWriteBatcher::CalculateBytes(std::shared_ptr<WriteData> write_data) {
+  int64_t bytes = 0;
+  for (const auto& datum : write_data->Datums()) {
+    auto put_datum = std::dynamic_pointer_cast<PutDatum>(datum);
+    if (put_datum != nullptr) {
+      for (const auto& kv : put_datum->kvs) {
+        bytes += kv.key().size() + kv.value().size();
+      }
+      continue;
+    }
+
+    auto delete_batch_datum = std::dynamic_pointer_cast<DeleteBatchDatum>(datum);
+    if (delete_batch_datum != nullptr) {
+      for (const auto& key : delete_batch_datum->keys) {
+        bytes += key.size();
+      }
+    }
+  }
+
+  return bytes;
+}
+
+void RaftWriteBatcher::Notify(std::shared_ptr<Context> ctx, butil::Status status) {
+  ctx->SetStatus(status);
+  auto sync_mode_cond = ctx->SyncModeCond();
+  if (sync_mode_cond != nullptr) {
+    sync_mode_cond->DecreaseSignal();
+  }
+}
+
+RaftWriteBatcher::Queue& RaftWriteBatcher::GetQueue(int64_t region_id) {
+  return *queues_[static_cast<uint64_t>(region_id) % queues_.size()];
+}
+
+butil::Status RaftWriteBatcher::Write(std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data) {
+  // CAUTION: sync mode cannot pass Done here
+  CHECK(ctx->Done() == nullptr) << fmt::format("[raft.batcher][region({})] sync mode cannot pass Done here.",
+                                               ctx->RegionId());
+
+  auto sync_mode_cond = ctx->CreateSyncModeCond();
+
+  auto& queue = GetQueue(ctx->RegionId());
+  bool is_leader = false;
+  {
+    BAIDU_SCOPED_LOCK(queue.mutex);
+    queue.members.push_back(Member{ctx, write_data, CalculateBytes(write_data)});
+    if (!queue.has_leader) {
+      queue.has_leader = true;
+      is_leader = true;
+    }
+  }
+
+  if (is_leader) {
+    if (FLAGS_raft_write_batch_window_us > 0) {
+      bthread_usleep(FLAGS_raft_write_batch_window_us);
+    }
+
+    std::vector<Member> members;
+    {
+      BAIDU_SCOPED_LOCK(queue.mutex);
+      members.swap(queue.members);
+      queue.has_leader = false;
+    }
+
+    CommitMembers(members);
+  }
+
+  sync_mode_cond->IncreaseWait();
+
+  return ctx->Status();
+}
+
+void RaftWriteBatcher::CommitMembers(std::vector<Member>& members) {
+  // Queue is shared by regions, keep arrival order in the same region.
+  std::stable_sort(members.begin(), members.end(),
+                   [](const Member& lhs, const Member& rhs) { return lhs.ctx->RegionId() < rhs.ctx->RegionId(); });
+
+  std::vector<Member> group;
+  int64_t group_bytes = 0;
+  for (auto& member : members) {
+    if (!group.empty()) {
+      const auto& first_ctx = group.front().ctx;
+      if (first_ctx->RegionId() != member.ctx->RegionId() ||
+          !Helper::IsEqualRegionEpoch(first_ctx->RegionEpoch(), member.ctx->RegionEpoch()) ||
+          group.size() >= FLAGS_raft_write_batch_max_count ||
+          group_bytes + member.bytes > FLAGS_raft_write_batch_max_bytes) {
+        CommitGroup(group);
+        group.clear();
+        group_bytes = 0;
+      }
+    }
+
+    group_bytes += member.bytes;
+    group.push_back(std::move(member));
+  }
+
+  if (!group.empty()) {
+    CommitGroup(group);
+  }
+}
+
+void RaftWriteBatcher::CommitGroup(std::vector<Member>& group) {
+  g_raft_write_batch_size << group.size();
+
+  const auto& first_ctx = group.front().ctx;
+  auto node = raft_node_manager_->GetNode(first_ctx->RegionId());
+  if (BAIDU_UNLIKELY(node == nullptr)) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.batcher][region({})] not found raft node.", first_ctx->RegionId());
+    for (auto& member : group) {
+      Notify(member.ctx, butil::Status(pb::error::ERAFT_NOT_FOUND, "Not found raft node"));
+    }
+    return;
+  }
+
+  // Commit directly, ctx is notified by apply.
+  if (group.size() == 1) {
+    auto& member = group.front();
+    auto status = node->Commit(member.ctx, GenRaftCmdRequest(member.ctx, member.write_data));
+    if (BAIDU_UNLIKELY(!status.ok())) {
+      Notify(member.ctx, status);
+    }
+    return;
+  }
+
+  // Merge all write into one raft cmd, group_ctx has no sync mode cond, so write callback fan out result.
+  std::vector<std::shared_ptr<Context>> member_ctxs;
+  member_ctxs.reserve(group.size());
+
+  auto raft_cmd = GenRaftCmdRequest(first_ctx, group.front().write_data);
+  member_ctxs.push_back(first_ctx);
+  for (size_t i = 1; i < group.size(); ++i) {
+    auto* requests = raft_cmd->mutable_requests();
+    for (auto& datum : group[i].write_data->Datums()) {
+      requests->AddAllocated(datum->TransformToRaft());
+    }
+    member_ctxs.push_back(group[i].ctx);
+  }
+
+  auto group_ctx = std::make_shared<Context>();
+  group_ctx->SetRegionId(first_ctx->RegionId()).SetRegionEpoch(first_ctx->RegionEpoch());
+  group_ctx->SetWriteCb([member_ctxs](std::shared_ptr<Context>, butil::Status status) {
+    for (const auto& member_ctx : member_ctxs) {
+      Notify(member_ctx, status);
+    }
+  });
+
+  auto status = node->Commit(group_ctx, raft_cmd);
+  if (BAIDU_UNLIKELY(!status.ok())) {
+    for (const auto& member_ctx : member_ctxs) {
+      Notify(member_ctx, status);
+    }
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,78 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_RAFT_WRITE_BATCHER_H_  // NOLINT
+#define DINGODB_ENGINE_RAFT_WRITE_BATCHER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "bthread/types.h"
+#include "butil/status.h"
+#include "common/context.h"
+#include "engine/write_data.h"
+#include "raft/raft_node_manager.h"
+
+namespace dingodb {
+
+// Group commit for sync raft write.
+// The first writer of a queue become leader, wait a short window, then take all pending writers,
+// merge writes of the same region and epoch into one RaftCmdRequest, and fan out the apply result.
+// The next writer become the new leader once the pending writers were taken, so groups are pipelined.
+class RaftWriteBatcher {
+ public:
+  RaftWriteBatcher(RaftNodeManager* raft_node_manager);
+  ~RaftWriteBatcher();
+
+  RaftWriteBatcher(const RaftWriteBatcher& rhs) = delete;
+  RaftWriteBatcher& operator=(const RaftWriteBatcher& rhs) = delete;
+  RaftWriteBatcher(RaftWriteBatcher&& rhs) = delete;
+  RaftWriteBatcher& operator=(RaftWriteBatcher&& rhs) = delete;
+
+  // Only put/delete batch without response can merge.
+  static bool IsBatchable(std::shared_ptr<WriteData> write_data);
+
+  // Same as RaftStoreEngine::Write, block until apply.
+  butil::Status Write(std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data);
+
+ private:
+  struct Member {
+    std::shared_ptr<Context> ctx;
+    std::shared_ptr<WriteData> write_data;
+    int64_t bytes{0};
+  };
+
+  struct Queue {
+    bthread_mutex_t mutex;
+    bool has_leader{false};
+    std::vector<Member> members;
+  };
+
+  static int64_t CalculateBytes(std::shared_ptr<WriteData> write_data);
+  static void Notify(std::shared_ptr<Context> ctx, butil::Status status);
+
+  Queue& GetQueue(int64_t region_id);
+
+  // Split members to groups by region/epoch/limit, and commit every group.
+  void CommitMembers(std::vector<Member>& members);
+  void CommitGroup(std::vector<Member>& group);
+
+  RaftNodeManager* raft_node_manager_;
+  std::vector<std::unique_ptr<Queue>> queues_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_RAFT_WRITE_BATCHER_H_  // NOLINT
@@ -18,13 +18,16 @@
 #include <sys/types.h>
 
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "butil/status.h"
 #include "config/config.h"
 #include "engine/iterator.h"
+#include "engine/row_cache.h"
 #include "engine/snapshot.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
@@ -45,6 +48,14 @@ class RawEngine : public std::enable_shared_from_this<RawEngine> {
     virtual butil::Status KvGet(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
                                 const std::string& key, std::string& value) = 0;
 
+    // Batch point lookup, values and key_states are aligned with keys.
+    // key_states[i] is false when keys[i] is not found.
+    virtual butil::Status KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                     std::vector<std::string>& values, std::vector<bool>& key_states) = 0;
+    virtual butil::Status KvMultiGet(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
+                                     const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                     std::vector<bool>& key_states) = 0;
+
     virtual butil::Status KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                                  std::vector<pb::common::KeyValue>& kvs) = 0;
     virtual butil::Status KvScan(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
@@ -70,6 +81,16 @@ class RawEngine : public std::enable_shared_from_this<RawEngine> {
 
     virtual butil::Status KvPut(const std::string& cf_name, const pb::common::KeyValue& kv) = 0;
     virtual butil::Status KvBatchPut(const std::string& cf_name, const std::vector<pb::common::KeyValue>& kvs) = 0;
+    // Put kvs of raft log in place, engine can override it to avoid copy kvs to vector.
+    virtual butil::Status KvBatchPut(const std::string& cf_name,
+                                     const google::protobuf::RepeatedPtrField<pb::common::KeyValue>& kvs) {
+      return KvBatchPut(cf_name, std::vector<pb::common::KeyValue>(kvs.begin(), kvs.end()));
+    }
+    // Bulk load sorted and unique kvs by build sst file and ingest, skip memtable and wal.
+    // Fallback to KvBatchPut when engine not support.
+    virtual butil::Status KvBulkIngest(const std::string& cf_name, const std::vector<pb::common::KeyValue>& kvs) {
+      return KvBatchPut(cf_name, kvs);
+    }
 
     virtual butil::Status KvDelete(const std::string& cf_name, const std::string& key) = 0;
 
@@ -80,6 +101,42 @@ class RawEngine : public std::enable_shared_from_this<RawEngine> {
         const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_put_with_cfs,
         const std::map<std::string, std::vector<std::string>>& kv_delete_with_cfs) = 0;
 
+    // Put of raft log apply, kvs and keys point to raft cmd, not copied.
+    struct ApplyPut {
+      const std::string* cf_name{nullptr};
+      const google::protobuf::RepeatedPtrField<pb::common::KeyValue>* kvs{nullptr};
+      // Put keys with the same value, e.g. delete flag of mvcc.
+      const google::protobuf::RepeatedPtrField<std::string>* keys{nullptr};
+      const std::string* value{nullptr};
+    };
+    // Write puts of consecutive raft logs and meta kvs e.g. applied index in one write batch,
+    // so the applied index is persisted atomically with data.
+    // Engine can override it to build write batch from raft cmd directly.
+    virtual butil::Status KvBatchApply(const std::vector<ApplyPut>& puts, const std::string& meta_cf_name,
+                                       const std::vector<pb::common::KeyValue>& meta_kvs) {
+      std::map<std::string, std::vector<pb::common::KeyValue>> kv_puts_with_cf;
+      for (const auto& put : puts) {
+        auto& kv_puts = kv_puts_with_cf[*put.cf_name];
+        if (put.kvs != nullptr) {
+          kv_puts.insert(kv_puts.end(), put.kvs->begin(), put.kvs->end());
+        }
+        if (put.keys != nullptr) {
+          for (const auto& key : *put.keys) {
+            pb::common::KeyValue kv;
+            kv.set_key(key);
+            kv.set_value(*put.value);
+            kv_puts.push_back(std::move(kv));
+          }
+        }
+      }
+      if (!meta_kvs.empty()) {
+        auto& kv_puts = kv_puts_with_cf[meta_cf_name];
+        kv_puts.insert(kv_puts.end(), meta_kvs.begin(), meta_kvs.end());
+      }
+
+      return KvBatchPutAndDelete(kv_puts_with_cf, {});
+    }
+
     virtual butil::Status KvDeleteRange(const std::string& cf_name, const pb::common::Range& range) = 0;
     virtual butil::Status KvBatchDeleteRange(
         const std::map<std::string, std::vector<pb::common::Range>>& range_with_cfs) = 0;
@@ -125,6 +182,9 @@ class RawEngine : public std::enable_shared_from_this<RawEngine> {
 
   virtual CheckpointPtr NewCheckpoint() = 0;
 
+  // Row cache of data column family point read, nullptr means disable.
+  virtual RowCachePtr GetRowCache() { return nullptr; }
+
   // range is encode range
   virtual butil::Status MergeCheckpointFiles(const std::string& path, const pb::common::Range& range,
                                              const std::vector<std::string>& cf_names,
@@ -134,8 +194,33 @@ class RawEngine : public std::enable_shared_from_this<RawEngine> {
   virtual std::vector<int64_t> GetApproximateSizes(const std::string& cf_name,
                                                    std::vector<pb::common::Range>& ranges) = 0;
 
+  // Approximate key count of encode range from sst table properties and memtable stats, no data is read.
+  virtual butil::Status GetApproximateKeyCount(const std::string& /*cf_name*/, const pb::common::Range& /*range*/,
+                                               int64_t& /*count*/) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support approximate key count.");
+  }
+
+  // Approximate memory of block cache and memtables of all column family, 0 if not support.
+  virtual int64_t GetBlockCacheUsage() { return 0; }
+  virtual int64_t GetMemtableUsage() { return 0; }
+
+  // Key samples of range from sst metadata, pair of key and size of data before it, not in order.
+  virtual butil::Status GetKeySamples(const std::string& /*cf_name*/, const pb::common::Range& /*range*/,
+                                      std::vector<std::pair<std::string, int64_t>>& /*samples*/) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support key samples.");
+  }
+
+  // Switch column family tuning profile at runtime.
+  virtual butil::Status SetColumnFamilyProfile(const std::string& /*cf_name*/, const std::string& /*profile*/) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support column family profile.");
+  }
+
   virtual void Flush(const std::string& cf_name) = 0;
   virtual butil::Status Compact(const std::string& cf_name) = 0;
+  // Compact key range of column family, e.g. drop range tombstones after large delete range.
+  virtual butil::Status CompactRange(const std::string& /*cf_name*/, const pb::common::Range& /*range*/) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support compact range.");
+  }
 
  protected:
   RawEngine() = default;
@@ -0,0 +1,147 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "engine/resolved_ts.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "brpc/reloadable_flags.h"
+#include "bvar/reducer.h"
+#include "common/constant.h"
+#include "common/gflag_validator.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "engine/raft_store_engine.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "mvcc/codec.h"
+#include "proto/store.pb.h"
+#include "raft/raft_node.h"
+#include "server/server.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_resolved_ts, true, "advance resolved ts of txn leader region, read below it skip lock check");
+DEFINE_validator(enable_resolved_ts, &PassBool);
+DEFINE_int64(resolved_ts_max_scan_lock_count, 10000, "not advance resolved ts of region has more locks than this");
+BRPC_VALIDATE_GFLAG(resolved_ts_max_scan_lock_count, brpc::PositiveInteger);
+
+bvar::Adder<int64_t> g_resolved_ts_advance_count("dingo_resolved_ts_advance_count");
+bvar::Adder<int64_t> g_resolved_ts_too_many_lock_count("dingo_resolved_ts_too_many_lock_count");
+
+bool ResolvedTs::GetMinLockTs(RawEnginePtr raw_engine, store::RegionPtr region, int64_t& min_lock_ts) {
+  auto range = region->Range(false);
+  IteratorOptions iter_options;
+  iter_options.lower_bound = mvcc::Codec::EncodeKey(range.start_key(), Constant::kLockVer);
+  iter_options.upper_bound = mvcc::Codec::EncodeKey(range.end_key(), Constant::kLockVer);
+
+  auto iter = raw_engine->Reader()->NewIterator(Constant::kTxnLockCF, iter_options);
+  if (iter == nullptr) {
+    return false;
+  }
+
+  int64_t count = 0;
+  for (iter->Seek(iter_options.lower_bound); iter->Valid(); iter->Next()) {
+    if (++count > FLAGS_resolved_ts_max_scan_lock_count) {
+      g_resolved_ts_too_many_lock_count << 1;
+      return false;
+    }
+
+    auto lock_value = iter->Value();
+    pb::store::LockInfo lock_info;
+    if (!lock_info.ParseFromArray(lock_value.data(), lock_value.size())) {
+      DINGO_LOG(ERROR) << fmt::format("[resolved_ts][region({})] parse lock info failed, key: {}", region->Id(),
+                                      Helper::StringToHex(iter->Key()));
+      return false;
+    }
+    if (lock_info.lock_ts() > 0) {
+      min_lock_ts = std::min(min_lock_ts, lock_info.lock_ts());
+    }
+  }
+
+  return true;
+}
+
+int64_t ResolvedTs::Advance(RawEnginePtr raw_engine, store::RegionPtr region, int64_t ts) {
+  if (ts <= region->ResolvedTs()) {
+    return region->ResolvedTs();
+  }
+
+  // commit ts of async commit and 1pc prewrite after here is larger than ts.
+  region->SetTxnAccessMaxTs(ts);
+
+  // memory lock is checked before lock cf, it is removed after written to lock cf, so either is seen.
+  int64_t min_lock_ts = ts + 1;
+  std::map<std::string, pb::store::LockInfo> memory_locks;
+  region->GetMemoryLocks(memory_locks);
+  for (const auto& [key, lock_info] : memory_locks) {
+    if (lock_info.lock_ts() > 0) {
+      min_lock_ts = std::min(min_lock_ts, lock_info.lock_ts());
+    }
+  }
+
+  if (!GetMinLockTs(raw_engine, region, min_lock_ts)) {
+    return region->ResolvedTs();
+  }
+
+  region->SetResolvedTs(min_lock_ts - 1);
+  g_resolved_ts_advance_count << 1;
+
+  return region->ResolvedTs();
+}
+
+void ResolvedTs::AdvanceAll() {
+  if (!FLAGS_enable_resolved_ts) {
+    return;
+  }
+
+  auto raft_store_engine = Server::GetInstance().GetRaftStoreEngine();
+  auto ts_provider = Server::GetInstance().GetTsProvider();
+  if (raft_store_engine == nullptr || ts_provider == nullptr) {
+    return;
+  }
+
+  // one ts for all regions, it is got from tso before any lock is checked.
+  int64_t ts = ts_provider->GetTs();
+  if (ts <= 0) {
+    DINGO_LOG(WARNING) << "[resolved_ts] get ts from tso failed.";
+    return;
+  }
+
+  for (auto& region : Server::GetInstance().GetAllAliveRegion()) {
+    if (!region->IsTxn() || region->State() != pb::common::StoreRegionState::NORMAL) {
+      continue;
+    }
+    // consistent readable is set at leader start, after logs of previous term are applied,
+    // before it lock of those logs may not be in lock cf yet.
+    auto node = raft_store_engine->GetNode(region->Id());
+    if (node == nullptr || !node->IsLeader() || !node->ConsistentReadable()) {
+      continue;
+    }
+
+    auto raw_engine = Server::GetInstance().GetRawEngine(region->GetRawEngineType());
+    if (raw_engine == nullptr) {
+      continue;
+    }
+
+    int64_t resolved_ts = Advance(raw_engine, region, ts);
+    DINGO_LOG(DEBUG) << fmt::format("[resolved_ts][region({})] advance resolved ts: {}", region->Id(), resolved_ts);
+  }
+}
+
+}  // namespace dingodb
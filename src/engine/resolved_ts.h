@@ -0,0 +1,46 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_ENGINE_RESOLVED_TS_H_
+#define DINGODB_ENGINE_RESOLVED_TS_H_
+
+#include <cstdint>
+
+#include "engine/raw_engine.h"
+#include "meta/store_meta_manager.h"
+
+namespace dingodb {
+
+// Resolved ts of txn region: every txn which may commit at ts <= resolved ts has resolved, so read at
+// ts <= resolved ts needn't check lock, and it is the watermark for change consumer of the region.
+// Leader advances it periodically: take ts from tso, raise region max ts to it so later async commit and
+// 1pc commit ts are larger, then take min start ts of memory locks and lock cf, which are written by apply.
+// 2pc commit ts is got from tso after prewrite, so it is larger too. Resolved ts is reset on leader stop.
+class ResolvedTs {
+ public:
+  // advance resolved ts of all txn leader region, called periodically.
+  static void AdvanceAll();
+
+  // advance resolved ts of region with ts from tso, return new resolved ts.
+  static int64_t Advance(RawEnginePtr raw_engine, store::RegionPtr region, int64_t ts);
+
+ private:
+  // min lock ts of lock cf in region range, return false when too many locks to scan.
+  static bool GetMinLockTs(RawEnginePtr raw_engine, store::RegionPtr region, int64_t& min_lock_ts);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_RESOLVED_TS_H_
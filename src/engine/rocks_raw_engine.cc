@@ -16,29 +16,43 @@
 
 #include <elf.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <exception>
 #include <map>
 #include <memory>
+#include <set>
 #include <stdexcept>
 #include <string>
 #include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
+#include "bthread/mutex.h"
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
+#include "common/gflag_validator.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "config/config_helper.h"
+#include "engine/io_budget.h"
+#include "engine/key_sample_collector.h"
+#include "engine/mvcc_ttl_compaction_filter.h"
 #include "engine/raw_engine.h"
+#include "engine/row_cache.h"
 #include "engine/snapshot.h"
+#include "engine/txn_gc_compaction_filter.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
+#include "mvcc/codec.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "rocksdb/advanced_options.h"
@@ -47,12 +61,29 @@
 #include "rocksdb/filter_policy.h"
 #include "rocksdb/iterator.h"
 #include "rocksdb/rate_limiter.h"
+#include "rocksdb/statistics.h"
 #include "rocksdb/table.h"
 #include "rocksdb/write_batch.h"
 
 namespace dingodb {
 DEFINE_bool(enable_rocksdb_sync, false, "enable rocksdb sync");
 
+DEFINE_bool(enable_row_cache, false, "enable row cache for data column family point read");
+DEFINE_int64(row_cache_capacity_bytes, 1024 * 1024 * 1024, "row cache capacity(bytes)");
+DEFINE_int64(row_cache_region_capacity_bytes, 64 * 1024 * 1024, "row cache per region capacity(bytes), 0 is unlimited");
+DEFINE_int32(row_cache_shard_num, 64, "row cache shard num");
+
+DEFINE_bool(enable_rocksdb_shared_snapshot, true, "enable share snapshot to concurrent readers when no new write");
+DEFINE_validator(enable_rocksdb_shared_snapshot, &PassBool);
+
+DEFINE_bool(bulk_scan_fill_cache, false, "bulk scan e.g. coprocessor/backup/split check/gc fill block cache");
+DEFINE_validator(bulk_scan_fill_cache, &PassBool);
+DEFINE_int64(bulk_scan_readahead_bytes, 2 * 1024 * 1024, "readahead of bulk scan, 0 is adaptive readahead");
+BRPC_VALIDATE_GFLAG(bulk_scan_readahead_bytes, brpc::NonNegativeInteger);
+
+bvar::Adder<int64_t> g_rocksdb_shared_snapshot_hit_count("dingo_rocksdb_shared_snapshot_hit_count");
+bvar::Adder<int64_t> g_rocksdb_shared_snapshot_miss_count("dingo_rocksdb_shared_snapshot_miss_count");
+
 namespace rocks {
 
 ColumnFamily::ColumnFamily(const std::string& cf_name, const ColumnFamilyConfig& config,
@@ -165,13 +196,23 @@ butil::Status SstFileWriter::SaveFile(std::shared_ptr<dingodb::Iterator> iter, c
     return butil::Status(status.code(), status.ToString());
   }
 
+  // snapshot sst is charged to io budget every 1MB
+  constexpr int64_t kIoBudgetChargeBytes = 1024 * 1024;
+  int64_t uncharged_bytes = 0;
   for (; iter->Valid(); iter->Next()) {
     status = sst_writer_->Put(iter->Key(), iter->Value());
     if (!status.ok()) {
       sst_writer_->Finish();
       return butil::Status(status.code(), status.ToString());
     }
+
+    uncharged_bytes += iter->Key().size() + iter->Value().size();
+    if (uncharged_bytes >= kIoBudgetChargeBytes) {
+      IoBudget::GetInstance().Acquire(uncharged_bytes);
+      uncharged_bytes = 0;
+    }
   }
+  IoBudget::GetInstance().Acquire(uncharged_bytes);
 
   status = sst_writer_->Finish();
   if (!status.ok()) {
@@ -358,6 +399,63 @@ butil::Status Reader::KvGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr
     return butil::Status(pb::error::EINTERNAL, "Internal get error");
   }
 
+  RegionResourceAccounting::AddReadBytes(value.size());
+
+  return butil::Status();
+}
+
+butil::Status Reader::KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                 std::vector<std::string>& values, std::vector<bool>& key_states) {
+  return KvMultiGet(GetColumnFamily(cf_name), GetSnapshot(), keys, values, key_states);
+}
+
+butil::Status Reader::KvMultiGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                 std::vector<bool>& key_states) {
+  return KvMultiGet(GetColumnFamily(cf_name), snapshot, keys, values, key_states);
+}
+
+butil::Status Reader::KvMultiGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                 std::vector<bool>& key_states) {
+  values.clear();
+  key_states.clear();
+  if (keys.empty()) {
+    return butil::Status();
+  }
+
+  std::vector<rocksdb::Slice> key_slices;
+  key_slices.reserve(keys.size());
+  for (const auto& key : keys) {
+    if (BAIDU_UNLIKELY(key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] not support empty key.");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+    key_slices.emplace_back(key);
+  }
+
+  rocksdb::ReadOptions read_option;
+  read_option.async_io = true;
+  read_option.snapshot = static_cast<const rocksdb::Snapshot*>(snapshot->Inner());
+
+  std::vector<rocksdb::PinnableSlice> pinnable_values(keys.size());
+  std::vector<rocksdb::Status> statuses(keys.size());
+  GetDB()->MultiGet(read_option, column_family->GetHandle(), keys.size(), key_slices.data(), pinnable_values.data(),
+                    statuses.data(), false);
+
+  values.resize(keys.size());
+  key_states.resize(keys.size(), false);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    const auto& s = statuses[i];
+    if (s.ok()) {
+      values[i].assign(pinnable_values[i].data(), pinnable_values[i].size());
+      key_states[i] = true;
+    } else if (!s.IsNotFound()) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] multi get key failed, error: {}", s.ToString());
+      return butil::Status(pb::error::EINTERNAL, "Internal multi get error");
+    }
+  }
+
   return butil::Status();
 }
 
@@ -447,6 +545,35 @@ butil::Status Reader::KvCount(const std::string& cf_name, dingodb::SnapshotPtr s
   return KvCount(GetColumnFamily(cf_name), snapshot, start_key, end_key, count);
 }
 
+// count of bulk scan iterator by class, which bypass block cache by default.
+static void CountBulkScanIterator(ScanClass scan_class) {
+  static bvar::Adder<int64_t> scan_count("dingo_bulk_scan_iterator_scan_count");
+  static bvar::Adder<int64_t> coprocessor_count("dingo_bulk_scan_iterator_coprocessor_count");
+  static bvar::Adder<int64_t> backup_count("dingo_bulk_scan_iterator_backup_count");
+  static bvar::Adder<int64_t> split_check_count("dingo_bulk_scan_iterator_split_check_count");
+  static bvar::Adder<int64_t> gc_count("dingo_bulk_scan_iterator_gc_count");
+
+  switch (scan_class) {
+    case ScanClass::kScan:
+      scan_count << 1;
+      break;
+    case ScanClass::kCoprocessor:
+      coprocessor_count << 1;
+      break;
+    case ScanClass::kBackup:
+      backup_count << 1;
+      break;
+    case ScanClass::kSplitCheck:
+      split_check_count << 1;
+      break;
+    case ScanClass::kGc:
+      gc_count << 1;
+      break;
+    default:
+      break;
+  }
+}
+
 dingodb::IteratorPtr Reader::NewIterator(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot,
                                          IteratorOptions options) {
   IteratorOptionsPtr inner_option = std::make_shared<IteratorOptions>(options.lower_bound, options.upper_bound);
@@ -458,6 +585,17 @@ dingodb::IteratorPtr Reader::NewIterator(ColumnFamilyPtr column_family, dingodb:
   read_options.auto_prefix_mode = true;
   read_options.async_io = true;
   read_options.adaptive_readahead = true;
+  read_options.fill_cache = options.fill_cache;
+  if (options.readahead_size > 0) {
+    read_options.readahead_size = options.readahead_size;
+  }
+  if (options.scan_class != ScanClass::kNone) {
+    read_options.fill_cache = FLAGS_bulk_scan_fill_cache;
+    if (options.readahead_size == 0 && FLAGS_bulk_scan_readahead_bytes > 0) {
+      read_options.readahead_size = FLAGS_bulk_scan_readahead_bytes;
+    }
+    CountBulkScanIterator(options.scan_class);
+  }
   if (!inner_option->upper_bound.empty()) {
     inner_option->extension = new rocksdb::Slice(inner_option->upper_bound);
     read_options.iterate_upper_bound = (rocksdb::Slice*)inner_option->extension;
@@ -491,6 +629,59 @@ ColumnFamilyPtr Writer::GetColumnFamily(const std::string& cf_name) { return Get
 
 ColumnFamilyPtr Writer::GetDefaultColumnFamily() { return GetRawEngine()->GetDefaultColumnFamily(); }
 
+// Data column family key is encode key with ts, shorter key is not written by mvcc.
+static const size_t kRowCacheMinKeyLength = 9 + 8;
+
+template <typename KvContainer>
+void Writer::InvalidateRowCache(const std::string& cf_name, const KvContainer& kvs) {
+  auto row_cache = GetRawEngine()->GetRowCache();
+  if (row_cache == nullptr || cf_name != Constant::kStoreDataCF) {
+    return;
+  }
+
+  for (const auto& kv : kvs) {
+    if (kv.key().size() >= kRowCacheMinKeyLength) {
+      row_cache->Invalidate(mvcc::Codec::TruncateTsForKey(kv.key()));
+    }
+  }
+}
+
+void Writer::InvalidateRowCache(const std::string& cf_name, const std::vector<std::string>& keys) {
+  auto row_cache = GetRawEngine()->GetRowCache();
+  if (row_cache == nullptr || cf_name != Constant::kStoreDataCF) {
+    return;
+  }
+
+  for (const auto& key : keys) {
+    if (key.size() >= kRowCacheMinKeyLength) {
+      row_cache->Invalidate(mvcc::Codec::TruncateTsForKey(key));
+    }
+  }
+}
+
+void Writer::InvalidateRowCache(const std::string& cf_name,
+                                const google::protobuf::RepeatedPtrField<std::string>& keys) {
+  auto row_cache = GetRawEngine()->GetRowCache();
+  if (row_cache == nullptr || cf_name != Constant::kStoreDataCF) {
+    return;
+  }
+
+  for (const auto& key : keys) {
+    if (key.size() >= kRowCacheMinKeyLength) {
+      row_cache->Invalidate(mvcc::Codec::TruncateTsForKey(key));
+    }
+  }
+}
+
+void Writer::InvalidateRowCache(const std::string& cf_name, const pb::common::Range& range) {
+  auto row_cache = GetRawEngine()->GetRowCache();
+  if (row_cache == nullptr || cf_name != Constant::kStoreDataCF) {
+    return;
+  }
+
+  row_cache->InvalidateRange(range.start_key(), range.end_key());
+}
+
 butil::Status Writer::KvPut(const std::string& cf_name, const pb::common::KeyValue& kv) {
   if (BAIDU_UNLIKELY(kv.key().empty())) {
     DINGO_LOG(ERROR) << fmt::format("[rocksdb] not support empty key.");
@@ -507,10 +698,24 @@ butil::Status Writer::KvPut(const std::string& cf_name, const pb::common::KeyVal
     return butil::Status(pb::error::EINTERNAL, "Internal put error");
   }
 
+  RegionResourceAccounting::AddWriteBytes(kv.key().size() + kv.value().size());
+
+  InvalidateRowCache(cf_name, std::vector<std::string>{kv.key()});
+
   return butil::Status();
 }
 
 butil::Status Writer::KvBatchPut(const std::string& cf_name, const std::vector<pb::common::KeyValue>& kvs) {
+  return DoKvBatchPut(cf_name, kvs);
+}
+
+butil::Status Writer::KvBatchPut(const std::string& cf_name,
+                                 const google::protobuf::RepeatedPtrField<pb::common::KeyValue>& kvs) {
+  return DoKvBatchPut(cf_name, kvs);
+}
+
+template <typename KvContainer>
+butil::Status Writer::DoKvBatchPut(const std::string& cf_name, const KvContainer& kvs) {
   if (BAIDU_UNLIKELY(kvs.empty())) {
     DINGO_LOG(ERROR) << fmt::format("[rocksdb] not support empty keys.");
     return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
@@ -541,6 +746,67 @@ butil::Status Writer::KvBatchPut(const std::string& cf_name, const std::vector<p
     return butil::Status(pb::error::EINTERNAL, "Internal write error");
   }
 
+  RegionResourceAccounting::AddWriteBytes(batch.GetDataSize());
+
+  InvalidateRowCache(cf_name, kvs);
+
+  return butil::Status();
+}
+
+butil::Status Writer::KvBulkIngest(const std::string& cf_name, const std::vector<pb::common::KeyValue>& kvs) {
+  if (BAIDU_UNLIKELY(kvs.empty())) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] not support empty keys.");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  // sst file require strictly increasing key.
+  for (size_t i = 0; i < kvs.size(); ++i) {
+    if (BAIDU_UNLIKELY(kvs[i].key().empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] not support empty key.");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+    if (i > 0 && kvs[i - 1].key() >= kvs[i].key()) {
+      return KvBatchPut(cf_name, kvs);
+    }
+  }
+
+  auto raw_engine = GetRawEngine();
+  std::string dir_path = fmt::format("{}/bulk_ingest", raw_engine->DbPath());
+  if (!Helper::IsExistPath(dir_path)) {
+    auto status = Helper::CreateDirectories(dir_path);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("[rocksdb] create bulk ingest dir {} failed, error: {}, fallback batch put.",
+                                        dir_path, status.error_str());
+      return KvBatchPut(cf_name, kvs);
+    }
+  }
+
+  static std::atomic<int64_t> bulk_ingest_seq{0};
+  std::string sst_path = fmt::format("{}/{}_{}_{}.sst", dir_path, cf_name, Helper::TimestampNs(), ++bulk_ingest_seq);
+
+  auto status = RocksRawEngine::NewSstFileWriter()->SaveFile(kvs, sst_path);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[rocksdb] save bulk ingest sst {} failed, error: {}, fallback batch put.",
+                                      sst_path, status.error_str());
+    Helper::RemoveFileOrDirectory(sst_path);
+    return KvBatchPut(cf_name, kvs);
+  }
+
+  rocksdb::IngestExternalFileOptions options;
+  options.write_global_seqno = false;
+  options.move_files = true;
+  rocksdb::Status s = GetDB()->IngestExternalFile(GetColumnFamily(cf_name)->GetHandle(), {sst_path}, options);
+  if (Helper::IsExistPath(sst_path)) {
+    Helper::RemoveFileOrDirectory(sst_path);
+  }
+  if (!s.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[rocksdb] bulk ingest sst {} failed, error: {}, fallback batch put.", sst_path,
+                                      s.ToString());
+    return KvBatchPut(cf_name, kvs);
+  }
+
+  InvalidateRowCache(cf_name, kvs);
+
   return butil::Status();
 }
 
@@ -589,6 +855,11 @@ butil::Status Writer::KvBatchPutAndDelete(const std::string& cf_name,
     return butil::Status(pb::error::EINTERNAL, "Internal write error");
   }
 
+  RegionResourceAccounting::AddWriteBytes(batch.GetDataSize());
+
+  InvalidateRowCache(cf_name, kvs_to_put);
+  InvalidateRowCache(cf_name, keys_to_delete);
+
   return butil::Status();
 }
 
@@ -650,6 +921,90 @@ butil::Status Writer::KvBatchPutAndDelete(
     return butil::Status(pb::error::EINTERNAL, fmt::format("rocksdb::DB::Write failed : {}", s.ToString()));
   }
 
+  RegionResourceAccounting::AddWriteBytes(batch.GetDataSize());
+
+  for (const auto& [cf_name, kv_puts] : kv_puts_with_cf) {
+    InvalidateRowCache(cf_name, kv_puts);
+  }
+  for (const auto& [cf_name, kv_deletes] : kv_deletes_with_cf) {
+    InvalidateRowCache(cf_name, kv_deletes);
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status Writer::KvBatchApply(const std::vector<ApplyPut>& puts, const std::string& meta_cf_name,
+                                   const std::vector<pb::common::KeyValue>& meta_kvs) {
+  rocksdb::WriteBatch batch;
+  for (const auto& put : puts) {
+    auto column_family = GetColumnFamily(*put.cf_name);
+    if (put.kvs != nullptr) {
+      for (const auto& kv : *put.kvs) {
+        if (BAIDU_UNLIKELY(kv.key().empty())) {
+          DINGO_LOG(ERROR) << fmt::format("[rocksdb] key empty not support");
+          return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+        }
+
+        rocksdb::Status s = batch.Put(column_family->GetHandle(), kv.key(), kv.value());
+        if (BAIDU_UNLIKELY(!s.ok())) {
+          DINGO_LOG(ERROR) << fmt::format("[rocksdb] put failed, error: {}", s.ToString());
+          return butil::Status(pb::error::EINTERNAL, "Internal put error");
+        }
+      }
+    }
+
+    if (put.keys != nullptr) {
+      for (const auto& key : *put.keys) {
+        if (BAIDU_UNLIKELY(key.empty())) {
+          DINGO_LOG(ERROR) << fmt::format("[rocksdb] key empty not support");
+          return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+        }
+
+        rocksdb::Status s = batch.Put(column_family->GetHandle(), key, *put.value);
+        if (BAIDU_UNLIKELY(!s.ok())) {
+          DINGO_LOG(ERROR) << fmt::format("[rocksdb] put failed, error: {}", s.ToString());
+          return butil::Status(pb::error::EINTERNAL, "Internal put error");
+        }
+      }
+    }
+  }
+
+  if (!meta_kvs.empty()) {
+    auto column_family = GetColumnFamily(meta_cf_name);
+    for (const auto& kv : meta_kvs) {
+      rocksdb::Status s = batch.Put(column_family->GetHandle(), kv.key(), kv.value());
+      if (BAIDU_UNLIKELY(!s.ok())) {
+        DINGO_LOG(ERROR) << fmt::format("[rocksdb] put failed, error: {}", s.ToString());
+        return butil::Status(pb::error::EINTERNAL, "Internal put error");
+      }
+    }
+  }
+
+  if (BAIDU_UNLIKELY(batch.Count() == 0)) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] keys empty not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  rocksdb::WriteOptions write_options;
+  write_options.sync = FLAGS_enable_rocksdb_sync;
+
+  rocksdb::Status s = GetDB()->Write(write_options, &batch);
+  if (!s.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] write failed, error: {}", s.ToString());
+    return butil::Status(pb::error::EINTERNAL, fmt::format("rocksdb::DB::Write failed : {}", s.ToString()));
+  }
+
+  RegionResourceAccounting::AddWriteBytes(batch.GetDataSize());
+
+  for (const auto& put : puts) {
+    if (put.kvs != nullptr) {
+      InvalidateRowCache(*put.cf_name, *put.kvs);
+    }
+    if (put.keys != nullptr) {
+      InvalidateRowCache(*put.cf_name, *put.keys);
+    }
+  }
+
   return butil::Status::OK();
 }
 
@@ -669,6 +1024,8 @@ butil::Status Writer::KvDelete(const std::string& cf_name, const std::string& ke
     return butil::Status(pb::error::EINTERNAL, "Internal delete error");
   }
 
+  InvalidateRowCache(cf_name, std::vector<std::string>{key});
+
   return butil::Status();
 }
 
@@ -695,6 +1052,8 @@ butil::Status Writer::KvDeleteRange(const std::string& cf_name, const pb::common
     return butil::Status(pb::error::EINTERNAL, "Internal write error");
   }
 
+  InvalidateRowCache(cf_name, range);
+
   return butil::Status();
 }
 
@@ -726,16 +1085,28 @@ butil::Status Writer::KvBatchDeleteRange(const std::map<std::string, std::vector
     return butil::Status(pb::error::EINTERNAL, "Internal write error");
   }
 
+  for (const auto& [cf_name, ranges] : range_with_cfs) {
+    for (const auto& range : ranges) {
+      InvalidateRowCache(cf_name, range);
+    }
+  }
+
   return butil::Status();
 }
 
 }  // namespace rocks
 
-RocksRawEngine::RocksRawEngine() : db_(nullptr), column_families_({}) {}
+RocksRawEngine::RocksRawEngine() : db_(nullptr), column_families_({}) {
+  bthread_mutex_init(&profile_mutex_, nullptr);
+  bthread_mutex_init(&shared_snapshot_mutex_, nullptr);
+}
 
-RocksRawEngine::~RocksRawEngine() = default;
+RocksRawEngine::~RocksRawEngine() {
+  bthread_mutex_destroy(&profile_mutex_);
+  bthread_mutex_destroy(&shared_snapshot_mutex_);
+}
 
-static rocks::ColumnFamilyMap GenColumnFamilyByDefaultConfig(const std::vector<std::string>& column_family_names) {
+static rocks::ColumnFamily::ColumnFamilyConfig GenDefaultColumnFamilyConfig() {
   rocks::ColumnFamily::ColumnFamilyConfig default_config;
   default_config.emplace(Constant::kBlockSize, Constant::kBlockSizeDefaultValue);
   default_config.emplace(Constant::kBlockCache, ConfigHelper::GetBlockCacheValue());
@@ -748,6 +1119,94 @@ static rocks::ColumnFamilyMap GenColumnFamilyByDefaultConfig(const std::vector<s
   default_config.emplace(Constant::kMaxBytesForLevelBase, Constant::kMaxBytesForLevelBaseDefaultValue);
   default_config.emplace(Constant::kTargetFileSizeBase, Constant::kTargetFileSizeBaseDefaultValue);
   default_config.emplace(Constant::kMaxBytesForLevelMultiplier, Constant::kMaxBytesForLevelMultiplierDefaultValue);
+  default_config.emplace(Constant::kFilterPolicy, Constant::kFilterPolicyDefaultValue);
+  default_config.emplace(Constant::kFilterBitsPerKey, Constant::kFilterBitsPerKeyDefaultValue);
+  default_config.emplace(Constant::kPartitionFilters, Constant::kPartitionFiltersDefaultValue);
+  default_config.emplace(Constant::kCompactionStyle, Constant::kCompactionStyleDefaultValue);
+  default_config.emplace(Constant::kEnableBlobFiles, Constant::kEnableBlobFilesDefaultValue);
+  default_config.emplace(Constant::kMinBlobSize, Constant::kMinBlobSizeDefaultValue);
+  default_config.emplace(Constant::kBlobFileSize, Constant::kBlobFileSizeDefaultValue);
+  default_config.emplace(Constant::kBlobGarbageCollectionAgeCutoff,
+                         Constant::kBlobGarbageCollectionAgeCutoffDefaultValue);
+  default_config.emplace(Constant::kBlobGarbageCollectionForceThreshold,
+                         Constant::kBlobGarbageCollectionForceThresholdDefaultValue);
+  default_config.emplace(Constant::kColumnFamilyProfile, Constant::kColumnFamilyProfileDefaultValue);
+
+  return default_config;
+}
+
+// Column family tuning profiles, set by store.$cf_name.profile or ControlConfig.
+// The region prefix(1 byte) + partition id(8 bytes) is kPrefixExtractorMinLength bytes after mem-comparable encode.
+// default: keep default config.
+// point_lookup: small hot column family, e.g. lock.
+// append_only: append-mostly column family, e.g. write.
+// large_value: large value or big column family, e.g. vector_table, value is separated to blob files.
+static const std::map<std::string, rocks::ColumnFamily::ColumnFamilyConfig> kColumnFamilyProfiles = {
+    {"default", {}},
+    {"point_lookup",
+     {
+         {Constant::kBlockSize, "16384"},
+         {Constant::kFilterPolicy, "ribbon"},
+         {Constant::kFilterBitsPerKey, "12"},
+         {Constant::kPrefixExtractor, "10"},
+         {Constant::kWriteBufferSize, "33554432"},
+         {Constant::kTargetFileSizeBase, "33554432"},
+         {Constant::kCompactionStyle, "level"},
+     }},
+    {"append_only",
+     {
+         {Constant::kFilterPolicy, "bloom"},
+         {Constant::kPartitionFilters, "true"},
+         {Constant::kPrefixExtractor, "10"},
+         {Constant::kWriteBufferSize, "134217728"},
+         {Constant::kMaxCompactionBytes, "4294967296"},
+         {Constant::kCompactionStyle, "universal"},
+     }},
+    {"large_value",
+     {
+         {Constant::kBlockSize, "262144"},
+         {Constant::kFilterPolicy, "ribbon"},
+         {Constant::kPartitionFilters, "true"},
+         {Constant::kTargetFileSizeBase, "134217728"},
+         {Constant::kMaxBytesForLevelBase, "536870912"},
+         {Constant::kCompactionStyle, "level"},
+         {Constant::kEnableBlobFiles, "true"},
+     }},
+};
+
+// These config item can change by rocksdb::DB::SetOptions at runtime.
+static const std::set<std::string> kMutableColumnFamilyConfigItems = {
+    Constant::kWriteBufferSize,
+    Constant::kMaxWriteBufferNumber,
+    Constant::kMaxCompactionBytes,
+    Constant::kMaxBytesForLevelBase,
+    Constant::kTargetFileSizeBase,
+    Constant::kMaxBytesForLevelMultiplier,
+    Constant::kPrefixExtractor,
+    Constant::kEnableBlobFiles,
+    Constant::kMinBlobSize,
+    Constant::kBlobFileSize,
+    Constant::kBlobGarbageCollectionAgeCutoff,
+    Constant::kBlobGarbageCollectionForceThreshold,
+};
+
+static bool ApplyColumnFamilyProfile(const std::string& profile, rocks::ColumnFamily::ColumnFamilyConfig& config) {
+  auto it = kColumnFamilyProfiles.find(profile);
+  if (it == kColumnFamilyProfiles.end()) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] not found column family profile {}.", profile);
+    return false;
+  }
+
+  for (const auto& [name, value] : it->second) {
+    config[name] = value;
+  }
+  config[Constant::kColumnFamilyProfile] = profile;
+
+  return true;
+}
+
+static rocks::ColumnFamilyMap GenColumnFamilyByDefaultConfig(const std::vector<std::string>& column_family_names) {
+  auto default_config = GenDefaultColumnFamilyConfig();
 
   rocks::ColumnFamilyMap column_families;
   for (const auto& cf_name : column_family_names) {
@@ -757,19 +1216,20 @@ static rocks::ColumnFamilyMap GenColumnFamilyByDefaultConfig(const std::vector<s
   return column_families;
 }
 
-static void SetColumnFamilyCustomConfig(const std::shared_ptr<Config>& config,
-                                        rocks::ColumnFamilyMap& column_families) {
+// Config priority custom(store.$cf_name) > custom(store.base) > profile > default.
+static std::map<std::string, rocks::ColumnFamily::ColumnFamilyConfig> SetColumnFamilyCustomConfig(
+    const std::shared_ptr<Config>& config, rocks::ColumnFamilyMap& column_families) {
+  std::map<std::string, rocks::ColumnFamily::ColumnFamilyConfig> custom_configs;
+
   // store.base config
   const auto base_cf_config = config->GetStringMap(Constant::kBaseColumnFamily);
   auto base_column_family_names = config->GetStringList(Constant::kColumnFamilies);
   for (const auto& cf_name : base_column_family_names) {
-    auto it = column_families.find(cf_name);
-    if (it == column_families.end()) {
+    if (column_families.find(cf_name) == column_families.end()) {
       continue;
     }
-    auto& column_family = it->second;
     for (const auto& [name, value] : base_cf_config) {
-      column_family->SetConfItem(name, value);
+      custom_configs[cf_name][name] = value;
     }
   }
 
@@ -777,14 +1237,35 @@ static void SetColumnFamilyCustomConfig(const std::shared_ptr<Config>& config,
   for (auto& [cf_name, column_family] : column_families) {
     std::string config_item("store." + cf_name);
     const auto cf_config = config->GetStringMap(config_item);
-    if (cf_config.empty()) {
+    for (const auto& [name, value] : cf_config) {
+      custom_configs[cf_name][name] = value;
+    }
+  }
+
+  for (auto& [cf_name, column_family] : column_families) {
+    auto it = custom_configs.find(cf_name);
+    if (it == custom_configs.end()) {
       continue;
     }
 
-    for (const auto& [name, value] : cf_config) {
+    auto& custom_config = it->second;
+    auto profile_it = custom_config.find(Constant::kColumnFamilyProfile);
+    if (profile_it != custom_config.end()) {
+      rocks::ColumnFamily::ColumnFamilyConfig profile_config;
+      if (!ApplyColumnFamilyProfile(profile_it->second, profile_config)) {
+        custom_config.erase(profile_it);
+      }
+      for (const auto& [name, value] : profile_config) {
+        column_family->SetConfItem(name, value);
+      }
+    }
+
+    for (const auto& [name, value] : custom_config) {
       column_family->SetConfItem(name, value);
     }
   }
+
+  return custom_configs;
 }
 
 template <typename T>
@@ -868,12 +1349,22 @@ static rocksdb::ColumnFamilyOptions GenRocksDBColumnFamilyOptions(rocks::ColumnF
   CastValue(column_family->GetConfItem(Constant::kMaxBytesForLevelMultiplier),
             family_options.max_bytes_for_level_multiplier);
 
-  // prefix_extractor
+  // prefix_extractor, capped prefix of encoded key, 0 is disable.
+  // Mvcc point lookup seek user key with upper bound of its successor, so auto_prefix_mode check prefix bloom
+  // filter when user key is not shorter than prefix, e.g. 24 cover prefix/partition_id/vector_id of vector key.
   {
     size_t value = 0;
     CastValue(column_family->GetConfItem(Constant::kPrefixExtractor), value);
 
-    family_options.prefix_extractor.reset(rocksdb::NewCappedPrefixTransform(value));
+    if (value > 0) {
+      if (value < Constant::kPrefixExtractorMinLength) {
+        DINGO_LOG(WARNING) << fmt::format(
+            "[rocksdb] column family {} prefix extractor({}) is shorter than prefix of partition({}), "
+            "prefix bloom filter is useless.",
+            column_family->Name(), value, Constant::kPrefixExtractorMinLength);
+      }
+      family_options.prefix_extractor.reset(rocksdb::NewCappedPrefixTransform(value));
+    }
   }
 
   // max_bytes_for_level_base
@@ -889,12 +1380,64 @@ static rocksdb::ColumnFamilyOptions GenRocksDBColumnFamilyOptions(rocks::ColumnF
       rocksdb::CompressionType::kZSTD,
   };
 
-  table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10.0, false));
+  // blob files, key-value separation of large value, leveled compaction not rewrite it again and again.
+  // Mvcc gc delete old versions of value, its blobs become garbage when compaction drop the keys,
+  // and blob files which have much garbage are reclaimed by forced compaction.
+  family_options.enable_blob_files = column_family->GetConfItem(Constant::kEnableBlobFiles) == "true";
+  CastValue(column_family->GetConfItem(Constant::kMinBlobSize), family_options.min_blob_size);
+  CastValue(column_family->GetConfItem(Constant::kBlobFileSize), family_options.blob_file_size);
+  family_options.blob_compression_type = rocksdb::CompressionType::kLZ4Compression;
+  family_options.enable_blob_garbage_collection = true;
+  CastValue(column_family->GetConfItem(Constant::kBlobGarbageCollectionAgeCutoff),
+            family_options.blob_garbage_collection_age_cutoff);
+  CastValue(column_family->GetConfItem(Constant::kBlobGarbageCollectionForceThreshold),
+            family_options.blob_garbage_collection_force_threshold);
+
+  // filter_policy
+  {
+    std::string filter_policy;
+    CastValue(column_family->GetConfItem(Constant::kFilterPolicy), filter_policy);
+    double bits_per_key = 0;
+    CastValue(column_family->GetConfItem(Constant::kFilterBitsPerKey), bits_per_key);
+
+    if (filter_policy == "ribbon") {
+      table_options.filter_policy.reset(rocksdb::NewRibbonFilterPolicy(bits_per_key));
+    } else if (filter_policy == "bloom") {
+      table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(bits_per_key, false));
+    } else if (filter_policy != "none") {
+      DINGO_LOG(FATAL) << fmt::format("[rocksdb] not support filter policy {}.", filter_policy);
+    }
+  }
   table_options.whole_key_filtering = true;
 
+  // partition_filters, partitioned index and filters, only top level index stay in memory.
+  if (column_family->GetConfItem(Constant::kPartitionFilters) == "true") {
+    table_options.index_type = rocksdb::BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
+    table_options.partition_filters = true;
+    table_options.cache_index_and_filter_blocks = true;
+    table_options.cache_index_and_filter_blocks_with_high_priority = true;
+    table_options.pin_top_level_index_and_filter = true;
+  }
+
+  // compaction_style
+  {
+    std::string compaction_style;
+    CastValue(column_family->GetConfItem(Constant::kCompactionStyle), compaction_style);
+    if (compaction_style == "universal") {
+      family_options.compaction_style = rocksdb::CompactionStyle::kCompactionStyleUniversal;
+    } else if (compaction_style == "level") {
+      family_options.compaction_style = rocksdb::CompactionStyle::kCompactionStyleLevel;
+    } else {
+      DINGO_LOG(FATAL) << fmt::format("[rocksdb] not support compaction style {}.", compaction_style);
+    }
+  }
+
   rocksdb::TableFactory* table_factory = NewBlockBasedTableFactory(table_options);
   family_options.table_factory.reset(table_factory);
 
+  // key samples in table properties, for estimate split key.
+  family_options.table_properties_collector_factories.push_back(std::make_shared<KeySampleCollectorFactory>());
+
   return family_options;
 }
 
@@ -904,6 +1447,40 @@ rocksdb::DB* RocksRawEngine::InitDB(const std::string& db_path, rocks::ColumnFam
   for (auto [cf_name, column_family] : column_families) {
     column_family->Dump();
     rocksdb::ColumnFamilyOptions family_options = GenRocksDBColumnFamilyOptions(column_family);
+    if (!cold_path_.empty() && IsTieredColumnFamily(cf_name)) {
+      // Level which exceed hot path target size place at cold path.
+      family_options.cf_paths.emplace_back(db_path, hot_path_target_size_);
+      family_options.cf_paths.emplace_back(cold_path_, UINT64_MAX);
+      DINGO_LOG(INFO) << fmt::format("[rocksdb] column family {} enable tiered storage, hot path: {} cold path: {}",
+                                     cf_name, db_path, cold_path_);
+    }
+    if (cf_name == Constant::kTxnWriteCF && column_families.find(Constant::kTxnDataCF) != column_families.end()) {
+      family_options.compaction_filter_factory =
+          std::make_shared<TxnGcCompactionFilterFactory>([this](const std::vector<std::string>& data_keys) {
+            auto db = GetDB();
+            if (db == nullptr) {
+              return;
+            }
+
+            auto handle = GetColumnFamily(Constant::kTxnDataCF)->GetHandle();
+            rocksdb::WriteBatch batch;
+            for (const auto& data_key : data_keys) {
+              batch.Delete(handle, data_key);
+            }
+
+            // Not stall compaction thread, data left by failed delete only waste space.
+            rocksdb::WriteOptions write_options;
+            write_options.no_slowdown = true;
+            auto s = db->Write(write_options, &batch);
+            if (!s.ok()) {
+              DINGO_LOG(WARNING) << fmt::format("[rocksdb] txn gc delete data cf failed, count({}) error: {}",
+                                                data_keys.size(), s.ToString());
+            }
+          });
+    }
+    if (cf_name == Constant::kStoreDataCF) {
+      family_options.compaction_filter_factory = std::make_shared<MvccTtlCompactionFilterFactory>();
+    }
     column_family_descs.push_back(rocksdb::ColumnFamilyDescriptor(cf_name, family_options));
   }
 
@@ -914,7 +1491,9 @@ rocksdb::DB* RocksRawEngine::InitDB(const std::string& db_path, rocks::ColumnFam
   db_options.max_subcompactions = db_options.max_background_jobs / 4 * 3;
   db_options.stats_dump_period_sec = ConfigHelper::GetRocksDBStatsDumpPeriodSec();
   db_options.use_direct_io_for_flush_and_compaction = true;
-  db_options.statistics=rocksdb::CreateDBStatistics();
+  db_options.statistics = rocksdb::CreateDBStatistics();
+  // flush and compaction share io budget with snapshot
+  db_options.rate_limiter = IoBudget::GetInstance().GetRateLimiter();
 
   DINGO_LOG(INFO) << fmt::format("[rocksdb] config max_background_jobs({}) max_subcompactions({})",
                                  db_options.max_background_jobs, db_options.max_subcompactions);
@@ -953,9 +1532,26 @@ bool RocksRawEngine::Init(std::shared_ptr<Config> config, const std::vector<std:
   db_path_ = db_path;
   DINGO_LOG(INFO) << fmt::format("[rocksdb] db path: {}", db_path_);
 
-  // Column family config priority custom(store.$cf_name) > custom(store.base) > default.
+  std::string cold_path = config->GetString(Constant::kStoreColdPathConfigName);
+  if (!cold_path.empty()) {
+    cold_path_ = cold_path + "/rocksdb";
+    int64_t hot_path_target_size = config->GetInt64(Constant::kStoreHotPathTargetSizeConfigName);
+    hot_path_target_size_ = hot_path_target_size > 0 ? hot_path_target_size : Constant::kHotPathTargetSizeDefault;
+    if (!Helper::IsExistPath(cold_path_)) {
+      auto status = Helper::CreateDirectories(cold_path_);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << fmt::format("[rocksdb] create cold path {} failed, error: {}", cold_path_,
+                                        status.error_str());
+        return false;
+      }
+    }
+    DINGO_LOG(INFO) << fmt::format("[rocksdb] cold path: {} hot path target size: {}", cold_path_,
+                                   hot_path_target_size_);
+  }
+
+  // Column family config priority custom(store.$cf_name) > custom(store.base) > profile > default.
   auto column_families = GenColumnFamilyByDefaultConfig(cf_names);
-  SetColumnFamilyCustomConfig(config, column_families);
+  custom_configs_ = SetColumnFamilyCustomConfig(config, column_families);
 
   rocksdb::DB* db = InitDB(db_path_, column_families);
   if (db == nullptr) {
@@ -968,6 +1564,23 @@ bool RocksRawEngine::Init(std::shared_ptr<Config> config, const std::vector<std:
   reader_ = std::make_shared<rocks::Reader>(GetSelfPtr());
   writer_ = std::make_shared<rocks::Writer>(GetSelfPtr());
 
+  if (!cold_path_.empty()) {
+    hot_tier_bytes_ =
+        std::make_unique<bvar::PassiveStatus<int64_t>>("dingo_rocksdb_hot_tier_bytes", &GetHotTierBytes, this);
+    cold_tier_bytes_ =
+        std::make_unique<bvar::PassiveStatus<int64_t>>("dingo_rocksdb_cold_tier_bytes", &GetColdTierBytes, this);
+  }
+
+  ExposeBloomFilterMetrics();
+
+  if (FLAGS_enable_row_cache) {
+    row_cache_ = RowCache::New(FLAGS_row_cache_capacity_bytes, FLAGS_row_cache_region_capacity_bytes,
+                               FLAGS_row_cache_shard_num);
+    DINGO_LOG(INFO) << fmt::format("[rocksdb] enable row cache, capacity: {} region capacity: {} shard num: {}",
+                                   FLAGS_row_cache_capacity_bytes, FLAGS_row_cache_region_capacity_bytes,
+                                   FLAGS_row_cache_shard_num);
+  }
+
   DINGO_LOG(INFO) << fmt::format("[rocksdb] open success, path: {}", db_path_);
 
   return true;
@@ -983,6 +1596,64 @@ pb::common::RawEngine RocksRawEngine::GetRawEngineType() { return pb::common::Ra
 
 std::string RocksRawEngine::DbPath() { return db_path_; }
 
+bool RocksRawEngine::IsTieredColumnFamily(const std::string& cf_name) {
+  // lock column family is small and hot, always keep at hot path.
+  return cf_name == Constant::kStoreDataCF || cf_name == Constant::kTxnDataCF || cf_name == Constant::kTxnWriteCF;
+}
+
+int64_t RocksRawEngine::GetTierBytes(bool is_cold) {
+  auto db = db_;
+  if (db == nullptr) {
+    return 0;
+  }
+
+  std::vector<rocksdb::LiveFileMetaData> metadatas;
+  db->GetLiveFilesMetaData(&metadatas);
+
+  int64_t bytes = 0;
+  for (const auto& metadata : metadatas) {
+    if ((metadata.db_path == cold_path_) == is_cold) {
+      bytes += metadata.size;
+    }
+  }
+
+  return bytes;
+}
+
+void RocksRawEngine::ExposeBloomFilterMetrics() {
+  // whole key filter: useful is negative, full_positive is maybe exist, full_true_positive is really exist.
+  // prefix filter: prefix_checked is check count, prefix_useful is negative.
+  static const std::vector<std::pair<std::string, uint32_t>> kBloomFilterTickers = {
+      {"dingo_rocksdb_bloom_filter_useful", rocksdb::Tickers::BLOOM_FILTER_USEFUL},
+      {"dingo_rocksdb_bloom_filter_full_positive", rocksdb::Tickers::BLOOM_FILTER_FULL_POSITIVE},
+      {"dingo_rocksdb_bloom_filter_full_true_positive", rocksdb::Tickers::BLOOM_FILTER_FULL_TRUE_POSITIVE},
+      {"dingo_rocksdb_bloom_filter_prefix_checked", rocksdb::Tickers::BLOOM_FILTER_PREFIX_CHECKED},
+      {"dingo_rocksdb_bloom_filter_prefix_useful", rocksdb::Tickers::BLOOM_FILTER_PREFIX_USEFUL},
+  };
+
+  auto statistics = db_->GetDBOptions().statistics;
+  if (statistics == nullptr) {
+    return;
+  }
+
+  for (const auto& [name, ticker] : kBloomFilterTickers) {
+    auto metric = std::make_unique<TickerMetric>();
+    metric->statistics = statistics;
+    metric->ticker = ticker;
+    metric->status = std::make_unique<bvar::PassiveStatus<int64_t>>(name, &GetTickerCount, metric.get());
+    bloom_filter_metrics_.push_back(std::move(metric));
+  }
+}
+
+int64_t RocksRawEngine::GetTickerCount(void* arg) {
+  auto* metric = static_cast<TickerMetric*>(arg);
+  return static_cast<int64_t>(metric->statistics->getTickerCount(metric->ticker));
+}
+
+int64_t RocksRawEngine::GetHotTierBytes(void* arg) { return static_cast<RocksRawEngine*>(arg)->GetTierBytes(false); }
+
+int64_t RocksRawEngine::GetColdTierBytes(void* arg) { return static_cast<RocksRawEngine*>(arg)->GetTierBytes(true); }
+
 std::shared_ptr<rocksdb::DB> RocksRawEngine::GetDB() { return db_; }
 
 rocks::ColumnFamilyPtr RocksRawEngine::GetDefaultColumnFamily() { return GetColumnFamily(Constant::kStoreDataCF); }
@@ -1009,8 +1680,33 @@ std::vector<rocks::ColumnFamilyPtr> RocksRawEngine::GetColumnFamilies(const std:
   return column_families;
 }
 
+// Snapshot is shared only when no write happened after it was taken, so reader always see the latest data.
 dingodb::SnapshotPtr RocksRawEngine::GetSnapshot() {
-  return std::make_shared<rocks::Snapshot>(db_->GetSnapshot(), db_);
+  if (!FLAGS_enable_rocksdb_shared_snapshot) {
+    return std::make_shared<rocks::Snapshot>(db_->GetSnapshot(), db_);
+  }
+
+  uint64_t latest_seq = db_->GetLatestSequenceNumber();
+  {
+    BAIDU_SCOPED_LOCK(shared_snapshot_mutex_);
+    auto snapshot = shared_snapshot_.lock();
+    if (snapshot != nullptr && shared_snapshot_seq_ == latest_seq) {
+      g_rocksdb_shared_snapshot_hit_count << 1;
+      return snapshot;
+    }
+  }
+
+  const auto* inner_snapshot = db_->GetSnapshot();
+  auto snapshot = std::make_shared<rocks::Snapshot>(inner_snapshot, db_);
+  g_rocksdb_shared_snapshot_miss_count << 1;
+
+  BAIDU_SCOPED_LOCK(shared_snapshot_mutex_);
+  if (inner_snapshot->GetSequenceNumber() >= shared_snapshot_seq_ || shared_snapshot_.expired()) {
+    shared_snapshot_ = snapshot;
+    shared_snapshot_seq_ = inner_snapshot->GetSequenceNumber();
+  }
+
+  return snapshot;
 }
 
 RawEngine::ReaderPtr RocksRawEngine::Reader() { return reader_; }
@@ -1146,6 +1842,75 @@ butil::Status RocksRawEngine::IngestExternalFile(const std::string& cf_name, con
     return butil::Status(status.code(), status.ToString());
   }
 
+  // the key range of ingested files is unknown, drop all cached rows.
+  if (row_cache_ != nullptr && cf_name == Constant::kStoreDataCF) {
+    row_cache_->Clear();
+  }
+
+  return butil::Status();
+}
+
+butil::Status RocksRawEngine::SetColumnFamilyProfile(const std::string& cf_name, const std::string& profile) {
+  auto it = column_families_.find(cf_name);
+  if (it == column_families_.end()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Not found column family %s", cf_name.c_str());
+  }
+  auto& column_family = it->second;
+
+  // target config is default + profile + custom, same as init.
+  auto target_config = GenDefaultColumnFamilyConfig();
+  if (!ApplyColumnFamilyProfile(profile, target_config)) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Not found column family profile %s", profile.c_str());
+  }
+  auto custom_it = custom_configs_.find(cf_name);
+  if (custom_it != custom_configs_.end()) {
+    for (const auto& [name, value] : custom_it->second) {
+      if (name != Constant::kColumnFamilyProfile) {
+        target_config[name] = value;
+      }
+    }
+  }
+
+  BAIDU_SCOPED_LOCK(profile_mutex_);
+
+  std::unordered_map<std::string, std::string> mutable_options;
+  std::vector<std::string> immutable_items;
+  for (const auto& [name, value] : target_config) {
+    if (name == Constant::kColumnFamilyProfile || column_family->GetConfItem(name) == value) {
+      continue;
+    }
+
+    if (kMutableColumnFamilyConfigItems.count(name) == 0) {
+      immutable_items.push_back(name);
+    } else if (name == Constant::kPrefixExtractor) {
+      mutable_options.emplace(name, fmt::format("rocksdb.CappedPrefix.{}", value));
+    } else {
+      mutable_options.emplace(name, value);
+    }
+  }
+
+  if (!mutable_options.empty()) {
+    auto status = db_->SetOptions(column_family->GetHandle(), mutable_options);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] set column family {} profile {} failed, error: {}", cf_name, profile,
+                                      status.ToString());
+      return butil::Status(pb::error::EINTERNAL, "Set options failed, %s", status.ToString().c_str());
+    }
+
+    for (const auto& [name, _] : mutable_options) {
+      column_family->SetConfItem(name, target_config[name]);
+    }
+  }
+  column_family->SetConfItem(Constant::kColumnFamilyProfile, profile);
+
+  DINGO_LOG(INFO) << fmt::format("[rocksdb] set column family {} profile {}, changed options: {}", cf_name, profile,
+                                 mutable_options.size());
+  if (!immutable_items.empty()) {
+    DINGO_LOG(WARNING) << fmt::format(
+        "[rocksdb] column family {} profile {} items({}) can not change at runtime, set store.{}.profile and restart.",
+        cf_name, profile, Helper::VectorToString(immutable_items), cf_name);
+  }
+
   return butil::Status();
 }
 
@@ -1172,9 +1937,38 @@ butil::Status RocksRawEngine::Compact(const std::string& cf_name) {
   return butil::Status();
 }
 
-void RocksRawEngine::Destroy() { rocksdb::DestroyDB(db_path_, rocksdb::Options()); }
+butil::Status RocksRawEngine::CompactRange(const std::string& cf_name, const pb::common::Range& range) {
+  DINGO_LOG(INFO) << fmt::format("[rocksdb] compact column family {} range{}", cf_name, Helper::RangeToString(range));
+  if (db_ != nullptr) {
+    rocksdb::CompactRangeOptions options;
+    // Not block other manual compaction, range compaction is background work.
+    options.exclusive_manual_compaction = false;
+    options.bottommost_level_compaction = rocksdb::BottommostLevelCompaction::kForceOptimized;
+
+    rocksdb::Slice begin(range.start_key());
+    rocksdb::Slice end(range.end_key());
+    auto status = db_->CompactRange(options, GetColumnFamily(cf_name)->GetHandle(), &begin, &end);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] compact range failed, column family {} range{} error: {}", cf_name,
+                                      Helper::RangeToString(range), status.ToString());
+      return butil::Status(pb::error::EINTERNAL, "Compact column family %s range failed", cf_name.c_str());
+    }
+  }
+
+  return butil::Status();
+}
+
+void RocksRawEngine::Destroy() {
+  rocksdb::DestroyDB(db_path_, rocksdb::Options());
+  if (!cold_path_.empty()) {
+    Helper::RemoveAllFileOrDirectory(cold_path_);
+  }
+}
 
 void RocksRawEngine::Close() {
+  hot_tier_bytes_.reset();
+  cold_tier_bytes_.reset();
+
   if (db_) {
     CancelAllBackgroundWork(db_.get(), true);
 
@@ -1197,6 +1991,74 @@ void RocksRawEngine::Close() {
   DINGO_LOG(INFO) << fmt::format("[rocksdb] close db.");
 }
 
+butil::Status RocksRawEngine::GetKeySamples(const std::string& cf_name, const pb::common::Range& range,
+                                            std::vector<std::pair<std::string, int64_t>>& samples) {
+  rocksdb::Range inner_range(range.start_key(), range.end_key());
+  rocksdb::TablePropertiesCollection props;
+  auto status = db_->GetPropertiesOfTablesInRange(GetColumnFamily(cf_name)->GetHandle(), &inner_range, 1, &props);
+  if (!status.ok()) {
+    return butil::Status(pb::error::EINTERNAL, status.ToString());
+  }
+
+  for (const auto& [file_name, table_props] : props) {
+    const auto& user_props = table_props->user_collected_properties;
+    auto it = user_props.find(KeySampleCollector::kPropertyName);
+    if (it == user_props.end()) {
+      return butil::Status(pb::error::ENOT_SUPPORT, fmt::format("Not found key samples of sst {}.", file_name));
+    }
+
+    std::vector<KeySampleCollector::Sample> file_samples;
+    if (!KeySampleCollector::DecodeSamples(it->second, file_samples)) {
+      return butil::Status(pb::error::EINTERNAL, fmt::format("Decode key samples of sst {} failed.", file_name));
+    }
+    for (auto& sample : file_samples) {
+      if (sample.first >= range.start_key() && sample.first < range.end_key()) {
+        samples.push_back(std::move(sample));
+      }
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status RocksRawEngine::GetApproximateKeyCount(const std::string& cf_name, const pb::common::Range& range,
+                                                     int64_t& count) {
+  auto* handle = GetColumnFamily(cf_name)->GetHandle();
+  rocksdb::Range inner_range(range.start_key(), range.end_key());
+  rocksdb::TablePropertiesCollection props;
+  auto status = db_->GetPropertiesOfTablesInRange(handle, &inner_range, 1, &props);
+  if (!status.ok()) {
+    return butil::Status(pb::error::EINTERNAL, status.ToString());
+  }
+
+  uint64_t entries = 0;
+  uint64_t deletions = 0;
+  uint64_t file_size = 0;
+  for (const auto& [_, table_props] : props) {
+    entries += table_props->num_entries;
+    deletions += table_props->num_deletions;
+    file_size += table_props->data_size + table_props->index_size + table_props->filter_size;
+  }
+
+  // sst size of range, scaled by average live entry size of overlapped sst.
+  count = 0;
+  if (entries > deletions && file_size > 0) {
+    rocksdb::SizeApproximationOptions options;
+    options.include_memtables = false;
+    uint64_t range_size = 0;
+    db_->GetApproximateSizes(options, handle, &inner_range, 1, &range_size);
+    double live_entries = static_cast<double>(entries - deletions);
+    count = static_cast<int64_t>(live_entries * std::min(range_size, file_size) / file_size);
+  }
+
+  uint64_t memtable_count = 0;
+  uint64_t memtable_size = 0;
+  db_->GetApproximateMemTableStats(handle, inner_range, &memtable_count, &memtable_size);
+  count += static_cast<int64_t>(memtable_count);
+
+  return butil::Status::OK();
+}
+
 std::vector<int64_t> RocksRawEngine::GetApproximateSizes(const std::string& cf_name,
                                                          std::vector<pb::common::Range>& ranges) {
   rocksdb::SizeApproximationOptions options;
@@ -1219,4 +2081,15 @@ std::vector<int64_t> RocksRawEngine::GetApproximateSizes(const std::string& cf_n
   return result;
 }
 
+// block cache is not shared between column family, so sum of column family is total usage.
+int64_t RocksRawEngine::GetBlockCacheUsage() {
+  uint64_t value = 0;
+  return db_->GetAggregatedIntProperty(rocksdb::DB::Properties::kBlockCacheUsage, &value) ? value : 0;
+}
+
+int64_t RocksRawEngine::GetMemtableUsage() {
+  uint64_t value = 0;
+  return db_->GetAggregatedIntProperty(rocksdb::DB::Properties::kCurSizeAllMemTables, &value) ? value : 0;
+}
+
 }  // namespace dingodb
@@ -21,6 +21,9 @@
 #include <string>
 #include <vector>
 
+#include "bthread/types.h"
+#include "bvar/passive_status.h"
+#include "common/region_resource.h"
 #include "config/config.h"
 #include "engine/iterator.h"
 #include "engine/raw_engine.h"
@@ -93,19 +96,41 @@ class Iterator : public dingodb::Iterator {
 
   bool Valid() const override;
 
-  void SeekToFirst() override { iter_->SeekToFirst(); }
-  void SeekToLast() override { iter_->SeekToLast(); }
+  void SeekToFirst() override {
+    RegionResourceAccounting::AddSeekCount(1);
+    iter_->SeekToFirst();
+  }
+  void SeekToLast() override {
+    RegionResourceAccounting::AddSeekCount(1);
+    iter_->SeekToLast();
+  }
 
-  void Seek(const std::string& target) override { return iter_->Seek(target); }
+  void Seek(const std::string& target) override {
+    RegionResourceAccounting::AddSeekCount(1);
+    return iter_->Seek(target);
+  }
 
-  void SeekForPrev(const std::string& target) override { return iter_->SeekForPrev(target); }
+  void SeekForPrev(const std::string& target) override {
+    RegionResourceAccounting::AddSeekCount(1);
+    return iter_->SeekForPrev(target);
+  }
 
-  void Next() override { iter_->Next(); }
+  void Next() override {
+    RegionResourceAccounting::AddScanKeyCount(1);
+    iter_->Next();
+  }
 
-  void Prev() override { iter_->Prev(); }
+  void Prev() override {
+    RegionResourceAccounting::AddScanKeyCount(1);
+    iter_->Prev();
+  }
 
   std::string_view Key() const override { return std::string_view(iter_->key().data(), iter_->key().size()); }
-  std::string_view Value() const override { return std::string_view(iter_->value().data(), iter_->value().size()); }
+  std::string_view Value() const override {
+    auto value = iter_->value();
+    RegionResourceAccounting::AddReadBytes(value.size());
+    return std::string_view(value.data(), value.size());
+  }
 
   butil::Status Status() const override;
 
@@ -187,6 +212,12 @@ class Reader : public RawEngine::Reader {
   butil::Status KvGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
                       std::string& value) override;
 
+  butil::Status KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                           std::vector<std::string>& values, std::vector<bool>& key_states) override;
+  butil::Status KvMultiGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                           const std::vector<std::string>& keys, std::vector<std::string>& values,
+                           std::vector<bool>& key_states) override;
+
   butil::Status KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                        std::vector<pb::common::KeyValue>& kvs) override;
   butil::Status KvScan(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
@@ -211,6 +242,9 @@ class Reader : public RawEngine::Reader {
 
   butil::Status KvGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot, const std::string& key,
                       std::string& value);
+  butil::Status KvMultiGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot,
+                           const std::vector<std::string>& keys, std::vector<std::string>& values,
+                           std::vector<bool>& key_states);
   butil::Status KvScan(ColumnFamilyPtr column_family, std::shared_ptr<dingodb::Snapshot> snapshot,
                        const std::string& start_key, const std::string& end_key,
                        std::vector<pb::common::KeyValue>& kvs);
@@ -229,6 +263,9 @@ class Writer : public RawEngine::Writer {
 
   butil::Status KvPut(const std::string& cf_name, const pb::common::KeyValue& kv) override;
   butil::Status KvBatchPut(const std::string& cf_name, const std::vector<pb::common::KeyValue>& kvs) override;
+  butil::Status KvBatchPut(const std::string& cf_name,
+                           const google::protobuf::RepeatedPtrField<pb::common::KeyValue>& kvs) override;
+  butil::Status KvBulkIngest(const std::string& cf_name, const std::vector<pb::common::KeyValue>& kvs) override;
 
   butil::Status KvDelete(const std::string& cf_name, const std::string& key) override;
 
@@ -236,6 +273,8 @@ class Writer : public RawEngine::Writer {
                                     const std::vector<std::string>& keys_to_delete) override;
   butil::Status KvBatchPutAndDelete(const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_puts_with_cf,
                                     const std::map<std::string, std::vector<std::string>>& kv_deletes_with_cf) override;
+  butil::Status KvBatchApply(const std::vector<ApplyPut>& puts, const std::string& meta_cf_name,
+                             const std::vector<pb::common::KeyValue>& meta_kvs) override;
 
   butil::Status KvDeleteRange(const std::string& cf_name, const pb::common::Range& range) override;
   butil::Status KvBatchDeleteRange(
@@ -247,6 +286,16 @@ class Writer : public RawEngine::Writer {
   ColumnFamilyPtr GetColumnFamily(const std::string& cf_name);
   ColumnFamilyPtr GetDefaultColumnFamily();
 
+  template <typename KvContainer>
+  butil::Status DoKvBatchPut(const std::string& cf_name, const KvContainer& kvs);
+
+  // Invalidate row cache after write success.
+  template <typename KvContainer>
+  void InvalidateRowCache(const std::string& cf_name, const KvContainer& kvs);
+  void InvalidateRowCache(const std::string& cf_name, const std::vector<std::string>& keys);
+  void InvalidateRowCache(const std::string& cf_name, const google::protobuf::RepeatedPtrField<std::string>& keys);
+  void InvalidateRowCache(const std::string& cf_name, const pb::common::Range& range);
+
   std::weak_ptr<RocksRawEngine> raw_engine_;
 };
 
@@ -280,16 +329,27 @@ class RocksRawEngine : public RawEngine {
   static rocks::SstFileWriterPtr NewSstFileWriter();
   RawEngine::CheckpointPtr NewCheckpoint() override;
 
+  RowCachePtr GetRowCache() override { return row_cache_; }
+
   butil::Status MergeCheckpointFiles(const std::string& path, const pb::common::Range& range,
                                      const std::vector<std::string>& cf_names,
                                      std::vector<std::string>& merge_sst_paths) override;
 
   butil::Status IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files) override;
 
+  butil::Status SetColumnFamilyProfile(const std::string& cf_name, const std::string& profile) override;
+
   void Flush(const std::string& cf_name) override;
   butil::Status Compact(const std::string& cf_name) override;
+  butil::Status CompactRange(const std::string& cf_name, const pb::common::Range& range) override;
 
   std::vector<int64_t> GetApproximateSizes(const std::string& cf_name, std::vector<pb::common::Range>& ranges) override;
+  butil::Status GetApproximateKeyCount(const std::string& cf_name, const pb::common::Range& range,
+                                       int64_t& count) override;
+  int64_t GetBlockCacheUsage() override;
+  int64_t GetMemtableUsage() override;
+  butil::Status GetKeySamples(const std::string& cf_name, const pb::common::Range& range,
+                              std::vector<std::pair<std::string, int64_t>>& samples) override;
 
  private:
   friend rocks::Reader;
@@ -303,13 +363,46 @@ class RocksRawEngine : public RawEngine {
   rocks::ColumnFamilyPtr GetColumnFamily(const std::string& cf_name);
   std::vector<rocks::ColumnFamilyPtr> GetColumnFamilies(const std::vector<std::string>& cf_names);
 
+  // Tiered storage
+  static bool IsTieredColumnFamily(const std::string& cf_name);
+  // Sum of live sst file size, is_cold decide at cold path or hot path.
+  int64_t GetTierBytes(bool is_cold);
+  static int64_t GetHotTierBytes(void* arg);
+  static int64_t GetColdTierBytes(void* arg);
+
+  // Bloom filter usefulness from rocksdb statistics, e.g. mvcc point lookup use prefix bloom filter.
+  struct TickerMetric {
+    std::shared_ptr<rocksdb::Statistics> statistics;
+    uint32_t ticker{0};
+    std::unique_ptr<bvar::PassiveStatus<int64_t>> status;
+  };
+  void ExposeBloomFilterMetrics();
+  static int64_t GetTickerCount(void* arg);
+
   std::string db_path_;
+  // Empty is disable tiered storage.
+  std::string cold_path_;
+  uint64_t hot_path_target_size_{0};
+  std::unique_ptr<bvar::PassiveStatus<int64_t>> hot_tier_bytes_;
+  std::unique_ptr<bvar::PassiveStatus<int64_t>> cold_tier_bytes_;
+  std::vector<std::unique_ptr<TickerMetric>> bloom_filter_metrics_;
   std::shared_ptr<rocksdb::DB> db_;
   rocks::ColumnFamilyMap column_families_;
   std::shared_ptr<rocksdb::RateLimiter> rate_limiter_;
 
+  // custom config of store.base and store.$cf_name, keep for switch profile.
+  std::map<std::string, rocks::ColumnFamily::ColumnFamilyConfig> custom_configs_;
+  bthread_mutex_t profile_mutex_;
+
   RawEngine::ReaderPtr reader_;
   RawEngine::WriterPtr writer_;
+
+  RowCachePtr row_cache_;
+
+  // Share latest snapshot to concurrent readers until next write, reduce db mutex contention of GetSnapshot.
+  bthread_mutex_t shared_snapshot_mutex_;
+  std::weak_ptr<dingodb::Snapshot> shared_snapshot_;
+  uint64_t shared_snapshot_seq_{0};
 };
 
 }  // namespace dingodb
@@ -0,0 +1,266 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/row_cache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "bthread/mutex.h"
+#include "bvar/reducer.h"
+#include "common/helper.h"
+
+namespace dingodb {
+
+bvar::Adder<int64_t> g_row_cache_hit_count("dingo_row_cache_hit_count");
+bvar::Adder<int64_t> g_row_cache_miss_count("dingo_row_cache_miss_count");
+bvar::Adder<int64_t> g_row_cache_evict_count("dingo_row_cache_evict_count");
+bvar::Adder<int64_t> g_row_cache_memory_bytes("dingo_row_cache_memory_bytes");
+
+RowCache::RowCache(int64_t capacity, int64_t region_capacity, int32_t shard_num) : region_capacity_(region_capacity) {
+  shard_num = std::max(shard_num, 1);
+  shard_capacity_ = std::max(capacity / shard_num, static_cast<int64_t>(1));
+
+  shards_.reserve(shard_num);
+  for (int32_t i = 0; i < shard_num; ++i) {
+    auto shard = std::make_unique<Shard>();
+    bthread_mutex_init(&shard->mutex, nullptr);
+    shards_.push_back(std::move(shard));
+  }
+
+  bthread_mutex_init(&region_mutex_, nullptr);
+}
+
+RowCache::~RowCache() {
+  Clear();
+
+  for (auto& shard : shards_) {
+    bthread_mutex_destroy(&shard->mutex);
+  }
+  bthread_mutex_destroy(&region_mutex_);
+}
+
+RowCache::Shard& RowCache::GetShard(std::string_view encode_key) {
+  return *shards_[std::hash<std::string_view>{}(encode_key) % shards_.size()];
+}
+
+bool RowCache::Get(const std::string& encode_key, int64_t ts, std::string& value) {
+  auto& shard = GetShard(encode_key);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+
+  auto it = shard.index.find(encode_key);
+  if (it != shard.index.end()) {
+    for (auto entry_it : it->second) {
+      if (entry_it->ts != ts) {
+        continue;
+      }
+
+      if (entry_it->expire_ms > 0 && entry_it->expire_ms < Helper::TimestampMs()) {
+        break;
+      }
+
+      value = entry_it->value;
+      shard.lru.splice(shard.lru.begin(), shard.lru, entry_it);
+      g_row_cache_hit_count << 1;
+      return true;
+    }
+  }
+
+  g_row_cache_miss_count << 1;
+  return false;
+}
+
+uint64_t RowCache::GetSeq(const std::string& encode_key) {
+  auto& shard = GetShard(encode_key);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+  return shard.seq;
+}
+
+void RowCache::Put(int64_t region_id, const std::string& encode_key, int64_t ts, const std::string& value,
+                   int64_t expire_ms, uint64_t seq) {
+  int64_t charge = static_cast<int64_t>(encode_key.size() + value.size() + sizeof(Entry));
+  if (charge > shard_capacity_) {
+    return;
+  }
+
+  auto& shard = GetShard(encode_key);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+
+  // write happened between read engine and fill cache, the value maybe stale.
+  if (shard.seq != seq) {
+    return;
+  }
+
+  auto& entry_its = shard.index[encode_key];
+  for (auto entry_it : entry_its) {
+    if (entry_it->ts == ts) {
+      return;
+    }
+  }
+
+  if (!ChargeRegion(region_id, charge)) {
+    if (entry_its.empty()) {
+      shard.index.erase(encode_key);
+    }
+    return;
+  }
+
+  shard.lru.push_front(Entry{region_id, encode_key, ts, value, expire_ms, charge});
+  entry_its.push_back(shard.lru.begin());
+  shard.usage += charge;
+  g_row_cache_memory_bytes << charge;
+
+  while (shard.usage > shard_capacity_ && !shard.lru.empty()) {
+    EraseEntry(shard, std::prev(shard.lru.end()));
+    g_row_cache_evict_count << 1;
+  }
+}
+
+void RowCache::Invalidate(std::string_view encode_key) {
+  auto& shard = GetShard(encode_key);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+
+  ++shard.seq;
+  auto it = shard.index.find(encode_key);
+  if (it != shard.index.end()) {
+    EraseKey(shard, it);
+  }
+}
+
+void RowCache::InvalidateRange(const std::string& start_key, const std::string& end_key) {
+  for (auto& shard_ptr : shards_) {
+    auto& shard = *shard_ptr;
+
+    BAIDU_SCOPED_LOCK(shard.mutex);
+
+    ++shard.seq;
+    auto it = shard.index.lower_bound(start_key);
+    // start_key maybe include ts, so the previous key maybe its prefix.
+    if (it != shard.index.begin()) {
+      auto prev_it = std::prev(it);
+      if (start_key.compare(0, prev_it->first.size(), prev_it->first) == 0) {
+        it = prev_it;
+      }
+    }
+
+    while (it != shard.index.end() && it->first < end_key) {
+      auto erase_it = it++;
+      EraseKey(shard, erase_it);
+    }
+  }
+}
+
+void RowCache::Clear() {
+  for (auto& shard_ptr : shards_) {
+    auto& shard = *shard_ptr;
+
+    BAIDU_SCOPED_LOCK(shard.mutex);
+
+    ++shard.seq;
+    while (!shard.lru.empty()) {
+      EraseEntry(shard, shard.lru.begin());
+    }
+  }
+}
+
+int64_t RowCache::Size() {
+  int64_t size = 0;
+  for (auto& shard : shards_) {
+    BAIDU_SCOPED_LOCK(shard->mutex);
+    size += shard->lru.size();
+  }
+
+  return size;
+}
+
+int64_t RowCache::MemoryUsage() {
+  int64_t usage = 0;
+  for (auto& shard : shards_) {
+    BAIDU_SCOPED_LOCK(shard->mutex);
+    usage += shard->usage;
+  }
+
+  return usage;
+}
+
+int64_t RowCache::RegionMemoryUsage(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(region_mutex_);
+
+  auto it = region_usages_.find(region_id);
+  return it != region_usages_.end() ? it->second : 0;
+}
+
+void RowCache::EraseKey(Shard& shard,
+                        std::map<std::string, std::vector<EntryList::iterator>, std::less<>>::iterator it) {
+  auto entry_its = std::move(it->second);
+  shard.index.erase(it);
+
+  for (auto entry_it : entry_its) {
+    shard.usage -= entry_it->charge;
+    g_row_cache_memory_bytes << -entry_it->charge;
+    ReleaseRegion(entry_it->region_id, entry_it->charge);
+    shard.lru.erase(entry_it);
+  }
+}
+
+void RowCache::EraseEntry(Shard& shard, EntryList::iterator entry_it) {
+  auto it = shard.index.find(entry_it->encode_key);
+  if (it != shard.index.end()) {
+    auto& entry_its = it->second;
+    entry_its.erase(std::remove(entry_its.begin(), entry_its.end(), entry_it), entry_its.end());
+    if (entry_its.empty()) {
+      shard.index.erase(it);
+    }
+  }
+
+  shard.usage -= entry_it->charge;
+  g_row_cache_memory_bytes << -entry_it->charge;
+  ReleaseRegion(entry_it->region_id, entry_it->charge);
+  shard.lru.erase(entry_it);
+}
+
+bool RowCache::ChargeRegion(int64_t region_id, int64_t charge) {
+  BAIDU_SCOPED_LOCK(region_mutex_);
+
+  auto it = region_usages_.find(region_id);
+  int64_t usage = it != region_usages_.end() ? it->second : 0;
+  if (region_capacity_ > 0 && usage + charge > region_capacity_) {
+    return false;
+  }
+
+  region_usages_[region_id] = usage + charge;
+  return true;
+}
+
+void RowCache::ReleaseRegion(int64_t region_id, int64_t charge) {
+  BAIDU_SCOPED_LOCK(region_mutex_);
+
+  auto it = region_usages_.find(region_id);
+  if (it == region_usages_.end()) {
+    return;
+  }
+
+  it->second -= charge;
+  if (it->second <= 0) {
+    region_usages_.erase(it);
+  }
+}
+
+}  // namespace dingodb
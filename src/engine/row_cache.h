@@ -0,0 +1,112 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_ROW_CACHE_H_  // NOLINT
+#define DINGODB_ENGINE_ROW_CACHE_H_
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "bthread/types.h"
+
+namespace dingodb {
+
+// Row cache for hot point reads of the data column family.
+// Cache key is mvcc encode key(not include ts) + read ts, cache value is plain value.
+// All writes of the raw engine invalidate the touched keys after the write success,
+// a per-shard sequence guard the fill of a concurrent read miss.
+class RowCache {
+ public:
+  RowCache(int64_t capacity, int64_t region_capacity, int32_t shard_num);
+  ~RowCache();
+
+  RowCache(const RowCache& rhs) = delete;
+  RowCache& operator=(const RowCache& rhs) = delete;
+  RowCache(RowCache&& rhs) = delete;
+  RowCache& operator=(RowCache&& rhs) = delete;
+
+  static std::shared_ptr<RowCache> New(int64_t capacity, int64_t region_capacity, int32_t shard_num) {
+    return std::make_shared<RowCache>(capacity, region_capacity, shard_num);
+  }
+
+  // encode_key is mvcc encode key, not include ts.
+  bool Get(const std::string& encode_key, int64_t ts, std::string& value);
+
+  // Get the invalidate sequence before read the engine, and pass it to Put.
+  uint64_t GetSeq(const std::string& encode_key);
+  // expire_ms is ttl of value, 0 is never expire.
+  // Discard when encode_key was invalidated after GetSeq or the region exceed memory budget.
+  void Put(int64_t region_id, const std::string& encode_key, int64_t ts, const std::string& value, int64_t expire_ms,
+           uint64_t seq);
+
+  // encode_key is mvcc encode key, not include ts.
+  void Invalidate(std::string_view encode_key);
+  // [start_key, end_key) is encode range, key allow include ts or not.
+  void InvalidateRange(const std::string& start_key, const std::string& end_key);
+  void Clear();
+
+  int64_t Size();
+  int64_t MemoryUsage();
+  int64_t RegionMemoryUsage(int64_t region_id);
+
+ private:
+  struct Entry {
+    int64_t region_id;
+    std::string encode_key;
+    int64_t ts;
+    std::string value;
+    int64_t expire_ms;
+    int64_t charge;
+  };
+  using EntryList = std::list<Entry>;
+
+  struct Shard {
+    bthread_mutex_t mutex;
+    uint64_t seq{0};
+    int64_t usage{0};
+    // front is the most recently used
+    EntryList lru;
+    // encode_key -> all cached ts of the key
+    std::map<std::string, std::vector<EntryList::iterator>, std::less<>> index;
+  };
+
+  Shard& GetShard(std::string_view encode_key);
+
+  // Must hold shard mutex.
+  void EraseKey(Shard& shard, std::map<std::string, std::vector<EntryList::iterator>, std::less<>>::iterator it);
+  void EraseEntry(Shard& shard, EntryList::iterator entry_it);
+
+  bool ChargeRegion(int64_t region_id, int64_t charge);
+  void ReleaseRegion(int64_t region_id, int64_t charge);
+
+  int64_t shard_capacity_;
+  int64_t region_capacity_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  bthread_mutex_t region_mutex_;
+  // region_id -> memory usage
+  std::unordered_map<int64_t, int64_t> region_usages_;
+};
+using RowCachePtr = std::shared_ptr<RowCache>;
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_ROW_CACHE_H_  // NOLINT
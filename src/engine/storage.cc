@@ -14,26 +14,37 @@
 
 #include "engine/storage.h"
 
+#include <algorithm>
+#include <atomic>
 #include <climits>
 #include <cstdint>
 #include <limits>
+#include <map>
 #include <string>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
+#include "common/gflag_validator.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "document/codec.h"
 #include "document/document_index.h"
+#include "engine/lock_wait_manager.h"
 #include "engine/raft_store_engine.h"
+#include "engine/row_cache.h"
 #include "engine/snapshot.h"
 #include "engine/write_data.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "glog/logging.h"
 #include "meta/store_meta_manager.h"
+#include "metrics/store_metrics_manager.h"
 #include "mvcc/codec.h"
+#include "mvcc/reader.h"
 #include "mvcc/ts_provider.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
@@ -51,6 +62,24 @@ namespace dingodb {
 DECLARE_bool(region_enable_auto_split);
 DECLARE_bool(region_enable_auto_merge);
 
+DEFINE_bool(enable_follower_read, false, "enable follower serve mvcc read which ts not greater than applied max ts");
+DEFINE_validator(enable_follower_read, &PassBool);
+DEFINE_int32(txn_batch_resolve_lock_concurrency, 8, "concurrency of regions do batch resolve lock");
+BRPC_VALIDATE_GFLAG(txn_batch_resolve_lock_concurrency, brpc::PositiveInteger);
+
+DEFINE_bool(enable_vector_follower_read, false,
+            "enable follower which hold vector index serve vector search, so read scale with replica");
+DEFINE_validator(enable_vector_follower_read, &PassBool);
+DEFINE_int64(vector_follower_read_max_log_gap, 64, "max gap of committed and applied log of vector follower read");
+BRPC_VALIDATE_GFLAG(vector_follower_read_max_log_gap, brpc::NonNegativeInteger);
+DEFINE_bool(enable_approximate_count, false,
+            "vector and document count answer from region key count and engine statistics instead of scan range");
+DEFINE_validator(enable_approximate_count, &PassBool);
+
+bvar::Adder<uint64_t> g_follower_read_count("dingo_storage_follower_read_count");
+bvar::Adder<uint64_t> g_vector_follower_read_count("dingo_storage_vector_follower_read_count");
+bvar::Adder<uint64_t> g_approximate_count_count("dingo_storage_approximate_count_count");
+
 Storage::Storage(std::shared_ptr<Engine> raft_engine, std::shared_ptr<Engine> mono_engine,
                  mvcc::TsProviderPtr ts_provider)
     : raft_engine_(raft_engine), mono_engine_(mono_engine), ts_provider_(ts_provider) {}
@@ -170,6 +199,58 @@ butil::Status Storage::ValidateLeader(store::RegionPtr region) {
   return butil::Status();
 }
 
+butil::Status Storage::ValidateLeaderOrFollowerRead(int64_t region_id, int64_t ts) {
+  auto status = ValidateLeader(region_id);
+  if (status.ok() || status.error_code() != pb::error::ERAFT_NOTLEADER) {
+    return status;
+  }
+
+  if (!FLAGS_enable_follower_read || ts <= 0) {
+    return status;
+  }
+
+  // Follower ever applied write which ts not less than read ts, so the version visible at ts is complete.
+  auto region = Server::GetInstance().GetRegion(region_id);
+  if (region == nullptr || region->RawAppliedMaxTs() < ts) {
+    return status;
+  }
+
+  g_follower_read_count << 1;
+  return butil::Status();
+}
+
+butil::Status Storage::ValidateLeaderOrVectorFollowerRead(store::RegionPtr region) {
+  auto status = ValidateLeader(region);
+  if (status.ok() || status.error_code() != pb::error::ERAFT_NOTLEADER) {
+    return status;
+  }
+
+  if (!FLAGS_enable_vector_follower_read) {
+    return status;
+  }
+
+  auto vector_index_wrapper = region->VectorIndexWrapper();
+  if (vector_index_wrapper == nullptr || !vector_index_wrapper->IsReady() ||
+      vector_index_wrapper->IsBulkImportPending()) {
+    return status;
+  }
+
+  // follower without leader may be partitioned, its committed log is not trusted.
+  auto node = GetRaftStoreEngine()->GetNode(region->Id());
+  if (node == nullptr || node->GetLeaderId().is_empty()) {
+    return status;
+  }
+
+  auto raft_status = node->GetStatus();
+  if (raft_status == nullptr ||
+      raft_status->committed_index() - raft_status->known_applied_index() > FLAGS_vector_follower_read_max_log_gap) {
+    return status;
+  }
+
+  g_vector_follower_read_count << 1;
+  return butil::Status();
+}
+
 bool Storage::IsLeader(int64_t region_id) {
   auto region = Server::GetInstance().GetRegion(region_id);
   if (BAIDU_UNLIKELY(region == nullptr)) {
@@ -202,18 +283,68 @@ bool Storage::IsLeader(store::RegionPtr region) {
   return false;
 }
 
+// Point read through row cache, fill cache when miss.
+static butil::Status KvGetWithRowCache(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine, RowCachePtr row_cache,
+                                       const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs) {
+  auto reader = mvcc::KvReader::New(raw_engine->Reader());
+  int64_t ts = ctx->Ts() > 0 ? ctx->Ts() : INT64_MAX;
+
+  kvs.reserve(keys.size());
+  for (const auto& key : keys) {
+    if (BAIDU_UNLIKELY(key.empty())) {
+      kvs.clear();
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+
+    pb::common::KeyValue kv;
+    std::string encode_key = mvcc::Codec::EncodeBytes(key);
+    if (row_cache->Get(encode_key, ts, *kv.mutable_value())) {
+      kv.set_key(key);
+      kvs.emplace_back(std::move(kv));
+      continue;
+    }
+
+    uint64_t seq = row_cache->GetSeq(encode_key);
+    int64_t expire_ms = 0;
+    auto status = reader->KvGet(ctx->CfName(), ts, key, *kv.mutable_value(), expire_ms);
+    if (BAIDU_UNLIKELY(!status.ok())) {
+      if (pb::error::EKEY_NOT_FOUND == status.error_code()) {
+        continue;
+      }
+      kvs.clear();
+      return status;
+    }
+
+    row_cache->Put(ctx->RegionId(), encode_key, ts, kv.value(), expire_ms, seq);
+
+    kv.set_key(key);
+    kvs.emplace_back(std::move(kv));
+  }
+
+  return butil::Status();
+}
+
 butil::Status Storage::KvGet(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys,
                              std::vector<pb::common::KeyValue>& kvs) {
-  auto status = ValidateLeader(ctx->RegionId());
+  auto status = ValidateLeaderOrFollowerRead(ctx->RegionId(), ctx->Ts());
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
 
+  if (ctx->CfName() == Constant::kStoreDataCF) {
+    auto raw_engine = GetRawEngine(ctx->StoreEngineType(), ctx->RawEngineType());
+    auto row_cache = raw_engine->GetRowCache();
+    if (row_cache != nullptr) {
+      return KvGetWithRowCache(ctx, raw_engine, row_cache, keys, kvs);
+    }
+  }
+
   auto reader = GetEngineMVCCReader(ctx->StoreEngineType(), ctx->RawEngineType());
 
+  kvs.reserve(keys.size());
   for (const auto& key : keys) {
-    std::string value;
-    auto status = reader->KvGet(ctx->CfName(), ctx->Ts(), key, value);
+    pb::common::KeyValue kv;
+    auto status = reader->KvGet(ctx->CfName(), ctx->Ts(), key, *kv.mutable_value());
     if (BAIDU_UNLIKELY(!status.ok())) {
       if (pb::error::EKEY_NOT_FOUND == status.error_code()) {
         continue;
@@ -222,10 +353,8 @@ butil::Status Storage::KvGet(std::shared_ptr<Context> ctx, const std::vector<std
       return status;
     }
 
-    pb::common::KeyValue kv;
     kv.set_key(key);
-    kv.set_value(value);
-    kvs.emplace_back(kv);
+    kvs.emplace_back(std::move(kv));
   }
 
   return butil::Status();
@@ -554,7 +683,7 @@ butil::Status Storage::VectorDelete(std::shared_ptr<Context> ctx, bool is_sync,
 
 butil::Status Storage::VectorBatchQuery(std::shared_ptr<Engine::VectorReader::Context> ctx,
                                         std::vector<pb::common::VectorWithId>& vector_with_ids) {
-  auto status = ValidateLeader(ctx->region_id);
+  auto status = ValidateLeaderOrFollowerRead(ctx->region_id, ctx->ts);
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
@@ -576,7 +705,10 @@ butil::Status Storage::VectorBatchQuery(std::shared_ptr<Engine::VectorReader::Co
 
 butil::Status Storage::VectorBatchSearch(std::shared_ptr<Engine::VectorReader::Context> ctx,
                                          std::vector<pb::index::VectorWithDistanceResult>& results) {
-  auto status = ValidateLeader(ctx->region_id);
+  auto status = ValidateLeaderOrFollowerRead(ctx->region_id, ctx->ts);
+  if (status.error_code() == pb::error::ERAFT_NOTLEADER) {
+    status = ValidateLeaderOrVectorFollowerRead(Server::GetInstance().GetRegion(ctx->region_id));
+  }
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
@@ -647,12 +779,49 @@ butil::Status Storage::VectorGetRegionMetrics(store::RegionPtr region, VectorInd
   return butil::Status();
 }
 
+// Approximate count of plain range at latest version, ts is ignored.
+// Region key count is scaled by size of range in region, engine statistics is used when region key count is not
+// collected yet, which count all mvcc versions of range.
+butil::Status Storage::ApproximateCount(store::RegionPtr region, const std::string& cf_name,
+                                        const pb::common::Range& range, int64_t& count) {
+  auto raw_engine = GetRawEngine(region->GetStoreEngineType(), region->GetRawEngineType());
+  auto encode_range = mvcc::Codec::EncodeRange(range);
+
+  auto region_metrics =
+      Server::GetInstance().GetStoreMetricsManager()->GetStoreRegionMetrics()->GetMetrics(region->Id());
+  int64_t key_count = region_metrics != nullptr ? region_metrics->KeyCount() : 0;
+  if (key_count > 0) {
+    auto region_range = region->Range(false);
+    if (range.start_key() <= region_range.start_key() && range.end_key() >= region_range.end_key()) {
+      count = key_count;
+      return butil::Status::OK();
+    }
+
+    std::vector<pb::common::Range> ranges = {encode_range, mvcc::Codec::EncodeRange(region_range)};
+    auto sizes = raw_engine->GetApproximateSizes(cf_name, ranges);
+    if (sizes.size() == 2 && sizes[1] > 0) {
+      count = static_cast<int64_t>(static_cast<double>(key_count) * std::min(sizes[0], sizes[1]) / sizes[1]);
+      return butil::Status::OK();
+    }
+  }
+
+  return raw_engine->GetApproximateKeyCount(cf_name, encode_range, count);
+}
+
 butil::Status Storage::VectorCount(store::RegionPtr region, pb::common::Range range, int64_t ts, int64_t& count) {
   auto status = ValidateLeader(region);
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
 
+  if (FLAGS_enable_approximate_count) {
+    status = ApproximateCount(region, Constant::kVectorDataCF, range, count);
+    if (status.ok()) {
+      g_approximate_count_count << 1;
+      return status;
+    }
+  }
+
   auto vector_reader = GetEngineVectorReader(region->GetStoreEngineType(), region->GetRawEngineType());
 
   status = vector_reader->VectorCount(ts, range, count);
@@ -1518,6 +1687,14 @@ butil::Status Storage::DocumentCount(store::RegionPtr region, pb::common::Range
     return status;
   }
 
+  if (FLAGS_enable_approximate_count) {
+    status = ApproximateCount(region, Constant::kStoreDataCF, range, count);
+    if (status.ok()) {
+      g_approximate_count_count << 1;
+      return status;
+    }
+  }
+
   auto document_reader = GetEngineDocumentReader(region->GetStoreEngineType(), region->GetRawEngineType());
 
   status = document_reader->DocumentCount(ts, range, count);
@@ -1647,6 +1824,7 @@ butil::Status Storage::TxnPessimisticRollback(std::shared_ptr<Context> ctx, stor
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
+  LockWaitManager::GetInstance().WakeUp(start_ts);
 
   return butil::Status::OK();
 }
@@ -1697,6 +1875,7 @@ butil::Status Storage::TxnCommit(std::shared_ptr<Context> ctx, store::RegionPtr
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
+  LockWaitManager::GetInstance().WakeUp(start_ts);
 
   return butil::Status();
 }
@@ -1719,6 +1898,8 @@ butil::Status Storage::TxnCheckTxnStatus(std::shared_ptr<Context> ctx, const std
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
+  // lock may be rollback by ttl expired
+  LockWaitManager::GetInstance().WakeUp(lock_ts);
 
   return butil::Status();
 }
@@ -1759,10 +1940,90 @@ butil::Status Storage::TxnResolveLock(std::shared_ptr<Context> ctx, int64_t star
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
+  LockWaitManager::GetInstance().WakeUp(start_ts);
+  for (const auto& [txn_start_ts, _] : txn_infos) {
+    LockWaitManager::GetInstance().WakeUp(txn_start_ts);
+  }
 
   return butil::Status();
 }
 
+struct TxnBatchResolveLockArg {
+  Storage* storage{nullptr};
+  std::vector<std::pair<int64_t, const std::map<int64_t, int64_t>*>> region_txn_infos;
+  std::atomic<int64_t> offset{0};
+
+  // result of every region, index is same as region_txn_infos
+  std::vector<butil::Status> statuses;
+  std::vector<pb::store::TxnResultInfo> txn_results;
+};
+
+static void* TxnBatchResolveLockRoutine(void* arg) {
+  auto* resolve_arg = static_cast<TxnBatchResolveLockArg*>(arg);
+  for (;;) {
+    int64_t offset = resolve_arg->offset.fetch_add(1);
+    if (offset >= static_cast<int64_t>(resolve_arg->region_txn_infos.size())) {
+      break;
+    }
+
+    const auto& [region_id, txn_infos] = resolve_arg->region_txn_infos[offset];
+    auto region = Server::GetInstance().GetRegion(region_id);
+    if (region == nullptr) {
+      resolve_arg->statuses[offset] =
+          butil::Status(pb::error::Errno::EREGION_NOT_FOUND, fmt::format("Not found region {}", region_id));
+      continue;
+    }
+
+    pb::store::TxnResolveLockRequest request;
+    pb::store::TxnResolveLockResponse response;
+    auto ctx = std::make_shared<Context>(nullptr, nullptr, &request, &response);
+    ctx->SetRegionId(region_id);
+    ctx->SetCfName(Constant::kStoreDataCF);
+    ctx->SetRegionEpoch(region->Epoch());
+    ctx->SetRawEngineType(region->GetRawEngineType());
+    ctx->SetStoreEngineType(region->GetStoreEngineType());
+
+    resolve_arg->statuses[offset] = resolve_arg->storage->TxnResolveLock(ctx, 0, 0, {}, *txn_infos);
+    resolve_arg->txn_results[offset].Swap(response.mutable_txn_result());
+  }
+
+  return nullptr;
+}
+
+void Storage::TxnBatchResolveLock(const std::map<int64_t, std::map<int64_t, int64_t>>& region_txn_infos,
+                                  std::map<int64_t, butil::Status>& region_status,
+                                  std::map<int64_t, pb::store::TxnResultInfo>& txn_results) {
+  if (region_txn_infos.empty()) {
+    return;
+  }
+
+  auto resolve_arg = std::make_shared<TxnBatchResolveLockArg>();
+  resolve_arg->storage = this;
+  for (const auto& [region_id, txn_infos] : region_txn_infos) {
+    resolve_arg->region_txn_infos.emplace_back(region_id, &txn_infos);
+  }
+  resolve_arg->statuses.resize(region_txn_infos.size());
+  resolve_arg->txn_results.resize(region_txn_infos.size());
+
+  int64_t start_time = Helper::TimestampMs();
+  int concurrency =
+      std::min(FLAGS_txn_batch_resolve_lock_concurrency, static_cast<int>(resolve_arg->region_txn_infos.size()));
+  if (concurrency <= 1 || !Helper::ParallelRunTask(&TxnBatchResolveLockRoutine, resolve_arg.get(), concurrency)) {
+    TxnBatchResolveLockRoutine(resolve_arg.get());
+  }
+
+  for (size_t i = 0; i < resolve_arg->region_txn_infos.size(); ++i) {
+    int64_t region_id = resolve_arg->region_txn_infos[i].first;
+    region_status[region_id] = resolve_arg->statuses[i];
+    if (resolve_arg->txn_results[i].ByteSizeLong() > 0) {
+      txn_results[region_id].Swap(&resolve_arg->txn_results[i]);
+    }
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[txn] batch resolve lock finish, region count({}) concurrency({}) elapsed({}ms)",
+                                 region_txn_infos.size(), concurrency, Helper::TimestampMs() - start_time);
+}
+
 butil::Status Storage::TxnBatchRollback(std::shared_ptr<Context> ctx, int64_t start_ts,
                                         const std::vector<std::string>& keys) {
   auto status = ValidateLeader(ctx->RegionId());
@@ -1778,6 +2039,7 @@ butil::Status Storage::TxnBatchRollback(std::shared_ptr<Context> ctx, int64_t st
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
+  LockWaitManager::GetInstance().WakeUp(start_ts);
 
   return butil::Status();
 }
@@ -2051,6 +2313,16 @@ butil::Status Storage::BackupMeta(std::shared_ptr<Context> ctx, store::RegionPtr
                                      storage_backend, compression_type, compression_level, response);
 }
 
+static const std::string kColumnFamilyProfileVariablePrefix = "store.";
+static const std::string kColumnFamilyProfileVariableSuffix = ".profile";
+
+static bool IsColumnFamilyProfileVariable(const std::string& name) {
+  return name.size() > kColumnFamilyProfileVariablePrefix.size() + kColumnFamilyProfileVariableSuffix.size() &&
+         name.compare(0, kColumnFamilyProfileVariablePrefix.size(), kColumnFamilyProfileVariablePrefix) == 0 &&
+         name.compare(name.size() - kColumnFamilyProfileVariableSuffix.size(), kColumnFamilyProfileVariableSuffix.size(),
+                      kColumnFamilyProfileVariableSuffix) == 0;
+}
+
 butil::Status Storage::ControlConfig(std::shared_ptr<Context> /*ctx*/,
                                      const std::vector<pb::common::ControlConfigVariable>& variables,
                                      dingodb::pb::store::ControlConfigResponse* response) {
@@ -2063,6 +2335,19 @@ butil::Status Storage::ControlConfig(std::shared_ptr<Context> /*ctx*/,
       Helper::HandleBoolControlConfigVariable(variable, config, FLAGS_region_enable_auto_split);
     } else if ("FLAGS_region_enable_auto_merge" == variable.name()) {
       Helper::HandleBoolControlConfigVariable(variable, config, FLAGS_region_enable_auto_merge);
+    } else if (IsColumnFamilyProfileVariable(variable.name())) {
+      // store.$cf_name.profile
+      std::string cf_name = variable.name().substr(
+          kColumnFamilyProfileVariablePrefix.size(),
+          variable.name().size() - kColumnFamilyProfileVariablePrefix.size() - kColumnFamilyProfileVariableSuffix.size());
+      auto status = Server::GetInstance().GetRawEngine(pb::common::RAW_ENG_ROCKSDB)->SetColumnFamilyProfile(
+          cf_name, variable.value());
+      config.set_is_already_set(false);
+      config.set_is_error_occurred(!status.ok());
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << fmt::format("ControlConfig set column family {} profile {} failed, error: {}", cf_name,
+                                        variable.value(), status.error_str());
+      }
     } else {
       config.set_is_already_set(false);
       config.set_is_error_occurred(true);
@@ -122,6 +122,11 @@ class Storage {
                                        const std::vector<std::string>& keys);
   butil::Status TxnResolveLock(std::shared_ptr<Context> ctx, int64_t start_ts, int64_t commit_ts,
                                const std::vector<std::string>& keys, const std::map<int64_t, int64_t>& txn_infos);
+  // Resolve locks of many regions on this store in parallel, region_txn_infos is region_id: (start_ts: commit_ts).
+  // region_status is status of every region, txn_results is set when region meet lock can't be resolved.
+  void TxnBatchResolveLock(const std::map<int64_t, std::map<int64_t, int64_t>>& region_txn_infos,
+                           std::map<int64_t, butil::Status>& region_status,
+                           std::map<int64_t, pb::store::TxnResultInfo>& txn_results);
   butil::Status TxnHeartBeat(std::shared_ptr<Context> ctx, const std::string& primary_lock, int64_t start_ts,
                              int64_t advise_lock_ttl);
   butil::Status TxnGc(std::shared_ptr<Context> ctx, int64_t safe_point_ts);
@@ -231,6 +236,11 @@ class Storage {
 
   butil::Status ValidateLeader(int64_t region_id);
   butil::Status ValidateLeader(store::RegionPtr region);
+  // Follower read: a follower can serve mvcc read at ts when it has applied raft log which ts not less than read ts.
+  butil::Status ValidateLeaderOrFollowerRead(int64_t region_id, int64_t ts);
+  // Vector follower read: a follower which hold ready vector index serve search when its apply lag of raft log is
+  // within vector_follower_read_max_log_gap, result may be stale.
+  butil::Status ValidateLeaderOrVectorFollowerRead(store::RegionPtr region);
   bool IsLeader(int64_t region_id);
   bool IsLeader(store::RegionPtr region);
 
@@ -265,6 +275,9 @@ class Storage {
                             const dingodb::pb::common::BackupDataFileValueSstMetaGroup& sst_metas);
 
  private:
+  butil::Status ApproximateCount(store::RegionPtr region, const std::string& cf_name, const pb::common::Range& range,
+                                 int64_t& count);
+
   std::shared_ptr<Engine> raft_engine_;
   std::shared_ptr<Engine> mono_engine_;
 
@@ -17,30 +17,39 @@
 #include <openssl/sha.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
+#include "bthread/bthread.h"
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
 #include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
 #include "common/gflag_validator.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/probe.h"
+#include "common/role.h"
 #include "common/stream.h"
 #include "common/uuid.h"
 #include "coprocessor/coprocessor_v2.h"
 #include "document/codec.h"
 #include "engine/gc_safe_point.h"
 #include "engine/rocks_raw_engine.h"
+#include "engine/txn_gc_compaction_filter.h"
 #include "fmt/core.h"
 #include "fmt/format.h"
 #include "glog/logging.h"
@@ -58,13 +67,42 @@ namespace dingodb {
 
 DEFINE_int64(max_short_value_in_write_cf, 256, "max short value in write cf");
 DEFINE_int64(max_batch_get_count, 4096, "max batch get count");
+DEFINE_int64(txn_scan_batch_read_data_count, 256, "txn scan read long value from data cf in batch of this count");
+BRPC_VALIDATE_GFLAG(txn_scan_batch_read_data_count, brpc::PositiveInteger);
+DEFINE_int32(txn_scan_parallel_num, 4, "count rows of txn scan with count coprocessor by this many parts in parallel");
+BRPC_VALIDATE_GFLAG(txn_scan_parallel_num, brpc::PositiveInteger);
+DEFINE_int64(txn_scan_parallel_min_bytes, 256 * 1024 * 1024, "min approximate size of txn scan range to split parts");
+BRPC_VALIDATE_GFLAG(txn_scan_parallel_min_bytes, brpc::NonNegativeInteger);
 DEFINE_int64(max_batch_get_memory_size, 60 * 1024 * 1024, "max batch get memory size");
 DEFINE_int64(max_prewrite_count, 4096, "max prewrite count");
 DEFINE_int64(max_commit_count, 4096, "max commit count");
 DEFINE_int64(max_rollback_count, 4096, "max rollback count");
 DEFINE_int64(max_resolve_count, 4096, "max rollback count");
+DEFINE_int64(txn_batch_resolve_lock_write_count, 1024, "max lock count of one raft write when batch resolve lock");
+BRPC_VALIDATE_GFLAG(txn_batch_resolve_lock_write_count, brpc::PositiveInteger);
+DEFINE_int64(txn_prewrite_write_batch_count, 1024,
+             "max lock count of one raft write when prewrite, large prewrite is written in several raft writes");
+BRPC_VALIDATE_GFLAG(txn_prewrite_write_batch_count, brpc::PositiveInteger);
 DEFINE_int64(max_pessimistic_count, 4096, "max pessimistic count");
+DEFINE_bool(enable_txn_memory_pessimistic_lock, false,
+            "keep pessimistic lock in memory of leader, persist it by prewrite, leader transfer, split or merge");
+DEFINE_validator(enable_txn_memory_pessimistic_lock, &PassBool);
+DEFINE_int64(txn_memory_pessimistic_lock_max_count, 100000,
+             "max memory pessimistic lock count of one region, more lock fallback to raft write");
+BRPC_VALIDATE_GFLAG(txn_memory_pessimistic_lock_max_count, brpc::NonNegativeInteger);
 DEFINE_int64(gc_delete_batch_count, 32768, "gc delete batch count");
+DEFINE_int32(txn_gc_concurrency, 4, "concurrency of regions do txn gc");
+BRPC_VALIDATE_GFLAG(txn_gc_concurrency, brpc::PositiveInteger);
+DEFINE_int64(txn_gc_max_bytes_per_second, 0, "max bytes per second of txn gc raft write, 0 means no limit");
+BRPC_VALIDATE_GFLAG(txn_gc_max_bytes_per_second, brpc::NonNegativeInteger);
+
+DECLARE_bool(enable_txn_gc_compaction_filter);
+DECLARE_bool(enable_mvcc_ttl_compaction_filter);
+
+DEFINE_bool(enable_txn_one_pc, true, "enable one phase commit when prewrite request try_one_pc");
+DEFINE_validator(enable_txn_one_pc, &PassBool);
+DEFINE_bool(enable_txn_async_commit, true, "enable async commit when prewrite request use_async_commit");
+DEFINE_validator(enable_txn_async_commit, &PassBool);
 
 DEFINE_bool(dingo_log_switch_txn_detail, false, "txn detail log");
 DEFINE_bool(dingo_log_switch_txn_gc_detail, false, "txn gc detail log");
@@ -74,9 +112,18 @@ DEFINE_int64(max_restore_data_memory_size, 10 * 1024 * 1024, "max restore data m
 BRPC_VALIDATE_GFLAG(max_restore_data_memory_size, brpc::PositiveInteger);
 DEFINE_int64(max_restore_count, 32768, "max restore count");
 BRPC_VALIDATE_GFLAG(max_restore_count, brpc::PositiveInteger);
-
+DEFINE_int64(max_restore_ingest_data_size, 64 * 1024 * 1024,
+             "max restore data size of one raft write when store region apply restore data by ingest sst");
+BRPC_VALIDATE_GFLAG(max_restore_ingest_data_size, brpc::PositiveInteger);
+DEFINE_bool(enable_backup_sst_compression, true, "compress block of backup sst file with zstd");
+DEFINE_validator(enable_backup_sst_compression, &PassBool);
+DEFINE_int32(backup_sst_compression_level, 3, "zstd level of backup sst file");
+BRPC_VALIDATE_GFLAG(backup_sst_compression_level, brpc::PositiveInteger);
+
+DECLARE_bool(enable_bulk_ingest_put);
 DECLARE_int64(stream_message_max_bytes);
 DECLARE_int64(stream_message_max_limit_size);
+DECLARE_int64(stream_iterator_memory_bytes);
 
 DEFINE_validator(dingo_log_switch_txn_detail, &PassBool);
 DEFINE_validator(dingo_log_switch_txn_gc_detail, &PassBool);
@@ -127,6 +174,13 @@ butil::Status TxnReader::GetLockInfo(const std::string &key, pb::store::LockInfo
   // if lock_value is not found or it is empty, then the key is not locked
   // else the key is locked, return WriteConflict
   if (status.error_code() == pb::error::Errno::EKEY_NOT_FOUND) {
+    // memory pessimistic lock only exist when lock cf has no lock of the key
+    if (region_ != nullptr && region_->PessimisticLockCount() > 0 && region_->GetPessimisticLock(key, lock_info)) {
+      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+          << "[txn]GetLockInfo key: " << Helper::StringToHex(key) << " is locked by memory pessimistic lock";
+      return butil::Status::OK();
+    }
+
     // key is not exists, the key is not locked
     DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
         << "[txn]GetLockInfo key: " << Helper::StringToHex(key) << " is not locked, lock_key is not exist";
@@ -189,6 +243,54 @@ butil::Status TxnReader::GetDataValue(const std::string &key, std::string &value
   return butil::Status::OK();
 }
 
+butil::Status TxnReader::BatchGetLockInfo(const std::vector<std::string> &keys,
+                                          std::vector<pb::store::LockInfo> &lock_infos) {
+  if (!is_initialized_) {
+    return butil::Status(pb::error::Errno::EINTERNAL, "txn reader is not initialized");
+  }
+
+  std::vector<std::string> lock_keys;
+  lock_keys.reserve(keys.size());
+  for (const auto &key : keys) {
+    lock_keys.push_back(mvcc::Codec::EncodeKey(key, Constant::kLockVer));
+  }
+
+  std::vector<std::string> lock_values;
+  std::vector<bool> key_states;
+  auto status = reader_->KvMultiGet(Constant::kTxnLockCF, snapshot_, lock_keys, lock_values, key_states);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << "[txn]BatchGetLockInfo read lock_keys failed, keys_count: " << keys.size()
+                     << ", status: " << status.error_str();
+    return butil::Status(status.error_code(), status.error_str());
+  }
+
+  lock_infos.clear();
+  lock_infos.resize(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    // if lock_value is not found or it is empty, then the key is not locked
+    if (!key_states[i] || lock_values[i].empty()) {
+      continue;
+    }
+
+    auto ret = lock_infos[i].ParseFromString(lock_values[i]);
+    if (!ret) {
+      DINGO_LOG(FATAL) << "[txn]BatchGetLockInfo parse lock info failed, lock_key: " << Helper::StringToHex(keys[i])
+                       << ", lock_value: " << Helper::StringToHex(lock_values[i]);
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status TxnReader::BatchGetDataValue(const std::vector<std::string> &keys, std::vector<std::string> &values,
+                                           std::vector<bool> &key_states) {
+  if (!is_initialized_) {
+    return butil::Status(pb::error::Errno::EINTERNAL, "txn reader is not initialized");
+  }
+
+  return reader_->KvMultiGet(Constant::kTxnDataCF, snapshot_, keys, values, key_states);
+}
+
 butil::Status TxnReader::GetWriteInfo(int64_t min_commit_ts, int64_t max_commit_ts, int64_t start_ts,
                                       const std::string &key, bool include_rollback, bool include_delete,
                                       bool include_put, pb::store::WriteInfo &write_info, int64_t &commit_ts) {
@@ -441,6 +543,7 @@ butil::Status TxnIterator::Init() {
   IteratorOptions write_iter_options;
   write_iter_options.lower_bound = mvcc::Codec::EncodeKey(range_.start_key(), Constant::kMaxVer);
   write_iter_options.upper_bound = mvcc::Codec::EncodeKey(range_.end_key(), Constant::kMaxVer);
+  write_iter_options.scan_class = scan_class_;
 
   write_iter_ = reader_->NewIterator(Constant::kTxnWriteCF, snapshot_, write_iter_options);
   if (write_iter_ == nullptr) {
@@ -452,6 +555,7 @@ butil::Status TxnIterator::Init() {
   IteratorOptions lock_iter_options;
   lock_iter_options.lower_bound = mvcc::Codec::EncodeKey(range_.start_key(), Constant::kLockVer);
   lock_iter_options.upper_bound = mvcc::Codec::EncodeKey(range_.end_key(), Constant::kLockVer);
+  lock_iter_options.scan_class = scan_class_;
 
   lock_iter_ = reader_->NewIterator(Constant::kTxnLockCF, snapshot_, lock_iter_options);
   if (lock_iter_ == nullptr) {
@@ -484,7 +588,7 @@ butil::Status TxnIterator::Seek(const std::string &key) {
     return ret;
   }
 
-  while (value_.empty()) {
+  while (value_.empty() && data_key_.empty()) {
     ret = InnerNext();
     if (ret.error_code() == pb::error::Errno::ETXN_SCAN_FINISH) {
       DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
@@ -495,7 +599,7 @@ butil::Status TxnIterator::Seek(const std::string &key) {
       return ret;
     }
 
-    if (!value_.empty()) {
+    if (!value_.empty() || !data_key_.empty()) {
       return butil::Status::OK();
     } else {
       DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
@@ -511,6 +615,7 @@ butil::Status TxnIterator::Seek(const std::string &key) {
 butil::Status TxnIterator::InnerSeek(const std::string &key) {
   key_.clear();
   value_.clear();
+  data_key_.clear();
   last_lock_key_.clear();
   last_write_key_.clear();
 
@@ -580,7 +685,7 @@ butil::Status TxnIterator::Next() {
       return ret;
     }
 
-    if (!value_.empty()) {
+    if (!value_.empty() || !data_key_.empty()) {
       return butil::Status::OK();
     } else {
       DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
@@ -607,6 +712,7 @@ butil::Status TxnIterator::InnerNext() {
   }
 
   value_.clear();
+  data_key_.clear();
 
   if (lock_iter_->Valid() && key_ >= last_lock_key_) {
     while (lock_iter_->Valid()) {
@@ -732,7 +838,7 @@ butil::Status TxnIterator::GetUserValueInWriteIter(std::shared_ptr<Iterator> wri
                                                    pb::store::IsolationLevel isolation_level, int64_t seek_ts,
                                                    int64_t start_ts, const std::string &user_key,
                                                    std::string &last_write_key, bool &is_value_found,
-                                                   std::string &user_value) {
+                                                   std::string &user_value, std::string *data_key) {
   is_value_found = false;
   while (write_iter->Valid()) {
     int64_t commit_ts;
@@ -803,6 +909,15 @@ butil::Status TxnIterator::GetUserValueInWriteIter(std::shared_ptr<Iterator> wri
       if (!write_info.short_value().empty()) {
         user_value = write_info.short_value();
 
+        // before return, go to next user_key
+        GotoNextUserKeyInWriteIter(write_iter, last_write_key, last_write_key);
+        is_value_found = true;
+        return butil::Status::OK();
+      } else if (data_key != nullptr) {
+        // lazy mode, caller read data cf in batch
+        *data_key = mvcc::Codec::EncodeKey(user_key, write_info.start_ts());
+        user_value = std::string();
+
         // before return, go to next user_key
         GotoNextUserKeyInWriteIter(write_iter, last_write_key, last_write_key);
         is_value_found = true;
@@ -881,7 +996,8 @@ butil::Status TxnIterator::GetCurrentValue() {
     if (last_lock_key_ == last_write_key_) {
       bool is_value_found = false;
       butil::Status status = GetUserValueInWriteIter(write_iter_, reader_, isolation_level_, seek_ts_, start_ts_, key_,
-                                                     last_write_key_, is_value_found, value_);
+                                                     last_write_key_, is_value_found, value_,
+                                                   lazy_value_ ? &data_key_ : nullptr);
       if (!status.ok()) {
         key_.clear();
         value_.clear();
@@ -908,7 +1024,8 @@ butil::Status TxnIterator::GetCurrentValue() {
 
     bool is_value_found = false;
     butil::Status status = GetUserValueInWriteIter(write_iter_, reader_, isolation_level_, seek_ts_, start_ts_, key_,
-                                                   last_write_key_, is_value_found, value_);
+                                                   last_write_key_, is_value_found, value_,
+                                                   lazy_value_ ? &data_key_ : nullptr);
     if (!status.ok()) {
       key_.clear();
       value_.clear();
@@ -946,7 +1063,37 @@ bool TxnIterator::Valid(pb::store::TxnResultInfo &txn_result_info) {
 
 std::string TxnIterator::Key() { return key_; }
 
-std::string TxnIterator::Value() { return value_; }
+std::string TxnIterator::Value() {
+  if (value_.empty() && !data_key_.empty()) {
+    // lazy value is not loaded by caller, read it from data cf
+    auto status = reader_->KvGet(Constant::kTxnDataCF, snapshot_, data_key_, value_);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << "[txn]Scan read lazy value failed, data_key: " << Helper::StringToHex(data_key_)
+                       << ", status: " << status.error_str();
+    }
+  }
+
+  return value_;
+}
+
+butil::Status TxnIterator::BatchGetDataValue(const std::vector<std::string> &data_keys,
+                                             std::vector<std::string> &values) {
+  std::vector<bool> key_states;
+  auto status = reader_->KvMultiGet(Constant::kTxnDataCF, snapshot_, data_keys, values, key_states);
+  if (!status.ok()) {
+    return status;
+  }
+
+  for (size_t i = 0; i < data_keys.size(); ++i) {
+    if (!key_states[i]) {
+      DINGO_LOG(ERROR) << "[txn]Scan read data failed, data is illegally not found, data_key: "
+                       << Helper::StringToHex(data_keys[i]);
+      return butil::Status(pb::error::Errno::EINTERNAL, "data is illegally not found");
+    }
+  }
+
+  return butil::Status::OK();
+}
 
 bool TxnEngineHelper::CheckLockConflict(const pb::store::LockInfo &lock_info, pb::store::IsolationLevel isolation_level,
                                         int64_t start_ts, const std::set<int64_t> &resolved_locks,
@@ -1018,17 +1165,21 @@ class TxnScanLockStreamState : public StreamState {
   TxnScanLockStreamState(IteratorPtr iter) : iter(iter) {}
   ~TxnScanLockStreamState() override = default;
 
-  static TxnScanLockStreamStatePtr New(RawEnginePtr engine, const pb::common::Range &range) {
+  // resume_key is encoded lock key of evicted stream, empty is seek from range start.
+  static TxnScanLockStreamStatePtr New(RawEnginePtr engine, const pb::common::Range &range,
+                                       const std::string &resume_key) {
     IteratorOptions iter_options;
     iter_options.lower_bound = mvcc::Codec::EncodeKey(range.start_key(), Constant::kLockVer);
     iter_options.upper_bound = mvcc::Codec::EncodeKey(range.end_key(), Constant::kLockVer);
 
     auto iter = engine->Reader()->NewIterator(Constant::kTxnLockCF, iter_options);
     CHECK(iter != nullptr) << "[txn] GetLockInfo NewIterator failed, range: " << Helper::RangeToString(range);
-    iter->Seek(iter_options.lower_bound);
+    iter->Seek(resume_key.empty() ? iter_options.lower_bound : resume_key);
     return std::make_shared<TxnScanLockStreamState>(iter);
   }
 
+  int64_t MemorySize() const override { return FLAGS_stream_iterator_memory_bytes; }
+
   IteratorPtr iter;
 };
 
@@ -1042,8 +1193,16 @@ butil::Status TxnEngineHelper::ScanLockInfo(StreamPtr stream, RawEnginePtr engin
       << fmt::format("[txn][{}] ScanLockInfo lock_ts: [{},{}] range: {} limit: {}.", stream->StreamId(), min_lock_ts,
                      max_lock_ts, Helper::RangeToString(range), limit);
 
-  auto stream_state = std::dynamic_pointer_cast<TxnScanLockStreamState>(
-      stream->GetOrNewStreamState([&]() -> StreamStatePtr { return TxnScanLockStreamState::New(engine, range); }));
+  // live iterator of evicted stream is released, seek from resume key.
+  std::string resume_key = stream->ResumeKey();
+  if (stream->IsEvicted() && resume_key.empty()) {
+    return butil::Status(pb::error::ESTREAM_EXPIRED, fmt::format("stream({}) is evicted.", stream->StreamId()));
+  }
+  // not evictable until this continuation is done.
+  stream->SetResumeKey("");
+
+  auto stream_state = std::dynamic_pointer_cast<TxnScanLockStreamState>(stream->GetOrNewStreamState(
+      [&]() -> StreamStatePtr { return TxnScanLockStreamState::New(engine, range, resume_key); }));
   IteratorPtr iter = stream_state->iter;
   CHECK(iter != nullptr) << fmt::format("[txn][{}] Scan stream_state->iter is nullptr.", stream->StreamId());
 
@@ -1103,6 +1262,10 @@ butil::Status TxnEngineHelper::ScanLockInfo(StreamPtr stream, RawEnginePtr engin
     iter->Next();
   }
 
+  if (has_more && iter->Valid()) {
+    stream->SetResumeKey(std::string(iter->Key()));
+  }
+
   return butil::Status::OK();
 }
 
@@ -1162,39 +1325,44 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
     return butil::Status(pb::error::Errno::EINTERNAL, "GetWriteIter failed");
   }
 
-  // for every key in keys, get lock info, if lock_ts < start_ts, return LockInfo
-  // else find the latest write below our start_ts
-  // then read data from data_cf
-  for (const auto &key : keys) {
-    pb::common::KeyValue kv;
-    kv.set_key(key);
-
-    pb::store::LockInfo lock_info;
-    auto ret = txn_reader.GetLockInfo(key, lock_info);
-    if (!ret.ok()) {
-      DINGO_LOG(FATAL) << "[txn]BatchGet GetLockInfo failed, key: " << Helper::StringToHex(key)
-                       << ", status: " << ret.error_str();
-    }
+  // get lock info of all keys in one batch, if lock_ts < start_ts, return LockInfo
+  std::vector<pb::store::LockInfo> lock_infos;
+  auto ret_lock = txn_reader.BatchGetLockInfo(keys, lock_infos);
+  if (!ret_lock.ok()) {
+    DINGO_LOG(FATAL) << "[txn]BatchGet BatchGetLockInfo failed, keys_count: " << keys.size()
+                     << ", status: " << ret_lock.error_str();
+  }
 
-    auto is_lock_conflict = CheckLockConflict(lock_info, isolation_level, start_ts, resolved_locks, txn_result_info);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    auto is_lock_conflict = CheckLockConflict(lock_infos[i], isolation_level, start_ts, resolved_locks, txn_result_info);
     if (is_lock_conflict) {
-      DINGO_LOG(WARNING) << "[txn]BatchGet CheckLockConflict return conflict, key: " << Helper::StringToHex(key)
+      DINGO_LOG(WARNING) << "[txn]BatchGet CheckLockConflict return conflict, key: " << Helper::StringToHex(keys[i])
                          << ", isolation_level: " << isolation_level << ", start_ts: " << start_ts
-                         << ", lock_info: " << lock_info.ShortDebugString()
+                         << ", lock_info: " << lock_infos[i].ShortDebugString()
                          << ", txn_result_info: " << txn_result_info.ShortDebugString();
       return butil::Status::OK();
     }
+  }
 
-    int64_t iter_start_ts;
-    bool is_valid = false;
-    if (isolation_level == pb::store::IsolationLevel::SnapshotIsolation) {
-      iter_start_ts = start_ts;
-    } else if (isolation_level == pb::store::IsolationLevel::ReadCommitted) {
-      iter_start_ts = Constant::kMaxVer;
-    } else {
-      DINGO_LOG(ERROR) << "[txn]BatchGet invalid isolation_level: " << isolation_level;
-      return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "invalid isolation_level");
-    }
+  int64_t iter_start_ts;
+  if (isolation_level == pb::store::IsolationLevel::SnapshotIsolation) {
+    iter_start_ts = start_ts;
+  } else if (isolation_level == pb::store::IsolationLevel::ReadCommitted) {
+    iter_start_ts = Constant::kMaxVer;
+  } else {
+    DINGO_LOG(ERROR) << "[txn]BatchGet invalid isolation_level: " << isolation_level;
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "invalid isolation_level");
+  }
+
+  // for every key in keys, find the latest write below our start_ts,
+  // the keys which value is not inlined in write_info are collected and read from data_cf in one batch.
+  std::vector<pb::common::KeyValue> tmp_kvs(keys.size());
+  std::vector<std::string> data_keys;
+  std::vector<size_t> data_key_indexes;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    const auto &key = keys[i];
+    auto &kv = tmp_kvs[i];
+    kv.set_key(key);
 
     DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
         << "key: " << Helper::StringToHex(key) << ", iter_start_ts: " << iter_start_ts;
@@ -1271,15 +1439,8 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
           break;
         }
 
-        auto ret1 = txn_reader.GetDataValue(mvcc::Codec::EncodeKey(key, write_info.start_ts()), *kv.mutable_value());
-        if (!ret1.ok() && ret1.error_code() != pb::error::Errno::EKEY_NOT_FOUND) {
-          DINGO_LOG(FATAL) << "[txn]BatchGet read data failed, key: " << Helper::StringToHex(key)
-                           << ", status: " << ret1.error_str();
-        } else if (ret1.error_code() == pb::error::Errno::EKEY_NOT_FOUND) {
-          DINGO_LOG(ERROR) << "[txn]BatchGet read data failed, data is illegally not found, key: "
-                           << Helper::StringToHex(key) << ", status: " << ret1.error_str()
-                           << ", ts: " << write_info.start_ts();
-        }
+        data_keys.push_back(mvcc::Codec::EncodeKey(key, write_info.start_ts()));
+        data_key_indexes.push_back(i);
         break;
       } else {
         DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
@@ -1289,9 +1450,32 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
 
       write_iter->Next();
     }
+  }
+
+  if (!data_keys.empty()) {
+    std::vector<std::string> data_values;
+    std::vector<bool> key_states;
+    auto ret = txn_reader.BatchGetDataValue(data_keys, data_values, key_states);
+    if (!ret.ok()) {
+      DINGO_LOG(FATAL) << "[txn]BatchGet read data failed, data_keys_count: " << data_keys.size()
+                       << ", status: " << ret.error_str();
+    }
 
-    kvs.emplace_back(kv);
+    for (size_t i = 0; i < data_keys.size(); ++i) {
+      auto &kv = tmp_kvs[data_key_indexes[i]];
+      if (!key_states[i]) {
+        DINGO_LOG(ERROR) << "[txn]BatchGet read data failed, data is illegally not found, key: "
+                         << Helper::StringToHex(kv.key()) << ", data_key: " << Helper::StringToHex(data_keys[i]);
+        continue;
+      }
+      kv.mutable_value()->swap(data_values[i]);
+    }
+  }
+
+  kvs.reserve(tmp_kvs.size());
+  for (auto &kv : tmp_kvs) {
     response_memory_size += kv.ByteSizeLong();
+    kvs.emplace_back(std::move(kv));
 
     if (response_memory_size >= FLAGS_max_batch_get_memory_size) {
       DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
@@ -1317,9 +1501,180 @@ class TxnScanStreamState : public StreamState {
 
   static TxnScanStreamStatePtr New(TxnIteratorPtr iter) { return std::make_shared<TxnScanStreamState>(iter); }
 
+  // txn iterator hold iterator of lock/write/data cf.
+  int64_t MemorySize() const override { return FLAGS_stream_iterator_memory_bytes * 3; }
+
   TxnIteratorPtr iter;
 };
 
+bvar::Adder<int64_t> g_txn_scan_parallel_count("dingo_txn_scan_parallel_count");
+
+// split range to at most part_num parts by bisecting the largest part, size is approximate size of write cf.
+static std::vector<pb::common::Range> SplitScanRange(RawEnginePtr raw_engine, const pb::common::Range &range,
+                                                     int part_num) {
+  std::vector<pb::common::Range> parts = {range};
+  if (part_num <= 1 || range.start_key().empty() || range.end_key().empty()) {
+    return parts;
+  }
+
+  auto approximate_size = [&raw_engine](const pb::common::Range &part) -> int64_t {
+    std::vector<pb::common::Range> ranges(1);
+    ranges[0].set_start_key(mvcc::Codec::EncodeBytes(part.start_key()));
+    ranges[0].set_end_key(mvcc::Codec::EncodeBytes(part.end_key()));
+    auto sizes = raw_engine->GetApproximateSizes(Constant::kTxnWriteCF, ranges);
+    return sizes.empty() ? 0 : sizes[0];
+  };
+
+  std::vector<int64_t> sizes = {approximate_size(range)};
+  if (sizes[0] < FLAGS_txn_scan_parallel_min_bytes) {
+    return parts;
+  }
+
+  while (static_cast<int>(parts.size()) < part_num) {
+    size_t pos = std::max_element(sizes.begin(), sizes.end()) - sizes.begin();
+    std::string middle_key = Helper::CalculateMiddleKey(parts[pos].start_key(), parts[pos].end_key());
+    if (middle_key <= parts[pos].start_key() || middle_key >= parts[pos].end_key()) {
+      break;
+    }
+
+    pb::common::Range right;
+    right.set_start_key(middle_key);
+    right.set_end_key(parts[pos].end_key());
+    parts[pos].set_end_key(middle_key);
+    sizes[pos] = approximate_size(parts[pos]);
+
+    parts.insert(parts.begin() + pos + 1, right);
+    sizes.insert(sizes.begin() + pos + 1, approximate_size(right));
+  }
+
+  return parts;
+}
+
+struct TxnScanCountTaskArg {
+  RawEnginePtr raw_engine;
+  pb::store::IsolationLevel isolation_level;
+  int64_t start_ts{0};
+  std::set<int64_t> resolved_locks;
+
+  std::vector<pb::common::Range> ranges;
+  std::atomic<int64_t> offset{0};
+
+  // result of each part
+  std::vector<int64_t> counts;
+  std::vector<butil::Status> statuses;
+  std::vector<pb::store::TxnResultInfo> txn_result_infos;
+};
+
+static void CountTxnScanPart(TxnScanCountTaskArg *arg, size_t i) {
+  const auto &range = arg->ranges[i];
+  auto iter = std::make_shared<TxnIterator>(arg->raw_engine, range, arg->start_ts, arg->isolation_level,
+                                            arg->resolved_locks);
+  // count never read value
+  iter->SetLazyValue(true);
+  iter->SetScanClass(ScanClass::kCoprocessor);
+  auto status = iter->Init();
+  if (!status.ok()) {
+    arg->statuses[i] = status;
+    return;
+  }
+
+  status = iter->Seek(range.start_key());
+  if (!status.ok() && status.error_code() != pb::error::Errno::ETXN_LOCK_CONFLICT) {
+    arg->statuses[i] = status;
+    return;
+  }
+
+  int64_t count = 0;
+  while (iter->Valid(arg->txn_result_infos[i])) {
+    ++count;
+    status = iter->Next();
+    if (!status.ok() && status.error_code() != pb::error::Errno::ETXN_LOCK_CONFLICT) {
+      arg->statuses[i] = status;
+      return;
+    }
+  }
+  arg->counts[i] = count;
+}
+
+static void *TxnScanCountRoutine(void *arg) {
+  auto *count_arg = static_cast<TxnScanCountTaskArg *>(arg);
+  for (;;) {
+    int64_t offset = count_arg->offset.fetch_add(1);
+    if (offset >= static_cast<int64_t>(count_arg->ranges.size())) {
+      break;
+    }
+    CountTxnScanPart(count_arg, offset);
+  }
+
+  return nullptr;
+}
+
+// count(*) pushdown over a large range, the count of parts are merged by sum.
+// return false if the range is not split, caller scan it in one iterator.
+static bool ParallelScanCount(StreamPtr stream, RawEnginePtr raw_engine,
+                              const pb::store::IsolationLevel &isolation_level, int64_t start_ts,
+                              const pb::common::Range &range, const std::set<int64_t> &resolved_locks,
+                              const pb::common::CoprocessorV2 &pb_coprocessor,
+                              pb::store::TxnResultInfo &txn_result_info, std::vector<pb::common::KeyValue> &kvs,
+                              bool &has_more, butil::Status &status) {
+  auto ranges = SplitScanRange(raw_engine, range, FLAGS_txn_scan_parallel_num);
+  if (ranges.size() <= 1) {
+    return false;
+  }
+
+  auto coprocessor = CoprocessorV2::New(Helper::GetKeyPrefix(range.start_key()));
+  status = coprocessor->Open(CoprocessorPbWrapper{pb_coprocessor});
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[txn][{}] Scan coprocessor::Open failed, error: {}.", stream->StreamId(),
+                                    status.error_cstr());
+    return true;
+  }
+
+  auto count_arg = std::make_shared<TxnScanCountTaskArg>();
+  count_arg->raw_engine = raw_engine;
+  count_arg->isolation_level = isolation_level;
+  count_arg->start_ts = start_ts;
+  count_arg->resolved_locks = resolved_locks;
+  count_arg->counts.resize(ranges.size(), 0);
+  count_arg->statuses.resize(ranges.size());
+  count_arg->txn_result_infos.resize(ranges.size());
+  count_arg->ranges = std::move(ranges);
+
+  int concurrency = count_arg->ranges.size();
+  if (!Helper::ParallelRunTask(&TxnScanCountRoutine, count_arg.get(), concurrency)) {
+    TxnScanCountRoutine(count_arg.get());
+  }
+  g_txn_scan_parallel_count << 1;
+
+  int64_t count = 0;
+  for (size_t i = 0; i < count_arg->ranges.size(); ++i) {
+    if (!count_arg->statuses[i].ok()) {
+      status = count_arg->statuses[i];
+      DINGO_LOG(ERROR) << fmt::format("[txn][{}] Scan count part({}) range: {} failed, status: {}.",
+                                      stream->StreamId(), i, Helper::RangeToString(count_arg->ranges[i]),
+                                      status.error_str());
+      return true;
+    }
+
+    // same as seek meet lock, return lock and nothing counted, the whole range is counted again after resolve.
+    if (count_arg->txn_result_infos[i].ByteSizeLong() > 0) {
+      txn_result_info = count_arg->txn_result_infos[i];
+      has_more = true;
+      status = butil::Status::OK();
+      return true;
+    }
+    count += count_arg->counts[i];
+  }
+
+  DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+      << fmt::format("[txn][{}] Scan count by {} parts, range: {} count: {}.", stream->StreamId(),
+                     count_arg->ranges.size(), Helper::RangeToString(range), count);
+
+  has_more = false;
+  status = coprocessor->ExecuteAggCount(count, kvs);
+  return true;
+}
+
 butil::Status TxnEngineHelper::Scan(StreamPtr stream, RawEnginePtr raw_engine,
                                     const pb::store::IsolationLevel &isolation_level, int64_t start_ts,
                                     const pb::common::Range &range, int64_t limit, bool key_only, bool is_reverse,
@@ -1346,13 +1701,36 @@ butil::Status TxnEngineHelper::Scan(StreamPtr stream, RawEnginePtr raw_engine,
     return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "kvs is not empty");
   }
 
+  // live iterator of evicted stream is released, seek from resume key.
+  bool is_evicted = stream->IsEvicted();
+  std::string resume_key = stream->ResumeKey();
+  if (is_evicted && resume_key.empty()) {
+    return butil::Status(pb::error::ESTREAM_EXPIRED, fmt::format("stream({}) is evicted.", stream->StreamId()));
+  }
+  // not evictable until this continuation is done.
+  stream->SetResumeKey("");
+
   // get or new TxnIterator.
   StreamStatePtr current_stream_state = stream->StreamState();
+  if (!current_stream_state && !is_evicted && !disable_coprocessor && coprocessor.for_agg_count() && !is_reverse &&
+      FLAGS_txn_scan_parallel_num > 1) {
+    butil::Status status;
+    if (ParallelScanCount(stream, raw_engine, isolation_level, start_ts, range, resolved_locks, coprocessor,
+                          txn_result_info, kvs, has_more, status)) {
+      return status;
+    }
+  }
+
   if (!current_stream_state) {
     DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail) << fmt::format(
         "[txn][{}] Scan current_stream_state is null, need to create new TxnIterator.", stream->StreamId());
 
     auto iter = std::make_shared<TxnIterator>(raw_engine, range, start_ts, isolation_level, resolved_locks);
+    // without coprocessor, read long value from data cf in batch
+    iter->SetLazyValue(disable_coprocessor);
+    if (!disable_coprocessor) {
+      iter->SetScanClass(ScanClass::kCoprocessor);
+    }
     butil::Status status = iter->Init();
     if (!status.ok()) {
       std::string s = fmt::format("[txn][{}] Scan init txn_iter failed, start_ts: {} range: {}  status: {}.",
@@ -1361,7 +1739,7 @@ butil::Status TxnEngineHelper::Scan(StreamPtr stream, RawEnginePtr raw_engine,
       return butil::Status(status.error_code(), s);
     }
 
-    status = iter->Seek(range.start_key());
+    status = iter->Seek(is_evicted ? resume_key : range.start_key());
     if (!status.ok()) {
       if (status.error_code() == pb::error::Errno::ETXN_LOCK_CONFLICT) {
         DINGO_LOG(INFO) << fmt::format("[txn][{}] Scan seek meet lock conflict, start_ts: {} range: {}  status: {}.",
@@ -1415,16 +1793,53 @@ butil::Status TxnEngineHelper::Scan(StreamPtr stream, RawEnginePtr raw_engine,
 
   } else {
     size_t bytes = 0;
-    while (iter->Valid(txn_result_info)) {
-      auto key = iter->Key();
-      auto value = iter->Value();
+    // rows whose value is in data cf, key_only scan never read them
+    std::vector<std::string> data_keys;
+    std::vector<size_t> data_key_indexes;
+    auto read_data_values = [&]() -> butil::Status {
+      if (data_keys.empty()) {
+        return butil::Status::OK();
+      }
 
+      std::vector<std::string> data_values;
+      auto status = iter->BatchGetDataValue(data_keys, data_values);
+      if (!status.ok()) {
+        return status;
+      }
+      for (size_t i = 0; i < data_keys.size(); ++i) {
+        bytes += data_values[i].size();
+        kvs[data_key_indexes[i]].mutable_value()->swap(data_values[i]);
+      }
+
+      data_keys.clear();
+      data_key_indexes.clear();
+      return butil::Status::OK();
+    };
+
+    while (iter->Valid(txn_result_info)) {
       pb::common::KeyValue kv;
-      kv.set_key(key);
-      if (!key_only) kv.set_value(value);
+      kv.set_key(iter->Key());
+      if (!key_only) {
+        if (!iter->DataKey().empty()) {
+          data_keys.push_back(iter->DataKey());
+          data_key_indexes.push_back(kvs.size());
+        } else {
+          kv.set_value(iter->Value());
+        }
+      }
       bytes += kv.ByteSizeLong();
       kvs.push_back(std::move(kv));
 
+      if (static_cast<int64_t>(data_keys.size()) >= FLAGS_txn_scan_batch_read_data_count) {
+        butil::Status status = read_data_values();
+        if (!status.ok()) {
+          DINGO_LOG(ERROR) << fmt::format("[txn][{}] Scan read data failed, start_ts: {} range: {} status: {}.",
+                                          stream->StreamId(), start_ts, Helper::RangeToString(range),
+                                          status.error_str());
+          return status;
+        }
+      }
+
       if (stop_checker(kvs.size(), bytes)) {
         has_more = true;
 
@@ -1449,7 +1864,7 @@ butil::Status TxnEngineHelper::Scan(StreamPtr stream, RawEnginePtr raw_engine,
               "{}",
               stream->StreamId(), txn_result_info.DebugString());
           has_more = true;
-          return butil::Status::OK();
+          break;
 
         } else {
           std::string s = fmt::format("[txn][{}] Scan iter->Next() failed, start_ts: {} range: {}  status: {}.",
@@ -1459,6 +1874,13 @@ butil::Status TxnEngineHelper::Scan(StreamPtr stream, RawEnginePtr raw_engine,
         }
       }
     }
+
+    butil::Status status = read_data_values();
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[txn][{}] Scan read data failed, start_ts: {} range: {} status: {}.",
+                                      stream->StreamId(), start_ts, Helper::RangeToString(range), status.error_str());
+      return status;
+    }
   }
 
   if (iter->Valid(txn_result_info)) {
@@ -1485,10 +1907,63 @@ butil::Status TxnEngineHelper::Scan(StreamPtr stream, RawEnginePtr raw_engine,
     }
   }
 
+  // reverse scan is not resumed by seek.
+  pb::store::TxnResultInfo resume_txn_result_info;
+  if (has_more && !is_reverse && iter->Valid(resume_txn_result_info)) {
+    stream->SetResumeKey(iter->Key());
+  }
+
   return butil::Status::OK();
 }
 
 bvar::LatencyRecorder g_txn_pessimistic_lock_latency("dingo_txn_pessimistic_lock");
+bvar::Adder<int64_t> g_txn_memory_pessimistic_lock_count("dingo_txn_memory_pessimistic_lock_count");
+bvar::Adder<int64_t> g_txn_memory_pessimistic_lock_fallback_count("dingo_txn_memory_pessimistic_lock_fallback_count");
+bvar::Adder<int64_t> g_txn_memory_pessimistic_lock_persist_count("dingo_txn_memory_pessimistic_lock_persist_count");
+
+// memory pessimistic lock is only kept by raft store leader of normal region, request must wait
+// for the result, and region is not in split or merge, which persist memory locks before proposed.
+static bool IsMemoryPessimisticLockEnabled(std::shared_ptr<Context> ctx, store::RegionPtr region) {
+  return FLAGS_enable_txn_memory_pessimistic_lock && region != nullptr && ctx->Done() == nullptr &&
+         region->GetStoreEngineType() == pb::common::StorageEngine::STORE_ENG_RAFT_STORE &&
+         region->State() == pb::common::StoreRegionState::NORMAL && !region->TemporaryDisableChange();
+}
+
+butil::Status TxnEngineHelper::PersistMemoryPessimisticLocks(std::shared_ptr<Engine> raft_engine,
+                                                             store::RegionPtr region) {
+  if (region->PessimisticLockCount() == 0) {
+    return butil::Status::OK();
+  }
+
+  std::vector<pb::store::LockInfo> lock_infos;
+  region->GetPessimisticLocks(lock_infos);
+
+  pb::raft::TxnRaftRequest txn_raft_request;
+  auto *lock_puts = txn_raft_request.mutable_multi_cf_put_and_delete()->add_puts_with_cf();
+  lock_puts->set_cf_name(Constant::kTxnLockCF);
+  for (const auto &lock_info : lock_infos) {
+    auto *kv = lock_puts->add_kvs();
+    kv->set_key(mvcc::Codec::EncodeKey(lock_info.key(), Constant::kLockVer));
+    kv->set_value(lock_info.SerializeAsString());
+  }
+
+  auto ctx = std::make_shared<Context>();
+  ctx->SetRegionId(region->Id());
+  ctx->SetRegionEpoch(region->Epoch());
+  ctx->SetStoreEngineType(region->GetStoreEngineType());
+  ctx->SetRawEngineType(region->GetRawEngineType());
+  auto ret = raft_engine->Write(ctx, WriteDataBuilder::BuildWrite(txn_raft_request));
+  if (!ret.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[txn][region({})] persist memory pessimistic lock failed, count: {}, error: {}",
+                                    region->Id(), lock_infos.size(), ret.error_str());
+    return ret;
+  }
+
+  g_txn_memory_pessimistic_lock_persist_count << lock_infos.size();
+  DINGO_LOG(INFO) << fmt::format("[txn][region({})] persist memory pessimistic lock, count: {}", region->Id(),
+                                 lock_infos.size());
+  return butil::Status::OK();
+}
 
 butil::Status TxnEngineHelper::PessimisticLock(RawEnginePtr raw_engine, std::shared_ptr<Engine> raft_engine,
                                                std::shared_ptr<Context> ctx,
@@ -1523,7 +1998,9 @@ butil::Status TxnEngineHelper::PessimisticLock(RawEnginePtr raw_engine, std::sha
   }
 
   auto *error = response->mutable_error();
+  auto region = Server::GetInstance().GetRegion(ctx->RegionId());
   TxnReader txn_reader(raw_engine);
+  txn_reader.SetRegion(region);
   auto ret_init = txn_reader.Init();
   if (!ret_init.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] PessimisticLock, start_ts: {}", ctx->RegionId(), start_ts)
@@ -1750,6 +2227,26 @@ butil::Status TxnEngineHelper::PessimisticLock(RawEnginePtr raw_engine, std::sha
     return butil::Status::OK();
   }
 
+  if (IsMemoryPessimisticLockEnabled(ctx, region)) {
+    bool is_memory_lock = true;
+    for (const auto &kv_put : kv_puts_lock) {
+      pb::store::LockInfo lock_info;
+      if (!lock_info.ParseFromString(kv_put.value()) ||
+          !region->LockPessimisticKey(lock_info.key(), lock_info, FLAGS_txn_memory_pessimistic_lock_max_count)) {
+        is_memory_lock = false;
+        break;
+      }
+    }
+
+    if (is_memory_lock) {
+      g_txn_memory_pessimistic_lock_count << kv_puts_lock.size();
+      return butil::Status::OK();
+    }
+
+    // over memory budget, locks already in memory are replaced by raft write below.
+    g_txn_memory_pessimistic_lock_fallback_count << 1;
+  }
+
   // after all mutations is processed, write into raft engine
   pb::raft::TxnRaftRequest txn_raft_request;
   auto *cf_put_delete = txn_raft_request.mutable_multi_cf_put_and_delete();
@@ -1872,6 +2369,7 @@ butil::Status TxnEngineHelper::PessimisticRollback(RawEnginePtr raw_engine, std:
   auto *error = response->mutable_error();
 
   TxnReader txn_reader(raw_engine);
+  txn_reader.SetRegion(region);
   auto ret_init = txn_reader.Init();
   if (!ret_init.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] PessimisticRollback, start_ts: {}", region->Id(), start_ts)
@@ -1987,6 +2485,10 @@ butil::Status TxnEngineHelper::PessimisticRollback(RawEnginePtr raw_engine, std:
 }
 
 bvar::LatencyRecorder g_txn_prewrite_latency("dingo_txn_prewrite");
+bvar::Adder<int64_t> g_txn_prewrite_one_pc_count("dingo_txn_prewrite_one_pc_count");
+bvar::Adder<int64_t> g_txn_prewrite_async_commit_count("dingo_txn_prewrite_async_commit_count");
+bvar::Adder<int64_t> g_txn_prewrite_fallback_2pc_count("dingo_txn_prewrite_fallback_2pc_count");
+bvar::Adder<int64_t> g_txn_prewrite_split_count("dingo_txn_prewrite_split_count");
 
 int64_t TxnEngineHelper::GenFinalMinCommitTs(store::RegionPtr region, pb::store::LockInfo &lock_info, std::string key,
                                              int64_t start_ts, int64_t for_update_ts, int64_t max_commit_ts) {
@@ -2273,6 +2775,22 @@ void TxnEngineHelper::FallbackTo1PCLocks(
   }
 }
 
+void TxnEngineHelper::FallbackTo2PCLocks(std::vector<pb::common::KeyValue> &kv_puts_lock) {
+  for (auto &kv : kv_puts_lock) {
+    pb::store::LockInfo lock_info;
+    if (!lock_info.ParseFromString(kv.value())) {
+      DINGO_LOG(FATAL) << "[txn]parse lock info failed, key: " << Helper::StringToHex(kv.key());
+    }
+    if (!lock_info.use_async_commit() && lock_info.secondaries().empty()) {
+      continue;
+    }
+
+    lock_info.set_use_async_commit(false);
+    lock_info.clear_secondaries();
+    kv.set_value(lock_info.SerializeAsString());
+  }
+}
+
 // Commit and delete all 1pc locks in txn.
 butil::Status TxnEngineHelper::OnePCommit(
     std::shared_ptr<Engine> raft_engine, std::shared_ptr<Context> ctx, store::RegionPtr region, int64_t start_ts,
@@ -2433,40 +2951,30 @@ butil::Status TxnEngineHelper::OnePCommit(
   return ret;
 }
 
-butil::Status TxnEngineHelper::DoPreWrite(std::shared_ptr<Engine> raft_engine, std::shared_ptr<Context> ctx,
-                                          int64_t region_id, int64_t start_ts, int64_t mutation_size,
-                                          std::vector<pb::common::KeyValue> &kv_puts_data,
-                                          std::vector<pb::common::KeyValue> &kv_puts_lock) {
-  if (kv_puts_data.empty() && kv_puts_lock.empty()) {
-    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
-        << fmt::format("[txn][region({})] Prewrite return empty kv_puts_data and kv_puts_lock,", region_id)
-        << ", kv_puts_data_size: " << kv_puts_data.size() << ", kv_puts_lock_size: " << kv_puts_lock.size()
-        << ", start_ts: " << start_ts << ", region_epoch: " << ctx->RegionEpoch().ShortDebugString()
-        << ", mutations_size: " << mutation_size;
-    return butil::Status::OK();
-  }
-
-  // after all mutations is processed, write into raft engine
+static butil::Status WritePrewriteData(std::shared_ptr<Engine> raft_engine, std::shared_ptr<Context> ctx,
+                                       int64_t region_id, int64_t start_ts, int64_t mutation_size,
+                                       const std::vector<const pb::common::KeyValue *> &kv_puts_data,
+                                       const std::vector<const pb::common::KeyValue *> &kv_puts_lock) {
   pb::raft::TxnRaftRequest txn_raft_request;
   auto *cf_put_delete = txn_raft_request.mutable_multi_cf_put_and_delete();
 
   if (!kv_puts_data.empty()) {
     auto *data_puts = cf_put_delete->add_puts_with_cf();
     data_puts->set_cf_name(Constant::kTxnDataCF);
-    for (auto &kv_put : kv_puts_data) {
+    for (const auto *kv_put : kv_puts_data) {
       auto *kv = data_puts->add_kvs();
-      kv->set_key(kv_put.key());
-      kv->set_value(kv_put.value());
+      kv->set_key(kv_put->key());
+      kv->set_value(kv_put->value());
     }
   }
 
   if (!kv_puts_lock.empty()) {
     auto *lock_puts = cf_put_delete->add_puts_with_cf();
     lock_puts->set_cf_name(Constant::kTxnLockCF);
-    for (auto &kv_put : kv_puts_lock) {
+    for (const auto *kv_put : kv_puts_lock) {
       auto *kv = lock_puts->add_kvs();
-      kv->set_key(kv_put.key());
-      kv->set_value(kv_put.value());
+      kv->set_key(kv_put->key());
+      kv->set_value(kv_put->value());
     }
   }
 
@@ -2485,6 +2993,64 @@ butil::Status TxnEngineHelper::DoPreWrite(std::shared_ptr<Engine> raft_engine, s
   return ret;
 }
 
+// plain key part of data key and lock key, both are encoded with a 8 bytes ts suffix.
+static std::string_view PrewriteKeyPrefix(const std::string &encode_key) {
+  return std::string_view(encode_key).substr(0, encode_key.size() - 8);
+}
+
+butil::Status TxnEngineHelper::DoPreWrite(std::shared_ptr<Engine> raft_engine, std::shared_ptr<Context> ctx,
+                                          int64_t region_id, int64_t start_ts, int64_t mutation_size,
+                                          std::vector<pb::common::KeyValue> &kv_puts_data,
+                                          std::vector<pb::common::KeyValue> &kv_puts_lock) {
+  if (kv_puts_data.empty() && kv_puts_lock.empty()) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+        << fmt::format("[txn][region({})] Prewrite return empty kv_puts_data and kv_puts_lock,", region_id)
+        << ", kv_puts_data_size: " << kv_puts_data.size() << ", kv_puts_lock_size: " << kv_puts_lock.size()
+        << ", start_ts: " << start_ts << ", region_epoch: " << ctx->RegionEpoch().ShortDebugString()
+        << ", mutations_size: " << mutation_size;
+    return butil::Status::OK();
+  }
+
+  // large prewrite is split to several raft writes, so raft log entry and apply batch stay bounded.
+  // data of a key is always written with its lock in same raft write, a failed batch just leave some locks
+  // of the txn, same as a failed prewrite of other region, and is resolved by retry or rollback.
+  int64_t batch_count = FLAGS_txn_prewrite_write_batch_count;
+  int64_t lock_count = kv_puts_lock.size();
+  int64_t batch_num = std::max(static_cast<int64_t>(1), (lock_count + batch_count - 1) / batch_count);
+
+  std::vector<std::vector<const pb::common::KeyValue *>> data_batches(batch_num);
+  std::vector<std::vector<const pb::common::KeyValue *>> lock_batches(batch_num);
+  if (batch_num == 1) {
+    for (const auto &kv : kv_puts_data) {
+      data_batches[0].push_back(&kv);
+    }
+    for (const auto &kv : kv_puts_lock) {
+      lock_batches[0].push_back(&kv);
+    }
+  } else {
+    std::unordered_map<std::string_view, int64_t> key_batches;
+    for (int64_t i = 0; i < lock_count; ++i) {
+      lock_batches[i / batch_count].push_back(&kv_puts_lock[i]);
+      key_batches[PrewriteKeyPrefix(kv_puts_lock[i].key())] = i / batch_count;
+    }
+    for (const auto &kv : kv_puts_data) {
+      auto it = key_batches.find(PrewriteKeyPrefix(kv.key()));
+      data_batches[it != key_batches.end() ? it->second : 0].push_back(&kv);
+    }
+    g_txn_prewrite_split_count << 1;
+  }
+
+  for (int64_t i = 0; i < batch_num; ++i) {
+    auto ret =
+        WritePrewriteData(raft_engine, ctx, region_id, start_ts, mutation_size, data_batches[i], lock_batches[i]);
+    if (!ret.ok()) {
+      return ret;
+    }
+  }
+
+  return butil::Status::OK();
+}
+
 butil::Status TxnEngineHelper::Prewrite(
     RawEnginePtr raw_engine, std::shared_ptr<Engine> raft_engine, std::shared_ptr<Context> ctx, store::RegionPtr region,
     const std::vector<pb::store::Mutation> &mutations, const std::string &primary_lock, int64_t start_ts,
@@ -2538,9 +3104,11 @@ butil::Status TxnEngineHelper::Prewrite(
   std::vector<std::tuple<std::string, std::string, pb::store::LockInfo, bool>> locks_for_1pc;
 
   bool use_async_commit = false;
-  if (!secondaries.empty()) {
+  if (!secondaries.empty() && FLAGS_enable_txn_async_commit) {
     use_async_commit = true;
   }
+  try_one_pc = try_one_pc && FLAGS_enable_txn_one_pc;
+  bool request_fast_commit = try_one_pc || use_async_commit;
   auto *response = dynamic_cast<pb::store::TxnPrewriteResponse *>(ctx->Response());
   if (response == nullptr) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] Prewrite, start_ts: {}", region->Id(), start_ts)
@@ -2550,6 +3118,7 @@ butil::Status TxnEngineHelper::Prewrite(
   auto *error = response->mutable_error();
 
   TxnReader txn_reader(raw_engine);
+  txn_reader.SetRegion(region);
   auto ret_init = txn_reader.Init();
   if (!ret_init.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] Prewrite, start_ts: {}", region->Id(), start_ts)
@@ -2559,6 +3128,7 @@ butil::Status TxnEngineHelper::Prewrite(
 
   // for every mutation, check and do prewrite, if any one of the mutation is failed, the whole prewrite is failed
   for (int64_t i = 0; i < mutations.size(); i++) {
+    DINGO_DEBUG_PROBE_LATENCY("txn_prewrite_mutation");
     const auto &mutation = mutations[i];
 
     // 1.check if the key is locked
@@ -2985,9 +3555,17 @@ butil::Status TxnEngineHelper::Prewrite(
         << fmt::format("[txn][region({})] Prewrite 1PC commit", region->Id()) << ", start_ts:" << start_ts
         << " ,final_min_commit_ts:" << final_min_commit_ts;
     response->set_one_pc_commit_ts(final_min_commit_ts);
+    g_txn_prewrite_one_pc_count << 1;
     return ret4;
   }
   FallbackTo1PCLocks(kv_puts_lock, locks_for_1pc);
+  if (use_async_commit) {
+    g_txn_prewrite_async_commit_count << 1;
+  } else if (request_fast_commit) {
+    // some mutation fallback to 2PC, the locks generated before must not be treated as async commit lock
+    g_txn_prewrite_fallback_2pc_count << 1;
+    FallbackTo2PCLocks(kv_puts_lock);
+  }
   return DoPreWrite(raft_engine, ctx, region->Id(), start_ts, mutations.size(), kv_puts_data, kv_puts_lock);
 }
 
@@ -3027,6 +3605,7 @@ butil::Status TxnEngineHelper::Commit(RawEnginePtr raw_engine, std::shared_ptr<E
 
   // create reader and writer
   TxnReader txn_reader(raw_engine);
+  txn_reader.SetRegion(region);
   auto ret_init = txn_reader.Init();
   if (!ret_init.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] Commit", region->Id())
@@ -3227,6 +3806,54 @@ butil::Status TxnEngineHelper::DoTxnCommit(RawEnginePtr raw_engine, std::shared_
   pb::raft::TxnRaftRequest txn_raft_request;
   auto *cf_put_delete = txn_raft_request.mutable_multi_cf_put_and_delete();
 
+  auto ret = GenCommitData(reader, region, lock_infos, start_ts, commit_ts, cf_put_delete, kv_puts_write,
+                           kv_deletes_lock);
+  if (!ret.ok()) {
+    return ret;
+  }
+
+  if (kv_puts_write.empty() && kv_deletes_lock.empty()) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+        << fmt::format("[txn][region({})] DoTxnCommit, start_ts: {} commit_ts: {}", region->Id(), start_ts, commit_ts)
+        << ", kv_puts_write is empty and kv_deletes_lock is empty";
+    return butil::Status::OK();
+  }
+
+  // after all mutations is processed, write into raft engine
+  if (!kv_puts_write.empty()) {
+    auto *write_puts = cf_put_delete->add_puts_with_cf();
+    write_puts->set_cf_name(Constant::kTxnWriteCF);
+    for (auto &kv_put : kv_puts_write) {
+      auto *kv = write_puts->add_kvs();
+      kv->set_key(kv_put.key());
+      kv->set_value(kv_put.value());
+    }
+  }
+
+  if (!kv_deletes_lock.empty()) {
+    auto *lock_dels = cf_put_delete->add_deletes_with_cf();
+    lock_dels->set_cf_name(Constant::kTxnLockCF);
+    for (auto &kv_del : kv_deletes_lock) {
+      lock_dels->add_keys(kv_del);
+    }
+  }
+
+  ret = raft_engine->Write(ctx, WriteDataBuilder::BuildWrite(txn_raft_request));
+  if (ret.error_code() == EPERM) {
+    DINGO_LOG(ERROR) << fmt::format("[txn][region({})] DoTxnCommit, start_ts: {} commit_ts: {}", region->Id(), start_ts,
+                                    commit_ts)
+                     << ", write to raft engine failed, status: " << ret.error_str();
+    return butil::Status(pb::error::Errno::ERAFT_NOTLEADER, ret.error_str());
+  }
+
+  return ret;
+}
+
+butil::Status TxnEngineHelper::GenCommitData(RawEngine::ReaderPtr reader, store::RegionPtr region,
+                                             const std::vector<pb::store::LockInfo> &lock_infos, int64_t start_ts,
+                                             int64_t commit_ts, pb::raft::MultiCfPutAndDeleteRequest *cf_put_delete,
+                                             std::vector<pb::common::KeyValue> &kv_puts_write,
+                                             std::vector<std::string> &kv_deletes_lock) {
   // for vector index region, commit to vector index
   auto *vector_add = cf_put_delete->mutable_vector_add();
   auto *vector_del = cf_put_delete->mutable_vector_del();
@@ -3337,48 +3964,14 @@ butil::Status TxnEngineHelper::DoTxnCommit(RawEnginePtr raw_engine, std::shared_
         } else {
           DINGO_LOG(FATAL) << fmt::format("[txn][region({})] DoTxnCommit, start_ts: {} commit_ts: {}", region->Id(),
                                           start_ts, commit_ts)
-                           << ", invalid lock_type, key: " << Helper::StringToHex(lock_info.key())
-                           << ", lock_info: " << lock_info.ShortDebugString();
-        }
-      }
-    }
-  }
-
-  if (kv_puts_write.empty() && kv_deletes_lock.empty()) {
-    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
-        << fmt::format("[txn][region({})] DoTxnCommit, start_ts: {} commit_ts: {}", region->Id(), start_ts, commit_ts)
-        << ", kv_puts_write is empty and kv_deletes_lock is empty";
-    return butil::Status::OK();
-  }
-
-  // after all mutations is processed, write into raft engine
-  if (!kv_puts_write.empty()) {
-    auto *write_puts = cf_put_delete->add_puts_with_cf();
-    write_puts->set_cf_name(Constant::kTxnWriteCF);
-    for (auto &kv_put : kv_puts_write) {
-      auto *kv = write_puts->add_kvs();
-      kv->set_key(kv_put.key());
-      kv->set_value(kv_put.value());
-    }
-  }
-
-  if (!kv_deletes_lock.empty()) {
-    auto *lock_dels = cf_put_delete->add_deletes_with_cf();
-    lock_dels->set_cf_name(Constant::kTxnLockCF);
-    for (auto &kv_del : kv_deletes_lock) {
-      lock_dels->add_keys(kv_del);
+                           << ", invalid lock_type, key: " << Helper::StringToHex(lock_info.key())
+                           << ", lock_info: " << lock_info.ShortDebugString();
+        }
+      }
     }
   }
 
-  auto ret = raft_engine->Write(ctx, WriteDataBuilder::BuildWrite(txn_raft_request));
-  if (ret.error_code() == EPERM) {
-    DINGO_LOG(ERROR) << fmt::format("[txn][region({})] DoTxnCommit, start_ts: {} commit_ts: {}", region->Id(), start_ts,
-                                    commit_ts)
-                     << ", write to raft engine failed, status: " << ret.error_str();
-    return butil::Status(pb::error::Errno::ERAFT_NOTLEADER, ret.error_str());
-  }
-
-  return ret;
+  return butil::Status::OK();
 }
 
 bvar::LatencyRecorder g_txn_check_txn_status_latency("dingo_txn_check_txn_status");
@@ -3416,6 +4009,7 @@ butil::Status TxnEngineHelper::CheckTxnStatus(RawEnginePtr raw_engine, std::shar
 
   // create reader and writer
   TxnReader txn_reader(raw_engine);
+  txn_reader.SetRegion(region);
   auto ret_init = txn_reader.Init();
   if (!ret_init.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] CheckTxnStatus", region->Id()) << ", init txn_reader failed";
@@ -3664,6 +4258,7 @@ butil::Status TxnEngineHelper::BatchRollback(RawEnginePtr raw_engine, std::share
 
   // create reader and writer
   TxnReader txn_reader(raw_engine);
+  txn_reader.SetRegion(region);
   auto ret_init = txn_reader.Init();
   if (!ret_init.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] BatchRollback", region->Id())
@@ -3785,38 +4380,8 @@ butil::Status TxnEngineHelper::DoRollback(RawEnginePtr /*raw_engine*/, std::shar
   std::vector<std::string> kv_deletes_lock;
   std::vector<std::string> kv_deletes_data;
 
-  for (const auto &key : keys_to_rollback_without_data) {
-    // delete lock
-    kv_deletes_lock.emplace_back(mvcc::Codec::EncodeKey(key, Constant::kLockVer));
-
-    // add write
-    pb::store::WriteInfo write_info;
-    write_info.set_start_ts(start_ts);
-    write_info.set_op(::dingodb::pb::store::Op::Rollback);
-
-    pb::common::KeyValue kv;
-    kv.set_key(mvcc::Codec::EncodeKey(key, start_ts));
-    kv.set_value(write_info.SerializeAsString());
-    kv_puts_write.emplace_back(kv);
-  }
-
-  for (const auto &key : keys_to_rollback_with_data) {
-    // delete lock
-    kv_deletes_lock.emplace_back(mvcc::Codec::EncodeKey(key, Constant::kLockVer));
-
-    // delete data
-    kv_deletes_data.emplace_back(mvcc::Codec::EncodeKey(key, start_ts));
-
-    // add write
-    pb::store::WriteInfo write_info;
-    write_info.set_start_ts(start_ts);
-    write_info.set_op(::dingodb::pb::store::Op::Rollback);
-
-    pb::common::KeyValue kv;
-    kv.set_key(mvcc::Codec::EncodeKey(key, start_ts));
-    kv.set_value(write_info.SerializeAsString());
-    kv_puts_write.emplace_back(kv);
-  }
+  GenRollbackData(keys_to_rollback_with_data, keys_to_rollback_without_data, start_ts, kv_puts_write, kv_deletes_lock,
+                  kv_deletes_data);
 
   if (kv_puts_write.empty() && kv_deletes_lock.empty() && kv_deletes_data.empty()) {
     DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail) << "[txn]Rollback nothing to do, start_ts: " << start_ts;
@@ -3863,6 +4428,45 @@ butil::Status TxnEngineHelper::DoRollback(RawEnginePtr /*raw_engine*/, std::shar
   return ret;
 }
 
+void TxnEngineHelper::GenRollbackData(const std::vector<std::string> &keys_to_rollback_with_data,
+                                      const std::vector<std::string> &keys_to_rollback_without_data, int64_t start_ts,
+                                      std::vector<pb::common::KeyValue> &kv_puts_write,
+                                      std::vector<std::string> &kv_deletes_lock,
+                                      std::vector<std::string> &kv_deletes_data) {
+  for (const auto &key : keys_to_rollback_without_data) {
+    // delete lock
+    kv_deletes_lock.emplace_back(mvcc::Codec::EncodeKey(key, Constant::kLockVer));
+
+    // add write
+    pb::store::WriteInfo write_info;
+    write_info.set_start_ts(start_ts);
+    write_info.set_op(::dingodb::pb::store::Op::Rollback);
+
+    pb::common::KeyValue kv;
+    kv.set_key(mvcc::Codec::EncodeKey(key, start_ts));
+    kv.set_value(write_info.SerializeAsString());
+    kv_puts_write.emplace_back(kv);
+  }
+
+  for (const auto &key : keys_to_rollback_with_data) {
+    // delete lock
+    kv_deletes_lock.emplace_back(mvcc::Codec::EncodeKey(key, Constant::kLockVer));
+
+    // delete data
+    kv_deletes_data.emplace_back(mvcc::Codec::EncodeKey(key, start_ts));
+
+    // add write
+    pb::store::WriteInfo write_info;
+    write_info.set_start_ts(start_ts);
+    write_info.set_op(::dingodb::pb::store::Op::Rollback);
+
+    pb::common::KeyValue kv;
+    kv.set_key(mvcc::Codec::EncodeKey(key, start_ts));
+    kv.set_value(write_info.SerializeAsString());
+    kv_puts_write.emplace_back(kv);
+  }
+}
+
 // MarkRollBackOnMissingLock
 butil::Status TxnEngineHelper::MarkRollBackOnMissingLock(RawEnginePtr /*raw_engine*/,
                                                          std::shared_ptr<Engine> raft_engine,
@@ -3925,6 +4529,7 @@ butil::Status TxnEngineHelper::TxnCheckSecondaryLocks(RawEnginePtr raw_engine, s
   }
 
   TxnReader txn_reader(raw_engine);
+  txn_reader.SetRegion(region);
   auto ret_init = txn_reader.Init();
   if (!ret_init.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] CheckSecondaryLocks", region->Id())
@@ -4014,89 +4619,177 @@ butil::Status TxnEngineHelper::TxnCheckSecondaryLocks(RawEnginePtr raw_engine, s
 
 bvar::LatencyRecorder g_txn_resolve_lock_latency("dingo_txn_resolve_lock");
 
+// Write the data of many resolved txns in one raft request.
+static butil::Status WriteBatchResolveLockData(std::shared_ptr<Engine> raft_engine, std::shared_ptr<Context> ctx,
+                                               store::RegionPtr region, pb::raft::TxnRaftRequest &txn_raft_request,
+                                               std::vector<pb::common::KeyValue> &kv_puts_write,
+                                               std::vector<std::string> &kv_deletes_lock,
+                                               std::vector<std::string> &kv_deletes_data) {
+  if (kv_puts_write.empty() && kv_deletes_lock.empty() && kv_deletes_data.empty()) {
+    return butil::Status::OK();
+  }
+
+  auto *cf_put_delete = txn_raft_request.mutable_multi_cf_put_and_delete();
+  if (!kv_puts_write.empty()) {
+    auto *write_puts = cf_put_delete->add_puts_with_cf();
+    write_puts->set_cf_name(Constant::kTxnWriteCF);
+    for (auto &kv_put : kv_puts_write) {
+      auto *kv = write_puts->add_kvs();
+      kv->set_key(kv_put.key());
+      kv->set_value(kv_put.value());
+    }
+  }
+
+  if (!kv_deletes_lock.empty()) {
+    auto *lock_dels = cf_put_delete->add_deletes_with_cf();
+    lock_dels->set_cf_name(Constant::kTxnLockCF);
+    for (auto &key_del : kv_deletes_lock) {
+      lock_dels->add_keys(key_del);
+    }
+  }
+
+  if (!kv_deletes_data.empty()) {
+    auto *data_dels = cf_put_delete->add_deletes_with_cf();
+    data_dels->set_cf_name(Constant::kTxnDataCF);
+    for (auto &key_del : kv_deletes_data) {
+      data_dels->add_keys(key_del);
+    }
+  }
+
+  DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+      << fmt::format("[txn][region({})] BatchResolveLock, write lock count: {} write count: {}", region->Id(),
+                     kv_deletes_lock.size(), kv_puts_write.size());
+
+  auto ret = raft_engine->Write(ctx, WriteDataBuilder::BuildWrite(txn_raft_request));
+
+  txn_raft_request.Clear();
+  kv_puts_write.clear();
+  kv_deletes_lock.clear();
+  kv_deletes_data.clear();
+
+  if (ret.error_code() == EPERM) {
+    DINGO_LOG(ERROR) << fmt::format("[txn][region({})] BatchResolveLock, write to raft engine failed, status: {}",
+                                    region->Id(), ret.error_str());
+    return butil::Status(pb::error::Errno::ERAFT_NOTLEADER, ret.error_str());
+  }
+
+  return ret;
+}
+
 butil::Status TxnEngineHelper::BatchResolveLock(RawEnginePtr raw_engine, std::shared_ptr<Engine> raft_engine,
                                                 std::shared_ptr<Context> ctx, store::RegionPtr region,
                                                 const std::map<int64_t, int64_t> &txn_infos,
                                                 pb::store::TxnResultInfo *txn_result) {
   if (txn_infos.empty()) return butil::Status::OK();
 
-  for (const auto &[start_ts, commit_ts] : txn_infos) {
-    std::vector<std::string> keys_to_rollback;
+  // scan lock cf once for all txns, lock_ts is in [min_lock_ts, max_lock_ts)
+  int64_t min_lock_ts = txn_infos.begin()->first;
+  int64_t max_lock_ts = txn_infos.rbegin()->first + 1;
 
-    std::vector<pb::store::LockInfo> lock_infos_to_commit;
-    std::vector<std::string> keys_to_rollback_with_data;
-    std::vector<std::string> keys_to_rollback_without_data;
+  auto reader = raw_engine->Reader();
+
+  pb::raft::TxnRaftRequest txn_raft_request;
+  std::vector<pb::common::KeyValue> kv_puts_write;
+  std::vector<std::string> kv_deletes_lock;
+  std::vector<std::string> kv_deletes_data;
 
-    auto stream = Stream::New(FLAGS_stream_message_max_limit_size);
+  // stream keep the iterator position between batches
+  auto stream = Stream::New(FLAGS_stream_message_max_limit_size);
+  std::string last_key;
+  bool has_more = true;
+  while (has_more) {
+    has_more = false;
     std::vector<pb::store::LockInfo> tmp_lock_infos;
-    bool has_more = false;
     std::string end_key{};
-    auto ret = ScanLockInfo(stream, raw_engine, start_ts, start_ts + 1, region->Range(false), 0, tmp_lock_infos,
+    auto ret = ScanLockInfo(stream, raw_engine, min_lock_ts, max_lock_ts, region->Range(false), 0, tmp_lock_infos,
                             has_more, end_key);
     if (!ret.ok()) {
       DINGO_LOG(FATAL) << fmt::format("[txn][region({})] BatchResolveLock, ", region->Id())
-                       << ", get lock info failed, start_ts: " << start_ts << ", status: " << ret.error_str();
+                       << ", get lock info failed, lock_ts: [" << min_lock_ts << "," << max_lock_ts
+                       << "), status: " << ret.error_str();
     }
 
+    std::map<int64_t, std::vector<pb::store::LockInfo>> lock_infos_to_commit;
+    std::map<int64_t, std::vector<std::string>> keys_to_rollback_with_data;
+    std::map<int64_t, std::vector<std::string>> keys_to_rollback_without_data;
+
     for (const auto &lock_info : tmp_lock_infos) {
+      // the last lock of previous batch is scanned again when has_more
+      if (!last_key.empty() && lock_info.key() == last_key) {
+        continue;
+      }
+      last_key = lock_info.key();
+
+      auto it = txn_infos.find(lock_info.lock_ts());
+      if (it == txn_infos.end()) {
+        continue;
+      }
+      int64_t start_ts = it->first;
+      int64_t commit_ts = it->second;
+
       // if the lock is a pessimistic lock, can't do resolvelock
       if (lock_info.lock_type() == pb::store::Op::Lock) {
         DINGO_LOG(ERROR) << fmt::format("[txn][region({})] BatchResolveLock,", region->Id())
                          << ", pessimistic lock, can't do resolvelock, key: " << lock_info.key()
                          << ", start_ts: " << start_ts << ", lock_info: " << lock_info.ShortDebugString();
         *txn_result->mutable_locked() = lock_info;
-        return butil::Status::OK();
+        return WriteBatchResolveLockData(raft_engine, ctx, region, txn_raft_request, kv_puts_write, kv_deletes_lock,
+                                         kv_deletes_data);
       } else if (lock_info.lock_type() != pb::store::Op::Put && lock_info.lock_type() != pb::store::Op::Delete &&
                  lock_info.lock_type() != pb::store::Op::PutIfAbsent) {
         DINGO_LOG(ERROR) << fmt::format("[txn][region({})] BatchResolveLock,", region->Id())
                          << ", invalid lock_type, key: " << lock_info.key() << ", start_ts: " << start_ts
                          << ", lock_info: " << lock_info.ShortDebugString();
         *txn_result->mutable_locked() = lock_info;
-        return butil::Status::OK();
+        return WriteBatchResolveLockData(raft_engine, ctx, region, txn_raft_request, kv_puts_write, kv_deletes_lock,
+                                         kv_deletes_data);
       }
 
       // prepare to do rollback or commit
       const std::string &key = lock_info.key();
       if (commit_ts > 0) {
         // do commit
-        lock_infos_to_commit.push_back(lock_info);
+        lock_infos_to_commit[start_ts].push_back(lock_info);
       } else {
+        DINGO_LOG(INFO) << fmt::format("[txn][region({})] BatchResolveLock, ", region->Id()) << "primary key:" << key
+                        << ", do rollback, start_ts: " << start_ts;
         if (lock_info.short_value().empty()) {
-          keys_to_rollback_with_data.push_back(key);
+          keys_to_rollback_with_data[start_ts].push_back(key);
         } else {
-          keys_to_rollback_without_data.push_back(key);
+          keys_to_rollback_without_data[start_ts].push_back(key);
         }
       }
     }
 
-    if (!lock_infos_to_commit.empty()) {
-      auto ret = DoTxnCommit(raw_engine, raft_engine, ctx, region, lock_infos_to_commit, start_ts, commit_ts);
+    // merge commit and rollback of all txns into one raft write
+    for (const auto &[start_ts, lock_infos] : lock_infos_to_commit) {
+      auto ret = GenCommitData(reader, region, lock_infos, start_ts, txn_infos.at(start_ts),
+                               txn_raft_request.mutable_multi_cf_put_and_delete(), kv_puts_write, kv_deletes_lock);
       if (!ret.ok()) {
         DINGO_LOG(ERROR) << fmt::format("[txn][region({})] BatchResolveLock, ", region->Id())
-                         << ", do txn commit failed, start_ts: " << start_ts << ", status: " << ret.error_str();
+                         << ", gen commit data failed, start_ts: " << start_ts << ", status: " << ret.error_str();
         return ret;
       }
     }
 
-    if (!keys_to_rollback_with_data.empty() || !keys_to_rollback_without_data.empty()) {
-      for (auto const &key : keys_to_rollback_with_data) {
-        DINGO_LOG(INFO) << fmt::format("[txn][region({})] BatchResolveLock, ", region->Id()) << "primary key:" << key
-                        << ", do rollback with data, start_ts: " << start_ts;
-      }
-      for (auto const &key : keys_to_rollback_without_data) {
-        DINGO_LOG(INFO) << fmt::format("[txn][region({})] BatchResolveLock, ", region->Id()) << "primary key:" << key
-                        << ", do rollback without data, start_ts: " << start_ts;
-      }
-      auto ret =
-          DoRollback(raw_engine, raft_engine, ctx, keys_to_rollback_with_data, keys_to_rollback_without_data, start_ts);
+    for (const auto &[start_ts, keys] : keys_to_rollback_with_data) {
+      GenRollbackData(keys, {}, start_ts, kv_puts_write, kv_deletes_lock, kv_deletes_data);
+    }
+    for (const auto &[start_ts, keys] : keys_to_rollback_without_data) {
+      GenRollbackData({}, keys, start_ts, kv_puts_write, kv_deletes_lock, kv_deletes_data);
+    }
+
+    if (static_cast<int64_t>(kv_deletes_lock.size()) >= FLAGS_txn_batch_resolve_lock_write_count) {
+      auto ret = WriteBatchResolveLockData(raft_engine, ctx, region, txn_raft_request, kv_puts_write, kv_deletes_lock,
+                                           kv_deletes_data);
       if (!ret.ok()) {
-        DINGO_LOG(ERROR) << fmt::format("[txn][region({})] BatchResolveLock, ", region->Id())
-                         << ", rollback failed, start_ts: " << start_ts << ", status: " << ret.error_str();
         return ret;
       }
     }
   }
-  return butil::Status::OK();
+
+  return WriteBatchResolveLockData(raft_engine, ctx, region, txn_raft_request, kv_puts_write, kv_deletes_lock,
+                                   kv_deletes_data);
 }
 
 butil::Status TxnEngineHelper::ResolveLock(RawEnginePtr raw_engine, std::shared_ptr<Engine> raft_engine,
@@ -4129,6 +4822,7 @@ butil::Status TxnEngineHelper::ResolveLock(RawEnginePtr raw_engine, std::shared_
   // if not exists, do nothing
   // create reader and writer
   TxnReader txn_reader(raw_engine);
+  txn_reader.SetRegion(region);
   auto ret_init = txn_reader.Init();
   if (!ret_init.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] ResolveLock", region->Id())
@@ -4309,6 +5003,7 @@ butil::Status TxnEngineHelper::HeartBeat(RawEnginePtr raw_engine, std::shared_pt
   auto *txn_result = response->mutable_txn_result();
 
   TxnReader txn_reader(raw_engine);
+  txn_reader.SetRegion(region);
   auto ret_init = txn_reader.Init();
   if (!ret_init.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] HeartBeat", region->Id())
@@ -4546,6 +5241,7 @@ butil::Status TxnEngineHelper::DoGcCoreTxn(RawEnginePtr raw_engine, std::shared_
   IteratorOptions write_iter_options;
   write_iter_options.lower_bound = mvcc::Codec::EncodeKey(region_start_key, Constant::kMaxVer);
   write_iter_options.upper_bound = mvcc::Codec::EncodeKey(region_end_key, Constant::kMaxVer);
+  write_iter_options.scan_class = ScanClass::kGc;
 
   auto write_iter = reader->NewIterator(Constant::kTxnWriteCF, snapshot, write_iter_options);
   if (nullptr == write_iter) {
@@ -4814,6 +5510,7 @@ butil::Status TxnEngineHelper::DoGcCoreNonTxn(RawEnginePtr raw_engine, std::shar
   IteratorOptions default_iter_options;
   default_iter_options.lower_bound = mvcc::Codec::EncodeKey(region_start_key, Constant::kMaxVer);
   default_iter_options.upper_bound = mvcc::Codec::EncodeKey(region_end_key, Constant::kMaxVer);
+  default_iter_options.scan_class = ScanClass::kGc;
 
   const std::string &cf_name =
       (type == pb::common::RegionType::INDEX_REGION ? Constant::kVectorDataCF : Constant::kStoreDataCF);
@@ -5141,6 +5838,7 @@ butil::Status TxnEngineHelper::CheckLockForTxnGc(RawEngine::ReaderPtr reader, st
   IteratorOptions lock_iter_options;
   lock_iter_options.lower_bound = mvcc::Codec::EncodeKey(start_key, Constant::kLockVer);
   lock_iter_options.upper_bound = mvcc::Codec::EncodeKey(end_key, 0);
+  lock_iter_options.scan_class = ScanClass::kGc;
 
   std::shared_ptr<dingodb::Iterator> lock_iter = reader->NewIterator(Constant::kTxnLockCF, snapshot, lock_iter_options);
   if (nullptr == lock_iter) {
@@ -5218,6 +5916,28 @@ butil::Status TxnEngineHelper::CheckLockForTxnGc(RawEngine::ReaderPtr reader, st
 
 bvar::LatencyRecorder g_txn_raft_engine_write_for_gc_latency("dingo_txn_raft_engine_write_for_gc");
 
+// Limit gc write bytes of all regions, every write wait until its turn of the rate.
+static void ThrottleTxnGcWrite(int64_t bytes) {
+  int64_t max_bytes_per_second = FLAGS_txn_gc_max_bytes_per_second;
+  if (max_bytes_per_second <= 0) {
+    return;
+  }
+
+  static std::atomic<int64_t> g_next_write_time_us{0};
+
+  int64_t cost_us = bytes * 1000000 / max_bytes_per_second;
+  int64_t now_us = Helper::TimestampUs();
+  int64_t next_write_time_us = g_next_write_time_us.load();
+  int64_t write_time_us = 0;
+  do {
+    write_time_us = std::max(now_us, next_write_time_us);
+  } while (!g_next_write_time_us.compare_exchange_weak(next_write_time_us, write_time_us + cost_us));
+
+  if (write_time_us > now_us) {
+    bthread_usleep(write_time_us - now_us);
+  }
+}
+
 butil::Status TxnEngineHelper::RaftEngineWriteForTxnGc(std::shared_ptr<Engine> raft_engine,
                                                        std::shared_ptr<Context> ctx,
                                                        const std::vector<std::string> &kv_deletes_lock,
@@ -5273,6 +5993,8 @@ butil::Status TxnEngineHelper::RaftEngineWriteForTxnGc(std::shared_ptr<Engine> r
     return butil::Status::OK();
   }
 
+  ThrottleTxnGcWrite(txn_raft_request.ByteSizeLong());
+
   return RaftEngineWrite(raft_engine, ctx, txn_raft_request, tenant_id, type, "RaftEngineWriteForTxnGc");
 #endif
 }
@@ -5611,6 +6333,106 @@ void TxnEngineHelper::RegularUpdateSafePointTsHandler(void * /*arg*/) {
 #endif
 #undef ENABLE_TXN_GC_REMEMBER_LAST_ACCOMPLISHED_SAFE_POINT_TS
 
+struct TxnGcTaskArg {
+  std::vector<store::RegionPtr> regions;
+  std::atomic<int64_t> offset{0};
+  std::shared_ptr<Storage> storage;
+  std::shared_ptr<GCSafePointManager> gc_safe_point_manager;
+  std::map<int64_t, std::pair<bool, int64_t>> safe_point_ts_group;
+};
+
+static void DoGcForRegion(TxnGcTaskArg *arg, const store::RegionPtr &region_ptr) {
+  auto &storage = arg->storage;
+  auto &gc_safe_point_manager = arg->gc_safe_point_manager;
+  auto &safe_point_ts_group = arg->safe_point_ts_group;
+
+  butil::Status status;
+
+  auto definition = region_ptr->Definition();
+  int64_t tenant_id = definition.tenant_id();
+
+  status = storage->ValidateLeader(region_ptr);
+  if (!status.ok()) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_gc_detail)
+        << fmt::format("[txn_gc][tenant({})][region({})]  is not leader yet. start_key : {} end_key : {}. ignore.",
+                       tenant_id, region_ptr->Id(), Helper::StringToHex(region_ptr->Range().start_key()),
+                       Helper::StringToHex(region_ptr->Range().end_key()));
+    return;
+  } else {
+    if (pb::common::StoreRegionState::NORMAL != region_ptr->State()) {
+      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_gc_detail) << fmt::format(
+          "[txn_gc][tenant({})][region({})] is leader. but state is not normal : {}.  start_key : {} end_key : {}. "
+          " "
+          "ignore.",
+          tenant_id, region_ptr->Id(), static_cast<int>(region_ptr->State()),
+          Helper::StringToHex(region_ptr->Range().start_key()), Helper::StringToHex(region_ptr->Range().end_key()));
+      return;
+    }
+  }
+
+  auto [internal_gc_stop, internal_safe_point_ts] = gc_safe_point_manager->GetGcFlagAndSafePointTs(tenant_id);
+  auto gc_safe_point = gc_safe_point_manager->FindSafePoint(tenant_id);
+
+  if (internal_gc_stop) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_gc_detail) << fmt::format(
+        "[txn_gc][tenant({})][region({})] set internal_gc_stop stop,  start_key : {} end_key : {} ignore.", tenant_id,
+        region_ptr->Id(), Helper::StringToHex(region_ptr->Range().start_key()),
+        Helper::StringToHex(region_ptr->Range().end_key()));
+    gc_safe_point->SetGcStop(true);
+    return;
+  }
+
+  auto safe_point_ts = safe_point_ts_group.at(tenant_id).second;
+
+  if (safe_point_ts < internal_safe_point_ts) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_gc_detail) << fmt::format(
+        "[txn_gc][tenant({})][region({})] current safe_point_ts : {}. newest safe_point_ts : {}. Don't worry, "
+        "we'll "
+        "deal with it next time. ignore.",
+        tenant_id, region_ptr->Id(), safe_point_ts, internal_safe_point_ts);
+  }
+
+  dingodb::pb::store::TxnGcRequest request;
+  dingodb::pb::store::TxnGcResponse response;
+
+  std::shared_ptr<Context> ctx = std::make_shared<Context>(nullptr, nullptr, &request, &response);
+  ctx->SetRegionId(region_ptr->Id());
+  ctx->SetCfName(Constant::kStoreDataCF);
+  ctx->SetRegionEpoch(region_ptr->Epoch());
+  ctx->SetIsolationLevel(::dingodb::pb::store::IsolationLevel::ReadCommitted);
+  ctx->SetRawEngineType(region_ptr->GetRawEngineType());
+  ctx->SetStoreEngineType(region_ptr->GetStoreEngineType());
+
+  auto writer = storage->GetEngineTxnWriter(ctx->StoreEngineType(), ctx->RawEngineType());
+
+  status = writer->TxnGc(ctx, safe_point_ts);
+
+  if (gc_safe_point->GetGcStop()) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_gc_detail)
+        << fmt::format("[txn_gc][tenant({})][region({})]  gc_stop stopped,  start_key : {} end_key : {}. ignore.",
+                       tenant_id, ctx->RegionId(), Helper::StringToHex(region_ptr->Range().start_key()),
+                       Helper::StringToHex(region_ptr->Range().end_key()));
+    return;
+  }
+
+#if defined(ENABLE_TXN_GC_REMEMBER_LAST_ACCOMPLISHED_SAFE_POINT_TS)
+  gc_safe_point->SetLastAccomplishedSafePointTs(safe_point_ts);
+#endif
+}
+
+static void *DoGcRoutine(void *arg) {
+  auto *gc_arg = static_cast<TxnGcTaskArg *>(arg);
+  for (;;) {
+    int64_t offset = gc_arg->offset.fetch_add(1);
+    if (offset >= static_cast<int64_t>(gc_arg->regions.size())) {
+      break;
+    }
+    DoGcForRegion(gc_arg, gc_arg->regions[offset]);
+  }
+
+  return nullptr;
+}
+
 void TxnEngineHelper::RegularDoGcHandler(void * /*arg*/) {
   static std::atomic<bool> g_regular_do_gc_handler_running(false);
 
@@ -5639,6 +6461,7 @@ void TxnEngineHelper::RegularDoGcHandler(void * /*arg*/) {
   }
 
   if (all_gc_stop) {
+    TxnGcCompactionFilterFactory::SetSafePointTs(0);
     DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_gc_detail) << fmt::format("[txn_gc] set gc_flag stop, return.");
     for (auto [tenant_id, safe_point_ts_pair] : safe_point_ts_group) {
       DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_gc_detail) << fmt::format(
@@ -5693,6 +6516,15 @@ void TxnEngineHelper::RegularDoGcHandler(void * /*arg*/) {
     return;
   }
 
+  // Compaction filter drop versions of all regions on this store, so use the min safe point of all tenants.
+  // Only store role, vector/document index need be updated with gc of index region.
+  int64_t compaction_filter_safe_point_ts = 0;
+  if ((FLAGS_enable_txn_gc_compaction_filter || FLAGS_enable_mvcc_ttl_compaction_filter) &&
+      GetRole() == pb::common::ClusterRole::STORE) {
+    compaction_filter_safe_point_ts = gc_safe_point_manager->GetMinSafePointTs();
+  }
+  TxnGcCompactionFilterFactory::SetSafePointTs(compaction_filter_safe_point_ts);
+
   std::vector<store::RegionPtr> region_ptrs = Server::GetInstance().GetAllAliveRegion();
 
   std::vector<store::RegionPtr> leader_region_ptrs;
@@ -5733,79 +6565,21 @@ void TxnEngineHelper::RegularDoGcHandler(void * /*arg*/) {
 
   // Caution !!!
   // We will not use a snapshot globally because it will affect other region compaction.
-  for (const auto &region_ptr : leader_region_ptrs) {
-    butil::Status status;
-
-    auto definition = region_ptr->Definition();
-    int64_t tenant_id = definition.tenant_id();
-
-    status = storage->ValidateLeader(region_ptr);
-    if (!status.ok()) {
-      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_gc_detail)
-          << fmt::format("[txn_gc][tenant({})][region({})]  is not leader yet. start_key : {} end_key : {}. ignore.",
-                         tenant_id, region_ptr->Id(), Helper::StringToHex(region_ptr->Range().start_key()),
-                         Helper::StringToHex(region_ptr->Range().end_key()));
-      continue;
-    } else {
-      if (pb::common::StoreRegionState::NORMAL != region_ptr->State()) {
-        DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_gc_detail) << fmt::format(
-            "[txn_gc][tenant({})][region({})] is leader. but state is not normal : {}.  start_key : {} end_key : {}. "
-            " "
-            "ignore.",
-            tenant_id, region_ptr->Id(), static_cast<int>(region_ptr->State()),
-            Helper::StringToHex(region_ptr->Range().start_key()), Helper::StringToHex(region_ptr->Range().end_key()));
-        continue;
-      }
-    }
-
-    auto [internal_gc_stop, internal_safe_point_ts] = gc_safe_point_manager->GetGcFlagAndSafePointTs(tenant_id);
-    auto gc_safe_point = gc_safe_point_manager->FindSafePoint(tenant_id);
-
-    if (internal_gc_stop) {
-      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_gc_detail) << fmt::format(
-          "[txn_gc][tenant({})][region({})] set internal_gc_stop stop,  start_key : {} end_key : {} ignore.", tenant_id,
-          region_ptr->Id(), Helper::StringToHex(region_ptr->Range().start_key()),
-          Helper::StringToHex(region_ptr->Range().end_key()));
-      gc_safe_point->SetGcStop(true);
-      continue;
-    }
-
-    auto safe_point_ts = safe_point_ts_group[tenant_id].second;
-
-    if (safe_point_ts < internal_safe_point_ts) {
-      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_gc_detail) << fmt::format(
-          "[txn_gc][tenant({})][region({})] current safe_point_ts : {}. newest safe_point_ts : {}. Don't worry, "
-          "we'll "
-          "deal with it next time. ignore.",
-          tenant_id, region_ptr->Id(), safe_point_ts, internal_safe_point_ts);
-    }
-
-    dingodb::pb::store::TxnGcRequest request;
-    dingodb::pb::store::TxnGcResponse response;
-
-    std::shared_ptr<Context> ctx = std::make_shared<Context>(nullptr, nullptr, &request, &response);
-    ctx->SetRegionId(region_ptr->Id());
-    ctx->SetCfName(Constant::kStoreDataCF);
-    ctx->SetRegionEpoch(region_ptr->Epoch());
-    ctx->SetIsolationLevel(::dingodb::pb::store::IsolationLevel::ReadCommitted);
-    ctx->SetRawEngineType(region_ptr->GetRawEngineType());
-    ctx->SetStoreEngineType(region_ptr->GetStoreEngineType());
-
-    auto writer = storage->GetEngineTxnWriter(ctx->StoreEngineType(), ctx->RawEngineType());
-
-    status = writer->TxnGc(ctx, safe_point_ts);
-
-    if (gc_safe_point->GetGcStop()) {
-      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_gc_detail)
-          << fmt::format("[txn_gc][tenant({})][region({})]  gc_stop stopped,  start_key : {} end_key : {}. ignore.",
-                         tenant_id, ctx->RegionId(), Helper::StringToHex(region_ptr->Range().start_key()),
-                         Helper::StringToHex(region_ptr->Range().end_key()));
+  auto gc_arg = std::make_shared<TxnGcTaskArg>();
+  gc_arg->storage = storage;
+  gc_arg->gc_safe_point_manager = gc_safe_point_manager;
+  gc_arg->safe_point_ts_group = safe_point_ts_group;
+  for (auto &region_ptr : leader_region_ptrs) {
+    // Store region versions are dropped by compaction filter.
+    if (compaction_filter_safe_point_ts > 0 && region_ptr->Type() == pb::common::STORE_REGION) {
       continue;
     }
+    gc_arg->regions.push_back(region_ptr);
+  }
 
-#if defined(ENABLE_TXN_GC_REMEMBER_LAST_ACCOMPLISHED_SAFE_POINT_TS)
-    gc_safe_point->SetLastAccomplishedSafePointTs(safe_point_ts);
-#endif
+  int concurrency = std::min(FLAGS_txn_gc_concurrency, static_cast<int>(gc_arg->regions.size()));
+  if (concurrency <= 1 || !Helper::ParallelRunTask(&DoGcRoutine, gc_arg.get(), concurrency)) {
+    DoGcRoutine(gc_arg.get());
   }
 
   DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_gc_detail) << fmt::format("[txn_gc] gc task end.");
@@ -5933,6 +6707,7 @@ butil::Status TxnEngineHelper::DoBackupDataCoreTxn(std::shared_ptr<Context> ctx,
   IteratorOptions write_iter_options;
   write_iter_options.lower_bound = mvcc::Codec::EncodeKey(region_start_key, Constant::kMaxVer);
   write_iter_options.upper_bound = mvcc::Codec::EncodeKey(region_end_key, Constant::kMaxVer);
+  write_iter_options.scan_class = ScanClass::kBackup;
 
   auto write_iter = reader->NewIterator(Constant::kTxnWriteCF, snapshot, write_iter_options);
   if (nullptr == write_iter) {
@@ -6081,6 +6856,7 @@ butil::Status TxnEngineHelper::DoBackupDataCoreNonTxn(std::shared_ptr<Context> c
   IteratorOptions default_iter_options;
   default_iter_options.lower_bound = mvcc::Codec::EncodeKey(region_start_key, Constant::kMaxVer);
   default_iter_options.upper_bound = mvcc::Codec::EncodeKey(region_end_key, Constant::kMaxVer);
+  default_iter_options.scan_class = ScanClass::kBackup;
 
   const std::string &cf_name =
       (region_type == pb::common::RegionType::INDEX_REGION ? Constant::kVectorDataCF : Constant::kStoreDataCF);
@@ -6429,6 +7205,11 @@ butil::Status TxnEngineHelper::DoWriteSstFile(store::RegionPtr region, int64_t i
   }
 
   rocksdb::Options options;
+  // backup file is written once and read once, trade cpu for less io and storage.
+  if (FLAGS_enable_backup_sst_compression) {
+    options.compression = rocksdb::CompressionType::kZSTD;
+    options.compression_opts.level = FLAGS_backup_sst_compression_level;
+  }
   rocks::SstFileWriter sst(options);
   std::string base_path = storage_backend.local().path();
   std::string dir_name = fmt::format("{}-{}", region_type_name, instance_id);
@@ -6544,6 +7325,27 @@ butil::Status TxnEngineHelper::BackupMeta(std::shared_ptr<Context> ctx, RawEngin
   return butil::Status();
 }
 
+// Store region apply large sorted put by ingest sst on every replica when enable_bulk_ingest_put,
+// so restore write larger batch, raft log just carry the kvs and replicas write them at disk speed.
+static bool IsRestoreByIngest(store::RegionPtr region) {
+  return FLAGS_enable_bulk_ingest_put && region->Type() == pb::common::STORE_REGION;
+}
+
+static bool IsRestoreBatchFull(store::RegionPtr region, int64_t total_size, int64_t total_count) {
+  if (IsRestoreByIngest(region)) {
+    return total_size > FLAGS_max_restore_ingest_data_size;
+  }
+  return total_size > FLAGS_max_restore_data_memory_size || total_count > FLAGS_max_restore_count;
+}
+
+// kvs of several backup sst files are not sorted as a whole, ingest require sorted kvs.
+static void SortRestoreKvs(std::vector<pb::common::KeyValue> &kvs) {
+  auto less = [](const pb::common::KeyValue &lhs, const pb::common::KeyValue &rhs) { return lhs.key() < rhs.key(); };
+  if (!std::is_sorted(kvs.begin(), kvs.end(), less)) {
+    std::sort(kvs.begin(), kvs.end(), less);
+  }
+}
+
 butil::Status GetDataValue(const pb::store::WriteInfo &write_info,
                            const std::map<std::string, pb::common::KeyValue> &kv_puts_data_map,
                            const std::string &encode_key, std::string &data_value) {
@@ -6701,7 +7503,7 @@ butil::Status TxnEngineHelper::RestoreTxn(std::shared_ptr<Context> ctx, store::R
         }
       }
 
-      if (total_size > FLAGS_max_restore_data_memory_size || total_count > FLAGS_max_restore_count) {
+      if (IsRestoreBatchFull(region, total_size, total_count)) {
         auto ret = raft_engine->Write(ctx, WriteDataBuilder::BuildWrite(txn_raft_request));
         if (ret.error_code() == EPERM) {
           DINGO_LOG(ERROR) << fmt::format(
@@ -6733,7 +7535,7 @@ butil::Status TxnEngineHelper::RestoreTxn(std::shared_ptr<Context> ctx, store::R
       total_size += kv_put.key().size();
       total_size += kv_put.value().size();
 
-      if (total_size > FLAGS_max_restore_data_memory_size || total_count > FLAGS_max_restore_count) {
+      if (IsRestoreBatchFull(region, total_size, total_count)) {
         auto ret = raft_engine->Write(ctx, WriteDataBuilder::BuildWrite(txn_raft_request));
         if (ret.error_code() == EPERM) {
           DINGO_LOG(ERROR) << fmt::format(
@@ -6762,7 +7564,7 @@ butil::Status TxnEngineHelper::RestoreTxn(std::shared_ptr<Context> ctx, store::R
       total_size += kv_put.key().size();
       total_size += kv_put.value().size();
 
-      if (total_size > FLAGS_max_restore_data_memory_size || total_count > FLAGS_max_restore_count) {
+      if (IsRestoreBatchFull(region, total_size, total_count)) {
         auto ret = raft_engine->Write(ctx, WriteDataBuilder::BuildWrite(txn_raft_request));
         if (ret.error_code() == EPERM) {
           DINGO_LOG(ERROR) << fmt::format(
@@ -6818,7 +7620,7 @@ butil::Status TxnEngineHelper::RestoreNonTxnStore(std::shared_ptr<Context> ctx,
     total_size += kv_data.key().size();
     total_size += kv_data.value().size();
 
-    if (total_size > FLAGS_max_restore_data_memory_size || total_count > FLAGS_max_restore_count) {
+    if (IsRestoreBatchFull(region, total_size, total_count)) {
       ret = raft_engine->Write(ctx, WriteDataBuilder::BuildWrite(
                                         ctx->CfName(), const_cast<std::vector<pb::common::KeyValue> &>(send_kvs), ts));
       if (ret.error_code() == EPERM) {
@@ -6894,7 +7696,7 @@ butil::Status TxnEngineHelper::RestoreNonTxnDocument(std::shared_ptr<Context> ct
     total_size += kv.key().size();
     total_size += kv.value().size();
 
-    if (total_size > FLAGS_max_restore_data_memory_size || total_count > FLAGS_max_restore_count) {
+    if (IsRestoreBatchFull(region, total_size, total_count)) {
       ret = raft_engine->Write(ctx, WriteDataBuilder::BuildWrite(Constant::kStoreDataCF, documents, delete_document_ids,
                                                                  send_kv_default, true));
       if (ret.error_code() == EPERM) {
@@ -7179,7 +7981,7 @@ butil::Status TxnEngineHelper::RestoreNonTxnIndex(std::shared_ptr<Context> ctx,
     send_vector_with_ids.push_back(vector);
     total_size += vector.ByteSizeLong();
     total_count++;
-    if (total_size > FLAGS_max_restore_data_memory_size || total_count > FLAGS_max_restore_count) {
+    if (IsRestoreBatchFull(region, total_size, total_count)) {
       ret = raft_engine->Write(ctx, WriteDataBuilder::BuildWrite(send_vector_with_ids, {}, {}, {}, {}, {}, true));
       if (ret.error_code() == EPERM) {
         DINGO_LOG(ERROR) << fmt::format(
@@ -7211,7 +8013,7 @@ butil::Status TxnEngineHelper::RestoreNonTxnIndex(std::shared_ptr<Context> ctx,
     total_size += kv.key().size();
     total_size += kv.value().size();
     total_count++;
-    if (total_size > FLAGS_max_restore_data_memory_size || total_count > FLAGS_max_restore_count) {
+    if (IsRestoreBatchFull(region, total_size, total_count)) {
       ret = raft_engine->Write(ctx, WriteDataBuilder::BuildWrite({}, send_kv_default, {}, {}, {}, {}, true));
       if (ret.error_code() == EPERM) {
         DINGO_LOG(ERROR) << fmt::format(
@@ -7243,7 +8045,7 @@ butil::Status TxnEngineHelper::RestoreNonTxnIndex(std::shared_ptr<Context> ctx,
     total_size += kv.key().size();
     total_size += kv.value().size();
     total_count++;
-    if (total_size > FLAGS_max_restore_data_memory_size || total_count > FLAGS_max_restore_count) {
+    if (IsRestoreBatchFull(region, total_size, total_count)) {
       ret = raft_engine->Write(ctx, WriteDataBuilder::BuildWrite({}, {}, send_kv_scalar, {}, {}, {}, true));
       if (ret.error_code() == EPERM) {
         DINGO_LOG(ERROR) << fmt::format(
@@ -7275,7 +8077,7 @@ butil::Status TxnEngineHelper::RestoreNonTxnIndex(std::shared_ptr<Context> ctx,
     total_size += kv.key().size();
     total_size += kv.value().size();
     total_count++;
-    if (total_size > FLAGS_max_restore_data_memory_size || total_count > FLAGS_max_restore_count) {
+    if (IsRestoreBatchFull(region, total_size, total_count)) {
       ret = raft_engine->Write(ctx, WriteDataBuilder::BuildWrite({}, {}, {}, send_kv_table, {}, {}, true));
       if (ret.error_code() == EPERM) {
         DINGO_LOG(ERROR) << fmt::format(
@@ -7306,7 +8108,7 @@ butil::Status TxnEngineHelper::RestoreNonTxnIndex(std::shared_ptr<Context> ctx,
     total_size += kv.key().size();
     total_size += kv.value().size();
     total_count++;
-    if (total_size > FLAGS_max_restore_data_memory_size || total_count > FLAGS_max_restore_count) {
+    if (IsRestoreBatchFull(region, total_size, total_count)) {
       ret = raft_engine->Write(ctx, WriteDataBuilder::BuildWrite({}, {}, {}, {}, send_kv_scalar_speed_up, {}, true));
       if (ret.error_code() == EPERM) {
         DINGO_LOG(ERROR) << fmt::format(
@@ -7397,6 +8199,11 @@ butil::Status TxnEngineHelper::DoReadSstFileForTxn(std::shared_ptr<Context> ctx,
       }
     }
   }
+  if (IsRestoreByIngest(region)) {
+    SortRestoreKvs(kv_puts_data);
+    SortRestoreKvs(kv_puts_write);
+  }
+
   if (!kv_puts_data.empty() || !kv_puts_write.empty()) {
     butil_status = RestoreTxn(ctx, region, raft_engine, kv_puts_data, kv_puts_write);
     if (BAIDU_UNLIKELY(!status.ok())) {
@@ -7472,6 +8279,10 @@ butil::Status TxnEngineHelper::DoReadSstFileForNonTxn(
     }
   }
 
+  if (IsRestoreByIngest(region)) {
+    SortRestoreKvs(kv_default);
+  }
+
   // vector index must handle kv_default, kv_scalar, kv_table, and kv_scalar_speed_up simultaneously.
   if (!kv_default.empty() || !kv_scalar.empty() || !kv_table.empty() || !kv_scalar_speed_up.empty()) {
     butil_status = RestoreNonTxn(ctx, region, raft_engine, kv_default, kv_scalar, kv_table, kv_scalar_speed_up);
@@ -27,6 +27,7 @@
 #include "engine/raw_engine.h"
 #include "engine/snapshot.h"
 #include "meta/store_meta_manager.h"
+#include "proto/raft.pb.h"
 #include "proto/store.pb.h"
 
 namespace dingodb {
@@ -40,8 +41,14 @@ class TxnReader {
   ~TxnReader() = default;
 
   butil::Status Init();
+  // with region, GetLockInfo also return in memory pessimistic lock of the region when lock cf has no lock.
+  void SetRegion(store::RegionPtr region) { region_ = region; }
   butil::Status GetLockInfo(const std::string &key, pb::store::LockInfo &lock_info);
   butil::Status GetDataValue(const std::string &key, std::string &value);
+  // batch version of GetLockInfo/GetDataValue, output is aligned with keys.
+  butil::Status BatchGetLockInfo(const std::vector<std::string> &keys, std::vector<pb::store::LockInfo> &lock_infos);
+  butil::Status BatchGetDataValue(const std::vector<std::string> &keys, std::vector<std::string> &values,
+                                  std::vector<bool> &key_states);
   butil::Status GetWriteInfo(int64_t min_commit_ts, int64_t max_commit_ts, int64_t start_ts, const std::string &key,
                              bool include_rollback, bool include_delete, bool include_put,
                              pb::store::WriteInfo &write_info, int64_t &commit_ts);
@@ -60,6 +67,7 @@ class TxnReader {
   RawEnginePtr raw_engine_;
   SnapshotPtr snapshot_;
   RawEngine::ReaderPtr reader_;
+  store::RegionPtr region_;
 
   std::shared_ptr<Iterator> write_iter_;
 };
@@ -90,6 +98,14 @@ class TxnIterator {
   std::string Key();
   std::string Value();
 
+  // In lazy value mode, value of long row is not read from data cf, caller read it by DataKey() in batch.
+  void SetLazyValue(bool lazy_value) { lazy_value_ = lazy_value; }
+  // set before Init, bulk scan e.g. coprocessor not fill block cache.
+  void SetScanClass(ScanClass scan_class) { scan_class_ = scan_class; }
+  // Data cf key of current row when its value is not loaded, else empty.
+  const std::string &DataKey() { return data_key_; }
+  butil::Status BatchGetDataValue(const std::vector<std::string> &data_keys, std::vector<std::string> &values);
+
   std::string GetLastLockKey() { return last_lock_key_; }
   std::string GetLastWriteKey() { return last_write_key_; }
 
@@ -97,7 +113,7 @@ class TxnIterator {
                                                pb::store::IsolationLevel isolation_level, int64_t seek_ts,
                                                int64_t start_ts, const std::string &user_key,
                                                std::string &last_write_key, bool &is_value_found,
-                                               std::string &user_value);
+                                               std::string &user_value, std::string *data_key = nullptr);
   static std::string GetUserKey(std::shared_ptr<Iterator> write_iter);
   static butil::Status GotoNextUserKeyInWriteIter(std::shared_ptr<Iterator> write_iter, std::string prev_user_key,
                                                   std::string &last_write_key);
@@ -122,6 +138,10 @@ class TxnIterator {
   std::string key_{};
   std::string value_{};
 
+  bool lazy_value_{false};
+  ScanClass scan_class_{ScanClass::kNone};
+  std::string data_key_{};
+
   // The resolved locks are used to check the lock conflict.
   // If the lock is resolved, there will not be a conflict for provided resolved_locks.
   std::set<int64_t> resolved_locks_;
@@ -156,6 +176,19 @@ class TxnEngineHelper {
                                    const std::vector<pb::store::LockInfo> &lock_infos, int64_t start_ts,
                                    int64_t commit_ts);
 
+  // Gen write cf puts and lock cf deletes of commit, not write to raft.
+  static butil::Status GenCommitData(RawEngine::ReaderPtr reader, store::RegionPtr region,
+                                     const std::vector<pb::store::LockInfo> &lock_infos, int64_t start_ts,
+                                     int64_t commit_ts, pb::raft::MultiCfPutAndDeleteRequest *cf_put_delete,
+                                     std::vector<pb::common::KeyValue> &kv_puts_write,
+                                     std::vector<std::string> &kv_deletes_lock);
+
+  // Gen write cf puts, lock cf and data cf deletes of rollback, not write to raft.
+  static void GenRollbackData(const std::vector<std::string> &keys_to_rollback_with_data,
+                              const std::vector<std::string> &keys_to_rollback_without_data, int64_t start_ts,
+                              std::vector<pb::common::KeyValue> &kv_puts_write,
+                              std::vector<std::string> &kv_deletes_lock, std::vector<std::string> &kv_deletes_data);
+
   static butil::Status DoRollback(RawEnginePtr raw_engine, std::shared_ptr<Engine> raft_engine,
                                   std::shared_ptr<Context> ctx, std::vector<std::string> &keys_to_rollback_with_data,
                                   std::vector<std::string> &keys_to_rollback_without_data, int64_t start_ts);
@@ -208,7 +241,11 @@ class TxnEngineHelper {
                                    std::shared_ptr<Context> ctx, int64_t start_ts, int64_t commit_ts,
                                    const std::vector<std::string> &keys, const std::map<int64_t, int64_t> &txn_infos);
 
-  static butil::Status BatchResolveLock(RawEnginePtr raw_engine, std::shared_ptr<Engine> raft_engine, std::shared_ptr<Context> ctx, store::RegionPtr region, const std::map<int64_t, int64_t> &txn_infos, pb::store::TxnResultInfo* txn_result);
+  // Resolve locks of many txns of region, lock cf is scanned once and writes are merged into few raft requests.
+  static butil::Status BatchResolveLock(RawEnginePtr raw_engine, std::shared_ptr<Engine> raft_engine,
+                                        std::shared_ptr<Context> ctx, store::RegionPtr region,
+                                        const std::map<int64_t, int64_t> &txn_infos,
+                                        pb::store::TxnResultInfo *txn_result);
 
   static butil::Status HeartBeat(RawEnginePtr raw_engine, std::shared_ptr<Engine> raft_engine,
                                  std::shared_ptr<Context> ctx, const std::string &primary_lock, int64_t start_ts,
@@ -347,11 +384,16 @@ class TxnEngineHelper {
       std::vector<pb::common::KeyValue> &kv_puts_lock,
       std::vector<std::tuple<std::string, std::string, pb::store::LockInfo, bool>> &locks_for_1pc);
 
+  // Clear async commit info of locks when prewrite fallback to 2PC.
+  static void FallbackTo2PCLocks(std::vector<pb::common::KeyValue> &kv_puts_lock);
+
   static butil::Status OnePCommit(
       std::shared_ptr<Engine> raft_engine, std::shared_ptr<Context> ctx, store::RegionPtr region, int64_t start_ts,
       int64_t final_commit_ts,
       std::vector<std::tuple<std::string, std::string, pb::store::LockInfo, bool>> &locks_for_1pc,
       std::vector<pb::common::KeyValue> &kv_puts_data);
+  // write in memory pessimistic locks of region to lock cf, before leader transfer, split or merge.
+  static butil::Status PersistMemoryPessimisticLocks(std::shared_ptr<Engine> raft_engine, store::RegionPtr region);
   static butil::Status DoPreWrite(std::shared_ptr<Engine> raft_engine, std::shared_ptr<Context> ctx, int64_t region_id,
                                   int64_t start_ts, int64_t mutation_size,
                                   std::vector<pb::common::KeyValue> &kv_puts_data,
@@ -0,0 +1,121 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/txn_gc_compaction_filter.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bvar/reducer.h"
+#include "common/gflag_validator.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "mvcc/codec.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_txn_gc_compaction_filter, false,
+            "enable drop txn versions below gc safe point in compaction instead of delete by raft");
+DEFINE_validator(enable_txn_gc_compaction_filter, &PassBool);
+
+static const size_t kDeleteDataBatchSize = 4096;
+
+bvar::Adder<int64_t> g_txn_gc_compaction_filter_remove_count("dingo_txn_gc_compaction_filter_remove_count");
+
+std::atomic<int64_t> TxnGcCompactionFilterFactory::safe_point_ts_{0};
+
+TxnGcCompactionFilter::~TxnGcCompactionFilter() { FlushDataKeys(); }
+
+void TxnGcCompactionFilter::FlushDataKeys() const {
+  if (data_keys_.empty()) {
+    return;
+  }
+
+  if (delete_data_func_ != nullptr) {
+    delete_data_func_(data_keys_);
+  }
+  data_keys_.clear();
+}
+
+bool TxnGcCompactionFilter::Filter(int /*level*/, const rocksdb::Slice& key, const rocksdb::Slice& existing_value,
+                                   std::string* /*new_value*/, bool* /*value_changed*/) const {
+  std::string plain_key;
+  int64_t commit_ts = 0;
+  if (!mvcc::Codec::DecodeKey(std::string_view(key.data(), key.size()), plain_key, commit_ts)) {
+    return false;
+  }
+
+  if (plain_key != last_key_) {
+    last_key_ = plain_key;
+    has_visible_version_ = false;
+  }
+
+  if (commit_ts > safe_point_ts_) {
+    return false;
+  }
+
+  pb::store::WriteInfo write_info;
+  if (!write_info.ParseFromArray(existing_value.data(), existing_value.size())) {
+    return false;
+  }
+
+  auto op = write_info.op();
+  if (!has_visible_version_) {
+    if (op == pb::store::Op::Put || op == pb::store::Op::Delete) {
+      // The newest visible version must be kept.
+      has_visible_version_ = true;
+      return false;
+    }
+
+    if (op != pb::store::Op::Rollback) {
+      return false;
+    }
+
+    g_txn_gc_compaction_filter_remove_count << 1;
+    return true;
+  }
+
+  if (op != pb::store::Op::Put && op != pb::store::Op::Delete && op != pb::store::Op::Rollback) {
+    return false;
+  }
+
+  if (op == pb::store::Op::Put && write_info.short_value().empty()) {
+    data_keys_.push_back(mvcc::Codec::EncodeKey(plain_key, write_info.start_ts()));
+    if (data_keys_.size() >= kDeleteDataBatchSize) {
+      FlushDataKeys();
+    }
+  }
+
+  g_txn_gc_compaction_filter_remove_count << 1;
+  return true;
+}
+
+std::unique_ptr<rocksdb::CompactionFilter> TxnGcCompactionFilterFactory::CreateCompactionFilter(
+    const rocksdb::CompactionFilter::Context& /*context*/) {
+  int64_t safe_point_ts = GetSafePointTs();
+  if (!FLAGS_enable_txn_gc_compaction_filter || safe_point_ts <= 0) {
+    return nullptr;
+  }
+
+  DINGO_LOG(DEBUG) << fmt::format("[txn_gc] create compaction filter, safe_point_ts({})", safe_point_ts);
+
+  return std::make_unique<TxnGcCompactionFilter>(safe_point_ts, delete_data_func_);
+}
+
+}  // namespace dingodb
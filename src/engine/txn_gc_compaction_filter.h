@@ -0,0 +1,85 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_TXN_GC_COMPACTION_FILTER_H_
+#define DINGODB_ENGINE_TXN_GC_COMPACTION_FILTER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/compaction_filter.h"
+#include "rocksdb/slice.h"
+
+namespace dingodb {
+
+// Drop txn mvcc versions which are invisible below gc safe point during compaction of write cf,
+// so gc need not scan region and delete through raft.
+// Every replica drop the same versions, because safe point is global and only invisible versions are dropped.
+// For one key only the versions older than the newest put/delete version(commit_ts <= safe_point_ts) are dropped,
+// the newest version which is seen in the same compaction is always kept.
+class TxnGcCompactionFilter : public rocksdb::CompactionFilter {
+ public:
+  using DeleteDataFunc = std::function<void(const std::vector<std::string>& data_keys)>;
+
+  TxnGcCompactionFilter(int64_t safe_point_ts, DeleteDataFunc delete_data_func)
+      : safe_point_ts_(safe_point_ts), delete_data_func_(delete_data_func) {}
+  ~TxnGcCompactionFilter() override;
+
+  bool Filter(int level, const rocksdb::Slice& key, const rocksdb::Slice& existing_value, std::string* new_value,
+              bool* value_changed) const override;
+
+  const char* Name() const override { return "TxnGcCompactionFilter"; }
+
+ private:
+  void FlushDataKeys() const;
+
+  int64_t safe_point_ts_;
+  // Delete data cf value of dropped put version.
+  DeleteDataFunc delete_data_func_;
+
+  // Compaction filter instance is used by one compaction thread, keys come in order.
+  mutable std::string last_key_;
+  // Whether has seen put/delete version(commit_ts <= safe_point_ts) of last_key_.
+  mutable bool has_visible_version_{false};
+  mutable std::vector<std::string> data_keys_;
+};
+
+class TxnGcCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
+ public:
+  TxnGcCompactionFilterFactory(TxnGcCompactionFilter::DeleteDataFunc delete_data_func)
+      : delete_data_func_(delete_data_func) {}
+  ~TxnGcCompactionFilterFactory() override = default;
+
+  std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
+      const rocksdb::CompactionFilter::Context& context) override;
+
+  const char* Name() const override { return "TxnGcCompactionFilterFactory"; }
+
+  // Set by txn gc handler, 0 means not gc.
+  static void SetSafePointTs(int64_t safe_point_ts) { safe_point_ts_.store(safe_point_ts); }
+  static int64_t GetSafePointTs() { return safe_point_ts_.load(); }
+
+ private:
+  TxnGcCompactionFilter::DeleteDataFunc delete_data_func_;
+
+  static std::atomic<int64_t> safe_point_ts_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_TXN_GC_COMPACTION_FILTER_H_
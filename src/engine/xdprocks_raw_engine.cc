@@ -342,6 +342,60 @@ butil::Status Reader::KvGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr
   return butil::Status();
 }
 
+butil::Status Reader::KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                 std::vector<std::string>& values, std::vector<bool>& key_states) {
+  return KvMultiGet(GetColumnFamily(cf_name), GetSnapshot(), keys, values, key_states);
+}
+
+butil::Status Reader::KvMultiGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                 std::vector<bool>& key_states) {
+  return KvMultiGet(GetColumnFamily(cf_name), snapshot, keys, values, key_states);
+}
+
+butil::Status Reader::KvMultiGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                 std::vector<bool>& key_states) {
+  values.clear();
+  key_states.clear();
+  if (keys.empty()) {
+    return butil::Status();
+  }
+
+  std::vector<xdprocks::Slice> key_slices;
+  key_slices.reserve(keys.size());
+  for (const auto& key : keys) {
+    if (BAIDU_UNLIKELY(key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[xdprocks] not support empty key.");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+    key_slices.emplace_back(key);
+  }
+
+  xdprocks::ReadOptions read_option;
+  read_option.snapshot = static_cast<const xdprocks::Snapshot*>(snapshot->Inner());
+
+  std::vector<xdprocks::PinnableSlice> pinnable_values(keys.size());
+  std::vector<xdprocks::Status> statuses(keys.size());
+  GetDB()->MultiGet(read_option, column_family->GetHandle(), keys.size(), key_slices.data(), pinnable_values.data(),
+                    statuses.data(), false);
+
+  values.resize(keys.size());
+  key_states.resize(keys.size(), false);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    const auto& s = statuses[i];
+    if (s.ok()) {
+      values[i].assign(pinnable_values[i].data(), pinnable_values[i].size());
+      key_states[i] = true;
+    } else if (!s.IsNotFound()) {
+      DINGO_LOG(ERROR) << fmt::format("[xdprocks] multi get key failed, error: {}", s.ToString());
+      return butil::Status(pb::error::EINTERNAL, "Internal multi get error");
+    }
+  }
+
+  return butil::Status();
+}
+
 butil::Status Reader::KvScan(ColumnFamilyPtr column_family, std::shared_ptr<dingodb::Snapshot> snapshot,
                              const std::string& start_key, const std::string& end_key,
                              std::vector<pb::common::KeyValue>& kvs) {
@@ -700,6 +754,13 @@ static xdp::ColumnFamilyMap GenColumnFamilyByDefaultConfig(const std::vector<std
   default_config.emplace(Constant::kMaxBytesForLevelBase, Constant::kMaxBytesForLevelBaseDefaultValue);
   default_config.emplace(Constant::kTargetFileSizeBase, Constant::kTargetFileSizeBaseDefaultValue);
   default_config.emplace(Constant::kMaxBytesForLevelMultiplier, Constant::kMaxBytesForLevelMultiplierDefaultValue);
+  default_config.emplace(Constant::kEnableBlobFiles, Constant::kEnableBlobFilesDefaultValue);
+  default_config.emplace(Constant::kMinBlobSize, Constant::kMinBlobSizeDefaultValue);
+  default_config.emplace(Constant::kBlobFileSize, Constant::kBlobFileSizeDefaultValue);
+  default_config.emplace(Constant::kBlobGarbageCollectionAgeCutoff,
+                         Constant::kBlobGarbageCollectionAgeCutoffDefaultValue);
+  default_config.emplace(Constant::kBlobGarbageCollectionForceThreshold,
+                         Constant::kBlobGarbageCollectionForceThresholdDefaultValue);
 
   xdp::ColumnFamilyMap column_families;
   for (const auto& cf_name : column_family_names) {
@@ -840,6 +901,19 @@ static xdprocks::ColumnFamilyOptions GenRcoksDBColumnFamilyOptions(xdp::ColumnFa
       xdprocks::CompressionType::kZSTD,
   };
 
+  // blob files, key-value separation of large value, leveled compaction not rewrite it again and again.
+  // Mvcc gc delete old versions of value, its blobs become garbage when compaction drop the keys,
+  // and blob files which have much garbage are reclaimed by forced compaction.
+  family_options.enable_blob_files = column_family->GetConfItem(Constant::kEnableBlobFiles) == "true";
+  CastValue(column_family->GetConfItem(Constant::kMinBlobSize), family_options.min_blob_size);
+  CastValue(column_family->GetConfItem(Constant::kBlobFileSize), family_options.blob_file_size);
+  family_options.blob_compression_type = xdprocks::CompressionType::kLZ4Compression;
+  family_options.enable_blob_garbage_collection = true;
+  CastValue(column_family->GetConfItem(Constant::kBlobGarbageCollectionAgeCutoff),
+            family_options.blob_garbage_collection_age_cutoff);
+  CastValue(column_family->GetConfItem(Constant::kBlobGarbageCollectionForceThreshold),
+            family_options.blob_garbage_collection_force_threshold);
+
   table_options.filter_policy.reset(xdprocks::NewBloomFilterPolicy(10.0, false));
   table_options.whole_key_filtering = true;
 
@@ -1176,4 +1250,15 @@ std::vector<int64_t> XDPRocksRawEngine::GetApproximateSizes(const std::string& c
   return result;
 }
 
+// block cache is not shared between column family, so sum of column family is total usage.
+int64_t XDPRocksRawEngine::GetBlockCacheUsage() {
+  uint64_t value = 0;
+  return db_->GetAggregatedIntProperty(xdprocks::DB::Properties::kBlockCacheUsage, &value) ? value : 0;
+}
+
+int64_t XDPRocksRawEngine::GetMemtableUsage() {
+  uint64_t value = 0;
+  return db_->GetAggregatedIntProperty(xdprocks::DB::Properties::kCurSizeAllMemTables, &value) ? value : 0;
+}
+
 }  // namespace dingodb
@@ -25,10 +25,11 @@ void EventListenerCollection::Register(std::shared_ptr<EventListener> listener)
   listeners_[listener->GetType()].push_back(listener);
 }
 
-EventListenerCollection::EventListenerChain EventListenerCollection::Get(EventType type) {
+const EventListenerCollection::EventListenerChain& EventListenerCollection::Get(EventType type) const {
+  static const EventListenerChain kEmptyChain;
   auto it = listeners_.find(type);
   if (it == listeners_.end()) {
-    return {};
+    return kEmptyChain;
   }
 
   return it->second;
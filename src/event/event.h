@@ -59,6 +59,7 @@ enum class EventType {
   kSmConfigurationCommited,
   kSmStartFollowing,
   kSmStopFollowing,
+  kSmBatchApply,
 };
 
 // Event abstract class.
@@ -102,7 +103,8 @@ class EventListenerCollection {
   const EventListenerCollection &operator=(const EventListenerCollection &) = delete;
 
   void Register(std::shared_ptr<EventListener> listener);
-  EventListenerChain Get(EventType type);
+  // Listeners are all registered before dispatch, return reference so not copy chain per event.
+  const EventListenerChain &Get(EventType type) const;
 
  private:
   std::unordered_map<EventType, EventListenerChain> listeners_;
@@ -16,12 +16,17 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <string_view>
 #include <vector>
 
+#include "butil/compiler_specific.h"
 #include "butil/endpoint.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/probe.h"
+#include "common/region_resource.h"
+#include "common/trace.h"
 #include "config/config_helper.h"
 #include "fmt/core.h"
 #include "handler/raft_snapshot_handler.h"
@@ -35,20 +40,35 @@ namespace dingodb {
 
 int SmApplyEventListener::OnEvent(std::shared_ptr<Event> event) {
   auto the_event = std::dynamic_pointer_cast<SmApplyEvent>(event);
+  return Apply(*the_event);
+}
 
+int SmApplyEventListener::Apply(const SmApplyEvent& event) {
   // Dispatch
   std::shared_ptr<Context> ctx;
-  if (the_event->ctx != nullptr) {
-    ctx = the_event->ctx;
+  if (event.ctx != nullptr) {
+    ctx = event.ctx;
   } else {
-    auto* done = dynamic_cast<BaseClosure*>(the_event->done);
+    auto* done = dynamic_cast<BaseClosure*>(event.done);
     ctx = done ? done->GetCtx() : nullptr;
   }
-  for (const auto& req : the_event->raft_cmd->requests()) {
+  RegionResourceScope resource_scope(event.region->Id());
+  TraceContext trace_context;
+  if (BAIDU_UNLIKELY(Tracer::IsEnabled())) {
+    Tracer::Extract(event.raft_cmd->header(), trace_context);
+  }
+  for (const auto& req : event.raft_cmd->requests()) {
     auto handler = handler_collection_->GetHandler(static_cast<HandlerType>(req.cmd_type()));
     if (handler) {
-      handler->Handle(ctx, the_event->region, the_event->engine, req, the_event->region_metrics, the_event->term_id,
-                      the_event->log_id);
+      DINGO_DEBUG_PROBE_LATENCY("raft_apply_handler");
+      ScopedSpan span(trace_context, "raft_apply_handler");
+      if (BAIDU_UNLIKELY(span.IsRecording())) {
+        span.AddAttribute("region_id", std::to_string(event.region->Id()));
+        span.AddAttribute("log_index", std::to_string(event.log_id));
+        span.AddAttribute("cmd_type", pb::raft::CmdType_Name(req.cmd_type()));
+        span.AddAttribute("store_id", std::to_string(Server::GetInstance().Id()));
+      }
+      handler->Handle(ctx, event.region, event.engine, req, event.region_metrics, event.term_id, event.log_id);
     } else {
       DINGO_LOG(ERROR) << "Unknown raft cmd type " << req.cmd_type();
     }
@@ -57,6 +77,14 @@ int SmApplyEventListener::OnEvent(std::shared_ptr<Event> event) {
   return 0;
 }
 
+int SmBatchApplyEventListener::OnEvent(std::shared_ptr<Event> event) {
+  auto the_event = std::dynamic_pointer_cast<SmBatchApplyEvent>(event);
+
+  RegionResourceScope resource_scope(the_event->region->Id());
+  return BatchPutHandler::Handle(the_event->region, the_event->engine, the_event->entries, the_event->raft_meta_kvs,
+                                 the_event->region_metrics);
+}
+
 int SmSnapshotSaveEventListener::OnEvent(std::shared_ptr<Event> event) {
   auto the_event = std::dynamic_pointer_cast<SmSnapshotSaveEvent>(event);
 
@@ -128,6 +156,10 @@ int SmLeaderStopEventListener::OnEvent(std::shared_ptr<Event> event) {
   if (node != nullptr) {
     node->SetConsistentReadable(false);
   }
+  // memory pessimistic lock is not replicated and is lost here, leader transfer persist it before.
+  region->ClearPessimisticLocks();
+  // new leader may commit below it, reading at old resolved ts must check lock again.
+  region->ResetResolvedTs();
   // Invoke handler
   auto handlers = handler_collection_->GetHandlers();
   for (auto& handle : handlers) {
@@ -239,6 +271,7 @@ std::shared_ptr<EventListenerCollection> StoreSmEventListenerFactory::Build() {
   std::shared_ptr<HandlerFactory> handler_factory;
   handler_factory = std::make_shared<RaftApplyHandlerFactory>();
   listener_collection->Register(std::make_shared<SmApplyEventListener>(handler_factory->Build()));
+  listener_collection->Register(std::make_shared<SmBatchApplyEventListener>());
 
   listener_collection->Register(std::make_shared<SmShutdownEventListener>());
   listener_collection->Register(
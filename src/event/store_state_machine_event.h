@@ -16,6 +16,8 @@
 #define DINGODB_EVENT_STATE_MACHINE_EVENT_H_
 
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 #include "event/event.h"
 #include "handler/handler.h"
@@ -49,11 +51,35 @@ class SmApplyEventListener : public EventListener {
 
   EventType GetType() override { return EventType::kSmApply; }
   int OnEvent(std::shared_ptr<Event> event) override;
+  // State machine call it directly when it is the only apply listener, event is not kept after apply.
+  int Apply(const SmApplyEvent& event);
 
  private:
   std::shared_ptr<HandlerCollection> handler_collection_;
 };
 
+// State Machine batch apply event, consecutive put/delete batch logs.
+struct SmBatchApplyEvent : public Event {
+  SmBatchApplyEvent() : Event(EventSource::kRaftStateMachine, EventType::kSmBatchApply) {}
+  ~SmBatchApplyEvent() override = default;
+
+  store::RegionPtr region;
+  store::RegionMetricsPtr region_metrics;
+  std::shared_ptr<RawEngine> engine;
+  std::vector<BatchPutHandler::Entry> entries;
+  // Raft meta with applied index of the last entry, written with entries in one write batch.
+  std::vector<pb::common::KeyValue> raft_meta_kvs;
+};
+
+class SmBatchApplyEventListener : public EventListener {
+ public:
+  SmBatchApplyEventListener() = default;
+  ~SmBatchApplyEventListener() override = default;
+
+  EventType GetType() override { return EventType::kSmBatchApply; }
+  int OnEvent(std::shared_ptr<Event> event) override;
+};
+
 // State Machine Shutdown
 struct SmShutdownEvent : public Event {
   SmShutdownEvent() : Event(EventSource::kRaftStateMachine, EventType::kSmShutdown) {}
@@ -26,6 +26,7 @@
 #include <utility>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "bthread/bthread.h"
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
@@ -39,6 +40,7 @@
 #include "engine/raw_engine.h"
 #include "event/store_state_machine_event.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "glog/logging.h"
 #include "meta/store_meta_manager.h"
 #include "mvcc/codec.h"
@@ -61,6 +63,11 @@ BRPC_VALIDATE_GFLAG(dingo_log_switch_raft_vector_add_use_document_detail, brpc::
 namespace dingodb {
 DECLARE_bool(dingo_log_switch_scalar_speed_up_detail);
 
+DEFINE_bool(enable_bulk_ingest_put, false, "enable apply large sorted batch put by ingest sst file");
+BRPC_VALIDATE_GFLAG(enable_bulk_ingest_put, brpc::PassValidate);
+DEFINE_int64(bulk_ingest_min_kv_count, 4096, "min kv count of batch put apply by ingest sst file");
+BRPC_VALIDATE_GFLAG(bulk_ingest_min_kv_count, brpc::PositiveInteger);
+
 int PutHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
                        const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t /*term_id*/,
                        int64_t /*log_id*/) {
@@ -73,8 +80,11 @@ int PutHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, st
   }
   if (request.kvs().size() == 1) {
     status = writer->KvPut(request.cf_name(), request.kvs().Get(0));
+  } else if (FLAGS_enable_bulk_ingest_put && request.kvs().size() >= FLAGS_bulk_ingest_min_kv_count) {
+    // Every replica build sst from the same log, skip memtable and wal, fallback batch put when kvs not sorted.
+    status = writer->KvBulkIngest(request.cf_name(), Helper::PbRepeatedToVector(request.kvs()));
   } else {
-    status = writer->KvBatchPut(request.cf_name(), Helper::PbRepeatedToVector(request.kvs()));
+    status = writer->KvBatchPut(request.cf_name(), request.kvs());
   }
 
   if (BAIDU_UNLIKELY(status.error_code() == pb::error::Errno::EINTERNAL)) {
@@ -93,21 +103,21 @@ int PutHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, st
   return 0;
 }
 
-int DeleteRangeHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr /*region*/,
-                               std::shared_ptr<RawEngine> engine, const pb::raft::Request &req,
-                               store::RegionMetricsPtr region_metrics, int64_t /*term_id*/, int64_t /*log_id*/) {
+int DeleteRangeHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+                               const pb::raft::Request &req, store::RegionMetricsPtr region_metrics,
+                               int64_t /*term_id*/, int64_t /*log_id*/) {
   butil::Status status;
   const auto &request = req.delete_range();
 
   auto writer = engine->Writer();
 
+  std::map<std::string, std::vector<pb::common::Range>> range_with_cfs;
+  range_with_cfs[request.cf_name()] = Helper::PbRepeatedToVector(request.ranges());
   if (1 == request.ranges().size()) {
     const auto &range = request.ranges()[0];
     status = writer->KvDeleteRange(request.cf_name(), range);
 
   } else {
-    std::map<std::string, std::vector<pb::common::Range>> range_with_cfs;
-    range_with_cfs[request.cf_name()] = Helper::PbRepeatedToVector(request.ranges());
     status = writer->KvBatchDeleteRange(range_with_cfs);
   }
 
@@ -115,6 +125,12 @@ int DeleteRangeHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr /*
     ctx->SetStatus(status);
   }
 
+  // Track range tombstone and compact deleted span
+  auto range_compactor = Server::GetInstance().GetRangeCompactor();
+  if (status.ok() && range_compactor != nullptr) {
+    range_compactor->OnDeleteRange(region->Id(), engine, range_with_cfs, region_metrics);
+  }
+
   // Update region metrics min/max key policy
   if (region_metrics != nullptr) {
     region_metrics->UpdateMaxAndMinKeyPolicy(request.ranges());
@@ -166,6 +182,77 @@ int DeleteBatchHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr re
   return 0;
 }
 
+bool BatchPutHandler::IsBatchable(const pb::raft::RaftCmdRequest &raft_cmd) {
+  if (raft_cmd.requests().empty()) {
+    return false;
+  }
+
+  for (const auto &req : raft_cmd.requests()) {
+    if (req.cmd_type() == pb::raft::PUT) {
+      if (req.put().kvs().empty() ||
+          (FLAGS_enable_bulk_ingest_put && req.put().kvs().size() >= FLAGS_bulk_ingest_min_kv_count)) {
+        return false;
+      }
+    } else if (req.cmd_type() == pb::raft::DELETEBATCH) {
+      if (req.delete_batch().keys().empty()) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+int BatchPutHandler::Handle(store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+                            const std::vector<Entry> &entries, const std::vector<pb::common::KeyValue> &raft_meta_kvs,
+                            store::RegionMetricsPtr region_metrics) {
+  // Keep log order, later write of the same key win. Kvs are written from raft cmd without copy.
+  const std::string delete_flag_value = mvcc::Codec::ValueFlagDelete();
+  std::vector<RawEngine::Writer::ApplyPut> puts;
+  for (const auto &entry : entries) {
+    for (const auto &req : entry.raft_cmd->requests()) {
+      RawEngine::Writer::ApplyPut put;
+      if (req.cmd_type() == pb::raft::PUT) {
+        put.cf_name = &req.put().cf_name();
+        put.kvs = &req.put().kvs();
+      } else {
+        put.cf_name = &req.delete_batch().cf_name();
+        put.keys = &req.delete_batch().keys();
+        put.value = &delete_flag_value;
+      }
+      puts.push_back(put);
+    }
+  }
+
+  auto writer = engine->Writer();
+  auto status = writer->KvBatchApply(puts, Constant::kStoreMetaCF, raft_meta_kvs);
+  if (BAIDU_UNLIKELY(status.error_code() == pb::error::Errno::EINTERNAL)) {
+    DINGO_LOG(FATAL) << fmt::format("[raft.apply][region({})] batch put failed, error: {}", region->Id(),
+                                    status.error_str());
+  }
+
+  for (const auto &entry : entries) {
+    if (entry.ctx) {
+      entry.ctx->SetStatus(status);
+    }
+
+    // Update region metrics min/max key
+    if (BAIDU_LIKELY(region_metrics != nullptr)) {
+      for (const auto &req : entry.raft_cmd->requests()) {
+        if (req.cmd_type() == pb::raft::PUT) {
+          region_metrics->UpdateMaxAndMinKey(req.put().kvs());
+        } else {
+          region_metrics->UpdateMaxAndMinKeyPolicy(req.delete_batch().keys());
+        }
+      }
+    }
+  }
+
+  return 0;
+}
+
 static void LaunchAyncSaveSnapshot(store::RegionPtr region) {  // NOLINT
   auto store_region_meta = GET_STORE_REGION_META;
   if (region->GetStoreEngineType() == pb::common::STORE_ENG_MONO_STORE) {
@@ -737,7 +824,8 @@ static std::vector<pb::raft::LogEntry> GetRaftLogEntries(int64_t region_id, int6
     auto &pb_log_entry = pb_log_entries[i];
     pb_log_entry.set_index(log_entries[i]->index);
     pb_log_entry.set_term(log_entries[i]->term);
-    pb_log_entry.mutable_data()->swap(log_entries[i]->out_data);
+    // Log entry maybe shared with log entry cache, so copy data.
+    pb_log_entry.set_data(log_entries[i]->out_data);
   }
 
   return pb_log_entries;
@@ -1146,6 +1234,10 @@ int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr regi
   }
 #endif
 
+  kvs_default.reserve(request.vectors_size());
+  kvs_scalar.reserve(request.vectors_size());
+  kvs_table.reserve(request.vectors_size());
+
   auto prefix = region->GetKeyPrefix();
   auto region_part_id = region->PartitionId();
   for (const auto &vector : request.vectors()) {
@@ -1250,16 +1342,16 @@ int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr regi
     }
 #endif
   }
-  kv_puts_with_cf.insert_or_assign(Constant::kStoreDataCF, kvs_default);
-  kv_puts_with_cf.insert_or_assign(Constant::kVectorScalarCF, kvs_scalar);
+  kv_puts_with_cf.insert_or_assign(Constant::kStoreDataCF, std::move(kvs_default));
+  kv_puts_with_cf.insert_or_assign(Constant::kVectorScalarCF, std::move(kvs_scalar));
   if (!kvs_scalar_speed_up.empty()) {
-    kv_puts_with_cf.insert_or_assign(Constant::kVectorScalarKeySpeedUpCF, kvs_scalar_speed_up);
+    kv_puts_with_cf.insert_or_assign(Constant::kVectorScalarKeySpeedUpCF, std::move(kvs_scalar_speed_up));
   }
-  kv_puts_with_cf.insert_or_assign(Constant::kVectorTableCF, kvs_table);
+  kv_puts_with_cf.insert_or_assign(Constant::kVectorTableCF, std::move(kvs_table));
 
 #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
   if (!document_with_ids.empty()) {
-    kv_puts_with_cf.insert_or_assign(Constant::kVectorScalarUseDocumentCF, kvs_scalar_use_document);
+    kv_puts_with_cf.insert_or_assign(Constant::kVectorScalarUseDocumentCF, std::move(kvs_scalar_use_document));
   }
 #endif
 
@@ -1283,9 +1375,22 @@ int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr regi
   // Handle vector index
   auto vector_index_wrapper = region->VectorIndexWrapper();
   int64_t vector_index_id = vector_index_wrapper->Id();
-  bool is_ready = vector_index_wrapper->IsReady();
+  bool is_ready = vector_index_wrapper->IsReady() && !vector_index_wrapper->IsBulkImportPending();
 
-  if (is_ready) {
+  if (is_ready && VectorIndexManager::IsAsyncApply(region, vector_index_wrapper, log_id)) {
+    // Update vector index at async apply queue, raft apply thread only write rocksdb.
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    vector_with_ids.reserve(request.vectors_size());
+    for (const auto &vector : request.vectors()) {
+      pb::common::VectorWithId vector_with_id;
+      *(vector_with_id.mutable_vector()) = vector.vector();
+      vector_with_id.set_id(vector.id());
+      vector_with_ids.push_back(std::move(vector_with_id));
+    }
+
+    VectorIndexManager::LaunchApplyVectorIndex(vector_index_wrapper, std::move(vector_with_ids), {},
+                                               request.is_update(), log_id);
+  } else if (is_ready) {
     // Check if the log_id is greater than the ApplyLogIndex of the vector index
     if (log_id > vector_index_wrapper->ApplyLogId() ||
         region->GetStoreEngineType() == pb::common::STORE_ENG_MONO_STORE) {
@@ -1298,7 +1403,7 @@ int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr regi
           pb::common::VectorWithId vector_with_id;
           *(vector_with_id.mutable_vector()) = vector.vector();
           vector_with_id.set_id(vector.id());
-          vector_with_ids.push_back(vector_with_id);
+          vector_with_ids.push_back(std::move(vector_with_id));
         }
 
         auto start_time = Helper::TimestampNs();
@@ -1471,8 +1576,11 @@ int VectorDeleteHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr r
 
   auto vector_index_wrapper = region->VectorIndexWrapper();
   int64_t vector_index_id = vector_index_wrapper->Id();
-  bool is_ready = vector_index_wrapper->IsReady();
-  if (is_ready && !request.ids().empty()) {
+  bool is_ready = vector_index_wrapper->IsReady() && !vector_index_wrapper->IsBulkImportPending();
+  if (is_ready && VectorIndexManager::IsAsyncApply(region, vector_index_wrapper, log_id)) {
+    VectorIndexManager::LaunchApplyVectorIndex(vector_index_wrapper, {}, Helper::PbRepeatedToVector(request.ids()),
+                                               false, log_id);
+  } else if (is_ready && !request.ids().empty()) {
     if (log_id > vector_index_wrapper->ApplyLogId() ||
         region->GetStoreEngineType() == pb::common::STORE_ENG_MONO_STORE) {
       try {
@@ -1700,11 +1808,25 @@ int VectorBatchAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr
   }
 #endif
 
+  bool is_bulk_import = request.delete_vector_ids().empty() &&
+                        VectorIndexManager::IsBulkImport(region, region->VectorIndexWrapper(), request.vectors_size(),
+                                                         log_id);
+
   // Put vector data to rocksdb
   if (!kv_puts_with_cf.empty()) {
     auto start_time = Helper::TimestampNs();
     auto writer = engine->Writer();
-    status = writer->KvBatchPutAndDelete(kv_puts_with_cf, kv_deletes_with_cf);
+    if (is_bulk_import && FLAGS_enable_bulk_ingest_put) {
+      // Every replica build sst of each cf from the same log, fallback batch put when kvs not sorted.
+      for (const auto &[cf_name, kvs] : kv_puts_with_cf) {
+        status = writer->KvBulkIngest(cf_name, kvs);
+        if (!status.ok()) {
+          break;
+        }
+      }
+    } else {
+      status = writer->KvBatchPutAndDelete(kv_puts_with_cf, kv_deletes_with_cf);
+    }
     if (tracker) tracker->SetStoreWriteTime(Helper::TimestampNs() - start_time);
     if (status.error_code() == pb::error::Errno::EINTERNAL) {
       DINGO_LOG(FATAL) << fmt::format("[raft.apply][region({})] KvBatchPutAndDelete failed, error: {}", region->Id(),
@@ -1753,9 +1875,26 @@ int VectorBatchAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr
   // Handle vector index
   auto vector_index_wrapper = region->VectorIndexWrapper();
   int64_t vector_index_id = vector_index_wrapper->Id();
-  bool is_ready = vector_index_wrapper->IsReady();
+  if (is_bulk_import) {
+    vector_index_wrapper->SetBulkImportLogId(log_id);
+  }
+  bool is_ready = vector_index_wrapper->IsReady() && !vector_index_wrapper->IsBulkImportPending();
 
-  if (is_ready) {
+  if (is_ready && VectorIndexManager::IsAsyncApply(region, vector_index_wrapper, log_id)) {
+    // Update vector index at async apply queue, raft apply thread only write rocksdb.
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    vector_with_ids.reserve(request.vectors_size());
+    for (const auto &vector : request.vectors()) {
+      pb::common::VectorWithId vector_with_id;
+      *(vector_with_id.mutable_vector()) = vector.vector();
+      vector_with_id.set_id(vector.id());
+      vector_with_ids.push_back(std::move(vector_with_id));
+    }
+
+    VectorIndexManager::LaunchApplyVectorIndex(vector_index_wrapper, std::move(vector_with_ids),
+                                               Helper::PbRepeatedToVector(request.delete_vector_ids()),
+                                               request.is_update(), log_id);
+  } else if (is_ready) {
     // Check if the log_id is greater than the ApplyLogIndex of the vector index
     if (log_id > vector_index_wrapper->ApplyLogId() ||
         region->GetStoreEngineType() == pb::common::STORE_ENG_MONO_STORE) {
@@ -17,6 +17,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "common/context.h"
 #include "engine/raw_engine.h"
@@ -52,6 +53,22 @@ class DeleteBatchHandler : public BaseHandler {
              int64_t log_id) override;
 };
 
+// Apply consecutive put/delete batch logs of one region with one write batch.
+class BatchPutHandler {
+ public:
+  struct Entry {
+    std::shared_ptr<Context> ctx;
+    std::shared_ptr<pb::raft::RaftCmdRequest> raft_cmd;
+  };
+
+  // All requests of raft cmd are put or delete batch, and not use bulk ingest.
+  static bool IsBatchable(const pb::raft::RaftCmdRequest &raft_cmd);
+
+  // Write all entries in one write batch, raft_meta_kvs is written to meta column family in the same batch.
+  static int Handle(store::RegionPtr region, std::shared_ptr<RawEngine> engine, const std::vector<Entry> &entries,
+                    const std::vector<pb::common::KeyValue> &raft_meta_kvs, store::RegionMetricsPtr region_metrics);
+};
+
 // SplitHandler
 class SplitHandler : public BaseHandler {
  public:
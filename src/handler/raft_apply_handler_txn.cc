@@ -24,6 +24,7 @@
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "engine/change_capture.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
 #include "handler/raft_apply_handler.h"
@@ -32,10 +33,27 @@
 #include "proto/common.pb.h"
 #include "proto/raft.pb.h"
 #include "proto/store.pb.h"
+#include "server/server.h"
 
 namespace dingodb {
 
 DECLARE_bool(dingo_log_switch_txn_detail);
+DECLARE_bool(enable_bulk_ingest_put);
+DECLARE_int64(bulk_ingest_min_kv_count);
+
+// Large put only request, e.g. restore data, is applied by ingest sst file per cf.
+static bool IsBulkIngestPut(const std::map<std::string, std::vector<pb::common::KeyValue>> &kv_puts_with_cf,
+                            const std::map<std::string, std::vector<std::string>> &kv_deletes_with_cf) {
+  if (!FLAGS_enable_bulk_ingest_put || kv_puts_with_cf.empty() || !kv_deletes_with_cf.empty()) {
+    return false;
+  }
+  for (const auto &[cf_name, kvs] : kv_puts_with_cf) {
+    if (static_cast<int64_t>(kvs.size()) < FLAGS_bulk_ingest_min_kv_count) {
+      return false;
+    }
+  }
+  return true;
+}
 
 void TxnHandler::HandleMultiCfPutAndDeleteRequest(std::shared_ptr<Context> ctx, store::RegionPtr region,
                                                   std::shared_ptr<RawEngine> engine,
@@ -93,7 +111,23 @@ void TxnHandler::HandleMultiCfPutAndDeleteRequest(std::shared_ptr<Context> ctx,
 
   auto writer = engine->Writer();
   butil::Status status;
-  if (!kv_puts_with_cf.empty() || !kv_deletes_with_cf.empty()) {
+  if (IsBulkIngestPut(kv_puts_with_cf, kv_deletes_with_cf)) {
+    // Ingest is not atomic across cf, ingest write cf last, data without write record is invisible.
+    for (const auto &[cf_name, kvs] : kv_puts_with_cf) {
+      if (cf_name != Constant::kTxnWriteCF && status.ok()) {
+        status = writer->KvBulkIngest(cf_name, kvs);
+      }
+    }
+    auto it = kv_puts_with_cf.find(Constant::kTxnWriteCF);
+    if (it != kv_puts_with_cf.end() && status.ok()) {
+      status = writer->KvBulkIngest(it->first, it->second);
+    }
+    if (!status.ok()) {
+      DINGO_LOG(FATAL) << fmt::format(
+          "[txn][region({})] HandleMultiCfPutAndDelete ingest fail, term: {} apply_log_id: {}, error: {}.",
+          region->Id(), term_id, log_id, status.error_str());
+    }
+  } else if (!kv_puts_with_cf.empty() || !kv_deletes_with_cf.empty()) {
     status = writer->KvBatchPutAndDelete(kv_puts_with_cf, kv_deletes_with_cf);
     if (!status.ok()) {
       DINGO_LOG(FATAL) << fmt::format(
@@ -102,6 +136,34 @@ void TxnHandler::HandleMultiCfPutAndDeleteRequest(std::shared_ptr<Context> ctx,
     }
   }
 
+  // lock cf of the key is written by raft, memory pessimistic lock of leader is replaced or released.
+  if (region->PessimisticLockCount() > 0) {
+    std::vector<std::string> plain_keys;
+    auto it = kv_puts_with_cf.find(Constant::kTxnLockCF);
+    if (it != kv_puts_with_cf.end()) {
+      for (const auto &kv : it->second) {
+        std::string plain_key;
+        if (mvcc::Codec::DecodeKey(kv.key(), plain_key)) plain_keys.push_back(std::move(plain_key));
+      }
+    }
+    auto del_it = kv_deletes_with_cf.find(Constant::kTxnLockCF);
+    if (del_it != kv_deletes_with_cf.end()) {
+      for (const auto &key : del_it->second) {
+        std::string plain_key;
+        if (mvcc::Codec::DecodeKey(key, plain_key)) plain_keys.push_back(std::move(plain_key));
+      }
+    }
+    region->UnlockPessimisticKeys(plain_keys);
+  }
+
+  // commit record of write cf is captured for change subscriber.
+  if (status.ok()) {
+    auto it = kv_puts_with_cf.find(Constant::kTxnWriteCF);
+    if (it != kv_puts_with_cf.end()) {
+      ChangeCapture::GetInstance().CaptureCommit(region, engine, log_id, it->second);
+    }
+  }
+
   auto tracker = ctx ? ctx->Tracker() : nullptr;
 
   // check if need to commit to vector index
@@ -257,7 +319,7 @@ void TxnHandler::HandleMultiCfPutAndDeleteRequest(std::shared_ptr<Context> ctx,
 void TxnHandler::HandleTxnDeleteRangeRequest(std::shared_ptr<Context> ctx, store::RegionPtr region,
                                              std::shared_ptr<RawEngine> engine,
                                              const pb::raft::TxnDeleteRangeRequest &request,
-                                             store::RegionMetricsPtr /*region_metrics*/, int64_t term_id,
+                                             store::RegionMetricsPtr region_metrics, int64_t term_id,
                                              int64_t log_id) {
   DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
       << fmt::format("[txn][region({})] HandleTxnDeleteRange, term: {} apply_log_id: {}", region->Id(), term_id, log_id)
@@ -289,6 +351,17 @@ void TxnHandler::HandleTxnDeleteRangeRequest(std::shared_ptr<Context> ctx, store
                                     term_id, log_id)
                      << ", write failed, request: " << request.ShortDebugString() << ", status: " << status.error_str();
   }
+  // memory pessimistic lock in range are released with lock cf.
+  if (region->PessimisticLockCount() > 0) {
+    region->ClearPessimisticLocks();
+  }
+  ChangeCapture::GetInstance().CaptureDeleteRange(region->Id(), log_id);
+
+  // Track range tombstone and compact deleted span
+  auto range_compactor = Server::GetInstance().GetRangeCompactor();
+  if (range_compactor != nullptr) {
+    range_compactor->OnDeleteRange(region->Id(), engine, ranges_with_cf, region_metrics);
+  }
 }
 
 int TxnHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
@@ -14,6 +14,8 @@
 
 #include "handler/raft_snapshot_handler.h"
 
+#include <sys/stat.h>
+
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
@@ -21,12 +23,15 @@
 #include <string>
 #include <vector>
 
+#include "bthread/bthread.h"
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
 #include "common/constant.h"
 #include "common/failpoint.h"
+#include "common/gflag_validator.h"
 #include "common/helper.h"
 #include "config/config_manager.h"
+#include "engine/mem_raw_engine.h"
 #include "fmt/core.h"
 #include "google/protobuf/message.h"
 #include "proto/common.pb.h"
@@ -38,15 +43,22 @@
 namespace dingodb {
 
 DEFINE_string(raft_snapshot_policy, "dingo", "raft snapshot policy, checkpoint or scan");
+DEFINE_bool(enable_raft_snapshot_async_save, true,
+            "enable link checkpoint files to snapshot in background, only for checkpoint policy");
+DEFINE_validator(enable_raft_snapshot_async_save, &PassBool);
+DEFINE_bool(enable_raft_snapshot_reuse_sst, true,
+            "enable follower reuse unchanged sst files of last snapshot when install snapshot, only for checkpoint "
+            "policy");
+DEFINE_validator(enable_raft_snapshot_reuse_sst, &PassBool);
 
 struct SaveRaftSnapshotArg {
   store::RegionPtr region;
   braft::SnapshotWriter* writer;
   braft::Closure* done;
-  RaftSnapshot* raft_snapshot;
+  std::shared_ptr<RaftSnapshot> raft_snapshot;
   int64_t region_version;
-  int64_t term;
-  int64_t log_index;
+  std::string checkpoint_path;
+  std::vector<pb::store_internal::SstFileInfo> sst_files;
 };
 
 // Filter sst file by range
@@ -82,7 +94,7 @@ butil::Status RaftSnapshot::GenSnapshotFileByCheckpoint(const std::string& check
   if (!status.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[raft.snapshot][region({})] Create checkpoint failed, path: {} error: {} {}",
                                     region->Id(), checkpoint_path, status.error_code(), status.error_str());
-    return butil::Status();
+    return status;
   }
 
   // Get region actual range
@@ -121,8 +133,10 @@ bool AddRegionMetaFile(braft::SnapshotWriter* writer, store::RegionPtr region, i
   return true;
 }
 
-bool RaftSnapshot::SaveSnapshot(braft::SnapshotWriter* writer, store::RegionPtr region,  // NOLINT
-                                GenSnapshotFileFunc func, int64_t region_version, int64_t term, int64_t log_index) {
+bool RaftSnapshot::PrepareSnapshot(braft::SnapshotWriter* writer, store::RegionPtr region,  // NOLINT
+                                   GenSnapshotFileFunc func, int64_t term, int64_t log_index,
+                                   std::string& checkpoint_path,
+                                   std::vector<pb::store_internal::SstFileInfo>& sst_files) {
   auto range = region->Range(false);
   if (range.start_key().empty() || range.end_key().empty()) {
     DINGO_LOG(ERROR) << fmt::format("[raft.snapshot][region({})] Save snapshot failed, range is invalid", region->Id());
@@ -137,18 +151,36 @@ bool RaftSnapshot::SaveSnapshot(braft::SnapshotWriter* writer, store::RegionPtr
     return false;
   }
 
-  std::string region_checkpoint_path =
+  checkpoint_path =
       fmt::format("{}/{}_{}", Server::GetInstance().GetCheckpointPath(), region->Id(), Helper::TimestampNs());
 
-  std::vector<pb::store_internal::SstFileInfo> sst_files;
-  auto status = func(region_checkpoint_path, region, sst_files);
+  auto status = func(checkpoint_path, region, sst_files);
   if (!status.ok() && status.error_code() != pb::error::ENO_ENTRIES) {
     // Clean temp checkpoint file
-    Helper::RemoveAllFileOrDirectory(region_checkpoint_path);
+    Helper::RemoveAllFileOrDirectory(checkpoint_path);
     return false;
   }
 
-  for (auto& sst_file : sst_files) {
+  return true;
+}
+
+// Generate stable identity of sst file, sst file is immutable and the name is unique in one db,
+// and snapshot file is hard link of db sst file, so name/inode/size identify the same sst file.
+static std::string GenSstFileChecksum(const std::string& filename, const std::string& path) {
+  struct stat st;
+  if (::stat(path.c_str(), &st) != 0) {
+    return "";
+  }
+
+  return fmt::format("{}_{}_{}", filename, st.st_ino, st.st_size);
+}
+
+bool RaftSnapshot::CommitSnapshot(braft::SnapshotWriter* writer, store::RegionPtr region,  // NOLINT
+                                  const std::string& checkpoint_path,
+                                  const std::vector<pb::store_internal::SstFileInfo>& sst_files,
+                                  int64_t region_version) {
+  int64_t reuse_file_count = 0;
+  for (const auto& sst_file : sst_files) {
     std::string filename = Helper::CleanFirstSlash(sst_file.name());
     std::string snapshot_path = writer->get_path() + "/" + filename;
     DINGO_LOG(DEBUG) << fmt::format("snapshot_path: {} to {}", sst_file.path(), snapshot_path);
@@ -156,18 +188,29 @@ bool RaftSnapshot::SaveSnapshot(braft::SnapshotWriter* writer, store::RegionPtr
       DINGO_LOG(ERROR) << fmt::format("[raft.snapshot][region({})] link file failed, path: {}", region->Id(),
                                       snapshot_path);
       // Clean temp checkpoint file
-      Helper::RemoveAllFileOrDirectory(region_checkpoint_path);
+      Helper::RemoveAllFileOrDirectory(checkpoint_path);
       return false;
     }
 
     auto filemeta = std::make_unique<braft::LocalFileMeta>();
     filemeta->set_user_meta(sst_file.SerializeAsString());
     filemeta->set_source(braft::FileSource::FILE_SOURCE_LOCAL);
+    // CURRENT/MANIFEST/OPTIONS(level -1) is rewrite every checkpoint, only sst file can be reused.
+    if (FLAGS_enable_raft_snapshot_reuse_sst && sst_file.level() >= 0) {
+      auto checksum = GenSstFileChecksum(filename, snapshot_path);
+      if (!checksum.empty()) {
+        filemeta->set_checksum(checksum);
+        ++reuse_file_count;
+      }
+    }
     writer->add_file(filename, static_cast<google::protobuf::Message*>(filemeta.get()));
   }
 
+  DINGO_LOG(INFO) << fmt::format("[raft.snapshot][region({})] snapshot file count({}) reusable sst file count({})",
+                                 region->Id(), sst_files.size(), reuse_file_count);
+
   // Clean temp checkpoint file
-  Helper::RemoveAllFileOrDirectory(region_checkpoint_path);
+  Helper::RemoveAllFileOrDirectory(checkpoint_path);
 
   // update snapshot epoch to store meta
   auto store_region_meta = GET_STORE_REGION_META;
@@ -183,6 +226,17 @@ bool RaftSnapshot::SaveSnapshot(braft::SnapshotWriter* writer, store::RegionPtr
   return true;
 }
 
+bool RaftSnapshot::SaveSnapshot(braft::SnapshotWriter* writer, store::RegionPtr region,  // NOLINT
+                                GenSnapshotFileFunc func, int64_t region_version, int64_t term, int64_t log_index) {
+  std::string checkpoint_path;
+  std::vector<pb::store_internal::SstFileInfo> sst_files;
+  if (!PrepareSnapshot(writer, region, func, term, log_index, checkpoint_path, sst_files)) {
+    return false;
+  }
+
+  return CommitSnapshot(writer, region, checkpoint_path, sst_files, region_version);
+}
+
 // Check snapshot region meta, especially region version.
 butil::Status RaftSnapshot::HandleRaftSnapshotRegionMeta(braft::SnapshotReader* reader, store::RegionPtr region) {
   pb::store_internal::RaftSnapshotRegionMeta meta;
@@ -452,7 +506,24 @@ bool RaftSnapshot::LoadSnapshotDingo(braft::SnapshotReader* reader, store::Regio
   return true;
 }
 
+static void* SaveSnapshotRoutine(void* arg) {
+  std::unique_ptr<SaveRaftSnapshotArg> save_arg(static_cast<SaveRaftSnapshotArg*>(arg));
+  brpc::ClosureGuard done_guard(save_arg->done);
+
+  if (!save_arg->raft_snapshot->CommitSnapshot(save_arg->writer, save_arg->region, save_arg->checkpoint_path,
+                                               save_arg->sst_files, save_arg->region_version)) {
+    LOG(ERROR) << fmt::format("[raft.snapshot][region({})] save snapshot failed.", save_arg->region->Id());
+    if (save_arg->done != nullptr) {
+      save_arg->done->status().set_error(pb::error::ERAFT_SAVE_SNAPSHOT, "save snapshot failed");
+    }
+  }
+
+  return nullptr;
+}
+
 // Use checkpoint save snapshot
+// Checkpoint is created in fsm thread for consistent with applied index,
+// link checkpoint files to snapshot writer is done in background.
 void SaveSnapshotByCheckpoint(store::RegionPtr region, std::shared_ptr<RawEngine> engine, int64_t term,
                               int64_t log_index, braft::SnapshotWriter* writer, braft::Closure* done) {
   brpc::ClosureGuard done_guard(done);
@@ -460,19 +531,71 @@ void SaveSnapshotByCheckpoint(store::RegionPtr region, std::shared_ptr<RawEngine
   auto raft_snapshot = std::make_shared<RaftSnapshot>(engine, false);
   auto gen_snapshot_file_func = std::bind(&RaftSnapshot::GenSnapshotFileByCheckpoint, raft_snapshot,  // NOLINT
                                           std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
-  if (!raft_snapshot->SaveSnapshot(writer, region, gen_snapshot_file_func, region->Epoch().version(), term,
-                                   log_index)) {
+
+  auto* arg = new SaveRaftSnapshotArg();
+  arg->region = region;
+  arg->writer = writer;
+  arg->raft_snapshot = raft_snapshot;
+  arg->region_version = region->Epoch().version();
+  if (!raft_snapshot->PrepareSnapshot(writer, region, gen_snapshot_file_func, term, log_index, arg->checkpoint_path,
+                                      arg->sst_files)) {
     LOG(ERROR) << fmt::format("[raft.snapshot][region({})] save snapshot failed.", region->Id());
+    delete arg;
     if (done != nullptr) {
       done->status().set_error(pb::error::ERAFT_SAVE_SNAPSHOT, "save snapshot failed");
     }
+    return;
+  }
+
+  arg->done = done_guard.release();
+  if (FLAGS_enable_raft_snapshot_async_save) {
+    bthread_t tid;
+    if (bthread_start_background(&tid, nullptr, SaveSnapshotRoutine, arg) == 0) {
+      return;
+    }
+    DINGO_LOG(WARNING) << fmt::format("[raft.snapshot][region({})] start save snapshot bthread failed, run in place.",
+                                      region->Id());
   }
+
+  SaveSnapshotRoutine(arg);
 }
 
-void SaveSnapshotByDingo(store::RegionPtr region, std::shared_ptr<RawEngine> /*engine*/, int64_t /*term*/,
-                         int64_t /*log_index*/, braft::SnapshotWriter* writer, braft::Closure* done) {
+// Memory raw engine has no persistent data, so serialize region data to sst files.
+static void SaveSnapshotByMemEngine(store::RegionPtr region, std::shared_ptr<MemRawEngine> engine, int64_t term,
+                                    int64_t log_index, braft::SnapshotWriter* writer, braft::Closure* done) {
+  if (!AddRegionMetaFile(writer, region, term, log_index)) {
+    done->status().set_error(pb::error::ERAFT_SAVE_SNAPSHOT, "save snapshot failed");
+    return;
+  }
+
+  auto range = region->Range(true);
+  auto cf_names = Helper::GetColumnFamilyNames(region->Range(false).start_key());
+  for (const auto& cf_name : cf_names) {
+    std::string filename = cf_name + std::string(Constant::kRaftSnapshotRegionDateFileNameSuffix);
+    auto status = engine->SaveFile(cf_name, range, writer->get_path() + "/" + filename);
+    if (status.error_code() == pb::error::ENO_ENTRIES) {
+      continue;
+    } else if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[raft.snapshot][region({})] save cf({}) sst file failed, error: {}",
+                                      region->Id(), cf_name, status.error_str());
+      done->status().set_error(pb::error::ERAFT_SAVE_SNAPSHOT, "save snapshot failed");
+      return;
+    }
+
+    writer->add_file(filename);
+  }
+}
+
+void SaveSnapshotByDingo(store::RegionPtr region, std::shared_ptr<RawEngine> engine, int64_t term, int64_t log_index,
+                         braft::SnapshotWriter* writer, braft::Closure* done) {
   brpc::ClosureGuard done_guard(done);
 
+  auto mem_engine = std::dynamic_pointer_cast<MemRawEngine>(engine);
+  if (mem_engine != nullptr) {
+    SaveSnapshotByMemEngine(region, mem_engine, term, log_index, writer, done);
+    return;
+  }
+
   // this is a fake snapshot only used to trim raft log.
   // so here we add 7 file names to the snapshot writer:
   // snapshot_region.meta, default.sst, vector_scalar.sst, vector_table.sst, data.sst, lock.sst, write.sst
@@ -490,6 +613,8 @@ int RaftSaveSnapshotHandler::Handle(store::RegionPtr region, std::shared_ptr<Raw
   std::string policy = FLAGS_raft_snapshot_policy;
   if (BAIDU_LIKELY(policy == Constant::kRaftSnapshotPolicyDingo)) {
     SaveSnapshotByDingo(region, engine, term, log_index, writer, done);
+  } else if (policy == Constant::kRaftSnapshotPolicyCheckpoint) {
+    SaveSnapshotByCheckpoint(region, engine, term, log_index, writer, done);
   } else {
     DINGO_LOG(FATAL) << fmt::format("[raft.snapshot][region({})] unknown snapshot policy: {}", region->Id(), policy);
   }
@@ -51,6 +51,14 @@ class RaftSnapshot {
   bool SaveSnapshot(braft::SnapshotWriter* writer, store::RegionPtr region, GenSnapshotFileFunc func,
                     int64_t region_version, int64_t term, int64_t log_index);
 
+  // Write region meta and generate checkpoint, must run in fsm thread.
+  bool PrepareSnapshot(braft::SnapshotWriter* writer, store::RegionPtr region, GenSnapshotFileFunc func, int64_t term,
+                       int64_t log_index, std::string& checkpoint_path,
+                       std::vector<pb::store_internal::SstFileInfo>& sst_files);
+  // Link checkpoint files to snapshot writer and update snapshot epoch, can run in background.
+  bool CommitSnapshot(braft::SnapshotWriter* writer, store::RegionPtr region, const std::string& checkpoint_path,
+                      const std::vector<pb::store_internal::SstFileInfo>& sst_files, int64_t region_version);
+
   bool LoadSnapshot(braft::SnapshotReader* reader, store::RegionPtr region);
   bool LoadSnapshotDingo(braft::SnapshotReader* reader, store::RegionPtr region);
 
@@ -120,11 +120,28 @@ int VectorIndexFollowerStopHandler::Handle(store::RegionPtr /*region*/, const br
   return 0;
 }
 
+// document
+int DocumentIndexLeaderStartHandler::Handle(store::RegionPtr region, int64_t) {
+  if (region == nullptr) {
+    return 0;
+  }
+
+  // Document index is loaded at every peer, but page cache of follower may be cold, warmup it for leader read.
+  auto document_index_wrapper = region->DocumentIndexWrapper();
+  if (document_index_wrapper != nullptr && document_index_wrapper->IsOwnReady()) {
+    DocumentIndexManager::LaunchWarmupDocumentIndex(document_index_wrapper, "beingLeader");
+  }
+
+  return 0;
+}
+
 std::shared_ptr<HandlerCollection> LeaderStartHandlerFactory::Build() {
   // vector
   auto handler_collection = std::make_shared<HandlerCollection>();
   if (GetRole() == pb::common::INDEX) {
     handler_collection->Register(std::make_shared<VectorIndexLeaderStartHandler>());
+  } else if (GetRole() == pb::common::DOCUMENT) {
+    handler_collection->Register(std::make_shared<DocumentIndexLeaderStartHandler>());
   }
 
   return handler_collection;
@@ -48,6 +48,14 @@ class VectorIndexFollowerStopHandler : public BaseHandler {
   int Handle(store::RegionPtr region, const braft::LeaderChangeContext &ctx) override;
 };
 
+// document
+// DocumentIndexLeaderStart
+class DocumentIndexLeaderStartHandler : public BaseHandler {
+ public:
+  HandlerType GetType() override { return HandlerType::kDocumentIndexLeaderStart; }
+  int Handle(store::RegionPtr region, int64_t term_id) override;
+};
+
 // Leader start handler collection
 class LeaderStartHandlerFactory : public HandlerFactory {
  public:
@@ -30,6 +30,7 @@
 #include "butil/compiler_specific.h"
 #include "butil/iobuf.h"
 #include "butil/time.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
@@ -69,11 +70,28 @@ BRPC_VALIDATE_GFLAG(rocks_log_write_wait_time_ms, brpc::PositiveInteger);
 DEFINE_int32(rocks_log_recycle_file_num, 8, "rocks log storage recycle log file num");
 BRPC_VALIDATE_GFLAG(rocks_log_recycle_file_num, brpc::PositiveInteger);
 
+DEFINE_bool(rocks_log_enable_pipeline_sync, true, "rocks log storage sync wal in other queue, overlap write and sync");
+BRPC_VALIDATE_GFLAG(rocks_log_enable_pipeline_sync, brpc::PassValidate);
+
 static bvar::LatencyRecorder g_append_entry_total_latency("dingo_rocks_raft_log_total");
 static bvar::LatencyRecorder g_append_entry_wait_latency("dingo_rocks_raft_log_wait");
 static bvar::LatencyRecorder g_write_latency("dingo_rocks_raft_log_write");
 static bvar::LatencyRecorder g_write_size("dingo_rocks_raft_log_write_size");
 static bvar::LatencyRecorder g_sync_wal_latency("dingo_rocks_raft_log_sync");
+static bvar::LatencyRecorder g_sync_group_size("dingo_rocks_raft_log_sync_group_size");
+
+DEFINE_bool(rocks_log_enable_entry_cache, true, "rocks log storage cache recent log entries in memory");
+BRPC_VALIDATE_GFLAG(rocks_log_enable_entry_cache, brpc::PassValidate);
+
+DEFINE_int64(rocks_log_entry_cache_region_max_bytes, 4 * 1024 * 1024, "rocks log storage entry cache max bytes of region");
+BRPC_VALIDATE_GFLAG(rocks_log_entry_cache_region_max_bytes, brpc::NonNegativeInteger);
+
+DEFINE_int64(rocks_log_entry_cache_max_bytes, 256 * 1024 * 1024, "rocks log storage entry cache max bytes");
+BRPC_VALIDATE_GFLAG(rocks_log_entry_cache_max_bytes, brpc::NonNegativeInteger);
+
+static bvar::Adder<int64_t> g_entry_cache_bytes("dingo_rocks_raft_log_entry_cache_bytes");
+static bvar::Adder<uint64_t> g_entry_cache_hit_count("dingo_rocks_raft_log_entry_cache_hit_count");
+static bvar::Adder<uint64_t> g_entry_cache_miss_count("dingo_rocks_raft_log_entry_cache_miss_count");
 
 static bool IsLE() {
   uint32_t i = 1;
@@ -309,6 +327,14 @@ static int ExecuteRoutine(void* meta, bthread::TaskIterator<Mutation*>& iter) {
 
     g_write_latency << Helper::TimestampUs() - start_time;
 
+    // All regions mutation written before sync are durable by one fsync,
+    // so hand over to sync queue and write next batch at the same time.
+    if (braft::FLAGS_raft_sync && FLAGS_rocks_log_enable_pipeline_sync && log_storage->CommitSync(mutations)) {
+      mutations.clear();
+      write_ops.clear();
+      return;
+    }
+
     if (braft::FLAGS_raft_sync) {
       start_time = Helper::TimestampUs();
 
@@ -368,6 +394,35 @@ static int ExecuteRoutine(void* meta, bthread::TaskIterator<Mutation*>& iter) {
   return 0;
 }
 
+static int SyncRoutine(void* meta, bthread::TaskIterator<Mutation*>& iter) {  // NOLINT
+  RocksLogStorage* log_storage = static_cast<RocksLogStorage*>(meta);
+
+  std::vector<Mutation*> mutations;
+  for (; iter; ++iter) {
+    if (BAIDU_LIKELY(*iter != nullptr)) {
+      mutations.push_back(*iter);
+    }
+  }
+
+  if (mutations.empty()) {
+    return 0;
+  }
+
+  int64_t start_time = Helper::TimestampUs();
+
+  bool ret = log_storage->SyncWal();
+
+  g_sync_wal_latency << Helper::TimestampUs() - start_time;
+  g_sync_group_size << mutations.size();
+
+  for (auto* mutation : mutations) {
+    mutation->ret = ret;
+    mutation->cond.DecreaseSignal();
+  }
+
+  return 0;
+}
+
 void LogEntry::Print() const {
   DINGO_LOG(INFO) << fmt::format("[raft.log][{}] log entry, type({}) term({}) index({}) in_data({}) out_data({})",
                                  region_id, LogEntryTypeName(type), term, index, in_data->size(), out_data.size());
@@ -425,6 +480,11 @@ bool RocksLogStorage::InitExecutionQueue() {
   options.bthread_attr = BTHREAD_ATTR_NORMAL;
   options.use_pthread = true;
 
+  if (bthread::execution_queue_start(&sync_queue_id_, &options, SyncRoutine, this) != 0) {
+    DINGO_LOG(ERROR) << "[raft.log] start sync execution queue failed.";
+    return false;
+  }
+
   if (bthread::execution_queue_start(&queue_id_, &options, ExecuteRoutine, this) != 0) {
     DINGO_LOG(ERROR) << "[raft.log] start execution queue failed.";
     return false;
@@ -444,6 +504,17 @@ bool RocksLogStorage::CloseExecutionQueue() {
     return false;
   }
 
+  // Write queue may hand over mutation to sync queue until it stop.
+  if (bthread::execution_queue_stop(sync_queue_id_) != 0) {
+    DINGO_LOG(ERROR) << "[raft.log] stop sync execution queue failed.";
+    return false;
+  }
+
+  if (bthread::execution_queue_join(sync_queue_id_) != 0) {
+    DINGO_LOG(ERROR) << "[raft.log] join sync execution queue failed.";
+    return false;
+  }
+
   return true;
 }
 
@@ -617,6 +688,202 @@ bool RocksLogStorage::InitIndexMeta() {
   return true;
 }
 
+LogEntryCache::LogEntryCache() : memory_tracker_(MemoryTracker::Subsystem(MemoryTracker::kRaftLogCache)) {
+  bthread_mutex_init(&mutex_, nullptr);
+  memory_tracker_->SetEvictor([this](int64_t bytes) -> int64_t { return Shrink(bytes); });
+}
+
+LogEntryCache::~LogEntryCache() {
+  memory_tracker_->SetEvictor(nullptr);
+  g_entry_cache_bytes << -total_bytes_.load(std::memory_order_relaxed);
+  memory_tracker_->Release(total_bytes_.load(std::memory_order_relaxed));
+  bthread_mutex_destroy(&mutex_);
+}
+
+void LogEntryCache::PopFront(RegionCache& region_cache) {
+  int64_t bytes = EntryBytes(region_cache.log_entries.front());
+  region_cache.log_entries.pop_front();
+  region_cache.bytes -= bytes;
+  total_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+  g_entry_cache_bytes << -bytes;
+  memory_tracker_->Release(bytes);
+}
+
+void LogEntryCache::PopBack(RegionCache& region_cache) {
+  int64_t bytes = EntryBytes(region_cache.log_entries.back());
+  region_cache.log_entries.pop_back();
+  region_cache.bytes -= bytes;
+  total_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+  g_entry_cache_bytes << -bytes;
+  memory_tracker_->Release(bytes);
+}
+
+void LogEntryCache::Append(int64_t region_id, const std::vector<LogEntry>& log_entries) {
+  if (log_entries.empty()) {
+    return;
+  }
+  // stop caching when store is over memory hard limit, braft read from storage instead.
+  if (!FLAGS_rocks_log_enable_entry_cache || BAIDU_UNLIKELY(memory_tracker_->IsOverHardLimit())) {
+    Erase(region_id);
+    return;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto& region_cache = region_caches_[region_id];
+  // Drop conflict entries, keep cached entries contiguous.
+  int64_t first_index = log_entries.front().index;
+  while (!region_cache.log_entries.empty() && region_cache.log_entries.back()->index >= first_index) {
+    PopBack(region_cache);
+  }
+  if (!region_cache.log_entries.empty() && region_cache.log_entries.back()->index + 1 != first_index) {
+    while (!region_cache.log_entries.empty()) {
+      PopBack(region_cache);
+    }
+  }
+
+  for (const auto& log_entry : log_entries) {
+    auto cache_log_entry = LogEntry::New();
+    cache_log_entry->type = log_entry.type;
+    cache_log_entry->region_id = log_entry.region_id;
+    cache_log_entry->term = log_entry.term;
+    cache_log_entry->index = log_entry.index;
+    if (log_entry.in_data != nullptr) {
+      cache_log_entry->out_data = log_entry.in_data->to_string();
+    } else {
+      cache_log_entry->out_data = log_entry.out_data;
+    }
+
+    int64_t bytes = EntryBytes(cache_log_entry);
+    region_cache.log_entries.push_back(cache_log_entry);
+    region_cache.bytes += bytes;
+    total_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    g_entry_cache_bytes << bytes;
+    memory_tracker_->Consume(bytes);
+
+    // Evict oldest entries of this region when exceed memory quota.
+    while (!region_cache.log_entries.empty() &&
+           (region_cache.bytes > FLAGS_rocks_log_entry_cache_region_max_bytes ||
+            total_bytes_.load(std::memory_order_relaxed) > FLAGS_rocks_log_entry_cache_max_bytes)) {
+      PopFront(region_cache);
+    }
+  }
+
+  if (region_cache.log_entries.empty()) {
+    region_caches_.erase(region_id);
+  }
+}
+
+void LogEntryCache::TruncatePrefix(int64_t region_id, int64_t keep_first_index) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = region_caches_.find(region_id);
+  if (it == region_caches_.end()) {
+    return;
+  }
+
+  auto& region_cache = it->second;
+  while (!region_cache.log_entries.empty() && region_cache.log_entries.front()->index < keep_first_index) {
+    PopFront(region_cache);
+  }
+  if (region_cache.log_entries.empty()) {
+    region_caches_.erase(it);
+  }
+}
+
+void LogEntryCache::TruncateSuffix(int64_t region_id, int64_t keep_last_index) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = region_caches_.find(region_id);
+  if (it == region_caches_.end()) {
+    return;
+  }
+
+  auto& region_cache = it->second;
+  while (!region_cache.log_entries.empty() && region_cache.log_entries.back()->index > keep_last_index) {
+    PopBack(region_cache);
+  }
+  if (region_cache.log_entries.empty()) {
+    region_caches_.erase(it);
+  }
+}
+
+void LogEntryCache::Erase(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = region_caches_.find(region_id);
+  if (it == region_caches_.end()) {
+    return;
+  }
+
+  auto& region_cache = it->second;
+  total_bytes_.fetch_sub(region_cache.bytes, std::memory_order_relaxed);
+  g_entry_cache_bytes << -region_cache.bytes;
+  memory_tracker_->Release(region_cache.bytes);
+  region_caches_.erase(it);
+}
+
+int64_t LogEntryCache::Shrink(int64_t bytes) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  int64_t old_total_bytes = total_bytes_.load(std::memory_order_relaxed);
+  // pop oldest entry of every region in turn, keep recent entries of all region.
+  while (!region_caches_.empty() && old_total_bytes - total_bytes_.load(std::memory_order_relaxed) < bytes) {
+    for (auto it = region_caches_.begin(); it != region_caches_.end();) {
+      PopFront(it->second);
+      if (it->second.log_entries.empty()) {
+        it = region_caches_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  return old_total_bytes - total_bytes_.load(std::memory_order_relaxed);
+}
+
+LogEntryPtr LogEntryCache::Get(int64_t region_id, int64_t index) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = region_caches_.find(region_id);
+  if (it == region_caches_.end()) {
+    return nullptr;
+  }
+
+  const auto& log_entries = it->second.log_entries;
+  int64_t front_index = log_entries.front()->index;
+  if (index < front_index || index > log_entries.back()->index) {
+    return nullptr;
+  }
+
+  return log_entries[index - front_index];
+}
+
+int64_t LogEntryCache::Get(int64_t region_id, int64_t start_index, int64_t end_index,
+                           std::vector<LogEntryPtr>& log_entries) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = region_caches_.find(region_id);
+  if (it == region_caches_.end()) {
+    return end_index;
+  }
+
+  const auto& cached_log_entries = it->second.log_entries;
+  int64_t front_index = cached_log_entries.front()->index;
+  int64_t cached_start_index = std::max(start_index, front_index);
+  if (cached_start_index >= end_index) {
+    return end_index;
+  }
+
+  int64_t cached_end_index = std::min(end_index, cached_log_entries.back()->index + 1);
+  log_entries.reserve(std::max(cached_end_index - cached_start_index, static_cast<int64_t>(0)));
+  for (int64_t index = cached_start_index; index < cached_end_index; ++index) {
+    log_entries.push_back(cached_log_entries[index - front_index]);
+  }
+
+  return cached_start_index;
+}
+
 bool RocksLogStorage::Init() {
   CHECK(!client_types_.empty()) << "[raft.log] please firstly register client type.";
 
@@ -786,6 +1053,7 @@ void RocksLogStorage::AdjustIndexMeta(const std::vector<Mutation*>& mutations) {
       case Mutation::Type::kAppendLogEntry: {
         int64_t last_index = mutation->log_entries.back().index;
         UpdateLastIndex(mutation->region_id, last_index);
+        log_entry_cache_.Append(mutation->region_id, mutation->log_entries);
       } break;
 
       case Mutation::Type::kTruncatePrefix: {
@@ -803,6 +1071,7 @@ void RocksLogStorage::AdjustIndexMeta(const std::vector<Mutation*>& mutations) {
             UpdateLastIndex(region_id, mutation->end_index - 1);
           }
         }
+        log_entry_cache_.TruncatePrefix(region_id, mutation->end_index);
       } break;
 
       case Mutation::Type::kTruncateSuffix: {
@@ -820,6 +1089,7 @@ void RocksLogStorage::AdjustIndexMeta(const std::vector<Mutation*>& mutations) {
             UpdateFirstIndex(region_id, mutation->start_index);
           }
         }
+        log_entry_cache_.TruncateSuffix(region_id, mutation->start_index - 1);
 
       } break;
 
@@ -828,6 +1098,7 @@ void RocksLogStorage::AdjustIndexMeta(const std::vector<Mutation*>& mutations) {
 
         DINGO_LOG(INFO) << fmt::format("[raft.log][{}] apply reset log.", region_id);
         ResetFirstAndLastIndex(region_id, mutation->reset_index, mutation->reset_index - 1);
+        log_entry_cache_.Erase(region_id);
       } break;
 
       case Mutation::Type::kDestroy: {
@@ -835,6 +1106,7 @@ void RocksLogStorage::AdjustIndexMeta(const std::vector<Mutation*>& mutations) {
 
         DINGO_LOG(INFO) << fmt::format("[raft.log][{}] apply destroy log.", region_id);
         DeleteIndexMeta(region_id);
+        log_entry_cache_.Erase(region_id);
 
       } break;
 
@@ -846,6 +1118,27 @@ void RocksLogStorage::AdjustIndexMeta(const std::vector<Mutation*>& mutations) {
   }
 }
 
+bool RocksLogStorage::CommitSync(const std::vector<Mutation*>& mutations) {
+  for (size_t i = 0; i < mutations.size(); ++i) {
+    if (BAIDU_UNLIKELY(bthread::execution_queue_execute(sync_queue_id_, mutations[i]) != 0)) {
+      DINGO_LOG(ERROR) << fmt::format("[raft.log] sync execution queue execute fail, sync in place.");
+      if (i == 0) {
+        return false;
+      }
+
+      // Some mutations already in queue, sync left in place.
+      bool ret = SyncWal();
+      for (size_t j = i; j < mutations.size(); ++j) {
+        mutations[j]->ret = ret;
+        mutations[j]->cond.DecreaseSignal();
+      }
+      break;
+    }
+  }
+
+  return true;
+}
+
 bool RocksLogStorage::SyncWal() {
   // auto status = db_->FlushWAL(true);
   auto status = db_->SyncWAL();
@@ -1041,6 +1334,32 @@ int64_t RocksLogStorage::GetTerm(int64_t region_id, int64_t index) {
 }
 
 LogEntryPtr RocksLogStorage::GetEntry(int64_t region_id, int64_t index) {
+  auto log_entry = log_entry_cache_.Get(region_id, index);
+  if (log_entry != nullptr) {
+    g_entry_cache_hit_count << 1;
+    return log_entry;
+  }
+
+  g_entry_cache_miss_count << 1;
+  return GetEntryFromRocks(region_id, index);
+}
+
+std::vector<LogEntryPtr> RocksLogStorage::GetEntries(int64_t region_id, int64_t start_index, int64_t end_index) {
+  std::vector<LogEntryPtr> cached_log_entries;
+  int64_t cached_start_index = log_entry_cache_.Get(region_id, start_index, end_index, cached_log_entries);
+  if (cached_start_index <= start_index) {
+    g_entry_cache_hit_count << 1;
+    return cached_log_entries;
+  }
+
+  g_entry_cache_miss_count << 1;
+  auto log_entries = GetEntriesFromRocks(region_id, start_index, cached_start_index);
+  log_entries.insert(log_entries.end(), cached_log_entries.begin(), cached_log_entries.end());
+
+  return log_entries;
+}
+
+LogEntryPtr RocksLogStorage::GetEntryFromRocks(int64_t region_id, int64_t index) {
   std::string key = Codec::EncodeKey(region_id, index);
 
   std::string value;
@@ -1068,7 +1387,8 @@ LogEntryPtr RocksLogStorage::GetEntry(int64_t region_id, int64_t index) {
   return log_entry;
 }
 
-std::vector<LogEntryPtr> RocksLogStorage::GetEntries(int64_t region_id, int64_t start_index, int64_t end_index) {
+std::vector<LogEntryPtr> RocksLogStorage::GetEntriesFromRocks(int64_t region_id, int64_t start_index,
+                                                              int64_t end_index) {
   std::string start_key = Codec::EncodeKey(region_id, start_index);
   std::string end_key = Codec::EncodeKey(region_id, end_index);
 
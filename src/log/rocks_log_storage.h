@@ -18,6 +18,7 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <map>
 #include <memory>
@@ -29,7 +30,9 @@
 #include "braft/log_entry.h"
 #include "braft/storage.h"
 #include "bthread/execution_queue.h"
+#include "bthread/mutex.h"
 #include "butil/iobuf.h"
+#include "common/memory_tracker.h"
 #include "common/synchronization.h"
 #include "rocksdb/db.h"
 #include "rocksdb/listener.h"
@@ -173,6 +176,51 @@ struct WriteOp {
   int64_t Size() const { return key_or_start_key.size() + value_or_end_key.size(); }
 };
 
+// Tail cache of recent log entries per region, shared by braft replication and vector/document index catch up.
+// Cached entries of one region are always contiguous and end at last log index, so [start, last] can be taken
+// from cache once start is not less than the first cached index. Entries taken from cache must not be modified.
+class LogEntryCache {
+ public:
+  LogEntryCache();
+  ~LogEntryCache();
+
+  LogEntryCache(const LogEntryCache&) = delete;
+  const LogEntryCache& operator=(const LogEntryCache&) = delete;
+
+  void Append(int64_t region_id, const std::vector<LogEntry>& log_entries);
+  // Drop entries [1, keep_first_index).
+  void TruncatePrefix(int64_t region_id, int64_t keep_first_index);
+  // Drop entries (keep_last_index, infinity).
+  void TruncateSuffix(int64_t region_id, int64_t keep_last_index);
+  void Erase(int64_t region_id);
+  // Drop oldest entries of all regions under memory pressure, return freed bytes.
+  int64_t Shrink(int64_t bytes);
+
+  LogEntryPtr Get(int64_t region_id, int64_t index);
+  // Take cached entries of [start_index, end_index), return the first index taken from cache,
+  // entries before it need read from storage, return end_index when nothing is cached.
+  int64_t Get(int64_t region_id, int64_t start_index, int64_t end_index, std::vector<LogEntryPtr>& log_entries);
+
+  int64_t Bytes() const { return total_bytes_.load(std::memory_order_relaxed); }
+
+ private:
+  struct RegionCache {
+    std::deque<LogEntryPtr> log_entries;
+    int64_t bytes{0};
+  };
+
+  static int64_t EntryBytes(const LogEntryPtr& log_entry) { return sizeof(LogEntry) + log_entry->out_data.size(); }
+  void PopFront(RegionCache& region_cache);
+  void PopBack(RegionCache& region_cache);
+
+  bthread_mutex_t mutex_;
+  std::map<int64_t, RegionCache> region_caches_;
+
+  std::atomic<int64_t> total_bytes_{0};
+
+  MemoryTrackerPtr memory_tracker_;
+};
+
 class RocksLogStorage;
 using RocksLogStoragePtr = std::shared_ptr<RocksLogStorage>;
 using LogStoragePtr = std::shared_ptr<RocksLogStorage>;
@@ -197,12 +245,15 @@ class RocksLogStorage {
   void AdjustIndexMeta(const std::vector<Mutation*>& mutations);
 
   bool SyncWal();
+  // Hand over written mutations to sync queue, mutations are signaled after wal synced.
+  bool CommitSync(const std::vector<Mutation*>& mutations);
 
   int64_t FirstLogIndex(int64_t region_id);
   int64_t LastLogIndex(int64_t region_id);
 
   int64_t GetTerm(int64_t region_id, int64_t index);
 
+  // Entries maybe shared with entry cache, must not be modified.
   LogEntryPtr GetEntry(int64_t region_id, int64_t index);
   std::vector<LogEntryPtr> GetEntries(int64_t region_id, int64_t start_index, int64_t end_index);
   std::vector<LogEntryPtr> GetDataEntries(int64_t region_id, int64_t start_index, int64_t end_index);
@@ -246,6 +297,9 @@ class RocksLogStorage {
 
   bool DeleteRange(const std::string& start_key, const std::string& end_key);
 
+  LogEntryPtr GetEntryFromRocks(int64_t region_id, int64_t index);
+  std::vector<LogEntryPtr> GetEntriesFromRocks(int64_t region_id, int64_t start_index, int64_t end_index);
+
   std::string path_;
 
   std::vector<ClientType> client_types_;
@@ -260,6 +314,10 @@ class RocksLogStorage {
   std::vector<rocksdb::ColumnFamilyHandle*> family_handles_;
 
   bthread::ExecutionQueueId<Mutation*> queue_id_;
+  // Sync wal for all regions written mutations, group commit across regions.
+  bthread::ExecutionQueueId<Mutation*> sync_queue_id_;
+
+  LogEntryCache log_entry_cache_;
 };
 
 class RocksLogStorageWrapper : public braft::LogStorage {
@@ -30,6 +30,7 @@
 #include "braft/protobuf_file.h"
 #include "braft/util.h"
 #include "butil/atomicops.h"
+#include "butil/compiler_specific.h"
 #include "butil/errno.h"
 #include "butil/fd_utility.h"              // butil::make_close_on_exec
 #include "butil/file_util.h"               // butil::CreateDirectory
@@ -39,8 +40,10 @@
 #include "butil/time.h"
 #include "bvar/latency_recorder.h"
 #include "common/constant.h"
+#include "common/cycle_clock.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/trace.h"
 #include "fmt/core.h"
 #include "proto/store_internal.pb.h"
 
@@ -788,6 +791,19 @@ int SegmentLogStorage::AppendEntries(const std::vector<braft::LogEntry*>& entrie
         entries.front()->id.term, entries.front()->id.index);
     return -1;
   }
+  // sampled entry of traced request, parse raft cmd header only when trace is enabled.
+  std::vector<std::pair<int64_t, TraceContext>> trace_entries;
+  int64_t trace_start_time_ns = 0;
+  if (BAIDU_UNLIKELY(Tracer::IsEnabled())) {
+    for (const auto* entry : entries) {
+      TraceContext trace_context;
+      if (entry->type == braft::ENTRY_TYPE_DATA && Tracer::Extract(entry->data, trace_context)) {
+        trace_entries.emplace_back(entry->id.index, trace_context);
+      }
+    }
+    trace_start_time_ns = CycleClock::NowNs();
+  }
+
   std::shared_ptr<Segment> last_segment;
   int64_t now = 0;
   int64_t delta_time_us = 0;
@@ -823,6 +839,24 @@ int SegmentLogStorage::AppendEntries(const std::vector<braft::LogEntry*>& entrie
     metric->sync_segment_time_us += delta_time_us;
     g_segment_log_sync_segment_latency << delta_time_us;
   }
+
+  if (BAIDU_UNLIKELY(!trace_entries.empty())) {
+    int64_t trace_end_time_ns = CycleClock::NowNs();
+    for (const auto& [log_index, trace_context] : trace_entries) {
+      Span span;
+      span.name = "raft_append_entries";
+      span.context = trace_context;
+      span.context.span_id = Tracer::GenSpanId();
+      span.parent_span_id = trace_context.span_id;
+      span.start_time_ns = trace_start_time_ns;
+      span.end_time_ns = trace_end_time_ns;
+      span.attributes.emplace_back("region_id", std::to_string(region_id_));
+      span.attributes.emplace_back("log_index", std::to_string(log_index));
+      span.attributes.emplace_back("entry_count", std::to_string(entries.size()));
+      Tracer::Emit(std::move(span));
+    }
+  }
+
   return entries.size();
 }
 
@@ -24,6 +24,7 @@
 #include <string_view>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/runnable.h"
@@ -34,15 +35,25 @@
 #include "mvcc/codec.h"
 #include "proto/common.pb.h"
 #include "proto/coordinator.pb.h"
+#include "proto/error.pb.h"
 #include "proto/raft.pb.h"
 #include "server/server.h"
 #include "server/service_helper.h"
+#include "store/heartbeat.h"
 #include "vector/vector_index_manager.h"
 
 namespace dingodb {
 
 DECLARE_bool(region_enable_auto_merge);
 
+DEFINE_int32(region_merge_batch_max_count, 8, "max adjacent co-located regions merged by one merge check task");
+BRPC_VALIDATE_GFLAG(region_merge_batch_max_count, brpc::PositiveInteger);
+DEFINE_int32(region_merge_batch_wait_timeout_s, 60, "batch merge wait one merge finish timeout seconds");
+BRPC_VALIDATE_GFLAG(region_merge_batch_wait_timeout_s, brpc::PositiveInteger);
+DEFINE_int32(region_merge_batch_heartbeat_wait_ms, 1000,
+             "batch merge wait heartbeat report merged region to coordinator before next merge");
+BRPC_VALIDATE_GFLAG(region_merge_batch_heartbeat_wait_ms, brpc::NonNegativeInteger);
+
 static std::atomic<bool> g_sequential_scan(true);
 
 bool MergeCheckWorkers::Init(uint32_t num) {
@@ -156,14 +167,14 @@ static bool CheckLeaderAndFollowerStatus(int64_t region_id) {
   return true;
 }
 
-void MergeCheckTask::MergeCheck() {
-  if (merge_from_region_ == nullptr || merge_to_region_ == nullptr) {
-    return;
+bool MergeCheckTask::MergeCheck(store::RegionPtr merge_from_region, store::RegionPtr merge_to_region) {
+  if (merge_from_region == nullptr || merge_to_region == nullptr) {
+    return false;
   }
 
   int64_t start_time = Helper::TimestampMs();
-  auto epoch = merge_from_region_->Epoch();
-  auto plain_range = merge_from_region_->Range(false);
+  auto epoch = merge_from_region->Epoch();
+  auto plain_range = merge_from_region->Range(false);
   auto encode_range = mvcc::Codec::EncodeRange(plain_range);
 
   std::vector<std::string> raw_cf_names;
@@ -173,45 +184,45 @@ void MergeCheckTask::MergeCheck() {
   std::vector<std::string> cf_names = txn_cf_names.empty() ? raw_cf_names : txn_cf_names;
 
   DINGO_LOG(INFO) << fmt::format("[merge.check][region({})] Will check merge for raw_range{} cf_names({})",
-                                 merge_from_region_->Id(), Helper::RangeToString(plain_range),
+                                 merge_from_region->Id(), Helper::RangeToString(plain_range),
                                  Helper::VectorToString(cf_names));
 
   bool need_merge = true;
   std::string reason;
   do {
-    need_merge = ValidRegion(merge_from_region_, reason);
+    need_merge = ValidRegion(merge_from_region, reason);
     if (!need_merge) {
       break;
     }
-    need_merge = ValidRegion(merge_to_region_, reason);
+    need_merge = ValidRegion(merge_to_region, reason);
     if (!need_merge) {
       break;
     }
-    if (!CheckLeaderAndFollowerStatus(merge_from_region_->Id())) {
+    if (!CheckLeaderAndFollowerStatus(merge_from_region->Id())) {
       need_merge = false;
       reason = "not leader or follower abnormal";
       break;
     }
     // validate region store engine
-    if (merge_from_region_->Definition().store_engine() != merge_to_region_->Definition().store_engine()) {
+    if (merge_from_region->Definition().store_engine() != merge_to_region->Definition().store_engine()) {
       need_merge = false;
       reason = "store_engine is different";
       break;
     }
     // validate region raw engine
-    if (merge_from_region_->Definition().raw_engine() != merge_to_region_->Definition().raw_engine()) {
+    if (merge_from_region->Definition().raw_engine() != merge_to_region->Definition().raw_engine()) {
       need_merge = false;
       reason = "raw_engine is different";
       break;
     }
     // validate region part id
-    if (merge_from_region_->Definition().part_id() != merge_to_region_->Definition().part_id()) {
+    if (merge_from_region->Definition().part_id() != merge_to_region->Definition().part_id()) {
       need_merge = false;
       reason = "region partition is different";
       break;
     }
     // validate region peers
-    if (Helper::IsDifferencePeers(merge_from_region_->Definition(), merge_to_region_->Definition())) {
+    if (Helper::IsDifferencePeers(merge_from_region->Definition(), merge_to_region->Definition())) {
       need_merge = false;
       reason = "region peers is differencce";
       break;
@@ -221,24 +232,149 @@ void MergeCheckTask::MergeCheck() {
   DINGO_LOG(INFO) << fmt::format(
       "[merge.check][region({})] merge check result({}) reason({}) "
       " elapsed time({}ms)",
-      merge_from_region_->Id(), need_merge, reason, Helper::TimestampMs() - start_time);
+      merge_from_region->Id(), need_merge, reason, Helper::TimestampMs() - start_time);
   if (!need_merge) {
-    return;
+    return false;
   }
 
   // Invoke coordinator SplitRegion api.
   auto coordinator_interaction = Server::GetInstance().GetCoordinatorInteraction();
   pb::coordinator::MergeRegionRequest request;
   pb::coordinator::MergeRegionResponse response;
-  request.mutable_merge_request()->set_target_region_id(merge_to_region_->Id());
-  request.mutable_merge_request()->set_source_region_id(merge_from_region_->Id());
+  request.mutable_merge_request()->set_target_region_id(merge_to_region->Id());
+  request.mutable_merge_request()->set_source_region_id(merge_from_region->Id());
 
   auto status = coordinator_interaction->SendRequest("MergeRegion", request, response);
   if (!status.ok()) {
     DINGO_LOG(WARNING) << fmt::format("[merge.check][region({})] send MergeRegion failed, error: {}",
-                                      merge_from_region_->Id(), Helper::PrintStatus(status));
-    return;
+                                      merge_from_region->Id(), Helper::PrintStatus(status));
+    return false;
+  }
+  if (response.error().errcode() != pb::error::OK) {
+    DINGO_LOG(WARNING) << fmt::format("[merge.check][region({})] MergeRegion failed, error: {} {}",
+                                      merge_from_region->Id(), pb::error::Errno_Name(response.error().errcode()),
+                                      response.error().errmsg());
+    return false;
+  }
+
+  return true;
+}
+
+void MergeCheckTask::MergeCheck() {
+  for (size_t i = 0; i + 1 < regions_.size(); ++i) {
+    auto merge_from_range = regions_[i]->Range(false);
+    if (!MergeCheck(regions_[i], regions_[i + 1])) {
+      return;
+    }
+
+    // next merge need range of this merge.
+    if (i + 2 < regions_.size() && !WaitMergeFinish(merge_from_range, regions_[i + 1])) {
+      return;
+    }
+  }
+}
+
+bool MergeCheckTask::WaitMergeFinish(const pb::common::Range& merge_from_range, store::RegionPtr merge_to_region) {
+  int64_t start_time = Helper::TimestampMs();
+  while (Helper::TimestampMs() - start_time < FLAGS_region_merge_batch_wait_timeout_s * 1000) {
+    auto merge_to_range = merge_to_region->Range(false);
+    if (merge_to_range.start_key() <= merge_from_range.start_key() &&
+        merge_from_range.end_key() <= merge_to_range.end_key()) {
+      // coordinator validate next merge with region range of heartbeat.
+      Heartbeat::TriggerStoreHeartbeat({merge_to_region->Id()}, true);
+      bthread_usleep(FLAGS_region_merge_batch_heartbeat_wait_ms * 1000);
+
+      DINGO_LOG(INFO) << fmt::format("[merge.check][region({})] batch merge step finish, range{} elapsed time({}ms)",
+                                     merge_to_region->Id(), Helper::RangeToString(merge_to_range),
+                                     Helper::TimestampMs() - start_time);
+      return true;
+    }
+
+    bthread_usleep(100 * 1000);
   }
+
+  DINGO_LOG(WARNING) << fmt::format("[merge.check][region({})] wait batch merge step timeout, stop batch merge.",
+                                    merge_to_region->Id());
+  return false;
+}
+
+bool PreMergeCheckTask::CanMerge(store::RegionPtr merge_from, store::RegionMetricsPtr from_region_metrics,
+                                 store::RegionPtr merge_to, store::RegionMetricsPtr to_region_metrics, bool sequence,
+                                 std::string& reason) {
+  int64_t interval = ConfigHelper::GetSplitMergeInterval();
+  int64_t merge_check_size = ConfigHelper::GetMergeCheckSize();
+  int64_t merge_check_keys_count = ConfigHelper::GetMergeCheckKeysCount();
+
+  if (from_region_metrics == nullptr || to_region_metrics == nullptr) {
+    reason = "region metric is nullptr";
+    return false;
+  }
+  if (merge_check_workers_ == nullptr) {
+    reason = "merge check worker is nullptr";
+    return false;
+  }
+  if (!ValidRegion(merge_from, reason)) {
+    return false;
+  }
+  if (!ValidRegion(merge_to, reason)) {
+    return false;
+  }
+  if (merge_check_workers_->IsExistRegionChecking(merge_from->Id()) ||
+      merge_check_workers_->IsExistRegionChecking(merge_to->Id())) {
+    reason = "region already exist merge check";
+    return false;
+  }
+  if (from_region_metrics->RegionSize() > merge_check_size) {
+    reason = "region approximate size too big";
+    return false;
+  }
+  if (from_region_metrics->KeyCount() > merge_check_keys_count) {
+    reason = "region approximate keys count too big";
+    return false;
+  }
+  if (!CheckLeaderAndFollowerStatus(merge_from->Id())) {
+    reason = "not leader or follower abnormal";
+    return false;
+  }
+  if (merge_from->LastSplitTimestamp() != 0 &&
+      merge_from->LastSplitTimestamp() + interval * 1000 > Helper::TimestampMs()) {
+    reason = "region recently has split";
+    return false;
+  }
+  if (merge_to->LastSplitTimestamp() != 0 && merge_to->LastSplitTimestamp() + interval * 1000 > Helper::TimestampMs()) {
+    reason = "region recently has split";
+    return false;
+  }
+  // validate region part id
+  if (merge_from->Definition().part_id() != merge_to->Definition().part_id()) {
+    reason = "region partition is different";
+    return false;
+  }
+  if (sequence && merge_from->Definition().range().end_key() != merge_to->Definition().range().start_key()) {
+    reason = "region range has not continuous";
+    return false;
+  }
+  if (!sequence && merge_from->Definition().range().start_key() != merge_to->Definition().range().end_key()) {
+    reason = "region range has not continuous";
+    return false;
+  }
+  // validate region store engine
+  if (merge_from->Definition().store_engine() != merge_to->Definition().store_engine()) {
+    reason = "store_engine is different";
+    return false;
+  }
+  // validate region raw engine
+  if (merge_from->Definition().raw_engine() != merge_to->Definition().raw_engine()) {
+    reason = "raw_engine is different";
+    return false;
+  }
+  // validate region peers
+  if (Helper::IsDifferencePeers(merge_from->Definition(), merge_to->Definition())) {
+    reason = "region peers is differencce";
+    return false;
+  }
+
+  return NeedMerge(merge_from, from_region_metrics, merge_to, to_region_metrics, reason);
 }
 
 bool PreMergeCheckTask::NeedMerge(store::RegionPtr from_region, store::RegionMetricsPtr from_region_metrics,
@@ -388,122 +524,57 @@ void PreMergeCheckTask::PreMergeCheck() {
   }
 
   int64_t interval = ConfigHelper::GetSplitMergeInterval();
+  auto max_merge_size = static_cast<int64_t>(ConfigHelper::GetRegionMaxSize() * ConfigHelper::GetMergeSizeRatio());
+  auto max_merge_keys_count =
+      static_cast<int64_t>(ConfigHelper::GetSplitKeysNumber() * ConfigHelper::GetMergeKeysRatio());
   // Region of doing check.
   for (int i = 0; i < regions.size() - 2; i++) {
     auto merge_from = regions[i];
     auto merge_to = regions[i + 1];
-    int64_t merge_check_size = ConfigHelper::GetMergeCheckSize();
-    int64_t merge_check_keys_count = ConfigHelper::GetMergeCheckKeysCount();
 
     auto region_metric = metrics->GetMetrics(merge_from->Id());
     auto to_region_metric = metrics->GetMetrics(merge_to->Id());
-    bool need_scan_check = true;
     std::string reason;
-    do {
-      if (region_metric == nullptr || to_region_metric == nullptr) {
-        need_scan_check = false;
-        reason = "region metric is nullptr";
-        break;
-      }
-      if (merge_check_workers_ == nullptr) {
-        need_scan_check = false;
-        reason = "merge check worker is nullptr";
-        break;
-      }
-      need_scan_check = ValidRegion(merge_from, reason);
-      if (!need_scan_check) {
-        break;
-      }
-      need_scan_check = ValidRegion(merge_to, reason);
-      if (!need_scan_check) {
-        break;
-      }
-      if (merge_check_workers_->IsExistRegionChecking(merge_from->Id())) {
-        need_scan_check = false;
-        reason = "region already exist merge check";
-        break;
-      }
-      if (region_metric->RegionSize() > merge_check_size) {
-        need_scan_check = false;
-        reason = "region approximate size too big";
-        break;
-      }
-      if (region_metric->KeyCount() > merge_check_keys_count) {
-        need_scan_check = false;
-        reason = "region approximate keys count too big";
-        break;
-      }
-      if (!CheckLeaderAndFollowerStatus(merge_from->Id())) {
-        need_scan_check = false;
-        reason = "not leader or follower abnormal";
-        break;
-      }
-      if (merge_from->LastSplitTimestamp() != 0 &&
-          merge_from->LastSplitTimestamp() + interval * 1000 > Helper::TimestampMs()) {
-        need_scan_check = false;
-        reason = "region recently has split";
-        break;
-      }
-      if (merge_to->LastSplitTimestamp() != 0 &&
-          merge_to->LastSplitTimestamp() + interval * 1000 > Helper::TimestampMs()) {
-        need_scan_check = false;
-        reason = "region recently has split";
-        break;
-      }
-      // validate region part id
-      if (merge_from->Definition().part_id() != merge_to->Definition().part_id()) {
-        need_scan_check = false;
-        reason = "region partition is different";
-        break;
-      }
-      if (sequence && merge_from->Definition().range().end_key() != merge_to->Definition().range().start_key()) {
-        need_scan_check = false;
-        reason = "region range has not continuous";
-        break;
-      }
+    bool need_scan_check = CanMerge(merge_from, region_metric, merge_to, to_region_metric, sequence, reason);
+    DINGO_LOG(INFO) << fmt::format(
+        "[merge.check][region({})] premerge check result({}) reason({}) split_after_merge_interval({})",
+        merge_from->Id(), need_scan_check, reason, interval);
+    if (!need_scan_check) {
+      continue;
+    }
 
-      if (!sequence && merge_from->Definition().range().start_key() != merge_to->Definition().range().end_key()) {
-        need_scan_check = false;
-        reason = "region range has not continuous";
+    // Batch following adjacent co-located regions, merged region should not reach split threshold.
+    std::vector<store::RegionPtr> batch_regions = {merge_from, merge_to};
+    int64_t batch_size = region_metric->RegionSize() + to_region_metric->RegionSize();
+    int64_t batch_keys_count = region_metric->KeyCount() + to_region_metric->KeyCount();
+    while (batch_regions.size() < static_cast<size_t>(FLAGS_region_merge_batch_max_count) &&
+           i + batch_regions.size() < regions.size()) {
+      auto batch_from = batch_regions.back();
+      auto batch_to = regions[i + batch_regions.size()];
+      auto batch_from_metric = metrics->GetMetrics(batch_from->Id());
+      auto batch_to_metric = metrics->GetMetrics(batch_to->Id());
+      if (!CanMerge(batch_from, batch_from_metric, batch_to, batch_to_metric, sequence, reason)) {
         break;
       }
-      // validate region store engine
-      if (merge_from->Definition().store_engine() != merge_to->Definition().store_engine()) {
-        need_scan_check = false;
-        reason = "store_engine is different";
-        break;
-      }
-      // validate region raw engine
-      if (merge_from->Definition().raw_engine() != merge_to->Definition().raw_engine()) {
-        need_scan_check = false;
-        reason = "raw_engine is different";
-        break;
-      }
-      // validate region peers
-      if (Helper::IsDifferencePeers(merge_from->Definition(), merge_to->Definition())) {
-        need_scan_check = false;
-        reason = "region peers is differencce";
-        break;
-      }
-      if (!NeedMerge(merge_from, region_metric, merge_to, to_region_metric, reason)) {
-        need_scan_check = false;
+      if (batch_size + batch_to_metric->RegionSize() > max_merge_size ||
+          batch_keys_count + batch_to_metric->KeyCount() > max_merge_keys_count) {
         break;
       }
 
-    } while (false);
-    DINGO_LOG(INFO) << fmt::format(
-        "[merge.check][region({})] premerge check result({}) reason({}) split_after_merge_interval({})",
-        merge_from->Id(), need_scan_check, reason, interval);
-    if (!need_scan_check) {
-      continue;
+      batch_size += batch_to_metric->RegionSize();
+      batch_keys_count += batch_to_metric->KeyCount();
+      batch_regions.push_back(batch_to);
     }
-    ++i;
-    merge_check_workers_->AddRegionChecking(merge_from->Id());
-    merge_check_workers_->AddRegionChecking(merge_to->Id());
-    auto task = std::make_shared<MergeCheckTask>(merge_check_workers_, merge_from, merge_to);
+    i += batch_regions.size() - 1;
+
+    for (const auto& region : batch_regions) {
+      merge_check_workers_->AddRegionChecking(region->Id());
+    }
+    auto task = std::make_shared<MergeCheckTask>(merge_check_workers_, batch_regions);
     if (!merge_check_workers_->Execute(task)) {
-      merge_check_workers_->DeleteRegionChecking(merge_from->Id());
-      merge_check_workers_->DeleteRegionChecking(merge_to->Id());
+      for (const auto& region : batch_regions) {
+        merge_check_workers_->DeleteRegionChecking(region->Id());
+      }
     };
   }
 }
@@ -57,29 +57,35 @@ class MergeCheckWorkers {
 };
 
 // Check region whether need to merge.
+// Regions are adjacent and co-located, each one is merged into next one in order, so a batch of small
+// regions is merged by one task, every merge only change metadata because peers are same.
 class MergeCheckTask : public TaskRunnable {
  public:
   MergeCheckTask(std::shared_ptr<MergeCheckWorkers> merge_check_workers, store::RegionPtr merge_from_region,
                  store::RegionPtr merge_to_region)
-      : merge_check_workers_(merge_check_workers),
-        merge_from_region_(merge_from_region),
-        merge_to_region_(merge_to_region) {}
+      : merge_check_workers_(merge_check_workers), regions_({merge_from_region, merge_to_region}) {}
+  MergeCheckTask(std::shared_ptr<MergeCheckWorkers> merge_check_workers, std::vector<store::RegionPtr> regions)
+      : merge_check_workers_(merge_check_workers), regions_(regions) {}
   ~MergeCheckTask() override = default;
 
   std::string Type() override { return "MERGE_CHECK"; }
 
   void Run() override {
     MergeCheck();
-    merge_check_workers_->DeleteRegionChecking(merge_from_region_->Id());
-    merge_check_workers_->DeleteRegionChecking(merge_to_region_->Id());
+    for (const auto& region : regions_) {
+      merge_check_workers_->DeleteRegionChecking(region->Id());
+    }
   }
 
  private:
   void MergeCheck();
+  // check and send merge to coordinator, return true if merge is sent.
+  static bool MergeCheck(store::RegionPtr merge_from_region, store::RegionPtr merge_to_region);
+  // wait merge_to_region contain range of merge_from_region.
+  static bool WaitMergeFinish(const pb::common::Range& merge_from_range, store::RegionPtr merge_to_region);
 
   std::shared_ptr<MergeCheckWorkers> merge_check_workers_;
-  store::RegionPtr merge_from_region_;
-  store::RegionPtr merge_to_region_;
+  std::vector<store::RegionPtr> regions_;
 };
 
 // merge check, if region approximate size exceed threshold size, then check region actual size and keys count.
@@ -95,6 +101,9 @@ class PreMergeCheckTask : public TaskRunnable {
 
  private:
   void PreMergeCheck();
+  // check whether from region can merge to adjacent to region.
+  bool CanMerge(store::RegionPtr merge_from, store::RegionMetricsPtr from_region_metrics, store::RegionPtr merge_to,
+                store::RegionMetricsPtr to_region_metrics, bool sequence, std::string& reason);
   bool NeedMerge(store::RegionPtr from_region, store::RegionMetricsPtr from_region_metrics, store::RegionPtr to_region,
                  store::RegionMetricsPtr to_region_metrics, std::string& reason);
   butil::Status UpdateActualSizeAndCount(store::RegionPtr region, store::RegionMetricsPtr region_metrics,
@@ -23,6 +23,7 @@
 #include <string>
 #include <utility>
 
+#include "brpc/reloadable_flags.h"
 #include "bthread/mutex.h"
 #include "butil/compiler_specific.h"
 #include "butil/scoped_lock.h"
@@ -33,6 +34,7 @@
 #include "config/config_helper.h"
 #include "engine/gc_safe_point.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "mvcc/codec.h"
 #include "proto/common.pb.h"
 #include "proto/coordinator.pb.h"
@@ -40,6 +42,15 @@
 
 namespace dingodb {
 
+DECLARE_bool(region_enable_load_split);
+DECLARE_uint32(region_load_split_sample_key_num);
+
+DEFINE_int32(region_history_state_max_num, 16, "max num of history state kept in region meta");
+BRPC_VALIDATE_GFLAG(region_history_state_max_num, brpc::PositiveInteger);
+DEFINE_int64(region_change_record_memory_max_num, 10000,
+             "max num of region change record cached in memory, older record is only kept in meta");
+BRPC_VALIDATE_GFLAG(region_change_record_memory_max_num, brpc::PositiveInteger);
+
 namespace store {
 
 Region::Region(int64_t region_id) {
@@ -154,6 +165,21 @@ void Region::DeSerialize(const std::string& data) {
   BAIDU_SCOPED_LOCK(mutex_);
   inner_region_.ParsePartialFromArray(data.data(), data.size());
   state_.store(inner_region_.state());
+  TrimHistoryState();
+}
+
+int64_t Region::MemorySize() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return sizeof(Region) + inner_region_.SpaceUsedLong() - sizeof(inner_region_);
+}
+
+// caller hold mutex_
+void Region::TrimHistoryState() {
+  int remove_num = inner_region_.history_states_size() - FLAGS_region_history_state_max_num;
+  if (remove_num > 0) {
+    auto* history_states = inner_region_.mutable_history_states();
+    history_states->erase(history_states->begin(), history_states->begin() + remove_num);
+  }
 }
 
 pb::common::RawEngine Region::GetRawEngineType() {
@@ -247,7 +273,8 @@ pb::common::Range Region::Range(bool is_encode, bool lock) {
 std::string Region::RangeToString(bool is_encode) { return Helper::RangeToString(Range(is_encode)); }
 
 bool Region::CheckKeyInRange(const std::string& key) {
-  auto region_range = Range();
+  BAIDU_SCOPED_LOCK(mutex_);
+  const auto& region_range = inner_region_.definition().range();
   return key >= region_range.start_key() && key < region_range.end_key();
 }
 
@@ -294,6 +321,7 @@ void Region::SetState(pb::common::StoreRegionState state) {
 void Region::AppendHistoryState(pb::common::StoreRegionState state) {
   BAIDU_SCOPED_LOCK(mutex_);
   inner_region_.add_history_states(state);
+  TrimHistoryState();
 }
 
 bool Region::NeedBootstrapDoSnapshot() {
@@ -306,6 +334,14 @@ void Region::SetNeedBootstrapDoSnapshot(bool need_do_snapshot) {
   inner_region_.set_need_bootstrap_do_snapshot(need_do_snapshot);
 }
 
+void Region::SampleRequestKeys(const std::vector<std::string_view>& keys) {
+  if (!FLAGS_region_enable_load_split) {
+    return;
+  }
+
+  key_sampler_.Sample(keys, FLAGS_region_load_split_sample_key_num);
+}
+
 bool Region::IsSupportSplitAndMerge() {
   BAIDU_SCOPED_LOCK(mutex_);
 
@@ -359,6 +395,11 @@ int64_t Region::PartitionId() {
   return inner_region_.definition().part_id();
 }
 
+int64_t Region::TenantId() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return inner_region_.definition().tenant_id();
+}
+
 int64_t Region::SnapshotEpochVersion() {
   BAIDU_SCOPED_LOCK(mutex_);
   return inner_region_.snapshot_epoch_version();
@@ -415,12 +456,19 @@ void Region::UnlockKeys(const std::vector<std::string>& keys) { this->concurrenc
 bool Region::CheckKeys(const std::vector<std::string>& keys, pb::store::IsolationLevel isolation_level,
                        int64_t start_ts, const std::set<int64_t>& resolved_locks,
                        pb::store::TxnResultInfo& txn_result_info) {
+  // all lock below resolved ts is resolved.
+  if (start_ts <= ResolvedTs()) {
+    return false;
+  }
   return this->concurrency_manager_.CheckKeys(keys, isolation_level, start_ts, resolved_locks, txn_result_info);
 }
 
 bool Region::CheckRange(const std::string& start_key, const std::string& end_key,
                         pb::store::IsolationLevel isolation_level, int64_t start_ts,
                         const std::set<int64_t>& resolved_locks, pb::store::TxnResultInfo& txn_result_info) {
+  if (start_ts <= ResolvedTs()) {
+    return false;
+  }
   return this->concurrency_manager_.CheckRange(start_key, end_key, isolation_level, start_ts, resolved_locks,
                                                txn_result_info);
 }
@@ -429,6 +477,26 @@ void Region::GetMemoryLocks(std::map<std::string, pb::store::LockInfo>& lock_tab
   return this->concurrency_manager_.GetKeys(lock_table);
 }
 
+bool Region::LockPessimisticKey(const std::string& key, const pb::store::LockInfo& lock_info, int64_t max_count) {
+  return this->concurrency_manager_.LockPessimisticKey(key, lock_info, max_count);
+}
+
+bool Region::GetPessimisticLock(const std::string& key, pb::store::LockInfo& lock_info) {
+  return this->concurrency_manager_.GetPessimisticLock(key, lock_info);
+}
+
+void Region::UnlockPessimisticKeys(const std::vector<std::string>& keys) {
+  this->concurrency_manager_.UnlockPessimisticKeys(keys);
+}
+
+void Region::GetPessimisticLocks(std::vector<pb::store::LockInfo>& lock_infos) {
+  this->concurrency_manager_.GetPessimisticLocks(lock_infos);
+}
+
+void Region::ClearPessimisticLocks() { this->concurrency_manager_.ClearPessimisticLocks(); }
+
+int64_t Region::PessimisticLockCount() { return this->concurrency_manager_.PessimisticLockCount(); }
+
 RaftMeta::RaftMeta(int64_t region_id) {
   raft_meta_.set_region_id(region_id);
   raft_meta_.set_term(0);
@@ -700,6 +768,7 @@ void RegionChangeRecorder::Upsert(const pb::store_internal::RegionChangeRecord&
     if (it == records_.end()) {
       records_.insert(std::make_pair(record.job_id(), record));
       record_for_save = record;
+      EvictRecord();
     } else {
       auto* time_point = it->second.add_timeline();
       time_point->set_time(Helper::NowTime());
@@ -736,6 +805,15 @@ void RegionChangeRecorder::TransformFromKv(const std::vector<pb::common::KeyValu
 
     records_.insert_or_assign(record.job_id(), record);
   }
+  EvictRecord();
+}
+
+// caller hold mutex_
+void RegionChangeRecorder::EvictRecord() {
+  // job id is increasing, so evict the oldest job, GetChangeRecord still read it from meta.
+  while (static_cast<int64_t>(records_.size()) > FLAGS_region_change_record_memory_max_num) {
+    records_.erase(records_.begin());
+  }
 }
 
 bool StoreServerMeta::Init() {
@@ -863,9 +941,23 @@ bool StoreRegionMeta::Init() {
   if (!kvs.empty()) {
     TransformFromKv(kvs);
   }
+
+  memory_size_metrics_ = std::make_unique<bvar::PassiveStatus<int64_t>>(
+      "dingo_store_region_meta_memory_size", &StoreRegionMeta::GetMemorySize, this);
   return true;
 }
 
+int64_t StoreRegionMeta::GetMemorySize(void* arg) {
+  auto* self = static_cast<StoreRegionMeta*>(arg);
+
+  int64_t memory_size = 0;
+  for (const auto& region : self->GetAllRegion()) {
+    memory_size += region->MemorySize();
+  }
+
+  return memory_size;
+}
+
 int64_t StoreRegionMeta::GetEpoch() { return 0; }
 
 void StoreRegionMeta::AddRegion(store::RegionPtr region) {
@@ -1235,6 +1327,19 @@ std::vector<store::RaftMetaPtr> StoreRaftMeta::GetAllRaftMeta() {
   return raft_metas;
 }
 
+pb::common::KeyValue StoreRaftMeta::GenAppliedRaftMetaKv(store::RaftMetaPtr raft_meta, int64_t term,
+                                                         int64_t applied_id) {
+  auto inner_raft_meta = raft_meta->InnerRaftMeta();
+  inner_raft_meta.set_term(term);
+  inner_raft_meta.set_applied_index(applied_id);
+
+  pb::common::KeyValue kv;
+  kv.set_key(GenKey(raft_meta->RegionId()));
+  kv.set_value(inner_raft_meta.SerializeAsString());
+
+  return kv;
+}
+
 std::shared_ptr<pb::common::KeyValue> StoreRaftMeta::TransformToKv(std::any obj) {
   auto raft_meta = std::any_cast<store::RaftMetaPtr>(obj);
   std::shared_ptr<pb::common::KeyValue> kv = std::make_shared<pb::common::KeyValue>();
@@ -28,9 +28,12 @@
 #include "braft/file_system_adaptor.h"
 #include "bthread/types.h"
 #include "butil/endpoint.h"
+#include "bvar/passive_status.h"
 #include "common/constant.h"
 #include "common/helper.h"
+#include "common/key_sampler.h"
 #include "common/latch.h"
+#include "common/region_request_metrics.h"
 #include "common/safe_map.h"
 #include "document/document_index.h"
 #include "engine/concurrency_manager.h"
@@ -75,6 +78,9 @@ class Region {
   std::string Serialize();
   void DeSerialize(const std::string& data);
 
+  // approximate memory of region meta, not include vector/document index and lock table.
+  int64_t MemorySize();
+
   int64_t Id() const { return inner_region_.id(); }
   const std::string& Name() const { return inner_region_.definition().name(); }
   pb::common::RegionType Type() { return inner_region_.region_type(); }
@@ -137,6 +143,7 @@ class Region {
   void SetParentId(int64_t region_id);
 
   int64_t PartitionId();
+  int64_t TenantId();
 
   int64_t SnapshotEpochVersion();
 
@@ -172,6 +179,12 @@ class Region {
     statistics_.last_serving_time_s.store(Helper::Timestamp(), std::memory_order_relaxed);
   }
 
+  // sample request keys for load based split.
+  void SampleRequestKeys(const std::vector<std::string_view>& keys);
+  KeySampler& GetKeySampler() { return key_sampler_; }
+
+  RegionRequestMetrics& GetRequestMetrics() { return request_metrics_; }
+
   void SetRawAppliedMaxTs(int64_t ts) {
     do {
       int64_t applied_max_ts = raw_applied_max_ts_.load(std::memory_order_acquire);
@@ -198,6 +211,15 @@ class Region {
   }
   int64_t TxnAccessMaxTs() { return txn_access_max_ts_.load(std::memory_order_acquire); }
 
+  // resolved ts of txn leader region, see ResolvedTs.
+  void SetResolvedTs(int64_t ts) {
+    int64_t resolved_ts = resolved_ts_.load(std::memory_order_acquire);
+    while (ts > resolved_ts && !resolved_ts_.compare_exchange_weak(resolved_ts, ts)) {
+    }
+  }
+  int64_t ResolvedTs() { return resolved_ts_.load(std::memory_order_acquire); }
+  void ResetResolvedTs() { resolved_ts_.store(0, std::memory_order_release); }
+
   // memory_lock_manager
   void LockKey(const std::string& key, ConcurrencyManager::LockEntryPtr lock_entry);
   void UnlockKeys(const std::vector<std::string>& keys);
@@ -209,7 +231,18 @@ class Region {
 
   void GetMemoryLocks(std::map<std::string, pb::store::LockInfo>& lock_table);
 
+  // in memory pessimistic lock of leader, see ConcurrencyManager.
+  bool LockPessimisticKey(const std::string& key, const pb::store::LockInfo& lock_info, int64_t max_count);
+  bool GetPessimisticLock(const std::string& key, pb::store::LockInfo& lock_info);
+  void UnlockPessimisticKeys(const std::vector<std::string>& keys);
+  void GetPessimisticLocks(std::vector<pb::store::LockInfo>& lock_infos);
+  void ClearPessimisticLocks();
+  int64_t PessimisticLockCount();
+
  private:
+  // only keep recent history state, avoid region meta grow for long running region.
+  void TrimHistoryState();
+
   bthread_mutex_t mutex_;
   pb::store_internal::Region inner_region_;
   std::atomic<pb::common::StoreRegionState> state_;
@@ -217,6 +250,7 @@ class Region {
   std::atomic<int64_t> raw_applied_max_ts_{0};
 
   std::atomic<int64_t> txn_access_max_ts_{0};
+  std::atomic<int64_t> resolved_ts_{0};
 
   pb::raft::SplitStrategy split_strategy_{};
 
@@ -227,6 +261,8 @@ class Region {
   Latches latches_;
 
   Statistics statistics_;
+  RegionRequestMetrics request_metrics_;
+  KeySampler key_sampler_;
   ConcurrencyManager concurrency_manager_;
 };
 
@@ -284,8 +320,11 @@ class RegionChangeRecorder : public TransformKvAble {
 
   void Save(const pb::store_internal::RegionChangeRecord& record);
 
-  // key: job_id
-  std::unordered_map<int64_t, pb::store_internal::RegionChangeRecord> records_;
+  // keep at most FLAGS_region_change_record_memory_max_num records in memory.
+  void EvictRecord();
+
+  // key: job_id, only recent records, all records are in meta.
+  std::map<int64_t, pb::store_internal::RegionChangeRecord> records_;
   bthread_mutex_t mutex_;
 
   // Read meta data from persistence storage.
@@ -375,6 +414,8 @@ class StoreRegionMeta : public TransformKvAble {
   std::vector<store::RegionPtr> GetAllMetricsRegion();
 
  private:
+  static int64_t GetMemorySize(void* arg);
+
   std::shared_ptr<pb::common::KeyValue> TransformToKv(std::any obj) override;
   void TransformFromKv(const std::vector<pb::common::KeyValue>& kvs) override;
 
@@ -386,6 +427,9 @@ class StoreRegionMeta : public TransformKvAble {
   // Store all region meta data in this server.
   using RegionMap = DingoSafeMap<int64_t, store::RegionPtr>;
   RegionMap regions_;
+
+  // memory of all region meta
+  std::unique_ptr<bvar::PassiveStatus<int64_t>> memory_size_metrics_;
 };
 
 class StoreRaftMeta : public TransformKvAble {
@@ -408,6 +452,9 @@ class StoreRaftMeta : public TransformKvAble {
   store::RaftMetaPtr GetRaftMeta(int64_t region_id);
   std::vector<store::RaftMetaPtr> GetAllRaftMeta();
 
+  // Raft meta kv with the given applied term/index, written in the same write batch with applied data.
+  pb::common::KeyValue GenAppliedRaftMetaKv(store::RaftMetaPtr raft_meta, int64_t term, int64_t applied_id);
+
  private:
   std::shared_ptr<pb::common::KeyValue> TransformToKv(std::any obj) override;
   void TransformFromKv(const std::vector<pb::common::KeyValue>& kvs) override;
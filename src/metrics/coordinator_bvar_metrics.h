@@ -130,6 +130,38 @@ class CoordinatorBvarMetricsTable {
   DingoMultiDimension<bvar::Status<int64_t>> table_metrics_;
 };
 
+class CoordinatorBvarMetricsAutoIncrement {
+ public:
+  CoordinatorBvarMetricsAutoIncrement()
+      : auto_increment_metrics_("dingo_metrics_coordinator_auto_increment", {"id", "type"}) {
+    auto_increment_metrics_.expose("dingo_metrics_coordinator_auto_increment");
+  }
+  ~CoordinatorBvarMetricsAutoIncrement() = default;
+
+  CoordinatorBvarMetricsAutoIncrement(const CoordinatorBvarMetricsAutoIncrement &) = delete;
+  void operator=(const CoordinatorBvarMetricsAutoIncrement &) = delete;
+
+  void UpdateAutoIncrementBvar(int64_t table_id, int64_t grant_count, int64_t grant_size, int64_t rate) {
+    auto *stats = auto_increment_metrics_.get_stats({std::to_string(table_id), "grant_count"});
+    if (stats) {
+      stats->set_value(grant_count);
+    }
+    auto *stats2 = auto_increment_metrics_.get_stats({std::to_string(table_id), "grant_size"});
+    if (stats2) {
+      stats2->set_value(grant_size);
+    }
+    auto *stats3 = auto_increment_metrics_.get_stats({std::to_string(table_id), "rate"});
+    if (stats3) {
+      stats3->set_value(rate);
+    }
+  }
+
+  void Clear() { auto_increment_metrics_.delete_stats(); }
+
+ private:
+  DingoMultiDimension<bvar::Status<int64_t>> auto_increment_metrics_;
+};
+
 class CoordinatorBvarMetricsIndex {
  public:
   CoordinatorBvarMetricsIndex() : index_metrics_("dingo_metrics_coordinator_index", {"id", "type"}) {
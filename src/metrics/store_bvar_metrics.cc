@@ -12,11 +12,117 @@
 
 #include "metrics/store_bvar_metrics.h"
 
+#include "metrics/store_bvar_metrics.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "brpc/reloadable_flags.h"
+#include "butil/fast_rand.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
 namespace dingodb {
 
+DEFINE_int32(region_stage_latency_sample_rate, 16,
+             "sample one request of every n requests to record region stage latency, 0 means disable");
+BRPC_VALIDATE_GFLAG(region_stage_latency_sample_rate, brpc::NonNegativeInteger);
+DEFINE_int32(slow_region_top_n, 10, "show top n slow region of every stage");
+BRPC_VALIDATE_GFLAG(slow_region_top_n, brpc::PositiveInteger);
+
+const std::vector<std::string> StoreBvarMetrics::kTrackerStages = {
+    "service_queue", "prepair_commit", "raft_commit", "raft_queue_wait", "raft_apply", "store_write", "read_store"};
+
+const std::vector<std::string> StoreBvarMetrics::kResourceNames = {"cpu_time_us", "read_bytes", "write_bytes",
+                                                                   "seek_count", "scan_key_count"};
+
 StoreBvarMetrics& StoreBvarMetrics::GetInstance() {
   static StoreBvarMetrics store_bvar_metrics;
   return store_bvar_metrics;
 }
 
-}  // namespace dingodb
\ No newline at end of file
+void StoreBvarMetrics::UpdateRegionStageLatency(std::string region_id, const Tracker& tracker) {
+  if (FLAGS_region_stage_latency_sample_rate <= 0 ||
+      butil::fast_rand_less_than(FLAGS_region_stage_latency_sample_rate) != 0) {
+    return;
+  }
+
+  // Same order with kTrackerStages.
+  uint64_t stage_times_ns[] = {tracker.ServiceQueueWaitTime(), tracker.PrepairCommitTime(), tracker.RaftCommitTime(),
+                               tracker.RaftQueueWaitTime(),    tracker.RaftApplyTime(),      tracker.StoreWriteTime(),
+                               tracker.ReadStoreTime()};
+  for (size_t i = 0; i < kTrackerStages.size(); ++i) {
+    // Skip stage which request not pass through, e.g. read request has no raft stage.
+    if (stage_times_ns[i] == 0) {
+      continue;
+    }
+    auto* stage_stat = region_stage_latency_.get_stats({region_id, kTrackerStages[i]});
+    if (stage_stat != nullptr) {
+      *stage_stat << stage_times_ns[i] / 1000;
+    }
+  }
+}
+
+void StoreBvarMetrics::UpdateRegionResourceUsage(std::string region_id, const RegionResourceUsage& usage) {
+  // Same order with kResourceNames.
+  int64_t values[] = {usage.cpu_time_us, usage.read_bytes, usage.write_bytes, usage.seek_count, usage.scan_key_count};
+  for (size_t i = 0; i < kResourceNames.size(); ++i) {
+    auto* resource_stat = region_resource_usage_.get_stats({region_id, kResourceNames[i]});
+    if (resource_stat != nullptr) {
+      resource_stat->set_value(values[i]);
+    }
+  }
+}
+
+std::vector<StoreBvarMetrics::SlowRegion> StoreBvarMetrics::GetSlowRegionTop(const std::string& stage,
+                                                                             uint32_t top_n) {
+  std::vector<std::list<std::string>> labels_list;
+  region_stage_latency_.list_stats(&labels_list);
+
+  std::vector<SlowRegion> slow_regions;
+  for (const auto& labels : labels_list) {
+    if (labels.size() != 2 || labels.back() != stage) {
+      continue;
+    }
+    auto* stage_stat = region_stage_latency_.get_stats(labels);
+    if (stage_stat == nullptr || stage_stat->qps() == 0) {
+      continue;
+    }
+    slow_regions.push_back({labels.front(), stage_stat->latency(), stage_stat->latency_percentile(0.99),
+                            stage_stat->qps()});
+  }
+
+  std::sort(slow_regions.begin(), slow_regions.end(),
+            [](const SlowRegion& lhs, const SlowRegion& rhs) { return lhs.latency_p99_us > rhs.latency_p99_us; });
+  if (slow_regions.size() > top_n) {
+    slow_regions.resize(top_n);
+  }
+
+  return slow_regions;
+}
+
+std::string StoreBvarMetrics::DumpSlowRegionTop(void* arg) {
+  auto* self = static_cast<StoreBvarMetrics*>(arg);
+
+  std::string result;
+  for (const auto& stage : kTrackerStages) {
+    auto slow_regions = self->GetSlowRegionTop(stage, FLAGS_slow_region_top_n);
+    if (slow_regions.empty()) {
+      continue;
+    }
+
+    result += fmt::format("{}:", stage);
+    for (const auto& slow_region : slow_regions) {
+      result += fmt::format(" region({}) latency({}us) p99({}us) qps({});", slow_region.region_id,
+                            slow_region.latency_us, slow_region.latency_p99_us, slow_region.qps);
+    }
+    result += "\n";
+  }
+
+  return result;
+}
+
+}  // namespace dingodb
@@ -15,13 +15,17 @@
 #ifndef DINGODB_STORE_BVAR_METRICS_H_
 #define DINGODB_STORE_BVAR_METRICS_H_
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "bvar/bvar.h"
 #include "bvar/multi_dimension.h"
 #include "bvar/reducer.h"
 #include "bvar/status.h"
 #include "common/helper.h"
+#include "common/region_resource.h"
+#include "common/tracker.h"
 
 namespace dingodb {
 
@@ -31,7 +35,12 @@ class StoreBvarMetrics {
       : leader_switch_time_("dingo_metrics_store_raft_leader_switch_time", {"region"}),
         leader_switch_count_("dingo_metrics_store_raft_leader_switch_count", {"region"}),
         commit_count_per_second_("dingo_metrics_store_raft_commit_count_per_second", {"region"}),
-        apply_count_per_second_("dingo_metrics_store_raft_apply_count_per_second", {"region"}) {}
+        apply_count_per_second_("dingo_metrics_store_raft_apply_count_per_second", {"region"}),
+        delete_range_tombstone_count_("dingo_metrics_store_region_delete_range_tombstone_count", {"region"}),
+        expired_ttl_bytes_("dingo_metrics_store_region_expired_ttl_bytes", {"region"}),
+        region_stage_latency_("dingo_metrics_store_region_stage_latency", {"region", "stage"}),
+        region_resource_usage_("dingo_metrics_store_region_resource_usage", {"region", "resource"}),
+        slow_region_top_("dingo_metrics_store_slow_region_top", DumpSlowRegionTop, this) {}
   ~StoreBvarMetrics() = default;
 
   StoreBvarMetrics(const StoreBvarMetrics&) = delete;
@@ -67,6 +76,36 @@ class StoreBvarMetrics {
     }
   }
 
+  void UpdateDeleteRangeTombstoneCount(std::string region_id, int64_t value) {
+    auto* region_stat = delete_range_tombstone_count_.get_stats({region_id});
+    if (region_stat != nullptr) {
+      region_stat->set_value(value);
+    }
+  }
+
+  // Bytes of expired ttl versions reclaimed by compaction.
+  void IncExpiredTtlBytes(std::string region_id, int64_t bytes) {
+    auto* region_stat = expired_ttl_bytes_.get_stats({region_id});
+    if (region_stat != nullptr) {
+      *region_stat << bytes;
+    }
+  }
+
+  // Accumulated cpu time and io of region, label resource is one of kResourceNames.
+  void UpdateRegionResourceUsage(std::string region_id, const RegionResourceUsage& usage);
+
+  // Sampled record every stage latency of request by region.
+  void UpdateRegionStageLatency(std::string region_id, const Tracker& tracker);
+
+  // Top n slow regions of the stage, sort by latency p99.
+  struct SlowRegion {
+    std::string region_id;
+    int64_t latency_us;
+    int64_t latency_p99_us;
+    int64_t qps;
+  };
+  std::vector<SlowRegion> GetSlowRegionTop(const std::string& stage, uint32_t top_n);
+
   void DeleteMetrics(std::string region_id) {
     if (leader_switch_time_.has_stats({region_id})) {
       leader_switch_time_.delete_stats({region_id});
@@ -80,13 +119,39 @@ class StoreBvarMetrics {
     if (apply_count_per_second_.has_stats({region_id})) {
       apply_count_per_second_.delete_stats({region_id});
     }
+    if (delete_range_tombstone_count_.has_stats({region_id})) {
+      delete_range_tombstone_count_.delete_stats({region_id});
+    }
+    if (expired_ttl_bytes_.has_stats({region_id})) {
+      expired_ttl_bytes_.delete_stats({region_id});
+    }
+    for (const auto& stage : kTrackerStages) {
+      if (region_stage_latency_.has_stats({region_id, stage})) {
+        region_stage_latency_.delete_stats({region_id, stage});
+      }
+    }
+    for (const auto& resource : kResourceNames) {
+      if (region_resource_usage_.has_stats({region_id, resource})) {
+        region_resource_usage_.delete_stats({region_id, resource});
+      }
+    }
   }
 
+  static const std::vector<std::string> kTrackerStages;
+  static const std::vector<std::string> kResourceNames;
+
  private:
   bvar::MultiDimension<bvar::Status<int64_t>> leader_switch_time_;
   bvar::MultiDimension<bvar::Status<int64_t>> leader_switch_count_;
   bvar::MultiDimension<bvar::PerSecondEx<bvar::Adder<int64_t>>> commit_count_per_second_;
   bvar::MultiDimension<bvar::PerSecondEx<bvar::Adder<int64_t>>> apply_count_per_second_;
+  bvar::MultiDimension<bvar::Status<int64_t>> delete_range_tombstone_count_;
+  bvar::MultiDimension<bvar::Adder<int64_t>> expired_ttl_bytes_;
+  bvar::MultiDimension<bvar::LatencyRecorder> region_stage_latency_;
+  bvar::MultiDimension<bvar::Status<int64_t>> region_resource_usage_;
+
+  static std::string DumpSlowRegionTop(void* arg);
+  bvar::PassiveStatus<std::string> slow_region_top_;
 };
 
 }  // namespace dingodb
@@ -14,20 +14,28 @@
 
 #include "metrics/store_metrics_manager.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "bthread/bthread.h"
+#include "bvar/passive_status.h"
 #include "butil/scoped_lock.h"
 #include "common/constant.h"
+#include "common/gflag_validator.h"
 #include "common/helper.h"
+#include "common/latency_sketch.h"
 #include "common/logging.h"
+#include "common/memory_tracker.h"
 #include "config/config_manager.h"
+#include "crontab/timer_wheel.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
+#include "metrics/store_bvar_metrics.h"
 #include "mvcc/codec.h"
 #include "mvcc/reader.h"
 #include "proto/common.pb.h"
@@ -35,11 +43,77 @@
 
 namespace dingodb {
 
+DECLARE_int32(crontab_region_spread_num);
+
 DEFINE_double(min_system_disk_capacity_free_ratio, 0.05, "Min system disk capacity free ratio");
 DEFINE_double(min_system_memory_capacity_free_ratio, 0.10, "Min system memory capacity free ratio");
 DEFINE_bool(enable_region_metrics_collect_key_count, true, "Enable region metrics collect key count");
 DEFINE_bool(enable_region_metrics_collect_key_max, false, "Enable region metrics collect key max");
 DEFINE_bool(enable_region_metrics_collect_key_min, false, "Enable region metrics collect key min");
+DEFINE_bool(enable_region_metrics_incremental_key_count, true,
+            "Estimate region key count from apply stream, full count only after split/merge/delete range");
+DEFINE_validator(enable_region_metrics_incremental_key_count, &PassBool);
+
+DEFINE_int32(region_request_top_n, 10, "show top n region of request latency p99 and count");
+BRPC_VALIDATE_GFLAG(region_request_top_n, brpc::PositiveInteger);
+
+// Aggregate request metrics block of all regions on demand, sorted by p99 latency.
+static std::string DumpRegionRequestTop(void*) {
+  auto store_meta_manager = Server::GetInstance().GetStoreMetaManager();
+  if (store_meta_manager == nullptr) {
+    return "";
+  }
+
+  struct RegionRequest {
+    int64_t region_id;
+    int64_t count;
+    int64_t p99_us;
+    int64_t p999_us;
+  };
+  std::vector<RegionRequest> reads;
+  std::vector<RegionRequest> writes;
+  int64_t error_count = 0;
+  LatencySketch store_read_latency;
+  LatencySketch store_write_latency;
+  for (const auto& region : store_meta_manager->GetStoreRegionMeta()->GetAllRegion()) {
+    auto& request_metrics = region->GetRequestMetrics();
+    error_count += request_metrics.ErrorCount();
+    if (request_metrics.ReadCount() > 0) {
+      const auto& latency = request_metrics.ReadLatency();
+      reads.push_back({region->Id(), request_metrics.ReadCount(), latency.Quantile(0.99), latency.Quantile(0.999)});
+      store_read_latency.Merge(latency);
+    }
+    if (request_metrics.WriteCount() > 0) {
+      const auto& latency = request_metrics.WriteLatency();
+      writes.push_back({region->Id(), request_metrics.WriteCount(), latency.Quantile(0.99), latency.Quantile(0.999)});
+      store_write_latency.Merge(latency);
+    }
+  }
+
+  auto format_top = [](const std::string& name, std::vector<RegionRequest>& requests) {
+    std::sort(requests.begin(), requests.end(),
+              [](const RegionRequest& lhs, const RegionRequest& rhs) { return lhs.p99_us > rhs.p99_us; });
+    if (requests.size() > static_cast<size_t>(FLAGS_region_request_top_n)) {
+      requests.resize(FLAGS_region_request_top_n);
+    }
+
+    std::string result = fmt::format("{}:", name);
+    for (const auto& request : requests) {
+      result += fmt::format(" region({}) count({}) p99({}us) p999({}us);", request.region_id, request.count,
+                            request.p99_us, request.p999_us);
+    }
+    return result + "\n";
+  };
+
+  std::string result = fmt::format("store: read p99({}us) write p99({}us) error count({})\n",
+                                   store_read_latency.Quantile(0.99), store_write_latency.Quantile(0.99), error_count);
+  result += format_top("read", reads);
+  result += format_top("write", writes);
+  return result;
+}
+
+static bvar::PassiveStatus<std::string> g_region_request_top("dingo_metrics_store_region_request_top",
+                                                             DumpRegionRequestTop, nullptr);
 
 namespace store {
 
@@ -54,6 +128,39 @@ RegionMetrics::~RegionMetrics() {
   bthread_mutex_destroy(&mutex_);
 }
 
+void RegionMetrics::IncDeleteRangeTombstoneCount(int64_t count) {
+  int64_t tombstone_count = 0;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    delete_range_tombstone_count_ += count;
+    tombstone_count = delete_range_tombstone_count_;
+  }
+
+  StoreBvarMetrics::GetInstance().UpdateDeleteRangeTombstoneCount(std::to_string(Id()), tombstone_count);
+}
+
+void RegionMetrics::DecDeleteRangeTombstoneCount(int64_t count) {
+  int64_t tombstone_count = 0;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    delete_range_tombstone_count_ = std::max(delete_range_tombstone_count_ - count, static_cast<int64_t>(0));
+    tombstone_count = delete_range_tombstone_count_;
+  }
+
+  StoreBvarMetrics::GetInstance().UpdateDeleteRangeTombstoneCount(std::to_string(Id()), tombstone_count);
+}
+
+void RegionMetrics::AddResourceUsage(const RegionResourceUsage& usage) {
+  RegionResourceUsage total_usage;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    resource_usage_.Add(usage);
+    total_usage = resource_usage_;
+  }
+
+  StoreBvarMetrics::GetInstance().UpdateRegionResourceUsage(std::to_string(Id()), total_usage);
+}
+
 std::string RegionMetrics::Serialize() {
   BAIDU_SCOPED_LOCK(mutex_);
   return inner_region_metrics_.SerializeAsString();
@@ -72,6 +179,12 @@ void RegionMetrics::UpdateMaxAndMinKey(const PbKeyValues& kvs) {
     mvcc::Codec::DecodeKey(kv.key(), plain_key);
     auto value_flag = mvcc::Codec::GetValueFlag(kv.value());
 
+    if (value_flag == mvcc::ValueFlag::kDelete) {
+      delete_key_hll_.Add(plain_key);
+    } else {
+      put_key_hll_.Add(plain_key);
+    }
+
     if (value_flag == mvcc::ValueFlag::kPut) {
       if (inner_region_metrics_.min_key().empty() || plain_key < inner_region_metrics_.min_key()) {
         inner_region_metrics_.set_min_key(plain_key);
@@ -93,6 +206,7 @@ void RegionMetrics::UpdateMaxAndMinKeyPolicy(const PbKeys& keys) {
   BAIDU_SCOPED_LOCK(mutex_);
 
   for (const auto& key : keys) {
+    delete_key_hll_.Add(key);
     if (key == inner_region_metrics_.min_key()) {
       need_update_min_key_ = true;
     } else if (key == inner_region_metrics_.max_key()) {
@@ -104,6 +218,9 @@ void RegionMetrics::UpdateMaxAndMinKeyPolicy(const PbKeys& keys) {
 void RegionMetrics::UpdateMaxAndMinKeyPolicy(const PbRanges& ranges) {
   BAIDU_SCOPED_LOCK(mutex_);
 
+  // deleted key count of range is unknown, full count again.
+  need_update_key_count_ = true;
+
   for (const auto& range : ranges) {
     auto plain_range = mvcc::Codec::DecodeRange(range);
     if (plain_range.start_key() <= inner_region_metrics_.min_key() &&
@@ -117,6 +234,17 @@ void RegionMetrics::UpdateMaxAndMinKeyPolicy(const PbRanges& ranges) {
   }
 }
 
+int64_t RegionMetrics::UpdateKeyCountByEstimate() {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  // overwrite of existing key is counted as new key, delete of not existing key is counted too,
+  // so it is approximate until next full count.
+  int64_t key_count = base_key_count_ + put_key_hll_.Estimate() - delete_key_hll_.Estimate();
+  key_count = std::max(key_count, static_cast<int64_t>(0));
+  inner_region_metrics_.set_row_count(key_count);
+  return key_count;
+}
+
 void RegionMetrics::UpdateMaxAndMinKeyPolicy() {
   BAIDU_SCOPED_LOCK(mutex_);
   need_update_min_key_ = true;
@@ -127,6 +255,27 @@ void RegionMetrics::UpdateMaxAndMinKeyPolicy() {
 
 bool StoreMetrics::Init() { return CollectMetrics(); }
 
+// sample subsystem not charged by itself, evict cache when store memory is over soft limit.
+static void CollectMemoryTracker(int64_t system_total_memory, int64_t process_used_memory) {
+  auto raw_engine = Server::GetInstance().GetRawEngine(pb::common::RawEngine::RAW_ENG_ROCKSDB);
+  if (raw_engine != nullptr) {
+    MemoryTracker::Subsystem(MemoryTracker::kRocksBlockCache)->SetConsumption(raw_engine->GetBlockCacheUsage());
+    MemoryTracker::Subsystem(MemoryTracker::kRocksMemtable)->SetConsumption(raw_engine->GetMemtableUsage());
+  }
+  MemoryTracker::UpdateRoot(system_total_memory, process_used_memory);
+
+  auto root = MemoryTracker::Root();
+  if (root->IsOverSoftLimit()) {
+    int64_t evict_bytes = root->Consumption() - root->SoftLimit();
+    int64_t freed_bytes = root->Evict(evict_bytes);
+
+    std::vector<std::string> lines;
+    root->Dump(2, lines);
+    DINGO_LOG(WARNING) << fmt::format("[metrics.store] memory is over soft limit, evict({}) freed({}), {}",
+                                      evict_bytes, freed_bytes, Helper::VectorToString(lines));
+  }
+}
+
 bool StoreMetrics::CollectMetrics() {
   std::map<std::string, int64_t> output;
 
@@ -152,6 +301,8 @@ bool StoreMetrics::CollectMetrics() {
     return false;
   }
 
+  CollectMemoryTracker(output["system_total_memory"], output["process_used_memory"]);
+
   {
     BAIDU_SCOPED_LOCK(mutex_);
     // system disk capacity
@@ -208,6 +359,17 @@ bool StoreMetrics::CollectMetrics() {
       }
     }
 
+    // reject write instead of OOM, until cache is evicted and memory is freed.
+    auto memory_tracker = MemoryTracker::Root();
+    if (!self_store_is_read_only && memory_tracker->IsOverHardLimit()) {
+      std::string s = fmt::format("Memory is over hard limit, consumption({}) hard_limit({})",
+                                  Helper::HumanReadableBytes(uint64_t(memory_tracker->Consumption())),
+                                  Helper::HumanReadableBytes(uint64_t(memory_tracker->HardLimit())));
+      DINGO_LOG(WARNING) << s;
+      self_store_is_read_only = true;
+      read_only_reason = s;
+    }
+
     metrics_.mutable_store_own_metrics()->set_is_ready_only(self_store_is_read_only);
     metrics_.mutable_store_own_metrics()->set_read_only_reason(read_only_reason);
   }
@@ -507,12 +669,33 @@ bool StoreRegionMetrics::CollectApproximateSizeMetrics() {
   return true;
 }
 
+void StoreRegionMetrics::CollectResourceMetrics() {
+  auto usages = RegionResourceAccounting::TakeAll();
+  for (const auto& [region_id, usage] : usages) {
+    auto region_metrics = GetMetrics(region_id);
+    if (region_metrics != nullptr) {
+      region_metrics->AddResourceUsage(usage);
+    }
+  }
+}
+
 bool StoreRegionMetrics::CollectMetrics() {
   auto store_region_meta = GET_STORE_REGION_META;
   auto store_raft_meta = Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta();
+
+  // resource usage is accounted even if region has no write.
+  CollectResourceMetrics();
+
   auto region_metricses = GetAllMetrics();
 
+  // crontab run crontab_region_spread_num times per collect interval, every round collect part of regions.
+  static RoundSpreader spreader(FLAGS_crontab_region_spread_num);
+  spreader.NextRound();
+
   for (const auto& region_metrics : region_metricses) {
+    if (!spreader.IsTurn(region_metrics->Id())) {
+      continue;
+    }
     auto raft_meta = store_raft_meta->GetRaftMeta(region_metrics->Id());
     if (raft_meta == nullptr) {
       DINGO_LOG(DEBUG) << fmt::format("[metrics.region][region({})] not found raft meta.", region_metrics->Id());
@@ -557,10 +740,11 @@ bool StoreRegionMetrics::CollectMetrics() {
 
     // Get region key counts
     if (FLAGS_enable_region_metrics_collect_key_count) {
-      if (region_metrics->NeedUpdateKeyCount()) {
+      if (!FLAGS_enable_region_metrics_incremental_key_count || region_metrics->NeedUpdateKeyCount()) {
+        region_metrics->SetNeedUpdateKeyCount(false);
         region_metrics->SetKeyCount(GetRegionKeyCount(region));
       } else {
-        region_metrics->SetNeedUpdateKeyCount(true);
+        region_metrics->UpdateKeyCountByEstimate();
       }
     }
 
@@ -594,6 +778,9 @@ bool StoreRegionMetrics::CollectMetrics() {
         int64_t total_memory_usage = 0;
         vector_index_wrapper->GetMemorySize(total_memory_usage);
         region_metrics->SetVectorMemoryBytes(total_memory_usage);
+        MemoryTracker::Subsystem(MemoryTracker::kVectorIndex)
+            ->GetOrNewChild(std::to_string(region->Id()))
+            ->SetConsumption(total_memory_usage);
 
         vector_index_has_data = true;
       }
@@ -644,6 +831,7 @@ void StoreRegionMetrics::DeleteMetrics(int64_t region_id) {
     BAIDU_SCOPED_LOCK(mutex_);
     metricses_.erase(region_id);
   }
+  MemoryTracker::Subsystem(MemoryTracker::kVectorIndex)->RemoveChild(std::to_string(region_id));
 
   meta_writer_->Delete(GenKey(region_id));
 }
@@ -26,6 +26,8 @@
 #include "bthread/types.h"
 #include "butil/scoped_lock.h"
 #include "common/constant.h"
+#include "common/hyper_log_log.h"
+#include "common/region_resource.h"
 #include "engine/engine.h"
 #include "meta/meta_reader.h"
 #include "meta/meta_writer.h"
@@ -60,6 +62,7 @@ class RegionMetrics {
     // UpdateMaxAndMinKeyPolicy
     need_update_min_key_ = true;
     need_update_max_key_ = true;
+    need_update_key_count_ = true;
   }
 
   int64_t LastLogIndex() {
@@ -197,11 +200,18 @@ class RegionMetrics {
     return inner_region_metrics_.row_count();
   }
 
+  // key_count is a full count, it is the base of following incremental estimate.
   void SetKeyCount(int64_t key_count) {
     BAIDU_SCOPED_LOCK(mutex_);
     inner_region_metrics_.set_row_count(key_count);
+    base_key_count_ = key_count;
+    put_key_hll_.Clear();
+    delete_key_hll_.Clear();
   }
 
+  // estimate key count from base and distinct put/delete keys applied since base, and set it to row_count.
+  int64_t UpdateKeyCountByEstimate();
+
   // vector index start
   pb::common::VectorIndexType GetVectorIndexType() {
     BAIDU_SCOPED_LOCK(mutex_);
@@ -265,6 +275,23 @@ class RegionMetrics {
 
   // vector index end
 
+  // Delete range tombstones since last range compaction, not persisted.
+  int64_t DeleteRangeTombstoneCount() {
+    BAIDU_SCOPED_LOCK(mutex_);
+    return delete_range_tombstone_count_;
+  }
+
+  void IncDeleteRangeTombstoneCount(int64_t count);
+  void DecDeleteRangeTombstoneCount(int64_t count);
+
+  // Accumulated cpu and io usage since region metrics is created, not persisted.
+  RegionResourceUsage ResourceUsage() {
+    BAIDU_SCOPED_LOCK(mutex_);
+    return resource_usage_;
+  }
+
+  void AddResourceUsage(const RegionResourceUsage& usage);
+
   const pb::common::RegionMetrics& InnerRegionMetrics() {
     BAIDU_SCOPED_LOCK(mutex_);
     return inner_region_metrics_;
@@ -290,6 +317,15 @@ class RegionMetrics {
   bool need_update_max_key_{true};
   // need update region key count
   bool need_update_key_count_{true};
+  // delete range tombstone count, reset by range compaction
+  int64_t delete_range_tombstone_count_{0};
+  // accumulated cpu and io usage
+  RegionResourceUsage resource_usage_;
+  // key count of last full count
+  int64_t base_key_count_{0};
+  // distinct put and delete keys applied since last full count
+  HyperLogLog put_key_hll_;
+  HyperLogLog delete_key_hll_;
 
   pb::common::RegionMetrics inner_region_metrics_;
   // protect inner_region_metrics_
@@ -339,6 +375,8 @@ class StoreRegionMetrics : public TransformKvAble {
   bool CollectApproximateSizeMetrics();
   // Collect other metrics, e.g. min_key/max_key/key_count.
   bool CollectMetrics();
+  // Flush cpu and io usage accounted by RegionResourceAccounting to region metrics.
+  void CollectResourceMetrics();
 
   static store::RegionMetricsPtr NewMetrics(int64_t region_id);
 
@@ -51,26 +51,35 @@ void Codec::EncodeBytes(const std::string& plain_key, std::string& output) {
 }
 
 void Codec::EncodeBytes(const std::string_view& plain_key, std::string& output) {
-  uint32_t new_size = (plain_key.length() / kGroupSize + 1) * kPadGroupSize;
-  output.resize(new_size);
+  output.resize(EncodeBytesLength(plain_key.length()));
+  EncodeBytes(plain_key, output.data());
+}
 
-  int index = 0;
+size_t Codec::EncodeBytes(const std::string_view& plain_key, char* buf) {
   const auto* data = plain_key.data();
-  char* buf = output.data();
-  for (int i = 0; i < plain_key.length(); ++i) {
-    if ((i + 1) % kGroupSize != 0) {
-      buf[index++] = data[i];
-    } else {
-      buf[index++] = data[i];
-      buf[index++] = '\xff';
-    }
+  size_t group_num = plain_key.length() / kGroupSize;
+
+  // full group: 8 bytes data|0xff
+  size_t index = 0;
+  for (size_t i = 0; i < group_num; ++i) {
+    memcpy(buf + index, data + i * kGroupSize, kGroupSize);
+    index += kGroupSize;
+    buf[index++] = '\xff';
   }
 
-  int padding_num = kGroupSize - (plain_key.length() % kGroupSize);
-  for (int i = 0; i < padding_num; ++i) {
-    buf[index++] = '\x00';
+  // last group: remain data|padding 0x00|0xff - padding_num
+  size_t remain = plain_key.length() - group_num * kGroupSize;
+  if (remain > 0) {
+    memcpy(buf + index, data + group_num * kGroupSize, remain);
+    index += remain;
   }
-  buf[index] = '\xff' - padding_num;
+
+  int padding_num = kGroupSize - remain;
+  memset(buf + index, 0, padding_num);
+  index += padding_num;
+  buf[index++] = '\xff' - padding_num;
+
+  return index;
 }
 
 bool Codec::DecodeBytes(const std::string& encode_key, std::string& output) {
@@ -78,26 +87,38 @@ bool Codec::DecodeBytes(const std::string& encode_key, std::string& output) {
 }
 
 bool Codec::DecodeBytes(const std::string_view& encode_key, std::string& output) {
-  if (encode_key.length() % kPadGroupSize != 0 || encode_key.back() == '\xff') {
+  output.resize(DecodeBytesMaxLength(encode_key.length()));
+
+  size_t length = 0;
+  if (!DecodeBytes(encode_key, output.data(), length)) {
+    output.clear();
     return false;
   }
 
-  uint32_t new_size = (encode_key.length() / kPadGroupSize) * kGroupSize;
-  output.clear();
-  output.reserve(new_size);
+  output.resize(length);
+  return true;
+}
 
-  const auto* data = encode_key.data();
-  for (int i = 0; i < encode_key.size(); i++) {
-    uint8_t marker = encode_key.at(i + 8);
+bool Codec::DecodeBytes(const std::string_view& encode_key, char* buf, size_t& length) {
+  length = 0;
+  if (encode_key.empty() || encode_key.length() % kPadGroupSize != 0 || encode_key.back() == '\xff') {
+    return false;
+  }
 
-    int pad_count = kMarker - marker;
-    for (int j = 0; j < kGroupSize - pad_count; ++j) {
-      output.push_back(encode_key.at(i++));
+  const auto* data = encode_key.data();
+  for (size_t i = 0; i < encode_key.length(); i += kPadGroupSize) {
+    int pad_count = kMarker - static_cast<uint8_t>(data[i + kGroupSize]);
+    if (pad_count > kGroupSize) {
+      return false;
     }
 
+    int data_count = kGroupSize - pad_count;
+    memcpy(buf + length, data + i, data_count);
+    length += data_count;
+
     if (pad_count != 0) {
-      for (int j = 0; j < pad_count; ++j) {
-        if (encode_key.at(i++) != 0) {
+      for (int j = data_count; j < kGroupSize; ++j) {
+        if (data[i + j] != 0) {
           return false;
         }
       }
@@ -111,24 +132,30 @@ bool Codec::DecodeBytes(const std::string_view& encode_key, std::string& output)
 
 std::string Codec::EncodeKey(const std::string& key, int64_t ts) {
   std::string encode_key;
-  encode_key.reserve(key.size() + 256);
-
-  EncodeBytes(key, encode_key);
-  SerialHelper::WriteLongWithNegation(ts, encode_key);
+  EncodeKey(std::string_view(key), ts, encode_key);
 
   return std::move(encode_key);
 }
 
 std::string Codec::EncodeKey(const std::string_view& key, int64_t ts) {
   std::string encode_key;
-  encode_key.reserve(key.size() + 256);
-
-  EncodeBytes(key, encode_key);
-  SerialHelper::WriteLongWithNegation(ts, encode_key);
+  EncodeKey(key, ts, encode_key);
 
   return std::move(encode_key);
 }
 
+void Codec::EncodeKey(const std::string_view& plain_key, int64_t ts, std::string& output) {
+  output.resize(EncodeKeyLength(plain_key.length()));
+  EncodeKey(plain_key, ts, output.data());
+}
+
+size_t Codec::EncodeKey(const std::string_view& plain_key, int64_t ts, char* buf) {
+  size_t length = EncodeBytes(plain_key, buf);
+  SerialHelper::WriteLongWithNegation(ts, buf + length);
+
+  return length + kTsLength;
+}
+
 bool Codec::DecodeKey(const std::string& encode_key_with_ts, std::string& plain_key, int64_t& ts) {
   return DecodeKey(std::string_view(encode_key_with_ts), plain_key, ts);
 }
@@ -40,13 +40,28 @@ class Codec {
   static std::string EncodeBytes(const std::string& plain_key);
   static void EncodeBytes(const std::string& plain_key, std::string& output);
   static void EncodeBytes(const std::string_view& plain_key, std::string& output);
+  // encode into caller-provided buffer without allocate memory, return encode length
+  // buf size must not less than EncodeBytesLength(plain_key.length())
+  static size_t EncodeBytes(const std::string_view& plain_key, char* buf);
   // decode encode key to user key
   static bool DecodeBytes(const std::string& encode_key, std::string& output);
   static bool DecodeBytes(const std::string_view& encode_key, std::string& output);
+  // decode into caller-provided buffer without allocate memory, length is user key length
+  // buf size must not less than DecodeBytesMaxLength(encode_key.length())
+  static bool DecodeBytes(const std::string_view& encode_key, char* buf, size_t& length);
+
+  static constexpr size_t EncodeBytesLength(size_t plain_key_length) { return (plain_key_length / 8 + 1) * 9; }
+  static constexpr size_t EncodeKeyLength(size_t plain_key_length) { return EncodeBytesLength(plain_key_length) + 8; }
+  static constexpr size_t DecodeBytesMaxLength(size_t encode_key_length) { return encode_key_length / 9 * 8; }
 
   // encode user key and ts
   static std::string EncodeKey(const std::string& plain_key, int64_t ts);
   static std::string EncodeKey(const std::string_view& plain_key, int64_t ts);
+  // encode into output, reuse the memory of output
+  static void EncodeKey(const std::string_view& plain_key, int64_t ts, std::string& output);
+  // encode into caller-provided buffer without allocate memory, return encode length
+  // buf size must not less than EncodeKeyLength(plain_key.length())
+  static size_t EncodeKey(const std::string_view& plain_key, int64_t ts, char* buf);
   // decode encode key to user key and ts
   static bool DecodeKey(const std::string& encode_key_with_ts, std::string& plain_key, int64_t& ts);
   static bool DecodeKey(const std::string_view& encode_key_with_ts, std::string& plain_key, int64_t& ts);
@@ -17,13 +17,23 @@
 #include <cstdint>
 #include <string>
 
+#include "brpc/reloadable_flags.h"
 #include "butil/status.h"
+#include "bvar/reducer.h"
 #include "common/helper.h"
+#include "common/serial_helper.h"
+#include "gflags/gflags.h"
 #include "glog/logging.h"
 #include "mvcc/codec.h"
 
 namespace dingodb {
 
+DEFINE_int32(mvcc_iterator_max_sequential_skip, 8,
+             "mvcc iterator reseek after skip this number of versions of the same key, 0 means never reseek");
+BRPC_VALIDATE_GFLAG(mvcc_iterator_max_sequential_skip, brpc::NonNegativeInteger);
+
+bvar::Adder<int64_t> g_mvcc_iterator_reseek_count("dingo_mvcc_iterator_reseek_count");
+
 namespace mvcc {
 
 bool Iterator::Valid() const {
@@ -40,11 +50,15 @@ void Iterator::SeekToFirst() { iter_->SeekToFirst(); }
 
 void Iterator::SeekToLast() { iter_->SeekToLast(); }
 
+// seek can be repeated, e.g. batch get keys with one iterator.
 void Iterator::Seek(const std::string& target) {
-  CHECK(type_ == Type::kNone) << "can't repeat seek.";
+  CHECK(type_ != Type::kForward) << "can't seek after seek for prev.";
 
-  type_ = Type::kBackward;
-  now_time_ = Helper::TimestampMs();
+  if (type_ == Type::kNone) {
+    type_ = Type::kBackward;
+    now_time_ = Helper::TimestampMs();
+  }
+  prev_encode_key_.clear();
   iter_->Seek(target);
   NextVisibleKey();
 }
@@ -84,33 +98,65 @@ std::string_view Iterator::Value() const {
 
 butil::Status Iterator::Status() const { return butil::Status::OK(); }
 
+// seek to the first version of encode_key which version not greater than ts
+void Iterator::Reseek(const std::string_view& encode_key, int64_t ts) {
+  std::string target(encode_key);
+  SerialHelper::WriteLongWithNegation(ts, target);
+
+  g_mvcc_iterator_reseek_count << 1;
+  iter_->Seek(target);
+}
+
 // filter condition:
 // 1. key > ts
 // 2. deleted key
 // 3. ttl expires
+// Skipping versions of the same key one by one is O(versions), so reseek after skip
+// FLAGS_mvcc_iterator_max_sequential_skip versions, like rocksdb max_sequential_skip_in_iterations.
 void Iterator::NextVisibleKey() {
-  for (; iter_->Valid(); iter_->Next()) {
+  const int max_skip = FLAGS_mvcc_iterator_max_sequential_skip;
+  int skip_count = 0;
+  while (iter_->Valid()) {
     auto key = iter_->Key();
     auto encode_key = Codec::TruncateTsForKey(key);
     if (encode_key == prev_encode_key_) {
+      // old version of already visited key, reseek to the oldest version(ts=0) of it.
+      if (max_skip > 0 && ++skip_count > max_skip) {
+        skip_count = 0;
+        Reseek(encode_key, 0);
+        continue;
+      }
+
+      iter_->Next();
       continue;
     }
 
     int64_t ts = Codec::TruncateKeyForTs(key);
     if (ts > ts_) {
+      // newer version than read ts, reseek to the first version not greater than read ts.
+      if (max_skip > 0 && ++skip_count > max_skip) {
+        skip_count = 0;
+        Reseek(encode_key, ts_);
+        continue;
+      }
+
+      iter_->Next();
       continue;
     }
 
+    skip_count = 0;
     prev_encode_key_ = encode_key;
 
     auto value = iter_->Value();
     auto flag = Codec::GetValueFlag(value);
     if (flag == ValueFlag::kDelete) {
+      iter_->Next();
       continue;
 
     } else if (flag == ValueFlag::kPutTTL) {
       int64_t ttl = Codec::GetValueTTL(value);
       if (ttl < now_time_) {
+        iter_->Next();
         continue;
       }
     }
@@ -18,6 +18,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
 
 #include "engine/iterator.h"
 
@@ -52,6 +53,7 @@ class Iterator : public dingodb::Iterator {
  private:
   void NextVisibleKey();
   void PrevVisibleKey();
+  void Reseek(const std::string_view& encode_key, int64_t ts);
 
   enum class Type {
     kNone = 0,
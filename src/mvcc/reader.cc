@@ -14,6 +14,7 @@
 
 #include "mvcc/reader.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -32,8 +33,38 @@ namespace dingodb {
 
 namespace mvcc {
 
+butil::Status Reader::KvBatchGet(const std::string& cf_name, int64_t ts, const std::vector<std::string>& plain_keys,
+                                 std::vector<pb::common::KeyValue>& plain_kvs) {
+  std::vector<std::string> sorted_plain_keys = plain_keys;
+  std::sort(sorted_plain_keys.begin(), sorted_plain_keys.end());
+  sorted_plain_keys.erase(std::unique(sorted_plain_keys.begin(), sorted_plain_keys.end()), sorted_plain_keys.end());
+
+  for (const auto& plain_key : sorted_plain_keys) {
+    std::string plain_value;
+    auto status = KvGet(cf_name, ts, plain_key, plain_value);
+    if (status.error_code() == pb::error::EKEY_NOT_FOUND) {
+      continue;
+    } else if (!status.ok()) {
+      return status;
+    }
+
+    pb::common::KeyValue kv;
+    kv.set_key(plain_key);
+    kv.set_value(std::move(plain_value));
+    plain_kvs.push_back(std::move(kv));
+  }
+
+  return butil::Status::OK();
+}
+
 butil::Status KvReader::KvGet(const std::string& cf_name, int64_t ts, const std::string& plain_key,
                               std::string& plain_value) {
+  int64_t expire_ms = 0;
+  return KvGet(cf_name, ts, plain_key, plain_value, expire_ms);
+}
+
+butil::Status KvReader::KvGet(const std::string& cf_name, int64_t ts, const std::string& plain_key,
+                              std::string& plain_value, int64_t& expire_ms) {
   if (plain_key.empty()) {
     return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
   }
@@ -50,7 +81,8 @@ butil::Status KvReader::KvGet(const std::string& cf_name, int64_t ts, const std:
     return butil::Status(pb::error::EKEY_NOT_FOUND, "Not found key");
   }
 
-  plain_value = Codec::UnPackageValue(iter->Value());
+  ValueFlag flag;
+  plain_value = Codec::UnPackageValue(iter->Value(), flag, expire_ms);
 
   return butil::Status().OK();
 }
@@ -82,7 +114,8 @@ butil::Status KvReader::KvScan(const std::string& cf_name, int64_t ts, const std
 
     kv.set_ts(ts);
     kv.set_key(decode_key);
-    kv.set_value(std::string(Codec::UnPackageValue(iter->Value())));
+    auto value = Codec::UnPackageValue(iter->Value());
+    kv.set_value(value.data(), value.size());
 
     plain_kvs.push_back(std::move(kv));
   }
@@ -262,7 +295,8 @@ butil::Status VectorReader::KvScan(const std::string& cf_name, int64_t ts, const
 
     kv.set_ts(ts);
     kv.set_key(plain_key);
-    kv.set_value(std::string(Codec::UnPackageValue(iter->Value())));
+    auto value = Codec::UnPackageValue(iter->Value());
+    kv.set_value(value.data(), value.size());
 
     plain_kvs.push_back(std::move(kv));
   }
@@ -391,6 +425,45 @@ dingodb::IteratorPtr VectorReader::NewIterator(const std::string& cf_name, int64
   return std::make_shared<Iterator>(ts > 0 ? ts : INT64_MAX, reader_->NewIterator(cf_name, options));
 }
 
+butil::Status VectorReader::KvBatchGet(const std::string& cf_name, int64_t ts,
+                                       const std::vector<std::string>& plain_keys,
+                                       std::vector<pb::common::KeyValue>& plain_kvs) {
+  // encode key keep order of plain key
+  std::vector<std::string> sorted_plain_keys = plain_keys;
+  std::sort(sorted_plain_keys.begin(), sorted_plain_keys.end());
+  sorted_plain_keys.erase(std::unique(sorted_plain_keys.begin(), sorted_plain_keys.end()), sorted_plain_keys.end());
+  if (sorted_plain_keys.empty()) {
+    return butil::Status::OK();
+  }
+  if (BAIDU_UNLIKELY(sorted_plain_keys.front().empty())) {
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  dingodb::IteratorOptions options;
+  options.upper_bound = Helper::PrefixNext(Codec::EncodeBytes(sorted_plain_keys.back()));
+
+  ts = ts > 0 ? ts : INT64_MAX;
+  auto iter = std::make_shared<Iterator>(ts, reader_->NewIterator(cf_name, options));
+  for (auto& plain_key : sorted_plain_keys) {
+    std::string encode_key = Codec::EncodeBytes(plain_key);
+    iter->Seek(encode_key);
+    if (!iter->Valid()) {
+      // no more visible key
+      break;
+    }
+    if (Codec::TruncateTsForKey(iter->Key()) != encode_key) {
+      continue;
+    }
+
+    pb::common::KeyValue kv;
+    kv.set_key(std::move(plain_key));
+    kv.set_value(std::string(Codec::UnPackageValue(iter->Value())));
+    plain_kvs.push_back(std::move(kv));
+  }
+
+  return butil::Status::OK();
+}
+
 butil::Status DocumentReader::KvGet(const std::string& cf_name, int64_t ts, const std::string& plain_key,
                                     std::string& plain_value) {
   if (plain_key.empty()) {
@@ -443,7 +516,8 @@ butil::Status DocumentReader::KvScan(const std::string& cf_name, int64_t ts, con
 
     kv.set_ts(ts);
     kv.set_key(plain_key);
-    kv.set_value(std::string(Codec::UnPackageValue(iter->Value())));
+    auto value = Codec::UnPackageValue(iter->Value());
+    kv.set_value(value.data(), value.size());
 
     plain_kvs.push_back(std::move(kv));
   }
@@ -19,6 +19,7 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "engine/raw_engine.h"
 
@@ -54,6 +55,11 @@ class Reader {
                                  const std::string& plain_end_key, std::string& plain_key) = 0;
 
   virtual dingodb::IteratorPtr NewIterator(const std::string& cf_name, int64_t ts, IteratorOptions options) = 0;
+
+  // get many plain keys at once
+  // output plain_kvs only contain found keys, order by plain key
+  virtual butil::Status KvBatchGet(const std::string& cf_name, int64_t ts, const std::vector<std::string>& plain_keys,
+                                   std::vector<pb::common::KeyValue>& plain_kvs);
 };
 using ReaderPtr = std::shared_ptr<Reader>;
 
@@ -67,6 +73,9 @@ class KvReader : public Reader {
   // output value is plain value, not include ext field
   butil::Status KvGet(const std::string& cf_name, int64_t ts, const std::string& plain_key,
                       std::string& plain_value) override;
+  // same as above, output expire_ms is the ttl of value, 0 is never expire.
+  butil::Status KvGet(const std::string& cf_name, int64_t ts, const std::string& plain_key, std::string& plain_value,
+                      int64_t& expire_ms);
 
   // start_key and end_key is plain key
   // output plain_kvs is plain key
@@ -127,6 +136,10 @@ class VectorReader : public Reader {
 
   dingodb::IteratorPtr NewIterator(const std::string& cf_name, int64_t ts, IteratorOptions options) override;
 
+  // seek sorted keys with one iterator, instead of one iterator per key.
+  butil::Status KvBatchGet(const std::string& cf_name, int64_t ts, const std::vector<std::string>& plain_keys,
+                           std::vector<pb::common::KeyValue>& plain_kvs) override;
+
  private:
   RawEngine::ReaderPtr reader_;
 };
@@ -14,6 +14,7 @@
 
 #include "mvcc/ts_provider.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <memory>
@@ -26,6 +27,9 @@
 #include "proto/meta.pb.h"
 
 DEFINE_uint32(ts_provider_batch_size, 100, "get tso batch size");
+DEFINE_uint32(ts_provider_max_batch_size, 10000, "max get tso batch size of adaptive batch");
+DEFINE_bool(ts_provider_enable_prefetch, true, "enable prefetch tso in background before batch ts run out");
+DEFINE_uint32(ts_provider_prefetch_window_ms, 500, "batch size is the consume ts count in this window");
 DEFINE_uint32(ts_provider_send_retry_num, 8, "send tso request retry num");
 DEFINE_uint32(ts_provider_max_retry_num, 16, "get tso max retry num");
 DEFINE_uint32(ts_provider_renew_max_retry_num, 16, "renew max retry num");
@@ -155,6 +159,15 @@ int64_t BatchTsList::GetTs(int64_t after_ts) {
   return 0;
 }
 
+bool BatchTsList::NeedPrefetch(int64_t low_watermark) {
+  BatchTs* head = head_.load();
+  if (head == nullptr || head->next.load() != nullptr) {
+    return false;
+  }
+
+  return head->Remain() < low_watermark || IsStale(head);
+}
+
 void BatchTsList::PushDead(BatchTs* batch_ts) {
   batch_ts->next.store(nullptr);
   batch_ts->SetDeadTime(Helper::TimestampMs());
@@ -289,10 +302,13 @@ int64_t TsProvider::GetTs(int64_t after_ts) {
     int64_t ts = batch_ts_list_->GetTs(after_ts);
     if (ts > 0) {
       get_ts_count_ << 1;
+      PrefetchBatchTs();
       return ts;
     }
 
+    int64_t start_time = Helper::TimestampUs();
     LaunchRenewBatchTs(true);
+    stall_latency_ << Helper::TimestampUs() - start_time;
   }
 
   if (retry_count == FLAGS_ts_provider_max_retry_num) {
@@ -322,6 +338,38 @@ void TsProvider::RenewBatchTs() {
   DINGO_LOG(ERROR) << fmt::format("renew retry({}) too much.", FLAGS_ts_provider_renew_max_retry_num);
 }
 
+void TsProvider::PrefetchBatchTs() {
+  if (!FLAGS_ts_provider_enable_prefetch) {
+    return;
+  }
+
+  // prefetch when less than half of the last batch left
+  int64_t low_watermark = std::max(last_batch_size_.load(std::memory_order_relaxed), FLAGS_ts_provider_batch_size) / 2;
+  if (!batch_ts_list_->NeedPrefetch(low_watermark)) {
+    return;
+  }
+
+  bool expect = false;
+  if (!is_prefetching_.compare_exchange_strong(expect, true)) {
+    return;
+  }
+
+  prefetch_count_ << 1;
+  auto task = std::make_shared<TakeBatchTsTask>(false, RenewEpoch(), GetSelfPtr());
+  if (!worker_->Execute(task)) {
+    is_prefetching_.store(false, std::memory_order_release);
+    DINGO_LOG(ERROR) << "Launch prefetch batch ts failed.";
+  }
+}
+
+uint32_t TsProvider::CalcBatchSize(int64_t ts_per_second) {
+  int64_t batch_size = ts_per_second * FLAGS_ts_provider_prefetch_window_ms / 1000;
+  batch_size = std::max(batch_size, static_cast<int64_t>(FLAGS_ts_provider_batch_size));
+  batch_size = std::min(batch_size, static_cast<int64_t>(FLAGS_ts_provider_max_batch_size));
+
+  return static_cast<uint32_t>(batch_size);
+}
+
 void TsProvider::LaunchRenewBatchTs(bool is_sync) {
   auto task = std::make_shared<TakeBatchTsTask>(is_sync, RenewEpoch(), GetSelfPtr());
   bool ret = worker_->Execute(task);
@@ -338,8 +386,9 @@ void TsProvider::LaunchRenewBatchTs(bool is_sync) {
 void TsProvider::TriggerRenewBatchTs() { LaunchRenewBatchTs(false); }
 
 std::string TsProvider::DebugInfo() {
-  return fmt::format("{} ts_count({}/{}) renew({})", batch_ts_list_->DebugInfo(), GetTsCount(), GetTsFailCount(),
-                     RenewEpoch());
+  return fmt::format("{} ts_count({}/{}) renew({}) prefetch({}) batch_size({})", batch_ts_list_->DebugInfo(),
+                     GetTsCount(), GetTsFailCount(), RenewEpoch(), prefetch_count_.get_value(),
+                     last_batch_size_.load());
 }
 
 // for test
@@ -363,7 +412,9 @@ BatchTs* GenBatchTsForTest() {
 BatchTs* TsProvider::SendTsoRequest() {
   pb::meta::TsoRequest tso_request;
   tso_request.set_op_type(pb::meta::TsoOpType::OP_GEN_TSO);
-  tso_request.set_count(FLAGS_ts_provider_batch_size);
+  uint32_t batch_size = CalcBatchSize(get_ts_per_second_.get_value(1));
+  last_batch_size_.store(batch_size, std::memory_order_relaxed);
+  tso_request.set_count(batch_size);
 
   pb::meta::TsoResponse tso_response;
   auto status = interaction_->SendRequest(pb::common::ServiceTypeMeta, "TsoService", tso_request, tso_response);
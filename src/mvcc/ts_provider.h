@@ -21,6 +21,9 @@
 #include <string>
 #include <vector>
 
+#include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
+#include "bvar/window.h"
 #include "common/runnable.h"
 #include "common/synchronization.h"
 
@@ -122,6 +125,9 @@ class BatchTsList {
 
   int64_t LastPhysical() const { return last_physical_.load(std::memory_order_relaxed); }
 
+  // Whether only the current BatchTs is left and its remain ts less than low_watermark.
+  bool NeedPrefetch(int64_t low_watermark);
+
   void CleanDead();
 
   std::string DebugInfo();
@@ -157,7 +163,10 @@ class TsProvider : public std::enable_shared_from_this<TsProvider> {
       : interaction_(interaction),
         get_ts_count_("dingo_ts_provider_get_ts_count"),
         get_ts_fail_count_("dingo_ts_provider_get_ts_fail_count"),
-        renew_epoch_("dingo_ts_provider_renew_epoch") {
+        renew_epoch_("dingo_ts_provider_renew_epoch"),
+        get_ts_per_second_("dingo_ts_provider_get_ts_per_second", &get_ts_count_),
+        stall_latency_("dingo_ts_provider_stall"),
+        prefetch_count_("dingo_ts_provider_prefetch_count") {
     worker_ = Worker::New();
     batch_ts_list_ = BatchTsList::New();
   }
@@ -194,6 +203,9 @@ class TsProvider : public std::enable_shared_from_this<TsProvider> {
 
   std::string DebugInfo();
 
+  // Batch size which can be consume in prefetch window at the consume rate.
+  static uint32_t CalcBatchSize(int64_t ts_per_second);
+
  private:
   friend class TakeBatchTsTask;
 
@@ -202,6 +214,9 @@ class TsProvider : public std::enable_shared_from_this<TsProvider> {
   void RenewBatchTs();
   void LaunchRenewBatchTs(bool is_sync);
 
+  // Renew BatchTs in background before current BatchTs run out.
+  void PrefetchBatchTs();
+
   // manage BatchTs cache
   BatchTsListPtr batch_ts_list_;
 
@@ -216,6 +231,15 @@ class TsProvider : public std::enable_shared_from_this<TsProvider> {
   bvar::Adder<uint64_t> get_ts_fail_count_;
 
   bvar::Adder<uint64_t> renew_epoch_;
+
+  bvar::PerSecond<bvar::Adder<uint64_t>> get_ts_per_second_;
+  // wait time of GetTs when no available ts
+  bvar::LatencyRecorder stall_latency_;
+  bvar::Adder<uint64_t> prefetch_count_;
+
+  // size of the last requested BatchTs
+  std::atomic<uint32_t> last_batch_size_{0};
+  std::atomic<bool> is_prefetching_{false};
 };
 
 // take BatchTs task, run at worker
@@ -235,6 +259,7 @@ class TakeBatchTsTask : public TaskRunnable {
     if (renew_num_ == ts_provider_->RenewEpoch()) {
       ts_provider_->RenewBatchTs();
     }
+    ts_provider_->is_prefetching_.store(false, std::memory_order_release);
 
     Notify();
   }
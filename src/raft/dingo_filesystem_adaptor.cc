@@ -21,6 +21,7 @@
 #include <utility>
 
 #include "common/constant.h"
+#include "common/gflag_validator.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
@@ -32,6 +33,8 @@
 namespace dingodb {
 
 DEFINE_int64(snapshot_timeout_min, 10, "snapshot_timeout_min : 10min");
+DEFINE_bool(enable_raft_snapshot_prefetch, true, "enable read ahead next chunk when install raft snapshot");
+DEFINE_validator(enable_raft_snapshot_prefetch, &PassBool);
 DECLARE_string(raft_snapshot_policy);
 
 bool inline IsSnapshotMetaFile(const std::string& path) {
@@ -129,6 +132,9 @@ void DingoDataReaderAdaptor::ContextReset() {
   temp_iter_context->iter->Seek(temp_iter_context->lower_bound);
   temp_iter_context->snapshot_context->data_iterators[iter_ctx_in_adaptor_->cf_name] = temp_iter_context;
   iter_ctx_in_adaptor_ = temp_iter_context;
+
+  prefetch_valid_ = false;
+  prefetch_package_.clear();
 }
 
 ssize_t DingoDataReaderAdaptor::read(butil::IOPortal* portal, off_t offset, size_t size) {
@@ -148,14 +154,18 @@ ssize_t DingoDataReaderAdaptor::read(butil::IOPortal* portal, off_t offset, size
   }
 
   TimeCost time_cost;
-  if (offset > iter_ctx_in_adaptor_->offset) {
+  WaitPrefetch();
+
+  // iterator is ahead of the copier when next chunk is prefetched
+  int64_t next_offset = prefetch_valid_ ? prefetch_offset_ : iter_ctx_in_adaptor_->offset;
+  if (offset > next_offset) {
     DINGO_LOG(ERROR) << "region_id: " << region_id_
                      << " retry last_offset, offset biger fail, time_cost: " << time_cost.GetTime()
                      << ", last_off: " << last_offset_ << ", off: " << offset
                      << ", ctx->off: " << iter_ctx_in_adaptor_->offset << ", size: " << size;
     return -1;
   }
-  if (offset < iter_ctx_in_adaptor_->offset) {
+  if (offset < next_offset) {
     // cache the last package, when retry first time, can recover
     if (last_offset_ == offset) {
       *portal = last_package_;
@@ -185,12 +195,42 @@ ssize_t DingoDataReaderAdaptor::read(butil::IOPortal* portal, off_t offset, size
 
   size_t count = 0;
   int64_t key_num = 0;
+  bool prefetch_hit = prefetch_valid_;
+  if (prefetch_valid_) {
+    portal->append(prefetch_package_);
+    count = prefetch_package_.size();
+    prefetch_package_.clear();
+    prefetch_valid_ = false;
+  }
+
+  if (count < size) {
+    auto read_size = ReadFromIterator(portal, size - count, key_num);
+    if (read_size < 0) {
+      return -1;
+    }
+    count += read_size;
+  }
+
+  DINGO_LOG(WARNING) << "region_id: " << region_id_ << " read done. count: " << count << ", key_num: " << key_num
+                     << ", time_cost: " << time_cost.GetTime() << ", off: " << offset << ", size: " << size
+                     << ", last_off: " << last_offset_ << ", last_count: " << last_package_.size()
+                     << ", prefetch_hit: " << prefetch_hit;
+  last_offset_ = offset;
+  last_package_ = *portal;
+
+  if (FLAGS_enable_raft_snapshot_prefetch && !iter_ctx_in_adaptor_->done) {
+    StartPrefetch(offset + count, size);
+  }
 
+  return count;
+}
+
+int64_t DingoDataReaderAdaptor::ReadFromIterator(butil::IOPortal* portal, size_t size, int64_t& key_num) {
+  size_t count = 0;
   while (count < size) {
     if (!iter_ctx_in_adaptor_->iter->Valid() ||
         !(iter_ctx_in_adaptor_->iter->Key() >= iter_ctx_in_adaptor_->lower_bound)) {
       iter_ctx_in_adaptor_->done = true;
-      // portal->append((void*)iter_context->offset, sizeof(size_t));
       DINGO_LOG(WARNING) << "region_id: " << region_id_
                          << " snapshot read over, total size: " << iter_ctx_in_adaptor_->offset;
       auto region = region_ptr_;
@@ -210,26 +250,60 @@ ssize_t DingoDataReaderAdaptor::read(butil::IOPortal* portal, off_t offset, size
     iter_ctx_in_adaptor_->offset_update_time.Reset();
     iter_ctx_in_adaptor_->iter->Next();
   }
-  DINGO_LOG(WARNING) << "region_id: " << region_id_ << " read done. count: " << count << ", key_num: " << key_num
-                     << ", time_cost: " << time_cost.GetTime() << ", off: " << offset << ", size: " << size
-                     << ", last_off: " << last_offset_ << ", last_count: " << last_package_.size();
-  last_offset_ = offset;
-  last_package_ = *portal;
+
   return count;
 }
 
+void* DingoDataReaderAdaptor::PrefetchRoutine(void* arg) {
+  auto* adaptor = static_cast<DingoDataReaderAdaptor*>(arg);
+
+  int64_t key_num = 0;
+  auto read_size = adaptor->ReadFromIterator(&adaptor->prefetch_package_, adaptor->prefetch_size_, key_num);
+  adaptor->prefetch_valid_ = read_size > 0;
+  if (read_size <= 0) {
+    adaptor->prefetch_package_.clear();
+  }
+
+  return nullptr;
+}
+
+void DingoDataReaderAdaptor::StartPrefetch(off_t offset, size_t size) {
+  prefetch_offset_ = offset;
+  prefetch_size_ = size;
+  prefetch_valid_ = false;
+  prefetch_package_.clear();
+
+  if (bthread_start_background(&prefetch_tid_, &BTHREAD_ATTR_NORMAL, PrefetchRoutine, this) != 0) {
+    DINGO_LOG(WARNING) << "region_id: " << region_id_ << " start snapshot prefetch failed, off: " << offset;
+    return;
+  }
+  prefetching_ = true;
+}
+
+void DingoDataReaderAdaptor::WaitPrefetch() {
+  if (prefetching_) {
+    bthread_join(prefetch_tid_, nullptr);
+    prefetching_ = false;
+  }
+}
+
 bool DingoDataReaderAdaptor::close() {
   if (closed_) {
     DINGO_LOG(WARNING) << "file has been closed, region_id: " << region_id_ << ", num_lines: " << num_lines_
                        << ", path: " << path_;
     return true;
   }
+  WaitPrefetch();
   dingo_fs_adatpor_->Close(path_);
   closed_ = true;
   return true;
 }
 
 ssize_t DingoDataReaderAdaptor::size() {
+  // still reading ahead, so the file is not over yet
+  if (prefetching_) {
+    return std::numeric_limits<ssize_t>::max();
+  }
   if (iter_ctx_in_adaptor_->done) {
     return iter_ctx_in_adaptor_->offset;
   }
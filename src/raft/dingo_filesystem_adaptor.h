@@ -18,6 +18,7 @@
 #include <braft/file_system_adaptor.h>
 #include <braft/raft.h>
 #include <braft/util.h>
+#include <bthread/bthread.h>
 
 #include <cstdint>
 #include <memory>
@@ -146,6 +147,15 @@ class DingoDataReaderAdaptor : public braft::FileAdaptor {
 
   void ContextReset();
 
+  // Serialize kv from iterator until reach size, return -1 when region is null.
+  int64_t ReadFromIterator(butil::IOPortal* portal, size_t size, int64_t& key_num);
+
+  // Read ahead next chunk in background while the current chunk is in flight,
+  // so serialize and network round trip are overlapped.
+  static void* PrefetchRoutine(void* arg);
+  void StartPrefetch(off_t offset, size_t size);
+  void WaitPrefetch();
+
   int64_t region_id_ = 0;
   int64_t cf_id_ = 0;
   store::RegionPtr region_ptr_;
@@ -156,6 +166,14 @@ class DingoDataReaderAdaptor : public braft::FileAdaptor {
   size_t num_lines_ = 0;
   butil::IOPortal last_package_;
   off_t last_offset_ = 0;
+
+  // Prefetch state, only touched by prefetch bthread between StartPrefetch and WaitPrefetch.
+  bthread_t prefetch_tid_ = 0;
+  bool prefetching_ = false;
+  bool prefetch_valid_ = false;
+  off_t prefetch_offset_ = 0;
+  size_t prefetch_size_ = 0;
+  butil::IOPortal prefetch_package_;
 };
 
 class DingoMetaReaderAdaptor : public braft::FileAdaptor {
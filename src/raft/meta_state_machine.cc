@@ -14,21 +14,29 @@
 
 #include "raft/meta_state_machine.h"
 
-#include <braft/protobuf_file.h>  // braft::ProtoBufFile
 #include <braft/storage.h>        // braft::SnapshotWriter
 #include <braft/util.h>           // braft::AsyncClosureGuard
+#include <fcntl.h>
+#include <unistd.h>
 
+#include <cerrno>
 #include <cstdint>
+#include <cstring>
+#include <limits>
 #include <memory>
+#include <string>
 
 #include "bthread/bthread.h"
+#include "butil/sys_byteorder.h"
 #include "common/logging.h"
 #include "common/meta_control.h"
 #include "engine/snapshot.h"
 #include "fmt/core.h"
 #include "fmt/format.h"
+#include "google/protobuf/io/zero_copy_stream_impl.h"
 #include "proto/coordinator_internal.pb.h"
 #include "proto/error.pb.h"
+#include "raft/raft_cmd_codec.h"
 
 namespace dingodb {
 
@@ -80,8 +88,7 @@ void MetaStateMachine::on_apply(braft::Iterator& iter) {
       raft_cmd = *(store_closure->GetRequest());
       is_leader = true;
     } else {
-      butil::IOBufAsZeroCopyInputStream wrapper(iter.data());
-      CHECK(raft_cmd.ParseFromZeroCopyStream(&wrapper));
+      CHECK(RaftCmdCodec::Decode(iter.data(), &raft_cmd));
     }
 
     DINGO_LOG(DEBUG) << fmt::format("[raft.sm][node({})] raft apply log on region[{}-term:{}-index:{}] cmd:[{}]",
@@ -106,6 +113,59 @@ struct SnapshotArg {
   braft::Closure* done;
 };
 
+// Same format as braft::ProtoBufFile(4 bytes length in network order and message), but message is serialized
+// to and parsed from file directly, so no whole serialized copy of meta is held in memory.
+static bool SaveMetaSnapshotFile(const std::string& path, const pb::coordinator_internal::MetaSnapshotFile& file) {
+  size_t size = file.ByteSizeLong();
+  if (size > std::numeric_limits<uint32_t>::max()) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.sm] meta snapshot file is too large, size({})", size);
+    return false;
+  }
+
+  std::string tmp_path = path + ".tmp";
+  int fd = ::open(tmp_path.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+  if (fd < 0) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.sm] open file({}) failed, error: {}", tmp_path, strerror(errno));
+    return false;
+  }
+
+  bool ret = false;
+  uint32_t header = butil::HostToNet32(static_cast<uint32_t>(size));
+  if (::write(fd, &header, sizeof(header)) == sizeof(header)) {
+    google::protobuf::io::FileOutputStream output(fd);
+    ret = file.SerializeToZeroCopyStream(&output) && output.Flush();
+  }
+  ret = ret && ::fsync(fd) == 0;
+  ::close(fd);
+
+  if (!ret || ::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.sm] write file({}) failed, error: {}", path, strerror(errno));
+    ::unlink(tmp_path.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+static bool LoadMetaSnapshotFile(const std::string& path, pb::coordinator_internal::MetaSnapshotFile& file) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.sm] open file({}) failed, error: {}", path, strerror(errno));
+    return false;
+  }
+
+  bool ret = false;
+  uint32_t header = 0;
+  if (::read(fd, &header, sizeof(header)) == sizeof(header)) {
+    google::protobuf::io::FileInputStream input(fd);
+    google::protobuf::io::LimitingInputStream limit_input(&input, butil::NetToHost32(header));
+    ret = file.ParseFromZeroCopyStream(&limit_input);
+  }
+  ::close(fd);
+
+  return ret;
+}
+
 static void* SaveSnapshot(void* arg) {
   SnapshotArg* sa = (SnapshotArg*)arg;
   std::unique_ptr<SnapshotArg> arg_guard(sa);
@@ -124,8 +184,7 @@ static void* SaveSnapshot(void* arg) {
 
   DINGO_LOG(INFO) << fmt::format("[raft.sm][node({})] save snapshot, generate metafile.", sa->node_id);
 
-  braft::ProtoBufFile pb_file(snapshot_path);
-  if (pb_file.save(&s, true) != 0) {
+  if (!SaveMetaSnapshotFile(snapshot_path, s)) {
     sa->done->status().set_error(EIO, "Fail to save pb_file");
     return nullptr;
   }
@@ -212,9 +271,8 @@ int MetaStateMachine::on_snapshot_load(braft::SnapshotReader* reader) {
   }
 
   std::string snapshot_path = reader->get_path() + "/data";
-  braft::ProtoBufFile pb_file(snapshot_path);
   pb::coordinator_internal::MetaSnapshotFile s;
-  if (pb_file.load(&s) != 0) {
+  if (!LoadMetaSnapshotFile(snapshot_path, s)) {
     DINGO_LOG(ERROR) << fmt::format("[raft.sm][node({})] fail to load snapshot from path({})", node_id_, snapshot_path);
     return -1;
   }
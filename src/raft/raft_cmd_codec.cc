@@ -0,0 +1,124 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "raft/raft_cmd_codec.h"
+
+#include <cstdint>
+#include <string>
+
+#include "brpc/compress.h"
+#include "brpc/reloadable_flags.h"
+#include "bvar/reducer.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_string(raft_log_vector_compress_type, "none",
+              "compress type of raft log carry vector add, snappy/gzip/zlib/none, all replicas must support it");
+DEFINE_string(raft_log_document_compress_type, "none",
+              "compress type of raft log carry document add, snappy/gzip/zlib/none, all replicas must support it");
+DEFINE_int64(raft_log_compress_min_bytes, 64 * 1024, "compress raft log only when larger than this");
+BRPC_VALIDATE_GFLAG(raft_log_compress_min_bytes, brpc::NonNegativeInteger);
+
+bvar::Adder<int64_t> g_raft_log_compress_count("dingo_raft_log_compress_count");
+bvar::Adder<int64_t> g_raft_log_compress_input_bytes("dingo_raft_log_compress_input_bytes");
+bvar::Adder<int64_t> g_raft_log_compress_output_bytes("dingo_raft_log_compress_output_bytes");
+
+static brpc::CompressType ParseCompressType(const std::string& compress_type) {
+  if (compress_type == "snappy") {
+    return brpc::COMPRESS_TYPE_SNAPPY;
+  } else if (compress_type == "gzip") {
+    return brpc::COMPRESS_TYPE_GZIP;
+  } else if (compress_type == "zlib") {
+    return brpc::COMPRESS_TYPE_ZLIB;
+  }
+  return brpc::COMPRESS_TYPE_NONE;
+}
+
+// float vector compress little, text compress well, so compress type is chosen by payload.
+static brpc::CompressType GetCompressType(const pb::raft::RaftCmdRequest& raft_cmd, size_t size) {
+  if (size < FLAGS_raft_log_compress_min_bytes) {
+    return brpc::COMPRESS_TYPE_NONE;
+  }
+
+  for (const auto& request : raft_cmd.requests()) {
+    switch (request.cmd_type()) {
+      case pb::raft::CmdType::VECTOR_ADD:
+      case pb::raft::CmdType::VECTOR_BATCH_ADD:
+        return ParseCompressType(FLAGS_raft_log_vector_compress_type);
+      case pb::raft::CmdType::DOCUMENT_ADD:
+      case pb::raft::CmdType::DOCUMENT_BATCH_ADD:
+        return ParseCompressType(FLAGS_raft_log_document_compress_type);
+      default:
+        break;
+    }
+  }
+
+  return brpc::COMPRESS_TYPE_NONE;
+}
+
+void RaftCmdCodec::Encode(const pb::raft::RaftCmdRequest& raft_cmd, butil::IOBuf& data) {
+  size_t size = raft_cmd.ByteSizeLong();
+  auto compress_type = GetCompressType(raft_cmd, size);
+  if (compress_type != brpc::COMPRESS_TYPE_NONE) {
+    butil::IOBuf compressed_data;
+    char header[2] = {kCompressMagic, static_cast<char>(compress_type)};
+    compressed_data.append(header, sizeof(header));
+    // keep plain data when compress fail or not smaller.
+    if (brpc::CompressData(compress_type, raft_cmd, &compressed_data) && compressed_data.size() < size) {
+      g_raft_log_compress_count << 1;
+      g_raft_log_compress_input_bytes << size;
+      g_raft_log_compress_output_bytes << compressed_data.size();
+      data.append(butil::IOBuf::Movable(compressed_data));
+      return;
+    }
+  }
+
+  butil::IOBufAsZeroCopyOutputStream wrapper(&data);
+  raft_cmd.SerializeToZeroCopyStream(&wrapper);
+}
+
+bool RaftCmdCodec::IsCompressed(const butil::IOBuf& data) {
+  const void* first = data.fetch1();
+  return first != nullptr && *static_cast<const char*>(first) == kCompressMagic;
+}
+
+bool RaftCmdCodec::Decode(const butil::IOBuf& data, pb::raft::RaftCmdRequest* raft_cmd) {
+  if (!IsCompressed(data)) {
+    butil::IOBufAsZeroCopyInputStream wrapper(data);
+    return raft_cmd->ParseFromZeroCopyStream(&wrapper);
+  }
+
+  char header[2];
+  if (data.copy_to(header, sizeof(header)) != sizeof(header)) {
+    return false;
+  }
+
+  butil::IOBuf compressed_data = data;
+  compressed_data.pop_front(sizeof(header));
+  return brpc::ParseFromCompressedData(compressed_data, raft_cmd, static_cast<brpc::CompressType>(header[1]));
+}
+
+bool RaftCmdCodec::Decode(const std::string& data, pb::raft::RaftCmdRequest* raft_cmd) {
+  if (data.empty() || data[0] != kCompressMagic) {
+    return raft_cmd->ParseFromString(data);
+  }
+
+  butil::IOBuf buf;
+  buf.append(data);
+  return Decode(buf, raft_cmd);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,45 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_RAFT_RAFT_CMD_CODEC_H_
+#define DINGODB_RAFT_RAFT_CMD_CODEC_H_
+
+#include <string>
+
+#include "butil/iobuf.h"
+#include "proto/raft.pb.h"
+
+namespace dingodb {
+
+// Encode raft command to raft log data, large vector/document add command is compressed, so log storage and
+// replication to follower carry less bytes.
+// compressed data: | kCompressMagic(1 byte) | compress type(1 byte) | compressed raft command |
+// serialized protobuf message never start with 0 byte(field number 0 is invalid), so plain data is parsed as before.
+class RaftCmdCodec {
+ public:
+  static void Encode(const pb::raft::RaftCmdRequest& raft_cmd, butil::IOBuf& data);
+
+  // raft_cmd may be allocated on arena.
+  static bool Decode(const butil::IOBuf& data, pb::raft::RaftCmdRequest* raft_cmd);
+  static bool Decode(const std::string& data, pb::raft::RaftCmdRequest* raft_cmd);
+
+  static bool IsCompressed(const butil::IOBuf& data);
+
+  static constexpr char kCompressMagic = 0;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_RAFT_RAFT_CMD_CODEC_H_
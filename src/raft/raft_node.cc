@@ -14,15 +14,20 @@
 
 #include "raft/raft_node.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
 
+#include "brpc/reloadable_flags.h"
 #include "bthread/bthread.h"
 #include "butil/compiler_specific.h"
 #include "butil/memory/ref_counted.h"
 #include "butil/status.h"
+#include "bvar/reducer.h"
+#include "common/constant.h"
 #include "common/failpoint.h"
+#include "common/gflag_validator.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "fmt/core.h"
@@ -31,12 +36,29 @@
 #include "metrics/store_bvar_metrics.h"
 #include "proto/common.pb.h"
 #include "raft/dingo_filesystem_adaptor.h"
+#include "raft/raft_cmd_codec.h"
 #include "raft/store_state_machine.h"
 
 DEFINE_int32(node_destroy_wait_time_ms, 3000, "wait time on node destroy");
 
+namespace braft {
+DECLARE_int32(raft_election_heartbeat_factor);
+}  // namespace braft
+
 namespace dingodb {
 
+DECLARE_string(raft_snapshot_policy);
+DECLARE_bool(enable_raft_snapshot_reuse_sst);
+
+DEFINE_bool(enable_raft_hibernate, false, "enable hibernate idle region leader to reduce heartbeat");
+DEFINE_validator(enable_raft_hibernate, &PassBool);
+DEFINE_int32(raft_hibernate_idle_time_s, 60, "region leader without commit exceed it will hibernate");
+BRPC_VALIDATE_GFLAG(raft_hibernate_idle_time_s, brpc::PositiveInteger);
+DEFINE_int32(raft_hibernate_election_timeout_factor, 4, "election timeout factor of hibernated region leader");
+BRPC_VALIDATE_GFLAG(raft_hibernate_election_timeout_factor, brpc::PositiveInteger);
+
+bvar::Adder<int64_t> g_raft_hibernated_node_count("dingo_raft_hibernated_node_count");
+
 RaftNode::RaftNode(int64_t node_id, const std::string& raft_group_name, braft::PeerId peer_id,
                    std::shared_ptr<BaseStateMachine> fsm, wal::LogStoragePtr log_storage)
     : node_id_(node_id),
@@ -56,6 +78,8 @@ int RaftNode::Init(store::RegionPtr region, const std::string& init_conf, const
                    int election_timeout_ms) {
   DINGO_LOG(INFO) << fmt::format("[raft.node][node_id({})] raft init init_conf: {}", node_id_, init_conf);
   election_timeout_ms_ = election_timeout_ms;
+  normal_election_timeout_ms_ = election_timeout_ms;
+  last_commit_time_ms_.store(Helper::TimestampMs(), std::memory_order_relaxed);
 
   braft::NodeOptions node_options;
   if (node_options.initial_conf.parse_from(init_conf) != 0) {
@@ -72,6 +96,9 @@ int RaftNode::Init(store::RegionPtr region, const std::string& init_conf, const
   node_options.raft_meta_uri = fmt::format("local-merged://{}/meta", raft_path);
   node_options.snapshot_uri = fmt::format("local://{}/snapshot/{}", raft_path, node_id_);
   node_options.disable_cli = false;
+  // Checkpoint snapshot carry sst identity as file checksum, follower link unchanged sst from last snapshot.
+  node_options.filter_before_copy_remote =
+      FLAGS_enable_raft_snapshot_reuse_sst && FLAGS_raft_snapshot_policy == Constant::kRaftSnapshotPolicyCheckpoint;
 
   node_options.log_storage = new wal::RocksLogStorageWrapper(node_id_, log_storage_);
   node_options.node_owns_log_storage = true;
@@ -126,8 +153,7 @@ butil::Status RaftNode::Commit(std::shared_ptr<Context> ctx, std::shared_ptr<pb:
     return butil::Status(pb::error::ERAFT_NOTLEADER, GetLeaderId().to_string());
   }
   butil::IOBuf data;
-  butil::IOBufAsZeroCopyOutputStream wrapper(&data);
-  raft_cmd->SerializeToZeroCopyStream(&wrapper);
+  RaftCmdCodec::Encode(*raft_cmd, data);
 
   FAIL_POINT("before_raft_commit");
 
@@ -136,6 +162,11 @@ butil::Status RaftNode::Commit(std::shared_ptr<Context> ctx, std::shared_ptr<pb:
     tracker->SetPrepairCommitTime();
   }
 
+  last_commit_time_ms_.store(Helper::TimestampMs(), std::memory_order_relaxed);
+  if (BAIDU_UNLIKELY(hibernated_.load(std::memory_order_relaxed))) {
+    WakeUp();
+  }
+
   braft::Task task;
   task.data = &data;
   task.done = new BaseClosure(ctx, raft_cmd);
@@ -167,6 +198,50 @@ void RaftNode::ResetElectionTimeout(int election_timeout_ms, int max_clock_drift
   }
 }
 
+void RaftNode::CheckHibernate() {
+  if (!IsLeader()) {
+    // Follower always use normal election timeout, otherwise it can't find leader down in time.
+    if (hibernated_.load(std::memory_order_relaxed)) {
+      WakeUp();
+    }
+    return;
+  }
+
+  if (!FLAGS_enable_raft_hibernate || hibernated_.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  if (Helper::TimestampMs() - last_commit_time_ms_.load(std::memory_order_relaxed) <
+      FLAGS_raft_hibernate_idle_time_s * 1000) {
+    return;
+  }
+
+  // Heartbeat interval is election_timeout / raft_election_heartbeat_factor, keep it less than
+  // half of follower election timeout.
+  int factor = std::min(FLAGS_raft_hibernate_election_timeout_factor,
+                        std::max(braft::FLAGS_raft_election_heartbeat_factor / 2, 1));
+  if (factor <= 1) {
+    return;
+  }
+
+  bool expected = false;
+  if (hibernated_.compare_exchange_strong(expected, true)) {
+    DINGO_LOG(INFO) << fmt::format("[raft.node][node_id({})] hibernate, election timeout({}) factor({})", node_id_,
+                                   normal_election_timeout_ms_, factor);
+    ResetElectionTimeout(normal_election_timeout_ms_ * factor, 1000);
+    g_raft_hibernated_node_count << 1;
+  }
+}
+
+void RaftNode::WakeUp() {
+  bool expected = true;
+  if (hibernated_.compare_exchange_strong(expected, false)) {
+    DINGO_LOG(INFO) << fmt::format("[raft.node][node_id({})] wake up from hibernate", node_id_);
+    ResetElectionTimeout(normal_election_timeout_ms_, 1000);
+    g_raft_hibernated_node_count << -1;
+  }
+}
+
 void RaftNode::Shutdown(braft::Closure* done) { node_->shutdown(done); }
 void RaftNode::Join() { node_->join(); }
 
@@ -85,13 +85,25 @@ class RaftNode {
   void SetConsistentReadable(bool consistent_readable);
   bool ConsistentReadable();
 
+  // Hibernate idle leader, enlarge election timeout so heartbeat become sparse,
+  // wake up when next commit or lose leadership.
+  void CheckHibernate();
+  bool IsHibernated() const { return hibernated_.load(std::memory_order_relaxed); }
+
  private:
+  void WakeUp();
+
   std::string path_;
   int64_t node_id_;
   std::string str_node_id_;
   std::string raft_group_name_;
 
   uint32_t election_timeout_ms_;
+  // Election timeout when not hibernated.
+  uint32_t normal_election_timeout_ms_{0};
+
+  std::atomic<int64_t> last_commit_time_ms_{0};
+  std::atomic<bool> hibernated_{false};
 
   std::shared_ptr<BaseStateMachine> fsm_;
   wal::LogStoragePtr log_storage_;
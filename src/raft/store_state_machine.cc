@@ -14,30 +14,67 @@
 
 #include "raft/store_state_machine.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "braft/util.h"
+#include "brpc/reloadable_flags.h"
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
+#include "bvar/recorder.h"
+#include "common/gflag_validator.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
 #include "event/store_state_machine_event.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "google/protobuf/arena.h"
 #include "meta/store_meta_manager.h"
 #include "metrics/store_bvar_metrics.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/raft.pb.h"
 #include "raft/dingo_filesystem_adaptor.h"
+#include "raft/raft_cmd_codec.h"
 #include "server/server.h"
 
 const int kSaveAppliedIndexStep = 10;
 
 namespace dingodb {
 
+DEFINE_bool(enable_raft_batch_apply, false, "enable apply consecutive put/delete batch logs with one write batch");
+DEFINE_validator(enable_raft_batch_apply, &PassBool);
+DEFINE_int32(raft_batch_apply_max_count, 256, "max log count of one batch apply");
+BRPC_VALIDATE_GFLAG(raft_batch_apply_max_count, brpc::PositiveInteger);
+
+DEFINE_bool(enable_raft_batch_apply_with_applied_index, true,
+            "enable write applied index with batch apply data in one write batch");
+DEFINE_validator(enable_raft_batch_apply_with_applied_index, &PassBool);
+
+bvar::IntRecorder g_raft_batch_apply_size("dingo_raft_state_machine_batch_apply_size");
+
+DEFINE_bool(enable_raft_apply_arena_parse, true, "enable parse raft log on protobuf arena when follower apply");
+DEFINE_validator(enable_raft_apply_arena_parse, &PassBool);
+
+// Parse raft log on one arena which block is sized by log, so nested messages and fields
+// of big batch (e.g. vector add) are allocated together and freed once with the command.
+static std::shared_ptr<pb::raft::RaftCmdRequest> ParseRaftCmdOnArena(const butil::IOBuf& data) {
+  google::protobuf::ArenaOptions options;
+  options.start_block_size = std::max(data.size() * 2, static_cast<size_t>(4096));
+  options.max_block_size = std::max(options.start_block_size, options.max_block_size);
+  auto* arena = new google::protobuf::Arena(options);
+
+  auto* raft_cmd = google::protobuf::Arena::CreateMessage<pb::raft::RaftCmdRequest>(arena);
+  CHECK(RaftCmdCodec::Decode(data, raft_cmd));
+
+  // Message is owned by arena, release arena when the last holder drop the command.
+  return std::shared_ptr<pb::raft::RaftCmdRequest>(raft_cmd, [arena](pb::raft::RaftCmdRequest*) { delete arena; });
+}
+
 StoreStateMachine::StoreStateMachine(RawEnginePtr engine, store::RegionPtr region, store::RaftMetaPtr raft_meta,
                                      store::RegionMetricsPtr region_metrics, EventListenerCollectionPtr listeners,
                                      WorkerSetPtr worker_set)
@@ -52,6 +89,12 @@ StoreStateMachine::StoreStateMachine(RawEnginePtr engine, store::RegionPtr regio
       last_snapshot_index_(0),
       worker_set_(worker_set) {
   bthread_mutex_init(&apply_mutex_, nullptr);
+  if (listeners_ != nullptr) {
+    const auto& apply_listeners = listeners_->Get(EventType::kSmApply);
+    if (apply_listeners.size() == 1) {
+      apply_listener_ = std::dynamic_pointer_cast<SmApplyEventListener>(apply_listeners[0]);
+    }
+  }
   DINGO_LOG(DEBUG) << fmt::format("[new.StoreStateMachine][id({})]", str_node_id_);
 }
 
@@ -78,6 +121,50 @@ void DoDispatchEvent(int64_t region_id, EventListenerCollectionPtr listeners, di
   }
 }
 
+// Fast path of apply event, call built-in apply listener directly.
+void DoDispatchApplyEvent(int64_t region_id, std::shared_ptr<SmApplyEventListener> apply_listener,
+                          EventListenerCollectionPtr listeners, std::shared_ptr<SmApplyEvent> event,
+                          BthreadCondPtr cond) {
+  if (apply_listener == nullptr) {
+    DoDispatchEvent(region_id, listeners, EventType::kSmApply, event, cond);
+    return;
+  }
+
+  DEFER(if (BAIDU_LIKELY(cond != nullptr)) { cond->DecreaseSignal(); });
+
+  int ret = apply_listener->Apply(*event);
+  if (ret != 0) {
+    DINGO_LOG(FATAL) << fmt::format("[raft.sm][region({})] dispatch apply event failed, ret: {}", region_id, ret);
+  }
+}
+
+std::shared_ptr<SmApplyEvent> StoreStateMachine::NewApplyEvent() {
+  if (apply_listener_ == nullptr) {
+    return std::make_shared<SmApplyEvent>();
+  }
+
+  if (apply_event_ == nullptr) {
+    apply_event_ = std::make_shared<SmApplyEvent>();
+  }
+  return apply_event_;
+}
+
+void StoreStateMachine::ReleaseApplyEvent() {
+  if (apply_event_ != nullptr) {
+    apply_event_->done = nullptr;
+    apply_event_->raft_cmd = nullptr;
+    apply_event_->ctx = nullptr;
+  }
+}
+
+int StoreStateMachine::DispatchApplyEvent(std::shared_ptr<SmApplyEvent> event) {
+  if (apply_listener_ != nullptr) {
+    return apply_listener_->Apply(*event);
+  }
+
+  return DispatchEvent(EventType::kSmApply, event);
+}
+
 int StoreStateMachine::DispatchEvent(dingodb::EventType event_type, std::shared_ptr<dingodb::Event> event) {
   if (listeners_ == nullptr) return -1;
 
@@ -91,9 +178,96 @@ int StoreStateMachine::DispatchEvent(dingodb::EventType event_type, std::shared_
   return 0;
 }
 
+void StoreStateMachine::AdvanceAppliedIndex(int64_t term, int64_t index, bool is_persisted) {
+  applied_term_ = term;
+  applied_index_ = index;
+  raft_meta_->SetTermAndAppliedId(applied_term_, applied_index_);
+
+  // bvar metrics
+  StoreBvarMetrics::GetInstance().IncApplyCountPerSecond(str_node_id_);
+
+  // Persistence applied index
+  // If operation is idempotent, it's ok.
+  // If not, must be stored with the data.
+  if (!is_persisted && applied_index_ % kSaveAppliedIndexStep == 0) {
+    Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->UpdateRaftMeta(raft_meta_);
+  }
+}
+
+void StoreStateMachine::FlushBatchApply(std::vector<BatchApplyEntry>& batch_entries) {
+  if (batch_entries.empty()) {
+    return;
+  }
+
+  g_raft_batch_apply_size << batch_entries.size();
+
+  auto event = std::make_shared<SmBatchApplyEvent>();
+  event->region = region_;
+  event->engine = raw_engine_;
+  event->region_metrics = region_metrics_;
+  event->entries.reserve(batch_entries.size());
+  for (const auto& batch_entry : batch_entries) {
+    event->entries.push_back(BatchPutHandler::Entry{batch_entry.ctx, batch_entry.raft_cmd});
+  }
+
+  // Meta column family is in rocksdb raw engine, applied index is persisted atomically with data only when
+  // data is in the same engine, then no log in batch is applied again after restart.
+  bool is_persisted = FLAGS_enable_raft_batch_apply_with_applied_index &&
+                      raw_engine_->GetRawEngineType() == pb::common::RAW_ENG_ROCKSDB;
+  if (is_persisted) {
+    const auto& last_entry = batch_entries.back();
+    event->raft_meta_kvs.push_back(
+        Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->GenAppliedRaftMetaKv(
+            raft_meta_, last_entry.term, last_entry.index));
+  }
+
+  if (BAIDU_LIKELY(worker_set_ != nullptr)) {
+    // Run in queue.
+    auto cond = std::make_shared<BthreadCond>();
+
+    auto task = DispatchEventTask::New([this, event, cond, &batch_entries]() {
+      for (const auto& batch_entry : batch_entries) {
+        if (batch_entry.tracker != nullptr) {
+          batch_entry.tracker->SetRaftQueueWaitTime();
+        }
+      }
+      DoDispatchEvent(region_->Id(), listeners_, EventType::kSmBatchApply, event, cond);
+    });
+
+    bool ret = worker_set_->ExecuteHashByRegionId(region_->Id(), task);
+    if (BAIDU_UNLIKELY(!ret)) {
+      DINGO_LOG(FATAL) << fmt::format(
+          "[raft.sm][region({})] execute batch apply task failed, downgrade to in_place execute", region_->Id());
+      DispatchEvent(EventType::kSmBatchApply, event);
+    } else {
+      cond->IncreaseWait();
+    }
+  } else {
+    DispatchEvent(EventType::kSmBatchApply, event);
+  }
+
+  // Complete closure by log order.
+  for (auto& batch_entry : batch_entries) {
+    if (batch_entry.tracker != nullptr) {
+      batch_entry.tracker->SetRaftApplyTime();
+    }
+
+    AdvanceAppliedIndex(batch_entry.term, batch_entry.index, is_persisted);
+
+    if (batch_entry.done != nullptr) {
+      braft::run_closure_in_bthread(batch_entry.done);
+    }
+  }
+
+  batch_entries.clear();
+}
+
 void StoreStateMachine::on_apply(braft::Iterator& iter) {
   BAIDU_SCOPED_LOCK(apply_mutex_);
 
+  // Consecutive put/delete batch logs, apply with one write batch.
+  std::vector<BatchApplyEntry> batch_entries;
+
   for (; iter.valid(); iter.next()) {
     braft::AsyncClosureGuard done_guard(iter.done());
 
@@ -108,6 +282,10 @@ void StoreStateMachine::on_apply(braft::Iterator& iter) {
       tracker->SetRaftCommitTime();
     }
 
+    if (BAIDU_UNLIKELY(region_->State() != pb::common::StoreRegionState::NORMAL)) {
+      FlushBatchApply(batch_entries);
+    }
+
     // Region is STANDBY state, wait to apply.
     while (BAIDU_UNLIKELY(region_->State() == pb::common::StoreRegionState::STANDBY)) {
       DINGO_LOG(WARNING) << fmt::format("[raft.sm][region({})] region is standby for spliting, waiting...",
@@ -124,13 +302,15 @@ void StoreStateMachine::on_apply(braft::Iterator& iter) {
       return;
     }
     // Parse raft command
-    auto raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
+    std::shared_ptr<pb::raft::RaftCmdRequest> raft_cmd;
     if (iter.done()) {
       BaseClosure* store_closure = dynamic_cast<BaseClosure*>(iter.done());
       raft_cmd = store_closure->GetRequest();
+    } else if (FLAGS_enable_raft_apply_arena_parse) {
+      raft_cmd = ParseRaftCmdOnArena(iter.data());
     } else {
-      butil::IOBufAsZeroCopyInputStream wrapper(iter.data());
-      CHECK(raft_cmd->ParseFromZeroCopyStream(&wrapper));
+      raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
+      CHECK(RaftCmdCodec::Decode(iter.data(), raft_cmd.get()));
     }
 
     // update apply max ts
@@ -172,9 +352,21 @@ void StoreStateMachine::on_apply(braft::Iterator& iter) {
         iter.index(), applied_index_,
         raft_cmd->requests().empty() ? "" : pb::raft::CmdType_Name(raft_cmd->requests().at(0).cmd_type()));
 
+    if (need_apply && FLAGS_enable_raft_batch_apply && BatchPutHandler::IsBatchable(*raft_cmd)) {
+      batch_entries.push_back(
+          BatchApplyEntry{done_guard.release(), ctx, raft_cmd, tracker, iter.term(), iter.index()});
+      if (batch_entries.size() >= FLAGS_raft_batch_apply_max_count) {
+        FlushBatchApply(batch_entries);
+      }
+      continue;
+    }
+
+    // Keep apply order.
+    FlushBatchApply(batch_entries);
+
     if (BAIDU_LIKELY(need_apply)) {
       // Build event
-      auto event = std::make_shared<SmApplyEvent>();
+      auto event = NewApplyEvent();
       event->region = region_;
       event->engine = raw_engine_;
       event->done = iter.done();
@@ -187,44 +379,35 @@ void StoreStateMachine::on_apply(braft::Iterator& iter) {
         // Run in queue.
         auto cond = std::make_shared<BthreadCond>();
 
-        auto task = std::make_shared<DispatchEventTask>([this, event, cond, tracker]() {
+        auto task = DispatchEventTask::New([this, event, cond, tracker]() {
           if (tracker != nullptr) {
             tracker->SetRaftQueueWaitTime();
           }
-          DoDispatchEvent(region_->Id(), listeners_, EventType::kSmApply, event, cond);
+          DoDispatchApplyEvent(region_->Id(), apply_listener_, listeners_, event, cond);
         });
 
-        bool ret = worker_set_->ExecuteRR(task);
+        bool ret = worker_set_->ExecuteHashByRegionId(region_->Id(), task);
         if (BAIDU_UNLIKELY(!ret)) {
           DINGO_LOG(FATAL) << fmt::format(
               "[raft.sm][region({})] execute apply task failed, downgrade to in_place execute", region_->Id());
-          DispatchEvent(EventType::kSmApply, event);
+          DispatchApplyEvent(event);
         } else {
           cond->IncreaseWait();
         }
       } else {
-        DispatchEvent(EventType::kSmApply, event);
+        DispatchApplyEvent(event);
       }
+      ReleaseApplyEvent();
     }
 
     if (tracker != nullptr) {
       tracker->SetRaftApplyTime();
     }
 
-    applied_term_ = iter.term();
-    applied_index_ = iter.index();
-    raft_meta_->SetTermAndAppliedId(applied_term_, applied_index_);
-
-    // bvar metrics
-    StoreBvarMetrics::GetInstance().IncApplyCountPerSecond(str_node_id_);
-
-    // Persistence applied index
-    // If operation is idempotent, it's ok.
-    // If not, must be stored with the data.
-    if (applied_index_ % kSaveAppliedIndexStep == 0) {
-      Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->UpdateRaftMeta(raft_meta_);
-    }
+    AdvanceAppliedIndex(iter.term(), iter.index());
   }
+
+  FlushBatchApply(batch_entries);
 }
 
 int32_t StoreStateMachine::CatchUpApplyLog(const std::vector<pb::raft::LogEntry>& entries) {
@@ -248,7 +431,7 @@ int32_t StoreStateMachine::CatchUpApplyLog(const std::vector<pb::raft::LogEntry>
       }
 
       auto raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
-      CHECK(raft_cmd->ParsePartialFromArray(entry.data().data(), entry.data().size()));
+      CHECK(RaftCmdCodec::Decode(entry.data(), raft_cmd.get()));
 
       DINGO_LOG(INFO) << fmt::format(
           "[raft.sm][region({}).epoch({})] apply log {}:{} applied_index({}) cmd_type({})",
@@ -256,7 +439,7 @@ int32_t StoreStateMachine::CatchUpApplyLog(const std::vector<pb::raft::LogEntry>
           entry.index(), applied_index_,
           raft_cmd->requests().empty() ? "" : pb::raft::CmdType_Name(raft_cmd->requests().at(0).cmd_type()));
 
-      auto event = std::make_shared<SmApplyEvent>();
+      auto event = NewApplyEvent();
       event->region = region_;
       event->engine = raw_engine_;
       event->raft_cmd = raft_cmd;
@@ -264,7 +447,8 @@ int32_t StoreStateMachine::CatchUpApplyLog(const std::vector<pb::raft::LogEntry>
       event->term_id = entry.term();
       event->log_id = entry.index();
 
-      DispatchEvent(EventType::kSmApply, event);
+      DispatchApplyEvent(event);
+      ReleaseApplyEvent();
 
       applied_term_ = entry.term();
       applied_index_ = entry.index();
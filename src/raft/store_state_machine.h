@@ -16,11 +16,14 @@
 #define DINGODB_RAFT_STATE_MACHINE_H_
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "braft/raft.h"
+#include "common/context.h"
 #include "common/runnable.h"
+#include "common/tracker.h"
 #include "engine/raw_engine.h"
 #include "event/event.h"
 #include "meta/store_meta_manager.h"
@@ -31,13 +34,19 @@
 namespace dingodb {
 
 struct SnapshotContext;
+struct SmApplyEvent;
+class SmApplyEventListener;
 
 class DispatchEventTask : public TaskRunnable {
  public:
-  using Handler = std::function<void(void)>;
-  DispatchEventTask(Handler handle) : handle_(handle) {}
+  using Handler = TaskHandler;
+  DispatchEventTask(Handler handle) : handle_(std::move(handle)) {}
   ~DispatchEventTask() override = default;
 
+  static std::shared_ptr<DispatchEventTask> New(Handler handle) {
+    return NewTask<DispatchEventTask>(std::move(handle));
+  }
+
   std::string Type() override { return "STATE_MACHINE_TASK"; }
 
   void Run() override { handle_(); }
@@ -80,13 +89,39 @@ class StoreStateMachine : public BaseStateMachine {
   std::shared_ptr<SnapshotContext> MakeSnapshotContext();
 
  private:
+  struct BatchApplyEntry {
+    google::protobuf::Closure* done{nullptr};
+    std::shared_ptr<Context> ctx;
+    std::shared_ptr<pb::raft::RaftCmdRequest> raft_cmd;
+    TrackerPtr tracker;
+    int64_t term{0};
+    int64_t index{0};
+  };
+
   int DispatchEvent(dingodb::EventType, std::shared_ptr<dingodb::Event> event);
 
+  // Must hold apply_mutex_.
+  // Reuse one apply event when only the built-in apply listener, which not keep event after apply.
+  std::shared_ptr<SmApplyEvent> NewApplyEvent();
+  // Must hold apply_mutex_.
+  // Release raft cmd and closure of reused apply event.
+  void ReleaseApplyEvent();
+  int DispatchApplyEvent(std::shared_ptr<SmApplyEvent> event);
+
+  // Must hold apply_mutex_.
+  // is_persisted: applied index is already written with data, skip periodic persistence.
+  void AdvanceAppliedIndex(int64_t term, int64_t index, bool is_persisted = false);
+  // Apply batch entries in one dispatch, then complete closures by log order.
+  void FlushBatchApply(std::vector<BatchApplyEntry>& batch_entries);
+
   std::string str_node_id_;
   store::RegionPtr region_;
 
   RawEnginePtr raw_engine_;
   EventListenerCollectionPtr listeners_;
+  // Built-in apply listener called without virtual dispatch, set when it is the only apply listener.
+  std::shared_ptr<SmApplyEventListener> apply_listener_;
+  std::shared_ptr<SmApplyEvent> apply_event_;
 
   int64_t applied_term_;
   int64_t applied_index_;
@@ -18,30 +18,41 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
+#include "bthread/bthread.h"
 #include "bthread/mutex.h"
 #include "butil/compiler_specific.h"
 #include "butil/macros.h"     // IWYU pragma: keep
+#include "bvar/reducer.h"
 #include "common/constant.h"  // IWYU pragma: keep
+#include "common/gflag_validator.h"
 #include "common/helper.h"    // IWYU pragma: keep
 #include "common/logging.h"
 #include "coprocessor/coprocessor.h"
 #include "coprocessor/coprocessor_v2.h"
 #include "coprocessor/utils.h"
 #include "engine/write_data.h"  // IWYU pragma: keep
+#include "gflags/gflags.h"
 #include "mvcc/codec.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "scan/scan_filter.h"
-#if defined(ENABLE_SCAN_OPTIMIZATION)
-#include "bthread/bthread.h"
-#endif
 
 namespace dingodb {
 
+DEFINE_bool(enable_scan_prefetch, true, "fetch next batch of scan in background before client continue");
+DEFINE_validator(enable_scan_prefetch, &PassBool);
+DEFINE_int64(scan_readahead_bytes, 1 * 1024 * 1024, "readahead of scan iterator, 0 is adaptive readahead");
+BRPC_VALIDATE_GFLAG(scan_readahead_bytes, brpc::NonNegativeInteger);
+
+bvar::Adder<int64_t> g_scan_prefetch_count("dingo_scan_prefetch_count");
+bvar::Adder<int64_t> g_scan_prefetch_hit_count("dingo_scan_prefetch_hit_count");
+
 ScanContext::ScanContext(bvar::LatencyRecorder* scan_latency)
     : region_id_(0),
       max_fetch_cnt_(0),
@@ -154,8 +165,8 @@ butil::Status ScanContext::GetKeyValue(std::vector<pb::common::KeyValue>& kvs, b
       kv.mutable_value()->swap(value);
     }
 
-    kvs.emplace_back(kv);
-    if (scan_filter.UptoLimit(kv)) {
+    kvs.emplace_back(std::move(kv));
+    if (scan_filter.UptoLimit(kvs.back())) {
       has_more = true;
       iter_->Next();
       break;
@@ -167,6 +178,73 @@ butil::Status ScanContext::GetKeyValue(std::vector<pb::common::KeyValue>& kvs, b
   return butil::Status();
 }
 
+butil::Status ScanContext::TakeKeyValue(std::vector<pb::common::KeyValue>& kvs, bool& has_more) {
+  if (!has_prefetch_) {
+    return GetKeyValue(kvs, has_more);
+  }
+
+  if (!prefetch_status_.ok()) {
+    has_prefetch_ = false;
+    return prefetch_status_;
+  }
+
+  // prefetch used fetch count of last request, return no more than this request want.
+  size_t count = std::min(prefetch_kvs_.size() - prefetch_offset_,
+                          static_cast<size_t>(std::min(max_fetch_cnt_, max_fetch_cnt_by_server_)));
+  kvs.reserve(kvs.size() + count);
+  for (size_t i = 0; i < count; ++i) {
+    kvs.push_back(std::move(prefetch_kvs_[prefetch_offset_ + i]));
+  }
+  prefetch_offset_ += count;
+  g_scan_prefetch_hit_count << 1;
+
+  if (prefetch_offset_ < prefetch_kvs_.size()) {
+    has_more = true;
+    return butil::Status();
+  }
+
+  has_more = prefetch_has_more_;
+  has_prefetch_ = false;
+  prefetch_kvs_.clear();
+  prefetch_offset_ = 0;
+  return butil::Status();
+}
+
+void ScanContext::StartPrefetch(std::shared_ptr<ScanContext> context) {
+  if (!FLAGS_enable_scan_prefetch || context->has_prefetch_) {
+    return;
+  }
+
+  context->prefetch_cond_.Increase();
+  auto* call = new std::function<void()>([context]() {
+    context->prefetch_kvs_.clear();
+    context->prefetch_offset_ = 0;
+    context->prefetch_has_more_ = false;
+    context->prefetch_status_ = context->GetKeyValue(context->prefetch_kvs_, context->prefetch_has_more_);
+    context->has_prefetch_ = true;
+    context->prefetch_cond_.DecreaseSignal();
+  });
+
+  bthread_t tid;
+  int ret = bthread_start_background(
+      &tid, nullptr,
+      [](void* arg) -> void* {
+        auto* call = static_cast<std::function<void()>*>(arg);
+        (*call)();
+        delete call;
+        return nullptr;
+      },
+      call);
+  if (ret != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[scan][scan_id({})] start prefetch failed, ret: {}", context->scan_id_, ret);
+    delete call;
+    context->prefetch_cond_.DecreaseSignal();
+    return;
+  }
+
+  g_scan_prefetch_count << 1;
+}
+
 #if defined(ENABLE_SCAN_OPTIMIZATION)
 butil::Status ScanContext::AsyncWork() {
   auto lambda_call = [this]() {
@@ -423,8 +501,11 @@ butil::Status ScanHandler::ScanBegin(std::shared_ptr<ScanContext> context, int64
 
   auto encode_range = mvcc::Codec::EncodeRange(range);
 
+  // scan context always read range sequentially batch by batch, and next batch is prefetched.
   IteratorOptions options;
   options.upper_bound = encode_range.end_key();
+  options.readahead_size = FLAGS_scan_readahead_bytes;
+  options.scan_class = context->disable_coprocessor_ ? ScanClass::kScan : ScanClass::kCoprocessor;
 
   context->iter_ = context->reader_->NewIterator(context->cf_name_, context->ts_, options);
   if (!context->iter_) {
@@ -442,6 +523,10 @@ butil::Status ScanHandler::ScanBegin(std::shared_ptr<ScanContext> context, int64
       return s;
     }
 
+    if (has_more) {
+      ScanContext::StartPrefetch(context);
+    }
+
 #if defined(ENABLE_SCAN_OPTIMIZATION)
     context->seek_state_ = ScanContext::SeekState::kInitted;
 #endif
@@ -498,17 +583,24 @@ butil::Status ScanHandler::ScanContinue(std::shared_ptr<ScanContext> context, co
   }
 #endif
 
+  // iterator and fetch count are used by prefetch until it is done.
+  context->prefetch_cond_.Wait(0);
+
   context->max_fetch_cnt_ = max_fetch_cnt;
 
   context->state_ = ScanState::kContinuing;
 
-  s = context->GetKeyValue(*kvs, has_more);
+  s = context->TakeKeyValue(*kvs, has_more);
   if (!s.ok()) {
     context->state_ = ScanState::kError;
     DINGO_LOG(ERROR) << fmt::format("ScanContext::GetKeyValue failed");
     return s;
   }
 
+  if (has_more) {
+    ScanContext::StartPrefetch(context);
+  }
+
   context->state_ = ScanState::kContinued;
   context->last_time_ms_ = context->GetCurrentTime();
 
@@ -23,6 +23,7 @@
 
 #include "bthread/types.h"
 #include "butil/status.h"
+#include "common/synchronization.h"
 #include "coprocessor/raw_coprocessor.h"
 #include "engine/iterator.h"
 #include "mvcc/reader.h"
@@ -85,6 +86,10 @@ class ScanContext {
   void Close();
   static std::chrono::milliseconds GetCurrentTime();
   butil::Status GetKeyValue(std::vector<pb::common::KeyValue>& kvs, bool& has_more);  // NOLINT
+  // get next batch from prefetched kvs if there is, otherwise from iterator. caller wait prefetch done.
+  butil::Status TakeKeyValue(std::vector<pb::common::KeyValue>& kvs, bool& has_more);  // NOLINT
+  // fetch next batch in background while client is handling current batch.
+  static void StartPrefetch(std::shared_ptr<ScanContext> context);
 #if defined(ENABLE_SCAN_OPTIMIZATION)
   butil::Status AsyncWork();
   void WaitForReady();
@@ -145,6 +150,14 @@ class ScanContext {
 
   bvar::LatencyRecorder* scan_latency_;
   BvarLatencyGuard bvar_guard_;
+
+  // prefetch of next batch, count of cond is 1 when prefetch is running.
+  BthreadCond prefetch_cond_;
+  bool has_prefetch_{false};
+  std::vector<pb::common::KeyValue> prefetch_kvs_;
+  size_t prefetch_offset_{0};
+  bool prefetch_has_more_{false};
+  butil::Status prefetch_status_;
 };
 
 class ScanContextV1 : public ScanContext {
@@ -0,0 +1,109 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "server/arena_message_factory.h"
+
+#ifdef DINGODB_HAS_RPC_PB_MESSAGE_FACTORY
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "common/helper.h"
+#include "gflags/gflags.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/service.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_rpc_arena, true, "allocate request and response of hot service on protobuf arena");
+DEFINE_string(rpc_arena_services, "dingodb.pb.store.StoreService,dingodb.pb.index.IndexService,"
+              "dingodb.pb.document.DocumentService", "full name of services use arena, split by comma");
+DEFINE_int64(rpc_arena_start_block_size, 4096, "first block size of rpc arena");
+DEFINE_int64(rpc_arena_max_block_size, 1024 * 1024, "max block size of rpc arena");
+
+class HeapRpcPBMessages : public brpc::RpcPBMessages {
+ public:
+  HeapRpcPBMessages(const google::protobuf::Service& service, const google::protobuf::MethodDescriptor& method)
+      : request_(service.GetRequestPrototype(&method).New()), response_(service.GetResponsePrototype(&method).New()) {}
+  ~HeapRpcPBMessages() override = default;
+
+  google::protobuf::Message* Request() override { return request_.get(); }
+  google::protobuf::Message* Response() override { return response_.get(); }
+
+ private:
+  std::unique_ptr<google::protobuf::Message> request_;
+  std::unique_ptr<google::protobuf::Message> response_;
+};
+
+class ArenaRpcPBMessages : public brpc::RpcPBMessages {
+ public:
+  ArenaRpcPBMessages(const google::protobuf::Service& service, const google::protobuf::MethodDescriptor& method)
+      : arena_(GenArenaOptions()) {
+    // messages are owned by arena, destroyed with it.
+    request_ = service.GetRequestPrototype(&method).New(&arena_);
+    response_ = service.GetResponsePrototype(&method).New(&arena_);
+  }
+  ~ArenaRpcPBMessages() override = default;
+
+  google::protobuf::Message* Request() override { return request_; }
+  google::protobuf::Message* Response() override { return response_; }
+
+ private:
+  static google::protobuf::ArenaOptions GenArenaOptions() {
+    google::protobuf::ArenaOptions options;
+    options.start_block_size = FLAGS_rpc_arena_start_block_size;
+    options.max_block_size = FLAGS_rpc_arena_max_block_size;
+    return options;
+  }
+
+  google::protobuf::Arena arena_;
+  google::protobuf::Message* request_{nullptr};
+  google::protobuf::Message* response_{nullptr};
+};
+
+class ArenaRpcPBMessageFactory : public brpc::RpcPBMessageFactory {
+ public:
+  ArenaRpcPBMessageFactory() {
+    std::vector<std::string> services;
+    Helper::SplitString(FLAGS_rpc_arena_services, ',', services);
+    arena_services_.insert(services.begin(), services.end());
+  }
+  ~ArenaRpcPBMessageFactory() override = default;
+
+  brpc::RpcPBMessages* Get(const google::protobuf::Service& service,
+                           const google::protobuf::MethodDescriptor& method) override {
+    if (FLAGS_enable_rpc_arena && arena_services_.count(method.service()->full_name()) > 0) {
+      return new ArenaRpcPBMessages(service, method);
+    }
+    return new HeapRpcPBMessages(service, method);
+  }
+
+  void Return(brpc::RpcPBMessages* messages) override { delete messages; }
+
+ private:
+  // not changed after created.
+  std::unordered_set<std::string> arena_services_;
+};
+
+brpc::RpcPBMessageFactory* NewArenaRpcPBMessageFactory() { return new ArenaRpcPBMessageFactory(); }
+
+}  // namespace dingodb
+
+#endif  // DINGODB_HAS_RPC_PB_MESSAGE_FACTORY
@@ -0,0 +1,36 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_ARENA_MESSAGE_FACTORY_H_
+#define DINGODB_ARENA_MESSAGE_FACTORY_H_
+
+#if __has_include("brpc/rpc_pb_message_factory.h")
+#define DINGODB_HAS_RPC_PB_MESSAGE_FACTORY 1
+#include "brpc/rpc_pb_message_factory.h"
+#endif
+
+namespace dingodb {
+
+#ifdef DINGODB_HAS_RPC_PB_MESSAGE_FACTORY
+// Request and response of hot service are allocated on one protobuf arena per rpc, the whole message graph
+// e.g. kvs, vectors and search results is freed in one operation when rpc is done.
+// Other service still use heap message. Server own the factory, every server need a new one.
+// Only available when brpc support custom message factory, otherwise server use default heap message.
+brpc::RpcPBMessageFactory* NewArenaRpcPBMessageFactory();
+#endif
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ARENA_MESSAGE_FACTORY_H_
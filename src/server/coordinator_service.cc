@@ -115,7 +115,7 @@ void CoordinatorServiceImpl::Hello(google::protobuf::RpcController *controller,
 
     // Run in queue.
     auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-    auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+    auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
       DoCoordinatorHello(controller, request, response, svr_done, coordinator_control_, engine_,
                          request->get_memory_info());
     });
@@ -167,7 +167,7 @@ void CoordinatorServiceImpl::GetMemoryInfo(google::protobuf::RpcController *cont
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCoordinatorHello(controller, request, response, svr_done, coordinator_control_, engine_, true);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2525,7 +2525,7 @@ void CoordinatorServiceImpl::CreateExecutor(google::protobuf::RpcController *con
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCreateExecutor(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2555,7 +2555,7 @@ void CoordinatorServiceImpl::DeleteExecutor(google::protobuf::RpcController *con
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDeleteExecutor(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2580,7 +2580,7 @@ void CoordinatorServiceImpl::CreateExecutorUser(google::protobuf::RpcController
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCreateExecutorUser(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2605,7 +2605,7 @@ void CoordinatorServiceImpl::UpdateExecutorUser(google::protobuf::RpcController
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoUpdateExecutorUser(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2630,7 +2630,7 @@ void CoordinatorServiceImpl::DeleteExecutorUser(google::protobuf::RpcController
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDeleteExecutorUser(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2655,7 +2655,7 @@ void CoordinatorServiceImpl::GetExecutorUserMap(google::protobuf::RpcController
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetExecutorUserMap(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2680,7 +2680,7 @@ void CoordinatorServiceImpl::CreateStore(google::protobuf::RpcController *contro
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCreateStore(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2711,7 +2711,7 @@ void CoordinatorServiceImpl::DeleteStore(google::protobuf::RpcController *contro
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDeleteStore(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2736,7 +2736,7 @@ void CoordinatorServiceImpl::UpdateStore(google::protobuf::RpcController *contro
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoUpdateStore(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2783,7 +2783,7 @@ void CoordinatorServiceImpl::ExecutorHeartbeat(google::protobuf::RpcController *
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoExecutorHeartbeat(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2798,6 +2798,10 @@ void CoordinatorServiceImpl::StoreHeartbeat(google::protobuf::RpcController *con
                                             pb::coordinator::StoreHeartbeatResponse *response,
                                             google::protobuf::Closure *done) {
   brpc::ClosureGuard done_guard(done);
+  // response store map may be large, compress it same as request.
+  auto *cntl = static_cast<brpc::Controller *>(controller);
+  cntl->set_response_compress_type(cntl->request_compress_type());
+
   auto is_leader = coordinator_control_->IsLeader();
   DINGO_LOG(DEBUG) << "Receive Store Heartbeat Request, IsLeader:" << is_leader
                    << ", Request:" << request->ShortDebugString();
@@ -2823,7 +2827,7 @@ void CoordinatorServiceImpl::StoreHeartbeat(google::protobuf::RpcController *con
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoStoreHeartbeat(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2850,7 +2854,7 @@ void CoordinatorServiceImpl::GetStoreMap(google::protobuf::RpcController *contro
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetStoreMap(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2875,7 +2879,7 @@ void CoordinatorServiceImpl::GetStoreMetrics(google::protobuf::RpcController *co
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetStoreMetrics(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2898,7 +2902,7 @@ void CoordinatorServiceImpl::GetStoreOwnMetrics(google::protobuf::RpcController
   }
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetStoreOwnMetrics(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2923,7 +2927,7 @@ void CoordinatorServiceImpl::DeleteStoreMetrics(google::protobuf::RpcController
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDeleteStoreMetrics(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2948,7 +2952,7 @@ void CoordinatorServiceImpl::GetRegionMetrics(google::protobuf::RpcController *c
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetRegionMetrics(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2973,7 +2977,7 @@ void CoordinatorServiceImpl::DeleteRegionMetrics(google::protobuf::RpcController
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDeleteRegionMetrics(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3000,7 +3004,7 @@ void CoordinatorServiceImpl::GetExecutorMap(google::protobuf::RpcController *con
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetExecutorMap(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3027,7 +3031,7 @@ void CoordinatorServiceImpl::GetRegionMap(google::protobuf::RpcController *contr
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetRegionMap(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3054,7 +3058,7 @@ void CoordinatorServiceImpl::GetDeletedRegionMap(google::protobuf::RpcController
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetDeletedRegionMap(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3081,7 +3085,7 @@ void CoordinatorServiceImpl::AddDeletedRegionMap(google::protobuf::RpcController
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoAddDeletedRegionMap(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3108,7 +3112,7 @@ void CoordinatorServiceImpl::CleanDeletedRegionMap(google::protobuf::RpcControll
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCleanDeletedRegionMap(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3135,7 +3139,7 @@ void CoordinatorServiceImpl::GetRegionCount(google::protobuf::RpcController *con
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetRegionCount(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3154,7 +3158,7 @@ void CoordinatorServiceImpl::GetCoordinatorMap(google::protobuf::RpcController *
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetCoordinatorMap(controller, request, response, svr_done, coordinator_control_, kv_control_, tso_control_,
                         auto_increment_control_, engine_);
   });
@@ -3180,7 +3184,7 @@ void CoordinatorServiceImpl::ConfigCoordinator(google::protobuf::RpcController *
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoConfigCoordinator(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3205,7 +3209,7 @@ void CoordinatorServiceImpl::CreateRegionId(google::protobuf::RpcController *con
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCreateRegionId(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3222,14 +3226,14 @@ void CoordinatorServiceImpl::QueryRegion(google::protobuf::RpcController *contro
   brpc::ClosureGuard done_guard(done);
   DINGO_LOG(DEBUG) << "Receive Query Region Request:" << request->ShortDebugString();
 
-  auto is_leader = coordinator_control_->IsLeader();
+  auto is_leader = coordinator_control_->CanServeRead();
   if (!is_leader) {
     return coordinator_control_->RedirectResponse(response);
   }
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoQueryRegion(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3303,7 +3307,7 @@ void CoordinatorServiceImpl::CreateRegion(google::protobuf::RpcController *contr
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCreateRegion(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3327,7 +3331,7 @@ void CoordinatorServiceImpl::DropRegion(google::protobuf::RpcController *control
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDropRegion(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3351,7 +3355,7 @@ void CoordinatorServiceImpl::DropRegionPermanently(google::protobuf::RpcControll
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDropRegionPermanently(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3375,7 +3379,7 @@ void CoordinatorServiceImpl::SplitRegion(google::protobuf::RpcController *contro
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoSplitRegion(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3399,7 +3403,7 @@ void CoordinatorServiceImpl::MergeRegion(google::protobuf::RpcController *contro
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoMergeRegion(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3423,7 +3427,7 @@ void CoordinatorServiceImpl::ChangePeerRegion(google::protobuf::RpcController *c
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoChangePeerRegion(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3447,7 +3451,7 @@ void CoordinatorServiceImpl::TransferLeaderRegion(google::protobuf::RpcControlle
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTransferLeaderRegion(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3471,7 +3475,7 @@ void CoordinatorServiceImpl::GetOrphanRegion(google::protobuf::RpcController *co
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetOrphanRegion(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3497,7 +3501,7 @@ void CoordinatorServiceImpl::GetStoreOperation(google::protobuf::RpcController *
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetStoreOperation(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3521,7 +3525,7 @@ void CoordinatorServiceImpl::CleanStoreOperation(google::protobuf::RpcController
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCleanStoreOperation(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3545,7 +3549,7 @@ void CoordinatorServiceImpl::AddStoreOperation(google::protobuf::RpcController *
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoAddStoreOperation(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3569,7 +3573,7 @@ void CoordinatorServiceImpl::RemoveStoreOperation(google::protobuf::RpcControlle
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoRemoveStoreOperation(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3593,7 +3597,7 @@ void CoordinatorServiceImpl::GetRegionCmd(google::protobuf::RpcController *contr
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetRegionCmd(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3619,7 +3623,7 @@ void CoordinatorServiceImpl::GetJobList(google::protobuf::RpcController *control
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetJobList(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3644,7 +3648,7 @@ void CoordinatorServiceImpl::CleanJobList(google::protobuf::RpcController *contr
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCleanJobList(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3664,7 +3668,7 @@ void CoordinatorServiceImpl::RaftControl(google::protobuf::RpcController *contro
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoRaftControl(controller, request, response, svr_done, coordinator_control_, kv_control_, tso_control_,
                   auto_increment_control_, engine_);
   });
@@ -3688,14 +3692,14 @@ void CoordinatorServiceImpl::ScanRegions(google::protobuf::RpcController *contro
     return;
   }
 
-  auto is_leader = coordinator_control_->IsLeader();
+  auto is_leader = coordinator_control_->CanServeRead();
   if (!is_leader) {
     return coordinator_control_->RedirectResponse(response);
   }
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoScanRegions(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3718,7 +3722,7 @@ void CoordinatorServiceImpl::GetRangeRegionMap(google::protobuf::RpcController *
   }
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetRangeRegionMap(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3741,7 +3745,7 @@ void CoordinatorServiceImpl::UpdateGCSafePoint(google::protobuf::RpcController *
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoUpdateGCSafePoint(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3765,7 +3769,7 @@ void CoordinatorServiceImpl::GetGCSafePoint(google::protobuf::RpcController *con
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetGCSafePoint(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3801,7 +3805,7 @@ void CoordinatorServiceImpl::UpdateRegionCmdStatus(google::protobuf::RpcControll
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoUpdateRegionCmdStatus(controller, request, response, svr_done, coordinator_control_, engine_);
   });
 
@@ -3963,7 +3967,7 @@ void CoordinatorServiceImpl::CreateIds(google::protobuf::RpcController *controll
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCreateIds(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -4005,7 +4009,7 @@ void CoordinatorServiceImpl::RegisterBackup(google::protobuf::RpcController *con
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoRegisterBackup(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -4045,7 +4049,7 @@ void CoordinatorServiceImpl::UnRegisterBackup(google::protobuf::RpcController *c
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoUnRegisterBackup(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -4103,7 +4107,7 @@ void CoordinatorServiceImpl::ControlConfig(google::protobuf::RpcController *cont
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoControlConfig(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -4145,7 +4149,7 @@ void CoordinatorServiceImpl::RegisterRestore(google::protobuf::RpcController *co
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoRegisterRestore(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -4184,7 +4188,7 @@ void CoordinatorServiceImpl::UnRegisterRestore(google::protobuf::RpcController *
   DINGO_LOG(DEBUG) << request->ShortDebugString();
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoUnRegisterRestore(controller, request, response, svr_done, coordinator_control_, engine_);
   });
 
@@ -4234,7 +4238,7 @@ void CoordinatorServiceImpl::RegisterBackupStatus(google::protobuf::RpcControlle
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoRegisterBackupStatus(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -4283,7 +4287,7 @@ void CoordinatorServiceImpl::RegisterRestoreStatus(google::protobuf::RpcControll
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoRegisterRestoreStatus(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
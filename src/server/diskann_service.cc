@@ -86,7 +86,7 @@ void DiskAnnServiceImpl::VectorNew(google::protobuf::RpcController* controller,
   auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorNew(handle_, controller, request, response, svr_done);
   });
 
@@ -162,7 +162,7 @@ void DiskAnnServiceImpl::VectorPushData(google::protobuf::RpcController* control
   auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorPushData(handle_, controller, request, response, svr_done);
   });
 
@@ -213,7 +213,7 @@ void DiskAnnServiceImpl::VectorBuild(google::protobuf::RpcController* controller
   auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorBuild(handle_, controller, request, response, svr_done);
   });
 
@@ -264,7 +264,7 @@ void DiskAnnServiceImpl::VectorLoad(google::protobuf::RpcController* controller,
   auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorLoad(handle_, controller, request, response, svr_done);
   });
 
@@ -315,7 +315,7 @@ void DiskAnnServiceImpl::VectorTryLoad(google::protobuf::RpcController* controll
   auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorTryLoad(handle_, controller, request, response, svr_done);
   });
 
@@ -372,7 +372,7 @@ void DiskAnnServiceImpl::VectorSearch(google::protobuf::RpcController* controlle
   auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorSearch(handle_, controller, request, response, svr_done);
   });
 
@@ -423,7 +423,7 @@ void DiskAnnServiceImpl::VectorReset(google::protobuf::RpcController* controller
   auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorReset(handle_, controller, request, response, svr_done);
   });
 
@@ -474,7 +474,7 @@ void DiskAnnServiceImpl::VectorClose(google::protobuf::RpcController* controller
   auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorClose(handle_, controller, request, response, svr_done);
   });
 
@@ -525,7 +525,7 @@ void DiskAnnServiceImpl::VectorDestroy(google::protobuf::RpcController* controll
   auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorDestroy(handle_, controller, request, response, svr_done);
   });
 
@@ -578,7 +578,7 @@ void DiskAnnServiceImpl::VectorStatus(google::protobuf::RpcController* controlle
   auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorStatus(handle_, controller, request, response, svr_done);
   });
 
@@ -629,7 +629,7 @@ void DiskAnnServiceImpl::VectorCount(google::protobuf::RpcController* controller
   auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorCount(handle_, controller, request, response, svr_done);
   });
 
@@ -680,7 +680,7 @@ void DiskAnnServiceImpl::VectorSetNoData(google::protobuf::RpcController* contro
   auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorSetNoData(handle_, controller, request, response, svr_done);
   });
 
@@ -734,7 +734,7 @@ void DiskAnnServiceImpl::VectorSetImportTooMany(google::protobuf::RpcController*
   auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorSetImportTooMany(handle_, controller, request, response, svr_done);
   });
 
@@ -785,7 +785,7 @@ void DiskAnnServiceImpl::VectorDump(google::protobuf::RpcController* controller,
   auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorDump(handle_, controller, request, response, svr_done);
   });
 
@@ -830,7 +830,7 @@ void DiskAnnServiceImpl::VectorDumpAll(google::protobuf::RpcController* controll
   auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorDumpAll(handle_, controller, request, response, svr_done);
   });
 
@@ -24,6 +24,7 @@
 #include "common/constant.h"
 #include "common/context.h"
 #include "common/helper.h"
+#include "common/region_resource.h"
 #include "common/synchronization.h"
 #include "common/version.h"
 #include "document/codec.h"
@@ -107,6 +108,7 @@ void DoDocumentBatchQuery(StoragePtr storage, google::protobuf::RpcController* c
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateDocumentBatchQueryRequest(storage, request, region);
   if (!status.ok()) {
@@ -157,7 +159,7 @@ void DocumentServiceImpl::DocumentBatchQuery(google::protobuf::RpcController* co
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDocumentBatchQuery(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -232,6 +234,7 @@ void DoDocumentSearch(StoragePtr storage, google::protobuf::RpcController* contr
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateDocumentSearchRequest(storage, request, region);
   if (!status.ok()) {
@@ -261,7 +264,7 @@ void DoDocumentSearch(StoragePtr storage, google::protobuf::RpcController* contr
   }
 
   for (auto& document_with_score : document_results) {
-    *(response->add_document_with_scores()) = document_with_score;
+    response->mutable_document_with_scores()->Add(std::move(document_with_score));
   }
 }
 
@@ -281,7 +284,7 @@ void DocumentServiceImpl::DocumentSearch(google::protobuf::RpcController* contro
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDocumentSearch(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteLeastQueue(task);
@@ -343,6 +346,7 @@ void DoDocumentSearchAll(StoragePtr storage, google::protobuf::RpcController* co
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateDocumentSearchAllRequest(storage, request, region);
   if (!status.ok()) {
@@ -370,7 +374,7 @@ void DoDocumentSearchAll(StoragePtr storage, google::protobuf::RpcController* co
   }
 
   for (auto& document_with_score : document_results) {
-    *(response->add_document_with_scores()) = document_with_score;
+    response->mutable_document_with_scores()->Add(std::move(document_with_score));
   }
   auto stream = ctx->Stream();
   CHECK(stream != nullptr) << fmt::format("[region({})] stream is nullptr.", region_id);
@@ -396,7 +400,7 @@ void DocumentServiceImpl::DocumentSearchAll(google::protobuf::RpcController* con
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDocumentSearchAll(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteLeastQueue(task);
@@ -482,6 +486,7 @@ void DoDocumentAdd(StoragePtr storage, google::protobuf::RpcController* controll
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto status = ValidateDocumentAddRequest(storage, request, region);
   if (!status.ok()) {
@@ -532,7 +537,7 @@ void DocumentServiceImpl::DocumentAdd(google::protobuf::RpcController* controlle
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDocumentAdd(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -593,6 +598,7 @@ void DoDocumentDelete(StoragePtr storage, google::protobuf::RpcController* contr
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto status = ValidateDocumentDeleteRequest(storage, request, region);
   if (!status.ok()) {
@@ -629,7 +635,7 @@ void DocumentServiceImpl::DocumentDelete(google::protobuf::RpcController* contro
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDocumentDelete(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -673,6 +679,7 @@ void DoDocumentGetBorderId(StoragePtr storage, google::protobuf::RpcController*
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateDocumentGetBorderIdRequest(storage, request, region);
   if (!status.ok()) {
@@ -709,7 +716,7 @@ void DocumentServiceImpl::DocumentGetBorderId(google::protobuf::RpcController* c
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDocumentGetBorderId(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -769,6 +776,7 @@ void DoDocumentScanQuery(StoragePtr storage, google::protobuf::RpcController* co
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateDocumentScanQueryRequest(storage, request, region);
   if (!status.ok()) {
@@ -823,7 +831,7 @@ void DocumentServiceImpl::DocumentScanQuery(google::protobuf::RpcController* con
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDocumentScanQuery(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -873,6 +881,7 @@ void DoDocumentGetRegionMetrics(StoragePtr storage, google::protobuf::RpcControl
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateDocumentGetRegionMetricsRequest(storage, request, region);
   if (!status.ok()) {
@@ -908,7 +917,7 @@ void DocumentServiceImpl::DocumentGetRegionMetrics(google::protobuf::RpcControll
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDocumentGetRegionMetrics(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -987,6 +996,7 @@ void DoDocumentCount(StoragePtr storage, google::protobuf::RpcController* contro
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateDocumentCountRequest(storage, request, region);
   if (!status.ok()) {
@@ -1025,7 +1035,7 @@ void DocumentServiceImpl::DocumentCount(google::protobuf::RpcController* control
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDocumentCount(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -1067,6 +1077,7 @@ void DoTxnGetDocument(StoragePtr storage, google::protobuf::RpcController* contr
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   region->SetTxnAccessMaxTs(request->start_ts());
   butil::Status status = ValidateTxnGetRequest(request, region);
   if (!status.ok()) {
@@ -1077,7 +1088,7 @@ void DoTxnGetDocument(StoragePtr storage, google::protobuf::RpcController* contr
 
   std::vector<std::string> keys;
   auto* mut_request = const_cast<pb::store::TxnGetRequest*>(request);
-  keys.emplace_back(std::move(*mut_request->release_key()));
+  keys.emplace_back(std::move(*mut_request->mutable_key()));
 
   std::set<int64_t> resolved_locks;
   for (const auto& lock : request->context().resolved_locks()) {
@@ -1143,7 +1154,7 @@ void DocumentServiceImpl::TxnGet(google::protobuf::RpcController* controller, co
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnGetDocument(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -1208,6 +1219,7 @@ void DoTxnScanDocument(StoragePtr storage, google::protobuf::RpcController* cont
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   region->SetTxnAccessMaxTs(request->start_ts());
   auto uniform_range = Helper::TransformRangeWithOptions(request->range());
   butil::Status status = ValidateTxnScanRequestIndex(request, region, uniform_range);
@@ -1304,7 +1316,7 @@ void DocumentServiceImpl::TxnScan(google::protobuf::RpcController* controller, c
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnScanDocument(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -1400,6 +1412,7 @@ void DoDocumentTxnPessimisticLock(StoragePtr storage, google::protobuf::RpcContr
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   auto status = ValidateDocumentTxnPessimisticLockRequest(storage, request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
@@ -1471,7 +1484,7 @@ void DocumentServiceImpl::TxnPessimisticLock(google::protobuf::RpcController* co
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDocumentTxnPessimisticLock(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -1501,7 +1514,7 @@ void DocumentServiceImpl::TxnPessimisticRollback(google::protobuf::RpcController
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnPessimisticRollback(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -1663,6 +1676,7 @@ void DoTxnPrewriteDocument(StoragePtr storage, google::protobuf::RpcController*
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   auto status = ValidateDocumentTxnPrewriteRequest(storage, request, region);
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
@@ -1753,7 +1767,7 @@ void DocumentServiceImpl::TxnPrewrite(google::protobuf::RpcController* controlle
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnPrewriteDocument(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -1860,7 +1874,7 @@ void DocumentServiceImpl::TxnCommit(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnCommit(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -1943,6 +1957,7 @@ void DocumentServiceImpl::TxnCheckTxnStatus(google::protobuf::RpcController* con
 
   auto region = svr_done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto status = DocumentValidateTxnCheckTxnStatusRequest(request, region);
   if (!status.ok()) {
@@ -1952,7 +1967,7 @@ void DocumentServiceImpl::TxnCheckTxnStatus(google::protobuf::RpcController* con
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnCheckTxnStatus(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -2025,6 +2040,7 @@ void DocumentServiceImpl::TxnResolveLock(google::protobuf::RpcController* contro
 
   auto region = svr_done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   auto status = DocumentValidateTxnResolveLockRequest(request, region);
   if (!status.ok()) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2032,7 +2048,7 @@ void DocumentServiceImpl::TxnResolveLock(google::protobuf::RpcController* contro
     return;
   }
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnResolveLock(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -2083,6 +2099,7 @@ void DoTxnBatchGetDocument(StoragePtr storage, google::protobuf::RpcController*
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   region->SetTxnAccessMaxTs(request->start_ts());
   butil::Status status = ValidateTxnBatchGetRequest(request, region);
   if (!status.ok()) {
@@ -2161,7 +2178,7 @@ void DocumentServiceImpl::TxnBatchGet(google::protobuf::RpcController* controlle
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnBatchGetDocument(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -2224,7 +2241,7 @@ void DocumentServiceImpl::TxnBatchRollback(google::protobuf::RpcController* cont
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnBatchRollback(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -2293,7 +2310,7 @@ void DocumentServiceImpl::TxnScanLock(google::protobuf::RpcController* controlle
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnScanLock(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -2350,7 +2367,7 @@ void DocumentServiceImpl::TxnHeartBeat(google::protobuf::RpcController* controll
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnHeartBeat(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -2389,6 +2406,7 @@ void DocumentServiceImpl::TxnGc(google::protobuf::RpcController* controller, con
 
   auto region = svr_done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto status = DocumentValidateTxnGcRequest(request, region);
   if (!status.ok()) {
@@ -2398,7 +2416,7 @@ void DocumentServiceImpl::TxnGc(google::protobuf::RpcController* controller, con
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnGc(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -2451,7 +2469,7 @@ void DocumentServiceImpl::TxnDeleteRange(google::protobuf::RpcController* contro
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnDeleteRange(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -2552,7 +2570,7 @@ void DocumentServiceImpl::BackupData(google::protobuf::RpcController* controller
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoBackupData(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -2578,7 +2596,7 @@ void DocumentServiceImpl::RestoreData(google::protobuf::RpcController* controlle
     return;
   }
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoRestoreData(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -2632,7 +2650,7 @@ void DocumentServiceImpl::TxnDump(google::protobuf::RpcController* controller, c
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnDump(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -2702,7 +2720,7 @@ void DocumentServiceImpl::Hello(google::protobuf::RpcController* controller, con
   auto* svr_done = new ServiceClosure<pb::document::HelloRequest, pb::document::HelloResponse, false>(
       __func__, done, request, response);
 
-  auto task = std::make_shared<ServiceTask>([=]() { DoHello(controller, request, response, svr_done); });
+  auto task = ServiceTask::New([=]() { DoHello(controller, request, response, svr_done); });
 
   bool ret = read_worker_set_->ExecuteRR(task);
   if (BAIDU_UNLIKELY(!ret)) {
@@ -2719,7 +2737,7 @@ void DocumentServiceImpl::GetMemoryInfo(google::protobuf::RpcController* control
   auto* svr_done = new ServiceClosure<pb::document::HelloRequest, pb::document::HelloResponse, false>(
       __func__, done, request, response);
 
-  auto task = std::make_shared<ServiceTask>([=]() { DoHello(controller, request, response, svr_done, true); });
+  auto task = ServiceTask::New([=]() { DoHello(controller, request, response, svr_done, true); });
 
   bool ret = read_worker_set_->ExecuteRR(task);
   if (BAIDU_UNLIKELY(!ret)) {
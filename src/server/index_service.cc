@@ -27,6 +27,7 @@
 #include "common/context.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/region_resource.h"
 #include "common/synchronization.h"
 #include "common/version.h"
 #include "engine/storage.h"
@@ -115,6 +116,7 @@ void DoVectorBatchQuery(StoragePtr storage, google::protobuf::RpcController* con
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateVectorBatchQueryRequest(storage, request, region);
   if (!status.ok()) {
@@ -166,7 +168,7 @@ void IndexServiceImpl::VectorBatchQuery(google::protobuf::RpcController* control
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorBatchQuery(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -218,7 +220,7 @@ static butil::Status ValidateVectorSearchRequest(StoragePtr storage, const pb::i
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Param vector_with_ids is empty");
   }
 
-  status = storage->ValidateLeader(region);
+  status = storage->ValidateLeaderOrVectorFollowerRead(region);
   if (!status.ok()) {
     return status;
   }
@@ -293,6 +295,7 @@ void DoVectorSearch(StoragePtr storage, google::protobuf::RpcController* control
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateVectorSearchRequest(storage, request, region);
   if (!status.ok()) {
@@ -340,7 +343,7 @@ void DoVectorSearch(StoragePtr storage, google::protobuf::RpcController* control
   }
 
   for (auto& vector_result : vector_results) {
-    *(response->add_batch_results()) = vector_result;
+    response->mutable_batch_results()->Add(std::move(vector_result));
   }
 }
 
@@ -359,7 +362,7 @@ void IndexServiceImpl::VectorSearch(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorSearch(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteLeastQueue(task);
@@ -538,6 +541,7 @@ void DoVectorAdd(StoragePtr storage, google::protobuf::RpcController* controller
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto status = ValidateVectorAddRequest(storage, request, region);
   if (!status.ok()) {
@@ -588,7 +592,7 @@ void IndexServiceImpl::VectorAdd(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorAdd(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -675,6 +679,7 @@ void DoVectorDelete(StoragePtr storage, google::protobuf::RpcController* control
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto status = ValidateVectorDeleteRequest(storage, request, region);
   if (!status.ok()) {
@@ -710,7 +715,7 @@ void IndexServiceImpl::VectorDelete(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorDelete(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -754,6 +759,7 @@ void DoVectorGetBorderId(StoragePtr storage, google::protobuf::RpcController* co
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateVectorGetBorderIdRequest(storage, request, region);
   if (!status.ok()) {
@@ -791,7 +797,7 @@ void IndexServiceImpl::VectorGetBorderId(google::protobuf::RpcController* contro
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorGetBorderId(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -851,6 +857,7 @@ void DoVectorScanQuery(StoragePtr storage, google::protobuf::RpcController* cont
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateVectorScanQueryRequest(storage, request, region);
   if (!status.ok()) {
@@ -907,7 +914,7 @@ void IndexServiceImpl::VectorScanQuery(google::protobuf::RpcController* controll
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorScanQuery(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -958,6 +965,7 @@ void DoVectorGetRegionMetrics(StoragePtr storage, google::protobuf::RpcControlle
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateVectorGetRegionMetricsRequest(storage, request, region);
   if (!status.ok()) {
@@ -993,7 +1001,7 @@ void IndexServiceImpl::VectorGetRegionMetrics(google::protobuf::RpcController* c
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorGetRegionMetrics(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -1072,6 +1080,7 @@ void DoVectorCount(StoragePtr storage, google::protobuf::RpcController* controll
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateVectorCountRequest(storage, request, region);
   if (!status.ok()) {
@@ -1109,7 +1118,7 @@ void IndexServiceImpl::VectorCount(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorCount(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -1165,6 +1174,7 @@ void DoVectorCountMemory(StoragePtr storage, google::protobuf::RpcController* co
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateVectorCountMemoryRequest(storage, request, region);
   if (!status.ok()) {
@@ -1209,7 +1219,7 @@ void IndexServiceImpl::VectorCountMemory(google::protobuf::RpcController* contro
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorCountMemory(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -1429,6 +1439,7 @@ void DoVectorImport(StoragePtr storage, google::protobuf::RpcController* control
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto status = ValidateVectorImportRequest(storage, request, region);
   if (!status.ok()) {
@@ -1484,7 +1495,7 @@ void IndexServiceImpl::VectorImport(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorImport(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -1544,6 +1555,7 @@ void DoVectorBuild(StoragePtr storage, google::protobuf::RpcController* controll
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateVectorBuildRequest(storage, request, region);
   if (!status.ok()) {
@@ -1587,7 +1599,7 @@ void IndexServiceImpl::VectorBuild(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorBuild(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -1651,6 +1663,7 @@ void DoVectorLoad(StoragePtr storage, google::protobuf::RpcController* controlle
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateVectorLoadRequest(storage, request, region);
   if (!status.ok()) {
@@ -1694,7 +1707,7 @@ void IndexServiceImpl::VectorLoad(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorLoad(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -1754,6 +1767,7 @@ void DoVectorStatus(StoragePtr storage, google::protobuf::RpcController* control
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateVectorStatusRequest(storage, request, region);
   if (!status.ok()) {
@@ -1799,7 +1813,7 @@ void IndexServiceImpl::VectorStatus(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorStatus(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -1859,6 +1873,7 @@ void DoVectorReset(StoragePtr storage, google::protobuf::RpcController* controll
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateVectorResetRequest(storage, request, region);
   if (!status.ok()) {
@@ -1902,7 +1917,7 @@ void IndexServiceImpl::VectorReset(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorReset(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -1962,6 +1977,7 @@ void DoVectorDump(StoragePtr storage, google::protobuf::RpcController* controlle
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateVectorDumpRequest(storage, request, region);
   if (!status.ok()) {
@@ -2007,7 +2023,7 @@ void IndexServiceImpl::VectorDump(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorDump(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -2060,6 +2076,7 @@ void DoVectorDisplayDocumentDetails(StoragePtr storage, google::protobuf::RpcCon
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateVectorDisplayDocumentDetails(storage, request, region);
   if (!status.ok()) {
@@ -2114,7 +2131,7 @@ void IndexServiceImpl::VectorDisplayDocumentDetails(google::protobuf::RpcControl
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorDisplayDocumentDetails(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -2245,6 +2262,7 @@ void DoVectorSearchDebug(StoragePtr storage, google::protobuf::RpcController* co
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateVectorSearchDebugRequest(storage, request, region);
   if (!status.ok()) {
@@ -2284,7 +2302,7 @@ void DoVectorSearchDebug(StoragePtr storage, google::protobuf::RpcController* co
   }
 
   for (auto& vector_result : vector_results) {
-    *(response->add_batch_results()) = vector_result;
+    response->mutable_batch_results()->Add(std::move(vector_result));
   }
   response->set_deserialization_id_time_us(deserialization_id_time_us);
   response->set_scan_scalar_time_us(scan_scalar_time_us);
@@ -2306,7 +2324,7 @@ void IndexServiceImpl::VectorSearchDebug(google::protobuf::RpcController* contro
     return DoVectorSearchDebug(storage_, controller, request, response, svr_done);
   }
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoVectorSearchDebug(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -2347,6 +2365,7 @@ void DoTxnGetVector(StoragePtr storage, google::protobuf::RpcController* control
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   region->SetTxnAccessMaxTs(request->start_ts());
   butil::Status status = ValidateTxnGetRequest(request, region);
   if (!status.ok()) {
@@ -2357,7 +2376,7 @@ void DoTxnGetVector(StoragePtr storage, google::protobuf::RpcController* control
 
   std::vector<std::string> keys;
   auto* mut_request = const_cast<pb::store::TxnGetRequest*>(request);
-  keys.emplace_back(std::move(*mut_request->release_key()));
+  keys.emplace_back(std::move(*mut_request->mutable_key()));
 
   std::set<int64_t> resolved_locks;
   for (const auto& lock : request->context().resolved_locks()) {
@@ -2425,7 +2444,7 @@ void IndexServiceImpl::TxnGet(google::protobuf::RpcController* controller, const
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnGetVector(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -2491,6 +2510,7 @@ void DoTxnScanVector(StoragePtr storage, google::protobuf::RpcController* contro
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   region->SetTxnAccessMaxTs(request->start_ts());
   auto uniform_range = Helper::TransformRangeWithOptions(request->range());
   butil::Status status = ValidateTxnScanRequestIndex(request, region, uniform_range);
@@ -2587,7 +2607,7 @@ void IndexServiceImpl::TxnScan(google::protobuf::RpcController* controller, cons
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnScanVector(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -2683,6 +2703,7 @@ void DoIndexTxnPessimisticLock(StoragePtr storage, google::protobuf::RpcControll
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   auto status = ValidateIndexTxnPessimisticLockRequest(storage, request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
@@ -2754,7 +2775,7 @@ void IndexServiceImpl::TxnPessimisticLock(google::protobuf::RpcController* contr
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoIndexTxnPessimisticLock(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -2784,7 +2805,7 @@ void IndexServiceImpl::TxnPessimisticRollback(google::protobuf::RpcController* c
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnPessimisticRollback(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -2993,6 +3014,7 @@ void DoTxnPrewriteVector(StoragePtr storage, google::protobuf::RpcController* co
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   auto status = ValidateIndexTxnPrewriteRequest(storage, request, region);
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
@@ -3082,7 +3104,7 @@ void IndexServiceImpl::TxnPrewrite(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnPrewriteVector(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -3194,7 +3216,7 @@ void IndexServiceImpl::TxnCommit(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnCommit(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -3277,6 +3299,7 @@ void IndexServiceImpl::TxnCheckTxnStatus(google::protobuf::RpcController* contro
 
   auto region = svr_done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto status = VectorValidateTxnCheckTxnStatusRequest(request, region);
   if (!status.ok()) {
@@ -3286,7 +3309,7 @@ void IndexServiceImpl::TxnCheckTxnStatus(google::protobuf::RpcController* contro
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnCheckTxnStatus(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -3359,6 +3382,7 @@ void IndexServiceImpl::TxnResolveLock(google::protobuf::RpcController* controlle
 
   auto region = svr_done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   auto status = VectorValidateTxnResolveLockRequest(request, region);
   if (!status.ok()) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -3366,7 +3390,7 @@ void IndexServiceImpl::TxnResolveLock(google::protobuf::RpcController* controlle
     return;
   }
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnResolveLock(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -3417,6 +3441,7 @@ void DoTxnBatchGetVector(StoragePtr storage, google::protobuf::RpcController* co
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   region->SetTxnAccessMaxTs(request->start_ts());
   butil::Status status = ValidateTxnBatchGetRequest(request, region);
   if (!status.ok()) {
@@ -3497,7 +3522,7 @@ void IndexServiceImpl::TxnBatchGet(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnBatchGetVector(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -3560,7 +3585,7 @@ void IndexServiceImpl::TxnBatchRollback(google::protobuf::RpcController* control
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnBatchRollback(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -3629,7 +3654,7 @@ void IndexServiceImpl::TxnScanLock(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnScanLock(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -3686,7 +3711,7 @@ void IndexServiceImpl::TxnHeartBeat(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnHeartBeat(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -3734,6 +3759,7 @@ void IndexServiceImpl::TxnGc(google::protobuf::RpcController* controller, const
 
   auto region = svr_done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto status = VectorValidateTxnGcRequest(request, region);
   if (!status.ok()) {
@@ -3743,7 +3769,7 @@ void IndexServiceImpl::TxnGc(google::protobuf::RpcController* controller, const
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnGc(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -3796,7 +3822,7 @@ void IndexServiceImpl::TxnDeleteRange(google::protobuf::RpcController* controlle
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnDeleteRange(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -3897,7 +3923,7 @@ void IndexServiceImpl::BackupData(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoBackupData(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -3937,7 +3963,7 @@ void IndexServiceImpl::ControlConfig(google::protobuf::RpcController* controller
       __func__, done, request, response);
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoControlConfig(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -3963,7 +3989,7 @@ void IndexServiceImpl::RestoreData(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoRestoreData(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -4017,7 +4043,7 @@ void IndexServiceImpl::TxnDump(google::protobuf::RpcController* controller, cons
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnDump(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -4087,7 +4113,7 @@ void IndexServiceImpl::Hello(google::protobuf::RpcController* controller, const
   auto* svr_done =
       new ServiceClosure<pb::index::HelloRequest, pb::index::HelloResponse, false>(__func__, done, request, response);
 
-  auto task = std::make_shared<ServiceTask>([=]() { DoHello(controller, request, response, svr_done); });
+  auto task = ServiceTask::New([=]() { DoHello(controller, request, response, svr_done); });
 
   bool ret = read_worker_set_->ExecuteRR(task);
   if (BAIDU_UNLIKELY(!ret)) {
@@ -4104,7 +4130,7 @@ void IndexServiceImpl::GetMemoryInfo(google::protobuf::RpcController* controller
   auto* svr_done =
       new ServiceClosure<pb::index::HelloRequest, pb::index::HelloResponse, false>(__func__, done, request, response);
 
-  auto task = std::make_shared<ServiceTask>([=]() { DoHello(controller, request, response, svr_done, true); });
+  auto task = ServiceTask::New([=]() { DoHello(controller, request, response, svr_done, true); });
 
   bool ret = read_worker_set_->ExecuteRR(task);
   if (BAIDU_UNLIKELY(!ret)) {
@@ -48,8 +48,10 @@
 #include "brpc/server.h"
 #include "butil/endpoint.h"
 #include "common/constant.h"
+#include "common/cycle_clock.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/numa.h"
 #include "common/role.h"
 #include "common/syscheck.h"
 #include "common/version.h"
@@ -58,6 +60,7 @@
 #include "config/config_manager.h"
 #include "gflags/gflags.h"
 #include "proto/common.pb.h"
+#include "server/arena_message_factory.h"
 #include "server/cluster_service.h"
 #include "server/coordinator_service.h"
 #include "server/debug_service.h"
@@ -97,9 +100,15 @@ DEFINE_bool(version_worker_set_use_pthread, false, "version worker set use pthre
 DEFINE_bool(read_worker_set_use_pthread, false, "read worker set use pthread");
 DEFINE_bool(write_worker_set_use_pthread, false, "write worker set use pthread");
 DEFINE_bool(apply_worker_set_use_pthread, false, "apply worker set use pthread");
+DEFINE_bool(store_worker_set_use_fair_queue, false,
+            "store read/write worker set use weighted fair queue by workload class");
 
 DEFINE_bool(enable_apply_worker_inplace_run, true, "enable apply worker inplace run");
 
+DEFINE_int32(raft_bthread_tag_worker_num, 0,
+             "bthread worker num of dedicated tag for raft server, so vote/heartbeat not wait for heavy apply "
+             "and request, 0 is share workers, disable enable_apply_worker_inplace_run for full isolation");
+
 DEFINE_uint32(read_worker_num, 128, "read service worker num");
 DEFINE_uint64(read_worker_max_pending_num, 1024, "read service worker num");
 DEFINE_uint32(write_worker_num, 128, "write service worker num");
@@ -127,9 +136,16 @@ DECLARE_int32(bvar_max_dump_multi_dimension_metric_number);
 
 }  // namespace bvar
 
+namespace dingodb {
+
+DECLARE_bool(enable_server_drain);
+
+}  // namespace dingodb
+
 namespace bthread {
 
 DECLARE_int32(bthread_concurrency);
+DECLARE_int32(task_group_ntags);
 
 }  // namespace bthread
 
@@ -265,7 +281,12 @@ static void SignalHandler(int signo) {
   printf("========== handle signal '%d' ==========\n", signo);
 
   if (signo == SIGTERM) {
-    // TODO: graceful shutdown
+    // drain in main thread, clean up is done after drain.
+    if (dingodb::FLAGS_enable_server_drain) {
+      brpc::AskToQuit();
+      return;
+    }
+
     // clean temp directory
     dingodb::Helper::RemoveAllFileOrDirectory(dingodb::Server::GetInstance().GetCheckpointPath());
     dingodb::Helper::RemoveFileOrDirectory(dingodb::Server::GetInstance().PidFilePath());
@@ -340,7 +361,12 @@ static void SignalHandlerWithoutLineno(int signo) {
   printf("========== handle signal '%d' ==========\n", signo);
 
   if (signo == SIGTERM) {
-    // TODO: graceful shutdown
+    // drain in main thread, clean up is done after drain.
+    if (dingodb::FLAGS_enable_server_drain) {
+      brpc::AskToQuit();
+      return;
+    }
+
     // clean temp directory
     dingodb::Helper::RemoveAllFileOrDirectory(dingodb::Server::GetInstance().GetCheckpointPath());
     dingodb::Helper::RemoveFileOrDirectory(dingodb::Server::GetInstance().PidFilePath());
@@ -581,6 +607,9 @@ int main(int argc, char *argv[]) {
     return -1;
   }
 
+  // calibrate cycle clock before any hot path probe.
+  dingodb::CycleClock::Init();
+
   if (!dingo_server.InitServerID()) {
     DINGO_LOG(ERROR) << "InitServerID failed!";
     return -1;
@@ -678,6 +707,17 @@ int main(int argc, char *argv[]) {
   options.num_threads = worker_thread_num;
   bthread::FLAGS_bthread_concurrency = worker_thread_num;
 
+  // Raft control rpc e.g. vote/heartbeat/timeout_now and leader callbacks run on dedicated bthread tag,
+  // worker sets of apply and request always run on default tag.
+  brpc::ServerOptions raft_options = options;
+  if (FLAGS_raft_bthread_tag_worker_num > 0) {
+    bthread::FLAGS_task_group_ntags = 2;
+    raft_options.num_threads = FLAGS_raft_bthread_tag_worker_num;
+    raft_options.bthread_tag = dingodb::Constant::kRaftBthreadTag;
+    DINGO_LOG(INFO) << fmt::format("raft server bthread tag({}) worker_num({})", raft_options.bthread_tag,
+                                   raft_options.num_threads);
+  }
+
   if (role == dingodb::pb::common::ClusterRole::COORDINATOR) {
     if (!dingo_server.InitLogStorage()) {
       DINGO_LOG(ERROR) << "InitLogStorage failed!";
@@ -830,7 +870,7 @@ int main(int argc, char *argv[]) {
       return -1;
     }
 
-    if (raft_server.Start(dingo_server.RaftListenEndpoint(), &options) != 0) {
+    if (raft_server.Start(dingo_server.RaftListenEndpoint(), &raft_options) != 0) {
       DINGO_LOG(ERROR) << "Fail to start raft server!";
       return -1;
     }
@@ -879,8 +919,12 @@ int main(int argc, char *argv[]) {
       return -1;
     }
 
-    dingodb::WorkerSetPtr read_worker_set = dingodb::SimpleWorkerSet::New(
-        "read_wkr", FLAGS_read_worker_num, FLAGS_read_worker_max_pending_num, FLAGS_read_worker_set_use_pthread, false);
+    dingodb::WorkerSetPtr read_worker_set =
+        FLAGS_store_worker_set_use_fair_queue
+            ? dingodb::FairWorkerSet::New("read_wkr", FLAGS_read_worker_num, FLAGS_read_worker_max_pending_num,
+                                          FLAGS_read_worker_set_use_pthread)
+            : dingodb::SimpleWorkerSet::New("read_wkr", FLAGS_read_worker_num, FLAGS_read_worker_max_pending_num,
+                                            FLAGS_read_worker_set_use_pthread, false);
     if (!read_worker_set->Init()) {
       DINGO_LOG(ERROR) << "Init service read WorkerSet failed!";
       return -1;
@@ -889,8 +933,11 @@ int main(int argc, char *argv[]) {
     dingo_server.SetStoreServiceReadWorkerSet(read_worker_set);
 
     dingodb::WorkerSetPtr write_worker_set =
-        dingodb::SimpleWorkerSet::New("write_wkr", FLAGS_write_worker_num, FLAGS_write_worker_max_pending_num,
-                                      FLAGS_write_worker_set_use_pthread, false);
+        FLAGS_store_worker_set_use_fair_queue
+            ? dingodb::FairWorkerSet::New("write_wkr", FLAGS_write_worker_num, FLAGS_write_worker_max_pending_num,
+                                          FLAGS_write_worker_set_use_pthread)
+            : dingodb::SimpleWorkerSet::New("write_wkr", FLAGS_write_worker_num, FLAGS_write_worker_max_pending_num,
+                                            FLAGS_write_worker_set_use_pthread, false);
     if (!write_worker_set->Init()) {
       DINGO_LOG(ERROR) << "Init service write WorkerSet failed!";
       return -1;
@@ -898,9 +945,13 @@ int main(int argc, char *argv[]) {
     store_service.SetWriteWorkSet(write_worker_set);
     dingo_server.SetStoreServiceWriteWorkerSet(write_worker_set);
 
+    // in numa mode apply of region run on numa node of the region.
     dingodb::WorkerSetPtr apply_worker_set =
-        dingodb::SimpleWorkerSet::New("apply_wkr", FLAGS_apply_worker_num, FLAGS_apply_worker_max_pending_num,
-                                      FLAGS_apply_worker_set_use_pthread, FLAGS_enable_apply_worker_inplace_run);
+        dingodb::NumaTopology::IsEnabled()
+            ? dingodb::NumaWorkerSet::New("apply_wkr", FLAGS_apply_worker_num, FLAGS_apply_worker_max_pending_num,
+                                          FLAGS_enable_apply_worker_inplace_run)
+            : dingodb::SimpleWorkerSet::New("apply_wkr", FLAGS_apply_worker_num, FLAGS_apply_worker_max_pending_num,
+                                            FLAGS_apply_worker_set_use_pthread, FLAGS_enable_apply_worker_inplace_run);
     if (!apply_worker_set->Init()) {
       DINGO_LOG(ERROR) << "Init raft apply WorkerSet failed!";
       return -1;
@@ -970,6 +1021,11 @@ int main(int argc, char *argv[]) {
       return -1;
     }
 
+    if (!dingo_server.InitRangeCompactor()) {
+      DINGO_LOG(ERROR) << "InitRangeCompactor failed!";
+      return -1;
+    }
+
     store_service.SetStorage(dingo_server.GetStorage());
     if (brpc_server.AddService(&store_service, brpc::SERVER_DOESNT_OWN_SERVICE) != 0) {
       DINGO_LOG(ERROR) << "Fail to add store service!";
@@ -999,7 +1055,7 @@ int main(int argc, char *argv[]) {
       return -1;
     }
 
-    if (raft_server.Start(dingo_server.RaftListenEndpoint(), &options) != 0) {
+    if (raft_server.Start(dingo_server.RaftListenEndpoint(), &raft_options) != 0) {
       DINGO_LOG(ERROR) << "Fail to start raft server!";
       return -1;
     }
@@ -1036,9 +1092,13 @@ int main(int argc, char *argv[]) {
     index_service.SetWriteWorkSet(write_worker_set);
     dingo_server.SetIndexServiceWriteWorkerSet(write_worker_set);
 
+    // in numa mode apply of region run on numa node of the region.
     dingodb::WorkerSetPtr apply_worker_set =
-        dingodb::SimpleWorkerSet::New("apply_wkr", FLAGS_apply_worker_num, FLAGS_apply_worker_max_pending_num,
-                                      FLAGS_apply_worker_set_use_pthread, FLAGS_enable_apply_worker_inplace_run);
+        dingodb::NumaTopology::IsEnabled()
+            ? dingodb::NumaWorkerSet::New("apply_wkr", FLAGS_apply_worker_num, FLAGS_apply_worker_max_pending_num,
+                                          FLAGS_enable_apply_worker_inplace_run)
+            : dingodb::SimpleWorkerSet::New("apply_wkr", FLAGS_apply_worker_num, FLAGS_apply_worker_max_pending_num,
+                                            FLAGS_apply_worker_set_use_pthread, FLAGS_enable_apply_worker_inplace_run);
     if (!apply_worker_set->Init()) {
       DINGO_LOG(ERROR) << "Init raft apply WorkerSet failed!";
       return -1;
@@ -1132,6 +1192,11 @@ int main(int argc, char *argv[]) {
       return -1;
     }
 
+    if (!dingo_server.InitRangeCompactor()) {
+      DINGO_LOG(ERROR) << "InitRangeCompactor failed!";
+      return -1;
+    }
+
     index_service.SetStorage(dingo_server.GetStorage());
     if (brpc_server.AddService(&index_service, brpc::SERVER_DOESNT_OWN_SERVICE) != 0) {
       DINGO_LOG(ERROR) << "Fail to add index service!";
@@ -1167,7 +1232,7 @@ int main(int argc, char *argv[]) {
       return -1;
     }
 
-    if (raft_server.Start(dingo_server.RaftListenEndpoint(), &options) != 0) {
+    if (raft_server.Start(dingo_server.RaftListenEndpoint(), &raft_options) != 0) {
       DINGO_LOG(ERROR) << "Fail to start raft server!";
       return -1;
     }
@@ -1204,9 +1269,13 @@ int main(int argc, char *argv[]) {
     document_service.SetWriteWorkSet(write_worker_set);
     dingo_server.SetIndexServiceWriteWorkerSet(write_worker_set);
 
+    // in numa mode apply of region run on numa node of the region.
     dingodb::WorkerSetPtr apply_worker_set =
-        dingodb::SimpleWorkerSet::New("apply_wkr", FLAGS_apply_worker_num, FLAGS_apply_worker_max_pending_num,
-                                      FLAGS_apply_worker_set_use_pthread, FLAGS_enable_apply_worker_inplace_run);
+        dingodb::NumaTopology::IsEnabled()
+            ? dingodb::NumaWorkerSet::New("apply_wkr", FLAGS_apply_worker_num, FLAGS_apply_worker_max_pending_num,
+                                          FLAGS_enable_apply_worker_inplace_run)
+            : dingodb::SimpleWorkerSet::New("apply_wkr", FLAGS_apply_worker_num, FLAGS_apply_worker_max_pending_num,
+                                            FLAGS_apply_worker_set_use_pthread, FLAGS_enable_apply_worker_inplace_run);
     if (!apply_worker_set->Init()) {
       DINGO_LOG(ERROR) << "Init raft apply WorkerSet failed!";
       return -1;
@@ -1295,6 +1364,11 @@ int main(int argc, char *argv[]) {
       return -1;
     }
 
+    if (!dingo_server.InitRangeCompactor()) {
+      DINGO_LOG(ERROR) << "InitRangeCompactor failed!";
+      return -1;
+    }
+
     document_service.SetStorage(dingo_server.GetStorage());
     if (brpc_server.AddService(&document_service, brpc::SERVER_DOESNT_OWN_SERVICE) != 0) {
       DINGO_LOG(ERROR) << "Fail to add index service!";
@@ -1330,7 +1404,7 @@ int main(int argc, char *argv[]) {
       return -1;
     }
 
-    if (raft_server.Start(dingo_server.RaftListenEndpoint(), &options) != 0) {
+    if (raft_server.Start(dingo_server.RaftListenEndpoint(), &raft_options) != 0) {
       DINGO_LOG(ERROR) << "Fail to start raft server!";
       return -1;
     }
@@ -1378,6 +1452,11 @@ int main(int argc, char *argv[]) {
     }
   }
 
+#ifdef DINGODB_HAS_RPC_PB_MESSAGE_FACTORY
+  // raft server use default heap message, server own the factory.
+  options.rpc_pb_message_factory = dingodb::NewArenaRpcPBMessageFactory();
+#endif
+
   if (brpc_server.Start(dingo_server.ServerListenEndpoint(), &options) != 0) {
     DINGO_LOG(ERROR) << "Fail to start server!";
     return -1;
@@ -1391,6 +1470,12 @@ int main(int argc, char *argv[]) {
   }
   DINGO_LOG(INFO) << "Server is going to quit";
 
+  if (dingodb::FLAGS_enable_server_drain) {
+    dingo_server.Drain();
+    dingodb::Helper::RemoveAllFileOrDirectory(dingo_server.GetCheckpointPath());
+    dingodb::Helper::RemoveFileOrDirectory(dingo_server.PidFilePath());
+  }
+
   if (role != dingodb::pb::common::ClusterRole::DISKANN) {
     raft_server.Stop(0);
   }
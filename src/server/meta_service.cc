@@ -45,6 +45,7 @@ namespace dingodb {
 DECLARE_int64(max_hnsw_memory_size_of_region);
 DECLARE_int32(max_hnsw_nlinks_of_region);
 DECLARE_int64(max_partition_num_of_table);
+DECLARE_bool(enable_auto_increment_lease);
 
 DEFINE_int32(max_check_tenants_count, 100, "max check tenants count");
 DEFINE_int32(max_check_schema_count, 100, "max check schema count");
@@ -925,6 +926,26 @@ void DoGenerateAutoIncrement(google::protobuf::RpcController *controller,
   DINGO_LOG(INFO) << request->ShortDebugString();
 
   int64_t table_id = request->table_id().entity_id();
+  if (FLAGS_enable_auto_increment_lease) {
+    int64_t start_id = 0;
+    int64_t end_id = 0;
+    auto ret = auto_increment_control->GenerateAutoIncrementFromLease(
+        table_id, request->count(), request->auto_increment_increment(), request->auto_increment_offset(), start_id,
+        end_id);
+    if (!ret.ok()) {
+      DINGO_LOG(ERROR) << "generate auto increment from lease failed, " << ret << " | " << request->ShortDebugString();
+      ServiceHelper::SetError(response->mutable_error(), ret.error_code(), ret.error_str());
+      if (ret.error_code() == pb::error::Errno::ERAFT_NOTLEADER) {
+        auto_increment_control->RedirectResponse(response);
+      }
+      return;
+    }
+
+    response->set_start_id(start_id);
+    response->set_end_id(end_id);
+    return;
+  }
+
   pb::coordinator_internal::MetaIncrement meta_increment;
   auto ret =
       auto_increment_control->GenerateAutoIncrement(table_id, request->count(), request->auto_increment_increment(),
@@ -2037,6 +2058,9 @@ void DoTsoService(google::protobuf::RpcController *controller, const pb::meta::T
   brpc::ClosureGuard done_guard(done);
 
   if (!tso_control->IsLeader()) {
+    if (TsoControl::CanProxyGenTso(controller, request)) {
+      return tso_control->ProxyGenTso(request, response);
+    }
     return tso_control->RedirectResponse(response);
   }
 
@@ -2194,7 +2218,7 @@ void MetaServiceImpl::GetSchemas(google::protobuf::RpcController *controller,
                                  google::protobuf::Closure *done) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!this->coordinator_control_->IsLeader()) {
+  if (!this->coordinator_control_->CanServeRead()) {
     return RedirectResponse(response);
   }
 
@@ -2202,7 +2226,7 @@ void MetaServiceImpl::GetSchemas(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetSchemas(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2216,7 +2240,7 @@ void MetaServiceImpl::GetSchema(google::protobuf::RpcController *controller, con
                                 pb::meta::GetSchemaResponse *response, google::protobuf::Closure *done) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!this->coordinator_control_->IsLeader()) {
+  if (!this->coordinator_control_->CanServeRead()) {
     return RedirectResponse(response);
   }
 
@@ -2224,7 +2248,7 @@ void MetaServiceImpl::GetSchema(google::protobuf::RpcController *controller, con
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetSchema(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2252,7 +2276,7 @@ void MetaServiceImpl::GetSchemaByName(google::protobuf::RpcController *controlle
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetSchemaByName(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2280,7 +2304,7 @@ void MetaServiceImpl::GetTablesCount(google::protobuf::RpcController *controller
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetTablesCount(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2309,7 +2333,7 @@ void MetaServiceImpl::GetTablesBySchema(google::protobuf::RpcController *control
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetTablesBySchema(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2323,7 +2347,7 @@ void MetaServiceImpl::GetTable(google::protobuf::RpcController *controller, cons
                                pb::meta::GetTableResponse *response, google::protobuf::Closure *done) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!this->coordinator_control_->IsLeader()) {
+  if (!this->coordinator_control_->CanServeRead()) {
     return RedirectResponse(response);
   }
 
@@ -2336,7 +2360,7 @@ void MetaServiceImpl::GetTable(google::protobuf::RpcController *controller, cons
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetTable(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2365,7 +2389,7 @@ void MetaServiceImpl::GetTableByName(google::protobuf::RpcController *controller
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetTableByName(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2393,7 +2417,7 @@ void MetaServiceImpl::GetTableRange(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetTableRange(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2421,7 +2445,7 @@ void MetaServiceImpl::GetTableMetrics(google::protobuf::RpcController *controlle
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetTableMetrics(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2450,7 +2474,7 @@ void MetaServiceImpl::CreateTableId(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCreateTableId(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2479,7 +2503,7 @@ void MetaServiceImpl::CreateTableIds(google::protobuf::RpcController *controller
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCreateTableIds(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2510,7 +2534,7 @@ void MetaServiceImpl::CreateTable(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCreateTable(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2539,7 +2563,7 @@ void MetaServiceImpl::DropSchema(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDropSchema(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2568,7 +2592,7 @@ void MetaServiceImpl::CreateSchema(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCreateSchema(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2597,7 +2621,7 @@ void MetaServiceImpl::DropTable(google::protobuf::RpcController *controller, con
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDropTable(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2621,7 +2645,7 @@ void MetaServiceImpl::GetAutoIncrements(google::protobuf::RpcController *control
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetAutoIncrements(controller, request, response, svr_done, auto_increment_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2644,7 +2668,7 @@ void MetaServiceImpl::GetAutoIncrement(google::protobuf::RpcController *controll
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetAutoIncrement(controller, request, response, svr_done, auto_increment_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2667,7 +2691,7 @@ void MetaServiceImpl::CreateAutoIncrement(google::protobuf::RpcController *contr
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCreateAutoIncrement(controller, request, response, svr_done, auto_increment_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2690,7 +2714,7 @@ void MetaServiceImpl::CreateAutoIncrements(google::protobuf::RpcController *cont
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCreateAutoIncrements(controller, request, response, svr_done, auto_increment_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2714,7 +2738,7 @@ void MetaServiceImpl::UpdateAutoIncrement(google::protobuf::RpcController *contr
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoUpdateAutoIncrement(controller, request, response, svr_done, auto_increment_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2738,7 +2762,7 @@ void MetaServiceImpl::GenerateAutoIncrement(google::protobuf::RpcController *con
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGenerateAutoIncrement(controller, request, response, svr_done, auto_increment_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2762,7 +2786,7 @@ void MetaServiceImpl::DeleteAutoIncrement(google::protobuf::RpcController *contr
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDeleteAutoIncrement(controller, request, response, svr_done, auto_increment_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2790,7 +2814,7 @@ void MetaServiceImpl::GetIndexesCount(google::protobuf::RpcController *controlle
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetIndexesCount(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2818,7 +2842,7 @@ void MetaServiceImpl::GetIndexes(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetIndexes(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2845,7 +2869,7 @@ void MetaServiceImpl::GetIndex(google::protobuf::RpcController *controller, cons
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetIndex(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2874,7 +2898,7 @@ void MetaServiceImpl::GetIndexByName(google::protobuf::RpcController *controller
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetIndexByName(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2902,7 +2926,7 @@ void MetaServiceImpl::GetIndexRange(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetIndexRange(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2930,7 +2954,7 @@ void MetaServiceImpl::GetIndexMetrics(google::protobuf::RpcController *controlle
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetIndexMetrics(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2959,7 +2983,7 @@ void MetaServiceImpl::CreateIndexId(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCreateIndexId(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -2990,7 +3014,7 @@ void MetaServiceImpl::CreateIndex(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCreateIndex(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3020,7 +3044,7 @@ void MetaServiceImpl::UpdateIndex(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoUpdateIndex(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3049,7 +3073,7 @@ void MetaServiceImpl::DropIndex(google::protobuf::RpcController *controller, con
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDropIndex(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3078,7 +3102,7 @@ void MetaServiceImpl::GenerateTableIds(google::protobuf::RpcController *controll
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGenerateTableIds(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3118,7 +3142,7 @@ void MetaServiceImpl::CreateTables(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCreateTables(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3132,7 +3156,7 @@ void MetaServiceImpl::GetTables(google::protobuf::RpcController *controller, con
                                 pb::meta::GetTablesResponse *response, google::protobuf::Closure *done) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!coordinator_control_->IsLeader()) {
+  if (!coordinator_control_->CanServeRead()) {
     return RedirectResponse(response);
   }
 
@@ -3146,7 +3170,7 @@ void MetaServiceImpl::GetTables(google::protobuf::RpcController *controller, con
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetTables(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3169,7 +3193,7 @@ void MetaServiceImpl::DropTables(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDropTables(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3201,7 +3225,7 @@ void MetaServiceImpl::UpdateTables(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoUpdateTables(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3234,7 +3258,7 @@ void MetaServiceImpl::AddIndexOnTable(google::protobuf::RpcController *controlle
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoAddIndexOnTable(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3266,7 +3290,7 @@ void MetaServiceImpl::DropIndexOnTable(google::protobuf::RpcController *controll
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDropIndexOnTable(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3289,7 +3313,7 @@ void MetaServiceImpl::SwitchAutoSplit(google::protobuf::RpcController *controlle
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoSwitchAutoSplit(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3317,7 +3341,7 @@ void MetaServiceImpl::TsoService(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTsoService(controller, request, response, svr_done, tso_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3340,7 +3364,7 @@ void MetaServiceImpl::GetDeletedTable(google::protobuf::RpcController *controlle
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetDeletedTable(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3363,7 +3387,7 @@ void MetaServiceImpl::GetDeletedIndex(google::protobuf::RpcController *controlle
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetDeletedIndex(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3387,7 +3411,7 @@ void MetaServiceImpl::CleanDeletedTable(google::protobuf::RpcController *control
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCleanDeletedTable(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3411,7 +3435,7 @@ void MetaServiceImpl::CleanDeletedIndex(google::protobuf::RpcController *control
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCleanDeletedIndex(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3428,7 +3452,7 @@ void MetaServiceImpl::Hello(google::protobuf::RpcController *controller, const p
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoAutoIncrementHello(controller, request, response, svr_done, auto_increment_control_, engine_,
                          request->get_memory_info());
   });
@@ -3446,7 +3470,7 @@ void MetaServiceImpl::GetMemoryInfo(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoAutoIncrementHello(controller, request, response, svr_done, auto_increment_control_, engine_, true);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3462,7 +3486,7 @@ void MetaServiceImpl::GetTsoInfo(google::protobuf::RpcController *controller, co
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>(
+  auto task = ServiceTask::New(
       [this, controller, response, svr_done]() { DoGetTsoInfo(controller, response, svr_done, tso_control_); });
   bool ret = worker_set_->ExecuteRR(task);
   if (!ret) {
@@ -3528,7 +3552,7 @@ void MetaServiceImpl::Watch(google::protobuf::RpcController *controller, const p
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoMetaWatch(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3567,7 +3591,7 @@ void MetaServiceImpl::ListWatch(google::protobuf::RpcController *controller, con
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoListWatch(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3685,7 +3709,7 @@ void MetaServiceImpl::ExportMeta(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoExportMeta(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3739,7 +3763,7 @@ void MetaServiceImpl::SaveIdEpochType(google::protobuf::RpcController *controlle
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoSaveIdEpochType(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -3966,7 +3990,7 @@ void MetaServiceImpl::ImportMeta(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoImportMeta(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -4024,7 +4048,7 @@ void MetaServiceImpl::ImportIdEpochType(google::protobuf::RpcController *control
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoImportEpochType(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -4091,7 +4115,7 @@ void MetaServiceImpl::CreateOrUpdateAutoIncrements(google::protobuf::RpcControll
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCreateOrUpdateAutoIncrements(controller, request, response, svr_done, auto_increment_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -4150,7 +4174,7 @@ void MetaServiceImpl::CreateTenant(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCreateTenant(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -4209,7 +4233,7 @@ void MetaServiceImpl::UpdateTenant(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoUpdateTenant(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -4264,7 +4288,7 @@ void MetaServiceImpl::DropTenant(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoDropTenant(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -4337,7 +4361,7 @@ void MetaServiceImpl::GetTenants(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetTenants(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -4399,7 +4423,7 @@ void MetaServiceImpl::CreateTenants(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCreateTenants(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -4475,7 +4499,7 @@ void MetaServiceImpl::CreateSchemas(google::protobuf::RpcController *controller,
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCreateSchemas(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -4628,7 +4652,7 @@ void MetaServiceImpl::CreateIndexMetas(google::protobuf::RpcController *controll
 
   // Run in queue.
   auto *svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoCreateIndexMetas(controller, request, response, svr_done, coordinator_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
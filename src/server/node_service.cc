@@ -426,6 +426,13 @@ void NodeServiceImpl::InstallVectorIndexSnapshot(google::protobuf::RpcController
     return;
   }
 
+  // follower own vector index save snapshot by itself.
+  if (vector_index_wrapper->IsReady()) {
+    ServiceHelper::SetError(response->mutable_error(), Errno::EVECTOR_NOT_NEED_SNAPSHOT,
+                            fmt::format("Not need snapshot, follower own vector index {}.", vector_index_id));
+    return;
+  }
+
   status = VectorIndexSnapshotManager::HandleInstallSnapshot(request->uri(), request->meta(),
                                                              vector_index_wrapper->SnapshotSet());
   if (!status.ok()) {
@@ -14,6 +14,7 @@
 
 #include "server/server.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <memory>
@@ -25,6 +26,7 @@
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/numa.h"
 #include "common/role.h"
 #include "common/version.h"
 #include "config/config.h"
@@ -33,7 +35,9 @@
 #include "coordinator/coordinator_control.h"
 #include "engine/bdb_raw_engine.h"
 #include "engine/engine.h"
+#include "engine/io_budget.h"
 #include "engine/raft_store_engine.h"
+#include "engine/resolved_ts.h"
 #include "engine/rocks_raw_engine.h"
 #include "event/store_state_machine_event.h"
 #include "fmt/core.h"
@@ -65,6 +69,7 @@ namespace dingodb {
 
 DECLARE_int64(compaction_retention_rev_count);
 DECLARE_bool(auto_compaction);
+DECLARE_int32(crontab_region_spread_num);
 
 DEFINE_bool(ip2hostname, false, "resolve ip to hostname for get map api");
 DEFINE_bool(enable_ip2hostname_cache, true, "enable ip2hostname cache");
@@ -95,7 +100,10 @@ DEFINE_int32(coordinator_remove_watch_interval_s, 10, "coordinator remove watch
 DEFINE_int32(coordinator_lease_interval_s, 1, "coordinator lease interval seconds");
 DEFINE_int32(coordinator_compaction_interval_s, 300, "coordinator compaction interval seconds");
 DEFINE_int32(server_scrub_vector_index_interval_s, 60, "scrub vector index interval seconds");
+DEFINE_int32(server_io_budget_adjust_interval_s, 5, "io budget adjust interval seconds");
+DEFINE_int32(server_resolved_ts_interval_s, 1, "resolved ts advance interval seconds");
 DEFINE_int32(raft_snapshot_interval_s, 120, "raft snapshot interval seconds");
+DEFINE_int32(raft_hibernate_check_interval_s, 10, "raft hibernate check interval seconds");
 DEFINE_int32(gc_update_safe_point_interval_s, 60, "gc update safe point interval seconds");
 DEFINE_int32(gc_do_gc_interval_s, 60, "gc do gc interval seconds");
 DEFINE_int32(balance_leader_interval_s, 60, "balance leader interval seconds");
@@ -103,6 +111,7 @@ DEFINE_int32(balance_region_interval_s, 120, "balance region interval seconds");
 DEFINE_int32(recycle_job_interval_s, 60, "recycle job list interval seconds");
 
 DEFINE_int32(server_scrub_document_index_interval_s, 60, "scrub document index interval seconds");
+DEFINE_int32(server_force_merge_document_index_interval_s, 600, "force merge document index interval seconds");
 
 DEFINE_bool(enable_balance_leader, true, "enable balance leader");
 BRPC_VALIDATE_GFLAG(enable_balance_leader, brpc::PassValidate);
@@ -119,6 +128,9 @@ DEFINE_bool(region_enable_auto_split, true, "enable auto split");
 BRPC_VALIDATE_GFLAG(region_enable_auto_split, brpc::PassValidate);
 
 DEFINE_bool(region_enable_auto_merge, true, "enable auto merge");
+
+DEFINE_bool(enable_server_drain, false, "enable drain leader and save vector index before exit when receive SIGTERM");
+DEFINE_int32(server_drain_timeout_s, 60, "max time of drain leader and save vector index before exit");
 BRPC_VALIDATE_GFLAG(region_enable_auto_merge, brpc::PassValidate);
 
 extern "C" {
@@ -524,7 +536,7 @@ bool Server::InitCrontabManager() {
   crontab_configs_.push_back({
       "STORE_REGION_METRICS",
       {pb::common::STORE, pb::common::INDEX, pb::common::DOCUMENT},
-      FLAGS_server_metrics_collect_interval_s * 1000,
+      FLAGS_server_metrics_collect_interval_s * 1000 / FLAGS_crontab_region_spread_num,
       true,
       [](void*) { Server::GetInstance().GetStoreMetricsManager()->CollectStoreRegionMetrics(); },
   });
@@ -540,6 +552,28 @@ bool Server::InitCrontabManager() {
       [](void*) { Server::GetInstance().GetStoreMetricsManager()->CollectStoreMetrics(); },
   });
 
+  // Add io budget adjust crontab
+  FLAGS_server_io_budget_adjust_interval_s =
+      GetInterval(config, "server.io_budget_adjust_interval_s", FLAGS_server_io_budget_adjust_interval_s);
+  crontab_configs_.push_back({
+      "IO_BUDGET_ADJUST",
+      {pb::common::STORE, pb::common::INDEX, pb::common::DOCUMENT},
+      FLAGS_server_io_budget_adjust_interval_s * 1000,
+      true,
+      [](void*) { IoBudget::GetInstance().Adjust(); },
+  });
+
+  // Add resolved ts advance crontab
+  FLAGS_server_resolved_ts_interval_s =
+      GetInterval(config, "server.resolved_ts_interval_s", FLAGS_server_resolved_ts_interval_s);
+  crontab_configs_.push_back({
+      "RESOLVED_TS",
+      {pb::common::STORE, pb::common::INDEX, pb::common::DOCUMENT},
+      FLAGS_server_resolved_ts_interval_s * 1000,
+      true,
+      [](void*) { ResolvedTs::AdvanceAll(); },
+  });
+
   // Add store approximate size metrics crontab
   FLAGS_server_approximate_size_metrics_collect_interval_s =
       GetInterval(config, "server.approximate_size_metrics_collect_interval_s",
@@ -590,7 +624,7 @@ bool Server::InitCrontabManager() {
       crontab_configs_.push_back({
           "SPLIT_CHECKER",
           {pb::common::STORE, pb::common::INDEX},
-          FLAGS_region_split_check_interval_s * 1000,
+          FLAGS_region_split_check_interval_s * 1000 / FLAGS_crontab_region_spread_num,
           true,
           [](void*) { PreSplitChecker::TriggerPreSplitCheck(nullptr); },
       });
@@ -737,6 +771,17 @@ bool Server::InitCrontabManager() {
       [](void*) { Heartbeat::TriggerScrubVectorIndex(nullptr); },
   });
 
+  // Add force merge document index crontab
+  FLAGS_server_force_merge_document_index_interval_s = GetInterval(
+      config, "server.force_merge_document_index_interval_s", FLAGS_server_force_merge_document_index_interval_s);
+  crontab_configs_.push_back({
+      "FORCE_MERGE_DOCUMENT_INDEX",
+      {pb::common::DOCUMENT},
+      FLAGS_server_force_merge_document_index_interval_s * 1000,
+      true,
+      [](void*) { DocumentIndexManager::ForceMergeDocumentIndex(); },
+  });
+
   auto raft_store_engine = GetRaftStoreEngine();
   if (raft_store_engine != nullptr) {
     // Add raft snapshot controller crontab
@@ -748,6 +793,17 @@ bool Server::InitCrontabManager() {
         true,
         [](void*) { Server::GetInstance().GetRaftStoreEngine()->DoSnapshotPeriodicity(); },
     });
+
+    // Add raft hibernate crontab
+    FLAGS_raft_hibernate_check_interval_s =
+        GetInterval(config, "raft.hibernate_check_interval_s", FLAGS_raft_hibernate_check_interval_s);
+    crontab_configs_.push_back({
+        "RAFT_HIBERNATE",
+        {pb::common::STORE, pb::common::INDEX, pb::common::DOCUMENT},
+        FLAGS_raft_hibernate_check_interval_s * 1000,
+        true,
+        [](void*) { Server::GetInstance().GetRaftStoreEngine()->DoHibernatePeriodicity(); },
+    });
   }
 
   // Add gc update safe point ts crontab
@@ -865,12 +921,26 @@ bool Server::InitStoreMetricsManager() {
 }
 
 bool Server::InitVectorIndexManager() {
-  vector_index_thread_pool_ =
-      std::make_shared<ThreadPool>("vector_index", FLAGS_vector_operation_parallel_thread_num, []() {
-        omp_set_num_threads(FLAGS_omp_num_threads);
+  if (NumaTopology::IsEnabled()) {
+    // every numa node has its own thread pool bound to node cpus, build and search of vector index run on the node.
+    int32_t node_num = NumaTopology::NodeNum();
+    uint32_t thread_num = std::max(FLAGS_vector_operation_parallel_thread_num / node_num, 1);
+    for (int32_t node = 0; node < node_num; ++node) {
+      vector_index_node_thread_pools_.push_back(
+          std::make_shared<ThreadPool>(fmt::format("vector_index_node{}", node), thread_num, [node]() {
+            NumaTopology::BindCurrentThread(node);
+            omp_set_num_threads(FLAGS_omp_num_threads);
+          }));
+    }
+    vector_index_thread_pool_ = vector_index_node_thread_pools_[0];
+  } else {
+    vector_index_thread_pool_ =
+        std::make_shared<ThreadPool>("vector_index", FLAGS_vector_operation_parallel_thread_num, []() {
+          omp_set_num_threads(FLAGS_omp_num_threads);
 
-        LOG(INFO) << fmt::format("omp max thread num per ancestor: {}", omp_get_max_threads());
-      });
+          LOG(INFO) << fmt::format("omp max thread num per ancestor: {}", omp_get_max_threads());
+        });
+  }
 
   vector_index_manager_ = VectorIndexManager::New();
   return vector_index_manager_->Init();
@@ -910,6 +980,11 @@ bool Server::InitPreMergeChecker() {
   return pre_merge_checker_->Init(merge_check_concurrency);
 }
 
+bool Server::InitRangeCompactor() {
+  range_compactor_ = std::make_shared<RangeCompactor>();
+  return range_compactor_->Init();
+}
+
 bool Server::InitTsProvider() {
   ts_provider_ = mvcc::TsProvider::New(GetCoordinatorInteraction());
   return ts_provider_->Init();
@@ -959,6 +1034,9 @@ void Server::Destroy() {
   if (store_controller_) {
     store_controller_->Destroy();
   }
+  if (range_compactor_) {
+    range_compactor_->Destroy();
+  }
 
   if (GetRole() == pb::common::INDEX && vector_index_manager_) {
     vector_index_manager_->Destroy();
@@ -977,6 +1055,101 @@ void Server::Destroy() {
   google::ShutdownGoogleLogging();
 }
 
+void Server::Drain() {
+  if (!FLAGS_enable_server_drain || raft_engine_ == nullptr) {
+    return;
+  }
+
+  auto role = GetRole();
+  if (role != pb::common::STORE && role != pb::common::INDEX && role != pb::common::DOCUMENT) {
+    return;
+  }
+
+  int64_t start_time = Helper::TimestampMs();
+  int64_t deadline_ms = start_time + FLAGS_server_drain_timeout_s * 1000;
+  DINGO_LOG(INFO) << fmt::format("[server.drain] start drain, timeout({}s).", FLAGS_server_drain_timeout_s);
+
+  DrainLeader(deadline_ms);
+  DrainVectorIndex(deadline_ms);
+  DrainRawEngine();
+
+  DINGO_LOG(INFO) << fmt::format("[server.drain] finish drain, elapsed time({}ms).",
+                                 Helper::TimestampMs() - start_time);
+}
+
+void Server::DrainLeader(int64_t deadline_ms) {
+  auto raft_store_engine = GetRaftStoreEngine();
+  std::vector<int64_t> transfer_region_ids;
+  for (const auto& region : GetAllAliveRegion()) {
+    if (region->GetStoreEngineType() != pb::common::STORE_ENG_RAFT_STORE || !IsLeader(region->Id())) {
+      continue;
+    }
+
+    for (const auto& peer : region->Peers()) {
+      if (peer.store_id() == Id() || peer.role() != pb::common::PeerRole::VOTER) {
+        continue;
+      }
+
+      auto status = raft_store_engine->TransferLeader(region->Id(), peer);
+      if (status.ok()) {
+        transfer_region_ids.push_back(region->Id());
+        break;
+      }
+      DINGO_LOG(WARNING) << fmt::format("[server.drain][region({})] transfer leader to store({}) failed, error: {}",
+                                        region->Id(), peer.store_id(), status.error_str());
+    }
+  }
+
+  // braft transfer leader when the target catch up log, wait it done.
+  size_t leader_count = transfer_region_ids.size();
+  while (leader_count > 0 && Helper::TimestampMs() < deadline_ms) {
+    bthread_usleep(100 * 1000);
+    leader_count = std::count_if(transfer_region_ids.begin(), transfer_region_ids.end(),
+                                 [this](int64_t region_id) { return IsLeader(region_id); });
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[server.drain] transfer leader count({}), still leader count({}).",
+                                 transfer_region_ids.size(), leader_count);
+}
+
+void Server::DrainVectorIndex(int64_t deadline_ms) {
+  for (const auto& region : GetAllAliveRegion()) {
+    if (Helper::TimestampMs() >= deadline_ms) {
+      DINGO_LOG(WARNING) << "[server.drain] drain timeout, give up save vector index.";
+      return;
+    }
+
+    auto vector_index_wrapper = region->VectorIndexWrapper();
+    if (vector_index_wrapper == nullptr || region->GetStoreEngineType() == pb::common::STORE_ENG_MONO_STORE) {
+      continue;
+    }
+    // skip index not loaded, being saved by background task or no new log since last save.
+    if (!vector_index_wrapper->IsOwnReady() || vector_index_wrapper->SavingNum() > 0 ||
+        vector_index_wrapper->ApplyLogId() <= vector_index_wrapper->SnapshotLogId()) {
+      continue;
+    }
+
+    auto status = VectorIndexManager::SaveVectorIndex(vector_index_wrapper, "drain");
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("[server.drain][region({})] save vector index failed, error: {}",
+                                        region->Id(), status.error_str());
+    }
+  }
+}
+
+void Server::DrainRawEngine() {
+  for (auto type : {pb::common::RAW_ENG_ROCKSDB, pb::common::RAW_ENG_BDB}) {
+    auto raw_engine = GetRawEngine(type);
+    if (raw_engine == nullptr) {
+      continue;
+    }
+
+    for (const auto& cf_name : Helper::GetColumnFamilyNamesByRole()) {
+      raw_engine->Flush(cf_name);
+    }
+  }
+}
+
 bool Server::Ip2Hostname(std::string& ip2hostname) {
   if (!FLAGS_ip2hostname) {
     return true;
@@ -1250,6 +1423,8 @@ std::shared_ptr<PreSplitChecker> Server::GetPreSplitChecker() { return pre_split
 
 std::shared_ptr<PreMergeChecker> Server::GetPreMergeChecker() { return pre_merge_checker_; }
 
+RangeCompactorPtr Server::GetRangeCompactor() { return range_compactor_; }
+
 void Server::SetStoreServiceReadWorkerSet(WorkerSetPtr worker_set) { store_service_read_worker_set_ = worker_set; }
 
 void Server::SetStoreServiceWriteWorkerSet(WorkerSetPtr worker_set) { store_service_write_worker_set_ = worker_set; }
@@ -1318,6 +1493,13 @@ uint64_t Server::GetDocumentIndexManagerBackgroundPendingTaskCount() {
   return document_index_manager_->GetBackgroundPendingTaskCount();
 }
 
+bool Server::ExecuteDocumentIndexSearchTask(TaskRunnablePtr task) {
+  if (document_index_manager_ == nullptr) {
+    return false;
+  }
+  return document_index_manager_->ExecuteTaskSearch(task);
+}
+
 std::string Server::GetAllWorkSetPendingTaskCount() {
   uint64_t store_servcie_read_pending_task_count =
       store_service_read_worker_set_ ? store_service_read_worker_set_->PendingTaskCount() : 0;
@@ -1339,6 +1521,21 @@ ThreadPoolPtr Server::GetVectorIndexThreadPool() {
   return vector_index_thread_pool_;
 }
 
+ThreadPoolPtr Server::GetVectorIndexThreadPool(int64_t region_id) {
+  if (vector_index_node_thread_pools_.empty()) {
+    return GetVectorIndexThreadPool();
+  }
+
+  int32_t node = NumaTopology::NodeOfRegion(region_id);
+  return vector_index_node_thread_pools_[node % vector_index_node_thread_pools_.size()];
+}
+
+ThreadPoolPtr Server::GetDocumentIndexThreadPool() {
+  CHECK(document_index_thread_pool_ != nullptr) << "document_index_thread_pool is nullptr.";
+
+  return document_index_thread_pool_;
+}
+
 mvcc::TsProviderPtr Server::GetTsProvider() {
   CHECK(ts_provider_ != nullptr) << "ts_provider is nullptr.";
 
@@ -19,6 +19,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "bthread/types.h"
 #include "common/safe_map.h"
@@ -44,6 +45,7 @@
 #include "proto/common.pb.h"
 #include "split/split_checker.h"
 #include "store/heartbeat.h"
+#include "store/range_compactor.h"
 #include "store/region_controller.h"
 #include "store/store_controller.h"
 #include "vector/vector_index_manager.h"
@@ -121,6 +123,9 @@ class Server {
   // Init PreMergeChecker
   bool InitPreMergeChecker();
 
+  // Init RangeCompactor
+  bool InitRangeCompactor();
+
   // Init TsProvider
   bool InitTsProvider();
 
@@ -137,6 +142,10 @@ class Server {
 
   void Destroy();
 
+  // Before exit, transfer leaders away, save vector index and flush memtable,
+  // so restart replay few log and client not wait election.
+  void Drain();
+
   bool Ip2Hostname(std::string& ip2hostname);
 
   int64_t Id() const;
@@ -219,6 +228,7 @@ class Server {
   bool IsLeader(int64_t region_id);
   std::shared_ptr<PreSplitChecker> GetPreSplitChecker();
   std::shared_ptr<PreMergeChecker> GetPreMergeChecker();
+  RangeCompactorPtr GetRangeCompactor();
 
   void SetStoreServiceReadWorkerSet(WorkerSetPtr worker_set);
   void SetStoreServiceWriteWorkerSet(WorkerSetPtr worker_set);
@@ -237,10 +247,15 @@ class Server {
 
   std::vector<std::vector<std::string>> GetDocumentIndexBackgroundWorkerSetTrace();
   uint64_t GetDocumentIndexManagerBackgroundPendingTaskCount();
+  // Execute document search at document index manager search worker, return false if not executed.
+  bool ExecuteDocumentIndexSearchTask(TaskRunnablePtr task);
 
   std::string GetAllWorkSetPendingTaskCount();
 
   ThreadPoolPtr GetVectorIndexThreadPool();
+  // thread pool of numa node which vector index of region placed on.
+  ThreadPoolPtr GetVectorIndexThreadPool(int64_t region_id);
+  ThreadPoolPtr GetDocumentIndexThreadPool();
 
   mvcc::TsProviderPtr GetTsProvider();
 
@@ -250,6 +265,11 @@ class Server {
   const Server& operator=(const Server&) = delete;
 
  private:
+  // for drain
+  void DrainLeader(int64_t deadline_ms);
+  void DrainVectorIndex(int64_t deadline_ms);
+  void DrainRawEngine();
+
   Server() {
     bthread_mutex_init(&cluster_read_only_reason_mutex_, nullptr);
     bthread_mutex_init(&cluster_force_read_only_reason_mutex_, nullptr);
@@ -359,6 +379,9 @@ class Server {
   // Pre merge checker
   std::shared_ptr<PreMergeChecker> pre_merge_checker_;
 
+  // Compact deleted span after large delete range
+  RangeCompactorPtr range_compactor_;
+
   // Crontab config
   std::vector<CrontabConfig> crontab_configs_;
 
@@ -382,6 +405,8 @@ class Server {
 
   // vector index thread pool
   ThreadPoolPtr vector_index_thread_pool_;
+  // vector index thread pool of every numa node in numa mode, first one is vector_index_thread_pool_
+  std::vector<ThreadPoolPtr> vector_index_node_thread_pools_;
 
   // document index thread pool
   ThreadPoolPtr document_index_thread_pool_;
@@ -190,6 +190,9 @@ butil::Status ServiceHelper::ValidateRegion(store::RegionPtr region, const std::
     return status;
   }
 
+  // every key request pass here, sample for load based split
+  region->SampleRequestKeys(keys);
+
   return butil::Status();
 }
 
@@ -15,6 +15,7 @@
 #ifndef DINGODB_SERVER_SERVICE_HELPER_H_
 #define DINGODB_SERVER_SERVICE_HELPER_H_
 
+#include <atomic>
 #include <cstdint>
 #include <fstream>
 #include <string>
@@ -25,10 +26,12 @@
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/tenant_quota.h"
 #include "common/tracker.h"
 #include "fmt/core.h"
 #include "glog/logging.h"
 #include "meta/store_meta_manager.h"
+#include "metrics/store_bvar_metrics.h"
 #include "proto/error.pb.h"
 #include "server/server.h"
 namespace dingodb {
@@ -133,10 +136,12 @@ void ServiceHelper::RedirectLeader(std::string addr, T* response) {
 // Handle service request in execute queue.
 class ServiceTask : public TaskRunnable {
  public:
-  using Handler = std::function<void(void)>;
-  ServiceTask(Handler handle) : handle_(handle) {}
+  using Handler = TaskHandler;
+  ServiceTask(Handler handle) : handle_(std::move(handle)) {}
   ~ServiceTask() override = default;
 
+  static std::shared_ptr<ServiceTask> New(Handler handle) { return NewTask<ServiceTask>(std::move(handle)); }
+
   std::string Type() override { return "SERVICE_TASK"; }
 
   void Run() override { handle_(); }
@@ -178,6 +183,15 @@ class ServiceClosure : public TrackClosure {
       if (BAIDU_UNLIKELY(region == nullptr)) {
         ServiceHelper::SetError(response->mutable_error(), pb::error::EREGION_NOT_FOUND,
                                 fmt::format("Not found region {} at server {}", region_id, Server::GetInstance().Id()));
+      } else if (BAIDU_UNLIKELY(TenantQuota::IsEnabled())) {
+        // reject before queued, caller not handle request without region.
+        auto status = TenantQuota::GetInstance().Acquire(region->TenantId(), is_write_request);
+        if (!status.ok()) {
+          ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+          region = nullptr;
+        } else {
+          region->IncServingRequestCount();
+        }
       } else {
         region->IncServingRequestCount();
       }
@@ -195,6 +209,9 @@ class ServiceClosure : public TrackClosure {
   void Run() override;
 
  private:
+  // request type which pass raft commit is write, same as region request metrics.
+  inline static std::atomic<bool> is_write_request{false};
+
   std::string method_name_;
 
   google::protobuf::Closure* done_;
@@ -284,6 +301,18 @@ void ServiceClosure<T, U, need_region>::Run() {
   if (region) {
     region->DecServingRequestCount();
     region->UpdateLastServingTime();
+    // request pass raft commit is write.
+    region->GetRequestMetrics().Record(tracker->RaftCommitTime() > 0, elapsed_time / 1000,
+                                       response_->error().errcode() != 0);
+    if (tracker->RaftCommitTime() > 0 && !is_write_request.load(std::memory_order_relaxed)) {
+      is_write_request.store(true, std::memory_order_relaxed);
+    }
+    if (BAIDU_UNLIKELY(TenantQuota::IsEnabled())) {
+      bool is_write = is_write_request.load(std::memory_order_relaxed);
+      TenantQuota::GetInstance().Charge(region->TenantId(), is_write,
+                                        is_write ? request_->ByteSizeLong() : response_->ByteSizeLong());
+    }
+    StoreBvarMetrics::GetInstance().UpdateRegionStageLatency(std::to_string(region->Id()), *tracker);
   }
 }
 
@@ -20,6 +20,7 @@
 #include <string_view>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
 #include "butil/time.h"
@@ -28,9 +29,11 @@
 #include "common/helper.h"
 #include "common/latch.h"
 #include "common/logging.h"
+#include "common/region_resource.h"
 #include "common/synchronization.h"
 #include "common/tracker.h"
 #include "common/version.h"
+#include "engine/lock_wait_manager.h"
 #include "fmt/core.h"
 #include "fmt/format.h"
 #include "gflags/gflags.h"
@@ -46,6 +49,9 @@ namespace dingodb {
 
 DEFINE_bool(enable_async_store_kvscan, true, "enable async store kvscan");
 DEFINE_bool(enable_async_store_operation, true, "enable async store operation");
+DEFINE_int64(txn_pessimistic_lock_wait_ms, 200,
+             "max wait time in store when pessimistic lock meet lock conflict, 0 means return conflict immediately");
+BRPC_VALIDATE_GFLAG(txn_pessimistic_lock_wait_ms, brpc::NonNegativeInteger);
 DECLARE_int64(stream_message_max_limit_size);
 DECLARE_int64(max_prewrite_count);
 
@@ -89,6 +95,7 @@ void DoKvGet(StoragePtr storage, google::protobuf::RpcController* controller,
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateKvGetRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -108,7 +115,7 @@ void DoKvGet(StoragePtr storage, google::protobuf::RpcController* controller,
 
   std::vector<std::string> keys;
   auto* mut_request = const_cast<dingodb::pb::store::KvGetRequest*>(request);
-  keys.emplace_back(std::move(*mut_request->release_key()));
+  keys.emplace_back(std::move(*mut_request->mutable_key()));
 
   std::vector<pb::common::KeyValue> kvs;
   status = storage->KvGet(ctx, keys, kvs);
@@ -139,7 +146,7 @@ void StoreServiceImpl::KvGet(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvGet(storage_, controller, request, response, svr_done);
   });
 
@@ -190,6 +197,7 @@ void DoKvBatchGet(StoragePtr storage, google::protobuf::RpcController* controlle
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateKvBatchGetRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -215,7 +223,7 @@ void DoKvBatchGet(StoragePtr storage, google::protobuf::RpcController* controlle
     return;
   }
 
-  Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+  Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
 
   tracker->SetReadStoreTime();
 }
@@ -239,7 +247,7 @@ void StoreServiceImpl::KvBatchGet(google::protobuf::RpcController* controller,
     return DoKvBatchGet(storage_, controller, request, response, svr_done);
   }
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvBatchGet(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -288,6 +296,7 @@ void DoKvPut(StoragePtr storage, google::protobuf::RpcController* controller,
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto status = ValidateKvPutRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -317,7 +326,7 @@ void DoKvPut(StoragePtr storage, google::protobuf::RpcController* controller,
 
   std::vector<pb::common::KeyValue> kvs;
   auto* mut_request = const_cast<dingodb::pb::store::KvPutRequest*>(request);
-  kvs.emplace_back(std::move(*mut_request->release_kv()));
+  kvs.emplace_back(std::move(*mut_request->mutable_kv()));
   status = storage->KvPut(ctx, kvs);
   if (BAIDU_UNLIKELY(!status.ok())) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
@@ -341,7 +350,7 @@ void StoreServiceImpl::KvPut(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvPut(storage_, controller, request, response, svr_done, true);
   });
 
@@ -397,6 +406,7 @@ void DoKvBatchPut(StoragePtr storage, google::protobuf::RpcController* controlle
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateKvBatchPutRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -456,7 +466,7 @@ void StoreServiceImpl::KvBatchPut(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvBatchPut(storage_, controller, request, response, svr_done, true);
   });
 
@@ -507,6 +517,7 @@ void DoKvPutIfAbsent(StoragePtr storage, google::protobuf::RpcController* contro
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateKvPutIfAbsentRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -537,7 +548,7 @@ void DoKvPutIfAbsent(StoragePtr storage, google::protobuf::RpcController* contro
   std::vector<bool> key_states;
   auto* mut_request = const_cast<dingodb::pb::store::KvPutIfAbsentRequest*>(request);
   std::vector<pb::common::KeyValue> kvs;
-  kvs.emplace_back(std::move(*mut_request->release_kv()));
+  kvs.emplace_back(std::move(*mut_request->mutable_kv()));
   status = storage->KvPutIfAbsent(ctx, kvs, true, key_states);
   if (BAIDU_UNLIKELY(!status.ok())) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
@@ -565,7 +576,7 @@ void StoreServiceImpl::KvPutIfAbsent(google::protobuf::RpcController* controller
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvPutIfAbsent(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->Execute(task);
@@ -620,6 +631,7 @@ void DoKvBatchPutIfAbsent(StoragePtr storage, google::protobuf::RpcController* c
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateKvBatchPutIfAbsentRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -685,7 +697,7 @@ void StoreServiceImpl::KvBatchPutIfAbsent(google::protobuf::RpcController* contr
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvBatchPutIfAbsent(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->Execute(task);
@@ -731,6 +743,7 @@ void DoKvBatchDelete(StoragePtr storage, google::protobuf::RpcController* contro
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto status = ValidateKvBatchDeleteRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -792,7 +805,7 @@ void StoreServiceImpl::KvBatchDelete(google::protobuf::RpcController* controller
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvBatchDelete(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->Execute(task);
@@ -838,6 +851,7 @@ void DoKvDeleteRange(StoragePtr storage, google::protobuf::RpcController* contro
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto uniform_range = Helper::TransformRangeWithOptions(request->range());
   butil::Status status = ValidateKvDeleteRangeRequest(request, region, uniform_range);
@@ -882,7 +896,7 @@ void StoreServiceImpl::KvDeleteRange(google::protobuf::RpcController* controller
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvDeleteRange(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->Execute(task);
@@ -927,6 +941,7 @@ void DoKvCompareAndSet(StoragePtr storage, google::protobuf::RpcController* cont
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto status = ValidateKvCompareAndSetRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -983,7 +998,7 @@ void StoreServiceImpl::KvCompareAndSet(google::protobuf::RpcController* controll
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvCompareAndSet(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->Execute(task);
@@ -1035,6 +1050,7 @@ void DoKvBatchCompareAndSet(StoragePtr storage, google::protobuf::RpcController*
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto status = ValidateKvBatchCompareAndSetRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -1099,7 +1115,7 @@ void StoreServiceImpl::KvBatchCompareAndSet(google::protobuf::RpcController* con
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvBatchCompareAndSet(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->Execute(task);
@@ -1149,6 +1165,7 @@ void DoKvScanBegin(StoragePtr storage, google::protobuf::RpcController* controll
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto uniform_range = Helper::TransformRangeWithOptions(request->range());
   butil::Status status = ValidateKvScanBeginRequest(request, region, uniform_range);
@@ -1183,7 +1200,7 @@ void DoKvScanBegin(StoragePtr storage, google::protobuf::RpcController* controll
   }
 
   if (!kvs.empty()) {
-    Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+    Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
   }
 
   *response->mutable_scan_id() = scan_id;
@@ -1205,9 +1222,11 @@ void StoreServiceImpl::KvScanBegin(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvScanBegin(storage_, controller, request, response, svr_done);
   });
+  task->SetWorkloadClass(request->has_coprocessor() && !request->disable_coprocessor() ? WorkloadClass::kAnalytics
+                                                                                       : WorkloadClass::kScan);
   bool ret = read_worker_set_->Execute(task);
   if (BAIDU_UNLIKELY(!ret)) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1245,6 +1264,7 @@ void DoKvScanContinue(StoragePtr storage, google::protobuf::RpcController* contr
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateKvScanContinueRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -1272,7 +1292,7 @@ void DoKvScanContinue(StoragePtr storage, google::protobuf::RpcController* contr
   }
 
   if (!kvs.empty()) {
-    Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+    Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
   }
 }
 
@@ -1292,9 +1312,10 @@ void StoreServiceImpl::KvScanContinue(google::protobuf::RpcController* controlle
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvScanContinue(storage_, controller, request, response, svr_done);
   });
+  task->SetWorkloadClass(WorkloadClass::kScan);
   bool ret = read_worker_set_->Execute(task);
   if (BAIDU_UNLIKELY(!ret)) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1328,6 +1349,7 @@ void DoKvScanRelease(StoragePtr storage, google::protobuf::RpcController* contro
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateKvScanReleaseRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -1366,9 +1388,10 @@ void StoreServiceImpl::KvScanRelease(google::protobuf::RpcController* controller
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvScanRelease(storage_, controller, request, response, svr_done);
   });
+  task->SetWorkloadClass(WorkloadClass::kScan);
   bool ret = read_worker_set_->Execute(task);
   if (BAIDU_UNLIKELY(!ret)) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1438,6 +1461,7 @@ void DoKvScanBeginV2(StoragePtr storage, google::protobuf::RpcController* contro
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto uniform_range = Helper::TransformRangeWithOptions(request->range());
   butil::Status status = ValidateKvScanBeginRequestV2(request, region, uniform_range);
@@ -1475,7 +1499,7 @@ void DoKvScanBeginV2(StoragePtr storage, google::protobuf::RpcController* contro
   }
 
   if (!kvs.empty()) {
-    Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+    Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
   }
 
   response->set_scan_id(scan_id);
@@ -1497,9 +1521,10 @@ void StoreServiceImpl::KvScanBeginV2(google::protobuf::RpcController* controller
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvScanBeginV2(storage_, controller, request, response, svr_done);
   });
+  task->SetWorkloadClass(request->has_coprocessor() ? WorkloadClass::kAnalytics : WorkloadClass::kScan);
   bool ret = read_worker_set_->Execute(task);
   if (BAIDU_UNLIKELY(!ret)) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1538,6 +1563,7 @@ void DoKvScanContinueV2(StoragePtr storage, google::protobuf::RpcController* con
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateKvScanContinueRequestV2(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -1565,7 +1591,7 @@ void DoKvScanContinueV2(StoragePtr storage, google::protobuf::RpcController* con
   }
 
   if (!kvs.empty()) {
-    Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+    Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
   }
 
   response->set_has_more(has_more);
@@ -1587,9 +1613,10 @@ void StoreServiceImpl::KvScanContinueV2(::google::protobuf::RpcController* contr
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvScanContinueV2(storage_, controller, request, response, svr_done);
   });
+  task->SetWorkloadClass(WorkloadClass::kScan);
   bool ret = read_worker_set_->Execute(task);
   if (BAIDU_UNLIKELY(!ret)) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1624,6 +1651,7 @@ void DoKvScanReleaseV2(StoragePtr storage, google::protobuf::RpcController* cont
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateKvScanReleaseRequestV2(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -1662,9 +1690,10 @@ void StoreServiceImpl::KvScanReleaseV2(::google::protobuf::RpcController* contro
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvScanReleaseV2(storage_, controller, request, response, svr_done);
   });
+  task->SetWorkloadClass(WorkloadClass::kScan);
   bool ret = read_worker_set_->Execute(task);
   if (BAIDU_UNLIKELY(!ret)) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1683,6 +1712,7 @@ void DoTxnGet(StoragePtr storage, google::protobuf::RpcController* controller,
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   region->SetTxnAccessMaxTs(request->start_ts());
   butil::Status status = ValidateTxnGetRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -1692,7 +1722,7 @@ void DoTxnGet(StoragePtr storage, google::protobuf::RpcController* controller,
   }
   std::vector<std::string> keys;
   auto* mut_request = const_cast<dingodb::pb::store::TxnGetRequest*>(request);
-  keys.emplace_back(std::move(*mut_request->release_key()));
+  keys.emplace_back(std::move(*mut_request->mutable_key()));
 
   std::set<int64_t> resolved_locks;
   for (const auto& lock : request->context().resolved_locks()) {
@@ -1744,7 +1774,7 @@ void StoreServiceImpl::TxnGet(google::protobuf::RpcController* controller, const
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnGet(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -1801,6 +1831,7 @@ void DoTxnScan(StoragePtr storage, google::protobuf::RpcController* controller,
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   region->SetTxnAccessMaxTs(request->start_ts());
   auto uniform_range = Helper::TransformRangeWithOptions(request->range());
   butil::Status status = ValidateTxnScanRequest(request, region, uniform_range);
@@ -1853,7 +1884,7 @@ void DoTxnScan(StoragePtr storage, google::protobuf::RpcController* controller,
   }
 
   if (!kvs.empty()) {
-    Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+    Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
   }
 
   if (txn_result_info.ByteSizeLong() > 0) {
@@ -1882,9 +1913,10 @@ void StoreServiceImpl::TxnScan(google::protobuf::RpcController* controller, cons
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnScan(storage_, controller, request, response, svr_done);
   });
+  task->SetWorkloadClass(request->has_coprocessor() ? WorkloadClass::kAnalytics : WorkloadClass::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (BAIDU_UNLIKELY(!ret)) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1954,9 +1986,32 @@ static butil::Status ValidateTxnPessimisticLockRequest(const dingodb::pb::store:
   return butil::Status();
 }
 
+// Get lock_ts of the conflict lock which can wait for, 0 means can't wait.
+static int64_t GetWaitableLockTs(const dingodb::pb::store::TxnPessimisticLockResponse* response, int64_t start_ts) {
+  if (response->error().errcode() != pb::error::OK || response->txn_result_size() == 0) {
+    return 0;
+  }
+
+  for (const auto& txn_result : response->txn_result()) {
+    if (!txn_result.has_locked()) {
+      return 0;
+    }
+  }
+
+  const auto& lock_info = response->txn_result(0).locked();
+  return lock_info.lock_ts() != start_ts ? lock_info.lock_ts() : 0;
+}
+
+static void LaunchTxnPessimisticLock(StoragePtr storage, WorkerSetPtr worker_set,
+                                     google::protobuf::RpcController* controller,
+                                     const dingodb::pb::store::TxnPessimisticLockRequest* request,
+                                     dingodb::pb::store::TxnPessimisticLockResponse* response, TrackClosure* done,
+                                     int64_t wait_deadline_ms);
+
 void DoTxnPessimisticLock(StoragePtr storage, google::protobuf::RpcController* controller,
                           const dingodb::pb::store::TxnPessimisticLockRequest* request,
-                          dingodb::pb::store::TxnPessimisticLockResponse* response, TrackClosure* done, bool is_sync) {
+                          dingodb::pb::store::TxnPessimisticLockResponse* response, TrackClosure* done, bool is_sync,
+                          WorkerSetPtr worker_set = nullptr, int64_t wait_deadline_ms = 0) {
   brpc::Controller* cntl = (brpc::Controller*)controller;
   brpc::ClosureGuard done_guard(done);
   auto tracker = done->Tracker();
@@ -1964,6 +2019,7 @@ void DoTxnPessimisticLock(StoragePtr storage, google::protobuf::RpcController* c
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto status = ValidateTxnPessimisticLockRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -2010,6 +2066,42 @@ void DoTxnPessimisticLock(StoragePtr storage, google::protobuf::RpcController* c
       *response->add_kvs() = kv;
     }
   }
+
+  // park request until lock owner txn finished, still hold latches here so lock owner can't wake up before wait.
+  int64_t lock_ts = GetWaitableLockTs(response, request->start_ts());
+  int64_t wait_ms = wait_deadline_ms - Helper::TimestampMs();
+  if (is_sync && worker_set != nullptr && lock_ts > 0 && wait_ms > 0) {
+    done_guard.release();
+    bool ret = LockWaitManager::GetInstance().Wait(
+        request->start_ts(), lock_ts, wait_ms,
+        [storage, worker_set, controller, request, response, done, wait_deadline_ms](bool is_timeout) {
+          response->Clear();
+          LaunchTxnPessimisticLock(storage, worker_set, controller, request, response, done,
+                                   is_timeout ? 0 : wait_deadline_ms);
+        });
+    if (!ret) {
+      // deadlock, return lock conflict
+      brpc::ClosureGuard wait_done_guard(done);
+    }
+  }
+}
+
+static void LaunchTxnPessimisticLock(StoragePtr storage, WorkerSetPtr worker_set,
+                                     google::protobuf::RpcController* controller,
+                                     const dingodb::pb::store::TxnPessimisticLockRequest* request,
+                                     dingodb::pb::store::TxnPessimisticLockResponse* response, TrackClosure* done,
+                                     int64_t wait_deadline_ms) {
+  // Run in queue.
+  auto task =
+      ServiceTask::New([storage, worker_set, controller, request, response, done, wait_deadline_ms]() {
+        DoTxnPessimisticLock(storage, controller, request, response, done, true, worker_set, wait_deadline_ms);
+      });
+  bool ret = worker_set->ExecuteRR(task);
+  if (BAIDU_UNLIKELY(!ret)) {
+    brpc::ClosureGuard done_guard(done);
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
+                            "WorkerSet queue is full, please wait and retry");
+  }
 }
 
 void StoreServiceImpl::TxnPessimisticLock(google::protobuf::RpcController* controller,
@@ -2023,16 +2115,9 @@ void StoreServiceImpl::TxnPessimisticLock(google::protobuf::RpcController* contr
     return;
   }
 
-  // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
-    DoTxnPessimisticLock(storage_, controller, request, response, svr_done, true);
-  });
-  bool ret = write_worker_set_->ExecuteRR(task);
-  if (BAIDU_UNLIKELY(!ret)) {
-    brpc::ClosureGuard done_guard(svr_done);
-    ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
-                            "WorkerSet queue is full, please wait and retry");
-  }
+  int64_t wait_deadline_ms =
+      FLAGS_txn_pessimistic_lock_wait_ms > 0 ? Helper::TimestampMs() + FLAGS_txn_pessimistic_lock_wait_ms : 0;
+  LaunchTxnPessimisticLock(storage_, write_worker_set_, controller, request, response, svr_done, wait_deadline_ms);
 }
 
 static butil::Status ValidateTxnPessimisticRollbackRequest(
@@ -2091,6 +2176,7 @@ void DoTxnPessimisticRollback(StoragePtr storage, google::protobuf::RpcControlle
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   auto status = ValidateTxnPessimisticRollbackRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
@@ -2137,7 +2223,7 @@ void StoreServiceImpl::TxnPessimisticRollback(google::protobuf::RpcController* c
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnPessimisticRollback(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -2211,6 +2297,7 @@ void DoTxnPrewrite(StoragePtr storage, google::protobuf::RpcController* controll
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   auto status = ValidateTxnPrewriteRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
@@ -2288,7 +2375,7 @@ void StoreServiceImpl::TxnPrewrite(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnPrewrite(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -2349,6 +2436,7 @@ void DoTxnCommit(StoragePtr storage, google::protobuf::RpcController* controller
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   region->SetTxnAccessMaxTs(request->commit_ts());
   auto status = ValidateTxnCommitRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -2402,7 +2490,7 @@ void StoreServiceImpl::TxnCommit(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnCommit(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -2462,6 +2550,7 @@ void DoTxnCheckTxnStatus(StoragePtr storage, google::protobuf::RpcController* co
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   int64_t new_max_ts = request->lock_ts();
 
   if (request->caller_start_ts() > new_max_ts) {
@@ -2515,7 +2604,7 @@ void StoreServiceImpl::TxnCheckTxnStatus(google::protobuf::RpcController* contro
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnCheckTxnStatus(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -2571,6 +2660,7 @@ void DoTxnCheckSecondaryLocks(StoragePtr storage, google::protobuf::RpcControlle
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   region->SetTxnAccessMaxTs(request->start_ts());
   auto status = ValidateTxnCheckSecondaryLocks(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -2626,7 +2716,7 @@ void StoreServiceImpl::TxnCheckSecondaryLocks(google::protobuf::RpcController* c
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnCheckSecondaryLocks(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -2677,6 +2767,7 @@ void DoTxnResolveLock(StoragePtr storage, google::protobuf::RpcController* contr
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   region->SetTxnAccessMaxTs(request->commit_ts());
   auto status = ValidateTxnResolveLockRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -2734,7 +2825,7 @@ void StoreServiceImpl::TxnResolveLock(google::protobuf::RpcController* controlle
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnResolveLock(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -2786,6 +2877,7 @@ void DoTxnBatchGet(StoragePtr storage, google::protobuf::RpcController* controll
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
   region->SetTxnAccessMaxTs(request->start_ts());
   butil::Status status = ValidateTxnBatchGetRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -2854,7 +2946,7 @@ void StoreServiceImpl::TxnBatchGet(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnBatchGet(storage_, controller, request, response, svr_done);
   });
   bool ret = read_worker_set_->ExecuteRR(task);
@@ -2911,6 +3003,7 @@ void DoTxnBatchRollback(StoragePtr storage, google::protobuf::RpcController* con
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto status = ValidateTxnBatchRollbackRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -2964,7 +3057,7 @@ void StoreServiceImpl::TxnBatchRollback(google::protobuf::RpcController* control
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnBatchRollback(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -3029,6 +3122,7 @@ void DoTxnScanLock(StoragePtr storage, google::protobuf::RpcController* controll
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateTxnScanLockRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -3091,9 +3185,10 @@ void StoreServiceImpl::TxnScanLock(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnScanLock(storage_, controller, request, response, svr_done);
   });
+  task->SetWorkloadClass(WorkloadClass::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (BAIDU_UNLIKELY(!ret)) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -3148,6 +3243,7 @@ void DoTxnHeartBeat(StoragePtr storage, google::protobuf::RpcController* control
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto status = ValidateTxnHeartBeatRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -3193,7 +3289,7 @@ void StoreServiceImpl::TxnHeartBeat(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnHeartBeat(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -3233,6 +3329,7 @@ void DoTxnGc(StoragePtr storage, google::protobuf::RpcController* controller,
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto status = ValidateTxnGcRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -3268,9 +3365,10 @@ void StoreServiceImpl::TxnGc(google::protobuf::RpcController* controller, const
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnGc(storage_, controller, request, response, svr_done, true);
   });
+  task->SetWorkloadClass(WorkloadClass::kBackground);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (BAIDU_UNLIKELY(!ret)) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -3324,6 +3422,7 @@ void DoTxnDeleteRange(StoragePtr storage, google::protobuf::RpcController* contr
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   auto status = ValidateTxnDeleteRangeRequest(request, region);
   if (BAIDU_UNLIKELY(!status.ok())) {
@@ -3360,7 +3459,7 @@ void StoreServiceImpl::TxnDeleteRange(google::protobuf::RpcController* controlle
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnDeleteRange(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -3461,9 +3560,10 @@ void StoreServiceImpl::BackupData(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoBackupData(storage_, controller, request, response, svr_done, true);
   });
+  task->SetWorkloadClass(WorkloadClass::kBackground);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (BAIDU_UNLIKELY(!ret)) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -3562,9 +3662,10 @@ void StoreServiceImpl::BackupMeta(google::protobuf::RpcController* controller,
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoBackupMeta(storage_, controller, request, response, svr_done, true);
   });
+  task->SetWorkloadClass(WorkloadClass::kBackground);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (BAIDU_UNLIKELY(!ret)) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -3602,7 +3703,7 @@ void StoreServiceImpl::ControlConfig(google::protobuf::RpcController* controller
       __func__, done, request, response);
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoControlConfig(storage_, controller, request, response, svr_done, true);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
@@ -3713,9 +3814,10 @@ void StoreServiceImpl::RestoreMeta(google::protobuf::RpcController* controller,
   auto* svr_done = new ServiceClosure(__func__, done, request, response);
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoRestoreMeta(storage_, controller, request, response, svr_done, true);
   });
+  task->SetWorkloadClass(WorkloadClass::kBackground);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (BAIDU_UNLIKELY(!ret)) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -3820,9 +3922,10 @@ void StoreServiceImpl::RestoreData(google::protobuf::RpcController* controller,
                                    dingodb::pb::store::RestoreDataResponse* response, google::protobuf::Closure* done) {
   auto* svr_done = new ServiceClosure(__func__, done, request, response);
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoRestoreData(storage_, controller, request, response, svr_done, true);
   });
+  task->SetWorkloadClass(WorkloadClass::kBackground);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (BAIDU_UNLIKELY(!ret)) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -3872,6 +3975,7 @@ void DoTxnDump(StoragePtr storage, google::protobuf::RpcController* controller,
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
+  RegionResourceScope resource_scope(region_id);
 
   butil::Status status = ValidateTxnDumpRequest(request, region);
   if (!status.ok()) {
@@ -3934,9 +4038,10 @@ void StoreServiceImpl::TxnDump(google::protobuf::RpcController* controller, cons
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoTxnDump(storage_, controller, request, response, svr_done);
   });
+  task->SetWorkloadClass(WorkloadClass::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (BAIDU_UNLIKELY(!ret)) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -4006,7 +4111,7 @@ void StoreServiceImpl::Hello(google::protobuf::RpcController* controller, const
   auto* svr_done =
       new ServiceClosure<pb::store::HelloRequest, pb::store::HelloResponse, false>(__func__, done, request, response);
 
-  auto task = std::make_shared<ServiceTask>([=]() { DoHello(controller, request, response, svr_done); });
+  auto task = ServiceTask::New([=]() { DoHello(controller, request, response, svr_done); });
   bool ret = read_worker_set_->ExecuteRR(task);
   if (BAIDU_UNLIKELY(!ret)) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -4021,7 +4126,7 @@ void StoreServiceImpl::GetMemoryInfo(google::protobuf::RpcController* controller
   // Run in queue.
   auto* svr_done =
       new ServiceClosure<pb::store::HelloRequest, pb::store::HelloResponse, false>(__func__, done, request, response);
-  auto task = std::make_shared<ServiceTask>([=]() { DoHello(controller, request, response, svr_done, true); });
+  auto task = ServiceTask::New([=]() { DoHello(controller, request, response, svr_done, true); });
   bool ret = read_worker_set_->ExecuteRR(task);
   if (BAIDU_UNLIKELY(!ret)) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -89,7 +89,7 @@ void UtilServiceImpl::VectorCalcDistance(google::protobuf::RpcController* contro
   // Run in queue.
   StoragePtr storage = storage_;
   auto task =
-      std::make_shared<ServiceTask>([=]() { DoVectorCalcDistance(storage, controller, request, response, svr_done); });
+      ServiceTask::New([=]() { DoVectorCalcDistance(storage, controller, request, response, svr_done); });
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -733,7 +733,7 @@ void VersionServiceProtoImpl::LeaseGrant(google::protobuf::RpcController* contro
 
   // Run in queue.
   auto* svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoLeaseGrant(controller, request, response, svr_done, kv_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -763,7 +763,7 @@ void VersionServiceProtoImpl::LeaseRevoke(google::protobuf::RpcController* contr
 
   // Run in queue.
   auto* svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoLeaseRevoke(controller, request, response, svr_done, kv_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -793,7 +793,7 @@ void VersionServiceProtoImpl::LeaseRenew(google::protobuf::RpcController* contro
 
   // Run in queue.
   auto* svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoLeaseRenew(controller, request, response, svr_done, kv_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -823,7 +823,7 @@ void VersionServiceProtoImpl::LeaseQuery(google::protobuf::RpcController* contro
 
   // Run in queue.
   auto* svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoLeaseQuery(controller, request, response, svr_done, kv_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -847,7 +847,7 @@ void VersionServiceProtoImpl::ListLeases(google::protobuf::RpcController* contro
 
   // Run in queue.
   auto* svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoListLeases(controller, request, response, svr_done, kv_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -878,7 +878,7 @@ void VersionServiceProtoImpl::GetRawKvIndex(google::protobuf::RpcController* con
 
   // Run in queue.
   auto* svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetRawKvIndex(controller, request, response, svr_done, kv_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -908,7 +908,7 @@ void VersionServiceProtoImpl::GetRawKvRev(google::protobuf::RpcController* contr
 
   // Run in queue.
   auto* svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoGetRawKvRev(controller, request, response, svr_done, kv_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -938,7 +938,7 @@ void VersionServiceProtoImpl::KvRange(google::protobuf::RpcController* controlle
 
   // Run in queue.
   auto* svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvRange(controller, request, response, svr_done, kv_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -967,7 +967,7 @@ void VersionServiceProtoImpl::KvPut(google::protobuf::RpcController* controller,
 
   // Run in queue.
   auto* svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvPut(controller, request, response, svr_done, kv_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -999,7 +999,7 @@ void VersionServiceProtoImpl::KvDeleteRange(google::protobuf::RpcController* con
 
   // Run in queue.
   auto* svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvDeleteRange(controller, request, response, svr_done, kv_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -1030,7 +1030,7 @@ void VersionServiceProtoImpl::KvCompaction(google::protobuf::RpcController* cont
 
   // Run in queue.
   auto* svr_done = new CoordinatorServiceClosure(__func__, done_guard.release(), request, response);
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvCompaction(controller, request, response, svr_done, kv_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -1067,7 +1067,7 @@ void VersionServiceProtoImpl::Watch(google::protobuf::RpcController* controller,
   auto* svr_done = new CoordinatorServiceClosure("Watch", done_guard.release(), request, response);
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoWatch(controller, request, response, svr_done, kv_control_, engine_);
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -1102,7 +1102,7 @@ void VersionServiceProtoImpl::Hello(google::protobuf::RpcController* controller,
   auto* svr_done = new CoordinatorServiceClosure("Hello", done_guard.release(), request, response);
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvHello(controller, request, response, svr_done, kv_control_, engine_, request->get_memory_info());
   });
   bool ret = worker_set_->ExecuteRR(task);
@@ -1126,7 +1126,7 @@ void VersionServiceProtoImpl::GetMemoryInfo(google::protobuf::RpcController* con
   }
 
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
+  auto task = ServiceTask::New([this, controller, request, response, svr_done]() {
     DoKvHello(controller, request, response, svr_done, kv_control_, engine_, true);
   });
   bool ret = worker_set_->ExecuteRR(task);
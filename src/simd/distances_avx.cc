@@ -21,6 +21,8 @@
 #include <immintrin.h>
 
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 
 namespace dingodb {
 
@@ -195,5 +197,243 @@ float fvec_Linf_avx(const float* x, const float* y, size_t d) {
   return _mm_cvtss_f32(msum2);
 }
 
+float fvec_inner_product_sq8_avx(const int8_t* x, const int8_t* y, size_t d) {
+  __m256i msum = _mm256_setzero_si256();
+
+  while (d >= 16) {
+    __m256i mx = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x)));
+    x += 16;
+    __m256i my = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(y)));
+    y += 16;
+    msum = _mm256_add_epi32(msum, _mm256_madd_epi16(mx, my));
+    d -= 16;
+  }
+
+  __m128i msum2 = _mm_add_epi32(_mm256_extracti128_si256(msum, 1), _mm256_castsi256_si128(msum));
+  msum2 = _mm_hadd_epi32(msum2, msum2);
+  msum2 = _mm_hadd_epi32(msum2, msum2);
+  int32_t res = _mm_cvtsi128_si32(msum2);
+
+  for (size_t i = 0; i < d; i++) {
+    res += static_cast<int32_t>(x[i]) * static_cast<int32_t>(y[i]);
+  }
+  return static_cast<float>(res);
+}
+
+// reads 0 <= d < 8 fp16 as __m256
+static inline __m256 masked_read_fp16(size_t d, const uint16_t* x) {
+  assert(d < 8);
+  ALIGNED(16) uint16_t buf[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  memcpy(buf, x, d * sizeof(uint16_t));
+  return _mm256_cvtph_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(buf)));
+}
+
+static inline float horizontal_sum(__m256 msum1) {
+  __m128 msum2 = _mm256_extractf128_ps(msum1, 1);
+  msum2 = _mm_add_ps(msum2, _mm256_extractf128_ps(msum1, 0));
+  msum2 = _mm_hadd_ps(msum2, msum2);
+  msum2 = _mm_hadd_ps(msum2, msum2);
+  return _mm_cvtss_f32(msum2);
+}
+
+float fvec_L2sqr_fp16_avx(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m256 msum1 = _mm256_setzero_ps();
+
+  while (d >= 8) {
+    __m256 mx = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x)));
+    x += 8;
+    __m256 my = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(y)));
+    y += 8;
+    const __m256 a_m_b = _mm256_sub_ps(mx, my);
+    msum1 = _mm256_add_ps(msum1, _mm256_mul_ps(a_m_b, a_m_b));
+    d -= 8;
+  }
+
+  if (d > 0) {
+    __m256 mx = masked_read_fp16(d, x);
+    __m256 my = masked_read_fp16(d, y);
+    const __m256 a_m_b = _mm256_sub_ps(mx, my);
+    msum1 = _mm256_add_ps(msum1, _mm256_mul_ps(a_m_b, a_m_b));
+  }
+
+  return horizontal_sum(msum1);
+}
+
+float fvec_inner_product_fp16_avx(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m256 msum1 = _mm256_setzero_ps();
+
+  while (d >= 8) {
+    __m256 mx = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x)));
+    x += 8;
+    __m256 my = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(y)));
+    y += 8;
+    msum1 = _mm256_add_ps(msum1, _mm256_mul_ps(mx, my));
+    d -= 8;
+  }
+
+  if (d > 0) {
+    __m256 mx = masked_read_fp16(d, x);
+    __m256 my = masked_read_fp16(d, y);
+    msum1 = _mm256_add_ps(msum1, _mm256_mul_ps(mx, my));
+  }
+
+  return horizontal_sum(msum1);
+}
+
+// bf16 is high half of fp32, widen by zero extend and shift.
+static inline __m256 load_bf16(const uint16_t* x) {
+  __m256i mx = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x)));
+  return _mm256_castsi256_ps(_mm256_slli_epi32(mx, 16));
+}
+
+// reads 0 <= d < 8 bf16 as __m256
+static inline __m256 masked_read_bf16(size_t d, const uint16_t* x) {
+  assert(d < 8);
+  ALIGNED(16) uint16_t buf[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  memcpy(buf, x, d * sizeof(uint16_t));
+  return load_bf16(buf);
+}
+
+float fvec_L2sqr_bf16_avx(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m256 msum1 = _mm256_setzero_ps();
+
+  while (d >= 8) {
+    const __m256 a_m_b = _mm256_sub_ps(load_bf16(x), load_bf16(y));
+    msum1 = _mm256_add_ps(msum1, _mm256_mul_ps(a_m_b, a_m_b));
+    x += 8;
+    y += 8;
+    d -= 8;
+  }
+
+  if (d > 0) {
+    const __m256 a_m_b = _mm256_sub_ps(masked_read_bf16(d, x), masked_read_bf16(d, y));
+    msum1 = _mm256_add_ps(msum1, _mm256_mul_ps(a_m_b, a_m_b));
+  }
+
+  return horizontal_sum(msum1);
+}
+
+float fvec_inner_product_bf16_avx(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m256 msum1 = _mm256_setzero_ps();
+
+  while (d >= 8) {
+    msum1 = _mm256_add_ps(msum1, _mm256_mul_ps(load_bf16(x), load_bf16(y)));
+    x += 8;
+    y += 8;
+    d -= 8;
+  }
+
+  if (d > 0) {
+    msum1 = _mm256_add_ps(msum1, _mm256_mul_ps(masked_read_bf16(d, x), masked_read_bf16(d, y)));
+  }
+
+  return horizontal_sum(msum1);
+}
+
+// Distances of x to a block of 8 y rows, x is loaded once for all rows and every row has its own
+// accumulator register. Rows of next block are prefetched one cache line a step.
+template <bool kL2>
+static inline void fvec_distance_batch_8_avx(const float* x, const float* y, size_t d, float* dis) {
+  __m256 msum[8];
+  for (auto& sum : msum) {
+    sum = _mm256_setzero_ps();
+  }
+
+  size_t i = 0;
+  for (; i + 8 <= d; i += 8) {
+    if ((i & 15) == 0) {
+      for (size_t r = 0; r < 8; ++r) {
+        _mm_prefetch(reinterpret_cast<const char*>(y + (r + 8) * d + i), _MM_HINT_T0);
+      }
+    }
+    __m256 mx = _mm256_loadu_ps(x + i);
+#pragma GCC unroll 8
+    for (size_t r = 0; r < 8; ++r) {
+      __m256 my = _mm256_loadu_ps(y + r * d + i);
+      if constexpr (kL2) {
+        __m256 diff = _mm256_sub_ps(mx, my);
+        msum[r] = _mm256_add_ps(msum[r], _mm256_mul_ps(diff, diff));
+      } else {
+        msum[r] = _mm256_add_ps(msum[r], _mm256_mul_ps(mx, my));
+      }
+    }
+  }
+
+  // horizontal sum of 8 accumulators into one register, lane r is sum of row r.
+  __m256 t0 = _mm256_hadd_ps(msum[0], msum[1]);
+  __m256 t1 = _mm256_hadd_ps(msum[2], msum[3]);
+  __m256 t2 = _mm256_hadd_ps(msum[4], msum[5]);
+  __m256 t3 = _mm256_hadd_ps(msum[6], msum[7]);
+  __m256 u0 = _mm256_hadd_ps(t0, t1);
+  __m256 u1 = _mm256_hadd_ps(t2, t3);
+  __m256 result = _mm256_add_ps(_mm256_permute2f128_ps(u0, u1, 0x20), _mm256_permute2f128_ps(u0, u1, 0x31));
+  _mm256_storeu_ps(dis, result);
+
+  for (; i < d; ++i) {
+    for (size_t r = 0; r < 8; ++r) {
+      if constexpr (kL2) {
+        float diff = x[i] - y[r * d + i];
+        dis[r] += diff * diff;
+      } else {
+        dis[r] += x[i] * y[r * d + i];
+      }
+    }
+  }
+}
+
+void fvec_L2sqr_ny_avx(float* dis, const float* x, const float* y, size_t d, size_t ny) {
+  size_t i = 0;
+  for (; i + 8 <= ny; i += 8) {
+    fvec_distance_batch_8_avx<true>(x, y + i * d, d, dis + i);
+  }
+  for (; i < ny; ++i) {
+    dis[i] = fvec_L2sqr_avx(x, y + i * d, d);
+  }
+}
+
+void fvec_inner_products_ny_avx(float* ip, const float* x, const float* y, size_t d, size_t ny) {
+  size_t i = 0;
+  for (; i + 8 <= ny; i += 8) {
+    fvec_distance_batch_8_avx<false>(x, y + i * d, d, ip + i);
+  }
+  for (; i < ny; ++i) {
+    ip[i] = fvec_inner_product_avx(x, y + i * d, d);
+  }
+}
+
+uint32_t hamming_distance_avx(const uint8_t* x, const uint8_t* y, size_t code_size) {
+  const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2,
+                                          2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  __m256i msum = _mm256_setzero_si256();
+
+  while (code_size >= 32) {
+    __m256i mx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x));
+    x += 32;
+    __m256i my = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y));
+    y += 32;
+    __m256i v = _mm256_xor_si256(mx, my);
+    __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low_mask));
+    __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask));
+    // sum bytes to 4 u64 lanes, no overflow of byte counter
+    msum = _mm256_add_epi64(msum, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+    code_size -= 32;
+  }
+
+  uint32_t res = _mm256_extract_epi64(msum, 0) + _mm256_extract_epi64(msum, 1) + _mm256_extract_epi64(msum, 2) +
+                 _mm256_extract_epi64(msum, 3);
+
+  for (; code_size >= 8; code_size -= 8, x += 8, y += 8) {
+    uint64_t a, b;
+    memcpy(&a, x, sizeof(a));
+    memcpy(&b, y, sizeof(b));
+    res += __builtin_popcountll(a ^ b);
+  }
+  for (size_t i = 0; i < code_size; i++) {
+    res += __builtin_popcount(x[i] ^ y[i]);
+  }
+  return res;
+}
+
 }  // namespace dingodb
 #endif
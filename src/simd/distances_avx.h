@@ -34,6 +34,30 @@ float fvec_L1_avx(const float* x, const float* y, size_t d);
 /// infinity distance
 float fvec_Linf_avx(const float* x, const float* y, size_t d);
 
+/// inner product of two int8 code vectors
+float fvec_inner_product_sq8_avx(const int8_t* x, const int8_t* y, size_t d);
+
+/// Squared L2 distance between two fp16 vectors
+float fvec_L2sqr_fp16_avx(const uint16_t* x, const uint16_t* y, size_t d);
+
+/// inner product of two fp16 vectors
+float fvec_inner_product_fp16_avx(const uint16_t* x, const uint16_t* y, size_t d);
+
+/// Squared L2 distance between two bf16 vectors
+float fvec_L2sqr_bf16_avx(const uint16_t* x, const uint16_t* y, size_t d);
+
+/// inner product of two bf16 vectors
+float fvec_inner_product_bf16_avx(const uint16_t* x, const uint16_t* y, size_t d);
+
+/// compute ny square L2 distance between x and a set of contiguous y vectors, 8 y vectors a block
+void fvec_L2sqr_ny_avx(float* dis, const float* x, const float* y, size_t d, size_t ny);
+
+/// compute the inner product between x and a set of contiguous y vectors, 8 y vectors a block
+void fvec_inner_products_ny_avx(float* ip, const float* x, const float* y, size_t d, size_t ny);
+
+/// hamming distance of two binary codes, popcount by pshufb nibble lookup
+uint32_t hamming_distance_avx(const uint8_t* x, const uint8_t* y, size_t code_size);
+
 }  // namespace dingodb
 
 #endif  // DINGODB_SIMD_DISTANCES_AVX_H_ //NOLINT
@@ -19,6 +19,7 @@
 
 #include <immintrin.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <string>
@@ -249,6 +250,141 @@ float fvec_Linf_avx512(const float* x, const float* y, size_t d) {
   return _mm_cvtss_f32(msum2);
 }
 
+// Distances of x to a block of 16 y rows, x is loaded once for all rows and every row has its own
+// accumulator register, the tail of dimension is read by mask. Rows of next block are prefetched
+// one cache line a step.
+template <bool kL2>
+static inline void fvec_distance_batch_16_avx512(const float* x, const float* y, size_t d, float* dis) {
+  __m512 msum[16];
+  for (auto& sum : msum) {
+    sum = _mm512_setzero_ps();
+  }
+
+  for (size_t i = 0; i < d; i += 16) {
+    __mmask16 mask = (d - i >= 16) ? static_cast<__mmask16>(0xFFFF) : static_cast<__mmask16>((1U << (d - i)) - 1);
+    __m512 mx = _mm512_maskz_loadu_ps(mask, x + i);
+#pragma GCC unroll 16
+    for (size_t r = 0; r < 16; ++r) {
+      _mm_prefetch(reinterpret_cast<const char*>(y + (r + 16) * d + i), _MM_HINT_T0);
+      __m512 my = _mm512_maskz_loadu_ps(mask, y + r * d + i);
+      if constexpr (kL2) {
+        __m512 diff = _mm512_sub_ps(mx, my);
+        msum[r] = _mm512_fmadd_ps(diff, diff, msum[r]);
+      } else {
+        msum[r] = _mm512_fmadd_ps(mx, my, msum[r]);
+      }
+    }
+  }
+
+  for (size_t r = 0; r < 16; ++r) {
+    dis[r] = _mm512_reduce_add_ps(msum[r]);
+  }
+}
+
+void fvec_L2sqr_ny_avx512(float* dis, const float* x, const float* y, size_t d, size_t ny) {
+  size_t i = 0;
+  for (; i + 16 <= ny; i += 16) {
+    fvec_distance_batch_16_avx512<true>(x, y + i * d, d, dis + i);
+  }
+  for (; i < ny; ++i) {
+    dis[i] = fvec_L2sqr_avx512(x, y + i * d, d);
+  }
+}
+
+void fvec_inner_products_ny_avx512(float* ip, const float* x, const float* y, size_t d, size_t ny) {
+  size_t i = 0;
+  for (; i + 16 <= ny; i += 16) {
+    fvec_distance_batch_16_avx512<false>(x, y + i * d, d, ip + i);
+  }
+  for (; i < ny; ++i) {
+    ip[i] = fvec_inner_product_avx512(x, y + i * d, d);
+  }
+}
+
+// reads 0 < d <= 16 16-bit values, 256 bit masked load need AVX512VL, so load by 512 bit mask.
+static inline __m256i masked_read_half(size_t d, const uint16_t* x) {
+  __mmask32 mask = _cvtu32_mask32(0xffffU >> (16 - d));
+  return _mm512_castsi512_si256(_mm512_maskz_loadu_epi16(mask, x));
+}
+
+// reads 0 < d <= 16 fp16 as __m512, tail of vector is read by mask
+static inline __m512 load_fp16(size_t d, const uint16_t* x) {
+  return _mm512_cvtph_ps(masked_read_half(d, x));
+}
+
+// reads 0 < d <= 16 bf16 as __m512, bf16 is high half of fp32
+static inline __m512 load_bf16(size_t d, const uint16_t* x) {
+  __m512i mx = _mm512_cvtepu16_epi32(masked_read_half(d, x));
+  return _mm512_castsi512_ps(_mm512_slli_epi32(mx, 16));
+}
+
+template <bool kL2, bool kBF16>
+static inline float fvec_distance_half_avx512(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m512 msum0 = _mm512_setzero_ps();
+  __m512 msum1 = _mm512_setzero_ps();
+
+  auto accumulate = [](size_t n, const uint16_t* x, const uint16_t* y, __m512& msum) {
+    __m512 mx = kBF16 ? load_bf16(n, x) : load_fp16(n, x);
+    __m512 my = kBF16 ? load_bf16(n, y) : load_fp16(n, y);
+    if constexpr (kL2) {
+      const __m512 a_m_b = _mm512_sub_ps(mx, my);
+      msum = _mm512_fmadd_ps(a_m_b, a_m_b, msum);
+    } else {
+      msum = _mm512_fmadd_ps(mx, my, msum);
+    }
+  };
+
+  size_t i = 0;
+  for (; i + 32 <= d; i += 32) {
+    accumulate(16, x + i, y + i, msum0);
+    accumulate(16, x + i + 16, y + i + 16, msum1);
+  }
+  for (; i < d; i += 16) {
+    accumulate(std::min<size_t>(16, d - i), x + i, y + i, msum0);
+  }
+
+  return _mm512_reduce_add_ps(_mm512_add_ps(msum0, msum1));
+}
+
+float fvec_L2sqr_fp16_avx512(const uint16_t* x, const uint16_t* y, size_t d) {
+  return fvec_distance_half_avx512<true, false>(x, y, d);
+}
+
+float fvec_inner_product_fp16_avx512(const uint16_t* x, const uint16_t* y, size_t d) {
+  return fvec_distance_half_avx512<false, false>(x, y, d);
+}
+
+float fvec_L2sqr_bf16_avx512(const uint16_t* x, const uint16_t* y, size_t d) {
+  return fvec_distance_half_avx512<true, true>(x, y, d);
+}
+
+float fvec_inner_product_bf16_avx512(const uint16_t* x, const uint16_t* y, size_t d) {
+  return fvec_distance_half_avx512<false, true>(x, y, d);
+}
+
+uint32_t hamming_distance_avx512(const uint8_t* x, const uint8_t* y, size_t code_size) {
+  __m512i msum = _mm512_setzero_si512();
+
+  while (code_size >= 64) {
+    __m512i mx = _mm512_loadu_si512(x);
+    x += 64;
+    __m512i my = _mm512_loadu_si512(y);
+    y += 64;
+    msum = _mm512_add_epi64(msum, _mm512_popcnt_epi64(_mm512_xor_si512(mx, my)));
+    code_size -= 64;
+  }
+
+  if (code_size > 0) {
+    // binary code is usually not multiple of 64 bytes, e.g. 128 bits, read tail by mask
+    __mmask64 mask = _cvtu64_mask64((~0ULL) >> (64 - code_size));
+    __m512i mx = _mm512_maskz_loadu_epi8(mask, x);
+    __m512i my = _mm512_maskz_loadu_epi8(mask, y);
+    msum = _mm512_add_epi64(msum, _mm512_popcnt_epi64(_mm512_xor_si512(mx, my)));
+  }
+
+  return static_cast<uint32_t>(_mm512_reduce_add_epi64(msum));
+}
+
 }  // namespace dingodb
 
 #endif
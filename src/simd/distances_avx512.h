@@ -33,6 +33,27 @@ float fvec_L1_avx512(const float* x, const float* y, size_t d);
 /// infinity distance
 float fvec_Linf_avx512(const float* x, const float* y, size_t d);
 
+/// compute ny square L2 distance between x and a set of contiguous y vectors, 16 y vectors a block
+void fvec_L2sqr_ny_avx512(float* dis, const float* x, const float* y, size_t d, size_t ny);
+
+/// compute the inner product between x and a set of contiguous y vectors, 16 y vectors a block
+void fvec_inner_products_ny_avx512(float* ip, const float* x, const float* y, size_t d, size_t ny);
+
+/// Squared L2 distance between two fp16 vectors, fp16 is converted and accumulated in fp32
+float fvec_L2sqr_fp16_avx512(const uint16_t* x, const uint16_t* y, size_t d);
+
+/// inner product of two fp16 vectors
+float fvec_inner_product_fp16_avx512(const uint16_t* x, const uint16_t* y, size_t d);
+
+/// Squared L2 distance between two bf16 vectors, bf16 is converted and accumulated in fp32
+float fvec_L2sqr_bf16_avx512(const uint16_t* x, const uint16_t* y, size_t d);
+
+/// inner product of two bf16 vectors
+float fvec_inner_product_bf16_avx512(const uint16_t* x, const uint16_t* y, size_t d);
+
+/// hamming distance of two binary codes, need AVX512_VPOPCNTDQ
+uint32_t hamming_distance_avx512(const uint8_t* x, const uint8_t* y, size_t code_size);
+
 }  // namespace dingodb
 
 #endif  // DINGODB_SIMD_DISTANCES_AVX512_H_  //NOLINT
@@ -0,0 +1,58 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#if defined(__x86_64__)
+#include "simd/distances_avx512bf16.h"
+
+#include <immintrin.h>
+
+#include <cstdint>
+
+namespace dingodb {
+
+float fvec_inner_product_bf16_avx512bf16(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m512 msum0 = _mm512_setzero_ps();
+  __m512 msum1 = _mm512_setzero_ps();
+
+  // every lane of vdpbf16ps sum two bf16 products into fp32
+  while (d >= 64) {
+    __m512bh mx0 = reinterpret_cast<__m512bh>(_mm512_loadu_si512(x));
+    __m512bh my0 = reinterpret_cast<__m512bh>(_mm512_loadu_si512(y));
+    __m512bh mx1 = reinterpret_cast<__m512bh>(_mm512_loadu_si512(x + 32));
+    __m512bh my1 = reinterpret_cast<__m512bh>(_mm512_loadu_si512(y + 32));
+    msum0 = _mm512_dpbf16_ps(msum0, mx0, my0);
+    msum1 = _mm512_dpbf16_ps(msum1, mx1, my1);
+    x += 64;
+    y += 64;
+    d -= 64;
+  }
+
+  while (d > 0) {
+    // masked tail is zero, so odd dimension is fine
+    size_t n = d < 32 ? d : 32;
+    __mmask32 mask = _cvtu32_mask32(0xffffffffU >> (32 - n));
+    __m512bh mx = reinterpret_cast<__m512bh>(_mm512_maskz_loadu_epi16(mask, x));
+    __m512bh my = reinterpret_cast<__m512bh>(_mm512_maskz_loadu_epi16(mask, y));
+    msum0 = _mm512_dpbf16_ps(msum0, mx, my);
+    x += n;
+    y += n;
+    d -= n;
+  }
+
+  return _mm512_reduce_add_ps(_mm512_add_ps(msum0, msum1));
+}
+
+}  // namespace dingodb
+
+#endif
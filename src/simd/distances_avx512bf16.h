@@ -0,0 +1,28 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_SIMD_DISTANCES_AVX512BF16_H_
+#define DINGODB_SIMD_DISTANCES_AVX512BF16_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dingodb {
+
+/// inner product of two bf16 vectors by vdpbf16ps, need AVX512_BF16, products are accumulated in fp32
+float fvec_inner_product_bf16_avx512bf16(const uint16_t* x, const uint16_t* y, size_t d);
+
+}  // namespace dingodb
+
+#endif  // DINGODB_SIMD_DISTANCES_AVX512BF16_H_  //NOLINT
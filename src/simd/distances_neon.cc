@@ -0,0 +1,319 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#if defined(__aarch64__)
+
+#include "simd/distances_neon.h"
+
+#include <arm_neon.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace dingodb {
+
+float fvec_L2sqr_neon(const float* x, const float* y, size_t d) {
+  float32x4_t msum0 = vdupq_n_f32(0.0f);
+  float32x4_t msum1 = vdupq_n_f32(0.0f);
+
+  size_t i = 0;
+  for (; i + 8 <= d; i += 8) {
+    float32x4_t diff0 = vsubq_f32(vld1q_f32(x + i), vld1q_f32(y + i));
+    float32x4_t diff1 = vsubq_f32(vld1q_f32(x + i + 4), vld1q_f32(y + i + 4));
+    msum0 = vfmaq_f32(msum0, diff0, diff0);
+    msum1 = vfmaq_f32(msum1, diff1, diff1);
+  }
+  if (i + 4 <= d) {
+    float32x4_t diff = vsubq_f32(vld1q_f32(x + i), vld1q_f32(y + i));
+    msum0 = vfmaq_f32(msum0, diff, diff);
+    i += 4;
+  }
+
+  float res = vaddvq_f32(vaddq_f32(msum0, msum1));
+  for (; i < d; ++i) {
+    const float tmp = x[i] - y[i];
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+float fvec_inner_product_neon(const float* x, const float* y, size_t d) {
+  float32x4_t msum0 = vdupq_n_f32(0.0f);
+  float32x4_t msum1 = vdupq_n_f32(0.0f);
+
+  size_t i = 0;
+  for (; i + 8 <= d; i += 8) {
+    msum0 = vfmaq_f32(msum0, vld1q_f32(x + i), vld1q_f32(y + i));
+    msum1 = vfmaq_f32(msum1, vld1q_f32(x + i + 4), vld1q_f32(y + i + 4));
+  }
+  if (i + 4 <= d) {
+    msum0 = vfmaq_f32(msum0, vld1q_f32(x + i), vld1q_f32(y + i));
+    i += 4;
+  }
+
+  float res = vaddvq_f32(vaddq_f32(msum0, msum1));
+  for (; i < d; ++i) {
+    res += x[i] * y[i];
+  }
+  return res;
+}
+
+float fvec_L1_neon(const float* x, const float* y, size_t d) {
+  float32x4_t msum = vdupq_n_f32(0.0f);
+
+  size_t i = 0;
+  for (; i + 4 <= d; i += 4) {
+    msum = vaddq_f32(msum, vabdq_f32(vld1q_f32(x + i), vld1q_f32(y + i)));
+  }
+
+  float res = vaddvq_f32(msum);
+  for (; i < d; ++i) {
+    res += std::fabs(x[i] - y[i]);
+  }
+  return res;
+}
+
+float fvec_Linf_neon(const float* x, const float* y, size_t d) {
+  float32x4_t mmax = vdupq_n_f32(0.0f);
+
+  size_t i = 0;
+  for (; i + 4 <= d; i += 4) {
+    mmax = vmaxq_f32(mmax, vabdq_f32(vld1q_f32(x + i), vld1q_f32(y + i)));
+  }
+
+  float res = vmaxvq_f32(mmax);
+  for (; i < d; ++i) {
+    res = std::fmax(res, std::fabs(x[i] - y[i]));
+  }
+  return res;
+}
+
+float fvec_norm_L2sqr_neon(const float* x, size_t d) {
+  float32x4_t msum = vdupq_n_f32(0.0f);
+
+  size_t i = 0;
+  for (; i + 4 <= d; i += 4) {
+    float32x4_t mx = vld1q_f32(x + i);
+    msum = vfmaq_f32(msum, mx, mx);
+  }
+
+  float res = vaddvq_f32(msum);
+  for (; i < d; ++i) {
+    res += x[i] * x[i];
+  }
+  return res;
+}
+
+// Distances of x to a block of 4 y rows, x is loaded once for all rows and every row has its own accumulator.
+template <bool kL2>
+static inline void fvec_distance_batch_4_neon(const float* x, const float* y, size_t d, float* dis) {
+  float32x4_t msum[4];
+  for (auto& sum : msum) {
+    sum = vdupq_n_f32(0.0f);
+  }
+
+  size_t i = 0;
+  for (; i + 4 <= d; i += 4) {
+    float32x4_t mx = vld1q_f32(x + i);
+#pragma GCC unroll 4
+    for (size_t r = 0; r < 4; ++r) {
+      float32x4_t my = vld1q_f32(y + r * d + i);
+      if constexpr (kL2) {
+        float32x4_t diff = vsubq_f32(mx, my);
+        msum[r] = vfmaq_f32(msum[r], diff, diff);
+      } else {
+        msum[r] = vfmaq_f32(msum[r], mx, my);
+      }
+    }
+  }
+
+  for (size_t r = 0; r < 4; ++r) {
+    dis[r] = vaddvq_f32(msum[r]);
+  }
+  for (; i < d; ++i) {
+    for (size_t r = 0; r < 4; ++r) {
+      if constexpr (kL2) {
+        const float diff = x[i] - y[r * d + i];
+        dis[r] += diff * diff;
+      } else {
+        dis[r] += x[i] * y[r * d + i];
+      }
+    }
+  }
+}
+
+void fvec_L2sqr_ny_neon(float* dis, const float* x, const float* y, size_t d, size_t ny) {
+  size_t i = 0;
+  for (; i + 4 <= ny; i += 4) {
+    fvec_distance_batch_4_neon<true>(x, y + i * d, d, dis + i);
+  }
+  for (; i < ny; ++i) {
+    dis[i] = fvec_L2sqr_neon(x, y + i * d, d);
+  }
+}
+
+void fvec_inner_products_ny_neon(float* ip, const float* x, const float* y, size_t d, size_t ny) {
+  size_t i = 0;
+  for (; i + 4 <= ny; i += 4) {
+    fvec_distance_batch_4_neon<false>(x, y + i * d, d, ip + i);
+  }
+  for (; i < ny; ++i) {
+    ip[i] = fvec_inner_product_neon(x, y + i * d, d);
+  }
+}
+
+void fvec_madd_neon(size_t n, const float* a, float bf, const float* b, float* c) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    vst1q_f32(c + i, vfmaq_n_f32(vld1q_f32(a + i), vld1q_f32(b + i), bf));
+  }
+  for (; i < n; ++i) {
+    c[i] = a[i] + bf * b[i];
+  }
+}
+
+int fvec_madd_and_argmin_neon(size_t n, const float* a, float bf, const float* b, float* c) {
+  fvec_madd_neon(n, a, bf, b, c);
+
+  // same as fvec_madd_and_argmin_ref, first index of min which is less than 1e20
+  float vmin = 1e20;
+  int imin = -1;
+  for (size_t i = 0; i < n; ++i) {
+    if (c[i] < vmin) {
+      vmin = c[i];
+      imin = i;
+    }
+  }
+  return imin;
+}
+
+float fvec_inner_product_sq8_neon(const int8_t* x, const int8_t* y, size_t d) {
+  int32x4_t msum = vdupq_n_s32(0);
+
+  size_t i = 0;
+  for (; i + 16 <= d; i += 16) {
+    int8x16_t mx = vld1q_s8(x + i);
+    int8x16_t my = vld1q_s8(y + i);
+    msum = vpadalq_s16(msum, vmull_s8(vget_low_s8(mx), vget_low_s8(my)));
+    msum = vpadalq_s16(msum, vmull_high_s8(mx, my));
+  }
+
+  int32_t res = vaddvq_s32(msum);
+  for (; i < d; ++i) {
+    res += static_cast<int32_t>(x[i]) * static_cast<int32_t>(y[i]);
+  }
+  return static_cast<float>(res);
+}
+
+static inline float32x4_t load_fp16_neon(const uint16_t* x) { return vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(x))); }
+
+static inline float fp16_to_fp32_neon(uint16_t h) {
+  return vgetq_lane_f32(vcvt_f32_f16(vreinterpret_f16_u16(vdup_n_u16(h))), 0);
+}
+
+float fvec_L2sqr_fp16_neon(const uint16_t* x, const uint16_t* y, size_t d) {
+  float32x4_t msum = vdupq_n_f32(0.0f);
+
+  size_t i = 0;
+  for (; i + 4 <= d; i += 4) {
+    float32x4_t diff = vsubq_f32(load_fp16_neon(x + i), load_fp16_neon(y + i));
+    msum = vfmaq_f32(msum, diff, diff);
+  }
+
+  float res = vaddvq_f32(msum);
+  for (; i < d; ++i) {
+    const float tmp = fp16_to_fp32_neon(x[i]) - fp16_to_fp32_neon(y[i]);
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+float fvec_inner_product_fp16_neon(const uint16_t* x, const uint16_t* y, size_t d) {
+  float32x4_t msum = vdupq_n_f32(0.0f);
+
+  size_t i = 0;
+  for (; i + 4 <= d; i += 4) {
+    msum = vfmaq_f32(msum, load_fp16_neon(x + i), load_fp16_neon(y + i));
+  }
+
+  float res = vaddvq_f32(msum);
+  for (; i < d; ++i) {
+    res += fp16_to_fp32_neon(x[i]) * fp16_to_fp32_neon(y[i]);
+  }
+  return res;
+}
+
+// bf16 is high half of fp32
+static inline float32x4_t load_bf16_neon(const uint16_t* x) {
+  return vreinterpretq_f32_u32(vshll_n_u16(vld1_u16(x), 16));
+}
+
+static inline float bf16_to_fp32_neon(uint16_t h) {
+  uint32_t bits = static_cast<uint32_t>(h) << 16;
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+float fvec_L2sqr_bf16_neon(const uint16_t* x, const uint16_t* y, size_t d) {
+  float32x4_t msum = vdupq_n_f32(0.0f);
+
+  size_t i = 0;
+  for (; i + 4 <= d; i += 4) {
+    float32x4_t diff = vsubq_f32(load_bf16_neon(x + i), load_bf16_neon(y + i));
+    msum = vfmaq_f32(msum, diff, diff);
+  }
+
+  float res = vaddvq_f32(msum);
+  for (; i < d; ++i) {
+    const float tmp = bf16_to_fp32_neon(x[i]) - bf16_to_fp32_neon(y[i]);
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+float fvec_inner_product_bf16_neon(const uint16_t* x, const uint16_t* y, size_t d) {
+  float32x4_t msum = vdupq_n_f32(0.0f);
+
+  size_t i = 0;
+  for (; i + 4 <= d; i += 4) {
+    msum = vfmaq_f32(msum, load_bf16_neon(x + i), load_bf16_neon(y + i));
+  }
+
+  float res = vaddvq_f32(msum);
+  for (; i < d; ++i) {
+    res += bf16_to_fp32_neon(x[i]) * bf16_to_fp32_neon(y[i]);
+  }
+  return res;
+}
+
+uint32_t hamming_distance_neon(const uint8_t* x, const uint8_t* y, size_t code_size) {
+  uint32x4_t msum = vdupq_n_u32(0);
+
+  size_t i = 0;
+  for (; i + 16 <= code_size; i += 16) {
+    uint8x16_t count = vcntq_u8(veorq_u8(vld1q_u8(x + i), vld1q_u8(y + i)));
+    msum = vpadalq_u16(msum, vpaddlq_u8(count));
+  }
+
+  uint32_t res = vaddvq_u32(msum);
+  for (; i < code_size; ++i) {
+    res += __builtin_popcount(x[i] ^ y[i]);
+  }
+  return res;
+}
+
+}  // namespace dingodb
+#endif
@@ -0,0 +1,70 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_SIMD_DISTANCES_NEON_H_
+#define DINGODB_SIMD_DISTANCES_NEON_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dingodb {
+
+/// Squared L2 distance between two vectors
+float fvec_L2sqr_neon(const float* x, const float* y, size_t d);
+
+/// inner product
+float fvec_inner_product_neon(const float* x, const float* y, size_t d);
+
+/// L1 distance
+float fvec_L1_neon(const float* x, const float* y, size_t d);
+
+/// infinity distance
+float fvec_Linf_neon(const float* x, const float* y, size_t d);
+
+/// squared norm of a vector
+float fvec_norm_L2sqr_neon(const float* x, size_t d);
+
+/// compute ny square L2 distance between x and a set of contiguous y vectors, 4 y vectors a block
+void fvec_L2sqr_ny_neon(float* dis, const float* x, const float* y, size_t d, size_t ny);
+
+/// compute the inner product between x and a set of contiguous y vectors, 4 y vectors a block
+void fvec_inner_products_ny_neon(float* ip, const float* x, const float* y, size_t d, size_t ny);
+
+/// c = a + bf * b
+void fvec_madd_neon(size_t n, const float* a, float bf, const float* b, float* c);
+
+/// c = a + bf * b, return index of min of c
+int fvec_madd_and_argmin_neon(size_t n, const float* a, float bf, const float* b, float* c);
+
+/// inner product of two int8 code vectors
+float fvec_inner_product_sq8_neon(const int8_t* x, const int8_t* y, size_t d);
+
+/// Squared L2 distance between two fp16 vectors
+float fvec_L2sqr_fp16_neon(const uint16_t* x, const uint16_t* y, size_t d);
+
+/// inner product of two fp16 vectors
+float fvec_inner_product_fp16_neon(const uint16_t* x, const uint16_t* y, size_t d);
+
+/// Squared L2 distance between two bf16 vectors
+float fvec_L2sqr_bf16_neon(const uint16_t* x, const uint16_t* y, size_t d);
+
+/// inner product of two bf16 vectors
+float fvec_inner_product_bf16_neon(const uint16_t* x, const uint16_t* y, size_t d);
+
+/// hamming distance of two binary codes, popcount by vcnt
+uint32_t hamming_distance_neon(const uint8_t* x, const uint8_t* y, size_t code_size);
+
+}  // namespace dingodb
+
+#endif  // DINGODB_SIMD_DISTANCES_NEON_H_ //NOLINT
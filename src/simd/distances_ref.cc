@@ -19,6 +19,8 @@
 #include "simd/distances_ref.h"
 
 #include <cmath>
+#include <cstring>
+
 namespace dingodb {
 
 float fvec_L2sqr_ref(const float* x, const float* y, size_t d) {
@@ -96,4 +98,128 @@ int fvec_madd_and_argmin_ref(size_t n, const float* a, float bf, const float* b,
   return imin;
 }
 
+float fvec_inner_product_sq8_ref(const int8_t* x, const int8_t* y, size_t d) {
+  int32_t res = 0;
+  for (size_t i = 0; i < d; i++) res += static_cast<int32_t>(x[i]) * static_cast<int32_t>(y[i]);
+  return static_cast<float>(res);
+}
+
+float fvec_L2sqr_fp16_ref(const uint16_t* x, const uint16_t* y, size_t d) {
+  float res = 0;
+  for (size_t i = 0; i < d; i++) {
+    const float tmp = fp16_to_fp32_ref(x[i]) - fp16_to_fp32_ref(y[i]);
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+float fvec_inner_product_fp16_ref(const uint16_t* x, const uint16_t* y, size_t d) {
+  float res = 0;
+  for (size_t i = 0; i < d; i++) res += fp16_to_fp32_ref(x[i]) * fp16_to_fp32_ref(y[i]);
+  return res;
+}
+
+float fvec_L2sqr_bf16_ref(const uint16_t* x, const uint16_t* y, size_t d) {
+  float res = 0;
+  for (size_t i = 0; i < d; i++) {
+    const float tmp = bf16_to_fp32_ref(x[i]) - bf16_to_fp32_ref(y[i]);
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+float fvec_inner_product_bf16_ref(const uint16_t* x, const uint16_t* y, size_t d) {
+  float res = 0;
+  for (size_t i = 0; i < d; i++) res += bf16_to_fp32_ref(x[i]) * bf16_to_fp32_ref(y[i]);
+  return res;
+}
+
+uint32_t hamming_distance_ref(const uint8_t* x, const uint8_t* y, size_t code_size) {
+  uint32_t res = 0;
+  size_t i = 0;
+  for (; i + 8 <= code_size; i += 8) {
+    uint64_t a, b;
+    memcpy(&a, x + i, sizeof(a));
+    memcpy(&b, y + i, sizeof(b));
+    res += __builtin_popcountll(a ^ b);
+  }
+  for (; i < code_size; i++) {
+    res += __builtin_popcount(x[i] ^ y[i]);
+  }
+  return res;
+}
+
+float fp16_to_fp32_ref(uint16_t h) {
+  const uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+  const uint32_t exponent = (h >> 10) & 0x1f;
+  const uint32_t mantissa = h & 0x3ff;
+
+  float f;
+  if (exponent == 0) {
+    // zero or subnormal, value is mantissa * 2^-24
+    f = static_cast<float>(mantissa) / 16777216.0f;
+    return sign != 0 ? -f : f;
+  }
+
+  uint32_t bits;
+  if (exponent == 0x1f) {
+    // inf or nan
+    bits = sign | 0x7f800000 | (mantissa << 13);
+  } else {
+    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  }
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+uint16_t fp32_to_fp16_ref(float f) {
+  uint32_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+  const uint16_t sign = (bits >> 16) & 0x8000;
+  const uint32_t abs = bits & 0x7fffffff;
+
+  if (abs >= 0x7f800000) {
+    // inf or nan, keep nan quiet
+    return sign | 0x7c00 | (abs > 0x7f800000 ? 0x200 : 0);
+  }
+  if (abs >= 0x477ff000) {
+    // overflow, round to inf
+    return sign | 0x7c00;
+  }
+  if (abs < 0x38800000) {
+    // subnormal, value * 2^24 is exact and at most 1024(min normal)
+    float abs_f;
+    memcpy(&abs_f, &abs, sizeof(abs_f));
+    return sign | static_cast<uint16_t>(std::nearbyint(abs_f * 16777216.0f));
+  }
+
+  // rebias exponent 127 -> 15
+  uint32_t h = (abs >> 13) - (112 << 10);
+  const uint32_t round_bits = abs & 0x1fff;
+  if (round_bits > 0x1000 || (round_bits == 0x1000 && (h & 1) != 0)) {
+    ++h;
+  }
+  return sign | static_cast<uint16_t>(h);
+}
+
+float bf16_to_fp32_ref(uint16_t h) {
+  // bf16 is high half of fp32
+  const uint32_t bits = static_cast<uint32_t>(h) << 16;
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+uint16_t fp32_to_bf16_ref(float f) {
+  uint32_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+  if ((bits & 0x7fffffff) > 0x7f800000) {
+    // nan, keep it quiet instead of round to inf
+    return static_cast<uint16_t>((bits >> 16) | 0x40);
+  }
+  // round to nearest even, overflow round to inf
+  bits += 0x7fff + ((bits >> 16) & 1);
+  return static_cast<uint16_t>(bits >> 16);
+}
+
 }  // namespace dingodb
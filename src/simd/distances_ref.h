@@ -17,6 +17,7 @@
 #ifndef DINGODB_SIMD_DISTANCES_REF_H_
 #define DINGODB_SIMD_DISTANCES_REF_H_
 
+#include <cstdint>
 #include <cstdio>
 
 namespace dingodb {
@@ -46,6 +47,32 @@ void fvec_madd_ref(size_t n, const float* a, float bf, const float* b, float* c)
 
 int fvec_madd_and_argmin_ref(size_t n, const float* a, float bf, const float* b, float* c);
 
+/// inner product of two int8 code vectors
+float fvec_inner_product_sq8_ref(const int8_t* x, const int8_t* y, size_t d);
+
+/// Squared L2 distance between two fp16 vectors
+float fvec_L2sqr_fp16_ref(const uint16_t* x, const uint16_t* y, size_t d);
+
+/// inner product of two fp16 vectors
+float fvec_inner_product_fp16_ref(const uint16_t* x, const uint16_t* y, size_t d);
+
+/// Squared L2 distance between two bf16 vectors
+float fvec_L2sqr_bf16_ref(const uint16_t* x, const uint16_t* y, size_t d);
+
+/// inner product of two bf16 vectors
+float fvec_inner_product_bf16_ref(const uint16_t* x, const uint16_t* y, size_t d);
+
+/// hamming distance of two binary codes of code_size bytes
+uint32_t hamming_distance_ref(const uint8_t* x, const uint8_t* y, size_t code_size);
+
+/// convert between IEEE 754 half and single precision, round to nearest even
+float fp16_to_fp32_ref(uint16_t h);
+uint16_t fp32_to_fp16_ref(float f);
+
+/// convert between bfloat16 and single precision, round to nearest even
+float bf16_to_fp32_ref(uint16_t h);
+uint16_t fp32_to_bf16_ref(float f);
+
 }  // namespace dingodb
 
 #endif  // DINGODB_SIMD_DISTANCES_REF_H_ //NOLINT
@@ -0,0 +1,134 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#if defined(__aarch64__) && defined(__ARM_FEATURE_SVE)
+
+#include "simd/distances_sve.h"
+
+#include <arm_sve.h>
+
+#include <cstdint>
+
+namespace dingodb {
+
+// Vector length agnostic loops, the tail is handled by predicate of whilelt, so no scalar remainder.
+
+float fvec_L2sqr_sve(const float* x, const float* y, size_t d) {
+  svfloat32_t msum = svdup_n_f32(0.0f);
+  for (size_t i = 0; i < d; i += svcntw()) {
+    svbool_t pg = svwhilelt_b32_u64(i, d);
+    svfloat32_t diff = svsub_f32_x(pg, svld1_f32(pg, x + i), svld1_f32(pg, y + i));
+    msum = svmla_f32_m(pg, msum, diff, diff);
+  }
+  return svaddv_f32(svptrue_b32(), msum);
+}
+
+float fvec_inner_product_sve(const float* x, const float* y, size_t d) {
+  svfloat32_t msum = svdup_n_f32(0.0f);
+  for (size_t i = 0; i < d; i += svcntw()) {
+    svbool_t pg = svwhilelt_b32_u64(i, d);
+    msum = svmla_f32_m(pg, msum, svld1_f32(pg, x + i), svld1_f32(pg, y + i));
+  }
+  return svaddv_f32(svptrue_b32(), msum);
+}
+
+float fvec_L1_sve(const float* x, const float* y, size_t d) {
+  svfloat32_t msum = svdup_n_f32(0.0f);
+  for (size_t i = 0; i < d; i += svcntw()) {
+    svbool_t pg = svwhilelt_b32_u64(i, d);
+    msum = svadd_f32_m(pg, msum, svabd_f32_x(pg, svld1_f32(pg, x + i), svld1_f32(pg, y + i)));
+  }
+  return svaddv_f32(svptrue_b32(), msum);
+}
+
+float fvec_Linf_sve(const float* x, const float* y, size_t d) {
+  svfloat32_t mmax = svdup_n_f32(0.0f);
+  for (size_t i = 0; i < d; i += svcntw()) {
+    svbool_t pg = svwhilelt_b32_u64(i, d);
+    mmax = svmax_f32_m(pg, mmax, svabd_f32_x(pg, svld1_f32(pg, x + i), svld1_f32(pg, y + i)));
+  }
+  return svmaxv_f32(svptrue_b32(), mmax);
+}
+
+float fvec_norm_L2sqr_sve(const float* x, size_t d) {
+  svfloat32_t msum = svdup_n_f32(0.0f);
+  for (size_t i = 0; i < d; i += svcntw()) {
+    svbool_t pg = svwhilelt_b32_u64(i, d);
+    svfloat32_t mx = svld1_f32(pg, x + i);
+    msum = svmla_f32_m(pg, msum, mx, mx);
+  }
+  return svaddv_f32(svptrue_b32(), msum);
+}
+
+// Distances of x to a block of 4 y rows, x is loaded once for all rows and every row has its own accumulator.
+template <bool kL2>
+static inline void fvec_distance_batch_4_sve(const float* x, const float* y, size_t d, float* dis) {
+  svfloat32_t msum0 = svdup_n_f32(0.0f);
+  svfloat32_t msum1 = svdup_n_f32(0.0f);
+  svfloat32_t msum2 = svdup_n_f32(0.0f);
+  svfloat32_t msum3 = svdup_n_f32(0.0f);
+
+  for (size_t i = 0; i < d; i += svcntw()) {
+    svbool_t pg = svwhilelt_b32_u64(i, d);
+    svfloat32_t mx = svld1_f32(pg, x + i);
+    svfloat32_t my0 = svld1_f32(pg, y + i);
+    svfloat32_t my1 = svld1_f32(pg, y + d + i);
+    svfloat32_t my2 = svld1_f32(pg, y + 2 * d + i);
+    svfloat32_t my3 = svld1_f32(pg, y + 3 * d + i);
+    if constexpr (kL2) {
+      svfloat32_t diff0 = svsub_f32_x(pg, mx, my0);
+      svfloat32_t diff1 = svsub_f32_x(pg, mx, my1);
+      svfloat32_t diff2 = svsub_f32_x(pg, mx, my2);
+      svfloat32_t diff3 = svsub_f32_x(pg, mx, my3);
+      msum0 = svmla_f32_m(pg, msum0, diff0, diff0);
+      msum1 = svmla_f32_m(pg, msum1, diff1, diff1);
+      msum2 = svmla_f32_m(pg, msum2, diff2, diff2);
+      msum3 = svmla_f32_m(pg, msum3, diff3, diff3);
+    } else {
+      msum0 = svmla_f32_m(pg, msum0, mx, my0);
+      msum1 = svmla_f32_m(pg, msum1, mx, my1);
+      msum2 = svmla_f32_m(pg, msum2, mx, my2);
+      msum3 = svmla_f32_m(pg, msum3, mx, my3);
+    }
+  }
+
+  svbool_t all = svptrue_b32();
+  dis[0] = svaddv_f32(all, msum0);
+  dis[1] = svaddv_f32(all, msum1);
+  dis[2] = svaddv_f32(all, msum2);
+  dis[3] = svaddv_f32(all, msum3);
+}
+
+void fvec_L2sqr_ny_sve(float* dis, const float* x, const float* y, size_t d, size_t ny) {
+  size_t i = 0;
+  for (; i + 4 <= ny; i += 4) {
+    fvec_distance_batch_4_sve<true>(x, y + i * d, d, dis + i);
+  }
+  for (; i < ny; ++i) {
+    dis[i] = fvec_L2sqr_sve(x, y + i * d, d);
+  }
+}
+
+void fvec_inner_products_ny_sve(float* ip, const float* x, const float* y, size_t d, size_t ny) {
+  size_t i = 0;
+  for (; i + 4 <= ny; i += 4) {
+    fvec_distance_batch_4_sve<false>(x, y + i * d, d, ip + i);
+  }
+  for (; i < ny; ++i) {
+    ip[i] = fvec_inner_product_sve(x, y + i * d, d);
+  }
+}
+
+}  // namespace dingodb
+#endif
@@ -24,10 +24,18 @@
 #if defined(__x86_64__)
 #include "simd/distances_avx.h"
 #include "simd/distances_avx512.h"
+#include "simd/distances_avx512bf16.h"
 #include "simd/distances_sse.h"
 #include "simd/instruction_set.h"
 #endif
 
+#if defined(__aarch64__)
+#include <sys/auxv.h>
+
+#include "simd/distances_neon.h"
+#include "simd/distances_sve.h"
+#endif
+
 #include "simd/distances_ref.h"
 // #include "knowhere/log.h"
 namespace dingodb {
@@ -38,6 +46,11 @@ bool use_avx2 = true;
 bool use_sse4_2 = true;
 #endif
 
+#if defined(__aarch64__)
+bool use_sve = true;
+bool use_neon = true;
+#endif
+
 decltype(fvec_inner_product) fvec_inner_product = fvec_inner_product_ref;
 decltype(fvec_L2sqr) fvec_L2sqr = fvec_L2sqr_ref;
 decltype(fvec_L1) fvec_L1 = fvec_L1_ref;
@@ -47,6 +60,12 @@ decltype(fvec_L2sqr_ny) fvec_L2sqr_ny = fvec_L2sqr_ny_ref;
 decltype(fvec_inner_products_ny) fvec_inner_products_ny = fvec_inner_products_ny_ref;
 decltype(fvec_madd) fvec_madd = fvec_madd_ref;
 decltype(fvec_madd_and_argmin) fvec_madd_and_argmin = fvec_madd_and_argmin_ref;
+decltype(fvec_inner_product_sq8) fvec_inner_product_sq8 = fvec_inner_product_sq8_ref;
+decltype(fvec_L2sqr_fp16) fvec_L2sqr_fp16 = fvec_L2sqr_fp16_ref;
+decltype(fvec_inner_product_fp16) fvec_inner_product_fp16 = fvec_inner_product_fp16_ref;
+decltype(fvec_L2sqr_bf16) fvec_L2sqr_bf16 = fvec_L2sqr_bf16_ref;
+decltype(fvec_inner_product_bf16) fvec_inner_product_bf16 = fvec_inner_product_bf16_ref;
+decltype(hamming_distance) hamming_distance = hamming_distance_ref;
 
 #if defined(__x86_64__)
 bool cpu_support_avx512() {
@@ -54,6 +73,16 @@ bool cpu_support_avx512() {
   return (instruction_set_inst.AVX512F() && instruction_set_inst.AVX512DQ() && instruction_set_inst.AVX512BW());
 }
 
+bool cpu_support_avx512_vpopcntdq() {
+  InstructionSet& instruction_set_inst = InstructionSet::GetInstance();
+  return cpu_support_avx512() && instruction_set_inst.AVX512VPOPCNTDQ();
+}
+
+bool cpu_support_avx512_bf16() {
+  InstructionSet& instruction_set_inst = InstructionSet::GetInstance();
+  return cpu_support_avx512() && instruction_set_inst.AVX512BF16();
+}
+
 bool cpu_support_avx2() {
   InstructionSet& instruction_set_inst = InstructionSet::GetInstance();
   return (instruction_set_inst.AVX2());
@@ -65,6 +94,17 @@ bool cpu_support_sse4_2() {
 }
 #endif
 
+#if defined(__aarch64__)
+// neon is mandatory on aarch64, sve is optional and must also be built in.
+bool cpu_support_sve() {
+#if defined(ENABLE_SIMD_SVE) && defined(HWCAP_SVE)
+  return (getauxval(AT_HWCAP) & HWCAP_SVE) != 0;
+#else
+  return false;
+#endif
+}
+#endif
+
 void fvec_hook(std::string& simd_type) {
   static std::mutex hook_mutex;
   std::lock_guard<std::mutex> lock(hook_mutex);
@@ -76,11 +116,20 @@ void fvec_hook(std::string& simd_type) {
     fvec_Linf = fvec_Linf_avx512;
 
     fvec_norm_L2sqr = fvec_norm_L2sqr_sse;
-    fvec_L2sqr_ny = fvec_L2sqr_ny_sse;
-    fvec_inner_products_ny = fvec_inner_products_ny_sse;
+    fvec_L2sqr_ny = fvec_L2sqr_ny_avx512;
+    fvec_inner_products_ny = fvec_inner_products_ny_avx512;
     fvec_madd = fvec_madd_sse;
     fvec_madd_and_argmin = fvec_madd_and_argmin_sse;
 
+    fvec_inner_product_sq8 = fvec_inner_product_sq8_avx;
+    fvec_L2sqr_fp16 = fvec_L2sqr_fp16_avx512;
+    fvec_inner_product_fp16 = fvec_inner_product_fp16_avx512;
+    fvec_L2sqr_bf16 = fvec_L2sqr_bf16_avx512;
+    fvec_inner_product_bf16 =
+        cpu_support_avx512_bf16() ? fvec_inner_product_bf16_avx512bf16 : fvec_inner_product_bf16_avx512;
+
+    hamming_distance = cpu_support_avx512_vpopcntdq() ? hamming_distance_avx512 : hamming_distance_avx;
+
     simd_type = "AVX512";
   } else if (use_avx2 && cpu_support_avx2()) {
     fvec_inner_product = fvec_inner_product_avx;
@@ -89,11 +138,19 @@ void fvec_hook(std::string& simd_type) {
     fvec_Linf = fvec_Linf_avx;
 
     fvec_norm_L2sqr = fvec_norm_L2sqr_sse;
-    fvec_L2sqr_ny = fvec_L2sqr_ny_sse;
-    fvec_inner_products_ny = fvec_inner_products_ny_sse;
+    fvec_L2sqr_ny = fvec_L2sqr_ny_avx;
+    fvec_inner_products_ny = fvec_inner_products_ny_avx;
     fvec_madd = fvec_madd_sse;
     fvec_madd_and_argmin = fvec_madd_and_argmin_sse;
 
+    fvec_inner_product_sq8 = fvec_inner_product_sq8_avx;
+    fvec_L2sqr_fp16 = fvec_L2sqr_fp16_avx;
+    fvec_inner_product_fp16 = fvec_inner_product_fp16_avx;
+    fvec_L2sqr_bf16 = fvec_L2sqr_bf16_avx;
+    fvec_inner_product_bf16 = fvec_inner_product_bf16_avx;
+
+    hamming_distance = hamming_distance_avx;
+
     simd_type = "AVX2";
   } else if (use_sse4_2 && cpu_support_sse4_2()) {
     fvec_inner_product = fvec_inner_product_sse;
@@ -107,6 +164,14 @@ void fvec_hook(std::string& simd_type) {
     fvec_madd = fvec_madd_sse;
     fvec_madd_and_argmin = fvec_madd_and_argmin_sse;
 
+    fvec_inner_product_sq8 = fvec_inner_product_sq8_ref;
+    fvec_L2sqr_fp16 = fvec_L2sqr_fp16_ref;
+    fvec_inner_product_fp16 = fvec_inner_product_fp16_ref;
+    fvec_L2sqr_bf16 = fvec_L2sqr_bf16_ref;
+    fvec_inner_product_bf16 = fvec_inner_product_bf16_ref;
+
+    hamming_distance = hamming_distance_ref;
+
     simd_type = "SSE4_2";
   } else {
     fvec_inner_product = fvec_inner_product_ref;
@@ -120,8 +185,76 @@ void fvec_hook(std::string& simd_type) {
     fvec_madd = fvec_madd_ref;
     fvec_madd_and_argmin = fvec_madd_and_argmin_ref;
 
+    fvec_inner_product_sq8 = fvec_inner_product_sq8_ref;
+    fvec_L2sqr_fp16 = fvec_L2sqr_fp16_ref;
+    fvec_inner_product_fp16 = fvec_inner_product_fp16_ref;
+    fvec_L2sqr_bf16 = fvec_L2sqr_bf16_ref;
+    fvec_inner_product_bf16 = fvec_inner_product_bf16_ref;
+
+    hamming_distance = hamming_distance_ref;
+
     simd_type = "GENERIC";
   }
+#elif defined(__aarch64__)
+  if (use_neon) {
+    fvec_inner_product = fvec_inner_product_neon;
+    fvec_L2sqr = fvec_L2sqr_neon;
+    fvec_L1 = fvec_L1_neon;
+    fvec_Linf = fvec_Linf_neon;
+
+    fvec_norm_L2sqr = fvec_norm_L2sqr_neon;
+    fvec_L2sqr_ny = fvec_L2sqr_ny_neon;
+    fvec_inner_products_ny = fvec_inner_products_ny_neon;
+    fvec_madd = fvec_madd_neon;
+    fvec_madd_and_argmin = fvec_madd_and_argmin_neon;
+
+    fvec_inner_product_sq8 = fvec_inner_product_sq8_neon;
+    fvec_L2sqr_fp16 = fvec_L2sqr_fp16_neon;
+    fvec_inner_product_fp16 = fvec_inner_product_fp16_neon;
+    fvec_L2sqr_bf16 = fvec_L2sqr_bf16_neon;
+    fvec_inner_product_bf16 = fvec_inner_product_bf16_neon;
+
+    hamming_distance = hamming_distance_neon;
+
+    simd_type = "NEON";
+  } else {
+    fvec_inner_product = fvec_inner_product_ref;
+    fvec_L2sqr = fvec_L2sqr_ref;
+    fvec_L1 = fvec_L1_ref;
+    fvec_Linf = fvec_Linf_ref;
+
+    fvec_norm_L2sqr = fvec_norm_L2sqr_ref;
+    fvec_L2sqr_ny = fvec_L2sqr_ny_ref;
+    fvec_inner_products_ny = fvec_inner_products_ny_ref;
+    fvec_madd = fvec_madd_ref;
+    fvec_madd_and_argmin = fvec_madd_and_argmin_ref;
+
+    fvec_inner_product_sq8 = fvec_inner_product_sq8_ref;
+    fvec_L2sqr_fp16 = fvec_L2sqr_fp16_ref;
+    fvec_inner_product_fp16 = fvec_inner_product_fp16_ref;
+    fvec_L2sqr_bf16 = fvec_L2sqr_bf16_ref;
+    fvec_inner_product_bf16 = fvec_inner_product_bf16_ref;
+
+    hamming_distance = hamming_distance_ref;
+
+    simd_type = "GENERIC";
+  }
+
+#if defined(ENABLE_SIMD_SVE)
+  // sve only override float kernels, others keep neon.
+  if (use_sve && cpu_support_sve()) {
+    fvec_inner_product = fvec_inner_product_sve;
+    fvec_L2sqr = fvec_L2sqr_sve;
+    fvec_L1 = fvec_L1_sve;
+    fvec_Linf = fvec_Linf_sve;
+
+    fvec_norm_L2sqr = fvec_norm_L2sqr_sve;
+    fvec_L2sqr_ny = fvec_L2sqr_ny_sve;
+    fvec_inner_products_ny = fvec_inner_products_ny_sve;
+
+    simd_type = "SVE";
+  }
+#endif
 #endif
 }
 
@@ -136,6 +269,14 @@ void fvec_hook_info(std::string& simd_type) {
   } else {
     simd_type = "GENERIC";
   }
+#elif defined(__aarch64__)
+  if (use_sve && cpu_support_sve()) {
+    simd_type = "SVE";
+  } else if (use_neon) {
+    simd_type = "NEON";
+  } else {
+    simd_type = "GENERIC";
+  }
 #endif
 }
 
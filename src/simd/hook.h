@@ -17,6 +17,8 @@
 #ifndef DINGODB_SIMD_HOOK_H_
 #define DINGODB_SIMD_HOOK_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 namespace dingodb {
 
@@ -30,18 +32,39 @@ extern void (*fvec_inner_products_ny)(float*, const float*, const float*, size_t
 extern void (*fvec_madd)(size_t, const float*, float, const float*, float*);
 extern int (*fvec_madd_and_argmin)(size_t, const float*, float, const float*, float*);
 
+// scalar quantized vector kernels
+extern float (*fvec_inner_product_sq8)(const int8_t*, const int8_t*, size_t);
+extern float (*fvec_L2sqr_fp16)(const uint16_t*, const uint16_t*, size_t);
+extern float (*fvec_inner_product_fp16)(const uint16_t*, const uint16_t*, size_t);
+extern float (*fvec_L2sqr_bf16)(const uint16_t*, const uint16_t*, size_t);
+extern float (*fvec_inner_product_bf16)(const uint16_t*, const uint16_t*, size_t);
+
+// binary vector kernels, size is code size in bytes
+extern uint32_t (*hamming_distance)(const uint8_t*, const uint8_t*, size_t);
+
 #if defined(__x86_64__)
 extern bool use_avx512;
 extern bool use_avx2;
 extern bool use_sse4_2;
 #endif
 
+#if defined(__aarch64__)
+extern bool use_sve;
+extern bool use_neon;
+#endif
+
 #if defined(__x86_64__)
 bool cpu_support_avx512();
+bool cpu_support_avx512_vpopcntdq();
+bool cpu_support_avx512_bf16();
 bool cpu_support_avx2();
 bool cpu_support_sse4_2();
 #endif
 
+#if defined(__aarch64__)
+bool cpu_support_sve();
+#endif
+
 void fvec_hook(std::string& simd_type);
 
 void fvec_hook_info(std::string& simd_type);
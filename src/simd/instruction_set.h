@@ -44,6 +44,7 @@ class InstructionSet {
         f_1_EDX_{0},
         f_7_EBX_{0},
         f_7_ECX_{0},
+        f_7_1_EAX_{0},
         f_81_ECX_{0},
         f_81_EDX_{0},
         data_{},
@@ -83,6 +84,10 @@ class InstructionSet {
     if (nIds_ >= 7) {
       f_7_EBX_ = data_[7][1];
       f_7_ECX_ = data_[7][2];
+
+      // sub leaf 1 of function 0x00000007
+      __cpuid_count(7, 1, cpui[0], cpui[1], cpui[2], cpui[3]);
+      f_7_1_EAX_ = cpui[0];
     }
 
     // Calling __cpuid with 0x80000000 as the function_id argument
@@ -165,6 +170,9 @@ class InstructionSet {
   bool AVX512VL() { return f_7_EBX_[31]; }
 
   bool PREFETCHWT1() { return f_7_ECX_[0]; }
+  bool AVX512VPOPCNTDQ() { return f_7_ECX_[14]; }
+
+  bool AVX512BF16() { return f_7_1_EAX_[5]; }
 
   bool LAHF() { return f_81_ECX_[0]; }
   bool LZCNT() { return isIntel_ && f_81_ECX_[5]; }
@@ -190,6 +198,7 @@ class InstructionSet {
   std::bitset<32> f_1_EDX_;
   std::bitset<32> f_7_EBX_;
   std::bitset<32> f_7_ECX_;
+  std::bitset<32> f_7_1_EAX_;
   std::bitset<32> f_81_ECX_;
   std::bitset<32> f_81_EDX_;
   std::vector<std::array<int, 4>> data_;
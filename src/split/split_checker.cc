@@ -16,18 +16,24 @@
 
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <queue>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "common/constant.h"
+#include "common/gflag_validator.h"
 #include "common/helper.h"
 #include "config/config_helper.h"
+#include "crontab/timer_wheel.h"
 #include "engine/iterator.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "meta/store_meta_manager.h"
 #include "mvcc/codec.h"
 #include "proto/common.pb.h"
@@ -40,6 +46,64 @@
 namespace dingodb {
 DECLARE_bool(enable_region_split_and_merge_for_lite);
 DECLARE_bool(region_enable_auto_split);
+DECLARE_int32(crontab_region_spread_num);
+
+DEFINE_bool(region_enable_load_split, false, "split small but hot region by sampled request keys");
+DEFINE_validator(region_enable_load_split, &PassBool);
+DEFINE_uint32(region_load_split_sample_key_num, 256, "max sampled request keys of region for load split");
+BRPC_VALIDATE_GFLAG(region_load_split_sample_key_num, brpc::PositiveInteger);
+DEFINE_int64(region_load_split_qps, 3000, "split region by load when request keys per second exceed this");
+BRPC_VALIDATE_GFLAG(region_load_split_qps, brpc::PositiveInteger);
+
+DEFINE_bool(region_split_check_use_key_sample, true,
+            "estimate split key by key samples in sst table properties instead of scan region");
+DEFINE_validator(region_split_check_use_key_sample, &PassBool);
+
+// too few samples can not tell the hot range.
+static const size_t kLoadSplitMinSampleKeyNum = 16;
+
+// Key samples of all column families from sst metadata, sorted by key, size is the sum of samples.
+// Return false when some sst has no samples or there is no sample, caller should fallback to scan region.
+static bool GetSortedKeySamples(RawEnginePtr raw_engine, const pb::common::Range& range,
+                                const std::vector<std::string>& cf_names,
+                                std::vector<std::pair<std::string, int64_t>>& samples, int64_t& size) {
+  if (!FLAGS_region_split_check_use_key_sample) {
+    return false;
+  }
+
+  for (const auto& cf_name : cf_names) {
+    auto status = raw_engine->GetKeySamples(cf_name, range, samples);
+    if (!status.ok()) {
+      DINGO_LOG(DEBUG) << fmt::format("[split.check] get key samples of cf({}) failed, error: {}", cf_name,
+                                      status.error_str());
+      return false;
+    }
+  }
+  if (samples.empty()) {
+    return false;
+  }
+
+  std::sort(samples.begin(), samples.end());
+  size = 0;
+  for (const auto& sample : samples) {
+    size += sample.second;
+  }
+
+  return true;
+}
+
+// First sample key which size of data before it reach pos.
+static std::string FindSampleKey(const std::vector<std::pair<std::string, int64_t>>& samples, int64_t pos) {
+  int64_t size = 0;
+  for (const auto& [key, sample_size] : samples) {
+    size += sample_size;
+    if (size >= pos) {
+      return key;
+    }
+  }
+
+  return "";
+}
 
 MergedIterator::MergedIterator(RawEnginePtr raw_engine, const std::vector<std::string>& cf_names,
                                const std::string& end_key)
@@ -49,6 +113,7 @@ MergedIterator::MergedIterator(RawEnginePtr raw_engine, const std::vector<std::s
   for (const auto& cf_name : cf_names) {
     IteratorOptions options;
     options.upper_bound = end_key;
+    options.scan_class = ScanClass::kSplitCheck;
     auto iter = raw_engine->Reader()->NewIterator(cf_name, snapshot, options);
     iters_.push_back(iter);
   }
@@ -99,6 +164,14 @@ void MergedIterator::Next(IteratorPtr iter, int iter_pos) {
 // base physics key, contain key of multi version.
 std::string HalfSplitChecker::SplitKey(store::RegionPtr region, const pb::common::Range& range,
                                        const std::vector<std::string>& cf_names, uint32_t& count, int64_t& size) {
+  std::vector<std::pair<std::string, int64_t>> samples;
+  if (GetSortedKeySamples(raw_engine_, range, cf_names, samples, size)) {
+    DINGO_LOG(INFO) << fmt::format(
+        "[split.check][region({})] policy(HALF) split_threshold_size({}) actual_size({}) sample_count({})",
+        region->Id(), split_threshold_size_, size, samples.size());
+    return size >= split_threshold_size_ ? FindSampleKey(samples, size / 2) : "";
+  }
+
   MergedIterator iter(raw_engine_, cf_names, range.end_key());
   iter.Seek(range.start_key());
 
@@ -136,13 +209,21 @@ std::string HalfSplitChecker::SplitKey(store::RegionPtr region, const pb::common
 // base physics key, contain key of multi version.
 std::string SizeSplitChecker::SplitKey(store::RegionPtr region, const pb::common::Range& range,
                                        const std::vector<std::string>& cf_names, uint32_t& count, int64_t& size) {
+  int64_t split_pos = split_size_ * split_ratio_;
+  std::vector<std::pair<std::string, int64_t>> samples;
+  if (GetSortedKeySamples(raw_engine_, range, cf_names, samples, size)) {
+    DINGO_LOG(INFO) << fmt::format(
+        "[split.check][region({})] policy(SIZE) split_size({}) split_ratio({}) actual_size({}) sample_count({})",
+        region->Id(), split_size_, split_ratio_, size, samples.size());
+    return size >= split_size_ ? FindSampleKey(samples, split_pos) : "";
+  }
+
   MergedIterator iter(raw_engine_, cf_names, range.end_key());
   iter.Seek(range.start_key());
 
   std::string prev_key;
   std::string split_key;
   bool is_split = false;
-  int64_t split_pos = split_size_ * split_ratio_;
   for (; iter.Valid(); iter.Next()) {
     size += iter.KeyValueSize();
     if (split_key.empty() && size >= split_pos) {
@@ -197,6 +278,61 @@ std::string KeysSplitChecker::SplitKey(store::RegionPtr region, const pb::common
   return is_split ? split_key : "";
 }
 
+std::string LoadSplitChecker::SplitKey(store::RegionPtr region, const pb::common::Range& /*range*/,
+                                       const std::vector<std::string>& /*cf_names*/, uint32_t& /*count*/,
+                                       int64_t& /*size*/) {
+  std::string split_key = CalcSplitKey(sample_keys_);
+  // split at start key make a empty region
+  if (split_key.empty() || split_key <= region->Range(false).start_key()) {
+    return "";
+  }
+
+  return mvcc::Codec::EncodeKey(split_key, Constant::kMaxVer);
+}
+
+std::string LoadSplitChecker::CalcSplitKey(std::vector<std::string>& sample_keys) {
+  size_t size = sample_keys.size();
+  if (size < kLoadSplitMinSampleKeyNum) {
+    return "";
+  }
+  std::sort(sample_keys.begin(), sample_keys.end());
+
+  // split key must be a boundary of different keys, left side is [0, pos).
+  // prefer boundary after median, else before median, each side keep at least a quarter of requests.
+  size_t mid = size / 2;
+  for (size_t pos = mid; pos <= size * 3 / 4; ++pos) {
+    if (sample_keys[pos] != sample_keys[pos - 1]) {
+      return sample_keys[pos];
+    }
+  }
+  for (size_t pos = mid; pos >= size / 4 && pos > 0; --pos) {
+    if (sample_keys[pos] != sample_keys[pos - 1]) {
+      return sample_keys[pos];
+    }
+  }
+
+  return "";
+}
+
+// Take sampled request keys of region, build load split checker when region is hot.
+static std::shared_ptr<SplitChecker> BuildLoadSplitChecker(store::RegionPtr region) {
+  std::vector<std::string> sample_keys;
+  int64_t elapsed_ms = 0;
+  int64_t count = region->GetKeySampler().Take(sample_keys, elapsed_ms);
+  if (!FLAGS_region_enable_load_split || elapsed_ms <= 0) {
+    return nullptr;
+  }
+
+  int64_t qps = count * 1000 / elapsed_ms;
+  if (qps < FLAGS_region_load_split_qps || sample_keys.size() < kLoadSplitMinSampleKeyNum) {
+    return nullptr;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[split.check][region({})] hot region qps({}) sample keys({})", region->Id(), qps,
+                                 sample_keys.size());
+  return std::make_shared<LoadSplitChecker>(std::move(sample_keys));
+}
+
 static bool CheckLeaderAndFollowerStatus(int64_t region_id) {
   auto region = Server::GetInstance().GetRegion(region_id);
   if (region == nullptr) {
@@ -439,12 +575,19 @@ void PreSplitCheckTask::PreSplitCheck() {
   auto metrics = Server::GetInstance().GetStoreMetricsManager()->GetStoreRegionMetrics();
   auto regions = GET_STORE_REGION_META->GetAllAliveRegion();
   int64_t split_check_approximate_size = ConfigHelper::GetSplitCheckApproximateSize();
+
+  // crontab run crontab_region_spread_num times per split check interval, every round check part of regions.
+  static RoundSpreader spreader(FLAGS_crontab_region_spread_num);
+  spreader.NextRound();
+
   for (auto& region : regions) {
-    if (!region->IsSupportSplitAndMerge()) {
+    if (!spreader.IsTurn(region->Id()) || !region->IsSupportSplitAndMerge()) {
       continue;
     }
 
     auto region_metric = metrics->GetMetrics(region->Id());
+    // hot region split by load regardless of size
+    auto load_split_checker = BuildLoadSplitChecker(region);
     bool need_scan_check = true;
     std::string reason;
     do {
@@ -483,7 +626,8 @@ void PreSplitCheckTask::PreSplitCheck() {
         reason = "not leader or follower abnormal";
         break;
       }
-      if (region_metric->InnerRegionMetrics().region_size() < split_check_approximate_size) {
+      if (load_split_checker == nullptr &&
+          region_metric->InnerRegionMetrics().region_size() < split_check_approximate_size) {
         need_scan_check = false;
         reason = "region approximate size too small";
         break;
@@ -521,7 +665,7 @@ void PreSplitCheckTask::PreSplitCheck() {
       continue;
     }
 
-    auto split_checker = BuildSplitChecker(raw_engine);
+    auto split_checker = load_split_checker != nullptr ? load_split_checker : BuildSplitChecker(raw_engine);
     if (split_checker == nullptr) {
       continue;
     }
@@ -20,6 +20,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "common/runnable.h"
@@ -65,6 +66,7 @@ class SplitChecker {
     kHalf = 0,
     kSize = 1,
     kKeys = 2,
+    kLoad = 3,
   };
 
   SplitChecker(Policy policy) : policy_(policy) {}
@@ -79,6 +81,8 @@ class SplitChecker {
       return "SIZE";
     } else if (policy_ == Policy::kKeys) {
       return "KEYS";
+    } else if (policy_ == Policy::kLoad) {
+      return "LOAD";
     }
     return "";
   };
@@ -157,6 +161,25 @@ class KeysSplitChecker : public SplitChecker {
   std::shared_ptr<RawEngine> raw_engine_;
 };
 
+// Split region based load, split key balance sampled request keys of both side.
+class LoadSplitChecker : public SplitChecker {
+ public:
+  LoadSplitChecker(std::vector<std::string> sample_keys)
+      : SplitChecker(SplitChecker::Policy::kLoad), sample_keys_(std::move(sample_keys)) {}
+  ~LoadSplitChecker() override = default;
+
+  // base sampled request key, not scan region.
+  std::string SplitKey(store::RegionPtr region, const pb::common::Range& range,
+                       const std::vector<std::string>& cf_names, uint32_t& count, int64_t& size) override;
+
+  // plain split key, empty when no key can split requests to both side, e.g. all request on one key.
+  static std::string CalcSplitKey(std::vector<std::string>& sample_keys);
+
+ private:
+  // Sampled plain key of request.
+  std::vector<std::string> sample_keys_;
+};
+
 // Multiple worker run split check task.
 class SplitCheckWorkers {
  public:
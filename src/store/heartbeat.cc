@@ -23,9 +23,14 @@
 #include <set>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
+#include "bthread/mutex.h"
+#include "bthread/unstable.h"
 #include "butil/compiler_specific.h"
+#include "butil/fast_rand.h"
 #include "butil/status.h"
 #include "butil/time.h"
+#include "common/gflag_validator.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/role.h"
@@ -53,11 +58,93 @@ DEFINE_int64(store_heartbeat_report_region_multiple, 3,
              "store heartbeat report region multiple, this defines how many times of heartbeat will report "
              "region_metrics once to coordinator");
 
+DEFINE_bool(enable_store_heartbeat_report_dirty_region, true,
+            "store heartbeat report region_metrics of dirty region between full report, dirty means leader, state or "
+            "epoch changed since last report");
+DEFINE_validator(enable_store_heartbeat_report_dirty_region, &PassBool);
+DEFINE_string(store_heartbeat_compress_type, "snappy", "store heartbeat request compress type, snappy/gzip/zlib/none");
+DEFINE_int64(store_heartbeat_compress_min_bytes, 4096, "compress store heartbeat request only when larger than this");
+BRPC_VALIDATE_GFLAG(store_heartbeat_compress_min_bytes, brpc::NonNegativeInteger);
+DEFINE_int64(store_heartbeat_jitter_ms, 500, "random delay of periodic store heartbeat, avoid burst of all stores");
+BRPC_VALIDATE_GFLAG(store_heartbeat_jitter_ms, brpc::NonNegativeInteger);
+
 DECLARE_bool(enable_balance_leader);
 DECLARE_bool(enable_balance_region);
 
 std::atomic<uint64_t> HeartbeatTask::heartbeat_counter = 0;
 
+// Region status of last report, region alter from it is dirty and reported in next heartbeat.
+struct RegionReportState {
+  int64_t leader_id{0};
+  pb::common::StoreRegionState state{pb::common::StoreRegionState::NEW};
+  int64_t epoch_version{0};
+  int64_t epoch_conf_version{0};
+
+  bool operator==(const RegionReportState& other) const {
+    return leader_id == other.leader_id && state == other.state && epoch_version == other.epoch_version &&
+           epoch_conf_version == other.epoch_conf_version;
+  }
+};
+
+class RegionReportStates {
+ public:
+  RegionReportStates() { bthread_mutex_init(&mutex_, nullptr); }
+  ~RegionReportStates() { bthread_mutex_destroy(&mutex_); }
+
+  static RegionReportStates& GetInstance() {
+    static RegionReportStates instance;
+    return instance;
+  }
+
+  // full report replace all states, so deleted regions are dropped.
+  void Set(std::map<int64_t, RegionReportState>&& states, bool is_full) {
+    BAIDU_SCOPED_LOCK(mutex_);
+    if (is_full) {
+      states_.swap(states);
+    } else {
+      for (auto& [region_id, state] : states) {
+        states_.insert_or_assign(region_id, state);
+      }
+    }
+  }
+
+  std::vector<int64_t> GetDirtyRegionIds(const std::vector<store::RegionPtr>& regions) {
+    std::vector<int64_t> region_ids;
+
+    BAIDU_SCOPED_LOCK(mutex_);
+    for (const auto& region : regions) {
+      auto it = states_.find(region->Id());
+      if (it == states_.end() || !(it->second == GenState(region))) {
+        region_ids.push_back(region->Id());
+      }
+    }
+    return region_ids;
+  }
+
+  static RegionReportState GenState(store::RegionPtr region) {
+    auto epoch = region->Epoch();
+    return {region->LeaderId(), region->State(), epoch.version(), epoch.conf_version()};
+  }
+
+ private:
+  bthread_mutex_t mutex_;
+  std::map<int64_t, RegionReportState> states_;
+};
+
+static brpc::CompressType GetHeartbeatCompressType(int64_t request_size) {
+  if (request_size < FLAGS_store_heartbeat_compress_min_bytes) {
+    return brpc::COMPRESS_TYPE_NONE;
+  }
+  if (FLAGS_store_heartbeat_compress_type == "snappy") {
+    return brpc::COMPRESS_TYPE_SNAPPY;
+  } else if (FLAGS_store_heartbeat_compress_type == "gzip") {
+    return brpc::COMPRESS_TYPE_GZIP;
+  } else if (FLAGS_store_heartbeat_compress_type == "zlib") {
+    return brpc::COMPRESS_TYPE_ZLIB;
+  }
+  return brpc::COMPRESS_TYPE_NONE;
+}
+
 void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> coordinator_interaction,
                                        std::vector<int64_t> region_ids, bool is_update_epoch_version) {
   auto start_time = Helper::TimestampMs();
@@ -85,6 +172,17 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
   // region_metrics, this is for reduce heartbeat size and cpu usage.
   bool need_report_region_metrics =
       !region_ids.empty() || (temp_heartbeat_count % FLAGS_store_heartbeat_report_region_multiple == 0);
+  bool is_full_report = region_ids.empty() && need_report_region_metrics;
+
+  // between full report, only report dirty regions, it can not update region definition in coordinator.
+  if (!need_report_region_metrics && FLAGS_enable_store_heartbeat_report_dirty_region) {
+    region_ids = RegionReportStates::GetInstance().GetDirtyRegionIds(
+        store_meta_manager->GetStoreRegionMeta()->GetAllRegion());
+    if (!region_ids.empty()) {
+      need_report_region_metrics = true;
+      is_update_epoch_version = false;
+    }
+  }
 
   // construct store_own_metrics
   *(request.mutable_store_metrics()) = store_metrics_manager->GetStoreMetrics()->Metrics();
@@ -101,6 +199,7 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
     DINGO_LOG(INFO) << fmt::format("[heartbeat.store] start_time({}) heartbeat_counter: {}", first_start_time,
                                    temp_heartbeat_count);
 
+    std::map<int64_t, RegionReportState> report_states;
     auto* mut_region_metrics_map = request.mutable_store_metrics()->mutable_region_metrics_map();
     auto region_metrics = store_metrics_manager->GetStoreRegionMetrics();
     std::vector<store::RegionPtr> region_metas;
@@ -205,7 +304,11 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
       }
 
       mut_region_metrics_map->insert({inner_region.id(), tmp_region_metrics});
+      report_states[inner_region.id()] = {inner_region.leader_id(), inner_region.state(),
+                                          inner_region.definition().epoch().version(),
+                                          inner_region.definition().epoch().conf_version()};
     }
+    RegionReportStates::GetInstance().Set(std::move(report_states), is_full_report);
 
     DINGO_LOG(INFO) << fmt::format(
         "[heartbeat.store] start_time({}) request region count({}) size({}) region_ids_count({}), elapsed time({} "
@@ -227,7 +330,9 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
 
   start_time = Helper::TimestampMs();
   pb::coordinator::StoreHeartbeatResponse response;
-  auto status = coordinator_interaction->SendRequest("StoreHeartbeat", request, response);
+  auto status = coordinator_interaction->SendRequest("StoreHeartbeat", request, response, 60000,
+                                                     pb::common::ServiceTypeCoordinator,
+                                                     GetHeartbeatCompressType(request.ByteSizeLong()));
   if (!status.ok()) {
     DINGO_LOG(WARNING) << fmt::format("[heartbeat.store] start_time({}) store heartbeat failed, error: {}",
                                       first_start_time, Helper::PrintStatus(status));
@@ -651,9 +756,26 @@ void Heartbeat::TriggerStoreHeartbeat(std::vector<int64_t> region_ids, bool is_u
   // Free at ExecuteRoutine()
   auto task = std::make_shared<HeartbeatTask>(Server::GetInstance().GetCoordinatorInteraction(), region_ids,
                                               is_update_epoch_version);
+
+  // periodic heartbeat is delayed randomly, partial heartbeat is sent immediately.
+  if (region_ids.empty() && FLAGS_store_heartbeat_jitter_ms > 0) {
+    auto* arg = new TaskRunnablePtr(task);
+    bthread_timer_t timer_id;
+    int64_t delay_ms = butil::fast_rand_less_than(FLAGS_store_heartbeat_jitter_ms + 1);
+    if (bthread_timer_add(&timer_id, butil::milliseconds_from_now(delay_ms), ExecuteDelayTask, arg) == 0) {
+      return;
+    }
+    delete arg;
+  }
+
   Server::GetInstance().GetHeartbeat()->Execute(task);
 }
 
+void Heartbeat::ExecuteDelayTask(void* arg) {
+  std::unique_ptr<TaskRunnablePtr> task(static_cast<TaskRunnablePtr*>(arg));
+  Server::GetInstance().GetHeartbeat()->Execute(*task);
+}
+
 void Heartbeat::TriggerCoordinatorUpdateState(void*) {
   // Free at ExecuteRoutine()
   auto task = std::make_shared<CoordinatorUpdateStateTask>(Server::GetInstance().GetCoordinatorControl());
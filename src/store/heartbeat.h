@@ -258,6 +258,8 @@ class Heartbeat {
 
  private:
   bool Execute(TaskRunnablePtr task);
+  // bthread timer callback, arg is heap allocated TaskRunnablePtr.
+  static void ExecuteDelayTask(void* arg);
 
   WorkerPtr worker_;
 };
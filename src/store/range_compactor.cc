@@ -0,0 +1,142 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "store/range_compactor.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "brpc/reloadable_flags.h"
+#include "bthread/mutex.h"
+#include "common/gflag_validator.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_delete_range_compact, true, "enable compact deleted span after large delete range");
+DEFINE_validator(enable_delete_range_compact, &PassBool);
+DEFINE_int64(delete_range_compact_min_bytes, 64 * 1024 * 1024,
+             "delete range approximate size exceed it will trigger compact deleted span");
+BRPC_VALIDATE_GFLAG(delete_range_compact_min_bytes, brpc::NonNegativeInteger);
+
+void RangeCompactTask::Run() { range_compactor_->Compact(region_id_); }
+
+RangeCompactor::RangeCompactor() {
+  worker_ = Worker::New();
+  bthread_mutex_init(&mutex_, nullptr);
+}
+
+RangeCompactor::~RangeCompactor() { bthread_mutex_destroy(&mutex_); }
+
+bool RangeCompactor::Init() { return worker_->Init(); }
+
+void RangeCompactor::Destroy() { worker_->Destroy(); }
+
+int64_t RangeCompactor::GetDeletedSize(RawEnginePtr raw_engine,
+                                       const std::map<std::string, std::vector<pb::common::Range>>& range_with_cfs) {
+  int64_t size = 0;
+  for (const auto& [cf_name, ranges] : range_with_cfs) {
+    // Data of deleted span still in sst file before compaction.
+    std::vector<pb::common::Range> mut_ranges = ranges;
+    for (auto range_size : raw_engine->GetApproximateSizes(cf_name, mut_ranges)) {
+      size += range_size;
+    }
+  }
+
+  return size;
+}
+
+void RangeCompactor::OnDeleteRange(int64_t region_id, RawEnginePtr raw_engine,
+                                   const std::map<std::string, std::vector<pb::common::Range>>& range_with_cfs,
+                                   store::RegionMetricsPtr region_metrics) {
+  int64_t tombstone_count = 0;
+  for (const auto& [_, ranges] : range_with_cfs) {
+    tombstone_count += ranges.size();
+  }
+  if (region_metrics != nullptr) {
+    region_metrics->IncDeleteRangeTombstoneCount(tombstone_count);
+  }
+
+  if (!FLAGS_enable_delete_range_compact || raw_engine == nullptr) {
+    return;
+  }
+
+  if (GetDeletedSize(raw_engine, range_with_cfs) < FLAGS_delete_range_compact_min_bytes) {
+    return;
+  }
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = pending_compactions_.find(region_id);
+    if (it != pending_compactions_.end()) {
+      // Merge into pending task.
+      auto& pending_compaction = it->second;
+      for (const auto& [cf_name, ranges] : range_with_cfs) {
+        auto& pending_ranges = pending_compaction.range_with_cfs[cf_name];
+        pending_ranges.insert(pending_ranges.end(), ranges.begin(), ranges.end());
+      }
+      pending_compaction.tombstone_count += tombstone_count;
+      return;
+    }
+
+    pending_compactions_[region_id] = PendingCompaction{raw_engine, region_metrics, range_with_cfs, tombstone_count};
+  }
+
+  auto task = std::make_shared<RangeCompactTask>(shared_from_this(), region_id);
+  if (!worker_->Execute(task)) {
+    DINGO_LOG(ERROR) << fmt::format("[range.compact][region({})] execute compact task failed.", region_id);
+    BAIDU_SCOPED_LOCK(mutex_);
+    pending_compactions_.erase(region_id);
+  }
+}
+
+void RangeCompactor::Compact(int64_t region_id) {
+  PendingCompaction pending_compaction;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = pending_compactions_.find(region_id);
+    if (it == pending_compactions_.end()) {
+      return;
+    }
+    pending_compaction = std::move(it->second);
+    pending_compactions_.erase(it);
+  }
+
+  int64_t start_time = Helper::TimestampMs();
+  for (const auto& [cf_name, ranges] : pending_compaction.range_with_cfs) {
+    for (const auto& range : ranges) {
+      auto status = pending_compaction.raw_engine->CompactRange(cf_name, range);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << fmt::format("[range.compact][region({})] compact cf({}) range{} failed, error: {}",
+                                        region_id, cf_name, Helper::RangeToString(range), status.error_str());
+      }
+    }
+  }
+
+  if (pending_compaction.region_metrics != nullptr) {
+    pending_compaction.region_metrics->DecDeleteRangeTombstoneCount(pending_compaction.tombstone_count);
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[range.compact][region({})] compact deleted span finish, tombstone({}) elapsed({}ms)",
+                                 region_id, pending_compaction.tombstone_count, Helper::TimestampMs() - start_time);
+}
+
+}  // namespace dingodb
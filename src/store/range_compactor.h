@@ -0,0 +1,96 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_STORE_RANGE_COMPACTOR_H_
+#define DINGODB_STORE_RANGE_COMPACTOR_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bthread/types.h"
+#include "common/runnable.h"
+#include "engine/raw_engine.h"
+#include "metrics/store_metrics_manager.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+class RangeCompactor;
+
+// Compact deleted span of one region.
+class RangeCompactTask : public TaskRunnable {
+ public:
+  RangeCompactTask(std::shared_ptr<RangeCompactor> range_compactor, int64_t region_id)
+      : range_compactor_(range_compactor), region_id_(region_id) {}
+  ~RangeCompactTask() override = default;
+
+  std::string Type() override { return "RANGE_COMPACT"; }
+
+  void Run() override;
+
+ private:
+  std::shared_ptr<RangeCompactor> range_compactor_;
+  int64_t region_id_;
+};
+
+// Range tombstones left by large delete range slow down iterator until compaction,
+// so compact the deleted span in background once the deleted data exceed threshold.
+// Delete ranges of the same region are merged into one pending task.
+class RangeCompactor : public std::enable_shared_from_this<RangeCompactor> {
+ public:
+  RangeCompactor();
+  ~RangeCompactor();
+
+  RangeCompactor(const RangeCompactor&) = delete;
+  const RangeCompactor& operator=(const RangeCompactor&) = delete;
+
+  bool Init();
+  void Destroy();
+
+  // Called by apply handler after delete range, range_with_cfs is encode range.
+  void OnDeleteRange(int64_t region_id, RawEnginePtr raw_engine,
+                     const std::map<std::string, std::vector<pb::common::Range>>& range_with_cfs,
+                     store::RegionMetricsPtr region_metrics);
+
+ private:
+  friend class RangeCompactTask;
+
+  struct PendingCompaction {
+    RawEnginePtr raw_engine;
+    store::RegionMetricsPtr region_metrics;
+    std::map<std::string, std::vector<pb::common::Range>> range_with_cfs;
+    int64_t tombstone_count{0};
+  };
+
+  static int64_t GetDeletedSize(RawEnginePtr raw_engine,
+                                const std::map<std::string, std::vector<pb::common::Range>>& range_with_cfs);
+
+  void Compact(int64_t region_id);
+
+  WorkerPtr worker_;
+
+  // Protect pending_compactions_.
+  bthread_mutex_t mutex_;
+  // region_id: pending compaction
+  std::map<int64_t, PendingCompaction> pending_compactions_;
+};
+
+using RangeCompactorPtr = std::shared_ptr<RangeCompactor>;
+
+}  // namespace dingodb
+
+#endif  // DINGODB_STORE_RANGE_COMPACTOR_H_
@@ -17,12 +17,14 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "butil/status.h"
 #include "common/context.h"
+#include "common/gflag_validator.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/role.h"
@@ -30,6 +32,8 @@
 #include "config/config_helper.h"
 #include "config/config_manager.h"
 #include "engine/raft_store_engine.h"
+#include "engine/change_capture.h"
+#include "engine/txn_engine_helper.h"
 #include "event/store_state_machine_event.h"
 #include "fmt/core.h"
 #include "fmt/format.h"
@@ -41,14 +45,19 @@
 #include "proto/coordinator.pb.h"
 #include "proto/error.pb.h"
 #include "proto/raft.pb.h"
+#include "raft/raft_cmd_codec.h"
 #include "server/server.h"
 #include "vector/codec.h"
 #include "vector/vector_index_hnsw.h"
+#include "vector/vector_index_segment_hnsw.h"
 
 DEFINE_int64(merge_committed_log_gap, 16, "merge commited log gap");
 DEFINE_int32(init_election_timeout_ms, 1000, "init election timeout");
 
 DEFINE_int64(transfer_leader_last_serving_gap_time_s, 6, "transfer leader last serving gap time");
+DEFINE_bool(enable_transfer_leader_vector_index_warmup, true,
+            "transfer leader of index region only when vector index of target peer is loaded, launch load if not");
+DEFINE_validator(enable_transfer_leader_vector_index_warmup, &PassBool);
 
 namespace dingodb {
 // Notify coordinator region command execute result.
@@ -335,6 +344,19 @@ butil::Status DeleteRegionTask::DeleteRegion(std::shared_ptr<Context> ctx, int64
         CHECK(status.ok()) << fmt::format("[control.region][region({})] delete region data txn failed, error: {}",
                                           region->Id(), status.error_str());
       }
+
+      // Compact deleted span of region, region metrics is dropped with region.
+      auto range_compactor = Server::GetInstance().GetRangeCompactor();
+      if (range_compactor != nullptr) {
+        std::map<std::string, std::vector<pb::common::Range>> range_with_cfs;
+        for (const auto& cf_name : raw_cf_names) {
+          range_with_cfs[cf_name].push_back(range);
+        }
+        for (const auto& cf_name : txn_cf_names) {
+          range_with_cfs[cf_name].push_back(range);
+        }
+        range_compactor->OnDeleteRange(region_id, region_raw_engine, range_with_cfs, nullptr);
+      }
     } else {
       auto command = std::make_shared<pb::coordinator::RegionCmd>();
       command->set_id(Helper::TimestampNs());
@@ -378,6 +400,7 @@ butil::Status DeleteRegionTask::DeleteRegion(std::shared_ptr<Context> ctx, int64
   DINGO_LOG(INFO) << fmt::format("[control.region][region({})] delete region finish, ref_count({})", region_id,
                                  region.use_count());
   store_region_meta->DeleteRegion(region_id);
+  ChangeCapture::GetInstance().Unsubscribe(region_id);
 
   return butil::Status();
 }
@@ -565,14 +588,19 @@ butil::Status SplitRegionTask::SplitRegion() {
 
   ADD_REGION_CHANGE_RECORD(*region_cmd_);
 
+  // memory pessimistic lock of parent must be in lock cf, so child region get its part.
+  auto engine = Server::GetInstance().GetEngine(parent_region->GetStoreEngineType());
+  status = TxnEngineHelper::PersistMemoryPessimisticLocks(engine, parent_region);
+  if (!status.ok()) {
+    return status;
+  }
+
   // Commit raft command
   auto ctx = std::make_shared<Context>();
   ctx->SetRegionId(region_cmd_->split_request().split_from_region_id());
   ctx->SetRegionEpoch(parent_region->Epoch());
-  status = Server::GetInstance()
-               .GetEngine(parent_region->GetStoreEngineType())
-               ->Write(ctx, WriteDataBuilder::BuildWrite(region_cmd_->job_id(), region_cmd_->split_request(),
-                                                         parent_region->Epoch()));
+  status = engine->Write(
+      ctx, WriteDataBuilder::BuildWrite(region_cmd_->job_id(), region_cmd_->split_request(), parent_region->Epoch()));
   DINGO_LOG_IF(ERROR, !status.ok()) << fmt::format("[control.region][region()] commit split command failed, error: {}",
                                                    status.error_str());
 
@@ -644,7 +672,7 @@ butil::Status CheckChangeRegionLog(int64_t region_id, int64_t min_applied_log_id
       region_id, min_applied_log_id, INT64_MAX, [&](const wal::LogEntry& log_entry) -> bool {
         if (log_entry.type == wal::LogEntryType::kEntryTypeData) {
           auto raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
-          CHECK(raft_cmd->ParseFromString(log_entry.out_data)) << "parse raft log fail.";
+          CHECK(RaftCmdCodec::Decode(log_entry.out_data, raft_cmd.get())) << "parse raft log fail.";
           for (const auto& request : raft_cmd->requests()) {
             if (request.cmd_type() == pb::raft::CmdType::SPLIT ||
                 request.cmd_type() == pb::raft::CmdType::PREPARE_MERGE ||
@@ -920,6 +948,14 @@ butil::Status MergeRegionTask::MergeRegion() {
   // Disable region change
   store_region_meta->UpdateTemporaryDisableChange(source_region, true);
   store_region_meta->UpdateTemporaryDisableChange(target_region, true);
+  // no new memory pessimistic lock since change is disabled, persist existing ones to be merged.
+  status = TxnEngineHelper::PersistMemoryPessimisticLocks(
+      Server::GetInstance().GetEngine(source_region->GetStoreEngineType()), source_region);
+  if (!status.ok()) {
+    store_region_meta->UpdateTemporaryDisableChange(source_region, false);
+    store_region_meta->UpdateTemporaryDisableChange(target_region, false);
+    return status;
+  }
   // Commit raft cmd
   auto ctx = std::make_shared<Context>();
   ctx->SetRegionId(source_region->Id());
@@ -1146,6 +1182,27 @@ butil::Status TransferLeaderTask::ValidateTransferLeader(std::shared_ptr<StoreMe
                                Constant::kTransferLeaderRaftLogFallBehindThreshold);
         }
       }
+
+      // Cold vector index of new leader make first searches timeout, so warm up it first,
+      // coordinator retry transfer at later balance round.
+      if (FLAGS_enable_transfer_leader_vector_index_warmup && region->Type() == pb::common::INDEX_REGION &&
+          region->VectorIndexWrapper() != nullptr) {
+        pb::node::CheckVectorIndexRequest request;
+        request.set_vector_index_id(region_id);
+        request.set_need_hold_if_absent(true);
+        pb::node::CheckVectorIndexResponse response;
+        auto endpoint = Helper::LocationToEndPoint(peer.raft_location());
+        auto status = ServiceAccess::CheckVectorIndex(request, endpoint, response);
+        if (!status.ok()) {
+          DINGO_LOG(WARNING) << fmt::format("[control.region][region({})] check peer {} vector index failed, error: {}",
+                                            region_id, Helper::EndPointToString(endpoint), status.error_str());
+        }
+
+        if (!response.is_exist()) {
+          return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, "Vector index %lu at peer %s is warming up",
+                               region_id, Helper::EndPointToString(endpoint).c_str());
+        }
+      }
     }
   }
 
@@ -1176,6 +1233,13 @@ butil::Status TransferLeaderTask::TransferLeader(std::shared_ptr<Context>, int64
   }
   auto raft_store_engine = Server::GetInstance().GetRaftStoreEngine();
   if (raft_store_engine != nullptr) {
+    auto region = store_meta_manager->GetStoreRegionMeta()->GetRegion(region_id);
+    if (region != nullptr) {
+      status = TxnEngineHelper::PersistMemoryPessimisticLocks(raft_store_engine, region);
+      if (!status.ok()) {
+        return status;
+      }
+    }
     return raft_store_engine->TransferLeader(region_id, peer);
   }
 
@@ -1396,13 +1460,15 @@ butil::Status UpdateDefinitionTask::UpdateDefinition(std::shared_ptr<Context> /*
   // check if is changing hnsw max_elements
   if (new_definition.index_parameter().vector_index_parameter().has_hnsw_parameter()) {
     auto hnsw_index = std::dynamic_pointer_cast<VectorIndexHnsw>(vector_index);
-    if (hnsw_index == nullptr) {
+    auto segment_hnsw_index = std::dynamic_pointer_cast<VectorIndexSegmentHnsw>(vector_index);
+    if (hnsw_index == nullptr && segment_hnsw_index == nullptr) {
       return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, fmt::format("Not found hnsw index {}", region_id));
     }
 
     auto new_max_elements = new_definition.index_parameter().vector_index_parameter().hnsw_parameter().max_elements();
     int64_t old_max_elements = 0;
-    auto ret = hnsw_index->GetMaxElements(old_max_elements);
+    auto ret = hnsw_index != nullptr ? hnsw_index->GetMaxElements(old_max_elements)
+                                     : segment_hnsw_index->GetMaxElements(old_max_elements);
     if (!ret.ok()) {
       DINGO_LOG(ERROR) << fmt::format("[control.region][region({})] get hnsw index max elements failed.", region_id);
       return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND,
@@ -1415,8 +1481,8 @@ butil::Status UpdateDefinitionTask::UpdateDefinition(std::shared_ptr<Context> /*
           new_max_elements, old_max_elements);
       return butil::Status::OK();
     } else {
-      ret = hnsw_index->ResizeMaxElements(
-          new_definition.index_parameter().vector_index_parameter().hnsw_parameter().max_elements());
+      ret = hnsw_index != nullptr ? hnsw_index->ResizeMaxElements(new_max_elements)
+                                  : segment_hnsw_index->ResizeMaxElements(new_max_elements);
       if (!ret.ok()) {
         DINGO_LOG(ERROR) << fmt::format("[control.region][region({})] resize hnsw index max elements failed.",
                                         region_id);
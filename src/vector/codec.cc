@@ -16,6 +16,7 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include "common/constant.h"
@@ -28,6 +29,17 @@
 
 namespace dingodb {
 
+// package fixed length key prefix|partition_id|vector_id into buf, avoid allocate memory
+static void PackageFixedVectorKey(char prefix, int64_t partition_id, int64_t vector_id, char* buf) {
+  CHECK(prefix != 0) << fmt::format("Invalid prefix {}.", prefix);
+  CHECK(partition_id > 0) << fmt::format("Invalid partition_id {}.", partition_id);
+  CHECK(vector_id >= 0) << fmt::format("Invalid vector_id {}.", vector_id);
+
+  buf[0] = prefix;
+  SerialHelper::WriteLong(partition_id, buf + 1);
+  SerialHelper::WriteLongComparable(vector_id, buf + 9);
+}
+
 std::string VectorCodec::PackageVectorKey(char prefix, int64_t partition_id) {
   CHECK(prefix != 0) << fmt::format("Invalid prefix {}.", prefix);
   CHECK(partition_id > 0) << fmt::format("Invalid partition_id {}.", partition_id);
@@ -109,15 +121,21 @@ std::string VectorCodec::EncodeVectorKey(char prefix, int64_t partition_id) {
 }
 
 std::string VectorCodec::EncodeVectorKey(char prefix, int64_t partition_id, int64_t vector_id) {
-  std::string plain_key = PackageVectorKey(prefix, partition_id, vector_id);
+  char plain_key[Constant::kVectorKeyMaxLenWithPrefix];
+  PackageFixedVectorKey(prefix, partition_id, vector_id, plain_key);
 
-  return mvcc::Codec::EncodeBytes(plain_key);
+  std::string encode_key;
+  mvcc::Codec::EncodeBytes(std::string_view(plain_key, sizeof(plain_key)), encode_key);
+  return std::move(encode_key);
 }
 
 std::string VectorCodec::EncodeVectorKey(char prefix, int64_t partition_id, int64_t vector_id, int64_t ts) {
-  std::string plain_key = PackageVectorKey(prefix, partition_id, vector_id);
+  char plain_key[Constant::kVectorKeyMaxLenWithPrefix];
+  PackageFixedVectorKey(prefix, partition_id, vector_id, plain_key);
 
-  return mvcc::Codec::EncodeKey(plain_key, ts);
+  std::string encode_key;
+  mvcc::Codec::EncodeKey(std::string_view(plain_key, sizeof(plain_key)), ts, encode_key);
+  return std::move(encode_key);
 }
 
 std::string VectorCodec::EncodeVectorKey(char prefix, int64_t partition_id, int64_t vector_id,
@@ -134,46 +152,72 @@ std::string VectorCodec::EncodeVectorKey(char prefix, int64_t partition_id, int6
   return mvcc::Codec::EncodeKey(plain_key, ts);
 }
 
+// decode partition_id and vector_id from encode key, key without scalar key is decoded in stack buffer
+static void DecodeFixedVectorKey(const std::string_view& encode_key, int64_t& partition_id, int64_t& vector_id) {
+  // long scalar key, decode in heap
+  if (encode_key.size() != 18 && encode_key.size() != 27) {
+    std::string plain_key;
+    bool ret = mvcc::Codec::DecodeBytes(encode_key, plain_key);
+    CHECK(ret) << fmt::format("Decode vector key({}) fail.", Helper::StringToHex(encode_key));
+
+    partition_id = VectorCodec::UnPackagePartitionId(plain_key);
+    vector_id = VectorCodec::UnPackageVectorId(plain_key);
+    return;
+  }
+
+  char plain_key[mvcc::Codec::DecodeBytesMaxLength(27)];
+  size_t length = 0;
+  bool ret = mvcc::Codec::DecodeBytes(encode_key, plain_key, length);
+  CHECK(ret) << fmt::format("Decode vector key({}) fail.", Helper::StringToHex(encode_key));
+  CHECK(length == Constant::kVectorKeyMinLenWithPrefix || length >= Constant::kVectorKeyMaxLenWithPrefix)
+      << fmt::format("Decode vector key({}) fail, invalid length.", Helper::StringToHex(encode_key));
+
+  partition_id = SerialHelper::ReadLong(std::string_view(plain_key + 1, 8));
+  vector_id = length >= Constant::kVectorKeyMaxLenWithPrefix
+              ? SerialHelper::ReadLongComparable(std::string_view(plain_key + 9, 8))
+              : 0;
+}
+
 int64_t VectorCodec::DecodePartitionIdFromEncodeKey(const std::string& encode_key) {
   CHECK((encode_key.size() == 18 || encode_key.size() >= 27)) << "encode_key length is invalid.";
 
-  std::string plain_key;
-  bool ret = mvcc::Codec::DecodeBytes(encode_key, plain_key);
-  CHECK(ret) << fmt::format("Decode vector key({}) fail.", Helper::StringToHex(encode_key));
+  int64_t partition_id = 0;
+  int64_t vector_id = 0;
+  DecodeFixedVectorKey(encode_key, partition_id, vector_id);
 
-  return UnPackagePartitionId(plain_key);
+  return partition_id;
 }
 
 int64_t VectorCodec::DecodePartitionIdFromEncodeKeyWithTs(const std::string& encode_key_with_ts) {
   CHECK((encode_key_with_ts.size() == 26 || encode_key_with_ts.size() >= 35))
       << "encode_key_with_ts length is invalid.";
 
-  std::string plain_key;
-  bool ret = mvcc::Codec::DecodeBytes(TruncateTsForKey(encode_key_with_ts), plain_key);
-  CHECK(ret) << fmt::format("Decode vector key({}) fail.", Helper::StringToHex(encode_key_with_ts));
+  int64_t partition_id = 0;
+  int64_t vector_id = 0;
+  DecodeFixedVectorKey(TruncateTsForKey(encode_key_with_ts), partition_id, vector_id);
 
-  return UnPackagePartitionId(plain_key);
+  return partition_id;
 }
 
 int64_t VectorCodec::DecodeVectorIdFromEncodeKey(const std::string& encode_key) {
   CHECK((encode_key.size() == 18 || encode_key.size() >= 27)) << "encode_key length is invalid.";
 
-  std::string plain_key;
-  bool ret = mvcc::Codec::DecodeBytes(encode_key, plain_key);
-  CHECK(ret) << fmt::format("Decode vector key({}) fail.", Helper::StringToHex(encode_key));
+  int64_t partition_id = 0;
+  int64_t vector_id = 0;
+  DecodeFixedVectorKey(encode_key, partition_id, vector_id);
 
-  return UnPackageVectorId(plain_key);
+  return vector_id;
 }
 
 int64_t VectorCodec::DecodeVectorIdFromEncodeKeyWithTs(const std::string& encode_key_with_ts) {
   CHECK((encode_key_with_ts.size() == 26 || encode_key_with_ts.size() >= 35))
       << "encode_key_with_ts length is invalid.";
 
-  std::string plain_key;
-  bool ret = mvcc::Codec::DecodeBytes(TruncateTsForKey(encode_key_with_ts), plain_key);
-  CHECK(ret) << fmt::format("Decode vector key({}) fail.", Helper::StringToHex(encode_key_with_ts));
+  int64_t partition_id = 0;
+  int64_t vector_id = 0;
+  DecodeFixedVectorKey(TruncateTsForKey(encode_key_with_ts), partition_id, vector_id);
 
-  return UnPackageVectorId(plain_key);
+  return vector_id;
 }
 
 std::string VectorCodec::DecodeScalarKeyFromEncodeKey(const std::string& encode_key) {
@@ -198,12 +242,7 @@ std::string VectorCodec::DecodeScalarKeyFromEncodeKeyWithTs(const std::string& e
 void VectorCodec::DecodeFromEncodeKey(const std::string& encode_key, int64_t& partition_id, int64_t& vector_id) {
   CHECK((encode_key.size() == 18 || encode_key.size() >= 27)) << "encode_key length is invalid.";
 
-  std::string plain_key;
-  bool ret = mvcc::Codec::DecodeBytes(encode_key, plain_key);
-  CHECK(ret) << fmt::format("Decode vector key({}) fail.", Helper::StringToHex(encode_key));
-
-  partition_id = UnPackagePartitionId(plain_key);
-  vector_id = UnPackageVectorId(plain_key);
+  DecodeFixedVectorKey(encode_key, partition_id, vector_id);
 }
 
 void VectorCodec::DecodeFromEncodeKey(const std::string& encode_key, int64_t& partition_id, int64_t& vector_id,
@@ -223,12 +262,7 @@ void VectorCodec::DecodeFromEncodeKeyWithTs(const std::string& encode_key_with_t
                                             int64_t& vector_id) {
   CHECK((encode_key_with_ts.size() == 26 || encode_key_with_ts.size() >= 35))
       << "encode_key_with_ts length is invalid.";
-  std::string plain_key;
-  bool ret = mvcc::Codec::DecodeBytes(TruncateTsForKey(encode_key_with_ts), plain_key);
-  CHECK(ret) << fmt::format("Decode vector key({}) fail.", Helper::StringToHex(encode_key_with_ts));
-
-  partition_id = UnPackagePartitionId(plain_key);
-  vector_id = UnPackageVectorId(plain_key);
+  DecodeFixedVectorKey(TruncateTsForKey(encode_key_with_ts), partition_id, vector_id);
 }
 
 void VectorCodec::DecodeFromEncodeKeyWithTs(const std::string& encode_key_with_ts, int64_t& partition_id,
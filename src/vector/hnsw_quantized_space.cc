@@ -0,0 +1,200 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/hnsw_quantized_space.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "simd/distances_ref.h"
+#include "simd/hook.h"
+
+namespace dingodb {
+
+// scale and norm_sqr
+static constexpr size_t kSQ8HeaderSize = sizeof(float) * 2;
+static constexpr float kSQ8MaxCode = 127.0f;
+
+static inline float SQ8Scale(const void* code) {
+  float scale;
+  memcpy(&scale, code, sizeof(scale));
+  return scale;
+}
+
+static inline float SQ8NormSqr(const void* code) {
+  float norm_sqr;
+  memcpy(&norm_sqr, static_cast<const char*>(code) + sizeof(float), sizeof(norm_sqr));
+  return norm_sqr;
+}
+
+static inline const int8_t* SQ8Codes(const void* code) {
+  return reinterpret_cast<const int8_t*>(static_cast<const char*>(code) + kSQ8HeaderSize);
+}
+
+HnswQuantizedSpace::HnswQuantizedSpace(HnswQuantizeType quantize_type, pb::common::MetricType metric_type,
+                                       size_t dimension)
+    : quantize_type_(quantize_type),
+      metric_type_(metric_type),
+      param_({CodeSize(quantize_type, dimension), dimension}) {
+  bool is_l2 = (metric_type == pb::common::MetricType::METRIC_TYPE_L2);
+  if (quantize_type == HnswQuantizeType::kFP16) {
+    dist_func_ = is_l2 ? FP16L2Distance : FP16InnerProductDistance;
+  } else if (quantize_type == HnswQuantizeType::kBF16) {
+    dist_func_ = is_l2 ? BF16L2Distance : BF16InnerProductDistance;
+  } else {
+    dist_func_ = is_l2 ? SQ8L2Distance : SQ8InnerProductDistance;
+  }
+}
+
+bool HnswQuantizedSpace::ParseQuantizeType(const std::string& name, HnswQuantizeType& quantize_type) {
+  if (name == "none") {
+    quantize_type = HnswQuantizeType::kNone;
+  } else if (name == "sq8") {
+    quantize_type = HnswQuantizeType::kSQ8;
+  } else if (name == "fp16") {
+    quantize_type = HnswQuantizeType::kFP16;
+  } else if (name == "bf16") {
+    quantize_type = HnswQuantizeType::kBF16;
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+std::string HnswQuantizedSpace::QuantizeTypeName(HnswQuantizeType quantize_type) {
+  switch (quantize_type) {
+    case HnswQuantizeType::kSQ8:
+      return "sq8";
+    case HnswQuantizeType::kFP16:
+      return "fp16";
+    case HnswQuantizeType::kBF16:
+      return "bf16";
+    default:
+      return "none";
+  }
+}
+
+size_t HnswQuantizedSpace::CodeSize(HnswQuantizeType quantize_type, size_t dimension) {
+  switch (quantize_type) {
+    case HnswQuantizeType::kSQ8:
+      return kSQ8HeaderSize + sizeof(int8_t) * dimension;
+    case HnswQuantizeType::kFP16:
+    case HnswQuantizeType::kBF16:
+      return sizeof(uint16_t) * dimension;
+    default:
+      return sizeof(float) * dimension;
+  }
+}
+
+void HnswQuantizedSpace::Encode(const float* vector, char* code) const {
+  size_t dimension = param_.dimension;
+  if (quantize_type_ == HnswQuantizeType::kFP16 || quantize_type_ == HnswQuantizeType::kBF16) {
+    auto* half_code = reinterpret_cast<uint16_t*>(code);
+    bool is_fp16 = quantize_type_ == HnswQuantizeType::kFP16;
+    for (size_t i = 0; i < dimension; ++i) {
+      uint16_t value = is_fp16 ? fp32_to_fp16_ref(vector[i]) : fp32_to_bf16_ref(vector[i]);
+      memcpy(half_code + i, &value, sizeof(value));
+    }
+    return;
+  }
+
+  float max_abs = 0.0f;
+  for (size_t i = 0; i < dimension; ++i) {
+    max_abs = std::max(max_abs, std::fabs(vector[i]));
+  }
+
+  float scale = max_abs / kSQ8MaxCode;
+  auto* codes = reinterpret_cast<int8_t*>(code + kSQ8HeaderSize);
+  for (size_t i = 0; i < dimension; ++i) {
+    float value = scale > 0.0f ? std::round(vector[i] / scale) : 0.0f;
+    codes[i] = static_cast<int8_t>(std::clamp(value, -kSQ8MaxCode, kSQ8MaxCode));
+  }
+
+  // norm of dequantized vector, so code distance of same vector is 0.
+  float norm_sqr = scale * scale * fvec_inner_product_sq8(codes, codes, dimension);
+  memcpy(code, &scale, sizeof(scale));
+  memcpy(code + sizeof(float), &norm_sqr, sizeof(norm_sqr));
+}
+
+void HnswQuantizedSpace::Decode(const char* code, float* vector) const {
+  size_t dimension = param_.dimension;
+  if (quantize_type_ == HnswQuantizeType::kFP16 || quantize_type_ == HnswQuantizeType::kBF16) {
+    bool is_fp16 = quantize_type_ == HnswQuantizeType::kFP16;
+    for (size_t i = 0; i < dimension; ++i) {
+      uint16_t value;
+      memcpy(&value, code + i * sizeof(uint16_t), sizeof(value));
+      vector[i] = is_fp16 ? fp16_to_fp32_ref(value) : bf16_to_fp32_ref(value);
+    }
+    return;
+  }
+
+  float scale = SQ8Scale(code);
+  const int8_t* codes = SQ8Codes(code);
+  for (size_t i = 0; i < dimension; ++i) {
+    vector[i] = scale * codes[i];
+  }
+}
+
+float HnswQuantizedSpace::Distance(const float* query, const char* code) const {
+  std::vector<float> vector(param_.dimension);
+  Decode(code, vector.data());
+
+  if (metric_type_ == pb::common::MetricType::METRIC_TYPE_L2) {
+    return fvec_L2sqr(query, vector.data(), param_.dimension);
+  }
+  // same as hnswlib::InnerProductSpace
+  return 1.0f - fvec_inner_product(query, vector.data(), param_.dimension);
+}
+
+float HnswQuantizedSpace::SQ8L2Distance(const void* x, const void* y, const void* param) {
+  size_t dimension = static_cast<const Param*>(param)->dimension;
+  float scale_product = SQ8Scale(x) * SQ8Scale(y);
+  float code_inner_product = fvec_inner_product_sq8(SQ8Codes(x), SQ8Codes(y), dimension);
+  float distance = SQ8NormSqr(x) + SQ8NormSqr(y) - 2.0f * scale_product * code_inner_product;
+  return std::max(distance, 0.0f);
+}
+
+float HnswQuantizedSpace::SQ8InnerProductDistance(const void* x, const void* y, const void* param) {
+  size_t dimension = static_cast<const Param*>(param)->dimension;
+  float scale_product = SQ8Scale(x) * SQ8Scale(y);
+  return 1.0f - scale_product * fvec_inner_product_sq8(SQ8Codes(x), SQ8Codes(y), dimension);
+}
+
+float HnswQuantizedSpace::FP16L2Distance(const void* x, const void* y, const void* param) {
+  size_t dimension = static_cast<const Param*>(param)->dimension;
+  return fvec_L2sqr_fp16(static_cast<const uint16_t*>(x), static_cast<const uint16_t*>(y), dimension);
+}
+
+float HnswQuantizedSpace::FP16InnerProductDistance(const void* x, const void* y, const void* param) {
+  size_t dimension = static_cast<const Param*>(param)->dimension;
+  return 1.0f - fvec_inner_product_fp16(static_cast<const uint16_t*>(x), static_cast<const uint16_t*>(y), dimension);
+}
+
+float HnswQuantizedSpace::BF16L2Distance(const void* x, const void* y, const void* param) {
+  size_t dimension = static_cast<const Param*>(param)->dimension;
+  return fvec_L2sqr_bf16(static_cast<const uint16_t*>(x), static_cast<const uint16_t*>(y), dimension);
+}
+
+float HnswQuantizedSpace::BF16InnerProductDistance(const void* x, const void* y, const void* param) {
+  size_t dimension = static_cast<const Param*>(param)->dimension;
+  return 1.0f - fvec_inner_product_bf16(static_cast<const uint16_t*>(x), static_cast<const uint16_t*>(y), dimension);
+}
+
+}  // namespace dingodb
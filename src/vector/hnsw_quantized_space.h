@@ -0,0 +1,89 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_HNSW_QUANTIZED_SPACE_H_
+#define DINGODB_VECTOR_HNSW_QUANTIZED_SPACE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "hnswlib/hnswlib.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+enum class HnswQuantizeType {
+  kNone = 0,
+  kSQ8 = 1,
+  kFP16 = 2,
+  kBF16 = 3,
+};
+
+// Hnsw space which store scalar quantized code instead of float32 vector.
+// SQ8 code layout: | scale(float) | norm_sqr(float) | int8 * dimension |, value[i] = scale * code[i],
+// scale is per vector, so no need train.
+// FP16 code layout: | fp16 * dimension |, BF16 code layout: | bf16 * dimension |, bf16 keep range of float32
+// with less precision, both are computed in float32.
+// Only support L2 and inner product, cosine vector need normalize before encode.
+class HnswQuantizedSpace : public hnswlib::SpaceInterface<float> {
+ public:
+  HnswQuantizedSpace(HnswQuantizeType quantize_type, pb::common::MetricType metric_type, size_t dimension);
+  ~HnswQuantizedSpace() override = default;
+
+  HnswQuantizedSpace(const HnswQuantizedSpace& rhs) = delete;
+  HnswQuantizedSpace& operator=(const HnswQuantizedSpace& rhs) = delete;
+
+  // name is none/sq8/fp16/bf16.
+  static bool ParseQuantizeType(const std::string& name, HnswQuantizeType& quantize_type);
+  static std::string QuantizeTypeName(HnswQuantizeType quantize_type);
+  // Bytes of one vector stored in hnsw, kNone is float32.
+  static size_t CodeSize(HnswQuantizeType quantize_type, size_t dimension);
+
+  size_t get_data_size() override { return param_.code_size; }
+  hnswlib::DISTFUNC<float> get_dist_func() override { return dist_func_; }
+  void* get_dist_func_param() override { return &param_; }
+
+  HnswQuantizeType QuantizeType() const { return quantize_type_; }
+
+  // code must have get_data_size() bytes.
+  void Encode(const float* vector, char* code) const;
+  void Decode(const char* code, float* vector) const;
+
+  // Distance between float query and code, more accurate than distance between codes, used to re-rank.
+  float Distance(const float* query, const char* code) const;
+
+ private:
+  // HierarchicalNSW::getDataByLabel<char> read first field as element count, so code_size must be first.
+  struct Param {
+    size_t code_size;
+    size_t dimension;
+  };
+
+  static float SQ8L2Distance(const void* x, const void* y, const void* param);
+  static float SQ8InnerProductDistance(const void* x, const void* y, const void* param);
+  static float FP16L2Distance(const void* x, const void* y, const void* param);
+  static float FP16InnerProductDistance(const void* x, const void* y, const void* param);
+  static float BF16L2Distance(const void* x, const void* y, const void* param);
+  static float BF16InnerProductDistance(const void* x, const void* y, const void* param);
+
+  HnswQuantizeType quantize_type_;
+  pb::common::MetricType metric_type_;
+  Param param_;
+  hnswlib::DISTFUNC<float> dist_func_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_HNSW_QUANTIZED_SPACE_H_
@@ -0,0 +1,105 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_filter_planner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "brpc/reloadable_flags.h"
+#include "bvar/reducer.h"
+#include "common/gflag_validator.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_vector_filter_planner, true, "enable choose scalar pre filter search plan by filter selectivity");
+DEFINE_validator(enable_vector_filter_planner, &PassBool);
+DEFINE_int64(vector_filter_brute_force_max_count, 2048,
+             "scalar pre filter use brute force when matched candidate count not more than this");
+BRPC_VALIDATE_GFLAG(vector_filter_brute_force_max_count, brpc::NonNegativeInteger);
+DEFINE_double(vector_filter_post_filter_min_selectivity, 0.9,
+              "scalar pre filter use post filter when filter selectivity not less than this");
+DEFINE_validator(vector_filter_post_filter_min_selectivity, &PassDouble);
+DEFINE_int64(vector_filter_post_filter_max_topk, 8192, "scalar pre filter max oversample topk of post filter");
+BRPC_VALIDATE_GFLAG(vector_filter_post_filter_max_topk, brpc::PositiveInteger);
+
+bvar::Adder<int64_t> g_vector_filter_brute_force_count("dingo_vector_filter_brute_force_count");
+bvar::Adder<int64_t> g_vector_filter_index_filter_count("dingo_vector_filter_index_filter_count");
+bvar::Adder<int64_t> g_vector_filter_post_filter_count("dingo_vector_filter_post_filter_count");
+
+VectorFilterPlan VectorFilterPlanner::Choose(int64_t candidate_count, int64_t total_count, uint32_t topk,
+                                             bool enable_range_search) {
+  // range search result count is unknown, oversample is not work.
+  if (!FLAGS_enable_vector_filter_planner || enable_range_search) {
+    return VectorFilterPlan::kIndexFilter;
+  }
+
+  if (candidate_count <= FLAGS_vector_filter_brute_force_max_count) {
+    return VectorFilterPlan::kBruteForce;
+  }
+
+  if (total_count > 0 && static_cast<double>(candidate_count) / total_count >=
+                             FLAGS_vector_filter_post_filter_min_selectivity) {
+    if (PostFilterTopk(candidate_count, total_count, topk) < FLAGS_vector_filter_post_filter_max_topk) {
+      return VectorFilterPlan::kPostFilter;
+    }
+  }
+
+  return VectorFilterPlan::kIndexFilter;
+}
+
+uint32_t VectorFilterPlanner::PostFilterTopk(int64_t candidate_count, int64_t total_count, uint32_t topk) {
+  if (candidate_count <= 0 || total_count <= candidate_count) {
+    return topk;
+  }
+
+  // expect topk matched result in oversampled result, add margin for not uniform distribution.
+  double selectivity = static_cast<double>(candidate_count) / total_count;
+  double expect_topk = std::ceil(topk / selectivity * 1.2) + 1;
+
+  return static_cast<uint32_t>(std::min(expect_topk, static_cast<double>(FLAGS_vector_filter_post_filter_max_topk)));
+}
+
+const char* VectorFilterPlanner::PlanName(VectorFilterPlan plan) {
+  switch (plan) {
+    case VectorFilterPlan::kBruteForce:
+      return "brute_force";
+    case VectorFilterPlan::kIndexFilter:
+      return "index_filter";
+    case VectorFilterPlan::kPostFilter:
+      return "post_filter";
+    default:
+      return "unknown";
+  }
+}
+
+void VectorFilterPlanner::RecordPlan(VectorFilterPlan plan) {
+  switch (plan) {
+    case VectorFilterPlan::kBruteForce:
+      g_vector_filter_brute_force_count << 1;
+      break;
+    case VectorFilterPlan::kIndexFilter:
+      g_vector_filter_index_filter_count << 1;
+      break;
+    case VectorFilterPlan::kPostFilter:
+      g_vector_filter_post_filter_count << 1;
+      break;
+    default:
+      break;
+  }
+}
+
+}  // namespace dingodb
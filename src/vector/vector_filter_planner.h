@@ -0,0 +1,50 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_FILTER_PLANNER_H_
+#define DINGODB_VECTOR_FILTER_PLANNER_H_
+
+#include <cstdint>
+
+namespace dingodb {
+
+// Plan of scalar pre filter vector search.
+enum class VectorFilterPlan {
+  // exact distance over the matched candidates only, used when few vectors match.
+  kBruteForce = 0,
+  // pass matched ids filter into vector index, filter in traversal.
+  kIndexFilter = 1,
+  // search vector index without filter and oversample, then drop not matched, used when most vectors match.
+  kPostFilter = 2,
+};
+
+// Choose scalar pre filter search plan by the selectivity of filter,
+// selectivity is matched candidate count divided by vector index count.
+class VectorFilterPlanner {
+ public:
+  static VectorFilterPlan Choose(int64_t candidate_count, int64_t total_count, uint32_t topk,
+                                 bool enable_range_search);
+
+  // topk of post filter search, oversample by selectivity.
+  static uint32_t PostFilterTopk(int64_t candidate_count, int64_t total_count, uint32_t topk);
+
+  static const char* PlanName(VectorFilterPlan plan);
+
+  // record plan metrics.
+  static void RecordPlan(VectorFilterPlan plan);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_FILTER_PLANNER_H_
@@ -0,0 +1,140 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_hybrid_fusion.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "brpc/reloadable_flags.h"
+#include "common/gflag_validator.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+static bool ValidateHybridFusionType(const char*, const std::string& value) {
+  return value == "rrf" || value == "weighted";
+}
+DEFINE_string(vector_index_hybrid_fusion_type, "rrf", "hybrid vector and bm25 search fusion type, rrf/weighted");
+DEFINE_validator(vector_index_hybrid_fusion_type, &ValidateHybridFusionType);
+DEFINE_int32(vector_index_hybrid_rrf_k, 60, "rrf fusion score is 1 / (k + rank), larger k flatten rank difference");
+BRPC_VALIDATE_GFLAG(vector_index_hybrid_rrf_k, brpc::PositiveInteger);
+DEFINE_double(vector_index_hybrid_vector_weight, 0.5,
+              "weighted fusion weight of vector score, bm25 score weight is 1 - this, [0, 1]");
+DEFINE_validator(vector_index_hybrid_vector_weight, &PassDouble);
+
+namespace {
+
+struct Candidate {
+  int64_t id{0};
+  double score{0.0};
+  // position in vector result, -1 is only hit by bm25
+  int vector_pos{-1};
+};
+
+// min-max normalize into [0, 1], best is 1.
+double Normalize(double value, double best, double worst) {
+  if (best == worst) {
+    return 1.0;
+  }
+  return (value - worst) / (best - worst);
+}
+
+}  // namespace
+
+HybridFusionType VectorHybridFusion::FusionType() {
+  return FLAGS_vector_index_hybrid_fusion_type == "weighted" ? HybridFusionType::kWeighted : HybridFusionType::kRrf;
+}
+
+void VectorHybridFusion::Fuse(const pb::index::VectorWithDistanceResult& vector_result,
+                              const std::vector<pb::common::DocumentWithScore>& document_results, uint32_t topk,
+                              pb::index::VectorWithDistanceResult& fused_result) {
+  Fuse(FusionType(), vector_result, document_results, topk, fused_result);
+}
+
+void VectorHybridFusion::Fuse(HybridFusionType type, const pb::index::VectorWithDistanceResult& vector_result,
+                              const std::vector<pb::common::DocumentWithScore>& document_results, uint32_t topk,
+                              pb::index::VectorWithDistanceResult& fused_result) {
+  std::vector<Candidate> candidates;
+  candidates.reserve(vector_result.vector_with_distances_size() + document_results.size());
+  std::unordered_map<int64_t, size_t> candidate_pos;
+
+  auto get_candidate = [&](int64_t id) -> Candidate& {
+    auto [it, is_new] = candidate_pos.try_emplace(id, candidates.size());
+    if (is_new) {
+      candidates.push_back(Candidate{id, 0.0, -1});
+    }
+    return candidates[it->second];
+  };
+
+  double vector_weight = std::clamp(FLAGS_vector_index_hybrid_vector_weight, 0.0, 1.0);
+  double rrf_k = FLAGS_vector_index_hybrid_rrf_k;
+
+  const auto& vector_with_distances = vector_result.vector_with_distances();
+  int vector_count = vector_with_distances.size();
+  for (int i = 0; i < vector_count; ++i) {
+    auto& candidate = get_candidate(vector_with_distances[i].vector_with_id().id());
+    candidate.vector_pos = i;
+    if (type == HybridFusionType::kRrf) {
+      candidate.score += 1.0 / (rrf_k + i + 1);
+    } else {
+      // distance direction depend on metric, result is sorted best first, so first is best.
+      candidate.score += vector_weight * Normalize(vector_with_distances[i].distance(),
+                                                   vector_with_distances[0].distance(),
+                                                   vector_with_distances[vector_count - 1].distance());
+    }
+  }
+
+  // bm25 score is larger is better.
+  std::vector<const pb::common::DocumentWithScore*> sorted_documents;
+  sorted_documents.reserve(document_results.size());
+  for (const auto& document_result : document_results) {
+    sorted_documents.push_back(&document_result);
+  }
+  std::stable_sort(sorted_documents.begin(), sorted_documents.end(),
+                   [](const auto* lhs, const auto* rhs) { return lhs->score() > rhs->score(); });
+
+  for (size_t i = 0; i < sorted_documents.size(); ++i) {
+    auto& candidate = get_candidate(sorted_documents[i]->document_with_id().id());
+    if (type == HybridFusionType::kRrf) {
+      candidate.score += 1.0 / (rrf_k + i + 1);
+    } else {
+      candidate.score += (1.0 - vector_weight) * Normalize(sorted_documents[i]->score(), sorted_documents[0]->score(),
+                                                           sorted_documents.back()->score());
+    }
+  }
+
+  std::sort(candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs) {
+    return lhs.score != rhs.score ? lhs.score > rhs.score : lhs.id < rhs.id;
+  });
+  if (topk > 0 && candidates.size() > topk) {
+    candidates.resize(topk);
+  }
+
+  fused_result.Clear();
+  for (const auto& candidate : candidates) {
+    auto* vector_with_distance = fused_result.add_vector_with_distances();
+    if (candidate.vector_pos >= 0) {
+      *vector_with_distance = vector_with_distances[candidate.vector_pos];
+    } else {
+      vector_with_distance->mutable_vector_with_id()->set_id(candidate.id);
+    }
+    vector_with_distance->set_distance(static_cast<float>(candidate.score));
+  }
+}
+
+}  // namespace dingodb
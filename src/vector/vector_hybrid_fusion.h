@@ -0,0 +1,54 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_HYBRID_FUSION_H_
+#define DINGODB_VECTOR_HYBRID_FUSION_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+
+namespace dingodb {
+
+// How to fuse vector search result and document bm25 search result into one ranked list.
+enum class HybridFusionType {
+  // reciprocal rank fusion, score is sum of 1 / (k + rank), only rank is used.
+  kRrf = 0,
+  // weighted sum of min-max normalized vector score and bm25 score.
+  kWeighted = 1,
+};
+
+// Fuse result of hybrid vector and bm25 search on same region, fused score is larger is better and
+// it is put into distance of result.
+class VectorHybridFusion {
+ public:
+  // vector_result is sorted by distance best first, document_results is in any order.
+  static void Fuse(const pb::index::VectorWithDistanceResult& vector_result,
+                   const std::vector<pb::common::DocumentWithScore>& document_results, uint32_t topk,
+                   pb::index::VectorWithDistanceResult& fused_result);
+
+  static void Fuse(HybridFusionType type, const pb::index::VectorWithDistanceResult& vector_result,
+                   const std::vector<pb::common::DocumentWithScore>& document_results, uint32_t topk,
+                   pb::index::VectorWithDistanceResult& fused_result);
+
+  // type by flag vector_index_hybrid_fusion_type.
+  static HybridFusionType FusionType();
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_HYBRID_FUSION_H_
@@ -0,0 +1,210 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_id_bitmap.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace dingodb {
+
+bool VectorIdBitmap::Container::Add(uint16_t low) {
+  if (IsBitmap()) {
+    uint64_t& word = bitmap[low / 64];
+    uint64_t mask = uint64_t(1) << (low % 64);
+    if ((word & mask) != 0) {
+      return false;
+    }
+    word |= mask;
+    ++cardinality;
+    return true;
+  }
+
+  if (array.empty() || array.back() < low) {
+    array.push_back(low);
+  } else {
+    auto it = std::lower_bound(array.begin(), array.end(), low);
+    if (*it == low) {
+      return false;
+    }
+    array.insert(it, low);
+  }
+  ++cardinality;
+
+  if (cardinality > kArrayMaxSize) {
+    ToBitmap();
+  }
+  return true;
+}
+
+bool VectorIdBitmap::Container::Contains(uint16_t low) const {
+  if (IsBitmap()) {
+    return (bitmap[low / 64] & (uint64_t(1) << (low % 64))) != 0;
+  }
+  return std::binary_search(array.begin(), array.end(), low);
+}
+
+void VectorIdBitmap::Container::ToBitmap() {
+  bitmap.assign(kBitmapWordCount, 0);
+  for (auto low : array) {
+    bitmap[low / 64] |= uint64_t(1) << (low % 64);
+  }
+  std::vector<uint16_t>().swap(array);
+}
+
+void VectorIdBitmap::Container::ToArray() {
+  std::vector<uint16_t> new_array;
+  new_array.reserve(cardinality);
+  for (size_t i = 0; i < bitmap.size(); ++i) {
+    uint64_t word = bitmap[i];
+    while (word != 0) {
+      new_array.push_back(static_cast<uint16_t>(i * 64 + __builtin_ctzll(word)));
+      word &= word - 1;
+    }
+  }
+  array.swap(new_array);
+  std::vector<uint64_t>().swap(bitmap);
+}
+
+void VectorIdBitmap::Container::IntersectWith(const Container& other) {
+  if (IsBitmap() && other.IsBitmap()) {
+    cardinality = 0;
+    for (size_t i = 0; i < kBitmapWordCount; ++i) {
+      bitmap[i] &= other.bitmap[i];
+      cardinality += __builtin_popcountll(bitmap[i]);
+    }
+    if (cardinality <= kArrayMaxSize) {
+      ToArray();
+    }
+    return;
+  }
+
+  if (IsBitmap()) {
+    // result is not more than other array
+    std::vector<uint16_t> new_array;
+    new_array.reserve(other.array.size());
+    for (auto low : other.array) {
+      if (Contains(low)) {
+        new_array.push_back(low);
+      }
+    }
+    array.swap(new_array);
+    std::vector<uint64_t>().swap(bitmap);
+  } else if (other.IsBitmap()) {
+    array.erase(std::remove_if(array.begin(), array.end(), [&other](uint16_t low) { return !other.Contains(low); }),
+                array.end());
+  } else {
+    std::vector<uint16_t> new_array;
+    new_array.reserve(std::min(array.size(), other.array.size()));
+    std::set_intersection(array.begin(), array.end(), other.array.begin(), other.array.end(),
+                          std::back_inserter(new_array));
+    array.swap(new_array);
+  }
+  cardinality = array.size();
+}
+
+VectorIdBitmap::Container& VectorIdBitmap::GetOrCreateContainer(uint64_t high) {
+  if (containers_.empty() || containers_.back().high < high) {
+    containers_.emplace_back();
+    containers_.back().high = high;
+    return containers_.back();
+  }
+  if (containers_.back().high == high) {
+    return containers_.back();
+  }
+
+  auto it = std::lower_bound(containers_.begin(), containers_.end(), high,
+                             [](const Container& container, uint64_t high) { return container.high < high; });
+  if (it == containers_.end() || it->high != high) {
+    it = containers_.emplace(it);
+    it->high = high;
+  }
+  return *it;
+}
+
+const VectorIdBitmap::Container* VectorIdBitmap::FindContainer(uint64_t high) const {
+  auto it = std::lower_bound(containers_.begin(), containers_.end(), high,
+                             [](const Container& container, uint64_t high) { return container.high < high; });
+  if (it == containers_.end() || it->high != high) {
+    return nullptr;
+  }
+  return &(*it);
+}
+
+void VectorIdBitmap::Add(int64_t vector_id) {
+  if (vector_id < 0) {
+    return;
+  }
+
+  uint64_t id = vector_id;
+  if (GetOrCreateContainer(id >> kLowBits).Add(static_cast<uint16_t>(id & kLowMask))) {
+    ++cardinality_;
+  }
+}
+
+bool VectorIdBitmap::Contains(int64_t vector_id) const {
+  if (vector_id < 0) {
+    return false;
+  }
+
+  uint64_t id = vector_id;
+  const auto* container = FindContainer(id >> kLowBits);
+  return container != nullptr && container->Contains(static_cast<uint16_t>(id & kLowMask));
+}
+
+int64_t VectorIdBitmap::MemorySize() const {
+  int64_t size = sizeof(VectorIdBitmap) + containers_.capacity() * sizeof(Container);
+  for (const auto& container : containers_) {
+    size += container.array.capacity() * sizeof(uint16_t) + container.bitmap.capacity() * sizeof(uint64_t);
+  }
+  return size;
+}
+
+void VectorIdBitmap::IntersectWith(const VectorIdBitmap& other) {
+  std::vector<Container> new_containers;
+  cardinality_ = 0;
+
+  auto other_it = other.containers_.begin();
+  for (auto& container : containers_) {
+    while (other_it != other.containers_.end() && other_it->high < container.high) {
+      ++other_it;
+    }
+    if (other_it == other.containers_.end()) {
+      break;
+    }
+    if (other_it->high != container.high) {
+      continue;
+    }
+
+    container.IntersectWith(*other_it);
+    if (container.cardinality > 0) {
+      cardinality_ += container.cardinality;
+      new_containers.push_back(std::move(container));
+    }
+  }
+
+  containers_.swap(new_containers);
+}
+
+std::vector<int64_t> VectorIdBitmap::ToVector() const {
+  std::vector<int64_t> vector_ids;
+  vector_ids.reserve(cardinality_);
+  ForEach([&vector_ids](int64_t vector_id) { vector_ids.push_back(vector_id); });
+  return vector_ids;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,106 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_ID_BITMAP_H_
+#define DINGODB_VECTOR_ID_BITMAP_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace dingodb {
+
+// Compressed bitmap of vector id, same layout as roaring bitmap.
+// Id is split to high 48 bits and low 16 bits, every high bits has a container of low bits,
+// container is sorted array when sparse and 65536 bits bitmap when dense.
+// Add ids in ascending order is fast path, that is the order of scan vector key.
+class VectorIdBitmap {
+ public:
+  VectorIdBitmap() = default;
+  ~VectorIdBitmap() = default;
+
+  VectorIdBitmap(const VectorIdBitmap&) = default;
+  VectorIdBitmap& operator=(const VectorIdBitmap&) = default;
+  VectorIdBitmap(VectorIdBitmap&&) = default;
+  VectorIdBitmap& operator=(VectorIdBitmap&&) = default;
+
+  // negative id is ignored.
+  void Add(int64_t vector_id);
+  bool Contains(int64_t vector_id) const;
+
+  int64_t Cardinality() const { return cardinality_; }
+  bool Empty() const { return cardinality_ == 0; }
+  int64_t MemorySize() const;
+
+  // keep ids which also exist in other.
+  void IntersectWith(const VectorIdBitmap& other);
+
+  // visit ids in ascending order.
+  template <typename Func>
+  void ForEach(Func&& func) const {
+    for (const auto& container : containers_) {
+      int64_t base = static_cast<int64_t>(container.high) << kLowBits;
+      if (container.IsBitmap()) {
+        for (size_t i = 0; i < container.bitmap.size(); ++i) {
+          uint64_t word = container.bitmap[i];
+          while (word != 0) {
+            func(base + static_cast<int64_t>(i * 64 + __builtin_ctzll(word)));
+            word &= word - 1;
+          }
+        }
+      } else {
+        for (auto low : container.array) {
+          func(base + low);
+        }
+      }
+    }
+  }
+
+  std::vector<int64_t> ToVector() const;
+
+ private:
+  static constexpr int kLowBits = 16;
+  static constexpr uint32_t kLowMask = (1 << kLowBits) - 1;
+  // same as roaring, array container is smaller than bitmap container under this size.
+  static constexpr int32_t kArrayMaxSize = 4096;
+  static constexpr size_t kBitmapWordCount = (1 << kLowBits) / 64;
+
+  struct Container {
+    uint64_t high{0};
+    int32_t cardinality{0};
+    // only one is used
+    std::vector<uint16_t> array;
+    std::vector<uint64_t> bitmap;
+
+    bool IsBitmap() const { return !bitmap.empty(); }
+    bool Add(uint16_t low);
+    bool Contains(uint16_t low) const;
+    void ToBitmap();
+    void ToArray();
+    void IntersectWith(const Container& other);
+  };
+
+  Container& GetOrCreateContainer(uint64_t high);
+  const Container* FindContainer(uint64_t high) const;
+
+  // sorted by high
+  std::vector<Container> containers_;
+  int64_t cardinality_{0};
+};
+
+using VectorIdBitmapPtr = std::shared_ptr<VectorIdBitmap>;
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_ID_BITMAP_H_
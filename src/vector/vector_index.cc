@@ -26,6 +26,7 @@
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/synchronization.h"
 #include "config/config_manager.h"
 #include "fmt/core.h"
 #include "mvcc/codec.h"
@@ -36,6 +37,7 @@
 #include "vector/codec.h"
 #include "vector/vector_index_diskann.h"
 #include "vector/vector_index_snapshot_manager.h"
+#include "vector/vector_index_utils.h"
 
 #ifndef ENABLE_SIMD_HOOK
 #define ENABLE_SIMD_HOOK
@@ -50,6 +52,9 @@
 
 namespace dingodb {
 
+DECLARE_bool(enable_vector_search_cache);
+DECLARE_int64(vector_index_async_apply_wait_timeout_ms);
+
 DEFINE_uint32(ivf_vector_write_batch_size_per_task, 256, "ivf vector write batch size per task");
 DEFINE_uint32(vector_read_batch_size_per_task, 1, "vector read batch size per task");
 
@@ -75,19 +80,11 @@ butil::Status ParallelRun(ThreadPoolPtr thread_pool, int64_t vector_index_id,
   std::vector<butil::Status> statuses(vector_with_id_batchs.size());
 
   uint64_t start_time = Helper::TimestampMs();
-  std::vector<ThreadPool::TaskPtr> tasks;
-  for (uint32_t i = 0; i < vector_with_id_batchs.size(); ++i) {
-    auto task = thread_pool->ExecuteTask([&, i](void*) { statuses[i] = fn(vector_with_id_batchs[i], i); }, nullptr,
-                                         is_priority ? 1 : 0);
-
-    if (task != nullptr) {
-      tasks.push_back(task);
+  thread_pool->ParallelFor(0, vector_with_id_batchs.size(), 1, is_priority ? 1 : 0, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      statuses[i] = fn(vector_with_id_batchs[i], i);
     }
-  }
-
-  for (auto& task : tasks) {
-    task->Join();
-  }
+  });
 
   int64_t elapsed_time = Helper::TimestampMs() - start_time;
   DINGO_LOG_IF(INFO, elapsed_time > FLAGS_parallel_log_threshold_time_ms)
@@ -554,6 +551,40 @@ void VectorIndexWrapper::SaveApplyLogId(int64_t apply_log_id) {
   SaveMeta();
 }
 
+void VectorIndexWrapper::SetAsyncApplyLogId(int64_t log_id) { async_apply_log_id_.store(log_id); }
+
+void VectorIndexWrapper::SetAsyncAppliedLogId(int64_t log_id) { async_applied_log_id_.store(log_id); }
+
+bool VectorIndexWrapper::IsAsyncApplying() { return async_applied_log_id_.load() < async_apply_log_id_.load(); }
+
+void VectorIndexWrapper::SetBulkImportLogId(int64_t log_id) {
+  bulk_import_log_id_.store(log_id);
+  last_bulk_import_time_ms_.store(Helper::TimestampMs());
+}
+
+// rebuilt vector index catch up log, so its apply log id reach bulk import log id.
+bool VectorIndexWrapper::IsBulkImportPending() { return bulk_import_log_id_.load() > ApplyLogId(); }
+
+int64_t VectorIndexWrapper::LastBulkImportTimeMs() { return last_bulk_import_time_ms_.load(); }
+
+void VectorIndexWrapper::WaitAsyncApply() {
+  int64_t log_id = async_apply_log_id_.load();
+  if (async_applied_log_id_.load() >= log_id) {
+    return;
+  }
+
+  int64_t start_time = Helper::TimestampMs();
+  while (async_applied_log_id_.load() < log_id && IsReady()) {
+    if (Helper::TimestampMs() - start_time > FLAGS_vector_index_async_apply_wait_timeout_ms) {
+      DINGO_LOG(WARNING) << fmt::format(
+          "[vector_index.wrapper][index_id({})] wait async apply timeout, log_id({}) applied_log_id({}).", Id(),
+          log_id, async_applied_log_id_.load());
+      break;
+    }
+    bthread_usleep(1000);
+  }
+}
+
 int64_t VectorIndexWrapper::SnapshotLogId() { return snapshot_log_id_.load(); }
 
 void VectorIndexWrapper::SetSnapshotLogId(int64_t snapshot_log_id) { snapshot_log_id_.store(snapshot_log_id); }
@@ -607,8 +638,11 @@ void VectorIndexWrapper::UpdateVectorIndex(VectorIndexPtr vector_index, const st
     }
 
     ++version_;
+    search_cache_.Invalidate();
 
     ready_.store(true);
+    is_evicted_.store(false);
+    last_access_time_ms_.store(Helper::TimestampMs(), std::memory_order_relaxed);
 
     int64_t apply_log_id = ApplyLogId();
     int64_t snapshot_log_id = SnapshotLogId();
@@ -636,6 +670,22 @@ void VectorIndexWrapper::ClearVectorIndex(const std::string& trace) {
   vector_index_ = nullptr;
   share_vector_index_ = nullptr;
   sibling_vector_index_ = nullptr;
+  search_cache_.Invalidate();
+}
+
+void VectorIndexWrapper::Evict(const std::string& trace) {
+  DINGO_LOG(INFO) << fmt::format("[vector_index.wrapper][index_id({})][trace({})] evict vector index, apply_log_id({})",
+                                 Id(), trace, ApplyLogId());
+
+  ClearVectorIndex(trace);
+  is_evicted_.store(true);
+}
+
+// load evicted vector index once, search fail until it is ready.
+static void ReloadEvictedVectorIndex(VectorIndexWrapperPtr vector_index_wrapper, std::atomic<bool>& is_evicted) {
+  if (is_evicted.exchange(false)) {
+    VectorIndexManager::LaunchLoadOrBuildVectorIndex(vector_index_wrapper, false, false, 0, "reload evicted");
+  }
 }
 
 VectorIndexPtr VectorIndexWrapper::GetOwnVectorIndex() {
@@ -662,6 +712,7 @@ void VectorIndexWrapper::SetShareVectorIndex(VectorIndexPtr vector_index) {
   BAIDU_SCOPED_LOCK(vector_index_mutex_);
 
   share_vector_index_ = vector_index;
+  search_cache_.Invalidate();
 
   // During split, there may occur leader change, set ready_ to true can improve the availablidy of vector index
   // Because follower is also do force rebuild too, so in this scenario follower is equivalent to leader
@@ -676,6 +727,7 @@ VectorIndexPtr VectorIndexWrapper::SiblingVectorIndex() {
 void VectorIndexWrapper::SetSiblingVectorIndex(VectorIndexPtr vector_index) {
   BAIDU_SCOPED_LOCK(vector_index_mutex_);
   sibling_vector_index_ = vector_index;
+  search_cache_.Invalidate();
 }
 
 int32_t VectorIndexWrapper::PendingTaskNum() { return pending_task_num_.load(std::memory_order_relaxed); }
@@ -936,6 +988,9 @@ butil::Status VectorIndexWrapper::Add(const std::vector<pb::common::VectorWithId
     return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, "vector index %lu is not ready.", Id());
   }
 
+  // cached search result is stale after write, even write partially failed.
+  DEFER(search_cache_.Invalidate());
+
   // Exist sibling vector index, so need to separate add vector.
   auto sibling_vector_index = SiblingVectorIndex();
   if (sibling_vector_index != nullptr) {
@@ -983,6 +1038,9 @@ butil::Status VectorIndexWrapper::Upsert(const std::vector<pb::common::VectorWit
     return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, "vector index %lu is not ready.", Id());
   }
 
+  // cached search result is stale after write, even write partially failed.
+  DEFER(search_cache_.Invalidate());
+
   // Exist sibling vector index, so need to separate upsert vector.
   auto sibling_vector_index = SiblingVectorIndex();
   if (sibling_vector_index != nullptr) {
@@ -1030,6 +1088,9 @@ butil::Status VectorIndexWrapper::Delete(const std::vector<int64_t>& delete_ids)
     return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, "vector index %lu is not ready.", Id());
   }
 
+  // cached search result is stale after write, even write partially failed.
+  DEFER(search_cache_.Invalidate());
+
   // Exist sibling vector index, so need to separate delete vector.
   auto sibling_vector_index = SiblingVectorIndex();
   if (sibling_vector_index != nullptr) {
@@ -1053,57 +1114,18 @@ butil::Status VectorIndexWrapper::Delete(const std::vector<int64_t>& delete_ids)
   return status;
 }
 
-static void MergeSearchResult(uint32_t topk, pb::index::VectorWithDistanceResult& input_1,
-                              pb::index::VectorWithDistanceResult& input_2,
-                              pb::index::VectorWithDistanceResult& results) {
-  if (topk == 0) return;
-  int input_1_size = input_1.vector_with_distances_size();
-  int input_2_size = input_2.vector_with_distances_size();
-  auto* vector_with_distances_1 = input_1.mutable_vector_with_distances();
-  auto* vector_with_distances_2 = input_2.mutable_vector_with_distances();
-
-  int i = 0, j = 0;
-  while (i < input_1_size && j < input_2_size) {
-    auto& distance_1 = vector_with_distances_1->at(i);
-    auto& distance_2 = vector_with_distances_2->at(j);
-    if (distance_1.distance() <= distance_2.distance()) {
-      ++i;
-      results.add_vector_with_distances()->Swap(&distance_1);
-    } else {
-      ++j;
-      results.add_vector_with_distances()->Swap(&distance_2);
-    }
-
-    if (results.vector_with_distances_size() >= topk) {
-      return;
-    }
-  }
-
-  for (; i < input_1_size; ++i) {
-    auto& distance = vector_with_distances_1->at(i);
-    results.add_vector_with_distances()->Swap(&distance);
-    if (results.vector_with_distances_size() >= topk) {
-      return;
-    }
-  }
-
-  for (; j < input_2_size; ++j) {
-    auto& distance = vector_with_distances_2->at(j);
-    results.add_vector_with_distances()->Swap(&distance);
-    if (results.vector_with_distances_size() >= topk) {
-      return;
-    }
-  }
-}
-
 static void MergeSearchResults(uint32_t topk, std::vector<pb::index::VectorWithDistanceResult>& input_1,
                                std::vector<pb::index::VectorWithDistanceResult>& input_2,
                                std::vector<pb::index::VectorWithDistanceResult>& results) {
   assert(input_1.size() == input_2.size());
 
+  // own and sibling index has no same vector
+  VectorTopkMerger merger(topk, false);
   results.resize(input_1.size());
   for (int i = 0; i < input_1.size(); ++i) {
-    MergeSearchResult(topk, input_1[i], input_2[i], results[i]);
+    merger.Add(input_1[i]);
+    merger.Add(input_2[i]);
+    merger.Finish(results[i]);
   }
 }
 
@@ -1112,10 +1134,13 @@ butil::Status VectorIndexWrapper::Search(std::vector<pb::common::VectorWithId> v
                                          std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
                                          bool reconstruct, const pb::common::VectorSearchParameter& parameter,
                                          std::vector<pb::index::VectorWithDistanceResult>& results) {
+  last_access_time_ms_.store(Helper::TimestampMs(), std::memory_order_relaxed);
   if (!IsReady()) {
+    ReloadEvictedVectorIndex(GetSelf(), is_evicted_);
     DINGO_LOG(WARNING) << fmt::format("[vector_index.wrapper][index_id({})] vector index is not ready.", Id());
     return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, "vector index %lu is not ready.", Id());
   }
+  WaitAsyncApply();
   auto vector_index = GetVectorIndex();
   if (vector_index == nullptr) {
     DINGO_LOG(WARNING) << fmt::format("[vector_index.wrapper][index_id({})] vector index is not ready.", Id());
@@ -1142,6 +1167,9 @@ butil::Status VectorIndexWrapper::Search(std::vector<pb::common::VectorWithId> v
     return status;
   }
 
+  // Only range filter is same between searches, so search with other filter not batch.
+  bool can_batch = filters.empty();
+
   const auto& index_range = vector_index->Range();
   if (region_range.start_key() != index_range.start_key() || region_range.end_key() != index_range.end_key()) {
     int64_t min_vector_id = 0, max_vector_id = 0;
@@ -1154,6 +1182,61 @@ butil::Status VectorIndexWrapper::Search(std::vector<pb::common::VectorWithId> v
     }
   }
 
+  if (can_batch) {
+    std::string batch_key =
+        fmt::format("{}|{}|{}|{}|{}", topk, reconstruct, Helper::StringToHex(region_range.start_key()),
+                    Helper::StringToHex(region_range.end_key()), parameter.SerializeAsString());
+    auto batch_search_func = [&](const std::vector<pb::common::VectorWithId>& query_vector_with_ids,
+                                 std::vector<pb::index::VectorWithDistanceResult>& query_results) {
+      return search_batcher_.Search(
+          batch_key, query_vector_with_ids,
+          [&](const std::vector<pb::common::VectorWithId>& batch_vector_with_ids,
+              std::vector<pb::index::VectorWithDistanceResult>& batch_results) {
+            return vector_index->SearchByParallel(batch_vector_with_ids, topk, filters, reconstruct, parameter,
+                                                  batch_results);
+          },
+          query_results);
+    };
+
+    if (!FLAGS_enable_vector_search_cache) {
+      return batch_search_func(vector_with_ids, results);
+    }
+
+    // version is got before search, so result of search concurrent with write is not cached.
+    auto cache_version = search_cache_.GetVersion(ApplyLogId());
+    results.resize(vector_with_ids.size());
+    std::vector<std::string> cache_keys;
+    std::vector<size_t> miss_offsets;
+    std::vector<pb::common::VectorWithId> miss_vector_with_ids;
+    cache_keys.reserve(vector_with_ids.size());
+    for (size_t i = 0; i < vector_with_ids.size(); ++i) {
+      cache_keys.push_back(VectorSearchCache::GenKey(vector_with_ids[i], batch_key));
+      if (!search_cache_.Get(cache_keys[i], cache_version, results[i])) {
+        miss_offsets.push_back(i);
+        miss_vector_with_ids.push_back(vector_with_ids[i]);
+      }
+    }
+    if (miss_vector_with_ids.empty()) {
+      return butil::Status::OK();
+    }
+
+    std::vector<pb::index::VectorWithDistanceResult> miss_results;
+    auto status = batch_search_func(miss_vector_with_ids, miss_results);
+    if (!status.ok()) {
+      return status;
+    }
+    if (miss_results.size() != miss_offsets.size()) {
+      return butil::Status(pb::error::EINTERNAL, "vector search result size not match query size.");
+    }
+
+    for (size_t i = 0; i < miss_offsets.size(); ++i) {
+      size_t offset = miss_offsets[i];
+      search_cache_.Put(cache_keys[offset], cache_version, miss_results[i]);
+      results[offset].Swap(&miss_results[i]);
+    }
+    return status;
+  }
+
   return vector_index->SearchByParallel(vector_with_ids, topk, filters, reconstruct, parameter, results);
 }
 
@@ -1162,9 +1245,12 @@ static void MergeRangeSearchResults(std::vector<pb::index::VectorWithDistanceRes
                                     std::vector<pb::index::VectorWithDistanceResult>& results) {
   assert(input_1.size() == input_2.size());
 
+  VectorTopkMerger merger(UINT32_MAX, false);
   results.resize(input_1.size());
   for (int i = 0; i < input_1.size(); ++i) {
-    MergeSearchResult(UINT32_MAX, input_1[i], input_2[i], results[i]);
+    merger.Add(input_1[i]);
+    merger.Add(input_2[i]);
+    merger.Finish(results[i]);
   }
 }
 
@@ -1173,10 +1259,13 @@ butil::Status VectorIndexWrapper::RangeSearch(std::vector<pb::common::VectorWith
                                               std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters,
                                               bool reconstruct, const pb::common::VectorSearchParameter& parameter,
                                               std::vector<pb::index::VectorWithDistanceResult>& results) {
+  last_access_time_ms_.store(Helper::TimestampMs(), std::memory_order_relaxed);
   if (!IsReady()) {
+    ReloadEvictedVectorIndex(GetSelf(), is_evicted_);
     DINGO_LOG(WARNING) << fmt::format("[vector_index.wrapper][index_id({})] vector index is not ready.", Id());
     return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, "vector index %lu is not ready.", Id());
   }
+  WaitAsyncApply();
   auto vector_index = GetVectorIndex();
   if (vector_index == nullptr) {
     DINGO_LOG(WARNING) << fmt::format("[vector_index.wrapper][index_id({})] vector index is not ready.", Id());
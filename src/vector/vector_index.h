@@ -21,6 +21,7 @@
 #include <memory>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "bthread/types.h"
@@ -36,7 +37,10 @@
 #include "fmt/core.h"
 #include "proto/common.pb.h"
 #include "proto/index.pb.h"
+#include "vector/vector_id_bitmap.h"
 #include "vector/vector_index_snapshot.h"
+#include "vector/vector_search_batcher.h"
+#include "vector/vector_search_cache.h"
 
 namespace dingodb {
 
@@ -145,6 +149,29 @@ class VectorIndex {
     std::vector<int64_t> vector_ids_;
   };
 
+  // compressed bitmap, bitmap is shared and not copied, so can be reused and intersected before build filter.
+  class BitmapFilterFunctor : public FilterFunctor {
+   public:
+    BitmapFilterFunctor(const BitmapFilterFunctor&) = delete;
+    BitmapFilterFunctor(BitmapFilterFunctor&&) = delete;
+    BitmapFilterFunctor& operator=(const BitmapFilterFunctor&) = delete;
+    BitmapFilterFunctor& operator=(BitmapFilterFunctor&&) = delete;
+
+    explicit BitmapFilterFunctor(std::shared_ptr<const VectorIdBitmap> bitmap, bool is_negation = false)
+        : bitmap_(std::move(bitmap)), is_negation_(is_negation) {}
+
+    ~BitmapFilterFunctor() override = default;
+
+    bool Check(int64_t vector_id) override {
+      bool exist = bitmap_->Contains(vector_id);
+      return !is_negation_ ? exist : !exist;
+    }
+
+   private:
+    std::shared_ptr<const VectorIdBitmap> bitmap_;
+    bool is_negation_{false};
+  };
+
   virtual int32_t GetDimension() = 0;
   virtual pb::common::MetricType GetMetricType() = 0;
   virtual butil::Status GetCount(int64_t& count);
@@ -228,6 +255,13 @@ class VectorIndex {
 
   virtual uint32_t WriteOpParallelNum() { return 1; }
 
+  // Copy vectors with id in [begin_vector_id, end_vector_id) to target, target is a new empty index with same type
+  // and parameter, e.g. index of split child, so not scan data and train again. Drop target when failed.
+  virtual butil::Status CopyTo(std::shared_ptr<VectorIndex> /*target*/, int64_t /*begin_vector_id*/,
+                               int64_t /*end_vector_id*/) {
+    return butil::Status(pb::error::Errno::ENOT_SUPPORT, "not support copy vector index");
+  }
+
   int64_t Id() const { return id; }
 
   pb::common::VectorIndexType VectorIndexType() { return vector_index_type; }
@@ -310,6 +344,11 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
   bool IsStop() { return stop_.load(); }
   bool IsOwnReady() { return GetOwnVectorIndex() != nullptr; }
 
+  // release memory of cold vector index, it is loaded again at next search.
+  void Evict(const std::string& trace);
+  bool IsEvicted() { return is_evicted_.load(); }
+  int64_t LastAccessTimeMs() { return last_access_time_ms_.load(std::memory_order_relaxed); }
+
   bool IsBuildError() { return build_error_.load(); }
 
   bool IsRebuildError() { return rebuild_error_.load(); }
@@ -352,6 +391,19 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
   void SetApplyLogId(int64_t apply_log_id);
   void SaveApplyLogId(int64_t apply_log_id);
 
+  // raft log id of last write put to async apply queue, and of last one finished by queue.
+  void SetAsyncApplyLogId(int64_t log_id);
+  void SetAsyncAppliedLogId(int64_t log_id);
+  bool IsAsyncApplying();
+  // wait async apply of writes before now finish, keep read your writes.
+  void WaitAsyncApply();
+
+  // raft log id of last bulk import, writes after it are not applied to vector index until vector index is
+  // rebuilt from data and catch up the log, so import speed is not bounded by incremental index insert.
+  void SetBulkImportLogId(int64_t log_id);
+  bool IsBulkImportPending();
+  int64_t LastBulkImportTimeMs();
+
   int64_t SnapshotLogId();
   void SetSnapshotLogId(int64_t snapshot_log_id);
   void SaveSnapshotLogId(int64_t snapshot_log_id);
@@ -468,6 +520,12 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
   std::atomic<int64_t> apply_log_id_;
   // last snapshot log id
   std::atomic<int64_t> snapshot_log_id_;
+  // async apply log id
+  std::atomic<int64_t> async_apply_log_id_{0};
+  std::atomic<int64_t> async_applied_log_id_{0};
+  // bulk import log id and time
+  std::atomic<int64_t> bulk_import_log_id_{0};
+  std::atomic<int64_t> last_bulk_import_time_ms_{0};
 
   // Indicate switching vector index.
   std::atomic<bool> is_switching_vector_index_;
@@ -501,6 +559,17 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
 
   // need hold vector index
   std::atomic<bool> is_hold_vector_index_;
+
+  // Coalesce concurrent search without extra filter.
+  VectorSearchBatcher search_batcher_;
+
+  // cache search result of repeated query, invalidated by write.
+  VectorSearchCache search_cache_;
+
+  // last search time, for evict cold vector index.
+  std::atomic<int64_t> last_access_time_ms_{0};
+  // vector index is evicted by memory budget and not loaded yet.
+  std::atomic<bool> is_evicted_{false};
 };
 
 using VectorIndexWrapperPtr = std::shared_ptr<VectorIndexWrapper>;
@@ -21,6 +21,8 @@
 #include <vector>
 
 #include "butil/status.h"
+#include "common/gflag_validator.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
@@ -28,6 +30,9 @@
 namespace dingodb {
 
 DEFINE_int64(bruteforce_need_save_count, 10000, "bruteforce need save count");
+DEFINE_bool(enable_bruteforce_memory_arena, false,
+            "keep vectors of bruteforce index in memory for search, instead of scan vector data of raw engine");
+DEFINE_validator(enable_bruteforce_memory_arena, &PassBool);
 
 VectorIndexBruteforce::VectorIndexBruteforce(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
                                              const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
@@ -35,43 +40,81 @@ VectorIndexBruteforce::VectorIndexBruteforce(int64_t id, const pb::common::Vecto
     : VectorIndex(id, vector_index_parameter, epoch, range, thread_pool) {
   metric_type_ = vector_index_parameter.bruteforce_parameter().metric_type();
   dimension_ = vector_index_parameter.bruteforce_parameter().dimension();
+
+  if (FLAGS_enable_bruteforce_memory_arena) {
+    pb::common::VectorIndexParameter index_parameter_flat;
+    index_parameter_flat.set_vector_index_type(::dingodb::pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT);
+    auto* flat_parameter = index_parameter_flat.mutable_flat_parameter();
+    flat_parameter->set_metric_type(metric_type_);
+    flat_parameter->set_dimension(dimension_);
+    arena_ = std::make_shared<VectorIndexFlat<faiss::Index, faiss::IndexIDMap2>>(id, index_parameter_flat, epoch,
+                                                                                 range, thread_pool);
+  }
 }
 
 VectorIndexBruteforce::~VectorIndexBruteforce() = default;
 
-butil::Status VectorIndexBruteforce::Upsert(const std::vector<pb::common::VectorWithId>& /*vector_with_ids*/) {
+butil::Status VectorIndexBruteforce::Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  if (arena_ != nullptr) {
+    return arena_->Upsert(vector_with_ids);
+  }
   return butil::Status::OK();
 }
 
-butil::Status VectorIndexBruteforce::Add(const std::vector<pb::common::VectorWithId>& /*vector_with_ids*/) {
+butil::Status VectorIndexBruteforce::Add(const std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  if (arena_ != nullptr) {
+    return arena_->Add(vector_with_ids);
+  }
   return butil::Status::OK();
 }
 
-butil::Status VectorIndexBruteforce::Delete(const std::vector<int64_t>& /*delete_ids*/) { return butil::Status::OK(); }
+butil::Status VectorIndexBruteforce::Delete(const std::vector<int64_t>& delete_ids) {
+  if (arena_ != nullptr) {
+    return arena_->Delete(delete_ids);
+  }
+  return butil::Status::OK();
+}
 
-butil::Status VectorIndexBruteforce::Search(const std::vector<pb::common::VectorWithId>& /*vector_with_ids*/,
-                                            uint32_t /*topk*/,
-                                            const std::vector<std::shared_ptr<FilterFunctor>>& /*filters*/, bool,
-                                            const pb::common::VectorSearchParameter&,
-                                            std::vector<pb::index::VectorWithDistanceResult>& /*results*/) {
+// without arena, EVECTOR_NOT_SUPPORT make VectorReader search by scan raw engine.
+butil::Status VectorIndexBruteforce::Search(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                            uint32_t topk, const std::vector<std::shared_ptr<FilterFunctor>>& filters,
+                                            bool reconstruct, const pb::common::VectorSearchParameter& parameter,
+                                            std::vector<pb::index::VectorWithDistanceResult>& results) {
+  if (arena_ != nullptr) {
+    return arena_->Search(vector_with_ids, topk, filters, reconstruct, parameter, results);
+  }
   return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "not support");
 }
 
 butil::Status VectorIndexBruteforce::RangeSearch(
-    const std::vector<pb::common::VectorWithId>& /*vector_with_ids*/, float /*radius*/,
-    const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& /*filters*/, bool /*reconstruct*/,
-    const pb::common::VectorSearchParameter& /*parameter*/,
-    std::vector<pb::index::VectorWithDistanceResult>& /*results*/) {
+    const std::vector<pb::common::VectorWithId>& vector_with_ids, float radius,
+    const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters, bool reconstruct,
+    const pb::common::VectorSearchParameter& parameter, std::vector<pb::index::VectorWithDistanceResult>& results) {
+  if (arena_ != nullptr) {
+    return arena_->RangeSearch(vector_with_ids, radius, filters, reconstruct, parameter, results);
+  }
   return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "not support");
 }
 
-void VectorIndexBruteforce::LockWrite() {}
+void VectorIndexBruteforce::LockWrite() {
+  if (arena_ != nullptr) {
+    arena_->LockWrite();
+  }
+}
 
-void VectorIndexBruteforce::UnlockWrite() {}
+void VectorIndexBruteforce::UnlockWrite() {
+  if (arena_ != nullptr) {
+    arena_->UnlockWrite();
+  }
+}
 
 bool VectorIndexBruteforce::SupportSave() { return true; }
 
 butil::Status VectorIndexBruteforce::Save(const std::string& path) {
+  if (arena_ != nullptr) {
+    return arena_->Save(path);
+  }
+
   std::ofstream log_file(path);
   if (!log_file.is_open()) {
     return butil::Status(pb::error::Errno::EINTERNAL, "open file failed");
@@ -81,13 +124,22 @@ butil::Status VectorIndexBruteforce::Save(const std::string& path) {
   return butil::Status::OK();
 }
 
-butil::Status VectorIndexBruteforce::Load(const std::string& /*path*/) { return butil::Status::OK(); }
+// file saved without arena fail to load into arena, then index is built from vector data.
+butil::Status VectorIndexBruteforce::Load(const std::string& path) {
+  if (arena_ != nullptr) {
+    return arena_->Load(path);
+  }
+  return butil::Status::OK();
+}
 
 int32_t VectorIndexBruteforce::GetDimension() { return this->dimension_; }
 
 pb::common::MetricType VectorIndexBruteforce::GetMetricType() { return this->metric_type_; }
 
 butil::Status VectorIndexBruteforce::GetCount(int64_t& count) {
+  if (arena_ != nullptr) {
+    return arena_->GetCount(count);
+  }
   count = 0;
   return butil::Status::OK();
 }
@@ -98,6 +150,9 @@ butil::Status VectorIndexBruteforce::GetDeletedCount(int64_t& deleted_count) {
 }
 
 butil::Status VectorIndexBruteforce::GetMemorySize(int64_t& memory_size) {
+  if (arena_ != nullptr) {
+    return arena_->GetMemorySize(memory_size);
+  }
   memory_size = 0;
   return butil::Status::OK();
 }
@@ -108,4 +163,22 @@ bool VectorIndexBruteforce::NeedToSave(int64_t last_save_log_behind) {
   return last_save_log_behind > FLAGS_bruteforce_need_save_count;
 }
 
+butil::Status VectorIndexBruteforce::CopyTo(std::shared_ptr<VectorIndex> target, int64_t begin_vector_id,
+                                            int64_t end_vector_id) {
+  auto target_index = std::dynamic_pointer_cast<VectorIndexBruteforce>(target);
+  if (target_index == nullptr || target_index.get() == this) {
+    return butil::Status(pb::error::Errno::ENOT_SUPPORT, "target vector index type not match");
+  }
+
+  // target without arena hold nothing.
+  if (target_index->arena_ == nullptr) {
+    return butil::Status::OK();
+  }
+  if (arena_ == nullptr) {
+    return butil::Status(pb::error::Errno::ENOT_SUPPORT, "source vector index has no arena");
+  }
+
+  return arena_->CopyTo(target_index->arena_, begin_vector_id, end_vector_id);
+}
+
 }  // namespace dingodb
@@ -21,8 +21,10 @@
 #include <vector>
 
 #include "butil/status.h"
+#include "faiss/IndexIDMap.h"
 #include "proto/common.pb.h"
 #include "vector/vector_index.h"
+#include "vector/vector_index_flat.h"
 
 namespace dingodb {
 
@@ -30,6 +32,8 @@ namespace dingodb {
 // which is used for testing and benchmarking.
 // In this vector index, we do not implement any index structure, any vector index add, del, search or range search
 // All of them are done by brute force, which is processed by VectorReader.
+// With flag enable_bruteforce_memory_arena, vectors are also kept in memory in a contiguous flat arena which
+// is maintained on apply, search scan it directly instead of decoding vector data from raw engine.
 class VectorIndexBruteforce : public VectorIndex {
  public:
   explicit VectorIndexBruteforce(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
@@ -81,7 +85,14 @@ class VectorIndexBruteforce : public VectorIndex {
 
   bool NeedToSave(int64_t last_save_log_behind) override;
 
+  butil::Status CopyTo(std::shared_ptr<VectorIndex> target, int64_t begin_vector_id, int64_t end_vector_id) override;
+
+  bool HasMemoryArena() const { return arena_ != nullptr; }
+
  private:
+  // nullptr when not enable memory arena.
+  std::shared_ptr<VectorIndexFlat<faiss::Index, faiss::IndexIDMap2>> arena_;
+
   // Dimension of the elements
   faiss::idx_t dimension_;
 
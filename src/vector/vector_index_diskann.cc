@@ -14,6 +14,7 @@
 
 #include "vector/vector_index_diskann.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
 #include <memory>
@@ -22,9 +23,12 @@
 
 #include "butil/status.h"
 #include "common/constant.h"
+#include "common/gflag_validator.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
 #include "config/config_manager.h"
+#include "faiss/IndexFlat.h"
+#include "faiss/impl/IDSelector.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
 #include "glog/logging.h"
@@ -59,6 +63,14 @@ DEFINE_int32(diskann_server_load_worker_max_pending_num, 1024, "0 is unlimited")
 
 DEFINE_int32(diskann_server_import_batch_size, 32 * 1024 * 1024, "diskann server import batch size");
 
+DEFINE_bool(enable_diskann_delta_index, true, "keep writes after diskann built at memory delta index for search");
+DEFINE_validator(enable_diskann_delta_index, &PassBool);
+DEFINE_int64(diskann_delta_search_max_extra_topk, 1024,
+             "diskann search get more results to fill the stale ones dropped, at most this");
+BRPC_VALIDATE_GFLAG(diskann_delta_search_max_extra_topk, brpc::NonNegativeInteger);
+
+bvar::Adder<int64_t> g_diskann_delta_count("dingo_diskann_delta_count");
+
 // outside not to modify
 DEFINE_bool(diskann_build_sync_internal, false, "diskann build sync internal. default is false");
 
@@ -77,9 +89,27 @@ VectorIndexDiskANN::VectorIndexDiskANN(int64_t id, const pb::common::VectorIndex
       is_connected_(false) {
   metric_type_ = vector_index_parameter.diskann_parameter().metric_type();
   dimension_ = vector_index_parameter.diskann_parameter().dimension();
+  ResetDeltaIndex();
 }
 
-VectorIndexDiskANN::~VectorIndexDiskANN() = default;
+VectorIndexDiskANN::~VectorIndexDiskANN() { g_diskann_delta_count << -delta_index_->ntotal; }
+
+void VectorIndexDiskANN::ResetDeltaIndex() {
+  RWLockWriteGuard guard(&delta_rw_lock_);
+
+  if (delta_index_ != nullptr) {
+    g_diskann_delta_count << -delta_index_->ntotal;
+  }
+  faiss::IndexFlat* raw_index = nullptr;
+  if (metric_type_ == pb::common::MetricType::METRIC_TYPE_L2) {
+    raw_index = new faiss::IndexFlatL2(dimension_);
+  } else {
+    raw_index = new faiss::IndexFlatIP(dimension_);
+  }
+  delta_index_ = std::make_unique<faiss::IndexIDMap2>(raw_index);
+  delta_index_->own_fields = true;
+  tombstone_ids_.clear();
+}
 
 void VectorIndexDiskANN::Init() {
   if (FLAGS_enable_vector_index_diskann) {
@@ -184,6 +214,36 @@ butil::Status VectorIndexDiskANN::AddOrUpsert(const std::vector<pb::common::Vect
     return status;
   }
 
+  if (!FLAGS_enable_diskann_delta_index) {
+    return butil::Status::OK();
+  }
+
+  bool normalize = metric_type_ == pb::common::MetricType::METRIC_TYPE_COSINE;
+  const auto& vector_values = VectorIndexUtils::ExtractVectorValue<float>(vector_with_ids, dimension_, normalize);
+  std::vector<faiss::idx_t> ids;
+  ids.reserve(vector_with_ids.size());
+  for (const auto& vector_with_id : vector_with_ids) {
+    ids.push_back(vector_with_id.id());
+  }
+
+  RWLockWriteGuard guard(&delta_rw_lock_);
+
+  // disk index may have old version of the vector, upsert always overwrite.
+  std::vector<faiss::idx_t> exist_ids;
+  for (auto id : ids) {
+    tombstone_ids_.insert(id);
+    if (delta_index_->rev_map.find(id) != delta_index_->rev_map.end()) {
+      exist_ids.push_back(id);
+    }
+  }
+  if (!exist_ids.empty()) {
+    faiss::IDSelectorBatch selector(exist_ids.size(), exist_ids.data());
+    g_diskann_delta_count << -static_cast<int64_t>(delta_index_->remove_ids(selector));
+  }
+
+  delta_index_->add_with_ids(ids.size(), vector_values.get(), ids.data());
+  g_diskann_delta_count << static_cast<int64_t>(ids.size());
+
   return butil::Status::OK();
 }
 
@@ -195,7 +255,67 @@ butil::Status VectorIndexDiskANN::Add(const std::vector<pb::common::VectorWithId
   return AddOrUpsertWrapper(vector_with_ids, false);
 }
 
-butil::Status VectorIndexDiskANN::Delete(const std::vector<int64_t>& /*delete_ids*/) { return butil::Status::OK(); }
+butil::Status VectorIndexDiskANN::Delete(const std::vector<int64_t>& delete_ids) {
+  if (!FLAGS_enable_diskann_delta_index || delete_ids.empty()) {
+    return butil::Status::OK();
+  }
+
+  RWLockWriteGuard guard(&delta_rw_lock_);
+
+  std::vector<faiss::idx_t> exist_ids;
+  for (auto id : delete_ids) {
+    tombstone_ids_.insert(id);
+    if (delta_index_->rev_map.find(id) != delta_index_->rev_map.end()) {
+      exist_ids.push_back(id);
+    }
+  }
+  if (!exist_ids.empty()) {
+    faiss::IDSelectorBatch selector(exist_ids.size(), exist_ids.data());
+    g_diskann_delta_count << -static_cast<int64_t>(delta_index_->remove_ids(selector));
+  }
+
+  return butil::Status::OK();
+}
+
+void VectorIndexDiskANN::MergeDeltaSearchResult(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                                uint32_t topk,
+                                                std::vector<pb::index::VectorWithDistanceResult>& results) {
+  RWLockReadGuard guard(&delta_rw_lock_);
+  if (tombstone_ids_.empty() && delta_index_->ntotal == 0) {
+    return;
+  }
+
+  std::vector<pb::index::VectorWithDistanceResult> delta_results;
+  if (delta_index_->ntotal > 0) {
+    bool normalize = metric_type_ == pb::common::MetricType::METRIC_TYPE_COSINE;
+    const auto& vector_values = VectorIndexUtils::ExtractVectorValue<float>(vector_with_ids, dimension_, normalize);
+    std::vector<float> distances(topk * vector_with_ids.size(), 0.0f);
+    std::vector<faiss::idx_t> labels(topk * vector_with_ids.size(), -1);
+    delta_index_->search(vector_with_ids.size(), vector_values.get(), topk, distances.data(), labels.data());
+    VectorIndexUtils::FillSearchResult(vector_with_ids, topk, distances, labels, metric_type_, dimension_,
+                                       delta_results);
+  }
+
+  results.resize(vector_with_ids.size());
+  VectorTopkMerger merger(topk, false);
+  for (size_t i = 0; i < results.size(); ++i) {
+    auto* vector_with_distances = results[i].mutable_vector_with_distances();
+    vector_with_distances->erase(
+        std::remove_if(vector_with_distances->begin(), vector_with_distances->end(),
+                       [this](const pb::common::VectorWithDistance& vector_with_distance) {
+                         return tombstone_ids_.count(vector_with_distance.vector_with_id().id()) > 0;
+                       }),
+        vector_with_distances->end());
+
+    merger.Add(results[i]);
+    if (i < delta_results.size()) {
+      merger.Add(delta_results[i]);
+    }
+    pb::index::VectorWithDistanceResult result;
+    merger.Finish(result);
+    results[i].Swap(&result);
+  }
+}
 
 butil::Status VectorIndexDiskANN::Search(const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
                                          const std::vector<std::shared_ptr<FilterFunctor>>& filters, bool,
@@ -212,13 +332,35 @@ butil::Status VectorIndexDiskANN::Search(const std::vector<pb::common::VectorWit
     return status;
   }
 
-  {
-    BvarLatencyGuard bvar_guard(&g_diskann_search_latency);
+  BvarLatencyGuard bvar_guard(&g_diskann_search_latency);
 
-    if (!filters.empty()) {
-      return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "Search with filter not support in DiskANN!!!");
-    }
+  if (!filters.empty()) {
+    return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "Search with filter not support in DiskANN!!!");
+  }
 
+  // get more from disk index, so there is still topk after drop stale vectors.
+  int64_t extra_topk = 0;
+  if (FLAGS_enable_diskann_delta_index) {
+    RWLockReadGuard guard(&delta_rw_lock_);
+    extra_topk = std::min(static_cast<int64_t>(tombstone_ids_.size()), FLAGS_diskann_delta_search_max_extra_topk);
+  }
+
+  status = SearchDiskIndex(vector_with_ids, topk + extra_topk, parameter, results);
+  if (!status.ok()) {
+    return status;
+  }
+
+  if (FLAGS_enable_diskann_delta_index) {
+    MergeDeltaSearchResult(vector_with_ids, topk, results);
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexDiskANN::SearchDiskIndex(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                                  uint32_t topk, const pb::common::VectorSearchParameter& parameter,
+                                                  std::vector<pb::index::VectorWithDistanceResult>& results) {
+  {
     butil::Status status;
 
     // search rpc
@@ -361,7 +503,7 @@ butil::Status VectorIndexDiskANN::Build(const pb::common::Range& region_range, m
   if (!FLAGS_diskann_build_sync_internal) {
     internal_state = pb::common::DiskANNCoreState::BUILDING;
     std::shared_ptr<VectorIndexDiskANN> self = GetSelf();
-    auto task = std::make_shared<ServiceTask>([self, region_range, reader, parameter, ts]() {
+    auto task = ServiceTask::New([self, region_range, reader, parameter, ts]() {
       pb::common::DiskANNCoreState state;
       auto status = self->DoBuild(region_range, reader, parameter, ts, state);
       (void)status;
@@ -504,7 +646,7 @@ butil::Status VectorIndexDiskANN::Load(const pb::common::VectorLoadParameter& pa
   if (!FLAGS_diskann_load_sync_internal) {
     internal_state = pb::common::DiskANNCoreState::LOADING;
     std::shared_ptr<VectorIndexDiskANN> self = GetSelf();
-    auto task = std::make_shared<ServiceTask>([self, internal_parameter]() {
+    auto task = ServiceTask::New([self, internal_parameter]() {
       pb::common::DiskANNCoreState state;
       butil::Status status;
       // load index rpc
@@ -634,6 +776,9 @@ butil::Status VectorIndexDiskANN::Reset(bool delete_data_file,
     return status;
   }
 
+  // disk index is gone, next build contains all vectors of delta index.
+  ResetDeltaIndex();
+
   // create index rpc
   if (status.error_code() == pb::error::Errno::EINDEX_NOT_FOUND) {
     status = SendVectorNewRequestWrapper();
@@ -723,12 +868,16 @@ butil::Status VectorIndexDiskANN::GetCount(int64_t& count) {
 }
 
 butil::Status VectorIndexDiskANN::GetDeletedCount(int64_t& deleted_count) {
-  deleted_count = 0;
+  RWLockReadGuard guard(&delta_rw_lock_);
+  deleted_count = tombstone_ids_.size();
   return butil::Status::OK();
 }
 
 butil::Status VectorIndexDiskANN::GetMemorySize(int64_t& memory_size) {
-  memory_size = 0;
+  RWLockReadGuard guard(&delta_rw_lock_);
+  // disk index is in diskann server, only delta index is in memory.
+  memory_size = delta_index_->ntotal * (dimension_ * sizeof(float) + sizeof(faiss::idx_t) * 2) +
+                tombstone_ids_.size() * sizeof(int64_t) * 2;
   return butil::Status::OK();
 }
 
@@ -825,10 +974,10 @@ butil::Status VectorIndexDiskANN::DoBuild(const pb::common::Range& region_range,
     int64_t vector_id = VectorCodec::DecodeVectorIdFromEncodeKeyWithTs(key);
     CHECK(vector_id > 0) << fmt::format("vector_id({}) is invalid", vector_id);
 
-    std::string value(mvcc::Codec::UnPackageValue(iter->Value()));
+    auto value = mvcc::Codec::UnPackageValue(iter->Value());
 
     pb::common::Vector vector;
-    CHECK(vector.ParseFromString(value)) << "Parse vector proto error";
+    CHECK(vector.ParseFromArray(value.data(), value.size())) << "Parse vector proto error";
     // std::cout << "key : " << Helper::StringToHex(key) << ", vector_id : " << vector_id << std::endl;
     vector_push_data_request.add_vectors()->Swap(&vector);
     vector_push_data_request.add_vector_ids(vector_id);
@@ -19,11 +19,13 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "brpc/channel.h"
 #include "butil/status.h"
 #include "common/synchronization.h"
+#include "faiss/IndexIDMap.h"
 #include "proto/common.pb.h"
 #include "proto/diskann.pb.h"
 #include "vector/vector_index.h"
@@ -114,6 +116,15 @@ class VectorIndexDiskANN : public VectorIndex, public std::enable_shared_from_th
   bool NeedToSave(int64_t last_save_log_behind) override;
 
  private:
+  // reset delta index when disk index is reset, new disk index is built from all region data.
+  void ResetDeltaIndex();
+  // drop stale vectors of disk result, merge with delta result.
+  void MergeDeltaSearchResult(const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                              std::vector<pb::index::VectorWithDistanceResult>& results);
+  butil::Status SearchDiskIndex(const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                                const pb::common::VectorSearchParameter& parameter,
+                                std::vector<pb::index::VectorWithDistanceResult>& results);
+
   static void InitDiskannServerAddr();
   static void InitWorkSet();
   butil::Status DoBuild(const pb::common::Range& region_range, mvcc::ReaderPtr reader,
@@ -177,6 +188,14 @@ class VectorIndexDiskANN : public VectorIndex, public std::enable_shared_from_th
 
   RWLock rw_lock_;
 
+  // Fresh writes after disk index is built, it is searched by brute force beside disk index,
+  // and is merged into disk index at next reset and build.
+  std::unique_ptr<faiss::IndexIDMap2> delta_index_;
+  // vectors of disk index which are deleted or upserted again after built.
+  std::unordered_set<int64_t> tombstone_ids_;
+  // Protect delta_index_/tombstone_ids_
+  RWLock delta_rw_lock_;
+
   static inline std::string diskann_server_addr;
   static inline WorkerSetPtr diskann_server_build_worker_set;
   static inline WorkerSetPtr diskann_server_load_worker_set;
@@ -24,6 +24,7 @@
 #include "faiss/IndexIDMap.h"
 #include "faiss/IndexIVF.h"
 #include "faiss/IndexIVFFlat.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "server/server.h"
 #include "vector/vector_index.h"
@@ -33,17 +34,20 @@
 #include "vector/vector_index_hnsw.h"
 #include "vector/vector_index_ivf_flat.h"
 #include "vector/vector_index_ivf_pq.h"
+#include "vector/vector_index_segment_hnsw.h"
 #include "vector/vector_index_utils.h"
 
 namespace dingodb {
 
+DECLARE_bool(enable_vector_index_hnsw_segment);
+
 std::shared_ptr<VectorIndex> VectorIndexFactory::New(int64_t id,
                                                      const pb::common::VectorIndexParameter& index_parameter,
                                                      const pb::common::RegionEpoch& epoch,
                                                      const pb::common::Range& range) {
   std::shared_ptr<VectorIndex> vector_index = nullptr;
 
-  auto thread_pool = Server::GetInstance().GetVectorIndexThreadPool();
+  auto thread_pool = Server::GetInstance().GetVectorIndexThreadPool(id);
 
   switch (index_parameter.vector_index_type()) {
     case pb::common::VECTOR_INDEX_TYPE_BRUTEFORCE: {
@@ -123,6 +127,14 @@ std::shared_ptr<VectorIndex> VectorIndexFactory::NewHnsw(int64_t id,
 
   // create index may throw exeception, so we need to catch it
   try {
+    if (FLAGS_enable_vector_index_hnsw_segment) {
+      auto new_segment_hnsw_index =
+          std::make_shared<VectorIndexSegmentHnsw>(id, index_parameter, epoch, range, thread_pool);
+      DINGO_LOG(INFO) << "create segment hnsw index success, id=" << id
+                      << ", parameter=" << index_parameter.ShortDebugString();
+      return new_segment_hnsw_index;
+    }
+
     auto new_hnsw_index = std::make_shared<VectorIndexHnsw>(id, index_parameter, epoch, range, thread_pool);
     if (new_hnsw_index == nullptr) {
       DINGO_LOG(ERROR) << "create hnsw index failed of new_hnsw_index is nullptr, id=" << id
@@ -14,18 +14,24 @@
 
 #include "vector/vector_index_flat.h"
 
+#include <algorithm>
 #include <climits>
 #include <cstddef>
 #include <cstdint>
+#include <exception>
 #include <future>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <string>
 #include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "butil/status.h"
+#include "common/gflag_validator.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
 #include "faiss/Index.h"
@@ -42,11 +48,23 @@
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
+#include "simd/hook.h"
+#include "vector/vector_index_gpu.h"
+#include "vector/vector_index_mmap_reader.h"
 #include "vector/vector_index_utils.h"
 
 namespace dingodb {
 
 DEFINE_int64(flat_need_save_count, 10000, "flat need save count");
+DEFINE_bool(enable_binary_flat_simd_search, true, "search binary flat index by dispatched simd hamming kernel");
+DEFINE_validator(enable_binary_flat_simd_search, &PassBool);
+DEFINE_bool(enable_flat_simd_search, true, "search float flat index by dispatched simd blocked one-to-many kernel");
+DEFINE_validator(enable_flat_simd_search, &PassBool);
+DEFINE_int64(flat_simd_search_max_query_count, 20,
+             "search float flat index by simd kernel only when query count less than this, faiss use blas above it");
+BRPC_VALIDATE_GFLAG(flat_simd_search_max_query_count, brpc::NonNegativeInteger);
+
+DECLARE_bool(vector_index_load_use_mmap);
 
 bvar::LatencyRecorder g_flat_upsert_latency("dingo_flat_upsert_latency");
 bvar::LatencyRecorder g_flat_search_latency("dingo_flat_search_latency");
@@ -96,6 +114,10 @@ VectorIndexFlat<T, U>::VectorIndexFlat(int64_t id, const pb::common::VectorIndex
     }
 
     index_id_map2_ = std::make_unique<U>(raw_index_.get());
+
+    if (VectorIndexGpuMirror::IsEnabled()) {
+      gpu_mirror_ = std::make_unique<VectorIndexGpuMirror>(id);
+    }
   } else if constexpr (std::is_same<T, faiss::IndexBinary>::value) {
     metric_type_ = vector_index_parameter.binary_flat_parameter().metric_type();
     dimension_ = vector_index_parameter.binary_flat_parameter().dimension();
@@ -158,6 +180,10 @@ butil::Status VectorIndexFlat<T, U>::AddOrUpsert(const std::vector<pb::common::V
     DINGO_LOG(FATAL);
   }
 
+  if (gpu_mirror_ != nullptr) {
+    gpu_mirror_->Invalidate();
+  }
+
   return butil::Status::OK();
 }
 
@@ -194,6 +220,10 @@ butil::Status VectorIndexFlat<T, U>::Delete(const std::vector<int64_t>& delete_i
           DINGO_LOG(WARNING) << fmt::format("[vector_index.flat][id({})] remove not found vector id.", Id());
           return butil::Status(pb::error::Errno::EVECTOR_INVALID, "remove not found vector id");
         }
+
+        if (gpu_mirror_ != nullptr) {
+          gpu_mirror_->Invalidate();
+        }
       }
     }
 
@@ -201,6 +231,109 @@ butil::Status VectorIndexFlat<T, U>::Delete(const std::vector<int64_t>& delete_i
   }
 }
 
+// Exhaustive hamming knn search on binary flat codes, use runtime dispatched popcount kernel instead of
+// faiss default hamming computer. Return false if index is not binary flat.
+static bool BinaryFlatSearch(const faiss::IndexBinaryIDMap2* index_id_map2, int64_t n, const uint8_t* x, int64_t k,
+                             int32_t* distances, faiss::idx_t* labels) {
+  const auto* flat_index = dynamic_cast<const faiss::IndexBinaryFlat*>(index_id_map2->index);
+  if (flat_index == nullptr) {
+    return false;
+  }
+
+  const int64_t code_size = flat_index->code_size;
+  const int64_t ntotal = flat_index->ntotal;
+  const uint8_t* codes = flat_index->xb.data();
+  std::vector<std::pair<int32_t, int64_t>> heap;
+  heap.reserve(k);
+  for (int64_t i = 0; i < n; ++i) {
+    const uint8_t* query = x + i * code_size;
+    heap.clear();
+    // max heap of top k nearest
+    for (int64_t j = 0; j < ntotal; ++j) {
+      int32_t distance = static_cast<int32_t>(hamming_distance(query, codes + j * code_size, code_size));
+      if (static_cast<int64_t>(heap.size()) < k) {
+        heap.emplace_back(distance, j);
+        std::push_heap(heap.begin(), heap.end());
+      } else if (distance < heap.front().first) {
+        std::pop_heap(heap.begin(), heap.end());
+        heap.back() = {distance, j};
+        std::push_heap(heap.begin(), heap.end());
+      }
+    }
+
+    std::sort_heap(heap.begin(), heap.end());
+    for (int64_t j = 0; j < k; ++j) {
+      if (j < static_cast<int64_t>(heap.size())) {
+        distances[i * k + j] = heap[j].first;
+        labels[i * k + j] = index_id_map2->id_map[heap[j].second];
+      } else {
+        distances[i * k + j] = std::numeric_limits<int32_t>::max();
+        labels[i * k + j] = -1;
+      }
+    }
+  }
+
+  return true;
+}
+
+// Exhaustive knn search on float flat codes, distances of a query to a block of database vectors are computed
+// by runtime dispatched register blocked kernel. Return false if index is not float flat.
+static bool FloatFlatSearch(const faiss::IndexIDMap2* index_id_map2, int64_t n, const float* x, int64_t k,
+                            float* distances, faiss::idx_t* labels) {
+  const auto* flat_index = dynamic_cast<const faiss::IndexFlat*>(index_id_map2->index);
+  if (flat_index == nullptr) {
+    return false;
+  }
+
+  const int64_t kBlockSize = 1024;
+  const bool is_l2 = flat_index->metric_type == faiss::METRIC_L2;
+  const int64_t dimension = flat_index->d;
+  const int64_t ntotal = flat_index->ntotal;
+  const float* xb = flat_index->get_xb();
+
+  std::vector<float> block_distances(kBlockSize);
+  // max heap of top k, key is distance for l2 and negative inner product for ip, smaller is nearer.
+  std::vector<std::pair<float, int64_t>> heap;
+  heap.reserve(k);
+  for (int64_t i = 0; i < n; ++i) {
+    const float* query = x + i * dimension;
+    heap.clear();
+    for (int64_t start = 0; start < ntotal; start += kBlockSize) {
+      int64_t block_size = std::min(kBlockSize, ntotal - start);
+      if (is_l2) {
+        fvec_L2sqr_ny(block_distances.data(), query, xb + start * dimension, dimension, block_size);
+      } else {
+        fvec_inner_products_ny(block_distances.data(), query, xb + start * dimension, dimension, block_size);
+      }
+
+      for (int64_t j = 0; j < block_size; ++j) {
+        float key = is_l2 ? block_distances[j] : -block_distances[j];
+        if (static_cast<int64_t>(heap.size()) < k) {
+          heap.emplace_back(key, start + j);
+          std::push_heap(heap.begin(), heap.end());
+        } else if (key < heap.front().first) {
+          std::pop_heap(heap.begin(), heap.end());
+          heap.back() = {key, start + j};
+          std::push_heap(heap.begin(), heap.end());
+        }
+      }
+    }
+
+    std::sort_heap(heap.begin(), heap.end());
+    for (int64_t j = 0; j < k; ++j) {
+      if (j < static_cast<int64_t>(heap.size())) {
+        distances[i * k + j] = is_l2 ? heap[j].first : -heap[j].first;
+        labels[i * k + j] = index_id_map2->id_map[heap[j].second];
+      } else {
+        distances[i * k + j] = is_l2 ? std::numeric_limits<float>::max() : -std::numeric_limits<float>::max();
+        labels[i * k + j] = -1;
+      }
+    }
+  }
+
+  return true;
+}
+
 template <typename T, typename U>
 butil::Status VectorIndexFlat<T, U>::Search(const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
                                             const std::vector<std::shared_ptr<FilterFunctor>>& filters, bool,
@@ -233,7 +366,9 @@ butil::Status VectorIndexFlat<T, U>::Search(const std::vector<pb::common::Vector
         flat_search_parameters.sel = flat_filter.get();
         index_id_map2_->search(vector_with_ids.size(), vector_values.get(), topk, distances.data(), labels.data(),
                                &flat_search_parameters);
-      } else {
+      } else if (!FLAGS_enable_binary_flat_simd_search ||
+                 !BinaryFlatSearch(index_id_map2_.get(), vector_with_ids.size(), vector_values.get(), topk,
+                                   distances.data(), labels.data())) {
         index_id_map2_->search(vector_with_ids.size(), vector_values.get(), topk, distances.data(), labels.data());
       }
       VectorIndexUtils::FillSearchResult(vector_with_ids, topk, distances, labels, metric_type_, dimension_, results);
@@ -248,7 +383,14 @@ butil::Status VectorIndexFlat<T, U>::Search(const std::vector<pb::common::Vector
         flat_search_parameters.sel = flat_filter.get();
         index_id_map2_->search(vector_with_ids.size(), vector_values.get(), topk, distances.data(), labels.data(),
                                &flat_search_parameters);
-      } else {
+      } else if (gpu_mirror_ != nullptr &&
+                 gpu_mirror_->Search(index_id_map2_.get(), vector_with_ids.size(), vector_values.get(), topk, nullptr,
+                                     distances.data(), labels.data())) {
+        // searched on gpu
+      } else if (!FLAGS_enable_flat_simd_search ||
+                 static_cast<int64_t>(vector_with_ids.size()) >= FLAGS_flat_simd_search_max_query_count ||
+                 !FloatFlatSearch(index_id_map2_.get(), vector_with_ids.size(), vector_values.get(), topk,
+                                  distances.data(), labels.data())) {
         index_id_map2_->search(vector_with_ids.size(), vector_values.get(), topk, distances.data(), labels.data());
       }
       VectorIndexUtils::FillSearchResult(vector_with_ids, topk, distances, labels, metric_type_, dimension_, results);
@@ -374,11 +516,21 @@ butil::Status VectorIndexFlat<T, U>::Load(const std::string& path) {
 
   // The outside has been locked. Remove the locking operation here.
   T* internal_raw_index = nullptr;
+  bool use_mmap = FLAGS_vector_index_load_use_mmap;
+  VectorIndexMmapReader mmap_reader;
+  if (use_mmap) {
+    auto status = mmap_reader.Open(path);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
   try {
     if constexpr (std::is_same<T, faiss::Index>::value) {
-      internal_raw_index = faiss::read_index(path.c_str(), 0);
+      internal_raw_index = use_mmap ? faiss::read_index(&mmap_reader, 0) : faiss::read_index(path.c_str(), 0);
     } else if constexpr (std::is_same<T, faiss::IndexBinary>::value) {
-      internal_raw_index = faiss::read_index_binary(path.c_str(), 0);
+      internal_raw_index =
+          use_mmap ? faiss::read_index_binary(&mmap_reader, 0) : faiss::read_index_binary(path.c_str(), 0);
     } else {
       DINGO_LOG(FATAL);
     }
@@ -451,6 +603,9 @@ butil::Status VectorIndexFlat<T, U>::Load(const std::string& path) {
 
   raw_index_.reset();
   index_id_map2_ = std::move(internal_index_id_map2);
+  if (gpu_mirror_ != nullptr) {
+    gpu_mirror_->Invalidate();
+  }
 
   if (pb::common::MetricType::METRIC_TYPE_COSINE == metric_type_) {
     normalize_ = true;
@@ -495,6 +650,9 @@ butil::Status VectorIndexFlat<T, U>::GetMemorySize(int64_t& memory_size) {
   if constexpr (std::is_same<T, faiss::Index>::value) {
     memory_size = count * sizeof(faiss::idx_t) + count * dimension_ * sizeof(faiss::Index::component_t) +
                   (sizeof(faiss::idx_t) + sizeof(faiss::idx_t)) * index_id_map2_->rev_map.size();
+    if (gpu_mirror_ != nullptr) {
+      memory_size += gpu_mirror_->MemorySize();
+    }
   } else if constexpr (std::is_same<T, faiss::IndexBinary>::value) {
     memory_size = count * sizeof(faiss::idx_t) +
                   count * dimension_ / CHAR_BIT * sizeof(faiss::IndexBinary::component_t) +
@@ -530,6 +688,75 @@ bool VectorIndexFlat<T, U>::NeedToSave(int64_t last_save_log_behind) {
   return false;
 }
 
+template <typename T, typename U>
+butil::Status VectorIndexFlat<T, U>::CopyTo(std::shared_ptr<VectorIndex> target, int64_t begin_vector_id,
+                                            int64_t end_vector_id) {
+  auto target_index = std::dynamic_pointer_cast<VectorIndexFlat<T, U>>(target);
+  if (target_index == nullptr || target_index.get() == this) {
+    return butil::Status(pb::error::Errno::ENOT_SUPPORT, "target vector index type not match");
+  }
+  if (target_index->dimension_ != dimension_ || target_index->metric_type_ != metric_type_) {
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "target vector index parameter not match");
+  }
+
+  // vector is stored normalized, so copy stored codes directly.
+  constexpr size_t kBatchSize = 4096;
+  using ValueType = std::conditional_t<std::is_same<T, faiss::IndexBinary>::value, uint8_t, float>;
+
+  RWLockReadGuard guard(&rw_lock_);
+  RWLockWriteGuard target_guard(&target_index->rw_lock_);
+
+  const auto* internal_index = index_id_map2_->index;
+  size_t code_size = 0;
+  if constexpr (std::is_same<T, faiss::IndexBinary>::value) {
+    code_size = internal_index->code_size;
+  } else {
+    code_size = internal_index->d;
+  }
+
+  std::vector<faiss::idx_t> ids;
+  std::vector<ValueType> values;
+  ids.reserve(kBatchSize);
+  values.resize(kBatchSize * code_size);
+  int64_t count = 0;
+
+  try {
+    const auto& id_map = index_id_map2_->id_map;
+    for (size_t i = 0; i < id_map.size(); ++i) {
+      if (id_map[i] < begin_vector_id || id_map[i] >= end_vector_id) {
+        continue;
+      }
+
+      internal_index->reconstruct(i, values.data() + ids.size() * code_size);
+      ids.push_back(id_map[i]);
+      if (ids.size() == kBatchSize) {
+        target_index->index_id_map2_->add_with_ids(ids.size(), values.data(), ids.data());
+        count += ids.size();
+        ids.clear();
+      }
+    }
+
+    if (!ids.empty()) {
+      target_index->index_id_map2_->add_with_ids(ids.size(), values.data(), ids.data());
+      count += ids.size();
+    }
+  } catch (std::exception& e) {
+    std::string s = fmt::format("copy flat index failed, error: {}", e.what());
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.flat][id({})] {}", Id(), s);
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  if (target_index->gpu_mirror_ != nullptr) {
+    target_index->gpu_mirror_->Invalidate();
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.flat][id({})] copy to index({}) range[{}, {}) count({}/{})", Id(),
+                                 target_index->Id(), begin_vector_id, end_vector_id, count,
+                                 index_id_map2_->id_map.size());
+
+  return butil::Status::OK();
+}
+
 template <typename T, typename U>
 template <typename V>
 std::vector<faiss::idx_t> VectorIndexFlat<T, U>::GetExistVectorIds(const V& ids, size_t size) {
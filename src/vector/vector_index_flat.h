@@ -29,6 +29,7 @@
 #include "faiss/utils/distances.h"
 #include "proto/common.pb.h"
 #include "vector/vector_index.h"
+#include "vector/vector_index_gpu.h"
 
 namespace dingodb {
 
@@ -112,6 +113,8 @@ class VectorIndexFlat : public VectorIndex {
 
   bool NeedToSave(int64_t last_save_log_behind) override;
 
+  butil::Status CopyTo(std::shared_ptr<VectorIndex> target, int64_t begin_vector_id, int64_t end_vector_id) override;
+
  private:
   template <typename V>
   std::vector<faiss::idx_t> GetExistVectorIds(const V& ids, size_t size);
@@ -126,6 +129,9 @@ class VectorIndexFlat : public VectorIndex {
 
   std::unique_ptr<U> index_id_map2_;
 
+  // only for float index, nullptr when gpu is not enabled.
+  VectorIndexGpuMirrorPtr gpu_mirror_;
+
   RWLock rw_lock_;
 
   // normalize vector
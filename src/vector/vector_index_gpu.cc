@@ -0,0 +1,187 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_index_gpu.h"
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+
+#include "brpc/reloadable_flags.h"
+#include "bthread/mutex.h"
+#include "bvar/reducer.h"
+#include "common/gflag_validator.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "faiss/Index.h"
+#include "faiss/IndexIVF.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+#ifdef ENABLE_FAISS_GPU_MODULE
+#include "faiss/gpu/GpuCloner.h"
+#include "faiss/gpu/StandardGpuResources.h"
+#include "faiss/gpu/utils/DeviceUtils.h"
+#endif
+
+namespace dingodb {
+
+DEFINE_bool(enable_vector_index_gpu, false, "search large flat and ivf vector index on gpu, need build with gpu");
+DEFINE_validator(enable_vector_index_gpu, &PassBool);
+DEFINE_int32(vector_index_gpu_device, 0, "gpu device of vector index");
+BRPC_VALIDATE_GFLAG(vector_index_gpu_device, brpc::NonNegativeInteger);
+DEFINE_int64(vector_index_gpu_min_count, 100000, "vector index search on gpu only when vector count reach this");
+BRPC_VALIDATE_GFLAG(vector_index_gpu_min_count, brpc::NonNegativeInteger);
+DEFINE_int64(vector_index_gpu_rebuild_interval_s, 60, "min interval of copy changed vector index to gpu again");
+BRPC_VALIDATE_GFLAG(vector_index_gpu_rebuild_interval_s, brpc::NonNegativeInteger);
+
+bvar::Adder<int64_t> g_vector_index_gpu_search_count("dingo_vector_index_gpu_search_count");
+bvar::Adder<int64_t> g_vector_index_gpu_rebuild_count("dingo_vector_index_gpu_rebuild_count");
+bvar::Adder<int64_t> g_vector_index_gpu_memory_size("dingo_vector_index_gpu_memory_size");
+
+#ifdef ENABLE_FAISS_GPU_MODULE
+// gpu resources is shared by all index, it is not thread safe, so all gpu operation is serialized.
+static faiss::gpu::StandardGpuResources* GetGpuResources() {
+  static auto* resources = new faiss::gpu::StandardGpuResources();
+  return resources;
+}
+
+static bthread_mutex_t* GetGpuMutex() {
+  static bthread_mutex_t* mutex = []() {
+    auto* mutex = new bthread_mutex_t;
+    bthread_mutex_init(mutex, nullptr);
+    return mutex;
+  }();
+  return mutex;
+}
+#endif
+
+// memory of vector codes and ids, gpu index keep same layout as cpu index.
+static int64_t EstimateMemorySize(const faiss::Index* cpu_index) {
+  const auto* ivf_index = dynamic_cast<const faiss::IndexIVF*>(cpu_index);
+  if (ivf_index != nullptr) {
+    return ivf_index->ntotal * (ivf_index->code_size + sizeof(faiss::idx_t)) +
+           ivf_index->nlist * ivf_index->d * sizeof(float);
+  }
+
+  return cpu_index->ntotal * (cpu_index->d * sizeof(float) + sizeof(faiss::idx_t));
+}
+
+VectorIndexGpuMirror::VectorIndexGpuMirror(int64_t id) : id_(id) { bthread_mutex_init(&mutex_, nullptr); }
+
+VectorIndexGpuMirror::~VectorIndexGpuMirror() {
+  g_vector_index_gpu_memory_size << -memory_size_;
+#ifdef ENABLE_FAISS_GPU_MODULE
+  if (gpu_index_ != nullptr) {
+    BAIDU_SCOPED_LOCK(*GetGpuMutex());
+    gpu_index_.reset();
+  }
+#endif
+  bthread_mutex_destroy(&mutex_);
+}
+
+bool VectorIndexGpuMirror::IsEnabled() {
+#ifdef ENABLE_FAISS_GPU_MODULE
+  static const int kDeviceCount = []() {
+    try {
+      return faiss::gpu::getNumDevices();
+    } catch (std::exception& e) {
+      DINGO_LOG(ERROR) << fmt::format("[vector_index.gpu] get gpu device failed, error: {}", e.what());
+      return 0;
+    }
+  }();
+
+  return FLAGS_enable_vector_index_gpu && FLAGS_vector_index_gpu_device < kDeviceCount;
+#else
+  return false;
+#endif
+}
+
+void VectorIndexGpuMirror::Invalidate() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  is_stale_ = true;
+}
+
+int64_t VectorIndexGpuMirror::MemorySize() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return memory_size_;
+}
+
+bool VectorIndexGpuMirror::Rebuild(const faiss::Index* cpu_index) {
+#ifdef ENABLE_FAISS_GPU_MODULE
+  int64_t now_ms = Helper::TimestampMs();
+  // limit copy rate of frequently changed or failed index, search on cpu meanwhile.
+  if (last_build_time_ms_ > 0 && now_ms - last_build_time_ms_ < FLAGS_vector_index_gpu_rebuild_interval_s * 1000) {
+    return false;
+  }
+  last_build_time_ms_ = now_ms;
+
+  // release old copy first, gpu memory may not hold two copies.
+  BAIDU_SCOPED_LOCK(*GetGpuMutex());
+  gpu_index_.reset();
+  g_vector_index_gpu_memory_size << -memory_size_;
+  memory_size_ = 0;
+
+  try {
+    gpu_index_.reset(faiss::gpu::index_cpu_to_gpu(GetGpuResources(), FLAGS_vector_index_gpu_device, cpu_index));
+  } catch (std::exception& e) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.gpu][id({})] copy index to gpu failed, error: {}", id_, e.what());
+    return false;
+  }
+
+  is_stale_ = false;
+  memory_size_ = EstimateMemorySize(cpu_index);
+  g_vector_index_gpu_memory_size << memory_size_;
+  g_vector_index_gpu_rebuild_count << 1;
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.gpu][id({})] copy index to gpu, count({}) memory_size({})", id_,
+                                 cpu_index->ntotal, memory_size_);
+  return true;
+#else
+  (void)cpu_index;
+  return false;
+#endif
+}
+
+bool VectorIndexGpuMirror::Search(const faiss::Index* cpu_index, faiss::idx_t n, const float* x, faiss::idx_t k,
+                                  const faiss::SearchParameters* params, float* distances, faiss::idx_t* labels) {
+#ifdef ENABLE_FAISS_GPU_MODULE
+  // gpu index not support id selector
+  if (!IsEnabled() || (params != nullptr && params->sel != nullptr) ||
+      cpu_index->ntotal < FLAGS_vector_index_gpu_min_count) {
+    return false;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (is_stale_ && !Rebuild(cpu_index)) {
+    return false;
+  }
+
+  try {
+    BAIDU_SCOPED_LOCK(*GetGpuMutex());
+    gpu_index_->search(n, x, k, distances, labels, params);
+  } catch (std::exception& e) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.gpu][id({})] search on gpu failed, error: {}", id_, e.what());
+    return false;
+  }
+
+  g_vector_index_gpu_search_count << 1;
+  return true;
+#else
+  (void)cpu_index, (void)n, (void)x, (void)k, (void)params, (void)distances, (void)labels;
+  return false;
+#endif
+}
+
+}  // namespace dingodb
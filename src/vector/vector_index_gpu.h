@@ -0,0 +1,69 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_INDEX_GPU_H_  // NOLINT
+#define DINGODB_VECTOR_INDEX_GPU_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "bthread/mutex.h"
+#include "faiss/Index.h"
+
+namespace dingodb {
+
+// Gpu copy of a cpu faiss flat/ivf index, only for search of large region.
+// Cpu index is still the source of truth for write, save and load, any write make the copy stale and
+// it is copied again at a later search. Search fallback to cpu when gpu is not built in, the region is
+// small, the copy is stale, or there is filter which gpu index not support.
+class VectorIndexGpuMirror {
+ public:
+  explicit VectorIndexGpuMirror(int64_t id);
+  ~VectorIndexGpuMirror();
+
+  VectorIndexGpuMirror(const VectorIndexGpuMirror&) = delete;
+  VectorIndexGpuMirror& operator=(const VectorIndexGpuMirror&) = delete;
+
+  // built with faiss gpu, enabled by flag and gpu device is found.
+  static bool IsEnabled();
+
+  // cpu index is changed, caller hold write lock of cpu index.
+  void Invalidate();
+
+  // search on gpu copy of cpu_index, caller hold read lock of cpu index.
+  // return false if not search on gpu, caller should search on cpu.
+  bool Search(const faiss::Index* cpu_index, faiss::idx_t n, const float* x, faiss::idx_t k,
+              const faiss::SearchParameters* params, float* distances, faiss::idx_t* labels);
+
+  // gpu memory used by the copy.
+  int64_t MemorySize();
+
+ private:
+  // caller hold mutex_
+  bool Rebuild(const faiss::Index* cpu_index);
+
+  int64_t id_;
+
+  bthread_mutex_t mutex_;
+  std::unique_ptr<faiss::Index> gpu_index_;
+  bool is_stale_{true};
+  int64_t last_build_time_ms_{0};
+  int64_t memory_size_{0};
+};
+
+using VectorIndexGpuMirrorPtr = std::unique_ptr<VectorIndexGpuMirror>;
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_INDEX_GPU_H_  // NOLINT
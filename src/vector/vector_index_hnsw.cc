@@ -20,13 +20,18 @@
 #include <cstdint>
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "butil/status.h"
 #include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
+#include "common/gflag_validator.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
@@ -35,7 +40,9 @@
 #include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
+#include "vector/hnsw_quantized_space.h"
 #include "vector/vector_index.h"
+#include "vector/vector_index_mmap_reader.h"
 #include "vector/vector_index_utils.h"
 
 namespace dingodb {
@@ -47,8 +54,39 @@ DEFINE_int64(hnsw_need_save_count, 10000, "hnsw need save count");
 DEFINE_uint32(hnsw_max_init_max_elements, 100000, "hnsw max init max elements");
 
 DEFINE_uint32(hnsw_max_elements_amplification_multiple, 1, "hnsw max elements amplification multiple");
+DEFINE_int64(hnsw_max_expand_step_elements, 1000000,
+             "hnsw capacity is doubled at write, but grow at most this each time for large index");
+BRPC_VALIDATE_GFLAG(hnsw_max_expand_step_elements, brpc::PositiveInteger);
+
+DEFINE_bool(hnsw_enable_replace_deleted, true,
+            "new vector reuse slot of deleted vector and repair graph around it in place, only effect new created "
+            "index, loaded index always enable");
+DEFINE_validator(hnsw_enable_replace_deleted, &PassBool);
+DEFINE_double(hnsw_rebuild_deleted_ratio, 0.5, "hnsw need rebuild when deleted ratio exceed this");
+DEFINE_validator(hnsw_rebuild_deleted_ratio, &PassDouble);
+DEFINE_double(hnsw_replace_deleted_rebuild_ratio, 0.9,
+              "hnsw which reuse deleted slot need rebuild when deleted ratio exceed this, deleted vector still slow "
+              "down search");
+DEFINE_validator(hnsw_replace_deleted_rebuild_ratio, &PassDouble);
+
+static bool ValidateHnswQuantizeType(const char* /*flagname*/, const std::string& value) {
+  HnswQuantizeType quantize_type;
+  return HnswQuantizedSpace::ParseQuantizeType(value, quantize_type);
+}
+DEFINE_string(hnsw_quantize_type, "none",
+              "hnsw vector storage quantize type, none/sq8/fp16/bf16, sq8 cut memory 4x and fp16/bf16 cut 2x, only "
+              "effect new created index");
+DEFINE_validator(hnsw_quantize_type, &ValidateHnswQuantizeType);
+DEFINE_int32(hnsw_quantize_rerank_multiple, 2,
+             "quantized hnsw search topk*multiple candidates, then re-rank them by distance to float query");
+BRPC_VALIDATE_GFLAG(hnsw_quantize_rerank_multiple, brpc::PositiveInteger);
+DEFINE_int32(hnsw_range_search_init_topk, 64,
+             "hnsw range search start with this topk, double it while all results are within radius");
+BRPC_VALIDATE_GFLAG(hnsw_range_search_init_topk, brpc::PositiveInteger);
 
 DECLARE_int64(vector_max_batch_count);
+DECLARE_int64(vector_index_max_range_search_result_count);
+DECLARE_bool(vector_index_load_use_mmap);
 
 DEFINE_uint32(hnsw_vector_write_batch_size_per_task, 16, "hnsw vector write batch size per task");
 DECLARE_uint32(vector_read_batch_size_per_task);
@@ -59,6 +97,13 @@ bvar::LatencyRecorder g_hnsw_search_latency("dingo_hnsw_search_latency");
 bvar::LatencyRecorder g_hnsw_range_search_latency("dingo_hnsw_range_search_latency");
 bvar::LatencyRecorder g_hnsw_delete_latency("dingo_hnsw_delete_latency");
 bvar::LatencyRecorder g_hnsw_load_latency("dingo_hnsw_load_latency");
+bvar::Adder<int64_t> g_hnsw_expand_count("dingo_hnsw_expand_count");
+
+static HnswQuantizeType GetHnswQuantizeType() {
+  HnswQuantizeType quantize_type = HnswQuantizeType::kNone;
+  HnswQuantizedSpace::ParseQuantizeType(FLAGS_hnsw_quantize_type, quantize_type);
+  return quantize_type;
+}
 
 // Filter vector id used by region range.
 class HnswRangeFilterFunctor : public hnswlib::BaseFilterFunctor {
@@ -85,40 +130,14 @@ class HnswRangeFilterFunctor : public hnswlib::BaseFilterFunctor {
 template <typename Function>
 inline void ParallelFor(ThreadPoolPtr thread_pool, int64_t vector_index_id, size_t start, size_t end,
                         uint32_t batch_size, bool is_priority, Function fn) {
-  struct Parameter {
-    size_t start_pos;
-    size_t end_pos;
-  };
-
   int64_t start_time = Helper::TimestampMs();
   // in thread pool run
   if (thread_pool != nullptr) {
-    std::vector<ThreadPool::TaskPtr> tasks;
-    for (size_t i = start; i < end; i += batch_size) {
-      Parameter* param = new Parameter();
-      param->start_pos = i;
-      param->end_pos = std::min(i + batch_size, end);
-
-      auto task = thread_pool->ExecuteTask(
-          [&](void* arg) {
-            Parameter* param = static_cast<Parameter*>(arg);
-            for (int j = param->start_pos; j < param->end_pos; ++j) {
-              fn(j);
-            }
-          },
-          param, is_priority ? 1 : 0);
-
-      if (task != nullptr) {
-        tasks.push_back(task);
-      } else {
-        delete param;
+    thread_pool->ParallelFor(start, end, batch_size, is_priority ? 1 : 0, [&](size_t begin_pos, size_t end_pos) {
+      for (size_t j = begin_pos; j < end_pos; ++j) {
+        fn(j);
       }
-    }
-
-    for (auto& task : tasks) {
-      task->Join();
-      delete static_cast<Parameter*>(task->arg);
-    }
+    });
   } else {
     // in-place run
     for (size_t i = start; i < end; ++i) {
@@ -135,7 +154,10 @@ inline void ParallelFor(ThreadPoolPtr thread_pool, int64_t vector_index_id, size
 VectorIndexHnsw::VectorIndexHnsw(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
                                  const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
                                  ThreadPoolPtr thread_pool)
-    : VectorIndex(id, vector_index_parameter, epoch, range, thread_pool), hnsw_space_(nullptr), hnsw_index_(nullptr) {
+    : VectorIndex(id, vector_index_parameter, epoch, range, thread_pool),
+      hnsw_index_(nullptr),
+      hnsw_space_(nullptr),
+      quantized_space_(nullptr) {
   if (vector_index_type == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW) {
     // const auto& hnsw_parameter = vector_index_parameter.hnsw_parameter();
     auto& hnsw_parameter = const_cast<pb::common::CreateHnswParam&>(vector_index_parameter.hnsw_parameter());
@@ -150,7 +172,13 @@ VectorIndexHnsw::VectorIndexHnsw(int64_t id, const pb::common::VectorIndexParame
 
     normalize_ = false;
 
-    if (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT) {
+    auto quantize_type = GetHnswQuantizeType();
+    if (quantize_type != HnswQuantizeType::kNone) {
+      normalize_ = (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_COSINE);
+      quantized_space_ =
+          new HnswQuantizedSpace(quantize_type, hnsw_parameter.metric_type(), hnsw_parameter.dimension());
+      hnsw_space_ = quantized_space_;
+    } else if (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT) {
       hnsw_space_ = new hnswlib::InnerProductSpace(hnsw_parameter.dimension());
     } else if (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_COSINE) {
       normalize_ = true;
@@ -166,10 +194,10 @@ VectorIndexHnsw::VectorIndexHnsw(int64_t id, const pb::common::VectorIndexParame
     DINGO_LOG(INFO) << fmt::format(
         "[vector_index.hnsw][id({})] create index, init_max_elements={} max_element_limit={} nlinks={} "
         "efconstruction={} "
-        "metric_type={} dimension={}",
+        "metric_type={} dimension={} quantize_type={}",
         Id(), FLAGS_hnsw_max_init_max_elements, max_element_limit_, hnsw_parameter.nlinks(),
         hnsw_parameter.efconstruction(), pb::common::MetricType_Name(hnsw_parameter.metric_type()),
-        hnsw_parameter.dimension());
+        hnsw_parameter.dimension(), HnswQuantizedSpace::QuantizeTypeName(quantize_type));
 
     uint32_t hnsw_init_max_elements = 0;
     if (max_element_limit_ < FLAGS_hnsw_max_init_max_elements) {
@@ -179,7 +207,8 @@ VectorIndexHnsw::VectorIndexHnsw(int64_t id, const pb::common::VectorIndexParame
     }
 
     hnsw_index_ = new hnswlib::HierarchicalNSW<float>(hnsw_space_, hnsw_init_max_elements, hnsw_parameter.nlinks(),
-                                                      hnsw_parameter.efconstruction(), 100, false);
+                                                      hnsw_parameter.efconstruction(), 100,
+                                                      FLAGS_hnsw_enable_replace_deleted);
   }
 }
 
@@ -216,20 +245,15 @@ butil::Status VectorIndexHnsw::Upsert(const std::vector<pb::common::VectorWithId
   // Add data to index
   try {
     // check if we need to expand the max_elements
-    auto batch_count = std::max(FLAGS_vector_max_batch_count, static_cast<int64_t>(vector_with_ids.size()));
-    if (hnsw_index_->getCurrentElementCount() + batch_count * 2 > hnsw_index_->getMaxElements()) {
-      auto new_max_elements = hnsw_index_->getMaxElements() * 2;
-      DINGO_LOG(INFO) << fmt::format("[vector_index.hnsw][id({})] expand max element, {} -> {}.", Id(),
-                                     hnsw_index_->getMaxElements(), new_max_elements);
+    ExpandMaxElements(std::max(FLAGS_vector_max_batch_count, static_cast<int64_t>(vector_with_ids.size())));
 
-      hnsw_index_->resizeIndex(new_max_elements);
-    }
+    auto replace_deleted = PrepareReplaceDeleted(vector_with_ids);
 
     if (!normalize_) {
       ParallelFor(thread_pool, Id(), 0, vector_with_ids.size(), FLAGS_hnsw_vector_write_batch_size_per_task,
                   is_priority, [&](size_t row) {
-                    this->hnsw_index_->addPoint((void*)vector_with_ids[row].vector().float_values().data(),
-                                                vector_with_ids[row].id(), false);
+                    this->AddPoint(vector_with_ids[row].vector().float_values().data(), vector_with_ids[row].id(),
+                                   replace_deleted[row]);
                   });
     } else {
       ParallelFor(thread_pool, Id(), 0, vector_with_ids.size(), FLAGS_hnsw_vector_write_batch_size_per_task,
@@ -239,7 +263,7 @@ butil::Status VectorIndexHnsw::Upsert(const std::vector<pb::common::VectorWithId
                     VectorIndexUtils::NormalizeVectorForHnsw(
                         (float*)vector_with_ids[row].vector().float_values().data(), dimension_, norm_array.data());
 
-                    this->hnsw_index_->addPoint((void*)norm_array.data(), vector_with_ids[row].id(), false);
+                    this->AddPoint(norm_array.data(), vector_with_ids[row].id(), replace_deleted[row]);
                   });
     }
     return butil::Status();
@@ -305,9 +329,30 @@ butil::Status VectorIndexHnsw::Load(const std::string& path) {
   // FIXME: need to prevent SEGV when delete old_hnsw_index
   if (vector_index_type == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW) {
     auto* old_hnsw_index = hnsw_index_;
+    // capacity is at least element count of file, and expand at write, not allocate the whole limit at load.
     uint32_t actual_max_elements =
-        vector_index_parameter.hnsw_parameter().max_elements() + Constant::kHnswMaxElementsExpandNum;
-    hnsw_index_ = new hnswlib::HierarchicalNSW<float>(hnsw_space_, path, false, actual_max_elements, true);
+        std::min(static_cast<uint32_t>(vector_index_parameter.hnsw_parameter().max_elements()) +
+                     Constant::kHnswMaxElementsExpandNum,
+                 FLAGS_hnsw_max_init_max_elements);
+    // hnswlib read file by itself, just read ahead file into page cache.
+    if (FLAGS_vector_index_load_use_mmap) {
+      VectorIndexMmapReader::PrefetchFile(path);
+    }
+    auto* new_hnsw_index = new hnswlib::HierarchicalNSW<float>(hnsw_space_, path, false, actual_max_elements, true);
+
+    // index file saved with another quantize type
+    if (new_hnsw_index->size_data_per_element_ !=
+        new_hnsw_index->size_links_level0_ + new_hnsw_index->data_size_ + sizeof(hnswlib::labeltype)) {
+      delete new_hnsw_index;
+      std::string s = fmt::format("index file element size not match, quantize_type({})",
+                                  HnswQuantizedSpace::QuantizeTypeName(quantized_space_ != nullptr
+                                                                           ? quantized_space_->QuantizeType()
+                                                                           : HnswQuantizeType::kNone));
+      DINGO_LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
+      return butil::Status(pb::error::Errno::EINTERNAL, s);
+    }
+
+    hnsw_index_ = new_hnsw_index;
     delete old_hnsw_index;
     return butil::Status::OK();
   } else {
@@ -382,7 +427,7 @@ butil::Status VectorIndexHnsw::Search(const std::vector<pb::common::VectorWithId
 
       if (reconstruct) {
         try {
-          std::vector<float> data = hnsw_index_->getDataByLabel<float>(data_label[row * topk + i]);
+          std::vector<float> data = GetVectorByLabel(data_label[row * topk + i]);
           for (auto& value : data) {
             vector_with_id->mutable_vector()->add_float_values(value);
           }
@@ -433,7 +478,7 @@ butil::Status VectorIndexHnsw::Search(const std::vector<pb::common::VectorWithId
                   std::priority_queue<std::pair<float, hnswlib::labeltype>> result;
 
                   try {
-                    result = hnsw_index_->searchKnn(data.get() + dimension_ * row, topk, hnsw_filter.get());
+                    result = SearchKnn(data.get() + dimension_ * row, topk, hnsw_filter.get());
                   } catch (std::runtime_error& e) {
                     std::string s = fmt::format("parallel search vector failed, error: {}", e.what());
                     LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
@@ -456,7 +501,7 @@ butil::Status VectorIndexHnsw::Search(const std::vector<pb::common::VectorWithId
           std::priority_queue<std::pair<float, hnswlib::labeltype>> result;
 
           try {
-            result = hnsw_index_->searchKnn(norm_array.data(), topk, hnsw_filter.get());
+            result = SearchKnn(norm_array.data(), topk, hnsw_filter.get());
           } catch (std::runtime_error& e) {
             std::string s = fmt::format("parallel search vector failed, error: {}", e.what());
             LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
@@ -484,12 +529,116 @@ butil::Status VectorIndexHnsw::Search(const std::vector<pb::common::VectorWithId
   return butil::Status::OK();
 }
 
-butil::Status VectorIndexHnsw::RangeSearch(const std::vector<pb::common::VectorWithId>& /*vector_with_ids*/,
-                                           float /*radius*/,
-                                           const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& /*filters*/,
-                                           bool /*reconstruct*/, const pb::common::VectorSearchParameter& /*parameter*/,
-                                           std::vector<pb::index::VectorWithDistanceResult>& /*results*/) {
-  return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "RangeSearch not support in Hnsw!!!");
+butil::Status VectorIndexHnsw::RangeSearch(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                           float radius,
+                                           const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
+                                           bool reconstruct, const pb::common::VectorSearchParameter& parameter,
+                                           std::vector<pb::index::VectorWithDistanceResult>& results) {
+  if (vector_with_ids.empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "vector_with_ids is empty");
+  }
+
+  if (vector_index_type != pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW) {
+    return butil::Status(pb::error::Errno::EINTERNAL, "vector index type is not supported");
+  }
+
+  if (parameter.hnsw().efsearch() < 0 || parameter.hnsw().efsearch() > 1024) {
+    std::string s = fmt::format("efsearch is illegal, {}, must between 0 and 1024", parameter.hnsw().efsearch());
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, s);
+  }
+
+  auto status = VectorIndexUtils::CheckVectorDimension(vector_with_ids, dimension_);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // hnsw distance of ip/cosine is 1-ip, same as radius.
+  uint32_t max_topk = std::max(FLAGS_vector_index_max_range_search_result_count, static_cast<int64_t>(1));
+  uint32_t init_topk =
+      std::min(static_cast<uint32_t>(std::max(FLAGS_hnsw_range_search_init_topk, parameter.hnsw().efsearch())),
+               max_topk);
+
+  auto hnsw_filter = filters.empty() ? nullptr : std::make_shared<HnswRangeFilterFunctor>(filters);
+
+  results.resize(vector_with_ids.size());
+  std::vector<butil::Status> statuses(vector_with_ids.size(), butil::Status::OK());
+
+  BvarLatencyGuard bvar_guard(&g_hnsw_range_search_latency);
+  RWLockReadGuard guard(&rw_lock_);
+
+  ParallelFor(
+      thread_pool, Id(), 0, vector_with_ids.size(), FLAGS_vector_read_batch_size_per_task, true, [&](size_t row) {
+        const float* query = vector_with_ids[row].vector().float_values().data();
+        std::vector<float> norm_array;
+        if (normalize_) {
+          norm_array.resize(dimension_);
+          VectorIndexUtils::NormalizeVectorForHnsw(query, dimension_, norm_array.data());
+          query = norm_array.data();
+        }
+
+        // searchKnn use ef = max(ef, topk), so larger topk expand ef too, stop when the farthest result is out of
+        // radius, the rest of graph is farther.
+        std::priority_queue<std::pair<float, hnswlib::labeltype>> result;
+        try {
+          for (uint32_t topk = init_topk;; topk = std::min(topk * 2, max_topk)) {
+            result = SearchKnn(query, topk, hnsw_filter.get());
+            if (result.size() < topk || result.top().first >= radius || topk >= max_topk) {
+              break;
+            }
+          }
+        } catch (std::runtime_error& e) {
+          std::string s = fmt::format("parallel range search vector failed, error: {}", e.what());
+          LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
+          statuses[row] = butil::Status(pb::error::Errno::EINTERNAL, s);
+          return;
+        }
+
+        while (!result.empty() && result.top().first >= radius) {
+          result.pop();
+        }
+
+        // result is max heap, fill from nearest.
+        std::vector<std::pair<float, hnswlib::labeltype>> in_radius;
+        in_radius.reserve(result.size());
+        for (; !result.empty(); result.pop()) {
+          in_radius.push_back(result.top());
+        }
+
+        for (auto it = in_radius.rbegin(); it != in_radius.rend(); ++it) {
+          auto* vector_with_distance = results[row].add_vector_with_distances();
+          vector_with_distance->set_distance(it->first);
+          vector_with_distance->set_metric_type(this->vector_index_parameter.hnsw_parameter().metric_type());
+
+          auto* vector_with_id = vector_with_distance->mutable_vector_with_id();
+          vector_with_id->set_id(it->second);
+          vector_with_id->mutable_vector()->set_dimension(dimension_);
+          vector_with_id->mutable_vector()->set_value_type(::dingodb::pb::common::ValueType::FLOAT);
+
+          // normalized vector is not origin vector, same as search.
+          if (reconstruct && !normalize_) {
+            try {
+              for (auto& value : GetVectorByLabel(it->second)) {
+                vector_with_id->mutable_vector()->add_float_values(value);
+              }
+            } catch (std::exception& e) {
+              std::string s = fmt::format("getDataByLabel failed, label: {}  err: {}", it->second, e.what());
+              LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
+              statuses[row] = butil::Status(pb::error::Errno::EINTERNAL, s);
+              return;
+            }
+          }
+        }
+      });
+
+  for (const auto& status : statuses) {
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+  }
+
+  return butil::Status::OK();
 }
 
 void VectorIndexHnsw::LockWrite() { rw_lock_.LockWrite(); }
@@ -499,17 +648,14 @@ void VectorIndexHnsw::UnlockWrite() { rw_lock_.UnlockWrite(); }
 butil::Status VectorIndexHnsw::ResizeMaxElements(int64_t new_max_elements) {
   RWLockWriteGuard guard(&rw_lock_);
 
-  try {
-    if (vector_index_type == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW) {
-      hnsw_index_->resizeIndex(new_max_elements);
-      return butil::Status::OK();
-    } else {
-      return butil::Status(pb::error::Errno::EINTERNAL, "vector index type is not supported");
-    }
-  } catch (std::runtime_error& e) {
-    std::string s = fmt::format("resize index failed, error: {}", e.what());
-    DINGO_LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
-    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  if (vector_index_type == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW) {
+    // capacity grow by write, so not allocate and copy all at once here.
+    DINGO_LOG(INFO) << fmt::format("[vector_index.hnsw][id({})] resize max element limit, {} -> {} capacity({}).", Id(),
+                                   max_element_limit_, new_max_elements, hnsw_index_->getMaxElements());
+    max_element_limit_ = new_max_elements;
+    return butil::Status::OK();
+  } else {
+    return butil::Status(pb::error::Errno::EINTERNAL, "vector index type is not supported");
   }
 
   return butil::Status::OK();
@@ -519,7 +665,7 @@ butil::Status VectorIndexHnsw::GetMaxElements(int64_t& max_elements) {
   RWLockReadGuard guard(&rw_lock_);
 
   if (vector_index_type == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW) {
-    max_elements = hnsw_index_->getMaxElements();
+    max_elements = max_element_limit_;
     return butil::Status::OK();
   } else {
     return butil::Status(pb::error::Errno::EINTERNAL, "vector index type is not supported");
@@ -533,7 +679,7 @@ bool VectorIndexHnsw::IsExceedsMaxElements(int64_t vector_size) {
     return true;
   }
   RWLockReadGuard guard(&rw_lock_);
-  bool is_exceeds = hnsw_index_->getCurrentElementCount() + vector_size > max_element_limit_;
+  bool is_exceeds = UsedElementCount() + vector_size > max_element_limit_;
   if (is_exceeds) {
     DINGO_LOG(ERROR) << fmt::format(
         "[vector_index.hnsw][id({})] exceeds max elements, current_element_count({}) , delete_element_count({}) , "
@@ -547,6 +693,159 @@ bool VectorIndexHnsw::IsExceedsMaxElements(int64_t vector_size) {
 
 hnswlib::HierarchicalNSW<float>* VectorIndexHnsw::GetHnswIndex() { return this->hnsw_index_; }
 
+bool VectorIndexHnsw::Exist(int64_t id) {
+  RWLockReadGuard guard(&rw_lock_);
+
+  std::unique_lock<std::mutex> lock(hnsw_index_->label_lookup_lock);
+  auto it = hnsw_index_->label_lookup_.find(id);
+  return it != hnsw_index_->label_lookup_.end() && !hnsw_index_->isMarkedDeleted(it->second);
+}
+
+butil::Status VectorIndexHnsw::GetVectors(std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  RWLockReadGuard guard(&rw_lock_);
+
+  std::vector<hnswlib::labeltype> labels;
+  {
+    std::unique_lock<std::mutex> lock(hnsw_index_->label_lookup_lock);
+    labels.reserve(hnsw_index_->label_lookup_.size());
+    for (const auto& [label, internal_id] : hnsw_index_->label_lookup_) {
+      if (!hnsw_index_->isMarkedDeleted(internal_id)) {
+        labels.push_back(label);
+      }
+    }
+  }
+
+  vector_with_ids.reserve(vector_with_ids.size() + labels.size());
+  try {
+    for (auto label : labels) {
+      auto vector = GetVectorByLabel(label);
+
+      pb::common::VectorWithId vector_with_id;
+      vector_with_id.set_id(label);
+      vector_with_id.mutable_vector()->set_dimension(dimension_);
+      vector_with_id.mutable_vector()->set_value_type(pb::common::ValueType::FLOAT);
+      vector_with_id.mutable_vector()->mutable_float_values()->Add(vector.begin(), vector.end());
+      vector_with_ids.push_back(std::move(vector_with_id));
+    }
+  } catch (std::runtime_error& e) {
+    std::string s = fmt::format("get vectors failed, error: {}", e.what());
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  return butil::Status::OK();
+}
+
+void VectorIndexHnsw::AddPoint(const float* vector, int64_t id, bool replace_deleted) {
+  if (quantized_space_ == nullptr) {
+    hnsw_index_->addPoint((void*)vector, id, replace_deleted);  // NOLINT
+    return;
+  }
+
+  std::vector<char> code(quantized_space_->get_data_size());
+  quantized_space_->Encode(vector, code.data());
+  hnsw_index_->addPoint(code.data(), id, replace_deleted);
+}
+
+std::vector<bool> VectorIndexHnsw::PrepareReplaceDeleted(const std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  std::vector<bool> replace_deleted(vector_with_ids.size(), false);
+  if (!hnsw_index_->allow_replace_deleted_ || hnsw_index_->getDeletedCount() == 0) {
+    return replace_deleted;
+  }
+
+  // Caller hold write lock, so label state not change here.
+  // Replace deleted slot with exist label will leave its old slot with same label, so exist label is updated in its
+  // own slot, deleted one is revived first, hnswlib not allow update deleted element when replace is enabled.
+  // Duplicate new label in one batch add in parallel, only first one can replace.
+  std::vector<int64_t> revive_ids;
+  std::unordered_set<int64_t> new_ids;
+  {
+    std::unique_lock<std::mutex> lock(hnsw_index_->label_lookup_lock);
+    for (size_t i = 0; i < vector_with_ids.size(); ++i) {
+      int64_t id = vector_with_ids[i].id();
+      auto it = hnsw_index_->label_lookup_.find(id);
+      if (it == hnsw_index_->label_lookup_.end()) {
+        replace_deleted[i] = new_ids.insert(id).second;
+      } else if (hnsw_index_->isMarkedDeleted(it->second)) {
+        revive_ids.push_back(id);
+      }
+    }
+  }
+
+  for (auto id : revive_ids) {
+    hnsw_index_->unmarkDelete(id);
+  }
+
+  return replace_deleted;
+}
+
+int64_t VectorIndexHnsw::UsedElementCount() {
+  // deleted slot will be reused, not occupy space.
+  if (hnsw_index_->allow_replace_deleted_) {
+    return hnsw_index_->getCurrentElementCount() - hnsw_index_->getDeletedCount();
+  }
+  return hnsw_index_->getCurrentElementCount();
+}
+
+void VectorIndexHnsw::ExpandMaxElements(int64_t batch_count) {
+  int64_t max_elements = hnsw_index_->getMaxElements();
+  int64_t need_max_elements = UsedElementCount() + batch_count * 2;
+  if (need_max_elements <= max_elements) {
+    return;
+  }
+
+  // double for amortized copy, but bounded step for large index, and not far beyond limit which reject write.
+  int64_t new_max_elements = max_elements + std::min(max_elements, FLAGS_hnsw_max_expand_step_elements);
+  new_max_elements =
+      std::min(new_max_elements, static_cast<int64_t>(max_element_limit_) + Constant::kHnswMaxElementsExpandNum);
+  new_max_elements = std::max(new_max_elements, need_max_elements);
+
+  int64_t start_time = Helper::TimestampMs();
+  hnsw_index_->resizeIndex(new_max_elements);
+  g_hnsw_expand_count << 1;
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.hnsw][id({})] expand max element, {} -> {} elapsed_time({}ms).", Id(),
+                                 max_elements, new_max_elements, Helper::TimestampMs() - start_time);
+}
+
+std::priority_queue<std::pair<float, hnswlib::labeltype>> VectorIndexHnsw::SearchKnn(
+    const float* query, uint32_t topk, hnswlib::BaseFilterFunctor* filter) {
+  if (quantized_space_ == nullptr) {
+    return hnsw_index_->searchKnn(query, topk, filter);
+  }
+
+  std::vector<char> code(quantized_space_->get_data_size());
+  quantized_space_->Encode(query, code.data());
+  auto candidates = hnsw_index_->searchKnn(code.data(), topk * FLAGS_hnsw_quantize_rerank_multiple, filter);
+  if (FLAGS_hnsw_quantize_rerank_multiple <= 1) {
+    return candidates;
+  }
+
+  // re-rank candidates by distance between float query and code
+  std::priority_queue<std::pair<float, hnswlib::labeltype>> result;
+  for (; !candidates.empty(); candidates.pop()) {
+    auto label = candidates.top().second;
+    auto candidate_code = hnsw_index_->getDataByLabel<char>(label);
+    result.emplace(quantized_space_->Distance(query, candidate_code.data()), label);
+    if (result.size() > topk) {
+      result.pop();
+    }
+  }
+
+  return result;
+}
+
+std::vector<float> VectorIndexHnsw::GetVectorByLabel(hnswlib::labeltype label) {
+  if (quantized_space_ == nullptr) {
+    return hnsw_index_->getDataByLabel<float>(label);
+  }
+
+  auto code = hnsw_index_->getDataByLabel<char>(label);
+  std::vector<float> vector(dimension_);
+  quantized_space_->Decode(code.data(), vector.data());
+  return vector;
+}
+
 int32_t VectorIndexHnsw::GetDimension() { return this->dimension_; }
 
 pb::common::MetricType VectorIndexHnsw::GetMetricType() {
@@ -586,7 +885,11 @@ bool VectorIndexHnsw::NeedToRebuild() {
     return false;
   }
 
-  return (deleted_count > 0 && deleted_count > element_count / 2);
+  // deleted slot is reused by new vector and graph is repaired in place, not need rebuild until most are deleted.
+  double rebuild_ratio =
+      hnsw_index_->allow_replace_deleted_ ? FLAGS_hnsw_replace_deleted_rebuild_ratio : FLAGS_hnsw_rebuild_deleted_ratio;
+
+  return deleted_count > element_count * rebuild_ratio;
 }
 
 bool VectorIndexHnsw::NeedToSave(int64_t last_save_log_behind) {
@@ -614,7 +917,8 @@ uint32_t VectorIndexHnsw::CalcHnswCountFromMemory(int64_t memory_size_limit, int
   int64_t size_links_level0 = nlinks * 2 + sizeof(int64_t) + sizeof(int64_t);
 
   // int64_t size_data_per_element_ = size_links_level0_ + data_size_ + sizeof(labeltype);
-  int64_t size_data_per_element = size_links_level0 + sizeof(float_t) * dimension + sizeof(int64_t);
+  int64_t data_size = HnswQuantizedSpace::CodeSize(GetHnswQuantizeType(), dimension);
+  int64_t size_data_per_element = size_links_level0 + data_size + sizeof(int64_t);
 
   // int64_t size_link_list_per_element =  sizeof(void*);
   int64_t size_link_list_per_element = sizeof(int64_t);
@@ -17,13 +17,16 @@
 
 #include <cstdint>
 #include <memory>
+#include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "butil/status.h"
 #include "common/synchronization.h"
 #include "hnswlib/hnswlib.h"
 #include "proto/common.pb.h"
+#include "vector/hnsw_quantized_space.h"
 #include "vector/vector_index.h"
 
 namespace dingodb {
@@ -75,6 +78,7 @@ class VectorIndexHnsw : public VectorIndex {
   butil::Status GetDeletedCount(int64_t& deleted_count) override;
   butil::Status GetMemorySize(int64_t& memory_size) override;
 
+  // Only change limit, capacity grow at write.
   butil::Status ResizeMaxElements(int64_t new_max_elements);
   butil::Status GetMaxElements(int64_t& max_elements);
 
@@ -90,12 +94,32 @@ class VectorIndexHnsw : public VectorIndex {
 
   hnswlib::HierarchicalNSW<float>* GetHnswIndex();
 
+  // vector exist and not deleted.
+  bool Exist(int64_t id);
+  // get all not deleted vectors, vector is decoded when quantized.
+  butil::Status GetVectors(std::vector<pb::common::VectorWithId>& vector_with_ids);
+
   // void NormalizeVector(const float* data, float* norm_array) const;
 
  private:
+  // Add vector to hnsw, encode it first when quantized.
+  void AddPoint(const float* vector, int64_t id, bool replace_deleted);
+  // Which vector can reuse slot of deleted vector, revive re-added deleted vector.
+  std::vector<bool> PrepareReplaceDeleted(const std::vector<pb::common::VectorWithId>& vector_with_ids);
+  // Element count occupy space of hnsw.
+  int64_t UsedElementCount();
+  // Grow capacity of hnsw to hold batch, caller hold write lock.
+  void ExpandMaxElements(int64_t batch_count);
+  // Search hnsw, when quantized search more candidates by code and re-rank them by float query.
+  std::priority_queue<std::pair<float, hnswlib::labeltype>> SearchKnn(const float* query, uint32_t topk,
+                                                                      hnswlib::BaseFilterFunctor* filter);
+  std::vector<float> GetVectorByLabel(hnswlib::labeltype label);
+
   // hnsw members
   hnswlib::HierarchicalNSW<float>* hnsw_index_;
   hnswlib::SpaceInterface<float>* hnsw_space_;
+  // Point to hnsw_space_ when vector is stored quantized, else nullptr.
+  HnswQuantizedSpace* quantized_space_;
 
   // Dimension of the elements
   uint32_t dimension_;
@@ -16,8 +16,10 @@
 
 #include <algorithm>
 #include <climits>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <exception>
 #include <future>
 #include <memory>
 #include <string>
@@ -29,6 +31,7 @@
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
 #include "common/constant.h"
+#include "common/gflag_validator.h"
 #include "common/logging.h"
 #include "faiss/Index.h"
 #include "faiss/IndexBinary.h"
@@ -39,16 +42,26 @@
 #include "faiss/MetricType.h"
 #include "faiss/impl/AuxIndexStructures.h"
 #include "faiss/index_io.h"
+#include "faiss/invlists/InvertedLists.h"
+#include "faiss/utils/distances.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "glog/logging.h"
 #include "proto/common.pb.h"
 #include "proto/debug.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
+#include "vector/vector_index_gpu.h"
+#include "vector/vector_index_mmap_reader.h"
 #include "vector/vector_index_utils.h"
 
 namespace dingodb {
 DEFINE_int64(ivf_flat_need_save_count, 10000, "ivf flat need save count");
+DEFINE_bool(enable_ivf_flat_range_search_centroid_bound, true,
+            "l2 ivf flat range search probe exactly the lists which may have vector within radius, ignore nprobe");
+DEFINE_validator(enable_ivf_flat_range_search_centroid_bound, &PassBool);
+
+DECLARE_bool(vector_index_load_use_mmap);
 
 bvar::LatencyRecorder g_ivf_flat_upsert_latency("dingo_ivf_flat_upsert_latency");
 bvar::LatencyRecorder g_ivf_flat_search_latency("dingo_ivf_flat_search_latency");
@@ -57,6 +70,42 @@ bvar::LatencyRecorder g_ivf_flat_delete_latency("dingo_ivf_flat_delete_latency")
 bvar::LatencyRecorder g_ivf_flat_load_latency("dingo_ivf_flat_load_latency");
 bvar::LatencyRecorder g_ivf_flat_train_latency("dingo_ivf_flat_train_latency");
 
+// Vector of list i is nearer to centroid i than to the nearest centroid c0, so its distance to query is at least
+// the distance from query to the bisector of c0 and ci. Lists are probed in centroid order, return the count of
+// lists to probe for all queries, lists after it have bound beyond radius and no vector within radius.
+static int32_t CentroidBoundNprobe(const faiss::IndexIVF* index, int64_t n, const float* queries, float radius) {
+  int64_t nlist = index->nlist;
+  int64_t d = index->d;
+  std::vector<float> centroids(nlist * d);
+  index->quantizer->reconstruct_n(0, nlist, centroids.data());
+
+  // radius of l2 is squared distance
+  float max_bound = std::sqrt(std::max(radius, 0.0F));
+  std::vector<float> distances(nlist);
+  std::vector<faiss::idx_t> labels(nlist);
+  int32_t nprobe = 1;
+  for (int64_t row = 0; row < n; ++row) {
+    index->quantizer->search(1, queries + row * d, nlist, distances.data(), labels.data());
+    if (labels[0] < 0) {
+      continue;
+    }
+
+    const float* nearest_centroid = centroids.data() + labels[0] * d;
+    for (int64_t j = nlist - 1; j >= nprobe; --j) {
+      if (labels[j] < 0) {
+        continue;
+      }
+      float centroid_distance = std::sqrt(faiss::fvec_L2sqr(nearest_centroid, centroids.data() + labels[j] * d, d));
+      if (centroid_distance <= 0 || (distances[j] - distances[0]) / (2 * centroid_distance) < max_bound) {
+        nprobe = j + 1;
+        break;
+      }
+    }
+  }
+
+  return nprobe;
+}
+
 template class VectorIndexIvfFlat<faiss::Index, faiss::IndexIVFFlat>;
 
 template class VectorIndexIvfFlat<faiss::IndexBinary, faiss::IndexBinaryIVF>;
@@ -87,6 +136,12 @@ VectorIndexIvfFlat<T, U>::VectorIndexIvfFlat(int64_t id, const pb::common::Vecto
   normalize_ = (pb::common::MetricType::METRIC_TYPE_COSINE == metric_type_);
 
   train_data_size_ = 0;
+
+  if constexpr (std::is_same<T, faiss::Index>::value) {
+    if (VectorIndexGpuMirror::IsEnabled()) {
+      gpu_mirror_ = std::make_unique<VectorIndexGpuMirror>(id);
+    }
+  }
 }
 
 template <typename T, typename U>
@@ -126,6 +181,10 @@ butil::Status VectorIndexIvfFlat<T, U>::AddOrUpsert(const std::vector<pb::common
     DINGO_LOG(FATAL);
   }
 
+  if (gpu_mirror_ != nullptr) {
+    gpu_mirror_->Invalidate();
+  }
+
   return butil::Status::OK();
 }
 
@@ -182,6 +241,10 @@ butil::Status VectorIndexIvfFlat<T, U>::Delete(const std::vector<int64_t>& delet
       DINGO_LOG(WARNING) << fmt::format("[vector_index.ivf_flat][id({})] remove not found vector id.", Id());
       return butil::Status(pb::error::Errno::EVECTOR_INVALID, "remove not found vector id");
     }
+
+    if (gpu_mirror_ != nullptr) {
+      gpu_mirror_->Invalidate();
+    }
   }
 
   return butil::Status::OK();
@@ -244,9 +307,16 @@ butil::Status VectorIndexIvfFlat<T, U>::Search(const std::vector<pb::common::Vec
       if (!filters.empty()) {
         auto ivf_flat_filter = filters.empty() ? nullptr : std::make_shared<IvfFlatIDSelector>(filters);
         ivf_search_parameters.sel = ivf_flat_filter.get();
-        index_->search(vector_with_ids.size(), vector_values.get(), topk, distances.data(), labels.data(),
-                       &ivf_search_parameters);
-      } else {
+        if (!VectorIndexUtils::AdaptiveIvfSearch(index_.get(), vector_with_ids.size(), vector_values.get(), topk,
+                                                 ivf_search_parameters, distances.data(), labels.data())) {
+          index_->search(vector_with_ids.size(), vector_values.get(), topk, distances.data(), labels.data(),
+                         &ivf_search_parameters);
+        }
+      } else if ((gpu_mirror_ == nullptr ||
+                  !gpu_mirror_->Search(index_.get(), vector_with_ids.size(), vector_values.get(), topk,
+                                       &ivf_search_parameters, distances.data(), labels.data())) &&
+                 !VectorIndexUtils::AdaptiveIvfSearch(index_.get(), vector_with_ids.size(), vector_values.get(),
+                                                      topk, ivf_search_parameters, distances.data(), labels.data())) {
         index_->search(vector_with_ids.size(), vector_values.get(), topk, distances.data(), labels.data(),
                        &ivf_search_parameters);
       }
@@ -330,6 +400,11 @@ butil::Status VectorIndexIvfFlat<T, U>::RangeSearch(
       if constexpr (std::is_same<T, faiss::Index>::value) {
         const auto& vector_values =
             VectorIndexUtils::ExtractVectorValue<float>(vector_with_ids, dimension_, normalize_);
+        if (FLAGS_enable_ivf_flat_range_search_centroid_bound &&
+            metric_type_ == pb::common::MetricType::METRIC_TYPE_L2) {
+          ivf_search_parameters.nprobe =
+              CentroidBoundNprobe(index_.get(), vector_with_ids.size(), vector_values.get(), radius);
+        }
         if (!filters.empty()) {
           auto ivf_flat_filter = filters.empty() ? nullptr : std::make_shared<IvfFlatIDSelector>(filters);
           ivf_search_parameters.sel = ivf_flat_filter.get();
@@ -418,11 +493,21 @@ butil::Status VectorIndexIvfFlat<T, U>::Load(const std::string& path) {
   BvarLatencyGuard bvar_guard(&g_ivf_flat_load_latency);
 
   T* internal_raw_index = nullptr;
+  bool use_mmap = FLAGS_vector_index_load_use_mmap;
+  VectorIndexMmapReader mmap_reader;
+  if (use_mmap) {
+    auto status = mmap_reader.Open(path);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
   try {
     if constexpr (std::is_same<T, faiss::Index>::value) {
-      internal_raw_index = faiss::read_index(path.c_str(), 0);
+      internal_raw_index = use_mmap ? faiss::read_index(&mmap_reader, 0) : faiss::read_index(path.c_str(), 0);
     } else if constexpr (std::is_same<T, faiss::IndexBinary>::value) {
-      internal_raw_index = faiss::read_index_binary(path.c_str(), 0);
+      internal_raw_index =
+          use_mmap ? faiss::read_index_binary(&mmap_reader, 0) : faiss::read_index_binary(path.c_str(), 0);
     } else {
       DINGO_LOG(FATAL);
     }
@@ -499,6 +584,9 @@ butil::Status VectorIndexIvfFlat<T, U>::Load(const std::string& path) {
 
   quantizer_.reset();
   index_ = std::move(internal_index_ivf_flat);
+  if (gpu_mirror_ != nullptr) {
+    gpu_mirror_->Invalidate();
+  }
 
   nlist_ = index_->nlist;
   train_data_size_ = index_->ntotal;
@@ -558,6 +646,9 @@ butil::Status VectorIndexIvfFlat<T, U>::GetMemorySize(int64_t& memory_size) {
   if (std::is_same<T, faiss ::Index>::value) {
     memory_size = count * sizeof(faiss::idx_t) + count * dimension_ * sizeof(faiss::Index::component_t) +
                   nlist_ * dimension_ * sizeof(faiss::Index::component_t);
+    if (gpu_mirror_ != nullptr) {
+      memory_size += gpu_mirror_->MemorySize();
+    }
   } else if (std::is_same<T, faiss::IndexBinary>::value) {
     memory_size = count * sizeof(faiss::idx_t) +
                   count * dimension_ / CHAR_BIT * sizeof(faiss::IndexBinary::component_t) +
@@ -801,6 +892,83 @@ bool VectorIndexIvfFlat<T, U>::NeedToSave(int64_t last_save_log_behind) {
   return false;
 }
 
+template <typename T, typename U>
+butil::Status VectorIndexIvfFlat<T, U>::CopyTo(std::shared_ptr<VectorIndex> target, int64_t begin_vector_id,
+                                               int64_t end_vector_id) {
+  auto target_index = std::dynamic_pointer_cast<VectorIndexIvfFlat<T, U>>(target);
+  if (target_index == nullptr || target_index.get() == this) {
+    return butil::Status(pb::error::Errno::ENOT_SUPPORT, "target vector index type not match");
+  }
+  if (target_index->dimension_ != dimension_ || target_index->metric_type_ != metric_type_) {
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "target vector index parameter not match");
+  }
+
+  using ValueType = std::conditional_t<std::is_same<T, faiss::IndexBinary>::value, uint8_t, float>;
+
+  RWLockReadGuard guard(&rw_lock_);
+  // not trained index has no vector, target train by itself at first add.
+  if (!IsTrainedImpl()) {
+    return butil::Status::OK();
+  }
+
+  RWLockWriteGuard target_guard(&target_index->rw_lock_);
+
+  int64_t count = 0;
+  try {
+    // share centroids, vectors keep in same list of child.
+    target_index->nlist_ = nlist_;
+    target_index->train_data_size_ = train_data_size_;
+    target_index->Init();
+
+    auto* quantizer = index_->quantizer;
+    size_t centroid_size = 0;
+    if constexpr (std::is_same<T, faiss::IndexBinary>::value) {
+      centroid_size = quantizer->code_size;
+    } else {
+      centroid_size = quantizer->d;
+    }
+    std::vector<ValueType> centroids(nlist_ * centroid_size);
+    quantizer->reconstruct_n(0, nlist_, centroids.data());
+    target_index->quantizer_->add(nlist_, centroids.data());
+    target_index->index_->is_trained = true;
+
+    auto* invlists = index_->invlists;
+    auto* target_invlists = target_index->index_->invlists;
+    size_t code_size = invlists->code_size;
+    for (size_t list_no = 0; list_no < nlist_; ++list_no) {
+      size_t list_size = invlists->list_size(list_no);
+      if (list_size == 0) {
+        continue;
+      }
+
+      faiss::InvertedLists::ScopedIds ids(invlists, list_no);
+      faiss::InvertedLists::ScopedCodes codes(invlists, list_no);
+      for (size_t i = 0; i < list_size; ++i) {
+        faiss::idx_t id = ids.get()[i];
+        if (id >= begin_vector_id && id < end_vector_id) {
+          target_invlists->add_entry(list_no, id, codes.get() + i * code_size);
+          ++count;
+        }
+      }
+    }
+    target_index->index_->ntotal = count;
+  } catch (std::exception& e) {
+    std::string s = fmt::format("copy ivf flat index failed, error: {}", e.what());
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.ivf_flat][id({})] {}", Id(), s);
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  if (target_index->gpu_mirror_ != nullptr) {
+    target_index->gpu_mirror_->Invalidate();
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[vector_index.ivf_flat][id({})] copy to index({}) range[{}, {}) nlist({}) count({}/{})", Id(),
+      target_index->Id(), begin_vector_id, end_vector_id, nlist_, count, index_->ntotal);
+
+  return butil::Status::OK();
+}
+
 template <typename T, typename U>
 void VectorIndexIvfFlat<T, U>::Init() {
   if constexpr (std::is_same<T, faiss::Index>::value) {
@@ -834,6 +1002,10 @@ void VectorIndexIvfFlat<T, U>::Init() {
   } else {
     DINGO_LOG(FATAL);
   }
+
+  if (gpu_mirror_ != nullptr) {
+    gpu_mirror_->Invalidate();
+  }
 }
 
 template <typename T, typename U>
@@ -851,6 +1023,9 @@ void VectorIndexIvfFlat<T, U>::Reset() {
   quantizer_->reset();
   index_->reset();
   nlist_ = nlist_org_;
+  if (gpu_mirror_ != nullptr) {
+    gpu_mirror_->Invalidate();
+  }
 }
 
 }  // namespace dingodb
@@ -29,6 +29,7 @@
 #include "faiss/utils/distances.h"
 #include "proto/common.pb.h"
 #include "vector/vector_index.h"
+#include "vector/vector_index_gpu.h"
 
 namespace dingodb {
 
@@ -110,6 +111,8 @@ class VectorIndexIvfFlat : public VectorIndex {
   bool IsTrained() override;
   bool NeedToSave(int64_t last_save_log_behind) override;
 
+  butil::Status CopyTo(std::shared_ptr<VectorIndex> target, int64_t begin_vector_id, int64_t end_vector_id) override;
+
  private:
   void Init();
 
@@ -138,6 +141,9 @@ class VectorIndexIvfFlat : public VectorIndex {
 
   std::unique_ptr<U> index_;
 
+  // only for float index, nullptr when gpu is not enabled.
+  VectorIndexGpuMirrorPtr gpu_mirror_;
+
   // normalize vector
   bool normalize_;
 
@@ -14,20 +14,27 @@
 
 #include "vector/vector_index_manager.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "bthread/bthread.h"
 #include "butil/status.h"
 #include "bvar/latency_recorder.h"
 #include "bvar/reducer.h"
+#include "bvar/status.h"
+#include "common/constant.h"
+#include "common/gflag_validator.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
+#include "config/config_manager.h"
 #include "fmt/core.h"
 #include "glog/logging.h"
 #include "meta/store_meta_manager.h"
@@ -38,6 +45,7 @@
 #include "proto/file_service.pb.h"
 #include "proto/node.pb.h"
 #include "proto/raft.pb.h"
+#include "raft/raft_cmd_codec.h"
 #include "server/server.h"
 #include "vector/codec.h"
 #include "vector/vector_index.h"
@@ -45,6 +53,7 @@
 #include "vector/vector_index_factory.h"
 #include "vector/vector_index_snapshot.h"
 #include "vector/vector_index_snapshot_manager.h"
+#include "vector/vector_index_utils.h"
 
 namespace dingodb {
 
@@ -56,6 +65,41 @@ DEFINE_int32(vector_fast_background_worker_num, 8, "vector index fast background
 DEFINE_int64(vector_fast_build_log_gap, 50, "vector index fast build log gap");
 DEFINE_int64(vector_pull_snapshot_min_log_gap, 66, "vector index pull snapshot min log gap");
 DEFINE_int64(vector_max_background_task_count, 32, "vector index max background task count");
+DEFINE_int64(vector_index_train_sample_max_count, 256 * 1024,
+             "vector index build train with at most this count vectors reservoir sampled from region");
+BRPC_VALIDATE_GFLAG(vector_index_train_sample_max_count, brpc::PositiveInteger);
+DEFINE_bool(enable_vector_index_build_pipeline, true, "vector index build scan next batch when adding current batch");
+DEFINE_validator(enable_vector_index_build_pipeline, &PassBool);
+DEFINE_int64(vector_index_memory_budget_bytes, 0,
+             "memory budget of all vector index on store, evict cold follower vector index when exceed, 0 is "
+             "unlimited");
+BRPC_VALIDATE_GFLAG(vector_index_memory_budget_bytes, brpc::NonNegativeInteger);
+DEFINE_int64(vector_index_evict_min_idle_s, 600, "vector index is evicted only when not searched in this time");
+BRPC_VALIDATE_GFLAG(vector_index_evict_min_idle_s, brpc::NonNegativeInteger);
+DEFINE_bool(enable_async_apply_vector_index, false,
+            "apply raft log to vector index at region ordered queue, not block raft apply thread");
+DEFINE_validator(enable_async_apply_vector_index, &PassBool);
+DEFINE_int32(vector_apply_worker_num, 16, "vector index async apply worker num");
+DEFINE_int64(vector_index_async_apply_wait_timeout_ms, 1000, "search wait async apply of written vector timeout");
+BRPC_VALIDATE_GFLAG(vector_index_async_apply_wait_timeout_ms, brpc::NonNegativeInteger);
+DEFINE_bool(enable_install_vector_index_snapshot_to_followers, false,
+            "leader install saved vector index snapshot to followers which not hold vector index, "
+            "so they catch up from log tail when become leader");
+DEFINE_validator(enable_install_vector_index_snapshot_to_followers, &PassBool);
+DEFINE_bool(enable_vector_bulk_import, false,
+            "large vector batch add only write data, vector index is rebuilt from data when import is idle");
+DEFINE_validator(enable_vector_bulk_import, &PassBool);
+DEFINE_bool(enable_vector_index_split_copy, true,
+            "split vector index by copy vectors of child range from parent index, instead of scan data and train");
+DEFINE_validator(enable_vector_index_split_copy, &PassBool);
+DEFINE_int64(vector_bulk_import_min_count, 10000, "min vector count of batch add treated as bulk import");
+BRPC_VALIDATE_GFLAG(vector_bulk_import_min_count, brpc::PositiveInteger);
+DEFINE_int64(vector_bulk_import_idle_s, 60, "rebuild vector index when no bulk import in this time");
+BRPC_VALIDATE_GFLAG(vector_bulk_import_idle_s, brpc::NonNegativeInteger);
+
+bvar::Adder<int64_t> g_vector_index_evict_count("dingo_vector_index_evict_count");
+bvar::Status<int64_t> g_vector_index_total_memory_size("dingo_vector_index_total_memory_size", 0);
+bvar::LatencyRecorder g_vector_index_async_apply_latency("dingo_vector_index_async_apply_latency");
 
 std::string RebuildVectorIndexTask::Trace() {
   return fmt::format("[vector_index.rebuild][id({}).start_time({}).job_id({})] {}", vector_index_wrapper_->Id(),
@@ -185,6 +229,51 @@ void RebuildVectorIndexTask::Run() {
   }
 }
 
+std::string ApplyVectorIndexTask::Trace() {
+  return fmt::format("[vector_index.apply][id({}).log_id({}).start_time({})]", vector_index_wrapper_->Id(), log_id_,
+                     Helper::FormatMsTime(start_time_));
+}
+
+void ApplyVectorIndexTask::Run() {
+  ON_SCOPE_EXIT([&]() {
+    vector_index_wrapper_->SetAsyncAppliedLogId(log_id_);
+    g_vector_index_async_apply_latency << (Helper::TimestampMs() - start_time_);
+  });
+
+  // same as apply at raft apply thread, not ready index catch up log by load/build.
+  if (!vector_index_wrapper_->IsReady() || log_id_ <= vector_index_wrapper_->ApplyLogId()) {
+    return;
+  }
+
+  try {
+    if (!vector_with_ids_.empty()) {
+      auto status = is_update_ ? vector_index_wrapper_->Upsert(vector_with_ids_)
+                               : vector_index_wrapper_->Add(vector_with_ids_);
+      if (status.ok()) {
+        vector_index_wrapper_->SetApplyLogId(log_id_);
+      } else {
+        DINGO_LOG(WARNING) << fmt::format(
+            "[vector_index.apply][index_id({})] upsert vector failed, log_id({}) count({}) error: {}",
+            vector_index_wrapper_->Id(), log_id_, vector_with_ids_.size(), Helper::PrintStatus(status));
+      }
+    }
+
+    if (!delete_ids_.empty()) {
+      auto status = vector_index_wrapper_->Delete(delete_ids_);
+      if (status.ok()) {
+        vector_index_wrapper_->SetApplyLogId(log_id_);
+      } else if (status.error_code() != pb::error::Errno::EVECTOR_INVALID) {
+        DINGO_LOG(WARNING) << fmt::format(
+            "[vector_index.apply][index_id({})] delete vector failed, log_id({}) count({}) error: {}",
+            vector_index_wrapper_->Id(), log_id_, delete_ids_.size(), Helper::PrintStatus(status));
+      }
+    }
+  } catch (const std::exception& e) {
+    DINGO_LOG(FATAL) << fmt::format("[vector_index.apply][index_id({})] apply vector exception, error: {}",
+                                    vector_index_wrapper_->Id(), e.what());
+  }
+}
+
 std::string SaveVectorIndexTask::Trace() {
   return fmt::format("[vector_index.save][id({}).start_time({})] {}", vector_index_wrapper_->Id(),
                      Helper::FormatMsTime(start_time_), trace_);
@@ -661,6 +750,12 @@ bool VectorIndexManager::Init() {
     return false;
   }
 
+  apply_workers_ = ExecqWorkerSet::New("vector_mgr_apply", FLAGS_vector_apply_worker_num, 0);
+  if (!apply_workers_->Init()) {
+    DINGO_LOG(ERROR) << "Init vector index manager apply worker set failed!";
+    return false;
+  }
+
   VectorIndex::SetSimdHook();
 
   VectorIndexDiskANN::Init();
@@ -675,6 +770,9 @@ void VectorIndexManager::Destroy() {
   if (fast_background_workers_ != nullptr) {
     fast_background_workers_->Destroy();
   }
+  if (apply_workers_ != nullptr) {
+    apply_workers_->Destroy();
+  }
 }
 
 // Build vector index for already exist vector index at bootstrap.
@@ -796,7 +894,7 @@ butil::Status VectorIndexManager::ReplayWalToVectorIndex(VectorIndexPtr vector_i
   auto log_entrys = log_stroage->GetDataEntries(vector_index->Id(), start_log_id, end_log_id);
   for (const auto& log_entry : log_entrys) {
     auto raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
-    CHECK(raft_cmd->ParseFromString(log_entry->out_data));
+    CHECK(RaftCmdCodec::Decode(log_entry->out_data, raft_cmd.get()));
     for (auto& request : *raft_cmd->mutable_requests()) {
       switch (request.cmd_type()) {
         case pb::raft::VECTOR_ADD: {
@@ -860,6 +958,95 @@ butil::Status VectorIndexManager::ReplayWalToVectorIndex(VectorIndexPtr vector_i
   return butil::Status();
 }
 
+// Add vector batch to vector index in background bthread during build, so scanning next batch and adding current
+// batch overlap. Only one batch is adding at a time, so memory is bounded by two batches.
+class VectorIndexBuildPipeline {
+ public:
+  explicit VectorIndexBuildPipeline(VectorIndexPtr vector_index) : vector_index_(vector_index) {}
+  ~VectorIndexBuildPipeline() { Wait(); }
+
+  VectorIndexBuildPipeline(const VectorIndexBuildPipeline&) = delete;
+  VectorIndexBuildPipeline& operator=(const VectorIndexBuildPipeline&) = delete;
+
+  // take vectors, return status of last batch.
+  butil::Status Add(std::vector<pb::common::VectorWithId>& vectors) {
+    auto status = Wait();
+
+    adding_vectors_.swap(vectors);
+    vectors.clear();
+    if (!FLAGS_enable_vector_index_build_pipeline ||
+        bthread_start_background(&tid_, nullptr, VectorIndexBuildPipeline::Run, this) != 0) {
+      tid_ = 0;
+      status_ = vector_index_->AddByParallel(adding_vectors_, false);
+    }
+
+    return status;
+  }
+
+  butil::Status Wait() {
+    if (tid_ != 0) {
+      bthread_join(tid_, nullptr);
+      tid_ = 0;
+    }
+
+    auto status = status_;
+    status_ = butil::Status::OK();
+    return status;
+  }
+
+ private:
+  static void* Run(void* arg) {
+    auto* self = static_cast<VectorIndexBuildPipeline*>(arg);
+    self->status_ = self->vector_index_->AddByParallel(self->adding_vectors_, false);
+    return nullptr;
+  }
+
+  VectorIndexPtr vector_index_;
+  std::vector<pb::common::VectorWithId> adding_vectors_;
+  bthread_t tid_{0};
+  butil::Status status_;
+};
+
+// Source index strictly cover the range of new index only after split, child share parent index and parent own
+// index keep range before split. After merge source not cover and after retrain range is same, so build from data.
+// Vector write of region is applied to source before log is applied, the new index catch up log from the apply
+// log id set before copy, so async apply is excluded.
+butil::Status VectorIndexManager::CopyFromSplitSource(VectorIndexWrapperPtr vector_index_wrapper,
+                                                      VectorIndexPtr vector_index, const std::string& trace) {
+  if (!FLAGS_enable_vector_index_split_copy || FLAGS_enable_async_apply_vector_index) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "not enable split copy");
+  }
+
+  auto source_vector_index = vector_index_wrapper->ShareVectorIndex();
+  if (source_vector_index == nullptr) {
+    source_vector_index = vector_index_wrapper->GetOwnVectorIndex();
+  }
+  if (source_vector_index == nullptr || source_vector_index->VectorIndexType() != vector_index->VectorIndexType()) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "not found same type source index");
+  }
+
+  const auto& source_range = source_vector_index->Range();
+  const auto& range = vector_index->Range();
+  bool is_cover = source_range.start_key() <= range.start_key() && range.end_key() <= source_range.end_key();
+  bool is_same = source_range.start_key() == range.start_key() && source_range.end_key() == range.end_key();
+  if (!is_cover || is_same) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "source index not split");
+  }
+
+  int64_t begin_vector_id = 0, end_vector_id = 0;
+  VectorCodec::DecodeRangeToVectorId(false, range, begin_vector_id, end_vector_id);
+
+  int64_t start_time = Helper::TimestampMs();
+  auto status = source_vector_index->CopyTo(vector_index, begin_vector_id, end_vector_id);
+  DINGO_LOG(INFO) << fmt::format(
+      "[vector_index.build][index_id({})][trace({})] copy from split source index({}) range: {}, elapsed_time: {}ms "
+      "error: {} {}",
+      vector_index->Id(), trace, source_vector_index->Id(), vector_index->RangeString(),
+      Helper::TimestampMs() - start_time, status.error_code(), status.error_str());
+
+  return status;
+}
+
 // Build vector index with original all data.
 VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector_index_wrapper,
                                                     const std::string& trace) {
@@ -907,6 +1094,22 @@ VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector
     }
   }
 
+  auto copy_status = CopyFromSplitSource(vector_index_wrapper, vector_index, trace);
+  if (copy_status.ok()) {
+    return vector_index;
+  } else if (copy_status.error_code() != pb::error::ENOT_SUPPORT) {
+    // maybe partially copied, build with new one.
+    int64_t apply_log_id = vector_index->ApplyLogId();
+    vector_index =
+        VectorIndexFactory::New(vector_index_id, vector_index_wrapper->IndexParameter(), region->Epoch(), range);
+    if (!vector_index) {
+      DINGO_LOG(WARNING) << fmt::format("[vector_index.build][index_id({})][trace({})] New vector index failed.",
+                                        vector_index_id, trace);
+      return nullptr;
+    }
+    vector_index->SetApplyLogId(apply_log_id);
+  }
+
   auto encode_range = mvcc::Codec::EncodeRange(vector_index->Range());
 
   DINGO_LOG(INFO) << fmt::format(
@@ -946,6 +1149,7 @@ VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector
 
   int64_t count = 0;
   int64_t upsert_use_time = 0;
+  VectorIndexBuildPipeline pipeline(vector_index);
   std::vector<pb::common::VectorWithId> vectors;
   vectors.reserve(Constant::kBuildVectorIndexBatchSize);
   for (iter->Seek(encode_range.start_key()); iter->Valid(); iter->Next()) {
@@ -954,8 +1158,8 @@ VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector
     std::string key(iter->Key());
     vector.set_id(VectorCodec::DecodeVectorIdFromEncodeKeyWithTs(key));
 
-    std::string value(mvcc::Codec::UnPackageValue(iter->Value()));
-    CHECK(vector.mutable_vector()->ParseFromString(value)) << "parse vector pb failed.";
+    auto value = mvcc::Codec::UnPackageValue(iter->Value());
+    CHECK(vector.mutable_vector()->ParseFromArray(value.data(), value.size())) << "parse vector pb failed.";
     if (vector.vector().value_type() == pb::common::ValueType::FLOAT) {
       if (vector.vector().float_values_size() <= 0) {
         DINGO_LOG(WARNING) << fmt::format(
@@ -975,11 +1179,17 @@ VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector
       continue;
     }
 
-    vectors.push_back(vector);
+    vectors.push_back(std::move(vector));
     if (++count % Constant::kBuildVectorIndexBatchSize == 0) {
       int64_t upsert_start_time = Helper::TimestampMs();
+      size_t batch_size = vectors.size();
 
-      vector_index->AddByParallel(vectors, false);
+      // wait last batch and start adding this batch.
+      auto status = pipeline.Add(vectors);
+      if (!status.ok()) {
+        DINGO_LOG(WARNING) << fmt::format("[vector_index.build][index_id({})][trace({})] add vector failed, error: {}",
+                                          vector_index_id, trace, status.error_str());
+      }
 
       int32_t this_upsert_time = Helper::TimestampMs() - upsert_start_time;
       upsert_use_time += this_upsert_time;
@@ -987,18 +1197,25 @@ VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector
       DINGO_LOG(INFO) << fmt::format(
           "[vector_index.build][index_id({})][trace({})] Build vector index progress, speed({:.3}ms/pervector) "
           "count({}) elapsed time({}/{}ms)",
-          vector_index_id, trace, static_cast<double>(this_upsert_time) / vectors.size(), count, upsert_use_time,
+          vector_index_id, trace, static_cast<double>(this_upsert_time) / batch_size, count, upsert_use_time,
           Helper::TimestampMs() - start_time);
 
-      vectors.clear();
+      vectors.reserve(Constant::kBuildVectorIndexBatchSize);
       // yield, for other bthread run.
       bthread_yield();
     }
   }
 
-  if (!vectors.empty()) {
+  {
     int64_t upsert_start_time = Helper::TimestampMs();
-    vector_index->AddByParallel(vectors, false);
+    auto status = vectors.empty() ? pipeline.Wait() : pipeline.Add(vectors);
+    if (status.ok()) {
+      status = pipeline.Wait();
+    }
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("[vector_index.build][index_id({})][trace({})] add vector failed, error: {}",
+                                        vector_index_id, trace, status.error_str());
+    }
     upsert_use_time += (Helper::TimestampMs() - upsert_start_time);
   }
 
@@ -1242,6 +1459,11 @@ butil::Status VectorIndexManager::CatchUpLogToVectorIndex(VectorIndexWrapperPtr
   return butil::Status();
 }
 
+static bool IsFollowerHoldVectorIndex() {
+  auto config = ConfigManager::GetInstance().GetRoleConfig();
+  return config == nullptr || config->GetBool("vector.enable_follower_hold_index");
+}
+
 butil::Status VectorIndexManager::SaveVectorIndex(VectorIndexWrapperPtr vector_index_wrapper,
                                                   const std::string& trace) {
   assert(vector_index_wrapper != nullptr);
@@ -1268,6 +1490,20 @@ butil::Status VectorIndexManager::SaveVectorIndex(VectorIndexWrapperPtr vector_i
     vector_index_wrapper->SetSnapshotLogId(snapshot_log_id);
   }
 
+  // Followers not hold vector index only keep raft data and snapshot of leader, load it on demand.
+  if (FLAGS_enable_install_vector_index_snapshot_to_followers && !IsFollowerHoldVectorIndex() &&
+      Server::GetInstance().IsLeader(vector_index_wrapper->Id())) {
+    auto snapshot = vector_index_wrapper->SnapshotSet()->GetLastSnapshot();
+    if (snapshot != nullptr) {
+      status = VectorIndexSnapshotManager::InstallSnapshotToFollowers(snapshot);
+      if (!status.ok()) {
+        DINGO_LOG(WARNING) << fmt::format(
+            "[vector_index.save][index_id({})][trace({})] install vector index snapshot to followers failed, error: {}",
+            vector_index_wrapper->Id(), trace, status.error_str());
+      }
+    }
+  }
+
   // Update vector index status NORMAL
   DINGO_LOG(INFO) << fmt::format(
       "[vector_index.save][index_id({}_v{})][trace({})] Save vector index success, elapsed time({}ms)",
@@ -1311,6 +1547,45 @@ void VectorIndexManager::LaunchSaveVectorIndex(VectorIndexWrapperPtr vector_inde
   }
 }
 
+bool VectorIndexManager::IsAsyncApply(store::RegionPtr region, VectorIndexWrapperPtr vector_index_wrapper,
+                                      int64_t log_id) {
+  if (region->GetStoreEngineType() != pb::common::STORE_ENG_RAFT_STORE || log_id == INT64_MAX) {
+    return false;
+  }
+
+  // keep order with pending async apply after flag is off.
+  return FLAGS_enable_async_apply_vector_index || vector_index_wrapper->IsAsyncApplying();
+}
+
+bool VectorIndexManager::IsBulkImport(store::RegionPtr region, VectorIndexWrapperPtr vector_index_wrapper,
+                                      int64_t vector_count, int64_t log_id) {
+  if (!FLAGS_enable_vector_bulk_import || vector_count < FLAGS_vector_bulk_import_min_count) {
+    return false;
+  }
+  // rebuild and catch up log only for raft store, diskann not build from data.
+  if (region->GetStoreEngineType() != pb::common::STORE_ENG_RAFT_STORE || log_id == INT64_MAX) {
+    return false;
+  }
+
+  return vector_index_wrapper->Type() != pb::common::VectorIndexType::VECTOR_INDEX_TYPE_DISKANN;
+}
+
+void VectorIndexManager::LaunchApplyVectorIndex(VectorIndexWrapperPtr vector_index_wrapper,
+                                                std::vector<pb::common::VectorWithId> vector_with_ids,
+                                                std::vector<int64_t> delete_ids, bool is_update, int64_t log_id) {
+  assert(vector_index_wrapper != nullptr);
+
+  vector_index_wrapper->SetAsyncApplyLogId(log_id);
+  auto task = std::make_shared<ApplyVectorIndexTask>(vector_index_wrapper, std::move(vector_with_ids),
+                                                     std::move(delete_ids), is_update, log_id);
+  if (!Server::GetInstance().GetVectorIndexManager()->ExecuteApplyTask(vector_index_wrapper->Id(), task)) {
+    DINGO_LOG(WARNING) << fmt::format(
+        "[vector_index.launch][index_id({})] Launch apply vector index failed, apply at current thread, log_id({}).",
+        vector_index_wrapper->Id(), log_id);
+    task->Run();
+  }
+}
+
 butil::Status VectorIndexManager::ScrubVectorIndex() {
   auto regions = Server::GetInstance().GetAllAliveRegion();
   if (regions.empty()) {
@@ -1340,6 +1615,17 @@ butil::Status VectorIndexManager::ScrubVectorIndex() {
       continue;
     }
 
+    if (vector_index_wrapper->IsBulkImportPending()) {
+      int64_t idle_time_ms = Helper::TimestampMs() - vector_index_wrapper->LastBulkImportTimeMs();
+      if (vector_index_wrapper->RebuildingNum() == 0 && idle_time_ms >= FLAGS_vector_bulk_import_idle_s * 1000) {
+        DINGO_LOG(INFO) << fmt::format(
+            "[vector_index.scrub][index_id({})] bulk import is idle, do rebuild vector index.", vector_index_id);
+        LaunchRebuildVectorIndex(vector_index_wrapper, 0, false, true, false, "from bulk import");
+      }
+      // not save vector index which miss bulk import vector.
+      continue;
+    }
+
     bool need_rebuild = vector_index_wrapper->NeedToRebuild();
     if (need_rebuild && vector_index_wrapper->RebuildingNum() == 0) {
       DINGO_LOG(INFO) << fmt::format("[vector_index.scrub][index_id({})] need rebuild, do rebuild vector index.",
@@ -1358,9 +1644,102 @@ butil::Status VectorIndexManager::ScrubVectorIndex() {
     }
   }
 
+  EvictColdVectorIndex(regions);
+
   return butil::Status::OK();
 }
 
+void VectorIndexManager::EvictColdVectorIndex(const std::vector<store::RegionPtr>& regions) {
+  struct Candidate {
+    VectorIndexWrapperPtr vector_index_wrapper;
+    int64_t memory_size;
+    int64_t last_access_time_ms;
+  };
+
+  int64_t total_memory_size = 0;
+  std::vector<Candidate> candidates;
+  int64_t now_ms = Helper::TimestampMs();
+  for (const auto& region : regions) {
+    auto vector_index_wrapper = region->VectorIndexWrapper();
+    if (vector_index_wrapper == nullptr || !vector_index_wrapper->IsReady()) {
+      continue;
+    }
+
+    int64_t memory_size = 0;
+    if (!vector_index_wrapper->GetMemorySize(memory_size).ok()) {
+      continue;
+    }
+    total_memory_size += memory_size;
+
+    // leader and mono store must serve, so only follower is evicted, it is loaded again before become leader.
+    if (region->GetStoreEngineType() == pb::common::STORE_ENG_MONO_STORE ||
+        Server::GetInstance().IsLeader(region->Id()) || region->State() != pb::common::NORMAL ||
+        vector_index_wrapper->IsStop() || vector_index_wrapper->IsTempHoldVectorIndex() ||
+        vector_index_wrapper->IsSwitchingVectorIndex() || vector_index_wrapper->PendingTaskNum() > 0) {
+      continue;
+    }
+    int64_t last_access_time_ms = vector_index_wrapper->LastAccessTimeMs();
+    if (now_ms - last_access_time_ms < FLAGS_vector_index_evict_min_idle_s * 1000) {
+      continue;
+    }
+
+    candidates.push_back({vector_index_wrapper, memory_size, last_access_time_ms});
+  }
+
+  g_vector_index_total_memory_size.set_value(total_memory_size);
+  if (FLAGS_vector_index_memory_budget_bytes <= 0 || total_memory_size <= FLAGS_vector_index_memory_budget_bytes) {
+    return;
+  }
+
+  // least recently searched first
+  std::sort(candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs) {
+    return lhs.last_access_time_ms < rhs.last_access_time_ms;
+  });
+
+  for (auto& candidate : candidates) {
+    if (total_memory_size <= FLAGS_vector_index_memory_budget_bytes) {
+      break;
+    }
+
+    auto& vector_index_wrapper = candidate.vector_index_wrapper;
+    // save first, so reload is not rebuild, evict at next scrub.
+    std::string trace;
+    if (vector_index_wrapper->SupportSave() && vector_index_wrapper->NeedToSave(trace)) {
+      LaunchSaveVectorIndex(vector_index_wrapper, fmt::format("evict-{}", trace));
+      continue;
+    }
+
+    vector_index_wrapper->Evict(fmt::format("memory budget {}/{}", total_memory_size,
+                                            FLAGS_vector_index_memory_budget_bytes));
+    total_memory_size -= candidate.memory_size;
+    g_vector_index_evict_count << 1;
+  }
+}
+
+// faiss kmeans use at most max_points_per_centroid points per centroid, ivf_pq degenerate to flat when train data
+// is less than it, so sample must cover it.
+static int64_t TrainSampleMaxCount(VectorIndexPtr vector_index) {
+  const int64_t kMaxPointsPerCentroid = 256;
+
+  int64_t max_count = FLAGS_vector_index_train_sample_max_count;
+  auto parameter = vector_index->VectorIndexParameter();
+  if (parameter.has_ivf_pq_parameter()) {
+    const auto& ivf_pq_parameter = parameter.ivf_pq_parameter();
+    int64_t nlist = ivf_pq_parameter.ncentroids() > 0 ? ivf_pq_parameter.ncentroids()
+                                                      : Constant::kCreateIvfPqParamNcentroids;
+    int64_t nbits = (ivf_pq_parameter.nbits_per_idx() % 64) > 0 ? (ivf_pq_parameter.nbits_per_idx() % 64)
+                                                                : Constant::kCreateIvfPqParamNbitsPerIdx;
+    max_count = std::max(max_count, kMaxPointsPerCentroid * nlist);
+    max_count = std::max(max_count, kMaxPointsPerCentroid * (static_cast<int64_t>(1) << std::min(nbits, static_cast<int64_t>(24))));
+  } else if (parameter.has_ivf_flat_parameter()) {
+    int64_t nlist = parameter.ivf_flat_parameter().ncentroids() > 0 ? parameter.ivf_flat_parameter().ncentroids()
+                                                                    : Constant::kCreateIvfFlatParamNcentroids;
+    max_count = std::max(max_count, kMaxPointsPerCentroid * nlist);
+  }
+
+  return max_count;
+}
+
 // range is encode range
 butil::Status VectorIndexManager::TrainForBuild(VectorIndexPtr vector_index, mvcc::ReaderPtr reader,
                                                 const pb::common::Range& encode_range) {
@@ -1369,13 +1748,14 @@ butil::Status VectorIndexManager::TrainForBuild(VectorIndexPtr vector_index, mvc
   auto iter = reader->NewIterator(Constant::kVectorDataCF, 0, options);
   CHECK(iter != nullptr) << fmt::format("[vector_index.build][index_id({})] NewIterator failed.", vector_index->Id());
 
-  std::vector<float> train_vectors;
-  train_vectors.reserve(100000 * vector_index->GetDimension());  // todo opt
+  // kmeans only use limit sample of train data, so not keep whole region in memory.
+  int32_t dimension = vector_index->GetDimension();
+  VectorReservoirSampler sampler(TrainSampleMaxCount(vector_index), dimension, vector_index->Id());
   for (iter->Seek(encode_range.start_key()); iter->Valid(); iter->Next()) {
     pb::common::VectorWithId vector;
 
-    std::string value(mvcc::Codec::UnPackageValue(iter->Value()));
-    CHECK(vector.mutable_vector()->ParseFromString(value)) << "parse vector pb failed.";
+    auto value = mvcc::Codec::UnPackageValue(iter->Value());
+    CHECK(vector.mutable_vector()->ParseFromArray(value.data(), value.size())) << "parse vector pb failed.";
 
     if (vector.vector().value_type() == pb::common::ValueType::FLOAT) {
       if (vector.vector().float_values_size() <= 0) {
@@ -1395,10 +1775,15 @@ butil::Status VectorIndexManager::TrainForBuild(VectorIndexPtr vector_index, mvc
       continue;
     }
 
-    train_vectors.insert(train_vectors.end(), vector.vector().float_values().begin(),
-                         vector.vector().float_values().end());
+    if (vector.vector().float_values_size() == dimension) {
+      sampler.Add(vector.vector().float_values().data());
+    }
   }
 
+  DINGO_LOG(INFO) << fmt::format("[vector_index.build][index_id({})] train sample count({}/{}).", vector_index->Id(),
+                                 sampler.SampleCount(), sampler.SeenCount());
+
+  auto& train_vectors = sampler.Samples();
   if (!train_vectors.empty()) {
     auto status = vector_index->TrainByParallel(train_vectors);
     if (!status.ok()) {
@@ -1427,6 +1812,14 @@ bool VectorIndexManager::ExecuteTaskFast(int64_t region_id, TaskRunnablePtr task
   return fast_background_workers_->ExecuteHashByRegionId(region_id, task);
 }
 
+bool VectorIndexManager::ExecuteApplyTask(int64_t region_id, TaskRunnablePtr task) {
+  if (apply_workers_ == nullptr) {
+    return false;
+  }
+
+  return apply_workers_->ExecuteHashByRegionId(region_id, task);
+}
+
 bool VectorIndexManager::ExecuteTask(int64_t region_id, TaskRunnablePtr task, bool is_fast_task) {
   if (is_fast_task) {
     return Server::GetInstance().GetVectorIndexManager()->ExecuteTaskFast(region_id, task);
@@ -19,6 +19,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "butil/status.h"
@@ -141,6 +142,37 @@ class BuildVectorIndexTask : public TaskRunnable {
   int64_t start_time_;
 };
 
+// Apply vector write of one raft log to vector index, decoupled from raft apply thread.
+// Task of same region run in order at one worker, so it is same order as raft log.
+class ApplyVectorIndexTask : public TaskRunnable {
+ public:
+  ApplyVectorIndexTask(VectorIndexWrapperPtr vector_index_wrapper,
+                       std::vector<pb::common::VectorWithId> vector_with_ids, std::vector<int64_t> delete_ids,
+                       bool is_update, int64_t log_id)
+      : vector_index_wrapper_(vector_index_wrapper),
+        vector_with_ids_(std::move(vector_with_ids)),
+        delete_ids_(std::move(delete_ids)),
+        is_update_(is_update),
+        log_id_(log_id) {
+    start_time_ = Helper::TimestampMs();
+  }
+  ~ApplyVectorIndexTask() override = default;
+
+  std::string Type() override { return "APPLY_VECTOR_INDEX"; }
+
+  void Run() override;
+
+  std::string Trace() override;
+
+ private:
+  VectorIndexWrapperPtr vector_index_wrapper_;
+  std::vector<pb::common::VectorWithId> vector_with_ids_;
+  std::vector<int64_t> delete_ids_;
+  bool is_update_;
+  int64_t log_id_;
+  int64_t start_time_;
+};
+
 // Manage vector index, e.g. build/rebuild/save/load vector index.
 class VectorIndexManager {
  public:
@@ -172,7 +204,19 @@ class VectorIndexManager {
   static void LaunchBuildVectorIndex(VectorIndexWrapperPtr vector_index_wrapper, bool is_temp_hold_vector_index,
                                      bool is_fast_build, int64_t job_id, const std::string& trace);
 
+  // Launch apply vector write at region ordered async apply queue, run at current thread if launch failed.
+  static void LaunchApplyVectorIndex(VectorIndexWrapperPtr vector_index_wrapper,
+                                     std::vector<pb::common::VectorWithId> vector_with_ids,
+                                     std::vector<int64_t> delete_ids, bool is_update, int64_t log_id);
+  // raft log of index region should apply to vector index asynchronously.
+  static bool IsAsyncApply(store::RegionPtr region, VectorIndexWrapperPtr vector_index_wrapper, int64_t log_id);
+  // large vector batch add of raft log is bulk import, vector index is rebuilt after import instead of insert.
+  static bool IsBulkImport(store::RegionPtr region, VectorIndexWrapperPtr vector_index_wrapper, int64_t vector_count,
+                           int64_t log_id);
+
   static butil::Status ScrubVectorIndex();
+  // evict least recently searched follower vector index when exceed memory budget.
+  static void EvictColdVectorIndex(const std::vector<store::RegionPtr>& regions);
 
   static bvar::Adder<uint64_t> bvar_vector_index_task_running_num;
   static bvar::Adder<uint64_t> bvar_vector_index_rebuild_task_running_num;
@@ -241,6 +285,7 @@ class VectorIndexManager {
 
   bool ExecuteTask(int64_t region_id, TaskRunnablePtr task);
   bool ExecuteTaskFast(int64_t region_id, TaskRunnablePtr task);
+  bool ExecuteApplyTask(int64_t region_id, TaskRunnablePtr task);
 
   static bool ExecuteTask(int64_t region_id, TaskRunnablePtr task, bool is_fast_task);
 
@@ -264,10 +309,16 @@ class VectorIndexManager {
   static butil::Status TrainForBuild(std::shared_ptr<VectorIndex> vector_index, mvcc::ReaderPtr reader,
                                      const pb::common::Range& encode_range);
 
+  // Copy vectors from index before split instead of scan data and train, ENOT_SUPPORT means not copied.
+  static butil::Status CopyFromSplitSource(VectorIndexWrapperPtr vector_index_wrapper,
+                                           std::shared_ptr<VectorIndex> vector_index, const std::string& trace);
+
  private:
   // Execute all vector index load/build/rebuild/save task.
   WorkerSetPtr background_workers_;
   WorkerSetPtr fast_background_workers_;
+  // Execute vector index apply task of raft log.
+  WorkerSetPtr apply_workers_;
 };
 
 using VectorIndexManagerPtr = std::shared_ptr<VectorIndexManager>;
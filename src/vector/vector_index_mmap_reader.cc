@@ -0,0 +1,138 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_index_mmap_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "brpc/reloadable_flags.h"
+#include "butil/status.h"
+#include "common/gflag_validator.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(vector_index_load_use_mmap, true, "load saved vector index file through mmap");
+DEFINE_validator(vector_index_load_use_mmap, &PassBool);
+DEFINE_int64(vector_index_mmap_release_bytes, 64 * 1024 * 1024,
+             "release consumed pages of mapped vector index file every such bytes, 0 means not release");
+BRPC_VALIDATE_GFLAG(vector_index_mmap_release_bytes, brpc::NonNegativeInteger);
+
+VectorIndexMmapReader::~VectorIndexMmapReader() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+butil::Status VectorIndexMmapReader::Open(const std::string& path) {
+  fd_ = open(path.c_str(), O_RDONLY);
+  if (fd_ < 0) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("open file {} failed, error: {}", path, strerror(errno)));
+  }
+
+  struct stat file_stat;
+  if (fstat(fd_, &file_stat) != 0) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("stat file {} failed, error: {}", path, strerror(errno)));
+  }
+
+  size_ = file_stat.st_size;
+  offset_ = 0;
+  released_offset_ = 0;
+  name = path;
+  if (size_ == 0) {
+    return butil::Status::OK();
+  }
+
+  void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+  if (data == MAP_FAILED) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("mmap file {} failed, error: {}", path, strerror(errno)));
+  }
+  data_ = static_cast<char*>(data);
+
+  // index file is read once from begin to end.
+  if (madvise(data_, size_, MADV_SEQUENTIAL) != 0 || madvise(data_, size_, MADV_WILLNEED) != 0) {
+    DINGO_LOG(WARNING) << fmt::format("[vector_index.mmap] madvise file {} failed, error: {}", path, strerror(errno));
+  }
+
+  return butil::Status::OK();
+}
+
+size_t VectorIndexMmapReader::operator()(void* ptr, size_t size, size_t nitems) {
+  if (size == 0 || offset_ >= size_) {
+    return 0;
+  }
+
+  // same as fread, only read whole items.
+  size_t count = std::min(nitems, (size_ - offset_) / size);
+  memcpy(ptr, data_ + offset_, count * size);
+  offset_ += count * size;
+
+  ReleaseConsumed();
+
+  return count;
+}
+
+void VectorIndexMmapReader::ReleaseConsumed() {
+  if (FLAGS_vector_index_mmap_release_bytes <= 0 ||
+      offset_ - released_offset_ < static_cast<size_t>(FLAGS_vector_index_mmap_release_bytes)) {
+    return;
+  }
+
+  static const size_t kPageSize = sysconf(_SC_PAGESIZE);
+  size_t release_end = offset_ / kPageSize * kPageSize;
+  if (release_end <= released_offset_) {
+    return;
+  }
+
+  // pages are clean file pages, drop them just reduce rss.
+  madvise(data_ + released_offset_, release_end - released_offset_, MADV_DONTNEED);
+  released_offset_ = release_end;
+}
+
+void VectorIndexMmapReader::PrefetchFile(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    DINGO_LOG(WARNING) << fmt::format("[vector_index.mmap] open file {} failed, error: {}", path, strerror(errno));
+    return;
+  }
+
+  // async read ahead, return immediately.
+  int ret = posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  if (ret == 0) {
+    ret = posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+  }
+  if (ret != 0) {
+    DINGO_LOG(WARNING) << fmt::format("[vector_index.mmap] fadvise file {} failed, error: {}", path, strerror(ret));
+  }
+
+  close(fd);
+}
+
+}  // namespace dingodb
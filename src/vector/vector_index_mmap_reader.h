@@ -0,0 +1,62 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_INDEX_MMAP_READER_H_
+#define DINGODB_VECTOR_INDEX_MMAP_READER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "butil/status.h"
+#include "faiss/impl/io.h"
+
+namespace dingodb {
+
+// Read saved vector index file through mmap, use by faiss::read_index.
+// Kernel read ahead the file sequentially, and the consumed pages are released during read,
+// so load not copy through stdio buffer and not keep the whole file resident.
+class VectorIndexMmapReader : public faiss::IOReader {
+ public:
+  VectorIndexMmapReader() = default;
+  ~VectorIndexMmapReader() override;
+
+  VectorIndexMmapReader(const VectorIndexMmapReader&) = delete;
+  VectorIndexMmapReader& operator=(const VectorIndexMmapReader&) = delete;
+
+  butil::Status Open(const std::string& path);
+
+  size_t operator()(void* ptr, size_t size, size_t nitems) override;
+  int filedescriptor() override { return fd_; }
+
+  size_t Size() const { return size_; }
+  size_t Offset() const { return offset_; }
+
+  // Advise kernel read ahead the whole file into page cache, used by index which load by itself, e.g. hnswlib.
+  static void PrefetchFile(const std::string& path);
+
+ private:
+  void ReleaseConsumed();
+
+  int fd_{-1};
+  char* data_{nullptr};
+  size_t size_{0};
+  size_t offset_{0};
+  // pages before it has been released
+  size_t released_offset_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_INDEX_MMAP_READER_H_
@@ -25,10 +25,14 @@
 #include <utility>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "bthread/mutex.h"
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
+#include "common/gflag_validator.h"
+#include "common/helper.h"
 #include "common/logging.h"
 #include "faiss/Index.h"
 #include "faiss/IndexFlat.h"
@@ -37,15 +41,27 @@
 #include "faiss/impl/IDSelector.h"
 #include "faiss/index_io.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/debug.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
+#include "vector/vector_index_gpu.h"
+#include "vector/vector_index_mmap_reader.h"
 #include "vector/vector_index_utils.h"
 
 namespace dingodb {
 
 DEFINE_int64(ivf_pq_need_save_count, 10000, "ivf pq need save count");
+DEFINE_bool(enable_ivf_pq_fast_scan, true, "ivf pq with 4 bits per idx search on fast scan copy of index");
+DEFINE_validator(enable_ivf_pq_fast_scan, &PassBool);
+DEFINE_int64(ivf_pq_fast_scan_rebuild_interval_s, 10, "min interval of copy changed ivf pq index to fast scan again");
+BRPC_VALIDATE_GFLAG(ivf_pq_fast_scan_rebuild_interval_s, brpc::NonNegativeInteger);
+
+bvar::Adder<int64_t> g_ivf_pq_fast_scan_search_count("dingo_ivf_pq_fast_scan_search_count");
+bvar::Adder<int64_t> g_ivf_pq_fast_scan_rebuild_count("dingo_ivf_pq_fast_scan_rebuild_count");
+
+DECLARE_bool(vector_index_load_use_mmap);
 
 VectorIndexRawIvfPq::VectorIndexRawIvfPq(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
                                          const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
@@ -70,9 +86,19 @@ VectorIndexRawIvfPq::VectorIndexRawIvfPq(int64_t id, const pb::common::VectorInd
 
   train_data_size_ = 0;
   // Delay object creation.
+
+  if (VectorIndexGpuMirror::IsEnabled()) {
+    gpu_mirror_ = std::make_unique<VectorIndexGpuMirror>(id);
+  }
+
+  bthread_mutex_init(&fast_scan_mutex_, nullptr);
 }
 
-VectorIndexRawIvfPq::~VectorIndexRawIvfPq() {}
+VectorIndexRawIvfPq::~VectorIndexRawIvfPq() {
+  // fast scan index use quantizer of index_
+  fast_scan_index_.reset();
+  bthread_mutex_destroy(&fast_scan_mutex_);
+}
 
 butil::Status VectorIndexRawIvfPq::AddOrUpsert(const std::vector<pb::common::VectorWithId>& vector_with_ids,
                                                bool is_upsert) {
@@ -99,6 +125,11 @@ butil::Status VectorIndexRawIvfPq::AddOrUpsert(const std::vector<pb::common::Vec
   }
   index_->add_with_ids(vector_with_ids.size(), vector_values.get(), ids.get());
 
+  if (gpu_mirror_ != nullptr) {
+    gpu_mirror_->Invalidate();
+  }
+  InvalidateFastScan();
+
   return butil::Status::OK();
 }
 
@@ -149,6 +180,11 @@ butil::Status VectorIndexRawIvfPq::Delete(const std::vector<int64_t>& delete_ids
       DINGO_LOG(WARNING) << fmt::format("[vector_index.raw_ivf_pq][id({})] remove not found vector id.", Id());
       return butil::Status(pb::error::Errno::EVECTOR_INVALID, "remove not found vector id");
     }
+
+    if (gpu_mirror_ != nullptr) {
+      gpu_mirror_->Invalidate();
+    }
+    InvalidateFastScan();
   }
 
   return butil::Status::OK();
@@ -194,9 +230,18 @@ butil::Status VectorIndexRawIvfPq::Search(const std::vector<pb::common::VectorWi
     if (!filters.empty()) {
       auto ivf_pq_filter = filters.empty() ? nullptr : std::make_shared<RawIvfPqIDSelector>(filters);
       ivf_search_parameters.sel = ivf_pq_filter.get();
-      index_->search(vector_with_ids.size(), vector_values.get(), topk, distances.data(), labels.data(),
-                     &ivf_search_parameters);
-    } else {
+      if (!VectorIndexUtils::AdaptiveIvfSearch(index_.get(), vector_with_ids.size(), vector_values.get(), topk,
+                                               ivf_search_parameters, distances.data(), labels.data())) {
+        index_->search(vector_with_ids.size(), vector_values.get(), topk, distances.data(), labels.data(),
+                       &ivf_search_parameters);
+      }
+    } else if ((gpu_mirror_ == nullptr ||
+                !gpu_mirror_->Search(index_.get(), vector_with_ids.size(), vector_values.get(), topk,
+                                     &ivf_search_parameters, distances.data(), labels.data())) &&
+               !FastScanSearch(vector_with_ids.size(), vector_values.get(), topk, ivf_search_parameters,
+                               distances.data(), labels.data()) &&
+               !VectorIndexUtils::AdaptiveIvfSearch(index_.get(), vector_with_ids.size(), vector_values.get(), topk,
+                                                    ivf_search_parameters, distances.data(), labels.data())) {
       index_->search(vector_with_ids.size(), vector_values.get(), topk, distances.data(), labels.data(),
                      &ivf_search_parameters);
     }
@@ -309,9 +354,18 @@ butil::Status VectorIndexRawIvfPq::Load(const std::string& path) {
   }
 
   // The outside has been locked. Remove the locking operation here.
+  bool use_mmap = FLAGS_vector_index_load_use_mmap;
+  VectorIndexMmapReader mmap_reader;
+  if (use_mmap) {
+    auto status = mmap_reader.Open(path);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
   faiss::Index* internal_raw_index = nullptr;
   try {
-    internal_raw_index = faiss::read_index(path.c_str(), 0);
+    internal_raw_index = use_mmap ? faiss::read_index(&mmap_reader, 0) : faiss::read_index(path.c_str(), 0);
 
   } catch (std::exception& e) {
     delete internal_raw_index;
@@ -388,8 +442,12 @@ butil::Status VectorIndexRawIvfPq::Load(const std::string& path) {
                          fmt::format("nbits not match: {} {}", internal_index->pq.nbits, nbits_per_idx_));
   }
 
+  InvalidateFastScan();
   quantizer_.reset();
   index_ = std::move(internal_index_ivf_pq);
+  if (gpu_mirror_ != nullptr) {
+    gpu_mirror_->Invalidate();
+  }
 
   train_data_size_ = index_->ntotal;
 
@@ -449,6 +507,17 @@ butil::Status VectorIndexRawIvfPq::GetMemorySize(int64_t& memory_size) {
     memory_size += precomputed_table;
   }
 
+  if (gpu_mirror_ != nullptr) {
+    memory_size += gpu_mirror_->MemorySize();
+  }
+
+  {
+    BAIDU_SCOPED_LOCK(fast_scan_mutex_);
+    if (fast_scan_index_ != nullptr) {
+      memory_size += fast_scan_index_->ntotal * (fast_scan_index_->code_size + sizeof(faiss::idx_t));
+    }
+  }
+
   return butil::Status::OK();
 }
 
@@ -549,6 +618,8 @@ bool VectorIndexRawIvfPq::NeedToSave(int64_t last_save_log_behind) {
 }
 
 void VectorIndexRawIvfPq::Init() {
+  InvalidateFastScan();
+
   if (pb::common::MetricType::METRIC_TYPE_L2 == metric_type_) {
     quantizer_ = std::make_unique<faiss::IndexFlatL2>(dimension_);
     index_ = std::make_unique<faiss::IndexIVFPQ>(quantizer_.get(), dimension_, nlist_, nsubvector_, nbits_per_idx_,
@@ -568,6 +639,10 @@ void VectorIndexRawIvfPq::Init() {
     index_ = std::make_unique<faiss::IndexIVFPQ>(quantizer_.get(), dimension_, nlist_, nsubvector_, nbits_per_idx_,
                                                  faiss::MetricType::METRIC_L2);
   }
+
+  if (gpu_mirror_ != nullptr) {
+    gpu_mirror_->Invalidate();
+  }
 }
 
 bool VectorIndexRawIvfPq::IsTrainedImpl() {
@@ -581,6 +656,63 @@ bool VectorIndexRawIvfPq::IsTrainedImpl() {
 void VectorIndexRawIvfPq::Reset() {
   quantizer_->reset();
   index_->reset();
+  if (gpu_mirror_ != nullptr) {
+    gpu_mirror_->Invalidate();
+  }
+  InvalidateFastScan();
+}
+
+void VectorIndexRawIvfPq::InvalidateFastScan() {
+  BAIDU_SCOPED_LOCK(fast_scan_mutex_);
+  is_fast_scan_stale_ = true;
+  // quantizer may be released with index_
+  fast_scan_index_.reset();
+}
+
+bool VectorIndexRawIvfPq::FastScanSearch(faiss::idx_t n, const float* x, faiss::idx_t k,
+                                         const faiss::IVFSearchParameters& params, float* distances,
+                                         faiss::idx_t* labels) {
+  if (!FLAGS_enable_ivf_pq_fast_scan || index_->pq.nbits != 4) {
+    return false;
+  }
+
+  std::shared_ptr<faiss::IndexIVFPQFastScan> fast_scan_index;
+  {
+    BAIDU_SCOPED_LOCK(fast_scan_mutex_);
+    if (is_fast_scan_stale_) {
+      int64_t now_ms = Helper::TimestampMs();
+      // limit copy rate of frequently changed index, search on index_ meanwhile.
+      if (last_fast_scan_build_time_ms_ > 0 &&
+          now_ms - last_fast_scan_build_time_ms_ < FLAGS_ivf_pq_fast_scan_rebuild_interval_s * 1000) {
+        return false;
+      }
+      last_fast_scan_build_time_ms_ = now_ms;
+
+      try {
+        fast_scan_index_ = std::make_shared<faiss::IndexIVFPQFastScan>(*index_);
+      } catch (std::exception& e) {
+        DINGO_LOG(ERROR) << fmt::format("[vector_index.raw_ivf_pq][id({})] copy to fast scan failed, error: {}",
+                                        Id(), e.what());
+        return false;
+      }
+      is_fast_scan_stale_ = false;
+      g_ivf_pq_fast_scan_rebuild_count << 1;
+    }
+    fast_scan_index = fast_scan_index_;
+  }
+
+  try {
+    faiss::IVFSearchParameters fast_scan_params;
+    fast_scan_params.nprobe = params.nprobe;
+    fast_scan_index->search(n, x, k, distances, labels, &fast_scan_params);
+  } catch (std::exception& e) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.raw_ivf_pq][id({})] fast scan search failed, error: {}", Id(),
+                                    e.what());
+    return false;
+  }
+
+  g_ivf_pq_fast_scan_search_count << 1;
+  return true;
 }
 
 }  // namespace dingodb
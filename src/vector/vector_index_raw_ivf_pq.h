@@ -16,6 +16,7 @@
 #define DINGODB_VECTOR_INDEX_RAW_IVF_PQ_H_
 
 #include <faiss/IndexIVFPQ.h>
+#include <faiss/IndexIVFPQFastScan.h>
 
 #include <cstdint>
 #include <memory>
@@ -29,6 +30,7 @@
 #include "faiss/utils/distances.h"
 #include "proto/common.pb.h"
 #include "vector/vector_index.h"
+#include "vector/vector_index_gpu.h"
 
 namespace dingodb {
 
@@ -118,6 +120,13 @@ class VectorIndexRawIvfPq : public VectorIndex {
 
   butil::Status AddOrUpsert(const std::vector<pb::common::VectorWithId>& vector_with_ids, bool is_upsert);
 
+  // search on fast scan copy of 4 bits pq index, caller hold read lock.
+  // return false if not search on it, caller should search on index_.
+  bool FastScanSearch(faiss::idx_t n, const float* x, faiss::idx_t k, const faiss::IVFSearchParameters& params,
+                      float* distances, faiss::idx_t* labels);
+  // caller hold write lock.
+  void InvalidateFastScan();
+
   // Dimension of the elements
   faiss::idx_t dimension_;
 
@@ -136,6 +145,17 @@ class VectorIndexRawIvfPq : public VectorIndex {
 
   std::unique_ptr<faiss::IndexIVFPQ> index_;
 
+  // nullptr when gpu is not enabled.
+  VectorIndexGpuMirrorPtr gpu_mirror_;
+
+  // Fast scan copy of index_ for search when nbits is 4, it use simd lookup table and is much faster.
+  // index_ is still the source of truth for write, save and load, write make it stale and it is copied
+  // again at a later search, it share quantizer with index_.
+  bthread_mutex_t fast_scan_mutex_;
+  std::shared_ptr<faiss::IndexIVFPQFastScan> fast_scan_index_;
+  bool is_fast_scan_stale_{true};
+  int64_t last_fast_scan_build_time_ms_{0};
+
   // normalize vector
   bool normalize_;
 
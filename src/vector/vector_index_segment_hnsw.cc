@@ -0,0 +1,792 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_index_segment_hnsw.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "brpc/reloadable_flags.h"
+#include "bthread/bthread.h"
+#include "butil/status.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
+#include "common/gflag_validator.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/synchronization.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "vector/vector_index_factory.h"
+#include "vector/vector_index_utils.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_vector_index_hnsw_segment, false,
+            "hnsw index write to flat buffer and build hnsw segment in background, only effect new created index");
+DEFINE_validator(enable_vector_index_hnsw_segment, &PassBool);
+DEFINE_int64(vector_index_segment_buffer_max_count, 10000, "segment hnsw seal buffer when vector count reach this");
+BRPC_VALIDATE_GFLAG(vector_index_segment_buffer_max_count, brpc::PositiveInteger);
+DEFINE_int64(vector_index_segment_max_count, 8, "segment hnsw merge smallest segments when segment count exceed this");
+BRPC_VALIDATE_GFLAG(vector_index_segment_max_count, brpc::PositiveInteger);
+DEFINE_double(vector_index_segment_compact_deleted_ratio, 0.3,
+              "segment hnsw rebuild segment when its deleted ratio exceed this");
+DEFINE_validator(vector_index_segment_compact_deleted_ratio, &PassDouble);
+
+DECLARE_int64(hnsw_need_save_count);
+
+bvar::LatencyRecorder g_segment_hnsw_upsert_latency("dingo_segment_hnsw_upsert_latency");
+bvar::LatencyRecorder g_segment_hnsw_search_latency("dingo_segment_hnsw_search_latency");
+bvar::LatencyRecorder g_segment_hnsw_build_latency("dingo_segment_hnsw_build_latency");
+bvar::Adder<int64_t> g_segment_hnsw_seal_count("dingo_segment_hnsw_seal_count");
+bvar::Adder<int64_t> g_segment_hnsw_merge_count("dingo_segment_hnsw_merge_count");
+
+static const std::string kManifestSegment = "segment";
+static const std::string kManifestBuffer = "buffer";
+
+static int64_t LiveCount(const std::shared_ptr<VectorIndex>& index) {
+  int64_t count = 0, deleted_count = 0;
+  index->GetCount(count);
+  index->GetDeletedCount(deleted_count);
+  return count - deleted_count;
+}
+
+// merge every index result, keep topk smallest distance, same id keep smallest one.
+static void MergeSearchResults(uint32_t topk, std::vector<std::vector<pb::index::VectorWithDistanceResult>>& inputs,
+                               std::vector<pb::index::VectorWithDistanceResult>& results) {
+  VectorTopkMerger merger(topk, true);
+  for (size_t row = 0; row < results.size(); ++row) {
+    for (auto& input : inputs) {
+      merger.Add(input[row]);
+    }
+    merger.Finish(results[row]);
+  }
+}
+
+VectorIndexSegmentHnsw::VectorIndexSegmentHnsw(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
+                                               const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
+                                               ThreadPoolPtr thread_pool)
+    : VectorIndex(id, vector_index_parameter, epoch, range, thread_pool) {
+  dimension_ = vector_index_parameter.hnsw_parameter().dimension();
+  max_element_limit_ = vector_index_parameter.hnsw_parameter().max_elements();
+  buffer_ = NewBuffer();
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[vector_index.segment_hnsw][id({})] create index, max_element_limit={} buffer_max_count={} metric_type={} "
+      "dimension={}",
+      Id(), max_element_limit_, FLAGS_vector_index_segment_buffer_max_count,
+      pb::common::MetricType_Name(vector_index_parameter.hnsw_parameter().metric_type()), dimension_);
+}
+
+VectorIndexSegmentHnsw::~VectorIndexSegmentHnsw() { WaitBackground(); }
+
+VectorIndexSegmentHnsw::BufferPtr VectorIndexSegmentHnsw::NewBuffer() {
+  pb::common::VectorIndexParameter flat_parameter;
+  flat_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT);
+  flat_parameter.mutable_flat_parameter()->set_dimension(dimension_);
+  flat_parameter.mutable_flat_parameter()->set_metric_type(vector_index_parameter.hnsw_parameter().metric_type());
+
+  auto buffer = std::make_shared<Buffer>();
+  buffer->index = VectorIndexFactory::NewFlat(Id(), flat_parameter, epoch, range, thread_pool);
+  CHECK(buffer->index != nullptr) << fmt::format("[vector_index.segment_hnsw][id({})] new flat buffer failed.", Id());
+  return buffer;
+}
+
+std::shared_ptr<VectorIndexHnsw> VectorIndexSegmentHnsw::NewSegmentIndex(int64_t max_elements) {
+  auto segment_parameter = vector_index_parameter;
+  segment_parameter.mutable_hnsw_parameter()->set_max_elements(std::max(max_elements, static_cast<int64_t>(1)));
+
+  // create index may throw exeception
+  try {
+    return std::make_shared<VectorIndexHnsw>(Id(), segment_parameter, epoch, range, thread_pool);
+  } catch (std::exception& e) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.segment_hnsw][id({})] new segment failed, error: {}", Id(),
+                                    e.what());
+    return nullptr;
+  }
+}
+
+std::vector<std::shared_ptr<VectorIndex>> VectorIndexSegmentHnsw::GetIndexes() {
+  RWLockReadGuard guard(&rw_lock_);
+
+  std::vector<std::shared_ptr<VectorIndex>> indexes;
+  indexes.reserve(segments_.size() + 2);
+  indexes.push_back(buffer_->index);
+  if (sealing_buffer_ != nullptr) {
+    indexes.push_back(sealing_buffer_->index);
+  }
+  for (const auto& segment : segments_) {
+    indexes.push_back(segment->index);
+  }
+
+  return indexes;
+}
+
+butil::Status VectorIndexSegmentHnsw::Add(const std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  return Upsert(vector_with_ids, true);
+}
+
+butil::Status VectorIndexSegmentHnsw::Add(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                          bool is_priority) {
+  return Upsert(vector_with_ids, is_priority);
+}
+
+butil::Status VectorIndexSegmentHnsw::Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  return Upsert(vector_with_ids, true);
+}
+
+butil::Status VectorIndexSegmentHnsw::Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                             bool /*is_priority*/) {
+  if (vector_with_ids.empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "vector_with_ids is empty");
+  }
+
+  auto status = VectorIndexUtils::CheckVectorDimension(vector_with_ids, dimension_);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // flat not allow duplicate id in one batch, last one win.
+  std::map<int64_t, const pb::common::VectorWithId*> unique_vector_with_ids;
+  for (const auto& vector_with_id : vector_with_ids) {
+    unique_vector_with_ids[vector_with_id.id()] = &vector_with_id;
+  }
+
+  std::vector<int64_t> ids;
+  std::vector<pb::common::VectorWithId> batch;
+  ids.reserve(unique_vector_with_ids.size());
+  batch.reserve(unique_vector_with_ids.size());
+  for (const auto& [id, vector_with_id] : unique_vector_with_ids) {
+    ids.push_back(id);
+    batch.push_back(*vector_with_id);
+  }
+
+  BvarLatencyGuard bvar_guard(&g_segment_hnsw_upsert_latency);
+  RWLockWriteGuard guard(&rw_lock_);
+
+  // old version maybe in buffer or any segment.
+  status = DeleteExist(ids);
+  if (!status.ok()) {
+    return status;
+  }
+
+  status = buffer_->index->Add(batch);
+  if (!status.ok()) {
+    return status;
+  }
+
+  for (auto& vector_with_id : batch) {
+    int64_t id = vector_with_id.id();
+    buffer_->vector_with_ids[id].Swap(&vector_with_id);
+  }
+
+  if (static_cast<int64_t>(buffer_->vector_with_ids.size()) >= FLAGS_vector_index_segment_buffer_max_count) {
+    ScheduleBackground();
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexSegmentHnsw::Delete(const std::vector<int64_t>& delete_ids) {
+  return Delete(delete_ids, true);
+}
+
+butil::Status VectorIndexSegmentHnsw::Delete(const std::vector<int64_t>& delete_ids, bool /*is_priority*/) {
+  if (delete_ids.empty()) {
+    return butil::Status::OK();
+  }
+
+  RWLockWriteGuard guard(&rw_lock_);
+  return DeleteExist(delete_ids);
+}
+
+butil::Status VectorIndexSegmentHnsw::DeleteExist(const std::vector<int64_t>& delete_ids) {
+  std::vector<int64_t> exist_ids;
+  for (auto id : delete_ids) {
+    if (buffer_->vector_with_ids.erase(id) > 0) {
+      exist_ids.push_back(id);
+    }
+  }
+  auto status = buffer_->index->Delete(exist_ids);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // sealing buffer vectors is building in background, not change them, only delete from its index.
+  if (sealing_buffer_ != nullptr) {
+    exist_ids.clear();
+    for (auto id : delete_ids) {
+      if (sealing_buffer_->vector_with_ids.find(id) != sealing_buffer_->vector_with_ids.end()) {
+        exist_ids.push_back(id);
+      }
+    }
+    status = sealing_buffer_->index->Delete(exist_ids);
+    if (!status.ok()) {
+      return status;
+    }
+    background_deleted_ids_.insert(background_deleted_ids_.end(), exist_ids.begin(), exist_ids.end());
+  }
+
+  for (const auto& segment : segments_) {
+    exist_ids.clear();
+    for (auto id : delete_ids) {
+      if (segment->index->Exist(id)) {
+        exist_ids.push_back(id);
+      }
+    }
+    if (exist_ids.empty()) {
+      continue;
+    }
+
+    status = segment->index->Delete(exist_ids, true);
+    if (!status.ok()) {
+      return status;
+    }
+    if (merging_segment_seqs_.count(segment->seq) > 0) {
+      background_deleted_ids_.insert(background_deleted_ids_.end(), exist_ids.begin(), exist_ids.end());
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+void VectorIndexSegmentHnsw::ScheduleBackground() {
+  if (background_running_) {
+    return;
+  }
+
+  if (background_tid_ != 0) {
+    // last routine is finished or finishing, it not hold lock any more.
+    bthread_join(background_tid_, nullptr);
+    background_tid_ = 0;
+  }
+
+  background_running_ = true;
+  if (bthread_start_background(&background_tid_, nullptr, BackgroundRoutine, this) != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.segment_hnsw][id({})] start background failed.", Id());
+    background_running_ = false;
+    background_tid_ = 0;
+  }
+}
+
+void* VectorIndexSegmentHnsw::BackgroundRoutine(void* arg) {
+  static_cast<VectorIndexSegmentHnsw*>(arg)->RunBackground();
+  return nullptr;
+}
+
+bool VectorIndexSegmentHnsw::PickSealJob() {
+  // last build failed, retry it.
+  if (sealing_buffer_ != nullptr) {
+    return true;
+  }
+  if (static_cast<int64_t>(buffer_->vector_with_ids.size()) < FLAGS_vector_index_segment_buffer_max_count) {
+    return false;
+  }
+
+  // buffer still searchable until segment is built.
+  sealing_buffer_ = buffer_;
+  buffer_ = NewBuffer();
+  return true;
+}
+
+bool VectorIndexSegmentHnsw::PickMergeJob(std::vector<SegmentPtr>& merge_segments) {
+  // rebuild segment with many deleted vectors
+  for (const auto& segment : segments_) {
+    int64_t count = 0, deleted_count = 0;
+    segment->index->GetCount(count);
+    segment->index->GetDeletedCount(deleted_count);
+    if (count > 0 && deleted_count > count * FLAGS_vector_index_segment_compact_deleted_ratio) {
+      merge_segments.push_back(segment);
+      return true;
+    }
+  }
+
+  if (static_cast<int64_t>(segments_.size()) <= FLAGS_vector_index_segment_max_count) {
+    return false;
+  }
+
+  // merge two smallest segments
+  std::vector<std::pair<int64_t, SegmentPtr>> sorted_segments;
+  sorted_segments.reserve(segments_.size());
+  for (const auto& segment : segments_) {
+    sorted_segments.emplace_back(LiveCount(segment->index), segment);
+  }
+  std::sort(sorted_segments.begin(), sorted_segments.end(),
+            [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+  merge_segments.push_back(sorted_segments[0].second);
+  merge_segments.push_back(sorted_segments[1].second);
+  return true;
+}
+
+void VectorIndexSegmentHnsw::RunBackground() {
+  for (;;) {
+    bool is_seal = false;
+    std::vector<SegmentPtr> merge_segments;
+    BufferPtr sealing_buffer;
+    {
+      RWLockWriteGuard guard(&rw_lock_);
+      if (PickSealJob()) {
+        is_seal = true;
+        sealing_buffer = sealing_buffer_;
+      } else if (PickMergeJob(merge_segments)) {
+        for (const auto& segment : merge_segments) {
+          merging_segment_seqs_.insert(segment->seq);
+        }
+      } else {
+        background_running_ = false;
+        return;
+      }
+    }
+
+    // build new segment without lock, write and search go on.
+    int64_t start_time = Helper::TimestampMs();
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    butil::Status status;
+    if (is_seal) {
+      vector_with_ids.reserve(sealing_buffer->vector_with_ids.size());
+      for (const auto& [_, vector_with_id] : sealing_buffer->vector_with_ids) {
+        vector_with_ids.push_back(vector_with_id);
+      }
+    } else {
+      for (const auto& segment : merge_segments) {
+        status = segment->index->GetVectors(vector_with_ids);
+        if (!status.ok()) {
+          break;
+        }
+      }
+    }
+
+    std::shared_ptr<VectorIndexHnsw> new_index;
+    if (status.ok()) {
+      BvarLatencyGuard bvar_guard(&g_segment_hnsw_build_latency);
+      new_index = NewSegmentIndex(vector_with_ids.size());
+      if (new_index == nullptr) {
+        status = butil::Status(pb::error::EINTERNAL, "new segment failed");
+      } else if (!vector_with_ids.empty()) {
+        status = new_index->Upsert(vector_with_ids, false);
+      }
+    }
+
+    RWLockWriteGuard guard(&rw_lock_);
+    if (!status.ok()) {
+      // keep sealing buffer and merging segments as they are, try again next schedule.
+      DINGO_LOG(ERROR) << fmt::format("[vector_index.segment_hnsw][id({})] build segment failed, error: {}", Id(),
+                                      status.error_str());
+      // deleted ids of sealing buffer is kept for retry.
+      if (!is_seal) {
+        merging_segment_seqs_.clear();
+        background_deleted_ids_.clear();
+      }
+      background_running_ = false;
+      return;
+    }
+
+    // deleted during build
+    std::vector<int64_t> deleted_ids;
+    for (auto id : background_deleted_ids_) {
+      if (new_index->Exist(id)) {
+        deleted_ids.push_back(id);
+      }
+    }
+    new_index->Delete(deleted_ids, false);
+    background_deleted_ids_.clear();
+
+    auto new_segment = std::make_shared<Segment>();
+    new_segment->seq = next_segment_seq_++;
+    new_segment->index = new_index;
+    if (is_seal) {
+      segments_.push_back(new_segment);
+      sealing_buffer_ = nullptr;
+      g_segment_hnsw_seal_count << 1;
+    } else {
+      segments_.erase(std::remove_if(segments_.begin(), segments_.end(),
+                                     [this](const SegmentPtr& segment) {
+                                       return merging_segment_seqs_.count(segment->seq) > 0;
+                                     }),
+                      segments_.end());
+      if (LiveCount(new_index) > 0) {
+        segments_.push_back(new_segment);
+      }
+      merging_segment_seqs_.clear();
+      g_segment_hnsw_merge_count << 1;
+    }
+
+    DINGO_LOG(INFO) << fmt::format(
+        "[vector_index.segment_hnsw][id({})] {} segment({}) finish, vector count({}) segment count({}) elapsed "
+        "time({}ms)",
+        Id(), is_seal ? "seal" : "merge", new_segment->seq, vector_with_ids.size(), segments_.size(),
+        Helper::TimestampMs() - start_time);
+  }
+}
+
+void VectorIndexSegmentHnsw::WaitBackground() {
+  for (;;) {
+    bthread_t tid = 0;
+    {
+      RWLockReadGuard guard(&rw_lock_);
+      tid = background_tid_;
+    }
+    if (tid == 0) {
+      return;
+    }
+
+    bthread_join(tid, nullptr);
+
+    RWLockReadGuard guard(&rw_lock_);
+    // no new routine is started during join
+    if (!background_running_ && background_tid_ == tid) {
+      return;
+    }
+  }
+}
+
+int64_t VectorIndexSegmentHnsw::SegmentCount() {
+  RWLockReadGuard guard(&rw_lock_);
+  return segments_.size();
+}
+
+butil::Status VectorIndexSegmentHnsw::Search(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                             uint32_t topk, const std::vector<std::shared_ptr<FilterFunctor>>& filters,
+                                             bool reconstruct, const pb::common::VectorSearchParameter& parameter,
+                                             std::vector<pb::index::VectorWithDistanceResult>& results) {
+  if (vector_with_ids.empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "vector_with_ids is empty");
+  }
+  if (topk == 0) {
+    return butil::Status::OK();
+  }
+
+  auto status = VectorIndexUtils::CheckVectorDimension(vector_with_ids, dimension_);
+  if (!status.ok()) {
+    return status;
+  }
+
+  BvarLatencyGuard bvar_guard(&g_segment_hnsw_search_latency);
+
+  auto indexes = GetIndexes();
+  std::vector<std::vector<pb::index::VectorWithDistanceResult>> index_results(indexes.size());
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    status = indexes[i]->Search(vector_with_ids, topk, filters, reconstruct, parameter, index_results[i]);
+    if (!status.ok()) {
+      return status;
+    }
+    // empty index may return nothing
+    index_results[i].resize(vector_with_ids.size());
+  }
+
+  results.resize(vector_with_ids.size());
+  MergeSearchResults(topk, index_results, results);
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexSegmentHnsw::RangeSearch(
+    const std::vector<pb::common::VectorWithId>& vector_with_ids, float radius,
+    const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters, bool reconstruct,
+    const pb::common::VectorSearchParameter& parameter, std::vector<pb::index::VectorWithDistanceResult>& results) {
+  if (vector_with_ids.empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "vector_with_ids is empty");
+  }
+
+  auto status = VectorIndexUtils::CheckVectorDimension(vector_with_ids, dimension_);
+  if (!status.ok()) {
+    return status;
+  }
+
+  auto indexes = GetIndexes();
+  std::vector<std::vector<pb::index::VectorWithDistanceResult>> index_results(indexes.size());
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    status = indexes[i]->RangeSearch(vector_with_ids, radius, filters, reconstruct, parameter, index_results[i]);
+    if (!status.ok()) {
+      return status;
+    }
+    index_results[i].resize(vector_with_ids.size());
+  }
+
+  results.resize(vector_with_ids.size());
+  MergeSearchResults(UINT32_MAX, index_results, results);
+
+  return butil::Status::OK();
+}
+
+void VectorIndexSegmentHnsw::LockWrite() { rw_lock_.LockWrite(); }
+
+void VectorIndexSegmentHnsw::UnlockWrite() { rw_lock_.UnlockWrite(); }
+
+bool VectorIndexSegmentHnsw::SupportSave() { return true; }
+
+butil::Status VectorIndexSegmentHnsw::SaveBuffer(const std::string& path) {
+  std::ofstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("open file {} failed", path));
+  }
+
+  std::set<int64_t> deleted_ids(background_deleted_ids_.begin(), background_deleted_ids_.end());
+  auto write_func = [&file](const pb::common::VectorWithId& vector_with_id) {
+    std::string data = vector_with_id.SerializeAsString();
+    uint32_t size = data.size();
+    file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    file.write(data.data(), data.size());
+  };
+
+  for (const auto& [_, vector_with_id] : buffer_->vector_with_ids) {
+    write_func(vector_with_id);
+  }
+  // sealing buffer is not built yet, save as buffer.
+  if (sealing_buffer_ != nullptr) {
+    for (const auto& [id, vector_with_id] : sealing_buffer_->vector_with_ids) {
+      if (deleted_ids.count(id) == 0 && buffer_->vector_with_ids.count(id) == 0) {
+        write_func(vector_with_id);
+      }
+    }
+  }
+
+  file.flush();
+  return file.good() ? butil::Status::OK() : butil::Status(pb::error::EINTERNAL, fmt::format("write {} failed", path));
+}
+
+butil::Status VectorIndexSegmentHnsw::LoadBuffer(const std::string& path, BufferPtr buffer) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("open file {} failed", path));
+  }
+
+  std::vector<pb::common::VectorWithId> vector_with_ids;
+  uint32_t size = 0;
+  std::string data;
+  while (file.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+    data.resize(size);
+    if (!file.read(data.data(), size)) {
+      return butil::Status(pb::error::EINTERNAL, fmt::format("read {} failed, file is truncated", path));
+    }
+
+    pb::common::VectorWithId vector_with_id;
+    if (!vector_with_id.ParseFromString(data)) {
+      return butil::Status(pb::error::EINTERNAL, fmt::format("parse {} failed", path));
+    }
+    vector_with_ids.push_back(std::move(vector_with_id));
+  }
+
+  if (!vector_with_ids.empty()) {
+    auto status = buffer->index->Add(vector_with_ids);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+  for (auto& vector_with_id : vector_with_ids) {
+    int64_t id = vector_with_id.id();
+    buffer->vector_with_ids[id].Swap(&vector_with_id);
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexSegmentHnsw::Save(const std::string& path) {
+  if (path.empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "path is empty");
+  }
+
+  // Save need the caller to do LockWrite() and UnlockWrite()
+  std::filesystem::path manifest_path(path);
+  std::string filename = manifest_path.filename().string();
+
+  std::string manifest;
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    std::string segment_filename = fmt::format("{}.segment_{}", filename, i);
+    auto status = segments_[i]->index->Save(Helper::ConcatPath(manifest_path.parent_path().string(), segment_filename));
+    if (!status.ok()) {
+      return status;
+    }
+    manifest += fmt::format("{} {}\n", kManifestSegment, segment_filename);
+  }
+
+  std::string buffer_filename = fmt::format("{}.buffer", filename);
+  auto status = SaveBuffer(Helper::ConcatPath(manifest_path.parent_path().string(), buffer_filename));
+  if (!status.ok()) {
+    return status;
+  }
+  manifest += fmt::format("{} {}\n", kManifestBuffer, buffer_filename);
+
+  // manifest is written last, index is not loadable until all segments are saved.
+  std::ofstream file(path);
+  if (!file.is_open()) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("open file {} failed", path));
+  }
+  file << manifest;
+  file.flush();
+
+  return file.good() ? butil::Status::OK() : butil::Status(pb::error::EINTERNAL, fmt::format("write {} failed", path));
+}
+
+butil::Status VectorIndexSegmentHnsw::Load(const std::string& path) {
+  if (path.empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "path is empty");
+  }
+
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("open file {} failed", path));
+  }
+
+  std::string dir = std::filesystem::path(path).parent_path().string();
+  std::vector<SegmentPtr> segments;
+  auto buffer = NewBuffer();
+  std::string type, filename;
+  while (file >> type >> filename) {
+    std::string filepath = Helper::ConcatPath(dir, filename);
+    if (type == kManifestSegment) {
+      // every segment is loaded independently, max elements is expanded to file count when load.
+      auto segment = std::make_shared<Segment>();
+      segment->index = NewSegmentIndex(1);
+      if (segment->index == nullptr) {
+        return butil::Status(pb::error::EINTERNAL, "new segment failed");
+      }
+      auto status = segment->index->Load(filepath);
+      if (!status.ok()) {
+        return status;
+      }
+      segments.push_back(segment);
+    } else if (type == kManifestBuffer) {
+      auto status = LoadBuffer(filepath, buffer);
+      if (!status.ok()) {
+        return status;
+      }
+    } else {
+      return butil::Status(pb::error::EINTERNAL, fmt::format("unknown manifest type {} in {}", type, path));
+    }
+  }
+
+  WaitBackground();
+
+  RWLockWriteGuard guard(&rw_lock_);
+  for (auto& segment : segments) {
+    segment->seq = next_segment_seq_++;
+  }
+  segments_.swap(segments);
+  buffer_ = buffer;
+  sealing_buffer_ = nullptr;
+  merging_segment_seqs_.clear();
+  background_deleted_ids_.clear();
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.segment_hnsw][id({})] load index, segment count({}) buffer count({})",
+                                 Id(), segments_.size(), buffer_->vector_with_ids.size());
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexSegmentHnsw::ResizeMaxElements(int64_t new_max_elements) {
+  RWLockWriteGuard guard(&rw_lock_);
+  // segment hnsw expand itself, only limit is changed.
+  max_element_limit_ = new_max_elements;
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexSegmentHnsw::GetMaxElements(int64_t& max_elements) {
+  RWLockReadGuard guard(&rw_lock_);
+  max_elements = max_element_limit_;
+  return butil::Status::OK();
+}
+
+int32_t VectorIndexSegmentHnsw::GetDimension() { return dimension_; }
+
+pb::common::MetricType VectorIndexSegmentHnsw::GetMetricType() {
+  return vector_index_parameter.hnsw_parameter().metric_type();
+}
+
+butil::Status VectorIndexSegmentHnsw::GetCount(int64_t& count) {
+  count = 0;
+  for (const auto& index : GetIndexes()) {
+    int64_t index_count = 0;
+    auto status = index->GetCount(index_count);
+    if (!status.ok()) {
+      return status;
+    }
+    count += index_count;
+  }
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexSegmentHnsw::GetDeletedCount(int64_t& deleted_count) {
+  deleted_count = 0;
+  for (const auto& index : GetIndexes()) {
+    int64_t index_deleted_count = 0;
+    auto status = index->GetDeletedCount(index_deleted_count);
+    if (!status.ok()) {
+      return status;
+    }
+    deleted_count += index_deleted_count;
+  }
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexSegmentHnsw::GetMemorySize(int64_t& memory_size) {
+  memory_size = 0;
+  for (const auto& index : GetIndexes()) {
+    int64_t index_memory_size = 0;
+    auto status = index->GetMemorySize(index_memory_size);
+    if (!status.ok()) {
+      return status;
+    }
+    memory_size += index_memory_size;
+  }
+
+  // raw vectors kept by buffer
+  RWLockReadGuard guard(&rw_lock_);
+  int64_t buffer_count = buffer_->vector_with_ids.size();
+  if (sealing_buffer_ != nullptr) {
+    buffer_count += sealing_buffer_->vector_with_ids.size();
+  }
+  memory_size += buffer_count * dimension_ * sizeof(float);
+
+  return butil::Status::OK();
+}
+
+bool VectorIndexSegmentHnsw::IsExceedsMaxElements(int64_t vector_size) {
+  int64_t count = 0, deleted_count = 0;
+  GetCount(count);
+  GetDeletedCount(deleted_count);
+
+  bool is_exceeds = count - deleted_count + vector_size > max_element_limit_;
+  if (is_exceeds) {
+    DINGO_LOG(ERROR) << fmt::format(
+        "[vector_index.segment_hnsw][id({})] exceeds max elements, count({}) deleted_count({}) vector_size({}) "
+        "max_element_limit({}).",
+        Id(), count, deleted_count, vector_size, max_element_limit_);
+  }
+
+  return is_exceeds;
+}
+
+bool VectorIndexSegmentHnsw::NeedToSave(int64_t last_save_log_behind) {
+  int64_t count = 0;
+  GetCount(count);
+  if (count == 0) {
+    return false;
+  }
+
+  return last_save_log_behind > FLAGS_hnsw_need_save_count;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,158 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_INDEX_SEGMENT_HNSW_H_  // NOLINT
+#define DINGODB_VECTOR_INDEX_SEGMENT_HNSW_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "bthread/types.h"
+#include "butil/status.h"
+#include "common/synchronization.h"
+#include "proto/common.pb.h"
+#include "vector/vector_index.h"
+#include "vector/vector_index_hnsw.h"
+
+namespace dingodb {
+
+// Segmented hnsw index for write heavy region.
+// Write append to a small mutable flat buffer, full buffer is sealed and built to an immutable hnsw segment in
+// background, too many small segments and segment with many deleted vectors are merged in background too.
+// Search fan out to buffer and all segments, then merge topk.
+class VectorIndexSegmentHnsw : public VectorIndex {
+ public:
+  explicit VectorIndexSegmentHnsw(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
+                                  const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
+                                  ThreadPoolPtr thread_pool);
+
+  ~VectorIndexSegmentHnsw() override;
+
+  VectorIndexSegmentHnsw(const VectorIndexSegmentHnsw& rhs) = delete;
+  VectorIndexSegmentHnsw& operator=(const VectorIndexSegmentHnsw& rhs) = delete;
+  VectorIndexSegmentHnsw(VectorIndexSegmentHnsw&& rhs) = delete;
+  VectorIndexSegmentHnsw& operator=(VectorIndexSegmentHnsw&& rhs) = delete;
+
+  butil::Status Add(const std::vector<pb::common::VectorWithId>& vector_with_ids) override;
+  butil::Status Add(const std::vector<pb::common::VectorWithId>& vector_with_ids, bool is_priority) override;
+
+  butil::Status Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids) override;
+  butil::Status Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids, bool is_priority) override;
+
+  butil::Status Delete(const std::vector<int64_t>& delete_ids) override;
+  butil::Status Delete(const std::vector<int64_t>& delete_ids, bool is_priority) override;
+
+  // path is manifest file, every segment and buffer is saved to its own file beside it.
+  butil::Status Save(const std::string& path) override;
+  butil::Status Load(const std::string& path) override;
+
+  butil::Status Search(const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                       const std::vector<std::shared_ptr<FilterFunctor>>& filters, bool reconstruct,
+                       const pb::common::VectorSearchParameter& parameter,
+                       std::vector<pb::index::VectorWithDistanceResult>& results) override;
+
+  butil::Status RangeSearch(const std::vector<pb::common::VectorWithId>& vector_with_ids, float radius,
+                            const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters, bool reconstruct,
+                            const pb::common::VectorSearchParameter& parameter,
+                            std::vector<pb::index::VectorWithDistanceResult>& results) override;
+
+  void LockWrite() override;
+  void UnlockWrite() override;
+  bool SupportSave() override;
+
+  butil::Status ResizeMaxElements(int64_t new_max_elements);
+  butil::Status GetMaxElements(int64_t& max_elements);
+
+  int32_t GetDimension() override;
+  pb::common::MetricType GetMetricType() override;
+  butil::Status GetCount(int64_t& count) override;
+  butil::Status GetDeletedCount(int64_t& deleted_count) override;
+  butil::Status GetMemorySize(int64_t& memory_size) override;
+  bool IsExceedsMaxElements(int64_t vector_size) override;
+  butil::Status Train([[maybe_unused]] std::vector<float>& train_datas) override { return butil::Status::OK(); }
+  butil::Status Train([[maybe_unused]] const std::vector<pb::common::VectorWithId>& vectors) override {
+    return butil::Status::OK();
+  }
+
+  // segments compact themselves in background.
+  bool NeedToRebuild() override { return false; }
+  bool NeedToSave(int64_t last_save_log_behind) override;
+
+  int64_t SegmentCount();
+  // wait background seal and merge finish, used by test.
+  void WaitBackground();
+
+ private:
+  // mutable buffer, keep raw vectors for build segment.
+  struct Buffer {
+    std::shared_ptr<VectorIndex> index;
+    std::map<int64_t, pb::common::VectorWithId> vector_with_ids;
+  };
+  using BufferPtr = std::shared_ptr<Buffer>;
+
+  // immutable segment, only delete is allowed.
+  struct Segment {
+    int64_t seq{0};
+    std::shared_ptr<VectorIndexHnsw> index;
+  };
+  using SegmentPtr = std::shared_ptr<Segment>;
+
+  BufferPtr NewBuffer();
+  std::shared_ptr<VectorIndexHnsw> NewSegmentIndex(int64_t max_elements);
+
+  // all searchable indexes.
+  std::vector<std::shared_ptr<VectorIndex>> GetIndexes();
+
+  // delete ids where they exist, caller hold write lock.
+  butil::Status DeleteExist(const std::vector<int64_t>& delete_ids);
+
+  // start background seal and merge if not running, caller hold write lock.
+  void ScheduleBackground();
+  static void* BackgroundRoutine(void* arg);
+  void RunBackground();
+  // pick job, return false when no job, caller hold write lock.
+  bool PickSealJob();
+  bool PickMergeJob(std::vector<SegmentPtr>& merge_segments);
+
+  butil::Status SaveBuffer(const std::string& path);
+  butil::Status LoadBuffer(const std::string& path, BufferPtr buffer);
+
+  // Dimension of the elements
+  uint32_t dimension_;
+
+  int64_t max_element_limit_;
+
+  RWLock rw_lock_;
+
+  BufferPtr buffer_;
+  // sealed buffer which is building to segment in background.
+  BufferPtr sealing_buffer_;
+  std::vector<SegmentPtr> segments_;
+  // segments which are merging in background.
+  std::set<int64_t> merging_segment_seqs_;
+  // deleted from sealing buffer or merging segments during background build, apply to new built segment.
+  std::vector<int64_t> background_deleted_ids_;
+  int64_t next_segment_seq_{0};
+
+  bool background_running_{false};
+  bthread_t background_tid_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_INDEX_SEGMENT_HNSW_H_
@@ -45,6 +45,8 @@ class SnapshotMeta {
   std::string Path() const { return path_; }
   std::string MetaPath();
   std::string IndexDataPath();
+  // crc32c of index data file, not exist in snapshot saved by old version.
+  std::string ChecksumPath();
   std::vector<std::string> ListFileNames();
 
   pb::common::RegionEpoch Epoch() const { return epoch_; }
@@ -14,7 +14,9 @@
 
 #include "vector/vector_index_snapshot_manager.h"
 
+#include <fcntl.h>
 #include <sys/wait.h>  // Add this include
+#include <unistd.h>
 
 #include <algorithm>
 #include <cstdint>
@@ -22,19 +24,30 @@
 #include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "braft/protobuf_file.h"
+#include "brpc/reloadable_flags.h"
+#include "bthread/bthread.h"
+#include "bthread/mutex.h"
 #include "butil/endpoint.h"
 #include "butil/iobuf.h"
+#include "butil/crc32c.h"
 #include "butil/status.h"
 #include "butil/strings/string_split.h"
+#include "bvar/reducer.h"
+#include "common/constant.h"
+#include "common/gflag_validator.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/service_access.h"
+#include "common/synchronization.h"
 #include "config/config_manager.h"
+#include "engine/io_budget.h"
 #include "fmt/core.h"
 #include "log/rocks_log_storage.h"
 #include "proto/common.pb.h"
@@ -49,6 +62,282 @@
 namespace dingodb {
 
 DEFINE_bool(vector_index_snapshot_use_fork, true, "Use fork to save vector index snapshot.");
+DEFINE_bool(vector_index_snapshot_checksum, true, "save crc32c of vector index snapshot file and check it when load");
+DEFINE_validator(vector_index_snapshot_checksum, &PassBool);
+
+DEFINE_int32(vector_index_snapshot_download_concurrency, 4, "max in flight chunk of download vector index snapshot file");
+BRPC_VALIDATE_GFLAG(vector_index_snapshot_download_concurrency, brpc::PositiveInteger);
+DEFINE_int32(vector_index_snapshot_download_retry_times, 3, "retry times of download one vector index snapshot chunk");
+BRPC_VALIDATE_GFLAG(vector_index_snapshot_download_retry_times, brpc::NonNegativeInteger);
+
+bvar::Adder<int64_t> g_vector_index_snapshot_download_bytes("dingo_vector_index_snapshot_download_bytes");
+bvar::Adder<int64_t> g_vector_index_snapshot_download_resume_count("dingo_vector_index_snapshot_download_resume_count");
+bvar::Adder<int64_t> g_vector_index_snapshot_checksum_mismatch_count(
+    "dingo_vector_index_snapshot_checksum_mismatch_count");
+
+// Not use DINGO_LOG, it is called in child process of fork.
+static butil::Status ComputeFileChecksum(const std::string& filepath, uint32_t& checksum) {
+  int fd = open(filepath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return butil::Status(pb::error::EINTERNAL, "open file %s failed, %s", filepath.c_str(), strerror(errno));
+  }
+
+  constexpr size_t kBufferSize = 1024 * 1024;
+  std::vector<char> buffer(kBufferSize);
+  checksum = 0;
+  for (;;) {
+    ssize_t n = read(fd, buffer.data(), buffer.size());
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      close(fd);
+      return butil::Status(pb::error::EINTERNAL, "read file %s failed, %s", filepath.c_str(), strerror(errno));
+    }
+    if (n == 0) {
+      break;
+    }
+    checksum = butil::crc32c::Extend(checksum, buffer.data(), n);
+  }
+
+  close(fd);
+  return butil::Status::OK();
+}
+
+static butil::Status SaveFileChecksum(const std::string& filepath, const std::string& checksum_filepath) {
+  uint32_t checksum = 0;
+  auto status = ComputeFileChecksum(filepath, checksum);
+  if (!status.ok()) {
+    return status;
+  }
+
+  std::ofstream checksum_file(checksum_filepath);
+  if (!checksum_file.is_open()) {
+    return butil::Status(pb::error::EINTERNAL, "open checksum file %s failed", checksum_filepath.c_str());
+  }
+  checksum_file << checksum;
+  checksum_file.close();
+  if (checksum_file.fail()) {
+    return butil::Status(pb::error::EINTERNAL, "write checksum file %s failed", checksum_filepath.c_str());
+  }
+
+  return butil::Status::OK();
+}
+
+static butil::Status CheckFileChecksum(const std::string& filepath, const std::string& checksum_filepath) {
+  std::ifstream checksum_file(checksum_filepath);
+  uint32_t expect_checksum = 0;
+  if (!checksum_file.is_open() || !(checksum_file >> expect_checksum)) {
+    return butil::Status(pb::error::EINTERNAL, "read checksum file %s failed", checksum_filepath.c_str());
+  }
+
+  uint32_t checksum = 0;
+  auto status = ComputeFileChecksum(filepath, checksum);
+  if (!status.ok()) {
+    return status;
+  }
+
+  if (checksum != expect_checksum) {
+    g_vector_index_snapshot_checksum_mismatch_count << 1;
+    return butil::Status(pb::error::EINTERNAL, "checksum not match, expect %u actual %u", expect_checksum, checksum);
+  }
+
+  return butil::Status::OK();
+}
+
+// record downloaded offset of every file, first line is the download source.
+static const std::string kDownloadProgressFilename = "download_progress";
+// file is downloaded completely
+static const int64_t kDownloadFileDone = -1;
+
+static bool LoadDownloadProgress(const std::string& path, const std::string& source,
+                                 std::map<std::string, int64_t>& file_offsets) {
+  std::ifstream file(fmt::format("{}/{}", path, kDownloadProgressFilename));
+  if (!file.is_open()) {
+    return false;
+  }
+
+  std::string line;
+  if (!std::getline(file, line) || line != source) {
+    return false;
+  }
+
+  while (std::getline(file, line)) {
+    auto pos = line.rfind(' ');
+    if (pos == std::string::npos) {
+      return false;
+    }
+    file_offsets[line.substr(0, pos)] = std::strtoll(line.c_str() + pos + 1, nullptr, 10);
+  }
+
+  return true;
+}
+
+static bool SaveDownloadProgress(const std::string& path, const std::string& source,
+                                 const std::map<std::string, int64_t>& file_offsets) {
+  std::string data = source + "\n";
+  for (const auto& [filename, offset] : file_offsets) {
+    data += fmt::format("{} {}\n", filename, offset);
+  }
+
+  return Helper::SaveFile(fmt::format("{}/{}", path, kDownloadProgressFilename), data);
+}
+
+// download path is fixed, so same snapshot can't be downloaded concurrently.
+static bthread_mutex_t* GetDownloadingMutex() {
+  static bthread_mutex_t* mutex = []() {
+    auto* mutex = new bthread_mutex_t;
+    bthread_mutex_init(mutex, nullptr);
+    return mutex;
+  }();
+  return mutex;
+}
+
+static std::set<std::string> downloading_paths;
+
+static bool BeginDownload(const std::string& path) {
+  BAIDU_SCOPED_LOCK(*GetDownloadingMutex());
+  return downloading_paths.insert(path).second;
+}
+
+static void EndDownload(const std::string& path) {
+  BAIDU_SCOPED_LOCK(*GetDownloadingMutex());
+  downloading_paths.erase(path);
+}
+
+// Download one snapshot file by a sliding window of concurrent chunk fetch, every chunk is written at its offset.
+// Only the contiguous downloaded prefix is treated as verified, failed download resume from it.
+class SnapshotFileDownloader {
+ public:
+  SnapshotFileDownloader(const butil::EndPoint& endpoint, int64_t reader_id, const std::string& filename, int fd,
+                         int64_t start_offset)
+      : endpoint_(endpoint), reader_id_(reader_id), filename_(filename), fd_(fd), start_offset_(start_offset) {
+    bthread_mutex_init(&mutex_, nullptr);
+  }
+  ~SnapshotFileDownloader() { bthread_mutex_destroy(&mutex_); }
+
+  butil::Status Run() {
+    std::vector<bthread_t> tids(FLAGS_vector_index_snapshot_download_concurrency, 0);
+    for (auto& tid : tids) {
+      if (bthread_start_background(&tid, nullptr, SnapshotFileDownloader::Worker, this) != 0) {
+        tid = 0;
+        Worker(this);
+      }
+    }
+    for (auto tid : tids) {
+      if (tid != 0) {
+        bthread_join(tid, nullptr);
+      }
+    }
+
+    BAIDU_SCOPED_LOCK(mutex_);
+    if (done_chunk_count_ >= eof_chunk_) {
+      return butil::Status::OK();
+    }
+    return status_.ok() ? butil::Status(pb::error::EINTERNAL, "Download file %s not complete", filename_.c_str())
+                        : status_;
+  }
+
+  // Before this offset is downloaded, except the last chunk every chunk is full.
+  int64_t VerifiedOffset() {
+    BAIDU_SCOPED_LOCK(mutex_);
+    return start_offset_ + done_chunk_count_ * Constant::kFileTransportChunkSize;
+  }
+
+ private:
+  static void* Worker(void* arg) {
+    auto* self = static_cast<SnapshotFileDownloader*>(arg);
+    for (;;) {
+      int64_t chunk = 0;
+      {
+        BAIDU_SCOPED_LOCK(self->mutex_);
+        if (!self->status_.ok() || self->next_chunk_ >= self->eof_chunk_) {
+          break;
+        }
+        chunk = self->next_chunk_++;
+      }
+
+      bool is_eof = false;
+      auto status = self->DownloadChunk(chunk, is_eof);
+
+      BAIDU_SCOPED_LOCK(self->mutex_);
+      if (!status.ok()) {
+        // chunk after eof is not needed
+        if (chunk >= self->eof_chunk_) {
+          break;
+        }
+        if (self->status_.ok()) {
+          self->status_ = status;
+        }
+        break;
+      }
+
+      if (is_eof) {
+        self->eof_chunk_ = std::min(self->eof_chunk_, chunk + 1);
+      }
+      self->done_chunks_.insert(chunk);
+      while (!self->done_chunks_.empty() && *self->done_chunks_.begin() == self->done_chunk_count_) {
+        self->done_chunks_.erase(self->done_chunks_.begin());
+        ++self->done_chunk_count_;
+      }
+    }
+
+    return nullptr;
+  }
+
+  butil::Status DownloadChunk(int64_t chunk, bool& is_eof) {
+    int64_t offset = start_offset_ + chunk * Constant::kFileTransportChunkSize;
+
+    pb::fileservice::GetFileRequest request;
+    request.set_reader_id(reader_id_);
+    request.set_filename(filename_);
+    request.set_offset(offset);
+    request.set_size(Constant::kFileTransportChunkSize);
+
+    for (int retry = 0;; ++retry) {
+      butil::IOBuf buf;
+      auto response = ServiceAccess::GetFile(request, endpoint_, &buf);
+      if (response == nullptr) {
+        if (retry < FLAGS_vector_index_snapshot_download_retry_times) {
+          bthread_usleep(100 * 1000 * (retry + 1));
+          continue;
+        }
+        return butil::Status(pb::error::EINTERNAL, "Get file %s offset %ld failed", filename_.c_str(), offset);
+      }
+
+      int64_t write_offset = offset;
+      while (!buf.empty()) {
+        ssize_t written = buf.pcut_into_file_descriptor(fd_, write_offset);
+        if (written < 0) {
+          return butil::Status(pb::error::EINTERNAL, "Write file %s offset %ld failed, error: %s", filename_.c_str(),
+                               write_offset, strerror(errno));
+        }
+        write_offset += written;
+      }
+
+      g_vector_index_snapshot_download_bytes << (write_offset - offset);
+      // a short chunk is the last one
+      is_eof = response->eof() ||
+               response->read_size() < static_cast<int64_t>(Constant::kFileTransportChunkSize);
+      return butil::Status::OK();
+    }
+  }
+
+  butil::EndPoint endpoint_;
+  int64_t reader_id_;
+  std::string filename_;
+  int fd_;
+  int64_t start_offset_;
+
+  bthread_mutex_t mutex_;
+  butil::Status status_;
+  int64_t next_chunk_{0};
+  // chunk index after the last chunk
+  int64_t eof_chunk_{INT64_MAX};
+  // chunk [0, done_chunk_count_) is downloaded
+  int64_t done_chunk_count_{0};
+  std::set<int64_t> done_chunks_;
+};
 
 // Get all snapshot path, except tmp dir.
 static std::vector<std::string> GetSnapshotPaths(std::string path) {
@@ -153,6 +442,10 @@ std::string VectorIndexSnapshotManager::GetSnapshotNewPath(int64_t vector_index_
   return fmt::format("{}/snapshot_{:020}", GetSnapshotParentPath(vector_index_id), snapshot_log_id);
 }
 
+std::string VectorIndexSnapshotManager::GetSnapshotDownloadPath(int64_t vector_index_id, int64_t snapshot_log_id) {
+  return fmt::format("{}/tmp_download_{:020}", GetSnapshotParentPath(vector_index_id), snapshot_log_id);
+}
+
 butil::Status VectorIndexSnapshotManager::LaunchInstallSnapshot(const butil::EndPoint& endpoint,
                                                                 vector_index::SnapshotMetaPtr snapshot) {
   assert(snapshot != nullptr);
@@ -202,7 +495,16 @@ butil::Status VectorIndexSnapshotManager::HandleInstallSnapshot(const std::strin
   //   return butil::Status(pb::error::EVECTOR_NOT_NEED_SNAPSHOT, "Not need snapshot, follower own vector index.");
   // }
 
-  return DownloadSnapshotFile(uri, meta, snapshot_set);
+  auto status = DownloadSnapshotFile(uri, meta, snapshot_set);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // Keep raft log after snapshot, follower catch up vector index from log tail when load it.
+  auto log_storage = Server::GetInstance().GetRaftLogStorage();
+  log_storage->TruncatePrefix(wal::ClientType::kVectorIndex, meta.vector_index_id(), meta.snapshot_log_index());
+
+  return butil::Status();
 }
 
 butil::Status VectorIndexSnapshotManager::LaunchPullSnapshot(const butil::EndPoint& endpoint,
@@ -416,55 +718,72 @@ butil::Status VectorIndexSnapshotManager::DownloadSnapshotFile(const std::string
         fmt::format("already exist vector index snapshot snapshot_log_index {}", meta.snapshot_log_index()));
   }
 
-  // temp snapshot path for save vector index.
-  std::string tmp_snapshot_path = GetSnapshotTmpPath(meta.vector_index_id());
-  if (std::filesystem::exists(tmp_snapshot_path)) {
-    Helper::RemoveAllFileOrDirectory(tmp_snapshot_path);
+  // download path is fixed by snapshot, resume when the previous download is from same source.
+  std::string tmp_snapshot_path = GetSnapshotDownloadPath(meta.vector_index_id(), meta.snapshot_log_index());
+  if (!BeginDownload(tmp_snapshot_path)) {
+    return butil::Status(pb::error::EINTERNAL, "Vector index snapshot is downloading, path: %s",
+                         tmp_snapshot_path.c_str());
+  }
+  DEFER(EndDownload(tmp_snapshot_path));
+
+  std::string source = fmt::format("{} {}", meta.snapshot_log_index(), Helper::EndPointToString(endpoint));
+  std::map<std::string, int64_t> file_offsets;
+  if (LoadDownloadProgress(tmp_snapshot_path, source, file_offsets)) {
+    g_vector_index_snapshot_download_resume_count << 1;
+    DINGO_LOG(INFO) << fmt::format("[vector_index.snapshot][index({})] resume download vector index snapshot: {}",
+                                   meta.vector_index_id(), tmp_snapshot_path);
   } else {
-    Helper::CreateDirectory(tmp_snapshot_path);
+    file_offsets.clear();
+    if (std::filesystem::exists(tmp_snapshot_path)) {
+      Helper::RemoveAllFileOrDirectory(tmp_snapshot_path);
+    }
+    if (!Helper::CreateDirectory(tmp_snapshot_path)) {
+      return butil::Status(pb::error::EINTERNAL, "Create tmp snapshot path failed, path: %s",
+                           tmp_snapshot_path.c_str());
+    }
   }
 
   for (const auto& filename : meta.filenames()) {
-    int64_t offset = 0;
-    std::ofstream ofile;
+    auto it = file_offsets.find(filename);
+    int64_t offset = it != file_offsets.end() ? it->second : 0;
+    if (offset == kDownloadFileDone) {
+      continue;
+    }
 
     std::string filepath = fmt::format("{}/{}", tmp_snapshot_path, filename);
-    ofile.open(filepath, std::ofstream::out | std::ofstream::binary);
-    DINGO_LOG(INFO) << fmt::format("[vector_index.snapshot][index({})] get vector index snapshot file: {}",
-                                   meta.vector_index_id(), filepath);
-
-    for (;;) {
-      pb::fileservice::GetFileRequest request;
-      request.set_reader_id(reader_id);
-      request.set_filename(filename);
-      request.set_offset(offset);
-      request.set_size(Constant::kFileTransportChunkSize);
-
-      DINGO_LOG(DEBUG) << fmt::format("[vector_index.snapshot][index({})] GetFileRequest: {}", meta.vector_index_id(),
-                                      request.ShortDebugString());
-
-      butil::IOBuf buf;
-      auto response = ServiceAccess::GetFile(request, endpoint, &buf);
-      if (response == nullptr) {
-        return butil::Status(pb::error::EINTERNAL, "Get file failed");
-      }
-
-      DINGO_LOG(DEBUG) << fmt::format("[vector_index.snapshot][index({})] GetFileResponse: {}", meta.vector_index_id(),
-                                      response->ShortDebugString());
+    DINGO_LOG(INFO) << fmt::format("[vector_index.snapshot][index({})] get vector index snapshot file: {} offset: {}",
+                                   meta.vector_index_id(), filepath, offset);
 
-      // Write local file.
-      ofile << buf;
-
-      if (response->eof()) {
-        break;
-      }
+    int fd = open(filepath.c_str(), O_WRONLY | O_CREAT, 0644);
+    if (fd < 0) {
+      return butil::Status(pb::error::EINTERNAL, "Open file %s failed, error: %s", filepath.c_str(), strerror(errno));
+    }
+    // drop not verified data after offset
+    if (ftruncate(fd, offset) != 0) {
+      close(fd);
+      return butil::Status(pb::error::EINTERNAL, "Truncate file %s failed, error: %s", filepath.c_str(),
+                           strerror(errno));
+    }
 
-      offset += response->read_size();
+    SnapshotFileDownloader downloader(endpoint, reader_id, filename, fd, offset);
+    auto status = downloader.Run();
+    if (status.ok() && fsync(fd) != 0) {
+      status = butil::Status(pb::error::EINTERNAL, "Sync file %s failed, error: %s", filepath.c_str(), strerror(errno));
     }
+    close(fd);
 
-    ofile.close();
+    file_offsets[filename] = status.ok() ? kDownloadFileDone : downloader.VerifiedOffset();
+    SaveDownloadProgress(tmp_snapshot_path, source, file_offsets);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format(
+          "[vector_index.snapshot][index({})] download vector index snapshot file {} failed, offset: {} error: {}",
+          meta.vector_index_id(), filepath, file_offsets[filename], status.error_str());
+      return status;
+    }
   }
 
+  Helper::RemoveFileOrDirectory(fmt::format("{}/{}", tmp_snapshot_path, kDownloadProgressFilename));
+
   if (snapshot_set->IsExistSnapshot(meta.snapshot_log_index())) {
     std::string msg =
         fmt::format("[vector_index.snapshot][index({})] already exist vector index snapshot snapshot_log_index {}",
@@ -572,6 +891,8 @@ butil::Status VectorIndexSnapshotManager::SaveVectorIndexSnapshot(VectorIndexWra
   std::string result_filepath =
       fmt::format("{}/index_{}_{}.result", tmp_snapshot_path, vector_index_id, apply_log_index);
   std::string log_filepath = fmt::format("{}/index_{}_{}.log", tmp_snapshot_path, vector_index_id, apply_log_index);
+  std::string checksum_filepath =
+      fmt::format("{}/index_{}_{}.crc", tmp_snapshot_path, vector_index_id, apply_log_index);
   std::string meta_filepath = fmt::format("{}/meta", tmp_snapshot_path);
 
   DINGO_LOG(INFO) << fmt::format("[vector_index.save_snapshot][index_id({})] Save vector index to file {}",
@@ -606,6 +927,9 @@ butil::Status VectorIndexSnapshotManager::SaveVectorIndexSnapshot(VectorIndexWra
     }
 
     auto ret = vector_index->Save(index_filepath);
+    if (ret.ok() && FLAGS_vector_index_snapshot_checksum) {
+      ret = SaveFileChecksum(index_filepath, checksum_filepath);
+    }
     if (!ret.ok()) {
       log_file << fmt::format("[vector_index.child_save_snapshot][index_id({})] Save vector index failed, error: {}.",
                               vector_index_id, ret.error_str())
@@ -789,6 +1113,14 @@ butil::Status VectorIndexSnapshotManager::SaveVectorIndexSnapshot(VectorIndexWra
 
   snapshot_log_index = apply_log_index;
 
+  // index is written by child process, charge io budget after write, it delay next background write.
+  std::error_code ec;
+  auto index_file_size = std::filesystem::file_size(
+      fmt::format("{}/index_{}_{}.idx", new_snapshot_path, vector_index_id, apply_log_index), ec);
+  if (!ec) {
+    IoBudget::GetInstance().Acquire(static_cast<int64_t>(index_file_size));
+  }
+
   DINGO_LOG(INFO) << fmt::format(
       "[vector_index.save_snapshot][index_id({})] Save vector index snapshot snapshot_{:020} elapsed(2) time {}ms",
       vector_index_id, apply_log_index, Helper::TimestampMs() - start_time);
@@ -866,6 +1198,18 @@ VectorIndexPtr VectorIndexSnapshotManager::LoadVectorIndexSnapshot(VectorIndexWr
     return nullptr;
   }
 
+  // snapshot saved by old version has no checksum file.
+  if (FLAGS_vector_index_snapshot_checksum && Helper::IsExistPath(last_snapshot->ChecksumPath())) {
+    status = CheckFileChecksum(last_snapshot->IndexDataPath(), last_snapshot->ChecksumPath());
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format(
+          "[vector_index.load_snapshot][index_id({}).snapshot_log_id({})] load snapshot failed, check index file "
+          "failed, error: {}.",
+          vector_index_id, last_snapshot->SnapshotLogId(), status.error_str());
+      return nullptr;
+    }
+  }
+
   // load index from file
   status = vector_index->Load(last_snapshot->IndexDataPath());
   if (!status.ok()) {
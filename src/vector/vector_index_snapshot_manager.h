@@ -66,6 +66,8 @@ class VectorIndexSnapshotManager {
  private:
   static std::string GetSnapshotTmpPath(int64_t vector_index_id);
   static std::string GetSnapshotNewPath(int64_t vector_index_id, int64_t snapshot_log_id);
+  // fixed tmp path of downloading snapshot, so failed download can resume.
+  static std::string GetSnapshotDownloadPath(int64_t vector_index_id, int64_t snapshot_log_id);
   static butil::Status DownloadSnapshotFile(const std::string& uri, const pb::node::VectorIndexSnapshotMeta& meta,
                                             vector_index::SnapshotMetaSetPtr snapshot_set);
 };
@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <climits>
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <set>
 #include <string>
@@ -24,8 +25,12 @@
 #include <utility>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "butil/status.h"
+#include "bvar/recorder.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
+#include "common/gflag_validator.h"
 #include "common/logging.h"
 #include "coprocessor/utils.h"
 #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
@@ -35,16 +40,33 @@
 #include "faiss/MetricType.h"
 #include "faiss/utils/extra_distances-inl.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "hnswlib/hnswlib.h"
 #include "hnswlib/space_ip.h"
 #include "hnswlib/space_l2.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
+#include "simd/hook.h"
 
 namespace dingodb {
 
 DECLARE_bool(dingo_log_switch_scalar_speed_up_detail);
 
+DEFINE_bool(enable_vector_calc_distance_batch, true, "calc float vector distance by batch simd kernels");
+DEFINE_validator(enable_vector_calc_distance_batch, &PassBool);
+
+DEFINE_bool(enable_vector_index_adaptive_nprobe, false,
+            "ivf search probe lists step by step, stop before nprobe when topk not improve in patience steps");
+DEFINE_validator(enable_vector_index_adaptive_nprobe, &PassBool);
+DEFINE_int32(vector_index_adaptive_nprobe_step, 4, "lists probed per step of adaptive nprobe search");
+BRPC_VALIDATE_GFLAG(vector_index_adaptive_nprobe_step, brpc::PositiveInteger);
+DEFINE_int32(vector_index_adaptive_nprobe_patience, 2, "steps without topk improvement before stop probe");
+BRPC_VALIDATE_GFLAG(vector_index_adaptive_nprobe_patience, brpc::PositiveInteger);
+
+bvar::Adder<int64_t> g_vector_index_adaptive_nprobe_query_count("dingo_vector_index_adaptive_nprobe_query_count");
+// probed lists of per thousand requested nprobe
+bvar::IntRecorder g_vector_index_adaptive_nprobe_probe_permille("dingo_vector_index_adaptive_nprobe_probe_permille");
+
 butil::Status VectorIndexUtils::CalcDistanceEntry(
     const ::dingodb::pb::index::VectorCalcDistanceRequest& request,
     std::vector<std::vector<float>>& distances,                             // NOLINT
@@ -195,6 +217,11 @@ butil::Status VectorIndexUtils::CalcL2DistanceByFaiss(
     std::vector<std::vector<float>>& distances,                          // NOLINT
     std::vector<::dingodb::pb::common::Vector>& result_op_left_vectors,  // NOLINT
     std::vector<::dingodb::pb::common::Vector>& result_op_right_vectors) {
+  if (CalcFloatDistanceByBatch(pb::common::METRIC_TYPE_L2, false, op_left_vectors, op_right_vectors,
+                               is_return_normlize, distances, result_op_left_vectors, result_op_right_vectors)) {
+    return butil::Status();
+  }
+
   return CalcDistanceCore(op_left_vectors, op_right_vectors, is_return_normlize, distances, result_op_left_vectors,
                           result_op_right_vectors, DoCalcL2DistanceByFaiss);
 }
@@ -206,6 +233,11 @@ butil::Status VectorIndexUtils::CalcIpDistanceByFaiss(
     std::vector<::dingodb::pb::common::Vector>& result_op_left_vectors,   // NOLINT
     std::vector<::dingodb::pb::common::Vector>& result_op_right_vectors)  // NOLINT
 {                                                                         // NOLINT
+  if (CalcFloatDistanceByBatch(pb::common::METRIC_TYPE_INNER_PRODUCT, false, op_left_vectors, op_right_vectors,
+                               is_return_normlize, distances, result_op_left_vectors, result_op_right_vectors)) {
+    return butil::Status();
+  }
+
   return CalcDistanceCore(op_left_vectors, op_right_vectors, is_return_normlize, distances, result_op_left_vectors,
                           result_op_right_vectors, DoCalcIpDistanceByFaiss);
 }
@@ -217,6 +249,11 @@ butil::Status VectorIndexUtils::CalcCosineDistanceByFaiss(
     std::vector<::dingodb::pb::common::Vector>& result_op_left_vectors,   // NOLINT
     std::vector<::dingodb::pb::common::Vector>& result_op_right_vectors)  // NOLINT
 {                                                                         // NOLINT
+  if (CalcFloatDistanceByBatch(pb::common::METRIC_TYPE_COSINE, false, op_left_vectors, op_right_vectors,
+                               is_return_normlize, distances, result_op_left_vectors, result_op_right_vectors)) {
+    return butil::Status();
+  }
+
   return CalcDistanceCore(op_left_vectors, op_right_vectors, is_return_normlize, distances, result_op_left_vectors,
                           result_op_right_vectors, DoCalcCosineDistanceByFaiss);
 }
@@ -239,6 +276,11 @@ butil::Status VectorIndexUtils::CalcL2DistanceByHnswlib(
     std::vector<::dingodb::pb::common::Vector>& result_op_left_vectors,   // NOLINT
     std::vector<::dingodb::pb::common::Vector>& result_op_right_vectors)  // NOLINT
 {                                                                         // NOLINT
+  if (CalcFloatDistanceByBatch(pb::common::METRIC_TYPE_L2, true, op_left_vectors, op_right_vectors,
+                               is_return_normlize, distances, result_op_left_vectors, result_op_right_vectors)) {
+    return butil::Status();
+  }
+
   return CalcDistanceCore(op_left_vectors, op_right_vectors, is_return_normlize, distances, result_op_left_vectors,
                           result_op_right_vectors, DoCalcL2DistanceByHnswlib);
 }
@@ -250,6 +292,11 @@ butil::Status VectorIndexUtils::CalcIpDistanceByHnswlib(
     std::vector<::dingodb::pb::common::Vector>& result_op_left_vectors,   // NOLINT
     std::vector<::dingodb::pb::common::Vector>& result_op_right_vectors)  // NOLINT
 {                                                                         // NOLINT
+  if (CalcFloatDistanceByBatch(pb::common::METRIC_TYPE_INNER_PRODUCT, true, op_left_vectors, op_right_vectors,
+                               is_return_normlize, distances, result_op_left_vectors, result_op_right_vectors)) {
+    return butil::Status();
+  }
+
   return CalcDistanceCore(op_left_vectors, op_right_vectors, is_return_normlize, distances, result_op_left_vectors,
                           result_op_right_vectors, DoCalcIpDistanceByHnswlib);
 }
@@ -261,10 +308,190 @@ butil::Status VectorIndexUtils::CalcCosineDistanceByHnswlib(
     std::vector<::dingodb::pb::common::Vector>& result_op_left_vectors,   // NOLINT
     std::vector<::dingodb::pb::common::Vector>& result_op_right_vectors)  // NOLINT
 {                                                                         // NOLINT
+  if (CalcFloatDistanceByBatch(pb::common::METRIC_TYPE_COSINE, true, op_left_vectors, op_right_vectors,
+                               is_return_normlize, distances, result_op_left_vectors, result_op_right_vectors)) {
+    return butil::Status();
+  }
+
   return CalcDistanceCore(op_left_vectors, op_right_vectors, is_return_normlize, distances, result_op_left_vectors,
                           result_op_right_vectors, DoCalcCosineDistanceByHnswlib);
 }
 
+bool VectorIndexUtils::CalcFloatDistanceByBatch(
+    pb::common::MetricType metric_type, bool is_hnswlib,
+    const google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& op_left_vectors,
+    const google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& op_right_vectors, bool is_return_normlize,
+    std::vector<std::vector<float>>& distances, std::vector<::dingodb::pb::common::Vector>& result_op_left_vectors,
+    std::vector<::dingodb::pb::common::Vector>& result_op_right_vectors) {
+  if (!FLAGS_enable_vector_calc_distance_batch || op_left_vectors.empty() || op_right_vectors.empty()) {
+    return false;
+  }
+
+  int32_t dimension = op_left_vectors[0].float_values_size();
+  if (dimension <= 0) {
+    return false;
+  }
+  for (const auto& vector : op_left_vectors) {
+    if (vector.float_values_size() != dimension) {
+      return false;
+    }
+  }
+  for (const auto& vector : op_right_vectors) {
+    if (vector.float_values_size() != dimension) {
+      return false;
+    }
+  }
+
+  bool is_cosine = (metric_type == pb::common::METRIC_TYPE_COSINE);
+  auto copy_to_buffer = [&](const google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& vectors,
+                            std::vector<float>& buffer) {
+    buffer.resize(static_cast<size_t>(vectors.size()) * dimension);
+    for (int i = 0; i < vectors.size(); ++i) {
+      const float* src = vectors[i].float_values().data();
+      float* dst = buffer.data() + static_cast<size_t>(i) * dimension;
+      if (is_cosine && is_hnswlib) {
+        NormalizeVectorForHnsw(src, dimension, dst);
+      } else {
+        std::copy(src, src + dimension, dst);
+        if (is_cosine) {
+          NormalizeVectorForFaiss(dst, dimension);
+        }
+      }
+    }
+  };
+
+  std::vector<float> left_buffer;
+  std::vector<float> right_buffer;
+  copy_to_buffer(op_left_vectors, left_buffer);
+  copy_to_buffer(op_right_vectors, right_buffer);
+
+  size_t left_count = op_left_vectors.size();
+  size_t right_count = op_right_vectors.size();
+  distances.clear();
+  distances.resize(left_count);
+  for (auto& distance : distances) {
+    distance.resize(right_count);
+  }
+
+  // right vectors of one block stay in cache when calculate with all left vectors.
+  constexpr size_t kBlockSize = 256;
+  for (size_t begin = 0; begin < right_count; begin += kBlockSize) {
+    size_t block_count = std::min(kBlockSize, right_count - begin);
+    const float* right = right_buffer.data() + begin * dimension;
+    for (size_t i = 0; i < left_count; ++i) {
+      const float* left = left_buffer.data() + i * dimension;
+      float* distance = distances[i].data() + begin;
+      if (metric_type == pb::common::METRIC_TYPE_L2) {
+        fvec_L2sqr_ny(distance, left, right, dimension, block_count);
+      } else {
+        fvec_inner_products_ny(distance, left, right, dimension, block_count);
+        for (size_t k = 0; k < block_count; ++k) {
+          distance[k] = 1.0f - distance[k];
+        }
+      }
+    }
+  }
+
+  if (is_return_normlize) {
+    auto assign_result = [&](const google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& vectors,
+                             const std::vector<float>& buffer, std::vector<::dingodb::pb::common::Vector>& results) {
+      results.clear();
+      results.resize(vectors.size());
+      for (int i = 0; i < vectors.size(); ++i) {
+        ResultOpVectorAssignment(results[i], vectors[i]);
+        if (is_cosine) {
+          const float* src = buffer.data() + static_cast<size_t>(i) * dimension;
+          std::copy(src, src + dimension, results[i].mutable_float_values()->mutable_data());
+        }
+      }
+    };
+    assign_result(op_left_vectors, left_buffer, result_op_left_vectors);
+    assign_result(op_right_vectors, right_buffer, result_op_right_vectors);
+  }
+
+  return true;
+}
+
+bool VectorIndexUtils::AdaptiveIvfSearch(const faiss::IndexIVF* index, int64_t n, const float* x, int64_t k,
+                                         const faiss::IVFSearchParameters& params, float* distances,
+                                         faiss::idx_t* labels) {
+  int64_t step = FLAGS_vector_index_adaptive_nprobe_step;
+  int64_t nprobe = std::min(static_cast<int64_t>(params.nprobe), static_cast<int64_t>(index->nlist));
+  if (!FLAGS_enable_vector_index_adaptive_nprobe || step <= 0 || nprobe <= step || k <= 0) {
+    return false;
+  }
+
+  bool is_similarity = index->metric_type == faiss::METRIC_INNER_PRODUCT;
+  auto is_better = [is_similarity](float lhs, float rhs) { return is_similarity ? lhs > rhs : lhs < rhs; };
+  float worst_distance = is_similarity ? -std::numeric_limits<float>::max() : std::numeric_limits<float>::max();
+
+  std::vector<float> coarse_distances(nprobe);
+  std::vector<faiss::idx_t> assign(nprobe);
+  std::vector<float> step_distances(k);
+  std::vector<faiss::idx_t> step_labels(k);
+  std::vector<std::pair<float, faiss::idx_t>> merged;
+  merged.reserve(2 * k);
+
+  faiss::IVFSearchParameters step_params;
+  step_params.max_codes = params.max_codes;
+  step_params.sel = params.sel;
+
+  int64_t total_probe = 0;
+  for (int64_t row = 0; row < n; ++row) {
+    const float* query = x + row * index->d;
+    float* row_distances = distances + row * k;
+    faiss::idx_t* row_labels = labels + row * k;
+    std::fill_n(row_distances, k, worst_distance);
+    std::fill_n(row_labels, k, -1);
+
+    // lists in ascending order of centroid distance, near lists are probed first.
+    index->quantizer->search(1, query, nprobe, coarse_distances.data(), assign.data());
+
+    int64_t probe = 0;
+    int32_t stale_step = 0;
+    while (probe < nprobe && stale_step < FLAGS_vector_index_adaptive_nprobe_patience) {
+      step_params.nprobe = std::min(step, nprobe - probe);
+      index->search_preassigned(1, query, k, assign.data() + probe, coarse_distances.data() + probe,
+                                step_distances.data(), step_labels.data(), false, &step_params);
+      probe += step_params.nprobe;
+
+      // lists are disjoint, no duplicate id between steps.
+      float last_kth_distance = row_distances[k - 1];
+      merged.clear();
+      for (int64_t i = 0; i < k; ++i) {
+        if (row_labels[i] >= 0) {
+          merged.emplace_back(row_distances[i], row_labels[i]);
+        }
+        if (step_labels[i] >= 0) {
+          merged.emplace_back(step_distances[i], step_labels[i]);
+        }
+      }
+      int64_t count = std::min(k, static_cast<int64_t>(merged.size()));
+      std::partial_sort(merged.begin(), merged.begin() + count, merged.end(),
+                        [&is_better](const auto& lhs, const auto& rhs) { return is_better(lhs.first, rhs.first); });
+      for (int64_t i = 0; i < count; ++i) {
+        row_distances[i] = merged[i].first;
+        row_labels[i] = merged[i].second;
+      }
+
+      // topk not full is always improving.
+      if (row_labels[k - 1] >= 0 && !is_better(row_distances[k - 1], last_kth_distance)) {
+        ++stale_step;
+      } else {
+        stale_step = 0;
+      }
+    }
+
+    total_probe += probe;
+    g_vector_index_adaptive_nprobe_probe_permille << probe * 1000 / nprobe;
+  }
+
+  g_vector_index_adaptive_nprobe_query_count << n;
+  DINGO_LOG(DEBUG) << fmt::format("[vector_index.adaptive] query({}) nprobe({}) probe lists({})", n, nprobe,
+                                  total_probe);
+  return true;
+}
+
 butil::Status VectorIndexUtils::DoCalcL2DistanceByFaiss(const ::dingodb::pb::common::Vector& op_left_vectors,
                                                         const ::dingodb::pb::common::Vector& op_right_vectors,
                                                         bool is_return_normlize,
@@ -337,9 +564,6 @@ butil::Status VectorIndexUtils::DoCalcHammingDistanceByFaiss(
     dingodb::pb::common::Vector& result_op_left_vectors,   // NOLINT
     dingodb::pb::common::Vector& result_op_right_vectors)  // NOLINT
 {                                                          // NOLINT
-  faiss::VectorDistance<faiss::MetricType::METRIC_HAMMING> vector_distance;
-  vector_distance.d = op_left_vectors.binary_values().size();
-
   std::vector<uint8_t> left_vectors = std::vector<uint8_t>(op_left_vectors.binary_values().size());
   for (int j = 0; j < op_left_vectors.binary_values().size(); j++) {
     left_vectors[j] = static_cast<uint8_t>(op_left_vectors.binary_values()[j][0]);
@@ -349,7 +573,8 @@ butil::Status VectorIndexUtils::DoCalcHammingDistanceByFaiss(
     right_vectors[j] = static_cast<uint8_t>(op_right_vectors.binary_values()[j][0]);
   }
 
-  distance = vector_distance(left_vectors.data(), right_vectors.data());
+  distance = static_cast<float>(
+      hamming_distance(left_vectors.data(), right_vectors.data(), std::min(left_vectors.size(), right_vectors.size())));
 
   ResultOpBinaryVectorAssignmentWrapper(op_left_vectors, op_right_vectors, is_return_normlize, result_op_left_vectors,
                                         result_op_right_vectors);
@@ -1901,4 +2126,74 @@ butil::Status VectorIndexUtils::ValidateVectorWithDocumentSpeedupJsonParameter(
 }
 #endif
 
+VectorReservoirSampler::VectorReservoirSampler(int64_t max_count, int32_t dimension, uint64_t seed)
+    : max_count_(max_count), dimension_(dimension), rng_(seed) {
+  samples_.reserve(std::max(max_count_, static_cast<int64_t>(0)) * dimension_);
+}
+
+void VectorReservoirSampler::Add(const float* vector_values) {
+  ++seen_count_;
+  if (seen_count_ <= max_count_) {
+    samples_.insert(samples_.end(), vector_values, vector_values + dimension_);
+    return;
+  }
+
+  // replace a sample with probability max_count/seen_count
+  std::uniform_int_distribution<int64_t> distrib(0, seen_count_ - 1);
+  int64_t pos = distrib(rng_);
+  if (pos < max_count_) {
+    std::copy(vector_values, vector_values + dimension_, samples_.begin() + pos * dimension_);
+  }
+}
+
+VectorTopkMerger::VectorTopkMerger(uint32_t topk, bool dedup_id) : topk_(topk), dedup_id_(dedup_id) {}
+
+void VectorTopkMerger::Push(const Candidate& candidate) {
+  if (heap_.size() < topk_) {
+    heap_.push_back(candidate);
+    std::push_heap(heap_.begin(), heap_.end(), Less);
+  } else if (!heap_.empty() && Less(candidate, heap_.front())) {
+    std::pop_heap(heap_.begin(), heap_.end(), Less);
+    heap_.back() = candidate;
+    std::push_heap(heap_.begin(), heap_.end(), Less);
+  }
+}
+
+void VectorTopkMerger::Add(pb::index::VectorWithDistanceResult& source) {
+  uint32_t source_index = sources_.size();
+  sources_.push_back(&source);
+
+  for (int i = 0; i < source.vector_with_distances_size(); ++i) {
+    const auto& vector_with_distance = source.vector_with_distances(i);
+    Candidate candidate{vector_with_distance.distance(), source_index, i};
+    if (!dedup_id_) {
+      Push(candidate);
+      continue;
+    }
+
+    auto [it, is_new] = id_candidates_.try_emplace(vector_with_distance.vector_with_id().id(), candidate);
+    if (!is_new && Less(candidate, it->second)) {
+      it->second = candidate;
+    }
+  }
+}
+
+void VectorTopkMerger::Finish(pb::index::VectorWithDistanceResult& result) {
+  for (const auto& [_, candidate] : id_candidates_) {
+    Push(candidate);
+  }
+
+  std::sort_heap(heap_.begin(), heap_.end(), Less);
+
+  auto* vector_with_distances = result.mutable_vector_with_distances();
+  vector_with_distances->Reserve(vector_with_distances->size() + heap_.size());
+  for (const auto& candidate : heap_) {
+    vector_with_distances->Add()->Swap(sources_[candidate.source]->mutable_vector_with_distances(candidate.offset));
+  }
+
+  sources_.clear();
+  heap_.clear();
+  id_candidates_.clear();
+}
+
 }  // namespace dingodb
@@ -17,6 +17,8 @@
 
 #include <cstdint>
 #include <memory>
+#include <random>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -24,6 +26,7 @@
 #include "common/threadpool.h"
 #include "faiss/Index.h"
 #include "faiss/IndexBinary.h"
+#include "faiss/IndexIVF.h"
 #include "faiss/impl/AuxIndexStructures.h"
 #include "proto/common.pb.h"
 #include "proto/index.pb.h"
@@ -122,6 +125,23 @@ class VectorIndexUtils {
 
   // internal api
 
+  // Batch path of float L2/IP/cosine, vectors are copied to contiguous buffers once and distances of each left vector
+  // to a block of right vectors are calculated by simd ny kernels. Return false when not applicable, e.g. vectors of
+  // different dimension, then caller calculate by pair.
+  static bool CalcFloatDistanceByBatch(
+      pb::common::MetricType metric_type, bool is_hnswlib,
+      const google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& op_left_vectors,
+      const google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& op_right_vectors,
+      bool is_return_normlize, std::vector<std::vector<float>>& distances,
+      std::vector<::dingodb::pb::common::Vector>& result_op_left_vectors,
+      std::vector<::dingodb::pb::common::Vector>& result_op_right_vectors);
+
+  // Search float ivf index by probing nearest lists step by step, stop when the kth distance of a query not improve
+  // in patience steps, so easy query probe fewer lists than nprobe. Return false when not enabled or nprobe is small,
+  // then caller search by index directly.
+  static bool AdaptiveIvfSearch(const faiss::IndexIVF* index, int64_t n, const float* x, int64_t k,
+                                const faiss::IVFSearchParameters& params, float* distances, faiss::idx_t* labels);
+
   static butil::Status DoCalcL2DistanceByFaiss(const ::dingodb::pb::common::Vector& op_left_vectors,
                                                const ::dingodb::pb::common::Vector& op_right_vectors,
                                                bool is_return_normlize, float& distance,
@@ -239,6 +259,64 @@ class VectorIndexUtils {
 #endif
 };
 
+// Reservoir sampling(algorithm R) of float vectors, keep a uniform sample of any size stream with bounded memory.
+class VectorReservoirSampler {
+ public:
+  VectorReservoirSampler(int64_t max_count, int32_t dimension, uint64_t seed = 0);
+
+  void Add(const float* vector_values);
+
+  // sample vectors, flat in row major.
+  std::vector<float>& Samples() { return samples_; }
+  int64_t SampleCount() const { return samples_.size() / dimension_; }
+  int64_t SeenCount() const { return seen_count_; }
+
+ private:
+  int64_t max_count_;
+  int32_t dimension_;
+  int64_t seen_count_{0};
+  std::vector<float> samples_;
+  std::mt19937_64 rng_;
+};
+
+// Top-k merge of search results of one query from many sources, e.g. own/sibling index or segments.
+// Candidates are kept in a bounded max heap of plain struct, only selected results are moved to output protobuf.
+class VectorTopkMerger {
+ public:
+  // dedup_id keep the smallest distance of same id, for sources which may contain same vector.
+  VectorTopkMerger(uint32_t topk, bool dedup_id);
+
+  // source must be alive until Finish(), its selected results are moved out.
+  void Add(pb::index::VectorWithDistanceResult& source);
+
+  // output topk of all sources order by distance, then merger can be reused.
+  void Finish(pb::index::VectorWithDistanceResult& result);
+
+ private:
+  struct Candidate {
+    float distance;
+    uint32_t source;
+    int32_t offset;
+  };
+
+  // order by distance, tie prefer earlier source.
+  static bool Less(const Candidate& lhs, const Candidate& rhs) {
+    if (lhs.distance != rhs.distance) {
+      return lhs.distance < rhs.distance;
+    }
+    return lhs.source != rhs.source ? lhs.source < rhs.source : lhs.offset < rhs.offset;
+  }
+
+  void Push(const Candidate& candidate);
+
+  uint32_t topk_;
+  bool dedup_id_;
+  std::vector<pb::index::VectorWithDistanceResult*> sources_;
+  // max heap, top is the worst candidate.
+  std::vector<Candidate> heap_;
+  std::unordered_map<int64_t, Candidate> id_candidates_;
+};
+
 }  // namespace dingodb
 
 #endif  // DINGODB_VECTOR_INDEX_UTILS_H_
@@ -15,6 +15,7 @@
 #include "vector/vector_reader.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <deque>
 #include <limits>
@@ -22,13 +23,16 @@
 #include <set>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "butil/status.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/probe.h"
 #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
 #include "common/uuid.h"
 #endif
@@ -38,6 +42,7 @@
 #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
 #include "document/codec.h"
 #endif
+#include "faiss/utils/distances.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
 #include "glog/logging.h"
@@ -47,6 +52,8 @@
 #include "server/server.h"
 #include "vector/codec.h"
 #include "vector/vector_index.h"
+#include "vector/vector_filter_planner.h"
+#include "vector/vector_hybrid_fusion.h"
 #include "vector/vector_index_factory.h"
 #include "vector/vector_index_utils.h"
 
@@ -60,9 +67,15 @@ namespace dingodb {
 DEFINE_int64(vector_index_max_range_search_result_count, 1024, "max range search result count");
 DEFINE_int64(vector_index_bruteforce_batch_count, 2048, "bruteforce batch count");
 DEFINE_bool(dingo_log_switch_scalar_speed_up_detail, false, "scalar speed up log");
+DEFINE_int32(ivf_pq_refine_multiple, 1,
+             "ivf pq search topk*multiple candidates, then re-rank them by raw vector, 1 is not refine");
+BRPC_VALIDATE_GFLAG(ivf_pq_refine_multiple, brpc::PositiveInteger);
 
 bvar::LatencyRecorder g_bruteforce_search_latency("dingo_bruteforce_search_latency");
 bvar::LatencyRecorder g_bruteforce_range_search_latency("dingo_bruteforce_range_search_latency");
+#if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
+bvar::LatencyRecorder g_vector_hybrid_search_latency("dingo_vector_hybrid_search_latency");
+#endif
 
 DECLARE_bool(dingo_log_switch_coprocessor_scalar_detail);
 
@@ -77,6 +90,20 @@ BRPC_VALIDATE_GFLAG(vector_index_uses_document_print_document, brpc::PassValidat
 
 #endif
 
+static void FillSelectedScalarData(const pb::common::VectorScalardata& vector_scalar,
+                                   const std::vector<std::string>& selected_scalar_keys,
+                                   pb::common::VectorWithId& vector_with_id) {
+  auto* scalar = vector_with_id.mutable_scalar_data()->mutable_scalar_data();
+  for (const auto& [key, value] : vector_scalar.scalar_data()) {
+    if (!selected_scalar_keys.empty() &&
+        std::find(selected_scalar_keys.begin(), selected_scalar_keys.end(), key) == selected_scalar_keys.end()) {
+      continue;
+    }
+
+    scalar->insert({key, value});
+  }
+}
+
 butil::Status VectorReader::QueryVectorWithId(int64_t ts, const pb::common::Range& region_range, int64_t partition_id,
                                               int64_t vector_id, bool with_vector_data,
                                               pb::common::VectorWithId& vector_with_id) {
@@ -110,15 +137,35 @@ butil::Status VectorReader::SearchVector(
     return butil::Status();
   }
 
+  DINGO_DEBUG_PROBE_LATENCY("vector_reader_search");
+  DINGO_DEBUG_PROBE_ADD("vector_reader_search_vector_count", vector_with_ids.size());
+
   auto vector_filter = parameter.vector_filter();
   auto vector_filter_type = parameter.vector_filter_type();
 
   bool with_vector_data = !(parameter.without_vector_data());
   std::vector<pb::index::VectorWithDistanceResult> tmp_results;
 
-  // scalar post filter
-  if (dingodb::pb::common::VectorFilter::SCALAR_FILTER == vector_filter &&
-      dingodb::pb::common::VectorFilterType::QUERY_POST == vector_filter_type) {
+#if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
+  // scalar post filter with document is hybrid search, not filter
+  bool is_hybrid_search = dingodb::pb::common::VectorFilter::SCALAR_FILTER == vector_filter &&
+                          dingodb::pb::common::VectorFilterType::QUERY_POST == vector_filter_type &&
+                          parameter.is_scalar_speed_up_with_document();
+#else
+  bool is_hybrid_search = false;
+#endif
+
+  if (is_hybrid_search) {
+#if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
+    butil::Status status = DoVectorSearchForHybridWithDocument(vector_index, region_range, vector_with_ids, parameter,
+                                                               vector_with_distance_results);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("DoVectorSearchForHybridWithDocument failed : {}", status.error_cstr());
+      return status;
+    }
+#endif
+  } else if (dingodb::pb::common::VectorFilter::SCALAR_FILTER == vector_filter &&
+             dingodb::pb::common::VectorFilterType::QUERY_POST == vector_filter_type) {  // scalar post filter
     uint32_t top_n = parameter.top_n();
     bool enable_range_search = parameter.enable_range_search();
 
@@ -290,26 +337,26 @@ butil::Status VectorReader::QueryVectorTableData(int64_t ts, const pb::common::R
                                                  int64_t partition_id,
                                                  std::vector<pb::index::VectorWithDistanceResult>& results) {
   // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
   for (auto& result : results) {
     for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
-      pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-      QueryVectorTableData(ts, region_range, partition_id, vector_with_id);
+      vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
     }
   }
 
-  return butil::Status();
+  return BatchQueryVectorTableData(ts, region_range, partition_id, vector_with_ids);
 }
 
 butil::Status VectorReader::QueryVectorTableData(int64_t ts, const pb::common::Range& region_range,
                                                  int64_t partition_id,
                                                  std::vector<pb::common::VectorWithDistance>& vector_with_distances) {
   // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
   for (auto& vector_with_distance : vector_with_distances) {
-    pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-    QueryVectorTableData(ts, region_range, partition_id, vector_with_id);
+    vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
   }
 
-  return butil::Status();
+  return BatchQueryVectorTableData(ts, region_range, partition_id, vector_with_ids);
 }
 
 butil::Status VectorReader::QueryVectorScalarData(int64_t ts, const pb::common::Range& region_range,
@@ -327,15 +374,7 @@ butil::Status VectorReader::QueryVectorScalarData(int64_t ts, const pb::common::
   pb::common::VectorScalardata vector_scalar;
   CHECK(vector_scalar.ParseFromString(plain_value)) << "Parase vector scalar data error.";
 
-  auto* scalar = vector_with_id.mutable_scalar_data()->mutable_scalar_data();
-  for (const auto& [key, value] : vector_scalar.scalar_data()) {
-    if (!selected_scalar_keys.empty() &&
-        std::find(selected_scalar_keys.begin(), selected_scalar_keys.end(), key) == selected_scalar_keys.end()) {
-      continue;
-    }
-
-    scalar->insert({key, value});
-  }
+  FillSelectedScalarData(vector_scalar, selected_scalar_keys, vector_with_id);
 
   return butil::Status();
 }
@@ -344,26 +383,144 @@ butil::Status VectorReader::QueryVectorScalarData(int64_t ts, const pb::common::
                                                   int64_t partition_id, std::vector<std::string> selected_scalar_keys,
                                                   std::vector<pb::index::VectorWithDistanceResult>& results) {
   // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
   for (auto& result : results) {
     for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
-      pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-      QueryVectorScalarData(ts, region_range, partition_id, selected_scalar_keys, vector_with_id);
+      vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
     }
   }
 
-  return butil::Status();
+  return BatchQueryVectorScalarData(ts, region_range, partition_id, selected_scalar_keys, vector_with_ids);
 }
 
 butil::Status VectorReader::QueryVectorScalarData(int64_t ts, const pb::common::Range& region_range,
                                                   int64_t partition_id, std::vector<std::string> selected_scalar_keys,
                                                   std::vector<pb::common::VectorWithDistance>& vector_with_distances) {
   // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
   for (auto& vector_with_distance : vector_with_distances) {
-    pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-    QueryVectorScalarData(ts, region_range, partition_id, selected_scalar_keys, vector_with_id);
+    vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
   }
 
-  return butil::Status();
+  return BatchQueryVectorScalarData(ts, region_range, partition_id, selected_scalar_keys, vector_with_ids);
+}
+
+butil::Status VectorReader::BatchQueryVectorData(int64_t ts, const pb::common::Range& region_range,
+                                                 int64_t partition_id, const std::vector<int64_t>& vector_ids,
+                                                 bool with_vector_data,
+                                                 std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  char prefix = Helper::GetKeyPrefix(region_range);
+  std::vector<std::string> plain_keys;
+  plain_keys.reserve(vector_ids.size());
+  for (auto vector_id : vector_ids) {
+    plain_keys.push_back(VectorCodec::PackageVectorKey(prefix, partition_id, vector_id));
+  }
+
+  std::vector<pb::common::KeyValue> plain_kvs;
+  auto status = reader_->KvBatchGet(Constant::kVectorDataCF, ts, plain_keys, plain_kvs);
+  if (!status.ok()) {
+    return status;
+  }
+
+  std::unordered_map<std::string_view, const std::string*> plain_values;
+  plain_values.reserve(plain_kvs.size());
+  for (const auto& kv : plain_kvs) {
+    plain_values[kv.key()] = &kv.value();
+  }
+
+  // keep order of vector_ids, if the id is not exist, the vector_with_id will be empty.
+  vector_with_ids.reserve(vector_with_ids.size() + vector_ids.size());
+  for (size_t i = 0; i < vector_ids.size(); ++i) {
+    pb::common::VectorWithId vector_with_id;
+    auto it = plain_values.find(plain_keys[i]);
+    if (it != plain_values.end()) {
+      if (with_vector_data) {
+        CHECK(vector_with_id.mutable_vector()->ParseFromString(*it->second)) << "Parse vector proto error";
+      }
+      vector_with_id.set_id(vector_ids[i]);
+    }
+
+    vector_with_ids.push_back(std::move(vector_with_id));
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorReader::BatchQueryVectorScalarData(int64_t ts, const pb::common::Range& region_range,
+                                                       int64_t partition_id,
+                                                       const std::vector<std::string>& selected_scalar_keys,
+                                                       const std::vector<pb::common::VectorWithId*>& vector_with_ids) {
+  if (vector_with_ids.empty()) {
+    return butil::Status::OK();
+  }
+
+  // same vector may be in result of many query
+  char prefix = Helper::GetKeyPrefix(region_range);
+  std::unordered_map<std::string, std::vector<pb::common::VectorWithId*>> key_vector_with_ids;
+  std::vector<std::string> plain_keys;
+  for (auto* vector_with_id : vector_with_ids) {
+    std::string plain_key = VectorCodec::PackageVectorKey(prefix, partition_id, vector_with_id->id());
+    auto& key_vector_with_id = key_vector_with_ids[plain_key];
+    if (key_vector_with_id.empty()) {
+      plain_keys.push_back(plain_key);
+    }
+    key_vector_with_id.push_back(vector_with_id);
+  }
+
+  std::vector<pb::common::KeyValue> plain_kvs;
+  auto status = reader_->KvBatchGet(Constant::kVectorScalarCF, ts, plain_keys, plain_kvs);
+  if (!status.ok()) {
+    return status;
+  }
+
+  for (const auto& kv : plain_kvs) {
+    pb::common::VectorScalardata vector_scalar;
+    CHECK(vector_scalar.ParseFromString(kv.value())) << "Parase vector scalar data error.";
+
+    for (auto* vector_with_id : key_vector_with_ids[kv.key()]) {
+      FillSelectedScalarData(vector_scalar, selected_scalar_keys, *vector_with_id);
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorReader::BatchQueryVectorTableData(int64_t ts, const pb::common::Range& region_range,
+                                                      int64_t partition_id,
+                                                      const std::vector<pb::common::VectorWithId*>& vector_with_ids) {
+  if (vector_with_ids.empty()) {
+    return butil::Status::OK();
+  }
+
+  // same vector may be in result of many query
+  char prefix = region_range.start_key()[0];
+  std::unordered_map<std::string, std::vector<pb::common::VectorWithId*>> key_vector_with_ids;
+  std::vector<std::string> plain_keys;
+  for (auto* vector_with_id : vector_with_ids) {
+    std::string plain_key = VectorCodec::PackageVectorKey(prefix, partition_id, vector_with_id->id());
+    auto& key_vector_with_id = key_vector_with_ids[plain_key];
+    if (key_vector_with_id.empty()) {
+      plain_keys.push_back(plain_key);
+    }
+    key_vector_with_id.push_back(vector_with_id);
+  }
+
+  std::vector<pb::common::KeyValue> plain_kvs;
+  auto status = reader_->KvBatchGet(Constant::kVectorTableCF, ts, plain_keys, plain_kvs);
+  if (!status.ok()) {
+    return status;
+  }
+
+  for (const auto& kv : plain_kvs) {
+    pb::common::VectorTableData vector_table;
+    CHECK(vector_table.ParseFromString(kv.value())) << "Prase vector table data error.";
+
+    for (auto* vector_with_id : key_vector_with_ids[kv.key()]) {
+      *(vector_with_id->mutable_table_data()) = vector_table;
+    }
+  }
+
+  return butil::Status::OK();
 }
 
 butil::Status VectorReader::CompareVectorScalarData(int64_t ts, const pb::common::Range& region_range,
@@ -438,13 +595,38 @@ butil::Status VectorReader::CompareVectorScalarDataWithCoprocessor(
 
 butil::Status VectorReader::VectorBatchSearch(std::shared_ptr<Engine::VectorReader::Context> ctx,
                                               std::vector<pb::index::VectorWithDistanceResult>& results) {  // NOLINT
+  // pq distance is approximate, search more candidates and re-rank them by raw vector.
+  uint32_t top_n = ctx->parameter.top_n();
+  bool need_refine = FLAGS_ivf_pq_refine_multiple > 1 && top_n > 0 &&
+                     ctx->vector_index->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ &&
+                     !ctx->parameter.enable_range_search() && !ctx->parameter.use_brute_force();
+  if (need_refine) {
+    ctx->parameter.set_top_n(top_n * FLAGS_ivf_pq_refine_multiple);
+  }
+
   // Search vectors by vectors
   auto status = SearchVector(ctx->ts, ctx->partition_id, ctx->vector_index, ctx->region_range, ctx->vector_with_ids,
                              ctx->parameter, ctx->scalar_schema, results);
+  if (need_refine) {
+    ctx->parameter.set_top_n(top_n);
+  }
   if (!status.ok()) {
     return status;
   }
 
+  if (need_refine) {
+    status = RefineSearchResults(ctx->ts, ctx->region_range, ctx->partition_id, ctx->vector_index->GetMetricType(),
+                                 ctx->vector_with_ids, top_n, results);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  // aggregate before fill data, only data of final list is read.
+  if (ctx->multi_vector_aggregation != Engine::VectorReader::MultiVectorAggregation::kNone) {
+    AggregateMultiVectorResults(ctx->multi_vector_aggregation, ctx->parameter.top_n(), results);
+  }
+
   if (!ctx->parameter.without_scalar_data()) {
     // Get scalar data by parameter
     std::vector<std::string> selected_scalar_keys = Helper::PbRepeatedToVector(ctx->parameter.selected_keys());
@@ -465,50 +647,180 @@ butil::Status VectorReader::VectorBatchSearch(std::shared_ptr<Engine::VectorRead
   return butil::Status();
 }
 
-butil::Status VectorReader::VectorBatchQuery(std::shared_ptr<Engine::VectorReader::Context> ctx,
-                                             std::vector<pb::common::VectorWithId>& vector_with_ids) {
-  for (auto vector_id : ctx->vector_ids) {
-    pb::common::VectorWithId vector_with_id;
-    auto status = QueryVectorWithId(ctx->ts, ctx->region_range, ctx->partition_id, vector_id, ctx->with_vector_data,
-                                    vector_with_id);
-    if ((!status.ok()) && status.error_code() != pb::error::EKEY_NOT_FOUND) {
-      DINGO_LOG(WARNING) << fmt::format("Query vector_with_id failed, vector_id: {} error: {}", vector_id,
-                                        status.error_str());
+// distance same as faiss search result, ip/cosine is 1-ip.
+static float RawVectorDistance(pb::common::MetricType metric_type, const pb::common::Vector& query,
+                               const pb::common::Vector& vector) {
+  int dimension = query.float_values_size();
+  const float* x = query.float_values().data();
+  const float* y = vector.float_values().data();
+  if (metric_type == pb::common::MetricType::METRIC_TYPE_L2) {
+    return faiss::fvec_L2sqr(x, y, dimension);
+  }
+
+  float ip = faiss::fvec_inner_product(x, y, dimension);
+  if (metric_type == pb::common::MetricType::METRIC_TYPE_COSINE) {
+    float norm = std::sqrt(faiss::fvec_norm_L2sqr(x, dimension) * faiss::fvec_norm_L2sqr(y, dimension));
+    ip = norm > 0 ? ip / norm : 0;
+  }
+  return 1.0F - ip;
+}
+
+butil::Status VectorReader::RefineSearchResults(int64_t ts, const pb::common::Range& region_range,
+                                                int64_t partition_id, pb::common::MetricType metric_type,
+                                                const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                                uint32_t topk,
+                                                std::vector<pb::index::VectorWithDistanceResult>& results) {
+  // one batch get of all candidates
+  std::vector<int64_t> vector_ids;
+  for (const auto& result : results) {
+    for (const auto& vector_with_distance : result.vector_with_distances()) {
+      vector_ids.push_back(vector_with_distance.vector_with_id().id());
     }
+  }
+  std::sort(vector_ids.begin(), vector_ids.end());
+  vector_ids.erase(std::unique(vector_ids.begin(), vector_ids.end()), vector_ids.end());
 
-    // if the id is not exist, the vector_with_id will be empty, sdk client will handle this
-    vector_with_ids.push_back(vector_with_id);
+  std::vector<pb::common::VectorWithId> raw_vector_with_ids;
+  auto status = BatchQueryVectorData(ts, region_range, partition_id, vector_ids, true, raw_vector_with_ids);
+  if (!status.ok()) {
+    return status;
   }
 
-  if (ctx->with_scalar_data) {
-    for (auto& vector_with_id : vector_with_ids) {
-      if (vector_with_id.ByteSizeLong() == 0) {
-        continue;
-      }
+  std::unordered_map<int64_t, const pb::common::Vector*> raw_vectors;
+  raw_vectors.reserve(raw_vector_with_ids.size());
+  for (const auto& raw_vector_with_id : raw_vector_with_ids) {
+    if (raw_vector_with_id.vector().float_values_size() > 0) {
+      raw_vectors[raw_vector_with_id.id()] = &raw_vector_with_id.vector();
+    }
+  }
 
-      auto status = QueryVectorScalarData(ctx->ts, ctx->region_range, ctx->partition_id, ctx->selected_scalar_keys,
-                                          vector_with_id);
-      if (!status.ok()) {
-        DINGO_LOG(WARNING) << fmt::format("Query vector scalar data failed, vector_id: {} error: {} ",
-                                          vector_with_id.id(), status.error_str());
+  for (size_t row = 0; row < results.size() && row < vector_with_ids.size(); ++row) {
+    const auto& query = vector_with_ids[row].vector();
+    auto* vector_with_distances = results[row].mutable_vector_with_distances();
+    for (auto& vector_with_distance : *vector_with_distances) {
+      auto it = raw_vectors.find(vector_with_distance.vector_with_id().id());
+      if (it != raw_vectors.end() && it->second->float_values_size() == query.float_values_size()) {
+        vector_with_distance.set_distance(RawVectorDistance(metric_type, query, *it->second));
       }
     }
+
+    std::stable_sort(vector_with_distances->begin(), vector_with_distances->end(),
+                     [](const pb::common::VectorWithDistance& lhs, const pb::common::VectorWithDistance& rhs) {
+                       return lhs.distance() < rhs.distance();
+                     });
+    if (vector_with_distances->size() > topk) {
+      vector_with_distances->DeleteSubrange(topk, vector_with_distances->size() - topk);
+    }
   }
 
-  if (ctx->with_table_data) {
-    for (auto& vector_with_id : vector_with_ids) {
-      if (vector_with_id.ByteSizeLong() == 0) {
-        continue;
-      }
+  return butil::Status::OK();
+}
 
-      auto status = QueryVectorTableData(ctx->ts, ctx->region_range, ctx->partition_id, vector_with_id);
-      if (!status.ok()) {
-        DINGO_LOG(WARNING) << fmt::format("Query vector table data failed, vector_id: {} error: {} ",
-                                          vector_with_id.id(), status.error_str());
+void VectorReader::AggregateMultiVectorResults(Engine::VectorReader::MultiVectorAggregation aggregation,
+                                               uint32_t topk,
+                                               std::vector<pb::index::VectorWithDistanceResult>& results) {
+  struct Score {
+    float distance{0};
+    // sum of farthest distance of query which hit this vector, for kSum.
+    float hit_farthest_distance{0};
+    pb::common::VectorWithDistance* vector_with_distance{nullptr};
+  };
+
+  float total_farthest_distance = 0;
+  std::unordered_map<int64_t, Score> scores;
+  for (auto& result : results) {
+    auto* vector_with_distances = result.mutable_vector_with_distances();
+    if (vector_with_distances->empty()) {
+      continue;
+    }
+
+    float farthest_distance = 0;
+    for (const auto& vector_with_distance : *vector_with_distances) {
+      farthest_distance = std::max(farthest_distance, vector_with_distance.distance());
+    }
+    total_farthest_distance += farthest_distance;
+
+    for (auto& vector_with_distance : *vector_with_distances) {
+      auto [it, is_new] = scores.try_emplace(vector_with_distance.vector_with_id().id());
+      auto& score = it->second;
+      if (aggregation == Engine::VectorReader::MultiVectorAggregation::kSum) {
+        score.distance += vector_with_distance.distance();
+        score.hit_farthest_distance += farthest_distance;
+        if (is_new) score.vector_with_distance = &vector_with_distance;
+      } else if (is_new || vector_with_distance.distance() < score.distance) {
+        score.distance = vector_with_distance.distance();
+        score.vector_with_distance = &vector_with_distance;
       }
     }
   }
 
+  std::vector<Score> ranked;
+  ranked.reserve(scores.size());
+  for (auto& [id, score] : scores) {
+    if (aggregation == Engine::VectorReader::MultiVectorAggregation::kSum) {
+      score.distance += total_farthest_distance - score.hit_farthest_distance;
+    }
+    ranked.push_back(score);
+  }
+
+  auto less = [](const Score& lhs, const Score& rhs) {
+    if (lhs.distance != rhs.distance) {
+      return lhs.distance < rhs.distance;
+    }
+    return lhs.vector_with_distance->vector_with_id().id() < rhs.vector_with_distance->vector_with_id().id();
+  };
+  if (ranked.size() > topk) {
+    std::partial_sort(ranked.begin(), ranked.begin() + topk, ranked.end(), less);
+    ranked.resize(topk);
+  } else {
+    std::sort(ranked.begin(), ranked.end(), less);
+  }
+
+  pb::index::VectorWithDistanceResult aggregated_result;
+  for (auto& score : ranked) {
+    auto* vector_with_distance = aggregated_result.add_vector_with_distances();
+    vector_with_distance->Swap(score.vector_with_distance);
+    vector_with_distance->set_distance(score.distance);
+  }
+
+  results.clear();
+  results.push_back(std::move(aggregated_result));
+}
+
+butil::Status VectorReader::VectorBatchQuery(std::shared_ptr<Engine::VectorReader::Context> ctx,
+                                             std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  // one batch get per cf, result hydration not grow with the number of vector ids.
+  auto status = BatchQueryVectorData(ctx->ts, ctx->region_range, ctx->partition_id, ctx->vector_ids,
+                                     ctx->with_vector_data, vector_with_ids);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("Query vector_with_id failed, vector_ids size: {} error: {}",
+                                      ctx->vector_ids.size(), status.error_str());
+    return status;
+  }
+
+  // skip not exist vector
+  std::vector<pb::common::VectorWithId*> exist_vector_with_ids;
+  for (auto& vector_with_id : vector_with_ids) {
+    if (vector_with_id.ByteSizeLong() != 0) {
+      exist_vector_with_ids.push_back(&vector_with_id);
+    }
+  }
+
+  if (ctx->with_scalar_data) {
+    auto status = BatchQueryVectorScalarData(ctx->ts, ctx->region_range, ctx->partition_id,
+                                             ctx->selected_scalar_keys, exist_vector_with_ids);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("Query vector scalar data failed, error: {} ", status.error_str());
+    }
+  }
+
+  if (ctx->with_table_data) {
+    auto status = BatchQueryVectorTableData(ctx->ts, ctx->region_range, ctx->partition_id, exist_vector_with_ids);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("Query vector table data failed, error: {} ", status.error_str());
+    }
+  }
+
   return butil::Status::OK();
 }
 
@@ -941,13 +1253,13 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilter(
                        (enable_speed_up ? "true" : "false"), (use_coprocessor ? "true" : "false"),
                        scalar_schema.ShortDebugString(), Helper::SetToString(compare_keys));
 
-    std::vector<int64_t> vector_ids;
-    vector_ids.reserve(1024);
+    // build bitmap directly while scan, it is shared by filter without copy.
+    auto vector_ids = std::make_shared<VectorIdBitmap>();
     if (enable_speed_up) {
       const auto& std_vector_scalar =
           use_coprocessor ? pb::common::VectorScalardata() : vector_with_ids[0].scalar_data();
       status = InternalVectorSearchForScalarPreFilterWithScalarKeySpeedUpCF(
-          region_range, compare_keys, use_coprocessor, scalar_coprocessor, std_vector_scalar, vector_ids);
+          region_range, compare_keys, use_coprocessor, scalar_coprocessor, std_vector_scalar, *vector_ids);
       if (!status.ok()) {
         DINGO_LOG(ERROR) << status.error_cstr();
         return status;
@@ -956,44 +1268,111 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilter(
       const auto& std_vector_scalar =
           use_coprocessor ? pb::common::VectorScalardata() : vector_with_ids[0].scalar_data();
       status = InternalVectorSearchForScalarPreFilterWithScalarCF(region_range, use_coprocessor, scalar_coprocessor,
-                                                                  std_vector_scalar, vector_ids);
+                                                                  std_vector_scalar, *vector_ids);
       if (!status.ok()) {
         DINGO_LOG(ERROR) << status.error_cstr();
         return status;
       }
     }
 
-    std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters;
-    status = VectorReader::SetVectorIndexIdsFilter(false, false, vector_ids, filters);
+    status = SearchWithScalarPreFilterIds(vector_index, region_range, vector_with_ids, parameter, vector_ids,
+                                          vector_with_distance_results);
     if (!status.ok()) {
       DINGO_LOG(ERROR) << status.error_cstr();
       return status;
     }
 
-    status = VectorReader::SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids, parameter,
-                                                       vector_with_distance_results, parameter.top_n(), filters);
+#if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
+  }
+#endif
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorReader::SearchWithScalarPreFilterIds(
+    VectorIndexWrapperPtr vector_index, const pb::common::Range& region_range,
+    const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
+    VectorIdBitmapPtr vector_ids, std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results) {
+  uint32_t topk = parameter.top_n();
+  int64_t candidate_count = vector_ids->Cardinality();
+  int64_t total_count = 0;
+  auto status = vector_index->GetCount(total_count);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[vector_index.filter_planner][index_id({})] get count failed, error: {}",
+                                      vector_index->Id(), status.error_str());
+    total_count = 0;
+  }
+
+  auto plan = parameter.use_brute_force()
+                  ? VectorFilterPlan::kIndexFilter
+                  : VectorFilterPlanner::Choose(candidate_count, total_count, topk, parameter.enable_range_search());
+
+  if (plan == VectorFilterPlan::kPostFilter) {
+    uint32_t post_filter_topk = VectorFilterPlanner::PostFilterTopk(candidate_count, total_count, topk);
+    std::vector<pb::index::VectorWithDistanceResult> tmp_results;
+    status = SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids, parameter, tmp_results,
+                                         post_filter_topk, {});
     if (!status.ok()) {
-      DINGO_LOG(ERROR) << status.error_cstr();
       return status;
     }
 
-#if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
+    bool is_enough = true;
+    for (auto& tmp_result : tmp_results) {
+      pb::index::VectorWithDistanceResult result;
+      for (auto& vector_with_distance : *tmp_result.mutable_vector_with_distances()) {
+        if (result.vector_with_distances_size() >= topk) {
+          break;
+        }
+        if (vector_ids->Contains(vector_with_distance.vector_with_id().id())) {
+          result.add_vector_with_distances()->Swap(&vector_with_distance);
+        }
+      }
+      is_enough = is_enough && result.vector_with_distances_size() >= std::min(static_cast<int64_t>(topk),
+                                                                                 candidate_count);
+      vector_with_distance_results.push_back(std::move(result));
+    }
+
+    if (is_enough) {
+      VectorFilterPlanner::RecordPlan(plan);
+      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_scalar_speed_up_detail) << fmt::format(
+          "[vector_index.filter_planner][index_id({})] plan: {} candidate_count: {} total_count: {} topk: {}",
+          vector_index->Id(), VectorFilterPlanner::PlanName(plan), candidate_count, total_count, post_filter_topk);
+      return butil::Status::OK();
+    }
+
+    // oversample not get enough matched result, search again with index filter.
+    vector_with_distance_results.clear();
+    plan = VectorFilterPlan::kIndexFilter;
   }
-#endif
 
-  return butil::Status::OK();
+  VectorFilterPlanner::RecordPlan(plan);
+  DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_scalar_speed_up_detail) << fmt::format(
+      "[vector_index.filter_planner][index_id({})] plan: {} candidate_count: {} total_count: {} topk: {}",
+      vector_index->Id(), VectorFilterPlanner::PlanName(plan), candidate_count, total_count, topk);
+
+  if (plan == VectorFilterPlan::kBruteForce) {
+    return BruteForceSearchByIds(vector_index, vector_with_ids, topk, region_range, vector_ids->ToVector(),
+                                 !parameter.without_vector_data(), parameter, vector_with_distance_results);
+  }
+
+  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters;
+  filters.push_back(std::make_shared<VectorIndex::BitmapFilterFunctor>(vector_ids));
+
+  return SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids, parameter,
+                                     vector_with_distance_results, topk, filters);
 }
 
 #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
 class InVectorUseDocumentSearchTask : public TaskRunnable {
  public:
   InVectorUseDocumentSearchTask(BthreadCondPtr cond, DocumentIndexWrapperPtr document_index_wrapper,
-                                const std::string& query_string,
+                                const std::string& query_string, uint32_t top_n,
                                 std::vector<pb::common::DocumentWithScore>& document_results, butil::Status& status,
                                 const pb::common::Range& region_range, std::string job_id, const std::string& trace)
       : cond_(cond),
         document_index_wrapper_(document_index_wrapper),
         query_string_(query_string),
+        top_n_(top_n),
         document_results_(document_results),
         status_(status),
         region_range_(region_range),
@@ -1007,14 +1386,14 @@ class InVectorUseDocumentSearchTask : public TaskRunnable {
 
   void Run() override {
     pb::common::DocumentSearchParameter document_search_parameter;
-    document_search_parameter.set_top_n(0);  // for all
+    document_search_parameter.set_top_n(top_n_);  // 0 is for all
     document_search_parameter.set_query_string(query_string_);
     // document_ids ignore
     // column_names ignore
     document_search_parameter.set_without_scalar_data(true);
     // selected_keys ignore
     document_search_parameter.set_without_table_data(true);  // must be true. else crash.
-    document_search_parameter.set_query_unlimited(true);     // for all
+    document_search_parameter.set_query_unlimited(top_n_ == 0);
 
     status_ = document_index_wrapper_->Search(region_range_, document_search_parameter, document_results_);
     if (!status_.ok()) {
@@ -1037,6 +1416,7 @@ class InVectorUseDocumentSearchTask : public TaskRunnable {
   BthreadCondPtr cond_;
   DocumentIndexWrapperPtr document_index_wrapper_;
   std::string query_string_;
+  uint32_t top_n_;
   std::vector<pb::common::DocumentWithScore>& document_results_;
   pb::common::Range region_range_;
   butil::Status& status_;
@@ -1046,21 +1426,67 @@ class InVectorUseDocumentSearchTask : public TaskRunnable {
   int64_t start_time_;
 };
 
-butil::Status VectorReader::DoVectorSearchForScalarPreFilterWithDocument(
-    VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
-    const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
-    const pb::common::ScalarSchema& /*scalar_schema*/,
-    std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results) {
-  butil::Status status;
+// Get ids of documents hit by query string as filter of vector search.
+class InVectorUseDocumentIdFilterTask : public TaskRunnable {
+ public:
+  InVectorUseDocumentIdFilterTask(BthreadCondPtr cond, DocumentIndexWrapperPtr document_index_wrapper,
+                                  const std::string& query_string, VectorIdBitmapPtr& document_ids,
+                                  butil::Status& status, const pb::common::Range& region_range, std::string job_id,
+                                  const std::string& trace)
+      : cond_(cond),
+        document_index_wrapper_(document_index_wrapper),
+        query_string_(query_string),
+        document_ids_(document_ids),
+        region_range_(region_range),
+        status_(status),
+        job_id_(job_id),
+        trace_(trace) {
+    start_time_ = Helper::TimestampMs();
+  }
+  ~InVectorUseDocumentIdFilterTask() override = default;
 
-  const std::string& query_string = parameter.query_string();
-  if (query_string.empty()) {
-    std::string s = fmt::format("Region: {} parameter.query_string() empty not support", vector_index->Id());
+  std::string Type() override { return "VECTOR_PRE_FILTER_USE_DOCUMENT_ID_FILTER"; }
+
+  void Run() override {
+    status_ = document_index_wrapper_->SearchAllIds(region_range_, query_string_, document_ids_);
+    if (!status_.ok()) {
+      DINGO_LOG(ERROR) << status_.error_cstr() << " " << Trace();
+    } else {
+      DINGO_LOG(DEBUG) << fmt::format("Document id filter use document index success, region_id: {}, count: {}. {}",
+                                      document_index_wrapper_->Id(), document_ids_->Cardinality(), Trace());
+    }
+    cond_->DecreaseSignal();
+  }
+
+  std::string Trace() override {
+    return fmt::format("[document_index.search][id({}).start_time({}).job_id({})] {}", document_index_wrapper_->Id(),
+                       Helper::FormatMsTime(start_time_), job_id_, trace_);
+  }
+
+ private:
+  BthreadCondPtr cond_;
+  DocumentIndexWrapperPtr document_index_wrapper_;
+  std::string query_string_;
+  VectorIdBitmapPtr& document_ids_;
+  pb::common::Range region_range_;
+  butil::Status& status_;
+
+  std::string job_id_;
+  std::string trace_;
+  int64_t start_time_;
+};
+
+// document index of vector region, used for scalar speed up and hybrid search.
+static butil::Status GetDocumentIndexOfVectorRegion(int64_t region_id, store::RegionPtr& region,
+                                                    DocumentIndexWrapperPtr& document_index_wrapper,
+                                                    DocumentIndexManagerPtr& document_index_manager) {
+  region = Server::GetInstance().GetRegion(region_id);
+  if (region == nullptr) {
+    std::string s = fmt::format("Region: {} not found", region_id);
     DINGO_LOG(ERROR) << s;
-    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, s);
+    return butil::Status(pb::error::Errno::EREGION_NOT_FOUND, s);
   }
 
-  store::RegionPtr region = Server::GetInstance().GetRegion(vector_index->Id());
   const pb::common::RegionDefinition& definition = region->Definition();
   bool enable_scalar_speed_up_with_document =
       definition.index_parameter().vector_index_parameter().enable_scalar_speed_up_with_document();
@@ -1070,7 +1496,7 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilterWithDocument(
     return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, s);
   }
 
-  DocumentIndexWrapperPtr document_index_wrapper = region->DocumentIndexWrapper();
+  document_index_wrapper = region->DocumentIndexWrapper();
   if (document_index_wrapper == nullptr) {
     std::string s = fmt::format("Region: {} document index not exist", region->Id());
     DINGO_LOG(ERROR) << s;
@@ -1084,7 +1510,7 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilterWithDocument(
     return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, s);
   }
 
-  DocumentIndexManagerPtr document_index_manager = Server::GetInstance().GetDocumentIndexManager();
+  document_index_manager = Server::GetInstance().GetDocumentIndexManager();
   if (document_index_manager == nullptr) {
     std::string s = fmt::format("Region: {} . DocumentIndexManager not exist", region->Id());
     DINGO_LOG(ERROR) << s;
@@ -1099,15 +1525,40 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilterWithDocument(
     return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, s);
   }
 
-  std::vector<pb::common::DocumentWithScore> document_results;
+  return butil::Status::OK();
+}
+
+butil::Status VectorReader::DoVectorSearchForScalarPreFilterWithDocument(
+    VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
+    const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
+    const pb::common::ScalarSchema& /*scalar_schema*/,
+    std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results) {
+  butil::Status status;
+
+  const std::string& query_string = parameter.query_string();
+  if (query_string.empty()) {
+    std::string s = fmt::format("Region: {} parameter.query_string() empty not support", vector_index->Id());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, s);
+  }
+
+  store::RegionPtr region;
+  DocumentIndexWrapperPtr document_index_wrapper;
+  DocumentIndexManagerPtr document_index_manager;
+  status = GetDocumentIndexOfVectorRegion(vector_index->Id(), region, document_index_wrapper, document_index_manager);
+  if (!status.ok()) {
+    return status;
+  }
+
+  VectorIdBitmapPtr document_ids;
 
   // default not use flow control
   if (FLAGS_vector_index_uses_document_to_enable_flow_control) {
     BthreadCondPtr cond = std::make_shared<BthreadCond>();
     std::string job_id = UUIDGenerator::GenerateUUID();
-    std::string trace = fmt::format("{}-{}", job_id, "in vector use document search task");
-    std::shared_ptr<InVectorUseDocumentSearchTask> task = std::make_shared<InVectorUseDocumentSearchTask>(
-        cond, document_index_wrapper, query_string, document_results, status, region_range, job_id, trace);
+    std::string trace = fmt::format("{}-{}", job_id, "in vector use document id filter task");
+    auto task = std::make_shared<InVectorUseDocumentIdFilterTask>(cond, document_index_wrapper, query_string,
+                                                                  document_ids, status, region_range, job_id, trace);
 
     if (!document_index_manager->ExecuteTaskVectorScalarSearch(region->Id(), task)) {
       std::string s =
@@ -1117,36 +1568,18 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilterWithDocument(
     }
 
     cond->IncreaseWait();
-
-    if (!status.ok()) {
-      DINGO_LOG(ERROR) << status.error_cstr();
-      return status;
-    }
   } else {
-    pb::common::DocumentSearchParameter document_search_parameter;
-    document_search_parameter.set_top_n(0);  // for all
-    document_search_parameter.set_query_string(query_string);
-    // document_ids ignore
-    // column_names ignore
-    document_search_parameter.set_without_scalar_data(true);
-    // selected_keys ignore
-    document_search_parameter.set_without_table_data(true);  // must be true. else crash.
-    document_search_parameter.set_query_unlimited(true);     // for all
-
-    status = document_index_wrapper->Search(region_range, document_search_parameter, document_results);
-    if (!status.ok()) {
-      DINGO_LOG(ERROR) << status.error_cstr();
-      return status;
-    }
+    status = document_index_wrapper->SearchAllIds(region_range, query_string, document_ids);
   }
 
-  std::vector<int64_t> vector_ids;
-  vector_ids.reserve(document_results.size());
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
 
-  for (const auto& document_with_score : document_results) {
-    vector_ids.push_back(document_with_score.document_with_id().id());
-    if (FLAGS_vector_index_uses_document_print_document) {
-      int64_t document_id = document_with_score.document_with_id().id();
+  if (FLAGS_vector_index_uses_document_print_document) {
+    std::vector<int64_t> print_document_ids = document_ids->ToVector();
+    for (int64_t document_id : print_document_ids) {
       auto partition_id = region->PartitionId();
       std::string plain_key =
           VectorCodec::PackageVectorKey(Helper::GetKeyPrefix(region_range), partition_id, document_id);
@@ -1163,25 +1596,100 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilterWithDocument(
         return butil::Status(pb::error::EINTERNAL, "Parse proto from string error");
       }
 
-      DINGO_LOG(INFO) << fmt::format("Document id: {} score: {} ", document_with_score.document_with_id().id(),
-                                     document.DebugString());
+      DINGO_LOG(INFO) << fmt::format("Document id: {} document: {} ", document_id, document.DebugString());
     }
   }
 
-  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters;
-  status = VectorReader::SetVectorIndexIdsFilter(false, false, vector_ids, filters);
+  // document ids is shared with cache, search with it as bitmap filter without copy.
+  status = SearchWithScalarPreFilterIds(vector_index, region_range, vector_with_ids, parameter, document_ids,
+                                        vector_with_distance_results);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
   }
 
-  status = VectorReader::SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids, parameter,
-                                                     vector_with_distance_results, parameter.top_n(), filters);
+  return butil::Status::OK();
+}
+
+butil::Status VectorReader::DoVectorSearchForHybridWithDocument(
+    VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
+    const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
+    std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results) {
+  int64_t start_time = Helper::TimestampUs();
+  butil::Status status;
+
+  const std::string& query_string = parameter.query_string();
+  if (query_string.empty()) {
+    std::string s = fmt::format("Region: {} parameter.query_string() empty not support", vector_index->Id());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, s);
+  }
+
+  store::RegionPtr region;
+  DocumentIndexWrapperPtr document_index_wrapper;
+  DocumentIndexManagerPtr document_index_manager;
+  status = GetDocumentIndexOfVectorRegion(vector_index->Id(), region, document_index_wrapper, document_index_manager);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // range search result count is unknown, fuse all.
+  uint32_t top_n = parameter.enable_range_search() ? 0 : parameter.top_n();
+
+  std::vector<pb::common::DocumentWithScore> document_results;
+  butil::Status document_status;
+  std::vector<pb::index::VectorWithDistanceResult> vector_results;
+
+  if (FLAGS_vector_index_uses_document_to_enable_flow_control) {
+    // bm25 search at document worker, vector search at current bthread meanwhile.
+    BthreadCondPtr cond = std::make_shared<BthreadCond>();
+    std::string job_id = UUIDGenerator::GenerateUUID();
+    std::string trace = fmt::format("{}-{}", job_id, "in vector hybrid document search task");
+    auto task = std::make_shared<InVectorUseDocumentSearchTask>(cond, document_index_wrapper, query_string, top_n,
+                                                                document_results, document_status, region_range,
+                                                                job_id, trace);
+    if (!document_index_manager->ExecuteTaskVectorScalarSearch(region->Id(), task)) {
+      std::string s =
+          fmt::format("Region: {} . DocumentIndexManager ExecuteTaskVectorScalarSearch failed", region->Id());
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::Errno::EDOCUMENT_INDEX_FULL, s);
+    }
+
+    status = VectorReader::SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids, parameter,
+                                                       vector_results, parameter.top_n(), {});
+    // task reference local result, must wait it finish.
+    cond->IncreaseWait();
+  } else {
+    pb::common::DocumentSearchParameter document_search_parameter;
+    document_search_parameter.set_top_n(top_n);
+    document_search_parameter.set_query_string(query_string);
+    document_search_parameter.set_without_scalar_data(true);
+    document_search_parameter.set_without_table_data(true);  // must be true. else crash.
+    document_search_parameter.set_query_unlimited(top_n == 0);
+    document_status = document_index_wrapper->Search(region_range, document_search_parameter, document_results);
+
+    status = VectorReader::SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids, parameter,
+                                                       vector_results, parameter.top_n(), {});
+  }
+
+  if (!document_status.ok()) {
+    DINGO_LOG(ERROR) << document_status.error_cstr();
+    return document_status;
+  }
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
   }
 
+  vector_with_distance_results.reserve(vector_results.size());
+  for (const auto& vector_result : vector_results) {
+    pb::index::VectorWithDistanceResult fused_result;
+    VectorHybridFusion::Fuse(vector_result, document_results, top_n, fused_result);
+    vector_with_distance_results.push_back(std::move(fused_result));
+  }
+
+  g_vector_hybrid_search_latency << Helper::TimestampUs() - start_time;
+
   return butil::Status::OK();
 }
 #endif  // #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
@@ -1205,7 +1713,7 @@ bool VectorReader::ScalarCompareCore(const pb::common::VectorScalardata& std_vec
 butil::Status VectorReader::InternalVectorSearchForScalarPreFilterWithScalarCF(
     pb::common::Range region_range, bool use_coprocessor, const std::shared_ptr<RawCoprocessor>& scalar_coprocessor,
     const pb::common::VectorScalardata& std_vector_scalar,
-    std::vector<int64_t>& vector_ids) {  // NOLINT
+    VectorIdBitmap& vector_ids) {  // NOLINT
   // scalar pre filter search
   butil::Status status;
 
@@ -1225,8 +1733,8 @@ butil::Status VectorReader::InternalVectorSearchForScalarPreFilterWithScalarCF(
 
   for (iter->Seek(encode_range.start_key()); iter->Valid(); iter->Next()) {
     pb::common::VectorScalardata internal_vector_scalar;
-    std::string value(mvcc::Codec::UnPackageValue(iter->Value()));
-    CHECK(internal_vector_scalar.ParseFromString(value)) << "Parse vector scalar data error.";
+    auto value = mvcc::Codec::UnPackageValue(iter->Value());
+    CHECK(internal_vector_scalar.ParseFromArray(value.data(), value.size())) << "Parse vector scalar data error.";
 
     bool compare_result = use_coprocessor ? ScalarCompareWithCoprocessorCore(scalar_coprocessor, internal_vector_scalar)
                                           : ScalarCompareCore(std_vector_scalar, internal_vector_scalar);
@@ -1235,7 +1743,7 @@ butil::Status VectorReader::InternalVectorSearchForScalarPreFilterWithScalarCF(
       std::string key(iter->Key());
       int64_t internal_vector_id = VectorCodec::DecodeVectorIdFromEncodeKeyWithTs(key);
       CHECK(internal_vector_id > 0) << fmt::format("decode vector id failed key: {}", Helper::StringToHex(key));
-      vector_ids.push_back(internal_vector_id);
+      vector_ids.Add(internal_vector_id);
     }
   }
 
@@ -1257,7 +1765,7 @@ bool VectorReader::ScalarCompareWithCoprocessorCore(
 butil::Status VectorReader::InternalVectorSearchForScalarPreFilterWithScalarKeySpeedUpCF(
     pb::common::Range region_range, const std::set<std::string>& compare_keys, bool use_coprocessor,
     const std::shared_ptr<RawCoprocessor>& scalar_coprocessor, const pb::common::VectorScalardata& std_vector_scalar,
-    std::vector<int64_t>& vector_ids) {  // NOLINT
+    VectorIdBitmap& vector_ids) {  // NOLINT
   auto encode_range = mvcc::Codec::EncodeRange(region_range);
 
   IteratorOptions options;
@@ -1278,7 +1786,7 @@ butil::Status VectorReader::InternalVectorSearchForScalarPreFilterWithScalarKeyS
                               ? this->ScalarCompareWithCoprocessorCore(scalar_coprocessor, internal_vector_scalar)
                               : this->ScalarCompareCore(std_vector_scalar, internal_vector_scalar);
     if (compare_result) {
-      vector_ids.push_back(last_vector_id);
+      vector_ids.Add(last_vector_id);
     }
 
     internal_vector_scalar.Clear();
@@ -1302,8 +1810,8 @@ butil::Status VectorReader::InternalVectorSearchForScalarPreFilterWithScalarKeyS
 
     if (compare_keys.find(scalar_key) != compare_keys.end()) {
       pb::common::ScalarValue scalar_value;
-      std::string value(mvcc::Codec::UnPackageValue(iter->Value()));
-      CHECK(scalar_value.ParseFromString(value)) << "Parse vector scalar data error.";
+      auto value = mvcc::Codec::UnPackageValue(iter->Value());
+      CHECK(scalar_value.ParseFromArray(value.data(), value.size())) << "Parse vector scalar data error.";
 
       internal_vector_scalar.mutable_scalar_data()->insert({scalar_key, scalar_value});
     }
@@ -1384,8 +1892,8 @@ butil::Status VectorReader::DoVectorSearchForTableCoprocessor(  // NOLINT(*stati
   vector_ids.reserve(1024);
   for (iter->Seek(encode_range.start_key()); iter->Valid(); iter->Next()) {
     pb::common::VectorTableData internal_vector_table;
-    std::string value(mvcc::Codec::UnPackageValue(iter->Value()));
-    CHECK(internal_vector_table.ParseFromString(value)) << "Parse vector table data error.";
+    auto value = mvcc::Codec::UnPackageValue(iter->Value());
+    CHECK(internal_vector_table.ParseFromArray(value.data(), value.size())) << "Parse vector table data error.";
 
     bool compare_result = lambda_table_compare_with_coprocessor_function(internal_vector_table);
     if (compare_result) {
@@ -1731,8 +2239,8 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilterDebug(
   vector_ids.reserve(1024);
   for (iter->Seek(encode_range.start_key()); iter->Valid(); iter->Next()) {
     pb::common::VectorScalardata internal_vector_scalar;
-    std::string value(mvcc::Codec::UnPackageValue(iter->Value()));
-    CHECK(internal_vector_scalar.ParseFromString(value)) << "Parse vector scalar data error.";
+    auto value = mvcc::Codec::UnPackageValue(iter->Value());
+    CHECK(internal_vector_scalar.ParseFromArray(value.data(), value.size())) << "Parse vector scalar data error.";
 
 #if !defined(ENABLE_SCALAR_WITH_COPROCESSOR)
     bool compare_result = lambda_scalar_compare_function(internal_vector_scalar);
@@ -1924,10 +2432,10 @@ butil::Status VectorReader::BruteForceSearch(VectorIndexWrapperPtr vector_index,
     auto vector_id = VectorCodec::DecodeVectorIdFromEncodeKeyWithTs(key);
     CHECK(vector_id > 0) << fmt::format("vector_id({}) is invaild", vector_id);
 
-    std::string value(mvcc::Codec::UnPackageValue(iter->Value()));
+    auto value = mvcc::Codec::UnPackageValue(iter->Value());
 
     pb::common::Vector vector;
-    CHECK(vector.ParseFromString(value)) << "Parse vector proto error";
+    CHECK(vector.ParseFromArray(value.data(), value.size())) << "Parse vector proto error";
 
     pb::common::VectorWithId vector_with_id;
     vector_with_id.mutable_vector()->Swap(&vector);
@@ -2047,6 +2555,123 @@ butil::Status VectorReader::BruteForceSearch(VectorIndexWrapperPtr vector_index,
   return butil::Status::OK();
 }
 
+// Read matched candidate vectors by id from raw engine, build flat index by batch and search
+butil::Status VectorReader::BruteForceSearchByIds(VectorIndexWrapperPtr vector_index,
+                                                  const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                                  uint32_t topk, const pb::common::Range& region_range,
+                                                  const std::vector<int64_t>& vector_ids, bool reconstruct,
+                                                  const pb::common::VectorSearchParameter& parameter,
+                                                  std::vector<pb::index::VectorWithDistanceResult>& results) {
+  if (!vector_index->IsReady()) {
+    DINGO_LOG(WARNING) << fmt::format("[vector_index.wrapper][index_id({})] vector index is not ready.",
+                                      vector_index->Id());
+    return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, "vector index %lu is not ready.", vector_index->Id());
+  }
+
+  auto dimension = vector_index->GetDimension();
+  if (dimension <= 0) {
+    std::string s =
+        fmt::format("This is bug. Subsequent complete repair vector index dimension({}) is invalid", dimension);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EVECTOR_INVALID, s);
+  }
+
+  pb::common::RegionEpoch epoch;
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.mutable_flat_parameter()->set_dimension(dimension);
+  index_parameter.mutable_flat_parameter()->set_metric_type(vector_index->GetMetricType());
+
+  BvarLatencyGuard bvar_guard(&g_bruteforce_search_latency);
+
+  int64_t partition_id = VectorCodec::UnPackagePartitionId(region_range.start_key());
+
+  // topk results
+  std::vector<std::priority_queue<DistanceResult>> top_results;
+  top_results.resize(vector_with_ids.size());
+
+  std::vector<pb::common::VectorWithId> vector_with_id_batch;
+  auto search_batch = [&]() -> butil::Status {
+    auto thread_pool = Server::GetInstance().GetVectorIndexThreadPool();
+    auto flat_index = VectorIndexFactory::NewFlat(INT64_MAX, index_parameter, epoch, region_range, thread_pool);
+    CHECK(flat_index != nullptr) << "flat_index is nullptr";
+
+    auto status = flat_index->AddByParallel(vector_with_id_batch);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("Add vector to flat index failed, error: {} {}", status.error_code(),
+                                      status.error_str());
+      return status;
+    }
+
+    std::vector<pb::index::VectorWithDistanceResult> results_batch;
+    status = flat_index->SearchByParallel(vector_with_ids, topk, {}, reconstruct, parameter, results_batch);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("Search vector index failed, error: {} {}", status.error_code(),
+                                      status.error_str());
+      return status;
+    }
+
+    CHECK(results_batch.size() == vector_with_ids.size());
+
+    for (int i = 0; i < results_batch.size(); i++) {
+      auto& top_result = top_results[i];
+      for (const auto& vector_with_distance : results_batch[i].vector_with_distances()) {
+        if (top_result.size() < topk) {
+          top_result.emplace(vector_with_distance.distance(), vector_with_distance);
+        } else if (top_result.top().distance > vector_with_distance.distance()) {
+          top_result.pop();
+          top_result.emplace(vector_with_distance.distance(), vector_with_distance);
+        }
+      }
+    }
+
+    vector_with_id_batch.clear();
+    return butil::Status::OK();
+  };
+
+  for (auto vector_id : vector_ids) {
+    pb::common::VectorWithId vector_with_id;
+    auto status = QueryVectorWithId(0, region_range, partition_id, vector_id, true, vector_with_id);
+    if (status.error_code() == pb::error::EKEY_NOT_FOUND) {
+      // scalar and vector data is not one snapshot, vector maybe deleted after scan scalar.
+      continue;
+    } else if (!status.ok()) {
+      return status;
+    }
+
+    vector_with_id_batch.push_back(std::move(vector_with_id));
+    if (vector_with_id_batch.size() == FLAGS_vector_index_bruteforce_batch_count) {
+      status = search_batch();
+      if (!status.ok()) {
+        return status;
+      }
+    }
+  }
+
+  if (!vector_with_id_batch.empty()) {
+    auto status = search_batch();
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  results.resize(top_results.size());
+  for (int i = 0; i < top_results.size(); i++) {
+    auto& top_result = top_results[i];
+
+    std::deque<pb::common::VectorWithDistance> vector_with_distances_deque;
+    while (!top_result.empty()) {
+      vector_with_distances_deque.emplace_front(top_result.top().vector_with_distance);
+      top_result.pop();
+    }
+
+    for (auto& vector_with_distance : vector_with_distances_deque) {
+      results[i].add_vector_with_distances()->Swap(&vector_with_distance);
+    }
+  }
+
+  return butil::Status::OK();
+}
+
 butil::Status VectorReader::BruteForceRangeSearch(VectorIndexWrapperPtr vector_index,
                                                   const std::vector<pb::common::VectorWithId>& vector_with_ids,
                                                   float radius, const pb::common::Range& region_range,
@@ -2088,10 +2713,10 @@ butil::Status VectorReader::BruteForceRangeSearch(VectorIndexWrapperPtr vector_i
     auto vector_id = VectorCodec::DecodeVectorIdFromEncodeKeyWithTs(key);
     CHECK(vector_id > 0) << fmt::format("vector_id({}) is invaild", vector_id);
 
-    std::string value(mvcc::Codec::UnPackageValue(iter->Value()));
+    auto value = mvcc::Codec::UnPackageValue(iter->Value());
 
     pb::common::Vector vector;
-    CHECK(vector.ParseFromString(value)) << "Parse vector proto error.";
+    CHECK(vector.ParseFromArray(value.data(), value.size())) << "Parse vector proto error.";
 
     pb::common::VectorWithId vector_with_id;
     vector_with_id.mutable_vector()->Swap(&vector);
@@ -31,6 +31,7 @@
 #include "mvcc/reader.h"
 #include "proto/common.pb.h"
 #include "proto/index.pb.h"
+#include "vector/vector_id_bitmap.h"
 
 namespace dingodb {
 
@@ -47,6 +48,10 @@ class VectorReader {
   butil::Status VectorBatchQuery(std::shared_ptr<Engine::VectorReader::Context> ctx,
                                  std::vector<pb::common::VectorWithId>& vector_with_ids);
 
+  // merge results of all query vectors to one ranked list of topk, distance is aggregated score.
+  static void AggregateMultiVectorResults(Engine::VectorReader::MultiVectorAggregation aggregation, uint32_t topk,
+                                          std::vector<pb::index::VectorWithDistanceResult>& results);
+
   butil::Status VectorGetBorderId(int64_t ts, const pb::common::Range& region_range, bool get_min, int64_t& vector_id);
 #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
   butil::Status VectorGetBorderIdForDocument(int64_t ts, const pb::common::Range& region_range, bool get_min,
@@ -123,6 +128,22 @@ class VectorReader {
   butil::Status QueryVectorTableData(int64_t ts, const pb::common::Range& region_range, int64_t partition_id,
                                      std::vector<pb::index::VectorWithDistanceResult>& results);
 
+  // fill data of many vector by one batch get of cf, instead of one get per vector.
+  butil::Status BatchQueryVectorData(int64_t ts, const pb::common::Range& region_range, int64_t partition_id,
+                                     const std::vector<int64_t>& vector_ids, bool with_vector_data,
+                                     std::vector<pb::common::VectorWithId>& vector_with_ids);
+  butil::Status BatchQueryVectorScalarData(int64_t ts, const pb::common::Range& region_range, int64_t partition_id,
+                                           const std::vector<std::string>& selected_scalar_keys,
+                                           const std::vector<pb::common::VectorWithId*>& vector_with_ids);
+  butil::Status BatchQueryVectorTableData(int64_t ts, const pb::common::Range& region_range, int64_t partition_id,
+                                          const std::vector<pb::common::VectorWithId*>& vector_with_ids);
+
+  // re-rank search results by distance of raw vector, keep topk.
+  butil::Status RefineSearchResults(int64_t ts, const pb::common::Range& region_range, int64_t partition_id,
+                                    pb::common::MetricType metric_type,
+                                    const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                                    std::vector<pb::index::VectorWithDistanceResult>& results);
+
   butil::Status GetBorderId(int64_t ts, const pb::common::Range& region_range, bool get_min, int64_t& vector_id);
 #if WITH_VECTOR_INDEX_USE_DOCUMENT_SPEEDUP
   butil::Status GetBorderIdForDocument(int64_t ts, const pb::common::Range& region_range, bool get_min,
@@ -148,6 +169,13 @@ class VectorReader {
       const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
       const pb::common::ScalarSchema& scalar_schema,
       std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results);
+
+  // Hybrid search, vector top-k and bm25 top-k of query_string run in parallel on same region,
+  // then fuse them into one ranked list, fused score is put into distance and larger is better.
+  butil::Status DoVectorSearchForHybridWithDocument(
+      VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
+      const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
+      std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results);
 #endif
 
   static bool ScalarCompareCore(const pb::common::VectorScalardata& std_vector_scalar,
@@ -156,7 +184,7 @@ class VectorReader {
   butil::Status InternalVectorSearchForScalarPreFilterWithScalarCF(
       pb::common::Range region_range, bool use_coprocessor, const std::shared_ptr<RawCoprocessor>& scalar_coprocessor,
       const pb::common::VectorScalardata& std_vector_scalar,
-      std::vector<int64_t>& vector_ids);  // NOLINT
+      VectorIdBitmap& vector_ids);  // NOLINT
 
   static bool ScalarCompareWithCoprocessorCore(const std::shared_ptr<RawCoprocessor>& scalar_coprocessor,
                                                const pb::common::VectorScalardata& internal_vector_scalar);
@@ -164,7 +192,7 @@ class VectorReader {
   butil::Status InternalVectorSearchForScalarPreFilterWithScalarKeySpeedUpCF(
       pb::common::Range region_range, const std::set<std::string>& compare_keys, bool use_coprocessor,
       const std::shared_ptr<RawCoprocessor>& scalar_coprocessor, const pb::common::VectorScalardata& std_vector_scalar,
-      std::vector<int64_t>& vector_ids);  // NOLINT
+      VectorIdBitmap& vector_ids);  // NOLINT
  private:
   butil::Status DoVectorSearchForTableCoprocessor(
       VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
@@ -210,6 +238,19 @@ class VectorReader {
                                  const pb::common::VectorSearchParameter& parameter,
                                  std::vector<pb::index::VectorWithDistanceResult>& results);
 
+  // choose plan by scalar filter selectivity and search with matched vector ids.
+  butil::Status SearchWithScalarPreFilterIds(
+      VectorIndexWrapperPtr vector_index, const pb::common::Range& region_range,
+      const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
+      VectorIdBitmapPtr vector_ids, std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results);
+
+  // brute force search only the vectors of vector_ids.
+  butil::Status BruteForceSearchByIds(VectorIndexWrapperPtr vector_index,
+                                      const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                                      const pb::common::Range& region_range, const std::vector<int64_t>& vector_ids,
+                                      bool reconstruct, const pb::common::VectorSearchParameter& parameter,
+                                      std::vector<pb::index::VectorWithDistanceResult>& results);
+
   butil::Status BruteForceRangeSearch(VectorIndexWrapperPtr vector_index,
                                       const std::vector<pb::common::VectorWithId>& vector_with_ids, float radius,
                                       const pb::common::Range& region_range,
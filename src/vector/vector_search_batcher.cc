@@ -0,0 +1,133 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_search_batcher.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "brpc/reloadable_flags.h"
+#include "bthread/bthread.h"
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "bvar/reducer.h"
+#include "common/gflag_validator.h"
+#include "common/synchronization.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_vector_search_batch, true, "enable coalesce concurrent vector search of same region");
+DEFINE_validator(enable_vector_search_batch, &PassBool);
+DEFINE_int64(vector_search_batch_window_us, 200, "vector search batch leader wait other search join window");
+BRPC_VALIDATE_GFLAG(vector_search_batch_window_us, brpc::NonNegativeInteger);
+DEFINE_int64(vector_search_batch_max_vector_count, 64, "vector search batch max vector count");
+BRPC_VALIDATE_GFLAG(vector_search_batch_max_vector_count, brpc::PositiveInteger);
+
+bvar::Adder<int64_t> g_vector_search_batch_count("dingo_vector_search_batch_count");
+bvar::Adder<int64_t> g_vector_search_batch_join_count("dingo_vector_search_batch_join_count");
+
+VectorSearchBatcher::VectorSearchBatcher() { bthread_mutex_init(&mutex_, nullptr); }
+
+VectorSearchBatcher::~VectorSearchBatcher() { bthread_mutex_destroy(&mutex_); }
+
+butil::Status VectorSearchBatcher::Search(const std::string& key,
+                                          const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                          SearchFunc search_func,
+                                          std::vector<pb::index::VectorWithDistanceResult>& results) {
+  int64_t in_flight_count = in_flight_count_.fetch_add(1) + 1;
+  DEFER(in_flight_count_.fetch_sub(1));
+
+  // no concurrent search, not batch to avoid wait window latency.
+  if (!FLAGS_enable_vector_search_batch || in_flight_count <= 1 ||
+      static_cast<int64_t>(vector_with_ids.size()) >= FLAGS_vector_search_batch_max_vector_count) {
+    return search_func(vector_with_ids, results);
+  }
+
+  BatchPtr batch;
+  bool is_leader = false;
+  size_t offset = 0;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = pending_batches_.find(key);
+    if (it != pending_batches_.end() &&
+        static_cast<int64_t>(it->second->vector_with_ids.size() + vector_with_ids.size()) <=
+            FLAGS_vector_search_batch_max_vector_count) {
+      // join collecting batch as follower
+      batch = it->second;
+      offset = batch->vector_with_ids.size();
+      batch->vector_with_ids.insert(batch->vector_with_ids.end(), vector_with_ids.begin(), vector_with_ids.end());
+    } else {
+      // become leader of new batch, the full batch is still searched by its leader
+      is_leader = true;
+      batch = std::make_shared<Batch>();
+      batch->vector_with_ids = vector_with_ids;
+      pending_batches_[key] = batch;
+    }
+  }
+
+  if (!is_leader) {
+    g_vector_search_batch_join_count << 1;
+    batch->done_event.wait();
+    if (!batch->status.ok()) {
+      return batch->status;
+    }
+
+    TakeResults(batch, offset, vector_with_ids.size(), results);
+    return butil::Status::OK();
+  }
+
+  // leader wait other search join
+  bthread_usleep(FLAGS_vector_search_batch_window_us);
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = pending_batches_.find(key);
+    if (it != pending_batches_.end() && it->second == batch) {
+      pending_batches_.erase(it);
+    }
+  }
+
+  g_vector_search_batch_count << 1;
+  batch->status = search_func(batch->vector_with_ids, batch->results);
+  if (batch->status.ok() && batch->results.size() != batch->vector_with_ids.size()) {
+    batch->status =
+        butil::Status(pb::error::EINTERNAL, fmt::format("batch search result size({}) not match vector size({})",
+                                                        batch->results.size(), batch->vector_with_ids.size()));
+  }
+
+  auto status = batch->status;
+  if (status.ok()) {
+    TakeResults(batch, 0, vector_with_ids.size(), results);
+  }
+  batch->done_event.signal();
+
+  return status;
+}
+
+void VectorSearchBatcher::TakeResults(BatchPtr batch, size_t offset, size_t count,
+                                      std::vector<pb::index::VectorWithDistanceResult>& results) {
+  // every search take its own range, so not conflict.
+  results.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    results[i].Swap(&batch->results[offset + i]);
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,75 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_SEARCH_BATCHER_H_
+#define DINGODB_VECTOR_SEARCH_BATCHER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bthread/countdown_event.h"
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+
+namespace dingodb {
+
+// Coalesce concurrent searches of one vector index which have same parameter into one batch search.
+// The first search of a batch is leader, it wait a short window for other searches to join only when
+// there are other searches in flight, then run the batch search and split results to every search.
+class VectorSearchBatcher {
+ public:
+  using SearchFunc = std::function<butil::Status(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                                 std::vector<pb::index::VectorWithDistanceResult>& results)>;
+
+  VectorSearchBatcher();
+  ~VectorSearchBatcher();
+
+  VectorSearchBatcher(const VectorSearchBatcher&) = delete;
+  VectorSearchBatcher& operator=(const VectorSearchBatcher&) = delete;
+
+  // key identify compatible search parameter, search_func is only called by leader.
+  butil::Status Search(const std::string& key, const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                       SearchFunc search_func, std::vector<pb::index::VectorWithDistanceResult>& results);
+
+ private:
+  struct Batch {
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    butil::Status status;
+    // leader signal when batch search finish
+    bthread::CountdownEvent done_event{1};
+  };
+  using BatchPtr = std::shared_ptr<Batch>;
+
+  static void TakeResults(BatchPtr batch, size_t offset, size_t count,
+                          std::vector<pb::index::VectorWithDistanceResult>& results);
+
+  std::atomic<int64_t> in_flight_count_{0};
+
+  bthread_mutex_t mutex_;
+  // key: collecting batch
+  std::map<std::string, BatchPtr> pending_batches_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_SEARCH_BATCHER_H_
@@ -0,0 +1,136 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_search_cache.h"
+
+#include <cstdint>
+#include <iterator>
+#include <string>
+
+#include "brpc/reloadable_flags.h"
+#include "bthread/mutex.h"
+#include "bvar/reducer.h"
+#include "common/gflag_validator.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_vector_search_cache, false, "enable cache search result of repeated vector query");
+DEFINE_validator(enable_vector_search_cache, &PassBool);
+DEFINE_int64(vector_search_cache_max_memory_bytes, 8 * 1024 * 1024, "vector search cache max memory of one region");
+BRPC_VALIDATE_GFLAG(vector_search_cache_max_memory_bytes, brpc::NonNegativeInteger);
+
+bvar::Adder<int64_t> g_vector_search_cache_hit_count("dingo_vector_search_cache_hit_count");
+bvar::Adder<int64_t> g_vector_search_cache_miss_count("dingo_vector_search_cache_miss_count");
+bvar::Adder<int64_t> g_vector_search_cache_memory_size("dingo_vector_search_cache_memory_size");
+
+VectorSearchCache::VectorSearchCache() { bthread_mutex_init(&mutex_, nullptr); }
+
+VectorSearchCache::~VectorSearchCache() {
+  g_vector_search_cache_memory_size << -memory_size_;
+  bthread_mutex_destroy(&mutex_);
+}
+
+std::string VectorSearchCache::GenKey(const pb::common::VectorWithId& vector_with_id, const std::string& param_key) {
+  std::string key = vector_with_id.vector().SerializeAsString();
+  key.append(param_key);
+  return key;
+}
+
+VectorSearchCache::Version VectorSearchCache::GetVersion(int64_t apply_log_id) const {
+  Version version;
+  version.apply_log_id = apply_log_id;
+  version.epoch = epoch_.load(std::memory_order_acquire);
+  return version;
+}
+
+bool VectorSearchCache::Get(const std::string& key, const Version& version,
+                            pb::index::VectorWithDistanceResult& result) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = entry_map_.find(key);
+  if (it == entry_map_.end()) {
+    g_vector_search_cache_miss_count << 1;
+    return false;
+  }
+
+  auto entry_it = it->second;
+  if (entry_it->version.apply_log_id != version.apply_log_id || entry_it->version.epoch != version.epoch) {
+    // stale entry will not be valid again
+    Erase(entry_it);
+    g_vector_search_cache_miss_count << 1;
+    return false;
+  }
+
+  entries_.splice(entries_.begin(), entries_, entry_it);
+  result = entry_it->result;
+  g_vector_search_cache_hit_count << 1;
+  return true;
+}
+
+void VectorSearchCache::Put(const std::string& key, const Version& version,
+                            const pb::index::VectorWithDistanceResult& result) {
+  // index is changed during search, the result may be stale.
+  if (version.epoch != epoch_.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  int64_t memory_size = key.size() * 2 + result.ByteSizeLong() + sizeof(Entry);
+  if (memory_size > FLAGS_vector_search_cache_max_memory_bytes) {
+    return;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = entry_map_.find(key);
+  if (it != entry_map_.end()) {
+    Erase(it->second);
+  }
+
+  entries_.push_front(Entry{key, version, result, memory_size});
+  entry_map_[key] = entries_.begin();
+  memory_size_ += memory_size;
+  g_vector_search_cache_memory_size << memory_size;
+
+  while (memory_size_ > FLAGS_vector_search_cache_max_memory_bytes && !entries_.empty()) {
+    Erase(std::prev(entries_.end()));
+  }
+}
+
+void VectorSearchCache::Invalidate() {
+  epoch_.fetch_add(1, std::memory_order_acq_rel);
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  g_vector_search_cache_memory_size << -memory_size_;
+  memory_size_ = 0;
+  entry_map_.clear();
+  entries_.clear();
+}
+
+int64_t VectorSearchCache::MemorySize() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return memory_size_;
+}
+
+int64_t VectorSearchCache::Size() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return entries_.size();
+}
+
+void VectorSearchCache::Erase(EntryList::iterator it) {
+  memory_size_ -= it->memory_size;
+  g_vector_search_cache_memory_size << -it->memory_size;
+  entry_map_.erase(it->key);
+  entries_.erase(it);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,84 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_SEARCH_CACHE_H_
+#define DINGODB_VECTOR_SEARCH_CACHE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "bthread/mutex.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+
+namespace dingodb {
+
+// LRU cache of search result of one vector index, bounded by memory.
+// Entry is valid only when apply log id and write epoch are same as when it is put, writer must call
+// Invalidate() after every write, so no stale result is returned for region without apply log id.
+class VectorSearchCache {
+ public:
+  struct Version {
+    int64_t apply_log_id{0};
+    int64_t epoch{0};
+  };
+
+  VectorSearchCache();
+  ~VectorSearchCache();
+
+  VectorSearchCache(const VectorSearchCache&) = delete;
+  VectorSearchCache& operator=(const VectorSearchCache&) = delete;
+
+  // key of one query vector, param_key identify search parameter, e.g. topk/reconstruct/range/parameter.
+  static std::string GenKey(const pb::common::VectorWithId& vector_with_id, const std::string& param_key);
+
+  // get version before search, put result with it after search.
+  Version GetVersion(int64_t apply_log_id) const;
+
+  bool Get(const std::string& key, const Version& version, pb::index::VectorWithDistanceResult& result);
+  void Put(const std::string& key, const Version& version, const pb::index::VectorWithDistanceResult& result);
+
+  // make all entries invalid.
+  void Invalidate();
+
+  int64_t MemorySize();
+  int64_t Size();
+
+ private:
+  struct Entry {
+    std::string key;
+    Version version;
+    pb::index::VectorWithDistanceResult result;
+    int64_t memory_size{0};
+  };
+  using EntryList = std::list<Entry>;
+
+  // caller hold mutex_
+  void Erase(EntryList::iterator it);
+
+  std::atomic<int64_t> epoch_{0};
+
+  bthread_mutex_t mutex_;
+  // front is most recently used
+  EntryList entries_;
+  std::unordered_map<std::string, EntryList::iterator> entry_map_;
+  int64_t memory_size_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_SEARCH_CACHE_H_
@@ -0,0 +1,82 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Micro benchmark of thread safe map under coordinator like read/write mix, e.g.
+// dingodb_vector_bench --benchmark_filter='BenchSafeMapMix.*' to compare DingoSafeMap and DingoShardedSafeMap.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+
+#include "common/safe_map.h"
+
+namespace dingodb {
+
+static const int64_t kKeyCount = 100000;
+
+template <typename MapType>
+static MapType& GetMap() {
+  static MapType* map = []() {
+    auto* map = new MapType();
+    map->Init(kKeyCount);
+    for (int64_t i = 0; i < kKeyCount; ++i) {
+      map->Put(i, i);
+    }
+    return map;
+  }();
+  return *map;
+}
+
+// range(0) is write percent of all operations, e.g. region map updated by heartbeat and read by route request.
+template <typename MapType>
+static void BenchSafeMapMix(benchmark::State& state) {
+  auto& map = GetMap<MapType>();
+  const int64_t write_percent = state.range(0);
+
+  std::mt19937_64 rng(state.thread_index());
+  std::uniform_int_distribution<int64_t> key_distrib(0, kKeyCount - 1);
+  std::uniform_int_distribution<int64_t> op_distrib(0, 99);
+
+  int64_t value = 0;
+  for (auto _ : state) {
+    int64_t key = key_distrib(rng);
+    if (op_distrib(rng) < write_percent) {
+      map.Put(key, key);
+    } else {
+      map.Get(key, value);
+      benchmark::DoNotOptimize(value);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+using DoublyBufferedMap = DingoSafeMap<int64_t, int64_t>;
+using ShardedMap = DingoShardedSafeMap<int64_t, int64_t>;
+
+BENCHMARK_TEMPLATE(BenchSafeMapMix, DoublyBufferedMap)
+    ->Arg(1)
+    ->Arg(10)
+    ->Arg(50)
+    ->Threads(1)
+    ->Threads(8);
+BENCHMARK_TEMPLATE(BenchSafeMapMix, ShardedMap)
+    ->Arg(1)
+    ->Arg(10)
+    ->Arg(50)
+    ->Threads(1)
+    ->Threads(8);
+
+}  // namespace dingodb
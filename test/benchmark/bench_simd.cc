@@ -0,0 +1,239 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Micro benchmark of simd kernels, every kernel is measured on every instruction set this cpu support,
+// e.g. dingodb_vector_bench --benchmark_filter='L2sqr/.*' to compare isa of one kernel.
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "simd/distances_ref.h"
+#include "simd/hook.h"
+
+#if defined(__x86_64__)
+#include "simd/distances_avx.h"
+#include "simd/distances_avx512.h"
+#include "simd/distances_avx512bf16.h"
+#include "simd/distances_sse.h"
+#endif
+
+#if defined(__aarch64__)
+#include "simd/distances_neon.h"
+#endif
+
+namespace dingodb {
+
+static const int kNy = 1024;
+
+static std::vector<float> GenData(size_t size, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> distrib(-1.0f, 1.0f);
+  std::vector<float> data(size);
+  for (auto& value : data) {
+    value = distrib(rng);
+  }
+  return data;
+}
+
+static bool IsaSupported(const std::string& isa) {
+#if defined(__x86_64__)
+  if (isa == "sse") return cpu_support_sse4_2();
+  if (isa == "avx") return cpu_support_avx2();
+  if (isa == "avx512") return cpu_support_avx512();
+  if (isa == "avx512bf16") return cpu_support_avx512_bf16();
+#endif
+  return isa == "ref" || isa == "hook" || isa == "neon";
+}
+
+// skip kernel of isa not supported by this cpu, return false if skipped.
+static bool CheckIsa(benchmark::State& state, const std::string& isa) {
+  if (!IsaSupported(isa)) {
+    state.SkipWithError(("cpu not support " + isa).c_str());
+    return false;
+  }
+  return true;
+}
+
+using DistanceFunc = float (*)(const float*, const float*, size_t);
+using NormFunc = float (*)(const float*, size_t);
+using DistanceNyFunc = void (*)(float*, const float*, const float*, size_t, size_t);
+using MaddFunc = void (*)(size_t, const float*, float, const float*, float*);
+using HalfDistanceFunc = float (*)(const uint16_t*, const uint16_t*, size_t);
+
+static void BenchDistance(benchmark::State& state, const std::string& isa, DistanceFunc func) {
+  if (!CheckIsa(state, isa)) return;
+  size_t d = state.range(0);
+  auto x = GenData(d, 1);
+  auto y = GenData(d, 2);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(func(x.data(), y.data(), d));
+  }
+  state.SetBytesProcessed(state.iterations() * d * sizeof(float) * 2);
+}
+
+static void BenchNorm(benchmark::State& state, const std::string& isa, NormFunc func) {
+  if (!CheckIsa(state, isa)) return;
+  size_t d = state.range(0);
+  auto x = GenData(d, 1);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(func(x.data(), d));
+  }
+  state.SetBytesProcessed(state.iterations() * d * sizeof(float));
+}
+
+// one query to kNy contiguous vectors, same as flat search.
+static void BenchDistanceNy(benchmark::State& state, const std::string& isa, DistanceNyFunc func) {
+  if (!CheckIsa(state, isa)) return;
+  size_t d = state.range(0);
+  auto x = GenData(d, 1);
+  auto y = GenData(d * kNy, 2);
+  std::vector<float> dis(kNy);
+
+  for (auto _ : state) {
+    func(dis.data(), x.data(), y.data(), d, kNy);
+    benchmark::DoNotOptimize(dis.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * d * kNy * sizeof(float));
+  state.SetItemsProcessed(state.iterations() * kNy);
+}
+
+static void BenchMadd(benchmark::State& state, const std::string& isa, MaddFunc func) {
+  if (!CheckIsa(state, isa)) return;
+  size_t d = state.range(0);
+  auto a = GenData(d, 1);
+  auto b = GenData(d, 2);
+  std::vector<float> c(d);
+
+  for (auto _ : state) {
+    func(d, a.data(), 0.5f, b.data(), c.data());
+    benchmark::DoNotOptimize(c.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * d * sizeof(float) * 3);
+}
+
+static void BenchHalfDistance(benchmark::State& state, const std::string& isa, HalfDistanceFunc func,
+                              uint16_t (*encode)(float)) {
+  if (!CheckIsa(state, isa)) return;
+  size_t d = state.range(0);
+  auto x = GenData(d, 1);
+  auto y = GenData(d, 2);
+  std::vector<uint16_t> x_code(d), y_code(d);
+  for (size_t i = 0; i < d; ++i) {
+    x_code[i] = encode(x[i]);
+    y_code[i] = encode(y[i]);
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(func(x_code.data(), y_code.data(), d));
+  }
+  state.SetBytesProcessed(state.iterations() * d * sizeof(uint16_t) * 2);
+}
+
+// dimension of common embedding model, and a odd one for tail handling.
+#define DINGO_BENCH_DIMENSIONS ->Arg(33)->Arg(128)->Arg(384)->Arg(768)->Arg(1536)
+
+#define DINGO_BENCH_KERNEL(bench, name, isa, func) \
+  BENCHMARK_CAPTURE(bench, name##_##isa, #isa, func) DINGO_BENCH_DIMENSIONS
+
+#define DINGO_BENCH_HALF_KERNEL(name, isa, func, encode) \
+  BENCHMARK_CAPTURE(BenchHalfDistance, name##_##isa, #isa, func, encode) DINGO_BENCH_DIMENSIONS
+
+// hooked kernel, it is what index actually use. Hook pointer is read at run time, it is not set yet when
+// benchmark is registered by static initialization.
+static float HookL2sqr(const float* x, const float* y, size_t d) { return fvec_L2sqr(x, y, d); }
+static float HookInnerProduct(const float* x, const float* y, size_t d) { return fvec_inner_product(x, y, d); }
+static void HookL2sqrNy(float* dis, const float* x, const float* y, size_t d, size_t ny) {
+  fvec_L2sqr_ny(dis, x, y, d, ny);
+}
+static void HookInnerProductsNy(float* ip, const float* x, const float* y, size_t d, size_t ny) {
+  fvec_inner_products_ny(ip, x, y, d, ny);
+}
+
+DINGO_BENCH_KERNEL(BenchDistance, L2sqr, hook, HookL2sqr);
+DINGO_BENCH_KERNEL(BenchDistance, InnerProduct, hook, HookInnerProduct);
+DINGO_BENCH_KERNEL(BenchDistanceNy, L2sqrNy, hook, HookL2sqrNy);
+DINGO_BENCH_KERNEL(BenchDistanceNy, InnerProductsNy, hook, HookInnerProductsNy);
+
+DINGO_BENCH_KERNEL(BenchDistance, L2sqr, ref, fvec_L2sqr_ref);
+DINGO_BENCH_KERNEL(BenchDistance, InnerProduct, ref, fvec_inner_product_ref);
+DINGO_BENCH_KERNEL(BenchDistance, L1, ref, fvec_L1_ref);
+DINGO_BENCH_KERNEL(BenchDistance, Linf, ref, fvec_Linf_ref);
+DINGO_BENCH_KERNEL(BenchNorm, NormL2sqr, ref, fvec_norm_L2sqr_ref);
+DINGO_BENCH_KERNEL(BenchDistanceNy, L2sqrNy, ref, fvec_L2sqr_ny_ref);
+DINGO_BENCH_KERNEL(BenchDistanceNy, InnerProductsNy, ref, fvec_inner_products_ny_ref);
+DINGO_BENCH_KERNEL(BenchMadd, Madd, ref, fvec_madd_ref);
+DINGO_BENCH_HALF_KERNEL(L2sqrFp16, ref, fvec_L2sqr_fp16_ref, fp32_to_fp16_ref);
+DINGO_BENCH_HALF_KERNEL(InnerProductFp16, ref, fvec_inner_product_fp16_ref, fp32_to_fp16_ref);
+DINGO_BENCH_HALF_KERNEL(L2sqrBf16, ref, fvec_L2sqr_bf16_ref, fp32_to_bf16_ref);
+DINGO_BENCH_HALF_KERNEL(InnerProductBf16, ref, fvec_inner_product_bf16_ref, fp32_to_bf16_ref);
+
+#if defined(__x86_64__)
+DINGO_BENCH_KERNEL(BenchDistance, L2sqr, sse, fvec_L2sqr_sse);
+DINGO_BENCH_KERNEL(BenchDistance, InnerProduct, sse, fvec_inner_product_sse);
+DINGO_BENCH_KERNEL(BenchDistance, L1, sse, fvec_L1_sse);
+DINGO_BENCH_KERNEL(BenchDistance, Linf, sse, fvec_Linf_sse);
+DINGO_BENCH_KERNEL(BenchNorm, NormL2sqr, sse, fvec_norm_L2sqr_sse);
+DINGO_BENCH_KERNEL(BenchDistanceNy, L2sqrNy, sse, fvec_L2sqr_ny_sse);
+DINGO_BENCH_KERNEL(BenchDistanceNy, InnerProductsNy, sse, fvec_inner_products_ny_sse);
+DINGO_BENCH_KERNEL(BenchMadd, Madd, sse, fvec_madd_sse);
+
+DINGO_BENCH_KERNEL(BenchDistance, L2sqr, avx, fvec_L2sqr_avx);
+DINGO_BENCH_KERNEL(BenchDistance, InnerProduct, avx, fvec_inner_product_avx);
+DINGO_BENCH_KERNEL(BenchDistance, L1, avx, fvec_L1_avx);
+DINGO_BENCH_KERNEL(BenchDistance, Linf, avx, fvec_Linf_avx);
+DINGO_BENCH_KERNEL(BenchDistanceNy, L2sqrNy, avx, fvec_L2sqr_ny_avx);
+DINGO_BENCH_KERNEL(BenchDistanceNy, InnerProductsNy, avx, fvec_inner_products_ny_avx);
+DINGO_BENCH_HALF_KERNEL(L2sqrFp16, avx, fvec_L2sqr_fp16_avx, fp32_to_fp16_ref);
+DINGO_BENCH_HALF_KERNEL(InnerProductFp16, avx, fvec_inner_product_fp16_avx, fp32_to_fp16_ref);
+DINGO_BENCH_HALF_KERNEL(L2sqrBf16, avx, fvec_L2sqr_bf16_avx, fp32_to_bf16_ref);
+DINGO_BENCH_HALF_KERNEL(InnerProductBf16, avx, fvec_inner_product_bf16_avx, fp32_to_bf16_ref);
+
+DINGO_BENCH_KERNEL(BenchDistance, L2sqr, avx512, fvec_L2sqr_avx512);
+DINGO_BENCH_KERNEL(BenchDistance, InnerProduct, avx512, fvec_inner_product_avx512);
+DINGO_BENCH_KERNEL(BenchDistance, L1, avx512, fvec_L1_avx512);
+DINGO_BENCH_KERNEL(BenchDistance, Linf, avx512, fvec_Linf_avx512);
+DINGO_BENCH_KERNEL(BenchDistanceNy, L2sqrNy, avx512, fvec_L2sqr_ny_avx512);
+DINGO_BENCH_KERNEL(BenchDistanceNy, InnerProductsNy, avx512, fvec_inner_products_ny_avx512);
+DINGO_BENCH_HALF_KERNEL(L2sqrFp16, avx512, fvec_L2sqr_fp16_avx512, fp32_to_fp16_ref);
+DINGO_BENCH_HALF_KERNEL(InnerProductFp16, avx512, fvec_inner_product_fp16_avx512, fp32_to_fp16_ref);
+DINGO_BENCH_HALF_KERNEL(L2sqrBf16, avx512, fvec_L2sqr_bf16_avx512, fp32_to_bf16_ref);
+DINGO_BENCH_HALF_KERNEL(InnerProductBf16, avx512, fvec_inner_product_bf16_avx512, fp32_to_bf16_ref);
+DINGO_BENCH_HALF_KERNEL(InnerProductBf16, avx512bf16, fvec_inner_product_bf16_avx512bf16, fp32_to_bf16_ref);
+#endif
+
+#if defined(__aarch64__)
+DINGO_BENCH_KERNEL(BenchDistance, L2sqr, neon, fvec_L2sqr_neon);
+DINGO_BENCH_KERNEL(BenchDistance, InnerProduct, neon, fvec_inner_product_neon);
+DINGO_BENCH_KERNEL(BenchDistance, L1, neon, fvec_L1_neon);
+DINGO_BENCH_KERNEL(BenchDistance, Linf, neon, fvec_Linf_neon);
+DINGO_BENCH_KERNEL(BenchNorm, NormL2sqr, neon, fvec_norm_L2sqr_neon);
+DINGO_BENCH_KERNEL(BenchDistanceNy, L2sqrNy, neon, fvec_L2sqr_ny_neon);
+DINGO_BENCH_KERNEL(BenchDistanceNy, InnerProductsNy, neon, fvec_inner_products_ny_neon);
+DINGO_BENCH_KERNEL(BenchMadd, Madd, neon, fvec_madd_neon);
+DINGO_BENCH_HALF_KERNEL(L2sqrFp16, neon, fvec_L2sqr_fp16_neon, fp32_to_fp16_ref);
+DINGO_BENCH_HALF_KERNEL(InnerProductFp16, neon, fvec_inner_product_fp16_neon, fp32_to_fp16_ref);
+DINGO_BENCH_HALF_KERNEL(L2sqrBf16, neon, fvec_L2sqr_bf16_neon, fp32_to_bf16_ref);
+DINGO_BENCH_HALF_KERNEL(InnerProductBf16, neon, fvec_inner_product_bf16_neon, fp32_to_bf16_ref);
+#endif
+
+}  // namespace dingodb
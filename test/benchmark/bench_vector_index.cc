@@ -0,0 +1,201 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// End to end add and search benchmark of vector index, arguments are dimension and vector count,
+// e.g. dingodb_vector_bench --benchmark_filter='Search/Hnsw.*'.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "common/threadpool.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index.h"
+#include "vector/vector_index_factory.h"
+
+namespace dingodb {
+
+static const int kTopk = 10;
+static const int kQueryCount = 100;
+static const int kNcentroids = 256;
+
+enum class IndexType {
+  kFlat,
+  kIvfFlat,
+  kIvfPq,
+  kHnsw,
+};
+
+static ThreadPoolPtr GetThreadPool() {
+  static ThreadPoolPtr thread_pool = std::make_shared<ThreadPool>("vector_bench", 4);
+  return thread_pool;
+}
+
+static std::vector<pb::common::VectorWithId> GenVectorWithIds(int64_t start_id, int64_t count, int dimension) {
+  std::mt19937 rng(start_id);
+  std::uniform_real_distribution<float> distrib(0.0f, 1.0f);
+
+  std::vector<pb::common::VectorWithId> vector_with_ids(count);
+  for (int64_t i = 0; i < count; ++i) {
+    auto& vector_with_id = vector_with_ids[i];
+    vector_with_id.set_id(start_id + i);
+    vector_with_id.mutable_vector()->set_dimension(dimension);
+    vector_with_id.mutable_vector()->set_value_type(pb::common::ValueType::FLOAT);
+    for (int j = 0; j < dimension; ++j) {
+      vector_with_id.mutable_vector()->add_float_values(distrib(rng));
+    }
+  }
+  return vector_with_ids;
+}
+
+static std::shared_ptr<VectorIndex> NewIndex(IndexType index_type, int dimension, int64_t count) {
+  static const pb::common::Range kRange;
+  pb::common::RegionEpoch epoch;
+  epoch.set_conf_version(1);
+  epoch.set_version(1);
+
+  const auto metric_type = pb::common::MetricType::METRIC_TYPE_L2;
+  pb::common::VectorIndexParameter index_parameter;
+  switch (index_type) {
+    case IndexType::kFlat:
+      index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT);
+      index_parameter.mutable_flat_parameter()->set_dimension(dimension);
+      index_parameter.mutable_flat_parameter()->set_metric_type(metric_type);
+      return VectorIndexFactory::NewFlat(1, index_parameter, epoch, kRange, GetThreadPool());
+    case IndexType::kIvfFlat:
+      index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_FLAT);
+      index_parameter.mutable_ivf_flat_parameter()->set_dimension(dimension);
+      index_parameter.mutable_ivf_flat_parameter()->set_metric_type(metric_type);
+      index_parameter.mutable_ivf_flat_parameter()->set_ncentroids(kNcentroids);
+      return VectorIndexFactory::NewIvfFlat(1, index_parameter, epoch, kRange, GetThreadPool());
+    case IndexType::kIvfPq:
+      index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ);
+      index_parameter.mutable_ivf_pq_parameter()->set_dimension(dimension);
+      index_parameter.mutable_ivf_pq_parameter()->set_metric_type(metric_type);
+      index_parameter.mutable_ivf_pq_parameter()->set_ncentroids(kNcentroids);
+      index_parameter.mutable_ivf_pq_parameter()->set_nsubvector(dimension / 8);
+      index_parameter.mutable_ivf_pq_parameter()->set_nbits_per_idx(8);
+      return VectorIndexFactory::NewIvfPq(1, index_parameter, epoch, kRange, GetThreadPool());
+    case IndexType::kHnsw:
+      index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW);
+      index_parameter.mutable_hnsw_parameter()->set_dimension(dimension);
+      index_parameter.mutable_hnsw_parameter()->set_metric_type(metric_type);
+      index_parameter.mutable_hnsw_parameter()->set_efconstruction(200);
+      index_parameter.mutable_hnsw_parameter()->set_max_elements(count);
+      index_parameter.mutable_hnsw_parameter()->set_nlinks(32);
+      return VectorIndexFactory::NewHnsw(1, index_parameter, epoch, kRange, GetThreadPool());
+  }
+  return nullptr;
+}
+
+// new index, train it if need, return nullptr if failed.
+static std::shared_ptr<VectorIndex> PrepareIndex(benchmark::State& state, IndexType index_type, int dimension,
+                                                 int64_t count, const std::vector<pb::common::VectorWithId>& data) {
+  auto vector_index = NewIndex(index_type, dimension, count);
+  if (vector_index == nullptr) {
+    state.SkipWithError("new vector index failed");
+    return nullptr;
+  }
+
+  if (vector_index->NeedTrain()) {
+    auto status = vector_index->Train(data);
+    if (!status.ok()) {
+      state.SkipWithError(("train failed, " + status.error_str()).c_str());
+      return nullptr;
+    }
+  }
+  return vector_index;
+}
+
+static void BenchAdd(benchmark::State& state, IndexType index_type) {
+  int dimension = state.range(0);
+  int64_t count = state.range(1);
+  auto data = GenVectorWithIds(1, count, dimension);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto vector_index = PrepareIndex(state, index_type, dimension, count, data);
+    if (vector_index == nullptr) {
+      return;
+    }
+    state.ResumeTiming();
+
+    auto status = vector_index->Add(data);
+    if (!status.ok()) {
+      state.SkipWithError(("add failed, " + status.error_str()).c_str());
+      return;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void BenchSearch(benchmark::State& state, IndexType index_type) {
+  int dimension = state.range(0);
+  int64_t count = state.range(1);
+  auto data = GenVectorWithIds(1, count, dimension);
+  auto vector_index = PrepareIndex(state, index_type, dimension, count, data);
+  if (vector_index == nullptr) {
+    return;
+  }
+  auto status = vector_index->Add(data);
+  if (!status.ok()) {
+    state.SkipWithError(("add failed, " + status.error_str()).c_str());
+    return;
+  }
+
+  auto queries = GenVectorWithIds(count + 1, kQueryCount, dimension);
+  pb::common::VectorSearchParameter parameter;
+  if (index_type == IndexType::kIvfFlat) {
+    parameter.mutable_ivf_flat()->set_nprobe(16);
+  } else if (index_type == IndexType::kIvfPq) {
+    parameter.mutable_ivf_pq()->set_nprobe(16);
+  } else if (index_type == IndexType::kHnsw) {
+    parameter.mutable_hnsw()->set_efsearch(64);
+  }
+
+  // one query a search, same as most client request.
+  int64_t query_index = 0;
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  for (auto _ : state) {
+    results.clear();
+    status = vector_index->Search({queries[query_index++ % kQueryCount]}, kTopk, {}, false, parameter, results);
+    if (!status.ok()) {
+      state.SkipWithError(("search failed, " + status.error_str()).c_str());
+      return;
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// {dimension, vector count}
+#define DINGO_BENCH_INDEX_ARGS ->ArgsProduct({{128, 768}, {10000, 100000}})->Unit(benchmark::kMillisecond)
+
+BENCHMARK_CAPTURE(BenchAdd, Flat, IndexType::kFlat) DINGO_BENCH_INDEX_ARGS;
+BENCHMARK_CAPTURE(BenchAdd, IvfFlat, IndexType::kIvfFlat) DINGO_BENCH_INDEX_ARGS;
+BENCHMARK_CAPTURE(BenchAdd, IvfPq, IndexType::kIvfPq) DINGO_BENCH_INDEX_ARGS;
+BENCHMARK_CAPTURE(BenchAdd, Hnsw, IndexType::kHnsw) DINGO_BENCH_INDEX_ARGS;
+
+BENCHMARK_CAPTURE(BenchSearch, Flat, IndexType::kFlat) DINGO_BENCH_INDEX_ARGS;
+BENCHMARK_CAPTURE(BenchSearch, IvfFlat, IndexType::kIvfFlat) DINGO_BENCH_INDEX_ARGS;
+BENCHMARK_CAPTURE(BenchSearch, IvfPq, IndexType::kIvfPq) DINGO_BENCH_INDEX_ARGS;
+BENCHMARK_CAPTURE(BenchSearch, Hnsw, IndexType::kHnsw) DINGO_BENCH_INDEX_ARGS;
+
+}  // namespace dingodb
@@ -0,0 +1,104 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_PERF_ENGINE_H_
+#define DINGODB_PERF_ENGINE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/role.h"
+#include "config/config.h"
+#include "config/config_manager.h"
+#include "config/yaml_config.h"
+#include "engine/bdb_raw_engine.h"
+#include "engine/mono_store_engine.h"
+#include "engine/rocks_raw_engine.h"
+#include "event/store_state_machine_event.h"
+#include "fmt/core.h"
+#include "glog/logging.h"
+#include "meta/store_meta_manager.h"
+#include "mvcc/ts_provider.h"
+
+namespace dingodb {
+
+// Local store engine shared by perf tests, RocksRawEngine and MonoStoreEngine under ./perf_test, same as unit test.
+// Data is kept between benchmarks of one run, every benchmark use its own key prefix and region.
+class PerfEngine {
+ public:
+  static PerfEngine& GetInstance() {
+    static PerfEngine* instance = new PerfEngine();
+    return *instance;
+  }
+
+  std::shared_ptr<RocksRawEngine> RawEngine() { return raw_engine_; }
+  std::shared_ptr<MonoStoreEngine> MonoEngine() { return mono_engine_; }
+
+  store::RegionPtr NewRegion(int64_t region_id) {
+    auto region = store::Region::New(region_id);
+    region->SetState(pb::common::StoreRegionState::NORMAL);
+    mono_engine_->GetStoreMetaManager()->GetStoreRegionMeta()->AddRegion(region);
+    mono_engine_->GetStoreMetricsManager()->GetStoreRegionMetrics()->AddMetrics(
+        StoreRegionMetrics::NewMetrics(region->Id()));
+    return region;
+  }
+
+ private:
+  PerfEngine() {
+    const std::string root_path = "./perf_test";
+    Helper::RemoveAllFileOrDirectory(root_path);
+    Helper::CreateDirectories(root_path + "/db");
+
+    std::string yaml_config = fmt::format(
+        "cluster:\n  name: dingodb\n  instance_id: 12345\n  coordinators: 127.0.0.1:19190\n"
+        "server:\n  host: 127.0.0.1\n  port: 23000\nlog:\n  path: {0}/log\nstore:\n  path: {0}/db\n",
+        root_path);
+    std::shared_ptr<Config> config = std::make_shared<YamlConfig>();
+    CHECK(config->Load(yaml_config) == 0) << "load perf test config failed";
+    SetRole("store");
+    ConfigManager::GetInstance().Register(GetRoleName(), config);
+
+    raw_engine_ = std::make_shared<RocksRawEngine>();
+    CHECK(raw_engine_->Init(config, {Constant::kTxnWriteCF, Constant::kTxnDataCF, Constant::kTxnLockCF, "default",
+                                     Constant::kStoreMetaCF}))
+        << "init rocks raw engine failed";
+
+    auto ts_provider = mvcc::TsProvider::New(nullptr);
+    CHECK(ts_provider->Init()) << "init ts provider failed";
+
+    auto meta_reader = std::make_shared<MetaReader>(raw_engine_);
+    auto meta_writer = std::make_shared<MetaWriter>(raw_engine_);
+    auto store_meta_manager = std::make_shared<StoreMetaManager>(meta_reader, meta_writer);
+    CHECK(store_meta_manager->Init()) << "init store meta manager failed";
+    auto store_metrics_manager = std::make_shared<StoreMetricsManager>(meta_reader, meta_writer);
+    CHECK(store_metrics_manager->Init()) << "init store metrics manager failed";
+
+    mono_engine_ = std::make_shared<MonoStoreEngine>(raw_engine_, std::make_shared<BdbRawEngine>(),
+                                                     std::make_shared<StoreSmEventListenerFactory>()->Build(),
+                                                     ts_provider, store_meta_manager, store_metrics_manager);
+    CHECK(mono_engine_->Init(config)) << "init mono store engine failed";
+  }
+
+  std::shared_ptr<RocksRawEngine> raw_engine_;
+  std::shared_ptr<MonoStoreEngine> mono_engine_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_PERF_ENGINE_H_
@@ -0,0 +1,76 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Micro benchmark of mvcc key/value codec on the read and write path, argument is plain key length,
+// e.g. dingodb_perf_test --benchmark_filter='BenchMvccCodec.*' --benchmark_format=json.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+
+#include "common/helper.h"
+#include "mvcc/codec.h"
+
+namespace dingodb {
+
+static const int64_t kTs = 1702966356362LL << 18;
+
+static void BenchMvccCodecEncodeKey(benchmark::State& state) {
+  std::string plain_key = Helper::GenerateRandomString(state.range(0));
+  std::string encode_key;
+  for (auto _ : state) {
+    encode_key.clear();
+    mvcc::Codec::EncodeKey(plain_key, kTs, encode_key);
+    benchmark::DoNotOptimize(encode_key);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * plain_key.size());
+}
+
+static void BenchMvccCodecDecodeKey(benchmark::State& state) {
+  std::string encode_key = mvcc::Codec::EncodeKey(Helper::GenerateRandomString(state.range(0)), kTs);
+  std::string plain_key;
+  int64_t ts = 0;
+  for (auto _ : state) {
+    plain_key.clear();
+    mvcc::Codec::DecodeKey(encode_key, plain_key, ts);
+    benchmark::DoNotOptimize(plain_key);
+    benchmark::DoNotOptimize(ts);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * encode_key.size());
+}
+
+static void BenchMvccCodecPackageValue(benchmark::State& state) {
+  std::string value = Helper::GenerateRandomString(state.range(0));
+  std::string output;
+  for (auto _ : state) {
+    output.clear();
+    mvcc::Codec::PackageValue(mvcc::ValueFlag::kPut, value, output);
+    benchmark::DoNotOptimize(mvcc::Codec::UnPackageValue(output));
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * value.size());
+}
+
+BENCHMARK(BenchMvccCodecEncodeKey)->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK(BenchMvccCodecDecodeKey)->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK(BenchMvccCodecPackageValue)->Arg(64)->Arg(1024);
+
+}  // namespace dingodb
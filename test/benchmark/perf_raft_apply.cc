@@ -0,0 +1,95 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Benchmark of follower raft apply of put log on a local RocksRawEngine: parse raft command from log data and run
+// the put apply handler, which is what StoreStateMachine::on_apply do for every log, braft itself is not included.
+// Argument is kv count of one log, e.g. dingodb_perf_test --benchmark_filter='BenchRaftApply.*'.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "butil/iobuf.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "engine/write_data.h"
+#include "fmt/core.h"
+#include "handler/raft_apply_handler.h"
+#include "mvcc/codec.h"
+#include "perf_engine.h"
+#include "proto/raft.pb.h"
+
+namespace dingodb {
+
+static const int64_t kRegionId = 1002;
+static const int kValueSize = 256;
+
+// log data of one put command, keys differ by log index so every apply write new keys.
+static butil::IOBuf GenPutLog(int64_t log_index, int64_t kv_count, const std::string& value) {
+  PutDatum datum;
+  datum.cf_name = Constant::kStoreDataCF;
+  for (int64_t i = 0; i < kv_count; ++i) {
+    pb::common::KeyValue kv;
+    kv.set_key(fmt::format("perf_apply_{:012}_{:06}", log_index, i));
+    kv.set_value(value);
+    datum.kvs.push_back(mvcc::Codec::EncodeKeyValueWithPut(log_index, kv));
+  }
+
+  pb::raft::RaftCmdRequest raft_cmd;
+  raft_cmd.mutable_header()->set_region_id(kRegionId);
+  raft_cmd.mutable_requests()->AddAllocated(datum.TransformToRaft());
+
+  butil::IOBuf data;
+  {
+    butil::IOBufAsZeroCopyOutputStream wrapper(&data);
+    raft_cmd.SerializeToZeroCopyStream(&wrapper);
+  }
+  return data;
+}
+
+static void BenchRaftApplyPut(benchmark::State& state) {
+  static store::RegionPtr region = PerfEngine::GetInstance().NewRegion(kRegionId);
+  auto raw_engine = PerfEngine::GetInstance().RawEngine();
+  auto handler = RaftApplyHandlerFactory().Build()->GetHandler(HandlerType::kPut);
+  std::string value = Helper::GenerateRandomString(kValueSize);
+
+  static int64_t log_index = 0;
+  int64_t log_bytes = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto data = GenPutLog(++log_index, state.range(0), value);
+    log_bytes += data.size();
+    state.ResumeTiming();
+
+    auto raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
+    butil::IOBufAsZeroCopyInputStream wrapper(data);
+    if (!raft_cmd->ParseFromZeroCopyStream(&wrapper)) {
+      state.SkipWithError("parse raft cmd failed");
+      break;
+    }
+    for (const auto& request : raft_cmd->requests()) {
+      handler->Handle(nullptr, region, raw_engine, request, nullptr, 1, log_index);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(log_bytes);
+}
+
+BENCHMARK(BenchRaftApplyPut)->Arg(1)->Arg(16)->Arg(256);
+
+}  // namespace dingodb
@@ -0,0 +1,207 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Benchmark of txn read/write path on a local RocksRawEngine, argument is key count of one op,
+// e.g. dingodb_perf_test --benchmark_filter='BenchTxn.*' --benchmark_out=txn.json --benchmark_out_format=json.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "common/constant.h"
+#include "common/context.h"
+#include "common/helper.h"
+#include "common/stream.h"
+#include "engine/txn_engine_helper.h"
+#include "fmt/core.h"
+#include "glog/logging.h"
+#include "perf_engine.h"
+#include "proto/common.pb.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+static const int64_t kRegionId = 1001;
+static const int64_t kKeyCount = 100000;
+static const int kValueSize = 256;
+static const std::string kKeyPrefix = "perf_txn_";
+
+static std::string GenTxnKey(int64_t id) { return fmt::format("{}{:010}", kKeyPrefix, id); }
+
+// fake tso, physical part is real time so lock ttl is valid.
+static int64_t NextTs() {
+  static std::atomic<int64_t> ts{Helper::TimestampMs() << 18};
+  return ts.fetch_add(1) + 1;
+}
+
+static butil::Status PrewriteAndCommit(store::RegionPtr region, const std::vector<std::string>& keys,
+                                       const std::string& value, bool try_one_pc) {
+  auto& perf_engine = PerfEngine::GetInstance();
+
+  std::vector<pb::store::Mutation> mutations;
+  for (const auto& key : keys) {
+    auto& mutation = mutations.emplace_back();
+    mutation.set_op(pb::store::Op::Put);
+    mutation.set_key(key);
+    mutation.set_value(value);
+  }
+
+  int64_t start_ts = NextTs();
+  pb::store::TxnPrewriteResponse prewrite_response;
+  auto ctx = std::make_shared<Context>();
+  ctx->SetRegionId(region->Id());
+  ctx->SetCfName(Constant::kStoreDataCF);
+  ctx->SetResponse(&prewrite_response);
+  auto status = TxnEngineHelper::Prewrite(perf_engine.RawEngine(), perf_engine.MonoEngine(), ctx, region, mutations,
+                                          keys.front(), start_ts, Helper::TimestampMs() + 60000, keys.size(),
+                                          try_one_pc, 0, 0, {}, {}, {}, {});
+  if (!status.ok() || prewrite_response.one_pc_commit_ts() > 0) {
+    return status;
+  }
+
+  pb::store::TxnCommitResponse commit_response;
+  ctx = std::make_shared<Context>();
+  ctx->SetRegionId(region->Id());
+  ctx->SetCfName(Constant::kStoreDataCF);
+  ctx->SetResponse(&commit_response);
+  return TxnEngineHelper::Commit(perf_engine.RawEngine(), perf_engine.MonoEngine(), ctx, region, start_ts, NextTs(),
+                                 keys);
+}
+
+// region with kKeyCount committed keys, loaded once for all read benchmarks.
+static store::RegionPtr GetLoadedRegion() {
+  static store::RegionPtr region = []() {
+    auto region = PerfEngine::GetInstance().NewRegion(kRegionId);
+    std::string value = Helper::GenerateRandomString(kValueSize);
+    for (int64_t i = 0; i < kKeyCount; i += 1000) {
+      std::vector<std::string> keys;
+      for (int64_t j = i; j < std::min(i + 1000, kKeyCount); ++j) {
+        keys.push_back(GenTxnKey(j));
+      }
+      auto status = PrewriteAndCommit(region, keys, value, false);
+      CHECK(status.ok()) << "load txn data failed, " << status.error_str();
+    }
+    return region;
+  }();
+  return region;
+}
+
+// range(0) is key count of one txn, range(1) is try one pc.
+static void BenchTxnPrewriteCommit(benchmark::State& state) {
+  auto region = GetLoadedRegion();
+  std::string value = Helper::GenerateRandomString(kValueSize);
+  int64_t next_id = 0;
+  for (auto _ : state) {
+    std::vector<std::string> keys;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      keys.push_back(GenTxnKey(next_id++ % kKeyCount));
+    }
+    auto status = PrewriteAndCommit(region, keys, value, state.range(1) != 0);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BenchTxnBatchGet(benchmark::State& state) {
+  GetLoadedRegion();
+  int64_t next_id = 0;
+  for (auto _ : state) {
+    std::vector<std::string> keys;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      keys.push_back(GenTxnKey((next_id += 7919) % kKeyCount));
+    }
+    pb::store::TxnResultInfo txn_result_info;
+    std::vector<pb::common::KeyValue> kvs;
+    auto status = TxnEngineHelper::BatchGet(PerfEngine::GetInstance().RawEngine(),
+                                            pb::store::IsolationLevel::SnapshotIsolation, NextTs(), keys, {},
+                                            txn_result_info, kvs);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+    benchmark::DoNotOptimize(kvs);
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// count of all rows by CoprocessorV2, same as dingodb_cli TxnCount.
+static pb::common::CoprocessorV2 GenCountCoprocessor() {
+  pb::common::CoprocessorV2 coprocessor;
+  coprocessor.set_schema_version(1);
+  coprocessor.set_codec_version(2);
+  coprocessor.set_for_agg_count(true);
+  coprocessor.set_rel_expr(std::string{static_cast<char>(0x74), static_cast<char>(0x01), static_cast<char>(0x10)});
+  coprocessor.add_selection_columns(0);
+
+  coprocessor.mutable_original_schema()->set_common_id(1);
+  auto* original_schema = coprocessor.mutable_original_schema()->add_schema();
+  original_schema->set_type(pb::common::Schema::Type::Schema_Type_INTEGER);
+  original_schema->set_is_key(true);
+  original_schema->set_index(0);
+
+  coprocessor.mutable_result_schema()->set_common_id(1);
+  auto* result_schema = coprocessor.mutable_result_schema()->add_schema();
+  result_schema->set_type(pb::common::Schema::Type::Schema_Type_LONG);
+  result_schema->set_index(0);
+  return coprocessor;
+}
+
+// range(0) is scan limit, range(1) is scan by count coprocessor.
+static void BenchTxnScan(benchmark::State& state) {
+  GetLoadedRegion();
+  bool with_coprocessor = state.range(1) != 0;
+  auto coprocessor = with_coprocessor ? GenCountCoprocessor() : pb::common::CoprocessorV2();
+
+  int64_t next_id = 0;
+  for (auto _ : state) {
+    int64_t start_id = (next_id += 7919) % (kKeyCount - state.range(0));
+    pb::common::Range range;
+    range.set_start_key(GenTxnKey(start_id));
+    range.set_end_key(GenTxnKey(start_id + state.range(0)));
+
+    pb::store::TxnResultInfo txn_result_info;
+    std::vector<pb::common::KeyValue> kvs;
+    bool has_more = false;
+    std::string end_scan_key;
+    auto status = TxnEngineHelper::Scan(Stream::New(10000000), PerfEngine::GetInstance().RawEngine(),
+                                        pb::store::IsolationLevel::SnapshotIsolation, NextTs(), range, state.range(0),
+                                        false, false, {}, !with_coprocessor, coprocessor, txn_result_info, kvs,
+                                        has_more, end_scan_key);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+    benchmark::DoNotOptimize(kvs);
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BenchTxnPrewriteCommit)->Args({1, 0})->Args({1, 1})->Args({16, 0})->Args({16, 1})->Args({256, 1});
+BENCHMARK(BenchTxnBatchGet)->Arg(1)->Arg(16)->Arg(256);
+BENCHMARK(BenchTxnScan)->Args({10, 0})->Args({1000, 0})->Args({10000, 0})->Args({1000, 1})->Args({10000, 1});
+
+}  // namespace dingodb
@@ -0,0 +1,77 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "br/restore_store_limiter.h"
+
+class BrRestoreStoreLimiterTest : public testing::Test {
+ protected:
+  static const int64_t kMb = 1024 * 1024;
+};
+
+TEST_F(BrRestoreStoreLimiterTest, AcquireUpToLimit) {
+  br::RestoreStoreLimiter limiter(2, 4, 2.0);
+
+  EXPECT_TRUE(limiter.Acquire(1));
+  EXPECT_TRUE(limiter.Acquire(1));
+  EXPECT_FALSE(limiter.Acquire(1));
+  EXPECT_DOUBLE_EQ(1.0, limiter.Load(1));
+
+  // other store has own slots
+  EXPECT_TRUE(limiter.Acquire(2));
+
+  limiter.Release(1, 100, kMb, true);
+  EXPECT_TRUE(limiter.Acquire(1));
+}
+
+TEST_F(BrRestoreStoreLimiterTest, AdditiveIncrease) {
+  br::RestoreStoreLimiter limiter(2, 3, 2.0);
+
+  // one more slot after a window of fast restores, never above max.
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(limiter.Acquire(1));
+    limiter.Release(1, 100, kMb, true);
+  }
+  EXPECT_EQ(3, limiter.GetLimit(1));
+}
+
+TEST_F(BrRestoreStoreLimiterTest, MultiplicativeDecrease) {
+  br::RestoreStoreLimiter limiter(4, 8, 2.0);
+
+  ASSERT_TRUE(limiter.Acquire(1));
+  limiter.Release(1, 100, 10 * kMb, true);
+  EXPECT_EQ(4, limiter.GetLimit(1));
+
+  // same size, much slower
+  ASSERT_TRUE(limiter.Acquire(1));
+  limiter.Release(1, 1000, 10 * kMb, true);
+  EXPECT_EQ(2, limiter.GetLimit(1));
+
+  // larger region is not slow when cost per mb is same
+  ASSERT_TRUE(limiter.Acquire(1));
+  limiter.Release(1, 2000, 100 * kMb, true);
+  EXPECT_EQ(2, limiter.GetLimit(1));
+
+  ASSERT_TRUE(limiter.Acquire(1));
+  limiter.Release(1, 10, kMb, false);
+  EXPECT_EQ(1, limiter.GetLimit(1));
+
+  ASSERT_TRUE(limiter.Acquire(1));
+  limiter.Release(1, 10, kMb, false);
+  EXPECT_EQ(1, limiter.GetLimit(1));
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "br/tool_utils.h"
+#include "fmt/core.h"
+
+class BrToolUtilsTest : public testing::Test {};
+
+TEST_F(BrToolUtilsTest, SplitKeyRange) {
+  std::string start_key = std::string("t") + std::string(8, '\x00');
+  std::string end_key = std::string("t") + std::string(8, '\xff');
+
+  auto split_keys = br::ToolUtils::SplitKeyRange(start_key, end_key, 4);
+  ASSERT_EQ(3, split_keys.size());
+  EXPECT_LT(start_key, split_keys[0]);
+  EXPECT_LT(split_keys[0], split_keys[1]);
+  EXPECT_LT(split_keys[1], split_keys[2]);
+  EXPECT_LT(split_keys[2], end_key);
+  // common prefix is kept
+  EXPECT_EQ('t', split_keys[1][0]);
+  EXPECT_EQ('\x7f', split_keys[1][1]);
+
+  // range too small or invalid to split
+  EXPECT_TRUE(br::ToolUtils::SplitKeyRange("a", "a", 4).empty());
+  EXPECT_TRUE(br::ToolUtils::SplitKeyRange("b", "a", 4).empty());
+  EXPECT_TRUE(br::ToolUtils::SplitKeyRange(start_key, end_key, 1).empty());
+}
+
+TEST_F(BrToolUtilsTest, KvBriefMerge) {
+  br::KvBrief kv_brief;
+  br::KvBrief part_kv_brief1;
+  br::KvBrief part_kv_brief2;
+  for (int i = 0; i < 20; ++i) {
+    std::string key = fmt::format("key{:02}", i);
+    kv_brief.Add(key, "value");
+    (i < 2 ? part_kv_brief1 : part_kv_brief2).Add(key, "value");
+  }
+
+  br::KvBrief merged_kv_brief;
+  merged_kv_brief.Merge(part_kv_brief1);
+  merged_kv_brief.Merge(part_kv_brief2);
+
+  EXPECT_EQ(20, merged_kv_brief.Count());
+  EXPECT_EQ(kv_brief.ToString(), merged_kv_brief.ToString());
+}
@@ -0,0 +1,47 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "common/cycle_clock.h"
+#include "common/helper.h"
+
+namespace dingodb {
+
+class CycleClockTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() { CycleClock::Init(); }
+};
+
+TEST_F(CycleClockTest, NowNs) {
+  // anchored at wall clock, allow small calibration error.
+  EXPECT_NEAR(Helper::TimestampNs(), CycleClock::NowNs(), 5 * 1000 * 1000);
+}
+
+TEST_F(CycleClockTest, Elapsed) {
+  uint64_t start_cycles = CycleClock::Now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  int64_t elapsed_us = CycleClock::CyclesToUs(CycleClock::Now() - start_cycles);
+
+  EXPECT_GE(elapsed_us, 45 * 1000);
+  EXPECT_LE(elapsed_us, 100 * 1000);
+  EXPECT_GT(CycleClock::NsPerCycle(), 0.0);
+}
+
+}  // namespace dingodb
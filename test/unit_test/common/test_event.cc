@@ -0,0 +1,110 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+
+#include "event/event.h"
+#include "fmt/core.h"
+
+namespace dingodb {
+
+struct TestApplyEvent : public Event {
+  TestApplyEvent() : Event(EventSource::kRaftStateMachine, EventType::kSmApply) {}
+  ~TestApplyEvent() override = default;
+
+  int64_t log_id{0};
+};
+
+class TestApplyEventListener : public EventListener {
+ public:
+  TestApplyEventListener() = default;
+  ~TestApplyEventListener() override = default;
+
+  EventType GetType() override { return EventType::kSmApply; }
+  int OnEvent(std::shared_ptr<Event> event) override {
+    return Apply(*std::dynamic_pointer_cast<TestApplyEvent>(event));
+  }
+  int Apply(const TestApplyEvent& event) {
+    sum_ += event.log_id;
+    return 0;
+  }
+
+  int64_t Sum() const { return sum_; }
+
+ private:
+  int64_t sum_{0};
+};
+
+class EventTest : public testing::Test {};
+
+TEST_F(EventTest, ListenerCollection) {
+  EventListenerCollection listeners;
+  EXPECT_TRUE(listeners.Get(EventType::kSmApply).empty());
+
+  auto listener = std::make_shared<TestApplyEventListener>();
+  listeners.Register(listener);
+  const auto& chain = listeners.Get(EventType::kSmApply);
+  ASSERT_EQ(1, chain.size());
+  EXPECT_EQ(listener->GetID(), chain[0]->GetID());
+  EXPECT_TRUE(listeners.Get(EventType::kSmBatchApply).empty());
+
+  auto event = std::make_shared<TestApplyEvent>();
+  event->log_id = 10;
+  EXPECT_EQ(0, chain[0]->OnEvent(event));
+  EXPECT_EQ(0, listener->Apply(*event));
+  EXPECT_EQ(20, listener->Sum());
+}
+
+// Old apply loop allocate event and dispatch it by virtual call for each log entry,
+// new apply loop reuse event and call the built-in listener directly.
+TEST_F(EventTest, ApplyLoopBenchmark) {
+  GTEST_SKIP() << "Performence test, skip...";
+
+  const int64_t kTimes = 10 * 1000 * 1000;
+  auto listeners = std::make_shared<EventListenerCollection>();
+  auto listener = std::make_shared<TestApplyEventListener>();
+  listeners->Register(listener);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int64_t i = 0; i < kTimes; ++i) {
+    auto event = std::make_shared<TestApplyEvent>();
+    event->log_id = i;
+    for (auto& chain_listener : listeners->Get(EventType::kSmApply)) {
+      chain_listener->OnEvent(event);
+    }
+  }
+  auto old_elapsed_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  auto apply_listener = std::dynamic_pointer_cast<TestApplyEventListener>(listeners->Get(EventType::kSmApply)[0]);
+  auto apply_event = std::make_shared<TestApplyEvent>();
+  start = std::chrono::steady_clock::now();
+  for (int64_t i = 0; i < kTimes; ++i) {
+    apply_event->log_id = i;
+    apply_listener->Apply(*apply_event);
+  }
+  auto new_elapsed_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << fmt::format("dynamic dispatch: {}ns/entry, fast path: {}ns/entry, sum: {}",
+                           old_elapsed_us * 1000.0 / kTimes, new_elapsed_us * 1000.0 / kTimes, listener->Sum())
+            << std::endl;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,47 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "common/hyper_log_log.h"
+
+namespace dingodb {
+
+TEST(HyperLogLogTest, Estimate) {
+  HyperLogLog hll;
+  EXPECT_EQ(0, hll.Estimate());
+
+  for (int i = 0; i < 10; ++i) {
+    hll.Add("key" + std::to_string(i));
+  }
+  EXPECT_EQ(10, hll.Estimate());
+
+  // duplicate key is counted once
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 100000; ++i) {
+      hll.Add("key" + std::to_string(i));
+    }
+  }
+  int64_t estimate = hll.Estimate();
+  EXPECT_GT(estimate, 85000);
+  EXPECT_LT(estimate, 115000);
+
+  hll.Clear();
+  EXPECT_EQ(0, hll.Estimate());
+}
+
+}  // namespace dingodb
@@ -99,6 +99,44 @@ TEST(DingoLatchTest, wakeup) {
   EXPECT_EQ(acquired_b, true);
 }
 
+TEST(DingoLatchTest, hot_slot_wait_stat) {
+  dingodb::Latches latches(1024);
+
+  std::vector<std::string> keys{"hot_key"};
+  dingodb::Lock owner(keys);
+  ASSERT_TRUE(latches.Acquire(&owner, 1));
+
+  // queue waiters on the hot key
+  std::vector<std::unique_ptr<dingodb::Lock>> waiters;
+  for (uint64_t cid = 2; cid < 12; ++cid) {
+    waiters.push_back(std::make_unique<dingodb::Lock>(keys));
+    EXPECT_FALSE(latches.Acquire(waiters.back().get(), cid));
+  }
+  EXPECT_TRUE(latches.GetHotSlots(10).empty());
+
+  // release in turn, every waiter is woke up once
+  dingodb::Lock* prev_lock = &owner;
+  uint64_t prev_cid = 1;
+  for (uint64_t cid = 2; cid < 12; ++cid) {
+    auto wakeup = latches.Release(prev_lock, prev_cid, std::nullopt);
+    ASSERT_EQ(1, wakeup.size());
+    EXPECT_EQ(cid, wakeup[0]);
+
+    auto* lock = waiters[cid - 2].get();
+    EXPECT_TRUE(latches.Acquire(lock, cid));
+    EXPECT_EQ(0, lock->waitStartUs);
+    prev_lock = lock;
+    prev_cid = cid;
+  }
+  EXPECT_TRUE(latches.Release(prev_lock, prev_cid, std::nullopt).empty());
+
+  auto hot_slots = latches.GetHotSlots(10);
+  ASSERT_EQ(1, hot_slots.size());
+  EXPECT_EQ(10, hot_slots[0].wait_count);
+  // waiters enqueued when waiting list size reach latch_hot_slot_waiting_num
+  EXPECT_EQ(3, hot_slots[0].hot_count);
+}
+
 TEST(DingoLatchTest, wakeup_by_multi_cmds) {
   dingodb::Latches latches(256);
 
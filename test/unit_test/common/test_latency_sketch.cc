@@ -0,0 +1,60 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+
+#include "common/latency_sketch.h"
+
+namespace dingodb {
+
+TEST(LatencySketchTest, BucketIndex) {
+  for (int64_t value : {0, 1, 7, 8, 15, 16, 100, 1000, 123456, 1LL << 31}) {
+    uint32_t index = LatencySketch::BucketIndex(value);
+    ASSERT_LT(index, LatencySketch::kBucketNum);
+    int64_t bucket_value = LatencySketch::BucketValue(index);
+    EXPECT_LE(std::abs(bucket_value - value), value / 16 + 1) << value;
+  }
+
+  EXPECT_EQ(LatencySketch::kBucketNum - 1, LatencySketch::BucketIndex(1LL << 40));
+  EXPECT_EQ(0, LatencySketch::BucketIndex(-1));
+}
+
+TEST(LatencySketchTest, QuantileAndMerge) {
+  LatencySketch sketch;
+  EXPECT_EQ(0, sketch.Quantile(0.99));
+
+  for (int64_t i = 1; i <= 1000; ++i) {
+    sketch.Add(i);
+  }
+  EXPECT_EQ(1000, sketch.Count());
+  EXPECT_NEAR(500, sketch.Quantile(0.5), 500 / 16 + 1);
+  EXPECT_NEAR(990, sketch.Quantile(0.99), 990 / 16 + 1);
+
+  LatencySketch other;
+  for (int64_t i = 0; i < 1000; ++i) {
+    other.Add(100000);
+  }
+  sketch.Merge(other);
+  EXPECT_EQ(2000, sketch.Count());
+  EXPECT_NEAR(100000, sketch.Quantile(0.99), 100000 / 16 + 1);
+
+  sketch.Clear();
+  EXPECT_EQ(0, sketch.Count());
+}
+
+}  // namespace dingodb
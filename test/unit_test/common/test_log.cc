@@ -15,11 +15,20 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <cstdint>
+#include <ctime>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <thread>
 
+#include "common/async_logger.h"
 #include "common/logging.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+DECLARE_int64(log_site_max_per_second);
+}  // namespace dingodb
 
 class DingoLoggerTest : public testing::Test {
  protected:
@@ -37,3 +46,49 @@ class DingoLoggerTest : public testing::Test {
 //   VLOG(1) << "This is a log";
 //   EXPECT_EQ(FLAGS_v, debug_level);
 // }
+
+TEST_F(DingoLoggerTest, LogSiteSuppress) {
+  dingodb::FLAGS_log_site_max_per_second = 10;
+
+  dingodb::LogSite site(__FILE__, __LINE__);
+  int allow_count = 0;
+  for (int i = 0; i < 100; ++i) {
+    allow_count += site.Allow() ? 1 : 0;
+  }
+  EXPECT_EQ(10, allow_count);
+
+  dingodb::FLAGS_log_site_max_per_second = 0;
+  EXPECT_TRUE(site.Allow());
+  dingodb::FLAGS_log_site_max_per_second = 100;
+}
+
+class MemoryLogger : public google::base::Logger {
+ public:
+  void Write(bool, time_t, const char* message, size_t message_len) override { data.append(message, message_len); }
+  void Flush() override { ++flush_count; }
+  uint32_t LogSize() override { return data.size(); }
+
+  std::string data;
+  int flush_count{0};
+};
+
+TEST_F(DingoLoggerTest, AsyncLogger) {
+  MemoryLogger memory_logger;
+  dingodb::AsyncLogger async_logger(&memory_logger);
+  async_logger.Start();
+
+  for (int i = 0; i < 100; ++i) {
+    std::string message = std::to_string(i) + "\n";
+    async_logger.Write(false, time(nullptr), message.data(), message.size());
+  }
+
+  async_logger.Flush();
+  EXPECT_EQ(0, memory_logger.data.find("0\n1\n2\n"));
+  EXPECT_EQ(async_logger.LogSize(), memory_logger.data.size());
+  EXPECT_GE(memory_logger.flush_count, 1);
+
+  // write directly after stop
+  async_logger.Stop();
+  async_logger.Write(false, time(nullptr), "end\n", 4);
+  EXPECT_EQ(memory_logger.data.size() - 4, memory_logger.data.rfind("end\n"));
+}
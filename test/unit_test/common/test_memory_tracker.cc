@@ -0,0 +1,81 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+
+#include "common/memory_tracker.h"
+
+namespace dingodb {
+
+TEST(MemoryTrackerTest, ConsumeAndLimit) {
+  auto store = std::make_shared<MemoryTracker>("test_store", nullptr);
+  store->SetLimit(1000, 2000);
+  auto subsystem = store->GetOrNewChild("subsystem");
+  auto region = subsystem->GetOrNewChild("1001");
+  EXPECT_EQ(subsystem, store->GetOrNewChild("subsystem"));
+
+  // charge of region is propagated to ancestors.
+  region->Consume(800);
+  EXPECT_EQ(800, subsystem->Consumption());
+  EXPECT_EQ(800, store->Consumption());
+  EXPECT_FALSE(region->IsOverSoftLimit());
+
+  region->SetConsumption(1500);
+  EXPECT_EQ(1500, store->Consumption());
+  EXPECT_TRUE(region->IsOverSoftLimit());
+  EXPECT_FALSE(region->IsOverHardLimit());
+
+  // hard limit of ancestor reject charge.
+  EXPECT_FALSE(region->TryConsume(600));
+  EXPECT_TRUE(region->TryConsume(100));
+  EXPECT_EQ(1600, store->Consumption());
+  EXPECT_EQ(1600, store->PeakConsumption());
+
+  subsystem->RemoveChild("1001");
+  EXPECT_EQ(0, subsystem->Consumption());
+  EXPECT_EQ(0, store->Consumption());
+}
+
+TEST(MemoryTrackerTest, Evict) {
+  auto store = std::make_shared<MemoryTracker>("test_store", nullptr);
+  auto small = store->GetOrNewChild("small");
+  auto large = store->GetOrNewChild("large");
+  small->Consume(100);
+  large->Consume(1000);
+
+  int64_t small_evict_bytes = 0;
+  small->SetEvictor([&](int64_t bytes) -> int64_t {
+    small_evict_bytes += bytes;
+    small->Release(bytes);
+    return bytes;
+  });
+  large->SetEvictor([&](int64_t bytes) -> int64_t {
+    // only part can be freed
+    large->Release(300);
+    return 300;
+  });
+
+  // the largest consumer is evicted first.
+  EXPECT_EQ(400, store->Evict(400));
+  EXPECT_EQ(700, large->Consumption());
+  EXPECT_EQ(100, small_evict_bytes);
+  EXPECT_EQ(0, small->Consumption());
+  EXPECT_EQ(700, store->Consumption());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,46 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <set>
+
+#include "common/helper.h"
+#include "common/numa.h"
+
+TEST(NumaTopologyTest, NodeCpus) {
+  int32_t node_num = dingodb::NumaTopology::NodeNum();
+  ASSERT_GE(node_num, 1);
+
+  // every cpu belongs to one node.
+  std::set<int32_t> cpus;
+  for (int32_t node = 0; node < node_num; ++node) {
+    for (int32_t cpu : dingodb::NumaTopology::NodeCpus(node)) {
+      EXPECT_TRUE(cpus.insert(cpu).second);
+      EXPECT_EQ(node, dingodb::NumaTopology::NodeOfCpu(cpu));
+    }
+  }
+  EXPECT_GE(cpus.size(), 1);
+
+  int32_t current_node = dingodb::NumaTopology::CurrentNode();
+  EXPECT_TRUE(current_node >= 0 && current_node < node_num);
+}
+
+TEST(NumaTopologyTest, NodeOfRegion) {
+  // numa mode is disabled by default, all regions on node 0.
+  EXPECT_FALSE(dingodb::NumaTopology::IsEnabled());
+  EXPECT_EQ(0, dingodb::NumaTopology::NodeOfRegion(80001));
+}
@@ -0,0 +1,59 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "common/region_resource.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DECLARE_int64(region_resource_flush_interval_ms);
+
+TEST(RegionResourceTest, AccountByScope) {
+  FLAGS_region_resource_flush_interval_ms = 0;
+  RegionResourceAccounting::TakeAll();
+
+  // no scope, not accounted.
+  RegionResourceAccounting::AddReadBytes(100);
+
+  {
+    RegionResourceScope scope(1);
+    RegionResourceAccounting::AddReadBytes(10);
+    RegionResourceAccounting::AddSeekCount(1);
+    {
+      RegionResourceScope nested_scope(2);
+      RegionResourceAccounting::AddWriteBytes(20);
+      RegionResourceAccounting::AddScanKeyCount(3);
+    }
+    RegionResourceAccounting::AddReadBytes(5);
+  }
+
+  auto usages = RegionResourceAccounting::TakeAll();
+  ASSERT_EQ(2, usages.size());
+  EXPECT_EQ(15, usages[1].read_bytes);
+  EXPECT_EQ(1, usages[1].seek_count);
+  EXPECT_EQ(0, usages[1].write_bytes);
+  EXPECT_EQ(20, usages[2].write_bytes);
+  EXPECT_EQ(3, usages[2].scan_key_count);
+  EXPECT_GE(usages[1].cpu_time_us, usages[2].cpu_time_us);
+
+  EXPECT_TRUE(RegionResourceAccounting::TakeAll().empty());
+  FLAGS_region_resource_flush_interval_ms = 1000;
+}
+
+}  // namespace dingodb
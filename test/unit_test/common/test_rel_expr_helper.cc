@@ -900,6 +900,14 @@ TEST_F(RelExprHelperTest, TransToOperandWrapper) {
                                               operand_ptr);
     EXPECT_EQ(ok.error_code(), pb::error::OK);
 
+    // prepared operand columns get same operands
+    auto operand_columns = RelExprHelper::GetOperandColumns(original_serial_schemas, selection_column_indexes);
+    EXPECT_EQ(operand_columns.size(), selection_column_indexes.size());
+    std::unique_ptr<std::vector<expr::Operand>> prepared_operand_ptr = std::make_unique<std::vector<expr::Operand>>();
+    ok = RelExprHelper::TransToOperandWrapper(0x01, operand_columns, original_record, prepared_operand_ptr);
+    EXPECT_EQ(ok.error_code(), pb::error::OK);
+    EXPECT_EQ(prepared_operand_ptr->size(), operand_ptr->size());
+
     for (const auto &operand : *operand_ptr) {
       try {
         auto v = operand.GetValue<bool>();
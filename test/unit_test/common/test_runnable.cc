@@ -19,7 +19,9 @@
 #include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <functional>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
@@ -66,4 +68,58 @@ TEST_F(SimpleWorkerSetTest, Performance01) {
   std::cout << "finish..." << std::endl;
   worker_set->Destroy();
   std::cout << "exit..." << std::endl;
-}
\ No newline at end of file
+}
+
+class FuncTestTask : public dingodb::TaskRunnable {
+ public:
+  FuncTestTask(std::function<void()> func) : func_(func) {}
+  ~FuncTestTask() override = default;
+
+  std::string Type() override { return "FuncTestTask"; }
+
+  void Run() override { func_(); }
+
+ private:
+  std::function<void()> func_;
+};
+
+TEST(FairWorkerSetTest, WeightedByWorkloadClass) {
+  auto worker_set = dingodb::FairWorkerSet::New("unit_test_fair", 1, 0, false);
+  ASSERT_TRUE(worker_set->Init());
+
+  // block the only worker until all tasks are queued.
+  std::atomic<bool> is_blocked{true};
+  worker_set->Execute(std::make_shared<FuncTestTask>([&is_blocked]() {
+    while (is_blocked.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  std::mutex mutex;
+  std::vector<dingodb::WorkloadClass> run_classes;
+  for (int i = 0; i < 10; ++i) {
+    for (auto workload_class : {dingodb::WorkloadClass::kBackground, dingodb::WorkloadClass::kOltp}) {
+      auto task = std::make_shared<FuncTestTask>([&mutex, &run_classes, workload_class]() {
+        std::lock_guard<std::mutex> guard(mutex);
+        run_classes.push_back(workload_class);
+      });
+      task->SetWorkloadClass(workload_class);
+      ASSERT_TRUE(worker_set->Execute(task));
+    }
+  }
+
+  is_blocked.store(false);
+  while (worker_set->PendingTaskCount() > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  worker_set->Destroy();
+
+  ASSERT_EQ(20, run_classes.size());
+  // oltp weight is 8 times of background.
+  int oltp_count = 0;
+  for (int i = 0; i < 10; ++i) {
+    oltp_count += run_classes[i] == dingodb::WorkloadClass::kOltp ? 1 : 0;
+  }
+  EXPECT_GE(oltp_count, 8);
+}
@@ -105,6 +105,45 @@ TEST(DingoSafeMapTest, DingoSafeMapCopy) {
   EXPECT_EQ(map3.size(), 3);
 }
 
+TEST(DingoSafeMapTest, DingoShardedSafeMap) {
+  dingodb::DingoShardedSafeMap<int64_t, int64_t> safe_map;
+  safe_map.Init(1000);
+  safe_map.Put(1, 1);
+  EXPECT_EQ(safe_map.Get(1), 1);
+
+  EXPECT_EQ(safe_map.PutIfAbsent(1, 2), -1);
+  EXPECT_EQ(safe_map.Get(1), 1);
+  EXPECT_EQ(safe_map.PutIfNotEqual(1, 2), 1);
+  EXPECT_EQ(safe_map.Get(1), 2);
+  EXPECT_EQ(safe_map.PutIfExists(2, 2), -1);
+  EXPECT_FALSE(safe_map.Exists(2));
+
+  std::vector<int64_t> key_list;
+  std::vector<int64_t> value_list;
+  for (int64_t i = 0; i < 100; ++i) {
+    key_list.push_back(i);
+    value_list.push_back(i * 10);
+  }
+  EXPECT_EQ(safe_map.MultiPut(key_list, value_list), 1);
+  EXPECT_EQ(safe_map.Size(), 100);
+  EXPECT_EQ(safe_map.PutIfEqual(3, 30), 1);
+  EXPECT_EQ(safe_map.PutIfEqual(3, 31), -1);
+
+  std::vector<int64_t> values;
+  EXPECT_EQ(safe_map.GetAllValues(values, [](int64_t value) { return value >= 500; }), 50);
+
+  EXPECT_EQ(safe_map.MultiErase({0, 1, 2}), 1);
+  EXPECT_EQ(safe_map.Size(), 97);
+
+  butil::FlatMap<int64_t, int64_t> raw_map;
+  raw_map.init(100);
+  safe_map.GetRawMapCopy(raw_map);
+  EXPECT_EQ(raw_map.size(), 97);
+
+  safe_map.Clear();
+  EXPECT_EQ(safe_map.Size(), 0);
+}
+
 TEST(DingoSafeStdMapTest, DingoSafeStdMapGetRangeValues) {
   dingodb::DingoSafeStdMap<std::string, std::string> safe_map;
 
@@ -22,6 +22,7 @@
 #include <iomanip>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 
@@ -327,6 +328,29 @@ TEST_F(SerialHelperTest, ReadWriteLongComparable) {
   }
 }
 
+TEST_F(SerialHelperTest, WriteLongToBuffer) {
+  std::vector<int64_t> values = {0, 1, 255, 256, 12345678900001, INT64_MAX};
+  for (auto value : values) {
+    char buf[8];
+
+    std::string output;
+    dingodb::SerialHelper::WriteLong(value, output);
+    dingodb::SerialHelper::WriteLong(value, buf);
+    EXPECT_EQ(output, std::string(buf, 8));
+
+    output.clear();
+    dingodb::SerialHelper::WriteLongWithNegation(value, output);
+    dingodb::SerialHelper::WriteLongWithNegation(value, buf);
+    EXPECT_EQ(output, std::string(buf, 8));
+    EXPECT_EQ(value, dingodb::SerialHelper::ReadLongWithNegation(std::string_view(buf, 8)));
+
+    output.clear();
+    dingodb::SerialHelper::WriteLongComparable(-value, output);
+    dingodb::SerialHelper::WriteLongComparable(-value, buf);
+    EXPECT_EQ(output, std::string(buf, 8));
+  }
+}
+
 TEST_F(SerialHelperTest, Performace) {
   GTEST_SKIP() << "Skip...";
 
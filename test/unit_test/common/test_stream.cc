@@ -0,0 +1,70 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "common/stream.h"
+#include "gflags/gflags.h"
+#include "proto/stream.pb.h"
+
+namespace dingodb {
+
+DECLARE_int64(stream_state_max_memory_bytes);
+
+class TestStreamState : public StreamState {
+ public:
+  int64_t MemorySize() const override { return 100; }
+};
+
+TEST(StreamManagerTest, EvictStreamState) {
+  int64_t old_max_memory_bytes = FLAGS_stream_state_max_memory_bytes;
+  FLAGS_stream_state_max_memory_bytes = 250;
+
+  auto stream_manager = StreamManager::New();
+  pb::stream::StreamRequestMeta stream_meta;
+  stream_meta.set_limit(10);
+
+  std::vector<StreamPtr> streams;
+  for (int i = 0; i < 3; ++i) {
+    auto stream = stream_manager->GetOrNew(stream_meta);
+    ASSERT_NE(nullptr, stream);
+    stream->SetStreamState(std::make_shared<TestStreamState>());
+    streams.push_back(stream);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+  // first stream has no resume key, it can't be evicted.
+  streams[1]->SetResumeKey("key_1");
+  streams[2]->SetResumeKey("key_2");
+
+  stream_manager->EvictStreamState(nullptr);
+
+  // least recently used evictable stream is evicted.
+  EXPECT_NE(nullptr, streams[0]->StreamState());
+  EXPECT_EQ(nullptr, streams[1]->StreamState());
+  EXPECT_TRUE(streams[1]->IsEvicted());
+  EXPECT_EQ("key_1", streams[1]->ResumeKey());
+  EXPECT_NE(nullptr, streams[2]->StreamState());
+  EXPECT_FALSE(streams[2]->IsEvicted());
+
+  FLAGS_stream_state_max_memory_bytes = old_max_memory_bytes;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,126 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "common/runnable.h"
+#include "common/task_pool.h"
+#include "fmt/core.h"
+
+class TaskPoolTest : public testing::Test {
+ protected:
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+class OldFuncTask : public dingodb::TaskRunnable {
+ public:
+  OldFuncTask(std::function<void()> func) : func_(func) {}
+  ~OldFuncTask() override = default;
+
+  std::string Type() override { return "OldFuncTask"; }
+
+  void Run() override { func_(); }
+
+ private:
+  std::function<void()> func_;
+};
+
+class NewFuncTask : public dingodb::TaskRunnable {
+ public:
+  NewFuncTask(dingodb::TaskHandler func) : func_(std::move(func)) {}
+  ~NewFuncTask() override = default;
+
+  std::string Type() override { return "NewFuncTask"; }
+
+  void Run() override { func_(); }
+
+ private:
+  dingodb::TaskHandler func_;
+};
+
+TEST_F(TaskPoolTest, ReuseBlock) {
+  int64_t count = 0;
+  auto value = std::make_shared<int64_t>(1);
+
+  uint64_t miss_count = dingodb::TaskPool::MissCount();
+  for (int i = 0; i < 1000; ++i) {
+    dingodb::TaskRunnablePtr task = dingodb::NewTask<NewFuncTask>([&count, value, i]() { count += *value; });
+    task->Run();
+  }
+
+  EXPECT_EQ(1000, count);
+  EXPECT_EQ(1, value.use_count());
+  // at most first task allocate block, others reuse it.
+  EXPECT_LE(dingodb::TaskPool::MissCount() - miss_count, 1);
+}
+
+TEST_F(TaskPoolTest, InlineFunction) {
+  int64_t count = 0;
+  std::string large(200, 'x');
+
+  dingodb::TaskHandler small_func([&count]() { ++count; });
+  dingodb::TaskHandler large_func([&count, large]() { count += large.size(); });
+  ASSERT_TRUE(small_func);
+
+  dingodb::TaskHandler func(std::move(small_func));
+  ASSERT_FALSE(small_func);
+  func();
+  EXPECT_EQ(1, count);
+
+  func = std::move(large_func);
+  func();
+  EXPECT_EQ(201, count);
+}
+
+// Old task take two allocations: make_shared block and std::function(capture beyond 16 bytes),
+// new task take none after warm up.
+TEST_F(TaskPoolTest, Benchmark) {
+  GTEST_SKIP() << "Performence test, skip...";
+
+  const int64_t kTimes = 10 * 1000 * 1000;
+  int64_t count = 0;
+  void* ptr1 = &count;
+  void* ptr2 = &count;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int64_t i = 0; i < kTimes; ++i) {
+    dingodb::TaskRunnablePtr task = std::make_shared<OldFuncTask>([&count, ptr1, ptr2, i]() { ++count; });
+    task->Run();
+  }
+  auto old_elapsed_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  uint64_t miss_count = dingodb::TaskPool::MissCount();
+  start = std::chrono::steady_clock::now();
+  for (int64_t i = 0; i < kTimes; ++i) {
+    dingodb::TaskRunnablePtr task = dingodb::NewTask<NewFuncTask>([&count, ptr1, ptr2, i]() { ++count; });
+    task->Run();
+  }
+  auto new_elapsed_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << fmt::format("old task: {}ns/task allocations: 2/task, new task: {}ns/task allocations: {:.6f}/task",
+                           old_elapsed_us * 1000.0 / kTimes, new_elapsed_us * 1000.0 / kTimes,
+                           (dingodb::TaskPool::MissCount() - miss_count) * 1.0 / kTimes)
+            << std::endl;
+}
@@ -0,0 +1,61 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "common/tenant_quota.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+DECLARE_int64(tenant_quota_write_qps);
+DECLARE_int64(tenant_quota_read_bytes_per_second);
+
+TEST(TenantQuotaTest, LimitWriteQps) {
+  FLAGS_tenant_quota_write_qps = 3;
+  TenantQuota tenant_quota;
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(tenant_quota.Acquire(101, true).ok());
+  }
+  auto status = tenant_quota.Acquire(101, true);
+  EXPECT_EQ(pb::error::EREQUEST_FULL, status.error_code());
+
+  // other tenant and read are not limited.
+  EXPECT_TRUE(tenant_quota.Acquire(102, true).ok());
+  EXPECT_TRUE(tenant_quota.Acquire(101, false).ok());
+
+  FLAGS_tenant_quota_write_qps = 0;
+  EXPECT_TRUE(tenant_quota.Acquire(101, true).ok());
+}
+
+TEST(TenantQuotaTest, LimitReadBytes) {
+  FLAGS_tenant_quota_read_bytes_per_second = 1000;
+  TenantQuota tenant_quota;
+
+  EXPECT_TRUE(tenant_quota.Acquire(201, false).ok());
+  tenant_quota.Charge(201, false, 600);
+  EXPECT_TRUE(tenant_quota.Acquire(201, false).ok());
+  // bytes is charged after request finish, so bucket go into debt.
+  tenant_quota.Charge(201, false, 600);
+  EXPECT_EQ(pb::error::EREQUEST_FULL, tenant_quota.Acquire(201, false).error_code());
+
+  FLAGS_tenant_quota_read_bytes_per_second = 0;
+}
+
+}  // namespace dingodb
@@ -102,6 +102,32 @@ TEST_F(ThreadPoolTest, ExecuteTaskPriority) {
   ASSERT_EQ(1, run_orders[2]);
 }
 
+TEST_F(ThreadPoolTest, ParallelFor) {
+  dingodb::ThreadPool thread_pool("unit_test", 4);
+
+  std::vector<int> values(1000, 0);
+  thread_pool.ParallelFor(0, values.size(), 7, 0, [&values](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      ++values[i];
+    }
+  });
+
+  for (int value : values) {
+    ASSERT_EQ(1, value);
+  }
+
+  // task submitted from worker is pushed to own queue, and can be stolen by other worker
+  std::atomic<int> count = 0;
+  auto task = thread_pool.ExecuteTask(
+      [&thread_pool, &count](void *) {
+        thread_pool.ParallelFor(0, 100, 1, 0, [&count](size_t begin, size_t end) { count.fetch_add(end - begin); });
+      },
+      nullptr);
+  task->Join();
+
+  ASSERT_EQ(100, count.load());
+}
+
 static int GetThreadPolicy(pthread_attr_t &attr) {
   int policy;
   int rs = pthread_attr_getschedpolicy(&attr, &policy);
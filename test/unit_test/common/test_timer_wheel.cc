@@ -0,0 +1,128 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "crontab/timer_wheel.h"
+
+namespace dingodb {
+
+class TimerWheelTest : public testing::Test {
+ protected:
+  // expired func run in background bthread, wait it done.
+  static void WaitCount(std::atomic<int64_t>& count, int64_t expect_count) {
+    for (int i = 0; i < 1000 && count.load() < expect_count; ++i) {
+      bthread_usleep(1000);
+    }
+  }
+};
+
+TEST_F(TimerWheelTest, ExpireInOrder) {
+  // not start ticker, tick manually.
+  TimerWheel timer_wheel(1);
+
+  std::vector<int64_t> delay_ticks = {1, 63, 64, 65, 4096, 5000, 300000};
+  std::vector<std::atomic<int64_t>> fired_ticks(delay_ticks.size());
+  std::atomic<int64_t> current_tick{0};
+  std::atomic<int64_t> fired_count{0};
+  for (size_t i = 0; i < delay_ticks.size(); ++i) {
+    timer_wheel.Schedule(delay_ticks[i], [&, i]() {
+      fired_ticks[i].store(current_tick.load());
+      fired_count.fetch_add(1);
+    });
+  }
+  EXPECT_EQ(delay_ticks.size(), timer_wheel.Size());
+
+  int64_t expect_count = 0;
+  for (int64_t tick = 1; tick <= delay_ticks.back(); ++tick) {
+    current_tick.store(tick);
+    timer_wheel.Tick();
+    if (tick == delay_ticks[expect_count]) {
+      ++expect_count;
+      WaitCount(fired_count, expect_count);
+      ASSERT_EQ(expect_count, fired_count.load()) << "tick: " << tick;
+      EXPECT_EQ(tick, fired_ticks[expect_count - 1].load());
+    }
+  }
+
+  EXPECT_EQ(0, timer_wheel.Size());
+}
+
+TEST_F(TimerWheelTest, Cancel) {
+  TimerWheel timer_wheel(1);
+
+  std::atomic<int64_t> fired_count{0};
+  uint64_t timer_id = timer_wheel.Schedule(10, [&]() { fired_count.fetch_add(1); });
+  timer_wheel.Schedule(20, [&]() { fired_count.fetch_add(1); });
+  EXPECT_TRUE(timer_wheel.Cancel(timer_id));
+  EXPECT_FALSE(timer_wheel.Cancel(timer_id));
+
+  for (int i = 0; i < 20; ++i) {
+    timer_wheel.Tick();
+  }
+  WaitCount(fired_count, 1);
+  EXPECT_EQ(1, fired_count.load());
+  EXPECT_EQ(0, timer_wheel.Size());
+}
+
+TEST_F(TimerWheelTest, Ticker) {
+  TimerWheel timer_wheel(1);
+  ASSERT_TRUE(timer_wheel.Start());
+
+  std::atomic<int64_t> fired_count{0};
+  for (int i = 0; i < 100; ++i) {
+    timer_wheel.Schedule(i, [&]() { fired_count.fetch_add(1); });
+  }
+  WaitCount(fired_count, 100);
+  EXPECT_EQ(100, fired_count.load());
+
+  timer_wheel.Stop();
+}
+
+TEST_F(TimerWheelTest, SpreadAndJitter) {
+  EXPECT_EQ(TimerWheel::SpreadOffset("STORE_METRICS", 1000), TimerWheel::SpreadOffset("STORE_METRICS", 1000));
+  EXPECT_LT(TimerWheel::SpreadOffset("STORE_METRICS", 1000), 1000);
+  EXPECT_EQ(0, TimerWheel::SpreadOffset("STORE_METRICS", 0));
+
+  EXPECT_EQ(1000, TimerWheel::Jitter(1000, 0.0));
+  for (int i = 0; i < 100; ++i) {
+    int64_t interval_ms = TimerWheel::Jitter(1000, 0.1);
+    EXPECT_GE(interval_ms, 900);
+    EXPECT_LE(interval_ms, 1100);
+  }
+}
+
+TEST_F(TimerWheelTest, RoundSpreader) {
+  RoundSpreader spreader(4);
+
+  // every region has exactly one turn in a whole interval.
+  std::vector<int> turn_counts(100, 0);
+  for (int round = 0; round < spreader.RoundNum(); ++round) {
+    spreader.NextRound();
+    for (int64_t region_id = 0; region_id < 100; ++region_id) {
+      turn_counts[region_id] += spreader.IsTurn(region_id) ? 1 : 0;
+    }
+  }
+  for (int count : turn_counts) {
+    EXPECT_EQ(1, count);
+  }
+}
+
+}  // namespace dingodb
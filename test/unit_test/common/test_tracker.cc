@@ -18,10 +18,18 @@
 #include <thread>
 #include <vector>
 
+#include "butil/iobuf.h"
 #include "common/helper.h"
+#include "common/trace.h"
 #include "common/tracker.h"
 #include "common/uuid.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/raft.pb.h"
+
+namespace dingodb {
+DECLARE_double(trace_sample_rate);
+}  // namespace dingodb
 
 class TrackerTest : public testing::Test {
  protected:
@@ -61,4 +69,59 @@ TEST_F(TrackerTest, SetTime) {
   ASSERT_LE(1 * ms * 1000 * 1000, tracker->RaftQueueWaitTime());
   ASSERT_LE(1 * ms * 1000 * 1000, tracker->RaftApplyTime());
   ASSERT_LE(6 * ms * 1000 * 1000, tracker->TotalRpcTime());
-}
\ No newline at end of file
+}
+TEST_F(TrackerTest, TraceSample) {
+  double old_sample_rate = dingodb::FLAGS_trace_sample_rate;
+
+  dingodb::FLAGS_trace_sample_rate = 0;
+  dingodb::pb::common::RequestInfo request_info;
+  EXPECT_FALSE(dingodb::Tracker::New(request_info)->IsSampled());
+
+  dingodb::FLAGS_trace_sample_rate = 1;
+  auto tracker = dingodb::Tracker::New(request_info);
+  EXPECT_TRUE(tracker->IsSampled());
+
+  dingodb::FLAGS_trace_sample_rate = old_sample_rate;
+}
+
+TEST_F(TrackerTest, TracePropagate) {
+  dingodb::TraceContext context{0x1234, 0x5678, 0x9abc};
+
+  dingodb::pb::raft::RaftCmdRequest raft_cmd;
+  raft_cmd.mutable_header()->set_region_id(1001);
+  dingodb::Tracer::Inject(context, raft_cmd.mutable_header());
+  raft_cmd.add_requests()->set_cmd_type(dingodb::pb::raft::CmdType::PUT);
+
+  // follower get context from serialized raft cmd.
+  butil::IOBuf data;
+  butil::IOBufAsZeroCopyOutputStream wrapper(&data);
+  ASSERT_TRUE(raft_cmd.SerializeToZeroCopyStream(&wrapper));
+
+  dingodb::TraceContext extract_context;
+  ASSERT_TRUE(dingodb::Tracer::Extract(data, extract_context));
+  EXPECT_EQ(context.trace_id_high, extract_context.trace_id_high);
+  EXPECT_EQ(context.trace_id_low, extract_context.trace_id_low);
+  EXPECT_EQ(context.span_id, extract_context.span_id);
+
+  // not traced raft cmd
+  dingodb::pb::raft::RaftCmdRequest plain_raft_cmd;
+  plain_raft_cmd.mutable_header()->set_region_id(1001);
+  EXPECT_FALSE(dingodb::Tracer::Extract(plain_raft_cmd.header(), extract_context));
+}
+
+TEST_F(TrackerTest, TraceOtlpJson) {
+  dingodb::Span span;
+  span.name = "raft_apply_handler";
+  span.context = {1, 2, 3};
+  span.parent_span_id = 4;
+  span.start_time_ns = 100;
+  span.end_time_ns = 200;
+  span.attributes.emplace_back("region_id", "1001");
+
+  std::string json = dingodb::Tracer::ToOtlpJson({span});
+  EXPECT_NE(std::string::npos, json.find(R"("traceId":"00000000000000010000000000000002")"));
+  EXPECT_NE(std::string::npos, json.find(R"("spanId":"0000000000000003")"));
+  EXPECT_NE(std::string::npos, json.find(R"("parentSpanId":"0000000000000004")"));
+  EXPECT_NE(std::string::npos, json.find(R"("startTimeUnixNano":"100")"));
+  EXPECT_NE(std::string::npos, json.find(R"({"key":"region_id","value":{"stringValue":"1001"}})"));
+}
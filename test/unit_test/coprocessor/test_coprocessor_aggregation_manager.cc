@@ -17,6 +17,7 @@
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 #include "butil/status.h"
@@ -2793,6 +2794,35 @@ TEST_F(CoprocessorAggregationManagerTest, CreateIterator) {
   }
 }
 
+TEST_F(CoprocessorAggregationManagerTest, HashTableGrow) {
+  AggregationHashTable table(1, 16);
+
+  for (int round = 0; round < 2; ++round) {
+    for (int i = 0; i < 1000; ++i) {
+      bool is_new = false;
+      size_t group = table.FindOrInsert("key_" + std::to_string(i), is_new);
+      EXPECT_EQ(i, group);
+      EXPECT_EQ(round == 0, is_new);
+      if (is_new) {
+        table.MutableValues().emplace_back(std::optional<int64_t>(0));
+      }
+      auto& value = std::any_cast<std::optional<int64_t>&>(table.GetValues(group)[0]);
+      value.value() += i;
+    }
+  }
+
+  // groups keep insertion order after grow.
+  EXPECT_EQ(1000, table.Size());
+  EXPECT_EQ("key_0", table.GetKey(0));
+  EXPECT_EQ("key_999", table.GetKey(999));
+  EXPECT_EQ(2 * 999, std::any_cast<std::optional<int64_t>>(table.GetValues(999)[0]).value());
+
+  // empty key is a valid group.
+  bool is_new = false;
+  EXPECT_EQ(1000, table.FindOrInsert("", is_new));
+  EXPECT_TRUE(is_new);
+}
+
 TEST_F(CoprocessorAggregationManagerTest, Close) { aggregation_manager->Close(); }
 
 }  // namespace dingodb
@@ -0,0 +1,87 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "coprocessor/coprocessor_v2_plan_cache.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+DECLARE_int64(coprocessor_v2_plan_cache_max_count);
+
+class CoprocessorV2PlanCacheTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    old_max_count = FLAGS_coprocessor_v2_plan_cache_max_count;
+    CoprocessorV2PlanCache::GetInstance().Clear();
+  }
+  void TearDown() override {
+    FLAGS_coprocessor_v2_plan_cache_max_count = old_max_count;
+    CoprocessorV2PlanCache::GetInstance().Clear();
+  }
+
+  int64_t old_max_count;
+};
+
+TEST_F(CoprocessorV2PlanCacheTest, GenKey) {
+  pb::common::CoprocessorV2 coprocessor;
+  coprocessor.set_schema_version(1);
+  coprocessor.add_selection_columns(0);
+  coprocessor.add_selection_columns(1);
+  std::string key = CoprocessorV2PlanCache::GenKey(coprocessor);
+
+  // rel expr is not part of plan
+  coprocessor.set_rel_expr("rel_expr");
+  EXPECT_EQ(key, CoprocessorV2PlanCache::GenKey(coprocessor));
+
+  coprocessor.add_selection_columns(2);
+  EXPECT_NE(key, CoprocessorV2PlanCache::GenKey(coprocessor));
+
+  coprocessor.set_schema_version(2);
+  coprocessor.clear_selection_columns();
+  coprocessor.add_selection_columns(0);
+  coprocessor.add_selection_columns(1);
+  EXPECT_NE(key, CoprocessorV2PlanCache::GenKey(coprocessor));
+}
+
+TEST_F(CoprocessorV2PlanCacheTest, PutAndGet) {
+  FLAGS_coprocessor_v2_plan_cache_max_count = 2;
+  auto& cache = CoprocessorV2PlanCache::GetInstance();
+
+  auto plan = std::make_shared<CoprocessorV2Plan>();
+  plan->selection_column_indexes = {1, 0};
+  cache.Put("key1", plan);
+  cache.Put("key2", std::make_shared<CoprocessorV2Plan>());
+
+  auto cached_plan = cache.Get("key1");
+  ASSERT_NE(nullptr, cached_plan);
+  EXPECT_EQ(plan->selection_column_indexes, cached_plan->selection_column_indexes);
+
+  // key2 is least recently used
+  cache.Put("key3", std::make_shared<CoprocessorV2Plan>());
+  EXPECT_EQ(2, cache.Size());
+  EXPECT_EQ(nullptr, cache.Get("key2"));
+  EXPECT_NE(nullptr, cache.Get("key1"));
+  EXPECT_NE(nullptr, cache.Get("key3"));
+
+  FLAGS_coprocessor_v2_plan_cache_max_count = 0;
+  EXPECT_EQ(nullptr, cache.Get("key1"));
+}
+
+}  // namespace dingodb
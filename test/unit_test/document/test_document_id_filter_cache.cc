@@ -0,0 +1,103 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "document/document_id_filter_cache.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "vector/vector_id_bitmap.h"
+
+namespace dingodb {
+
+DECLARE_int64(document_id_filter_cache_max_memory_bytes);
+
+class DocumentIdFilterCacheTest : public testing::Test {
+ protected:
+  void SetUp() override { old_max_memory_bytes = FLAGS_document_id_filter_cache_max_memory_bytes; }
+  void TearDown() override { FLAGS_document_id_filter_cache_max_memory_bytes = old_max_memory_bytes; }
+
+  static std::string GenKey(const std::string& query_string) {
+    pb::common::Range range;
+    range.set_start_key("r1");
+    range.set_end_key("r2");
+    return DocumentIdFilterCache::GenKey(range, query_string);
+  }
+
+  static VectorIdBitmapPtr GenIds(int64_t start_id, int64_t count) {
+    auto ids = std::make_shared<VectorIdBitmap>();
+    for (int64_t id = start_id; id < start_id + count; ++id) {
+      ids->Add(id);
+    }
+    return ids;
+  }
+
+  int64_t old_max_memory_bytes;
+};
+
+TEST_F(DocumentIdFilterCacheTest, HitAndReload) {
+  DocumentIdFilterCache cache;
+  DocumentIdFilterCache::Version version{1, 0};
+
+  EXPECT_EQ(nullptr, cache.Get(GenKey("text:apple"), version));
+  cache.Put(GenKey("text:apple"), version, GenIds(1, 100));
+
+  auto ids = cache.Get(GenKey("text:apple"), version);
+  ASSERT_NE(nullptr, ids);
+  EXPECT_EQ(100, ids->Cardinality());
+  EXPECT_EQ(nullptr, cache.Get(GenKey("text:banana"), version));
+
+  // key contains range
+  pb::common::Range other_range;
+  other_range.set_start_key("r1");
+  other_range.set_end_key("r3");
+  EXPECT_NE(GenKey("text:apple"), DocumentIdFilterCache::GenKey(other_range, "text:apple"));
+
+  // reader of sibling document index is reloaded
+  EXPECT_EQ(nullptr, cache.Get(GenKey("text:apple"), DocumentIdFilterCache::Version{1, 2}));
+  EXPECT_EQ(0, cache.Size());
+  EXPECT_EQ(0, cache.MemorySize());
+}
+
+TEST_F(DocumentIdFilterCacheTest, EvictByMemory) {
+  DocumentIdFilterCache cache;
+  DocumentIdFilterCache::Version version{1, 0};
+
+  cache.Put(GenKey("a"), version, GenIds(0, 10));
+  int64_t entry_memory_size = cache.MemorySize();
+  ASSERT_GT(entry_memory_size, 0);
+
+  FLAGS_document_id_filter_cache_max_memory_bytes = entry_memory_size * 3;
+  cache.Put(GenKey("b"), version, GenIds(0, 10));
+  cache.Put(GenKey("c"), version, GenIds(0, 10));
+
+  // a is recently used, b is evicted
+  ASSERT_NE(nullptr, cache.Get(GenKey("a"), version));
+  cache.Put(GenKey("d"), version, GenIds(0, 10));
+
+  EXPECT_EQ(3, cache.Size());
+  EXPECT_LE(cache.MemorySize(), FLAGS_document_id_filter_cache_max_memory_bytes);
+  EXPECT_NE(nullptr, cache.Get(GenKey("a"), version));
+  EXPECT_EQ(nullptr, cache.Get(GenKey("b"), version));
+
+  // too large to cache
+  cache.Put(GenKey("e"), version, GenIds(0, 100000));
+  EXPECT_EQ(nullptr, cache.Get(GenKey("e"), version));
+}
+
+}  // namespace dingodb
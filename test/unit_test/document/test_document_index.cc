@@ -21,7 +21,15 @@
 
 #include "butil/status.h"
 #include "document/codec.h"
+#include "document/document_index.h"
 #include "document/document_index_factory.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+DECLARE_int64(document_index_refresh_interval_ms);
+DECLARE_int64(document_index_search_parallel_num);
+DECLARE_int64(document_index_search_parallel_min_doc_count);
+}  // namespace dingodb
 
 static size_t log_level = 1;
 
@@ -519,4 +527,157 @@ TEST(DingoDocumentIndexTest, test_upsert) {
     EXPECT_EQ(ret.ok(), true);
     EXPECT_EQ(results.size(), 0);
   }
-}
\ No newline at end of file
+}
+TEST(DingoDocumentIndexTest, test_deferred_write_refresh) {
+  std::filesystem::remove_all(kDocumentIndexTestIndexPath);
+  std::string index_path{kDocumentIndexTestIndexPath};
+
+  std::string error_message;
+  std::string json_parameter;
+  std::map<std::string, dingodb::TokenizerType> column_tokenizer_parameter;
+
+  dingodb::pb::common::DocumentIndexParameter document_index_parameter;
+  auto* text_field = document_index_parameter.mutable_scalar_schema()->add_fields();
+  text_field->set_key("text");
+  text_field->set_field_type(dingodb::pb::common::ScalarFieldType::STRING);
+  column_tokenizer_parameter["text"] = dingodb::TokenizerType::kTokenizerTypeText;
+
+  ASSERT_TRUE(dingodb::DocumentCodec::GenDefaultTokenizerJsonParameter(column_tokenizer_parameter, json_parameter,
+                                                                       error_message));
+  document_index_parameter.set_json_parameter(json_parameter);
+
+  dingodb::pb::common::RegionEpoch region_epoch;
+  dingodb::pb::common::Range range;
+  auto document_index =
+      dingodb::DocumentIndexFactory::CreateIndex(1, index_path, document_index_parameter, region_epoch, range, true);
+  ASSERT_TRUE(document_index != nullptr);
+
+  std::vector<dingodb::pb::common::DocumentWithId> document_with_ids;
+  for (int i = 0; i < 3; i++) {
+    dingodb::pb::common::DocumentWithId document_with_id;
+    document_with_id.set_id(i + 1);
+    dingodb::pb::common::DocumentValue document_value;
+    document_value.set_field_type(dingodb::pb::common::ScalarFieldType::STRING);
+    document_value.mutable_field_value()->set_string_data("Explorers discover uncharted territories " +
+                                                          std::to_string(i));
+    document_with_id.mutable_document()->mutable_document_data()->insert({"text", document_value});
+    document_with_ids.push_back(document_with_id);
+  }
+
+  auto ret = document_index->AddDeferred(document_with_ids);
+  ASSERT_TRUE(ret.ok()) << ret.error_str();
+  EXPECT_EQ(3, document_index->PendingWriteCount());
+
+  // deferred write is not searchable before refresh
+  std::vector<dingodb::pb::common::DocumentWithScore> results;
+  ret = document_index->Search(10, "discover", false, 0, INT64_MAX, false, false, {}, {}, results);
+  EXPECT_TRUE(ret.ok());
+  EXPECT_EQ(0, results.size());
+
+  // not due by interval or size
+  int64_t old_interval_ms = dingodb::FLAGS_document_index_refresh_interval_ms;
+  dingodb::FLAGS_document_index_refresh_interval_ms = 3600 * 1000;
+  ASSERT_TRUE(document_index->Refresh(false).ok());
+  EXPECT_EQ(3, document_index->PendingWriteCount());
+  dingodb::FLAGS_document_index_refresh_interval_ms = old_interval_ms;
+
+  // explicit refresh for read your writes
+  ASSERT_TRUE(document_index->Refresh(true).ok());
+  EXPECT_EQ(0, document_index->PendingWriteCount());
+  results.clear();
+  ret = document_index->Search(10, "discover", false, 0, INT64_MAX, false, false, {}, {}, results);
+  EXPECT_TRUE(ret.ok());
+  EXPECT_EQ(3, results.size());
+
+  ret = document_index->Delete({1});
+  ASSERT_TRUE(ret.ok());
+  EXPECT_EQ(1, document_index->PendingWriteCount());
+  ASSERT_TRUE(document_index->Refresh(true).ok());
+  results.clear();
+  ret = document_index->Search(10, "discover", false, 0, INT64_MAX, false, false, {}, {}, results);
+  EXPECT_TRUE(ret.ok());
+  EXPECT_EQ(2, results.size());
+
+  int64_t segment_count = 0;
+  ret = document_index->GetSegmentCount(segment_count);
+  ASSERT_TRUE(ret.ok()) << ret.error_str();
+  EXPECT_GE(segment_count, 1);
+
+  EXPECT_FALSE(document_index->IsWarm());
+  ASSERT_TRUE(document_index->Warmup().ok());
+  EXPECT_TRUE(document_index->IsWarm());
+}
+
+TEST(DingoDocumentIndexTest, test_split_search) {
+  std::filesystem::remove_all(kDocumentIndexTestIndexPath);
+  std::string index_path{kDocumentIndexTestIndexPath};
+
+  std::string error_message;
+  std::string json_parameter;
+  std::map<std::string, dingodb::TokenizerType> column_tokenizer_parameter;
+
+  dingodb::pb::common::DocumentIndexParameter document_index_parameter;
+  auto* text_field = document_index_parameter.mutable_scalar_schema()->add_fields();
+  text_field->set_key("text");
+  text_field->set_field_type(dingodb::pb::common::ScalarFieldType::STRING);
+  column_tokenizer_parameter["text"] = dingodb::TokenizerType::kTokenizerTypeText;
+
+  ASSERT_TRUE(dingodb::DocumentCodec::GenDefaultTokenizerJsonParameter(column_tokenizer_parameter, json_parameter,
+                                                                       error_message));
+  document_index_parameter.set_json_parameter(json_parameter);
+
+  dingodb::pb::common::RegionEpoch region_epoch;
+  dingodb::pb::common::Range range;
+  range.set_start_key(dingodb::DocumentCodec::PackageDocumentKey('r', 1, 1));
+  range.set_end_key(dingodb::DocumentCodec::PackageDocumentKey('r', 1, 101));
+  auto document_index =
+      dingodb::DocumentIndexFactory::CreateIndex(1, index_path, document_index_parameter, region_epoch, range, true);
+  ASSERT_TRUE(document_index != nullptr);
+
+  std::vector<dingodb::pb::common::DocumentWithId> document_with_ids;
+  for (int i = 1; i <= 100; i++) {
+    dingodb::pb::common::DocumentWithId document_with_id;
+    document_with_id.set_id(i);
+    dingodb::pb::common::DocumentValue document_value;
+    document_value.set_field_type(dingodb::pb::common::ScalarFieldType::STRING);
+    std::string text = "Explorers discover uncharted territories";
+    for (int j = 0; j < i % 7; j++) {
+      text += " discover";
+    }
+    document_value.mutable_field_value()->set_string_data(text);
+    document_with_id.mutable_document()->mutable_document_data()->insert({"text", document_value});
+    document_with_ids.push_back(document_with_id);
+  }
+  ASSERT_TRUE(document_index->Add(document_with_ids, true).ok());
+
+  auto document_index_wrapper = dingodb::DocumentIndexWrapper::New(1, document_index_parameter,
+                                                                   dingodb::UseDocumentPurposeType::kDocumentModule);
+  document_index_wrapper->UpdateDocumentIndex(document_index, "test_split_search");
+
+  dingodb::pb::common::DocumentSearchParameter parameter;
+  parameter.set_top_n(10);
+  parameter.set_query_string("discover");
+  parameter.set_without_scalar_data(true);
+  parameter.set_without_table_data(true);
+
+  std::vector<dingodb::pb::common::DocumentWithScore> results;
+  auto ret = document_index_wrapper->Search(range, parameter, results);
+  ASSERT_TRUE(ret.ok()) << ret.error_str();
+  ASSERT_EQ(10, results.size());
+
+  // split to 4 id ranges, merged result is same as search whole range.
+  int64_t old_parallel_num = dingodb::FLAGS_document_index_search_parallel_num;
+  int64_t old_min_doc_count = dingodb::FLAGS_document_index_search_parallel_min_doc_count;
+  dingodb::FLAGS_document_index_search_parallel_num = 4;
+  dingodb::FLAGS_document_index_search_parallel_min_doc_count = 0;
+
+  std::vector<dingodb::pb::common::DocumentWithScore> split_results;
+  ret = document_index_wrapper->Search(range, parameter, split_results);
+  dingodb::FLAGS_document_index_search_parallel_num = old_parallel_num;
+  dingodb::FLAGS_document_index_search_parallel_min_doc_count = old_min_doc_count;
+  ASSERT_TRUE(ret.ok()) << ret.error_str();
+  ASSERT_EQ(results.size(), split_results.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    EXPECT_FLOAT_EQ(results[i].score(), split_results[i].score());
+  }
+}
@@ -0,0 +1,92 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "butil/status.h"
+#include "document/document_reader.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+static std::vector<pb::common::DocumentWithScore> GenResults(int64_t count) {
+  std::vector<pb::common::DocumentWithScore> results;
+  for (int64_t id = 1; id <= count; ++id) {
+    pb::common::DocumentWithScore document_with_score;
+    document_with_score.mutable_document_with_id()->set_id(id);
+    document_with_score.set_score(static_cast<float>(count - id));
+    results.push_back(document_with_score);
+  }
+  return results;
+}
+
+TEST(DocumentSearchAllStreamStateTest, BatchByPage) {
+  pb::common::DocumentSearchParameter parameter;
+  auto stream_state = DocumentSearchAllStreamState::New(GenResults(25), 100, parameter);
+
+  int64_t fill_count = 0;
+  auto filler = [&](int64_t ts, pb::common::DocumentWithScore&) -> butil::Status {
+    EXPECT_EQ(100, ts);
+    ++fill_count;
+    return butil::Status::OK();
+  };
+
+  int64_t next_id = 1;
+  bool has_more = true;
+  while (has_more) {
+    std::vector<pb::common::DocumentWithScore> results;
+    butil::Status status;
+    has_more = stream_state->Batch(10, filler, results, status);
+    ASSERT_TRUE(status.ok());
+    for (const auto& result : results) {
+      EXPECT_EQ(next_id++, result.document_with_id().id());
+    }
+  }
+
+  // only returned documents are read
+  EXPECT_EQ(26, next_id);
+  EXPECT_EQ(25, fill_count);
+}
+
+TEST(DocumentSearchAllStreamStateTest, RetryFailedFill) {
+  pb::common::DocumentSearchParameter parameter;
+  auto stream_state = DocumentSearchAllStreamState::New(GenResults(5), 100, parameter);
+
+  auto fail_filler = [&](int64_t, pb::common::DocumentWithScore& document_with_score) -> butil::Status {
+    if (document_with_score.document_with_id().id() == 3) {
+      return butil::Status(pb::error::EINTERNAL, "read fail");
+    }
+    return butil::Status::OK();
+  };
+
+  std::vector<pb::common::DocumentWithScore> results;
+  butil::Status status;
+  EXPECT_TRUE(stream_state->Batch(10, fail_filler, results, status));
+  EXPECT_FALSE(status.ok());
+  EXPECT_EQ(2, results.size());
+
+  auto filler = [&](int64_t, pb::common::DocumentWithScore&) -> butil::Status { return butil::Status::OK(); };
+  results.clear();
+  EXPECT_FALSE(stream_state->Batch(10, filler, results, status));
+  ASSERT_TRUE(status.ok());
+  ASSERT_EQ(3, results.size());
+  EXPECT_EQ(3, results[0].document_with_id().id());
+}
+
+}  // namespace dingodb
@@ -31,6 +31,7 @@
 #include "config/yaml_config.h"
 #include "engine/bdb_raw_engine.h"
 #include "engine/snapshot.h"
+#include "fmt/core.h"
 #include "gflags/gflags.h"
 #include "proto/common.pb.h"
 
@@ -38,6 +39,9 @@ namespace dingodb {
 
 DEFINE_uint32(bdb_test_max_count, 30000, "bdb_test_max_count");
 
+DECLARE_int32(bdb_scan_bulk_buffer_size);
+DECLARE_bool(bdb_kv_get_without_snapshot);
+
 static const std::string kDefaultCf = "default";
 
 static const std::string kTempDataDirectory = "./unit_test/bdb_unit_test";
@@ -596,6 +600,52 @@ TEST_F(RawBdbEngineTest, KvGet) {
   }
 }
 
+TEST_F(RawBdbEngineTest, KvMultiGet) {
+  const std::string &cf_name = kDefaultCf;
+  auto writer = RawBdbEngineTest::engine->Writer();
+  auto reader = RawBdbEngineTest::engine->Reader();
+
+  std::vector<pb::common::KeyValue> kvs;
+  for (int i = 0; i < 10; ++i) {
+    pb::common::KeyValue kv;
+    kv.set_key("multi_get_key" + std::to_string(i));
+    kv.set_value("multi_get_value" + std::to_string(i));
+    kvs.push_back(kv);
+  }
+  butil::Status ok = writer->KvBatchPut(cf_name, kvs);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  // key empty
+  {
+    std::vector<std::string> keys{"multi_get_key1", ""};
+    std::vector<std::string> values;
+    std::vector<bool> key_states;
+
+    ok = reader->KvMultiGet(cf_name, keys, values, key_states);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::EKEY_EMPTY);
+  }
+
+  // unsorted keys with some not exist
+  {
+    std::vector<std::string> keys{"multi_get_key7", "multi_get_key_not_exist", "multi_get_key2", "multi_get_key0"};
+    std::vector<std::string> values;
+    std::vector<bool> key_states;
+
+    ok = reader->KvMultiGet(cf_name, RawBdbEngineTest::engine->GetSnapshot(), keys, values, key_states);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    EXPECT_EQ(keys.size(), values.size());
+    EXPECT_EQ(keys.size(), key_states.size());
+
+    EXPECT_TRUE(key_states[0]);
+    EXPECT_EQ("multi_get_value7", values[0]);
+    EXPECT_FALSE(key_states[1]);
+    EXPECT_TRUE(key_states[2]);
+    EXPECT_EQ("multi_get_value2", values[2]);
+    EXPECT_TRUE(key_states[3]);
+    EXPECT_EQ("multi_get_value0", values[3]);
+  }
+}
+
 TEST_F(RawBdbEngineTest, KvScan) {
   const std::string &cf_name = kDefaultCf;
   auto reader = RawBdbEngineTest::engine->Reader();
@@ -653,6 +703,49 @@ TEST_F(RawBdbEngineTest, KvScan) {
   }
 }
 
+TEST_F(RawBdbEngineTest, KvScanBulk) {
+  const std::string &cf_name = kDefaultCf;
+  auto writer = RawBdbEngineTest::engine->Writer();
+  auto reader = RawBdbEngineTest::engine->Reader();
+
+  // some value is larger than bulk buffer.
+  std::vector<pb::common::KeyValue> kvs;
+  for (int i = 0; i < 100; ++i) {
+    pb::common::KeyValue kv;
+    kv.set_key(fmt::format("bulk_scan_key{:03}", i));
+    kv.set_value(std::string(i % 10 == 0 ? 100 * 1024 : 100, 'a' + i % 26));
+    kvs.push_back(kv);
+  }
+  butil::Status ok = writer->KvBatchPut(cf_name, kvs);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  int32_t old_buffer_size = FLAGS_bdb_scan_bulk_buffer_size;
+  FLAGS_bdb_scan_bulk_buffer_size = 0;
+  std::vector<pb::common::KeyValue> expect_kvs;
+  ok = reader->KvScan(cf_name, "bulk_scan_key010", "bulk_scan_key090", expect_kvs);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  FLAGS_bdb_scan_bulk_buffer_size = 1;
+  std::vector<pb::common::KeyValue> bulk_kvs;
+  ok = reader->KvScan(cf_name, "bulk_scan_key010", "bulk_scan_key090", bulk_kvs);
+  FLAGS_bdb_scan_bulk_buffer_size = old_buffer_size;
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  ASSERT_EQ(80, expect_kvs.size());
+  ASSERT_EQ(expect_kvs.size(), bulk_kvs.size());
+  for (size_t i = 0; i < bulk_kvs.size(); ++i) {
+    EXPECT_EQ(expect_kvs[i].key(), bulk_kvs[i].key());
+    EXPECT_EQ(expect_kvs[i].value(), bulk_kvs[i].value());
+  }
+
+  FLAGS_bdb_kv_get_without_snapshot = true;
+  std::string value;
+  ok = reader->KvGet(cf_name, "bulk_scan_key020", value);
+  FLAGS_bdb_kv_get_without_snapshot = false;
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  EXPECT_EQ(kvs[20].value(), value);
+}
+
 TEST_F(RawBdbEngineTest, KvCount) {
   const std::string &cf_name = kDefaultCf;
   auto reader = RawBdbEngineTest::engine->Reader();
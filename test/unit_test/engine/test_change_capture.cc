@@ -0,0 +1,143 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "config/yaml_config.h"
+#include "engine/change_capture.h"
+#include "engine/mem_raw_engine.h"
+#include "gflags/gflags.h"
+#include "meta/store_meta_manager.h"
+#include "mvcc/codec.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+DECLARE_int64(change_capture_region_max_memory_size);
+
+static const std::string kChangeCaptureRootPath = "./unit_test_change_capture";
+
+class ChangeCaptureTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    Helper::CreateDirectories(kChangeCaptureRootPath);
+
+    engine = std::make_shared<MemRawEngine>();
+    ASSERT_TRUE(engine->Init(std::make_shared<YamlConfig>(),
+                             {Constant::kTxnDataCF, Constant::kTxnLockCF, Constant::kTxnWriteCF}));
+
+    pb::common::RegionDefinition definition;
+    definition.set_id(kRegionId);
+    region = store::Region::New(definition);
+    old_max_memory_size = FLAGS_change_capture_region_max_memory_size;
+  }
+
+  void TearDown() override {
+    FLAGS_change_capture_region_max_memory_size = old_max_memory_size;
+    ChangeCapture::GetInstance().Unsubscribe(kRegionId);
+    engine->Close();
+    engine->Destroy();
+    Helper::RemoveAllFileOrDirectory(kChangeCaptureRootPath);
+  }
+
+  // commit key at commit_ts, value is put to data cf, return write cf kv as applied.
+  pb::common::KeyValue Commit(const std::string& key, const std::string& value, int64_t start_ts,
+                              int64_t commit_ts) {
+    pb::common::KeyValue data_kv;
+    data_kv.set_key(mvcc::Codec::EncodeKey(key, start_ts));
+    data_kv.set_value(value);
+    EXPECT_TRUE(engine->Writer()->KvPut(Constant::kTxnDataCF, data_kv).ok());
+
+    pb::store::WriteInfo write_info;
+    write_info.set_start_ts(start_ts);
+    write_info.set_op(pb::store::Op::Put);
+    pb::common::KeyValue write_kv;
+    write_kv.set_key(mvcc::Codec::EncodeKey(key, commit_ts));
+    write_kv.set_value(write_info.SerializeAsString());
+    EXPECT_TRUE(engine->Writer()->KvPut(Constant::kTxnWriteCF, write_kv).ok());
+    return write_kv;
+  }
+
+  inline static const int64_t kRegionId = 2001;
+
+  std::shared_ptr<MemRawEngine> engine;
+  store::RegionPtr region;
+  int64_t old_max_memory_size;
+};
+
+TEST_F(ChangeCaptureTest, CaptureAndFetch) {
+  auto& change_capture = ChangeCapture::GetInstance();
+
+  // not subscribed region is not captured.
+  change_capture.CaptureCommit(region, engine, 1, {Commit("key1", "value1", 10, 11)});
+  std::vector<ChangeEvent> events;
+  EXPECT_EQ(pb::error::EREGION_NOT_FOUND, change_capture.Fetch(kRegionId, 0, 10, events).error_code());
+
+  change_capture.Subscribe(kRegionId, 1, true);
+  change_capture.CaptureCommit(region, engine, 2, {Commit("key1", "value2", 20, 21)});
+  change_capture.CaptureCommit(region, engine, 3, {Commit("key2", "value3", 30, 31), Commit("key3", "v", 30, 31)});
+
+  ASSERT_TRUE(change_capture.Fetch(kRegionId, 1, 10, events).ok());
+  ASSERT_EQ(3, events.size());
+  EXPECT_EQ("key1", events[0].key);
+  EXPECT_EQ("value2", events[0].value);
+  EXPECT_EQ("value1", events[0].old_value);
+  EXPECT_EQ(21, events[0].commit_ts);
+  EXPECT_EQ(pb::store::Op::Put, events[0].op);
+
+  // events of one log are not split.
+  events.clear();
+  ASSERT_TRUE(change_capture.Fetch(kRegionId, 2, 1, events).ok());
+  ASSERT_EQ(2, events.size());
+  EXPECT_EQ(3, events[1].log_id);
+
+  events.clear();
+  ASSERT_TRUE(change_capture.Fetch(kRegionId, 3, 10, events).ok());
+  EXPECT_TRUE(events.empty());
+
+  // consumer behind delete range must rescan.
+  change_capture.CaptureDeleteRange(kRegionId, 4);
+  EXPECT_EQ(pb::error::ESTREAM_EXPIRED, change_capture.Fetch(kRegionId, 3, 10, events).error_code());
+  EXPECT_TRUE(change_capture.Fetch(kRegionId, 4, 10, events).ok());
+}
+
+TEST_F(ChangeCaptureTest, BoundedMemory) {
+  auto& change_capture = ChangeCapture::GetInstance();
+  FLAGS_change_capture_region_max_memory_size = 4096;
+
+  change_capture.Subscribe(kRegionId, 0, false);
+  for (int i = 1; i <= 100; ++i) {
+    change_capture.CaptureCommit(region, engine, i, {Commit("key", std::string(100, 'a'), i * 10, i * 10 + 1)});
+  }
+  EXPECT_LE(change_capture.MemorySize(), 4096);
+
+  std::vector<ChangeEvent> events;
+  EXPECT_EQ(pb::error::ESTREAM_EXPIRED, change_capture.Fetch(kRegionId, 0, 100, events).error_code());
+  ASSERT_TRUE(change_capture.Fetch(kRegionId, 90, 100, events).ok());
+  EXPECT_EQ(10, events.size());
+  EXPECT_EQ(100, events.back().log_id);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,165 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/helper.h"
+#include "engine/concurrency_manager.h"
+#include "fmt/core.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+class ConcurrencyManagerTest : public testing::Test {
+ protected:
+  static ConcurrencyManager::LockEntryPtr GenLockEntry(const std::string& key, int64_t lock_ts) {
+    auto lock_entry = std::make_shared<ConcurrencyManager::LockEntry>();
+    lock_entry->lock_info.set_key(key);
+    lock_entry->lock_info.set_lock_ts(lock_ts);
+    lock_entry->lock_info.set_min_commit_ts(lock_ts + 1);
+    return lock_entry;
+  }
+
+  static std::string GenKey(int i) { return fmt::format("key{:08}", i); }
+};
+
+TEST_F(ConcurrencyManagerTest, CheckKeysAndRange) {
+  ConcurrencyManager manager;
+  for (int i = 0; i < 100; i += 10) {
+    manager.LockKey(GenKey(i), GenLockEntry(GenKey(i), 100));
+  }
+
+  std::set<int64_t> resolved_locks;
+  pb::store::TxnResultInfo txn_result_info;
+  EXPECT_TRUE(manager.CheckKeys({GenKey(1), GenKey(20)}, pb::store::IsolationLevel::SnapshotIsolation, 200,
+                                resolved_locks, txn_result_info));
+  EXPECT_EQ(GenKey(20), txn_result_info.locked().key());
+
+  // read ts less than min_commit_ts ignore lock
+  EXPECT_FALSE(manager.CheckKeys({GenKey(20)}, pb::store::IsolationLevel::SnapshotIsolation, 100, resolved_locks,
+                                 txn_result_info));
+  EXPECT_FALSE(manager.CheckKeys({GenKey(1), GenKey(2)}, pb::store::IsolationLevel::SnapshotIsolation, 200,
+                                 resolved_locks, txn_result_info));
+
+  EXPECT_TRUE(manager.CheckRange(GenKey(31), GenKey(41), pb::store::IsolationLevel::SnapshotIsolation, 200,
+                                 resolved_locks, txn_result_info));
+  EXPECT_EQ(GenKey(40), txn_result_info.locked().key());
+  EXPECT_FALSE(manager.CheckRange(GenKey(31), GenKey(40), pb::store::IsolationLevel::SnapshotIsolation, 200,
+                                  resolved_locks, txn_result_info));
+
+  std::map<std::string, pb::store::LockInfo> lock_table;
+  manager.GetKeys(lock_table);
+  ASSERT_EQ(10, lock_table.size());
+  EXPECT_EQ(GenKey(0), lock_table.begin()->first);
+
+  manager.UnlockKeys({GenKey(40), GenKey(41)});
+  EXPECT_FALSE(manager.CheckRange(GenKey(31), GenKey(50), pb::store::IsolationLevel::SnapshotIsolation, 200,
+                                  resolved_locks, txn_result_info));
+
+  lock_table.clear();
+  manager.GetKeys(lock_table);
+  EXPECT_EQ(9, lock_table.size());
+}
+
+TEST_F(ConcurrencyManagerTest, PessimisticLock) {
+  ConcurrencyManager manager;
+
+  auto lock_entry = GenLockEntry(GenKey(0), 100);
+  lock_entry->lock_info.set_lock_type(pb::store::Op::Lock);
+  ASSERT_TRUE(manager.LockPessimisticKey(GenKey(0), lock_entry->lock_info, 2));
+  // same txn update lock, other txn is rejected.
+  EXPECT_TRUE(manager.LockPessimisticKey(GenKey(0), lock_entry->lock_info, 2));
+  lock_entry->lock_info.set_lock_ts(101);
+  EXPECT_FALSE(manager.LockPessimisticKey(GenKey(0), lock_entry->lock_info, 2));
+  EXPECT_EQ(1, manager.PessimisticLockCount());
+
+  // over max count
+  EXPECT_TRUE(manager.LockPessimisticKey(GenKey(1), lock_entry->lock_info, 2));
+  EXPECT_FALSE(manager.LockPessimisticKey(GenKey(2), lock_entry->lock_info, 2));
+
+  pb::store::LockInfo lock_info;
+  ASSERT_TRUE(manager.GetPessimisticLock(GenKey(0), lock_info));
+  EXPECT_EQ(100, lock_info.lock_ts());
+  EXPECT_FALSE(manager.GetPessimisticLock(GenKey(2), lock_info));
+
+  // pessimistic lock is not prewrite memory lock, not seen by read check and prewrite unlock.
+  std::set<int64_t> resolved_locks;
+  pb::store::TxnResultInfo txn_result_info;
+  EXPECT_FALSE(manager.CheckKeys({GenKey(0)}, pb::store::IsolationLevel::SnapshotIsolation, 200, resolved_locks,
+                                 txn_result_info));
+  manager.UnlockKeys({GenKey(0)});
+  EXPECT_EQ(2, manager.PessimisticLockCount());
+
+  std::vector<pb::store::LockInfo> lock_infos;
+  manager.GetPessimisticLocks(lock_infos);
+  EXPECT_EQ(2, lock_infos.size());
+
+  manager.UnlockPessimisticKeys({GenKey(0)});
+  EXPECT_EQ(1, manager.PessimisticLockCount());
+  manager.ClearPessimisticLocks();
+  EXPECT_EQ(0, manager.PessimisticLockCount());
+  EXPECT_FALSE(manager.GetPessimisticLock(GenKey(1), lock_info));
+}
+
+// Prewrite lock/unlock and reader check concurrently, print elapsed time as contention benchmark.
+TEST_F(ConcurrencyManagerTest, Contention) {
+  ConcurrencyManager manager;
+
+  const int thread_num = 16;
+  const int op_num = 20000;
+  std::atomic<int64_t> conflict_count{0};
+
+  int64_t start_time = Helper::TimestampMs();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_num; ++t) {
+    threads.emplace_back([&, t]() {
+      std::set<int64_t> resolved_locks;
+      pb::store::TxnResultInfo txn_result_info;
+      for (int i = 0; i < op_num; ++i) {
+        auto key = GenKey(t * op_num + i);
+        if (t % 2 == 0) {
+          manager.LockKey(key, GenLockEntry(key, 100));
+          manager.UnlockKeys({key});
+        } else if (manager.CheckKeys({key, GenKey(i)}, pb::store::IsolationLevel::SnapshotIsolation, 200,
+                                     resolved_locks, txn_result_info)) {
+          conflict_count.fetch_add(1);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::cout << fmt::format("thread({}) op({}) conflict({}) elapsed({}ms)", thread_num, op_num, conflict_count.load(),
+                           Helper::TimestampMs() - start_time)
+            << '\n';
+
+  // all locks are released
+  std::map<std::string, pb::store::LockInfo> lock_table;
+  manager.GetKeys(lock_table);
+  EXPECT_TRUE(lock_table.empty());
+}
+
+}  // namespace dingodb
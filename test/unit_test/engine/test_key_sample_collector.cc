@@ -0,0 +1,57 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "engine/key_sample_collector.h"
+#include "fmt/core.h"
+#include "rocksdb/table_properties.h"
+
+namespace dingodb {
+
+TEST(KeySampleCollectorTest, SampleAndDecode) {
+  KeySampleCollector collector(100);
+
+  // 10 bytes per entry, one sample every 10 entries, and the tail.
+  for (int i = 0; i < 25; ++i) {
+    std::string key = fmt::format("key{:02}", i);
+    std::string value(10 - key.size(), 'v');
+    ASSERT_TRUE(collector.AddUserKey(key, value, rocksdb::kEntryPut, 0, 0).ok());
+  }
+
+  rocksdb::UserCollectedProperties properties;
+  ASSERT_TRUE(collector.Finish(&properties).ok());
+  ASSERT_NE(properties.end(), properties.find(KeySampleCollector::kPropertyName));
+
+  std::vector<KeySampleCollector::Sample> samples;
+  ASSERT_TRUE(KeySampleCollector::DecodeSamples(properties[KeySampleCollector::kPropertyName], samples));
+  ASSERT_EQ(3, samples.size());
+  EXPECT_EQ("key09", samples[0].first);
+  EXPECT_EQ(100, samples[0].second);
+  EXPECT_EQ("key19", samples[1].first);
+  EXPECT_EQ("key24", samples[2].first);
+  EXPECT_EQ(50, samples[2].second);
+
+  // truncated data
+  std::string data = KeySampleCollector::EncodeSamples(samples);
+  std::vector<KeySampleCollector::Sample> truncated_samples;
+  EXPECT_FALSE(KeySampleCollector::DecodeSamples(data.substr(0, data.size() - 1), truncated_samples));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,101 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "engine/lock_wait_manager.h"
+
+namespace dingodb {
+
+class LockWaitManagerTest : public testing::Test {
+ protected:
+  static void WaitFor(const std::atomic<int>& count, int expect) {
+    for (int i = 0; i < 200 && count.load() != expect; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+};
+
+TEST_F(LockWaitManagerTest, WakeUp) {
+  LockWaitManager lock_wait_manager;
+
+  std::atomic<int> wake_count = 0;
+  std::atomic<int> timeout_count = 0;
+  auto func = [&](bool is_timeout) { is_timeout ? ++timeout_count : ++wake_count; };
+
+  EXPECT_TRUE(lock_wait_manager.Wait(101, 100, 10000, func));
+  EXPECT_TRUE(lock_wait_manager.Wait(102, 100, 10000, func));
+  EXPECT_TRUE(lock_wait_manager.Wait(103, 200, 10000, func));
+  EXPECT_EQ(3, lock_wait_manager.WaiterCount());
+
+  lock_wait_manager.WakeUp(100);
+  EXPECT_EQ(2, wake_count.load());
+  EXPECT_EQ(1, lock_wait_manager.WaiterCount());
+
+  // wake up again is no effect
+  lock_wait_manager.WakeUp(100);
+  EXPECT_EQ(2, wake_count.load());
+
+  lock_wait_manager.WakeUp(200);
+  EXPECT_EQ(3, wake_count.load());
+  EXPECT_EQ(0, timeout_count.load());
+  EXPECT_EQ(0, lock_wait_manager.WaiterCount());
+}
+
+TEST_F(LockWaitManagerTest, Timeout) {
+  LockWaitManager lock_wait_manager;
+
+  std::atomic<int> wake_count = 0;
+  std::atomic<int> timeout_count = 0;
+  auto func = [&](bool is_timeout) { is_timeout ? ++timeout_count : ++wake_count; };
+
+  EXPECT_TRUE(lock_wait_manager.Wait(101, 100, 20, func));
+  WaitFor(timeout_count, 1);
+  EXPECT_EQ(1, timeout_count.load());
+  EXPECT_EQ(0, lock_wait_manager.WaiterCount());
+
+  // waiter is removed after timeout
+  lock_wait_manager.WakeUp(100);
+  EXPECT_EQ(0, wake_count.load());
+}
+
+TEST_F(LockWaitManagerTest, Deadlock) {
+  LockWaitManager lock_wait_manager;
+
+  std::atomic<int> wake_count = 0;
+  auto func = [&](bool) { ++wake_count; };
+
+  // 101 -> 102 -> 103 -> 101
+  EXPECT_TRUE(lock_wait_manager.Wait(101, 102, 10000, func));
+  EXPECT_TRUE(lock_wait_manager.Wait(102, 103, 10000, func));
+  EXPECT_FALSE(lock_wait_manager.Wait(103, 101, 10000, func));
+  EXPECT_EQ(2, lock_wait_manager.WaiterCount());
+
+  // 103 finished, 102 not wait any more
+  lock_wait_manager.WakeUp(103);
+  EXPECT_EQ(1, wake_count.load());
+  EXPECT_TRUE(lock_wait_manager.Wait(103, 101, 10000, func));
+
+  lock_wait_manager.WakeUp(101);
+  lock_wait_manager.WakeUp(102);
+  EXPECT_EQ(3, wake_count.load());
+  EXPECT_EQ(0, lock_wait_manager.WaiterCount());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,220 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "common/helper.h"
+#include "config/yaml_config.h"
+#include "engine/mem_raw_engine.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+static const std::string kMemDefaultCf = "default";
+static const std::string kMemRootPath = "./unit_test_mem_raw_engine";
+
+class MemRawEngineTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    Helper::CreateDirectories(kMemRootPath);
+
+    engine = std::make_shared<MemRawEngine>();
+    ASSERT_TRUE(engine->Init(std::make_shared<YamlConfig>(), {kMemDefaultCf}));
+  }
+
+  void TearDown() override {
+    engine->Close();
+    engine->Destroy();
+    Helper::RemoveAllFileOrDirectory(kMemRootPath);
+  }
+
+  static pb::common::KeyValue GenKv(const std::string& key, const std::string& value) {
+    pb::common::KeyValue kv;
+    kv.set_key(key);
+    kv.set_value(value);
+    return kv;
+  }
+
+  static pb::common::Range GenRange(const std::string& start_key, const std::string& end_key) {
+    pb::common::Range range;
+    range.set_start_key(start_key);
+    range.set_end_key(end_key);
+    return range;
+  }
+
+  std::shared_ptr<MemRawEngine> engine;
+};
+
+TEST_F(MemRawEngineTest, PutAndGet) {
+  auto writer = engine->Writer();
+  auto reader = engine->Reader();
+
+  std::string value;
+  EXPECT_EQ(pb::error::EKEY_NOT_FOUND, reader->KvGet(kMemDefaultCf, "key1", value).error_code());
+
+  EXPECT_EQ(pb::error::EKEY_EMPTY, writer->KvPut(kMemDefaultCf, GenKv("", "value")).error_code());
+  EXPECT_TRUE(writer->KvPut(kMemDefaultCf, GenKv("key1", "value1")).ok());
+  EXPECT_TRUE(reader->KvGet(kMemDefaultCf, "key1", value).ok());
+  EXPECT_EQ("value1", value);
+
+  // overwrite
+  EXPECT_TRUE(writer->KvPut(kMemDefaultCf, GenKv("key1", "value2")).ok());
+  EXPECT_TRUE(reader->KvGet(kMemDefaultCf, "key1", value).ok());
+  EXPECT_EQ("value2", value);
+
+  EXPECT_TRUE(writer->KvDelete(kMemDefaultCf, "key1").ok());
+  EXPECT_EQ(pb::error::EKEY_NOT_FOUND, reader->KvGet(kMemDefaultCf, "key1", value).error_code());
+}
+
+TEST_F(MemRawEngineTest, BatchPutAndDelete) {
+  auto writer = engine->Writer();
+  auto reader = engine->Reader();
+
+  std::vector<pb::common::KeyValue> kvs;
+  for (int i = 0; i < 10; ++i) {
+    kvs.push_back(GenKv("key" + std::to_string(i), "value" + std::to_string(i)));
+  }
+  EXPECT_TRUE(writer->KvBatchPut(kMemDefaultCf, kvs).ok());
+
+  EXPECT_TRUE(writer->KvBatchPutAndDelete(kMemDefaultCf, {GenKv("key10", "value10")}, {"key0", "key1"}).ok());
+
+  int64_t count = 0;
+  EXPECT_TRUE(reader->KvCount(kMemDefaultCf, "key", "kez", count).ok());
+  EXPECT_EQ(9, count);
+
+  std::vector<std::string> values;
+  std::vector<bool> key_states;
+  EXPECT_TRUE(reader->KvMultiGet(kMemDefaultCf, {"key0", "key2", "key10"}, values, key_states).ok());
+  EXPECT_EQ(std::vector<bool>({false, true, true}), key_states);
+  EXPECT_EQ("value2", values[1]);
+  EXPECT_EQ("value10", values[2]);
+}
+
+TEST_F(MemRawEngineTest, Snapshot) {
+  auto writer = engine->Writer();
+  auto reader = engine->Reader();
+
+  EXPECT_TRUE(writer->KvPut(kMemDefaultCf, GenKv("key1", "value1")).ok());
+
+  auto snapshot = engine->GetSnapshot();
+  ASSERT_TRUE(snapshot != nullptr);
+
+  EXPECT_TRUE(writer->KvPut(kMemDefaultCf, GenKv("key1", "value2")).ok());
+  EXPECT_TRUE(writer->KvPut(kMemDefaultCf, GenKv("key2", "value2")).ok());
+
+  // snapshot only see old version
+  std::string value;
+  EXPECT_TRUE(reader->KvGet(kMemDefaultCf, snapshot, "key1", value).ok());
+  EXPECT_EQ("value1", value);
+  EXPECT_EQ(pb::error::EKEY_NOT_FOUND, reader->KvGet(kMemDefaultCf, snapshot, "key2", value).error_code());
+
+  EXPECT_TRUE(reader->KvGet(kMemDefaultCf, "key1", value).ok());
+  EXPECT_EQ("value2", value);
+
+  // compact keep versions which snapshot can read
+  EXPECT_TRUE(engine->Compact(kMemDefaultCf).ok());
+  EXPECT_TRUE(reader->KvGet(kMemDefaultCf, snapshot, "key1", value).ok());
+  EXPECT_EQ("value1", value);
+
+  snapshot.reset();
+  EXPECT_TRUE(engine->Compact(kMemDefaultCf).ok());
+  EXPECT_TRUE(reader->KvGet(kMemDefaultCf, "key1", value).ok());
+  EXPECT_EQ("value2", value);
+}
+
+TEST_F(MemRawEngineTest, Iterator) {
+  auto writer = engine->Writer();
+  auto reader = engine->Reader();
+
+  std::vector<pb::common::KeyValue> kvs;
+  for (int i = 0; i < 10; ++i) {
+    kvs.push_back(GenKv("key" + std::to_string(i), "value" + std::to_string(i)));
+  }
+  EXPECT_TRUE(writer->KvBatchPut(kMemDefaultCf, kvs).ok());
+
+  auto iter = reader->NewIterator(kMemDefaultCf, IteratorOptions("key2", "key5"));
+  ASSERT_TRUE(iter != nullptr);
+
+  std::vector<std::string> keys;
+  for (iter->Seek("key2"); iter->Valid(); iter->Next()) {
+    keys.emplace_back(iter->Key());
+  }
+  EXPECT_EQ(std::vector<std::string>({"key2", "key3", "key4"}), keys);
+
+  // write during iterate is not visible
+  iter->Seek("key2");
+  EXPECT_TRUE(writer->KvDelete(kMemDefaultCf, "key3").ok());
+  iter->Next();
+  ASSERT_TRUE(iter->Valid());
+  EXPECT_EQ("key3", iter->Key());
+  EXPECT_EQ("value3", iter->Value());
+}
+
+TEST_F(MemRawEngineTest, DeleteRange) {
+  auto writer = engine->Writer();
+  auto reader = engine->Reader();
+
+  std::vector<pb::common::KeyValue> kvs;
+  for (int i = 0; i < 10; ++i) {
+    kvs.push_back(GenKv("key" + std::to_string(i), "value" + std::to_string(i)));
+  }
+  EXPECT_TRUE(writer->KvBatchPut(kMemDefaultCf, kvs).ok());
+
+  EXPECT_EQ(pb::error::EILLEGAL_PARAMTETERS,
+            writer->KvDeleteRange(kMemDefaultCf, GenRange("key5", "key2")).error_code());
+  EXPECT_TRUE(writer->KvDeleteRange(kMemDefaultCf, GenRange("key2", "key5")).ok());
+
+  std::vector<pb::common::KeyValue> scan_kvs;
+  EXPECT_TRUE(reader->KvScan(kMemDefaultCf, "key", "kez", scan_kvs).ok());
+  EXPECT_EQ(7, scan_kvs.size());
+  EXPECT_EQ("key1", scan_kvs[1].key());
+  EXPECT_EQ("key5", scan_kvs[2].key());
+}
+
+TEST_F(MemRawEngineTest, SaveFileAndIngest) {
+  auto writer = engine->Writer();
+
+  std::vector<pb::common::KeyValue> kvs;
+  for (int i = 0; i < 10; ++i) {
+    kvs.push_back(GenKv("key" + std::to_string(i), "value" + std::to_string(i)));
+  }
+  EXPECT_TRUE(writer->KvBatchPut(kMemDefaultCf, kvs).ok());
+
+  std::string filename = kMemRootPath + "/default.sst";
+  EXPECT_EQ(pb::error::ENO_ENTRIES, engine->SaveFile(kMemDefaultCf, GenRange("a", "b"), filename).error_code());
+  EXPECT_TRUE(engine->SaveFile(kMemDefaultCf, GenRange("key", "kez"), filename).ok());
+
+  auto other_engine = std::make_shared<MemRawEngine>();
+  ASSERT_TRUE(other_engine->Init(std::make_shared<YamlConfig>(), {kMemDefaultCf}));
+  EXPECT_TRUE(other_engine->IngestExternalFile(kMemDefaultCf, {filename}).ok());
+
+  std::vector<pb::common::KeyValue> scan_kvs;
+  EXPECT_TRUE(other_engine->Reader()->KvScan(kMemDefaultCf, "key", "kez", scan_kvs).ok());
+  ASSERT_EQ(kvs.size(), scan_kvs.size());
+  for (size_t i = 0; i < kvs.size(); ++i) {
+    EXPECT_EQ(kvs[i].key(), scan_kvs[i].key());
+    EXPECT_EQ(kvs[i].value(), scan_kvs[i].value());
+  }
+
+  other_engine->Close();
+}
+
+}  // namespace dingodb
@@ -0,0 +1,97 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "brpc/global.h"
+#include "butil/iobuf.h"
+#include "gflags/gflags.h"
+#include "proto/raft.pb.h"
+#include "raft/raft_cmd_codec.h"
+
+namespace dingodb {
+
+DECLARE_string(raft_log_vector_compress_type);
+DECLARE_int64(raft_log_compress_min_bytes);
+
+class RaftCmdCodecTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() { brpc::GlobalInitializeOrDie(); }
+
+  void SetUp() override {
+    old_compress_type = FLAGS_raft_log_vector_compress_type;
+    old_min_bytes = FLAGS_raft_log_compress_min_bytes;
+    FLAGS_raft_log_compress_min_bytes = 1024;
+  }
+
+  void TearDown() override {
+    FLAGS_raft_log_vector_compress_type = old_compress_type;
+    FLAGS_raft_log_compress_min_bytes = old_min_bytes;
+  }
+
+  static pb::raft::RaftCmdRequest GenVectorAddCmd(int count) {
+    pb::raft::RaftCmdRequest raft_cmd;
+    raft_cmd.mutable_header()->set_region_id(1000);
+    auto* request = raft_cmd.add_requests();
+    request->set_cmd_type(pb::raft::CmdType::VECTOR_ADD);
+    for (int i = 0; i < count; ++i) {
+      auto* vector = request->mutable_vector_add()->add_vectors();
+      vector->set_id(i);
+      for (int j = 0; j < 64; ++j) {
+        vector->mutable_vector()->add_float_values(static_cast<float>(j % 8));
+      }
+    }
+    return raft_cmd;
+  }
+
+  std::string old_compress_type;
+  int64_t old_min_bytes;
+};
+
+TEST_F(RaftCmdCodecTest, EncodeAndDecode) {
+  auto raft_cmd = GenVectorAddCmd(100);
+
+  for (const auto* compress_type : {"none", "snappy", "gzip", "zlib"}) {
+    FLAGS_raft_log_vector_compress_type = compress_type;
+
+    butil::IOBuf data;
+    RaftCmdCodec::Encode(raft_cmd, data);
+    EXPECT_EQ(std::string(compress_type) != "none", RaftCmdCodec::IsCompressed(data)) << compress_type;
+
+    pb::raft::RaftCmdRequest decode_raft_cmd;
+    ASSERT_TRUE(RaftCmdCodec::Decode(data, &decode_raft_cmd)) << compress_type;
+    EXPECT_EQ(raft_cmd.SerializeAsString(), decode_raft_cmd.SerializeAsString());
+
+    // log storage hold data as string
+    pb::raft::RaftCmdRequest decode_raft_cmd_2;
+    ASSERT_TRUE(RaftCmdCodec::Decode(data.to_string(), &decode_raft_cmd_2)) << compress_type;
+    EXPECT_EQ(raft_cmd.SerializeAsString(), decode_raft_cmd_2.SerializeAsString());
+  }
+}
+
+TEST_F(RaftCmdCodecTest, SmallNotCompress) {
+  FLAGS_raft_log_vector_compress_type = "snappy";
+  auto raft_cmd = GenVectorAddCmd(1);
+
+  butil::IOBuf data;
+  RaftCmdCodec::Encode(raft_cmd, data);
+  EXPECT_FALSE(RaftCmdCodec::IsCompressed(data));
+  EXPECT_EQ(raft_cmd.SerializeAsString(), data.to_string());
+}
+
+}  // namespace dingodb
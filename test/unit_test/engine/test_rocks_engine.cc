@@ -219,6 +219,29 @@ TEST_F(RawRocksEngineTest, GetSnapshotReleaseSnapshot) {
   EXPECT_NE(snapshot.get(), nullptr);
 }
 
+TEST_F(RawRocksEngineTest, SharedSnapshot) {
+  auto snapshot1 = RawRocksEngineTest::engine->GetSnapshot();
+  auto snapshot2 = RawRocksEngineTest::engine->GetSnapshot();
+  // no write between, share the same snapshot
+  EXPECT_EQ(snapshot1.get(), snapshot2.get());
+
+  pb::common::KeyValue kv;
+  kv.set_key("shared_snapshot_key");
+  kv.set_value("value");
+  butil::Status ok = RawRocksEngineTest::engine->Writer()->KvPut(kDefaultCf, kv);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  // new write must be visible to new reader
+  auto snapshot3 = RawRocksEngineTest::engine->GetSnapshot();
+  EXPECT_NE(snapshot1.get(), snapshot3.get());
+
+  std::string value;
+  ok = RawRocksEngineTest::engine->Reader()->KvGet(kDefaultCf, snapshot3, kv.key(), value);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  ok = RawRocksEngineTest::engine->Reader()->KvGet(kDefaultCf, snapshot1, kv.key(), value);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::EKEY_NOT_FOUND);
+}
+
 TEST_F(RawRocksEngineTest, Flush) {
   const std::string &cf_name = kDefaultCf;
 
@@ -583,6 +606,170 @@ TEST_F(RawRocksEngineTest, KvGet) {
   }
 }
 
+TEST_F(RawRocksEngineTest, KvMultiGet) {
+  const std::string &cf_name = kDefaultCf;
+  auto writer = RawRocksEngineTest::engine->Writer();
+  auto reader = RawRocksEngineTest::engine->Reader();
+
+  std::vector<pb::common::KeyValue> kvs;
+  for (int i = 0; i < 10; ++i) {
+    pb::common::KeyValue kv;
+    kv.set_key("multi_get_key" + std::to_string(i));
+    kv.set_value("multi_get_value" + std::to_string(i));
+    kvs.push_back(kv);
+  }
+  butil::Status ok = writer->KvBatchPut(cf_name, kvs);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  // key empty
+  {
+    std::vector<std::string> keys{"multi_get_key1", ""};
+    std::vector<std::string> values;
+    std::vector<bool> key_states;
+
+    ok = reader->KvMultiGet(cf_name, keys, values, key_states);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::EKEY_EMPTY);
+  }
+
+  // unsorted keys with some not exist
+  {
+    std::vector<std::string> keys{"multi_get_key7", "multi_get_key_not_exist", "multi_get_key2", "multi_get_key0"};
+    std::vector<std::string> values;
+    std::vector<bool> key_states;
+
+    ok = reader->KvMultiGet(cf_name, RawRocksEngineTest::engine->GetSnapshot(), keys, values, key_states);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    EXPECT_EQ(keys.size(), values.size());
+    EXPECT_EQ(keys.size(), key_states.size());
+
+    EXPECT_TRUE(key_states[0]);
+    EXPECT_EQ("multi_get_value7", values[0]);
+    EXPECT_FALSE(key_states[1]);
+    EXPECT_TRUE(key_states[2]);
+    EXPECT_EQ("multi_get_value2", values[2]);
+    EXPECT_TRUE(key_states[3]);
+    EXPECT_EQ("multi_get_value0", values[3]);
+  }
+}
+
+TEST_F(RawRocksEngineTest, KvBulkIngest) {
+  const std::string &cf_name = kDefaultCf;
+  auto writer = RawRocksEngineTest::engine->Writer();
+  auto reader = RawRocksEngineTest::engine->Reader();
+
+  // empty
+  {
+    std::vector<pb::common::KeyValue> kvs;
+    butil::Status ok = writer->KvBulkIngest(cf_name, kvs);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::EKEY_EMPTY);
+  }
+
+  // sorted kvs ingest sst, overwrite exist key
+  {
+    pb::common::KeyValue kv;
+    kv.set_key("bulk_ingest_key0");
+    kv.set_value("old_value");
+    butil::Status ok = writer->KvPut(cf_name, kv);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+    std::vector<pb::common::KeyValue> kvs;
+    for (int i = 0; i < 10; ++i) {
+      kv.set_key("bulk_ingest_key" + std::to_string(i));
+      kv.set_value("bulk_ingest_value" + std::to_string(i));
+      kvs.push_back(kv);
+    }
+    ok = writer->KvBulkIngest(cf_name, kvs);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+    for (const auto &kv : kvs) {
+      std::string value;
+      ok = reader->KvGet(cf_name, kv.key(), value);
+      EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+      EXPECT_EQ(kv.value(), value);
+    }
+  }
+
+  // unsorted kvs fallback batch put
+  {
+    std::vector<pb::common::KeyValue> kvs;
+    for (int i = 9; i >= 0; --i) {
+      pb::common::KeyValue kv;
+      kv.set_key("bulk_ingest_unsorted_key" + std::to_string(i));
+      kv.set_value("bulk_ingest_unsorted_value" + std::to_string(i));
+      kvs.push_back(kv);
+    }
+    butil::Status ok = writer->KvBulkIngest(cf_name, kvs);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+    for (const auto &kv : kvs) {
+      std::string value;
+      ok = reader->KvGet(cf_name, kv.key(), value);
+      EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+      EXPECT_EQ(kv.value(), value);
+    }
+  }
+}
+
+TEST_F(RawRocksEngineTest, SetColumnFamilyProfile) {
+  // not exist column family
+  butil::Status ok = RawRocksEngineTest::engine->SetColumnFamilyProfile("not_exist_cf", "point_lookup");
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::EILLEGAL_PARAMTETERS);
+
+  // not exist profile
+  ok = RawRocksEngineTest::engine->SetColumnFamilyProfile(kDefaultCf, "not_exist_profile");
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::EILLEGAL_PARAMTETERS);
+
+  ok = RawRocksEngineTest::engine->SetColumnFamilyProfile(kDefaultCf, "point_lookup");
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  // read and write still work after switch
+  auto writer = RawRocksEngineTest::engine->Writer();
+  auto reader = RawRocksEngineTest::engine->Reader();
+  pb::common::KeyValue kv;
+  kv.set_key("profile_key");
+  kv.set_value("profile_value");
+  ok = writer->KvPut(kDefaultCf, kv);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  std::string value;
+  ok = reader->KvGet(kDefaultCf, kv.key(), value);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  EXPECT_EQ(kv.value(), value);
+
+  ok = RawRocksEngineTest::engine->SetColumnFamilyProfile(kDefaultCf, "default");
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+}
+
+TEST_F(RawRocksEngineTest, CompactRange) {
+  auto writer = RawRocksEngineTest::engine->Writer();
+  auto reader = RawRocksEngineTest::engine->Reader();
+
+  std::vector<pb::common::KeyValue> kvs;
+  for (int i = 0; i < 100; i++) {
+    pb::common::KeyValue kv;
+    kv.set_key("compact_key" + std::to_string(i));
+    kv.set_value("value" + std::to_string(i));
+    kvs.push_back(kv);
+  }
+  butil::Status ok = writer->KvBatchPut(kDefaultCf, kvs);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  RawRocksEngineTest::engine->Flush(kDefaultCf);
+
+  pb::common::Range range;
+  range.set_start_key("compact_key");
+  range.set_end_key("compact_kez");
+  ok = writer->KvDeleteRange(kDefaultCf, range);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  ok = RawRocksEngineTest::engine->CompactRange(kDefaultCf, range);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  int64_t count = 0;
+  ok = reader->KvCount(kDefaultCf, range.start_key(), range.end_key(), count);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  EXPECT_EQ(0, count);
+}
+
 #ifdef TEST_KV_BATCH_GET_SWITCH
 TEST_F(RawRocksEngineTest, KvBatchGet) {
   const std::string &cf_name = kDefaultCf;
@@ -1637,6 +1824,36 @@ TEST_F(RawRocksEngineTest, IteratorPerf) {
   EXPECT_GE(count, 1);
 }
 
+TEST_F(RawRocksEngineTest, GetApproximateKeyCount) {
+  auto writer = RawRocksEngineTest::engine->Writer();
+
+  std::string prefix = "APPROXIMATE";
+  int64_t num = 10000;
+  for (int64_t i = 0; i < num; ++i) {
+    pb::common::KeyValue kv;
+    kv.set_key(prefix + fmt::format("{:08}", i));
+    kv.set_value(GenRandomString(64));
+    writer->KvPut(kDefaultCf, kv);
+  }
+
+  pb::common::Range range;
+  range.set_start_key(prefix);
+  range.set_end_key(dingodb::Helper::PrefixNext(prefix));
+
+  // in memtable
+  int64_t count = 0;
+  auto status = RawRocksEngineTest::engine->GetApproximateKeyCount(kDefaultCf, range, count);
+  EXPECT_TRUE(status.ok()) << status.error_str();
+  EXPECT_GT(count, 0);
+
+  // in sst
+  RawRocksEngineTest::engine->Flush(kDefaultCf);
+  status = RawRocksEngineTest::engine->GetApproximateKeyCount(kDefaultCf, range, count);
+  EXPECT_TRUE(status.ok()) << status.error_str();
+  EXPECT_GT(count, num / 2);
+  EXPECT_LT(count, num * 2);
+}
+
 // TEST_F(RawRocksEngineTest, Checkpoint) {
 //   auto writer = RawRocksEngineTest::engine->Writer();
 
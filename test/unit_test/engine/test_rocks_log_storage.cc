@@ -830,6 +830,49 @@ TEST_F(RocksLogStorageTest, AppendByMultiProducer) {
   log_storage->Close();
 }
 
+TEST_F(RocksLogStorageTest, LogEntryCache) {
+  dingodb::wal::LogEntryCache cache;
+  int64_t region_id = 300001;
+
+  cache.Append(region_id, GenLogEntries({{region_id, 1, 10, 1, dingodb::wal::LogEntryType::kEntryTypeData}}));
+  ASSERT_TRUE(cache.Bytes() > 0);
+
+  auto log_entry = cache.Get(region_id, 5);
+  ASSERT_TRUE(log_entry != nullptr);
+  EXPECT_EQ(5, log_entry->index);
+  EXPECT_TRUE(cache.Get(region_id, 11) == nullptr);
+
+  std::vector<dingodb::wal::LogEntryPtr> log_entries;
+  EXPECT_EQ(3, cache.Get(region_id, 3, 8, log_entries));
+  ASSERT_EQ(5, log_entries.size());
+  EXPECT_EQ(3, log_entries.front()->index);
+  EXPECT_EQ(7, log_entries.back()->index);
+
+  // conflict entries are replaced
+  cache.Append(region_id, GenLogEntries({{region_id, 8, 12, 2, dingodb::wal::LogEntryType::kEntryTypeData}}));
+  EXPECT_EQ(1, cache.Get(region_id, 7)->term);
+  EXPECT_EQ(2, cache.Get(region_id, 8)->term);
+  EXPECT_EQ(12, cache.Get(region_id, 12)->index);
+
+  cache.TruncatePrefix(region_id, 6);
+  EXPECT_TRUE(cache.Get(region_id, 5) == nullptr);
+  log_entries.clear();
+  EXPECT_EQ(6, cache.Get(region_id, 1, 100, log_entries));
+  EXPECT_EQ(7, log_entries.size());
+
+  cache.TruncateSuffix(region_id, 9);
+  EXPECT_TRUE(cache.Get(region_id, 10) == nullptr);
+
+  // not contiguous entries reset cache
+  cache.Append(region_id, GenLogEntries({{region_id, 20, 21, 2, dingodb::wal::LogEntryType::kEntryTypeData}}));
+  EXPECT_TRUE(cache.Get(region_id, 9) == nullptr);
+  EXPECT_TRUE(cache.Get(region_id, 20) != nullptr);
+
+  cache.Erase(region_id);
+  EXPECT_TRUE(cache.Get(region_id, 20) == nullptr);
+  EXPECT_EQ(0, cache.Bytes());
+}
+
 TEST_F(RocksLogStorageTest, Perf) {
   GTEST_SKIP() << "skip...";
 
@@ -0,0 +1,139 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "common/helper.h"
+#include "engine/row_cache.h"
+#include "mvcc/codec.h"
+
+namespace dingodb {
+
+class RowCacheTest : public testing::Test {
+ protected:
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+TEST_F(RowCacheTest, GetAndPut) {
+  auto row_cache = RowCache::New(1024 * 1024, 0, 4);
+
+  std::string encode_key = mvcc::Codec::EncodeBytes("key1");
+  std::string value;
+  EXPECT_FALSE(row_cache->Get(encode_key, INT64_MAX, value));
+
+  row_cache->Put(1, encode_key, INT64_MAX, "value1", 0, row_cache->GetSeq(encode_key));
+  EXPECT_TRUE(row_cache->Get(encode_key, INT64_MAX, value));
+  EXPECT_EQ("value1", value);
+
+  // other read ts is not hit
+  EXPECT_FALSE(row_cache->Get(encode_key, 100, value));
+
+  // expired value is not hit
+  std::string ttl_encode_key = mvcc::Codec::EncodeBytes("key2");
+  row_cache->Put(1, ttl_encode_key, INT64_MAX, "value2", Helper::TimestampMs() - 1000,
+                 row_cache->GetSeq(ttl_encode_key));
+  EXPECT_FALSE(row_cache->Get(ttl_encode_key, INT64_MAX, value));
+
+  EXPECT_EQ(2, row_cache->Size());
+  EXPECT_EQ(row_cache->MemoryUsage(), row_cache->RegionMemoryUsage(1));
+}
+
+TEST_F(RowCacheTest, Invalidate) {
+  auto row_cache = RowCache::New(1024 * 1024, 0, 4);
+
+  std::string encode_key = mvcc::Codec::EncodeBytes("key1");
+  row_cache->Put(1, encode_key, INT64_MAX, "value1", 0, row_cache->GetSeq(encode_key));
+  row_cache->Put(1, encode_key, 100, "value0", 0, row_cache->GetSeq(encode_key));
+
+  // write key with ts invalidate all cached ts of the key
+  std::string encode_key_with_ts = mvcc::Codec::EncodeKey(std::string("key1"), 200);
+  row_cache->Invalidate(mvcc::Codec::TruncateTsForKey(encode_key_with_ts));
+
+  std::string value;
+  EXPECT_FALSE(row_cache->Get(encode_key, INT64_MAX, value));
+  EXPECT_FALSE(row_cache->Get(encode_key, 100, value));
+  EXPECT_EQ(0, row_cache->Size());
+  EXPECT_EQ(0, row_cache->MemoryUsage());
+  EXPECT_EQ(0, row_cache->RegionMemoryUsage(1));
+}
+
+TEST_F(RowCacheTest, StaleFill) {
+  auto row_cache = RowCache::New(1024 * 1024, 0, 4);
+
+  std::string encode_key = mvcc::Codec::EncodeBytes("key1");
+  uint64_t seq = row_cache->GetSeq(encode_key);
+
+  // write happened between read engine and fill cache
+  row_cache->Invalidate(encode_key);
+  row_cache->Put(1, encode_key, INT64_MAX, "stale_value", 0, seq);
+
+  std::string value;
+  EXPECT_FALSE(row_cache->Get(encode_key, INT64_MAX, value));
+}
+
+TEST_F(RowCacheTest, InvalidateRange) {
+  auto row_cache = RowCache::New(1024 * 1024, 0, 4);
+
+  for (int i = 0; i < 10; ++i) {
+    std::string encode_key = mvcc::Codec::EncodeBytes("key" + std::to_string(i));
+    row_cache->Put(1, encode_key, INT64_MAX, "value", 0, row_cache->GetSeq(encode_key));
+  }
+  EXPECT_EQ(10, row_cache->Size());
+
+  // start key with ts, key3 should be invalidated too
+  auto range = mvcc::Codec::EncodeRange("key3", "key6");
+  row_cache->InvalidateRange(mvcc::Codec::EncodeKey(std::string("key3"), 100), range.end_key());
+
+  std::string value;
+  for (int i = 0; i < 10; ++i) {
+    std::string encode_key = mvcc::Codec::EncodeBytes("key" + std::to_string(i));
+    EXPECT_EQ(i < 3 || i >= 6, row_cache->Get(encode_key, INT64_MAX, value)) << i;
+  }
+
+  row_cache->Clear();
+  EXPECT_EQ(0, row_cache->Size());
+}
+
+TEST_F(RowCacheTest, Capacity) {
+  std::string value(64, 'a');
+
+  // region budget
+  auto row_cache = RowCache::New(1024 * 1024, 1024, 1);
+  for (int i = 0; i < 100; ++i) {
+    std::string encode_key = mvcc::Codec::EncodeBytes("key" + std::to_string(i));
+    row_cache->Put(1, encode_key, INT64_MAX, value, 0, row_cache->GetSeq(encode_key));
+  }
+  EXPECT_LE(row_cache->RegionMemoryUsage(1), 1024);
+  EXPECT_GT(row_cache->Size(), 0);
+
+  std::string encode_key = mvcc::Codec::EncodeBytes("other_region_key");
+  row_cache->Put(2, encode_key, INT64_MAX, value, 0, row_cache->GetSeq(encode_key));
+  EXPECT_TRUE(row_cache->Get(encode_key, INT64_MAX, value));
+
+  // total capacity evict lru
+  auto small_row_cache = RowCache::New(2048, 0, 1);
+  for (int i = 0; i < 100; ++i) {
+    std::string encode_key = mvcc::Codec::EncodeBytes("key" + std::to_string(i));
+    small_row_cache->Put(1, encode_key, INT64_MAX, value, 0, small_row_cache->GetSeq(encode_key));
+  }
+  EXPECT_LE(small_row_cache->MemoryUsage(), 2048);
+  EXPECT_TRUE(small_row_cache->Get(mvcc::Codec::EncodeBytes("key99"), INT64_MAX, value));
+  EXPECT_FALSE(small_row_cache->Get(mvcc::Codec::EncodeBytes("key0"), INT64_MAX, value));
+}
+
+}  // namespace dingodb
@@ -23,6 +23,7 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "coordinator/balance_leader.h"
+#include "coordinator/region_load_stat.h"
 #include "proto/common.pb.h"
 
 class CandidateStoresTest : public testing::Test {
@@ -412,4 +413,28 @@ TEST_F(BalanceLeaderSchedulerTest, ParseTimePeriod) {
     ASSERT_EQ(2, time_periods[0].first);
     ASSERT_EQ(4, time_periods[0].second);
   }
-}
\ No newline at end of file
+}
+TEST_F(BalanceLeaderSchedulerTest, RegionLoadStat) {
+  dingodb::RegionLoadStat load_stat;
+  int64_t now_ms = dingodb::Helper::TimestampMs();
+
+  // first heartbeat only set base
+  load_stat.Update(1, 1000, now_ms);
+  ASSERT_EQ(0, load_stat.GetWriteBytesRate(1, now_ms));
+
+  // 10MB in 10s, smoothed with previous rate
+  load_stat.Update(1, 1000 + 10 * 1024 * 1024, now_ms + 10000);
+  ASSERT_EQ(512 * 1024, load_stat.GetWriteBytesRate(1, now_ms + 10000));
+
+  // too close heartbeat is ignored
+  load_stat.Update(1, 1000, now_ms + 10500);
+  ASSERT_EQ(512 * 1024, load_stat.GetWriteBytesRate(1, now_ms + 10500));
+
+  // no heartbeat for a long time is cold
+  ASSERT_EQ(0, load_stat.GetWriteBytesRate(1, now_ms + 3600 * 1000));
+  ASSERT_EQ(0, load_stat.GetWriteBytesRate(2, now_ms));
+
+  ASSERT_FALSE(load_stat.IsCoolingDown(1));
+  load_stat.MarkMoved(1);
+  ASSERT_TRUE(load_stat.IsCoolingDown(1));
+}
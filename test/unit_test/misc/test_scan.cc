@@ -35,6 +35,7 @@
 #include "config/yaml_config.h"
 #include "crontab/crontab.h"
 #include "engine/rocks_raw_engine.h"
+#include "gflags/gflags.h"
 #include "gtest/gtest.h"
 #include "mvcc/codec.h"
 #include "proto/common.pb.h"
@@ -43,6 +44,8 @@
 
 namespace dingodb {
 
+DECLARE_bool(enable_scan_prefetch);
+
 static const std::string &kDefaultCf = "default";  // NOLINT
 
 static const std::vector<std::string> kAllCFs = {kDefaultCf};
@@ -802,6 +805,51 @@ TEST_F(ScanTest, scan) {
   this->DeleteScan();
 }
 
+TEST_F(ScanTest, ScanPrefetch) {
+  auto raw_rocks_engine = this->GetRawRocksEngine();
+  auto mvcc_reader = dingodb::mvcc::KvReader::New(raw_rocks_engine->Reader());
+
+  pb::common::Range range;
+  range.set_start_key("keyAA");
+  range.set_end_key("keyZZ");
+
+  // fetch count of continue is different from prefetch, prefetched kvs are kept for next continue.
+  auto scan_keys = [&](bool enable_prefetch) -> std::vector<std::string> {
+    bool old_enable_prefetch = FLAGS_enable_scan_prefetch;
+    FLAGS_enable_scan_prefetch = enable_prefetch;
+
+    std::string scan_id;
+    auto scan = this->GetScan(&scan_id);
+    EXPECT_TRUE(scan->Open(scan_id, mvcc_reader, kDefaultCf, 0).ok());
+
+    std::vector<pb::common::KeyValue> kvs;
+    EXPECT_TRUE(ScanHandler::ScanBegin(scan, 1, range, 2, true, false, true, {}, &kvs).ok());
+
+    std::vector<int64_t> max_fetch_cnts = {1, 3};
+    for (size_t i = 0;; ++i) {
+      bool has_more = false;
+      EXPECT_TRUE(ScanHandler::ScanContinue(scan, scan_id, max_fetch_cnts[i % 2], &kvs, has_more).ok());
+      if (!has_more) {
+        break;
+      }
+    }
+    EXPECT_TRUE(ScanHandler::ScanRelease(scan, scan_id).ok());
+    this->DeleteScan();
+
+    FLAGS_enable_scan_prefetch = old_enable_prefetch;
+
+    std::vector<std::string> keys;
+    for (const auto &kv : kvs) {
+      keys.push_back(kv.key());
+    }
+    return keys;
+  };
+
+  auto keys = scan_keys(false);
+  EXPECT_FALSE(keys.empty());
+  EXPECT_EQ(keys, scan_keys(true));
+}
+
 TEST_F(ScanTest, Init2) {
   auto raw_rocks_engine = this->GetRawRocksEngine();
   std::string scan_id;
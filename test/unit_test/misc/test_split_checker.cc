@@ -24,6 +24,7 @@
 #include "common/helper.h"
 #include "config/yaml_config.h"
 #include "engine/rocks_raw_engine.h"
+#include "fmt/core.h"
 #include "proto/common.pb.h"
 #include "split/split_checker.h"
 
@@ -293,4 +294,39 @@ TEST_F(SplitCheckerTest, KeysSplitKeys) {  // NOLINT
   writer->KvDeleteRange(kAllCFs, range);
 }
 
+TEST_F(SplitCheckerTest, LoadSplitKey) {  // NOLINT
+  // too few samples
+  {
+    std::vector<std::string> sample_keys = {"a", "b", "c"};
+    EXPECT_TRUE(LoadSplitChecker::CalcSplitKey(sample_keys).empty());
+  }
+
+  // split at median
+  {
+    std::vector<std::string> sample_keys;
+    for (int i = 31; i >= 0; --i) {
+      sample_keys.push_back(fmt::format("key{:04}", i));
+    }
+    EXPECT_EQ("key0016", LoadSplitChecker::CalcSplitKey(sample_keys));
+  }
+
+  // median is a hot key, split at its boundary
+  {
+    std::vector<std::string> sample_keys;
+    for (int i = 0; i < 8; ++i) {
+      sample_keys.push_back(fmt::format("key{:04}", i));
+    }
+    for (int i = 0; i < 12; ++i) {
+      sample_keys.push_back("key1000");
+    }
+    EXPECT_EQ("key1000", LoadSplitChecker::CalcSplitKey(sample_keys));
+  }
+
+  // all requests on one key can not split
+  {
+    std::vector<std::string> sample_keys(32, "key0001");
+    EXPECT_TRUE(LoadSplitChecker::CalcSplitKey(sample_keys).empty());
+  }
+}
+
 }  // namespace dingodb
\ No newline at end of file
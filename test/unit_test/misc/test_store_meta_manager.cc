@@ -15,10 +15,16 @@
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <set>
 #include <string>
 
+#include "gflags/gflags.h"
 #include "meta/store_meta_manager.h"
 
+namespace dingodb {
+DECLARE_int32(region_history_state_max_num);
+}  // namespace dingodb
+
 class StoreRegionMetaTest : public testing::Test {
  protected:
   void SetUp() override {}
@@ -41,4 +47,50 @@ TEST_F(StoreRegionMetaTest, AddRegion) {
   auto region = store_region_mata->GetRegion(1001);
   EXPECT_NE(nullptr, region);
   EXPECT_EQ(1001, region->Id());
-}
\ No newline at end of file
+}
+TEST_F(StoreRegionMetaTest, HistoryStateBounded) {
+  dingodb::pb::common::RegionDefinition definition;
+  definition.set_id(1002);
+  auto region = dingodb::store::Region::New(definition);
+  int64_t init_memory_size = region->MemorySize();
+  EXPECT_GT(init_memory_size, 0);
+
+  for (int i = 0; i < dingodb::FLAGS_region_history_state_max_num * 10; ++i) {
+    region->AppendHistoryState(dingodb::pb::common::StoreRegionState::NORMAL);
+  }
+  region->AppendHistoryState(dingodb::pb::common::StoreRegionState::DELETING);
+
+  dingodb::store::Region new_region(1002);
+  new_region.DeSerialize(region->Serialize());
+  EXPECT_EQ(new_region.InnerRegion().history_states_size(), dingodb::FLAGS_region_history_state_max_num);
+  EXPECT_EQ(dingodb::pb::common::StoreRegionState::DELETING,
+            new_region.InnerRegion().history_states(dingodb::FLAGS_region_history_state_max_num - 1));
+}
+
+TEST_F(StoreRegionMetaTest, ResolvedTsSkipLockCheck) {
+  dingodb::pb::common::RegionDefinition definition;
+  definition.set_id(1003);
+  auto region = dingodb::store::Region::New(definition);
+
+  auto lock_entry = std::make_shared<dingodb::ConcurrencyManager::LockEntry>();
+  lock_entry->lock_info.set_key("key1");
+  lock_entry->lock_info.set_lock_ts(100);
+  lock_entry->lock_info.set_min_commit_ts(101);
+  region->LockKey("key1", lock_entry);
+
+  std::set<int64_t> resolved_locks;
+  dingodb::pb::store::TxnResultInfo txn_result_info;
+  EXPECT_TRUE(region->CheckKeys({"key1"}, dingodb::pb::store::IsolationLevel::SnapshotIsolation, 200, resolved_locks,
+                                txn_result_info));
+
+  // resolved ts only move forward
+  region->SetResolvedTs(200);
+  region->SetResolvedTs(150);
+  EXPECT_EQ(200, region->ResolvedTs());
+  EXPECT_FALSE(region->CheckKeys({"key1"}, dingodb::pb::store::IsolationLevel::SnapshotIsolation, 200, resolved_locks,
+                                 txn_result_info));
+
+  region->ResetResolvedTs();
+  EXPECT_TRUE(region->CheckKeys({"key1"}, dingodb::pb::store::IsolationLevel::SnapshotIsolation, 200, resolved_locks,
+                                txn_result_info));
+}
@@ -0,0 +1,88 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "coordinator/tso_control.h"
+#include "proto/error.pb.h"
+#include "proto/meta.pb.h"
+
+namespace dingodb {
+
+class TsoBatcherTest : public testing::Test {};
+
+struct GenTsoArg {
+  TsoBatcher* batcher;
+  std::atomic<int64_t>* alloc_count;
+  int64_t count;
+  pb::meta::TsoResponse response;
+};
+
+static void* GenTsoRoutine(void* arg) {
+  auto* gen_arg = static_cast<GenTsoArg*>(arg);
+  pb::meta::TsoRequest request;
+  request.set_op_type(pb::meta::OP_GEN_TSO);
+  request.set_count(gen_arg->count);
+
+  static std::atomic<int64_t> logical{0};
+  gen_arg->batcher->GenTso(&request, &gen_arg->response, [&](int64_t count, pb::meta::TsoResponse* response) {
+    gen_arg->alloc_count->fetch_add(1);
+    response->mutable_start_timestamp()->set_physical(1000);
+    response->mutable_start_timestamp()->set_logical(logical.fetch_add(count));
+    response->set_count(count);
+    bthread_usleep(1000);
+  });
+  return nullptr;
+}
+
+TEST_F(TsoBatcherTest, SplitRange) {
+  const int kCount = 64;
+  TsoBatcher batcher;
+  std::atomic<int64_t> alloc_count{0};
+
+  std::vector<GenTsoArg> args(kCount);
+  std::vector<bthread_t> tids(kCount);
+  for (int i = 0; i < kCount; ++i) {
+    args[i].batcher = &batcher;
+    args[i].alloc_count = &alloc_count;
+    args[i].count = i % 3 + 1;
+    ASSERT_EQ(0, bthread_start_background(&tids[i], nullptr, GenTsoRoutine, &args[i]));
+  }
+  for (auto tid : tids) {
+    bthread_join(tid, nullptr);
+  }
+
+  // concurrent requests are coalesced, and every request get a distinct logical range.
+  EXPECT_LT(alloc_count.load(), kCount);
+  std::vector<std::pair<int64_t, int64_t>> ranges;
+  for (const auto& arg : args) {
+    ASSERT_EQ(pb::error::Errno::OK, arg.response.error().errcode());
+    EXPECT_EQ(arg.count, arg.response.count());
+    int64_t logical = arg.response.start_timestamp().logical();
+    ranges.emplace_back(logical, logical + arg.count);
+  }
+  std::sort(ranges.begin(), ranges.end());
+  for (size_t i = 1; i < ranges.size(); ++i) {
+    EXPECT_EQ(ranges[i - 1].second, ranges[i].first);
+  }
+}
+
+}  // namespace dingodb
@@ -15,7 +15,9 @@
 #include <gtest/gtest.h>
 
 #include <cstdint>
+#include <iostream>
 #include <string>
+#include <string_view>
 
 #include "common/helper.h"
 #include "mvcc/codec.h"
@@ -395,4 +397,71 @@ TEST_F(MvccCodecTest, PackageValue) {
   }
 }
 
-}  // namespace dingodb
\ No newline at end of file
+TEST_F(MvccCodecTest, EncodeDecodeWithBuffer) {
+  for (int len = 0; len <= 33; ++len) {
+    std::string user_key;
+    for (int i = 0; i < len; ++i) {
+      user_key.push_back(static_cast<char>(i % 3 == 0 ? 0xff : i));
+    }
+
+    // encode bytes
+    std::string expect_encode_bytes = mvcc::Codec::EncodeBytes(user_key);
+    ASSERT_EQ(mvcc::Codec::EncodeBytesLength(user_key.size()), expect_encode_bytes.size());
+
+    char buf[64];
+    size_t length = mvcc::Codec::EncodeBytes(user_key, buf);
+    ASSERT_EQ(expect_encode_bytes, std::string(buf, length));
+
+    // decode bytes
+    char plain_buf[64];
+    size_t plain_length = 0;
+    ASSERT_TRUE(mvcc::Codec::DecodeBytes(expect_encode_bytes, plain_buf, plain_length));
+    ASSERT_EQ(user_key, std::string(plain_buf, plain_length));
+
+    // encode key
+    std::string expect_encode_key = mvcc::Codec::EncodeKey(user_key, 123456789);
+    ASSERT_EQ(mvcc::Codec::EncodeKeyLength(user_key.size()), expect_encode_key.size());
+
+    length = mvcc::Codec::EncodeKey(user_key, 123456789, buf);
+    ASSERT_EQ(expect_encode_key, std::string(buf, length));
+
+    // reuse output
+    std::string output = "dirty data";
+    mvcc::Codec::EncodeKey(user_key, 123456789, output);
+    ASSERT_EQ(expect_encode_key, output);
+
+    std::string actual_user_key;
+    int64_t ts = 0;
+    ASSERT_TRUE(mvcc::Codec::DecodeKey(output, actual_user_key, ts));
+    ASSERT_EQ(user_key, actual_user_key);
+    ASSERT_EQ(123456789, ts);
+  }
+}
+
+TEST_F(MvccCodecTest, Performance) {
+  GTEST_SKIP() << "Performence test, skip...";
+
+  std::string user_key = "hello world 123456";
+  constexpr int kLoopCount = 10000000;
+
+  int64_t start_time = Helper::TimestampMs();
+  for (int i = 0; i < kLoopCount; ++i) {
+    std::string encode_key = mvcc::Codec::EncodeKey(user_key, i);
+    std::string plain_key;
+    int64_t ts = 0;
+    mvcc::Codec::DecodeKey(encode_key, plain_key, ts);
+  }
+  std::cout << "string encode/decode elapsed time: " << Helper::TimestampMs() - start_time << "ms" << std::endl;
+
+  start_time = Helper::TimestampMs();
+  char buf[mvcc::Codec::EncodeKeyLength(64)];
+  char plain_buf[64];
+  for (int i = 0; i < kLoopCount; ++i) {
+    size_t length = mvcc::Codec::EncodeKey(user_key, i, buf);
+    size_t plain_length = 0;
+    mvcc::Codec::DecodeBytes(std::string_view(buf, length - 8), plain_buf, plain_length);
+  }
+  std::cout << "buffer encode/decode elapsed time: " << Helper::TimestampMs() - start_time << "ms" << std::endl;
+}
+
+}  // namespace dingodb
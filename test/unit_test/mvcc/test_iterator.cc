@@ -20,11 +20,14 @@
 #include "common/helper.h"
 #include "config/yaml_config.h"
 #include "engine/rocks_raw_engine.h"
+#include "gflags/gflags.h"
 #include "mvcc/codec.h"
 #include "mvcc/iterator.h"
 
 namespace dingodb {
 
+DECLARE_int32(mvcc_iterator_max_sequential_skip);
+
 static const std::string kDefaultCf = "default";
 static const std::vector<std::string> kAllCFs = {kDefaultCf};
 
@@ -234,6 +237,138 @@ TEST_F(MvccIteratorTest, BackwardIterator) {
   writer->KvDeleteRange(kDefaultCf, range);
 }
 
+TEST_F(MvccIteratorTest, BackwardIteratorSkipManyVersions) {
+  FLAGS_mvcc_iterator_max_sequential_skip = 2;
+
+  // arrange data, hello1 and hello2 has many versions
+  auto writer = engine->Writer();
+
+  std::vector<pb::common::KeyValue> kvs;
+  for (int i = 0; i < 50; ++i) {
+    pb::common::KeyValue kv;
+    kv.set_key("hello1");
+    kv.set_value(GenRandomString(16));
+    kvs.push_back(mvcc::Codec::EncodeKeyValueWithPut(100000 + i, kv));
+  }
+  for (int i = 0; i < 50; ++i) {
+    pb::common::KeyValue kv;
+    kv.set_key("hello2");
+    kv.set_value(GenRandomString(16));
+    kvs.push_back(mvcc::Codec::EncodeKeyValueWithPut(100000 + i, kv));
+  }
+  {
+    pb::common::KeyValue kv;
+    kv.set_key("hello3");
+    kv.set_value(GenRandomString(16));
+    kvs.push_back(mvcc::Codec::EncodeKeyValueWithPut(100000, kv));  // offset 100
+  }
+
+  writer->KvBatchPutAndDelete(kDefaultCf, kvs, {});
+
+  std::string start_key = mvcc::Codec::EncodeBytes("hello1");
+  std::string end_key = mvcc::Codec::EncodeBytes("hello4");
+  dingodb::IteratorOptions options;
+  options.upper_bound = end_key;
+
+  // read latest version
+  {
+    auto reader = engine->Reader();
+    auto iter = std::make_shared<mvcc::Iterator>(0, reader->NewIterator(kDefaultCf, options));
+    iter->Seek(start_key);
+    ASSERT_TRUE(iter->Valid());
+    EXPECT_EQ(kvs[49].key(), iter->Key());  // hello1+100049
+    iter->Next();
+    ASSERT_TRUE(iter->Valid());
+    EXPECT_EQ(kvs[99].key(), iter->Key());  // hello2+100049
+    iter->Next();
+    ASSERT_TRUE(iter->Valid());
+    EXPECT_EQ(kvs[100].key(), iter->Key());  // hello3+100000
+    iter->Next();
+    ASSERT_FALSE(iter->Valid());
+  }
+
+  // read old version, skip many newer versions
+  {
+    auto reader = engine->Reader();
+    auto iter = std::make_shared<mvcc::Iterator>(100010, reader->NewIterator(kDefaultCf, options));
+    iter->Seek(start_key);
+    ASSERT_TRUE(iter->Valid());
+    EXPECT_EQ(kvs[10].key(), iter->Key());  // hello1+100010
+    iter->Next();
+    ASSERT_TRUE(iter->Valid());
+    EXPECT_EQ(kvs[60].key(), iter->Key());  // hello2+100010
+    iter->Next();
+    ASSERT_TRUE(iter->Valid());
+    EXPECT_EQ(kvs[100].key(), iter->Key());  // hello3+100000
+    iter->Next();
+    ASSERT_FALSE(iter->Valid());
+  }
+
+  FLAGS_mvcc_iterator_max_sequential_skip = 8;
+
+  // clear data
+  pb::common::Range range;
+  range.set_start_key("hello");
+  range.set_end_key("hellz");
+  writer->KvDeleteRange(kDefaultCf, range);
+}
+
+TEST_F(MvccIteratorTest, BackwardIteratorRepeatSeek) {
+  // arrange data, hello2 is deleted
+  auto writer = engine->Writer();
+
+  std::vector<pb::common::KeyValue> kvs;
+  for (const auto* key : {"hello1", "hello2", "hello3", "hello5"}) {
+    pb::common::KeyValue kv;
+    kv.set_key(key);
+    kv.set_value(GenRandomString(16));
+    kvs.push_back(mvcc::Codec::EncodeKeyValueWithPut(100000, kv));
+    kvs.push_back(mvcc::Codec::EncodeKeyValueWithPut(100001, kv));
+  }
+  {
+    pb::common::KeyValue kv;
+    kv.set_key("hello2");
+    kvs.push_back(mvcc::Codec::EncodeKeyValueWithDelete(100002, kv));  // offset 8
+  }
+
+  writer->KvBatchPutAndDelete(kDefaultCf, kvs, {});
+
+  dingodb::IteratorOptions options;
+  options.upper_bound = mvcc::Codec::EncodeBytes("hello6");
+
+  // batch get sorted keys with one iterator
+  auto reader = engine->Reader();
+  auto iter = std::make_shared<mvcc::Iterator>(0, reader->NewIterator(kDefaultCf, options));
+
+  iter->Seek(mvcc::Codec::EncodeBytes("hello1"));
+  ASSERT_TRUE(iter->Valid());
+  EXPECT_EQ(kvs[1].key(), iter->Key());  // hello1+100001
+
+  // deleted key is skipped
+  iter->Seek(mvcc::Codec::EncodeBytes("hello2"));
+  ASSERT_TRUE(iter->Valid());
+  EXPECT_EQ(kvs[5].key(), iter->Key());  // hello3+100001
+
+  // seek same key again
+  iter->Seek(mvcc::Codec::EncodeBytes("hello3"));
+  ASSERT_TRUE(iter->Valid());
+  EXPECT_EQ(kvs[5].key(), iter->Key());  // hello3+100001
+
+  // not exist key
+  iter->Seek(mvcc::Codec::EncodeBytes("hello4"));
+  ASSERT_TRUE(iter->Valid());
+  EXPECT_EQ(kvs[7].key(), iter->Key());  // hello5+100001
+
+  iter->Seek(mvcc::Codec::EncodeBytes("hello6"));
+  ASSERT_FALSE(iter->Valid());
+
+  // clear data
+  pb::common::Range range;
+  range.set_start_key("hello");
+  range.set_end_key("hellz");
+  writer->KvDeleteRange(kDefaultCf, range);
+}
+
 TEST_F(MvccIteratorTest, BackwardIteratorForDeleteKey) {
   // arrange data
   auto writer = engine->Writer();
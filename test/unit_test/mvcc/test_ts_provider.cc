@@ -26,8 +26,13 @@
 #include "config/yaml_config.h"
 #include "engine/rocks_raw_engine.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "mvcc/ts_provider.h"
 
+DECLARE_uint32(ts_provider_batch_size);
+DECLARE_uint32(ts_provider_max_batch_size);
+DECLARE_uint32(ts_provider_prefetch_window_ms);
+
 namespace dingodb {
 
 const uint32_t kBatchTsSzie = 100;
@@ -86,6 +91,31 @@ TEST_F(BatchTsListTest, SingleThread) {
   EXPECT_EQ(1, batch_ts_list.ActualCount());
 }
 
+TEST_F(BatchTsListTest, NeedPrefetch) {
+  mvcc::BatchTsList batch_ts_list;
+
+  // only empty head
+  EXPECT_TRUE(batch_ts_list.NeedPrefetch(1));
+
+  batch_ts_list.Push(GenBatchTs());
+  // has next BatchTs
+  EXPECT_FALSE(batch_ts_list.NeedPrefetch(kBatchTsSzie));
+
+  for (int i = 0; i < kBatchTsSzie / 2; ++i) {
+    ASSERT_GT(batch_ts_list.GetTs(), 0);
+  }
+  EXPECT_FALSE(batch_ts_list.NeedPrefetch(kBatchTsSzie / 4));
+  EXPECT_TRUE(batch_ts_list.NeedPrefetch(kBatchTsSzie));
+}
+
+TEST_F(BatchTsListTest, CalcBatchSize) {
+  EXPECT_EQ(FLAGS_ts_provider_batch_size, mvcc::TsProvider::CalcBatchSize(0));
+  EXPECT_EQ(FLAGS_ts_provider_max_batch_size, mvcc::TsProvider::CalcBatchSize(INT32_MAX));
+
+  int64_t ts_per_second = FLAGS_ts_provider_batch_size * 1000 / FLAGS_ts_provider_prefetch_window_ms * 2;
+  EXPECT_EQ(FLAGS_ts_provider_batch_size * 2, mvcc::TsProvider::CalcBatchSize(ts_per_second));
+}
+
 TEST_F(BatchTsListTest, MultiThread) {
   mvcc::BatchTsList batch_ts_list;
 
@@ -0,0 +1,90 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "engine/mvcc_ttl_compaction_filter.h"
+#include "mvcc/codec.h"
+
+namespace dingodb {
+
+class MvccTtlCompactionFilterTest : public testing::Test {
+ protected:
+  static std::string GenValue(mvcc::ValueFlag flag, int64_t ttl = 0) {
+    std::string value = "value";
+    if (flag == mvcc::ValueFlag::kPutTTL) {
+      mvcc::Codec::PackageValue(flag, ttl, value);
+    } else {
+      mvcc::Codec::PackageValue(flag, value);
+    }
+    return value;
+  }
+
+  // keys must be fed in compaction order(key asc, ts desc).
+  static bool Filter(const MvccTtlCompactionFilter& filter, const std::string& key, int64_t ts,
+                     const std::string& value, std::string& new_value, bool& value_changed) {
+    new_value.clear();
+    value_changed = false;
+    return filter.Filter(0, mvcc::Codec::EncodeKey(key, ts), value, &new_value, &value_changed);
+  }
+};
+
+TEST_F(MvccTtlCompactionFilterTest, ReclaimExpiredVersion) {
+  // safe point 100, value expire before 1000 is reclaimed.
+  MvccTtlCompactionFilter filter(100, 1000);
+  std::string new_value;
+  bool value_changed = false;
+
+  // key1: expired version above safe point is changed to delete, older versions still needed.
+  EXPECT_FALSE(Filter(filter, "key1", 120, GenValue(mvcc::ValueFlag::kPutTTL, 500), new_value, value_changed));
+  EXPECT_TRUE(value_changed);
+  EXPECT_EQ(mvcc::ValueFlag::kDelete, mvcc::Codec::GetValueFlag(new_value));
+  EXPECT_FALSE(Filter(filter, "key1", 110, GenValue(mvcc::ValueFlag::kPut), new_value, value_changed));
+  EXPECT_FALSE(value_changed);
+
+  // not expired version is kept, older version below it is not dropped.
+  EXPECT_FALSE(Filter(filter, "key1", 90, GenValue(mvcc::ValueFlag::kPutTTL, 2000), new_value, value_changed));
+  EXPECT_FALSE(value_changed);
+  EXPECT_FALSE(Filter(filter, "key1", 80, GenValue(mvcc::ValueFlag::kPut), new_value, value_changed));
+
+  // key2: expired version below safe point hide older versions, they are dropped.
+  EXPECT_FALSE(Filter(filter, "key2", 90, GenValue(mvcc::ValueFlag::kPutTTL, 500), new_value, value_changed));
+  EXPECT_TRUE(value_changed);
+  EXPECT_TRUE(Filter(filter, "key2", 80, GenValue(mvcc::ValueFlag::kPut), new_value, value_changed));
+  EXPECT_TRUE(Filter(filter, "key2", 70, GenValue(mvcc::ValueFlag::kPutTTL, 2000), new_value, value_changed));
+
+  // key3: delete below safe point also hide older versions.
+  EXPECT_FALSE(Filter(filter, "key3", 90, GenValue(mvcc::ValueFlag::kDelete), new_value, value_changed));
+  EXPECT_FALSE(value_changed);
+  EXPECT_TRUE(Filter(filter, "key3", 80, GenValue(mvcc::ValueFlag::kPut), new_value, value_changed));
+}
+
+TEST_F(MvccTtlCompactionFilterTest, NoSafePoint) {
+  // without safe point only expired value is reclaimed, no version is dropped.
+  MvccTtlCompactionFilter filter(0, 1000);
+  std::string new_value;
+  bool value_changed = false;
+
+  EXPECT_FALSE(Filter(filter, "key1", 90, GenValue(mvcc::ValueFlag::kPutTTL, 500), new_value, value_changed));
+  EXPECT_TRUE(value_changed);
+  EXPECT_FALSE(Filter(filter, "key1", 80, GenValue(mvcc::ValueFlag::kPut), new_value, value_changed));
+  EXPECT_FALSE(Filter(filter, "key1", 70, GenValue(mvcc::ValueFlag::kDelete), new_value, value_changed));
+  EXPECT_FALSE(Filter(filter, "key1", 60, GenValue(mvcc::ValueFlag::kPut), new_value, value_changed));
+}
+
+}  // namespace dingodb
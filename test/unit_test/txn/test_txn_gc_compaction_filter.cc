@@ -0,0 +1,84 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "engine/txn_gc_compaction_filter.h"
+#include "mvcc/codec.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+class TxnGcCompactionFilterTest : public testing::Test {
+ protected:
+  static std::string GenWriteValue(pb::store::Op op, int64_t start_ts, const std::string& short_value = "") {
+    pb::store::WriteInfo write_info;
+    write_info.set_op(op);
+    write_info.set_start_ts(start_ts);
+    if (!short_value.empty()) {
+      write_info.set_short_value(short_value);
+    }
+    return write_info.SerializeAsString();
+  }
+
+  // Filter write cf record, keys must be fed in compaction order(key asc, commit_ts desc).
+  static bool Filter(const TxnGcCompactionFilter& filter, const std::string& key, int64_t commit_ts,
+                     const std::string& value) {
+    std::string write_key = mvcc::Codec::EncodeKey(key, commit_ts);
+    std::string new_value;
+    bool value_changed = false;
+    return filter.Filter(0, write_key, value, &new_value, &value_changed);
+  }
+};
+
+TEST_F(TxnGcCompactionFilterTest, DropInvisibleVersion) {
+  std::vector<std::string> deleted_data_keys;
+  {
+    TxnGcCompactionFilter filter(100, [&](const std::vector<std::string>& data_keys) {
+      deleted_data_keys.insert(deleted_data_keys.end(), data_keys.begin(), data_keys.end());
+    });
+
+    // key1: version above safe point and newest visible version are kept.
+    EXPECT_FALSE(Filter(filter, "key1", 120, GenWriteValue(pb::store::Op::Put, 110, "v")));
+    EXPECT_FALSE(Filter(filter, "key1", 90, GenWriteValue(pb::store::Op::Put, 80, "v")));
+    EXPECT_TRUE(Filter(filter, "key1", 70, GenWriteValue(pb::store::Op::Put, 60)));
+    EXPECT_TRUE(Filter(filter, "key1", 50, GenWriteValue(pb::store::Op::Rollback, 50)));
+
+    // key2: newest visible version is delete, older put is dropped.
+    EXPECT_TRUE(Filter(filter, "key2", 95, GenWriteValue(pb::store::Op::Rollback, 95)));
+    EXPECT_FALSE(Filter(filter, "key2", 90, GenWriteValue(pb::store::Op::Delete, 85)));
+    EXPECT_TRUE(Filter(filter, "key2", 40, GenWriteValue(pb::store::Op::Put, 30, "v")));
+
+    // key3: only one visible version.
+    EXPECT_FALSE(Filter(filter, "key3", 40, GenWriteValue(pb::store::Op::Put, 30)));
+  }
+
+  // Data of dropped put version without short value is deleted when filter destroy.
+  ASSERT_EQ(1, deleted_data_keys.size());
+  EXPECT_EQ(mvcc::Codec::EncodeKey(std::string("key1"), 60), deleted_data_keys[0]);
+}
+
+TEST_F(TxnGcCompactionFilterTest, Factory) {
+  TxnGcCompactionFilterFactory factory(nullptr);
+  rocksdb::CompactionFilter::Context context;
+
+  TxnGcCompactionFilterFactory::SetSafePointTs(0);
+  EXPECT_EQ(nullptr, factory.CreateCompactionFilter(context));
+}
+
+}  // namespace dingodb
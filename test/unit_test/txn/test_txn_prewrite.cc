@@ -55,6 +55,8 @@
 
 namespace dingodb {
 
+DECLARE_int64(txn_prewrite_write_batch_count);
+
 static const std::string kDefaultCf = "default";
 
 static const std::vector<std::string> kAllCFs = {Constant::kTxnWriteCF, Constant::kTxnDataCF, Constant::kTxnLockCF,
@@ -1542,6 +1544,107 @@ TEST_F(TxnPreWriteTest, RepeatedComittedPreWriteWithOnePC) {
   }
 }
 
+TEST_F(TxnPreWriteTest, FallbackTo2PCLocks) {
+  std::vector<pb::common::KeyValue> kv_puts_lock;
+  for (int i = 0; i < 3; ++i) {
+    pb::store::LockInfo lock_info;
+    lock_info.set_key("key" + std::to_string(i));
+    lock_info.set_primary_lock("key0");
+    lock_info.set_use_async_commit(i != 2);
+    if (i == 0) {
+      lock_info.add_secondaries("key1");
+      lock_info.add_secondaries("key2");
+    }
+
+    pb::common::KeyValue kv;
+    kv.set_key(mvcc::Codec::EncodeKey(lock_info.key(), Constant::kLockVer));
+    kv.set_value(lock_info.SerializeAsString());
+    kv_puts_lock.push_back(kv);
+  }
+
+  TxnEngineHelper::FallbackTo2PCLocks(kv_puts_lock);
+
+  ASSERT_EQ(3, kv_puts_lock.size());
+  for (int i = 0; i < 3; ++i) {
+    pb::store::LockInfo lock_info;
+    ASSERT_TRUE(lock_info.ParseFromString(kv_puts_lock[i].value()));
+    EXPECT_EQ("key" + std::to_string(i), lock_info.key());
+    EXPECT_EQ("key0", lock_info.primary_lock());
+    EXPECT_FALSE(lock_info.use_async_commit());
+    EXPECT_EQ(0, lock_info.secondaries_size());
+  }
+}
+
+TEST_F(TxnPreWriteTest, GenRollbackData) {
+  std::vector<pb::common::KeyValue> kv_puts_write;
+  std::vector<std::string> kv_deletes_lock;
+  std::vector<std::string> kv_deletes_data;
+
+  // merge rollback of two txns
+  TxnEngineHelper::GenRollbackData({"key0"}, {"key1"}, 100, kv_puts_write, kv_deletes_lock, kv_deletes_data);
+  TxnEngineHelper::GenRollbackData({}, {"key2"}, 200, kv_puts_write, kv_deletes_lock, kv_deletes_data);
+
+  ASSERT_EQ(3, kv_puts_write.size());
+  ASSERT_EQ(3, kv_deletes_lock.size());
+  ASSERT_EQ(1, kv_deletes_data.size());
+  EXPECT_EQ(mvcc::Codec::EncodeKey("key0", 100), kv_deletes_data[0]);
+  EXPECT_EQ(mvcc::Codec::EncodeKey("key2", Constant::kLockVer), kv_deletes_lock[2]);
+
+  pb::store::WriteInfo write_info;
+  ASSERT_TRUE(write_info.ParseFromString(kv_puts_write[2].value()));
+  EXPECT_EQ(mvcc::Codec::EncodeKey("key2", 200), kv_puts_write[2].key());
+  EXPECT_EQ(200, write_info.start_ts());
+  EXPECT_EQ(pb::store::Op::Rollback, write_info.op());
+}
+
+TEST_F(TxnPreWriteTest, SplitPreWrite) {
+  auto region_id = 373;
+  auto region = store::Region::New(region_id);
+  region->SetState(pb::common::StoreRegionState::NORMAL);
+  auto store_region_meta = mono_engine->GetStoreMetaManager()->GetStoreRegionMeta();
+  store_region_meta->AddRegion(region);
+  auto region_metrics = StoreRegionMetrics::NewMetrics(region->Id());
+  mono_engine->GetStoreMetricsManager()->GetStoreRegionMetrics()->AddMetrics(region_metrics);
+
+  int64_t old_batch_count = FLAGS_txn_prewrite_write_batch_count;
+  FLAGS_txn_prewrite_write_batch_count = 2;
+
+  pb::store::TxnPrewriteResponse response;
+  auto ctx = std::make_shared<Context>();
+  ctx->SetRegionId(region_id);
+  ctx->SetCfName(Constant::kStoreDataCF);
+  ctx->SetResponse(&response);
+
+  // long value is put to data cf, short value is in lock, both are split to 3 raft writes.
+  std::vector<pb::store::Mutation> mutations;
+  std::vector<std::string> keys;
+  for (int i = 0; i < 5; ++i) {
+    pb::store::Mutation mutation;
+    mutation.set_op(::dingodb::pb::store::Op::Put);
+    mutation.set_key("split_test_key" + std::to_string(i));
+    mutation.set_value(std::string(i % 2 == 0 ? 1024 : 8, 'v'));
+    mutations.emplace_back(mutation);
+    keys.push_back(mutation.key());
+  }
+
+  int64_t start_ts = 10;
+  auto status = TxnEngineHelper::Prewrite(engine, mono_engine, ctx, region, mutations, mutations[0].key(), start_ts,
+                                          lock_ttl, mutations.size(), false, 0, 0, {}, {}, {}, {});
+  FLAGS_txn_prewrite_write_batch_count = old_batch_count;
+
+  EXPECT_TRUE(status.ok()) << status.error_str();
+  EXPECT_EQ(0, response.txn_result_size());
+  for (const auto &mutation : mutations) {
+    MustLocked(mutation.key(), start_ts);
+  }
+
+  MustCommit(region, start_ts, start_ts + 1, keys);
+  for (const auto &mutation : mutations) {
+    MustGet(mutation.key(), start_ts + 2, mutation.value());
+  }
+  DeleteRange();
+}
+
 TEST_F(TxnPreWriteTest, KvDeleteRange) { DeleteRange(); }
 
 }  // namespace dingodb
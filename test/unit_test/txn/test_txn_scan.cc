@@ -38,6 +38,7 @@
 #include "coordinator/tso_control.h"
 #include "engine/rocks_raw_engine.h"
 #include "engine/txn_engine_helper.h"
+#include "gflags/gflags.h"
 #include "mvcc/codec.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
@@ -51,6 +52,9 @@
 
 namespace dingodb {
 
+DECLARE_int32(txn_scan_parallel_num);
+DECLARE_int64(txn_scan_parallel_min_bytes);
+
 static const std::string kDefaultCf = "default";
 
 static const std::vector<std::string> kAllCFs = {Constant::kTxnWriteCF, Constant::kTxnDataCF, Constant::kTxnLockCF,
@@ -778,6 +782,56 @@ TEST_F(TxnScanTest, Scan) {
   EXPECT_FALSE(has_more);
 }
 
+TEST_F(TxnScanTest, ScanAggCountParallel) {
+#if !defined(TEST_COPROCESSOR_V2_MOCK)
+  GTEST_SKIP() << "TEST_COPROCESSOR_V2_MOCK not defined";
+#endif
+  std::sort(keys.begin(), keys.end());
+
+  pb::common::Range range;
+  range.set_start_key(keys.front());
+  range.set_end_key(Helper::PrefixNext(keys.back()));
+
+  pb::common::CoprocessorV2 count_coprocessor = pb_coprocessor;
+  count_coprocessor.set_for_agg_count(true);
+  count_coprocessor.mutable_result_schema()->clear_schema();
+  auto *schema = count_coprocessor.mutable_result_schema()->add_schema();
+  schema->set_type(::dingodb::pb::common::Schema_Type::Schema_Type_LONG);
+  schema->set_is_key(false);
+  schema->set_is_nullable(false);
+  schema->set_index(0);
+
+  int64_t ts = ++end_ts;
+  auto scan_count = [&](int32_t parallel_num) -> std::vector<pb::common::KeyValue> {
+    int32_t old_parallel_num = FLAGS_txn_scan_parallel_num;
+    int64_t old_min_bytes = FLAGS_txn_scan_parallel_min_bytes;
+    FLAGS_txn_scan_parallel_num = parallel_num;
+    FLAGS_txn_scan_parallel_min_bytes = 0;
+
+    std::vector<pb::common::KeyValue> kvs;
+    pb::store::TxnResultInfo txn_result_info;
+    std::string end_key;
+    bool has_more = false;
+    auto status = TxnEngineHelper::Scan(Stream::New(10000000), engine, pb::store::IsolationLevel::SnapshotIsolation, ts,
+                                        range, 10, false, false, {}, false, count_coprocessor, txn_result_info, kvs,
+                                        has_more, end_key);
+    EXPECT_TRUE(status.ok()) << status.error_str();
+    EXPECT_FALSE(has_more);
+
+    FLAGS_txn_scan_parallel_num = old_parallel_num;
+    FLAGS_txn_scan_parallel_min_bytes = old_min_bytes;
+    return kvs;
+  };
+
+  // sum of parts is same as count of whole range.
+  auto serial_kvs = scan_count(1);
+  auto parallel_kvs = scan_count(4);
+  ASSERT_EQ(1, serial_kvs.size());
+  ASSERT_EQ(1, parallel_kvs.size());
+  EXPECT_EQ(serial_kvs[0].key(), parallel_kvs[0].key());
+  EXPECT_EQ(serial_kvs[0].value(), parallel_kvs[0].value());
+}
+
 TEST_F(TxnScanTest, KvDeleteRange) { DeleteRange(); }
 
 }  // namespace dingodb
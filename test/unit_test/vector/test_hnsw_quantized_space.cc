@@ -0,0 +1,237 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "simd/distances_ref.h"
+#include "simd/hook.h"
+#include "vector/hnsw_quantized_space.h"
+#include "vector/vector_index.h"
+#include "vector/vector_index_factory.h"
+
+namespace dingodb {
+
+DECLARE_string(hnsw_quantize_type);
+
+class HnswQuantizedSpaceTest : public testing::Test {
+ protected:
+  static std::vector<float> GenVector(std::mt19937& rng, size_t dimension) {
+    std::uniform_real_distribution<float> distrib(-1.0f, 1.0f);
+    std::vector<float> vector(dimension);
+    for (auto& value : vector) {
+      value = distrib(rng);
+    }
+    return vector;
+  }
+
+  inline static size_t dimension = 37;
+};
+
+TEST_F(HnswQuantizedSpaceTest, FP16Convert) {
+  EXPECT_EQ(0x0000, fp32_to_fp16_ref(0.0f));
+  EXPECT_EQ(0x3c00, fp32_to_fp16_ref(1.0f));
+  EXPECT_EQ(0xc000, fp32_to_fp16_ref(-2.0f));
+  EXPECT_EQ(0x7bff, fp32_to_fp16_ref(65504.0f));
+  EXPECT_EQ(0x7c00, fp32_to_fp16_ref(1e6f));
+  EXPECT_EQ(0x0001, fp32_to_fp16_ref(std::ldexp(1.0f, -24)));
+
+  for (uint32_t h = 0; h < 0x7c00; ++h) {
+    EXPECT_EQ(h, fp32_to_fp16_ref(fp16_to_fp32_ref(h)));
+  }
+}
+
+TEST_F(HnswQuantizedSpaceTest, BF16Convert) {
+  EXPECT_EQ(0x0000, fp32_to_bf16_ref(0.0f));
+  EXPECT_EQ(0x3f80, fp32_to_bf16_ref(1.0f));
+  EXPECT_EQ(0xc000, fp32_to_bf16_ref(-2.0f));
+  EXPECT_EQ(0x7f80, fp32_to_bf16_ref(std::numeric_limits<float>::infinity()));
+  EXPECT_EQ(0x7fc0, fp32_to_bf16_ref(std::numeric_limits<float>::quiet_NaN()));
+  // 1 + 2^-8 is half way, round to even
+  EXPECT_EQ(0x3f80, fp32_to_bf16_ref(1.0f + std::ldexp(1.0f, -8)));
+
+  for (uint32_t h = 0; h < 0x7f80; ++h) {
+    EXPECT_EQ(h, fp32_to_bf16_ref(bf16_to_fp32_ref(h)));
+  }
+}
+
+TEST_F(HnswQuantizedSpaceTest, HalfKernel) {
+  std::mt19937 rng(4);
+
+  for (size_t d : {1, 15, 16, 17, 64, 100}) {
+    auto x = GenVector(rng, d);
+    auto y = GenVector(rng, d);
+    std::vector<uint16_t> x_fp16(d), y_fp16(d), x_bf16(d), y_bf16(d);
+    for (size_t i = 0; i < d; ++i) {
+      x_fp16[i] = fp32_to_fp16_ref(x[i]);
+      y_fp16[i] = fp32_to_fp16_ref(y[i]);
+      x_bf16[i] = fp32_to_bf16_ref(x[i]);
+      y_bf16[i] = fp32_to_bf16_ref(y[i]);
+    }
+
+    // hooked simd kernels same as ref
+    EXPECT_NEAR(fvec_L2sqr_fp16_ref(x_fp16.data(), y_fp16.data(), d), fvec_L2sqr_fp16(x_fp16.data(), y_fp16.data(), d),
+                1e-3);
+    EXPECT_NEAR(fvec_inner_product_fp16_ref(x_fp16.data(), y_fp16.data(), d),
+                fvec_inner_product_fp16(x_fp16.data(), y_fp16.data(), d), 1e-3);
+    EXPECT_NEAR(fvec_L2sqr_bf16_ref(x_bf16.data(), y_bf16.data(), d), fvec_L2sqr_bf16(x_bf16.data(), y_bf16.data(), d),
+                1e-3);
+    EXPECT_NEAR(fvec_inner_product_bf16_ref(x_bf16.data(), y_bf16.data(), d),
+                fvec_inner_product_bf16(x_bf16.data(), y_bf16.data(), d), 1e-3);
+  }
+}
+
+TEST_F(HnswQuantizedSpaceTest, CodeSize) {
+  EXPECT_EQ(dimension * 4, HnswQuantizedSpace::CodeSize(HnswQuantizeType::kNone, dimension));
+  EXPECT_EQ(dimension + 8, HnswQuantizedSpace::CodeSize(HnswQuantizeType::kSQ8, dimension));
+  EXPECT_EQ(dimension * 2, HnswQuantizedSpace::CodeSize(HnswQuantizeType::kFP16, dimension));
+  EXPECT_EQ(dimension * 2, HnswQuantizedSpace::CodeSize(HnswQuantizeType::kBF16, dimension));
+
+  HnswQuantizeType quantize_type;
+  EXPECT_TRUE(HnswQuantizedSpace::ParseQuantizeType("sq8", quantize_type));
+  EXPECT_EQ(HnswQuantizeType::kSQ8, quantize_type);
+  EXPECT_FALSE(HnswQuantizedSpace::ParseQuantizeType("pq", quantize_type));
+}
+
+TEST_F(HnswQuantizedSpaceTest, EncodeDecode) {
+  std::mt19937 rng(1);
+
+  for (auto quantize_type : {HnswQuantizeType::kSQ8, HnswQuantizeType::kFP16, HnswQuantizeType::kBF16}) {
+    HnswQuantizedSpace space(quantize_type, pb::common::MetricType::METRIC_TYPE_L2, dimension);
+    float max_error = quantize_type == HnswQuantizeType::kSQ8   ? 1.0f / 127
+                      : quantize_type == HnswQuantizeType::kFP16 ? 1e-3f
+                                                                 : 4e-3f;
+
+    for (int i = 0; i < 100; ++i) {
+      auto vector = GenVector(rng, dimension);
+      std::vector<char> code(space.get_data_size());
+      space.Encode(vector.data(), code.data());
+
+      std::vector<float> decode_vector(dimension);
+      space.Decode(code.data(), decode_vector.data());
+      for (size_t j = 0; j < dimension; ++j) {
+        EXPECT_NEAR(vector[j], decode_vector[j], max_error);
+      }
+
+      // distance to self
+      auto dist_func = space.get_dist_func();
+      EXPECT_NEAR(0.0f, dist_func(code.data(), code.data(), space.get_dist_func_param()), 1e-4);
+    }
+  }
+
+  // zero vector
+  HnswQuantizedSpace space(HnswQuantizeType::kSQ8, pb::common::MetricType::METRIC_TYPE_L2, dimension);
+  std::vector<float> vector(dimension, 0.0f);
+  std::vector<char> code(space.get_data_size());
+  space.Encode(vector.data(), code.data());
+  std::vector<float> decode_vector(dimension, 1.0f);
+  space.Decode(code.data(), decode_vector.data());
+  EXPECT_EQ(vector, decode_vector);
+}
+
+TEST_F(HnswQuantizedSpaceTest, Distance) {
+  std::mt19937 rng(2);
+
+  for (auto quantize_type : {HnswQuantizeType::kSQ8, HnswQuantizeType::kFP16, HnswQuantizeType::kBF16}) {
+    for (auto metric_type :
+         {pb::common::MetricType::METRIC_TYPE_L2, pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT}) {
+      HnswQuantizedSpace space(quantize_type, metric_type, dimension);
+      auto dist_func = space.get_dist_func();
+
+      for (int i = 0; i < 100; ++i) {
+        auto x = GenVector(rng, dimension);
+        auto y = GenVector(rng, dimension);
+        float expect_distance = metric_type == pb::common::MetricType::METRIC_TYPE_L2
+                                    ? fvec_L2sqr_ref(x.data(), y.data(), dimension)
+                                    : 1.0f - fvec_inner_product_ref(x.data(), y.data(), dimension);
+
+        std::vector<char> x_code(space.get_data_size());
+        std::vector<char> y_code(space.get_data_size());
+        space.Encode(x.data(), x_code.data());
+        space.Encode(y.data(), y_code.data());
+
+        EXPECT_NEAR(expect_distance, dist_func(x_code.data(), y_code.data(), space.get_dist_func_param()), 0.2);
+        EXPECT_NEAR(expect_distance, space.Distance(x.data(), y_code.data()), 0.1);
+      }
+    }
+  }
+}
+
+TEST_F(HnswQuantizedSpaceTest, SearchIndex) {
+  static const pb::common::Range kRange;
+  std::string old_quantize_type = FLAGS_hnsw_quantize_type;
+
+  for (const auto* quantize_type : {"sq8", "fp16", "bf16"}) {
+    FLAGS_hnsw_quantize_type = quantize_type;
+
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW);
+    index_parameter.mutable_hnsw_parameter()->set_dimension(dimension);
+    index_parameter.mutable_hnsw_parameter()->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+    index_parameter.mutable_hnsw_parameter()->set_efconstruction(200);
+    index_parameter.mutable_hnsw_parameter()->set_max_elements(1000);
+    index_parameter.mutable_hnsw_parameter()->set_nlinks(16);
+
+    pb::common::RegionEpoch epoch;
+    epoch.set_conf_version(1);
+    epoch.set_version(1);
+
+    auto vector_index = VectorIndexFactory::NewHnsw(1, index_parameter, epoch, kRange, nullptr);
+    ASSERT_NE(nullptr, vector_index);
+
+    std::mt19937 rng(3);
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    for (int64_t id = 0; id < 200; ++id) {
+      pb::common::VectorWithId vector_with_id;
+      vector_with_id.set_id(id);
+      vector_with_id.mutable_vector()->set_dimension(dimension);
+      vector_with_id.mutable_vector()->set_value_type(pb::common::ValueType::FLOAT);
+      for (auto value : GenVector(rng, dimension)) {
+        vector_with_id.mutable_vector()->add_float_values(value);
+      }
+      vector_with_ids.push_back(vector_with_id);
+    }
+    ASSERT_TRUE(vector_index->Upsert(vector_with_ids).ok());
+
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    pb::common::VectorSearchParameter search_parameter;
+    search_parameter.mutable_hnsw()->set_efsearch(64);
+    ASSERT_TRUE(vector_index->Search({vector_with_ids[7]}, 3, {}, true, search_parameter, results).ok());
+    ASSERT_EQ(1, results.size());
+    ASSERT_EQ(3, results[0].vector_with_distances_size());
+
+    const auto& nearest = results[0].vector_with_distances(0);
+    EXPECT_EQ(7, nearest.vector_with_id().id());
+    EXPECT_EQ(dimension, static_cast<size_t>(nearest.vector_with_id().vector().float_values_size()));
+    for (size_t i = 0; i < dimension; ++i) {
+      EXPECT_NEAR(vector_with_ids[7].vector().float_values(i), nearest.vector_with_id().vector().float_values(i),
+                  1.0f / 127);
+    }
+  }
+
+  FLAGS_hnsw_quantize_type = old_quantize_type;
+}
+
+}  // namespace dingodb
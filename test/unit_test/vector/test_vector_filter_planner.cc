@@ -0,0 +1,71 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "gflags/gflags.h"
+#include "vector/vector_filter_planner.h"
+
+namespace dingodb {
+
+DECLARE_bool(enable_vector_filter_planner);
+DECLARE_int64(vector_filter_brute_force_max_count);
+DECLARE_double(vector_filter_post_filter_min_selectivity);
+DECLARE_int64(vector_filter_post_filter_max_topk);
+
+class VectorFilterPlannerTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    FLAGS_enable_vector_filter_planner = true;
+    FLAGS_vector_filter_brute_force_max_count = 2048;
+    FLAGS_vector_filter_post_filter_min_selectivity = 0.9;
+    FLAGS_vector_filter_post_filter_max_topk = 8192;
+  }
+};
+
+TEST_F(VectorFilterPlannerTest, Choose) {
+  // few candidates
+  EXPECT_EQ(VectorFilterPlan::kBruteForce, VectorFilterPlanner::Choose(0, 1000000, 10, false));
+  EXPECT_EQ(VectorFilterPlan::kBruteForce, VectorFilterPlanner::Choose(2048, 1000000, 10, false));
+
+  // middle selectivity
+  EXPECT_EQ(VectorFilterPlan::kIndexFilter, VectorFilterPlanner::Choose(2049, 1000000, 10, false));
+  EXPECT_EQ(VectorFilterPlan::kIndexFilter, VectorFilterPlanner::Choose(500000, 1000000, 10, false));
+
+  // most vectors match
+  EXPECT_EQ(VectorFilterPlan::kPostFilter, VectorFilterPlanner::Choose(950000, 1000000, 10, false));
+  // oversample topk too large
+  EXPECT_EQ(VectorFilterPlan::kIndexFilter, VectorFilterPlanner::Choose(950000, 1000000, 8000, false));
+
+  // range search
+  EXPECT_EQ(VectorFilterPlan::kIndexFilter, VectorFilterPlanner::Choose(10, 1000000, 10, true));
+
+  FLAGS_enable_vector_filter_planner = false;
+  EXPECT_EQ(VectorFilterPlan::kIndexFilter, VectorFilterPlanner::Choose(10, 1000000, 10, false));
+}
+
+TEST_F(VectorFilterPlannerTest, PostFilterTopk) {
+  EXPECT_EQ(10, VectorFilterPlanner::PostFilterTopk(1000, 1000, 10));
+  EXPECT_EQ(10, VectorFilterPlanner::PostFilterTopk(0, 1000, 10));
+
+  uint32_t topk = VectorFilterPlanner::PostFilterTopk(900, 1000, 10);
+  EXPECT_GE(topk, 12);
+  EXPECT_LE(topk, 20);
+
+  EXPECT_EQ(8192, VectorFilterPlanner::PostFilterTopk(1, 1000000, 10));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,105 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_hybrid_fusion.h"
+
+namespace dingodb {
+
+DECLARE_int32(vector_index_hybrid_rrf_k);
+DECLARE_double(vector_index_hybrid_vector_weight);
+
+class VectorHybridFusionTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    FLAGS_vector_index_hybrid_rrf_k = 60;
+    FLAGS_vector_index_hybrid_vector_weight = 0.5;
+  }
+
+  // vector result sorted by l2 distance
+  static pb::index::VectorWithDistanceResult GenVectorResult(const std::vector<int64_t>& ids) {
+    pb::index::VectorWithDistanceResult result;
+    for (size_t i = 0; i < ids.size(); ++i) {
+      auto* vector_with_distance = result.add_vector_with_distances();
+      vector_with_distance->mutable_vector_with_id()->set_id(ids[i]);
+      vector_with_distance->set_distance(static_cast<float>(i + 1));
+    }
+    return result;
+  }
+
+  static std::vector<pb::common::DocumentWithScore> GenDocumentResults(const std::vector<int64_t>& ids,
+                                                                       const std::vector<float>& scores) {
+    std::vector<pb::common::DocumentWithScore> results;
+    for (size_t i = 0; i < ids.size(); ++i) {
+      pb::common::DocumentWithScore document_with_score;
+      document_with_score.mutable_document_with_id()->set_id(ids[i]);
+      document_with_score.set_score(scores[i]);
+      results.push_back(document_with_score);
+    }
+    return results;
+  }
+
+  static std::vector<int64_t> GetIds(const pb::index::VectorWithDistanceResult& result) {
+    std::vector<int64_t> ids;
+    for (const auto& vector_with_distance : result.vector_with_distances()) {
+      ids.push_back(vector_with_distance.vector_with_id().id());
+    }
+    return ids;
+  }
+};
+
+TEST_F(VectorHybridFusionTest, Rrf) {
+  auto vector_result = GenVectorResult({1, 2, 3, 4});
+  // not sorted by score
+  auto document_results = GenDocumentResults({5, 3, 2}, {1.0, 3.0, 2.0});
+
+  pb::index::VectorWithDistanceResult fused_result;
+  VectorHybridFusion::Fuse(HybridFusionType::kRrf, vector_result, document_results, 3, fused_result);
+
+  // 3 and 2 hit by both, 1 is vector top1.
+  EXPECT_EQ(std::vector<int64_t>({3, 2, 1}), GetIds(fused_result));
+  EXPECT_FLOAT_EQ(1.0 / 63 + 1.0 / 61, fused_result.vector_with_distances(0).distance());
+
+  // all
+  VectorHybridFusion::Fuse(HybridFusionType::kRrf, vector_result, document_results, 0, fused_result);
+  EXPECT_EQ(5, fused_result.vector_with_distances_size());
+}
+
+TEST_F(VectorHybridFusionTest, Weighted) {
+  auto vector_result = GenVectorResult({1, 2, 3});
+  auto document_results = GenDocumentResults({3, 4}, {10.0, 1.0});
+
+  pb::index::VectorWithDistanceResult fused_result;
+  FLAGS_vector_index_hybrid_vector_weight = 1.0;
+  VectorHybridFusion::Fuse(HybridFusionType::kWeighted, vector_result, document_results, 2, fused_result);
+  EXPECT_EQ(std::vector<int64_t>({1, 2}), GetIds(fused_result));
+
+  FLAGS_vector_index_hybrid_vector_weight = 0.0;
+  VectorHybridFusion::Fuse(HybridFusionType::kWeighted, vector_result, document_results, 1, fused_result);
+  EXPECT_EQ(std::vector<int64_t>({3}), GetIds(fused_result));
+
+  FLAGS_vector_index_hybrid_vector_weight = 0.5;
+  VectorHybridFusion::Fuse(HybridFusionType::kWeighted, vector_result, document_results, 0, fused_result);
+  // 3: 0.5*0 + 0.5*1, 1: 0.5*1, 2: 0.5*0.5, 4: 0
+  EXPECT_EQ(std::vector<int64_t>({1, 3, 2, 4}), GetIds(fused_result));
+}
+
+}  // namespace dingodb
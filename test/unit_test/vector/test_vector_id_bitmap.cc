@@ -0,0 +1,103 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "vector/vector_id_bitmap.h"
+
+namespace dingodb {
+
+class VectorIdBitmapTest : public testing::Test {
+ protected:
+  static std::set<int64_t> GenIds(int64_t count, int64_t max_id, uint32_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int64_t> dist(1, max_id);
+    std::set<int64_t> ids;
+    while (ids.size() < count) {
+      ids.insert(dist(rng));
+    }
+    return ids;
+  }
+};
+
+TEST_F(VectorIdBitmapTest, AddAndContains) {
+  // sparse and dense container
+  for (int64_t max_id : {int64_t(10000000), int64_t(100000)}) {
+    auto ids = GenIds(50000, max_id, 1);
+
+    VectorIdBitmap bitmap;
+    // not ascending order
+    std::vector<int64_t> shuffled(ids.begin(), ids.end());
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(2));
+    for (auto id : shuffled) {
+      bitmap.Add(id);
+    }
+    // duplicate
+    bitmap.Add(*ids.begin());
+
+    EXPECT_EQ(ids.size(), bitmap.Cardinality());
+    for (int64_t id = 1; id <= 200000; ++id) {
+      EXPECT_EQ(ids.count(id) > 0, bitmap.Contains(id)) << id;
+    }
+    EXPECT_FALSE(bitmap.Contains(-1));
+    EXPECT_EQ(std::vector<int64_t>(ids.begin(), ids.end()), bitmap.ToVector());
+  }
+}
+
+TEST_F(VectorIdBitmapTest, IntersectWith) {
+  auto sparse_ids = GenIds(20000, 10000000, 3);
+  auto dense_ids = GenIds(60000, 200000, 4);
+  // make some ids exist in both
+  for (int64_t id = 1; id < 1000; ++id) {
+    sparse_ids.insert(id);
+    dense_ids.insert(id);
+  }
+
+  VectorIdBitmap sparse_bitmap;
+  for (auto id : sparse_ids) {
+    sparse_bitmap.Add(id);
+  }
+  VectorIdBitmap dense_bitmap;
+  for (auto id : dense_ids) {
+    dense_bitmap.Add(id);
+  }
+
+  std::vector<int64_t> expect_ids;
+  std::set_intersection(sparse_ids.begin(), sparse_ids.end(), dense_ids.begin(), dense_ids.end(),
+                        std::back_inserter(expect_ids));
+
+  VectorIdBitmap result = sparse_bitmap;
+  result.IntersectWith(dense_bitmap);
+  EXPECT_EQ(expect_ids, result.ToVector());
+  EXPECT_EQ(expect_ids.size(), result.Cardinality());
+
+  result = dense_bitmap;
+  result.IntersectWith(sparse_bitmap);
+  EXPECT_EQ(expect_ids, result.ToVector());
+
+  result = dense_bitmap;
+  result.IntersectWith(dense_bitmap);
+  EXPECT_EQ(std::vector<int64_t>(dense_ids.begin(), dense_ids.end()), result.ToVector());
+
+  result.IntersectWith(VectorIdBitmap());
+  EXPECT_TRUE(result.Empty());
+}
+
+}  // namespace dingodb
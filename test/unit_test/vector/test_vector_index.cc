@@ -18,6 +18,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <memory>
 #include <random>
 #include <string>
 #include <utility>
@@ -28,6 +29,7 @@
 #include "proto/common.pb.h"
 #include "proto/index.pb.h"
 #include "vector/codec.h"
+#include "vector/vector_id_bitmap.h"
 #include "vector/vector_index.h"
 #include "vector/vector_index_factory.h"
 
@@ -283,4 +285,65 @@ TEST_F(VectorIndexWrapperTest, SortFilterFunctorPerformance) {
   std::cout << "query elapsed time: " << dingodb::Helper::TimestampUs() - start_time << std::endl;
 }
 
+TEST_F(VectorIndexWrapperTest, BitmapFilterFunctor) {
+  auto bitmap = std::make_shared<VectorIdBitmap>();
+  for (int64_t i = 1; i <= 100000; i += 3) {
+    bitmap->Add(i);
+  }
+
+  auto selecter = std::make_shared<VectorIndex::BitmapFilterFunctor>(bitmap);
+  auto negation_selecter = std::make_shared<VectorIndex::BitmapFilterFunctor>(bitmap, true);
+  for (int64_t i = 1; i <= 100010; ++i) {
+    bool expect = i <= 100000 && (i - 1) % 3 == 0;
+    EXPECT_EQ(expect, selecter->Check(i));
+    EXPECT_EQ(!expect, negation_selecter->Check(i));
+  }
+}
+
+TEST_F(VectorIndexWrapperTest, BitmapFilterFunctorPerformance) {
+  GTEST_SKIP() << "skip performance";
+
+  int num = 100000;
+  std::vector<int64_t> vector_ids;
+  vector_ids.reserve(num);
+  for (int i = 0; i < num; ++i) {
+    vector_ids.push_back(dingodb::Helper::GenerateRealRandomInteger(1000000, 1000000000));
+  }
+
+  int64_t start_time = dingodb::Helper::TimestampUs();
+
+  auto bitmap = std::make_shared<VectorIdBitmap>();
+  for (auto vector_id : vector_ids) {
+    bitmap->Add(vector_id);
+  }
+  auto selecter = std::make_shared<VectorIndex::BitmapFilterFunctor>(bitmap);
+  std::cout << "build elapsed time: " << dingodb::Helper::TimestampUs() - start_time
+            << " memory size: " << bitmap->MemorySize() << std::endl;
+
+  start_time = dingodb::Helper::TimestampUs();
+  for (int i = 0; i < 100000; ++i) {
+    selecter->Check(dingodb::Helper::GenerateRealRandomInteger(1000000, 1000000000));
+  }
+
+  std::cout << "query elapsed time: " << dingodb::Helper::TimestampUs() - start_time << std::endl;
+}
+
+TEST_F(VectorIndexWrapperTest, BulkImportPending) {
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(::dingodb::pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT);
+  index_parameter.mutable_flat_parameter()->set_dimension(8);
+  index_parameter.mutable_flat_parameter()->set_metric_type(::dingodb::pb::common::MetricType::METRIC_TYPE_L2);
+  auto vector_index_wrapper = VectorIndexWrapper::New(1, index_parameter);
+  vector_index_wrapper->SetApplyLogId(10);
+
+  EXPECT_FALSE(vector_index_wrapper->IsBulkImportPending());
+  vector_index_wrapper->SetBulkImportLogId(12);
+  EXPECT_TRUE(vector_index_wrapper->IsBulkImportPending());
+  EXPECT_GT(vector_index_wrapper->LastBulkImportTimeMs(), 0);
+
+  // rebuilt vector index catch up bulk import log.
+  vector_index_wrapper->SetApplyLogId(12);
+  EXPECT_FALSE(vector_index_wrapper->IsBulkImportPending());
+}
+
 }  // namespace dingodb
@@ -0,0 +1,123 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "butil/status.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index_bruteforce.h"
+#include "vector/vector_index_factory.h"
+
+namespace dingodb {
+
+DECLARE_bool(enable_bruteforce_memory_arena);
+
+class VectorIndexBruteforceTest : public testing::Test {
+ protected:
+  void SetUp() override { old_enable_arena = FLAGS_enable_bruteforce_memory_arena; }
+  void TearDown() override { FLAGS_enable_bruteforce_memory_arena = old_enable_arena; }
+
+  static std::shared_ptr<VectorIndex> NewIndex(int64_t id) {
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_BRUTEFORCE);
+    index_parameter.mutable_bruteforce_parameter()->set_dimension(kDimension);
+    index_parameter.mutable_bruteforce_parameter()->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+
+    pb::common::RegionEpoch epoch;
+    pb::common::Range range;
+    return VectorIndexFactory::NewBruteForce(id, index_parameter, epoch, range, nullptr);
+  }
+
+  static std::vector<pb::common::VectorWithId> GenVectorWithIds(int64_t count) {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> distrib(0.0, 1.0);
+
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    for (int64_t id = 1; id <= count; ++id) {
+      pb::common::VectorWithId vector_with_id;
+      vector_with_id.set_id(id);
+      vector_with_id.mutable_vector()->set_dimension(kDimension);
+      vector_with_id.mutable_vector()->set_value_type(pb::common::ValueType::FLOAT);
+      for (int i = 0; i < kDimension; ++i) {
+        vector_with_id.mutable_vector()->add_float_values(distrib(rng));
+      }
+      vector_with_ids.push_back(vector_with_id);
+    }
+    return vector_with_ids;
+  }
+
+  static int64_t SearchTop1(std::shared_ptr<VectorIndex> index, const pb::common::VectorWithId& vector_with_id) {
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    auto status = index->Search({vector_with_id}, 3, {}, false, {}, results);
+    if (!status.ok() || results.size() != 1 || results[0].vector_with_distances_size() == 0) {
+      return -1;
+    }
+    return results[0].vector_with_distances(0).vector_with_id().id();
+  }
+
+  inline static const int kDimension = 8;
+  bool old_enable_arena;
+};
+
+TEST_F(VectorIndexBruteforceTest, WithoutArena) {
+  FLAGS_enable_bruteforce_memory_arena = false;
+  auto index = NewIndex(1);
+  ASSERT_NE(nullptr, index);
+
+  auto vector_with_ids = GenVectorWithIds(10);
+  EXPECT_TRUE(index->Upsert(vector_with_ids).ok());
+
+  // search by scan raw engine in vector reader
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  auto status = index->Search({vector_with_ids[0]}, 3, {}, false, {}, results);
+  EXPECT_EQ(pb::error::EVECTOR_NOT_SUPPORT, status.error_code());
+}
+
+TEST_F(VectorIndexBruteforceTest, Arena) {
+  FLAGS_enable_bruteforce_memory_arena = true;
+  auto index = NewIndex(1);
+  ASSERT_NE(nullptr, index);
+  EXPECT_TRUE(std::dynamic_pointer_cast<VectorIndexBruteforce>(index)->HasMemoryArena());
+
+  auto vector_with_ids = GenVectorWithIds(100);
+  ASSERT_TRUE(index->Upsert(vector_with_ids).ok());
+  int64_t count = 0;
+  index->GetCount(count);
+  EXPECT_EQ(100, count);
+
+  for (int64_t id : {1, 50, 100}) {
+    EXPECT_EQ(id, SearchTop1(index, vector_with_ids[id - 1]));
+  }
+
+  ASSERT_TRUE(index->Delete({50}).ok());
+  EXPECT_NE(50, SearchTop1(index, vector_with_ids[49]));
+
+  // split child copy arena
+  auto child_index = NewIndex(2);
+  ASSERT_TRUE(index->CopyTo(child_index, 1, 31).ok());
+  child_index->GetCount(count);
+  EXPECT_EQ(30, count);
+  EXPECT_EQ(10, SearchTop1(child_index, vector_with_ids[9]));
+}
+
+}  // namespace dingodb
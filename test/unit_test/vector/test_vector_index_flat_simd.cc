@@ -26,6 +26,8 @@
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
+#include "simd/distances_ref.h"
+#include "simd/hook.h"
 #include "vector/vector_index_factory.h"
 
 DEFINE_uint32(vector_index_flat_simd_test_dimension, 512, "vector index flat simd test dimension. default 512");
@@ -327,4 +329,54 @@ TEST_F(VectorIndexFlatSimdTest, Search) {
 
   lambda_search_function_wrapper(vector_index_flat_ip, "flat ip");
 }
+
+TEST_F(VectorIndexFlatSimdTest, HammingDistance) {
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int> distrib(0, 255);
+
+  // cover simd block and tail
+  for (size_t code_size : {1, 7, 8, 16, 31, 32, 33, 64, 100, 128, 200}) {
+    std::vector<uint8_t> x(code_size), y(code_size);
+    for (size_t i = 0; i < code_size; ++i) {
+      x[i] = distrib(rng);
+      y[i] = distrib(rng);
+    }
+
+    uint32_t expect = 0;
+    for (size_t i = 0; i < code_size; ++i) {
+      expect += __builtin_popcount(x[i] ^ y[i]);
+    }
+    EXPECT_EQ(expect, hamming_distance_ref(x.data(), y.data(), code_size)) << code_size;
+    EXPECT_EQ(expect, hamming_distance(x.data(), y.data(), code_size)) << code_size;
+    EXPECT_EQ(0, hamming_distance(x.data(), x.data(), code_size)) << code_size;
+  }
+}
+
+TEST_F(VectorIndexFlatSimdTest, DistancesNy) {
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> distrib(-1.0, 1.0);
+
+  // cover row block, row tail and dimension tail
+  for (size_t d : {1, 7, 8, 16, 17, 33, 128}) {
+    for (size_t ny : {1, 7, 8, 15, 16, 17, 40}) {
+      std::vector<float> x(d), y(d * ny);
+      for (auto& value : x) value = distrib(rng);
+      for (auto& value : y) value = distrib(rng);
+
+      std::vector<float> expect(ny), actual(ny);
+      fvec_L2sqr_ny_ref(expect.data(), x.data(), y.data(), d, ny);
+      fvec_L2sqr_ny(actual.data(), x.data(), y.data(), d, ny);
+      for (size_t i = 0; i < ny; ++i) {
+        EXPECT_NEAR(expect[i], actual[i], 1e-4 * d) << d << " " << ny << " " << i;
+      }
+
+      fvec_inner_products_ny_ref(expect.data(), x.data(), y.data(), d, ny);
+      fvec_inner_products_ny(actual.data(), x.data(), y.data(), d, ny);
+      for (size_t i = 0; i < ny; ++i) {
+        EXPECT_NEAR(expect[i], actual[i], 1e-4 * d) << d << " " << ny << " " << i;
+      }
+    }
+  }
+}
+
 }  // namespace dingodb
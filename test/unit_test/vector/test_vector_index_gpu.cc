@@ -0,0 +1,80 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "faiss/IndexFlat.h"
+#include "faiss/IndexIDMap.h"
+#include "gflags/gflags.h"
+#include "vector/vector_index_gpu.h"
+
+namespace dingodb {
+
+DECLARE_int64(vector_index_gpu_min_count);
+
+class VectorIndexGpuMirrorTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    old_min_count = FLAGS_vector_index_gpu_min_count;
+    FLAGS_vector_index_gpu_min_count = 0;
+  }
+  void TearDown() override { FLAGS_vector_index_gpu_min_count = old_min_count; }
+
+  int64_t old_min_count;
+};
+
+TEST_F(VectorIndexGpuMirrorTest, SearchSameAsCpu) {
+  const int kDimension = 16;
+  const int kCount = 1000;
+  const int kTopk = 5;
+
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> distrib(0.0, 1.0);
+  std::vector<float> data(kCount * kDimension);
+  std::vector<faiss::idx_t> ids(kCount);
+  for (int i = 0; i < kCount; ++i) {
+    ids[i] = i + 1000;
+    for (int j = 0; j < kDimension; ++j) {
+      data[i * kDimension + j] = distrib(rng);
+    }
+  }
+
+  faiss::IndexFlatL2 raw_index(kDimension);
+  faiss::IndexIDMap2 cpu_index(&raw_index);
+  cpu_index.add_with_ids(kCount, data.data(), ids.data());
+
+  VectorIndexGpuMirror gpu_mirror(1);
+  std::vector<float> distances(kTopk);
+  std::vector<faiss::idx_t> labels(kTopk, -1);
+  bool on_gpu = gpu_mirror.Search(&cpu_index, 1, data.data(), kTopk, nullptr, distances.data(), labels.data());
+
+  // without gpu, caller fallback to cpu.
+  EXPECT_EQ(VectorIndexGpuMirror::IsEnabled(), on_gpu);
+  if (on_gpu) {
+    EXPECT_EQ(1000, labels[0]);
+    EXPECT_GT(gpu_mirror.MemorySize(), 0);
+
+    // stale copy is not used within rebuild interval.
+    gpu_mirror.Invalidate();
+    EXPECT_FALSE(gpu_mirror.Search(&cpu_index, 1, data.data(), kTopk, nullptr, distances.data(), labels.data()));
+  } else {
+    EXPECT_EQ(0, gpu_mirror.MemorySize());
+  }
+}
+
+}  // namespace dingodb
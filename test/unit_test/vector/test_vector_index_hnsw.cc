@@ -21,6 +21,7 @@
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <algorithm>
 #include <memory>
 #include <random>
 #include <vector>
@@ -28,6 +29,7 @@
 #include "butil/status.h"
 #include "faiss/MetricType.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
@@ -38,6 +40,8 @@
 
 namespace dingodb {
 
+DECLARE_int32(hnsw_range_search_init_topk);
+
 class VectorIndexHnswTest : public testing::Test {
  protected:
   static void SetUpTestSuite() {}
@@ -610,4 +614,192 @@ TEST_F(VectorIndexHnswTest, EfSearchCosine) {
   }
 }
 
+TEST_F(VectorIndexHnswTest, ReplaceDeleted) {
+  static const pb::common::Range kRange;
+
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW);
+  index_parameter.mutable_hnsw_parameter()->set_dimension(dimension);
+  index_parameter.mutable_hnsw_parameter()->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+  index_parameter.mutable_hnsw_parameter()->set_efconstruction(200);
+  index_parameter.mutable_hnsw_parameter()->set_max_elements(1000);
+  index_parameter.mutable_hnsw_parameter()->set_nlinks(16);
+
+  pb::common::RegionEpoch epoch;
+  epoch.set_conf_version(1);
+  epoch.set_version(1);
+
+  auto vector_index = VectorIndexFactory::NewHnsw(1, index_parameter, epoch, kRange, nullptr);
+  ASSERT_NE(nullptr, vector_index);
+  auto* hnsw_index = std::dynamic_pointer_cast<VectorIndexHnsw>(vector_index)->GetHnswIndex();
+
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+  auto gen_vector_with_ids = [&](int64_t start_id, int64_t count) {
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    for (int64_t id = start_id; id < start_id + count; ++id) {
+      pb::common::VectorWithId vector_with_id;
+      vector_with_id.set_id(id);
+      vector_with_id.mutable_vector()->set_dimension(dimension);
+      vector_with_id.mutable_vector()->set_value_type(pb::common::ValueType::FLOAT);
+      for (int i = 0; i < dimension; ++i) {
+        vector_with_id.mutable_vector()->add_float_values(dist(rng));
+      }
+      vector_with_ids.push_back(vector_with_id);
+    }
+    return vector_with_ids;
+  };
+
+  ASSERT_TRUE(vector_index->Upsert(gen_vector_with_ids(1, 100)).ok());
+
+  std::vector<int64_t> delete_ids;
+  for (int64_t id = 1; id <= 60; ++id) {
+    delete_ids.push_back(id);
+  }
+  ASSERT_TRUE(vector_index->Delete(delete_ids).ok());
+  // below replace deleted rebuild ratio
+  EXPECT_FALSE(vector_index->NeedToRebuild());
+
+  // new vector reuse deleted slot, revived vector stay in own slot
+  auto new_vector_with_ids = gen_vector_with_ids(1001, 50);
+  auto revive_vector_with_ids = gen_vector_with_ids(1, 5);
+  ASSERT_TRUE(vector_index->Upsert(new_vector_with_ids).ok());
+  ASSERT_TRUE(vector_index->Upsert(revive_vector_with_ids).ok());
+  EXPECT_EQ(100, hnsw_index->getCurrentElementCount());
+  EXPECT_EQ(5, hnsw_index->getDeletedCount());
+
+  pb::common::VectorSearchParameter search_parameter;
+  search_parameter.mutable_hnsw()->set_efsearch(100);
+  for (const auto& vector_with_id : {new_vector_with_ids[10], revive_vector_with_ids[2]}) {
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    ASSERT_TRUE(vector_index->Search({vector_with_id}, 1, {}, false, search_parameter, results).ok());
+    ASSERT_EQ(1, results.size());
+    ASSERT_EQ(1, results[0].vector_with_distances_size());
+    EXPECT_EQ(vector_with_id.id(), results[0].vector_with_distances(0).vector_with_id().id());
+  }
+
+  // deleted vector not in result
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  ASSERT_TRUE(vector_index->Search(gen_vector_with_ids(1, 1), 95, {}, false, search_parameter, results).ok());
+  ASSERT_EQ(1, results.size());
+  for (const auto& vector_with_distance : results[0].vector_with_distances()) {
+    int64_t id = vector_with_distance.vector_with_id().id();
+    EXPECT_FALSE(id > 5 && id <= 60) << id;
+  }
+}
+
+TEST_F(VectorIndexHnswTest, RangeSearch) {
+  static const pb::common::Range kRange;
+  const int kCount = 300;
+
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW);
+  index_parameter.mutable_hnsw_parameter()->set_dimension(dimension);
+  index_parameter.mutable_hnsw_parameter()->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+  index_parameter.mutable_hnsw_parameter()->set_efconstruction(200);
+  index_parameter.mutable_hnsw_parameter()->set_max_elements(kCount);
+  index_parameter.mutable_hnsw_parameter()->set_nlinks(16);
+
+  pb::common::RegionEpoch epoch;
+  epoch.set_conf_version(1);
+  epoch.set_version(1);
+
+  auto vector_index = VectorIndexFactory::NewHnsw(1, index_parameter, epoch, kRange, nullptr);
+  ASSERT_NE(nullptr, vector_index);
+
+  std::mt19937 rng(11);
+  std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+  std::vector<pb::common::VectorWithId> vector_with_ids;
+  for (int64_t id = 1; id <= kCount; ++id) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(id);
+    vector_with_id.mutable_vector()->set_dimension(dimension);
+    vector_with_id.mutable_vector()->set_value_type(pb::common::ValueType::FLOAT);
+    for (int i = 0; i < dimension; ++i) {
+      vector_with_id.mutable_vector()->add_float_values(dist(rng));
+    }
+    vector_with_ids.push_back(vector_with_id);
+  }
+  ASSERT_TRUE(vector_index->Upsert(vector_with_ids).ok());
+
+  // radius cover 40 nearest vectors, more than init topk.
+  const auto& query = vector_with_ids[0];
+  std::vector<float> distances;
+  for (const auto& vector_with_id : vector_with_ids) {
+    float distance = 0;
+    for (int i = 0; i < dimension; ++i) {
+      float diff = vector_with_id.vector().float_values(i) - query.vector().float_values(i);
+      distance += diff * diff;
+    }
+    distances.push_back(distance);
+  }
+  std::sort(distances.begin(), distances.end());
+  float radius = (distances[39] + distances[40]) / 2;
+
+  int32_t old_init_topk = FLAGS_hnsw_range_search_init_topk;
+  FLAGS_hnsw_range_search_init_topk = 4;
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  auto status = vector_index->RangeSearch({query}, radius, {}, false, {}, results);
+  FLAGS_hnsw_range_search_init_topk = old_init_topk;
+  ASSERT_TRUE(status.ok()) << status.error_str();
+
+  ASSERT_EQ(1, results.size());
+  EXPECT_GE(results[0].vector_with_distances_size(), 36);
+  EXPECT_LE(results[0].vector_with_distances_size(), 40);
+  EXPECT_EQ(query.id(), results[0].vector_with_distances(0).vector_with_id().id());
+  float last_distance = 0;
+  for (const auto& vector_with_distance : results[0].vector_with_distances()) {
+    EXPECT_LT(vector_with_distance.distance(), radius);
+    EXPECT_GE(vector_with_distance.distance(), last_distance);
+    last_distance = vector_with_distance.distance();
+  }
+}
+
+TEST_F(VectorIndexHnswTest, ResizeMaxElementsLimitOnly) {
+  static const pb::common::Range kRange;
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(::dingodb::pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW);
+  index_parameter.mutable_hnsw_parameter()->set_dimension(dimension);
+  index_parameter.mutable_hnsw_parameter()->set_metric_type(::dingodb::pb::common::MetricType::METRIC_TYPE_L2);
+  index_parameter.mutable_hnsw_parameter()->set_efconstruction(efconstruction);
+  index_parameter.mutable_hnsw_parameter()->set_max_elements(100);
+  index_parameter.mutable_hnsw_parameter()->set_nlinks(nlinks);
+
+  pb::common::RegionEpoch epoch;
+  auto vector_index = VectorIndexFactory::NewHnsw(1, index_parameter, epoch, kRange, nullptr);
+  auto hnsw_index = std::dynamic_pointer_cast<VectorIndexHnsw>(vector_index);
+  ASSERT_NE(nullptr, hnsw_index);
+  int64_t capacity = hnsw_index->GetHnswIndex()->getMaxElements();
+
+  EXPECT_TRUE(hnsw_index->IsExceedsMaxElements(150));
+  ASSERT_TRUE(hnsw_index->ResizeMaxElements(1000000).ok());
+  EXPECT_FALSE(hnsw_index->IsExceedsMaxElements(150));
+
+  // limit is raised, capacity is not allocated until write.
+  int64_t max_elements = 0;
+  ASSERT_TRUE(hnsw_index->GetMaxElements(max_elements).ok());
+  EXPECT_EQ(1000000, max_elements);
+  EXPECT_EQ(capacity, hnsw_index->GetHnswIndex()->getMaxElements());
+
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> distrib(0.0, 1.0);
+  std::vector<pb::common::VectorWithId> vector_with_ids;
+  for (int64_t id = 0; id < 150; ++id) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(id);
+    vector_with_id.mutable_vector()->set_dimension(dimension);
+    vector_with_id.mutable_vector()->set_value_type(::dingodb::pb::common::ValueType::FLOAT);
+    for (int i = 0; i < dimension; ++i) {
+      vector_with_id.mutable_vector()->add_float_values(distrib(rng));
+    }
+    vector_with_ids.push_back(vector_with_id);
+  }
+  ASSERT_TRUE(vector_index->Upsert(vector_with_ids).ok());
+  EXPECT_GE(hnsw_index->GetHnswIndex()->getMaxElements(), 150);
+
+  int64_t count = 0;
+  vector_index->GetCount(count);
+  EXPECT_EQ(150, count);
+}
+
 }  // namespace dingodb
@@ -0,0 +1,94 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "vector/vector_index_mmap_reader.h"
+
+namespace dingodb {
+
+DECLARE_int64(vector_index_mmap_release_bytes);
+
+class VectorIndexMmapReaderTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    data.resize(1024 * 1024 + 3);
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = static_cast<char>(i * 31);
+    }
+
+    std::ofstream file(kFilePath, std::ios::binary);
+    file.write(data.data(), data.size());
+  }
+
+  static void TearDownTestSuite() { std::remove(kFilePath); }
+
+  inline static const char* kFilePath = "./vector_index_mmap_reader_test.idx";
+  inline static std::vector<char> data;
+};
+
+TEST_F(VectorIndexMmapReaderTest, Read) {
+  int64_t old_release_bytes = FLAGS_vector_index_mmap_release_bytes;
+  FLAGS_vector_index_mmap_release_bytes = 4096;
+
+  VectorIndexMmapReader reader;
+  ASSERT_TRUE(reader.Open(kFilePath).ok());
+  EXPECT_EQ(data.size(), reader.Size());
+
+  // read by different item size, check content still right after consumed pages released.
+  std::vector<char> result;
+  std::vector<char> buf(64 * 1024);
+  for (size_t item_size : {1, 8, 4096, 7}) {
+    size_t count = reader(buf.data(), item_size, buf.size() / item_size);
+    EXPECT_EQ(buf.size() / item_size, count);
+    result.insert(result.end(), buf.begin(), buf.begin() + count * item_size);
+  }
+  while (true) {
+    size_t count = reader(buf.data(), 1, buf.size());
+    if (count == 0) {
+      break;
+    }
+    result.insert(result.end(), buf.begin(), buf.begin() + count);
+  }
+  EXPECT_EQ(data, result);
+  EXPECT_EQ(data.size(), reader.Offset());
+
+  FLAGS_vector_index_mmap_release_bytes = old_release_bytes;
+}
+
+TEST_F(VectorIndexMmapReaderTest, ReadPartialItem) {
+  VectorIndexMmapReader reader;
+  ASSERT_TRUE(reader.Open(kFilePath).ok());
+
+  std::vector<char> buf(data.size() + 16);
+  // file size is not multiple of 8, last partial item is not read like fread.
+  EXPECT_EQ(data.size() / 8, reader(buf.data(), 8, buf.size() / 8));
+  EXPECT_EQ(0, reader(buf.data(), 8, 1));
+  EXPECT_EQ(3, reader(buf.data(), 1, 8));
+}
+
+TEST_F(VectorIndexMmapReaderTest, OpenNotExistFile) {
+  VectorIndexMmapReader reader;
+  EXPECT_FALSE(reader.Open("./not_exist_vector_index_file.idx").ok());
+}
+
+}  // namespace dingodb
@@ -29,6 +29,7 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "faiss/MetricType.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
@@ -37,6 +38,8 @@
 
 namespace dingodb {
 
+DECLARE_bool(enable_ivf_pq_fast_scan);
+
 static const std::string kTempDataDirectory = "./unit_test/vector_index_raw_ivf_pq";
 
 class VectorIndexRawIvfPqTest : public testing::Test {
@@ -1566,4 +1569,67 @@ TEST_F(VectorIndexRawIvfPqTest, SearchAfterLoad) {
   }
 }
 
+TEST(VectorIndexRawIvfPqFastScanTest, SearchSameAsPq) {
+  const int kDimension = 16;
+  const int kCount = 2000;
+  const int kTopk = 10;
+
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(::dingodb::pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ);
+  index_parameter.mutable_ivf_pq_parameter()->set_dimension(kDimension);
+  index_parameter.mutable_ivf_pq_parameter()->set_metric_type(::dingodb::pb::common::MetricType::METRIC_TYPE_L2);
+  index_parameter.mutable_ivf_pq_parameter()->set_ncentroids(4);
+  index_parameter.mutable_ivf_pq_parameter()->set_nsubvector(8);
+  index_parameter.mutable_ivf_pq_parameter()->set_nbits_per_idx(4);
+  auto vector_index = std::make_shared<VectorIndexRawIvfPq>(1, index_parameter, pb::common::RegionEpoch(),
+                                                            pb::common::Range(), nullptr);
+
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<float> distrib(0.0, 1.0);
+  std::vector<pb::common::VectorWithId> vector_with_ids;
+  for (int64_t id = 1; id <= kCount; ++id) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(id);
+    vector_with_id.mutable_vector()->set_dimension(kDimension);
+    vector_with_id.mutable_vector()->set_value_type(::dingodb::pb::common::ValueType::FLOAT);
+    for (int i = 0; i < kDimension; ++i) {
+      vector_with_id.mutable_vector()->add_float_values(distrib(rng));
+    }
+    vector_with_ids.push_back(vector_with_id);
+  }
+  ASSERT_TRUE(vector_index->Train(vector_with_ids).ok());
+  ASSERT_TRUE(vector_index->Add(vector_with_ids).ok());
+
+  std::vector<pb::common::VectorWithId> queries(vector_with_ids.begin(), vector_with_ids.begin() + 20);
+  pb::common::VectorSearchParameter parameter;
+  parameter.mutable_ivf_pq()->set_nprobe(4);
+
+  bool old_enable_fast_scan = FLAGS_enable_ivf_pq_fast_scan;
+  FLAGS_enable_ivf_pq_fast_scan = false;
+  std::vector<pb::index::VectorWithDistanceResult> pq_results;
+  ASSERT_TRUE(vector_index->Search(queries, kTopk, {}, false, parameter, pq_results).ok());
+
+  FLAGS_enable_ivf_pq_fast_scan = true;
+  std::vector<pb::index::VectorWithDistanceResult> fast_scan_results;
+  ASSERT_TRUE(vector_index->Search(queries, kTopk, {}, false, parameter, fast_scan_results).ok());
+  FLAGS_enable_ivf_pq_fast_scan = old_enable_fast_scan;
+
+  // same codes, fast scan only quantize distance lookup table.
+  ASSERT_EQ(pq_results.size(), fast_scan_results.size());
+  int same_count = 0;
+  for (size_t row = 0; row < pq_results.size(); ++row) {
+    ASSERT_EQ(kTopk, fast_scan_results[row].vector_with_distances_size());
+    std::vector<int64_t> pq_ids;
+    for (const auto& vector_with_distance : pq_results[row].vector_with_distances()) {
+      pq_ids.push_back(vector_with_distance.vector_with_id().id());
+    }
+    for (const auto& vector_with_distance : fast_scan_results[row].vector_with_distances()) {
+      if (std::find(pq_ids.begin(), pq_ids.end(), vector_with_distance.vector_with_id().id()) != pq_ids.end()) {
+        ++same_count;
+      }
+    }
+  }
+  EXPECT_GE(same_count, pq_results.size() * kTopk * 8 / 10);
+}
+
 }  // namespace dingodb
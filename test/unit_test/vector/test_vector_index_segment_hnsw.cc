@@ -0,0 +1,177 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index_segment_hnsw.h"
+
+namespace dingodb {
+
+DECLARE_int64(vector_index_segment_buffer_max_count);
+DECLARE_int64(vector_index_segment_max_count);
+
+class VectorIndexSegmentHnswTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    old_buffer_max_count = FLAGS_vector_index_segment_buffer_max_count;
+    old_segment_max_count = FLAGS_vector_index_segment_max_count;
+    FLAGS_vector_index_segment_buffer_max_count = 100;
+    FLAGS_vector_index_segment_max_count = 2;
+  }
+
+  void TearDown() override {
+    FLAGS_vector_index_segment_buffer_max_count = old_buffer_max_count;
+    FLAGS_vector_index_segment_max_count = old_segment_max_count;
+    std::filesystem::remove_all(kSaveDir);
+  }
+
+  static std::shared_ptr<VectorIndexSegmentHnsw> NewIndex() {
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW);
+    index_parameter.mutable_hnsw_parameter()->set_dimension(kDimension);
+    index_parameter.mutable_hnsw_parameter()->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+    index_parameter.mutable_hnsw_parameter()->set_efconstruction(200);
+    index_parameter.mutable_hnsw_parameter()->set_max_elements(100000);
+    index_parameter.mutable_hnsw_parameter()->set_nlinks(16);
+
+    pb::common::RegionEpoch epoch;
+    epoch.set_conf_version(1);
+    epoch.set_version(1);
+    pb::common::Range range;
+    return std::make_shared<VectorIndexSegmentHnsw>(1, index_parameter, epoch, range, nullptr);
+  }
+
+  static pb::common::VectorWithId GenVectorWithId(int64_t id) {
+    std::mt19937 rng(id);
+    std::uniform_real_distribution<float> distrib(0.0, 1.0);
+
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(id);
+    vector_with_id.mutable_vector()->set_dimension(kDimension);
+    vector_with_id.mutable_vector()->set_value_type(pb::common::ValueType::FLOAT);
+    for (int i = 0; i < kDimension; ++i) {
+      vector_with_id.mutable_vector()->add_float_values(distrib(rng));
+    }
+    return vector_with_id;
+  }
+
+  static std::vector<pb::common::VectorWithId> GenVectorWithIds(int64_t start_id, int64_t count) {
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    for (int64_t id = start_id; id < start_id + count; ++id) {
+      vector_with_ids.push_back(GenVectorWithId(id));
+    }
+    return vector_with_ids;
+  }
+
+  // search vector itself, top1 should be itself.
+  static int64_t SearchTop1(std::shared_ptr<VectorIndexSegmentHnsw> index, int64_t id) {
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    pb::common::VectorSearchParameter parameter;
+    parameter.mutable_hnsw()->set_efsearch(64);
+    auto status = index->Search({GenVectorWithId(id)}, 3, {}, false, parameter, results);
+    if (!status.ok() || results.size() != 1 || results[0].vector_with_distances_size() == 0) {
+      return -1;
+    }
+    return results[0].vector_with_distances(0).vector_with_id().id();
+  }
+
+  inline static const int kDimension = 8;
+  inline static const std::string kSaveDir = "./segment_hnsw_test";
+
+  int64_t old_buffer_max_count;
+  int64_t old_segment_max_count;
+};
+
+TEST_F(VectorIndexSegmentHnswTest, UpsertAndSearch) {
+  auto index = NewIndex();
+
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(index->Upsert(GenVectorWithIds(i * 100, 100)).ok());
+    index->WaitBackground();
+  }
+
+  // sealed buffers are built to segments, and merged when too many.
+  EXPECT_GE(index->SegmentCount(), 1);
+  EXPECT_LE(index->SegmentCount(), 2);
+
+  int64_t count = 0, deleted_count = 0;
+  index->GetCount(count);
+  index->GetDeletedCount(deleted_count);
+  EXPECT_EQ(500, count - deleted_count);
+
+  for (int64_t id : {0, 99, 100, 250, 499}) {
+    EXPECT_EQ(id, SearchTop1(index, id));
+  }
+}
+
+TEST_F(VectorIndexSegmentHnswTest, DeleteAndReupsert) {
+  auto index = NewIndex();
+
+  ASSERT_TRUE(index->Upsert(GenVectorWithIds(0, 100)).ok());
+  index->WaitBackground();
+  ASSERT_TRUE(index->Upsert(GenVectorWithIds(100, 10)).ok());
+
+  // delete from segment and buffer
+  ASSERT_TRUE(index->Delete({5, 105}).ok());
+  EXPECT_NE(5, SearchTop1(index, 5));
+  EXPECT_NE(105, SearchTop1(index, 105));
+
+  // upsert again, new version is in buffer
+  ASSERT_TRUE(index->Upsert({GenVectorWithId(5)}).ok());
+  EXPECT_EQ(5, SearchTop1(index, 5));
+
+  int64_t count = 0, deleted_count = 0;
+  index->GetCount(count);
+  index->GetDeletedCount(deleted_count);
+  EXPECT_EQ(109, count - deleted_count);
+}
+
+TEST_F(VectorIndexSegmentHnswTest, SaveAndLoad) {
+  auto index = NewIndex();
+
+  ASSERT_TRUE(index->Upsert(GenVectorWithIds(0, 100)).ok());
+  index->WaitBackground();
+  ASSERT_TRUE(index->Upsert(GenVectorWithIds(100, 20)).ok());
+  ASSERT_TRUE(index->Delete({1}).ok());
+
+  std::filesystem::create_directories(kSaveDir);
+  std::string path = kSaveDir + "/index_1_100.idx";
+  index->LockWrite();
+  auto status = index->Save(path);
+  index->UnlockWrite();
+  ASSERT_TRUE(status.ok()) << status.error_str();
+
+  auto new_index = NewIndex();
+  status = new_index->Load(path);
+  ASSERT_TRUE(status.ok()) << status.error_str();
+  EXPECT_EQ(index->SegmentCount(), new_index->SegmentCount());
+
+  for (int64_t id : {0, 50, 110, 119}) {
+    EXPECT_EQ(id, SearchTop1(new_index, id));
+  }
+  EXPECT_NE(1, SearchTop1(new_index, 1));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,148 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "butil/status.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index_factory.h"
+
+namespace dingodb {
+
+class VectorIndexSplitCopyTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() { vector_index_thread_pool = std::make_shared<ThreadPool>("vector_index", 2); }
+
+  static pb::common::VectorIndexParameter FlatParameter() {
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT);
+    index_parameter.mutable_flat_parameter()->set_dimension(kDimension);
+    index_parameter.mutable_flat_parameter()->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+    return index_parameter;
+  }
+
+  static pb::common::VectorIndexParameter IvfFlatParameter() {
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_FLAT);
+    index_parameter.mutable_ivf_flat_parameter()->set_dimension(kDimension);
+    index_parameter.mutable_ivf_flat_parameter()->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+    index_parameter.mutable_ivf_flat_parameter()->set_ncentroids(4);
+    return index_parameter;
+  }
+
+  static std::vector<pb::common::VectorWithId> GenVectorWithIds(int64_t count) {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> distrib(0.0, 1.0);
+
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    for (int64_t id = 0; id < count; ++id) {
+      pb::common::VectorWithId vector_with_id;
+      vector_with_id.set_id(id);
+      vector_with_id.mutable_vector()->set_dimension(kDimension);
+      vector_with_id.mutable_vector()->set_value_type(pb::common::ValueType::FLOAT);
+      for (int i = 0; i < kDimension; ++i) {
+        vector_with_id.mutable_vector()->add_float_values(distrib(rng));
+      }
+      vector_with_ids.push_back(vector_with_id);
+    }
+    return vector_with_ids;
+  }
+
+  // search vector itself with all list probed, top1 should be itself when it is in index.
+  static int64_t SearchTop1(std::shared_ptr<VectorIndex> index, const pb::common::VectorWithId& vector_with_id) {
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    pb::common::VectorSearchParameter parameter;
+    parameter.mutable_ivf_flat()->set_nprobe(4);
+    auto status = index->Search({vector_with_id}, 3, {}, false, parameter, results);
+    if (!status.ok() || results.size() != 1 || results[0].vector_with_distances_size() == 0) {
+      return -1;
+    }
+    return results[0].vector_with_distances(0).vector_with_id().id();
+  }
+
+  static void CheckCopy(std::shared_ptr<VectorIndex> source, std::shared_ptr<VectorIndex> target,
+                        const std::vector<pb::common::VectorWithId>& vector_with_ids) {
+    ASSERT_TRUE(source->CopyTo(target, 100, 300).ok());
+
+    int64_t count = 0;
+    target->GetCount(count);
+    EXPECT_EQ(200, count);
+    EXPECT_TRUE(target->IsTrained());
+
+    for (int64_t id : {100, 150, 299}) {
+      EXPECT_EQ(id, SearchTop1(target, vector_with_ids[id]));
+    }
+    for (int64_t id : {0, 99, 300, 499}) {
+      int64_t top1 = SearchTop1(target, vector_with_ids[id]);
+      EXPECT_TRUE(top1 >= 100 && top1 < 300) << top1;
+    }
+
+    // source is not changed
+    source->GetCount(count);
+    EXPECT_EQ(static_cast<int64_t>(vector_with_ids.size()), count);
+  }
+
+  inline static const int kDimension = 8;
+  inline static ThreadPoolPtr vector_index_thread_pool;
+};
+
+TEST_F(VectorIndexSplitCopyTest, Flat) {
+  pb::common::RegionEpoch epoch;
+  pb::common::Range range;
+  auto source = VectorIndexFactory::NewFlat(1, FlatParameter(), epoch, range, vector_index_thread_pool);
+  auto target = VectorIndexFactory::NewFlat(2, FlatParameter(), epoch, range, vector_index_thread_pool);
+  ASSERT_NE(nullptr, source);
+  ASSERT_NE(nullptr, target);
+
+  auto vector_with_ids = GenVectorWithIds(500);
+  ASSERT_TRUE(source->Upsert(vector_with_ids).ok());
+
+  CheckCopy(source, target, vector_with_ids);
+}
+
+TEST_F(VectorIndexSplitCopyTest, IvfFlat) {
+  pb::common::RegionEpoch epoch;
+  pb::common::Range range;
+  auto source = VectorIndexFactory::NewIvfFlat(1, IvfFlatParameter(), epoch, range, vector_index_thread_pool);
+  auto target = VectorIndexFactory::NewIvfFlat(2, IvfFlatParameter(), epoch, range, vector_index_thread_pool);
+  ASSERT_NE(nullptr, source);
+  ASSERT_NE(nullptr, target);
+
+  auto vector_with_ids = GenVectorWithIds(500);
+  ASSERT_TRUE(source->Train(vector_with_ids).ok());
+  ASSERT_TRUE(source->Upsert(vector_with_ids).ok());
+  EXPECT_FALSE(target->IsTrained());
+
+  CheckCopy(source, target, vector_with_ids);
+}
+
+TEST_F(VectorIndexSplitCopyTest, TypeNotMatch) {
+  pb::common::RegionEpoch epoch;
+  pb::common::Range range;
+  auto source = VectorIndexFactory::NewFlat(1, FlatParameter(), epoch, range, vector_index_thread_pool);
+  auto target = VectorIndexFactory::NewIvfFlat(2, IvfFlatParameter(), epoch, range, vector_index_thread_pool);
+
+  auto status = source->CopyTo(target, 0, 100);
+  EXPECT_EQ(pb::error::ENOT_SUPPORT, status.error_code());
+}
+
+}  // namespace dingodb
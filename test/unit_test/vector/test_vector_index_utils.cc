@@ -24,9 +24,13 @@
 #include <iostream>
 #include <random>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "butil/status.h"
+#include "faiss/IndexFlat.h"
+#include "faiss/IndexIVFFlat.h"
+#include "gflags/gflags.h"
 #include "glog/logging.h"
 #include "gtest/gtest.h"
 #include "proto/common.pb.h"
@@ -36,6 +40,9 @@
 
 namespace dingodb {
 
+DECLARE_bool(enable_vector_index_adaptive_nprobe);
+DECLARE_int32(vector_index_adaptive_nprobe_patience);
+
 class VectorIndexUtilsTest : public testing::Test {
  protected:
   static void SetUpTestSuite() {}
@@ -5260,4 +5267,243 @@ TEST_F(VectorIndexUtilsTest, NormalizeVectorForHnsw) {
   }
 }
 
+TEST_F(VectorIndexUtilsTest, VectorReservoirSampler) {
+  constexpr int32_t kDimension = 4;
+  constexpr int64_t kMaxCount = 100;
+
+  // less than max count, keep all
+  {
+    VectorReservoirSampler sampler(kMaxCount, kDimension, 1);
+    for (int i = 0; i < 10; ++i) {
+      std::array<float, kDimension> data;
+      data.fill(i);
+      sampler.Add(data.data());
+    }
+    EXPECT_EQ(10, sampler.SampleCount());
+    EXPECT_EQ(9.0F, sampler.Samples()[9 * kDimension]);
+  }
+
+  // more than max count, sample is bounded and spread over whole stream
+  {
+    constexpr int kCount = 100000;
+    VectorReservoirSampler sampler(kMaxCount, kDimension, 1);
+    for (int i = 0; i < kCount; ++i) {
+      std::array<float, kDimension> data;
+      data.fill(i);
+      sampler.Add(data.data());
+    }
+    EXPECT_EQ(kMaxCount, sampler.SampleCount());
+    EXPECT_EQ(kCount, sampler.SeenCount());
+
+    int64_t second_half_count = 0;
+    for (int64_t i = 0; i < sampler.SampleCount(); ++i) {
+      if (sampler.Samples()[i * kDimension] >= kCount / 2) {
+        ++second_half_count;
+      }
+    }
+    EXPECT_GT(second_half_count, kMaxCount / 4);
+    EXPECT_LT(second_half_count, kMaxCount * 3 / 4);
+  }
+}
+
+TEST_F(VectorIndexUtilsTest, VectorTopkMerger) {
+  auto gen_result = [](const std::vector<std::pair<int64_t, float>>& id_distances) {
+    pb::index::VectorWithDistanceResult result;
+    for (const auto& [id, distance] : id_distances) {
+      auto* vector_with_distance = result.add_vector_with_distances();
+      vector_with_distance->mutable_vector_with_id()->set_id(id);
+      vector_with_distance->set_distance(distance);
+    }
+    return result;
+  };
+  auto get_ids = [](const pb::index::VectorWithDistanceResult& result) {
+    std::vector<int64_t> ids;
+    for (const auto& vector_with_distance : result.vector_with_distances()) {
+      ids.push_back(vector_with_distance.vector_with_id().id());
+    }
+    return ids;
+  };
+
+  // topk of many sources, tie prefer earlier source
+  {
+    auto source_1 = gen_result({{1, 0.1}, {2, 0.5}, {3, 0.9}});
+    auto source_2 = gen_result({{4, 0.2}, {5, 0.5}});
+    auto source_3 = gen_result({{6, 0.05}});
+
+    VectorTopkMerger merger(4, false);
+    merger.Add(source_1);
+    merger.Add(source_2);
+    merger.Add(source_3);
+    pb::index::VectorWithDistanceResult result;
+    merger.Finish(result);
+    EXPECT_EQ(std::vector<int64_t>({6, 1, 4, 2}), get_ids(result));
+
+    // reuse merger
+    auto source_4 = gen_result({{7, 0.3}});
+    merger.Add(source_4);
+    pb::index::VectorWithDistanceResult result_2;
+    merger.Finish(result_2);
+    EXPECT_EQ(std::vector<int64_t>({7}), get_ids(result_2));
+  }
+
+  // same id keep smallest distance
+  {
+    auto source_1 = gen_result({{1, 0.4}, {2, 0.5}});
+    auto source_2 = gen_result({{1, 0.1}, {3, 0.6}});
+
+    VectorTopkMerger merger(UINT32_MAX, true);
+    merger.Add(source_1);
+    merger.Add(source_2);
+    pb::index::VectorWithDistanceResult result;
+    merger.Finish(result);
+    ASSERT_EQ(std::vector<int64_t>({1, 2, 3}), get_ids(result));
+    EXPECT_FLOAT_EQ(0.1, result.vector_with_distances(0).distance());
+  }
+
+  // topk is zero
+  {
+    auto source_1 = gen_result({{1, 0.1}});
+    VectorTopkMerger merger(0, false);
+    merger.Add(source_1);
+    pb::index::VectorWithDistanceResult result;
+    merger.Finish(result);
+    EXPECT_EQ(0, result.vector_with_distances_size());
+  }
+}
+
+TEST_F(VectorIndexUtilsTest, AdaptiveIvfSearch) {
+  const int kDimension = 8;
+  const int kCount = 2000;
+  const int kNlist = 16;
+  const int kTopk = 10;
+  const int kQueryCount = 10;
+
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> distrib(0.0, 1.0);
+  std::vector<float> data(kCount * kDimension);
+  for (auto& value : data) {
+    value = distrib(rng);
+  }
+
+  faiss::IndexFlatL2 quantizer(kDimension);
+  faiss::IndexIVFFlat index(&quantizer, kDimension, kNlist);
+  index.train(kCount, data.data());
+  index.add(kCount, data.data());
+
+  faiss::IVFSearchParameters params;
+  params.nprobe = kNlist;
+  std::vector<float> expect_distances(kQueryCount * kTopk);
+  std::vector<faiss::idx_t> expect_labels(kQueryCount * kTopk);
+  index.search(kQueryCount, data.data(), kTopk, expect_distances.data(), expect_labels.data(), &params);
+
+  bool old_enable = FLAGS_enable_vector_index_adaptive_nprobe;
+  int32_t old_patience = FLAGS_vector_index_adaptive_nprobe_patience;
+  std::vector<float> distances(kQueryCount * kTopk);
+  std::vector<faiss::idx_t> labels(kQueryCount * kTopk);
+
+  // disabled
+  FLAGS_enable_vector_index_adaptive_nprobe = false;
+  EXPECT_FALSE(VectorIndexUtils::AdaptiveIvfSearch(&index, kQueryCount, data.data(), kTopk, params, distances.data(),
+                                                   labels.data()));
+
+  // patience not less than steps, all lists are probed, same as search all lists.
+  FLAGS_enable_vector_index_adaptive_nprobe = true;
+  FLAGS_vector_index_adaptive_nprobe_patience = kNlist;
+  EXPECT_TRUE(VectorIndexUtils::AdaptiveIvfSearch(&index, kQueryCount, data.data(), kTopk, params, distances.data(),
+                                                  labels.data()));
+  EXPECT_EQ(expect_labels, labels);
+
+  // stop early, query itself is in the nearest list.
+  FLAGS_vector_index_adaptive_nprobe_patience = 1;
+  EXPECT_TRUE(VectorIndexUtils::AdaptiveIvfSearch(&index, kQueryCount, data.data(), kTopk, params, distances.data(),
+                                                  labels.data()));
+  for (int row = 0; row < kQueryCount; ++row) {
+    EXPECT_EQ(row, labels[row * kTopk]);
+    EXPECT_GE(labels[row * kTopk + kTopk - 1], 0);
+  }
+
+  FLAGS_enable_vector_index_adaptive_nprobe = old_enable;
+  FLAGS_vector_index_adaptive_nprobe_patience = old_patience;
+}
+
+TEST_F(VectorIndexUtilsTest, CalcFloatDistanceByBatch) {
+  const int kDimension = 16;
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> distrib(-1.0, 1.0);
+
+  auto gen_vectors = [&](int count) {
+    google::protobuf::RepeatedPtrField<pb::common::Vector> vectors;
+    for (int i = 0; i < count; ++i) {
+      auto* vector = vectors.Add();
+      vector->set_dimension(kDimension);
+      vector->set_value_type(pb::common::ValueType::FLOAT);
+      for (int j = 0; j < kDimension; ++j) {
+        vector->add_float_values(distrib(rng));
+      }
+    }
+    return vectors;
+  };
+
+  // more right vectors than one block
+  auto left_vectors = gen_vectors(3);
+  auto right_vectors = gen_vectors(300);
+
+  for (auto metric_type : {pb::common::METRIC_TYPE_L2, pb::common::METRIC_TYPE_INNER_PRODUCT,
+                           pb::common::METRIC_TYPE_COSINE}) {
+    for (bool is_hnswlib : {false, true}) {
+      std::vector<std::vector<float>> distances;
+      std::vector<pb::common::Vector> result_left_vectors;
+      std::vector<pb::common::Vector> result_right_vectors;
+      ASSERT_TRUE(VectorIndexUtils::CalcFloatDistanceByBatch(metric_type, is_hnswlib, left_vectors, right_vectors, true,
+                                                             distances, result_left_vectors, result_right_vectors));
+
+      std::vector<std::vector<float>> pair_distances;
+      std::vector<pb::common::Vector> pair_left_vectors;
+      std::vector<pb::common::Vector> pair_right_vectors;
+      VectorIndexUtils::DoCalcDistanceFunc do_calc_func;
+      if (metric_type == pb::common::METRIC_TYPE_L2) {
+        do_calc_func =
+            is_hnswlib ? VectorIndexUtils::DoCalcL2DistanceByHnswlib : VectorIndexUtils::DoCalcL2DistanceByFaiss;
+      } else if (metric_type == pb::common::METRIC_TYPE_INNER_PRODUCT) {
+        do_calc_func =
+            is_hnswlib ? VectorIndexUtils::DoCalcIpDistanceByHnswlib : VectorIndexUtils::DoCalcIpDistanceByFaiss;
+      } else {
+        do_calc_func = is_hnswlib ? VectorIndexUtils::DoCalcCosineDistanceByHnswlib
+                                  : VectorIndexUtils::DoCalcCosineDistanceByFaiss;
+      }
+      ASSERT_TRUE(VectorIndexUtils::CalcDistanceCore(left_vectors, right_vectors, true, pair_distances,
+                                                     pair_left_vectors, pair_right_vectors, do_calc_func)
+                      .ok());
+
+      ASSERT_EQ(pair_distances.size(), distances.size());
+      for (size_t i = 0; i < distances.size(); ++i) {
+        ASSERT_EQ(pair_distances[i].size(), distances[i].size());
+        for (size_t j = 0; j < distances[i].size(); ++j) {
+          EXPECT_NEAR(pair_distances[i][j], distances[i][j], 1e-4);
+        }
+      }
+
+      ASSERT_EQ(pair_right_vectors.size(), result_right_vectors.size());
+      for (size_t i = 0; i < result_right_vectors.size(); ++i) {
+        ASSERT_EQ(kDimension, result_right_vectors[i].float_values_size());
+        for (int j = 0; j < kDimension; ++j) {
+          EXPECT_NEAR(pair_right_vectors[i].float_values(j), result_right_vectors[i].float_values(j), 1e-5);
+        }
+      }
+    }
+  }
+
+  // different dimension fallback to pair
+  {
+    auto vectors = gen_vectors(2);
+    vectors[1].add_float_values(1.0);
+    std::vector<std::vector<float>> distances;
+    std::vector<pb::common::Vector> result_left_vectors;
+    std::vector<pb::common::Vector> result_right_vectors;
+    EXPECT_FALSE(VectorIndexUtils::CalcFloatDistanceByBatch(pb::common::METRIC_TYPE_L2, false, left_vectors, vectors,
+                                                            false, distances, result_left_vectors,
+                                                            result_right_vectors));
+  }
+}
+
 }  // namespace dingodb
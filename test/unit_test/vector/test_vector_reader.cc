@@ -17,6 +17,7 @@
 #include <cstdlib>
 #include <memory>
 #include <random>
+#include <utility>
 #include <vector>
 
 #include "butil/status.h"
@@ -1910,4 +1911,42 @@ TEST_F(VectorIndexReaderTest, IdPreFilter) {
   }
 }
 
+static pb::index::VectorWithDistanceResult GenResult(const std::vector<std::pair<int64_t, float>>& id_distances) {
+  pb::index::VectorWithDistanceResult result;
+  for (const auto& [id, distance] : id_distances) {
+    auto* vector_with_distance = result.add_vector_with_distances();
+    vector_with_distance->mutable_vector_with_id()->set_id(id);
+    vector_with_distance->set_distance(distance);
+  }
+  return result;
+}
+
+TEST(VectorReaderAggregateTest, MultiVectorAggregation) {
+  auto gen_results = []() {
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    results.push_back(GenResult({{10, 0.1}, {11, 0.5}, {12, 0.6}}));
+    results.push_back(GenResult({{11, 0.2}, {12, 0.3}, {13, 0.9}}));
+    return results;
+  };
+
+  // best distance
+  auto results = gen_results();
+  VectorReader::AggregateMultiVectorResults(Engine::VectorReader::MultiVectorAggregation::kMax, 3, results);
+  ASSERT_EQ(1, results.size());
+  ASSERT_EQ(3, results[0].vector_with_distances_size());
+  EXPECT_EQ(10, results[0].vector_with_distances(0).vector_with_id().id());
+  EXPECT_EQ(11, results[0].vector_with_distances(1).vector_with_id().id());
+  EXPECT_EQ(12, results[0].vector_with_distances(2).vector_with_id().id());
+  EXPECT_FLOAT_EQ(0.2, results[0].vector_with_distances(1).distance());
+
+  // missing query count as its farthest: 10 = 0.1+0.9, 11 = 0.7, 12 = 0.9, 13 = 0.6+0.9
+  results = gen_results();
+  VectorReader::AggregateMultiVectorResults(Engine::VectorReader::MultiVectorAggregation::kSum, 2, results);
+  ASSERT_EQ(1, results.size());
+  ASSERT_EQ(2, results[0].vector_with_distances_size());
+  EXPECT_EQ(11, results[0].vector_with_distances(0).vector_with_id().id());
+  EXPECT_FLOAT_EQ(0.7, results[0].vector_with_distances(0).distance());
+  EXPECT_EQ(12, results[0].vector_with_distances(1).vector_with_id().id());
+}
+
 }  // namespace dingodb
@@ -0,0 +1,152 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "butil/status.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_search_batcher.h"
+
+namespace dingodb {
+
+DECLARE_int64(vector_search_batch_window_us);
+
+class VectorSearchBatcherTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    old_window_us = FLAGS_vector_search_batch_window_us;
+    FLAGS_vector_search_batch_window_us = 20 * 1000;
+  }
+  void TearDown() override { FLAGS_vector_search_batch_window_us = old_window_us; }
+
+  // result distance is vector id, so every search can check it get own result.
+  static butil::Status FakeSearch(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                  std::vector<pb::index::VectorWithDistanceResult>& results) {
+    for (const auto& vector_with_id : vector_with_ids) {
+      pb::index::VectorWithDistanceResult result;
+      result.add_vector_with_distances()->set_distance(vector_with_id.id());
+      results.push_back(result);
+    }
+    return butil::Status::OK();
+  }
+
+  static std::vector<pb::common::VectorWithId> GenVectorWithIds(int64_t id) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(id);
+    return {vector_with_id};
+  }
+
+  int64_t old_window_us;
+};
+
+TEST_F(VectorSearchBatcherTest, SingleSearch) {
+  VectorSearchBatcher batcher;
+
+  std::atomic<int> search_count = 0;
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  auto status = batcher.Search(
+      "key", GenVectorWithIds(1),
+      [&](const std::vector<pb::common::VectorWithId>& vector_with_ids,
+          std::vector<pb::index::VectorWithDistanceResult>& results) {
+        ++search_count;
+        return FakeSearch(vector_with_ids, results);
+      },
+      results);
+
+  EXPECT_TRUE(status.ok());
+  EXPECT_EQ(1, search_count.load());
+  ASSERT_EQ(1, results.size());
+  EXPECT_EQ(1, results[0].vector_with_distances(0).distance());
+}
+
+TEST_F(VectorSearchBatcherTest, ConcurrentSearch) {
+  VectorSearchBatcher batcher;
+
+  const int kThreadNum = 16;
+  std::atomic<int> ready_count = 0;
+  std::atomic<int> search_count = 0;
+  std::atomic<int> error_count = 0;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadNum; ++i) {
+    threads.emplace_back([&, i]() {
+      // start search at the same time
+      ++ready_count;
+      while (ready_count.load() < kThreadNum) {
+        std::this_thread::yield();
+      }
+
+      std::vector<pb::index::VectorWithDistanceResult> results;
+      auto status = batcher.Search(
+          i % 2 == 0 ? "key_1" : "key_2", GenVectorWithIds(i),
+          [&](const std::vector<pb::common::VectorWithId>& vector_with_ids,
+              std::vector<pb::index::VectorWithDistanceResult>& results) {
+            ++search_count;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            return FakeSearch(vector_with_ids, results);
+          },
+          results);
+
+      if (!status.ok() || results.size() != 1 || results[0].vector_with_distances(0).distance() != i) {
+        ++error_count;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(0, error_count.load());
+  // concurrent searches of same key are coalesced.
+  EXPECT_LT(search_count.load(), kThreadNum);
+}
+
+TEST_F(VectorSearchBatcherTest, SearchFail) {
+  VectorSearchBatcher batcher;
+
+  const int kThreadNum = 8;
+  std::atomic<int> fail_count = 0;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadNum; ++i) {
+    threads.emplace_back([&, i]() {
+      std::vector<pb::index::VectorWithDistanceResult> results;
+      auto status = batcher.Search(
+          "key", GenVectorWithIds(i),
+          [&](const std::vector<pb::common::VectorWithId>&, std::vector<pb::index::VectorWithDistanceResult>&) {
+            return butil::Status(pb::error::EINTERNAL, "search fail");
+          },
+          results);
+      if (!status.ok()) {
+        ++fail_count;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // every search get error of its batch.
+  EXPECT_EQ(kThreadNum, fail_count.load());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,99 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_search_cache.h"
+
+namespace dingodb {
+
+DECLARE_int64(vector_search_cache_max_memory_bytes);
+
+class VectorSearchCacheTest : public testing::Test {
+ protected:
+  void SetUp() override { old_max_memory_bytes = FLAGS_vector_search_cache_max_memory_bytes; }
+  void TearDown() override { FLAGS_vector_search_cache_max_memory_bytes = old_max_memory_bytes; }
+
+  static std::string GenKey(float value) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.mutable_vector()->set_dimension(1);
+    vector_with_id.mutable_vector()->add_float_values(value);
+    return VectorSearchCache::GenKey(vector_with_id, "10|false");
+  }
+
+  static pb::index::VectorWithDistanceResult GenResult(int64_t id) {
+    pb::index::VectorWithDistanceResult result;
+    result.add_vector_with_distances()->mutable_vector_with_id()->set_id(id);
+    return result;
+  }
+
+  int64_t old_max_memory_bytes;
+};
+
+TEST_F(VectorSearchCacheTest, HitAndInvalidate) {
+  VectorSearchCache cache;
+
+  auto version = cache.GetVersion(100);
+  cache.Put(GenKey(1.0), version, GenResult(1));
+
+  pb::index::VectorWithDistanceResult result;
+  ASSERT_TRUE(cache.Get(GenKey(1.0), version, result));
+  EXPECT_EQ(1, result.vector_with_distances(0).vector_with_id().id());
+  EXPECT_FALSE(cache.Get(GenKey(2.0), version, result));
+
+  // new apply log
+  EXPECT_FALSE(cache.Get(GenKey(1.0), cache.GetVersion(101), result));
+
+  // write without apply log, e.g. mono store
+  cache.Put(GenKey(1.0), version, GenResult(1));
+  cache.Invalidate();
+  EXPECT_FALSE(cache.Get(GenKey(1.0), cache.GetVersion(100), result));
+  EXPECT_EQ(0, cache.MemorySize());
+
+  // version got before write is not put
+  cache.Put(GenKey(1.0), version, GenResult(1));
+  EXPECT_EQ(0, cache.Size());
+}
+
+TEST_F(VectorSearchCacheTest, EvictByMemory) {
+  VectorSearchCache cache;
+  auto version = cache.GetVersion(1);
+
+  cache.Put(GenKey(10), version, GenResult(10));
+  int64_t entry_memory_size = cache.MemorySize();
+  ASSERT_GT(entry_memory_size, 0);
+
+  FLAGS_vector_search_cache_max_memory_bytes = entry_memory_size * 3;
+  cache.Put(GenKey(11), version, GenResult(11));
+  cache.Put(GenKey(12), version, GenResult(12));
+
+  // key 10 is recently used, key 11 is evicted
+  pb::index::VectorWithDistanceResult result;
+  ASSERT_TRUE(cache.Get(GenKey(10), version, result));
+  cache.Put(GenKey(13), version, GenResult(13));
+
+  EXPECT_EQ(3, cache.Size());
+  EXPECT_LE(cache.MemorySize(), FLAGS_vector_search_cache_max_memory_bytes);
+  EXPECT_TRUE(cache.Get(GenKey(10), version, result));
+  EXPECT_FALSE(cache.Get(GenKey(11), version, result));
+  EXPECT_TRUE(cache.Get(GenKey(13), version, result));
+}
+
+}  // namespace dingodb